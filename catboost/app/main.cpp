@@ -19,6 +19,7 @@ int main(int argc, const char* argv[]) {
         TSetLoggingVerbose inThisScope;
         TModChooser modChooser;
         modChooser.AddMode("fit", mode_fit, "train model");
+        modChooser.AddMode("benchmark-fit", mode_benchmark_fit, "measure training speed on synthetic or given datasets");
         modChooser.AddMode("calc", mode_calc, "evaluate model predictions");
         modChooser.AddMode("dataset-statistics", mode_dataset_statistics, "calculate dataset statistics");
         modChooser.AddMode("fstr", mode_fstr, "evaluate feature importances");
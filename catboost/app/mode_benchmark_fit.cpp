@@ -0,0 +1,449 @@
+#include "modes.h"
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/data/load_data.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <catboost/private/libs/algo/helpers.h>
+#include <catboost/private/libs/options/enums.h>
+
+#include <library/cpp/getopt/small/last_getopt.h>
+#include <library/cpp/json/json_reader.h>
+#include <library/cpp/json/json_value.h>
+#include <library/cpp/json/json_writer.h>
+
+#include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+#include <util/system/fs.h>
+#include <util/system/hp_timer.h>
+#include <util/system/info.h>
+
+#include <cmath>
+#include <limits>
+
+
+using namespace NCB;
+
+
+namespace {
+    /* Synthetic datasets with shapes of the datasets usually used to compare training speed:
+     *  Higgs - few dense float features,
+     *  Epsilon - many dense float features,
+     *  Criteo - integer counters with missing values and high cardinality categorical features.
+     * Labels are binary and depend on the features, so trees are not degenerate.
+     */
+    struct TBenchmarkDatasetShape {
+        TStringBuf Name;
+        ui32 FloatFeatureCount;
+        ui32 CatFeatureCount;
+        ui32 CatFeatureCardinality;
+        bool Counters; // float features are integer counters with missing values
+    };
+
+    const TBenchmarkDatasetShape BenchmarkDatasetShapes[] = {
+        {"higgs", 28, 0, 0, false},
+        {"epsilon", 2000, 0, 0, false},
+        {"criteo", 13, 26, 100000, true},
+    };
+
+    struct TBenchmarkFitOptions {
+        TString DatasetName = "higgs";
+        ui32 ObjectCount = 100000;
+        ui64 Seed = 0;
+
+        // load dataset instead of generating it
+        TString LearnSetPath;
+        TString CdPath;
+
+        ui32 IterationCount = 100;
+        TVector<ETaskType> TaskTypes = {ETaskType::CPU};
+        TVector<int> ThreadCounts = {(int)NSystemInfo::CachedNumberOfCpus()};
+        TVector<ui32> Depths = {6};
+        TVector<ui32> BorderCounts = {254};
+        TVector<TString> LossFunctions = {"Logloss"};
+        ui32 RepetitionCount = 1;
+
+        TString TrainDir = "catboost_benchmark_fit";
+        TString OutputPath; // stdout if empty
+    };
+}
+
+
+template <class T>
+static TVector<T> ParseList(TStringBuf list) {
+    TVector<T> result;
+    for (const auto& item : StringSplitter(list).Split(',').SkipEmpty()) {
+        result.push_back(FromString<T>(item.Token()));
+    }
+    CB_ENSURE(!result.empty(), "Empty list of values");
+    return result;
+}
+
+static const TBenchmarkDatasetShape& GetDatasetShape(TStringBuf name) {
+    const auto* shape = FindIf(
+        BenchmarkDatasetShapes,
+        [=] (const TBenchmarkDatasetShape& shape) { return shape.Name == name; }
+    );
+    CB_ENSURE(shape != std::end(BenchmarkDatasetShapes), "Unknown benchmark dataset " << name);
+    return *shape;
+}
+
+
+static TDataProviderPtr GenerateDataset(const TBenchmarkDatasetShape& shape, ui32 objectCount, ui64 seed) {
+    TFastRng64 rng(seed);
+
+    // approximately normal, Irwin-Hall distribution
+    auto genNormal = [&] () {
+        double sum = 0.0;
+        for (auto i : xrange(4)) {
+            Y_UNUSED(i);
+            sum += rng.GenRandReal1();
+        }
+        return (sum - 2.0) * sqrt(3.0);
+    };
+
+    TVector<TVector<float>> floatFeatures(shape.FloatFeatureCount); // [featureIdx][objectIdx]
+    TVector<double> logits(objectCount, 0.0);
+    for (auto featureIdx : xrange(shape.FloatFeatureCount)) {
+        auto& feature = floatFeatures[featureIdx];
+        feature.yresize(objectCount);
+
+        // only some features are informative, as in real datasets
+        const double weight = (featureIdx % 4 == 0) ? (featureIdx % 8 ? 1.0 : -1.0) : 0.0;
+        for (auto objectIdx : xrange(objectCount)) {
+            if (shape.Counters) {
+                if (rng.GenRandReal1() < 0.2) {
+                    feature[objectIdx] = std::numeric_limits<float>::quiet_NaN();
+                } else {
+                    const double value = floor(exp(rng.GenRandReal1() * 8.0)) - 1.0;
+                    feature[objectIdx] = value;
+                    logits[objectIdx] += weight * (log1p(value) - 3.0) * 0.5;
+                }
+            } else {
+                const double value = genNormal();
+                feature[objectIdx] = value;
+                logits[objectIdx] += weight * value;
+            }
+        }
+    }
+
+    TVector<TVector<ui32>> catFeatures(shape.CatFeatureCount); // [featureIdx][objectIdx], hashed values
+    for (auto featureIdx : xrange(shape.CatFeatureCount)) {
+        auto& feature = catFeatures[featureIdx];
+        feature.yresize(objectCount);
+
+        // skewed distribution of values, effects of values are pseudo random
+        const bool isInformative = featureIdx % 4 == 0;
+        for (auto objectIdx : xrange(objectCount)) {
+            const ui32 value = (ui32)pow((double)shape.CatFeatureCardinality, rng.GenRandReal1());
+            feature[objectIdx] = CalcCatFeatureHash(ToString(value));
+            if (isInformative) {
+                logits[objectIdx] += (double)(feature[objectIdx] % 7) / 3.0 - 1.0;
+            }
+        }
+    }
+
+    TVector<float> target;
+    target.yresize(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        const double probability = Sigmoid(logits[objectIdx]);
+        target[objectIdx] = rng.GenRandReal1() < probability ? 1.0f : 0.0f;
+    }
+
+    TVector<ui32> catFeatureIndices;
+    for (auto featureIdx : xrange(shape.CatFeatureCount)) {
+        catFeatureIndices.push_back(shape.FloatFeatureCount + featureIdx);
+    }
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.TargetType = ERawTargetType::Float;
+            metaInfo.TargetCount = 1;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                shape.FloatFeatureCount + shape.CatFeatureCount,
+                catFeatureIndices,
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto featureIdx : xrange(shape.FloatFeatureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    MakeTypeCastArrayHolderFromVector<float, float>(floatFeatures[featureIdx])
+                );
+            }
+            for (auto featureIdx : xrange(shape.CatFeatureCount)) {
+                visitor->AddCatFeature(
+                    shape.FloatFeatureCount + featureIdx,
+                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(catFeatures[featureIdx]))
+                );
+            }
+            visitor->AddTarget(MakeTypeCastArrayHolderFromVector<float, float>(target));
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TDataProviderPtr LoadDataset(const TBenchmarkFitOptions& options) {
+    NCatboostOptions::TColumnarPoolFormatParams columnarPoolFormatParams;
+    if (options.CdPath) {
+        columnarPoolFormatParams.CdFilePath = TPathWithScheme(options.CdPath, "dsv");
+    }
+    return ReadDataset(
+        /*taskType*/Nothing(),
+        TPathWithScheme(options.LearnSetPath, "dsv"),
+        /*pairsFilePath*/TPathWithScheme(),
+        /*groupWeightsFilePath*/TPathWithScheme(),
+        /*timestampsFilePath*/TPathWithScheme(),
+        /*baselineFilePath*/TPathWithScheme(),
+        /*featureNamesPath*/TPathWithScheme(),
+        /*poolMetaInfoPath*/TPathWithScheme(),
+        columnarPoolFormatParams,
+        /*ignoredFeatures*/TVector<ui32>(),
+        EObjectsOrder::Undefined,
+        (int)NSystemInfo::CachedNumberOfCpus(),
+        /*verbose*/ false,
+        /*forceUnitAutoPairWeights*/ false
+    );
+}
+
+
+// average times of operations from TProfileInfo, detailed profile is written only by CPU training
+static NJson::TJsonValue ReadAveragePhaseTimes(const TString& trainDir) {
+    const TString profileLogPath = JoinFsPaths(trainDir, "catboost_profile.log.json");
+    if (!NFs::Exists(profileLogPath)) {
+        return NJson::TJsonValue(NJson::JSON_MAP);
+    }
+
+    // summary is the last record
+    NJson::TJsonValue summary(NJson::JSON_MAP);
+    TFileInput input(profileLogPath);
+    TString line;
+    while (input.ReadLine(line)) {
+        NJson::TJsonValue record;
+        if (NJson::ReadJsonTree(line, &record) && record.Has("average_iteration_time")) {
+            summary = record["times"];
+        }
+    }
+    return summary;
+}
+
+static NJson::TJsonValue GetIterationTimeStats(const TMetricsAndTimeLeftHistory& history) {
+    NJson::TJsonValue stats(NJson::JSON_MAP);
+    const auto& timeHistory = history.TimeHistory;
+    if (timeHistory.empty()) {
+        return stats;
+    }
+
+    // the first iteration includes lazy initializations, so it is reported separately
+    stats["first"] = timeHistory[0].IterationTime;
+    if (timeHistory.size() > 1) {
+        TVector<double> times;
+        for (const auto& timeInfo : MakeArrayRef(timeHistory).Slice(1)) {
+            times.push_back(timeInfo.IterationTime);
+        }
+        Sort(times);
+        stats["mean"] = Accumulate(times, 0.0) / times.size();
+        stats["median"] = times[times.size() / 2];
+        stats["min"] = times.front();
+        stats["max"] = times.back();
+    }
+    return stats;
+}
+
+static NJson::TJsonValue RunBenchmark(
+    TDataProviderPtr dataset,
+    const NJson::TJsonValue& params,
+    const TString& trainDir
+) {
+    NJson::TJsonValue result;
+    result["params"] = params;
+
+    NJson::TJsonValue trainParams = params;
+    trainParams["train_dir"] = trainDir;
+    trainParams["detailed_profile"] = true;
+    trainParams["logging_level"] = "Silent";
+
+    TDataProviders pools;
+    pools.Learn = dataset;
+
+    TFullModel model;
+    TMetricsAndTimeLeftHistory history;
+    THPTimer timer;
+    try {
+        TrainModel(
+            trainParams,
+            /*quantizedFeaturesInfo*/ nullptr,
+            /*objectiveDescriptor*/ Nothing(),
+            /*evalMetricDescriptor*/ Nothing(),
+            /*callbackDescriptor*/ Nothing(),
+            std::move(pools),
+            /*initModel*/ Nothing(),
+            /*initLearnProgress*/ nullptr,
+            /*outputModelPath*/ "",
+            &model,
+            /*evalResultPtrs*/ {},
+            &history
+        );
+    } catch (const std::exception& e) {
+        // e.g. GPU training is not supported by this build, continue with other configurations
+        result["error"] = e.what();
+        return result;
+    }
+    result["total_time"] = timer.Passed();
+    result["iteration_count"] = model.GetTreeCount();
+    result["iteration_time"] = GetIterationTimeStats(history);
+    result["phase_times"] = ReadAveragePhaseTimes(trainDir);
+    return result;
+}
+
+
+int mode_benchmark_fit(int argc, const char* argv[]) {
+    ConfigureMalloc();
+
+    TBenchmarkFitOptions options;
+    TString taskTypes = "CPU";
+    TString threadCounts = ToString(options.ThreadCounts[0]);
+    TString depths = "6";
+    TString borderCounts = "254";
+    TString lossFunctions = "Logloss";
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddLongOption("dataset", "synthetic dataset: higgs, epsilon or criteo")
+        .RequiredArgument("NAME")
+        .StoreResult(&options.DatasetName)
+        .DefaultValue(options.DatasetName);
+    parser.AddLongOption("objects", "objects count of synthetic dataset")
+        .RequiredArgument("INT")
+        .StoreResult(&options.ObjectCount)
+        .DefaultValue(options.ObjectCount);
+    parser.AddLongOption("seed", "random seed for dataset generation and training")
+        .RequiredArgument("INT")
+        .StoreResult(&options.Seed)
+        .DefaultValue(options.Seed);
+    parser.AddLongOption('f', "learn-set", "dsv dataset to use instead of a synthetic one")
+        .RequiredArgument("PATH")
+        .StoreResult(&options.LearnSetPath);
+    parser.AddLongOption("cd", "column description of learn set")
+        .RequiredArgument("PATH")
+        .StoreResult(&options.CdPath);
+    parser.AddLongOption('i', "iterations", "fixed number of iterations of each training")
+        .RequiredArgument("INT")
+        .StoreResult(&options.IterationCount)
+        .DefaultValue(options.IterationCount);
+    parser.AddLongOption("task-types", "comma-separated list of CPU, GPU")
+        .RequiredArgument("LIST")
+        .StoreResult(&taskTypes)
+        .DefaultValue(taskTypes);
+    parser.AddLongOption("thread-counts", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&threadCounts)
+        .DefaultValue(threadCounts);
+    parser.AddLongOption("depths", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&depths)
+        .DefaultValue(depths);
+    parser.AddLongOption("border-counts", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&borderCounts)
+        .DefaultValue(borderCounts);
+    parser.AddLongOption("loss-functions", "comma-separated list, labels are binary")
+        .RequiredArgument("LIST")
+        .StoreResult(&lossFunctions)
+        .DefaultValue(lossFunctions);
+    parser.AddLongOption("repetitions", "number of trainings with each configuration")
+        .RequiredArgument("INT")
+        .StoreResult(&options.RepetitionCount)
+        .DefaultValue(options.RepetitionCount);
+    parser.AddLongOption("train-dir", "directory for training logs")
+        .RequiredArgument("PATH")
+        .StoreResult(&options.TrainDir)
+        .DefaultValue(options.TrainDir);
+    parser.AddLongOption('o', "output", "path to JSON results; omit to output to stdout")
+        .RequiredArgument("PATH")
+        .StoreResult(&options.OutputPath);
+    parser.SetFreeArgsMax(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    options.TaskTypes = ParseList<ETaskType>(taskTypes);
+    options.ThreadCounts = ParseList<int>(threadCounts);
+    options.Depths = ParseList<ui32>(depths);
+    options.BorderCounts = ParseList<ui32>(borderCounts);
+    options.LossFunctions = ParseList<TString>(lossFunctions);
+    CB_ENSURE(options.IterationCount > 0, "Iteration count must be positive");
+    CB_ENSURE(options.RepetitionCount > 0, "Repetition count must be positive");
+
+    NJson::TJsonValue results;
+    TDataProviderPtr dataset;
+    if (options.LearnSetPath) {
+        dataset = LoadDataset(options);
+        results["dataset"]["path"] = options.LearnSetPath;
+    } else {
+        const auto& shape = GetDatasetShape(options.DatasetName);
+        dataset = GenerateDataset(shape, options.ObjectCount, options.Seed);
+        results["dataset"]["name"] = options.DatasetName;
+        results["dataset"]["seed"] = options.Seed;
+    }
+    results["dataset"]["object_count"] = dataset->GetObjectCount();
+    results["dataset"]["feature_count"] = dataset->MetaInfo.GetFeatureCount();
+
+    auto& runs = results["runs"];
+    runs.SetType(NJson::JSON_ARRAY);
+    for (auto taskType : options.TaskTypes) {
+        for (auto threadCount : options.ThreadCounts) {
+            for (auto depth : options.Depths) {
+                for (auto borderCount : options.BorderCounts) {
+                    for (const auto& lossFunction : options.LossFunctions) {
+                        NJson::TJsonValue params;
+                        params["task_type"] = ToString(taskType);
+                        params["thread_count"] = threadCount;
+                        params["depth"] = depth;
+                        params["border_count"] = borderCount;
+                        params["loss_function"] = lossFunction;
+                        params["iterations"] = options.IterationCount;
+                        params["random_seed"] = options.Seed;
+
+                        for (auto repetition : xrange(options.RepetitionCount)) {
+                            const TString runTrainDir = JoinFsPaths(
+                                options.TrainDir,
+                                "run_" + ToString(runs.GetArray().size())
+                            );
+                            NFs::MakeDirectoryRecursive(runTrainDir);
+
+                            CATBOOST_NOTICE_LOG << "Train " << params.GetStringRobust()
+                                << ", repetition " << repetition << Endl;
+                            auto run = RunBenchmark(dataset, params, runTrainDir);
+                            run["repetition"] = repetition;
+                            runs.AppendValue(std::move(run));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.OutputPath) {
+        TFileOutput output(options.OutputPath);
+        NJson::WriteJson(&output, &results, /*formatOutput*/ true);
+    } else {
+        NJson::WriteJson(&Cout, &results, /*formatOutput*/ true);
+        Cout << Endl;
+    }
+    return 0;
+}
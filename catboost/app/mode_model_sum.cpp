@@ -17,6 +17,7 @@ int mode_model_sum(int argc, const char* argv[]) {
     TString outputModelPath;
     EModelType outputModelFormat = EModelType::CatboostBinary;
     ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage;
+    bool foldEqualTrees = false;
 
     auto parser = NLastGetopt::TOpts();
     parser.AddHelpOption();
@@ -59,6 +60,9 @@ int mode_model_sum(int argc, const char* argv[]) {
             GetEnumAllNames<ECtrTableMergePolicy>()))
         .Optional()
         .StoreResult(&ctrMergePolicy);
+    parser.AddLongOption("fold-equal-trees", "Sum symmetric trees with equal splits into one tree")
+        .NoArgument()
+        .StoreTrue(&foldEqualTrees);
     parser.SetFreeArgsNum(0);
     NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
     TVector<THolder<TFullModel>> models;
@@ -67,7 +71,7 @@ int mode_model_sum(int argc, const char* argv[]) {
         models.emplace_back(MakeHolder<TFullModel>(ReadModel(path)));
         modelPtrs.emplace_back(models.back().Get());
     }
-    TFullModel result = SumModels(modelPtrs, modelWeights, modelParamsPrefixes, ctrMergePolicy);
+    TFullModel result = SumModels(modelPtrs, modelWeights, modelParamsPrefixes, ctrMergePolicy, foldEqualTrees);
     NCB::ExportModel(result, outputModelPath, outputModelFormat);
     return 0;
 }
@@ -38,6 +38,7 @@ namespace {
         int ThreadCount;
         TVector<TPathWithScheme> PoolPaths;
         bool PrintScaleAndBias = false;
+        bool CompactForApply = false;
 
         TModeParams(int argc, const char* argv[]) {
             auto parser = NLastGetopt::TOpts();
@@ -62,6 +63,10 @@ namespace {
                 .StoreTrue(&PrintScaleAndBias)
                 .Help("Print input and resulting scale and bias")
                 ;
+            parser.AddLongOption("compact-for-apply").NoArgument()
+                .StoreTrue(&CompactForApply)
+                .Help("Drop splits and CTR data not affecting predictions, the model is usable for apply only")
+                ;
             parser.AddLongOption("logging-level").RequiredArgument("LEVEL")
                 .Handler1T<TStringBuf>([=](auto level){ LoggingLevel = FromString<ELoggingLevel>(level); })
                 .Help("Logging level, one of " + GetEnumAllNames<ELoggingLevel>())
@@ -120,7 +125,11 @@ namespace {
                 model.SetScaleAndBias({scale, bias});
             }
 
-            if (inputScaleAndBias != model.GetScaleAndBias() || modeParams.OutputModelFileName) {
+            if (modeParams.CompactForApply) {
+                model.CompactForApply();
+            }
+
+            if (inputScaleAndBias != model.GetScaleAndBias() || modeParams.OutputModelFileName || modeParams.CompactForApply) {
                 if (modeParams.PrintScaleAndBias) {
                     Cout << "Output model"
                         << " scale " << model.GetScaleAndBias().Scale
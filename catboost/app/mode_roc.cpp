@@ -22,6 +22,7 @@ struct TRocParams {
     TString EvalResultPath;
     float LabelBinarizationBorder;
     int ThreadCount;
+    ui32 HistogramBinBits;
 
     void BindParserOpts(NLastGetopt::TOpts& parser) {
         parser.AddLongOption('i', "eval-file", "eval result path")
@@ -39,6 +40,11 @@ struct TRocParams {
             .StoreResult(&ThreadCount)
             .RequiredArgument("INT")
             .DefaultValue(NSystemInfo::CachedNumberOfCpus());
+        parser.AddLongOption("histogram-bits", "build the curve from a histogram of predictions with 2^INT bins, "
+                             "memory does not depend on the eval set size (default: 0, exact curve)")
+            .StoreResult(&HistogramBinBits)
+            .RequiredArgument("INT")
+            .DefaultValue(0);
     }
 };
 
@@ -84,7 +90,7 @@ int mode_roc(int argc, const char* argv[]) {
     PrepareTargetBinary(labels, params.LabelBinarizationBorder, &labels);
 
     TVector<TConstArrayRef<float>> labelsParam(1, labels);
-    TRocCurve rocCurve(approxes, labelsParam, params.ThreadCount);
+    TRocCurve rocCurve(approxes, labelsParam, params.ThreadCount, params.HistogramBinBits);
     rocCurve.OutputRocCurve(params.OutputPath);
     return 0;
 }
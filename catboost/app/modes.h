@@ -7,6 +7,7 @@
 
 
 int mode_fit(int argc, const char* argv[]);
+int mode_benchmark_fit(int argc, const char* argv[]);
 int mode_ostr(int argc, const char* argv[]);
 int mode_eval_metrics(int argc, const char* argv[]);
 int mode_eval_feature(int argc, const char* argv[]);
@@ -42,6 +42,17 @@ double TCudaManager::TotalMemoryMb(ui32 devId) const {
     return devPtr->GetMemoryState().RequestedGpuRam * 1.0 / 1024 / 1024;
 }
 
+double TCudaManager::PeakUsedMemoryMb(ui32 devId) const {
+    auto devPtr = GetState().Devices[devId];
+    return devPtr->GetMemoryState().PeakUsedGpuRam * 1.0 / 1024 / 1024;
+}
+
+double TCudaManager::FragmentedMemoryMb(ui32 devId) const {
+    GetCudaManager().WaitComplete();
+    auto devPtr = GetState().Devices[devId];
+    return devPtr->GetMemoryState().FragmentedGpuRam * 1.0 / 1024 / 1024;
+}
+
 void TCudaManager::StopChild() {
     CB_ENSURE(IsChildManager);
     CB_ENSURE(ParentProfiler != nullptr);
@@ -78,6 +89,7 @@ void TCudaManager::StartChild(TCudaManager& parent,
     InitDefaultStream();
     CreateProfiler();
     GetProfiler().SetDefaultProfileMode(parent.GetProfiler().GetDefaultProfileMode());
+    GetProfiler().SetTraceEnabled(parent.GetProfiler().IsTraceEnabled());
     ParentProfiler = &parent.GetProfiler();
 }
 
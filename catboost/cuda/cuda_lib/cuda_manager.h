@@ -225,6 +225,11 @@ namespace NCudaLib {
 
         double TotalMemoryMb(ui32 devId) const;
 
+        //peak and fragmented memory of the device memory pool, for diagnostics of out of memory errors
+        double PeakUsedMemoryMb(ui32 devId) const;
+
+        double FragmentedMemoryMb(ui32 devId) const;
+
         //waits for finish all work submitted to selected devices
         void WaitComplete(TDevicesList&& devices);
 
@@ -1 +1,26 @@
 #include "cuda_profiler.h"
+
+#include <library/cpp/json/json_writer.h>
+
+namespace NCudaLib {
+    void TProfileTrace::Save(IOutputStream* output) const {
+        NJson::TJsonWriter writer(output, /*formatOutput*/ false);
+        writer.OpenMap();
+        writer.Write("displayTimeUnit", "ms");
+        writer.WriteKey("traceEvents");
+        writer.OpenArray();
+        for (const auto& event : Events) {
+            writer.OpenMap();
+            writer.Write("name", event.Label);
+            writer.Write("ph", "X");
+            writer.Write("ts", event.StartMicroseconds);
+            writer.Write("dur", event.DurationMicroseconds);
+            writer.Write("pid", 0);
+            writer.Write("tid", event.ThreadId);
+            writer.CloseMap();
+        }
+        writer.CloseArray();
+        writer.CloseMap();
+        writer.Flush();
+    }
+}
@@ -3,7 +3,9 @@
 #include "cuda_manager.h"
 #include <cmath>
 #include <util/generic/string.h>
+#include <util/generic/vector.h>
 #include <util/generic/yexception.h>
+#include <util/stream/output.h>
 
 namespace NCudaLib {
     enum class EProfileMode {
@@ -14,6 +16,55 @@ namespace NCudaLib {
         NoProfile
     };
 
+    //finished label intervals in chronological order, saved as chrome trace (chrome://tracing, ui.perfetto.dev)
+    class TProfileTrace {
+    public:
+        struct TEvent {
+            TString Label;
+            double StartMicroseconds;
+            double DurationMicroseconds;
+            ui32 ThreadId;
+        };
+
+    public:
+        bool IsEnabled() const {
+            return Enabled;
+        }
+
+        void SetEnabled(bool enabled) {
+            Enabled = enabled;
+        }
+
+        void AddEvent(const TString& label,
+                      std::chrono::high_resolution_clock::time_point start,
+                      std::chrono::high_resolution_clock::time_point end) {
+            using TMicroseconds = std::chrono::duration<double, std::micro>;
+            Events.push_back({
+                label,
+                std::chrono::duration_cast<TMicroseconds>(start.time_since_epoch()).count(),
+                std::chrono::duration_cast<TMicroseconds>(end - start).count(),
+                ThreadId
+            });
+        }
+
+        //events of child profilers are shown as separate threads
+        void Add(const TProfileTrace& other) {
+            const ui32 threadId = ++ChildCount;
+            for (const auto& event : other.Events) {
+                Events.push_back(event);
+                Events.back().ThreadId = threadId;
+            }
+        }
+
+        void Save(IOutputStream* output) const;
+
+    private:
+        bool Enabled = false;
+        ui32 ThreadId = 0;
+        ui32 ChildCount = 0;
+        TVector<TEvent> Events;
+    };
+
     class TLabeledInterval {
         TString Label;
         std::chrono::high_resolution_clock::time_point Time;
@@ -26,6 +77,7 @@ namespace NCudaLib {
         ui32* Nestedness;
         ui32 TabSize = 0;
         TMaybe<std::chrono::high_resolution_clock::time_point> Timestamp;
+        TProfileTrace* Trace;
 
         void UpdateTabSize(ui32 tabSize) {
             if (TabSize != tabSize) {
@@ -38,7 +90,8 @@ namespace NCudaLib {
 
     public:
         TLabeledInterval(const TString& label, ui32* nestedness,
-                         EProfileMode profileMode = EProfileMode::LabelAsync)
+                         EProfileMode profileMode = EProfileMode::LabelAsync,
+                         TProfileTrace* trace = nullptr)
             : Label(label)
             , Count(0)
             , Max(0.0)
@@ -47,6 +100,7 @@ namespace NCudaLib {
             , Active(false)
             , ProfileMode(profileMode)
             , Nestedness(nestedness)
+            , Trace(trace)
         {
             CB_ENSURE(nestedness, "Need nestedness counter");
             TabSize = *nestedness;
@@ -114,7 +168,11 @@ namespace NCudaLib {
                 GetCudaManager().WaitComplete();
             }
 
-            auto elapsed = std::chrono::high_resolution_clock::now() - Time;
+            const auto endTime = std::chrono::high_resolution_clock::now();
+            if (Trace && Trace->IsEnabled()) {
+                Trace->AddEvent(Label, Time, endTime);
+            }
+            auto elapsed = endTime - Time;
             double val = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * 1.0 / 1000 / 1000;
 
             Max = std::max(Max, val);
@@ -137,6 +195,7 @@ namespace NCudaLib {
         TLabeledInterval EmptyLabel;
         bool PrintOnDelete = true;
         ui32 Nestedness = 0;
+        TProfileTrace Trace;
 
     public:
         TCudaProfiler(EProfileMode profileMode = EProfileMode::LabelAsync,
@@ -177,10 +236,25 @@ namespace NCudaLib {
                 if (Labels.count(label) == 0) {
                     Labels[entry.first] = MakeHolder<TLabeledInterval>(label,
                                                                        &Nestedness,
-                                                                       DefaultProfileMode);
+                                                                       DefaultProfileMode,
+                                                                       &Trace);
                 }
                 Labels[entry.first]->Add(*entry.second);
             }
+            Trace.Add(other.Trace);
+        }
+
+        //record every profiled interval, not only aggregated statistics
+        inline void SetTraceEnabled(bool enabled) {
+            Trace.SetEnabled(enabled);
+        }
+
+        inline bool IsTraceEnabled() const {
+            return Trace.IsEnabled();
+        }
+
+        inline void SaveTrace(IOutputStream* output) const {
+            Trace.Save(output);
         }
 
         inline void SetDefaultProfileMode(EProfileMode mode) {
@@ -200,7 +274,8 @@ namespace NCudaLib {
             if (!Labels.count(label)) {
                 Labels[label] = MakeHolder<TLabeledInterval>(label,
                                                              &Nestedness,
-                                                             DefaultProfileMode);
+                                                             DefaultProfileMode,
+                                                             &Trace);
             }
             return Guard(*Labels[label]);
         }
@@ -363,6 +363,9 @@ namespace NCudaLib {
 
             result.RequestedGpuRam = DeviceMemoryProvider->GetRequestedRamSize();
             result.FreeGpuRam = DeviceMemoryProvider->GetFreeMemorySize();
+            result.PeakUsedGpuRam = DeviceMemoryProvider->GetPeakUsedMemorySize();
+            result.FragmentedGpuRam = DeviceMemoryProvider->GetFragmentedMemorySize();
+            result.GpuDefragmentationCount = DeviceMemoryProvider->GetDefragmentationCount();
             return result;
         }
 
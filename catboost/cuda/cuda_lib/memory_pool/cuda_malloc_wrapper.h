@@ -55,6 +55,18 @@ namespace NCudaLib {
             return freeBytes;
         }
 
+        ui64 GetPeakUsedMemorySize() const {
+            return 0;
+        }
+
+        ui64 GetFragmentedMemorySize() const {
+            return 0;
+        }
+
+        ui64 GetDefragmentationCount() const {
+            return 0;
+        }
+
         void TryDefragment() {
         }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <catboost/cuda/cuda_lib/cuda_base.h>
+#include <util/generic/utility.h>
 #include <util/generic/vector.h>
 #include <util/string/builder.h>
 #include <util/datetime/base.h>
@@ -10,6 +11,8 @@
  * Moreover, memory copy is pretty fast operation in GPU memory.
  * So for buffers we use simple stack-based scheme for memory allocation. We greedy allocate memory in last free block while we can.
  * If we don't have enough memory - we simply defragment it
+ * Holes freed in the middle of the stack are reused with best-fit search before falling back to the last block,
+ * so changing sizes of temporary buffers cause less defragmentations
  */
 
 namespace NCudaLib {
@@ -61,6 +64,20 @@ namespace NCudaLib {
             return TIntrusivePtr<TAllocatedBlock>(cursor);
         }
 
+        //smallest free block before the last one with at least size bytes, nullptr if there is no such block
+        TAllocatedBlock* FindBestFitFreeBlock(ui64 size) const {
+            TAllocatedBlock* bestBlock = nullptr;
+            for (TAllocatedBlock* cursor = FirstFreeBlock.Get(); cursor != LastBlock.Get(); cursor = cursor->Next.Get()) {
+                if (cursor->IsFree && cursor->Size >= size && (bestBlock == nullptr || cursor->Size < bestBlock->Size)) {
+                    bestBlock = cursor;
+                    if (bestBlock->Size == size) {
+                        break;
+                    }
+                }
+            }
+            return bestBlock;
+        }
+
         //splits free block to allocated and free
         TIntrusivePtr<TAllocatedBlock> SplitFreeBlock(TIntrusivePtr<TAllocatedBlock> block,
                                                       ui64 size) {
@@ -126,6 +143,8 @@ namespace NCudaLib {
         char* Memory = nullptr;
         ui64 TotalMemory;
         ui64 FreeMemory;
+        ui64 PeakUsedMemory = 0;
+        ui64 DefragmentationCount = 0;
         TIntrusivePtr<TAllocatedBlock> LastBlock;
 
         ui64 CalculateFragmentedMemorySize() const {
@@ -204,6 +223,7 @@ namespace NCudaLib {
                                << " in " << (Now() - startTime).SecondsFloat() << " seconds " << Endl;
             LastBlock->Size += defragmentedMemory;
             LastBlock->Ptr = startPtr + writeOffset;
+            ++DefragmentationCount;
 
             CB_ENSURE(LastBlock == cursor);
             FirstFreeBlock = LastBlock;
@@ -280,8 +300,8 @@ namespace NCudaLib {
         template <class T>
         bool NeedSyncForAllocation(ui64 size) const {
             const ui64 requestedBlockSize = GetBlockSize<T>(size) + MEMORY_REQUEST_ADJUSTMENT;
-            const bool canUseFirstFreeBlock = FirstFreeBlock != LastBlock && (FirstFreeBlock->Size >= requestedBlockSize);
-            return (LastBlock->Size < requestedBlockSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION)) && !canUseFirstFreeBlock;
+            const bool canUseFreeHole = FindBestFitFreeBlock(GetBlockSize<T>(size)) != nullptr;
+            return (LastBlock->Size < requestedBlockSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION)) && !canUseFreeHole;
         }
 
         template <typename T = char>
@@ -290,9 +310,9 @@ namespace NCudaLib {
 
             TIntrusivePtr<TAllocatedBlock> block = nullptr;
 
-            if (FirstFreeBlock->Size >= requestedBlockSize && (FirstFreeBlock != LastBlock)) {
-                Y_ASSERT(FirstFreeBlock->IsFree);
-                block = SplitFreeBlock(FirstFreeBlock, requestedBlockSize);
+            if (TAllocatedBlock* freeHole = FindBestFitFreeBlock(requestedBlockSize)) {
+                Y_ASSERT(freeHole->IsFree);
+                block = SplitFreeBlock(TIntrusivePtr<TAllocatedBlock>(freeHole), requestedBlockSize);
             } else {
                 const ui64 adjustedMemoryRequestSize = (requestedBlockSize + MEMORY_REQUEST_ADJUSTMENT);
                 const bool needDefragment = (LastBlock->Size < adjustedMemoryRequestSize || ((LastBlock->Size - requestedBlockSize) <= MINIMUM_FREE_MEMORY_TO_DEFRAGMENTATION));
@@ -301,7 +321,9 @@ namespace NCudaLib {
                 }
                 if (LastBlock->Size < adjustedMemoryRequestSize) {
                     ythrow TOutOfMemoryError() << "Error: Out of memory. Requested " << requestedBlockSize / MB << " MB; Free "
-                                               << (LastBlock->Size) / MB << " MB";
+                                               << (LastBlock->Size) / MB << " MB; Fragmented "
+                                               << CalculateFragmentedMemorySize() / MB << " MB; Peak used "
+                                               << PeakUsedMemory / MB << " MB";
                 }
                 block = SplitFreeBlock(LastBlock, requestedBlockSize);
                 Y_ASSERT(FirstFreeBlock->Ptr <= LastBlock->Ptr);
@@ -309,6 +331,7 @@ namespace NCudaLib {
             Y_ASSERT(FirstFreeBlock->Ptr <= LastBlock->Ptr);
 
             FreeMemory -= block->Size;
+            PeakUsedMemory = Max(PeakUsedMemory, TotalMemory - FreeMemory);
             return new TMemoryBlock<T>(block, *this);
         }
 
@@ -338,6 +361,19 @@ namespace NCudaLib {
         ui64 GetFreeMemorySize() const {
             return FreeMemory;
         }
+
+        ui64 GetPeakUsedMemorySize() const {
+            return PeakUsedMemory;
+        }
+
+        //free memory which is not available for stack allocations without defragmentation
+        ui64 GetFragmentedMemorySize() const {
+            return CalculateFragmentedMemorySize();
+        }
+
+        ui64 GetDefragmentationCount() const {
+            return DefragmentationCount;
+        }
     };
 
     extern template class TStackLikeMemoryPool<EPtrType::CudaDevice>;
@@ -28,6 +28,32 @@ Y_UNIT_TEST_SUITE(TMemoryPoolTest) {
         }
     }
 
+    Y_UNIT_TEST(TestBestFitHoleReuse) {
+        TStackLikeMemoryPool<EPtrType::Host> pool(64 * 1024);
+        using TPtr = THolder<std::remove_pointer<decltype(pool.Create(0))>::type>;
+
+        TPtr block1(pool.Create(1024));
+        TPtr block2(pool.Create(4096));
+        TPtr block3(pool.Create(1024));
+        TPtr block4(pool.Create(1024));
+        TPtr block5(pool.Create(1024));
+        const ui64 peakUsed = pool.GetPeakUsedMemorySize();
+        UNIT_ASSERT_VALUES_EQUAL(peakUsed, 8192);
+
+        auto* const bigHole = block2->Get();
+        auto* const smallHole = block4->Get();
+        block2.Reset(nullptr);
+        block4.Reset(nullptr);
+        UNIT_ASSERT_VALUES_EQUAL(pool.GetFragmentedMemorySize(), 4096 + 1024);
+
+        TPtr smallBlock(pool.Create(1000));
+        UNIT_ASSERT_EQUAL(smallBlock->Get(), smallHole);
+        TPtr bigBlock(pool.Create(3000));
+        UNIT_ASSERT_EQUAL(bigBlock->Get(), bigHole);
+        UNIT_ASSERT_VALUES_EQUAL(pool.GetPeakUsedMemorySize(), peakUsed);
+        UNIT_ASSERT_VALUES_EQUAL(pool.GetDefragmentationCount(), 0);
+    }
+
     Y_UNIT_TEST(TestSimpleDefragment) {
         TSetLoggingVerbose inThisScope;
         const ui64 MB = 1024 * 1024;
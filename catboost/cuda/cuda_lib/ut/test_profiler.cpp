@@ -0,0 +1,50 @@
+#include <catboost/cuda/cuda_lib/cuda_profiler.h>
+#include <library/cpp/json/json_reader.h>
+#include <library/cpp/testing/unittest/registar.h>
+#include <util/stream/str.h>
+
+using namespace NCudaLib;
+
+Y_UNIT_TEST_SUITE(TCudaProfilerTest) {
+    Y_UNIT_TEST(TestTrace) {
+        TCudaProfiler profiler(EProfileMode::LabelAsync, 0, false);
+        profiler.SetTraceEnabled(true);
+        for (ui32 i = 0; i < 2; ++i) {
+            auto outerGuard = profiler.Profile("outer \"label\"");
+            auto innerGuard = profiler.Profile("inner");
+        }
+
+        TCudaProfiler childProfiler(EProfileMode::LabelAsync, 0, false);
+        childProfiler.SetTraceEnabled(true);
+        {
+            auto guard = childProfiler.Profile("child");
+        }
+        profiler.Add(childProfiler);
+
+        TStringStream trace;
+        profiler.SaveTrace(&trace);
+        NJson::TJsonValue json;
+        UNIT_ASSERT(NJson::ReadJsonTree(trace.Str(), &json));
+        const auto& events = json["traceEvents"].GetArraySafe();
+        UNIT_ASSERT_VALUES_EQUAL(events.size(), 5);
+        UNIT_ASSERT_VALUES_EQUAL(events[0]["name"].GetStringSafe(), "inner");
+        UNIT_ASSERT_VALUES_EQUAL(events[1]["name"].GetStringSafe(), "outer \"label\"");
+        UNIT_ASSERT(events[1]["ts"].GetDoubleSafe() <= events[0]["ts"].GetDoubleSafe());
+        UNIT_ASSERT(events[1]["dur"].GetDoubleSafe() >= events[0]["dur"].GetDoubleSafe());
+        UNIT_ASSERT_VALUES_EQUAL(events[1]["tid"].GetIntegerSafe(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(events[4]["name"].GetStringSafe(), "child");
+        UNIT_ASSERT_VALUES_EQUAL(events[4]["tid"].GetIntegerSafe(), 1);
+    }
+
+    Y_UNIT_TEST(TestTraceIsDisabledByDefault) {
+        TCudaProfiler profiler(EProfileMode::LabelAsync, 0, false);
+        {
+            auto guard = profiler.Profile("label");
+        }
+        TStringStream trace;
+        profiler.SaveTrace(&trace);
+        NJson::TJsonValue json;
+        UNIT_ASSERT(NJson::ReadJsonTree(trace.Str(), &json));
+        UNIT_ASSERT(json["traceEvents"].GetArraySafe().empty());
+    }
+}
@@ -8,8 +8,19 @@ namespace NCudaLib {
         ui64 RequestedGpuRam = 0;
         ui64 FreePinnedRam = 0;
         ui64 RequestedPinnedRam = 0;
+        ui64 PeakUsedGpuRam = 0;
+        ui64 FragmentedGpuRam = 0;
+        ui64 GpuDefragmentationCount = 0;
 
-        Y_SAVELOAD_DEFINE(FreeGpuRam, RequestedGpuRam, FreePinnedRam, RequestedPinnedRam);
+        Y_SAVELOAD_DEFINE(
+            FreeGpuRam,
+            RequestedGpuRam,
+            FreePinnedRam,
+            RequestedPinnedRam,
+            PeakUsedGpuRam,
+            FragmentedGpuRam,
+            GpuDefragmentationCount
+        );
     };
 
     class IWorkerStateProvider {
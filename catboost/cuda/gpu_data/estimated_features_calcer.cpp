@@ -1,60 +1,199 @@
 #include "estimated_features_calcer.h"
 #include "gpu_binarization_helpers.h"
 
+#include <library/cpp/threading/future/async.h>
+
+#include <util/generic/deque.h>
+#include <util/generic/scope.h>
+#include <util/system/condvar.h>
+#include <util/system/mutex.h>
+#include <util/thread/pool.h>
+
 namespace NCatboostCuda {
 
+    namespace {
+        /* Writers of features computed in the background thread, executed by the calling thread in order.
+         * The total size of features waiting to be written is limited, the estimation thread waits when it is exceeded.
+         */
+        class TComputedFeaturesQueue {
+        public:
+            using TWriter = std::function<void()>;
+
+        public:
+            explicit TComputedFeaturesQueue(size_t maxQueuedSize)
+                : MaxQueuedSize(maxQueuedSize)
+            {
+            }
+
+            // a single writer larger than the limit is still queued if the queue is empty
+            void Push(TWriter&& writer, size_t size) {
+                with_lock (Mutex) {
+                    while (!Cancelled && !Writers.empty() && (QueuedSize + size > MaxQueuedSize)) {
+                        CondVar.WaitI(Mutex);
+                    }
+                    CB_ENSURE(!Cancelled, "Estimated features writing has failed");
+                    Writers.emplace_back(std::move(writer), size);
+                    QueuedSize += size;
+                }
+                CondVar.BroadCast();
+            }
+
+            // returns false when the queue is finished and all writers are taken
+            bool Pop(TWriter* writer) {
+                with_lock (Mutex) {
+                    while (Writers.empty() && !Finished) {
+                        CondVar.WaitI(Mutex);
+                    }
+                    if (Writers.empty()) {
+                        return false;
+                    }
+                    *writer = std::move(Writers.front().first);
+                    QueuedSize -= Writers.front().second;
+                    Writers.pop_front();
+                }
+                CondVar.BroadCast();
+                return true;
+            }
+
+            void Finish() {
+                with_lock (Mutex) {
+                    Finished = true;
+                }
+                CondVar.BroadCast();
+            }
+
+            // makes waiting and next Push calls fail
+            void Cancel() {
+                with_lock (Mutex) {
+                    Cancelled = true;
+                    Writers.clear();
+                }
+                CondVar.BroadCast();
+            }
+
+        private:
+            const size_t MaxQueuedSize;
+
+            TMutex Mutex;
+            TCondVar CondVar;
+            TDeque<std::pair<TWriter, size_t>> Writers;
+            size_t QueuedSize = 0;
+            bool Finished = false;
+            bool Cancelled = false;
+        };
+    }
+
+    // to overlap estimation of next features with writing of the previous ones without much additional memory
+    static constexpr size_t MaxQueuedComputedFeaturesSize = 256 << 20;
+
+    /* Calls computeFeatures(estimator, queue) for all estimatorIds in a background thread
+     * and executes writers pushed to the queue in this thread.
+     */
+    template <class TComputeFeatures>
+    static void ComputeFeaturesInBackground(
+        TConstArrayRef<NCB::TEstimatorId> estimatorIds,
+        const TComputeFeatures& computeFeatures
+    ) {
+        if (estimatorIds.empty()) {
+            return;
+        }
+        TComputedFeaturesQueue queue(MaxQueuedComputedFeaturesSize);
+
+        TThreadPool estimationThread;
+        estimationThread.Start(1);
+        auto estimation = NThreading::Async(
+            [&] () {
+                Y_DEFER {
+                    queue.Finish();
+                };
+                for (const auto& estimator : estimatorIds) {
+                    computeFeatures(estimator, &queue);
+                }
+            },
+            estimationThread
+        );
+
+        try {
+            TComputedFeaturesQueue::TWriter writer;
+            while (queue.Pop(&writer)) {
+                writer();
+            }
+        } catch (...) {
+            queue.Cancel();
+            estimation.Wait();
+            throw;
+        }
+        estimation.GetValueSync();
+        estimationThread.Stop();
+    }
+
+    void TEstimatorsExecutor::ComputeFeatures(
+        const NCB::TEstimatorId& estimator,
+        const NCB::TCalculatedFeatureVisitor& learnVisitor,
+        TConstArrayRef<NCB::TCalculatedFeatureVisitor> testVisitors
+    ) {
+        if (estimator.IsOnline) {
+            Estimators.GetOnlineFeatureEstimator(estimator.Id)->ComputeOnlineFeatures(
+                PermutationIndices,
+                learnVisitor,
+                testVisitors,
+                LocalExecutor
+            );
+        } else {
+            Estimators.GetFeatureEstimator(estimator.Id)->ComputeFeatures(learnVisitor, testVisitors, LocalExecutor);
+        }
+    }
+
     void TEstimatorsExecutor::ExecEstimators(
         TConstArrayRef<NCB::TEstimatorId> estimatorIds,
         TBinarizedFeatureVisitor learnBinarizedVisitor,
         TMaybe<TBinarizedFeatureVisitor> testBinarizedVisitor
     ) {
         TGpuBordersBuilder bordersBuilder(FeaturesManager);
-        for (const auto& estimator : estimatorIds) {
-            auto featureVisitor = [&](TBinarizedFeatureVisitor visitor, ui32 featureId, TConstArrayRef<float> values) {
-                NCB::TEstimatedFeatureId feature{estimator, featureId};
-                auto id = FeaturesManager.GetId(feature);
-                auto borders = bordersBuilder.GetOrComputeBorders(id, FeaturesManager.GetBinarizationDescription(feature), values);
-                auto binarized = NCB::BinarizeLine<ui8>(values,
-                                                        ENanMode::Forbidden,
-                                                        borders);
-                CB_ENSURE(borders.size() <= 255, "Error: too many borders " << borders.size());
-                const ui8 binCount = borders.size() + 1;
-                visitor(binarized, feature, binCount);
-            };
-
-            NCB::TCalculatedFeatureVisitor learnVisitor{
-                std::bind(
-                    featureVisitor,
-                    learnBinarizedVisitor,
-                    std::placeholders::_1,
-                    std::placeholders::_2
-                )
-            };
+        // called in this thread only
+        auto featureVisitor = [&](
+            const TBinarizedFeatureVisitor& visitor,
+            NCB::TEstimatorId estimator,
+            ui32 featureId,
+            TConstArrayRef<float> values
+        ) {
+            NCB::TEstimatedFeatureId feature{estimator, featureId};
+            auto id = FeaturesManager.GetId(feature);
+            auto borders = bordersBuilder.GetOrComputeBorders(id, FeaturesManager.GetBinarizationDescription(feature), values);
+            auto binarized = NCB::BinarizeLine<ui8>(values,
+                                                    ENanMode::Forbidden,
+                                                    borders);
+            CB_ENSURE(borders.size() <= 255, "Error: too many borders " << borders.size());
+            const ui8 binCount = borders.size() + 1;
+            visitor(binarized, feature, binCount);
+        };
 
-            TVector<NCB::TCalculatedFeatureVisitor> testVisitors;
-            if (testBinarizedVisitor) {
-                testVisitors.push_back(
-                    NCB::TCalculatedFeatureVisitor{
-                        std::bind(
-                            featureVisitor,
-                            *testBinarizedVisitor,
-                            std::placeholders::_1,
-                            std::placeholders::_2
+        ComputeFeaturesInBackground(
+            estimatorIds,
+            [&] (const NCB::TEstimatorId& estimator, TComputedFeaturesQueue* queue) {
+                auto makeVisitor = [&] (const TBinarizedFeatureVisitor* visitor) {
+                    return NCB::TCalculatedFeatureVisitor{
+                        NCB::TCalculatedFeatureVisitor::TSingleFeatureWriter(
+                            [&featureVisitor, visitor, estimator, queue] (ui32 featureId, TConstArrayRef<float> values) {
+                                TVector<float> valuesCopy(values.begin(), values.end());
+                                queue->Push(
+                                    [&featureVisitor, visitor, estimator, featureId, values = std::move(valuesCopy)] () {
+                                        featureVisitor(*visitor, estimator, featureId, values);
+                                    },
+                                    values.size() * sizeof(float)
+                                );
+                            }
                         )
-                    }
-                );
-            }
+                    };
+                };
 
-            if (estimator.IsOnline) {
-                Estimators.GetOnlineFeatureEstimator(estimator.Id)->ComputeOnlineFeatures(
-                    PermutationIndices,
-                    learnVisitor,
-                    testVisitors,
-                    LocalExecutor);
-            } else {
-                Estimators.GetFeatureEstimator(estimator.Id)->ComputeFeatures(learnVisitor, testVisitors, LocalExecutor);
+                TVector<NCB::TCalculatedFeatureVisitor> testVisitors;
+                if (testBinarizedVisitor) {
+                    testVisitors.push_back(makeVisitor(testBinarizedVisitor.Get()));
+                }
+                ComputeFeatures(estimator, makeVisitor(&learnBinarizedVisitor), testVisitors);
             }
-        }
+        );
     }
 
     static ui8 ExtractFeatureFromPack(ui32 featurePack, ui32 featureIndex) {
@@ -76,69 +215,65 @@ namespace NCatboostCuda {
         TBinarizedFeatureVisitor learnBinarizedVisitor,
         TMaybe<TBinarizedFeatureVisitor> testBinarizedVisitor
     ) {
-        for (const auto& estimator : estimatorIds) {
-            auto featureVisitor =
-                [&](
-                    TBinarizedFeatureVisitor visitor,
-                    TConstArrayRef<ui32> featureIds,
-                    TConstArrayRef<ui32> binFeatures
-                ) {
-                    TVector<ui8> binarized(binFeatures.size());
-                    const ui8 binCount = 2;
-                    for (ui32 i: xrange(featureIds.size())) {
-                        NCB::TEstimatedFeatureId feature{estimator, featureIds[i]};
-
-                        auto id = FeaturesManager.GetId(feature);
-                        if (!FeaturesManager.HasBorders(id)) {
-                            FeaturesManager.SetBorders(id, {0.5});
-                        }
-
-                        ExtractFeatureFromPack(
-                            MakeConstArrayRef(binFeatures),
-                            i,
-                            TArrayRef<ui8>(binarized.data(), binarized.size())
-                        );
-                        visitor(binarized, feature, binCount);
+        // called in this thread only
+        auto featureVisitor =
+            [&](
+                const TBinarizedFeatureVisitor& visitor,
+                NCB::TEstimatorId estimator,
+                TConstArrayRef<ui32> featureIds,
+                TConstArrayRef<ui32> binFeatures
+            ) {
+                TVector<ui8> binarized(binFeatures.size());
+                const ui8 binCount = 2;
+                for (ui32 i: xrange(featureIds.size())) {
+                    NCB::TEstimatedFeatureId feature{estimator, featureIds[i]};
+
+                    auto id = FeaturesManager.GetId(feature);
+                    if (!FeaturesManager.HasBorders(id)) {
+                        FeaturesManager.SetBorders(id, {0.5});
                     }
-                };
 
-            NCB::TCalculatedFeatureVisitor learnVisitor{
-                std::bind(
-                    featureVisitor,
-                    learnBinarizedVisitor,
-                    std::placeholders::_1,
-                    std::placeholders::_2
-                )
+                    ExtractFeatureFromPack(
+                        MakeConstArrayRef(binFeatures),
+                        i,
+                        TArrayRef<ui8>(binarized.data(), binarized.size())
+                    );
+                    visitor(binarized, feature, binCount);
+                }
             };
-            TVector<NCB::TCalculatedFeatureVisitor> testVisitors;
-            if (testBinarizedVisitor) {
-                testVisitors.push_back(
-                    NCB::TCalculatedFeatureVisitor{
-                        std::bind(
-                            featureVisitor,
-                            *testBinarizedVisitor,
-                            std::placeholders::_1,
-                            std::placeholders::_2
+
+        ComputeFeaturesInBackground(
+            estimatorIds,
+            [&] (const NCB::TEstimatorId& estimator, TComputedFeaturesQueue* queue) {
+                auto makeVisitor = [&] (const TBinarizedFeatureVisitor* visitor) {
+                    return NCB::TCalculatedFeatureVisitor{
+                        NCB::TCalculatedFeatureVisitor::TPackedFeatureWriter(
+                            [&featureVisitor, visitor, estimator, queue] (
+                                TConstArrayRef<ui32> featureIds,
+                                TConstArrayRef<ui32> binFeatures
+                            ) {
+                                TVector<ui32> featureIdsCopy(featureIds.begin(), featureIds.end());
+                                TVector<ui32> binFeaturesCopy(binFeatures.begin(), binFeatures.end());
+                                queue->Push(
+                                    [&featureVisitor, visitor, estimator,
+                                     featureIds = std::move(featureIdsCopy),
+                                     binFeatures = std::move(binFeaturesCopy)] () {
+                                        featureVisitor(*visitor, estimator, featureIds, binFeatures);
+                                    },
+                                    binFeatures.size() * sizeof(ui32)
+                                );
+                            }
                         )
-                    }
-                );
-            }
+                    };
+                };
 
-            if (estimator.IsOnline) {
-                Estimators.GetOnlineFeatureEstimator(estimator.Id)->ComputeOnlineFeatures(
-                    PermutationIndices,
-                    learnVisitor,
-                    testVisitors,
-                    LocalExecutor
-                );
-            } else {
-                Estimators.GetFeatureEstimator(estimator.Id)->ComputeFeatures(
-                    learnVisitor,
-                    testVisitors,
-                    LocalExecutor
-                );
+                TVector<NCB::TCalculatedFeatureVisitor> testVisitors;
+                if (testBinarizedVisitor) {
+                    testVisitors.push_back(makeVisitor(testBinarizedVisitor.Get()));
+                }
+                ComputeFeatures(estimator, makeVisitor(&learnBinarizedVisitor), testVisitors);
             }
-        }
+        );
     }
 
 }
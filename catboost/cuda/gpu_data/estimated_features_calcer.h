@@ -13,6 +13,9 @@
 
 namespace NCatboostCuda {
 
+    /* Estimators compute features on CPU in a background thread, while the calling thread binarizes
+     * already computed features and passes them to visitors (that write them to GPU).
+     */
     class TEstimatorsExecutor {
     public:
         using TBinarizedFeatureVisitor =  std::function<void(TConstArrayRef<ui8>, //binarizedFeature
@@ -40,6 +43,11 @@ namespace NCatboostCuda {
                                           TMaybe<TBinarizedFeatureVisitor> testVisitor
                                           );
 
+    private:
+        void ComputeFeatures(const NCB::TEstimatorId& estimator,
+                             const NCB::TCalculatedFeatureVisitor& learnVisitor,
+                             TConstArrayRef<NCB::TCalculatedFeatureVisitor> testVisitors);
+
     private:
         TBinarizedFeaturesManager& FeaturesManager;
         const NCB::TFeatureEstimators& Estimators;
@@ -88,6 +88,7 @@ namespace NCatboostCuda {
                     *BestTestCursor = TStripeBuffer<float>::CopyMappingAndColumnCount(*other.BestTestCursor);
                     BestTestCursor->Copy(*other.BestTestCursor);
                 }
+                StartingPoint = other.StartingPoint;
             }
         };
 
@@ -580,7 +581,8 @@ namespace NCatboostCuda {
                 &baseCursors->Cursors,
                 TestDataProvider ? &baseCursors->TestCursor : nullptr
             );
-            auto startingBaseCursors = CreateCursors(*baseInputData);
+            // copies of cursors don't need initialization by CreateCursors (it uploads starting approxes)
+            auto startingBaseCursors = MakeHolder<TBoostingCursors>();
             startingBaseCursors->CopyFrom(*baseCursors);
 
             const ui32 experimentSize = ModelBasedEvalConfig.ExperimentSize;
@@ -623,7 +625,7 @@ namespace NCatboostCuda {
                 for (experimentIdx = 0; experimentIdx < ModelBasedEvalConfig.ExperimentCount; ++experimentIdx) {
                     auto metricSaver = ProgressTracker->Clone(forceMetricSaveFunc);
                     TVector<TEnsemble> ignoredModels(permutationCount);
-                    auto experimentCursors = CreateCursors(*inputData);
+                    auto experimentCursors = MakeHolder<TBoostingCursors>();
                     experimentCursors->CopyFrom(*baseCursors);
                     BaseIterationSeed = savedBaseSeed + getExperimentStart(experimentIdx);
                     Fit(inputData->DataSets,
@@ -637,6 +639,9 @@ namespace NCatboostCuda {
                         &ignoredModels,
                         experimentCursors->BestTestCursor.Get()
                     );
+                    if (experimentIdx + 1 == ModelBasedEvalConfig.ExperimentCount.Get()) {
+                        break; // base cursors after the last experiment are not used
+                    }
                     AppendEnsembles(
                         baseInputData->DataSets,
                         baseModels,
@@ -6,45 +6,6 @@
 
 namespace NKernelHost {
 
-    class TComputeNeedWeightsKernel: public TStatelessKernel {
-    private:
-        TCudaBufferPtr<const float> Targets;
-        TCudaBufferPtr<const float> Weights;
-        TCudaBufferPtr<const ui32> Offsets;
-        TCudaBufferPtr<float> NeedWeights;
-        float Alpha;
-
-    public:
-        TComputeNeedWeightsKernel() = default;
-
-        TComputeNeedWeightsKernel(TCudaBufferPtr<const float> targets,
-                                  TCudaBufferPtr<const float> weights,
-                                  TCudaBufferPtr<const ui32> offsets,
-                                  TCudaBufferPtr<float> needWeights,
-                                  float alpha)
-                : Targets(targets)
-                , Weights(weights)
-                , Offsets(offsets)
-                , NeedWeights(needWeights)
-                , Alpha(alpha)
-        {
-        }
-
-        Y_SAVELOAD_DEFINE(Targets, Weights, Offsets, NeedWeights, Alpha);
-
-        void Run(const TCudaStream& stream) const {
-            NKernel::ComputeNeedWeights(Targets.Get(),
-                                        Weights.Get(),
-                                        Targets.Size(),
-                                        NeedWeights.Size(),
-                                        Offsets.Get(),
-                                        Offsets.Get() + 1,
-                                        NeedWeights.Get(),
-                                        Alpha,
-                                        stream.GetStream());
-        }
-    };
-
     class TComputeWeightsWithTargetsKernel: public TStatelessKernel {
     private:
         TCudaBufferPtr<const float> Targets;
@@ -78,48 +39,39 @@ namespace NKernelHost {
     private:
         TCudaBufferPtr<const float> Targets;
         TCudaBufferPtr<const float> WeightsPrefixSum;
-        TCudaBufferPtr<const float> NeedWeights;
         TCudaBufferPtr<const ui32> Offsets;
         ui32 BinCount;
         TCudaBufferPtr<float> Point;
         float Alpha;
-        ui32 BinarySearchIterations;
 
     public:
         TComputeWeightedQuantileWithBinarySearchKernel() = default;
 
         TComputeWeightedQuantileWithBinarySearchKernel(TCudaBufferPtr<const float> targets,
                                                        TCudaBufferPtr<const float> weightsPrefixSum,
-                                                       TCudaBufferPtr<const float> needWeights,
                                                        TCudaBufferPtr<const ui32> offsets,
                                                        ui32 binCount,
                                                        TCudaBufferPtr<float> point,
-                                                       float alpha,
-                                                       ui32 binarySearchIterations)
+                                                       float alpha)
                 : Targets(targets)
                 , WeightsPrefixSum(weightsPrefixSum)
-                , NeedWeights(needWeights)
                 , Offsets(offsets)
                 , BinCount(binCount)
                 , Point(point)
                 , Alpha(alpha)
-                , BinarySearchIterations(binarySearchIterations)
         {
         }
 
-        Y_SAVELOAD_DEFINE(Targets, WeightsPrefixSum, NeedWeights, Offsets, Point, BinCount, BinarySearchIterations, Alpha);
+        Y_SAVELOAD_DEFINE(Targets, WeightsPrefixSum, Offsets, Point, BinCount, Alpha);
 
         void Run(const TCudaStream& stream) const {
             NKernel::ComputeWeightedQuantileWithBinarySearch(Targets.Get(),
                                                              WeightsPrefixSum.Get(),
-                                                             Targets.Size(),
-                                                             NeedWeights.Get(),
                                                              Offsets.Get(),
                                                              Offsets.Get() + 1,
                                                              BinCount,
                                                              Point.Get(),
                                                              Alpha,
-                                                             BinarySearchIterations,
                                                              stream.GetStream());
         }
     };
@@ -154,17 +106,6 @@ namespace NKernelHost {
     };
 }
 
-template <class TMapping>
-inline void ComputeNeedWeights(TCudaBuffer<float, TMapping>& targets,
-                               TCudaBuffer<float, TMapping>& weights,
-                               TCudaBuffer<ui32, TMapping>& offsets,
-                               TCudaBuffer<float, TMapping>* needWeights,
-                               float alpha,
-                               ui32 stream = 0) {
-    using TKernel = NKernelHost::TComputeNeedWeightsKernel;
-    LaunchKernels<TKernel>(targets.NonEmptyDevices(), stream, targets, weights, offsets, needWeights, alpha);
-}
-
 template <class TMapping>
 inline void ComputeWeightsWithTargets(const TCudaBuffer<float, TMapping>& targets,
                                       const TCudaBuffer<float, TMapping>& weights,
@@ -177,15 +118,13 @@ inline void ComputeWeightsWithTargets(const TCudaBuffer<float, TMapping>& target
 template <class TDataMapping, class TPointMapping>
 inline void CalculateQuantileWithBinarySearch(const TCudaBuffer<float, TDataMapping>& targets,
                                               const TCudaBuffer<float, TDataMapping>& weightsPrefixSum,
-                                              const TCudaBuffer<float, TPointMapping>& needWeights,
                                               const TCudaBuffer<ui32, TDataMapping>& offsets,
                                               ui32 binCount,
                                               TCudaBuffer<float, TPointMapping>* point,
                                               float alpha,
-                                              ui32 binarySearchIterations,
                                               ui32 stream = 0) {
     using TKernel = NKernelHost::TComputeWeightedQuantileWithBinarySearchKernel;
-    LaunchKernels<TKernel>(targets.NonEmptyDevices(), stream, targets, weightsPrefixSum, needWeights, offsets, binCount, point, alpha, binarySearchIterations);
+    LaunchKernels<TKernel>(targets.NonEmptyDevices(), stream, targets, weightsPrefixSum, offsets, binCount, point, alpha);
 }
 
 template <class TMapping>
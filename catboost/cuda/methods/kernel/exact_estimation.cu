@@ -4,74 +4,44 @@
 
 namespace NKernel {
 
+    // first object of each sorted bin with weights prefix sum reaching alpha of bin total weight,
+    // total weight is the last element of inclusive weights prefix sum of the bin
     template <int BLOCK_SIZE>
     __global__ void ComputeWeightedQuantileWithBinarySearchImpl(const float* targets,
                                                                 const float* weightsPrefixSum,
-                                                                ui32 objectsCount,
-                                                                const float* needWeights,
                                                                 const ui32* beginOffsets,
                                                                 const ui32* endOffsets,
+                                                                ui32 binCount,
                                                                 float* point,
-                                                                float alpha,
-                                                                ui32 binarySearchIterations) {
+                                                                float alpha) {
         const ui32 i = blockIdx.x * BLOCK_SIZE + threadIdx.x;
-        if (i >= objectsCount) {
+        if (i >= binCount) {
             return;
         }
 
-        ui32 left = beginOffsets[i];
-        ui32 right = endOffsets[i] == 0 ? 0 : endOffsets[i] - 1;
+        const ui32 begin = beginOffsets[i];
+        const ui32 end = endOffsets[i];
 
-        if (left > right) {
+        if (begin >= end) {
             point[i] = 0;
             return;
         }
 
         const float eps = std::numeric_limits<float>::epsilon();
-        for (ui32 index = 0; index < binarySearchIterations; ++index) {
-            ui32 middle = left + (right - left) / 2;
-
-            if (weightsPrefixSum[middle] < needWeights[i] - eps) {
-                left = middle;
+        const float needWeight = weightsPrefixSum[end - 1] * alpha - eps;
+        ui32 left = begin;
+        ui32 right = end - 1;
+        while (left < right) {
+            const ui32 middle = left + (right - left) / 2;
+
+            if (weightsPrefixSum[middle] < needWeight) {
+                left = middle + 1;
             } else {
                 right = middle;
             }
         }
 
-        point[i] = targets[right];
-        return;
-    }
-
-    template <int BLOCK_SIZE>
-    __global__ void ComputeNeedWeightsImpl(const float* targets,
-                                           const float* weights,
-                                           const ui32* beginOffsets,
-                                           const ui32* endOffsets,
-                                           float* needWeights,
-                                           float alpha,
-                                           ui32 elementsPerThreads) {
-        const ui32 begin = beginOffsets[blockIdx.x] + threadIdx.x;
-        const ui32 end = endOffsets[blockIdx.x];
-
-        __shared__ float localBuffer[BLOCK_SIZE];
-        localBuffer[threadIdx.x] = 0;
-
-        if (begin >= end) {
-            return;
-        }
-
-        float totalSum = 0;
-        for (ui32 idx = begin; idx < end; idx += BLOCK_SIZE) {
-            totalSum += weights[idx];
-        }
-
-        localBuffer[threadIdx.x] = totalSum;
-        __syncthreads();
-
-        float blocksSum = FastInBlockReduce<float>(threadIdx.x, localBuffer, BLOCK_SIZE);
-        if (threadIdx.x == 0) {
-            needWeights[blockIdx.x] = blocksSum * alpha;
-        }
+        point[i] = targets[left];
     }
 
     __global__ void ComputeWeightsWithTargetsImpl(const float* targets,
@@ -101,28 +71,6 @@ namespace NKernel {
         flags[begin] = 1;
     }
 
-    void ComputeNeedWeights(const float* targets,
-                            const float* weights,
-                            ui32 objectsCount,
-                            ui32 binCount,
-                            const ui32* beginOffsets,
-                            const ui32* endOffsets,
-                            float* needWeights,
-                            float alpha,
-                            TCudaStream stream) {
-        const ui32 blockSize = 1024;
-        const ui32 blocksNum = binCount;
-        const ui32 elementsPerThreads = CeilDivide(objectsCount, blockSize * blocksNum);
-
-        ComputeNeedWeightsImpl<blockSize> << < blocksNum, blockSize, 0, stream >> > (targets,
-                                                                                     weights,
-                                                                                     beginOffsets,
-                                                                                     endOffsets,
-                                                                                     needWeights,
-                                                                                     alpha,
-                                                                                     elementsPerThreads);
-    }
-
     void ComputeWeightsWithTargets(const float* targets,
                                    const float* weights,
                                    float* weightsWithTargets,
@@ -139,27 +87,22 @@ namespace NKernel {
 
     void ComputeWeightedQuantileWithBinarySearch(const float* targets,
                                                  const float* weightsPrefixSum,
-                                                 ui32 objectsCount,
-                                                 const float* needWeights,
                                                  const ui32* beginOffsets,
                                                  const ui32* endOffsets,
                                                  ui32 binCount,
                                                  float* point,
                                                  float alpha,
-                                                 ui32 binarySearchIterations,
                                                  TCudaStream stream) {
         const ui32 blockSize = 256;
         const ui32 blocksNum = CeilDivide(binCount, blockSize);
 
         ComputeWeightedQuantileWithBinarySearchImpl<blockSize> << < blocksNum, blockSize, 0, stream >> > (targets,
                                                                                                           weightsPrefixSum,
-                                                                                                          objectsCount,
-                                                                                                          needWeights,
                                                                                                           beginOffsets,
                                                                                                           endOffsets,
+                                                                                                          binCount,
                                                                                                           point,
-                                                                                                          alpha,
-                                                                                                          binarySearchIterations);
+                                                                                                          alpha);
     }
 
     void MakeEndOfBinsFlags(const ui32* beginOffsets,
@@ -67,8 +67,7 @@ namespace NCatboostCuda {
                                  const TCudaBuffer<float, TMapping>& weights,
                                  ui32 binCount,
                                  TVector<float>& point,
-                                 const NCatboostOptions::TLossDescription& lossDescription,
-                                 ui32 binarySearchIterations) {
+                                 const NCatboostOptions::TLossDescription& lossDescription) {
         const auto &params = lossDescription.GetLossParamsMap();
         auto it = params.find("alpha");
         float alpha = it == params.end() ? 0.5 : FromString<float>(it->second);
@@ -120,27 +119,14 @@ namespace NCatboostCuda {
         SegmentedScanVector(orderedWeights, endOfBinsFlags, weightsPrefixSum, true, 1);
         //
 
-        //
         auto pointMapping = NCudaLib::TSingleMapping(0, binCount);
-        auto needWeights = TSingleBuffer<float>::Create(pointMapping);
-        FillBuffer(needWeights, 0.0f);
-
-        ComputeNeedWeights(orderedTargets,
-                           orderedWeights,
-                           binsOffsets,
-                           &needWeights,
-                           alpha);
-        //
-
         auto result = TSingleBuffer<float>::Create(pointMapping);
         CalculateQuantileWithBinarySearch(orderedTargets,
                                           weightsPrefixSum,
-                                          needWeights,
                                           binsOffsets,
                                           binCount,
                                           &result,
-                                          alpha,
-                                          binarySearchIterations);
+                                          alpha);
 
         result.Read(point);
     }
@@ -151,8 +137,7 @@ namespace NCatboostCuda {
                             const TCudaBuffer<float, TMapping>& weights,
                             ui32 binCount,
                             TVector<float>& point,
-                            const NCatboostOptions::TLossDescription& lossDescription,
-                            ui32 binarySearchIterations = 16) {
+                            const NCatboostOptions::TLossDescription& lossDescription) {
         switch (lossDescription.GetLossFunction()) {
             case ELossFunction::Quantile:
             case ELossFunction::MAE: {
@@ -161,8 +146,7 @@ namespace NCatboostCuda {
                                         weights,
                                         binCount,
                                         point,
-                                        lossDescription,
-                                        binarySearchIterations);
+                                        lossDescription);
                 return;
             }
             case ELossFunction::MAPE: {
@@ -174,8 +158,7 @@ namespace NCatboostCuda {
                                         weightsWithTargets,
                                         binCount,
                                         point,
-                                        lossDescription,
-                                        binarySearchIterations);
+                                        lossDescription);
                 return;
             }
             default: {
@@ -88,8 +88,7 @@ Y_UNIT_TEST_SUITE(TExactLeavesEstimationTest) {
                            weightsBuffer,
                            binCount,
                            point,
-                           lossDescription,
-                           /*binarySearchIterations =*/ 100);
+                           lossDescription);
     }
 
     void RunTests(ui32 seed,
@@ -35,6 +35,7 @@
 
 #include <util/folder/path.h>
 #include <util/generic/scope.h>
+#include <util/stream/file.h>
 #include <util/system/compiler.h>
 #include <util/system/guard.h>
 #include <util/system/info.h>
@@ -214,6 +215,19 @@ namespace NCatboostCuda {
         } else {
             profiler->SetDefaultProfileMode(NCudaLib::EProfileMode::NoProfile);
         }
+        profiler->SetTraceEnabled(isProfile);
+    }
+
+    static void SaveCudaProfilerTrace(const NCudaLib::TCudaProfiler& profiler,
+                                      const NCatboostOptions::TOutputFilesOptions& outputOptions) {
+        if (!profiler.IsTraceEnabled() || !outputOptions.AllowWriteFiles()) {
+            return;
+        }
+        TFsPath(outputOptions.GetTrainDir()).MkDirs();
+        const TString tracePath = JoinFsPaths(outputOptions.GetTrainDir(), "profile_trace.json");
+        TFileOutput traceOutput(tracePath);
+        profiler.SaveTrace(&traceOutput);
+        CATBOOST_INFO_LOG << "Profile trace is saved to " << tracePath << Endl;
     }
 
     TGpuTrainResult TrainModelImpl(const TTrainModelInternalOptions& internalOptions,
@@ -255,6 +269,7 @@ namespace NCatboostCuda {
         } else {
             ythrow TCatBoostException() << "Error: optimization scheme is not supported for GPU learning " << optimizationImplementation;
         }
+        SaveCudaProfilerTrace(profiler, outputOptions);
         return model;
     }
 
@@ -1370,5 +1370,124 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
     Y_END_JNI_API_CALL();
 }
 
+template <typename T>
+static TArrayRef<T> GetDirectBufferAsArrayRef(
+    JNIEnv* const jenv,
+    const jobject buffer,
+    const size_t size,
+    const TStringBuf bufferName)
+{
+    if (size == 0) {
+        return {};
+    }
+    CB_ENSURE(jenv->IsSameObject(buffer, NULL) == JNI_FALSE, "`" << bufferName << "` is null");
+    void* const address = jenv->GetDirectBufferAddress(buffer);
+    CB_ENSURE(address, "`" << bufferName << "` should be a direct buffer");
+    const jlong capacity = jenv->GetDirectBufferCapacity(buffer);
+    const size_t requiredCapacity = size * sizeof(T);
+    CB_ENSURE(
+        capacity >= 0 && static_cast<size_t>(capacity) >= requiredCapacity,
+        "`" << bufferName << "` capacity is insufficient: " << LabeledOutput(capacity, requiredCapacity));
+    CB_ENSURE(
+        reinterpret_cast<uintptr_t>(address) % alignof(T) == 0,
+        "`" << bufferName << "` address should be aligned to " << alignof(T) << " bytes");
+    return MakeArrayRef(static_cast<T*>(address), size);
+}
+
+// Features and predictions are passed in direct buffers with native byte order, so no row arrays are
+// created and no values are copied.
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredictDirect
+  (JNIEnv* jenv, jclass, jlong jhandle, jobject jnumericFeatures, jobject jcatFeatures, jint jdocumentCount, jint jnumericFeatureCount, jint jcatFeatureCount, jboolean jcolumnMajor, jobject jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(
+        jdocumentCount >= 0 && jnumericFeatureCount >= 0 && jcatFeatureCount >= 0,
+        "document and feature counts should be non-negative");
+
+    const size_t documentCount = jdocumentCount;
+    const size_t numericFeatureCount = jnumericFeatureCount;
+    const size_t catFeatureCount = jcatFeatureCount;
+    if (documentCount == 0) {
+        return 0;
+    }
+
+    CB_ENSURE(
+        model->GetNumTextFeatures() == 0 && model->GetNumEmbeddingFeatures() == 0,
+        "models with text or embedding features are not supported for direct buffers");
+
+    const size_t modelPredictionSize = model->GetDimensionsCount();
+    const size_t minNumericFeatureCount = model->GetNumFloatFeatures();
+    const size_t minCatFeatureCount = model->GetNumCatFeatures();
+
+    CB_ENSURE(
+        numericFeatureCount >= minNumericFeatureCount,
+        LabeledOutput(numericFeatureCount, minNumericFeatureCount));
+
+    CB_ENSURE(
+        catFeatureCount >= minCatFeatureCount,
+        LabeledOutput(catFeatureCount, minCatFeatureCount));
+
+    const auto numericFeatures = GetDirectBufferAsArrayRef<const float>(
+        jenv, jnumericFeatures, documentCount * numericFeatureCount, "numericFeatures");
+    const auto catFeatures = GetDirectBufferAsArrayRef<const int>(
+        jenv, jcatFeatures, documentCount * catFeatureCount, "catFeatures");
+    const auto predictions = GetDirectBufferAsArrayRef<double>(
+        jenv, jpredictions, documentCount * modelPredictionSize, "predictions");
+
+    if (jcolumnMajor) {
+        // hashes of categorical features are passed as floats with the same bits to the flat interface
+        static_assert(sizeof(float) == sizeof(int), "float and int have different sizes");
+        const size_t flatFeatureCount = model->ModelTrees->GetFlatFeatureVectorExpectedSize();
+        TVector<TConstArrayRef<float>> flatFeatureColumns(flatFeatureCount);
+        TVector<bool> isFlatFeatureSet(flatFeatureCount, false);
+        for (const auto& floatFeature : model->ModelTrees->GetFloatFeatures()) {
+            const size_t columnIdx = floatFeature.Position.Index;
+            flatFeatureColumns[floatFeature.Position.FlatIndex] = numericFeatures.Slice(
+                columnIdx * documentCount,
+                documentCount);
+            isFlatFeatureSet[floatFeature.Position.FlatIndex] = true;
+        }
+        for (const auto& catFeature : model->ModelTrees->GetCatFeatures()) {
+            const size_t columnIdx = catFeature.Position.Index;
+            flatFeatureColumns[catFeature.Position.FlatIndex] = MakeArrayRef(
+                reinterpret_cast<const float*>(catFeatures.data() + columnIdx * documentCount),
+                documentCount);
+            isFlatFeatureSet[catFeature.Position.FlatIndex] = true;
+        }
+
+        // flat indices not known to the model are never used in trees, but should have values
+        TVector<float> unusedFeatureColumn;
+        for (auto flatFeatureIdx : xrange(flatFeatureCount)) {
+            if (!isFlatFeatureSet[flatFeatureIdx]) {
+                unusedFeatureColumn.resize(documentCount, 0.0f);
+                flatFeatureColumns[flatFeatureIdx] = unusedFeatureColumn;
+            }
+        }
+
+        model->CalcFlatTransposed(flatFeatureColumns, 0, model->GetTreeCount(), predictions);
+    } else {
+        TVector<TConstArrayRef<float>> numericFeatureRows;
+        TVector<TConstArrayRef<int>> catFeatureRows;
+        if (numericFeatureCount) {
+            numericFeatureRows.reserve(documentCount);
+            for (auto documentIdx : xrange(documentCount)) {
+                numericFeatureRows.push_back(
+                    numericFeatures.Slice(documentIdx * numericFeatureCount, numericFeatureCount));
+            }
+        }
+        if (catFeatureCount) {
+            catFeatureRows.reserve(documentCount);
+            for (auto documentIdx : xrange(documentCount)) {
+                catFeatureRows.push_back(catFeatures.Slice(documentIdx * catFeatureCount, catFeatureCount));
+            }
+        }
+        model->Calc(numericFeatureRows, catFeatureRows, predictions);
+    }
+
+    Y_END_JNI_API_CALL();
+}
+
 #undef Y_BEGIN_JNI_API_CALL
 #undef Y_END_JNI_API_CALL
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <util/generic/array_ref.h>
 #include <util/generic/strbuf.h>
 #include <util/system/types.h>
 
 ui32 CalcCatFeatureHash(const TStringBuf feature) noexcept;
 
+/* Same as CalcCatFeatureHash for each of features, hashes must have the same size.
+ * Hashes of values equal to the previous ones are reused, so columns of low-cardinality features
+ * with repeated values are hashed faster.
+ */
+void CalcCatFeatureHashes(TConstArrayRef<TStringBuf> features, TArrayRef<ui32> hashes) noexcept;
+
 // deprecated, for compatibility, prefer CalcCatFeatureHash in new code
 inline int CalcCatFeatureHashInt(const TStringBuf feature) noexcept {
     ui32 hashVal = CalcCatFeatureHash(feature);
@@ -0,0 +1,457 @@
+#include "arrow_c_data_import.h"
+#include "arrow_values.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+
+namespace NCB {
+
+    namespace {
+        // owns the moved array, see "Moving an array" in the C data interface specification
+        struct TArrowCDataArrayHolder : public IResourceHolder {
+            ArrowArray Array;
+
+        public:
+            explicit TArrowCDataArrayHolder(ArrowArray* array)
+                : Array(*array)
+            {
+                array->release = nullptr;
+            }
+
+            ~TArrowCDataArrayHolder() {
+                if (Array.release) {
+                    Array.release(&Array);
+                }
+            }
+        };
+    }
+
+    static TArrowValueType ParseValueType(const char* format, TStringBuf columnName) {
+        const TStringBuf formatBuf = format ? TStringBuf(format) : TStringBuf();
+        CB_ENSURE(
+            formatBuf.size() == 1,
+            "Arrow C data: column \"" << columnName << "\" has unsupported format \"" << formatBuf << '"'
+        );
+
+        TArrowValueType result;
+        switch (formatBuf[0]) {
+            case 'b':
+                result.Kind = TArrowValueType::EKind::Bool;
+                break;
+            case 'c':
+            case 'C':
+                result.ByteWidth = 1;
+                break;
+            case 's':
+            case 'S':
+                result.ByteWidth = 2;
+                break;
+            case 'i':
+            case 'I':
+                result.ByteWidth = 4;
+                break;
+            case 'l':
+            case 'L':
+                result.ByteWidth = 8;
+                break;
+            case 'f':
+                result.Kind = TArrowValueType::EKind::FloatingPoint;
+                result.ByteWidth = 4;
+                break;
+            case 'g':
+                result.Kind = TArrowValueType::EKind::FloatingPoint;
+                result.ByteWidth = 8;
+                break;
+            case 'u':
+                result.Kind = TArrowValueType::EKind::Utf8;
+                break;
+            case 'U':
+                result.Kind = TArrowValueType::EKind::LargeUtf8;
+                break;
+            default:
+                CB_ENSURE(
+                    false,
+                    "Arrow C data: column \"" << columnName << "\" has unsupported format \"" << formatBuf << '"'
+                );
+        }
+        if (result.Kind == TArrowValueType::EKind::Int) {
+            // lowercase formats are signed
+            result.IsSigned = (formatBuf[0] >= 'a');
+        }
+        return result;
+    }
+
+    TArrowCDataRecordBatch::TArrowCDataRecordBatch(const ArrowSchema& schema, ArrowArray* array) {
+        CB_ENSURE(array && array->release, "Arrow C data: array is released");
+
+        // take ownership first so the array is released on errors too
+        auto arrayHolder = MakeIntrusive<TArrowCDataArrayHolder>(array);
+        ArrayHolder = arrayHolder;
+        const ArrowArray& structArray = arrayHolder->Array;
+
+        CB_ENSURE(schema.release, "Arrow C data: schema is released");
+        CB_ENSURE(
+            schema.format && (TStringBuf(schema.format) == TStringBuf("+s")),
+            "Arrow C data: record batch should be passed as a struct array"
+        );
+        CB_ENSURE(
+            structArray.n_children == schema.n_children,
+            "Arrow C data: array and schema have different numbers of columns"
+        );
+        CB_ENSURE(
+            (structArray.length >= 0) && (structArray.offset >= 0),
+            "Arrow C data: wrong struct array length or offset"
+        );
+        CB_ENSURE(
+            (structArray.n_buffers == 0) || !structArray.buffers[0] || (structArray.null_count == 0),
+            "Arrow C data: null rows of record batch are not supported"
+        );
+        RowCount = structArray.length;
+
+        const auto columnCount = SafeIntegerCast<ui32>(schema.n_children);
+        Fields.resize(columnCount);
+        Arrays.resize(columnCount);
+        Dictionaries.resize(columnCount);
+        for (auto columnIdx : xrange(columnCount)) {
+            const ArrowSchema& columnSchema = *schema.children[columnIdx];
+            const ArrowArray& columnArray = *structArray.children[columnIdx];
+
+            TArrowField& field = Fields[columnIdx];
+            field.Name = columnSchema.name ? columnSchema.name : "";
+            CB_ENSURE(
+                columnSchema.n_children == 0,
+                "Arrow C data: column \"" << field.Name << "\" has nested type that is not supported"
+            );
+            if (columnSchema.dictionary) {
+                field.DictionaryId = columnIdx;
+                field.IndexType = ParseValueType(columnSchema.format, field.Name);
+                CB_ENSURE(
+                    field.IndexType.Kind == TArrowValueType::EKind::Int,
+                    "Arrow C data: column \"" << field.Name << "\" has dictionary indices of non-integer type"
+                );
+                field.ValueType = ParseValueType(columnSchema.dictionary->format, field.Name);
+                CB_ENSURE(
+                    columnArray.dictionary,
+                    "Arrow C data: column \"" << field.Name << "\" has no dictionary values"
+                );
+                const ArrowArray& dictionaryArray = *columnArray.dictionary;
+                CB_ENSURE(
+                    (dictionaryArray.length >= 0) && (dictionaryArray.offset >= 0),
+                    "Arrow C data: column \"" << field.Name << "\" has wrong dictionary length or offset"
+                );
+                Dictionaries[columnIdx] = ImportArray(
+                    field.ValueType,
+                    dictionaryArray,
+                    dictionaryArray.offset,
+                    dictionaryArray.length
+                );
+            } else {
+                field.ValueType = ParseValueType(columnSchema.format, field.Name);
+            }
+
+            // offset of the struct array applies to its children
+            CB_ENSURE(
+                (columnArray.offset >= 0) && (columnArray.length >= structArray.offset + structArray.length),
+                "Arrow C data: column \"" << field.Name << "\" has wrong length or offset"
+            );
+            Arrays[columnIdx] = ImportArray(
+                field.GetStoredType(),
+                columnArray,
+                columnArray.offset + structArray.offset,
+                RowCount
+            );
+        }
+    }
+
+    TConstArrayRef<ui8> TArrowCDataRecordBatch::SliceBitmap(const void* bitmap, ui64 offset, ui64 length) {
+        const ui8* bits = static_cast<const ui8*>(bitmap);
+        const ui64 size = CeilDiv<ui64>(length, 8);
+        if (offset % 8 == 0) {
+            return TConstArrayRef<ui8>(bits + offset / 8, size);
+        }
+        TVector<ui8> shifted(size, 0);
+        for (auto idx : xrange(length)) {
+            const ui64 srcIdx = offset + idx;
+            shifted[idx >> 3] |= ((bits[srcIdx >> 3] >> (srcIdx & 7)) & 1) << (idx & 7);
+        }
+        ShiftedBitmaps.push_back(std::move(shifted));
+        return ShiftedBitmaps.back();
+    }
+
+    TArrowArray TArrowCDataRecordBatch::ImportArray(
+        const TArrowValueType& type,
+        const ArrowArray& array,
+        ui64 offset,
+        ui64 length
+    ) {
+        const i64 expectedBufferCount = type.IsString() ? 3 : 2;
+        CB_ENSURE(array.n_buffers == expectedBufferCount, "Arrow C data: wrong number of buffers");
+
+        TArrowArray result;
+        result.Length = length;
+        if (array.buffers[0] && length) {
+            result.Validity = SliceBitmap(array.buffers[0], offset, length);
+            if ((array.null_count >= 0) && (offset == (ui64)array.offset) && (length == (ui64)array.length)) {
+                result.NullCount = array.null_count;
+            } else {
+                for (auto idx : xrange(length)) {
+                    result.NullCount += !result.IsValid(idx);
+                }
+            }
+        }
+
+        if (!length) {
+            return result;
+        }
+        const ui8* values = static_cast<const ui8*>(array.buffers[1]);
+        CB_ENSURE(values, "Arrow C data: values buffer is null");
+        switch (type.Kind) {
+            case TArrowValueType::EKind::Bool:
+                result.Values = SliceBitmap(values, offset, length);
+                break;
+            case TArrowValueType::EKind::Int:
+            case TArrowValueType::EKind::FloatingPoint:
+                result.Values = TConstArrayRef<ui8>(
+                    values + offset * type.ByteWidth,
+                    GetArrowMinValuesBufferSize(type, length)
+                );
+                break;
+            case TArrowValueType::EKind::Utf8:
+            case TArrowValueType::EKind::LargeUtf8: {
+                const ui64 offsetSize = (type.Kind == TArrowValueType::EKind::Utf8) ? sizeof(i32) : sizeof(i64);
+                result.Values = TConstArrayRef<ui8>(
+                    values + offset * offsetSize,
+                    GetArrowMinValuesBufferSize(type, length)
+                );
+
+                // string offsets point into the whole data buffer
+                const i64 dataSize = (type.Kind == TArrowValueType::EKind::Utf8)
+                    ? (i64)GetArrowValue<i32>(result, length)
+                    : GetArrowValue<i64>(result, length);
+                CB_ENSURE(dataSize >= 0, "Arrow C data: wrong string offsets");
+                if (dataSize) {
+                    CB_ENSURE(array.buffers[2], "Arrow C data: string data buffer is null");
+                    result.Data = TConstArrayRef<ui8>(static_cast<const ui8*>(array.buffers[2]), dataSize);
+                }
+                break;
+            }
+        }
+        return result;
+    }
+
+    TFeaturesLayoutPtr TArrowCDataRecordBatch::CreateFeaturesLayout() const {
+        TVector<ui32> catFeatureIndices;
+        TVector<TString> featureNames;
+        for (auto fieldIdx : xrange(SafeIntegerCast<ui32>(Fields.size()))) {
+            const TArrowField& field = Fields[fieldIdx];
+            if (field.DictionaryId || !field.ValueType.IsNumeric()) {
+                catFeatureIndices.push_back(fieldIdx);
+            }
+            featureNames.push_back(field.Name);
+        }
+        return MakeIntrusive<TFeaturesLayout>(
+            SafeIntegerCast<ui32>(Fields.size()),
+            catFeatureIndices,
+            featureNames
+        );
+    }
+
+    ITypedSequencePtr<float> TArrowCDataRecordBatch::GetFloatColumn(ui32 fieldIdx) const {
+        const TArrowField& field = Fields[fieldIdx];
+        CB_ENSURE(
+            !field.DictionaryId && field.ValueType.IsNumeric(),
+            "Arrow C data: column \"" << field.Name << "\" should have numeric type"
+        );
+        const TArrowArray& array = Arrays[fieldIdx];
+
+        // values are used directly from the producer's buffer if no conversion of nulls is needed
+        if ((field.ValueType.Kind != TArrowValueType::EKind::Bool) && (array.NullCount == 0)) {
+            ITypedSequencePtr<float> result;
+            DispatchArrowNumericType(
+                field.ValueType,
+                [&] (auto typeTag) {
+                    using TSrc = decltype(typeTag);
+                    if (reinterpret_cast<uintptr_t>(array.Values.data()) % alignof(TSrc) == 0) {
+                        result = MakeTypeCastArrayHolder<float, TSrc>(
+                            TMaybeOwningConstArrayHolder<TSrc>::CreateOwning(
+                                TConstArrayRef<TSrc>(reinterpret_cast<const TSrc*>(array.Values.data()), RowCount),
+                                ArrayHolder
+                            )
+                        );
+                    }
+                }
+            );
+            if (result) {
+                return result;
+            }
+        }
+
+        TVector<float> values;
+        values.yresize(RowCount);
+        ConvertArrowNumericArray(field.ValueType, array, 0, RowCount, values.data());
+        return MakeTypeCastArrayHolderFromVector<float, float>(values);
+    }
+
+    TVector<ui32> TArrowCDataRecordBatch::GetHashedCatColumn(
+        ui32 fieldIdx,
+        ui32 flatFeatureIdx,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) const {
+        const TArrowField& field = Fields[fieldIdx];
+        CB_ENSURE(
+            field.ValueType.IsString(),
+            "Arrow C data: column \"" << field.Name << "\" should have string dictionary values"
+        );
+
+        // each dictionary value is hashed once
+        const TArrowArray& dictionary = Dictionaries[fieldIdx];
+        TVector<ui32> dictionaryHashes;
+        dictionaryHashes.yresize(dictionary.Length);
+        for (auto idx : xrange(dictionary.Length)) {
+            dictionaryHashes[idx] = visitor->GetCatFeatureValue(
+                flatFeatureIdx,
+                dictionary.IsValid(idx) ? GetArrowStringValue(field.ValueType, dictionary, idx) : TStringBuf()
+            );
+        }
+
+        const TArrowArray& array = Arrays[fieldIdx];
+        const ui32 nullHash = array.NullCount ? visitor->GetCatFeatureValue(flatFeatureIdx, TStringBuf()) : 0;
+        TVector<ui32> result;
+        result.yresize(RowCount);
+        DispatchArrowNumericType(
+            field.IndexType,
+            [&] (auto typeTag) {
+                using TIndex = decltype(typeTag);
+                for (auto idx : xrange(RowCount)) {
+                    if (!array.IsValid(idx)) {
+                        result[idx] = nullHash;
+                        continue;
+                    }
+                    const i64 dictionaryIdx = static_cast<i64>(GetArrowValue<TIndex>(array, idx));
+                    CB_ENSURE(
+                        (0 <= dictionaryIdx) && ((size_t)dictionaryIdx < dictionaryHashes.size()),
+                        "Arrow C data: dictionary index is out of bounds"
+                    );
+                    result[idx] = dictionaryHashes[dictionaryIdx];
+                }
+            }
+        );
+        return result;
+    }
+
+    TVector<TStringBuf> TArrowCDataRecordBatch::GetStringColumn(
+        ui32 fieldIdx,
+        TVector<TString>* convertedValues
+    ) const {
+        const TArrowField& field = Fields[fieldIdx];
+        const TArrowArray& array = Arrays[fieldIdx];
+
+        TVector<TStringBuf> result;
+        result.yresize(RowCount);
+        if (field.DictionaryId) {
+            CB_ENSURE(
+                field.ValueType.IsString(),
+                "Arrow C data: column \"" << field.Name << "\" should have string dictionary values"
+            );
+            const TArrowArray& dictionary = Dictionaries[fieldIdx];
+            DispatchArrowNumericType(
+                field.IndexType,
+                [&] (auto typeTag) {
+                    using TIndex = decltype(typeTag);
+                    for (auto idx : xrange(RowCount)) {
+                        if (!array.IsValid(idx)) {
+                            result[idx] = TStringBuf();
+                            continue;
+                        }
+                        const i64 dictionaryIdx = static_cast<i64>(GetArrowValue<TIndex>(array, idx));
+                        CB_ENSURE(
+                            (0 <= dictionaryIdx) && ((ui64)dictionaryIdx < dictionary.Length),
+                            "Arrow C data: dictionary index is out of bounds"
+                        );
+                        result[idx] = dictionary.IsValid(dictionaryIdx)
+                            ? GetArrowStringValue(field.ValueType, dictionary, dictionaryIdx)
+                            : TStringBuf();
+                    }
+                }
+            );
+        } else if (field.ValueType.IsString()) {
+            for (auto idx : xrange(RowCount)) {
+                result[idx] = array.IsValid(idx) ? GetArrowStringValue(field.ValueType, array, idx) : TStringBuf();
+            }
+        } else {
+            // strings should be the same as in dsv files, so floating point values are not allowed
+            CB_ENSURE(
+                field.ValueType.Kind != TArrowValueType::EKind::FloatingPoint,
+                "Arrow C data: column \"" << field.Name << "\" should have string, integer or boolean type"
+            );
+            convertedValues->resize(RowCount);
+            for (auto idx : xrange(RowCount)) {
+                if (array.IsValid(idx)) {
+                    (*convertedValues)[idx] = GetArrowIntegerValueAsString(field.ValueType, array, idx);
+                }
+                result[idx] = (*convertedValues)[idx];
+            }
+        }
+        return result;
+    }
+
+    void TArrowCDataRecordBatch::AddFeatures(
+        const TFeaturesLayout& featuresLayout,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) const {
+        CB_ENSURE(
+            featuresLayout.GetExternalFeatureCount() == Fields.size(),
+            "Arrow C data: features layout has " << featuresLayout.GetExternalFeatureCount()
+            << " features but record batch has " << Fields.size() << " columns"
+        );
+        const auto featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
+        for (auto fieldIdx : xrange(SafeIntegerCast<ui32>(Fields.size()))) {
+            if (featuresMetaInfo[fieldIdx].IsIgnored) {
+                continue;
+            }
+            TVector<TString> convertedValues;
+            switch (featuresMetaInfo[fieldIdx].Type) {
+                case EFeatureType::Float:
+                    visitor->AddFloatFeature(fieldIdx, GetFloatColumn(fieldIdx));
+                    break;
+                case EFeatureType::Categorical:
+                    if (Fields[fieldIdx].DictionaryId) {
+                        visitor->AddCatFeature(
+                            fieldIdx,
+                            TMaybeOwningConstArrayHolder<ui32>::CreateOwning(
+                                GetHashedCatColumn(fieldIdx, fieldIdx, visitor)
+                            )
+                        );
+                    } else {
+                        const auto values = GetStringColumn(fieldIdx, &convertedValues);
+                        visitor->AddCatFeature(fieldIdx, TConstArrayRef<TStringBuf>(values));
+                    }
+                    break;
+                case EFeatureType::Text: {
+                    const auto values = GetStringColumn(fieldIdx, &convertedValues);
+                    visitor->AddTextFeature(
+                        fieldIdx,
+                        TMaybeOwningConstArrayHolder<TString>::CreateOwning(
+                            TVector<TString>(values.begin(), values.end())
+                        )
+                    );
+                    break;
+                }
+                default:
+                    CB_ENSURE(
+                        false,
+                        "Arrow C data: column \"" << Fields[fieldIdx].Name
+                        << "\": features of this type are not supported"
+                    );
+            }
+        }
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "arrow_c_data.h"
+#include "arrow_loader.h"
+#include "features_layout.h"
+#include "visitor.h"
+
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Record batch passed through Apache Arrow C data interface as a struct array (format "+s"),
+     *  each child of it is a column.
+     * Only flat columns with numeric, boolean and utf8 values (possibly dictionary encoded) are supported.
+     * Buffers are not copied: the array is moved into the batch and released when the batch and all
+     *  data that references it (see GetResourceHolder) are destroyed. The schema is only read.
+     */
+    class TArrowCDataRecordBatch {
+    public:
+        TArrowCDataRecordBatch(const ArrowSchema& schema, ArrowArray* array);
+
+        const TVector<TArrowField>& GetFields() const {
+            return Fields;
+        }
+
+        ui64 GetRowCount() const {
+            return RowCount;
+        }
+
+        const TArrowArray& GetArray(ui32 fieldIdx) const {
+            return Arrays[fieldIdx];
+        }
+
+        // for dictionary encoded columns only
+        const TArrowArray& GetDictionary(ui32 fieldIdx) const {
+            return Dictionaries[fieldIdx];
+        }
+
+        TIntrusivePtr<IResourceHolder> GetResourceHolder() const {
+            return ArrayHolder;
+        }
+
+        // numeric columns are float features, other ones are categorical, column names are feature names
+        TFeaturesLayoutPtr CreateFeaturesLayout() const;
+
+        /* columns are passed to the visitor as features of the corresponding types from featuresLayout,
+         * visitor->Start should be called with GetResourceHolder() in resource holders
+         */
+        void AddFeatures(const TFeaturesLayout& featuresLayout, IRawFeaturesOrderDataVisitor* visitor) const;
+
+    private:
+        // offset and length are in values of array, array.offset is not taken into account
+        TArrowArray ImportArray(const TArrowValueType& type, const ArrowArray& array, ui64 offset, ui64 length);
+        TConstArrayRef<ui8> SliceBitmap(const void* bitmap, ui64 offset, ui64 length);
+
+        ITypedSequencePtr<float> GetFloatColumn(ui32 fieldIdx) const;
+        TVector<ui32> GetHashedCatColumn(ui32 fieldIdx, ui32 flatFeatureIdx, IRawFeaturesOrderDataVisitor* visitor) const;
+        TVector<TStringBuf> GetStringColumn(ui32 fieldIdx, TVector<TString>* convertedValues) const;
+
+    private:
+        TIntrusivePtr<IResourceHolder> ArrayHolder;
+        ui64 RowCount = 0;
+        TVector<TArrowField> Fields;
+        TVector<TArrowArray> Arrays; // [fieldIdx]
+        TVector<TArrowArray> Dictionaries; // [fieldIdx], empty for not dictionary encoded columns
+
+        // validity and boolean bitmaps of arrays with offsets that are not multiples of 8 are copied here
+        TVector<TVector<ui8>> ShiftedBitmaps;
+    };
+
+}
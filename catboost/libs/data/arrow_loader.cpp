@@ -0,0 +1,868 @@
+#include "arrow_loader.h"
+#include "arrow_values.h"
+
+#include "baseline.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+#include <catboost/private/libs/data_types/groupid.h>
+#include <catboost/private/libs/data_util/exists_checker.h>
+#include <catboost/private/libs/labels/helpers.h>
+#include <catboost/private/libs/options/pool_metainfo_options.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
+
+#include <library/cpp/object_factory/object_factory.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/system/unaligned_mem.h>
+
+#include <limits>
+#include <type_traits>
+
+
+namespace NCB {
+
+    namespace {
+        // see format/File.fbs, format/Schema.fbs and format/Message.fbs in Apache Arrow sources
+        enum class EFooterField {
+            Version,
+            Schema,
+            Dictionaries,
+            RecordBatches
+        };
+
+        enum class ESchemaField {
+            Endianness,
+            Fields
+        };
+
+        enum class EFieldField {
+            Name,
+            Nullable,
+            TypeType,
+            Type,
+            Dictionary,
+            Children
+        };
+
+        enum class EDictionaryEncodingField {
+            Id,
+            IndexType
+        };
+
+        enum class EIntField {
+            BitWidth,
+            IsSigned
+        };
+
+        enum class EFloatingPointField {
+            Precision
+        };
+
+        enum class EMessageField {
+            Version,
+            HeaderType,
+            Header,
+            BodyLength
+        };
+
+        enum class ERecordBatchField {
+            Length,
+            Nodes,
+            Buffers,
+            Compression
+        };
+
+        enum class EDictionaryBatchField {
+            Id,
+            Data,
+            IsDelta
+        };
+
+        // values of Type union
+        enum class EArrowType : ui8 {
+            Int = 2,
+            FloatingPoint = 3,
+            Utf8 = 5,
+            Bool = 6,
+            LargeUtf8 = 20
+        };
+
+        // values of MessageHeader union
+        enum class EMessageHeaderType : ui8 {
+            DictionaryBatch = 2,
+            RecordBatch = 3
+        };
+
+        struct TArrowBlock {
+            i64 Offset;
+            i32 MetaDataLength;
+            i32 Padding;
+            i64 BodyLength;
+        };
+
+        struct TArrowFieldNode {
+            i64 Length;
+            i64 NullCount;
+        };
+
+        struct TArrowBuffer {
+            i64 Offset;
+            i64 Length;
+        };
+
+        static_assert(sizeof(TArrowBlock) == 24);
+        static_assert(sizeof(TArrowFieldNode) == 16);
+        static_assert(sizeof(TArrowBuffer) == 16);
+
+        constexpr TStringBuf ArrowMagic = "ARROW1";
+
+        struct TBlobHolder : public IResourceHolder {
+            TBlob Data;
+
+        public:
+            explicit TBlobHolder(TBlob data)
+                : Data(std::move(data))
+            {}
+        };
+    }
+
+    template <class TEnum>
+    static flatbuffers::voffset_t GetVTableOffset(TEnum field) {
+        return static_cast<flatbuffers::voffset_t>(4 + 2 * static_cast<int>(field));
+    }
+
+    template <class TValue, class TEnum>
+    static TValue GetScalarField(const flatbuffers::Table* table, TEnum field, TValue defaultValue) {
+        return table->GetField<TValue>(GetVTableOffset(field), defaultValue);
+    }
+
+    template <class TPointer, class TEnum>
+    static TPointer GetPointerField(const flatbuffers::Table* table, TEnum field) {
+        return table->GetPointer<TPointer>(GetVTableOffset(field));
+    }
+
+    using TTableVector = flatbuffers::Vector<flatbuffers::Offset<flatbuffers::Table>>;
+
+
+    static TArrowValueType ParseIntType(const flatbuffers::Table* intType) {
+        CB_ENSURE(intType, "Arrow file: integer type has no description");
+        TArrowValueType result;
+        result.Kind = TArrowValueType::EKind::Int;
+        const i32 bitWidth = GetScalarField<i32>(intType, EIntField::BitWidth, 0);
+        CB_ENSURE(
+            bitWidth == 8 || bitWidth == 16 || bitWidth == 32 || bitWidth == 64,
+            "Arrow file: unsupported integer bit width " << bitWidth
+        );
+        result.ByteWidth = bitWidth / 8;
+        result.IsSigned = GetScalarField<ui8>(intType, EIntField::IsSigned, 0) != 0;
+        return result;
+    }
+
+    static TArrowField ParseField(const flatbuffers::Table* field) {
+        TArrowField result;
+        if (const auto* name = GetPointerField<const flatbuffers::String*>(field, EFieldField::Name)) {
+            result.Name = TString(name->c_str(), name->size());
+        }
+
+        const auto* children = GetPointerField<const TTableVector*>(field, EFieldField::Children);
+        CB_ENSURE(
+            !children || children->size() == 0,
+            "Arrow file: column " << result.Name << " has nested type, it is not supported"
+        );
+
+        const auto* type = GetPointerField<const flatbuffers::Table*>(field, EFieldField::Type);
+        const auto typeType = static_cast<EArrowType>(GetScalarField<ui8>(field, EFieldField::TypeType, 0));
+        switch (typeType) {
+            case EArrowType::Int:
+                result.ValueType = ParseIntType(type);
+                break;
+            case EArrowType::FloatingPoint: {
+                // enum Precision { HALF, SINGLE, DOUBLE }
+                const i16 precision = type ? GetScalarField<i16>(type, EFloatingPointField::Precision, 0) : 0;
+                CB_ENSURE(
+                    precision == 1 || precision == 2,
+                    "Arrow file: column " << result.Name << " has half precision type, it is not supported"
+                );
+                result.ValueType.Kind = TArrowValueType::EKind::FloatingPoint;
+                result.ValueType.ByteWidth = (precision == 1) ? 4 : 8;
+                break;
+            }
+            case EArrowType::Utf8:
+                result.ValueType.Kind = TArrowValueType::EKind::Utf8;
+                break;
+            case EArrowType::LargeUtf8:
+                result.ValueType.Kind = TArrowValueType::EKind::LargeUtf8;
+                break;
+            case EArrowType::Bool:
+                result.ValueType.Kind = TArrowValueType::EKind::Bool;
+                break;
+            default:
+                CB_ENSURE(
+                    false,
+                    "Arrow file: column " << result.Name << " has unsupported type " << (int)typeType
+                );
+        }
+
+        if (const auto* dictionary = GetPointerField<const flatbuffers::Table*>(field, EFieldField::Dictionary)) {
+            result.DictionaryId = GetScalarField<i64>(dictionary, EDictionaryEncodingField::Id, 0);
+            const auto* indexType = GetPointerField<const flatbuffers::Table*>(
+                dictionary,
+                EDictionaryEncodingField::IndexType
+            );
+            if (indexType) {
+                result.IndexType = ParseIntType(indexType);
+            } else {
+                result.IndexType.Kind = TArrowValueType::EKind::Int;
+                result.IndexType.ByteWidth = 4;
+                result.IndexType.IsSigned = true;
+            }
+        }
+        return result;
+    }
+
+    // returns message header, body is placed right after the message metadata
+    static const flatbuffers::Table* ParseMessage(
+        const TBlob& file,
+        const TArrowBlock& block,
+        EMessageHeaderType expectedHeaderType,
+        TConstArrayRef<ui8>* body
+    ) {
+        CB_ENSURE(
+            (block.Offset >= 0) && (block.MetaDataLength >= 8) && (block.BodyLength >= 0)
+            && ((ui64)block.Offset + (ui64)block.MetaDataLength + (ui64)block.BodyLength <= file.Size()),
+            "Arrow file: message is out of file bounds"
+        );
+        const ui8* message = file.AsUnsignedCharPtr() + block.Offset;
+
+        // since Arrow 0.15 metadata size is preceded by continuation marker
+        size_t metaDataStart = sizeof(i32);
+        if (ReadUnaligned<i32>(message) == -1) {
+            metaDataStart += sizeof(i32);
+        }
+        const auto* messageTable = flatbuffers::GetRoot<flatbuffers::Table>(message + metaDataStart);
+        CB_ENSURE(
+            GetScalarField<ui8>(messageTable, EMessageField::HeaderType, 0) == (ui8)expectedHeaderType,
+            "Arrow file: unexpected message type"
+        );
+        const auto* header = GetPointerField<const flatbuffers::Table*>(messageTable, EMessageField::Header);
+        CB_ENSURE(header, "Arrow file: message has no header");
+
+        *body = TConstArrayRef<ui8>(message + block.MetaDataLength, block.BodyLength);
+        return header;
+    }
+
+    // storedTypes are types of buffers of each column of the record batch
+    static TVector<TArrowArray> ParseRecordBatch(
+        const flatbuffers::Table* recordBatch,
+        TConstArrayRef<ui8> body,
+        TConstArrayRef<TArrowValueType> storedTypes,
+        ui64* length
+    ) {
+        CB_ENSURE(
+            !recordBatch->CheckField(GetVTableOffset(ERecordBatchField::Compression)),
+            "Arrow file: compressed record batches are not supported"
+        );
+        const i64 batchLength = GetScalarField<i64>(recordBatch, ERecordBatchField::Length, 0);
+        CB_ENSURE(batchLength >= 0, "Arrow file: negative record batch length");
+        *length = batchLength;
+
+        const auto* nodes = GetPointerField<const flatbuffers::Vector<const TArrowFieldNode*>*>(
+            recordBatch,
+            ERecordBatchField::Nodes
+        );
+        const auto* buffers = GetPointerField<const flatbuffers::Vector<const TArrowBuffer*>*>(
+            recordBatch,
+            ERecordBatchField::Buffers
+        );
+        CB_ENSURE(
+            nodes && (nodes->size() == storedTypes.size()),
+            "Arrow file: record batch has unexpected number of columns"
+        );
+
+        ui32 bufferIdx = 0;
+        auto getNextBuffer = [&] () {
+            CB_ENSURE(buffers && (bufferIdx < buffers->size()), "Arrow file: record batch has too few buffers");
+            const TArrowBuffer* buffer = buffers->Get(bufferIdx++);
+            CB_ENSURE(
+                (buffer->Offset >= 0) && (buffer->Length >= 0)
+                && ((ui64)buffer->Offset + (ui64)buffer->Length <= body.size()),
+                "Arrow file: buffer is out of record batch body bounds"
+            );
+            return body.Slice(buffer->Offset, buffer->Length);
+        };
+
+        TVector<TArrowArray> arrays(storedTypes.size());
+        for (auto columnIdx : xrange(storedTypes.size())) {
+            const TArrowFieldNode* node = nodes->Get(columnIdx);
+            TArrowArray& array = arrays[columnIdx];
+            CB_ENSURE(node->Length == batchLength, "Arrow file: column length differs from record batch length");
+            CB_ENSURE(
+                (node->NullCount >= 0) && (node->NullCount <= node->Length),
+                "Arrow file: wrong null count"
+            );
+            array.Length = node->Length;
+            array.NullCount = node->NullCount;
+
+            const auto validity = getNextBuffer();
+            if (array.NullCount) {
+                CB_ENSURE(
+                    validity.size() >= CeilDiv<ui64>(array.Length, 8),
+                    "Arrow file: validity buffer is too small"
+                );
+                array.Validity = validity;
+            }
+            array.Values = getNextBuffer();
+            CB_ENSURE(
+                array.Values.size() >= GetArrowMinValuesBufferSize(storedTypes[columnIdx], array.Length),
+                "Arrow file: values buffer is too small"
+            );
+            if (storedTypes[columnIdx].IsString()) {
+                array.Data = getNextBuffer();
+            }
+        }
+        return arrays;
+    }
+
+    TArrowFile::TArrowFile(const TString& path)
+        : File(TBlob::FromFile(path))
+        , FileHolder(MakeIntrusive<TBlobHolder>(File))
+    {
+        const size_t trailerSize = ArrowMagic.size() + sizeof(i32);
+        CB_ENSURE(
+            (File.Size() >= ArrowMagic.size() + trailerSize)
+            && (TStringBuf(File.AsCharPtr(), ArrowMagic.size()) == ArrowMagic)
+            && (TStringBuf(File.AsCharPtr() + File.Size() - ArrowMagic.size(), ArrowMagic.size()) == ArrowMagic),
+            "File " << path << " is not in Arrow IPC file format"
+        );
+        const i32 footerSize = ReadUnaligned<i32>(File.AsCharPtr() + File.Size() - trailerSize);
+        CB_ENSURE(
+            (footerSize > 0) && ((size_t)footerSize <= File.Size() - trailerSize - ArrowMagic.size()),
+            "Arrow file: wrong footer size"
+        );
+        const auto* footer = flatbuffers::GetRoot<flatbuffers::Table>(
+            File.AsUnsignedCharPtr() + File.Size() - trailerSize - footerSize
+        );
+
+        const auto* schema = GetPointerField<const flatbuffers::Table*>(footer, EFooterField::Schema);
+        CB_ENSURE(schema, "Arrow file: no schema");
+        CB_ENSURE(
+            GetScalarField<i16>(schema, ESchemaField::Endianness, 0) == 0,
+            "Arrow file: big endian data is not supported"
+        );
+        const auto* fields = GetPointerField<const TTableVector*>(schema, ESchemaField::Fields);
+        CB_ENSURE(fields && fields->size(), "Arrow file: no columns");
+
+        TVector<TArrowValueType> storedTypes;
+        THashMap<i64, TArrowValueType> dictionaryValueTypes;
+        for (auto fieldIdx : xrange(fields->size())) {
+            Fields.push_back(ParseField(fields->Get(fieldIdx)));
+            storedTypes.push_back(Fields.back().GetStoredType());
+            if (Fields.back().DictionaryId) {
+                dictionaryValueTypes[*Fields.back().DictionaryId] = Fields.back().ValueType;
+            }
+        }
+
+        const auto* dictionaryBlocks = GetPointerField<const flatbuffers::Vector<const TArrowBlock*>*>(
+            footer,
+            EFooterField::Dictionaries
+        );
+        if (dictionaryBlocks) {
+            for (auto blockIdx : xrange(dictionaryBlocks->size())) {
+                TConstArrayRef<ui8> body;
+                const auto* dictionaryBatch = ParseMessage(
+                    File,
+                    *dictionaryBlocks->Get(blockIdx),
+                    EMessageHeaderType::DictionaryBatch,
+                    &body
+                );
+                const i64 dictionaryId = GetScalarField<i64>(dictionaryBatch, EDictionaryBatchField::Id, 0);
+                const auto* valueType = dictionaryValueTypes.FindPtr(dictionaryId);
+                CB_ENSURE(valueType, "Arrow file: dictionary " << dictionaryId << " is not used in schema");
+                const auto* data = GetPointerField<const flatbuffers::Table*>(
+                    dictionaryBatch,
+                    EDictionaryBatchField::Data
+                );
+                CB_ENSURE(data, "Arrow file: dictionary batch has no data");
+                ui64 length = 0;
+                auto arrays = ParseRecordBatch(data, body, MakeArrayRef(valueType, 1), &length);
+
+                // deltas are appended, there are no dictionary replacements in file format
+                Dictionaries[dictionaryId].push_back(arrays[0]);
+            }
+        }
+
+        const auto* recordBatchBlocks = GetPointerField<const flatbuffers::Vector<const TArrowBlock*>*>(
+            footer,
+            EFooterField::RecordBatches
+        );
+        BatchOffsets.push_back(0);
+        if (recordBatchBlocks) {
+            for (auto blockIdx : xrange(recordBatchBlocks->size())) {
+                TConstArrayRef<ui8> body;
+                const auto* recordBatch = ParseMessage(
+                    File,
+                    *recordBatchBlocks->Get(blockIdx),
+                    EMessageHeaderType::RecordBatch,
+                    &body
+                );
+                ui64 length = 0;
+                RecordBatches.push_back(ParseRecordBatch(recordBatch, body, storedTypes, &length));
+                BatchOffsets.push_back(BatchOffsets.back() + length);
+            }
+        }
+    }
+
+    TConstArrayRef<TArrowArray> TArrowFile::GetDictionary(i64 dictionaryId) const {
+        const auto* dictionary = Dictionaries.FindPtr(dictionaryId);
+        return dictionary ? TConstArrayRef<TArrowArray>(*dictionary) : TConstArrayRef<TArrowArray>();
+    }
+
+
+    TArrowDataLoader::TArrowDataLoader(TDatasetLoaderPullArgs&& args)
+        : File(args.PoolPath.Path)
+        , Args(std::move(args.CommonArgs))
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TArrowDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TArrowDataLoader:GroupWeightsFilePath does not exist");
+        CB_ENSURE(!Args.TimestampsFilePath.Inited() || CheckExists(Args.TimestampsFilePath),
+                  "TArrowDataLoader:TimestampsFilePath does not exist");
+        CB_ENSURE(!Args.FeatureNamesPath.Inited() || CheckExists(Args.FeatureNamesPath),
+                  "TArrowDataLoader:FeatureNamesPath does not exist");
+        CB_ENSURE(!Args.PoolMetaInfoPath.Inited() || CheckExists(Args.PoolMetaInfoPath),
+                  "TArrowDataLoader:PoolMetaInfoPath does not exist");
+
+        THolder<IBaselineReader> baselineReader;
+        if (Args.BaselineFilePath.Inited()) {
+            CB_ENSURE(
+                CheckExists(Args.BaselineFilePath),
+                "TArrowDataLoader:BaselineFilePath does not exist"
+            );
+            baselineReader = GetProcessor<IBaselineReader, TBaselineReaderArgs>(
+                Args.BaselineFilePath,
+                TBaselineReaderArgs{
+                    Args.BaselineFilePath,
+                    ClassLabelsToStrings(Args.ClassLabels),
+                    Args.DatasetSubset.Range
+                }
+            );
+        }
+
+        CB_ENSURE(File.GetRowCount() > 0, "TArrowDataLoader: no data rows in pool");
+        SubsetBegin = Min(Args.DatasetSubset.Range.Begin, File.GetRowCount());
+        const ui64 subsetEnd = Min(Args.DatasetSubset.Range.End, File.GetRowCount());
+        CB_ENSURE(
+            subsetEnd - SubsetBegin <= Max<ui32>(),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+        );
+        ObjectCount = subsetEnd - SubsetBegin;
+
+        const auto& fields = File.GetFields();
+        TVector<TString> headerColumns;
+        for (const auto& field : fields) {
+            headerColumns.push_back(field.Name);
+        }
+
+        auto columnsDescription = TDataColumnsMetaInfo{
+            Args.CdProvider->GetColumnsDescription(SafeIntegerCast<ui32>(fields.size()))
+        };
+
+        ERawTargetType targetType = ERawTargetType::None;
+        for (auto columnIdx : xrange(columnsDescription.Columns.size())) {
+            if (columnsDescription.Columns[columnIdx].Type != EColumn::Label) {
+                continue;
+            }
+            const auto& field = fields[columnIdx];
+            const ERawTargetType columnTargetType = (!field.DictionaryId && field.ValueType.IsNumeric())
+                ? ERawTargetType::Float
+                : ERawTargetType::String;
+            CB_ENSURE(
+                (targetType == ERawTargetType::None) || (targetType == columnTargetType),
+                "TArrowDataLoader: all label columns should be either numeric or string"
+            );
+            targetType = columnTargetType;
+        }
+
+        const TVector<TString> featureNames = GetFeatureNames(
+            columnsDescription,
+            headerColumns,
+            Args.FeatureNamesPath
+        );
+
+        const auto poolMetaInfoOptions = NCatboostOptions::LoadPoolMetaInfoOptions(Args.PoolMetaInfoPath);
+
+        DataMetaInfo = TDataMetaInfo(
+            std::move(columnsDescription),
+            targetType,
+            Args.GroupWeightsFilePath.Inited(),
+            Args.TimestampsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            Args.ForceUnitAutoPairWeights,
+            baselineReader ? TMaybe<ui32>(baselineReader->GetBaselineCount()) : Nothing(),
+            &featureNames,
+            &poolMetaInfoOptions.Tags.Get(),
+            Args.ClassLabels
+        );
+
+        ProcessIgnoredFeaturesList(
+            Args.IgnoredFeatures,
+            /*allFeaturesIgnoredMessage*/ Nothing(),
+            &DataMetaInfo,
+            &FeatureIgnored
+        );
+    }
+
+    template <class TFunc>
+    void TArrowDataLoader::ForEachBatchInSubset(TFunc&& f) const {
+        const ui64 subsetEnd = SubsetBegin + ObjectCount;
+        Args.LocalExecutor->ExecRangeWithThrow(
+            [&] (int batchIdx) {
+                const ui64 batchBegin = File.GetBatchOffset(batchIdx);
+                const ui64 begin = Max(batchBegin, SubsetBegin);
+                const ui64 end = Min(File.GetBatchOffset(batchIdx + 1), subsetEnd);
+                if (begin < end) {
+                    f(batchIdx, begin - batchBegin, end - batchBegin, SafeIntegerCast<ui32>(begin - SubsetBegin));
+                }
+            },
+            0,
+            SafeIntegerCast<int>(File.GetBatchCount()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+    void TArrowDataLoader::CheckNoNulls(ui32 columnIdx) const {
+        for (auto batchIdx : xrange(File.GetBatchCount())) {
+            CB_ENSURE(
+                File.GetArray(batchIdx, columnIdx).NullCount == 0,
+                "TArrowDataLoader: null values are not supported for columns of this type"
+            );
+        }
+    }
+
+    template <class TDst>
+    TVector<TDst> TArrowDataLoader::ReadNumericColumn(ui32 columnIdx) const {
+        const TArrowField& field = File.GetFields()[columnIdx];
+        CB_ENSURE(
+            !field.DictionaryId && field.ValueType.IsNumeric(),
+            "TArrowDataLoader: column " << columnIdx << " (" << field.Name << ") should have numeric type"
+        );
+
+        TVector<TDst> result;
+        result.yresize(ObjectCount);
+        ForEachBatchInSubset(
+            [&] (ui32 batchIdx, ui64 begin, ui64 end, ui32 dstOffset) {
+                ConvertArrowNumericArray(
+                    field.ValueType,
+                    File.GetArray(batchIdx, columnIdx),
+                    begin,
+                    end,
+                    result.data() + dstOffset
+                );
+            }
+        );
+        return result;
+    }
+
+    ITypedSequencePtr<float> TArrowDataLoader::GetFloatColumn(ui32 columnIdx) const {
+        const TArrowField& field = File.GetFields()[columnIdx];
+
+        // values are used directly from the mapped file if no conversion of nulls is needed
+        if ((File.GetBatchCount() == 1)
+            && !field.DictionaryId
+            && (field.ValueType.Kind == TArrowValueType::EKind::Int
+                || field.ValueType.Kind == TArrowValueType::EKind::FloatingPoint)
+            && (File.GetArray(0, columnIdx).NullCount == 0))
+        {
+            const TArrowArray& array = File.GetArray(0, columnIdx);
+            ITypedSequencePtr<float> result;
+            DispatchArrowNumericType(
+                field.ValueType,
+                [&] (auto typeTag) {
+                    using TSrc = decltype(typeTag);
+                    if (reinterpret_cast<uintptr_t>(array.Values.data()) % alignof(TSrc) == 0) {
+                        const TSrc* values = reinterpret_cast<const TSrc*>(array.Values.data()) + SubsetBegin;
+                        result = MakeTypeCastArrayHolder<float, TSrc>(
+                            TMaybeOwningConstArrayHolder<TSrc>::CreateOwning(
+                                TConstArrayRef<TSrc>(values, ObjectCount),
+                                File.GetResourceHolder()
+                            )
+                        );
+                    }
+                }
+            );
+            if (result) {
+                return result;
+            }
+        }
+
+        TVector<float> values = ReadNumericColumn<float>(columnIdx);
+        return MakeTypeCastArrayHolderFromVector<float, float>(values);
+    }
+
+    TVector<TStringBuf> TArrowDataLoader::ReadStringColumn(
+        ui32 columnIdx,
+        TVector<TString>* convertedValues
+    ) const {
+        const TArrowField& field = File.GetFields()[columnIdx];
+
+        TVector<TStringBuf> dictionaryValues;
+        if (field.DictionaryId) {
+            CB_ENSURE(
+                field.ValueType.IsString(),
+                "TArrowDataLoader: column " << columnIdx << " (" << field.Name << ") should have string values"
+            );
+            for (const auto& array : File.GetDictionary(*field.DictionaryId)) {
+                for (auto idx : xrange(array.Length)) {
+                    dictionaryValues.push_back(
+                        array.IsValid(idx) ? GetArrowStringValue(field.ValueType, array, idx) : TStringBuf()
+                    );
+                }
+            }
+        } else if (!field.ValueType.IsString()) {
+            // strings should be the same as in dsv files, so floating point values are not allowed
+            CB_ENSURE(
+                field.ValueType.Kind != TArrowValueType::EKind::FloatingPoint,
+                "TArrowDataLoader: column " << columnIdx << " (" << field.Name
+                << ") should have string, integer or boolean type"
+            );
+            convertedValues->resize(ObjectCount);
+        }
+
+        TVector<TStringBuf> result;
+        result.yresize(ObjectCount);
+        ForEachBatchInSubset(
+            [&] (ui32 batchIdx, ui64 begin, ui64 end, ui32 dstOffset) {
+                const TArrowArray& array = File.GetArray(batchIdx, columnIdx);
+                TStringBuf* dst = result.data() + dstOffset;
+                if (field.DictionaryId) {
+                    DispatchArrowNumericType(
+                        field.IndexType,
+                        [&] (auto typeTag) {
+                            using TIndex = decltype(typeTag);
+                            for (auto idx : xrange(begin, end)) {
+                                if (!array.IsValid(idx)) {
+                                    *dst++ = TStringBuf();
+                                    continue;
+                                }
+                                const i64 dictionaryIdx = static_cast<i64>(GetArrowValue<TIndex>(array, idx));
+                                CB_ENSURE(
+                                    (0 <= dictionaryIdx) && ((size_t)dictionaryIdx < dictionaryValues.size()),
+                                    "Arrow file: dictionary index is out of bounds"
+                                );
+                                *dst++ = dictionaryValues[dictionaryIdx];
+                            }
+                        }
+                    );
+                } else if (field.ValueType.IsString()) {
+                    for (auto idx : xrange(begin, end)) {
+                        *dst++ = array.IsValid(idx) ? GetArrowStringValue(field.ValueType, array, idx) : TStringBuf();
+                    }
+                } else {
+                    TString* converted = convertedValues->data() + dstOffset;
+                    for (auto idx : xrange(begin, end)) {
+                        if (array.IsValid(idx)) {
+                            *converted = GetArrowIntegerValueAsString(field.ValueType, array, idx);
+                        }
+                        *dst++ = *converted++;
+                    }
+                }
+            }
+        );
+        return result;
+    }
+
+    TVector<ui32> TArrowDataLoader::ReadHashedCatColumn(
+        ui32 columnIdx,
+        ui32 flatFeatureIdx,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) const {
+        const TArrowField& field = File.GetFields()[columnIdx];
+        CB_ENSURE_INTERNAL(field.DictionaryId, "ReadHashedCatColumn is implemented only for dictionary encoded columns");
+
+        // each value is hashed once, visitor's hash to string map is updated here, not in parallel
+        TVector<ui32> dictionaryHashes;
+        for (const auto& array : File.GetDictionary(*field.DictionaryId)) {
+            for (auto idx : xrange(array.Length)) {
+                dictionaryHashes.push_back(
+                    visitor->GetCatFeatureValue(
+                        flatFeatureIdx,
+                        array.IsValid(idx) ? GetArrowStringValue(field.ValueType, array, idx) : TStringBuf()
+                    )
+                );
+            }
+        }
+        bool hasNulls = false;
+        for (auto batchIdx : xrange(File.GetBatchCount())) {
+            hasNulls = hasNulls || File.GetArray(batchIdx, columnIdx).NullCount;
+        }
+        const ui32 nullHash = hasNulls ? visitor->GetCatFeatureValue(flatFeatureIdx, TStringBuf()) : 0;
+
+        TVector<ui32> result;
+        result.yresize(ObjectCount);
+        ForEachBatchInSubset(
+            [&] (ui32 batchIdx, ui64 begin, ui64 end, ui32 dstOffset) {
+                const TArrowArray& array = File.GetArray(batchIdx, columnIdx);
+                ui32* dst = result.data() + dstOffset;
+                DispatchArrowNumericType(
+                    field.IndexType,
+                    [&] (auto typeTag) {
+                        using TIndex = decltype(typeTag);
+                        for (auto idx : xrange(begin, end)) {
+                            if (!array.IsValid(idx)) {
+                                *dst++ = nullHash;
+                                continue;
+                            }
+                            const i64 dictionaryIdx = static_cast<i64>(GetArrowValue<TIndex>(array, idx));
+                            CB_ENSURE(
+                                (0 <= dictionaryIdx) && ((size_t)dictionaryIdx < dictionaryHashes.size()),
+                                "Arrow file: dictionary index is out of bounds"
+                            );
+                            *dst++ = dictionaryHashes[dictionaryIdx];
+                        }
+                    }
+                );
+            }
+        );
+        return result;
+    }
+
+    void TArrowDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(DataMetaInfo, ObjectCount, Args.ObjectsOrder, {File.GetResourceHolder()});
+
+        const auto& columns = DataMetaInfo.ColumnsInfo->Columns;
+        ui32 featureIdx = 0;
+        ui32 targetIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange(SafeIntegerCast<ui32>(columns.size()))) {
+            const EColumn columnType = columns[columnIdx].Type;
+            try {
+                if (IsFactorColumn(columnType)) {
+                    const ui32 flatFeatureIdx = featureIdx++;
+                    if (FeatureIgnored[flatFeatureIdx] || !Args.DatasetSubset.HasFeatures) {
+                        continue;
+                    }
+                    TVector<TString> convertedValues;
+                    switch (columnType) {
+                        case EColumn::Num:
+                            visitor->AddFloatFeature(flatFeatureIdx, GetFloatColumn(columnIdx));
+                            break;
+                        case EColumn::Categ:
+                            if (File.GetFields()[columnIdx].DictionaryId) {
+                                visitor->AddCatFeature(
+                                    flatFeatureIdx,
+                                    TMaybeOwningConstArrayHolder<ui32>::CreateOwning(
+                                        ReadHashedCatColumn(columnIdx, flatFeatureIdx, visitor)
+                                    )
+                                );
+                            } else {
+                                const auto values = ReadStringColumn(columnIdx, &convertedValues);
+                                visitor->AddCatFeature(flatFeatureIdx, TConstArrayRef<TStringBuf>(values));
+                            }
+                            break;
+                        case EColumn::Text: {
+                            const auto values = ReadStringColumn(columnIdx, &convertedValues);
+                            visitor->AddTextFeature(
+                                flatFeatureIdx,
+                                TMaybeOwningConstArrayHolder<TString>::CreateOwning(
+                                    TVector<TString>(values.begin(), values.end())
+                                )
+                            );
+                            break;
+                        }
+                        default:
+                            CB_ENSURE(false, "TArrowDataLoader: features of this type are not supported");
+                    }
+                    continue;
+                }
+
+                TVector<TString> convertedValues;
+                switch (columnType) {
+                    case EColumn::Label:
+                        CheckNoNulls(columnIdx);
+                        if (DataMetaInfo.TargetType == ERawTargetType::Float) {
+                            TVector<float> target = ReadNumericColumn<float>(columnIdx);
+                            visitor->AddTarget(targetIdx, MakeTypeCastArrayHolderFromVector<float, float>(target));
+                        } else {
+                            const auto values = ReadStringColumn(columnIdx, &convertedValues);
+                            visitor->AddTarget(targetIdx, TVector<TString>(values.begin(), values.end()));
+                        }
+                        ++targetIdx;
+                        break;
+                    case EColumn::Weight:
+                        CheckNoNulls(columnIdx);
+                        visitor->AddWeights(ReadNumericColumn<float>(columnIdx));
+                        break;
+                    case EColumn::GroupWeight:
+                        CheckNoNulls(columnIdx);
+                        visitor->AddGroupWeights(ReadNumericColumn<float>(columnIdx));
+                        break;
+                    case EColumn::Baseline:
+                        CheckNoNulls(columnIdx);
+                        visitor->AddBaseline(baselineIdx++, ReadNumericColumn<float>(columnIdx));
+                        break;
+                    case EColumn::GroupId:
+                    case EColumn::SubgroupId: {
+                        CheckNoNulls(columnIdx);
+                        const auto values = ReadStringColumn(columnIdx, &convertedValues);
+                        for (auto objectIdx : xrange(ObjectCount)) {
+                            if (columnType == EColumn::GroupId) {
+                                visitor->AddGroupId(objectIdx, CalcGroupIdFor(values[objectIdx]));
+                            } else {
+                                visitor->AddSubgroupId(objectIdx, CalcSubgroupIdFor(values[objectIdx]));
+                            }
+                        }
+                        break;
+                    }
+                    case EColumn::SampleId: {
+                        const auto values = ReadStringColumn(columnIdx, &convertedValues);
+                        for (auto objectIdx : xrange(ObjectCount)) {
+                            visitor->AddSampleId(objectIdx, TString(values[objectIdx]));
+                        }
+                        break;
+                    }
+                    case EColumn::Timestamp: {
+                        CheckNoNulls(columnIdx);
+                        const auto values = ReadNumericColumn<ui64>(columnIdx);
+                        for (auto objectIdx : xrange(ObjectCount)) {
+                            visitor->AddTimestamp(objectIdx, values[objectIdx]);
+                        }
+                        break;
+                    }
+                    case EColumn::Auxiliary:
+                        break;
+                    default:
+                        CB_ENSURE(false, "wrong column type");
+                }
+            } catch (yexception& e) {
+                throw TCatBoostException() << "Column " << columnIdx << " (type " << columnType
+                    << ", name \"" << File.GetFields()[columnIdx].Name << "\"): " << e.what();
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+        SetPairs(Args.PairsFilePath, Args.DatasetSubset, visitor->GetGroupIds(), visitor);
+        SetBaseline(
+            Args.BaselineFilePath,
+            ObjectCount,
+            Args.DatasetSubset,
+            ClassLabelsToStrings(DataMetaInfo.ClassLabels),
+            visitor
+        );
+        SetTimestamps(Args.TimestampsFilePath, ObjectCount, Args.DatasetSubset, visitor);
+        visitor->Finish();
+    }
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> ArrowExistsCheckerReg("arrow");
+        TDatasetLoaderFactory::TRegistrator<TArrowDataLoader> ArrowDataLoaderReg("arrow");
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "loader.h"
+#include "meta_info.h"
+
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+#include <catboost/libs/helpers/resource_holder.h>
+#include <catboost/private/libs/data_util/path_with_scheme.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    // type of values of one column in Arrow IPC file, nested types are not supported
+    struct TArrowValueType {
+        enum class EKind {
+            Bool,
+            Int,
+            FloatingPoint,
+            Utf8,
+            LargeUtf8
+        };
+
+        EKind Kind = EKind::Int;
+        ui32 ByteWidth = 0; // for Int and FloatingPoint
+        bool IsSigned = true; // for Int
+
+    public:
+        bool IsNumeric() const {
+            return Kind == EKind::Bool || Kind == EKind::Int || Kind == EKind::FloatingPoint;
+        }
+
+        bool IsString() const {
+            return Kind == EKind::Utf8 || Kind == EKind::LargeUtf8;
+        }
+    };
+
+    struct TArrowField {
+        TString Name;
+        TArrowValueType ValueType;
+
+        // for dictionary-encoded columns record batches contain indices in the dictionary
+        TMaybe<i64> DictionaryId;
+        TArrowValueType IndexType;
+
+    public:
+        // type of values stored in record batches
+        const TArrowValueType& GetStoredType() const {
+            return DictionaryId ? IndexType : ValueType;
+        }
+    };
+
+    // one column of one record batch, buffers point to the mapped file
+    struct TArrowArray {
+        ui64 Length = 0;
+        ui64 NullCount = 0;
+        TConstArrayRef<ui8> Validity; // empty if all values are valid
+        TConstArrayRef<ui8> Values; // offsets for string columns
+        TConstArrayRef<ui8> Data; // characters for string columns
+
+    public:
+        bool IsValid(ui64 idx) const {
+            return Validity.empty() || ((Validity[idx >> 3] >> (idx & 7)) & 1);
+        }
+    };
+
+    /*
+     * Apache Arrow IPC file format (a.k.a. Feather V2) reader, the file is memory mapped and
+     *  columns are not decoded until requested.
+     * Only flat columns with numeric, boolean and utf8 values (possibly dictionary encoded) in
+     *  uncompressed record batches are supported.
+     */
+    class TArrowFile {
+    public:
+        explicit TArrowFile(const TString& path);
+
+        const TVector<TArrowField>& GetFields() const {
+            return Fields;
+        }
+
+        ui64 GetRowCount() const {
+            return BatchOffsets.back();
+        }
+
+        ui32 GetBatchCount() const {
+            return RecordBatches.size();
+        }
+
+        ui64 GetBatchOffset(ui32 batchIdx) const {
+            return BatchOffsets[batchIdx];
+        }
+
+        const TArrowArray& GetArray(ui32 batchIdx, ui32 fieldIdx) const {
+            return RecordBatches[batchIdx][fieldIdx];
+        }
+
+        // all values of the dictionary, delta batches are concatenated
+        TConstArrayRef<TArrowArray> GetDictionary(i64 dictionaryId) const;
+
+        TIntrusivePtr<IResourceHolder> GetResourceHolder() const {
+            return FileHolder;
+        }
+
+    private:
+        TBlob File;
+        TIntrusivePtr<IResourceHolder> FileHolder;
+        TVector<TArrowField> Fields;
+        TVector<TVector<TArrowArray>> RecordBatches; // [batchIdx][fieldIdx]
+        TVector<ui64> BatchOffsets; // [batchIdx], has additional element with row count at the end
+        THashMap<i64, TVector<TArrowArray>> Dictionaries;
+    };
+
+
+    /*
+     * Loader for datasets in Arrow IPC files (scheme "arrow") written, e.g., by pyarrow.feather.write_feather
+     *  with compression='uncompressed'.
+     * Columns are matched with column description by their indices, column names are used as feature names.
+     * Only columns used for the dataset are decoded, record batches are decoded in parallel.
+     * Numeric features from single record batch files without nulls are not copied.
+     */
+    class TArrowDataLoader : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TArrowDataLoader(TDatasetLoaderPullArgs&& args);
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        // nulls are replaced by NaN for floating point destination types
+        template <class TDst>
+        TVector<TDst> ReadNumericColumn(ui32 columnIdx) const;
+
+        ITypedSequencePtr<float> GetFloatColumn(ui32 columnIdx) const;
+
+        // for non-string columns values are converted to strings and stored in convertedValues
+        TVector<TStringBuf> ReadStringColumn(ui32 columnIdx, TVector<TString>* convertedValues) const;
+
+        // for dictionary encoded columns, each dictionary value is hashed once
+        TVector<ui32> ReadHashedCatColumn(
+            ui32 columnIdx,
+            ui32 flatFeatureIdx,
+            IRawFeaturesOrderDataVisitor* visitor
+        ) const;
+
+        void CheckNoNulls(ui32 columnIdx) const;
+
+        // calls f(batchIdx, [begin, end) in batch, offset of begin in the loaded subset)
+        template <class TFunc>
+        void ForEachBatchInSubset(TFunc&& f) const;
+
+    private:
+        TArrowFile File;
+        TDatasetLoaderCommonArgs Args;
+        ui64 SubsetBegin = 0;
+        ui32 ObjectCount = 0;
+        TDataMetaInfo DataMetaInfo;
+        TVector<bool> FeatureIgnored; // [flatFeatureIdx]
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "arrow_loader.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/system/types.h>
+#include <util/system/unaligned_mem.h>
+
+#include <limits>
+#include <type_traits>
+
+
+// readers of values of TArrowArray shared by loaders of Arrow data from different sources
+
+namespace NCB {
+
+    inline ui64 GetArrowMinValuesBufferSize(const TArrowValueType& type, ui64 length) {
+        switch (type.Kind) {
+            case TArrowValueType::EKind::Bool:
+                return CeilDiv<ui64>(length, 8);
+            case TArrowValueType::EKind::Int:
+            case TArrowValueType::EKind::FloatingPoint:
+                return length * type.ByteWidth;
+            case TArrowValueType::EKind::Utf8:
+                return length ? (length + 1) * sizeof(i32) : 0;
+            case TArrowValueType::EKind::LargeUtf8:
+                return length ? (length + 1) * sizeof(i64) : 0;
+        }
+        Y_UNREACHABLE();
+    }
+
+    template <class T>
+    inline T GetArrowValue(const TArrowArray& array, ui64 idx) {
+        return ReadUnaligned<T>(array.Values.data() + idx * sizeof(T));
+    }
+
+    inline bool GetArrowBoolValue(const TArrowArray& array, ui64 idx) {
+        return (array.Values[idx >> 3] >> (idx & 7)) & 1;
+    }
+
+    inline TStringBuf GetArrowStringValue(const TArrowValueType& type, const TArrowArray& array, ui64 idx) {
+        i64 begin;
+        i64 end;
+        if (type.Kind == TArrowValueType::EKind::Utf8) {
+            begin = GetArrowValue<i32>(array, idx);
+            end = GetArrowValue<i32>(array, idx + 1);
+        } else {
+            begin = GetArrowValue<i64>(array, idx);
+            end = GetArrowValue<i64>(array, idx + 1);
+        }
+        CB_ENSURE(
+            (0 <= begin) && (begin <= end) && ((ui64)end <= array.Data.size()),
+            "Arrow data: wrong string offsets"
+        );
+        return TStringBuf((const char*)array.Data.data() + begin, end - begin);
+    }
+
+    // calls f with default constructed value of C++ type corresponding to Int or FloatingPoint type
+    template <class TFunc>
+    inline void DispatchArrowNumericType(const TArrowValueType& type, TFunc&& f) {
+        if (type.Kind == TArrowValueType::EKind::FloatingPoint) {
+            if (type.ByteWidth == 4) {
+                f(float());
+            } else {
+                f(double());
+            }
+            return;
+        }
+        CB_ENSURE_INTERNAL(type.Kind == TArrowValueType::EKind::Int, "Unexpected Arrow type kind");
+        switch (type.ByteWidth) {
+            case 1:
+                type.IsSigned ? f(i8()) : f(ui8());
+                break;
+            case 2:
+                type.IsSigned ? f(i16()) : f(ui16());
+                break;
+            case 4:
+                type.IsSigned ? f(i32()) : f(ui32());
+                break;
+            default:
+                type.IsSigned ? f(i64()) : f(ui64());
+        }
+    }
+
+    template <class TDst>
+    inline void ConvertArrowNumericArray(
+        const TArrowValueType& type,
+        const TArrowArray& array,
+        ui64 begin,
+        ui64 end,
+        TDst* dst
+    ) {
+        const TDst nullValue = std::numeric_limits<TDst>::quiet_NaN();
+        if (type.Kind == TArrowValueType::EKind::Bool) {
+            for (auto idx : xrange(begin, end)) {
+                *dst++ = array.IsValid(idx) ? TDst(GetArrowBoolValue(array, idx)) : nullValue;
+            }
+            return;
+        }
+        DispatchArrowNumericType(
+            type,
+            [&] (auto typeTag) {
+                using TSrc = decltype(typeTag);
+                for (auto idx : xrange(begin, end)) {
+                    *dst++ = array.IsValid(idx) ? static_cast<TDst>(GetArrowValue<TSrc>(array, idx)) : nullValue;
+                }
+            }
+        );
+    }
+
+    // for Int and Bool types
+    inline TString GetArrowIntegerValueAsString(const TArrowValueType& type, const TArrowArray& array, ui64 idx) {
+        if (type.Kind == TArrowValueType::EKind::Bool) {
+            return GetArrowBoolValue(array, idx) ? "1" : "0";
+        }
+        TString result;
+        DispatchArrowNumericType(
+            type,
+            [&] (auto typeTag) {
+                using TSrc = decltype(typeTag);
+                if constexpr (std::is_signed_v<TSrc>) {
+                    result = ToString((i64)GetArrowValue<TSrc>(array, idx));
+                } else {
+                    result = ToString((ui64)GetArrowValue<TSrc>(array, idx));
+                }
+            }
+        );
+        return result;
+    }
+}
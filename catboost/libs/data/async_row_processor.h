@@ -1,6 +1,7 @@
 #pragma once
 
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/profile_trace.h>
 
 #include <library/cpp/threading/future/future.h>
 #include <library/cpp/threading/local_executor/local_executor.h>
@@ -101,6 +102,7 @@ namespace NCB {
             NPar::ILocalExecutor::TExecRangeParams blockParams(0, ParseBuffer.ysize());
             blockParams.SetBlockCount(threadCount);
             LocalExecutor->ExecRangeWithThrow([this, blockParams, processFunc = std::move(processFunc)](int blockIdx) {
+                CB_PROFILE_TRACE_SCOPE("Parse rows block");
                 const int blockOffset = blockIdx * blockParams.GetBlockSize();
                 for (int i = blockOffset; i < Min(blockOffset + blockParams.GetBlockSize(), ParseBuffer.ysize()); ++i) {
                     processFunc(ParseBuffer[i], i);
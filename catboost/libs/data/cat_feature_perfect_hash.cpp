@@ -3,6 +3,7 @@
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/stream/output.h>
+#include <util/system/guard.h>
 
 
 template <>
@@ -24,6 +25,20 @@ namespace NCB {
             FuzzyEquals(Fraction, rhs.Fraction);
     }
 
+    TCatFeaturesPerfectHash::TCatFeaturesPerfectHash(TCatFeaturesPerfectHash&& rhs) {
+        *this = std::move(rhs);
+    }
+
+    TCatFeaturesPerfectHash& TCatFeaturesPerfectHash::operator=(TCatFeaturesPerfectHash&& rhs) {
+        CatFeatureUniqValuesCountsVector = std::move(rhs.CatFeatureUniqValuesCountsVector);
+        FeaturesPerfectHash = std::move(rhs.FeaturesPerfectHash);
+        HasHashInRam = rhs.HasHashInRam;
+        HasFeatureHashInRam = std::move(rhs.HasFeatureHashInRam);
+        FeatureStorageTempFiles = std::move(rhs.FeatureStorageTempFiles);
+        StorageTmpDir = std::move(rhs.StorageTmpDir);
+        return *this;
+    }
+
     bool TCatFeaturesPerfectHash::operator==(const TCatFeaturesPerfectHash& rhs) const {
         if (CatFeatureUniqValuesCountsVector != rhs.CatFeatureUniqValuesCountsVector) {
             return false;
@@ -60,10 +75,98 @@ namespace NCB {
         // cast is safe because map from ui32 keys can't have more than Max<ui32>() keys
         counts.OnAll = (ui32)perfectHash.GetSize();
 
-        if (!HasHashInRam) {
-            Load();
+        GetMutableFeaturePerfectHash(catFeatureIdx) = std::move(perfectHash);
+    }
+
+    void TCatFeaturesPerfectHash::FreeRam(const TString& tmpDir) const {
+        with_lock (StorageLock) {
+            if (HasHashInRam) {
+                HasFeatureHashInRam.assign(FeaturesPerfectHash.size(), true);
+                FeatureStorageTempFiles.resize(FeaturesPerfectHash.size());
+                HasHashInRam = false;
+            }
+            StorageTmpDir = tmpDir;
+            for (auto catFeatureIdx : xrange(FeaturesPerfectHash.size())) {
+                FreeFeatureRamImpl(catFeatureIdx);
+            }
+        }
+    }
+
+    void TCatFeaturesPerfectHash::FreeFeatureRam(const TCatFeatureIdx catFeatureIdx) const {
+        CheckHasFeature(catFeatureIdx);
+        with_lock (StorageLock) {
+            CB_ENSURE_INTERNAL(!HasHashInRam, "Cat features perfect hash RAM has not been freed before");
+            FreeFeatureRamImpl(*catFeatureIdx);
+        }
+    }
+
+    void TCatFeaturesPerfectHash::Load() const {
+        with_lock (StorageLock) {
+            if (!HasHashInRam) {
+                for (auto catFeatureIdx : xrange(FeaturesPerfectHash.size())) {
+                    LoadFeatureImpl(catFeatureIdx);
+                }
+                // saved copies are kept for the next FreeRam
+                HasHashInRam = true;
+            }
+        }
+    }
+
+    void TCatFeaturesPerfectHash::Save(IOutputStream* out) const {
+        Load();
+        ::SaveMany(out, CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+    }
+
+    void TCatFeaturesPerfectHash::Load(IInputStream* in) {
+        ::LoadMany(in, CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+        CB_ENSURE(HasHashInRam, "Cat features perfect hash has been saved without data");
+        HasFeatureHashInRam.clear();
+        FeatureStorageTempFiles.clear();
+    }
+
+    void TCatFeaturesPerfectHash::LoadFeature(const TCatFeatureIdx catFeatureIdx) const {
+        with_lock (StorageLock) {
+            LoadFeatureImpl(*catFeatureIdx);
+        }
+    }
+
+    TCatFeaturePerfectHash& TCatFeaturesPerfectHash::GetMutableFeaturePerfectHash(
+        const TCatFeatureIdx catFeatureIdx
+    ) {
+        CheckHasFeature(catFeatureIdx);
+        with_lock (StorageLock) {
+            LoadFeatureImpl(*catFeatureIdx);
+            if (!FeatureStorageTempFiles.empty()) {
+                FeatureStorageTempFiles[*catFeatureIdx].Reset();
+            }
+        }
+        return FeaturesPerfectHash[*catFeatureIdx];
+    }
+
+    void TCatFeaturesPerfectHash::FreeFeatureRamImpl(ui32 catFeatureIdx) const {
+        if (!HasFeatureHashInRam[catFeatureIdx]) {
+            return;
+        }
+        auto& storageTempFile = FeatureStorageTempFiles[catFeatureIdx];
+        if (!storageTempFile) {
+            storageTempFile = MakeHolder<TTempFile>(
+                JoinFsPaths(StorageTmpDir, TString::Join("cat_feature_index.", CreateGuidAsString(), ".tmp"))
+            );
+            TOFStream out(storageTempFile->Name());
+            ::Save(&out, FeaturesPerfectHash[catFeatureIdx]);
+        }
+        FeaturesPerfectHash[catFeatureIdx] = TCatFeaturePerfectHash();
+        HasFeatureHashInRam[catFeatureIdx] = false;
+    }
+
+    void TCatFeaturesPerfectHash::LoadFeatureImpl(ui32 catFeatureIdx) const {
+        if (HasHashInRam || HasFeatureHashInRam[catFeatureIdx]) {
+            return;
         }
-        FeaturesPerfectHash[*catFeatureIdx] = std::move(perfectHash);
+        CB_ENSURE(FeatureStorageTempFiles[catFeatureIdx], "Need a file to load cat features hash");
+        TIFStream inputStream(FeatureStorageTempFiles[catFeatureIdx]->Name());
+        ::Load(&inputStream, FeaturesPerfectHash[catFeatureIdx]);
+        HasFeatureHashInRam[catFeatureIdx] = true;
     }
 
     int TCatFeaturesPerfectHash::operator&(IBinSaver& binSaver) {
@@ -75,6 +178,8 @@ namespace NCB {
         binSaver.AddMulti(CatFeatureUniqValuesCountsVector, FeaturesPerfectHash);
         if (binSaver.IsReading()) {
             HasHashInRam = true;
+            HasFeatureHashInRam.clear();
+            FeatureStorageTempFiles.clear();
         }
         return 0;
     }
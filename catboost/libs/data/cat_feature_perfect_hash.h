@@ -172,6 +172,10 @@ struct TDumper<NCB::TCatFeaturePerfectHash> {
 
 namespace NCB {
 
+    /* Perfect hashes of features can be moved out of RAM by FreeRam, then they are saved to separate files
+     * and hashes of features are loaded back one by one when they are accessed. Processing of all features
+     * one by one with FreeFeatureRam after each of them needs RAM for the largest perfect hash only.
+     */
     class TCatFeaturesPerfectHash {
     public:
         // for IBinSaver
@@ -182,18 +186,18 @@ namespace NCB {
             , FeaturesPerfectHash(catFeatureCount)
         {}
 
-        TCatFeaturesPerfectHash(TCatFeaturesPerfectHash&& rhs) = default;
+        TCatFeaturesPerfectHash(TCatFeaturesPerfectHash&& rhs);
 
         ~TCatFeaturesPerfectHash() = default;
 
-        TCatFeaturesPerfectHash& operator=(TCatFeaturesPerfectHash&& rhs) = default;
+        TCatFeaturesPerfectHash& operator=(TCatFeaturesPerfectHash&& rhs);
 
         bool operator==(const TCatFeaturesPerfectHash& rhs) const;
 
         const TCatFeaturePerfectHash& GetFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx) const {
             CheckHasFeature(catFeatureIdx);
             if (!HasHashInRam) {
-                Load();
+                LoadFeature(catFeatureIdx);
             }
             return FeaturesPerfectHash[*catFeatureIdx];
         }
@@ -211,41 +215,25 @@ namespace NCB {
             return (size_t)*catFeatureIdx < CatFeatureUniqValuesCountsVector.size();
         }
 
-        void FreeRam(const TString& tmpDir) const {
-            if (!StorageTempFile) {
-                StorageTempFile = MakeHolder<TTempFile>(
-                    JoinFsPaths(tmpDir, TString::Join("cat_feature_index.", CreateGuidAsString(), ".tmp"))
-                );
-            }
-            Save();
-            TVector<TCatFeaturePerfectHash> empty;
-            FeaturesPerfectHash.swap(empty);
-            HasHashInRam = false;
+        // perfect hashes of all features are in RAM
+        bool IsInRam() const {
+            return HasHashInRam;
         }
 
-        void Load() const {
-            if (!HasHashInRam) {
-                CB_ENSURE(StorageTempFile, "Need a file to load cat features hash");
-                TIFStream inputStream(StorageTempFile->Name());
-                FeaturesPerfectHash.clear();
-                ::Load(&inputStream, FeaturesPerfectHash);
-                HasHashInRam = true;
-            }
-        }
+        void FreeRam(const TString& tmpDir) const;
 
-        Y_SAVELOAD_DEFINE(CatFeatureUniqValuesCountsVector, FeaturesPerfectHash, HasHashInRam);
+        // can be called after FreeRam, the feature perfect hash is saved only if it has not been saved yet
+        void FreeFeatureRam(const TCatFeatureIdx catFeatureIdx) const;
+
+        void Load() const;
+
+        void Save(IOutputStream* out) const;
+        void Load(IInputStream* in);
 
         int operator&(IBinSaver& binSaver);
 
         ui32 CalcCheckSum() const;
 
-    private:
-        void Save() const {
-            CB_ENSURE(StorageTempFile, "Need a file to load cat features hash");
-            TOFStream out(StorageTempFile->Name());
-            ::Save(&out, FeaturesPerfectHash);
-        }
-
     private:
         friend class TCatFeaturesPerfectHashHelper;
 
@@ -257,10 +245,24 @@ namespace NCB {
             );
         }
 
+        void LoadFeature(const TCatFeatureIdx catFeatureIdx) const;
+
+        // loaded perfect hash which is going to be updated, so its saved copy is dropped
+        TCatFeaturePerfectHash& GetMutableFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx);
+
+        // implementations of above, expect StorageLock to be acquired
+        void FreeFeatureRamImpl(ui32 catFeatureIdx) const;
+        void LoadFeatureImpl(ui32 catFeatureIdx) const;
+
     private:
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqValuesCountsVector; // [catFeatureIdx]
         mutable TVector<TCatFeaturePerfectHash> FeaturesPerfectHash; // [catFeatureIdx]
         mutable bool HasHashInRam = true;
-        mutable THolder<TTempFile> StorageTempFile;
+
+        // used only after FreeRam
+        mutable TVector<bool> HasFeatureHashInRam; // [catFeatureIdx]
+        mutable TVector<THolder<TTempFile>> FeatureStorageTempFiles; // [catFeatureIdx]
+        mutable TString StorageTmpDir;
+        mutable TAdaptiveLock StorageLock;
     };
 }
@@ -41,10 +41,7 @@ namespace NCB {
         TCatFeaturePerfectHash perfectHashMap;
         {
             TWriteGuard guard(QuantizedFeaturesInfo->GetRWMutex());
-            if (!featuresHash.HasHashInRam) {
-                featuresHash.Load();
-            }
-            perfectHashMap = std::move(featuresHash.FeaturesPerfectHash[*catFeatureIdx]);
+            perfectHashMap = std::move(featuresHash.GetMutableFeaturePerfectHash(catFeatureIdx));
         }
 
         // if perfectHashMap is already non-empty existing mapping can't be modified
@@ -211,7 +208,7 @@ namespace NCB {
                 uniqValuesCounts.OnLearnOnly = perfectHashMap.GetSize();
             }
             uniqValuesCounts.OnAll = perfectHashMap.GetSize();
-            featuresHash.FeaturesPerfectHash[*catFeatureIdx] = std::move(perfectHashMap);
+            featuresHash.GetMutableFeaturePerfectHash(catFeatureIdx) = std::move(perfectHashMap);
         }
     }
 
@@ -3,6 +3,7 @@
 
 #include <catboost/libs/column_description/cd_parser.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/private/libs/data_util/exists_checker.h>
 #include <catboost/private/libs/data_util/line_data_reader.h>
 #include <catboost/private/libs/labels/helpers.h>
@@ -10,6 +11,7 @@
 
 #include <library/cpp/object_factory/object_factory.h>
 #include <library/cpp/string_utils/csv/csv.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
@@ -19,17 +21,27 @@
 #include <util/system/guard.h>
 #include <util/system/types.h>
 
+#include <cstring>
+
 
 namespace NCB {
 
     TCBDsvDataLoader::TCBDsvDataLoader(TDatasetLoaderPullArgs&& args)
         : TCBDsvDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(
+                    args.PoolPath,
+                    args.CommonArgs.PoolFormat,
+                    /*keepLineOrder*/ true,
+                    args.CommonArgs.ShardsShuffleSeed
+                ),
                 std::move(args.CommonArgs)
             }
         )
     {
+        if (dynamic_cast<TFileLineDataReader*>(LineDataReader.Get()) && !BaselineReader) {
+            ChunkedPoolPath = args.PoolPath.Path;
+        }
     }
 
     TCBDsvDataLoader::TCBDsvDataLoader(TLineDataLoaderPushArgs&& args)
@@ -108,21 +120,52 @@ namespace NCB {
             &DataMetaInfo,
             &FeatureIgnored
         );
+    }
 
+    void TCBDsvDataLoader::StartAsyncReading() {
+        if (AsyncReadingStarted) {
+            return;
+        }
         AsyncRowProcessor.ReadBlockAsync(GetReadFunc());
         if (BaselineReader) {
             AsyncBaselineRowProcessor.ReadBlockAsync(GetReadBaselineFunc());
         }
+        AsyncReadingStarted = true;
     }
 
     TVector<TColumn> TCBDsvDataLoader::CreateColumnsDescription(ui32 columnsCount) {
         return Args.CdProvider->GetColumnsDescription(columnsCount);
     }
 
+    static ui64 CountLinesByChunks(const TString& path, bool hasHeader, NPar::ILocalExecutor* localExecutor) {
+        TLineChunkReader chunkReader(path, hasHeader);
+        const int threadCount = localExecutor->GetThreadCount() + 1;
+        TVector<ui64> partLineCounts(threadCount);
+        ui64 lineCount = 0;
+        TStringBuf chunk;
+        while (chunkReader.ReadChunk(&chunk)) {
+            const TVector<TStringBuf> parts = SplitAtLineBoundaries(chunk, threadCount);
+            localExecutor->ExecRangeWithThrow(
+                [&] (int partIdx) {
+                    partLineCounts[partIdx] = GetLineCount(parts[partIdx]);
+                },
+                0,
+                parts.ysize(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            for (auto partIdx : xrange(parts.size())) {
+                lineCount += partLineCounts[partIdx];
+            }
+        }
+        return lineCount;
+    }
+
     ui32 TCBDsvDataLoader::GetObjectCountSynchronized() {
         TGuard g(ObjectCountMutex);
         if (!ObjectCount) {
-            const ui64 dataLineCount = LineDataReader->GetDataLineCount();
+            const ui64 dataLineCount = ChunkedPoolPath ?
+                CountLinesByChunks(*ChunkedPoolPath, Args.PoolFormat.HasHeader, Args.LocalExecutor)
+                : LineDataReader->GetDataLineCount();
             CB_ENSURE(
                 dataLineCount <= Max<ui32>(), "CatBoost does not support datasets with more than "
                 << Max<ui32>() << " objects"
@@ -165,187 +208,242 @@ namespace NCB {
         return result;
     }
 
-    void TCBDsvDataLoader::ProcessBlock(IRawObjectsOrderDataVisitor* visitor) {
-        visitor->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
-
-        auto& columnsDescription = DataMetaInfo.ColumnsInfo->Columns;
-
-        auto parseLine = [&](TString& line, int lineIdx) {
-            const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
-
-            ui32 featureId = 0;
-            ui32 targetId = 0;
-            ui32 baselineIdx = 0;
-
-            TVector<float> floatFeatures;
-            floatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
+    namespace {
+        // the same as NCsvFormat::CsvSplitter with quoting ignored, but delimiters are searched by memchr
+        class TUnquotedFieldsSplitter {
+        public:
+            TUnquotedFieldsSplitter(TStringBuf line, char delimiter)
+                : Delimiter(delimiter)
+                , Begin(line.begin())
+                , End(line.end())
+            {}
 
-            TVector<ui32> catFeatures;
-            catFeatures.yresize(featuresLayout.GetCatFeatureCount());
+            bool Step() {
+                if (Begin == End) {
+                    return false;
+                }
+                ++Begin;
+                return true;
+            }
 
-            TVector<TString> textFeatures;
-            textFeatures.yresize(featuresLayout.GetTextFeatureCount());
+            TStringBuf Consume() {
+                const char* tokenEnd = (const char*)memchr(Begin, Delimiter, End - Begin);
+                if (!tokenEnd) {
+                    tokenEnd = End;
+                }
+                const TStringBuf token(Begin, tokenEnd);
+                Begin = tokenEnd;
+                return token;
+            }
 
-            TVector<TVector<float>> embeddingFeatures;
-            embeddingFeatures.yresize(featuresLayout.GetEmbeddingFeatureCount());
+        private:
+            const char Delimiter;
+            const char* Begin;
+            const char* const End;
+        };
+    }
 
-            size_t tokenIdx = 0;
-            try {
-                const bool floatFeaturesOnly = catFeatures.empty() && textFeatures.empty();
-                auto splitter = NCsvFormat::CsvSplitter(line, FieldDelimiter, floatFeaturesOnly ? '\0' : CsvSplitterQuote);
-                do {
-                    TStringBuf token = splitter.Consume();
-                    CB_ENSURE(
-                        tokenIdx < columnsDescription.size(),
-                        "wrong column count: found token " << token << " with id more than " << columnsDescription.ysize() << " values:\n" << line
-                    );
-                    try {
-                        switch (columnsDescription[tokenIdx].Type) {
-                            case EColumn::Categ: {
-                                if (!FeatureIgnored[featureId]) {
-                                    const ui32 catFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
-                                    catFeatures[catFeatureIdx] = visitor->GetCatFeatureValue(lineIdx, featureId, token);
-                                }
-                                ++featureId;
-                                break;
-                            }
-                            case EColumn::HashedCateg: {
-                                if (!FeatureIgnored[featureId]) {
-                                    if (!TryFromString<ui32>(
-                                            token,
-                                            catFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
-                                        ))
-                                    {
-                                        CB_ENSURE(
-                                            false,
-                                            "Factor " << featureId << "=" << token << " cannot be parsed as hashed categorical value."
-                                            " Try correcting column description file."
-                                        );
-                                    }
-                                }
-                                ++featureId;
-                                break;
-                            }
-                            case EColumn::Num: {
-                                if (!FeatureIgnored[featureId]) {
-                                    if (!TryFloatFromString(
-                                            token,
-                                            /*parseNonFinite*/true,
-                                            &floatFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
-                                         ))
-                                    {
-                                        CB_ENSURE(
-                                            false,
-                                            "Factor " << featureId << "=" << token << " cannot be parsed as float."
-                                            " Try correcting column description file."
-                                        );
-                                    }
-                                }
-                                ++featureId;
-                                break;
+    template <class TFieldsSplitter>
+    void TCBDsvDataLoader::ParseLine(
+        TStringBuf line,
+        TFieldsSplitter& splitter,
+        ui32 objectIdx,
+        ui64 lineNumber,
+        IRawObjectsOrderDataVisitor* visitor
+    ) {
+        const auto& columnsDescription = DataMetaInfo.ColumnsInfo->Columns;
+        const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
+
+        ui32 featureId = 0;
+        ui32 targetId = 0;
+        ui32 baselineIdx = 0;
+
+        TVector<float> floatFeatures;
+        floatFeatures.yresize(featuresLayout.GetFloatFeatureCount());
+
+        TVector<ui32> catFeatures;
+        catFeatures.yresize(featuresLayout.GetCatFeatureCount());
+
+        TVector<TString> textFeatures;
+        textFeatures.yresize(featuresLayout.GetTextFeatureCount());
+
+        TVector<TVector<float>> embeddingFeatures;
+        embeddingFeatures.yresize(featuresLayout.GetEmbeddingFeatureCount());
+
+        size_t tokenIdx = 0;
+        try {
+            do {
+                TStringBuf token = splitter.Consume();
+                CB_ENSURE(
+                    tokenIdx < columnsDescription.size(),
+                    "wrong column count: found token " << token << " with id more than " << columnsDescription.ysize() << " values:\n" << line
+                );
+                try {
+                    switch (columnsDescription[tokenIdx].Type) {
+                        case EColumn::Categ: {
+                            if (!FeatureIgnored[featureId]) {
+                                const ui32 catFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
+                                catFeatures[catFeatureIdx] = visitor->GetCatFeatureValue(objectIdx, featureId, token);
                             }
-                            case EColumn::Text: {
-                                if (!FeatureIgnored[featureId]) {
-                                    const ui32 textFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
-                                    textFeatures[textFeatureIdx] = TString(token);
+                            ++featureId;
+                            break;
+                        }
+                        case EColumn::HashedCateg: {
+                            if (!FeatureIgnored[featureId]) {
+                                if (!TryFromString<ui32>(
+                                        token,
+                                        catFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
+                                    ))
+                                {
+                                    CB_ENSURE(
+                                        false,
+                                        "Factor " << featureId << "=" << token << " cannot be parsed as hashed categorical value."
+                                        " Try correcting column description file."
+                                    );
                                 }
-                                ++featureId;
-                                break;
                             }
-                            case EColumn::NumVector: {
-                                if (!FeatureIgnored[featureId]) {
-                                    const ui32 embeddingFeatureIdx
-                                        = featuresLayout.GetInternalFeatureIdx(featureId);
-                                    embeddingFeatures[embeddingFeatureIdx] = ProcessNumVector(
+                            ++featureId;
+                            break;
+                        }
+                        case EColumn::Num: {
+                            if (!FeatureIgnored[featureId]) {
+                                if (!TryFloatFromString(
                                         token,
-                                        NumVectorDelimiter,
-                                        featureId
+                                        /*parseNonFinite*/true,
+                                        &floatFeatures[featuresLayout.GetInternalFeatureIdx(featureId)]
+                                     ))
+                                {
+                                    CB_ENSURE(
+                                        false,
+                                        "Factor " << featureId << "=" << token << " cannot be parsed as float."
+                                        " Try correcting column description file."
                                     );
                                 }
-                                ++featureId;
-                                break;
                             }
-                            case EColumn::Label: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Label");
-                                visitor->AddTarget(targetId, lineIdx, TString(token));
-                                ++targetId;
+                            ++featureId;
                             break;
+                        }
+                        case EColumn::Text: {
+                            if (!FeatureIgnored[featureId]) {
+                                const ui32 textFeatureIdx = featuresLayout.GetInternalFeatureIdx(featureId);
+                                textFeatures[textFeatureIdx] = TString(token);
                             }
-                            case EColumn::Weight: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for weight");
-                                visitor->AddWeight(lineIdx, FromString<float>(token));
-                                break;
-                            }
-                            case EColumn::Auxiliary: {
-                                break;
-                            }
-                            case EColumn::GroupId: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
-                                visitor->AddGroupId(lineIdx, CalcGroupIdFor(token));
-                                break;
-                            }
-                            case EColumn::GroupWeight: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
-                                visitor->AddGroupWeight(lineIdx, FromString<float>(token));
-                                break;
-                            }
-                            case EColumn::SubgroupId: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
-                                visitor->AddSubgroupId(lineIdx, CalcSubgroupIdFor(token));
-                                break;
-                            }
-                            case EColumn::Baseline: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
-                                visitor->AddBaseline(lineIdx, baselineIdx, FromString<float>(token));
-                                ++baselineIdx;
-                                break;
-                            }
-                            case EColumn::SampleId: {
-                                break;
-                            }
-                            case EColumn::Timestamp: {
-                                CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
-                                visitor->AddTimestamp(lineIdx, FromString<ui64>(token));
-                                break;
-                            }
-                            default: {
-                                CB_ENSURE(false, "wrong column type");
+                            ++featureId;
+                            break;
+                        }
+                        case EColumn::NumVector: {
+                            if (!FeatureIgnored[featureId]) {
+                                const ui32 embeddingFeatureIdx
+                                    = featuresLayout.GetInternalFeatureIdx(featureId);
+                                embeddingFeatures[embeddingFeatureIdx] = ProcessNumVector(
+                                    token,
+                                    NumVectorDelimiter,
+                                    featureId
+                                );
                             }
+                            ++featureId;
+                            break;
+                        }
+                        case EColumn::Label: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for Label");
+                            visitor->AddTarget(targetId, objectIdx, TString(token));
+                            ++targetId;
+                        break;
+                        }
+                        case EColumn::Weight: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for weight");
+                            visitor->AddWeight(objectIdx, FromString<float>(token));
+                            break;
+                        }
+                        case EColumn::Auxiliary: {
+                            break;
+                        }
+                        case EColumn::GroupId: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for GroupId");
+                            visitor->AddGroupId(objectIdx, CalcGroupIdFor(token));
+                            break;
+                        }
+                        case EColumn::GroupWeight: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for GroupWeight");
+                            visitor->AddGroupWeight(objectIdx, FromString<float>(token));
+                            break;
+                        }
+                        case EColumn::SubgroupId: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for SubgroupId");
+                            visitor->AddSubgroupId(objectIdx, CalcSubgroupIdFor(token));
+                            break;
+                        }
+                        case EColumn::Baseline: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for Baseline");
+                            visitor->AddBaseline(objectIdx, baselineIdx, FromString<float>(token));
+                            ++baselineIdx;
+                            break;
+                        }
+                        case EColumn::SampleId: {
+                            break;
+                        }
+                        case EColumn::Timestamp: {
+                            CB_ENSURE(token.length() != 0, "empty values not supported for Timestamp");
+                            visitor->AddTimestamp(objectIdx, FromString<ui64>(token));
+                            break;
+                        }
+                        default: {
+                            CB_ENSURE(false, "wrong column type");
                         }
-                    } catch (yexception& e) {
-                        throw TCatBoostException() << "Column " << tokenIdx << " (type "
-                            << columnsDescription[tokenIdx].Type << ", value = \"" << token
-                            << "\"): " << e.what();
                     }
-                    ++tokenIdx;
-                } while (splitter.Step());
-                CB_ENSURE(
-                    tokenIdx == columnsDescription.size(),
-                    "wrong column count: expected " << columnsDescription.ysize() << ", found " << tokenIdx
-                );
-                if (!floatFeatures.empty()) {
-                    visitor->AddAllFloatFeatures(lineIdx, floatFeatures);
-                }
-                if (!catFeatures.empty()) {
-                    visitor->AddAllCatFeatures(lineIdx, catFeatures);
+                } catch (yexception& e) {
+                    throw TCatBoostException() << "Column " << tokenIdx << " (type "
+                        << columnsDescription[tokenIdx].Type << ", value = \"" << token
+                        << "\"): " << e.what();
                 }
-                if (!textFeatures.empty()) {
-                    visitor->AddAllTextFeatures(lineIdx, textFeatures);
-                }
-                if (!embeddingFeatures.empty()) {
-                    for (auto embeddingFeatureIdx : xrange(embeddingFeatures.size())) {
-                        visitor->AddEmbeddingFeature(
-                            lineIdx,
-                            featuresLayout.GetEmbeddingFeatureInternalIdxToExternalIdx()[embeddingFeatureIdx],
-                            TMaybeOwningConstArrayHolder<float>::CreateOwning(
-                                std::move(embeddingFeatures[embeddingFeatureIdx])
-                            )
-                        );
-                    }
+                ++tokenIdx;
+            } while (splitter.Step());
+            CB_ENSURE(
+                tokenIdx == columnsDescription.size(),
+                "wrong column count: expected " << columnsDescription.ysize() << ", found " << tokenIdx
+            );
+            if (!floatFeatures.empty()) {
+                visitor->AddAllFloatFeatures(objectIdx, floatFeatures);
+            }
+            if (!catFeatures.empty()) {
+                visitor->AddAllCatFeatures(objectIdx, catFeatures);
+            }
+            if (!textFeatures.empty()) {
+                visitor->AddAllTextFeatures(objectIdx, textFeatures);
+            }
+            if (!embeddingFeatures.empty()) {
+                for (auto embeddingFeatureIdx : xrange(embeddingFeatures.size())) {
+                    visitor->AddEmbeddingFeature(
+                        objectIdx,
+                        featuresLayout.GetEmbeddingFeatureInternalIdxToExternalIdx()[embeddingFeatureIdx],
+                        TMaybeOwningConstArrayHolder<float>::CreateOwning(
+                            std::move(embeddingFeatures[embeddingFeatureIdx])
+                        )
+                    );
                 }
-            } catch (yexception& e) {
-                throw TCatBoostException() << "Error in dsv data. Line " <<
-                    AsyncRowProcessor.GetLinesProcessed() + lineIdx + 1 << ": " << e.what();
+            }
+        } catch (yexception& e) {
+            throw TCatBoostException() << "Error in dsv data. Line " <<
+                lineNumber << ": " << e.what();
+        }
+    }
+
+    void TCBDsvDataLoader::ProcessBlock(IRawObjectsOrderDataVisitor* visitor) {
+        visitor->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
+
+        const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
+        const bool floatFeaturesOnly
+            = (featuresLayout.GetCatFeatureCount() == 0) && (featuresLayout.GetTextFeatureCount() == 0);
+        const bool ignoreQuoting = floatFeaturesOnly || (CsvSplitterQuote == '\0');
+
+        auto parseLine = [&](TString& line, int lineIdx) {
+            const ui64 lineNumber = AsyncRowProcessor.GetLinesProcessed() + lineIdx + 1;
+            if (ignoreQuoting) {
+                TUnquotedFieldsSplitter splitter(line, FieldDelimiter);
+                ParseLine(line, splitter, lineIdx, lineNumber, visitor);
+            } else {
+                NCsvFormat::CsvSplitter splitter(line, FieldDelimiter, CsvSplitterQuote);
+                ParseLine(line, splitter, lineIdx, lineNumber, visitor);
             }
         };
 
@@ -362,6 +460,71 @@ namespace NCB {
         }
     }
 
+    void TCBDsvDataLoader::DoByChunks(IRawObjectsOrderDataVisitor* visitor) {
+        StartBuilder(false, GetObjectCountSynchronized(), 0, visitor);
+
+        NPar::ILocalExecutor* localExecutor = Args.LocalExecutor;
+        const int threadCount = localExecutor->GetThreadCount() + 1;
+
+        const auto& featuresLayout = *DataMetaInfo.FeaturesLayout;
+        const bool floatFeaturesOnly
+            = (featuresLayout.GetCatFeatureCount() == 0) && (featuresLayout.GetTextFeatureCount() == 0);
+        const bool ignoreQuoting = floatFeaturesOnly || (CsvSplitterQuote == '\0');
+
+        TLineChunkReader chunkReader(*ChunkedPoolPath, Args.PoolFormat.HasHeader);
+        TVector<TVector<TStringBuf>> partLines(threadCount);
+        TVector<ui32> partOffsets(threadCount + 1, 0);
+        ui64 linesProcessed = 0;
+        TStringBuf chunk;
+        while (chunkReader.ReadChunk(&chunk)) {
+            const TVector<TStringBuf> parts = SplitAtLineBoundaries(chunk, threadCount);
+            localExecutor->ExecRangeWithThrow(
+                [&] (int partIdx) {
+                    SplitLines(parts[partIdx], &partLines[partIdx]);
+                },
+                0,
+                parts.ysize(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            for (auto partIdx : xrange(parts.size())) {
+                partOffsets[partIdx + 1] = partOffsets[partIdx] + partLines[partIdx].size();
+            }
+            const ui32 chunkLineCount = partOffsets[parts.size()];
+
+            // objects of different parts are added to the block concurrently, as in ProcessBlock
+            visitor->StartNextBlock(chunkLineCount);
+            localExecutor->ExecRangeWithThrow(
+                [&] (int partIdx) {
+                    CB_PROFILE_TRACE_SCOPE("Parse dsv chunk part");
+                    TString lineBuffer; // CsvSplitter needs mutable TString
+                    const auto& lines = partLines[partIdx];
+                    for (auto lineIdx : xrange(lines.size())) {
+                        const ui32 objectIdx = partOffsets[partIdx] + lineIdx;
+                        const ui64 lineNumber = linesProcessed + objectIdx + 1;
+                        if (ignoreQuoting) {
+                            TUnquotedFieldsSplitter splitter(lines[lineIdx], FieldDelimiter);
+                            ParseLine(lines[lineIdx], splitter, objectIdx, lineNumber, visitor);
+                        } else {
+                            lineBuffer = lines[lineIdx];
+                            NCsvFormat::CsvSplitter splitter(lineBuffer, FieldDelimiter, CsvSplitterQuote);
+                            ParseLine(lineBuffer, splitter, objectIdx, lineNumber, visitor);
+                        }
+                    }
+                },
+                0,
+                parts.ysize(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            linesProcessed += chunkLineCount;
+        }
+        CB_ENSURE(
+            linesProcessed == GetObjectCountSynchronized(),
+            "TCBDsvDataLoader: pool file has been changed during loading"
+        );
+
+        FinalizeBuilder(false, visitor);
+    }
+
     int GetDsvColumnCount(const TPathWithScheme& pathWithScheme, const TDsvFormatOptions& format, bool ignoreCsvQuoting) {
         CB_ENSURE_INTERNAL(pathWithScheme.Scheme == "dsv", "Unsupported scheme " << pathWithScheme.Scheme);
         TString firstLine;
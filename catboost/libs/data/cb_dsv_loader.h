@@ -4,11 +4,13 @@
 #include "loader.h"
 
 #include <catboost/libs/column_description/column.h>
+#include <catboost/private/libs/data_util/line_chunk_reader.h>
 #include <catboost/private/libs/data_util/line_data_reader.h>
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/generic/ylimits.h>
@@ -49,10 +51,16 @@ namespace NCB {
         }
 
         void Do(IRawObjectsOrderDataVisitor* visitor) override {
-            TBase::Do(GetReadFunc(), GetReadBaselineFunc(), visitor);
+            if (ChunkedPoolPath) {
+                DoByChunks(visitor);
+            } else {
+                StartAsyncReading();
+                TBase::Do(GetReadFunc(), GetReadBaselineFunc(), visitor);
+            }
         }
 
         bool DoBlock(IRawObjectsOrderDataVisitor* visitor) override {
+            StartAsyncReading();
             return TBase::DoBlock(GetReadFunc(), GetReadBaselineFunc(), visitor);
         }
 
@@ -69,6 +77,25 @@ namespace NCB {
 
         void ProcessBlock(IRawObjectsOrderDataVisitor* visitor) override;
 
+    protected:
+        void StartAsyncReading();
+
+        /* Read file by chunks of bytes instead of line by line in one thread.
+         * Lines of each chunk are split and parsed in parallel and passed to visitor
+         * as a block with their offsets in the chunk.
+         */
+        void DoByChunks(IRawObjectsOrderDataVisitor* visitor);
+
+        // lineNumber is used in error messages only
+        template <class TFieldsSplitter>
+        void ParseLine(
+            TStringBuf line,
+            TFieldsSplitter& splitter,
+            ui32 objectIdx,
+            ui64 lineNumber,
+            IRawObjectsOrderDataVisitor* visitor
+        );
+
     protected:
         TVector<bool> FeatureIgnored; // init in process
         char FieldDelimiter;
@@ -76,6 +103,8 @@ namespace NCB {
         char CsvSplitterQuote;
         THolder<NCB::ILineDataReader> LineDataReader;
         THolder<NCB::IBaselineReader> BaselineReader;
+        TMaybe<TString> ChunkedPoolPath; // defined if pool is a local file and can be read by chunks
+        bool AsyncReadingStarted = false;
 
         // cached
         TMutex ObjectCountMutex;
@@ -1 +1,60 @@
 #include "columns.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+
+
+namespace NCB {
+
+    TVector<TConstEmbedding> MakeDenseEmbeddings(TMaybeOwningConstArrayHolder<float> data, size_t dimension) {
+        CB_ENSURE_INTERNAL(dimension > 0, "Embedding dimension must be positive");
+        CB_ENSURE_INTERNAL(
+            data.GetSize() % dimension == 0,
+            "Dense embeddings data size " << data.GetSize() << " is not a multiple of dimension " << dimension
+        );
+        TVector<TConstEmbedding> embeddings;
+        embeddings.reserve(data.GetSize() / dimension);
+        for (size_t offset = 0; offset < data.GetSize(); offset += dimension) {
+            embeddings.push_back(data.Slice(offset, dimension));
+        }
+        return embeddings;
+    }
+
+    void MakeEmbeddingsContiguous(TArrayRef<TConstEmbedding> embeddings, NPar::ILocalExecutor* localExecutor) {
+        if (embeddings.empty()) {
+            return;
+        }
+        const size_t dimension = embeddings[0].GetSize();
+        const bool canBeMadeContiguous = (dimension > 0) && AllOf(
+            embeddings,
+            [=] (const TConstEmbedding& embedding) {
+                return (embedding.GetSize() == dimension) && embedding.GetResourceHolder();
+            }
+        );
+        if (!canBeMadeContiguous) {
+            return;
+        }
+
+        TVector<float> data;
+        data.yresize(embeddings.size() * dimension);
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            SafeIntegerCast<ui32>(embeddings.size()),
+            [&] (ui32 objectIdx) {
+                Copy(embeddings[objectIdx].begin(), embeddings[objectIdx].end(), data.begin() + objectIdx * dimension);
+            }
+        );
+
+        // per-object buffers are released as embeddings are replaced
+        TVector<TConstEmbedding> denseEmbeddings = MakeDenseEmbeddings(
+            TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(data)),
+            dimension
+        );
+        for (auto objectIdx : xrange(embeddings.size())) {
+            embeddings[objectIdx] = std::move(denseEmbeddings[objectIdx]);
+        }
+    }
+
+}
@@ -479,6 +479,18 @@ namespace NCB {
     using TEmbeddingValuesHolder = ITypedFeatureValuesHolder<TConstEmbedding, EFeatureValuesType::Embedding>;
     using TEmbeddingArrayValuesHolder = TPolymorphicArrayValuesHolder<TEmbeddingValuesHolder>;
 
+    /* Embeddings of objects from one contiguous buffer, row-major with dimension values per object.
+     * Returned embeddings are views of rows that share ownership of data, so there are no per-object
+     * allocations.
+     */
+    TVector<TConstEmbedding> MakeDenseEmbeddings(TMaybeOwningConstArrayHolder<float> data, size_t dimension);
+
+    /* Replaces owning per-object embeddings with views of one contiguous buffer.
+     * Does nothing if embeddings have different dimensions or some of them are non-owning views of external
+     * data.
+     */
+    void MakeEmbeddingsContiguous(TArrayRef<TConstEmbedding> embeddings, NPar::ILocalExecutor* localExecutor);
+
 
     using IQuantizedFloatValuesHolder = IQuantizedFeatureValuesHolder<ui8, EFeatureValuesType::QuantizedFloat>;
     using IQuantizedCatValuesHolder = IQuantizedFeatureValuesHolder<ui32, EFeatureValuesType::PerfectHashedCategorical>;
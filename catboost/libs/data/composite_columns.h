@@ -218,11 +218,13 @@ namespace NCB {
     public:
         TFeaturesGroupPartValuesHolderImpl(ui32 featureId,
                                            const IFeaturesGroupArray* groupData,
-                                           ui32 inGroupIdx)
+                                           ui32 inGroupIdx,
+                                           ui32 partBitCount = CHAR_BIT)
             : TBase(featureId, groupData->GetSize())
             , GroupData(dynamic_cast<const TFeaturesGroupArrayHolder*>(groupData))
             , GroupSizeInBytes(0) // inited below
             , InGroupIdx(inGroupIdx)
+            , PartBitCount(partBitCount)
         {
             CB_ENSURE_INTERNAL(GroupData, "groupData is empty or is not TFeaturesGroupArrayHolder");
             ui32 bitsPerKey;
@@ -236,8 +238,9 @@ namespace NCB {
 
         TFeaturesGroupPartValuesHolderImpl(ui32 featureId,
                                            THolder<TFeaturesGroupArrayHolder>&& groupData,
-                                           ui32 inGroupIdx)
-            : TFeaturesGroupPartValuesHolderImpl(featureId, groupData.Get(), inGroupIdx)
+                                           ui32 inGroupIdx,
+                                           ui32 partBitCount = CHAR_BIT)
+            : TFeaturesGroupPartValuesHolderImpl(featureId, groupData.Get(), inGroupIdx, partBitCount)
         {
             GroupDataHolder = std::move(groupData);
         }
@@ -262,7 +265,8 @@ namespace NCB {
                     GroupData->CloneWithNewSubsetIndexing(cloningParams, localExecutor),
                     "Column type changed after cloning"
                 ),
-                InGroupIdx
+                InGroupIdx,
+                PartBitCount
             );
         }
 
@@ -278,8 +282,8 @@ namespace NCB {
                 [&] (const auto* histogram) {
                     using TGroup = std::remove_cvref_t<decltype(*histogram)>;
 
-                    auto transformer = [firstBitPos = InGroupIdx * CHAR_BIT] (TGroup group) {
-                        return group >> firstBitPos;
+                    auto transformer = [inGroupIdx = InGroupIdx, partBitCount = PartBitCount] (TGroup group) {
+                        return GetPartValueFromGroup(group, inGroupIdx, partBitCount);
                     };
 
                     result = MakeTransformingArraySubsetBlockIterator<ui8>(
@@ -300,6 +304,7 @@ namespace NCB {
         const TFeaturesGroupArrayHolder* GroupData;
         ui32 GroupSizeInBytes;
         ui32 InGroupIdx;
+        ui32 PartBitCount;
         THolder<TFeaturesGroupArrayHolder> GroupDataHolder;
     };
 
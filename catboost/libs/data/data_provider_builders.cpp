@@ -7,6 +7,7 @@
 #include "lazy_columns.h"
 #include "sparse_columns.h"
 #include "objects.h"
+#include "quantization.h"
 #include "sparse_columns.h"
 #include "target.h"
 #include "util.h"
@@ -1022,6 +1023,9 @@ namespace NCB {
                                 )
                             );
                         } else {
+                            if constexpr (std::is_same_v<T, TConstEmbedding>) {
+                                MakeEmbeddingsContiguous(PerFeatureData[perTypeFeatureIdx].DenseDstView, LocalExecutor);
+                            }
                             result->push_back(
                                 MakeHolder<TPolymorphicArrayValuesHolder<TColumn>>(
                                     /* featureId */ flatFeatureIdx,
@@ -2423,4 +2427,252 @@ namespace NCB {
                 return nullptr;
         }
     }
+
+    template <class TDst, class TValue>
+    static TMaybeOwningConstArrayHolder<ui8> MakeQuantizedFeaturePart(TConstArrayRef<TValue> values) {
+        auto part = TMaybeOwningConstArrayHolder<TDst>::CreateOwning(TVector<TDst>(values.begin(), values.end()));
+        return TMaybeOwningConstArrayHolder<ui8>::CreateOwningReinterpretCast(part);
+    }
+
+    template <class TValue>
+    static TMaybeOwningConstArrayHolder<ui8> MakeQuantizedFeaturePart(
+        TConstArrayRef<TValue> values,
+        ui8 bitsPerDocumentFeature
+    ) {
+        switch (bitsPerDocumentFeature) {
+            case 8:
+                return MakeQuantizedFeaturePart<ui8>(values);
+            case 16:
+                return MakeQuantizedFeaturePart<ui16>(values);
+            default:
+                CB_ENSURE_INTERNAL(
+                    bitsPerDocumentFeature == 32,
+                    "Unsupported bits per document feature: " << (int)bitsPerDocumentFeature
+                );
+                return MakeQuantizedFeaturePart<ui32>(values);
+        }
+    }
+
+    // pass objects [objectOffset, data.GetObjectCount()) of data to visitor starting from dstObjectOffset
+    static void AddQuantizedDataPart(
+        const TQuantizedDataProvider& data,
+        ui32 objectOffset,
+        ui32 dstObjectOffset,
+        const TPoolQuantizationSchema& poolQuantizationSchema,
+        IQuantizedFeaturesDataVisitor* visitor,
+        NPar::ILocalExecutor* localExecutor
+    ) {
+        const auto& objectsData = *data.ObjectsData;
+        const auto& featuresLayout = *data.MetaInfo.FeaturesLayout;
+        const ui32 objectCount = objectsData.GetObjectCount();
+
+        auto slice = [=] (auto values) {
+            return values.Slice(objectOffset);
+        };
+
+        for (auto i : xrange(poolQuantizationSchema.FloatFeatureIndices.size())) {
+            const auto flatFeatureIdx = SafeIntegerCast<ui32>(poolQuantizationSchema.FloatFeatureIndices[i]);
+            const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+            const auto feature = objectsData.GetFloatFeature(*floatFeatureIdx);
+            if (!feature) {
+                continue;
+            }
+            const ui8 bitsPerDocumentFeature = CalcHistogramWidthForBorders(
+                poolQuantizationSchema.Borders[i].size()
+            );
+            const TVector<ui8> values = (*feature)->ExtractValues(localExecutor);
+            visitor->AddFloatFeaturePart(
+                flatFeatureIdx,
+                dstObjectOffset,
+                bitsPerDocumentFeature,
+                MakeQuantizedFeaturePart(slice(TConstArrayRef<ui8>(values)), bitsPerDocumentFeature)
+            );
+        }
+        for (auto i : xrange(poolQuantizationSchema.CatFeatureIndices.size())) {
+            const auto flatFeatureIdx = SafeIntegerCast<ui32>(poolQuantizationSchema.CatFeatureIndices[i]);
+            const auto catFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
+            const auto feature = objectsData.GetCatFeature(*catFeatureIdx);
+            if (!feature) {
+                continue;
+            }
+            const ui8 bitsPerDocumentFeature = CalcHistogramWidthForUniqueValuesCount(
+                poolQuantizationSchema.FeaturesPerfectHash[i].size()
+            );
+            const TVector<ui32> values = (*feature)->ExtractValues(localExecutor);
+            visitor->AddCatFeaturePart(
+                flatFeatureIdx,
+                dstObjectOffset,
+                bitsPerDocumentFeature,
+                MakeQuantizedFeaturePart(slice(TConstArrayRef<ui32>(values)), bitsPerDocumentFeature)
+            );
+        }
+
+        if (const auto timestamp = objectsData.GetTimestamp()) {
+            visitor->AddTimestampPart(dstObjectOffset, TUnalignedArrayBuf<ui64>(slice(*timestamp)));
+        }
+
+        const auto& targetData = data.RawTargetData;
+        switch (targetData.GetTargetType()) {
+            case ERawTargetType::Integer:
+            case ERawTargetType::Float:
+                {
+                    TVector<TVector<float>> target(targetData.GetTargetDimension());
+                    TVector<TArrayRef<float>> targetRefs;
+                    for (auto& targetPart : target) {
+                        targetPart.yresize(objectCount);
+                        targetRefs.push_back(targetPart);
+                    }
+                    targetData.GetNumericTarget(targetRefs);
+                    for (auto targetIdx : xrange(target.size())) {
+                        visitor->AddTargetPart(
+                            targetIdx,
+                            dstObjectOffset,
+                            TUnalignedArrayBuf<float>(slice(TConstArrayRef<float>(target[targetIdx])))
+                        );
+                    }
+                }
+                break;
+            case ERawTargetType::String:
+                {
+                    TVector<TConstArrayRef<TString>> target;
+                    targetData.GetStringTargetRef(&target);
+                    for (auto targetIdx : xrange(target.size())) {
+                        const auto targetPart = slice(target[targetIdx]);
+                        visitor->AddTargetPart(
+                            targetIdx,
+                            dstObjectOffset,
+                            TMaybeOwningConstArrayHolder<TString>::CreateOwning(
+                                TVector<TString>(targetPart.begin(), targetPart.end())
+                            )
+                        );
+                    }
+                }
+                break;
+            case ERawTargetType::None:
+                break;
+        }
+
+        if (const auto baseline = targetData.GetBaseline()) {
+            for (auto baselineIdx : xrange(baseline->size())) {
+                visitor->AddBaselinePart(
+                    dstObjectOffset,
+                    baselineIdx,
+                    TUnalignedArrayBuf<float>(slice((*baseline)[baselineIdx]))
+                );
+            }
+        }
+
+        // weights can be trivial (not stored) in quantized data even if they are present in meta info
+        auto getWeightsPart = [=] (const TWeights<float>& weights) {
+            TVector<float> weightsPart;
+            weightsPart.reserve(objectCount - objectOffset);
+            for (auto objectIdx : xrange(objectOffset, objectCount)) {
+                weightsPart.push_back(weights[objectIdx]);
+            }
+            return weightsPart;
+        };
+        if (data.MetaInfo.HasWeights) {
+            const auto weightsPart = getWeightsPart(targetData.GetWeights());
+            visitor->AddWeightPart(dstObjectOffset, TUnalignedArrayBuf<float>(TConstArrayRef<float>(weightsPart)));
+        }
+        if (data.MetaInfo.HasGroupWeight) {
+            const auto groupWeightsPart = getWeightsPart(targetData.GetGroupWeights());
+            visitor->AddGroupWeightPart(
+                dstObjectOffset,
+                TUnalignedArrayBuf<float>(TConstArrayRef<float>(groupWeightsPart))
+            );
+        }
+    }
+
+
+    TQuantizedDataProviderPtr AppendToQuantizedData(
+        TQuantizedDataProviderPtr quantizedData,
+        ui32 droppedObjectCount,
+        TRawDataProviderPtr newRawData,
+        const TQuantizationOptions& quantizationOptions,
+        TRestorableFastRng64* rand,
+        NPar::ILocalExecutor* localExecutor
+    ) {
+        const auto& metaInfo = quantizedData->MetaInfo;
+        CB_ENSURE(
+            droppedObjectCount <= quantizedData->GetObjectCount(),
+            "Cannot drop " << droppedObjectCount << " objects from data with "
+            << quantizedData->GetObjectCount() << " objects"
+        );
+        const ui32 retainedObjectCount = quantizedData->GetObjectCount() - droppedObjectCount;
+        for (const auto* dataMetaInfo : {&metaInfo, &newRawData->MetaInfo}) {
+            CB_ENSURE(
+                !dataMetaInfo->HasGroupId && !dataMetaInfo->HasPairs,
+                "Appending to quantized data with groups or pairs is not supported"
+            );
+        }
+        CB_ENSURE(
+            (newRawData->MetaInfo.TargetType == metaInfo.TargetType)
+            && (newRawData->MetaInfo.TargetCount == metaInfo.TargetCount)
+            && (newRawData->MetaInfo.BaselineCount == metaInfo.BaselineCount)
+            && (newRawData->MetaInfo.HasWeights == metaInfo.HasWeights)
+            && (newRawData->MetaInfo.HasGroupWeight == metaInfo.HasGroupWeight)
+            && (newRawData->MetaInfo.HasTimestamp == metaInfo.HasTimestamp),
+            "New data columns are incompatible with quantized data columns"
+        );
+
+        auto quantizedFeaturesInfo = quantizedData->ObjectsData->GetQuantizedFeaturesInfo();
+        CheckCompatibleForQuantize(
+            *newRawData->MetaInfo.FeaturesLayout,
+            *quantizedFeaturesInfo->GetFeaturesLayout(),
+            "new data"
+        );
+
+        const auto newQuantizedData = Quantize(
+            quantizationOptions,
+            std::move(newRawData),
+            quantizedFeaturesInfo,
+            rand,
+            localExecutor
+        );
+
+        // class labels are set in metaInfo, raw target values are passed to visitor
+        const auto poolQuantizationSchema = GetPoolQuantizationSchema(
+            *quantizedFeaturesInfo,
+            /*classLabels*/ {}
+        );
+
+        TDataMetaInfo resultMetaInfo = metaInfo;
+        resultMetaInfo.ObjectCount = retainedObjectCount + newQuantizedData->GetObjectCount();
+        resultMetaInfo.HasSampleId = false; // not supported by the quantized features visitor
+
+        TDataProviderClosure dataProviderClosure(
+            EDatasetVisitorType::QuantizedFeatures,
+            TDataProviderBuilderOptions(),
+            localExecutor
+        );
+        auto* visitor = dataProviderClosure.GetVisitor<IQuantizedFeaturesDataVisitor>();
+        visitor->Start(
+            resultMetaInfo,
+            SafeIntegerCast<ui32>(resultMetaInfo.ObjectCount),
+            quantizedData->ObjectsData->GetOrder(),
+            /*resourceHolders*/ {},
+            poolQuantizationSchema,
+            /*wholeColumns*/ false
+        );
+        AddQuantizedDataPart(
+            *quantizedData,
+            droppedObjectCount,
+            /*dstObjectOffset*/ 0,
+            poolQuantizationSchema,
+            visitor,
+            localExecutor
+        );
+        AddQuantizedDataPart(
+            *newQuantizedData,
+            /*objectOffset*/ 0,
+            /*dstObjectOffset*/ retainedObjectCount,
+            poolQuantizationSchema,
+            visitor,
+            localExecutor
+        );
+        visitor->Finish();
+
+        return dataProviderClosure.GetResult()->CastMoveTo<TQuantizedObjectsDataProvider>();
+    }
 }
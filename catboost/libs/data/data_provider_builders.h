@@ -2,10 +2,12 @@
 
 #include "data_provider.h"
 #include "loader.h"
+#include "quantization.h"
 #include "quantized_features_info.h"
 #include "visitor.h"
 
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/helpers/sparse_array.h>
 
 #include <library/cpp/threading/local_executor/local_executor.h>
@@ -139,4 +141,23 @@ namespace NCB {
         loader(dataProviderClosure.GetVisitor<IVisitor>());
         return dataProviderClosure.GetResult();
     }
+
+
+    /*
+     * Sliding window update of quantized data: the first droppedObjectCount objects of quantizedData are
+     *  dropped and newRawData objects are appended after the remaining ones.
+     * newRawData is quantized with borders and perfect hashes from quantizedData's quantizedFeaturesInfo
+     *  (perfect hashes are extended by new categorical values), features of the retained objects are copied
+     *  as already quantized bins, so they are neither reloaded nor requantized.
+     * The result is built by the quantized features builder (the same way as quantized pools are loaded).
+     * Data with groups or pairs is not supported.
+     */
+    TQuantizedDataProviderPtr AppendToQuantizedData(
+        TQuantizedDataProviderPtr quantizedData,
+        ui32 droppedObjectCount,
+        TRawDataProviderPtr newRawData,
+        const TQuantizationOptions& quantizationOptions,
+        TRestorableFastRng64* rand,
+        NPar::ILocalExecutor* localExecutor
+    );
 }
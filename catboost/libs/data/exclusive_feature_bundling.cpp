@@ -14,7 +14,6 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/cast.h>
-#include <util/generic/hash_set.h>
 #include <util/generic/maybe.h>
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
@@ -30,18 +29,91 @@ namespace NCB {
     // [flatFeatureIdx] -> (blockIdx, nonZero Mask)
     using TFeaturesNonDefaultMasks = TVector<TVector<std::pair<ui32, ui64>>>;
 
+    /* Objects used by the bundle are stored as sorted (blockIdx, nonZero Mask) pairs while there are few of them
+     * and as a dense array of block masks otherwise, so memory and time spent on a bundle are proportional
+     * to the number of non default values in it and not to the number of objects.
+     */
     struct TExclusiveFeatureBundleForMerging {
-        ui32 IntersectionCount;
-        ui64 NonDefaultCount;
+        ui32 IntersectionCount = 0;
+        ui64 NonDefaultCount = 0;
+        TVector<std::pair<ui32, ui64>> SparseUsedObjects; // used while UsedObjects is empty
         TVector<ui64> UsedObjects; // block non default masks
 
     public:
-        TExclusiveFeatureBundleForMerging(ui32 objectCount, NPar::ILocalExecutor* localExecutor)
-            : IntersectionCount(0)
-            , NonDefaultCount(0)
-        {
-            UsedObjects.yresize(CeilDiv((size_t)objectCount, CHAR_BIT * sizeof(ui64)));
-            ParallelFill<ui64>(0, /*blockSize*/ Nothing(), localExecutor, UsedObjects);
+        bool IsDense() const {
+            return !UsedObjects.empty();
+        }
+
+        void AddUsedObjects(TConstArrayRef<std::pair<ui32, ui64>> featureNonDefaultMasks, ui32 blockCount) {
+            if (IsDense()) {
+                for (auto [blockIdx, mask] : featureNonDefaultMasks) {
+                    UsedObjects[blockIdx] |= mask;
+                }
+                return;
+            }
+
+            TVector<std::pair<ui32, ui64>> merged;
+            merged.reserve(SparseUsedObjects.size() + featureNonDefaultMasks.size());
+            auto bundleIt = SparseUsedObjects.begin();
+            for (auto [blockIdx, mask] : featureNonDefaultMasks) {
+                for (; (bundleIt != SparseUsedObjects.end()) && (bundleIt->first < blockIdx); ++bundleIt) {
+                    merged.push_back(*bundleIt);
+                }
+                if ((bundleIt != SparseUsedObjects.end()) && (bundleIt->first == blockIdx)) {
+                    merged.emplace_back(blockIdx, bundleIt->second | mask);
+                    ++bundleIt;
+                } else {
+                    merged.emplace_back(blockIdx, mask);
+                }
+            }
+            merged.insert(merged.end(), bundleIt, SparseUsedObjects.end());
+
+            // 16 is an empiric constant: dense masks are faster to update and intersect
+            if (merged.size() * 16 > blockCount) {
+                UsedObjects.resize(blockCount, 0);
+                for (auto [blockIdx, mask] : merged) {
+                    UsedObjects[blockIdx] = mask;
+                }
+                SparseUsedObjects = TVector<std::pair<ui32, ui64>>();
+            } else {
+                SparseUsedObjects = std::move(merged);
+            }
+        }
+
+        ui32 CalcIntersectionCount(
+            TConstArrayRef<std::pair<ui32, ui64>> featureNonDefaultMasks,
+            ui32 maxIntersectionCount
+        ) const {
+            ui32 intersectionCount = 0;
+            if (IsDense()) {
+                for (auto [blockIdx, mask] : featureNonDefaultMasks) {
+                    intersectionCount += (ui32)PopCount(mask & UsedObjects[blockIdx]);
+                    if (intersectionCount > maxIntersectionCount) {
+                        return intersectionCount;
+                    }
+                }
+                return intersectionCount;
+            }
+
+            auto bundleIt = SparseUsedObjects.begin();
+            for (auto [blockIdx, mask] : featureNonDefaultMasks) {
+                bundleIt = LowerBoundBy(
+                    bundleIt,
+                    SparseUsedObjects.end(),
+                    blockIdx,
+                    [] (const std::pair<ui32, ui64>& blockMask) { return blockMask.first; }
+                );
+                if (bundleIt == SparseUsedObjects.end()) {
+                    break;
+                }
+                if (bundleIt->first == blockIdx) {
+                    intersectionCount += (ui32)PopCount(mask & bundleIt->second);
+                    if (intersectionCount > maxIntersectionCount) {
+                        return intersectionCount;
+                    }
+                }
+            }
+            return intersectionCount;
         }
     };
 
@@ -53,6 +125,7 @@ namespace NCB {
         ui32 featureNonDefaultCount,
         ui32 binCountInBundleNeeded,
         ui32 intersectionCount,
+        ui32 blockCount,
         TExclusiveFeaturesBundle* bundle,
         TExclusiveFeatureBundleForMerging* bundleForMerging
     ) {
@@ -69,27 +142,7 @@ namespace NCB {
 
         bundleForMerging->NonDefaultCount += featureNonDefaultCount;
         bundleForMerging->IntersectionCount += intersectionCount;
-
-        TArrayRef<ui64> bundleMasks = bundleForMerging->UsedObjects;
-
-        for (auto [blockIdx, mask] : featureNonDefaultMasks) {
-            bundleMasks[blockIdx] = bundleMasks[blockIdx] | mask;
-        }
-    }
-
-    static ui32 CalcIntersectionCount(
-        TConstArrayRef<ui64> usedObjectsInBundle,
-        TConstArrayRef<std::pair<ui32, ui64>> featureNonDefaultMasks,
-        ui32 maxIntersectionCount
-    ) {
-        ui32 intersectionCount = 0;
-        for (auto [blockIdx, mask] : featureNonDefaultMasks) {
-            intersectionCount += (ui32)PopCount(mask & usedObjectsInBundle[blockIdx]);
-            if (intersectionCount > maxIntersectionCount) {
-                return intersectionCount;
-            }
-        }
-        return intersectionCount;
+        bundleForMerging->AddUsedObjects(featureNonDefaultMasks, blockCount);
     }
 
     static TVector<TExclusiveFeaturesBundle> CreateExclusiveFeatureBundlesImpl(
@@ -98,12 +151,12 @@ namespace NCB {
         const TFeaturesNonDefaultMasks& featuresNonDefaultMasks,
         TConstArrayRef<ui32> featuresNonDefaultCounts,
         TConstArrayRef<ui32> flatFeatureIndicesToCalc,
-        const TExclusiveFeaturesBundlingOptions& options,
-        NPar::ILocalExecutor* localExecutor
+        const TExclusiveFeaturesBundlingOptions& options
     ) {
         const auto& featuresLayout = *quantizedFeaturesInfo.GetFeaturesLayout();
 
         const ui32 maxObjectIntersection = ui32(options.MaxConflictFraction * float(objectCount));
+        const ui32 blockCount = CeilDiv(objectCount, ui32(CHAR_BIT * sizeof(ui64)));
 
         // shortcut for easier sequential one hot bundling
         TVector<TMaybe<ui32>> flatFeatureIdxToBundleIdx(featuresLayout.GetExternalFeatureCount());
@@ -111,11 +164,21 @@ namespace NCB {
         TVector<TExclusiveFeaturesBundle> bundles;
         TVector<TExclusiveFeatureBundleForMerging> bundlesForMerging;
 
+        /* bundles that still can accept features, candidates are chosen only from them so the time spent
+         * on each feature is bounded by options.MaxBundleCandidates and does not depend on the number of bundles
+         */
+        TVector<ui32> openBundles;
+
+        auto isOpenBundle = [&] (ui32 bundleIdx) -> bool {
+            const auto& bundleForMerging = bundlesForMerging[bundleIdx];
+            return (bundles[bundleIdx].GetUsedByPartsBinCount() + 1 < options.MaxBuckets)
+                && (bundleForMerging.NonDefaultCount
+                    < (objectCount + maxObjectIntersection - bundleForMerging.IntersectionCount));
+        };
+
         TFastRng64 rng(0);
 
         for (auto flatFeatureIdx : flatFeatureIndicesToCalc) {
-            const auto featureMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo()[flatFeatureIdx];
-
             const auto featureType = featuresLayout.GetExternalFeatureType(flatFeatureIdx);
             const auto perTypeFeatureIdx = featuresLayout.GetInternalFeatureIdx(flatFeatureIdx);
 
@@ -164,8 +227,7 @@ namespace NCB {
                 auto maxRemaininingIntersectionCount
                     = maxObjectIntersection - bundleForMerging.IntersectionCount;
 
-                ui32 intersectionCount = CalcIntersectionCount(
-                    bundleForMerging.UsedObjects,
+                ui32 intersectionCount = bundleForMerging.CalcIntersectionCount(
                     featureNonDefaultMasks,
                     maxRemaininingIntersectionCount);
 
@@ -177,6 +239,7 @@ namespace NCB {
                         featureNonDefaultCount,
                         binCountInBundleNeeded,
                         intersectionCount,
+                        blockCount,
                         &bundle,
                         &bundleForMerging
                     );
@@ -187,44 +250,70 @@ namespace NCB {
             };
 
 
-            THashSet<ui32> checkedBundlesForNeighbors;
-
-            // try neighboring bundles first
-            if ((flatFeatureIdx > 0) && flatFeatureIdxToBundleIdx[flatFeatureIdx - 1].Defined()) {
-                auto bundleIdx = *(flatFeatureIdxToBundleIdx[flatFeatureIdx - 1]);
-                if (isCandidateBundle(bundleIdx) && tryAddToBundle(bundleIdx)) {
-                    continue;
+            // at most 2 neighbors
+            ui32 checkedBundlesForNeighbors[2];
+            size_t checkedBundlesForNeighborsCount = 0;
+            auto isCheckedBundleForNeighbor = [&] (ui32 bundleIdx) -> bool {
+                return Find(
+                    checkedBundlesForNeighbors,
+                    checkedBundlesForNeighbors + checkedBundlesForNeighborsCount,
+                    bundleIdx
+                ) != checkedBundlesForNeighbors + checkedBundlesForNeighborsCount;
+            };
+            auto tryAddToNeighborBundle = [&] (ui32 neighborFlatFeatureIdx) -> bool {
+                if (!flatFeatureIdxToBundleIdx[neighborFlatFeatureIdx].Defined()) {
+                    return false;
                 }
-                checkedBundlesForNeighbors.insert(bundleIdx);
-            }
-            if (((flatFeatureIdx + 1) < flatFeatureIdxToBundleIdx.size()) &&
-                flatFeatureIdxToBundleIdx[flatFeatureIdx + 1].Defined())
-            {
-                auto bundleIdx = *(flatFeatureIdxToBundleIdx[flatFeatureIdx + 1]);
-                if (checkedBundlesForNeighbors.contains(bundleIdx)) {
-                    continue;
+                auto bundleIdx = *(flatFeatureIdxToBundleIdx[neighborFlatFeatureIdx]);
+                if (isCheckedBundleForNeighbor(bundleIdx)) {
+                    return false;
                 }
                 if (isCandidateBundle(bundleIdx) && tryAddToBundle(bundleIdx)) {
-                    continue;
+                    return true;
                 }
-                checkedBundlesForNeighbors.insert(bundleIdx);
+                checkedBundlesForNeighbors[checkedBundlesForNeighborsCount++] = bundleIdx;
+                return false;
+            };
+
+            // try neighboring bundles first
+            if ((flatFeatureIdx > 0) && tryAddToNeighborBundle(flatFeatureIdx - 1)) {
+                continue;
+            }
+            if (((flatFeatureIdx + 1) < flatFeatureIdxToBundleIdx.size())
+                && tryAddToNeighborBundle(flatFeatureIdx + 1))
+            {
+                continue;
             }
 
             TVector<ui32> bundlesToCheck;
 
-            for (auto bundleIdx : xrange(bundles.size())) {
-                if (!checkedBundlesForNeighbors.contains(bundleIdx) && isCandidateBundle(bundleIdx)) {
-                    bundlesToCheck.push_back(bundleIdx);
-                }
-            }
-
-            const size_t maxBundlesToCheck = options.MaxBundleCandidates - checkedBundlesForNeighbors.size();
+            const size_t maxBundlesToCheck
+                = options.MaxBundleCandidates - Min<size_t>(options.MaxBundleCandidates, checkedBundlesForNeighborsCount);
 
-            if (bundlesToCheck.size() > maxBundlesToCheck) {
-                for (auto i : xrange(maxBundlesToCheck)) {
-                    std::swap(bundlesToCheck[i], bundlesToCheck[rng.Uniform(i, bundlesToCheck.size())]);
+            if (openBundles.size() <= maxBundlesToCheck) {
+                EraseIf(openBundles, [&] (ui32 bundleIdx) { return !isOpenBundle(bundleIdx); });
+                for (auto bundleIdx : openBundles) {
+                    if (!isCheckedBundleForNeighbor(bundleIdx) && isCandidateBundle(bundleIdx)) {
+                        bundlesToCheck.push_back(bundleIdx);
+                    }
+                }
+            } else {
+                // random sample of open bundles, closed bundles found in the sample are removed
+                size_t sampleSize = maxBundlesToCheck;
+                for (size_t i = 0; i < sampleSize; ) {
+                    std::swap(openBundles[i], openBundles[rng.Uniform(i, openBundles.size())]);
+                    const ui32 bundleIdx = openBundles[i];
+                    if (!isOpenBundle(bundleIdx)) {
+                        openBundles[i] = openBundles.back();
+                        openBundles.pop_back();
+                        sampleSize = Min(sampleSize, openBundles.size());
+                        continue;
+                    }
+                    if (!isCheckedBundleForNeighbor(bundleIdx) && isCandidateBundle(bundleIdx)) {
+                        bundlesToCheck.push_back(bundleIdx);
+                    }
+                    ++i;
                 }
-                bundlesToCheck.resize(maxBundlesToCheck);
             }
 
             for (auto bundleIdx : bundlesToCheck) {
@@ -237,10 +326,11 @@ namespace NCB {
             if (!flatFeatureIdxToBundleIdx[flatFeatureIdx]) {
                 // no bundle found - add new
 
-                flatFeatureIdxToBundleIdx[flatFeatureIdx] = SafeIntegerCast<ui32>(bundles.size());
+                const ui32 bundleIdx = SafeIntegerCast<ui32>(bundles.size());
+                flatFeatureIdxToBundleIdx[flatFeatureIdx] = bundleIdx;
 
                 TExclusiveFeaturesBundle bundle;
-                TExclusiveFeatureBundleForMerging bundleForMerging(objectCount, localExecutor);
+                TExclusiveFeatureBundleForMerging bundleForMerging;
 
                 AddFeatureToBundle(
                     quantizedFeaturesInfo,
@@ -249,15 +339,22 @@ namespace NCB {
                     featureNonDefaultCount,
                     binCountInBundleNeeded,
                     /*intersectionCount*/ 0,
+                    blockCount,
                     &bundle,
                     &bundleForMerging
                 );
 
                 bundles.push_back(std::move(bundle));
                 bundlesForMerging.push_back(std::move(bundleForMerging));
+                if (isOpenBundle(bundleIdx)) {
+                    openBundles.push_back(bundleIdx);
+                }
             }
         }
 
+        // masks are not needed anymore, free memory before the selection of bundles for the result
+        bundlesForMerging = TVector<TExclusiveFeatureBundleForMerging>();
+
         TVector<ui32> bundlesForResult;
 
         // less than sizeof(TBinaryFeaturesPack) * CHAR_BIT binary features
@@ -426,8 +523,7 @@ namespace NCB {
                         featuresNonDefaultMasks,
                         featuresNonDefaultCount,
                         *featureIndices,
-                        options,
-                        localExecutor
+                        options
                     );
                 }
             );
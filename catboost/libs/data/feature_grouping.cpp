@@ -20,6 +20,8 @@ namespace NCB {
             "Currently it is possible to group only 2 or 4 features");
         TVector<TFeaturesGroup> groups;
         TFeaturesGroup group;
+        TFeaturesGroup halfByteGroup;
+        halfByteGroup.PartBitCount = CHAR_BIT / 2;
         featuresLayout.IterateOverAvailableFeatures<EFeatureType::Float>(
             [&] (const TFloatFeatureIdx& floatFeatureIdx) {
                 /* Currently grouped only float features with number of bins up to 256 */
@@ -33,6 +35,18 @@ namespace NCB {
                 if (isInExclusiveBundle || isPackedBinary)
                     return;
 
+                if (options.GroupSmallFeaturesInHalfBytes && (bucketCount <= MaxHalfByteGroupPartBucketCount)) {
+                    halfByteGroup.Add(TFeaturesGroupPart{EFeatureType::Float, *floatFeatureIdx, bucketCount});
+
+                    if (halfByteGroup.Parts.size() == 2 * options.MaxFeaturesPerBundle) {
+                        groups.emplace_back(halfByteGroup);
+                        halfByteGroup.Parts.clear();
+                        halfByteGroup.BucketOffsets.clear();
+                        halfByteGroup.TotalBucketCount = 0;
+                    }
+                    return;
+                }
+
                 group.Add(TFeaturesGroupPart{EFeatureType::Float, *floatFeatureIdx, bucketCount});
 
                 if (group.Parts.size() == options.MaxFeaturesPerBundle) {
@@ -48,8 +62,18 @@ namespace NCB {
         if (!group.Parts.empty()) {
             groups.emplace_back(group);
         }
+
+        // unused half bytes are allowed, only groups of 1 feature are unreasonable here
+        if (halfByteGroup.Parts.size() == 1) {
+            halfByteGroup.PopLastFeature();
+        }
+        if (!halfByteGroup.Parts.empty()) {
+            groups.emplace_back(halfByteGroup);
+        }
+
         for (auto groupIdx : xrange(groups.size())) {
-            CATBOOST_DEBUG_LOG << "Group #" << groupIdx << ":";
+            CATBOOST_DEBUG_LOG << "Group #" << groupIdx
+                << " (" << groups[groupIdx].PartBitCount << " bits per feature):";
             for (auto& part : groups[groupIdx].Parts) {
                 CATBOOST_DEBUG_LOG << " " << part.FeatureIdx;
             }
@@ -35,20 +35,31 @@ namespace NCB {
         SAVELOAD(FeatureType, FeatureIdx, BucketCount);
     };
 
+    // features with at most this number of buckets are stored in half bytes
+    constexpr ui32 MaxHalfByteGroupPartBucketCount = 16;
+
     struct TFeaturesGroup {
         TVector<TFeaturesGroupPart> Parts;
         TVector<ui32> BucketOffsets;
         ui32 TotalBucketCount = 0;
+        ui32 PartBitCount = CHAR_BIT; // CHAR_BIT or CHAR_BIT / 2
 
     public:
         inline bool operator==(const TFeaturesGroup& rhs) const {
             return (Parts == rhs.Parts)
                 && (BucketOffsets == rhs.BucketOffsets)
-                && (TotalBucketCount == rhs.TotalBucketCount);
+                && (TotalBucketCount == rhs.TotalBucketCount)
+                && (PartBitCount == rhs.PartBitCount);
         }
 
+        // 1, 2 or 4, unused high bits are possible in groups of half bytes
         inline ui32 GetSizeInBytes() const {
-            return Parts.size();
+            const ui32 bitCount = Parts.size() * PartBitCount;
+            ui32 sizeInBytes = 1;
+            while (sizeInBytes * CHAR_BIT < bitCount) {
+                sizeInBytes *= 2;
+            }
+            return sizeInBytes;
         }
 
         inline void Add(const TFeaturesGroupPart& part) {
@@ -63,7 +74,7 @@ namespace NCB {
             Parts.pop_back();
         }
 
-        SAVELOAD(Parts, BucketOffsets, TotalBucketCount);
+        SAVELOAD(Parts, BucketOffsets, TotalBucketCount, PartBitCount);
     };
 
     struct TFeaturesGroupIndex {
@@ -71,12 +82,17 @@ namespace NCB {
         ui32 InGroupIdx;
     };
 
-    inline ui8 GetPartValueFromGroup(ui32 groupValue, size_t partIdx) {
-        return static_cast<ui8>(groupValue >> (partIdx * CHAR_BIT));
+    inline ui8 GetPartValueFromGroup(ui32 groupValue, size_t partIdx, ui32 partBitCount = CHAR_BIT) {
+        return static_cast<ui8>((groupValue >> (partIdx * partBitCount)) & ((ui32(1) << partBitCount) - 1));
     }
 
     struct TFeaturesGroupingOptions {
         ui32 MaxFeaturesPerBundle = 4;
+
+        /* Put features with at most MaxHalfByteGroupPartBucketCount buckets to separate groups of half bytes,
+         * such groups contain up to 2 * MaxFeaturesPerBundle features
+         */
+        bool GroupSmallFeaturesInHalfBytes = true;
     };
 
     TVector<TFeaturesGroup> CreateFeatureGroups(
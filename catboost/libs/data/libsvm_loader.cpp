@@ -65,7 +65,12 @@ namespace NCB {
     TLibSvmDataLoader::TLibSvmDataLoader(TDatasetLoaderPullArgs&& args)
         : TLibSvmDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(
+                    args.PoolPath,
+                    args.CommonArgs.PoolFormat,
+                    /*keepLineOrder*/ true,
+                    args.CommonArgs.ShardsShuffleSeed
+                ),
                 std::move(args.CommonArgs)
             }
         )
@@ -5,6 +5,7 @@
 #include "data_provider_builders.h"
 #include "proceed_pool_in_blocks.h"
 #include "quantization.h"
+#include "sparse_columns.h"
 #include "util.h"
 #include "visitor.h"
 
@@ -22,10 +23,15 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
 
+#include <atomic>
+#include <functional>
+
 using namespace NCB;
 
 namespace {
@@ -59,18 +65,26 @@ namespace {
             "Found unknown features, which are not supported in block quantization");
     }
 
+    /* called when dataset meta info is known
+     * useInputBorders is false when features layout is not final yet (for datasets with unknown number of
+     * sparse features), borders from the input file can be loaded only for the final features layout
+     */
+    using TPrepareQuantizationParametersFunc = std::function<void(
+        const TDataMetaInfo& metaInfo,
+        bool useInputBorders,
+        TQuantizationOptions* quantizationOptions,
+        TQuantizedFeaturesInfoPtr* quantizedFeaturesInfo)>;
+
     class TRawObjectsOrderQuantizationFirstPassVisitor final : public IRawObjectsOrderDataVisitor {
     public:
         TRawObjectsOrderQuantizationFirstPassVisitor(
-            NJson::TJsonValue plainJsonParams,
-            TMaybe<TString> inputBordersPath,
+            TPrepareQuantizationParametersFunc prepareQuantizationParameters,
             TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
             THolder<IDataProviderBuilder> builder,
             TRestorableFastRng64* rand,
             NPar::ILocalExecutor* localExecutor)
             : LocalExecutor(localExecutor)
-            , PlainJsonParams(std::move(plainJsonParams))
-            , InputBordersPath(std::move(inputBordersPath))
+            , PrepareQuantizationParameters(std::move(prepareQuantizationParameters))
             , QuantizedFeaturesInfo(std::move(quantizedFeaturesInfo))
             , DataBuilder(std::move(builder))
             , DataVisitor(dynamic_cast<NCB::IRawObjectsOrderDataVisitor*>(DataBuilder.Get()))
@@ -104,17 +118,34 @@ namespace {
             ObjectCount = objectCount;
             CB_ENSURE(ObjectCount > 0, "pool is empty");
 
-            PrepareQuantizationParameters(
-                PlainJsonParams,
-                metaInfo,
-                InputBordersPath,
-                &QuantizationOptions,
-                &QuantizedFeaturesInfo);
+            HaveUnknownNumberOfSparseFeatures = haveUnknownNumberOfSparseFeatures;
+            ObservedFloatFeatureCount = metaInfo.FeaturesLayout->GetFloatFeatureCount();
+
+            /* features layout will be known only after the whole dataset is read,
+             * until then quantization parameters are used only for sample selection
+             */
+            DelayQuantizedFeaturesInfoPreparation = haveUnknownNumberOfSparseFeatures && !QuantizedFeaturesInfo;
+
+            TQuantizedFeaturesInfoPtr quantizedFeaturesInfoForSample;
+            if (DelayQuantizedFeaturesInfoPreparation) {
+                PrepareQuantizationParameters(
+                    metaInfo,
+                    /*useInputBorders*/ false,
+                    &QuantizationOptions,
+                    &quantizedFeaturesInfoForSample);
+            } else {
+                PrepareQuantizationParameters(
+                    metaInfo,
+                    /*useInputBorders*/ true,
+                    &QuantizationOptions,
+                    &QuantizedFeaturesInfo);
+                quantizedFeaturesInfoForSample = QuantizedFeaturesInfo;
+            }
 
             SampleSubset = MakeIncrementalIndexing(
                 GetArraySubsetForBuildBorders(
                     ObjectCount,
-                    QuantizedFeaturesInfo->GetFloatFeatureBinarization(Max<ui32>()).BorderSelectionType,
+                    quantizedFeaturesInfoForSample->GetFloatFeatureBinarization(Max<ui32>()).BorderSelectionType,
                     objectsOrder == EObjectsOrder::RandomShuffled,
                     QuantizationOptions.MaxSubsetSizeForBuildBordersAlgorithms,
                     Rand),
@@ -219,6 +250,11 @@ namespace {
             ui32 localObjectIdx,
             TConstPolymorphicValuesSparseArray<float, ui32> features) override {
 
+            if (HaveUnknownNumberOfSparseFeatures) {
+                // features that are present only in skipped objects must be in the result layout as well
+                UpdateObservedFloatFeatureCount(features.GetSize());
+            }
+
             const ui32 sampleIdx = GetSampleIdx(localObjectIdx);
             if (sampleIdx == NotSet) {
                 return;
@@ -418,6 +454,22 @@ namespace {
                 CB_ENSURE_INTERNAL(rawDataProvider, "Failed to cast data provider to TRawDataProviderPtr");
             }
 
+            const ui32 sampleFloatFeatureCount = rawDataProvider->MetaInfo.FeaturesLayout->GetFloatFeatureCount();
+            if (DelayQuantizedFeaturesInfoPreparation) {
+                TDataMetaInfo metaInfo = rawDataProvider->MetaInfo;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(*metaInfo.FeaturesLayout);
+                for (auto floatFeatureIdx : xrange(sampleFloatFeatureCount, ObservedFloatFeatureCount.load())) {
+                    Y_UNUSED(floatFeatureIdx);
+                    metaInfo.FeaturesLayout->AddFeature(
+                        TFeatureMetaInfo(EFeatureType::Float, /*name*/ "", /*isSparse*/ true));
+                }
+                PrepareQuantizationParameters(
+                    metaInfo,
+                    /*useInputBorders*/ true,
+                    &QuantizationOptions,
+                    &QuantizedFeaturesInfo);
+            }
+
             CalcBordersAndNanMode(
                 QuantizationOptions,
                 rawDataProvider,
@@ -425,6 +477,17 @@ namespace {
                 Rand,
                 LocalExecutor);
 
+            // features without borders that are absent in the sample are constant in it
+            if (DelayQuantizedFeaturesInfoPreparation) {
+                auto& featuresLayout = *QuantizedFeaturesInfo->GetFeaturesLayout();
+                for (auto floatFeatureIdx : xrange(sampleFloatFeatureCount, featuresLayout.GetFloatFeatureCount())) {
+                    if (!QuantizedFeaturesInfo->HasBorders(TFloatFeatureIdx(floatFeatureIdx))) {
+                        featuresLayout.IgnoreExternalFeature(
+                            featuresLayout.GetExternalFeatureIdx(floatFeatureIdx, EFeatureType::Float));
+                    }
+                }
+            }
+
             // TODO(vetaleha): build CatFeaturesPerfectHash, TextProcessingOptions and TextDigitizers
 
             rawDataProvider->MetaInfo.FeaturesLayout = QuantizedFeaturesInfo->GetFeaturesLayout();
@@ -437,14 +500,26 @@ namespace {
                 std::move(UnsampledData)};
         }
 
+    private:
+        void UpdateObservedFloatFeatureCount(ui32 floatFeatureCount) {
+            ui32 observedCount = ObservedFloatFeatureCount.load();
+            while ((observedCount < floatFeatureCount)
+                && !ObservedFloatFeatureCount.compare_exchange_weak(observedCount, floatFeatureCount))
+            {}
+        }
+
     private:
         bool IsStarted = false;
         bool ResultsTaken = false;
 
         NPar::ILocalExecutor* LocalExecutor;
 
-        NJson::TJsonValue PlainJsonParams;
-        TMaybe<TString> InputBordersPath;
+        TPrepareQuantizationParametersFunc PrepareQuantizationParameters;
+        bool HaveUnknownNumberOfSparseFeatures = false;
+        bool DelayQuantizedFeaturesInfoPreparation = false;
+
+        // max float features count in all objects, not only in the sample, updated from parsing threads
+        std::atomic<ui32> ObservedFloatFeatureCount{0};
         TQuantizationOptions QuantizationOptions;
         TQuantizedFeaturesInfoPtr QuantizedFeaturesInfo;
 
@@ -471,14 +546,50 @@ namespace {
         TUnsampledData UnsampledData;
     };
 
-    template <class T, class ValuesHolder>
-    TMaybeOwningConstArrayHolder<ui8> ExtractValuesForQuantizedVisitor(
-        const ValuesHolder& srcValues,
-        NPar::ILocalExecutor* localExecutor) {
-
-        TMaybeOwningConstArrayHolder<T> values =
-            TMaybeOwningConstArrayHolder<T>::CreateOwning(srcValues.template ExtractValues<T>(localExecutor));
-        return TMaybeOwningConstArrayHolder<ui8>::CreateOwningReinterpretCast(values);
+    /* srcFeature == nullptr means that the feature is absent in the block (all values are default)
+     * only non-default values of sparse features are quantized
+     */
+    template <class TBin>
+    TMaybeOwningConstArrayHolder<ui8> QuantizeFloatFeatureForQuantizedVisitor(
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        TFloatFeatureIdx floatFeatureIdx,
+        ui32 objectCount,
+        const TFloatValuesHolder* srcFeature) {
+
+        const ui32 flatFeatureIdx = quantizedFeaturesInfo.GetFeaturesLayout()->GetExternalFeatureIdx(
+            *floatFeatureIdx,
+            EFeatureType::Float);
+        const ENanMode nanMode = quantizedFeaturesInfo.GetNanMode(floatFeatureIdx);
+        const bool allowNans = (nanMode != ENanMode::Forbidden)
+            || quantizedFeaturesInfo.GetFloatFeaturesAllowNansInTestOnly();
+        TConstArrayRef<float> borders = quantizedFeaturesInfo.GetBorders(floatFeatureIdx);
+
+        auto quantize = [=] (float srcValue) {
+            return Quantize<TBin>(flatFeatureIdx, allowNans, nanMode, borders, srcValue);
+        };
+
+        TVector<TBin> dstValues;
+        if (!srcFeature) {
+            dstValues.resize(objectCount, quantize(0.0f));
+        } else if (const auto* sparseFeature = dynamic_cast<const TFloatSparseValuesHolder*>(srcFeature)) {
+            const auto& srcData = sparseFeature->GetData();
+            dstValues.resize(objectCount, quantize(srcData.GetDefaultValue()));
+            srcData.ForEachNonDefault(
+                [&] (ui32 objectIdx, float srcValue) {
+                    dstValues[objectIdx] = quantize(srcValue);
+                });
+        } else {
+            dstValues.yresize(objectCount);
+            ui32 objectIdx = 0;
+            auto blockIterator = srcFeature->GetBlockIterator();
+            while (auto block = blockIterator->Next(BINARIZATION_BLOCK_SIZE)) {
+                for (float srcValue : block) {
+                    dstValues[objectIdx++] = quantize(srcValue);
+                }
+            }
+        }
+        return TMaybeOwningConstArrayHolder<ui8>::CreateOwningReinterpretCast(
+            TMaybeOwningConstArrayHolder<TBin>::CreateOwning(std::move(dstValues)));
     }
 
     class TQuantizationSecondPassBlockConsumer {
@@ -487,7 +598,6 @@ namespace {
             TQuantizationFirstPassResult firstPassResult,
             TDatasetSubset loadSubset,
             EObjectsOrder objectsOrder,
-            TRestorableFastRng64* rand,
             NPar::ILocalExecutor* localExecutor)
             : LocalExecutor(localExecutor)
             , FirstPassResult(std::move(firstPassResult))
@@ -501,7 +611,6 @@ namespace {
                   dynamic_cast<NCB::IQuantizedFeaturesDataVisitor*>(QuantizedDataBuilder.Get()))
             , ObjectsOrder(objectsOrder)
             , ObjectOffset(0)
-            , Rand(rand)
         {
             CB_ENSURE_INTERNAL(
                 QuantizedDataBuilder,
@@ -540,114 +649,99 @@ namespace {
             dataBlock.Drop();
             CB_ENSURE_INTERNAL(rawDataBlock, "failed cast of TDataProvider to TRawDataProvider");
 
-            TQuantizedObjectsDataProviderPtr quantizedObjectsData = Quantize(
-                FirstPassResult.QuantizationOptions,
-                std::move(rawDataBlock->ObjectsData),
-                FirstPassResult.QuantizedFeaturesInfo,
-                Rand,
-                LocalExecutor);
+            const TRawObjectsDataProvider& rawObjectsData = *rawDataBlock->ObjectsData;
 
-            auto groupIds = quantizedObjectsData->GetGroupIds();
+            auto groupIds = rawObjectsData.GetGroupIds();
             if (groupIds) {
                 QuantizedDataVisitor->AddGroupIdPart(ObjectOffset, TUnalignedArrayBuf<TGroupId>(*groupIds));
             }
 
-            auto subgroupIds = quantizedObjectsData->GetSubgroupIds();
+            auto subgroupIds = rawObjectsData.GetSubgroupIds();
             if (subgroupIds) {
                 QuantizedDataVisitor->AddSubgroupIdPart(
                     ObjectOffset,
                     TUnalignedArrayBuf<TSubgroupId>(*subgroupIds));
             }
 
-            auto timestamps = quantizedObjectsData->GetTimestamp();
+            auto timestamps = rawObjectsData.GetTimestamp();
             if (timestamps) {
                 QuantizedDataVisitor->AddTimestampPart(ObjectOffset, TUnalignedArrayBuf<ui64>(*timestamps));
             }
 
-            const auto quantizedFeaturesInfo = quantizedObjectsData->GetQuantizedFeaturesInfo();
-            const auto featuresLayout = quantizedFeaturesInfo->GetFeaturesLayout();
-            for (auto flatFeatureIdx : xrange(featuresLayout->GetExternalFeatureCount())) {
-                const auto featureMetaInfo = featuresLayout->GetExternalFeatureMetaInfo(flatFeatureIdx);
+            const ui32 objectCount = rawObjectsData.GetObjectCount();
+            const auto& quantizedFeaturesInfo = *FirstPassResult.QuantizedFeaturesInfo;
+            const auto& featuresLayout = *quantizedFeaturesInfo.GetFeaturesLayout();
+
+            // can be less than in featuresLayout if features with unknown count are absent in this block
+            const ui32 blockFloatFeatureCount = rawObjectsData.GetFeaturesLayout()->GetFloatFeatureCount();
 
+            TVector<ui32> flatFeatureIndices;
+            for (auto flatFeatureIdx : xrange(featuresLayout.GetExternalFeatureCount())) {
+                const auto featureMetaInfo = featuresLayout.GetExternalFeatureMetaInfo(flatFeatureIdx);
                 if (!featureMetaInfo.IsAvailable) {
                     continue;
                 }
+                CB_ENSURE_INTERNAL(
+                    featureMetaInfo.Type == EFeatureType::Float,
+                    "building quantization results is supported only for numerical features");
+                flatFeatureIndices.push_back(flatFeatureIdx);
+            }
 
-                if (featureMetaInfo.Type == EFeatureType::Float) {
-                    const auto floatFeatureIdx =
-                        featuresLayout->GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+            TVector<ui8> bitsPerKey(flatFeatureIndices.size());
+            TVector<TMaybeOwningConstArrayHolder<ui8>> values(flatFeatureIndices.size());
 
-                    TMaybeData<const IQuantizedFloatValuesHolder*> feature =
-                        quantizedObjectsData->GetFloatFeature(*floatFeatureIdx);
+            // quantize raw columns directly, without building an intermediate quantized data provider
+            LocalExecutor->ExecRangeWithThrow(
+                [&] (int i) {
+                    const ui32 flatFeatureIdx = flatFeatureIndices[i];
+                    const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(
+                        flatFeatureIdx);
 
                     CB_ENSURE_INTERNAL(
-                        feature,
-                        "GetFloatFeature returned nothing for available feature " << flatFeatureIdx);
-                    CB_ENSURE_INTERNAL(
-                        feature.GetRef(),
-                        "GetFloatFeature returned nullptr for available feature " << flatFeatureIdx);
-                    CB_ENSURE_INTERNAL(
-                        quantizedFeaturesInfo->HasBorders(floatFeatureIdx),
+                        quantizedFeaturesInfo.HasBorders(floatFeatureIdx),
                         "There is no borders for available feature " << flatFeatureIdx);
 
-                    TMaybeOwningConstArrayHolder<ui8> values;
-                    const ui8 bitsPerKey = CalcHistogramWidthForBorders(
-                        quantizedFeaturesInfo->GetBorders(floatFeatureIdx).size());
-                    switch (bitsPerKey) {
-                        case 8:
-                            values = ExtractValuesForQuantizedVisitor<ui8>(**feature, LocalExecutor);
-                            break;
-                        case 16:
-                            values = ExtractValuesForQuantizedVisitor<ui16>(**feature, LocalExecutor);
-                            break;
-                        default:
-                            CB_ENSURE_INTERNAL(false, "unexpected bitsPerKey: " << bitsPerKey);
+                    const TFloatValuesHolder* srcFeature = nullptr;
+                    if (*floatFeatureIdx < blockFloatFeatureCount) {
+                        TMaybeData<const TFloatValuesHolder*> feature
+                            = rawObjectsData.GetFloatFeature(*floatFeatureIdx);
+                        CB_ENSURE_INTERNAL(
+                            feature && *feature,
+                            "GetFloatFeature returned nothing for available feature " << flatFeatureIdx);
+                        srcFeature = *feature;
                     }
-                    QuantizedDataVisitor->AddFloatFeaturePart(
-                        flatFeatureIdx,
-                        ObjectOffset,
-                        bitsPerKey,
-                        values);
-                } else if (featureMetaInfo.Type == EFeatureType::Categorical) {
-                    const auto catFeatureIdx =
-                        featuresLayout->GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
-
-                    TMaybeData<const IQuantizedCatValuesHolder*> feature =
-                        quantizedObjectsData->GetCatFeature(*catFeatureIdx);
-
-                    CB_ENSURE_INTERNAL(
-                        feature,
-                        "GetCatFeature returned nothing for available feature" << flatFeatureIdx);
-                    CB_ENSURE_INTERNAL(
-                        feature.GetRef(),
-                        "GetCatFeature returned nullptr for available feature " << flatFeatureIdx);
 
-                    TMaybeOwningConstArrayHolder<ui8> values;
-                    const ui8 bitsPerKey = CalcHistogramWidthForUniqueValuesCount(
-                        quantizedFeaturesInfo->GetUniqueValuesCounts(catFeatureIdx).OnAll);
-                    switch (bitsPerKey) {
+                    bitsPerKey[i] = CalcHistogramWidthForBorders(
+                        quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size());
+                    switch (bitsPerKey[i]) {
                         case 8:
-                            values = ExtractValuesForQuantizedVisitor<ui8>(**feature, LocalExecutor);
+                            values[i] = QuantizeFloatFeatureForQuantizedVisitor<ui8>(
+                                quantizedFeaturesInfo,
+                                floatFeatureIdx,
+                                objectCount,
+                                srcFeature);
                             break;
                         case 16:
-                            values = ExtractValuesForQuantizedVisitor<ui16>(**feature, LocalExecutor);
-                            break;
-                        case 32:
-                            values = ExtractValuesForQuantizedVisitor<ui32>(**feature, LocalExecutor);
+                            values[i] = QuantizeFloatFeatureForQuantizedVisitor<ui16>(
+                                quantizedFeaturesInfo,
+                                floatFeatureIdx,
+                                objectCount,
+                                srcFeature);
                             break;
                         default:
-                            CB_ENSURE_INTERNAL(false, "unexpected bitsPerKey: " << bitsPerKey);
+                            CB_ENSURE_INTERNAL(false, "unexpected bitsPerKey: " << bitsPerKey[i]);
                     }
-                    QuantizedDataVisitor->AddCatFeaturePart(
-                        flatFeatureIdx,
-                        ObjectOffset,
-                        sizeof(IQuantizedCatValuesHolder::TValueType) * 8,
-                        TMaybeOwningConstArrayHolder<ui8>::CreateOwningReinterpretCast(values));
-                } else {
-                    CB_ENSURE_INTERNAL(
-                        false,
-                        "building quantization results is supported only for numerical and categorical features");
-                }
+                },
+                0,
+                SafeIntegerCast<int>(flatFeatureIndices.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE);
+
+            for (auto i : xrange(flatFeatureIndices.size())) {
+                QuantizedDataVisitor->AddFloatFeaturePart(
+                    flatFeatureIndices[i],
+                    ObjectOffset,
+                    bitsPerKey[i],
+                    std::move(values[i]));
             }
 
             const auto targetDimension = rawDataBlock->RawTargetData.GetTargetDimension();
@@ -745,13 +839,37 @@ namespace {
         ui32 ObjectOffset;
 
         TVector<ui32> IgnoredFeatures;
-
-        TRestorableFastRng64* Rand;
     };
 
 } // anonymous namespace
 
-TDataProviderPtr NCB::ReadAndQuantizeDataset(
+bool NCB::CanReadAndQuantizeDataset(
+    const TPathWithScheme& poolPath,
+    const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams) {
+
+    if ((poolPath.Scheme != "dsv") && (poolPath.Scheme != "libsvm") && !poolPath.Scheme.empty()) {
+        return false;
+    }
+    const auto columnsDescription = MakeCdProviderFromFile(columnarPoolFormatParams.CdFilePath)
+        ->GetColumnsDescription(/*columnsCount*/ Nothing());
+    return AllOf(
+        columnsDescription,
+        [] (const TColumn& column) {
+            return !IsFactorColumn(column.Type) || (column.Type == EColumn::Num);
+        });
+}
+
+static TMaybe<TString> GetInputBordersPathString(const TPathWithScheme& inputBordersPath) {
+    if (!inputBordersPath.Inited()) {
+        return Nothing();
+    }
+    CB_ENSURE(
+        inputBordersPath.Scheme == "dsv",
+        "Unknown input borders scheme " << inputBordersPath.Scheme);
+    return inputBordersPath.Path;
+}
+
+static TDataProviderPtr ReadAndQuantizeDatasetImpl(
     const TPathWithScheme& poolPath,
     const TPathWithScheme& pairsFilePath,        // can be uninited
     const TPathWithScheme& groupWeightsFilePath, // can be uninited
@@ -759,11 +877,11 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
     const TPathWithScheme& baselineFilePath,     // can be uninited
     const TPathWithScheme& featureNamesPath,     // can be uninited
     const TPathWithScheme& poolMetaInfoPath,     // can be uninited
-    const TPathWithScheme& inputBordersPath,     // can be uninited
     const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
     const TVector<ui32>& ignoredFeatures,
     EObjectsOrder objectsOrder,
-    NJson::TJsonValue plainJsonParams,
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    TPrepareQuantizationParametersFunc prepareQuantizationParameters,
     TMaybe<ui32> blockSize,
     TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
     TDatasetSubset loadSubset,
@@ -784,11 +902,6 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
         classLabels = &emptyClassLabels;
     }
 
-    NJson::TJsonValue jsonParams;
-    NJson::TJsonValue outputJsonParams;
-    NCatboostOptions::PlainJsonToOptions(plainJsonParams, &jsonParams, &outputJsonParams);
-    NCatboostOptions::TCatBoostOptions catBoostOptions(NCatboostOptions::LoadOptions(jsonParams));
-
     auto datasetLoader = GetProcessor<IDatasetLoader>(
         poolPath, // for choosing processor
         // processor args
@@ -810,7 +923,8 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
                 loadSubset,
                 /*LoadColumnsAsString*/ false,
                 catBoostOptions.DataProcessingOptions->ForceUnitAutoPairWeights,
-                localExecutor}});
+                localExecutor,
+                columnarPoolFormatParams.ShardsShuffleSeed}});
 
     CB_ENSURE(
         EDatasetVisitorType::QuantizedFeatures != datasetLoader->GetVisitorType(),
@@ -821,17 +935,8 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
 
     TRestorableFastRng64 rand(catBoostOptions.RandomSeed);
 
-    TMaybe<TString> inputBordersPathString;
-    if (inputBordersPath.Inited()) {
-        CB_ENSURE(
-            inputBordersPath.Scheme == "dsv",
-            "Unknown input borders scheme " << inputBordersPath.Scheme);
-        inputBordersPathString = inputBordersPath.Path;
-    }
-
     TRawObjectsOrderQuantizationFirstPassVisitor firstPassVisitor(
-        plainJsonParams,
-        inputBordersPathString,
+        std::move(prepareQuantizationParameters),
         quantizedFeaturesInfo,
         CreateDataProviderBuilder(
             datasetLoader->GetVisitorType(),
@@ -846,7 +951,6 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
         firstPassVisitor.GetFirstPassResult(),
         loadSubset,
         objectsOrder,
-        &rand,
         localExecutor);
 
     NCatboostOptions::TDatasetReadingParams params;
@@ -865,6 +969,114 @@ TDataProviderPtr NCB::ReadAndQuantizeDataset(
     return secondPassQuantizer.GetResult();
 }
 
+
+TDataProviderPtr NCB::ReadAndQuantizeDataset(
+    const TPathWithScheme& poolPath,
+    const TPathWithScheme& pairsFilePath,        // can be uninited
+    const TPathWithScheme& groupWeightsFilePath, // can be uninited
+    const TPathWithScheme& timestampsFilePath,   // can be uninited
+    const TPathWithScheme& baselineFilePath,     // can be uninited
+    const TPathWithScheme& featureNamesPath,     // can be uninited
+    const TPathWithScheme& poolMetaInfoPath,     // can be uninited
+    const TPathWithScheme& inputBordersPath,     // can be uninited
+    const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
+    const TVector<ui32>& ignoredFeatures,
+    EObjectsOrder objectsOrder,
+    NJson::TJsonValue plainJsonParams,
+    TMaybe<ui32> blockSize,
+    TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    TDatasetSubset loadSubset,
+    TMaybe<TVector<NJson::TJsonValue>*> classLabels,
+    NPar::ILocalExecutor* localExecutor) {
+
+    NJson::TJsonValue jsonParams;
+    NJson::TJsonValue outputJsonParams;
+    NCatboostOptions::PlainJsonToOptions(plainJsonParams, &jsonParams, &outputJsonParams);
+    NCatboostOptions::TCatBoostOptions catBoostOptions(NCatboostOptions::LoadOptions(jsonParams));
+
+    return ReadAndQuantizeDatasetImpl(
+        poolPath,
+        pairsFilePath,
+        groupWeightsFilePath,
+        timestampsFilePath,
+        baselineFilePath,
+        featureNamesPath,
+        poolMetaInfoPath,
+        columnarPoolFormatParams,
+        ignoredFeatures,
+        objectsOrder,
+        catBoostOptions,
+        [plainJsonParams = std::move(plainJsonParams), inputBordersPathString = GetInputBordersPathString(inputBordersPath)] (
+            const TDataMetaInfo& metaInfo,
+            bool useInputBorders,
+            TQuantizationOptions* quantizationOptions,
+            TQuantizedFeaturesInfoPtr* quantizedFeaturesInfo
+        ) {
+            PrepareQuantizationParameters(
+                plainJsonParams,
+                metaInfo,
+                useInputBorders ? inputBordersPathString : Nothing(),
+                quantizationOptions,
+                quantizedFeaturesInfo);
+        },
+        blockSize,
+        std::move(quantizedFeaturesInfo),
+        loadSubset,
+        classLabels,
+        localExecutor);
+}
+
+TDataProviderPtr NCB::ReadAndQuantizeDataset(
+    const TPathWithScheme& poolPath,
+    const TPathWithScheme& pairsFilePath,        // can be uninited
+    const TPathWithScheme& groupWeightsFilePath, // can be uninited
+    const TPathWithScheme& timestampsFilePath,   // can be uninited
+    const TPathWithScheme& baselineFilePath,     // can be uninited
+    const TPathWithScheme& featureNamesPath,     // can be uninited
+    const TPathWithScheme& poolMetaInfoPath,     // can be uninited
+    const TPathWithScheme& inputBordersPath,     // can be uninited
+    const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
+    const TVector<ui32>& ignoredFeatures,
+    EObjectsOrder objectsOrder,
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    TMaybe<ui32> blockSize,
+    TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    TDatasetSubset loadSubset,
+    TMaybe<TVector<NJson::TJsonValue>*> classLabels,
+    NPar::ILocalExecutor* localExecutor) {
+
+    return ReadAndQuantizeDatasetImpl(
+        poolPath,
+        pairsFilePath,
+        groupWeightsFilePath,
+        timestampsFilePath,
+        baselineFilePath,
+        featureNamesPath,
+        poolMetaInfoPath,
+        columnarPoolFormatParams,
+        ignoredFeatures,
+        objectsOrder,
+        catBoostOptions,
+        [&catBoostOptions, inputBordersPathString = GetInputBordersPathString(inputBordersPath)] (
+            const TDataMetaInfo& metaInfo,
+            bool useInputBorders,
+            TQuantizationOptions* quantizationOptions,
+            TQuantizedFeaturesInfoPtr* quantizedFeaturesInfo
+        ) {
+            PrepareQuantizationParameters(
+                catBoostOptions,
+                metaInfo,
+                useInputBorders ? inputBordersPathString : Nothing(),
+                quantizationOptions,
+                quantizedFeaturesInfo);
+        },
+        blockSize,
+        std::move(quantizedFeaturesInfo),
+        loadSubset,
+        classLabels,
+        localExecutor);
+}
+
 TDataProviderPtr NCB::ReadAndQuantizeDataset(
     const TPathWithScheme& poolPath,
     const TPathWithScheme& pairsFilePath,        // can be uninited
@@ -12,6 +12,7 @@
 #include <util/system/types.h>
 
 namespace NCatboostOptions {
+    class TCatBoostOptions;
     struct TColumnarPoolFormatParams;
 }
 
@@ -22,6 +23,14 @@ namespace NPar {
 namespace NCB {
     struct TPathWithScheme;
 
+    /* true if the dataset can be read by ReadAndQuantizeDataset: dsv or libsvm format with only float features
+     * (as defined by column description), so raw features of the whole dataset are never stored
+     */
+    bool CanReadAndQuantizeDataset(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams
+    );
+
     // use from C++ code
     TDataProviderPtr ReadAndQuantizeDataset(
         const TPathWithScheme& poolPath,
@@ -43,6 +52,27 @@ namespace NCB {
         NPar::ILocalExecutor* localExecutor
     );
 
+    // catBoostOptions must not depend on feature names, ignored features are specified by ignoredFeatures
+    TDataProviderPtr ReadAndQuantizeDataset(
+        const TPathWithScheme& poolPath,
+        const TPathWithScheme& pairsFilePath, // can be uninited
+        const TPathWithScheme& groupWeightsFilePath, // can be uninited
+        const TPathWithScheme& timestampsFilePath, // can be uninited
+        const TPathWithScheme& baselineFilePath, // can be uninited
+        const TPathWithScheme& featureNamesPath, // can be uninited
+        const TPathWithScheme& poolMetaInfoPath, // can be uninited
+        const TPathWithScheme& inputBordersPath, // can be uninited
+        const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+        TMaybe<ui32> blockSize,
+        TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+        TDatasetSubset loadSubset,
+        TMaybe<TVector<NJson::TJsonValue>*> classLabels,
+        NPar::ILocalExecutor* localExecutor
+    );
+
     // for use from context where there's no localExecutor and proper logging handling is unimplemented
     TDataProviderPtr ReadAndQuantizeDataset(
         const TPathWithScheme& poolPath,
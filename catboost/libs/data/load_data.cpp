@@ -3,6 +3,8 @@
 
 #include "cb_dsv_loader.h"
 #include "data_provider_builders.h"
+#include "load_and_quantize_data.h"
+#include "raw_dataset_cache.h"
 
 #include <catboost/libs/column_description/cd_parser.h>
 #include <catboost/libs/helpers/exception.h>
@@ -11,6 +13,8 @@
 #include <catboost/private/libs/data_util/exists_checker.h>
 
 #include <util/datetime/base.h>
+#include <util/generic/array_ref.h>
+#include <util/system/fs.h>
 
 
 namespace NCB {
@@ -36,12 +40,41 @@ namespace NCB {
         if (classLabels) {
             UpdateClassLabelsFromBaselineFile(baselineFilePath, *classLabels);
         }
+
+        TPathWithScheme datasetPath = poolPath;
+        TMaybe<TString> rawDatasetCacheFilePath;
+        if (!columnarPoolFormatParams.RawDatasetCacheDir.empty() && (loadSubset == TDatasetSubset::MakeColumns())) {
+            const TPathWithScheme auxiliaryFilePaths[] = {
+                pairsFilePath,
+                groupWeightsFilePath,
+                timestampsFilePath,
+                baselineFilePath,
+                featureNamesPath,
+                poolMetaInfoPath
+            };
+            rawDatasetCacheFilePath = GetRawDatasetCacheFilePath(
+                columnarPoolFormatParams.RawDatasetCacheDir,
+                poolPath,
+                auxiliaryFilePaths,
+                columnarPoolFormatParams,
+                ignoredFeatures,
+                objectsOrder,
+                forceUnitAutoPairWeights,
+                classLabels ? TConstArrayRef<NJson::TJsonValue>(**classLabels) : TConstArrayRef<NJson::TJsonValue>()
+            );
+            if (rawDatasetCacheFilePath && NFs::Exists(*rawDatasetCacheFilePath)) {
+                CATBOOST_INFO_LOG << "Loading dataset from raw dataset cache " << *rawDatasetCacheFilePath << Endl;
+                datasetPath = TPathWithScheme(*rawDatasetCacheFilePath, "raw-cache");
+                rawDatasetCacheFilePath.Clear();
+            }
+        }
+
         auto datasetLoader = GetProcessor<IDatasetLoader>(
-            poolPath, // for choosing processor
+            datasetPath, // for choosing processor
 
             // processor args
             TDatasetLoaderPullArgs {
-                poolPath,
+                datasetPath,
 
                 TDatasetLoaderCommonArgs {
                     pairsFilePath,
@@ -59,7 +92,8 @@ namespace NCB {
                     loadSubset,
                     /*LoadColumnsAsString*/ false,
                     forceUnitAutoPairWeights,
-                    localExecutor
+                    localExecutor,
+                    columnarPoolFormatParams.ShardsShuffleSeed
                 }
             }
         );
@@ -82,7 +116,19 @@ namespace NCB {
         );
 
         datasetLoader->DoIfCompatible(dynamic_cast<IDatasetVisitor*>(dataProviderBuilder.Get()));
-        return dataProviderBuilder->GetResult();
+        TDataProviderPtr dataProvider = dataProviderBuilder->GetResult();
+
+        // the cache is an optimization only, so failing to create it is not an error
+        if (rawDatasetCacheFilePath) {
+            try {
+                NFs::MakeDirectoryRecursive(columnarPoolFormatParams.RawDatasetCacheDir);
+                SaveRawDatasetCache(*dataProvider, *rawDatasetCacheFilePath, localExecutor);
+                CATBOOST_INFO_LOG << "Dataset is saved to raw dataset cache " << *rawDatasetCacheFilePath << Endl;
+            } catch (const std::exception& e) {
+                CATBOOST_WARNING_LOG << "Dataset is not saved to raw dataset cache: " << e.what() << Endl;
+            }
+        }
+        return dataProvider;
     }
 
 
@@ -196,7 +242,8 @@ namespace NCB {
         bool forceUnitAutoPairWeights,
         TMaybe<TVector<NJson::TJsonValue>*> classLabels,
         NPar::ILocalExecutor* const executor,
-        TProfileInfo* const profile
+        TProfileInfo* const profile,
+        const NCatboostOptions::TCatBoostOptions* learnQuantizationOptions
     ) {
         if (readTestData) {
             loadOptions.Validate();
@@ -209,23 +256,50 @@ namespace NCB {
         if (loadOptions.LearnSetPath.Inited()) {
             CATBOOST_DEBUG_LOG << "Loading features..." << Endl;
             auto start = Now();
-            dataProviders.Learn = ReadDataset(
-                taskType,
-                loadOptions.LearnSetPath,
-                loadOptions.PairsFilePath,
-                loadOptions.GroupWeightsFilePath,
-                loadOptions.TimestampsFilePath,
-                loadOptions.BaselineFilePath,
-                loadOptions.FeatureNamesPath,
-                loadOptions.PoolMetaInfoPath,
-                loadOptions.ColumnarPoolFormatParams,
-                loadOptions.IgnoredFeatures,
-                objectsOrder,
-                learnDatasetSubset,
-                forceUnitAutoPairWeights,
-                classLabels,
-                executor
-            );
+            // raw dataset cache stores raw datasets, so the learn dataset is quantized after loading if it is used
+            if (learnQuantizationOptions && loadOptions.ColumnarPoolFormatParams.RawDatasetCacheDir.empty()) {
+                CATBOOST_DEBUG_LOG << "Learn features are quantized while reading" << Endl;
+                TVector<NJson::TJsonValue> emptyClassLabels;
+                dataProviders.Learn = ReadAndQuantizeDataset(
+                    loadOptions.LearnSetPath,
+                    loadOptions.PairsFilePath,
+                    loadOptions.GroupWeightsFilePath,
+                    loadOptions.TimestampsFilePath,
+                    loadOptions.BaselineFilePath,
+                    loadOptions.FeatureNamesPath,
+                    loadOptions.PoolMetaInfoPath,
+                    loadOptions.BordersFile ?
+                        TPathWithScheme(loadOptions.BordersFile, "dsv")
+                        : TPathWithScheme(),
+                    loadOptions.ColumnarPoolFormatParams,
+                    loadOptions.IgnoredFeatures,
+                    objectsOrder,
+                    *learnQuantizationOptions,
+                    /*blockSize*/ Nothing(),
+                    /*quantizedFeaturesInfo*/ nullptr,
+                    learnDatasetSubset,
+                    classLabels ? classLabels : MakeMaybe(&emptyClassLabels),
+                    executor
+                );
+            } else {
+                dataProviders.Learn = ReadDataset(
+                    taskType,
+                    loadOptions.LearnSetPath,
+                    loadOptions.PairsFilePath,
+                    loadOptions.GroupWeightsFilePath,
+                    loadOptions.TimestampsFilePath,
+                    loadOptions.BaselineFilePath,
+                    loadOptions.FeatureNamesPath,
+                    loadOptions.PoolMetaInfoPath,
+                    loadOptions.ColumnarPoolFormatParams,
+                    loadOptions.IgnoredFeatures,
+                    objectsOrder,
+                    learnDatasetSubset,
+                    forceUnitAutoPairWeights,
+                    classLabels,
+                    executor
+                );
+            }
             CATBOOST_DEBUG_LOG << "Loading features time: " << (Now() - start).Seconds() << Endl;
             if (profile) {
                 profile->AddOperation("Build learn pool");
@@ -23,6 +23,10 @@ namespace NJson {
     class TJsonValue;
 }
 
+namespace NCatboostOptions {
+    class TCatBoostOptions;
+}
+
 
 namespace NCB {
     // use from C++ code
@@ -91,7 +95,12 @@ namespace NCB {
         bool forceUnitAutoPairWeights,
         TMaybe<TVector<NJson::TJsonValue>*> classLabels,
         NPar::ILocalExecutor* executor,
-        TProfileInfo* profile
+        TProfileInfo* profile,
+
+        /* if specified, learn dataset is quantized with these options while reading,
+         * see ReadAndQuantizeDataset and CanReadAndQuantizeDataset
+         */
+        const NCatboostOptions::TCatBoostOptions* learnQuantizationOptions = nullptr
     );
 
     TPrecomputedOnlineCtrData ReadPrecomputedOnlineCtrMetaData(
@@ -11,8 +11,10 @@
 
 #include <util/charset/unidata.h>
 #include <util/generic/algorithm.h>
+#include <util/generic/array_size.h>
 #include <util/generic/ptr.h>
 #include <util/generic/xrange.h>
+#include <util/string/ascii.h>
 #include <util/string/cast.h>
 #include <util/string/split.h>
 #include <util/system/types.h>
@@ -408,6 +410,58 @@ namespace NCB {
             }
         };
 
+        /* plain decimals like "-12.375" with at most 24 significant bits and 10 fractional digits:
+         * both mantissa and power of 10 are exact floats, so their quotient is correctly rounded
+         * and equals the result of TryFromString<float>
+         */
+        bool TryShortDecimalFromString(TStringBuf token, float& value) {
+            static constexpr float PowersOf10[] = {
+                1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+            };
+            static constexpr ui64 MaxMantissa = ui64(1) << 24;
+
+            const char* ptr = token.data();
+            const char* end = ptr + token.size();
+            const bool negative = (*ptr == '-');
+            if (negative) {
+                ++ptr;
+            }
+            const char* intBegin = ptr;
+            ui64 mantissa = 0;
+            for (; ptr != end && IsAsciiDigit(*ptr); ++ptr) {
+                mantissa = mantissa * 10 + (*ptr - '0');
+                if (mantissa > MaxMantissa) {
+                    return false;
+                }
+            }
+            if (ptr == intBegin) {
+                return false;
+            }
+            size_t fractionDigits = 0;
+            if (ptr != end) {
+                if (*ptr != '.') {
+                    return false;
+                }
+                ++ptr;
+                const char* fractionBegin = ptr;
+                for (; ptr != end && IsAsciiDigit(*ptr); ++ptr) {
+                    mantissa = mantissa * 10 + (*ptr - '0');
+                    if (mantissa > MaxMantissa) {
+                        return false;
+                    }
+                }
+                fractionDigits = ptr - fractionBegin;
+                if ((ptr != end) || !fractionDigits || (fractionDigits >= Y_ARRAY_SIZE(PowersOf10))) {
+                    return false;
+                }
+            }
+            value = float(mantissa) / PowersOf10[fractionDigits];
+            if (negative) {
+                value = -value;
+            }
+            return true;
+        }
+
         bool TryFloatFromStringFast(TStringBuf token, float& value) {
             if (token.empty()) {
                 return false;
@@ -438,6 +492,9 @@ namespace NCB {
                     return true;
                 }
             }
+            if (TryShortDecimalFromString(token, value)) {
+                return true;
+            }
             return TryFromString<float>(token, value);
         }
     }
@@ -75,6 +75,7 @@ namespace NCB {
         bool LoadColumnsAsString;
         bool ForceUnitAutoPairWeights;
         NPar::ILocalExecutor* LocalExecutor;
+        TMaybe<ui64> ShardsShuffleSeed = Nothing(); // order of shards for sharded pool paths, sorted if Nothing
     };
 
     // pass this struct to to IDatasetLoader ctor
@@ -124,7 +125,13 @@ namespace NCB {
 
     struct IRawFeaturesOrderDatasetLoader : public IDatasetLoader {
         virtual EDatasetVisitorType GetVisitorType() const override {
-            return EDatasetVisitorType::RawObjectsOrder;
+            return EDatasetVisitorType::RawFeaturesOrder;
+        }
+
+        void DoIfCompatible(IDatasetVisitor* visitor) override {
+            auto compatibleVisitor = dynamic_cast<IRawFeaturesOrderDataVisitor*>(visitor);
+            CB_ENSURE_INTERNAL(compatibleVisitor, "visitor is incompatible with dataset loader");
+            Do(compatibleVisitor);
         }
 
         // Process all data
@@ -7,11 +7,13 @@
 
 #include <catboost/libs/helpers/math_utils.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/helpers/serialization.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/logging/logging.h>
 
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
@@ -82,7 +84,13 @@ static void CheckGroupIds(
         }
     }
 
-    Sort(groupGroupIds);
+    if constexpr (std::is_same_v<TGroupIdClass, TGroupId>) {
+        // no executor is passed to Check, radix sort is faster than Sort even in one thread
+        NPar::TLocalExecutor sequentialExecutor;
+        ParallelRadixSort(MakeArrayRef(groupGroupIds), [] (TGroupId groupId) { return groupId; }, &sequentialExecutor);
+    } else {
+        Sort(groupGroupIds);
+    }
     auto it = std::adjacent_find(groupGroupIds.begin(), groupGroupIds.end());
     CB_ENSURE(it == groupGroupIds.end(), "group Ids are not consecutive");
 }
@@ -670,6 +678,23 @@ void NCB::TRawObjectsData::Check(
     }
 }
 
+namespace {
+    // copy-vs-view decisions made in GetSubset for feature columns, for logging
+    struct TColumnsSubsetStats {
+        ui32 ViewCount = 0;
+        ui32 CopyCount = 0;
+        ui64 CopyMemory = 0; // estimated
+
+    public:
+        void Log(ui32 subsetObjectCount) const {
+            CATBOOST_DEBUG_LOG << "Objects data subset of " << subsetObjectCount << " objects: "
+                << ViewCount << " feature columns are views over the source data, " << CopyCount
+                << " feature columns are copied (estimated size is " << HumanReadableSize(CopyMemory, SF_BYTES)
+                << ")" << Endl;
+        }
+    };
+}
+
 template <class TColumn, class TGetAggregatedColumn>
 static void GetSubsetWithScheduling(
     TConstArrayRef<THolder<TColumn>> src,
@@ -684,7 +709,8 @@ static void GetSubsetWithScheduling(
     TGetAggregatedColumn&& getAggregatedData,
     //std::function<THolder<TColumn>(ui32)> getAggregatedData,
     TResourceConstrainedExecutor* resourceConstrainedExecutor,
-    TVector<THolder<TColumn>>* dst
+    TVector<THolder<TColumn>>* dst,
+    TColumnsSubsetStats* stats = nullptr
 ) {
 
     dst->clear(); // cleanup old data
@@ -709,25 +735,30 @@ static void GetSubsetWithScheduling(
             continue;
         }
         auto dstHolderPtr = &(*dst)[i];
-        // TODO(kirillovs): add shortcut here for zero-cost cloneable columns
-        resourceConstrainedExecutor->Add(
-            {
-                srcDataPtr->EstimateMemoryForCloning(cloningParams),
-                [srcDataPtr, dstHolderPtr, localExecutor, cloningParams] () {
-                    auto clonedColumn = srcDataPtr->CloneWithNewSubsetIndexing(
-                        cloningParams,
-                        localExecutor
-                    );
-                    *dstHolderPtr = DynamicHolderCast<TColumn>(
-                        srcDataPtr->CloneWithNewSubsetIndexing(
-                            cloningParams,
-                            localExecutor
-                        ),
-                        "Column type changed after cloning"
-                    );
-                }
+        auto cloneColumn = [srcDataPtr, dstHolderPtr, localExecutor, cloningParams] () {
+            *dstHolderPtr = DynamicHolderCast<TColumn>(
+                srcDataPtr->CloneWithNewSubsetIndexing(
+                    cloningParams,
+                    localExecutor
+                ),
+                "Column type changed after cloning"
+            );
+        };
+
+        const ui64 memoryForCloning = srcDataPtr->EstimateMemoryForCloning(cloningParams);
+        if (memoryForCloning == 0) {
+            // zero-cost cloneable columns are views over the source column storage
+            cloneColumn();
+            if (stats) {
+                ++stats->ViewCount;
             }
-        );
+        } else {
+            resourceConstrainedExecutor->Add({memoryForCloning, std::move(cloneColumn)});
+            if (stats) {
+                ++stats->CopyCount;
+                stats->CopyMemory += memoryForCloning;
+            }
+        }
     }
 }
 
@@ -739,7 +770,8 @@ static void GetSubsetWithScheduling(
     // needed only for sparse features
     const TMaybe<TFeaturesArraySubsetInvertedIndexing>& subsetInvertedIndexing,
     TResourceConstrainedExecutor* resourceConstrainedExecutor,
-    TVector<THolder<T>>* dst
+    TVector<THolder<T>>* dst,
+    TColumnsSubsetStats* stats = nullptr
 ) {
     ::GetSubsetWithScheduling(
         src,
@@ -747,7 +779,8 @@ static void GetSubsetWithScheduling(
         subsetInvertedIndexing,
         /*getPackedOrBundledData*/ [] (ui32) { return nullptr; },
         resourceConstrainedExecutor,
-        dst
+        dst,
+        stats
     );
 }
 
@@ -796,6 +829,7 @@ TObjectsDataProviderPtr NCB::TRawObjectsDataProvider::GetSubsetImpl(
     auto resourceConstrainedExecutor = CreateCpuRamConstrainedExecutor(cpuRamLimit, localExecutor);
 
     TRawObjectsData subsetData;
+    TColumnsSubsetStats subsetStats;
 
     auto getSubsetWithScheduling = [&] (const auto& srcFeatures, auto* dstFeatures) {
         GetSubsetWithScheduling(
@@ -803,7 +837,8 @@ TObjectsDataProviderPtr NCB::TRawObjectsDataProvider::GetSubsetImpl(
             subsetCommonData.SubsetIndexing.Get(),
             subsetInvertedIndexing,
             &resourceConstrainedExecutor,
-            dstFeatures
+            dstFeatures,
+            &subsetStats
         );
     };
 
@@ -812,6 +847,7 @@ TObjectsDataProviderPtr NCB::TRawObjectsDataProvider::GetSubsetImpl(
     getSubsetWithScheduling(Data.TextFeatures, &subsetData.TextFeatures);
     getSubsetWithScheduling(Data.EmbeddingFeatures, &subsetData.EmbeddingFeatures);
 
+    subsetStats.Log(subsetCommonData.SubsetIndexing->Size());
     resourceConstrainedExecutor.ExecTasks();
 
     return MakeIntrusive<TRawObjectsDataProvider>(
@@ -1160,7 +1196,8 @@ static void LoadFeatures(
                 (*dst)[*featureIdx] = MakeHolder<TFeaturesGroupPartValuesHolderImpl<TColumn>>(
                     flatFeatureIdx,
                     (**featureGroupsData).SrcData[featuresGroupIndex.GroupIdx].Get(),
-                    featuresGroupIndex.InGroupIdx
+                    featuresGroupIndex.InGroupIdx,
+                    (**featureGroupsData).MetaData[featuresGroupIndex.GroupIdx].PartBitCount
                 );
             } else {
                 LoadNonBundledColumnData(
@@ -1685,7 +1722,8 @@ static THolder<TColumn> GetAggregatedColumn(
         return MakeHolder<TFeaturesGroupPartValuesHolderImpl<TColumn>>(
             flatFeatureIdx,
             groupsData.SrcData[groupIndex->GroupIdx].Get(),
-            groupIndex->InGroupIdx
+            groupIndex->InGroupIdx,
+            groupsData.MetaData[groupIndex->GroupIdx].PartBitCount
         );
     }
 
@@ -1735,6 +1773,8 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedObjectsDataProvider::GetSubsetImpl(
 
     resourceConstrainedExecutor.ExecTasks();
 
+    TColumnsSubsetStats subsetStats;
+
     auto getSubsetWithSchedulingForFeaturesPart = [&] (
         const auto& srcData,
         auto&& getPackedOrBundledData,
@@ -1746,7 +1786,8 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedObjectsDataProvider::GetSubsetImpl(
                 subsetInvertedIndexing,
                 std::move(getPackedOrBundledData),
                 &resourceConstrainedExecutor,
-                dstSubsetData
+                dstSubsetData,
+                &subsetStats
             );
         };
 
@@ -1784,6 +1825,7 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedObjectsDataProvider::GetSubsetImpl(
         &subsetData.EmbeddingFeatures
     );
 
+    subsetStats.Log(subsetCommonData.SubsetIndexing->Size());
     resourceConstrainedExecutor.ExecTasks();
 
     subsetData.QuantizedFeaturesInfo = Data.QuantizedFeaturesInfo;
@@ -1886,7 +1928,8 @@ static void MakeConsecutiveIfDenseArrayFeatures(
                 (*dst)[*featureIdx] = MakeHolder<TFeaturesGroupPartValuesHolderImpl<TColumn>>(
                     srcColumn->GetId(),
                     newFeatureGroupsData.SrcData[maybeFeaturesGroupIndex->GroupIdx].Get(),
-                    maybeFeaturesGroupIndex->InGroupIdx
+                    maybeFeaturesGroupIndex->InGroupIdx,
+                    newFeatureGroupsData.MetaData[maybeFeaturesGroupIndex->GroupIdx].PartBitCount
                 );
 
             } else {
@@ -1976,6 +2019,9 @@ void NCB::TQuantizedObjectsDataProvider::EnsureConsecutiveIfDenseFeaturesData(
         return;
     }
 
+    CATBOOST_DEBUG_LOG << "Dense quantized features data of " << GetObjectCount()
+        << " objects is copied to make it consecutive" << Endl;
+
     auto newSubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(
         TFullSubset<ui32>(GetObjectCount())
     );
@@ -9,10 +9,10 @@
 
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/compression.h>
-#include <catboost/libs/helpers/double_array_iterator.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/libs/helpers/sample.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/logging/logging.h>
@@ -35,6 +35,8 @@
 #include <util/system/compiler.h>
 #include <util/system/mem_info.h>
 
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <numeric>
 
@@ -47,25 +49,37 @@ namespace NCB {
         NPar::ILocalExecutor* localExecutor
     ) {
         if (hasDenseData && !std::holds_alternative<TFullSubset<ui32>>(srcSubsetIndexing)) {
-            TVector<ui32> srcIndices;
-            srcIndices.yresize(srcSubsetIndexing.Size());
-            TArrayRef<ui32> srcIndicesRef = srcIndices;
+            struct TIndexPair {
+                ui32 SrcIdx;
+                ui32 DstIdx;
+            };
+
+            TVector<TIndexPair> indexPairs;
+            indexPairs.yresize(srcSubsetIndexing.Size());
+            TArrayRef<TIndexPair> indexPairsRef = indexPairs;
 
             srcSubsetIndexing.ParallelForEach(
                 [=] (ui32 objectIdx, ui32 srcObjectIdx) {
-                    srcIndicesRef[objectIdx] = srcObjectIdx;
+                    indexPairsRef[objectIdx] = TIndexPair{srcObjectIdx, objectIdx};
                 },
                 localExecutor
             );
 
-            TVector<ui32> dstIndices;
-            dstIndices.yresize(srcSubsetIndexing.Size());
-            Iota(dstIndices.begin(), dstIndices.end(), ui32(0));
-
-            TDoubleArrayIterator<ui32, ui32> beginIter{srcIndices.begin(), dstIndices.begin()};
-            TDoubleArrayIterator<ui32, ui32> endIter{srcIndices.end(), dstIndices.end()};
+            ParallelRadixSort(indexPairsRef, [] (const TIndexPair& pair) { return pair.SrcIdx; }, localExecutor);
 
-            Sort(beginIter, endIter, [](auto lhs, auto rhs) { return lhs.first < rhs.first; });
+            TVector<ui32> srcIndices;
+            srcIndices.yresize(indexPairs.size());
+            TVector<ui32> dstIndices;
+            dstIndices.yresize(indexPairs.size());
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                SafeIntegerCast<int>(indexPairs.size()),
+                [&] (int i) {
+                    srcIndices[i] = indexPairs[i].SrcIdx;
+                    dstIndices[i] = indexPairs[i].DstIdx;
+                }
+            );
 
             SrcSubsetIndexing = TFeaturesArraySubsetIndexing(std::move(srcIndices));
             DstIndexing = TFeaturesArraySubsetIndexing(std::move(dstIndices));
@@ -113,6 +127,48 @@ namespace NCB {
         }
     };
 
+    /* Shared by border calculation tasks of all float features.
+     * Tasks of features are balanced between threads by the executor, but the last features can take much
+     * longer than the others if they have many unique values. So when there are fewer features left to start
+     * than threads, samples of the started features are sorted in parallel, and idle threads help to finish them.
+     */
+    class TBuildBordersScheduler {
+    public:
+        // smaller samples are sorted faster than parallel sort is scheduled
+        static constexpr size_t MinSampleSizeToSortInParallel = 1 << 14;
+
+    public:
+        TBuildBordersScheduler(ui32 featureCount, NPar::ILocalExecutor* localExecutor)
+            : UnstartedFeatureCount(featureCount)
+            , SortBuffers(localExecutor->GetThreadCount() + 1)
+            , LocalExecutor(localExecutor)
+        {}
+
+        // call once at the start of each feature task, returns if its sample should be sorted in parallel
+        bool StartFeature() {
+            const ui32 unstartedFeatureCount = UnstartedFeatureCount.fetch_sub(1) - 1;
+            return unstartedFeatureCount < SafeIntegerCast<ui32>(LocalExecutor->GetThreadCount());
+        }
+
+        // buffer of the current thread is reused for samples of all features processed in it
+        TVector<float>* GetSortBuffer() {
+            const int threadId = LocalExecutor->GetWorkerThreadId();
+            if ((threadId >= 0) && (size_t(threadId) < SortBuffers.size())) {
+                return &SortBuffers[threadId];
+            }
+            return nullptr;
+        }
+
+        NPar::ILocalExecutor* GetLocalExecutor() const {
+            return LocalExecutor;
+        }
+
+    private:
+        std::atomic<ui32> UnstartedFeatureCount;
+        TVector<TVector<float>> SortBuffers;
+        NPar::ILocalExecutor* LocalExecutor;
+    };
+
     // TODO(akhropov): maybe use different sample selection logic for sparse data
     static TSubsetIndexingForBuildBorders GetSubsetForBuildBorders(
         const TFeaturesArraySubsetIndexing& srcIndexing,
@@ -205,6 +261,7 @@ namespace NCB {
             }
 
             result += sizeof(float) * nonDefaultSampleSize; // for copying to srcFeatureValuesForBuildBorders
+            result += sizeof(float) * nonDefaultSampleSize; // for parallel sort of the sample
 
             const auto& floatFeatureBinarizationSettings
                 = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
@@ -237,6 +294,8 @@ namespace NCB {
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         const TMaybe<TVector<float>>& initialBorders,
         TMaybe<float> quantizedDefaultBinFraction,
+        bool sortSampleInParallel,
+        TBuildBordersScheduler* buildBordersScheduler,
         ENanMode* nanMode,
         NSplitSelection::TQuantization* quantization
     ) {
@@ -327,6 +386,22 @@ namespace NCB {
         }
 
         if (nonNanValuesBorderCount > 0) {
+            if (sortSampleInParallel
+                && (featureValues.Values.size() >= TBuildBordersScheduler::MinSampleSizeToSortInParallel))
+            {
+                TVector<float>* sortBuffer = buildBordersScheduler->GetSortBuffer();
+                if (sortBuffer) {
+                    sortBuffer->yresize(featureValues.Values.size());
+                }
+                ParallelRadixSort(
+                    MakeArrayRef(featureValues.Values),
+                    [] (float value) { return value; },
+                    buildBordersScheduler->GetLocalExecutor(),
+                    sortBuffer
+                );
+                featureValues.ValuesSorted = true;
+            }
+
             *quantization = NSplitSelection::BestSplit(
                 std::move(featureValues),
                 /*featureValuesMayContainNans*/ false,
@@ -1567,7 +1642,7 @@ namespace NCB {
                         GetSrcPart(aggregateIdx, partIdx)
                     );
                 if (defaultBin) {
-                    result |= *defaultBin << (partIdx * CHAR_BIT);
+                    result |= *defaultBin << (partIdx * MetaData[aggregateIdx].PartBitCount);
                 }
             }
 
@@ -1575,8 +1650,7 @@ namespace NCB {
         }
 
         TAggregationContext GetAggregationContext(ui32 aggregateIdx, ui32 partIdx) const {
-            Y_UNUSED(aggregateIdx);
-            return (ui32)partIdx * CHAR_BIT;
+            return (ui32)partIdx * MetaData[aggregateIdx].PartBitCount;
         }
 
         template <class TDstValue>
@@ -1613,7 +1687,8 @@ namespace NCB {
                             new TQuantizedFloatGroupPartValuesHolder(
                                 flatFeatureIdx,
                                 groupData.Get(),
-                                partIdx
+                                partIdx,
+                                MetaData[aggregateIdx].PartBitCount
                             )
                         );
                         break;
@@ -1764,9 +1839,12 @@ namespace NCB {
         const TMaybe<TIncrementalDenseIndexing>& incrementalDenseIndexing,
         const TFeaturesArraySubsetIndexing* dstSubsetIndexing,  // can be nullptr if generateBordersOnly
         NPar::ILocalExecutor* localExecutor,
+        TBuildBordersScheduler* buildBordersScheduler,
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedFloatValuesHolder>* dstQuantizedFeature // can be nullptr if generateBordersOnly
     ) {
+        const bool sortSampleInParallel = buildBordersScheduler->StartFeature();
+
         bool calculateNanMode = true;
         ENanMode nanMode = ENanMode::Forbidden;
 
@@ -1805,6 +1883,8 @@ namespace NCB {
                 *quantizedFeaturesInfo,
                 initialBordersForFeature,
                 options.DefaultValueFractionToEnableSparseStorage,
+                sortSampleInParallel,
+                buildBordersScheduler,
                 &nanMode,
                 &calculatedQuantization
             );
@@ -2264,6 +2344,13 @@ namespace NCB {
                 ui64 cpuRamUsage = NMemInfo::GetMemInfo().RSS;
                 OutputWarningIfCpuRamUsageOverLimit(cpuRamUsage, options.CpuRamLimit);
 
+                // before resourceConstrainedExecutor, because its destructor can execute tasks
+                ui32 floatFeatureCount = 0;
+                featuresLayout->IterateOverAvailableFeatures<EFeatureType::Float>(
+                    [&] (TFloatFeatureIdx /*floatFeatureIdx*/) { ++floatFeatureCount; }
+                );
+                TBuildBordersScheduler buildBordersScheduler(floatFeatureCount, localExecutor);
+
                 TResourceConstrainedExecutor resourceConstrainedExecutor(
                     "CPU RAM",
                     options.CpuRamLimit - Min(cpuRamUsage, options.CpuRamLimit),
@@ -2301,6 +2388,7 @@ namespace NCB {
                                         incrementalIndexing,
                                         subsetIndexing.Get(),
                                         localExecutor,
+                                        &buildBordersScheduler,
                                         quantizedFeaturesInfo,
                                         calcQuantizationAndNanModeOnlyInProcessFloatFeatures ?
                                             nullptr
@@ -2606,6 +2694,30 @@ namespace NCB {
     }
 
 
+    /* Features groups store several float features of an object together, so leafwise scoring calculates
+     * their histograms in one pass over objects. It pays off for wide and short datasets, where a pass over
+     * each feature column is too short. Groups are enabled automatically only for grow policies which always
+     * use leafwise scoring.
+     */
+    static bool NeedToGroupFeaturesForCpu(
+        const NCatboostOptions::TCatBoostOptions& params,
+        const TDataMetaInfo& metaInfo
+    ) {
+        const auto& devGroupFeatures = params.DataProcessingOptions->DevGroupFeatures;
+        if (devGroupFeatures.IsSet()) {
+            return devGroupFeatures.GetUnchecked();
+        }
+        const ui32 minFeatureCountToGroup = 1000;
+        const ui64 maxObjectCountPerFeatureToGroup = 100;
+
+        const auto growPolicy = params.ObliviousTreeOptions->GrowPolicy.Get();
+        const ui32 floatFeatureCount = metaInfo.FeaturesLayout->GetFloatFeatureCount();
+        return (growPolicy == EGrowPolicy::Lossguide || growPolicy == EGrowPolicy::Depthwise)
+            && (floatFeatureCount >= minFeatureCountToGroup)
+            && (metaInfo.ObjectCount != 0)
+            && (metaInfo.ObjectCount <= maxObjectCountPerFeatureToGroup * floatFeatureCount);
+    }
+
     void PrepareQuantizationParameters(
         const NCatboostOptions::TCatBoostOptions& params,
         const TDataMetaInfo& metaInfo,
@@ -2613,8 +2725,11 @@ namespace NCB {
         TQuantizationOptions* quantizationOptions,
         TQuantizedFeaturesInfoPtr* quantizedFeaturesInfo
     ) {
-        quantizationOptions->GroupFeaturesForCpu = params.DataProcessingOptions->DevGroupFeatures.GetUnchecked();
         if (params.GetTaskType() == ETaskType::CPU) {
+            quantizationOptions->GroupFeaturesForCpu = NeedToGroupFeaturesForCpu(params, metaInfo);
+            if (quantizationOptions->GroupFeaturesForCpu) {
+                CATBOOST_DEBUG_LOG << "Float features are stored in groups for leafwise scoring" << Endl;
+            }
 
             quantizationOptions->ExclusiveFeaturesBundlingOptions.MaxBuckets
                 = params.ObliviousTreeOptions->DevExclusiveFeaturesBundleMaxBuckets.Get();
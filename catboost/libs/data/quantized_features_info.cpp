@@ -272,39 +272,52 @@ namespace NCB {
     TPerfectHashedToHashedCatValuesMap TQuantizedFeaturesInfo::CalcPerfectHashedToHashedCatValuesMap(
         NPar::ILocalExecutor* localExecutor
     ) const {
-        // load once and then work with all features in parallel
-        LoadCatFeaturePerfectHashToRam();
+        /* perfect hashes in RAM are processed in parallel, otherwise features are loaded one by one,
+         * so only the largest perfect hash has to fit in RAM
+         */
+        const bool perfectHashInRam = CatFeaturesPerfectHash.IsInRam();
 
         const auto& featuresLayout = *GetFeaturesLayout();
         TPerfectHashedToHashedCatValuesMap result(featuresLayout.GetCatFeatureCount());
 
-        localExecutor->ExecRangeWithThrow(
-            [&] (int catFeatureIdx) {
-                if (!featuresLayout.GetInternalFeatureMetaInfo(
-                        (ui32)catFeatureIdx,
-                        EFeatureType::Categorical
-                    ).IsAvailable)
-                {
-                    return;
-                }
+        const auto calcFeatureMap = [&] (int catFeatureIdx) {
+            if (!featuresLayout.GetInternalFeatureMetaInfo(
+                    (ui32)catFeatureIdx,
+                    EFeatureType::Categorical
+                ).IsAvailable)
+            {
+                return;
+            }
 
-                const auto& catFeaturePerfectHash = GetCategoricalFeaturesPerfectHash(
-                    TCatFeatureIdx((ui32)catFeatureIdx)
-                );
-                auto& perFeatureResult = result[catFeatureIdx];
-                perFeatureResult.yresize(catFeaturePerfectHash.GetSize());
-                if (catFeaturePerfectHash.DefaultMap) {
-                    perFeatureResult[catFeaturePerfectHash.DefaultMap->DstValueWithCount.Value]
-                        = catFeaturePerfectHash.DefaultMap->SrcValue;
-                }
-                for (const auto [hashedCatValue, perfectHash] : catFeaturePerfectHash.Map) {
-                    perFeatureResult[perfectHash.Value] = hashedCatValue;
-                }
-            },
-            0,
-            SafeIntegerCast<int>(featuresLayout.GetCatFeatureCount()),
-            NPar::TLocalExecutor::WAIT_COMPLETE
-        );
+            const auto& catFeaturePerfectHash = GetCategoricalFeaturesPerfectHash(
+                TCatFeatureIdx((ui32)catFeatureIdx)
+            );
+            auto& perFeatureResult = result[catFeatureIdx];
+            perFeatureResult.yresize(catFeaturePerfectHash.GetSize());
+            if (catFeaturePerfectHash.DefaultMap) {
+                perFeatureResult[catFeaturePerfectHash.DefaultMap->DstValueWithCount.Value]
+                    = catFeaturePerfectHash.DefaultMap->SrcValue;
+            }
+            for (const auto [hashedCatValue, perfectHash] : catFeaturePerfectHash.Map) {
+                perFeatureResult[perfectHash.Value] = hashedCatValue;
+            }
+            if (!perfectHashInRam) {
+                CatFeaturesPerfectHash.FreeFeatureRam(TCatFeatureIdx((ui32)catFeatureIdx));
+            }
+        };
+
+        if (perfectHashInRam) {
+            localExecutor->ExecRangeWithThrow(
+                calcFeatureMap,
+                0,
+                SafeIntegerCast<int>(featuresLayout.GetCatFeatureCount()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        } else {
+            for (auto catFeatureIdx : xrange(SafeIntegerCast<int>(featuresLayout.GetCatFeatureCount()))) {
+                calcFeatureMap(catFeatureIdx);
+            }
+        }
 
         return result;
     }
@@ -0,0 +1,532 @@
+#include "raw_dataset_cache.h"
+
+#include "meta_info.h"
+#include "objects.h"
+#include "pairs.h"
+#include "target.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/polymorphic_type_containers.h>
+#include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/private/libs/data_types/groupid.h>
+#include <catboost/private/libs/data_types/pair.h>
+#include <catboost/private/libs/data_util/exists_checker.h>
+#include <catboost/private/libs/data_util/shards.h>
+
+#include <library/cpp/binsaver/bin_saver.h>
+#include <library/cpp/binsaver/util_stream_io.h>
+#include <library/cpp/json/json_writer.h>
+#include <library/cpp/object_factory/object_factory.h>
+
+#include <util/digest/murmur.h>
+#include <util/folder/path.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/stream/mem.h>
+#include <util/stream/str.h>
+#include <util/string/hex.h>
+#include <util/system/align.h>
+#include <util/system/fs.h>
+#include <util/system/unaligned_mem.h>
+
+#include <variant>
+
+
+namespace NCB {
+
+    // change the last character if the layout of the file or of the header changes
+    static constexpr TStringBuf RawDatasetCacheMagic = "CBRAWDS1";
+
+    static constexpr ui64 ColumnAlignment = 64;
+
+    static constexpr size_t FileHashBlockSize = 1 << 20;
+
+
+    // array of values in the data part of the cache file
+    struct TRawDatasetCacheColumnBlock {
+        ui64 Offset = 0; // from the beginning of the data part
+        ui64 Size = 0; // in bytes
+
+    public:
+        SAVELOAD(Offset, Size);
+    };
+
+    struct TRawDatasetCacheHeader {
+        TDataMetaInfo MetaInfo;
+        bool ForceUnitAutoPairWeights = false; // is not serialized with MetaInfo
+        ui32 ObjectCount = 0;
+        EObjectsOrder Order = EObjectsOrder::Undefined;
+
+        TVector<TMaybe<TRawDatasetCacheColumnBlock>> FloatFeatures; // [floatFeatureIdx], Nothing() for unavailable features
+        TVector<TMaybe<TRawDatasetCacheColumnBlock>> CatFeatures; // [catFeatureIdx], Nothing() for unavailable features
+        TVector<THashMap<ui32, TString>> CatFeaturesHashToString; // [catFeatureIdx]
+        TVector<TMaybe<TVector<TString>>> TextFeatures; // [textFeatureIdx], Nothing() for unavailable features
+
+        TVector<TRawDatasetCacheColumnBlock> NumericTargets; // [targetIdx]
+        TVector<TVector<TString>> StringTargets; // [targetIdx]
+        TVector<TVector<float>> Baseline; // [approxIdx][objectIdx]
+        TVector<float> Weights; // empty if trivial
+        TVector<float> GroupWeights; // empty if trivial
+
+        TMaybe<TVector<TGroupId>> GroupIds;
+        TMaybe<TVector<TString>> StringGroupIds;
+        TMaybe<TVector<TSubgroupId>> SubgroupIds;
+        TMaybe<TVector<TString>> StringSubgroupIds;
+        TMaybe<TVector<TString>> SampleIds;
+        TMaybe<TVector<ui64>> Timestamps;
+
+        TMaybe<TFlatPairsInfo> FlatPairs;
+
+        // TPairInGroup has no binsaver serialization, so grouped pairs are stored by fields
+        TMaybe<TVector<ui32>> GroupedPairsIndices; // GroupIdx, WinnerIdxInGroup, LoserIdxInGroup for each pair
+        TVector<float> GroupedPairsWeights;
+
+    public:
+        int operator&(IBinSaver& binSaver) {
+            AddWithShared(&binSaver, &MetaInfo);
+            binSaver.AddMulti(
+                ForceUnitAutoPairWeights,
+                ObjectCount,
+                Order,
+                FloatFeatures,
+                CatFeatures,
+                CatFeaturesHashToString,
+                TextFeatures,
+                NumericTargets,
+                StringTargets,
+                Baseline,
+                Weights,
+                GroupWeights,
+                GroupIds,
+                StringGroupIds,
+                SubgroupIds,
+                StringSubgroupIds,
+                SampleIds,
+                Timestamps,
+                FlatPairs,
+                GroupedPairsIndices,
+                GroupedPairsWeights
+            );
+            return 0;
+        }
+    };
+
+
+    static ui64 UpdateHash(ui64 hash, TStringBuf data) {
+        // size is hashed too to make the hash of a sequence of strings unambiguous
+        const ui64 size = data.size();
+        hash = MurmurHash<ui64>(&size, sizeof(size), hash);
+        return MurmurHash<ui64>(data.data(), data.size(), hash);
+    }
+
+    template <class T>
+    static ui64 UpdateHashWithValue(ui64 hash, T value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value);
+        return MurmurHash<ui64>(&value, sizeof(value), hash);
+    }
+
+    static ui64 UpdateHashWithFileContent(ui64 hash, const TString& path) {
+        TFileInput input(path);
+        TVector<char> buffer;
+        buffer.yresize(FileHashBlockSize);
+        ui64 size = 0;
+        while (const size_t blockSize = input.Load(buffer.data(), buffer.size())) {
+            hash = MurmurHash<ui64>(buffer.data(), blockSize, hash);
+            size += blockSize;
+        }
+        return UpdateHashWithValue(hash, size);
+    }
+
+    TMaybe<TString> GetRawDatasetCacheFilePath(
+        const TString& cacheDir,
+        const TPathWithScheme& poolPath,
+        TConstArrayRef<TPathWithScheme> auxiliaryFilePaths,
+        const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        bool forceUnitAutoPairWeights,
+        TConstArrayRef<NJson::TJsonValue> classLabels
+    ) {
+        if ((poolPath.Scheme != "dsv") && (poolPath.Scheme != "libsvm")) {
+            return Nothing();
+        }
+
+        TVector<TPathWithScheme> filePaths;
+        if (IsShardedPath(poolPath)) {
+            filePaths = GetShardPaths(poolPath, columnarPoolFormatParams.ShardsShuffleSeed);
+        } else {
+            filePaths.push_back(poolPath);
+        }
+        filePaths.push_back(columnarPoolFormatParams.CdFilePath);
+        filePaths.insert(filePaths.end(), auxiliaryFilePaths.begin(), auxiliaryFilePaths.end());
+
+        ui64 hash = UpdateHash(0, RawDatasetCacheMagic);
+        for (const auto& filePath : filePaths) {
+            hash = UpdateHashWithValue(hash, filePath.Inited());
+            if (!filePath.Inited()) {
+                continue;
+            }
+            if (!TFsPath(filePath.Path).IsFile()) {
+                return Nothing();
+            }
+            hash = UpdateHash(hash, filePath.Scheme);
+            hash = UpdateHashWithFileContent(hash, filePath.Path);
+        }
+
+        const auto& dsvFormat = columnarPoolFormatParams.DsvFormat;
+        hash = UpdateHashWithValue(hash, dsvFormat.HasHeader);
+        hash = UpdateHashWithValue(hash, dsvFormat.Delimiter);
+        hash = UpdateHashWithValue(hash, dsvFormat.NumVectorDelimiter);
+        hash = UpdateHashWithValue(hash, dsvFormat.IgnoreCsvQuoting);
+
+        hash = UpdateHashWithValue(hash, ignoredFeatures.size());
+        for (auto ignoredFeature : ignoredFeatures) {
+            hash = UpdateHashWithValue(hash, ignoredFeature);
+        }
+        hash = UpdateHashWithValue(hash, objectsOrder);
+        hash = UpdateHashWithValue(hash, forceUnitAutoPairWeights);
+        hash = UpdateHashWithValue(hash, classLabels.size());
+        for (const auto& classLabel : classLabels) {
+            hash = UpdateHash(hash, NJson::WriteJson(&classLabel, /*formatOutput*/ false));
+        }
+
+        return (TFsPath(cacheDir) / (to_lower(HexEncode(&hash, sizeof(hash))) + ".cbraw")).GetPath();
+    }
+
+
+    static void WritePadding(ui64 size, IOutputStream* output) {
+        static const char zeros[ColumnAlignment] = {};
+        while (size) {
+            const ui64 partSize = Min(size, ColumnAlignment);
+            output->Write(zeros, partSize);
+            size -= partSize;
+        }
+    }
+
+    void SaveRawDatasetCache(
+        const TDataProvider& dataProvider,
+        const TString& filePath,
+        NPar::ILocalExecutor* localExecutor
+    ) {
+        const auto* objectsData = dynamic_cast<const TRawObjectsDataProvider*>(dataProvider.ObjectsData.Get());
+        CB_ENSURE(objectsData, "Only datasets with raw objects data can be saved to raw dataset cache");
+
+        const auto& featuresLayout = *dataProvider.MetaInfo.FeaturesLayout;
+        CB_ENSURE(
+            featuresLayout.GetEmbeddingFeatureCount() == 0,
+            "Datasets with embedding features can't be saved to raw dataset cache"
+        );
+
+        const TRawTargetDataProvider& rawTargetData = dataProvider.RawTargetData;
+
+        TRawDatasetCacheHeader header;
+        header.MetaInfo = dataProvider.MetaInfo;
+        header.ForceUnitAutoPairWeights = dataProvider.MetaInfo.ForceUnitAutoPairWeights;
+        header.ObjectCount = objectsData->GetObjectCount();
+        header.Order = objectsData->GetOrder();
+
+        // all columns have objectCount elements of 4 bytes so data part layout is known before extracting them
+        ui64 dataSize = 0;
+        auto addColumnBlock = [&] () {
+            TRawDatasetCacheColumnBlock block;
+            block.Offset = AlignUp(dataSize, ColumnAlignment);
+            block.Size = sizeof(ui32) * header.ObjectCount;
+            dataSize = block.Offset + block.Size;
+            return block;
+        };
+
+        header.FloatFeatures.resize(featuresLayout.GetFloatFeatureCount());
+        for (auto floatFeatureIdx : xrange(featuresLayout.GetFloatFeatureCount())) {
+            if (objectsData->GetFloatFeature(floatFeatureIdx)) {
+                header.FloatFeatures[floatFeatureIdx] = addColumnBlock();
+            }
+        }
+
+        header.CatFeatures.resize(featuresLayout.GetCatFeatureCount());
+        header.CatFeaturesHashToString.resize(featuresLayout.GetCatFeatureCount());
+        for (auto catFeatureIdx : xrange(featuresLayout.GetCatFeatureCount())) {
+            if (objectsData->GetCatFeature(catFeatureIdx)) {
+                header.CatFeatures[catFeatureIdx] = addColumnBlock();
+                header.CatFeaturesHashToString[catFeatureIdx] = objectsData->GetCatFeaturesHashToString(catFeatureIdx);
+            }
+        }
+
+        header.TextFeatures.resize(featuresLayout.GetTextFeatureCount());
+        for (auto textFeatureIdx : xrange(featuresLayout.GetTextFeatureCount())) {
+            if (const auto textFeature = objectsData->GetTextFeature(textFeatureIdx)) {
+                const auto values = (*textFeature)->ExtractValues(localExecutor);
+                header.TextFeatures[textFeatureIdx] = TVector<TString>(values.begin(), values.end());
+            }
+        }
+
+        TVector<ITypedSequencePtr<float>> numericTargets;
+        if (const auto target = rawTargetData.GetTarget()) {
+            for (const auto& oneTarget : *target) {
+                if (const auto* numericTarget = std::get_if<ITypedSequencePtr<float>>(&oneTarget)) {
+                    header.NumericTargets.push_back(addColumnBlock());
+                    numericTargets.push_back(*numericTarget);
+                } else {
+                    header.StringTargets.push_back(std::get<TVector<TString>>(oneTarget));
+                }
+            }
+        }
+        CB_ENSURE_INTERNAL(
+            header.NumericTargets.empty() || header.StringTargets.empty(),
+            "Targets of both numeric and string types"
+        );
+
+        if (const auto baseline = rawTargetData.GetBaseline()) {
+            for (auto approx : *baseline) {
+                header.Baseline.emplace_back(approx.begin(), approx.end());
+            }
+        }
+        if (!rawTargetData.GetWeights().IsTrivial()) {
+            Assign(rawTargetData.GetWeights().GetNonTrivialData(), &header.Weights);
+        }
+        if (!rawTargetData.GetGroupWeights().IsTrivial()) {
+            Assign(rawTargetData.GetGroupWeights().GetNonTrivialData(), &header.GroupWeights);
+        }
+
+        auto copyMaybeData = [] (auto maybeData, auto* dst) {
+            if (maybeData) {
+                dst->ConstructInPlace(maybeData->begin(), maybeData->end());
+            }
+        };
+        copyMaybeData(objectsData->GetGroupIds(), &header.GroupIds);
+        copyMaybeData(objectsData->GetStringGroupIds(), &header.StringGroupIds);
+        copyMaybeData(objectsData->GetSubgroupIds(), &header.SubgroupIds);
+        copyMaybeData(objectsData->GetStringSubgroupIds(), &header.StringSubgroupIds);
+        copyMaybeData(objectsData->GetSampleIds(), &header.SampleIds);
+        copyMaybeData(objectsData->GetTimestamp(), &header.Timestamps);
+
+        if (const auto& pairs = rawTargetData.GetPairs()) {
+            if (const auto* flatPairs = std::get_if<TFlatPairsInfo>(&*pairs)) {
+                header.FlatPairs = *flatPairs;
+            } else {
+                const auto& groupedPairs = std::get<TGroupedPairsInfo>(*pairs);
+                header.GroupedPairsIndices.ConstructInPlace();
+                header.GroupedPairsIndices->reserve(groupedPairs.size() * 3);
+                header.GroupedPairsWeights.reserve(groupedPairs.size());
+                for (const auto& pair : groupedPairs) {
+                    header.GroupedPairsIndices->push_back(pair.GroupIdx);
+                    header.GroupedPairsIndices->push_back(pair.WinnerIdxInGroup);
+                    header.GroupedPairsIndices->push_back(pair.LoserIdxInGroup);
+                    header.GroupedPairsWeights.push_back(pair.Weight);
+                }
+            }
+        }
+
+        TString headerData;
+        {
+            TStringOutput headerOutput(headerData);
+            SerializeToArcadiaStream(headerOutput, header);
+        }
+
+        const TString tmpFilePath = filePath + ".tmp";
+        try {
+            TFileOutput output(tmpFilePath);
+            output.Write(RawDatasetCacheMagic.data(), RawDatasetCacheMagic.size());
+            const ui64 headerSize = headerData.size();
+            output.Write(&headerSize, sizeof(headerSize));
+            output.Write(headerData.data(), headerData.size());
+
+            ui64 position = RawDatasetCacheMagic.size() + sizeof(headerSize) + headerSize;
+            const ui64 dataOffset = AlignUp(position, ColumnAlignment);
+            auto writeColumn = [&] (const TRawDatasetCacheColumnBlock& block, TConstArrayRef<char> data) {
+                CB_ENSURE_INTERNAL(data.size() == block.Size, "Unexpected raw dataset cache column size");
+                WritePadding(dataOffset + block.Offset - position, &output);
+                output.Write(data.data(), data.size());
+                position = dataOffset + block.Offset + block.Size;
+            };
+
+            // the same order as in the layout of the data part
+            for (auto floatFeatureIdx : xrange(header.FloatFeatures.size())) {
+                if (header.FloatFeatures[floatFeatureIdx]) {
+                    const auto values = (*objectsData->GetFloatFeature(floatFeatureIdx))->ExtractValues(localExecutor);
+                    writeColumn(*header.FloatFeatures[floatFeatureIdx], as_bytes(*values));
+                }
+            }
+            for (auto catFeatureIdx : xrange(header.CatFeatures.size())) {
+                if (header.CatFeatures[catFeatureIdx]) {
+                    const auto values = (*objectsData->GetCatFeature(catFeatureIdx))->ExtractValues(localExecutor);
+                    writeColumn(*header.CatFeatures[catFeatureIdx], as_bytes(*values));
+                }
+            }
+            for (auto targetIdx : xrange(numericTargets.size())) {
+                const TVector<float> values = ToVector(*numericTargets[targetIdx]);
+                writeColumn(header.NumericTargets[targetIdx], as_bytes(MakeArrayRef(values)));
+            }
+            output.Finish();
+        } catch (...) {
+            NFs::Remove(tmpFilePath);
+            throw;
+        }
+        CB_ENSURE(NFs::Rename(tmpFilePath, filePath), "Failed to rename " << tmpFilePath << " to " << filePath);
+    }
+
+
+    template <class T>
+    static TMaybeOwningConstArrayHolder<T> GetColumn(
+        const TBlob& file,
+        ui64 dataOffset,
+        const TRawDatasetCacheColumnBlock& block,
+        TIntrusivePtr<IResourceHolder> fileHolder
+    ) {
+        CB_ENSURE(
+            (block.Size % sizeof(T) == 0) && (dataOffset + block.Offset + block.Size <= file.Size()),
+            "Raw dataset cache: column is out of the file bounds"
+        );
+        return TMaybeOwningConstArrayHolder<T>::CreateOwning(
+            TConstArrayRef<T>(
+                reinterpret_cast<const T*>(file.AsCharPtr() + dataOffset + block.Offset),
+                block.Size / sizeof(T)
+            ),
+            std::move(fileHolder)
+        );
+    }
+
+    TRawDatasetCacheLoader::TRawDatasetCacheLoader(TDatasetLoaderPullArgs&& args)
+        : File(TBlob::FromFile(args.PoolPath.Path))
+        , FileHolder(MakeIntrusive<TVectorHolder<TBlob>>(TVector<TBlob>{File}))
+        , Header(MakeHolder<TRawDatasetCacheHeader>())
+    {
+        CB_ENSURE(
+            args.CommonArgs.DatasetSubset == TDatasetSubset::MakeColumns(),
+            "Raw dataset cache can be loaded only fully"
+        );
+
+        const ui64 prefixSize = RawDatasetCacheMagic.size() + sizeof(ui64);
+        CB_ENSURE(
+            (File.Size() >= prefixSize)
+                && (TStringBuf(File.AsCharPtr(), RawDatasetCacheMagic.size()) == RawDatasetCacheMagic),
+            args.PoolPath.Path << " is not a raw dataset cache file or has an unsupported version"
+        );
+        const ui64 headerSize = ReadUnaligned<ui64>(File.AsCharPtr() + RawDatasetCacheMagic.size());
+        CB_ENSURE(prefixSize + headerSize <= File.Size(), "Raw dataset cache: header is out of the file bounds");
+
+        TMemoryInput headerInput(File.AsCharPtr() + prefixSize, headerSize);
+        SerializeFromStream(headerInput, *Header);
+        Header->MetaInfo.ForceUnitAutoPairWeights = Header->ForceUnitAutoPairWeights;
+
+        DataOffset = AlignUp<ui64>(prefixSize + headerSize, ColumnAlignment);
+    }
+
+    TRawDatasetCacheLoader::~TRawDatasetCacheLoader() = default;
+
+    void TRawDatasetCacheLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        TRawDatasetCacheHeader& header = *Header;
+        const auto& featuresLayout = *header.MetaInfo.FeaturesLayout;
+
+        visitor->Start(header.MetaInfo, header.ObjectCount, header.Order, {FileHolder});
+
+        for (auto objectIdx : xrange(header.ObjectCount)) {
+            if (header.GroupIds) {
+                visitor->AddGroupId(objectIdx, (*header.GroupIds)[objectIdx]);
+            } else if (header.StringGroupIds) {
+                visitor->AddGroupId(objectIdx, (*header.StringGroupIds)[objectIdx]);
+            }
+            if (header.SubgroupIds) {
+                visitor->AddSubgroupId(objectIdx, (*header.SubgroupIds)[objectIdx]);
+            } else if (header.StringSubgroupIds) {
+                visitor->AddSubgroupId(objectIdx, (*header.StringSubgroupIds)[objectIdx]);
+            }
+            if (header.SampleIds) {
+                visitor->AddSampleId(objectIdx, (*header.SampleIds)[objectIdx]);
+            }
+        }
+        if (header.Timestamps) {
+            visitor->SetTimestamps(std::move(*header.Timestamps));
+        }
+
+        for (auto floatFeatureIdx : xrange(header.FloatFeatures.size())) {
+            if (const auto& block = header.FloatFeatures[floatFeatureIdx]) {
+                visitor->AddFloatFeature(
+                    featuresLayout.GetExternalFeatureIdx(floatFeatureIdx, EFeatureType::Float),
+                    MakeTypeCastArrayHolder<float, float>(GetColumn<float>(File, DataOffset, *block, FileHolder))
+                );
+            }
+        }
+
+        for (auto catFeatureIdx : xrange(header.CatFeatures.size())) {
+            if (const auto& block = header.CatFeatures[catFeatureIdx]) {
+                const ui32 flatFeatureIdx = featuresLayout.GetExternalFeatureIdx(
+                    catFeatureIdx,
+                    EFeatureType::Categorical
+                );
+
+                // values are hashed again but only once for each unique value
+                for (const auto& [hashedValue, value] : header.CatFeaturesHashToString[catFeatureIdx]) {
+                    CB_ENSURE(
+                        visitor->GetCatFeatureValue(flatFeatureIdx, value) == hashedValue,
+                        "Raw dataset cache: categorical feature values hashing has changed"
+                    );
+                }
+                visitor->AddCatFeature(flatFeatureIdx, GetColumn<ui32>(File, DataOffset, *block, FileHolder));
+            }
+        }
+
+        for (auto textFeatureIdx : xrange(header.TextFeatures.size())) {
+            if (auto& values = header.TextFeatures[textFeatureIdx]) {
+                visitor->AddTextFeature(
+                    featuresLayout.GetExternalFeatureIdx(textFeatureIdx, EFeatureType::Text),
+                    TMaybeOwningConstArrayHolder<TString>::CreateOwning(std::move(*values))
+                );
+            }
+        }
+
+        for (auto targetIdx : xrange(header.NumericTargets.size())) {
+            visitor->AddTarget(
+                targetIdx,
+                MakeTypeCastArrayHolder<float, float>(
+                    GetColumn<float>(File, DataOffset, header.NumericTargets[targetIdx], FileHolder)
+                )
+            );
+        }
+        for (auto targetIdx : xrange(header.StringTargets.size())) {
+            visitor->AddTarget(targetIdx, header.StringTargets[targetIdx]);
+        }
+
+        if (!header.Baseline.empty()) {
+            visitor->SetBaseline(std::move(header.Baseline));
+        }
+        if (!header.Weights.empty()) {
+            visitor->AddWeights(header.Weights);
+        }
+        if (!header.GroupWeights.empty()) {
+            visitor->SetGroupWeights(std::move(header.GroupWeights));
+        }
+
+        if (header.FlatPairs) {
+            visitor->SetPairs(TRawPairsData(std::move(*header.FlatPairs)));
+        } else if (header.GroupedPairsIndices) {
+            const auto& indices = *header.GroupedPairsIndices;
+            CB_ENSURE(
+                indices.size() == 3 * header.GroupedPairsWeights.size(),
+                "Raw dataset cache: inconsistent grouped pairs data"
+            );
+            TGroupedPairsInfo groupedPairs;
+            groupedPairs.reserve(header.GroupedPairsWeights.size());
+            for (auto pairIdx : xrange(header.GroupedPairsWeights.size())) {
+                groupedPairs.push_back(
+                    TPairInGroup{
+                        indices[3 * pairIdx],
+                        indices[3 * pairIdx + 1],
+                        indices[3 * pairIdx + 2],
+                        header.GroupedPairsWeights[pairIdx]
+                    }
+                );
+            }
+            visitor->SetPairs(TRawPairsData(std::move(groupedPairs)));
+        }
+
+        visitor->Finish();
+    }
+
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> RawDatasetCacheExistsCheckerReg("raw-cache");
+        TDatasetLoaderFactory::TRegistrator<TRawDatasetCacheLoader> RawDatasetCacheLoaderReg("raw-cache");
+    }
+}
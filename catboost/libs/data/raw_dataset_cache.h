@@ -0,0 +1,75 @@
+#pragma once
+
+#include "data_provider.h"
+#include "loader.h"
+#include "order.h"
+
+#include <catboost/libs/helpers/resource_holder.h>
+#include <catboost/private/libs/data_util/path_with_scheme.h>
+#include <catboost/private/libs/options/load_options.h>
+
+#include <library/cpp/json/json_value.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Raw dataset cache is a columnar binary dump of a raw dataset that is much faster to load than
+     *  the original text dataset. It is created by ReadDataset on the first load of a local dsv or libsvm
+     *  dataset if columnarPoolFormatParams.RawDatasetCacheDir is specified and loaded instead of the dataset
+     *  on subsequent runs.
+     * Numeric features, numeric targets and hashed categorical features are stored as aligned arrays used
+     *  directly from the memory mapped cache file, other data is serialized in the file header.
+     * Datasets with embedding features are not supported.
+     */
+
+    /*
+     * File name of the cache in cacheDir for the dataset.
+     * It depends on contents of the dataset, column description and auxiliary files and on loading parameters.
+     * Returns Nothing() if the dataset can't be cached (it is not a local dsv or libsvm dataset)
+     */
+    TMaybe<TString> GetRawDatasetCacheFilePath(
+        const TString& cacheDir,
+        const TPathWithScheme& poolPath,
+        TConstArrayRef<TPathWithScheme> auxiliaryFilePaths, // some of them can be uninited
+        const NCatboostOptions::TColumnarPoolFormatParams& columnarPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        bool forceUnitAutoPairWeights,
+        TConstArrayRef<NJson::TJsonValue> classLabels
+    );
+
+    // dataProvider must contain raw objects data, file is replaced atomically
+    void SaveRawDatasetCache(
+        const TDataProvider& dataProvider,
+        const TString& filePath,
+        NPar::ILocalExecutor* localExecutor
+    );
+
+
+    struct TRawDatasetCacheHeader;
+
+    // Loader for raw dataset cache files (scheme "raw-cache"), loading parameters are taken from the cache.
+    class TRawDatasetCacheLoader : public IRawFeaturesOrderDatasetLoader {
+    public:
+        explicit TRawDatasetCacheLoader(TDatasetLoaderPullArgs&& args);
+        ~TRawDatasetCacheLoader();
+
+        void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+    private:
+        TBlob File;
+        TIntrusivePtr<IResourceHolder> FileHolder;
+        THolder<TRawDatasetCacheHeader> Header;
+        ui64 DataOffset = 0;
+    };
+}
@@ -0,0 +1,227 @@
+#include <catboost/libs/data/arrow_c_data_import.h>
+#include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/data/objects.h>
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/system/unaligned_mem.h>
+
+#include <cmath>
+
+
+using namespace NCB;
+
+
+namespace {
+    // buffers and descriptions of arrays are kept here, release only marks the array as released
+    struct TTestArrowColumn {
+        TString Format;
+        TString Name;
+        TVector<const void*> Buffers;
+        ArrowSchema Schema;
+        ArrowArray Array;
+
+        THolder<TTestArrowColumn> Dictionary;
+    };
+
+    struct TTestArrowRecordBatch {
+        TVector<THolder<TTestArrowColumn>> Columns;
+        TVector<ArrowSchema*> SchemaChildren;
+        TVector<ArrowArray*> ArrayChildren;
+        TVector<const void*> Buffers = {nullptr};
+        ArrowSchema Schema;
+        ArrowArray Array;
+        int ReleaseCount = 0;
+    };
+}
+
+static void ReleaseTestSchema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+
+static void ReleaseTestArray(ArrowArray* array) {
+    if (array->private_data) {
+        ++static_cast<TTestArrowRecordBatch*>(array->private_data)->ReleaseCount;
+    }
+    array->release = nullptr;
+}
+
+static void InitTestColumn(i64 length, i64 nullCount, TTestArrowColumn* column) {
+    column->Schema = ArrowSchema{
+        column->Format.data(),
+        column->Name.data(),
+        nullptr,
+        ARROW_FLAG_NULLABLE,
+        0,
+        nullptr,
+        column->Dictionary ? &column->Dictionary->Schema : nullptr,
+        ReleaseTestSchema,
+        nullptr
+    };
+    column->Array = ArrowArray{
+        length,
+        nullCount,
+        0,
+        (i64)column->Buffers.size(),
+        0,
+        column->Buffers.data(),
+        nullptr,
+        column->Dictionary ? &column->Dictionary->Array : nullptr,
+        ReleaseTestArray,
+        nullptr
+    };
+}
+
+static THolder<TTestArrowColumn> MakeTestColumn(
+    const TString& format,
+    const TString& name,
+    i64 length,
+    i64 nullCount,
+    TVector<const void*> buffers
+) {
+    auto column = MakeHolder<TTestArrowColumn>();
+    column->Format = format;
+    column->Name = name;
+    column->Buffers = std::move(buffers);
+    InitTestColumn(length, nullCount, column.Get());
+    return column;
+}
+
+static void InitTestRecordBatch(i64 length, i64 offset, TTestArrowRecordBatch* batch) {
+    for (auto& column : batch->Columns) {
+        batch->SchemaChildren.push_back(&column->Schema);
+        batch->ArrayChildren.push_back(&column->Array);
+    }
+    batch->Schema = ArrowSchema{
+        "+s",
+        "",
+        nullptr,
+        0,
+        (i64)batch->Columns.size(),
+        batch->SchemaChildren.data(),
+        nullptr,
+        ReleaseTestSchema,
+        nullptr
+    };
+    batch->Array = ArrowArray{
+        length,
+        0,
+        offset,
+        (i64)batch->Buffers.size(),
+        (i64)batch->Columns.size(),
+        batch->Buffers.data(),
+        batch->ArrayChildren.data(),
+        nullptr,
+        ReleaseTestArray,
+        batch
+    };
+}
+
+
+Y_UNIT_TEST_SUITE(ArrowCDataImport) {
+    Y_UNIT_TEST(ReadColumns) {
+        const float floatValues[] = {0.5f, 1.0f, -2.0f, 3.5f};
+        const i32 intValues[] = {1, 2, 0, 4};
+        const ui8 intValidity[] = {0b1011}; // third value is null
+        const i32 stringOffsets[] = {0, 1, 3, 3, 6};
+        const char stringData[] = "abbccc";
+        const i8 dictionaryIndices[] = {1, 0, 1, 1};
+        const i32 dictionaryOffsets[] = {0, 3, 7};
+        const char dictionaryData[] = "redblue";
+
+        TTestArrowRecordBatch batch;
+        batch.Columns.push_back(MakeTestColumn("f", "f32", 4, 0, {nullptr, floatValues}));
+        batch.Columns.push_back(MakeTestColumn("i", "i32", 4, 1, {intValidity, intValues}));
+        batch.Columns.push_back(MakeTestColumn("u", "str", 4, 0, {nullptr, stringOffsets, stringData}));
+        {
+            auto column = MakeHolder<TTestArrowColumn>();
+            column->Format = "c";
+            column->Name = "dict";
+            column->Buffers = {nullptr, dictionaryIndices};
+            column->Dictionary = MakeTestColumn("u", "", 2, 0, {nullptr, dictionaryOffsets, dictionaryData});
+            InitTestColumn(4, 0, column.Get());
+            batch.Columns.push_back(std::move(column));
+        }
+        InitTestRecordBatch(4, 0, &batch);
+
+        {
+            TArrowCDataRecordBatch recordBatch(batch.Schema, &batch.Array);
+            UNIT_ASSERT(!batch.Array.release);
+            UNIT_ASSERT_VALUES_EQUAL(recordBatch.GetRowCount(), 4);
+            UNIT_ASSERT_VALUES_EQUAL(recordBatch.GetFields().size(), 4);
+            UNIT_ASSERT_VALUES_EQUAL(recordBatch.GetFields()[3].Name, "dict");
+            UNIT_ASSERT(recordBatch.GetFields()[3].DictionaryId);
+            UNIT_ASSERT_VALUES_EQUAL(recordBatch.GetArray(1).NullCount, 1);
+
+            const auto featuresLayout = recordBatch.CreateFeaturesLayout();
+            UNIT_ASSERT_VALUES_EQUAL(featuresLayout->GetFloatFeatureCount(), 2);
+            UNIT_ASSERT_VALUES_EQUAL(featuresLayout->GetCatFeatureCount(), 2);
+            UNIT_ASSERT_VALUES_EQUAL(featuresLayout->GetExternalFeatureIds()[2], "str");
+
+            TDataMetaInfo metaInfo;
+            metaInfo.FeaturesLayout = featuresLayout;
+            auto dataProvider = CreateDataProvider(
+                [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                    visitor->Start(metaInfo, 4, EObjectsOrder::Undefined, {recordBatch.GetResourceHolder()});
+                    recordBatch.AddFeatures(*featuresLayout, visitor);
+                    visitor->Finish();
+                }
+            );
+            auto* objectsData = dynamic_cast<TRawObjectsDataProvider*>(dataProvider->ObjectsData.Get());
+            UNIT_ASSERT(objectsData);
+
+            NPar::TLocalExecutor localExecutor;
+            const auto floatFeature = (*objectsData->GetFloatFeature(0))->ExtractValues(&localExecutor);
+            for (auto idx : xrange(4)) {
+                UNIT_ASSERT_VALUES_EQUAL((*floatFeature)[idx], floatValues[idx]);
+            }
+            const auto intFeature = (*objectsData->GetFloatFeature(1))->ExtractValues(&localExecutor);
+            UNIT_ASSERT_VALUES_EQUAL((*intFeature)[3], 4.0f);
+            UNIT_ASSERT(std::isnan((*intFeature)[2]));
+
+            const auto stringFeature = (*objectsData->GetCatFeature(0))->ExtractValues(&localExecutor);
+            UNIT_ASSERT_VALUES_EQUAL((*stringFeature)[1], CalcCatFeatureHash(TStringBuf("bb")));
+            UNIT_ASSERT_VALUES_EQUAL((*stringFeature)[2], CalcCatFeatureHash(TStringBuf()));
+            const auto dictionaryFeature = (*objectsData->GetCatFeature(1))->ExtractValues(&localExecutor);
+            UNIT_ASSERT_VALUES_EQUAL((*dictionaryFeature)[0], CalcCatFeatureHash(TStringBuf("blue")));
+            UNIT_ASSERT_VALUES_EQUAL((*dictionaryFeature)[1], CalcCatFeatureHash(TStringBuf("red")));
+        }
+        UNIT_ASSERT_VALUES_EQUAL(batch.ReleaseCount, 1);
+    }
+
+    Y_UNIT_TEST(ReadSlicedColumns) {
+        const double values[] = {0., 1., 2., 3., 4., 5., 6., 7., 8., 9., 10., 11.};
+        const ui8 validity[] = {0xFF, 0b11111101}; // value 9 is null
+
+        TTestArrowRecordBatch batch;
+        batch.Columns.push_back(MakeTestColumn("g", "g", 12, 1, {validity, values}));
+        batch.Columns.back()->Array.offset = 2;
+        batch.Columns.back()->Array.length = 10;
+        InitTestRecordBatch(5, 3, &batch);
+
+        TArrowCDataRecordBatch recordBatch(batch.Schema, &batch.Array);
+        const TArrowArray& array = recordBatch.GetArray(0);
+        UNIT_ASSERT_VALUES_EQUAL(array.Length, 5);
+        UNIT_ASSERT_VALUES_EQUAL(array.NullCount, 1);
+        for (auto idx : xrange(5)) {
+            UNIT_ASSERT_VALUES_EQUAL(array.IsValid(idx), idx != 4);
+            UNIT_ASSERT_VALUES_EQUAL(ReadUnaligned<double>(array.Values.data() + idx * sizeof(double)), 5. + idx);
+        }
+    }
+
+    Y_UNIT_TEST(UnsupportedFormat) {
+        const ui8 values[] = {1, 2};
+
+        TTestArrowRecordBatch batch;
+        batch.Columns.push_back(MakeTestColumn("e", "half", 2, 0, {nullptr, values}));
+        InitTestRecordBatch(2, 0, &batch);
+
+        UNIT_ASSERT_EXCEPTION(TArrowCDataRecordBatch(batch.Schema, &batch.Array), TCatBoostException);
+        UNIT_ASSERT_VALUES_EQUAL(batch.ReleaseCount, 1);
+    }
+}
@@ -0,0 +1,61 @@
+#include <catboost/libs/data/cat_feature_perfect_hash.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+
+
+using namespace NCB;
+
+
+static TCatFeaturePerfectHash MakeFeaturePerfectHash(ui32 valueCount, ui32 seed) {
+    TCatFeaturePerfectHash perfectHash;
+    perfectHash.DefaultMap = TCatFeaturePerfectHashDefaultValue{seed, TValueWithCount{0, 10}, 0.5f};
+    for (ui32 value = 1; value < valueCount; ++value) {
+        perfectHash.Map.emplace(seed + value * 7, TValueWithCount{value, value});
+    }
+    return perfectHash;
+}
+
+Y_UNIT_TEST_SUITE(TCatFeaturesPerfectHash) {
+    Y_UNIT_TEST(FreeRamAndLoadFeatures) {
+        TTempDir tmpDir;
+
+        TVector<TCatFeaturePerfectHash> expectedPerfectHashes;
+        TCatFeaturesPerfectHash perfectHash(3);
+        for (ui32 catFeatureIdx : xrange(3)) {
+            expectedPerfectHashes.push_back(MakeFeaturePerfectHash(10 * (catFeatureIdx + 1), catFeatureIdx));
+            perfectHash.UpdateFeaturePerfectHash(
+                TCatFeatureIdx(catFeatureIdx),
+                MakeFeaturePerfectHash(10 * (catFeatureIdx + 1), catFeatureIdx));
+        }
+
+        perfectHash.FreeRam(tmpDir.Name());
+        UNIT_ASSERT(!perfectHash.IsInRam());
+
+        // features are loaded and freed one by one
+        for (ui32 catFeatureIdx : xrange(3)) {
+            UNIT_ASSERT_EQUAL(
+                perfectHash.GetFeaturePerfectHash(TCatFeatureIdx(catFeatureIdx)),
+                expectedPerfectHashes[catFeatureIdx]);
+            UNIT_ASSERT_VALUES_EQUAL(
+                perfectHash.GetUniqueValuesCounts(TCatFeatureIdx(catFeatureIdx)).OnAll,
+                10 * (catFeatureIdx + 1));
+            perfectHash.FreeFeatureRam(TCatFeatureIdx(catFeatureIdx));
+        }
+
+        // updated features are saved again
+        expectedPerfectHashes[1] = MakeFeaturePerfectHash(25, 1);
+        perfectHash.UpdateFeaturePerfectHash(TCatFeatureIdx(1), MakeFeaturePerfectHash(25, 1));
+        perfectHash.FreeRam(tmpDir.Name());
+
+        perfectHash.Load();
+        UNIT_ASSERT(perfectHash.IsInRam());
+        for (ui32 catFeatureIdx : xrange(3)) {
+            UNIT_ASSERT_EQUAL(
+                perfectHash.GetFeaturePerfectHash(TCatFeatureIdx(catFeatureIdx)),
+                expectedPerfectHashes[catFeatureIdx]);
+        }
+    }
+}
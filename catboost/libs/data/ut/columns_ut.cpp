@@ -124,4 +124,39 @@ Y_UNIT_TEST_SUITE(Columns) {
             UNIT_ASSERT(Equal<ui8>(values, expectedFeatureValues[bitIdx]));
         }
     }
+
+    Y_UNIT_TEST(MakeEmbeddingsContiguous) {
+        const TVector<TVector<float>> srcEmbeddings = {{0.f, 1.f, 2.f}, {3.f, 4.f, 5.f}, {6.f, 7.f, 8.f}};
+
+        TVector<TConstEmbedding> embeddings;
+        for (const auto& embedding : srcEmbeddings) {
+            embeddings.push_back(TConstEmbedding::CreateOwning(TVector<float>(embedding)));
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        MakeEmbeddingsContiguous(embeddings, &localExecutor);
+        for (auto objectIdx : xrange(srcEmbeddings.size())) {
+            UNIT_ASSERT(Equal<float>(*embeddings[objectIdx], srcEmbeddings[objectIdx]));
+            UNIT_ASSERT_EQUAL(embeddings[objectIdx].data(), embeddings[0].data() + objectIdx * 3);
+        }
+
+        // non-owning views are not copied
+        TVector<float> externalData = {1.f, 2.f};
+        TVector<TConstEmbedding> externalEmbeddings = {TConstEmbedding::CreateNonOwning(externalData)};
+        MakeEmbeddingsContiguous(externalEmbeddings, &localExecutor);
+        UNIT_ASSERT_EQUAL(externalEmbeddings[0].data(), externalData.data());
+
+        const auto denseEmbeddings = MakeDenseEmbeddings(
+            TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>{0.f, 1.f, 2.f, 3.f, 4.f, 5.f}),
+            2
+        );
+        UNIT_ASSERT_VALUES_EQUAL(denseEmbeddings.size(), 3);
+        UNIT_ASSERT(Equal<float>(*denseEmbeddings[2], TVector<float>{4.f, 5.f}));
+        UNIT_ASSERT_EXCEPTION(
+            MakeDenseEmbeddings(TMaybeOwningConstArrayHolder<float>::CreateOwning(TVector<float>(5)), 2),
+            TCatBoostException
+        );
+    }
 }
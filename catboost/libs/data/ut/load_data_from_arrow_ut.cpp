@@ -0,0 +1,346 @@
+#include <catboost/libs/data/ut/lib/for_loader.h>
+
+#include <catboost/libs/data/arrow_loader.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <limits>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+namespace {
+    // minimal writer of Arrow IPC files, see format/File.fbs, format/Schema.fbs and format/Message.fbs
+    enum EArrowTypeType : ui8 {
+        Int = 2,
+        FloatingPoint = 3,
+        Utf8 = 5
+    };
+
+    struct TTestField {
+        TString Name;
+        EArrowTypeType TypeType;
+        i16 Precision = 1; // for FloatingPoint: SINGLE = 1, DOUBLE = 2
+        TMaybe<i64> DictionaryId; // indices are int32
+    };
+
+    struct TTestArray {
+        i64 Length = 0;
+        i64 NullCount = 0;
+        TString Validity;
+        TString Values;
+        TMaybe<TString> Data; // for strings
+    };
+
+    struct TTestBlock {
+        i64 Offset;
+        i32 MetaDataLength;
+        i32 Padding;
+        i64 BodyLength;
+    };
+
+    struct TTestFieldNode {
+        i64 Length;
+        i64 NullCount;
+    };
+
+    struct TTestBuffer {
+        i64 Offset;
+        i64 Length;
+    };
+}
+
+static flatbuffers::voffset_t VOffset(int fieldIdx) {
+    return flatbuffers::voffset_t(4 + 2 * fieldIdx);
+}
+
+static void AlignTo8(TString* data) {
+    data->resize(CeilDiv<size_t>(data->size(), 8) * 8, '\0');
+}
+
+template <class T>
+static TTestArray MakePrimitiveArray(const TVector<T>& values, const TVector<bool>& isValid = {}) {
+    TTestArray array;
+    array.Length = values.size();
+    array.Values = TString((const char*)values.data(), values.size() * sizeof(T));
+    if (!isValid.empty()) {
+        array.Validity = TString(CeilDiv<size_t>(values.size(), 8), '\0');
+        for (auto idx : xrange(isValid.size())) {
+            if (isValid[idx]) {
+                array.Validity[idx / 8] |= char(1 << (idx % 8));
+            } else {
+                ++array.NullCount;
+            }
+        }
+    }
+    return array;
+}
+
+static TTestArray MakeUtf8Array(const TVector<TString>& values) {
+    TVector<i32> offsets = {0};
+    TString data;
+    for (const auto& value : values) {
+        data += value;
+        offsets.push_back(data.size());
+    }
+    TTestArray array = MakePrimitiveArray(offsets);
+    array.Length = values.size();
+    array.Data = data;
+    return array;
+}
+
+static flatbuffers::Offset<flatbuffers::Table> BuildIntType(flatbuffers::FlatBufferBuilder* builder) {
+    const auto start = builder->StartTable();
+    builder->AddElement<i32>(VOffset(0), 32, 0);
+    builder->AddElement<ui8>(VOffset(1), 1, 0);
+    return builder->EndTable(start);
+}
+
+static flatbuffers::Offset<flatbuffers::Table> BuildField(
+    const TTestField& field,
+    flatbuffers::FlatBufferBuilder* builder
+) {
+    const auto name = builder->CreateString(field.Name.data(), field.Name.size());
+
+    flatbuffers::Offset<flatbuffers::Table> type;
+    if (field.TypeType == EArrowTypeType::Int) {
+        type = BuildIntType(builder);
+    } else {
+        const auto start = builder->StartTable();
+        if (field.TypeType == EArrowTypeType::FloatingPoint) {
+            builder->AddElement<i16>(VOffset(0), field.Precision, 0);
+        }
+        type = builder->EndTable(start);
+    }
+
+    flatbuffers::Offset<flatbuffers::Table> dictionary;
+    if (field.DictionaryId) {
+        const auto indexType = BuildIntType(builder);
+        const auto start = builder->StartTable();
+        builder->AddElement<i64>(VOffset(0), *field.DictionaryId, 0);
+        builder->AddOffset(VOffset(1), indexType);
+        dictionary = builder->EndTable(start);
+    }
+
+    const auto start = builder->StartTable();
+    builder->AddOffset(VOffset(0), name);
+    builder->AddElement<ui8>(VOffset(2), field.TypeType, 0);
+    builder->AddOffset(VOffset(3), type);
+    if (field.DictionaryId) {
+        builder->AddOffset(VOffset(4), dictionary);
+    }
+    return builder->EndTable(start);
+}
+
+static flatbuffers::Offset<flatbuffers::Table> BuildRecordBatch(
+    const TVector<TTestArray>& arrays,
+    flatbuffers::FlatBufferBuilder* builder,
+    TString* body
+) {
+    TVector<TTestFieldNode> nodes;
+    TVector<TTestBuffer> buffers;
+    auto addBuffer = [&] (const TString& data) {
+        buffers.push_back(TTestBuffer{(i64)body->size(), (i64)data.size()});
+        *body += data;
+        AlignTo8(body);
+    };
+    for (const auto& array : arrays) {
+        nodes.push_back(TTestFieldNode{array.Length, array.NullCount});
+        addBuffer(array.Validity);
+        addBuffer(array.Values);
+        if (array.Data) {
+            addBuffer(*array.Data);
+        }
+    }
+    const auto nodesOffset = builder->CreateVectorOfStructs(nodes.data(), nodes.size());
+    const auto buffersOffset = builder->CreateVectorOfStructs(buffers.data(), buffers.size());
+
+    const auto start = builder->StartTable();
+    builder->AddElement<i64>(VOffset(0), arrays[0].Length, 0);
+    builder->AddOffset(VOffset(1), nodesOffset);
+    builder->AddOffset(VOffset(2), buffersOffset);
+    return builder->EndTable(start);
+}
+
+// dictionaryId is defined for dictionary batches
+static TTestBlock WriteMessage(const TVector<TTestArray>& arrays, TMaybe<i64> dictionaryId, TString* file) {
+    flatbuffers::FlatBufferBuilder builder;
+    TString body;
+    auto header = BuildRecordBatch(arrays, &builder, &body);
+    if (dictionaryId) {
+        const auto start = builder.StartTable();
+        builder.AddElement<i64>(VOffset(0), *dictionaryId, 0);
+        builder.AddOffset(VOffset(1), header);
+        header = builder.EndTable(start);
+    }
+    const auto start = builder.StartTable();
+    builder.AddElement<i16>(VOffset(0), 4, 0); // V5
+    builder.AddElement<ui8>(VOffset(1), dictionaryId ? 2 : 3, 0);
+    builder.AddOffset(VOffset(2), header);
+    builder.AddElement<i64>(VOffset(3), body.size(), 0);
+    builder.Finish(flatbuffers::Offset<flatbuffers::Table>(builder.EndTable(start)));
+
+    TString metaData((const char*)builder.GetBufferPointer(), builder.GetSize());
+    AlignTo8(&metaData);
+    const i32 continuation = -1;
+    const i32 metaDataSize = metaData.size();
+
+    TTestBlock block{(i64)file->size(), (i32)(2 * sizeof(i32) + metaData.size()), 0, (i64)body.size()};
+    file->append((const char*)&continuation, sizeof(continuation));
+    file->append((const char*)&metaDataSize, sizeof(metaDataSize));
+    *file += metaData;
+    *file += body;
+    return block;
+}
+
+static TString WriteArrowFile(
+    const TVector<TTestField>& fields,
+    const TVector<std::pair<i64, TTestArray>>& dictionaries,
+    const TVector<TVector<TTestArray>>& recordBatches
+) {
+    TString file("ARROW1\0\0", 8);
+    TVector<TTestBlock> dictionaryBlocks;
+    for (const auto& [dictionaryId, array] : dictionaries) {
+        dictionaryBlocks.push_back(WriteMessage({array}, dictionaryId, &file));
+    }
+    TVector<TTestBlock> recordBatchBlocks;
+    for (const auto& arrays : recordBatches) {
+        recordBatchBlocks.push_back(WriteMessage(arrays, Nothing(), &file));
+    }
+
+    flatbuffers::FlatBufferBuilder builder;
+    TVector<flatbuffers::Offset<flatbuffers::Table>> fieldOffsets;
+    for (const auto& field : fields) {
+        fieldOffsets.push_back(BuildField(field, &builder));
+    }
+    const auto fieldsOffset = builder.CreateVector(fieldOffsets.data(), fieldOffsets.size());
+    const auto schemaStart = builder.StartTable();
+    builder.AddOffset(VOffset(1), fieldsOffset);
+    const flatbuffers::Offset<flatbuffers::Table> schema = builder.EndTable(schemaStart);
+    const auto dictionariesOffset = builder.CreateVectorOfStructs(dictionaryBlocks.data(), dictionaryBlocks.size());
+    const auto recordBatchesOffset = builder.CreateVectorOfStructs(
+        recordBatchBlocks.data(),
+        recordBatchBlocks.size()
+    );
+    const auto start = builder.StartTable();
+    builder.AddElement<i16>(VOffset(0), 4, 0);
+    builder.AddOffset(VOffset(1), schema);
+    builder.AddOffset(VOffset(2), dictionariesOffset);
+    builder.AddOffset(VOffset(3), recordBatchesOffset);
+    builder.Finish(flatbuffers::Offset<flatbuffers::Table>(builder.EndTable(start)));
+
+    const i32 footerSize = builder.GetSize();
+    file.append((const char*)builder.GetBufferPointer(), builder.GetSize());
+    file.append((const char*)&footerSize, sizeof(footerSize));
+    file += "ARROW1";
+    return file;
+}
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromArrow) {
+    Y_UNIT_TEST(ReadDataset) {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        const TVector<TTestField> fields = {
+            {"Target", EArrowTypeType::FloatingPoint, /*Precision*/ 2, Nothing()},
+            {"f1", EArrowTypeType::FloatingPoint, /*Precision*/ 1, Nothing()},
+            {"c", EArrowTypeType::Utf8, /*Precision*/ 1, /*DictionaryId*/ TMaybe<i64>(0)},
+            {"f3", EArrowTypeType::Int, /*Precision*/ 1, Nothing()},
+            {"t", EArrowTypeType::Utf8, /*Precision*/ 1, Nothing()},
+        };
+        const TString arrowFileData = WriteArrowFile(
+            fields,
+            {{0, MakeUtf8Array({"a", "b"})}},
+            {
+                {
+                    MakePrimitiveArray<double>({0.0, 1.0}),
+                    MakePrimitiveArray<float>({0.1f, 0.2f}),
+                    MakePrimitiveArray<i32>({1, 0}),
+                    MakePrimitiveArray<i32>({1, 0}, {true, false}),
+                    MakeUtf8Array({"x", "y"})
+                },
+                {
+                    MakePrimitiveArray<double>({0.0}),
+                    MakePrimitiveArray<float>({0.3f}),
+                    MakePrimitiveArray<i32>({1}),
+                    MakePrimitiveArray<i32>({3}),
+                    MakeUtf8Array({"z"})
+                }
+            }
+        );
+
+        TReadDatasetTestCase testCase;
+        TSrcData srcData;
+        srcData.Scheme = "arrow";
+        srcData.CdFileData = TStringBuf(
+            "0\tTarget\n"
+            "2\tCateg\n"
+            "4\tCateg\n"
+        );
+        srcData.DatasetFileData = arrowFileData;
+        testCase.SrcData = std::move(srcData);
+
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::Num, ""},
+            {EColumn::Categ, ""},
+            {EColumn::Num, ""},
+            {EColumn::Categ, ""},
+        };
+
+        TVector<TString> featureId = {"f1", "c", "f3", "t"};
+
+        expectedData.MetaInfo = TDataMetaInfo(
+            std::move(dataColumnsMetaInfo),
+            ERawTargetType::Float,
+            false,
+            false,
+            false,
+            false,
+            /* additionalBaselineCount */ Nothing(),
+            &featureId
+        );
+        expectedData.Objects.FloatFeatures = {
+            TVector<float>{0.1f, 0.2f, 0.3f},
+            TVector<float>{1.0f, nan, 3.0f},
+        };
+        expectedData.Objects.CatFeatures = {
+            TVector<TStringBuf>{"b", "a", "b"},
+            TVector<TStringBuf>{"x", "y", "z"},
+        };
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(3);
+        expectedData.Target.TargetType = ERawTargetType::Float;
+        TVector<TVector<TString>> rawTarget{{"0", "1", "0"}};
+        expectedData.Target.Target.assign(rawTarget.begin(), rawTarget.end());
+        expectedData.Target.Weights = TWeights<float>(3);
+        expectedData.Target.GroupWeights = TWeights<float>(3);
+
+        testCase.ExpectedData = std::move(expectedData);
+
+        TestReadDataset(testCase);
+    }
+
+    Y_UNIT_TEST(ReadDatasetWithWrongFormat) {
+        TReadDatasetTestCase testCase;
+        TSrcData srcData;
+        srcData.Scheme = "arrow";
+        srcData.DatasetFileData = TStringBuf("0\t0.1\t0.2\n");
+        testCase.SrcData = std::move(srcData);
+        testCase.ExpectedReadError = true;
+
+        TestReadDataset(testCase);
+    }
+}
@@ -1,11 +1,15 @@
 #include <catboost/libs/data/quantization.h>
 
 #include <catboost/libs/data/data_provider.h>
+#include <catboost/libs/data/data_provider_builders.h>
 
 #include <catboost/libs/data/ut/lib/for_data_provider.h>
 #include <catboost/libs/data/ut/lib/for_objects.h>
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/xrange.h>
+#include <util/random/fast.h>
 
 #include <library/cpp/testing/unittest/registar.h>
 
@@ -1360,4 +1364,215 @@ Y_UNIT_TEST_SUITE(Quantization) {
 
         Test(std::move(generateTestCase));
    }
+
+    // samples of the last features are sorted in parallel, it must not change borders
+    Y_UNIT_TEST(TestBordersDoNotDependOnThreadCount) {
+        const ui32 objectCount = 100000;
+        const ui32 featureCount = 3;
+
+        TVector<TVector<float>> floatFeatures(featureCount, TVector<float>(objectCount));
+        TFastRng64 rng(0);
+        for (auto& feature : floatFeatures) {
+            for (auto& value : feature) {
+                value = rng.GenRandReal1();
+            }
+        }
+
+        TVector<TVector<TVector<float>>> bordersForThreadCounts;
+        for (auto threadCount : {1, 4}) {
+            TRawBuilderData srcData;
+
+            TDataColumnsMetaInfo dataColumnsMetaInfo;
+            dataColumnsMetaInfo.Columns = {{EColumn::Label, ""}};
+            for (auto featureIdx : xrange(featureCount)) {
+                Y_UNUSED(featureIdx);
+                dataColumnsMetaInfo.Columns.push_back({EColumn::Num, ""});
+            }
+            TDataMetaInfo metaInfo(std::move(dataColumnsMetaInfo), ERawTargetType::String, false, false, false, false, Nothing());
+            srcData.MetaInfo = metaInfo;
+
+            srcData.TargetData.TargetType = ERawTargetType::String;
+            TVector<TVector<TString>> rawTarget{TVector<TString>(objectCount, "0")};
+            srcData.TargetData.Target.assign(rawTarget.begin(), rawTarget.end());
+            srcData.TargetData.SetTrivialWeights(objectCount);
+
+            srcData.CommonObjectsData.FeaturesLayout = srcData.MetaInfo.FeaturesLayout;
+            srcData.CommonObjectsData.SubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(
+                TFullSubset<ui32>(objectCount)
+            );
+            InitFeatures(
+                floatFeatures,
+                *srcData.CommonObjectsData.SubsetIndexing,
+                TConstArrayRef<ui32>{0, 1, 2},
+                &srcData.ObjectsData.FloatFeatures
+            );
+
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount - 1);
+
+            TRawDataProviderPtr rawDataProvider = MakeDataProvider<TRawObjectsDataProvider>(
+                Nothing(),
+                std::move(srcData),
+                false,
+                /*forceUnitAutoPairWeights*/ false,
+                &localExecutor
+            );
+
+            auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+                *metaInfo.FeaturesLayout,
+                TConstArrayRef<ui32>(),
+                NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, 254, ENanMode::Forbidden)
+            );
+
+            TQuantizationOptions quantizationOptions;
+            TRestorableFastRng64 rand(0);
+            CalcBordersAndNanMode(quantizationOptions, rawDataProvider, quantizedFeaturesInfo, &rand, &localExecutor);
+
+            auto& borders = bordersForThreadCounts.emplace_back();
+            for (auto featureIdx : xrange(featureCount)) {
+                borders.push_back(quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(featureIdx)));
+            }
+        }
+
+        UNIT_ASSERT(bordersForThreadCounts[0] == bordersForThreadCounts[1]);
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(AppendToQuantizedData) {
+    static TRawDataProviderPtr CreateRawData(
+        const TFeaturesLayoutPtr& featuresLayout,
+        const TVector<float>& floatFeature,
+        const TVector<TString>& catFeature,
+        const TVector<float>& target
+    ) {
+        TDataMetaInfo metaInfo;
+        metaInfo.FeaturesLayout = featuresLayout;
+        metaInfo.TargetType = ERawTargetType::Float;
+        metaInfo.TargetCount = 1;
+
+        return CreateDataProvider<IRawObjectsOrderDataVisitor>(
+            [&] (IRawObjectsOrderDataVisitor* visitor) {
+                visitor->Start(
+                    /*inBlock*/ false,
+                    metaInfo,
+                    /*haveUnknownNumberOfSparseFeatures*/ false,
+                    target.size(),
+                    EObjectsOrder::Ordered,
+                    /*resourceHolders*/ {}
+                );
+                visitor->StartNextBlock(target.size());
+                for (auto objectIdx : xrange(target.size())) {
+                    visitor->AddFloatFeature(objectIdx, 0, floatFeature[objectIdx]);
+                    visitor->AddCatFeature(objectIdx, 1, catFeature[objectIdx]);
+                    visitor->AddTarget(objectIdx, target[objectIdx]);
+                }
+                visitor->Finish();
+            }
+        )->CastMoveTo<TRawObjectsDataProvider>();
+    }
+
+    Y_UNIT_TEST(DropAndAppend) {
+        const auto featuresLayout = MakeIntrusive<TFeaturesLayout>(
+            ui32(2),
+            TVector<ui32>{1},
+            TVector<ui32>{},
+            TVector<ui32>{},
+            TVector<TString>{"f0", "c1"}
+        );
+        const TVector<float> floatFeature = {0.1f, 0.5f, 0.3f, 0.9f, 0.7f, 0.2f, 0.4f, 0.8f, 0.35f, 1.5f, 0.05f};
+        const TVector<TString> catFeature = {"a", "b", "a", "c", "b", "c", "a", "b", "d", "a", "d"};
+        const TVector<float> target = {0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f};
+        const ui32 oldObjectCount = 8;
+        const ui32 droppedObjectCount = 3;
+
+        auto slice = [] (const auto& values, size_t begin, size_t end) {
+            return std::decay_t<decltype(values)>(values.begin() + begin, values.begin() + end);
+        };
+
+        NPar::TLocalExecutor localExecutor;
+        TRestorableFastRng64 rand(0);
+        TQuantizationOptions quantizationOptions;
+
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            *featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, 16, ENanMode::Forbidden)
+        );
+        auto quantizedData = Quantize(
+            quantizationOptions,
+            CreateRawData(
+                featuresLayout,
+                slice(floatFeature, 0, oldObjectCount),
+                slice(catFeature, 0, oldObjectCount),
+                slice(target, 0, oldObjectCount)
+            ),
+            quantizedFeaturesInfo,
+            &rand,
+            &localExecutor
+        );
+        const auto borders = quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(0));
+
+        auto result = AppendToQuantizedData(
+            quantizedData,
+            droppedObjectCount,
+            CreateRawData(
+                featuresLayout,
+                slice(floatFeature, oldObjectCount, floatFeature.size()),
+                slice(catFeature, oldObjectCount, catFeature.size()),
+                slice(target, oldObjectCount, target.size())
+            ),
+            quantizationOptions,
+            &rand,
+            &localExecutor
+        );
+
+        // borders are reused, new categorical value is added to the perfect hash
+        UNIT_ASSERT(quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(0)) == borders);
+        UNIT_ASSERT_VALUES_EQUAL(
+            quantizedFeaturesInfo->GetUniqueValuesCounts(TCatFeatureIdx(0)).OnAll,
+            4
+        );
+
+        // same as quantization of the whole window with the same quantization info
+        auto expected = Quantize(
+            quantizationOptions,
+            CreateRawData(
+                featuresLayout,
+                slice(floatFeature, droppedObjectCount, floatFeature.size()),
+                slice(catFeature, droppedObjectCount, catFeature.size()),
+                slice(target, droppedObjectCount, target.size())
+            ),
+            quantizedFeaturesInfo,
+            &rand,
+            &localExecutor
+        );
+
+        UNIT_ASSERT_VALUES_EQUAL(result->GetObjectCount(), expected->GetObjectCount());
+        UNIT_ASSERT_VALUES_EQUAL(
+            (*result->ObjectsData->GetFloatFeature(0))->ExtractValues(&localExecutor),
+            (*expected->ObjectsData->GetFloatFeature(0))->ExtractValues(&localExecutor)
+        );
+        UNIT_ASSERT_VALUES_EQUAL(
+            (*result->ObjectsData->GetCatFeature(0))->ExtractValues(&localExecutor),
+            (*expected->ObjectsData->GetCatFeature(0))->ExtractValues(&localExecutor)
+        );
+
+        TVector<float> resultTarget(result->GetObjectCount());
+        TArrayRef<float> resultTargetRef = resultTarget;
+        result->RawTargetData.GetNumericTarget(TArrayRef<TArrayRef<float>>(&resultTargetRef, 1));
+        UNIT_ASSERT_VALUES_EQUAL(resultTarget, slice(target, droppedObjectCount, target.size()));
+
+        UNIT_ASSERT_EXCEPTION(
+            AppendToQuantizedData(
+                quantizedData,
+                oldObjectCount + 1,
+                CreateRawData(featuresLayout, {0.f}, {"a"}, {0.f}),
+                quantizationOptions,
+                &rand,
+                &localExecutor
+            ),
+            TCatBoostException
+        );
+    }
 }
@@ -0,0 +1,109 @@
+#include <catboost/libs/data/ut/lib/for_loader.h>
+
+#include <catboost/libs/data/load_data.h>
+#include <catboost/libs/data/raw_dataset_cache.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+static TDataProviderPtr ReadDatasetWithCache(
+    const TReadDatasetMainParams& readDatasetMainParams,
+    NPar::ILocalExecutor* localExecutor
+) {
+    return ReadDataset(
+        /*taskType*/Nothing(),
+        readDatasetMainParams.PoolPath,
+        readDatasetMainParams.PairsFilePath,
+        readDatasetMainParams.GroupWeightsFilePath,
+        /*timestampsFilePath*/TPathWithScheme(),
+        readDatasetMainParams.BaselineFilePath,
+        readDatasetMainParams.FeatureNamesFilePath,
+        /*poolMetaInfoFilePath*/TPathWithScheme(),
+        readDatasetMainParams.ColumnarPoolFormatParams,
+        /*ignoredFeatures*/ {},
+        EObjectsOrder::Undefined,
+        TDatasetSubset::MakeColumns(),
+        /*forceUnitAutoPairWeights*/ false,
+        /*classLabels*/Nothing(),
+        localExecutor
+    );
+}
+
+static TVector<TString> GetCacheFileNames(const TFsPath& cacheDir) {
+    TVector<TString> names;
+    cacheDir.ListNames(names);
+    return names;
+}
+
+
+Y_UNIT_TEST_SUITE(RawDatasetCache) {
+    Y_UNIT_TEST(ReadDatasetTwice) {
+        TSrcData srcData;
+        srcData.Scheme = "dsv";
+        srcData.CdFileData =
+            "0\tTarget\n"
+            "1\tGroupId\n"
+            "2\tWeight\n"
+            "3\tNum\tf0\n"
+            "4\tCateg\tc0\n"
+            "5\tText\tt0\n"
+            "6\tNum\tf1\n"sv;
+        srcData.DatasetFileData =
+            "0.12\tquery0\t0.5\t0.1\tMale\tcat dog\t-1\n"
+            "0.22\tquery0\t1.0\t0.97\tFemale\tdog\t0\n"
+            "0.34\tquery1\t0.1\t0.13\tMale\tmouse\t2.5\n"
+            "0.42\tquery1\t2.0\t0.0\tChild\t\t1\n"sv;
+        srcData.PairsFileData =
+            "0\t1\n"
+            "3\t2\n"sv;
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        TTempDir cacheDir;
+        readDatasetMainParams.ColumnarPoolFormatParams.RawDatasetCacheDir = cacheDir.Name();
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDataProviderPtr parsedDataProvider = ReadDatasetWithCache(readDatasetMainParams, &localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(GetCacheFileNames(cacheDir.Name()).size(), 1);
+
+        TDataProviderPtr cachedDataProvider = ReadDatasetWithCache(readDatasetMainParams, &localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(GetCacheFileNames(cacheDir.Name()).size(), 1);
+        UNIT_ASSERT(parsedDataProvider->EqualTo(*cachedDataProvider));
+
+        // other loading parameters are another cache entry
+        readDatasetMainParams.ColumnarPoolFormatParams.DsvFormat.IgnoreCsvQuoting = true;
+        TDataProviderPtr otherDataProvider = ReadDatasetWithCache(readDatasetMainParams, &localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(GetCacheFileNames(cacheDir.Name()).size(), 2);
+        UNIT_ASSERT(parsedDataProvider->EqualTo(*otherDataProvider));
+    }
+
+    Y_UNIT_TEST(NotCachedSchemes) {
+        NCatboostOptions::TColumnarPoolFormatParams columnarPoolFormatParams;
+        UNIT_ASSERT(
+            !GetRawDatasetCacheFilePath(
+                "cache",
+                TPathWithScheme("quantized://pool.bin"),
+                /*auxiliaryFilePaths*/ {},
+                columnarPoolFormatParams,
+                /*ignoredFeatures*/ {},
+                EObjectsOrder::Undefined,
+                /*forceUnitAutoPairWeights*/ false,
+                /*classLabels*/ {}
+            )
+        );
+    }
+}
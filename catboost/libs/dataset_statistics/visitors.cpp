@@ -2,8 +2,63 @@
 
 #include <catboost/libs/helpers/json_helpers.h>
 
+#include <util/generic/xrange.h>
+#include <util/system/guard.h>
+
+#include <atomic>
+
 using namespace NJson;
 
+namespace {
+    struct TCachedThreadFeatureStatistics {
+        ui64 Id = 0;
+        TFeatureStatistics* FeatureStatistics = nullptr;
+    };
+}
+
+static std::atomic<ui64> ThreadFeatureStatisticsCount = 0;
+
+static thread_local TCachedThreadFeatureStatistics CachedThreadFeatureStatistics;
+
+void TDatasetStatisticsFullVisitor::StartThreadFeatureStatistics() {
+    with_lock (ThreadFeatureStatisticsLock) {
+        ThreadFeatureStatistics.clear();
+        ThreadFeatureStatisticsId = ++ThreadFeatureStatisticsCount;
+    }
+}
+
+TFeatureStatistics* TDatasetStatisticsFullVisitor::GetThreadFeatureStatistics() {
+    if (CachedThreadFeatureStatistics.Id != ThreadFeatureStatisticsId) {
+        auto featureStatistics = MakeHolder<TFeatureStatistics>();
+        featureStatistics->Init(MetaInfo, CustomBorders);
+        with_lock (ThreadFeatureStatisticsLock) {
+            CachedThreadFeatureStatistics.FeatureStatistics = featureStatistics.Get();
+            ThreadFeatureStatistics.push_back(std::move(featureStatistics));
+        }
+        CachedThreadFeatureStatistics.Id = ThreadFeatureStatisticsId;
+    }
+    return CachedThreadFeatureStatistics.FeatureStatistics;
+}
+
+void TDatasetStatisticsFullVisitor::FinishThreadFeatureStatistics() {
+    auto& featureStatistics = DatasetStatistics.FeatureStatistics;
+    with_lock (ThreadFeatureStatisticsLock) {
+        for (const auto& threadFeatureStatistics : ThreadFeatureStatistics) {
+            for (auto i : xrange(featureStatistics.FloatFeatureStatistics.size())) {
+                featureStatistics.FloatFeatureStatistics[i].Update(
+                    threadFeatureStatistics->FloatFeatureStatistics[i]);
+            }
+            for (auto i : xrange(featureStatistics.CatFeatureStatistics.size())) {
+                featureStatistics.CatFeatureStatistics[i].Update(
+                    threadFeatureStatistics->CatFeatureStatistics[i]);
+            }
+        }
+        ThreadFeatureStatistics.clear();
+        // invalidates pointers to the destroyed partial statistics cached by threads
+        ThreadFeatureStatisticsId = ++ThreadFeatureStatisticsCount;
+    }
+}
+
 void TDatasetStatisticsFullVisitor::OutputResult(const TString& outputPath) const {
     TFileOutput output(outputPath);
     WriteJsonWithCatBoostPrecision(this->GetDatasetStatistics().ToJson(), true, &output);
@@ -10,8 +10,10 @@
 #include <library/cpp/json/writer/json_value.h>
 
 #include <util/digest/numeric.h>
+#include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 #include <util/stream/fwd.h>
+#include <util/system/spinlock.h>
 
 using namespace NCB;
 
@@ -73,6 +75,7 @@ public:
             MetaInfo.TargetType = ERawTargetType::Float;
         }
         DatasetStatistics.Init(MetaInfo, CustomBorders, TargetCustomBorders);
+        StartThreadFeatureStatistics();
 //        MetaInfo.TargetType = ERawTargetType::String;
         FloatTarget.resize(metaInfo.TargetCount);
     }
@@ -109,15 +112,16 @@ public:
     // TRawObjectsData
     void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
         Y_ASSERT(false);
-        DatasetStatistics.FeatureStatistics
-            .FloatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx)]
+        GetThreadFeatureStatistics()
+            ->FloatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx)]
             .Update(feature);
         Y_UNUSED(localObjectIdx);
     }
     void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
+        auto* featureStatistics = GetThreadFeatureStatistics();
         for (auto perTypeFeatureIdx : xrange(features.size())) {
-            DatasetStatistics.FeatureStatistics
-                .FloatFeatureStatistics[TFloatFeatureIdx(perTypeFeatureIdx).Idx]
+            featureStatistics
+                ->FloatFeatureStatistics[TFloatFeatureIdx(perTypeFeatureIdx).Idx]
                 .Update(features[perTypeFeatureIdx]);
         }
         Y_UNUSED(localObjectIdx);
@@ -144,16 +148,17 @@ public:
 
     void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
         // ToDo Implement CatFeatureStatistics MLTOOLS-6678
-         DatasetStatistics.FeatureStatistics
-             .CatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx)]
+         GetThreadFeatureStatistics()
+             ->CatFeatureStatistics[GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx)]
              .Update(feature);
         Y_UNUSED(localObjectIdx);
     }
     void AddAllCatFeatures(ui32 localObjectIdx, TConstArrayRef<ui32> features) override {
         // ToDo Implement CatFeatureStatistics MLTOOLS-6678
+        auto* featureStatistics = GetThreadFeatureStatistics();
         for (auto perTypeFeatureIdx : xrange(features.size())) {
-            DatasetStatistics.FeatureStatistics
-                .CatFeatureStatistics[TCatFeatureIdx(perTypeFeatureIdx).Idx]
+            featureStatistics
+                ->CatFeatureStatistics[TCatFeatureIdx(perTypeFeatureIdx).Idx]
                 .Update(features[perTypeFeatureIdx]);
         }
         Y_UNUSED(localObjectIdx);
@@ -256,6 +261,7 @@ public:
         if (DatasetStatistics.GroupwiseStats.Defined()) {
             DatasetStatistics.GroupwiseStats->Flush();
         }
+        FinishThreadFeatureStatistics();
 
         if (ObjectCount != 0) {
             CATBOOST_INFO_LOG << "Object info sizes: " << ObjectCount << " "
@@ -297,6 +303,14 @@ private:
         return MetaInfo.FeaturesLayout->GetExpandingInternalFeatureIdx<FeatureType>(flatFeatureIdx).Idx;
     }
 
+    /* Loaders call visitor methods from several threads. Float and categorical feature statistics are
+     * accumulated in partial statistics of each thread (so that threads don't take the locks of shared
+     * statistics for every value) and are merged into DatasetStatistics at Finish.
+     */
+    void StartThreadFeatureStatistics();
+    TFeatureStatistics* GetThreadFeatureStatistics();
+    void FinishThreadFeatureStatistics();
+
 private:
     bool InBlock;
     ui32 ObjectCount;
@@ -310,6 +324,12 @@ private:
     bool IsLocal;
 
     TDatasetStatistics DatasetStatistics;
+
+    // to distinguish partial statistics of different visitors and processings in the thread-local cache
+    ui64 ThreadFeatureStatisticsId = 0;
+    TAdaptiveLock ThreadFeatureStatisticsLock;
+    TVector<THolder<TFeatureStatistics>> ThreadFeatureStatistics;
+
     TVector<TVector<float>> FloatTarget;
     TMutex TargetLock;
     TDataMetaInfo MetaInfo;
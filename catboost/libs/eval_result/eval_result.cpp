@@ -8,7 +8,9 @@
 #include <catboost/private/libs/options/enum_helpers.h>
 
 #include <util/generic/hash_set.h>
+#include <util/generic/ymath.h>
 #include <util/stream/fwd.h>
+#include <util/stream/str.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
 
@@ -48,6 +50,65 @@ static TFeatureIdToDesc GetFeatureIdToDesc(const TDataProvider& pool) {
     return res;
 }
 
+static void OutputDocumentRow(
+    const TVector<THolder<IColumnPrinter>>& columnPrinter,
+    ui32 docId,
+    IOutputStream* outputStream) {
+
+    TString delimiter = "";
+    for (auto& printer : columnPrinter) {
+        *outputStream << delimiter;
+        printer->OutputValue(outputStream, docId);
+        delimiter = printer->GetAfterColumnDelimiter();
+    }
+    *outputStream << '\n';
+}
+
+/* Rows are formatted in parallel by blocks and written in document order.
+ * At most (threadCount + 1) blocks are kept in memory at once.
+ * Columns read from the source pool file are printed sequentially because pool columns printers
+ *  read the file as a stream.
+ */
+static void OutputDocumentRows(
+    const TVector<THolder<IColumnPrinter>>& columnPrinter,
+    ui32 docCount,
+    bool canFormatInParallel,
+    NPar::ILocalExecutor* executor,
+    IOutputStream* outputStream) {
+
+    const int threadCount = executor->GetThreadCount() + 1;
+    if (!canFormatInParallel || (threadCount == 1)) {
+        for (ui32 docId = 0; docId < docCount; ++docId) {
+            OutputDocumentRow(columnPrinter, docId, outputStream);
+        }
+        return;
+    }
+
+    constexpr ui32 BlockSize = 10000;
+    TVector<TString> formattedBlocks(threadCount);
+    for (ui32 batchBegin = 0; batchBegin < docCount; batchBegin += BlockSize * threadCount) {
+        const ui32 batchEnd = Min<ui64>((ui64)batchBegin + (ui64)BlockSize * threadCount, docCount);
+        const int blockCount = CeilDiv(batchEnd - batchBegin, BlockSize);
+        executor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const ui32 blockBegin = batchBegin + blockIdx * BlockSize;
+                const ui32 blockEnd = Min(blockBegin + BlockSize, batchEnd);
+                TString& formattedBlock = formattedBlocks[blockIdx];
+                formattedBlock.clear();
+                TStringOutput blockOutput(formattedBlock);
+                for (ui32 docId = blockBegin; docId < blockEnd; ++docId) {
+                    OutputDocumentRow(columnPrinter, docId, &blockOutput);
+                }
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
+            outputStream->Write(formattedBlocks[blockIdx]);
+        }
+    }
+}
+
 namespace NCB {
 
     TVector<TVector<TVector<double>>>& TEvalResult::GetRawValuesRef() {
@@ -366,15 +427,13 @@ namespace NCB {
             }
             *outputStream << Endl;
         }
-        for (ui32 docId = 0; docId < pool.ObjectsGrouping->GetObjectCount(); ++docId) {
-            TString delimiter = "";
-            for (auto& printer : columnPrinter) {
-                *outputStream << delimiter;
-                printer->OutputValue(outputStream, docId);
-                delimiter = printer->GetAfterColumnDelimiter();
-            }
-            *outputStream << Endl;
-        }
+        OutputDocumentRows(
+            columnPrinter,
+            pool.ObjectsGrouping->GetObjectCount(),
+            /*canFormatInParallel*/ !needPoolColumnsPrinter,
+            executor,
+            outputStream);
+        outputStream->Flush();
     }
 
     void OutputEvalResultToFile(
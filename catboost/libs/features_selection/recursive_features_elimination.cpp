@@ -671,16 +671,21 @@ namespace NCB {
             );
         };
 
+        // target processing depends only on the loss and the labels, which are the same for all the models,
+        // so it is done once instead of for every evaluated feature at every step
+        TTargetDataProviderPtr fstrTarget;
         const auto calcLoss = [&] (const auto& approx, const TFullModel& model) {
-            TRestorableFastRng64 rand(0);
-            const auto fstrTarget = CreateModelCompatibleProcessedDataProvider(
-                *fstrPool,
-                { catBoostOptions.MetricOptions->ObjectiveMetric.Get() },
-                model,
-                GetMonopolisticFreeCpuRam(),
-                &rand,
-                executor
-            ).TargetData;
+            if (!fstrTarget) {
+                TRestorableFastRng64 rand(0);
+                fstrTarget = CreateModelCompatibleProcessedDataProvider(
+                    *fstrPool,
+                    { catBoostOptions.MetricOptions->ObjectiveMetric.Get() },
+                    model,
+                    GetMonopolisticFreeCpuRam(),
+                    &rand,
+                    executor
+                ).TargetData;
+            }
 
             return CalcMetric(
                 *loss.Get(),
@@ -216,6 +216,8 @@ TVector<TMetricHolder> CalcFeatureEffectLossChangeMetricStats(
     }
 
     int approxDimension = model.ModelTrees->GetDimensionsCount();
+    const TConstArrayRef<float> target = targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>());
+    const TConstArrayRef<float> weights = GetWeights(*targetData);
 
     TProfileInfo profile(documentCount);
     TImportanceLogger importanceLogger(
@@ -250,8 +252,8 @@ TVector<TMetricHolder> CalcFeatureEffectLossChangeMetricStats(
         scores.back().Add(
             dynamic_cast<const ISingleTargetEval*>(metric.Get())->Eval(
                 approx,
-                targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()),
-                GetWeights(*targetData),
+                target,
+                weights,
                 queriesInfo,
                 queryBegin,
                 queryEnd,
@@ -272,31 +274,43 @@ TVector<TMetricHolder> CalcFeatureEffectLossChangeMetricStats(
             calcType
         );
 
-        for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
-            NPar::ILocalExecutor::TExecRangeParams blockParams(begin, end);
-            blockParams.SetBlockCountToThreadCount();
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
-                }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-            scores[featureIdx].Add(
-                dynamic_cast<const ISingleTargetEval*>(metric.Get())->Eval(
-                    approx,
-                    targetData->GetOneDimensionalTarget().GetOrElse(TConstArrayRef<float>()),
-                    GetWeights(*targetData),
-                    queriesInfo,
-                    queryBegin,
-                    queryEnd,
-                    *localExecutor
-                )
-            );
-            localExecutor->ExecRange([&](ui32 docIdx) {
+        // features are removed independently, so every feature is evaluated on its own copy of the block approx
+        const ui32 blockDocumentCount = end - begin;
+        TVector<TQueryInfo> blockQueriesInfo;
+        if (!queriesInfo.empty()) {
+            blockQueriesInfo.assign(queriesInfo.begin() + queryBegin, queriesInfo.begin() + queryEnd);
+            for (auto& query : blockQueriesInfo) {
+                query.Begin -= begin;
+                query.End -= begin;
+            }
+        }
+        const auto blockTarget = target.empty() ? target : target.Slice(begin, blockDocumentCount);
+        const auto blockWeights = weights.empty() ? weights : weights.Slice(begin, blockDocumentCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int featureIdx) {
+                TVector<TVector<double>> blockApprox(approxDimension, TVector<double>(blockDocumentCount));
                 for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    for (ui32 docIdx = 0; docIdx < blockDocumentCount; ++docIdx) {
+                        blockApprox[dimensionIdx][docIdx]
+                            = approx[dimensionIdx][begin + docIdx] - shapValues[docIdx][featureIdx][dimensionIdx];
+                    }
                 }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-        }
+                scores[featureIdx].Add(
+                    dynamic_cast<const ISingleTargetEval*>(metric.Get())->Eval(
+                        blockApprox,
+                        blockTarget,
+                        blockWeights,
+                        blockQueriesInfo,
+                        /*begin*/ 0,
+                        /*end*/ queriesInfo.empty() ? blockDocumentCount : queryEnd - queryBegin,
+                        *localExecutor
+                    )
+                );
+            },
+            0,
+            featuresCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
         if (needYetiRankPairs) {
             for (ui32 queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex) {
                 queriesInfo[queryIndex].Competitors.clear();
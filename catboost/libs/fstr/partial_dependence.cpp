@@ -35,6 +35,10 @@ namespace {
             }
         }
     };
+
+    inline bool IsFullRange(const TFloatFeatureBucketRange& range) {
+        return range.Start == 0 && range.End == range.NumOfBuckets;
+    }
 } //anonymous
 
 TVector<TFloatFeatureBucketRange> PrepareFeatureRanges(
@@ -132,9 +136,15 @@ TVector<double> MergeBucketRanges(
     int numOfBucketsTotal = rowNum * columnNum;
     TVector<double> edges(numOfBucketsTotal);
 
+    // leaves of trees without splits by the features cover all buckets, their sum is added to every bucket at once
+    double predictionForAllBuckets = 0;
     for (size_t leafIdx = 0; leafIdx < leafValues.size(); ++leafIdx) {
         const auto& ranges = leafBucketRanges[leafIdx];
         double leafValue = leafValues[leafIdx];
+        if (IsFullRange(ranges[0]) && IsFullRange(ranges[1])) {
+            predictionForAllBuckets += leafValue * leafWeights[leafIdx];
+            continue;
+        }
         for (int rowIdx = ranges[0].Start; rowIdx < ranges[0].End; ++rowIdx) {
             if (ranges[1].Start < ranges[1].End) {
                 edges[rowIdx * columnNum + ranges[1].Start] += leafValue * leafWeights[leafIdx];
@@ -151,7 +161,7 @@ TVector<double> MergeBucketRanges(
     double acc = 0;
     for (int idx = 0; idx < numOfBucketsTotal; ++idx) {
         acc += edges[idx];
-        predictionsByBuckets[idx] = acc;
+        predictionsByBuckets[idx] = acc + predictionForAllBuckets;
     }
 
     size_t numOfDocuments = dataProvider.GetObjectCount();
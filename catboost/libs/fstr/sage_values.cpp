@@ -8,6 +8,7 @@
 #include <catboost/libs/helpers/cpu_random.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/model/cpu/quantization.h>
@@ -50,9 +51,7 @@ class MarginalImputer {
 public:
     MarginalImputer(
         const TDataProvider& dataset,
-        NPar::ILocalExecutor* executor,
-        TRestorableFastRng64* randPtr)
-        : RandPtr(randPtr)
+        NPar::ILocalExecutor* executor)
     {
         LocalExecutor = executor;
         ReferenceSamplesCount = dataset.GetObjectCount();
@@ -97,7 +96,8 @@ public:
     void ImputeInplace(
         const TVector<std::pair<ui32, EFeatureType>>& features,
         FullSubsetIndexingPtrWrapper& fullSubsetIndexingPtrWrapper,
-        TDataProvider* datasetPtr)
+        TRestorableFastRng64* randPtr,
+        TDataProvider* datasetPtr) const
     {
         // sanity check
         CB_ENSURE_INTERNAL(ReferenceSamplesFloat.size() == datasetPtr->MetaInfo.FeaturesLayout->GetFloatFeatureCount(),
@@ -125,7 +125,7 @@ public:
                 case EFeatureType::Float: {
                     TVector<float> values(objectsCount);
                     for (auto& value: values) {
-                        value = ReferenceSamplesFloat[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+                        value = ReferenceSamplesFloat[featureIndex][randPtr->Uniform(ReferenceSamplesCount)];
                     }
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetFloatFeature(featureIndex))->GetId();
                     TFloatArrayValuesHolder floatValuesHolder(
@@ -141,7 +141,7 @@ public:
                 case EFeatureType::Categorical: {
                     TVector<ui32> values(objectsCount);
                     for (auto& value: values) {
-                        value = ReferenceSamplesCategorical[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+                        value = ReferenceSamplesCategorical[featureIndex][randPtr->Uniform(ReferenceSamplesCount)];
                     }
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetCatFeature(featureIndex))->GetId();
                     THashedCatArrayValuesHolder catValuesHolder(
@@ -157,7 +157,7 @@ public:
                 case EFeatureType::Text: {
                     TVector<TString> values(objectsCount);
                     for (auto& value: values) {
-                        value = ReferenceSamplesText[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+                        value = ReferenceSamplesText[featureIndex][randPtr->Uniform(ReferenceSamplesCount)];
                     }
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetTextFeature(featureIndex))->GetId();
                     TStringTextArrayValuesHolder textValuesHolder(
@@ -173,7 +173,7 @@ public:
                 case EFeatureType::Embedding: {
                     TVector<TConstEmbedding> values(objectsCount);
                     for (auto& value: values) {
-                        value = ReferenceSamplesEmbedding[featureIndex][RandPtr->Uniform(ReferenceSamplesCount)];
+                        value = ReferenceSamplesEmbedding[featureIndex][randPtr->Uniform(ReferenceSamplesCount)];
                     }
                     ui32 featureId = (*rawObjectsDataProviderPtr->GetEmbeddingFeature(featureIndex))->GetId();
                     TEmbeddingArrayValuesHolder embeddingValuesHolder(
@@ -197,7 +197,6 @@ private:
     TVector<TMaybeOwningArrayHolder<ui32>> ReferenceSamplesCategorical;
     TVector<TMaybeOwningArrayHolder<TString>> ReferenceSamplesText;
     TVector<TMaybeOwningArrayHolder<TConstEmbedding>> ReferenceSamplesEmbedding;
-    TRestorableFastRng64* RandPtr;
     ui32 ReferenceSamplesCount;
     NPar::ILocalExecutor* LocalExecutor;
 };
@@ -352,14 +351,12 @@ TVector<TVector<double>> CalcSageValues(
     CB_ENSURE(model.ModelTrees->GetDimensionsCount() == 1, "Model must not be trained for multiclassification");
 
     // setting algorithm params
-    TRestorableFastRng64 rand(228);
     size_t featuresCount = dataset.MetaInfo.GetFeatureCount();
     batchSize = Min(batchSize, size_t(dataset.GetObjectCount()));
     auto featuresLayout = dataset.MetaInfo.FeaturesLayout;
     const double convergenceThreshold = 0.1;
 
-    FullSubsetIndexingPtrWrapper fullSubsetIndexingPtrWrapper;
-    MarginalImputer imputer(dataset, localExecutor, &rand);
+    const MarginalImputer imputer(dataset, localExecutor);
 
     // creating loss holder
     NCatboostOptions::TLossDescription metricDescription;
@@ -380,41 +377,71 @@ TVector<TVector<double>> CalcSageValues(
     TVector<THolder<IMetric>> metrics;
     metrics.push_back(std::move(metric));
 
+    // every sampling iteration has its own random generator, so the result does not depend on threads count
+    const TVector<ui64> samplingSeeds = GenRandUI64Vector(SafeIntegerCast<int>(nSamples), /*randomSeed*/ 228);
+
     // main algorithm: calculating sage values
+    // sampling iterations are independent and run in parallel by rounds, convergence is checked
+    // after every iteration in their order as in the sequential algorithm
     TImportanceLogger samplingIterationsLogger(nSamples, "sampling iterations passed",
                                                "Calculating SAGE values...", logPeriod);
     TProfileInfo samplingItertionsProfile(nSamples);
     TVector<TVector<double>> sageValues(featuresCount, TVector<double>{0});
-    for (size_t i = 0; i < nSamples; ++i) {
+    const size_t roundSize = SafeIntegerCast<size_t>(localExecutor->GetThreadCount() + 1);
+    bool isConverged = false;
+    for (size_t roundBegin = 0; roundBegin < nSamples && !isConverged; roundBegin += roundSize) {
+        const size_t roundEnd = Min(nSamples, roundBegin + roundSize);
         samplingItertionsProfile.StartIterationBlock();
 
-        // sampling batch of dataset elements
-        auto datasetBatch = GetRandomDatasetBatch(dataset, batchSize, &rand, localExecutor);
-
-        // generating features permutation
-        auto featuresPermutation = GenerateFeaturesPermutation(featuresLayout, &rand);
-
-        // running approximation algorithm
-        double previousLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
-        for (size_t j = 0; j < featuresCount; ++j) {
-            // preparing dataset, sampling disabled features
-            imputer.ImputeInplace({featuresPermutation[j]}, fullSubsetIndexingPtrWrapper, &datasetBatch);
+        // [iteration in round][step] = (external feature index, loss change)
+        TVector<TVector<std::pair<ui32, double>>> lossChanges(roundEnd - roundBegin);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int iterationIdx) {
+                TRestorableFastRng64 iterationRand(samplingSeeds[iterationIdx]);
+                FullSubsetIndexingPtrWrapper fullSubsetIndexingPtrWrapper;
+
+                // sampling batch of dataset elements
+                auto datasetBatch = GetRandomDatasetBatch(dataset, batchSize, &iterationRand, localExecutor);
+
+                // generating features permutation
+                auto featuresPermutation = GenerateFeaturesPermutation(featuresLayout, &iterationRand);
+
+                // running approximation algorithm
+                auto& iterationLossChanges = lossChanges[iterationIdx - roundBegin];
+                double previousLoss = CalculateModelLoss(model, datasetBatch, metrics, &iterationRand, localExecutor);
+                for (size_t j = 0; j < featuresCount; ++j) {
+                    // preparing dataset, sampling disabled features
+                    imputer.ImputeInplace({featuresPermutation[j]}, fullSubsetIndexingPtrWrapper, &iterationRand, &datasetBatch);
+
+                    // calculting loss change
+                    double currentLoss = CalculateModelLoss(model, datasetBatch, metrics, &iterationRand, localExecutor);
+                    ui32 externalFeatureIndex = featuresLayout->GetExternalFeatureIdx(featuresPermutation[j].first,
+                                                                                      featuresPermutation[j].second);
+                    iterationLossChanges.emplace_back(externalFeatureIndex, currentLoss - previousLoss);
+                    previousLoss = currentLoss;
+                }
+            },
+            SafeIntegerCast<int>(roundBegin),
+            SafeIntegerCast<int>(roundEnd),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
 
-            // calculting loss and updating sage value
-            double currentLoss = CalculateModelLoss(model, datasetBatch, metrics, &rand, localExecutor);
-            ui32 externalFeatureIndex = featuresLayout->GetExternalFeatureIdx(featuresPermutation[j].first,
-                                                                              featuresPermutation[j].second);
-            sageValues[externalFeatureIndex].push_back(currentLoss - previousLoss);
-            previousLoss = currentLoss;
-        }
+        size_t passedIterationCount = 0;
+        for (const auto& iterationLossChanges : lossChanges) {
+            for (auto [externalFeatureIndex, lossChange] : iterationLossChanges) {
+                sageValues[externalFeatureIndex].push_back(lossChange);
+            }
+            ++passedIterationCount;
 
-        // checking for convergence if needed
-        if (detectConvergence && CheckIfAllSageValuesConverged(sageValues, convergenceThreshold)) {
-            CATBOOST_INFO_LOG << "Sage Values Have Converged" << Endl;
-            break;
+            // checking for convergence if needed
+            if (detectConvergence && CheckIfAllSageValuesConverged(sageValues, convergenceThreshold)) {
+                CATBOOST_INFO_LOG << "Sage Values Have Converged" << Endl;
+                isConverged = true;
+                break;
+            }
         }
 
-        samplingItertionsProfile.FinishIterationBlock(1);
+        samplingItertionsProfile.FinishIterationBlock(passedIterationCount);
         auto profileResults = samplingItertionsProfile.GetProfileResults();
         samplingIterationsLogger.Log(profileResults);
     }
@@ -8,6 +8,9 @@
 #include <catboost/private/libs/algo/index_calcer.h>
 #include <catboost/libs/model/cpu/quantization.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+
 
 using namespace NCB;
 
@@ -103,6 +106,30 @@ void AllocateStorage(
     }
 }
 
+static void AllocateCoOccurringStorage(
+    const TVector<TVector<bool>>& isCoOccurringClasses,
+    const size_t dim1,
+    const size_t dim2,
+    NPar::ILocalExecutor* localExecutor,
+    TInteractionValuesSubset* map
+) {
+    for (auto idx1 : xrange(isCoOccurringClasses.size())) {
+        for (auto idx2 : xrange(isCoOccurringClasses.size())) {
+            if (!isCoOccurringClasses[idx1][idx2]) {
+                continue;
+            }
+            auto& value = (*map)[std::make_pair(idx1, idx2)];
+            value.resize(dim1);
+            ParallelFill(
+                TVector<double>(dim2, 0.0),
+                /*blockSize*/ Nothing(),
+                localExecutor,
+                MakeArrayRef(value)
+            );
+        }
+    }
+}
+
 static inline void Allocate4DimensionalVector(
     const size_t dim1,
     const size_t dim2,
@@ -196,6 +223,48 @@ static void UnpackInternalShapInteractionValues(
     }
 }
 
+static void UnpackInternalShapInteractionValuesToSparse(
+    const TInteractionValuesSubset& shapInteractionValuesInternal,
+    const TVector<TVector<int>>& combinationClassFeatures,
+    const TVector<double>& rescaleCoefficients,
+    size_t approxDimension,
+    size_t documentCount,
+    TSparseShapInteractionValues* shapInteractionValues
+) {
+    auto getValues = [&] (int featureIdx1, int featureIdx2) -> TVector<TVector<double>>& {
+        auto& values = (*shapInteractionValues)[std::make_pair(featureIdx1, featureIdx2)];
+        if (values.empty()) {
+            values.assign(approxDimension, TVector<double>(documentCount, 0.0));
+        }
+        return values;
+    };
+    for (const auto& [classIndices, documentsByClasses] : shapInteractionValuesInternal) {
+        const auto [classIdx1, classIdx2] = classIndices;
+        if (classIdx1 == classIdx2) {
+            // unpack main effect
+            double coefficientForMainEffect = 1.0 / rescaleCoefficients[classIdx1];
+            for (int featureIdx : combinationClassFeatures[classIdx1]) {
+                AddValuesAllDocuments(documentsByClasses, coefficientForMainEffect, &getValues(featureIdx, featureIdx));
+            }
+            continue;
+        }
+        // unpack interaction effect, the other order of features is unpacked with the symmetric pair of classes
+        double coefficientForInteractionEffect = 1.0 / (rescaleCoefficients[classIdx1] * rescaleCoefficients[classIdx2]);
+        for (int featureIdx1 : combinationClassFeatures[classIdx1]) {
+            for (int featureIdx2 : combinationClassFeatures[classIdx2]) {
+                if (featureIdx1 >= featureIdx2) {
+                    continue;
+                }
+                AddValuesAllDocuments(
+                    documentsByClasses,
+                    coefficientForInteractionEffect,
+                    &getValues(featureIdx1, featureIdx2)
+                );
+            }
+        }
+    }
+}
+
 static inline TVector<size_t> IntersectClasses(
     const TVector<size_t>& classIndicesFirst,
     const TVector<size_t>& classIndicesSecond
@@ -246,6 +315,60 @@ static void ContructClassIndices(
     }
 }
 
+// returned: combination classes of splits for every tree
+static TVector<TVector<size_t>> GetCombinationClassesByTree(
+    const TModelTrees& forest,
+    const TVector<int>& binFeatureCombinationClass
+) {
+    const auto& treeSplits = forest.GetModelTreeData()->GetTreeSplits();
+    const auto& treeStartOffsets = forest.GetModelTreeData()->GetTreeStartOffsets();
+    const size_t treeCount = forest.GetTreeCount();
+    TVector<TVector<size_t>> combinationClassesByTree(treeCount);
+    for (size_t treeIdx : xrange(treeCount)) {
+        const size_t endOffset = treeIdx + 1 == treeCount ? treeSplits.size() : treeStartOffsets[treeIdx + 1];
+        auto& combinationClasses = combinationClassesByTree[treeIdx];
+        for (size_t nodeIdx : xrange<size_t>(treeStartOffsets[treeIdx], endOffset)) {
+            combinationClasses.push_back(binFeatureCombinationClass[treeSplits[nodeIdx]]);
+        }
+        SortUnique(combinationClasses);
+    }
+    return combinationClassesByTree;
+}
+
+// classes interact only if they are used in the same tree, interaction values of other pairs are exactly zero
+static TVector<TVector<bool>> GetCoOccurringClasses(
+    const TVector<TVector<size_t>>& combinationClassesByTree,
+    size_t classCount
+) {
+    TVector<TVector<bool>> isCoOccurring(classCount, TVector<bool>(classCount, false));
+    for (size_t classIdx : xrange(classCount)) {
+        isCoOccurring[classIdx][classIdx] = true;
+    }
+    for (const auto& combinationClasses : combinationClassesByTree) {
+        for (size_t classIdx1 : combinationClasses) {
+            for (size_t classIdx2 : combinationClasses) {
+                isCoOccurring[classIdx1][classIdx2] = true;
+            }
+        }
+    }
+    return isCoOccurring;
+}
+
+static TVector<bool> GetTreesWithClass(
+    const TVector<TVector<size_t>>& combinationClassesByTree,
+    size_t classIdx
+) {
+    TVector<bool> isTreeWithClass(combinationClassesByTree.size(), false);
+    for (size_t treeIdx : xrange(combinationClassesByTree.size())) {
+        isTreeWithClass[treeIdx] = BinarySearch(
+            combinationClassesByTree[treeIdx].begin(),
+            combinationClassesByTree[treeIdx].end(),
+            classIdx
+        );
+    }
+    return isTreeWithClass;
+}
+
 static inline double GetInteractionEffect(double contribOn, double contribOff) {
     return (contribOn - contribOff) / 2.0;
 }
@@ -287,6 +410,8 @@ static void CalcInternalShapInteractionValuesMulti(
     const TVector<TVector<NModelEvaluation::TCalcerIndexType>>& indexes,
     const TVector<size_t>& classIndicesFirst,
     const TVector<size_t>& classIndicesSecond,
+    const TVector<TVector<size_t>>& combinationClassesByTree,
+    const TVector<TVector<bool>>& isCoOccurringClasses,
     int logPeriod,
     NPar::ILocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
@@ -333,7 +458,9 @@ static void CalcInternalShapInteractionValuesMulti(
     // Katsushige Fujimoto, Ivan Kojadinovic, and Jean-Luc Marichal. 2006. Axiomatic
     // characterizations of probabilistic and cardinal-probabilistic interaction indices.
     // Games and Economic Behavior 55, 1 (2006), 72–99
+    // contributions with the fixed class differ only in trees where it is used, so the others are skipped
     for (size_t classIdx1 : classIndicesFirst) {
+        const TVector<bool> isTreeUsed = GetTreesWithClass(combinationClassesByTree, classIdx1);
         const auto& contribsOn = CalcShapValueWithQuantizedData(
             model,
             binarizedFeatures,
@@ -343,7 +470,8 @@ static void CalcInternalShapInteractionValuesMulti(
             logPeriod,
             preparedTrees,
             localExecutor,
-            calcType
+            calcType,
+            isTreeUsed
         );
         const auto& contribsOff = CalcShapValueWithQuantizedData(
             model,
@@ -354,12 +482,16 @@ static void CalcInternalShapInteractionValuesMulti(
             logPeriod,
             preparedTrees,
             localExecutor,
-            calcType
+            calcType,
+            isTreeUsed
         );
         // if needed calculate Ф(i, i) then to calculate all Ф(i, j) where i != j
         // Φ(i,i) = ϕ(i) − sum(Φ(i,j)) i.e reducing path of sum
         if (isSameClassIdx[classIdx1]) {
             for (size_t classIdx2 : xrange(classCount)) {
+                if (!isCoOccurringClasses[classIdx1][classIdx2]) {
+                    continue;
+                }
                 AddInteractionEffectAllDocumentsForPairClasses(
                     contribsOn[classIdx2],
                     contribsOff[classIdx2],
@@ -372,6 +504,9 @@ static void CalcInternalShapInteractionValuesMulti(
             }
         } else {
             for (size_t classIdx2 : classIndicesSecond) {
+                if (!isCoOccurringClasses[classIdx1][classIdx2]) {
+                    continue;
+                }
                 AddInteractionEffectAllDocumentsForPairClasses(
                     contribsOn[classIdx2],
                     contribsOff[classIdx2],
@@ -484,6 +619,11 @@ static void CalcShapInteraction(
         &classIndicesFirst,
         &classIndicesSecond
     );
+    const auto combinationClassesByTree = GetCombinationClassesByTree(*model.ModelTrees, preparedTrees->BinFeatureCombinationClass);
+    const auto isCoOccurringClasses = GetCoOccurringClasses(
+        combinationClassesByTree,
+        preparedTrees->CombinationClassFeatures.size()
+    );
     const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
     const size_t approxDimension = model.GetDimensionsCount();
     TStorageType shapInteractionValuesInternal;
@@ -502,6 +642,8 @@ static void CalcShapInteraction(
         indexes,
         classIndicesFirst,
         classIndicesSecond,
+        combinationClassesByTree,
+        isCoOccurringClasses,
         logPeriod,
         localExecutor,
         preparedTrees,
@@ -621,3 +763,78 @@ TInteractionValuesFull CalcShapInteractionValuesMulti(
         &preparedTrees
     );
 }
+
+TSparseShapInteractionValues CalcSparseShapInteractionValuesMulti(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::ILocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType
+) {
+    TShapPreparedTrees preparedTrees = PrepareTrees(
+        model,
+        &dataset,
+        /*referenceDataset*/ nullptr,
+        mode,
+        localExecutor,
+        /*calcInternalValues*/ true,
+        calcType
+    );
+    TVector<TIntrusivePtr<NModelEvaluation::IQuantizedData>> binarizedFeatures;
+    TVector<TVector<NModelEvaluation::TCalcerIndexType>> indexes;
+    CalcLeafIndices(
+        model,
+        dataset,
+        &binarizedFeatures,
+        &indexes
+    );
+    TVector<size_t> classIndicesFirst;
+    TVector<size_t> classIndicesSecond;
+    ContructClassIndices(
+        preparedTrees.CombinationClassFeatures,
+        /*pairOfFeatures*/ Nothing(),
+        &classIndicesFirst,
+        &classIndicesSecond
+    );
+    const auto combinationClassesByTree = GetCombinationClassesByTree(*model.ModelTrees, preparedTrees.BinFeatureCombinationClass);
+    const auto isCoOccurringClasses = GetCoOccurringClasses(
+        combinationClassesByTree,
+        preparedTrees.CombinationClassFeatures.size()
+    );
+    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    const size_t approxDimension = model.GetDimensionsCount();
+    TInteractionValuesSubset shapInteractionValuesInternal;
+    AllocateCoOccurringStorage(
+        isCoOccurringClasses,
+        approxDimension,
+        documentCount,
+        localExecutor,
+        &shapInteractionValuesInternal
+    );
+    CalcInternalShapInteractionValuesMulti(
+        model,
+        documentCount,
+        binarizedFeatures,
+        indexes,
+        classIndicesFirst,
+        classIndicesSecond,
+        combinationClassesByTree,
+        isCoOccurringClasses,
+        logPeriod,
+        localExecutor,
+        &preparedTrees,
+        &shapInteractionValuesInternal,
+        calcType
+    );
+    TSparseShapInteractionValues shapInteractionValues;
+    UnpackInternalShapInteractionValuesToSparse(
+        shapInteractionValuesInternal,
+        preparedTrees.CombinationClassFeatures,
+        ContructRescaleCoefficients(preparedTrees.CombinationClassFeatures),
+        approxDimension,
+        documentCount,
+        &shapInteractionValues
+    );
+    return shapInteractionValues;
+}
@@ -6,9 +6,14 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/hash.h>
+
 
 struct TShapPreparedTrees;
 
+// ShapInteractionValues[(featureIdx1, featureIdx2)][dim][documentIdx] for featureIdx1 <= featureIdx2
+using TSparseShapInteractionValues = THashMap<std::pair<int, int>, TVector<TVector<double>>>;
+
 
 void ValidateFeaturePair(int flatFeatureCount, std::pair<int, int> featurePair);
 void ValidateFeatureInteractionParams(
@@ -40,3 +45,14 @@ TVector<TVector<TVector<TVector<double>>>> CalcShapInteractionValuesMulti(
     NPar::ILocalExecutor* localExecutor,
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
 );
+
+// same values as CalcShapInteractionValuesMulti without bias, but only for pairs of features used in the same tree
+// (values of other pairs are zero) and only for featureIdx1 <= featureIdx2
+TSparseShapInteractionValues CalcSparseShapInteractionValuesMulti(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    int logPeriod,
+    EPreCalcShapValues mode,
+    NPar::ILocalExecutor* localExecutor,
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+);
@@ -14,8 +14,11 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
+#include <util/generic/hash.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
+#include <util/string/builder.h>
 #include <catboost/libs/model/cpu/quantization.h>
 
 
@@ -39,8 +42,72 @@ namespace {
         {
         }
     };
+
+    /* For symmetric trees SHAP values of a document depend only on its leaf indexes,
+     * so they are reused for documents with the same leaf indexes in all trees.
+     * The cache is turned off if documents rarely repeat.
+     */
+    class TShapValuesByLeafIndexesCache {
+    public:
+        explicit TShapValuesByLeafIndexesCache(size_t maxValuesCount)
+            : MaxValuesCount(maxValuesCount)
+        {
+        }
+
+        bool IsEnabled() const {
+            return Enabled;
+        }
+
+        const TVector<TVector<double>>* Find(TStringBuf leafIndexes) {
+            ++LookupCount;
+            const auto it = ShapValuesByLeafIndexes.find(leafIndexes);
+            if (it == ShapValuesByLeafIndexes.end()) {
+                return nullptr;
+            }
+            ++HitCount;
+            return &it->second;
+        }
+
+        // documents of the same block with equal leaf indexes are not calculated again either
+        void CountRepeatedDocument() {
+            ++HitCount;
+        }
+
+        void Add(TStringBuf leafIndexes, const TVector<TVector<double>>& shapValues) {
+            const size_t valuesCount = shapValues.size() * (shapValues.empty() ? 0 : shapValues[0].size());
+            if (ValuesCount + valuesCount > MaxValuesCount) {
+                return;
+            }
+            ValuesCount += valuesCount;
+            ShapValuesByLeafIndexes.emplace(leafIndexes, shapValues);
+        }
+
+        void DisableIfUseless() {
+            if (LookupCount >= MinLookupCountToDisable && HitCount * 8 < LookupCount) {
+                Enabled = false;
+                ShapValuesByLeafIndexes.clear();
+            }
+        }
+
+    private:
+        static constexpr size_t MinLookupCountToDisable = 16 * CB_THREAD_LIMIT;
+
+        size_t MaxValuesCount;
+        size_t ValuesCount = 0;
+        size_t LookupCount = 0;
+        size_t HitCount = 0;
+        bool Enabled = true;
+        THashMap<TString, TVector<TVector<double>>> ShapValuesByLeafIndexes;
+    };
 } //anonymous
 
+static constexpr size_t ShapValuesCacheMaxValuesCount = 1 << 24;
+
+static bool CanReuseShapValuesByLeafIndexes(const TFullModel& model, ECalcTypeShapValues calcType) {
+    // independent SHAP values depend on document index, non-symmetric trees need the document features
+    return model.IsOblivious() && calcType != ECalcTypeShapValues::Independent;
+}
+
 static TVector<TFeaturePathElement> ExtendFeaturePath(
     const TVector<TFeaturePathElement>& oldFeaturePath,
     double zeroPathsFraction,
@@ -866,7 +933,8 @@ void CalcShapValuesForDocumentMulti(
     size_t documentIdxInBlock,
     TVector<TVector<double>>* shapValues,
     ECalcTypeShapValues calcType,
-    size_t documentIdx
+    size_t documentIdx,
+    TConstArrayRef<bool> isTreeUsed
 ) {
     const TString lossFunctionName = model.GetLossFunctionName();
     TMaybe<ELossFunction> lossFunction = Nothing();
@@ -891,6 +959,9 @@ void CalcShapValuesForDocumentMulti(
     }
     const size_t treeCount = model.GetTreeCount();
     for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        if (!isTreeUsed.empty() && !isTreeUsed[treeIdx]) {
+            continue;
+        }
         const size_t leafCount = (size_t(1) << forest.GetModelTreeData()->GetTreeSizes()[treeIdx]);
         if (preparedTrees.CalcShapValuesByLeafForAllTrees && model.IsOblivious()) {
             if (isIndependent) {
@@ -1088,20 +1159,56 @@ static void CalcShapValuesForDocumentBlockMulti(
     size_t end,
     NPar::ILocalExecutor* localExecutor,
     TVector<TVector<TVector<double>>>* shapValuesForAllDocuments,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TShapValuesByLeafIndexesCache* cache = nullptr
 ) {
     const size_t documentCount = end - start;
+    const size_t treeCount = model.GetTreeCount();
 
     auto binarizedFeaturesForBlock = MakeQuantizedFeaturesForEvaluator(model, featuresBlockIterator, start, end);
 
-    TVector<NModelEvaluation::TCalcerIndexType> indices(binarizedFeaturesForBlock->GetObjectsCount() * model.GetTreeCount());
-    model.GetCurrentEvaluator()->CalcLeafIndexes(binarizedFeaturesForBlock.Get(), 0, model.GetTreeCount(), indices);
+    TVector<NModelEvaluation::TCalcerIndexType> indices(binarizedFeaturesForBlock->GetObjectsCount() * treeCount);
+    model.GetCurrentEvaluator()->CalcLeafIndexes(binarizedFeaturesForBlock.Get(), 0, treeCount, indices);
 
     const int oldShapValuesSize = shapValuesForAllDocuments->size();
     shapValuesForAllDocuments->resize(oldShapValuesSize + end - start);
 
-    NPar::ILocalExecutor::TExecRangeParams blockParams(0, documentCount);
-    localExecutor->ExecRange([&] (size_t documentIdxInBlock) {
+    auto getLeafIndexes = [&] (size_t documentIdxInBlock) {
+        return TStringBuf(
+            reinterpret_cast<const char*>(indices.data() + documentIdxInBlock * treeCount),
+            treeCount * sizeof(NModelEvaluation::TCalcerIndexType)
+        );
+    };
+
+    // documents to calculate and for others the document with the same leaf indexes (or documentCount if cached)
+    TVector<size_t> documentsToCalc;
+    TVector<size_t> sameLeafIndexesDocument;
+    const bool useCache = cache && cache->IsEnabled();
+    if (useCache) {
+        THashMap<TStringBuf, size_t> firstDocumentByLeafIndexes;
+        sameLeafIndexesDocument.resize(documentCount, documentCount);
+        for (size_t documentIdxInBlock : xrange(documentCount)) {
+            const auto leafIndexes = getLeafIndexes(documentIdxInBlock);
+            if (const auto* cachedShapValues = cache->Find(leafIndexes)) {
+                (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdxInBlock] = *cachedShapValues;
+                continue;
+            }
+            const auto [it, isNew] = firstDocumentByLeafIndexes.emplace(leafIndexes, documentIdxInBlock);
+            if (isNew) {
+                documentsToCalc.push_back(documentIdxInBlock);
+            } else {
+                sameLeafIndexesDocument[documentIdxInBlock] = it->second;
+                cache->CountRepeatedDocument();
+            }
+        }
+    } else {
+        documentsToCalc.resize(documentCount);
+        Iota(documentsToCalc.begin(), documentsToCalc.end(), 0);
+    }
+
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, documentsToCalc.size());
+    localExecutor->ExecRange([&] (size_t idx) {
+        const size_t documentIdxInBlock = documentsToCalc[idx];
         TVector<TVector<double>>& shapValues = (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdxInBlock];
 
         CalcShapValuesForDocumentMulti(
@@ -1110,7 +1217,7 @@ static void CalcShapValuesForDocumentBlockMulti(
             binarizedFeaturesForBlock.Get(),
             fixedFeatureParams,
             flatFeatureCount,
-            MakeArrayRef(indices.data() + documentIdxInBlock * model.GetTreeCount(), model.GetTreeCount()),
+            MakeArrayRef(indices.data() + documentIdxInBlock * treeCount, treeCount),
             documentIdxInBlock,
             &shapValues,
             calcType,
@@ -1118,6 +1225,23 @@ static void CalcShapValuesForDocumentBlockMulti(
         );
 
     }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    if (useCache) {
+        for (size_t documentIdxInBlock : xrange(documentCount)) {
+            const size_t sameDocumentIdxInBlock = sameLeafIndexesDocument[documentIdxInBlock];
+            if (sameDocumentIdxInBlock != documentCount) {
+                (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdxInBlock]
+                    = (*shapValuesForAllDocuments)[oldShapValuesSize + sameDocumentIdxInBlock];
+            }
+        }
+        for (size_t documentIdxInBlock : documentsToCalc) {
+            cache->Add(
+                getLeafIndexes(documentIdxInBlock),
+                (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdxInBlock]
+            );
+        }
+        cache->DisableIfUseless();
+    }
 }
 
 static void CalcShapValuesByLeafForTreeBlock(
@@ -1128,7 +1252,8 @@ static void CalcShapValuesByLeafForTreeBlock(
     const TMaybe<TFixedFeatureParams>& fixedFeatureParams,
     NPar::ILocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TConstArrayRef<bool> isTreeUsed
 ) {
     const auto& binFeatureCombinationClass = preparedTrees->BinFeatureCombinationClass;
     const auto& combinationClassFeatures = preparedTrees->CombinationClassFeatures;
@@ -1136,6 +1261,9 @@ static void CalcShapValuesByLeafForTreeBlock(
 
     NPar::ILocalExecutor::TExecRangeParams blockParams(start, end);
     localExecutor->ExecRange([&] (size_t treeIdx) {
+        if (!isTreeUsed.empty() && !isTreeUsed[treeIdx]) {
+            return;
+        }
         if (preparedTrees->CalcShapValuesByLeafForAllTrees && isOblivious) {
             const size_t leafCount = (size_t(1) << forest.GetModelTreeData()->GetTreeSizes()[treeIdx]);
             TVector<TVector<TShapValue>>& shapValuesByLeaf = preparedTrees->ShapValuesByLeafForAllTrees[treeIdx];
@@ -1211,7 +1339,8 @@ void CalcShapValuesByLeaf(
     bool calcInternalValues,
     NPar::ILocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TConstArrayRef<bool> isTreeUsed
 ) {
     const size_t treeCount = model.GetTreeCount();
     const size_t treeBlockSize = CB_THREAD_LIMIT; // least necessary for threading
@@ -1231,7 +1360,8 @@ void CalcShapValuesByLeaf(
             fixedFeatureParams,
             localExecutor,
             preparedTrees,
-            calcType
+            calcType,
+            isTreeUsed
         );
 
         processTreesProfile.FinishIterationBlock(end - start);
@@ -1408,6 +1538,9 @@ TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
     THolder<IFeaturesBlockIterator> featuresBlockIterator
         = CreateFeaturesBlockIterator(model, *dataset.ObjectsData, 0, documentCount);
 
+    TShapValuesByLeafIndexesCache cache(ShapValuesCacheMaxValuesCount);
+    TShapValuesByLeafIndexesCache* cachePtr = CanReuseShapValuesByLeafIndexes(model, calcType) ? &cache : nullptr;
+
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
 
@@ -1425,7 +1558,8 @@ TVector<TVector<TVector<double>>> CalcShapValuesWithPreparedTrees(
             end,
             localExecutor,
             &shapValues,
-            calcType
+            calcType,
+            cachePtr
         );
 
         processDocumentsProfile.FinishIterationBlock(end - start);
@@ -1538,7 +1672,8 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
     int logPeriod,
     TShapPreparedTrees* preparedTrees,
     NPar::ILocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    TConstArrayRef<bool> isTreeUsed
 ) {
     CalcShapValuesByLeaf(
         model,
@@ -1547,7 +1682,8 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
         preparedTrees->CalcInternalValues,
         localExecutor,
         preparedTrees,
-        calcType
+        calcType,
+        isTreeUsed
     );
     const TModelTrees& forest = *model.ModelTrees;
     TVector<TVector<TVector<double>>> shapValues(documentCount);
@@ -1569,7 +1705,9 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
                 docIndices,
                 documentIdxInBlock,
                 &shapValues[documentIdx],
-                calcType
+                calcType,
+                documentIdx,
+                isTreeUsed
             );
         }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
     }
@@ -1589,6 +1727,36 @@ static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapV
     }
 }
 
+// NumPy format version 1.0 header, see numpy.lib.format
+static void OutputNpyHeader(size_t documentCount, size_t approxDimension, size_t valuesCount, TFileOutput& out) {
+    TStringBuilder header;
+    header << "{'descr': '<f4', 'fortran_order': False, 'shape': (" << documentCount << ", ";
+    if (approxDimension > 1) {
+        header << approxDimension << ", ";
+    }
+    header << valuesCount << "), }";
+    const size_t prefixSize = 10; // magic string, version and header length
+    const size_t paddedSize = (prefixSize + header.size() + 1 + 63) / 64 * 64;
+    const size_t paddingSize = paddedSize - prefixSize - header.size() - 1;
+    header << TString(paddingSize, ' ') << '\n';
+
+    const ui16 headerSize = SafeIntegerCast<ui16>(header.size());
+    out.Write("\x93NUMPY\x01\x00", 8);
+    out.Write(&headerSize, sizeof(headerSize));
+    out.Write(header.data(), header.size());
+}
+
+static void OutputShapValuesMultiAsFloat32(const TVector<TVector<TVector<double>>>& shapValues, TFileOutput& out) {
+    static_assert(sizeof(float) == 4);
+    TVector<float> buffer;
+    for (const auto& shapValuesForDocument : shapValues) {
+        for (const auto& shapValuesForClass : shapValuesForDocument) {
+            buffer.assign(shapValuesForClass.begin(), shapValuesForClass.end());
+            out.Write(buffer.data(), buffer.size() * sizeof(float));
+        }
+    }
+}
+
 void CalcAndOutputShapValues(
     const TFullModel& model,
     const TDataProvider& dataset,
@@ -1596,7 +1764,8 @@ void CalcAndOutputShapValues(
     int logPeriod,
     EPreCalcShapValues mode,
     NPar::ILocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType
+    ECalcTypeShapValues calcType,
+    EShapValuesOutputFormat outputFormat
 ) {
     TShapPreparedTrees preparedTrees = PrepareTrees(
         model,
@@ -1630,7 +1799,17 @@ void CalcAndOutputShapValues(
     THolder<IFeaturesBlockIterator> featuresBlockIterator
         = CreateFeaturesBlockIterator(model, *dataset.ObjectsData, 0, documentCount);
 
+    TShapValuesByLeafIndexesCache cache(ShapValuesCacheMaxValuesCount);
+    TShapValuesByLeafIndexesCache* cachePtr = CanReuseShapValuesByLeafIndexes(model, calcType) ? &cache : nullptr;
+
     TFileOutput out(outputPath);
+    if (outputFormat == EShapValuesOutputFormat::Npy) {
+        const TString lossFunctionName = model.GetLossFunctionName();
+        const bool isRMSEWithUncertainty
+            = lossFunctionName && FromString<ELossFunction>(lossFunctionName) == ELossFunction::RMSEWithUncertainty;
+        const size_t approxDimension = isRMSEWithUncertainty ? 1 : model.GetDimensionsCount();
+        OutputNpyHeader(documentCount, approxDimension, flatFeatureCount + 1, out);
+    }
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
         processDocumentsProfile.StartIterationBlock();
@@ -1650,10 +1829,18 @@ void CalcAndOutputShapValues(
             end,
             localExecutor,
             &shapValuesForBlock,
-            calcType
+            calcType,
+            cachePtr
         );
 
-        OutputShapValuesMulti(shapValuesForBlock, out);
+        switch (outputFormat) {
+            case EShapValuesOutputFormat::Tsv:
+                OutputShapValuesMulti(shapValuesForBlock, out);
+                break;
+            case EShapValuesOutputFormat::Npy:
+                OutputShapValuesMultiAsFloat32(shapValuesForBlock, out);
+                break;
+        }
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
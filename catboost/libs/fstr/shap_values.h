@@ -55,7 +55,8 @@ void CalcShapValuesForDocumentMulti(
     size_t documentIdxInBlock,
     TVector<TVector<double>>* shapValues,
     ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
-    size_t documentIdx = (size_t)(-1)
+    size_t documentIdx = (size_t)(-1),
+    TConstArrayRef<bool> isTreeUsed = {} // empty means all trees, otherwise other trees are skipped
 );
 
 void CalcShapValuesForDocumentMulti(
@@ -76,7 +77,8 @@ void CalcShapValuesByLeaf(
     bool calcInternalValues,
     NPar::ILocalExecutor* localExecutor,
     TShapPreparedTrees* preparedTrees,
-    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
+    TConstArrayRef<bool> isTreeUsed = {} // empty means all trees
 );
 
 // returned: ShapValues[documentIdx][dimension][feature]
@@ -126,10 +128,12 @@ TVector<TVector<TVector<double>>> CalcShapValueWithQuantizedData(
     int logPeriod,
     TShapPreparedTrees* preparedTrees,
     NPar::ILocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
+    TConstArrayRef<bool> isTreeUsed = {} // empty means all trees
 );
 
 // outputs for each document in order for each dimension in order an array of feature contributions
+// documents are processed and written block by block, so memory does not depend on documents count
 void CalcAndOutputShapValues(
     const TFullModel& model,
     const NCB::TDataProvider& dataset,
@@ -137,7 +141,8 @@ void CalcAndOutputShapValues(
     int logPeriod,
     EPreCalcShapValues mode,
     NPar::ILocalExecutor* localExecutor,
-    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular
+    ECalcTypeShapValues calcType = ECalcTypeShapValues::Regular,
+    EShapValuesOutputFormat outputFormat = EShapValuesOutputFormat::Tsv
 );
 
 void CalcShapValuesInternalForFeature(
@@ -0,0 +1,48 @@
+#include "grouped_index_hash.h"
+
+#include <util/generic/bitops.h>
+#include <util/generic/ymath.h>
+
+
+namespace NCatboost {
+
+    TGroupedIndexHash::TGroupedIndexHash(const TDenseIndexHashView& denseIndex) {
+        const size_t elementCount = denseIndex.CountNonEmptyBuckets();
+        // at most 7/8 of slots are used, so every probe sequence reaches a group with an empty slot
+        const size_t groupCount = FastClp2(Max<size_t>(CeilDiv<size_t>(elementCount * 8, GroupSize * 7), 1));
+        GroupMask = groupCount - 1;
+        Tags.assign(groupCount * GroupSize, EmptyTag);
+        Buckets.assign(groupCount * GroupSize, TBucket{TBucket::InvalidHashValue, 0});
+        for (const auto& bucket : denseIndex.GetBuckets()) {
+            if (bucket.Hash == TBucket::InvalidHashValue) {
+                continue;
+            }
+            for (size_t groupIdx = bucket.Hash & GroupMask; ; groupIdx = (groupIdx + 1) & GroupMask) {
+                const size_t groupStart = groupIdx * GroupSize;
+                size_t slot = 0;
+                while (slot < GroupSize && Tags[groupStart + slot] != EmptyTag) {
+                    ++slot;
+                }
+                if (slot < GroupSize) {
+                    Tags[groupStart + slot] = GetTag(bucket.Hash);
+                    Buckets[groupStart + slot] = bucket;
+                    break;
+                }
+            }
+        }
+    }
+
+    void TGroupedIndexHash::GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui64> indexes) const {
+        CB_ENSURE_INTERNAL(hashes.size() <= indexes.size(), "Insufficient indexes size");
+        const size_t count = hashes.size();
+        for (size_t idx = 0; idx < Min(count, PrefetchDistance); ++idx) {
+            Prefetch(hashes[idx]);
+        }
+        for (size_t idx = 0; idx < count; ++idx) {
+            if (idx + PrefetchDistance < count) {
+                Prefetch(hashes[idx + PrefetchDistance]);
+            }
+            indexes[idx] = GetIndex(hashes[idx]);
+        }
+    }
+}
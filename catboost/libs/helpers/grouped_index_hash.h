@@ -0,0 +1,89 @@
+#pragma once
+
+#include "dense_hash_view.h"
+
+#include <library/cpp/sse/sse.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/bitops.h>
+#include <util/generic/vector.h>
+#include <util/system/compiler.h>
+#include <util/system/types.h>
+
+namespace NCatboost {
+
+    /**
+     * Read-only index [ui64] -> [ui32] with the contents of a TDenseIndexHashView, laid out for large tables.
+     * Slots are split into groups of GroupSize, every slot has a one byte tag holding 7 high bits of its hash,
+     * so a probe matches tags of a whole group with one SIMD compare and reads buckets only for tag matches.
+     * Hashes are placed into the first group with an empty slot starting from the one of their low bits, so
+     * probes stop at the first group with an empty tag.
+     */
+    class TGroupedIndexHash {
+    public:
+        static constexpr size_t GroupSize = 16;
+        static constexpr ui8 EmptyTag = 0x80;
+        static constexpr ui32 NotFoundIndex = TDenseIndexHashView::NotFoundIndex;
+        // Batch lookup probes this many hashes ahead of the one being resolved
+        static constexpr size_t PrefetchDistance = 8;
+
+    public:
+        explicit TGroupedIndexHash(const TDenseIndexHashView& denseIndex);
+
+        ui32 GetIndex(ui64 hash) const {
+            const ui8 tag = GetTag(hash);
+            for (size_t groupIdx = hash & GroupMask; ; groupIdx = (groupIdx + 1) & GroupMask) {
+                const size_t groupStart = groupIdx * GroupSize;
+                ui32 matchMask;
+                ui32 emptyMask;
+#if defined(ARCADIA_SSE)
+                const __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Tags.data() + groupStart));
+                matchMask = _mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(tag)));
+                // only the empty tag has the high bit set
+                emptyMask = _mm_movemask_epi8(tags);
+#else
+                matchMask = 0;
+                emptyMask = 0;
+                for (size_t slot = 0; slot < GroupSize; ++slot) {
+                    matchMask |= ui32(Tags[groupStart + slot] == tag) << slot;
+                    emptyMask |= ui32(Tags[groupStart + slot] == EmptyTag) << slot;
+                }
+#endif
+                for (; matchMask; matchMask &= matchMask - 1) {
+                    const TBucket& bucket = Buckets[groupStart + CountTrailingZeroBits(matchMask)];
+                    if (bucket.Hash == hash) {
+                        return bucket.IndexValue;
+                    }
+                }
+                if (emptyMask) {
+                    return NotFoundIndex;
+                }
+            }
+        }
+
+        // Same as GetIndex for every hash, with memory of following hashes' groups prefetched
+        void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui64> indexes) const;
+
+        size_t GetGroupCount() const {
+            return Tags.size() / GroupSize;
+        }
+
+    private:
+        static ui8 GetTag(ui64 hash) {
+            return hash >> 57;
+        }
+
+        void Prefetch(ui64 hash) const {
+            const size_t groupStart = (hash & GroupMask) * GroupSize;
+            Y_PREFETCH_READ(Tags.data() + groupStart, 1);
+            // groups are filled from the first slot, so most of their buckets are in the first two cache lines
+            Y_PREFETCH_READ(Buckets.data() + groupStart, 1);
+            Y_PREFETCH_READ(reinterpret_cast<const char*>(Buckets.data() + groupStart) + 64, 1);
+        }
+
+    private:
+        ui64 GroupMask = 0;
+        TVector<ui8> Tags;
+        TVector<TBucket> Buckets;
+    };
+}
@@ -20,13 +20,17 @@ static TJsonValue VectorToJson(const TVector<T>& values) {
     return jsonValue;
 }
 
-static void WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput, IOutputStream* out) {
+inline TJsonWriterConfig GetCatBoostPrecisionJsonWriterConfig(bool formatOutput) {
     TJsonWriterConfig config;
     config.FormatOutput = formatOutput;
     config.FloatNDigits = 9;
     config.DoubleNDigits = 17;
     config.SortKeys = true;
-    WriteJson(out, &value, config);
+    return config;
+}
+
+static void WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput, IOutputStream* out) {
+    WriteJson(out, &value, GetCatBoostPrecisionJsonWriterConfig(formatOutput));
 }
 
 inline TString WriteJsonWithCatBoostPrecision(const TJsonValue& value, bool formatOutput) {
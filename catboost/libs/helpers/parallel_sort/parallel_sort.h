@@ -3,7 +3,12 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+
+#include <cstring>
+#include <type_traits>
 
 namespace NCB {
 
@@ -151,4 +156,165 @@ namespace NCB {
             startPositions = newStartPositions;
         }
     }
+
+    namespace NPrivate {
+        inline ui32 ToRadixKey(ui32 key) {
+            return key;
+        }
+
+        inline ui64 ToRadixKey(ui64 key) {
+            return key;
+        }
+
+        // order of the result matches the order of floats (-0.0f precedes +0.0f), nans go to the ends
+        inline ui32 ToRadixKey(float key) {
+            ui32 bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        }
+
+        inline ui64 ToRadixKey(double key) {
+            ui64 bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+        }
+    }
+
+    /* Stable LSD radix sort by getKey(element) in ascending order, getKey must return ui32, ui64, float or double.
+     * Use a negated key for descending order.
+     * Each pass over an 8-bit digit is parallelized over blocks of elements, passes where all elements
+     * have the same digit are skipped.
+     */
+    template <class TElement, class TGetKey>
+    inline void ParallelRadixSort(
+        TArrayRef<TElement> elements,
+        TGetKey getKey,
+        NPar::ILocalExecutor* localExecutor,
+        TVector<TElement>* buf = nullptr
+    ) {
+        static_assert(std::is_trivially_copyable<TElement>::value, "");
+        using TKey = decltype(NPrivate::ToRadixKey(getKey(elements[0])));
+        constexpr ui32 DigitBits = 8;
+        constexpr ui32 DigitCount = 1 << DigitBits;
+        constexpr ui32 MinBlockSize = 16384;
+
+        const ui32 size = elements.size();
+        if (size <= 1) {
+            return;
+        }
+        TVector<TElement> newBuf;
+        if (buf == nullptr) {
+            buf = &newBuf;
+        }
+        buf->yresize(size);
+
+        const ui32 blockCount = Min<ui32>(localExecutor->GetThreadCount() + 1, CeilDiv(size, MinBlockSize));
+        TVector<ui32> blockSizes;
+        EquallyDivide(size, blockCount, &blockSizes);
+        TVector<ui32> blockStarts(blockCount + 1, 0);
+        for (ui32 blockId = 0; blockId < blockCount; ++blockId) {
+            blockStarts[blockId + 1] = blockStarts[blockId] + blockSizes[blockId];
+        }
+
+        TVector<ui32> offsets(blockCount * DigitCount);
+        TElement* src = elements.data();
+        TElement* dst = buf->data();
+        for (ui32 shift = 0; shift < sizeof(TKey) * 8; shift += DigitBits) {
+            auto getDigit = [&] (const TElement& element) {
+                return (NPrivate::ToRadixKey(getKey(element)) >> shift) & (DigitCount - 1);
+            };
+            Fill(offsets.begin(), offsets.end(), 0);
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&] (int blockId) {
+                    ui32* blockCounts = offsets.data() + blockId * DigitCount;
+                    for (ui32 i = blockStarts[blockId]; i < blockStarts[blockId + 1]; ++i) {
+                        ++blockCounts[getDigit(src[i])];
+                    }
+                }
+            );
+            const ui32 firstDigit = getDigit(src[0]);
+            bool isSameDigit = true;
+            for (ui32 blockId = 0; blockId < blockCount; ++blockId) {
+                isSameDigit &= offsets[blockId * DigitCount + firstDigit] == blockSizes[blockId];
+            }
+            if (isSameDigit) {
+                continue;
+            }
+            // digit-major, block-minor order of output ranges keeps the sort stable
+            ui32 position = 0;
+            for (ui32 digit = 0; digit < DigitCount; ++digit) {
+                for (ui32 blockId = 0; blockId < blockCount; ++blockId) {
+                    const ui32 count = offsets[blockId * DigitCount + digit];
+                    offsets[blockId * DigitCount + digit] = position;
+                    position += count;
+                }
+            }
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&] (int blockId) {
+                    ui32* blockOffsets = offsets.data() + blockId * DigitCount;
+                    for (ui32 i = blockStarts[blockId]; i < blockStarts[blockId + 1]; ++i) {
+                        dst[blockOffsets[getDigit(src[i])]++] = src[i];
+                    }
+                }
+            );
+            std::swap(src, dst);
+        }
+        if (src != elements.data()) {
+            NPar::ParallelFor(
+                *localExecutor,
+                0,
+                blockCount,
+                [&] (int blockId) {
+                    std::copy(src + blockStarts[blockId], src + blockStarts[blockId + 1], elements.data() + blockStarts[blockId]);
+                }
+            );
+        }
+    }
+
+    /* Sorts each segment [segmentOffsets[i], segmentOffsets[i + 1]) of elements independently,
+     * segmentOffsets must be non-decreasing and end with elements.size().
+     * Segments (e.g. queries or leaves) are distributed between threads in groups of roughly equal total size.
+     */
+    template <class TElement, typename TCompare>
+    inline void ParallelSegmentedSort(
+        TConstArrayRef<ui32> segmentOffsets,
+        TArrayRef<TElement> elements,
+        TCompare cmp,
+        NPar::ILocalExecutor* localExecutor
+    ) {
+        if (segmentOffsets.size() <= 1) {
+            return;
+        }
+        const ui32 segmentCount = segmentOffsets.size() - 1;
+        const ui64 totalSize = segmentOffsets.back() - segmentOffsets[0];
+        const ui32 groupCount = Min<ui32>(segmentCount, (localExecutor->GetThreadCount() + 1) * 4);
+        TVector<ui32> groupStarts = {0};
+        for (ui32 segmentIdx = 1; segmentIdx < segmentCount; ++segmentIdx) {
+            const ui64 groupSize = segmentOffsets[segmentIdx] - segmentOffsets[groupStarts.back()];
+            if (groupSize * groupCount >= totalSize) {
+                groupStarts.push_back(segmentIdx);
+            }
+        }
+        groupStarts.push_back(segmentCount);
+        NPar::ParallelFor(
+            *localExecutor,
+            0,
+            groupStarts.size() - 1,
+            [&] (int groupIdx) {
+                for (ui32 segmentIdx = groupStarts[groupIdx]; segmentIdx < groupStarts[groupIdx + 1]; ++segmentIdx) {
+                    StableSort(
+                        elements.begin() + segmentOffsets[segmentIdx],
+                        elements.begin() + segmentOffsets[segmentIdx + 1],
+                        cmp
+                    );
+                }
+            }
+        );
+    }
 }
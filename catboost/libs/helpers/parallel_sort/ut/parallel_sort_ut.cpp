@@ -6,6 +6,8 @@
 #include <util/generic/algorithm.h>
 #include <util/random/shuffle.h>
 
+#include <limits>
+
 static TVector<ui32> GeneratePermutation(size_t size, TRandom& rnd) {
     TVector<ui32> permutation(size);
     std::iota(permutation.begin(), permutation.end(), 0);
@@ -164,4 +166,92 @@ Y_UNIT_TEST_SUITE(ParallelSortTests) {
             UNIT_ASSERT_GE(currentVector[i + 1], currentVector[i]);
         }
     }
+
+    template <class TKey>
+    static void CheckRadixSortIsStable(const TVector<TKey>& keys, int additionalThreadCount) {
+        struct TElement {
+            TKey Key;
+            ui32 Payload;
+        };
+        TVector<TElement> elements;
+        for (ui32 i = 0; i < keys.size(); ++i) {
+            elements.push_back({keys[i], i});
+        }
+        TVector<TElement> expected = elements;
+        StableSort(expected, [] (const TElement& lhs, const TElement& rhs) { return lhs.Key < rhs.Key; });
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(additionalThreadCount);
+        NCB::ParallelRadixSort(MakeArrayRef(elements), [] (const TElement& element) { return element.Key; }, &localExecutor);
+        for (size_t i = 0; i < elements.size(); ++i) {
+            UNIT_ASSERT_VALUES_EQUAL(elements[i].Key, expected[i].Key);
+            UNIT_ASSERT_VALUES_EQUAL(elements[i].Payload, expected[i].Payload);
+        }
+    }
+
+    Y_UNIT_TEST(ParallelRadixSortUi32Test) {
+        TRandom rnd(239);
+        const ui32 size = 300000;
+        CheckRadixSortIsStable(RandomVector(size, size / 100u, rnd), 7);
+        CheckRadixSortIsStable(RandomVector(size, 13u, rnd), 0);
+
+        TVector<ui32> largeKeys(size);
+        for (auto& key : largeKeys) {
+            key = ui32(rnd.NextUniformL());
+        }
+        CheckRadixSortIsStable(largeKeys, 7);
+        CheckRadixSortIsStable(TVector<ui32>{}, 7);
+        CheckRadixSortIsStable(TVector<ui32>{5}, 7);
+    }
+
+    Y_UNIT_TEST(ParallelRadixSortFloatTest) {
+        TRandom rnd(239);
+        const ui32 size = 300000;
+        TVector<float> floatKeys(size);
+        TVector<double> doubleKeys(size);
+        for (ui32 i = 0; i < size; ++i) {
+            floatKeys[i] = (int(rnd(2001)) - 1000) * 0.25f;
+            doubleKeys[i] = (rnd.NextUniform() - 0.5) * 1e10;
+        }
+        floatKeys[0] = -std::numeric_limits<float>::infinity();
+        floatKeys[1] = std::numeric_limits<float>::infinity();
+        CheckRadixSortIsStable(floatKeys, 7);
+        CheckRadixSortIsStable(doubleKeys, 3);
+    }
+
+    Y_UNIT_TEST(ParallelRadixSortOwnBufTest) {
+        TRandom rnd(239);
+        TVector<float> values(100000);
+        for (auto& value : values) {
+            value = rnd.NextUniform() - 0.5;
+        }
+        TVector<float> expected = values;
+        Sort(expected);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TVector<float> buf;
+        NCB::ParallelRadixSort(MakeArrayRef(values), [] (float value) { return -value; }, &localExecutor, &buf);
+        Reverse(expected.begin(), expected.end());
+        UNIT_ASSERT_VALUES_EQUAL(values, expected);
+    }
+
+    Y_UNIT_TEST(ParallelSegmentedSortTest) {
+        TRandom rnd(239);
+        const TVector<ui32> segmentSizes = {0, 1, 100000, 3, 0, 5000, 17, 1, 20000};
+        TVector<ui32> segmentOffsets = {0};
+        for (auto segmentSize : segmentSizes) {
+            segmentOffsets.push_back(segmentOffsets.back() + segmentSize);
+        }
+        TVector<ui32> values = GeneratePermutation(segmentOffsets.back(), rnd);
+        TVector<ui32> expected = values;
+        for (size_t i = 0; i + 1 < segmentOffsets.size(); ++i) {
+            Sort(expected.begin() + segmentOffsets[i], expected.begin() + segmentOffsets[i + 1], CmpGreater);
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(7);
+        NCB::ParallelSegmentedSort(MakeConstArrayRef(segmentOffsets), MakeArrayRef(values), CmpGreater, &localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(values, expected);
+    }
 }
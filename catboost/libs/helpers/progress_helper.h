@@ -81,6 +81,18 @@ public:
         reader(&input);
     }
 
+    /* Same as CheckedLoad, but the file is memory mapped, so large progress data (e.g. fold approxes)
+     * is read from the mapping without intermediate stream buffering.
+     */
+    template <class TReader>
+    void CheckedLoadMapped(const TFsPath& path, TReader&& reader) {
+        TString label;
+        TMappedFileInput input(path.GetPath());
+        ::Load(&input, label);
+        CB_ENSURE(Label == label, "Error: expect " << Label << " progress. Got " << label);
+        reader(&input);
+    }
+
 private:
     TString Label;
     TString ExceptionMessage;
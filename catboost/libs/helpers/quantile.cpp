@@ -7,73 +7,109 @@
 #include <util/generic/ymath.h>
 
 #include <algorithm>
+#include <cfloat>
 
 namespace {
     struct TValueWithWeight {
         float Value;
         float Weight;
     };
+
+    struct TQuantileQuery {
+        double NeedWeight;
+        size_t ResultIdx;
+    };
 }
 
-static double CalcSampleQuantileBinarySearch(
-    TConstArrayRef<float> sampleRef,
-    TConstArrayRef<float> weightsRef,
-    const double alpha
+static float MedianOfThree(float a, float b, float c) {
+    return Max(Min(a, b), Min(Max(a, b), c));
+}
+
+static void SelectQuantilesInSortedElements(
+    TConstArrayRef<TValueWithWeight> elements,
+    double collectedWeight,
+    TConstArrayRef<TQuantileQuery> queries, // ordered by NeedWeight
+    TArrayRef<double> results
 ) {
-    constexpr int BINARY_SEARCH_ITERATIONS = 100;
+    size_t elementIdx = 0;
+    double sumWeight = collectedWeight + elements[0].Weight;
+    for (const auto& query : queries) {
+        while (sumWeight < query.NeedWeight - DBL_EPSILON && elementIdx + 1 < elements.size()) {
+            ++elementIdx;
+            sumWeight += elements[elementIdx].Weight;
+        }
+        results[query.ResultIdx] = elements[elementIdx].Value;
+    }
+}
 
-    const double totalWeight = Accumulate(weightsRef, 0.0);
-    const double needWeight = totalWeight * alpha;
+/*
+ * Weighted quickselect for several quantiles at once: a three-way partition around a pivot splits the queries
+ * between less, equal and greater parts, and only the parts containing answers are processed further.
+ * Sample values before elements have total weight collectedWeight and are less than all values in elements.
+ */
+static void SelectQuantiles(
+    TArrayRef<TValueWithWeight> elements,
+    double collectedWeight,
+    TConstArrayRef<TQuantileQuery> queries, // ordered by NeedWeight
+    TArrayRef<double> results
+) {
+    constexpr size_t MAX_SIZE_TO_SORT = 32;
 
-    const auto minMaxSamples = MinMaxElement(sampleRef.begin(), sampleRef.end());
-    double lQ = *minMaxSamples.first - DBL_EPSILON;
-    double rQ = *minMaxSamples.second;
+    while (!queries.empty()) {
+        Y_ASSERT(!elements.empty());
+        if (elements.size() <= MAX_SIZE_TO_SORT) {
+            Sort(elements, [](const TValueWithWeight& elem1, const TValueWithWeight& elem2) {
+                return elem1.Value < elem2.Value;
+            });
+            SelectQuantilesInSortedElements(elements, collectedWeight, queries, results);
+            return;
+        }
 
-    const size_t sampleSize = sampleRef.size();
-    TVector<TValueWithWeight> elements;
-    elements.yresize(sampleSize);
-    for (auto i : xrange(sampleSize)) {
-        elements[i] = {sampleRef[i], weightsRef[i]};
-    }
-    /*
-     * We will support the following invariant:
-     * total weight of elements with sample values <= lQ is strictly less than needWeight
-     * total weight of elements with sample values <= rQ is greater or equal than needWeight
-     * elements with indices < l are less or equal than q
-     * elements with indices > r are greater than q
-     */
-    int l = 0, r = sampleSize;
-    double collectedLeftWeight = 0;
-    for (auto it : xrange(BINARY_SEARCH_ITERATIONS)) {
-        Y_UNUSED(it);
-        const double q = (lQ + rQ) / 2;
-        auto partitionIt = std::partition(
-            elements.begin() + l,
-            elements.begin() + r,
-            [q](const TValueWithWeight& element) {
-                return element.Value <= q;
-            }
-        );
-        const double partitionLeftWeight = Accumulate(
-            elements.begin() + l,
-            partitionIt,
-            0.0,
-            [](double sum, const TValueWithWeight& element) {
-                return sum + element.Weight;
+        const float pivot = MedianOfThree(
+            elements.front().Value,
+            elements[elements.size() / 2].Value,
+            elements.back().Value);
+        size_t lessEnd = 0;
+        size_t greaterBegin = elements.size();
+        double lessWeight = 0;
+        double equalWeight = 0;
+        for (size_t i = 0; i < greaterBegin;) {
+            const float value = elements[i].Value;
+            if (value < pivot) {
+                lessWeight += elements[i].Weight;
+                std::swap(elements[lessEnd++], elements[i++]);
+            } else if (value > pivot) {
+                std::swap(elements[i], elements[--greaterBegin]);
+            } else {
+                equalWeight += elements[i].Weight;
+                ++i;
             }
-        );
-        const int partitionPoint = partitionIt - elements.begin();
+        }
 
-        if (collectedLeftWeight + partitionLeftWeight < needWeight - DBL_EPSILON) {
-            l = partitionPoint;
-            lQ = q;
-            collectedLeftWeight += partitionLeftWeight;
-        } else {
-            r = partitionPoint;
-            rQ = q;
+        const auto inLessEnd = lessEnd == 0
+            ? queries.begin()
+            : FindIf(queries, [&](const TQuantileQuery& query) {
+                return collectedWeight + lessWeight < query.NeedWeight - DBL_EPSILON;
+            });
+        const auto inEqualEnd = greaterBegin == elements.size()
+            ? queries.end()
+            : std::find_if(inLessEnd, queries.end(), [&](const TQuantileQuery& query) {
+                return collectedWeight + lessWeight + equalWeight < query.NeedWeight - DBL_EPSILON;
+            });
+        for (auto it = inLessEnd; it != inEqualEnd; ++it) {
+            results[it->ResultIdx] = pivot;
+        }
+        if (inLessEnd != queries.begin()) {
+            SelectQuantiles(
+                elements.Slice(0, lessEnd),
+                collectedWeight,
+                TConstArrayRef<TQuantileQuery>(queries.begin(), inLessEnd),
+                results);
         }
+        elements = elements.Slice(greaterBegin);
+        collectedWeight += lessWeight + equalWeight;
+        queries = TConstArrayRef<TQuantileQuery>(inEqualEnd, queries.end());
     }
-    return rQ;
 }
 
 static double CalcSampleQuantileLinearSearch(
@@ -102,6 +138,48 @@ static double CalcSampleQuantileLinearSearch(
     return elements.back().Value;
 }
 
+TVector<double> CalcSampleQuantiles(
+    TConstArrayRef<float> sampleRef,
+    TConstArrayRef<float> weightsRef,
+    TConstArrayRef<double> alphas
+) {
+    TVector<double> quantiles(alphas.size(), 0.0);
+    if (sampleRef.empty()) {
+        return quantiles;
+    }
+    TVector<float> defaultWeights;
+    if (weightsRef.empty()) {
+        defaultWeights.resize(sampleRef.size(), 1.0);
+        weightsRef = defaultWeights;
+    }
+    Y_ASSERT(sampleRef.size() == weightsRef.size());
+
+    const double totalWeight = Accumulate(weightsRef, 0.0);
+    TVector<TQuantileQuery> queries;
+    for (auto i : xrange(alphas.size())) {
+        if (alphas[i] <= 0) {
+            quantiles[i] = *MinElement(sampleRef.begin(), sampleRef.end());
+        } else {
+            Y_ASSERT(alphas[i] <= 1);
+            queries.push_back({totalWeight * alphas[i], i});
+        }
+    }
+    if (queries.empty()) {
+        return quantiles;
+    }
+    StableSort(queries, [](const TQuantileQuery& lhs, const TQuantileQuery& rhs) {
+        return lhs.NeedWeight < rhs.NeedWeight;
+    });
+
+    TVector<TValueWithWeight> elements;
+    elements.yresize(sampleRef.size());
+    for (auto i : xrange(sampleRef.size())) {
+        elements[i] = {sampleRef[i], weightsRef[i]};
+    }
+    SelectQuantiles(elements, /*collectedWeight*/ 0.0, queries, quantiles);
+    return quantiles;
+}
+
 double CalcSampleQuantile(
     TConstArrayRef<float> sampleRef,
     TConstArrayRef<float> weightsRef,
@@ -114,13 +192,14 @@ double CalcSampleQuantile(
         return *MinElement(sampleRef.begin(), sampleRef.end());
     }
     Y_ASSERT(0 <= alpha && alpha <= 1);
+    if (sampleRef.size() >= 100) {
+        return CalcSampleQuantiles(sampleRef, weightsRef, MakeArrayRef(&alpha, 1))[0];
+    }
     TVector<float> defaultWeights;
     if (weightsRef.empty()) {
         defaultWeights.resize(sampleRef.size(), 1.0);
         weightsRef = defaultWeights;
     }
     Y_ASSERT(sampleRef.size() == weightsRef.size());
-    return sampleRef.size() < 100
-        ? CalcSampleQuantileLinearSearch(sampleRef, weightsRef, alpha)
-        : CalcSampleQuantileBinarySearch(sampleRef, weightsRef, alpha);
+    return CalcSampleQuantileLinearSearch(sampleRef, weightsRef, alpha);
 }
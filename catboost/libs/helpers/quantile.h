@@ -10,3 +10,12 @@ double CalcSampleQuantile(
     TConstArrayRef<float> weights,
     double alpha
 );
+
+/*
+ * The same for several alphas in one pass. Uses selection instead of a full sort of sample.
+ */
+TVector<double> CalcSampleQuantiles(
+    TConstArrayRef<float> sample,
+    TConstArrayRef<float> weights,
+    TConstArrayRef<double> alphas
+);
@@ -0,0 +1 @@
+#include "rank2_array.h"
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+
+namespace NCB {
+
+    /**
+     * Rank 2 array [dim1][dim2] stored in one contiguous block instead of TVector<TVector<T>>.
+     * Rows start at multiples of cache line size from the block start, so rows processed by different
+     * threads don't share cache lines. Element type defines precision, e.g. float or double.
+     */
+    template <class T>
+    class TRank2Array {
+    public:
+        static constexpr size_t RowAlignment = 64;
+
+    public:
+        TRank2Array() = default;
+
+        TRank2Array(size_t dim1, size_t dim2, T value = T()) {
+            Resize(dim1, dim2, value);
+        }
+
+        // Elements are left uninitialized, as with TVector::yresize
+        void Allocate(size_t dim1, size_t dim2) {
+            SetShape(dim1, dim2);
+            Data.yresize(Dim1 * Stride);
+        }
+
+        void Resize(size_t dim1, size_t dim2, T value = T()) {
+            SetShape(dim1, dim2);
+            Data.assign(Dim1 * Stride, value);
+        }
+
+        void Clear() {
+            Dim1 = 0;
+            Dim2 = 0;
+            Stride = 0;
+            Data.clear();
+        }
+
+        size_t size() const {
+            return Dim1;
+        }
+
+        int ysize() const {
+            return (int)Dim1;
+        }
+
+        bool empty() const {
+            return Dim1 == 0;
+        }
+
+        size_t GetRowSize() const {
+            return Dim2;
+        }
+
+        TArrayRef<T> operator[](size_t idx1) {
+            Y_ASSERT(idx1 < Dim1);
+            return TArrayRef<T>(Data.data() + idx1 * Stride, Dim2);
+        }
+
+        TConstArrayRef<T> operator[](size_t idx1) const {
+            Y_ASSERT(idx1 < Dim1);
+            return TConstArrayRef<T>(Data.data() + idx1 * Stride, Dim2);
+        }
+
+        TArrayRef<T> front() {
+            return (*this)[0];
+        }
+
+        TConstArrayRef<T> front() const {
+            return (*this)[0];
+        }
+
+        TVector<TArrayRef<T>> GetRows() {
+            TVector<TArrayRef<T>> rows;
+            rows.reserve(Dim1);
+            for (size_t idx1 = 0; idx1 < Dim1; ++idx1) {
+                rows.push_back((*this)[idx1]);
+            }
+            return rows;
+        }
+
+        TVector<TConstArrayRef<T>> GetRows() const {
+            TVector<TConstArrayRef<T>> rows;
+            rows.reserve(Dim1);
+            for (size_t idx1 = 0; idx1 < Dim1; ++idx1) {
+                rows.push_back((*this)[idx1]);
+            }
+            return rows;
+        }
+
+    private:
+        void SetShape(size_t dim1, size_t dim2) {
+            const size_t rowAlignmentInElements = Max<size_t>(RowAlignment / sizeof(T), 1);
+            Dim1 = dim1;
+            Dim2 = dim2;
+            Stride = CeilDiv(dim2, rowAlignmentInElements) * rowAlignmentInElements;
+        }
+
+    private:
+        size_t Dim1 = 0;
+        size_t Dim2 = 0;
+        size_t Stride = 0;
+        TVector<T> Data;
+    };
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/random/fast.h>
 #include <util/ysaveload.h>
+#include <util/generic/utility.h>
 #include <util/generic/vector.h>
 
 struct TRestorableFastRng64 : public TCommonRNG<ui64, TRestorableFastRng64> {
@@ -54,3 +57,37 @@ private:
 };
 
 TVector<ui64> GenRandUI64Vector(int size, ui64 randomSeed);
+
+/* Calls generateBlock(blockBegin, blockEnd, blockRand) in parallel for blocks of [0, count).
+ * If generateBlock makes exactly one GenRand call (like GenRandReal1) for each element, values are
+ * the same as generated by rand sequentially for all elements, because blockRand is rand advanced
+ * to the block begin (advance of the underlying LCGs takes logarithmic time).
+ * rand is advanced by count.
+ */
+template <class TGenerateBlock>
+void ParallelGenRandByBlocks(
+    int count,
+    int blockSize,
+    NPar::ILocalExecutor* localExecutor,
+    TRestorableFastRng64* rand,
+    const TGenerateBlock& generateBlock
+) {
+    if (count == 0) {
+        return;
+    }
+    const TRestorableFastRng64& srcRand = *rand;
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, count);
+    blockParams.SetBlockSize(blockSize);
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            const int blockBegin = blockIdx * blockParams.GetBlockSize();
+            const int blockEnd = Min(blockBegin + blockParams.GetBlockSize(), count);
+            TRestorableFastRng64 blockRand = srcRand;
+            blockRand.Advance(blockBegin);
+            generateBlock(blockBegin, blockEnd, &blockRand);
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+    rand->Advance(count);
+}
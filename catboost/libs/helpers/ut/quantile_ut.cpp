@@ -3,9 +3,12 @@
 #include <catboost/libs/helpers/quantile.h>
 #include <catboost/private/libs/options/restrictions.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
 
 #include <cfloat>
 
@@ -201,4 +204,39 @@ Y_UNIT_TEST_SUITE(TCalcQuantile) {
         TVector<float> sample =    {0,     1,      2,      3,      4,      5,      6,      7};
         UNIT_ASSERT_DOUBLES_EQUAL(CalcSampleQuantile(sample, weightsHasWeights, 0.52), 4 , 1e-6);
     }
+
+    Y_UNIT_TEST(TCalcQuantilesLargeSample) {
+        TFastRng64 rng(17);
+        TVector<float> sample;
+        TVector<float> weights;
+        for (auto i : xrange(5000)) {
+            Y_UNUSED(i);
+            sample.push_back(static_cast<int>(rng.Uniform(200)) * 0.5f - 30);
+            weights.push_back(rng.Uniform(4) == 0 ? 0.0f : static_cast<float>(1 + rng.Uniform(4)));
+        }
+        const TVector<double> alphas = {0.9, 0.01, 0.5, 0.0, 1.0, 0.5, 0.25};
+
+        TVector<std::pair<float, float>> sorted;
+        for (auto i : xrange(sample.size())) {
+            sorted.emplace_back(sample[i], weights[i]);
+        }
+        Sort(sorted);
+        const double totalWeight = Accumulate(weights, 0.0);
+
+        const TVector<double> quantiles = CalcSampleQuantiles(sample, weights, alphas);
+        UNIT_ASSERT_VALUES_EQUAL(quantiles.size(), alphas.size());
+        for (auto i : xrange(alphas.size())) {
+            double expected = sorted[0].first;
+            double sumWeight = 0;
+            for (const auto& [value, weight] : sorted) {
+                sumWeight += weight;
+                expected = value;
+                if (alphas[i] <= 0 || sumWeight >= totalWeight * alphas[i] - DBL_EPSILON) {
+                    break;
+                }
+            }
+            UNIT_ASSERT_VALUES_EQUAL(quantiles[i], expected);
+            UNIT_ASSERT_VALUES_EQUAL(CalcSampleQuantile(sample, weights, alphas[i]), expected);
+        }
+    }
 }
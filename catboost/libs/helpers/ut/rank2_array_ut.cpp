@@ -0,0 +1,78 @@
+#include <catboost/libs/helpers/rank2_array.h>
+
+#include <util/generic/xrange.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TRank2ArrayTest) {
+    Y_UNIT_TEST(TestEmpty) {
+        TRank2Array<double> array;
+        UNIT_ASSERT(array.empty());
+        UNIT_ASSERT_VALUES_EQUAL(array.size(), 0);
+        UNIT_ASSERT(array.GetRows().empty());
+    }
+
+    template <class T>
+    static void TestResize() {
+        TRank2Array<T> array(3, 5, T(2));
+        UNIT_ASSERT_VALUES_EQUAL(array.size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(array.ysize(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(array.GetRowSize(), 5);
+        for (auto idx1 : xrange(array.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(array[idx1].size(), 5);
+            for (auto idx2 : xrange(array.GetRowSize())) {
+                UNIT_ASSERT_VALUES_EQUAL(array[idx1][idx2], T(2));
+                array[idx1][idx2] = T(idx1 * 10 + idx2);
+            }
+        }
+        const TRank2Array<T>& constArray = array;
+        const auto rows = constArray.GetRows();
+        UNIT_ASSERT_VALUES_EQUAL(rows.size(), 3);
+        for (auto idx1 : xrange(rows.size())) {
+            UNIT_ASSERT_EQUAL(
+                static_cast<size_t>(rows[idx1].data() - rows[0].data()) * sizeof(T) % TRank2Array<T>::RowAlignment,
+                0);
+            for (auto idx2 : xrange(rows[idx1].size())) {
+                UNIT_ASSERT_VALUES_EQUAL(rows[idx1][idx2], T(idx1 * 10 + idx2));
+            }
+        }
+
+        array.Resize(2, 17);
+        UNIT_ASSERT_VALUES_EQUAL(array.size(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(array.front().size(), 17);
+        UNIT_ASSERT_VALUES_EQUAL(array[1][16], T(0));
+
+        array.Clear();
+        UNIT_ASSERT(array.empty());
+    }
+
+    Y_UNIT_TEST(TestResizeDouble) {
+        TestResize<double>();
+    }
+
+    Y_UNIT_TEST(TestResizeFloat) {
+        TestResize<float>();
+    }
+
+    Y_UNIT_TEST(TestAllocate) {
+        TRank2Array<float> array;
+        array.Allocate(4, 100);
+        UNIT_ASSERT_VALUES_EQUAL(array.size(), 4);
+        UNIT_ASSERT_VALUES_EQUAL(array.GetRowSize(), 100);
+        // rows don't overlap
+        for (auto idx1 : xrange(array.size())) {
+            for (auto& value : array[idx1]) {
+                value = idx1;
+            }
+        }
+        for (auto idx1 : xrange(array.size())) {
+            for (auto value : array[idx1]) {
+                UNIT_ASSERT_VALUES_EQUAL(value, idx1);
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <catboost/libs/helpers/restorable_rng.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+
+Y_UNIT_TEST_SUITE(TRestorableFastRng64Test) {
+    Y_UNIT_TEST(ParallelGenRandByBlocksIsSameAsSequential) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (int count : {0, 1, 999, 1000, 12345}) {
+            TRestorableFastRng64 sequentialRand(17);
+            sequentialRand.Advance(5);
+            TVector<double> expected;
+            for (auto i : xrange(count)) {
+                Y_UNUSED(i);
+                expected.push_back(sequentialRand.GenRandReal1());
+            }
+
+            TRestorableFastRng64 rand(17);
+            rand.Advance(5);
+            TVector<double> values(count);
+            ParallelGenRandByBlocks(
+                count,
+                /*blockSize*/ 1000,
+                &localExecutor,
+                &rand,
+                [&] (int blockBegin, int blockEnd, TRestorableFastRng64* blockRand) {
+                    for (auto i : xrange(blockBegin, blockEnd)) {
+                        values[i] = blockRand->GenRandReal1();
+                    }
+                });
+
+            UNIT_ASSERT_VALUES_EQUAL(values, expected);
+            UNIT_ASSERT_VALUES_EQUAL(rand.GetCallCount(), sequentialRand.GetCallCount());
+            UNIT_ASSERT_VALUES_EQUAL(rand.GenRand(), sequentialRand.GenRand());
+        }
+    }
+}
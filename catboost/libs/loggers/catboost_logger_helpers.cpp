@@ -69,6 +69,7 @@ TString TOutputFiles::AlignFilePathAndCreateDir(const TString& baseDir, const TS
 void TOutputFiles::InitializeFiles(const NCatboostOptions::TOutputFilesOptions& params, const TString& namesPrefix) {
     if (!params.AllowWriteFiles()) {
         Y_ASSERT(TimeLeftLogFile.empty());
+        Y_ASSERT(ProfileCountersLogFile.empty());
         Y_ASSERT(LearnErrorLogFile.empty());
         Y_ASSERT(TestErrorLogFile.empty());
         Y_ASSERT(SnapshotFile.empty());
@@ -83,6 +84,12 @@ void TOutputFiles::InitializeFiles(const NCatboostOptions::TOutputFilesOptions&
     NamesPrefix = namesPrefix;
     CB_ENSURE(!params.GetTimeLeftLogFilename().empty(), "empty time_left filename");
     TimeLeftLogFile = TOutputFiles::AlignFilePathAndCreateDir(trainDir, params.GetTimeLeftLogFilename(), NamesPrefix);
+    if (params.GetProfileCountersLogFilename()) {
+        ProfileCountersLogFile = TOutputFiles::AlignFilePathAndCreateDir(
+            trainDir,
+            params.GetProfileCountersLogFilename(),
+            NamesPrefix);
+    }
 
     CB_ENSURE(!params.GetLearnErrorFilename().empty(), "empty learn_error filename");
     LearnErrorLogFile = TOutputFiles::AlignFilePathAndCreateDir(trainDir, params.GetLearnErrorFilename(), NamesPrefix);
@@ -330,8 +337,10 @@ void InitializeFileLoggers(
             metricPeriod,
             logger
     );
-
-
+    if (outputFiles.ProfileCountersLogFile) {
+        logger->AddProfileBackend(
+            TIntrusivePtr<ILoggingBackend>(new TProfileCountersFileLoggingBackend(outputFiles.ProfileCountersLogFile)));
+    }
 }
 
 
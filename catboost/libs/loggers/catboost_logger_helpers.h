@@ -49,6 +49,7 @@ public:
 
     TString NamesPrefix;
     TString TimeLeftLogFile;
+    TString ProfileCountersLogFile;
     TString LearnErrorLogFile;
     TString TestErrorLogFile;
     TString SnapshotFile;
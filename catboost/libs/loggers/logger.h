@@ -8,8 +8,11 @@
 #include <library/cpp/json/writer/json_value.h>
 #include <util/stream/format.h>
 #include <util/generic/hash.h>
+#include <util/generic/utility.h>
 #include <util/generic/ymath.h>
 
+#include <tuple>
+
 
 class IMetricEvalResult {
 public:
@@ -254,6 +257,16 @@ public:
         for (const auto& it : profileResults.OperationToTime) {
             times[it.first] = it.second;
         }
+        if (!profileResults.Counters.empty()) {
+            auto& counters = CurrentValue["counters"];
+            for (const auto& [counter, value] : profileResults.Counters) {
+                counters[counter] = value;
+                auto [peakIt, isNew] = PeakCounters.emplace(counter, value);
+                if (!isNew) {
+                    peakIt->second = Max(peakIt->second, value);
+                }
+            }
+        }
 
         PassedIterations = profileResults.PassedIterations;
         OperationToTimeInAllIterations = profileResults.OperationToTimeInAllIterations;
@@ -281,12 +294,19 @@ private:
         for (const auto& it : OperationToTimeInAllIterations) {
             times[it.first] = it.second / PassedIterations;
         }
+        if (!PeakCounters.empty()) {
+            auto& peakCounters = CurrentValue["peak_counters"];
+            for (const auto& [counter, value] : PeakCounters) {
+                peakCounters[counter] = value;
+            }
+        }
         *File << CurrentValue.GetStringRobust() << Endl;
     }
     NJson::TJsonValue CurrentValue;
     THolder<TOFStream> File;
     int PassedIterations;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TMap<TString, double> PeakCounters; // max of values of counters over iterations
 };
 
 
@@ -353,6 +373,36 @@ private:
     THolder<TOFStream> File;
 };
 
+// Times of operations and counters of iterations, one value per line
+class TProfileCountersFileLoggingBackend : public ILoggingBackend {
+public:
+    explicit TProfileCountersFileLoggingBackend(const TString& fileName)
+        : File(new TOFStream(fileName))
+    {
+        *File << "iter\tkind\tname\tvalue" << Endl;
+    }
+
+    void OutputProfile(const TProfileResults& profileResults) {
+        for (const auto& [operation, time] : profileResults.OperationToTime) {
+            Values.emplace_back("time", operation, time);
+        }
+        for (const auto& [counter, value] : profileResults.Counters) {
+            Values.emplace_back("counter", counter, value);
+        }
+    }
+
+    void Flush(const int currentIteration) {
+        for (const auto& [kind, name, value] : Values) {
+            *File << currentIteration << "\t" << kind << "\t" << name << "\t" << value << Endl;
+        }
+        Values.clear();
+    }
+
+private:
+    TVector<std::tuple<TStringBuf, TString, double>> Values;
+    THolder<TOFStream> File;
+};
+
 class TTensorBoardLoggingBackend : public ILoggingBackend {
 public:
     explicit TTensorBoardLoggingBackend(const TString& dirName)
@@ -16,7 +16,8 @@ struct TProfileResults {
         double currentTime = 0,
         int passedIterations = 0,
         TMap<TString, double> operationToTime = {},
-        TMap<TString, double> operationToTimeInAllIterations = {}
+        TMap<TString, double> operationToTimeInAllIterations = {},
+        TMap<TString, double> counters = {}
     )
         : PassedTime(passedTime)
         , RemainingTime(remainingTime)
@@ -25,6 +26,7 @@ struct TProfileResults {
         , PassedIterations(passedIterations)
         , OperationToTime(operationToTime)
         , OperationToTimeInAllIterations(operationToTimeInAllIterations)
+        , Counters(counters)
     {
     }
 
@@ -35,6 +37,7 @@ struct TProfileResults {
     int PassedIterations;
     TMap<TString, double> OperationToTime;
     TMap<TString, double> OperationToTimeInAllIterations;
+    TMap<TString, double> Counters;
 };
 
 struct TProfileInfoData {
@@ -90,6 +93,7 @@ public:
         CurrentTime = 0;
         Timer.Reset();
         OperationToTime.clear();
+        Counters.clear();
     }
 
     void StartNextIteration() {
@@ -102,6 +106,11 @@ public:
         OperationToTime[operation] += passedTime; // operations can be repeated in one iteration
     }
 
+    // Non time statistics of iteration, e.g. memory usage, repeated values are summed up
+    void AddCounter(const TString& counter, double value) {
+        Counters[counter] += value;
+    }
+
     void FinishIterationBlock(int blockSize) {
         CurrentTime += Timer.PassedReset();
         OperationToTime["Iteration time"] = CurrentTime;
@@ -136,7 +145,8 @@ public:
             CurrentTime,
             ProfileData.PassedIterations,
             OperationToTime,
-            ProfileData.OperationToTimeInAllIterations
+            ProfileData.OperationToTimeInAllIterations,
+            Counters
         };
     }
 
@@ -144,6 +154,7 @@ private:
     static constexpr int MAX_TIME_RATIO = 100;
     TProfileInfoData ProfileData;
     TMap<TString, double> OperationToTime;
+    TMap<TString, double> Counters;
     THPTimer Timer;
     int InitIterations;
     bool IsIterationGood;
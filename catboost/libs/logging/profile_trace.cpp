@@ -0,0 +1,119 @@
+#include "profile_trace.h"
+
+#include "logging.h"
+
+#include <util/generic/singleton.h>
+#include <util/generic/yexception.h>
+#include <util/stream/file.h>
+#include <util/stream/null.h>
+#include <util/stream/output.h>
+#include <util/system/guard.h>
+
+
+namespace {
+    struct TCachedThreadEvents {
+        ui64 Generation = 0;
+        void* Events = nullptr;
+    };
+}
+
+static thread_local TCachedThreadEvents CachedThreadEvents;
+
+
+namespace NCB {
+
+    TProfileTraceCollector& TProfileTraceCollector::Instance() {
+        return *Singleton<TProfileTraceCollector>();
+    }
+
+    void TProfileTraceCollector::Start() {
+        with_lock (Lock) {
+            ThreadsEvents.clear();
+            StartTime = TInstant::Now();
+            Generation.fetch_add(1);
+        }
+        Enabled.store(true);
+    }
+
+    TProfileTraceCollector::TThreadEvents* TProfileTraceCollector::GetThreadEvents() {
+        const ui64 generation = Generation.load(std::memory_order_acquire);
+        if (CachedThreadEvents.Generation != generation) {
+            with_lock (Lock) {
+                ThreadsEvents.push_back(MakeHolder<TThreadEvents>());
+                ThreadsEvents.back()->ThreadIdx = ThreadsEvents.size() - 1;
+                CachedThreadEvents.Events = ThreadsEvents.back().Get();
+            }
+            CachedThreadEvents.Generation = generation;
+        }
+        return static_cast<TThreadEvents*>(CachedThreadEvents.Events);
+    }
+
+    void TProfileTraceCollector::AddEvent(const char* name, TInstant startTime, TInstant endTime) {
+        if (!IsEnabled()) {
+            return;
+        }
+        GetThreadEvents()->Events.push_back(TEvent{name, startTime, endTime});
+    }
+
+    static void WriteJsonString(TStringBuf str, IOutputStream* output) {
+        *output << '"';
+        for (char c : str) {
+            if (c == '"' || c == '\\') {
+                *output << '\\';
+            }
+            *output << c;
+        }
+        *output << '"';
+    }
+
+    void TProfileTraceCollector::Finish(IOutputStream* output) {
+        Enabled.store(false);
+        with_lock (Lock) {
+            *output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            bool isFirstEvent = true;
+            auto startEvent = [&] () {
+                *output << (isFirstEvent ? "\n" : ",\n");
+                isFirstEvent = false;
+            };
+            for (const auto& threadEvents : ThreadsEvents) {
+                const ui32 tid = threadEvents->ThreadIdx;
+                startEvent();
+                *output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+                    << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+                for (const auto& event : threadEvents->Events) {
+                    startEvent();
+                    *output << "{\"name\":";
+                    WriteJsonString(event.Name, output);
+                    *output << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                        << ",\"ts\":" << (event.StartTime - StartTime).MicroSeconds()
+                        << ",\"dur\":" << (event.EndTime - event.StartTime).MicroSeconds() << '}';
+                }
+            }
+            *output << "\n]}\n";
+            ThreadsEvents.clear();
+        }
+    }
+
+
+    TProfileTraceSession::TProfileTraceSession(const TString& outputPath) {
+        auto& collector = TProfileTraceCollector::Instance();
+        if (!outputPath.empty() && !collector.IsEnabled()) {
+            OutputPath = outputPath;
+            collector.Start();
+        }
+    }
+
+    TProfileTraceSession::~TProfileTraceSession() {
+        if (OutputPath.empty()) {
+            return;
+        }
+        try {
+            TOFStream output(OutputPath);
+            TProfileTraceCollector::Instance().Finish(&output);
+        } catch (...) {
+            CATBOOST_WARNING_LOG << "Failed to write profile trace to " << OutputPath << ": "
+                << CurrentExceptionMessage() << Endl;
+            TProfileTraceCollector::Instance().Finish(&Cnull);
+        }
+    }
+}
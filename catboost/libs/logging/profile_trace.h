@@ -0,0 +1,97 @@
+#pragma once
+
+#include <util/datetime/base.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/fwd.h>
+#include <util/system/mutex.h>
+#include <util/system/types.h>
+
+#include <atomic>
+
+
+namespace NCB {
+
+    /* Collects scoped trace events (see CB_PROFILE_TRACE_SCOPE) of all threads while enabled
+     * and writes them in Chrome trace event format (viewable in chrome://tracing or Perfetto).
+     * Events are appended to per-thread buffers, so recording does not take locks after the first
+     * event of a thread. Event names must be string literals.
+     */
+    class TProfileTraceCollector {
+    public:
+        static TProfileTraceCollector& Instance();
+
+        bool IsEnabled() const {
+            return Enabled.load(std::memory_order_relaxed);
+        }
+
+        // drops previously collected events
+        void Start();
+
+        // all traced scopes must be finished
+        void Finish(IOutputStream* output);
+
+        void AddEvent(const char* name, TInstant startTime, TInstant endTime);
+
+    private:
+        struct TEvent {
+            const char* Name;
+            TInstant StartTime;
+            TInstant EndTime;
+        };
+
+        struct TThreadEvents {
+            ui32 ThreadIdx = 0;
+            TVector<TEvent> Events;
+        };
+
+    private:
+        TThreadEvents* GetThreadEvents();
+
+    private:
+        std::atomic<bool> Enabled = false;
+        // incremented on Start, invalidates buffers cached by threads
+        std::atomic<ui64> Generation = 0;
+        TInstant StartTime;
+
+        TMutex Lock;
+        TVector<THolder<TThreadEvents>> ThreadsEvents;
+    };
+
+
+    class TProfileTraceScope {
+    public:
+        explicit TProfileTraceScope(const char* name)
+            : Name(TProfileTraceCollector::Instance().IsEnabled() ? name : nullptr)
+            , StartTime(Name ? TInstant::Now() : TInstant())
+        {
+        }
+
+        ~TProfileTraceScope() {
+            if (Name) {
+                TProfileTraceCollector::Instance().AddEvent(Name, StartTime, TInstant::Now());
+            }
+        }
+
+    private:
+        const char* Name;
+        TInstant StartTime;
+    };
+
+
+    /* Enables trace collection for its lifetime and writes the trace to outputPath at the end.
+     * Does nothing if outputPath is empty or trace is already collected by an enclosing session.
+     */
+    class TProfileTraceSession {
+    public:
+        explicit TProfileTraceSession(const TString& outputPath);
+        ~TProfileTraceSession();
+
+    private:
+        TString OutputPath;
+    };
+}
+
+#define CB_PROFILE_TRACE_SCOPE(name) \
+    ::NCB::TProfileTraceScope Y_GENERATE_UNIQUE_ID(profileTraceScope)(name)
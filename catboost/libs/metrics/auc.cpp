@@ -3,9 +3,16 @@
 #include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/private/libs/index_range/index_range.h>
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 using NMetrics::TSample;
 using NMetrics::TBinClassSample;
@@ -244,6 +251,73 @@ static bool CompareBinClassSamplesByPrediction(const TBinClassSample& left, cons
     return left.Prediction < right.Prediction;
 }
 
+// unsigned keys with the same order as predictions, -0.0 and 0.0 get the same key
+static ui64 GetOrderedKey(double prediction) {
+    if (prediction == 0) {
+        prediction = 0;
+    }
+    ui64 bits;
+    std::memcpy(&bits, &prediction, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (ui64(1) << 63);
+}
+
+static ui32 GetOrderedKey(float prediction) {
+    if (prediction == 0) {
+        prediction = 0;
+    }
+    ui32 bits;
+    std::memcpy(&bits, &prediction, sizeof(bits));
+    return (bits >> 31) ? ~bits : bits | (ui32(1) << 31);
+}
+
+static float GetPredictionFromOrderedKey(ui32 key) {
+    const ui32 bits = (key >> 31) ? key & ~(ui32(1) << 31) : ~key;
+    float prediction;
+    std::memcpy(&prediction, &bits, sizeof(prediction));
+    return prediction;
+}
+
+// LSD radix sort by prediction, passes over bytes equal for all samples are skipped
+static void RadixSortByPrediction(TVector<TBinClassSample>* samples, TVector<TBinClassSample>* buf) {
+    constexpr ui32 DigitBits = 8;
+    constexpr ui32 DigitCount = 1 << DigitBits;
+    constexpr ui32 PassCount = sizeof(ui64) * 8 / DigitBits;
+
+    const size_t size = samples->size();
+    TVector<ui64> keys;
+    keys.yresize(size);
+    for (auto idx : xrange(size)) {
+        keys[idx] = GetOrderedKey((*samples)[idx].Prediction);
+    }
+    TVector<ui64> keysBuf;
+    keysBuf.yresize(size);
+    buf->yresize(size);
+
+    TVector<size_t> offsets(DigitCount);
+    for (auto pass : xrange(PassCount)) {
+        const ui32 shift = pass * DigitBits;
+        Fill(offsets.begin(), offsets.end(), 0);
+        for (auto key : keys) {
+            ++offsets[(key >> shift) & (DigitCount - 1)];
+        }
+        if (offsets[(keys[0] >> shift) & (DigitCount - 1)] == size) {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto& digitOffset : offsets) {
+            offset += digitOffset;
+            digitOffset = offset - digitOffset;
+        }
+        for (auto idx : xrange(size)) {
+            const size_t position = offsets[(keys[idx] >> shift) & (DigitCount - 1)]++;
+            keysBuf[position] = keys[idx];
+            (*buf)[position] = (*samples)[idx];
+        }
+        keys.swap(keysBuf);
+        samples->swap(*buf);
+    }
+}
+
 double CalcBinClassAuc(
     TVector<TBinClassSample>* positiveSamples,
     TVector<TBinClassSample>* negativeSamples,
@@ -257,8 +331,8 @@ double CalcBinClassAuc(
         std::swap(positiveSamples, negativeSamples);
         needSwap = true;
     }
-    TVector<TBinClassSample> buf(positiveSamples->begin(), positiveSamples->end());
-    NCB::ParallelMergeSort(CompareBinClassSamplesByPrediction, positiveSamples, localExecutor, &buf);
+    TVector<TBinClassSample> buf;
+    RadixSortByPrediction(positiveSamples, &buf);
     TVector<ui32> equalPredictionPositions(positiveSamples->size());
     for (ui32 i = positiveSamples->size(); i > 0; --i) {
         equalPredictionPositions[i - 1] = i;
@@ -311,3 +385,49 @@ double CalcBinClassAuc(
     localExecutor.RunAdditionalThreads(threadCount - 1);
     return CalcBinClassAuc(positiveSamples, negativeSamples, &localExecutor);
 }
+
+TBinClassAucHistogram::TBinClassAucHistogram(ui32 binBits)
+    : BinBits(binBits)
+{
+    CB_ENSURE(0 < binBits && binBits <= MaxBinBits, "AUC histogram should have from 1 to " << MaxBinBits << " bin bits");
+    PositiveWeights.resize(size_t(1) << binBits, 0);
+    NegativeWeights.resize(size_t(1) << binBits, 0);
+}
+
+ui32 TBinClassAucHistogram::GetBin(double prediction) const {
+    return GetOrderedKey(static_cast<float>(prediction)) >> (32 - BinBits);
+}
+
+double TBinClassAucHistogram::GetBinLowerBound(ui32 bin) const {
+    const float lowerBound = GetPredictionFromOrderedKey(bin << (32 - BinBits));
+    return std::isnan(lowerBound) ? -std::numeric_limits<double>::infinity() : lowerBound;
+}
+
+void TBinClassAucHistogram::Add(double prediction, double positiveWeight, double negativeWeight) {
+    const ui32 bin = GetBin(prediction);
+    PositiveWeights[bin] += positiveWeight;
+    NegativeWeights[bin] += negativeWeight;
+}
+
+void TBinClassAucHistogram::Merge(const TBinClassAucHistogram& other) {
+    CB_ENSURE_INTERNAL(BinBits == other.BinBits, "Only AUC histograms with the same bins can be merged");
+    for (auto bin : xrange(PositiveWeights.size())) {
+        PositiveWeights[bin] += other.PositiveWeights[bin];
+        NegativeWeights[bin] += other.NegativeWeights[bin];
+    }
+}
+
+double TBinClassAucHistogram::CalcAuc() const {
+    double positiveWeightSum = 0;
+    double negativeWeightSum = 0;
+    double pairWeightSum = 0;
+    for (auto bin : xrange(PositiveWeights.size())) {
+        pairWeightSum += PositiveWeights[bin] * (negativeWeightSum + NegativeWeights[bin] / 2.0);
+        positiveWeightSum += PositiveWeights[bin];
+        negativeWeightSum += NegativeWeights[bin];
+    }
+    if (positiveWeightSum == 0 || negativeWeightSum == 0) {
+        return 0;
+    }
+    return pairWeightSum / (positiveWeightSum * negativeWeightSum);
+}
@@ -4,6 +4,9 @@
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
 double CalcAUC(
     TVector<NMetrics::TSample>* samples,
     double* outWeightSum = nullptr,
@@ -12,3 +15,43 @@ double CalcAUC(
 
 double CalcBinClassAuc(TVector<NMetrics::TBinClassSample>* positiveSamples, TVector<NMetrics::TBinClassSample>* negativeSamples, NPar::ILocalExecutor* localExecutor);
 double CalcBinClassAuc(TVector<NMetrics::TBinClassSample>* positiveSamples, TVector<NMetrics::TBinClassSample>* negativeSamples, int threadCount = 1);
+
+/**
+ * Approximate binary classification AUC with memory bounded by the number of bins: predictions are binned
+ * by the high bits of their order preserving float representation, pairs within one bin are counted as ties.
+ * Histograms of different parts of the data can be built in parallel and merged.
+ */
+class TBinClassAucHistogram {
+public:
+    static constexpr ui32 DefaultBinBits = 16;
+    static constexpr ui32 MaxBinBits = 24;
+
+public:
+    explicit TBinClassAucHistogram(ui32 binBits = DefaultBinBits);
+
+    void Add(double prediction, double positiveWeight, double negativeWeight);
+    void Merge(const TBinClassAucHistogram& other);
+
+    double CalcAuc() const;
+
+    // bins are ordered by predictions
+    ui32 GetBinCount() const {
+        return PositiveWeights.size();
+    }
+    double GetPositiveWeight(ui32 bin) const {
+        return PositiveWeights[bin];
+    }
+    double GetNegativeWeight(ui32 bin) const {
+        return NegativeWeights[bin];
+    }
+    // the smallest prediction that falls into the bin, -inf for the bins of the smallest predictions
+    double GetBinLowerBound(ui32 bin) const;
+
+private:
+    ui32 GetBin(double prediction) const;
+
+private:
+    ui32 BinBits;
+    TVector<double> PositiveWeights; // [bin]
+    TVector<double> NegativeWeights; // [bin]
+};
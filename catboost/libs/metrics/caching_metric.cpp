@@ -3,15 +3,20 @@
 #include "description_utils.h"
 #include "classification_utils.h"
 #include "kappa.h"
+#include "query_doc_order.h"
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
 #include <catboost/libs/helpers/math_utils.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/options/data_processing_options.h>
 #include <catboost/private/libs/options/enum_helpers.h>
+#include <util/digest/murmur.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/string.h>
 #include <util/generic/set.h>
 
+#include <functional>
+
 using NCB::AppendTemporaryMetricsVector;
 using NCB::AsVector;
 
@@ -1601,6 +1606,38 @@ TVector<TParamSet> TWKappaMetric::ValidParamSets() {
     return {TParamSet{{TParamInfo{"use_weights", false, true}}, ""}};
 };
 
+static ui64 CalcApproxHash(TConstArrayRef<TConstArrayRef<double>> approx, ui32 begin, ui32 end) {
+    ui64 hash = 0;
+    for (const auto& dimApprox : approx) {
+        hash = MurmurHash<ui64>(dimApprox.data() + begin, (end - begin) * sizeof(double), hash);
+    }
+    return hash;
+}
+
+// returns [blockId] flags of blocks with approxes changed since the previous call
+static TVector<ui8> UpdateBlockHashes(
+    TConstArrayRef<TConstArrayRef<double>> approx,
+    const NPar::ILocalExecutor::TExecRangeParams& blockParams,
+    std::function<std::pair<ui32, ui32>(int /*from*/, int /*to*/)> getObjectBounds,
+    NPar::ILocalExecutor* localExecutor,
+    TVector<ui64>* blockHashes
+) {
+    const int blockCount = blockParams.GetBlockCount();
+    const int blockSize = blockParams.GetBlockSize();
+    const bool isNewLayout = blockHashes->ysize() != blockCount;
+    blockHashes->resize(blockCount, 0);
+    TVector<ui8> isChanged(blockCount, 1); // not TVector<bool> to be written concurrently
+    NPar::ParallelFor(*localExecutor, 0, blockCount, [&](int blockId) {
+        const auto [begin, end] = getObjectBounds(
+            blockParams.FirstId + blockId * blockSize,
+            Min(blockParams.FirstId + (blockId + 1) * blockSize, blockParams.LastId));
+        const ui64 hash = CalcApproxHash(approx, begin, end);
+        isChanged[blockId] = isNewLayout || hash != (*blockHashes)[blockId];
+        (*blockHashes)[blockId] = hash;
+    });
+    return isChanged;
+}
+
 TVector<TMetricHolder> EvalErrorsWithCaching(
     const TVector<TVector<double>>& approx,
     const TVector<TVector<double>>& approxDelta,
@@ -1609,7 +1646,8 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TConstArrayRef<float> weight,
     TConstArrayRef<TQueryInfo> queriesInfo,
     TConstArrayRef<const IMetric*> metrics,
-    NPar::ILocalExecutor* localExecutor
+    NPar::ILocalExecutor* localExecutor,
+    TAdditiveMetricsState* additiveMetricsState
 ) {
     const auto threadCount = localExecutor->GetThreadCount() + 1;
     const auto objectCount = approx.front().size();
@@ -1634,36 +1672,63 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
             );
         }
     };
-    const auto calcNonCaching = [&](auto metric, auto from, auto to) {
+    const auto calcNonCaching = [&](auto metric, auto from, auto to, NPar::ILocalExecutor* executor) {
         if (target.size() <= 1 && dynamic_cast<const ISingleTargetEval*>(metric) != nullptr) {
             CB_ENSURE(!metric->NeedTarget() || target.size() == 1, "Metric [" + metric->GetDescription() + "] requires "
                     << (target.size() > 1 ? "one-dimensional" : "") <<  "target");
             return dynamic_cast<const ISingleTargetEval*>(metric)->Eval(
                 approxRef, approxDeltaRef, isExpApprox,
                 metric->NeedTarget() ? target[0] : TConstArrayRef<float>(),
-                weight, queriesInfo, from, to, *localExecutor
+                weight, queriesInfo, from, to, *executor
             );
         } else {
             CB_ENSURE(!isExpApprox, "Metric [" << metric->GetDescription() << "] does not support exponentiated approxes");
             return dynamic_cast<const IMultiTargetEval*>(metric)->Eval(
-                approxRef, approxDeltaRef, target, weight, from, to, *localExecutor
+                approxRef, approxDeltaRef, target, weight, from, to, *executor
             );
         }
     };
 
-    TVector<TMetricHolder> errors;
-    errors.reserve(metrics.size());
+    TVector<TMetricHolder> errors(metrics.size());
+
+    // blocks are not limited by thread count for reuse of partial results, so that unchanged parts are smaller
+    const bool useAdditiveMetricsState = additiveMetricsState && !target.empty();
+    CB_ENSURE_INTERNAL(!useAdditiveMetricsState || approxDelta.empty(), "Additive metrics state requires empty approx delta");
 
     NPar::ILocalExecutor::TExecRangeParams objectwiseBlockParams(0, objectCount);
     if (!target.empty()) {
-        const auto objectwiseEffectiveBlockCount = Min(threadCount, int(ceil(double(objectCount) / GetMinBlockSize(objectCount))));
-        objectwiseBlockParams.SetBlockCount(objectwiseEffectiveBlockCount);
+        const auto minBlockCount = int(ceil(double(objectCount) / GetMinBlockSize(objectCount)));
+        objectwiseBlockParams.SetBlockCount(useAdditiveMetricsState ? minBlockCount : Min(threadCount, minBlockCount));
     }
 
     NPar::ILocalExecutor::TExecRangeParams querywiseBlockParams(0, queryCount);
     if (!queriesInfo.empty()) {
-        const auto querywiseEffectiveBlockCount = Min(threadCount, int(ceil(double(queryCount) / GetMinBlockSize(objectCount))));
-        querywiseBlockParams.SetBlockCount(querywiseEffectiveBlockCount);
+        const auto minBlockCount = int(ceil(double(queryCount) / GetMinBlockSize(objectCount)));
+        querywiseBlockParams.SetBlockCount(useAdditiveMetricsState ? minBlockCount : Min(threadCount, minBlockCount));
+    }
+
+    TVector<ui8> isObjectwiseBlockChanged;
+    TVector<ui8> isQuerywiseBlockChanged;
+    if (useAdditiveMetricsState) {
+        if (additiveMetricsState->IsExpApprox != isExpApprox || additiveMetricsState->ApproxDimension != approx.size()) {
+            additiveMetricsState->Clear();
+            additiveMetricsState->IsExpApprox = isExpApprox;
+            additiveMetricsState->ApproxDimension = approx.size();
+        }
+        isObjectwiseBlockChanged = UpdateBlockHashes(
+            approxRef,
+            objectwiseBlockParams,
+            [] (int from, int to) { return std::make_pair(ui32(from), ui32(to)); },
+            localExecutor,
+            &additiveMetricsState->ObjectwiseBlockHashes);
+        if (!queriesInfo.empty()) {
+            isQuerywiseBlockChanged = UpdateBlockHashes(
+                approxRef,
+                querywiseBlockParams,
+                [&] (int from, int to) { return std::make_pair(queriesInfo[from].Begin, queriesInfo[to - 1].End); },
+                localExecutor,
+                &additiveMetricsState->QuerywiseBlockHashes);
+        }
     }
 
     TCache nonAdditiveCache;
@@ -1672,39 +1737,165 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TVector<TMetricHolder> objectwiseBlockResults(objectwiseBlockParams.GetBlockCount());
     TVector<TMetricHolder> querywiseBlockResults(querywiseBlockParams.GetBlockCount());
 
+    const auto isCachingMetric = [] (const IMetric* metric) {
+        return dynamic_cast<const ICachingSingleTargetEval*>(metric)
+            || dynamic_cast<const ICachingMultiTargetEval*>(metric);
+    };
+
+    // Objectwise additive metrics are evaluated together in blocks, and in subblocks inside blocks,
+    // so that approxes, targets and weights of a subblock are read from memory once for all of them.
+    TVector<ui32> fusedMetricIndices;
+    for (auto i : xrange(metrics.size())) {
+        if (metrics[i]->IsAdditiveMetric() && metrics[i]->GetErrorType() == EErrorType::PerObjectError && !target.empty()) {
+            fusedMetricIndices.push_back(i);
+        }
+    }
+    if (!fusedMetricIndices.empty()) {
+        CB_ENSURE(objectCount > 0, "Not enough data to calculate metric: groupwise metric w/o group id's, or objectwise metric w/o samples");
+        constexpr int SubblockSize = 4096;
+        const int blockSize = objectwiseBlockParams.GetBlockSize();
+        const int blockCount = objectwiseBlockParams.GetBlockCount();
+
+        TVector<TVector<TMetricHolder>> localBlockResults(fusedMetricIndices.size());
+        TVector<TVector<TMetricHolder>*> blockResults; // [fusedMetricIdx][blockId]
+        TVector<ui8> needAllBlocksEval; // [fusedMetricIdx]
+        TVector<ui8> isCaching; // [fusedMetricIdx]
+        for (auto fusedMetricIdx : xrange(fusedMetricIndices.size())) {
+            const IMetric* metric = metrics[fusedMetricIndices[fusedMetricIdx]];
+            auto* results = &localBlockResults[fusedMetricIdx];
+            if (useAdditiveMetricsState) {
+                results = &additiveMetricsState->BlockResults[metric->GetDescription()];
+            }
+            needAllBlocksEval.push_back(!useAdditiveMetricsState || results->ysize() != blockCount);
+            results->resize(blockCount);
+            blockResults.push_back(results);
+            isCaching.push_back(isCachingMetric(metric));
+        }
+        const auto needBlockEval = [&] (ui32 fusedMetricIdx, int blockId) {
+            return needAllBlocksEval[fusedMetricIdx] || isObjectwiseBlockChanged[blockId];
+        };
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                NPar::TLocalExecutor blockExecutor; // without threads, blocks are already evaluated in parallel
+                for (auto fusedMetricIdx : xrange(fusedMetricIndices.size())) {
+                    if (needBlockEval(fusedMetricIdx, blockId)) {
+                        (*blockResults[fusedMetricIdx])[blockId] = TMetricHolder();
+                    }
+                }
+                const int blockEnd = Min<int>((blockId + 1) * blockSize, objectCount);
+                for (int from = blockId * blockSize; from < blockEnd; from += SubblockSize) {
+                    const int to = Min(from + SubblockSize, blockEnd);
+                    TCache cache; // cached values are not keyed by object range
+                    for (auto fusedMetricIdx : xrange(fusedMetricIndices.size())) {
+                        if (!needBlockEval(fusedMetricIdx, blockId)) {
+                            continue;
+                        }
+                        const IMetric* metric = metrics[fusedMetricIndices[fusedMetricIdx]];
+                        (*blockResults[fusedMetricIdx])[blockId].Add(
+                            isCaching[fusedMetricIdx]
+                                ? calcCaching(metric, from, to, &cache)
+                                : calcNonCaching(metric, from, to, &blockExecutor));
+                    }
+                }
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        for (auto fusedMetricIdx : xrange(fusedMetricIndices.size())) {
+            TMetricHolder& error = errors[fusedMetricIndices[fusedMetricIdx]];
+            for (const auto& blockResult : *blockResults[fusedMetricIdx]) {
+                error.Add(blockResult);
+            }
+        }
+    }
+
+    // ranking metrics share one order of documents in queries
+    TVector<ui32> queryDocOrder;
+    const bool canShareQueryDocOrder = approxDelta.empty() && approx.size() == 1 && target.size() == 1;
+
     for (auto i : xrange(metrics.size())) {
         auto metric = metrics[i];
+        if (IsIn(fusedMetricIndices, i)) {
+            continue;
+        }
 
         const bool isObjectwise = metric->GetErrorType() == EErrorType::PerObjectError;
         const auto end = isObjectwise ? objectCount : queryCount;
         CB_ENSURE(end > 0, "Not enough data to calculate metric: groupwise metric w/o group id's, or objectwise metric w/o samples");
 
-        const bool isCaching = dynamic_cast<const ICachingSingleTargetEval*>(metric)
-                            || dynamic_cast<const ICachingMultiTargetEval*>(metric);
+        const bool isCaching = isCachingMetric(metric);
+        const auto* docOrderEval = canShareQueryDocOrder && !isObjectwise ? dynamic_cast<const IQueryDocOrderEval*>(metric) : nullptr;
+        if (docOrderEval && queryDocOrder.empty()) {
+            // order by exponentiated approxes is the same
+            queryDocOrder = CalcQueryDocOrder(approxRef[0], target[0], queriesInfo, localExecutor);
+        }
 
-        if (isCaching && metric->IsAdditiveMetric()) {
+        if (metric->IsAdditiveMetric() && (isCaching || docOrderEval || useAdditiveMetricsState)) {
             const auto blockSize = isObjectwise ? objectwiseBlockParams.GetBlockSize() : querywiseBlockParams.GetBlockSize();
             const auto blockCount = isObjectwise ? objectwiseBlockParams.GetBlockCount() : querywiseBlockParams.GetBlockCount();
 
-            auto &results = isObjectwise ? objectwiseBlockResults : querywiseBlockResults;
+            auto* results = isObjectwise ? &objectwiseBlockResults : &querywiseBlockResults;
             auto &cache = isObjectwise ? objectwiseAdditiveCache : querywiseAdditiveCache;
 
-            NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
-                const auto from = blockId * blockSize;
-                const auto to = Min<int>((blockId + 1) * blockSize, end);
-                results[blockId] = calcCaching(metric, from, to, &cache[blockId]);
-            });
+            TConstArrayRef<ui8> isBlockChanged;
+            if (useAdditiveMetricsState) {
+                results = &additiveMetricsState->BlockResults[metric->GetDescription()];
+                if (results->ysize() == blockCount) {
+                    isBlockChanged = isObjectwise ? isObjectwiseBlockChanged : isQuerywiseBlockChanged;
+                } else {
+                    results->assign(blockCount, TMetricHolder());
+                }
+            }
+            const auto needBlockEval = [&] (int blockId) {
+                return isBlockChanged.empty() || isBlockChanged[blockId];
+            };
+
+            if (docOrderEval) {
+                NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
+                    if (needBlockEval(blockId)) {
+                        const auto from = blockId * blockSize;
+                        const auto to = Min<int>((blockId + 1) * blockSize, end);
+                        const ui32 offset = queriesInfo[from].Begin;
+                        (*results)[blockId] = docOrderEval->EvalWithDocOrder(
+                            target[0].Slice(offset),
+                            queriesInfo,
+                            MakeArrayRef(queryDocOrder).Slice(offset),
+                            from,
+                            to);
+                    }
+                });
+            } else if (isCaching) {
+                NPar::ParallelFor(*localExecutor, 0, blockCount, [&](auto blockId) {
+                    if (needBlockEval(blockId)) {
+                        const auto from = blockId * blockSize;
+                        const auto to = Min<int>((blockId + 1) * blockSize, end);
+                        (*results)[blockId] = calcCaching(metric, from, to, &cache[blockId]);
+                    }
+                });
+            } else {
+                // non-caching metrics parallelize evaluation in blocks themselves
+                for (auto blockId : xrange(blockCount)) {
+                    if (needBlockEval(blockId)) {
+                        const auto from = blockId * blockSize;
+                        const auto to = Min<int>((blockId + 1) * blockSize, end);
+                        (*results)[blockId] = calcNonCaching(metric, from, to, localExecutor);
+                    }
+                }
+            }
 
             TMetricHolder error;
-            for (const auto &blockResult : results) {
+            for (const auto &blockResult : *results) {
                 error.Add(blockResult);
             }
-            errors.push_back(error);
+            errors[i] = error;
         } else {
             if (isCaching) {
-                errors.push_back(calcCaching(metric, 0, end, &nonAdditiveCache));
+                errors[i] = calcCaching(metric, 0, end, &nonAdditiveCache);
             } else {
-                errors.push_back(calcNonCaching(metric, 0, end));
+                errors[i] = calcNonCaching(metric, 0, end, localExecutor);
             }
         }
     }
@@ -10,6 +10,9 @@
 
 #include <util/generic/fwd.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
 
 struct IMetric;
 struct TMetricConfig;
@@ -18,6 +21,27 @@ struct TParamSet;
 TVector<THolder<IMetric>> CreateCachingMetrics(const TMetricConfig& config);
 TVector<TParamSet> CachingMetricValidParamSets(ELossFunction metric);
 
+/**
+ * Per-block partial values of additive metrics kept between EvalErrorsWithCaching calls for the same dataset.
+ * Blocks are identified by hashes of their approxes, so blocks with approxes unchanged since the previous
+ * call are not evaluated again.
+ */
+struct TAdditiveMetricsState {
+    bool IsExpApprox = false;
+    size_t ApproxDimension = 0;
+    TVector<ui64> ObjectwiseBlockHashes; // [blockId]
+    TVector<ui64> QuerywiseBlockHashes; // [blockId]
+    THashMap<TString, TVector<TMetricHolder>> BlockResults; // metric description -> [blockId]
+
+public:
+    void Clear() {
+        ObjectwiseBlockHashes.clear();
+        QuerywiseBlockHashes.clear();
+        BlockResults.clear();
+    }
+};
+
+// additiveMetricsState is optional and can be used only with empty approxDelta
 TVector<TMetricHolder> EvalErrorsWithCaching(
     const TVector<TVector<double>>& approx,
     const TVector<TVector<double>>& approxDelta,
@@ -26,7 +50,8 @@ TVector<TMetricHolder> EvalErrorsWithCaching(
     TConstArrayRef<float> weight,
     TConstArrayRef<TQueryInfo> queriesInfo,
     TConstArrayRef<const IMetric *> metrics,
-    NPar::ILocalExecutor *localExecutor
+    NPar::ILocalExecutor *localExecutor,
+    TAdditiveMetricsState* additiveMetricsState = nullptr
 );
 
 inline static TVector<TMetricHolder> EvalErrorsWithCaching(
@@ -37,7 +62,8 @@ inline static TVector<TMetricHolder> EvalErrorsWithCaching(
     TConstArrayRef<float> weight,
     TConstArrayRef<TQueryInfo> queriesInfo,
     TConstArrayRef<const IMetric*> metrics,
-    NPar::ILocalExecutor *localExecutor
+    NPar::ILocalExecutor *localExecutor,
+    TAdditiveMetricsState* additiveMetricsState = nullptr
 ) {
     return EvalErrorsWithCaching(
         approx,
@@ -47,6 +73,7 @@ inline static TVector<TMetricHolder> EvalErrorsWithCaching(
         weight,
         queriesInfo,
         metrics,
-        localExecutor
+        localExecutor,
+        additiveMetricsState
     );
 }
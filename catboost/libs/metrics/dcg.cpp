@@ -13,6 +13,8 @@
 #include <util/generic/vector.h>
 #include <util/generic/ymath.h>
 
+#include <functional>
+
 using NMetrics::TSample;
 
 template <typename F>
@@ -140,3 +142,37 @@ double CalcNdcg(TConstArrayRef<TSample> samples, TConstArrayRef<double> decay, E
     double idcg = CalcIDcg(samples, decay, type, topSize);
     return idcg > 0 ? dcg / idcg : 1;
 }
+
+double CalcDcgWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<ui32> docOrder,
+    TConstArrayRef<double> decay,
+    ENdcgMetricType type,
+    ui32 topSize
+) {
+    const ui32 size = Min<ui32>(topSize, target.size());
+    TStackVec<double> sortedTargets;
+    sortedTargets.yresize(size);
+    for (ui32 i = 0; i < size; ++i) {
+        sortedTargets[i] = target[docOrder[i]];
+    }
+    return CalcDcgSorted(sortedTargets, decay, type);
+}
+
+double CalcNdcgWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<ui32> docOrder,
+    TConstArrayRef<double> decay,
+    ENdcgMetricType type,
+    ui32 topSize
+) {
+    double dcg = CalcDcgWithDocOrder(target, docOrder, decay, type, topSize);
+
+    const ui32 size = Min<ui32>(topSize, target.size());
+    TStackVec<double> idealTargets;
+    idealTargets.yresize(target.size());
+    Copy(target.begin(), target.end(), idealTargets.begin());
+    PartialSort(idealTargets.begin(), idealTargets.begin() + size, idealTargets.end(), std::greater<double>());
+    double idcg = CalcDcgSorted(MakeArrayRef(idealTargets.data(), size), decay, type);
+    return idcg > 0 ? dcg / idcg : 1;
+}
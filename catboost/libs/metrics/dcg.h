@@ -52,3 +52,18 @@ double CalcNdcg(
     TConstArrayRef<double> decay,
     ENdcgMetricType type = ENdcgMetricType::Base,
     ui32 topSize = Max<ui32>());
+
+// docOrder is the order of documents in query, see query_doc_order.h
+double CalcDcgWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<ui32> docOrder,
+    TConstArrayRef<double> decay,
+    ENdcgMetricType type = ENdcgMetricType::Base,
+    ui32 topSize = Max<ui32>());
+
+double CalcNdcgWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<ui32> docOrder,
+    TConstArrayRef<double> decay,
+    ENdcgMetricType type = ENdcgMetricType::Base,
+    ui32 topSize = Max<ui32>());
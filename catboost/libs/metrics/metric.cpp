@@ -12,6 +12,7 @@
 #include "llp.h"
 #include "pfound.h"
 #include "precision_recall_at_k.h"
+#include "query_doc_order.h"
 #include "description_utils.h"
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
@@ -22,6 +23,7 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/options/enum_helpers.h>
 #include <catboost/private/libs/options/enums.h>
+#include <catboost/private/libs/index_range/index_range.h>
 #include <catboost/private/libs/options/loss_description.h>
 
 #include <library/cpp/fast_exp/fast_exp.h>
@@ -32,6 +34,7 @@
 #include <util/generic/hash_set.h>
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
@@ -162,6 +165,42 @@ namespace {
         ) const = 0;
     };
 
+    struct TQueryDocOrderMetric: public TAdditiveSingleTargetMetric, IQueryDocOrderEval {
+        explicit TQueryDocOrderMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
+            : TAdditiveSingleTargetMetric(lossFunction, descriptionParams) {}
+        TMetricHolder EvalSingleThread(
+            TConstArrayRef<TConstArrayRef<double>> approx,
+            TConstArrayRef<TConstArrayRef<double>> approxDelta,
+            bool isExpApprox,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> /*weight*/,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int queryStartIndex,
+            int queryEndIndex
+        ) const final {
+            if (queryStartIndex == queryEndIndex) {
+                return TMetricHolder(2);
+            }
+            const ui32 begin = queriesInfo[queryStartIndex].Begin;
+            const ui32 end = queriesInfo[queryEndIndex - 1].End;
+            TConstArrayRef<double> blockApprox = approx[0].Slice(begin, end - begin);
+            TVector<double> approxWithDelta;
+            if (!approxDelta.empty()) {
+                approxWithDelta.yresize(end - begin);
+                for (auto idx : xrange(end - begin)) {
+                    const double delta = approxDelta[0][begin + idx];
+                    approxWithDelta[idx] = isExpApprox ? blockApprox[idx] * delta : blockApprox[idx] + delta;
+                }
+                blockApprox = approxWithDelta;
+            }
+            const auto blockTarget = target.Slice(begin, end - begin);
+            TVector<ui32> docOrder;
+            docOrder.yresize(end - begin);
+            CalcQueryDocOrder(blockApprox, blockTarget, queriesInfo, queryStartIndex, queryEndIndex, docOrder);
+            return EvalWithDocOrder(blockTarget, queriesInfo, docOrder, queryStartIndex, queryEndIndex);
+        }
+    };
+
     struct TNonAdditiveSingleTargetMetric: public TSingleTargetMetric {
         explicit TNonAdditiveSingleTargetMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
             : TSingleTargetMetric(lossFunction, descriptionParams) {}
@@ -2529,20 +2568,17 @@ TVector<TParamSet> TQueryRMSEMetric::ValidParamSets() {
 /* PFound */
 
 namespace {
-    struct TPFoundMetric final: public TAdditiveSingleTargetMetric {
+    struct TPFoundMetric final: public TQueryDocOrderMetric {
         explicit TPFoundMetric(const TLossParams& params,
                 int topSize, double decay);
 
         static TVector<THolder<IMetric>> Create(const TMetricConfig& config);
         static TVector<TParamSet> ValidParamSets();
 
-        TMetricHolder EvalSingleThread(
-            TConstArrayRef<TConstArrayRef<double>> approx,
-            TConstArrayRef<TConstArrayRef<double>> approxDelta,
-            bool isExpApprox,
+        TMetricHolder EvalWithDocOrder(
             TConstArrayRef<float> target,
-            TConstArrayRef<float> weight,
             TConstArrayRef<TQueryInfo> queriesInfo,
+            TConstArrayRef<ui32> docOrder,
             int queryStartIndex,
             int queryEndIndex
         ) const override;
@@ -2570,43 +2606,32 @@ TVector<THolder<IMetric>> TPFoundMetric::Create(const TMetricConfig& config) {
 }
 
 TPFoundMetric::TPFoundMetric(const TLossParams& params, int topSize, double decay)
-        : TAdditiveSingleTargetMetric(ELossFunction::PFound, params)
+        : TQueryDocOrderMetric(ELossFunction::PFound, params)
         , TopSize(topSize)
         , Decay(decay) {
     UseWeights.SetDefaultValue(true);
 }
 
-TMetricHolder TPFoundMetric::EvalSingleThread(
-    TConstArrayRef<TConstArrayRef<double>> approxRef,
-    TConstArrayRef<TConstArrayRef<double>> approxDeltaRef,
-    bool isExpApprox,
+TMetricHolder TPFoundMetric::EvalWithDocOrder(
     TConstArrayRef<float> target,
-    TConstArrayRef<float> /*weight*/,
     TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<ui32> docOrder,
     int queryStartIndex,
     int queryEndIndex
 ) const {
-    const auto impl = [=] (auto hasDelta, auto isExpApprox) {
-        TConstArrayRef<double> approx = approxRef[0];
-        TConstArrayRef<double> approxDelta = GetRowRef(approxDeltaRef, /*rowIdx*/0);
-        TPFoundCalcer calcer(TopSize, Decay);
-        for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-            const int queryBegin = queriesInfo[queryIndex].Begin;
-            const int queryEnd = queriesInfo[queryIndex].End;
-            const ui32* subgroupIdData = nullptr;
-            const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.0;
-            if (!queriesInfo[queryIndex].SubgroupId.empty()) {
-                subgroupIdData = queriesInfo[queryIndex].SubgroupId.data();
-            }
-            const double* approxDeltaData = nullptr;
-            if (hasDelta) {
-                approxDeltaData = approxDelta.data();
-            }
-            calcer.AddQuery<isExpApprox, hasDelta>(target.data() + queryBegin, approx.data() + queryBegin, approxDeltaData + queryBegin, queryWeight, subgroupIdData, queryEnd - queryBegin);
+    TPFoundCalcer calcer(TopSize, Decay);
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        const ui32 queryBegin = queriesInfo[queryIndex].Begin - offset;
+        const ui32 querySize = queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
+        const ui32* subgroupIdData = nullptr;
+        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.0;
+        if (!queriesInfo[queryIndex].SubgroupId.empty()) {
+            subgroupIdData = queriesInfo[queryIndex].SubgroupId.data();
         }
-        return calcer.GetMetric();
-    };
-    return DispatchGenericLambda(impl, !approxDeltaRef.empty(), isExpApprox);
+        calcer.AddQueryWithDocOrder(target.data() + queryBegin, docOrder.data() + queryBegin, queryWeight, subgroupIdData, querySize);
+    }
+    return calcer.GetMetric();
 }
 
 EErrorType TPFoundMetric::GetErrorType() const {
@@ -2637,22 +2662,19 @@ TVector<TParamSet> TPFoundMetric::ValidParamSets() {
 /* NDCG@N */
 
 namespace {
-    struct TDcgMetric final: public TAdditiveSingleTargetMetric {
+    struct TDcgMetric final: public TQueryDocOrderMetric {
         explicit TDcgMetric(ELossFunction lossFunction, const TLossParams& params,
                             int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator);
 
         static TVector<THolder<IMetric>> Create(const TMetricConfig& config);
         static TVector<TParamSet> ValidParamSets();
 
-        TMetricHolder EvalSingleThread(
-                TConstArrayRef<TConstArrayRef<double>> approx,
-                TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
+        TMetricHolder EvalWithDocOrder(
+            TConstArrayRef<float> target,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            TConstArrayRef<ui32> docOrder,
+            int queryStartIndex,
+            int queryEndIndex
         ) const override;
         TString GetDescription () const override;
         EErrorType GetErrorType() const override;
@@ -2721,7 +2743,7 @@ TString TDcgMetric::GetDescription() const {
 
 TDcgMetric::TDcgMetric(ELossFunction lossFunction, const TLossParams& params,
                        int topSize, ENdcgMetricType type, bool normalized, ENdcgDenominatorType denominator)
-    : TAdditiveSingleTargetMetric(lossFunction, params)
+    : TQueryDocOrderMetric(lossFunction, params)
     , TopSize(topSize)
     , MetricType(type)
     , Normalized(normalized)
@@ -2729,52 +2751,32 @@ TDcgMetric::TDcgMetric(ELossFunction lossFunction, const TLossParams& params,
     UseWeights.SetDefaultValue(true);
 }
 
-TMetricHolder TDcgMetric::EvalSingleThread(
-    TConstArrayRef<TConstArrayRef<double>> approx,
-    TConstArrayRef<TConstArrayRef<double>> approxDelta,
-    bool isExpApprox,
+TMetricHolder TDcgMetric::EvalWithDocOrder(
     TConstArrayRef<float> target,
-    TConstArrayRef<float> /*weight*/,
     TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<ui32> docOrder,
     int queryStartIndex,
     int queryEndIndex
 ) const {
-    Y_ASSERT(!isExpApprox);
-    TConstArrayRef<double> approxesRef;
-    TVector<double> approxWithDelta;
-    if (approxDelta.empty()) {
-        approxesRef = approx.front();
-    } else {
-        Y_ASSERT(approx.front().size() == approxDelta.front().size());
-        approxWithDelta.yresize(approx.front().size());
-        for (size_t doc = 0; doc < approx.front().size(); ++doc) {
-            approxWithDelta[doc] = approx.front()[doc] + approxDelta.front()[doc];
-        }
-        approxesRef = approxWithDelta;
-    }
-
     TMetricHolder error(2);
-    TVector<NMetrics::TSample> samples;
     TVector<double> decay;
     decay.yresize(LargeGroupSize);
     FillDcgDecay(DenominatorType, Nothing(), decay);
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        const auto queryBegin = queriesInfo[queryIndex].Begin;
-        const auto queryEnd = queriesInfo[queryIndex].End;
-        const auto querySize = queryEnd - queryBegin;
+        const auto queryBegin = queriesInfo[queryIndex].Begin - offset;
+        const auto querySize = queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
         const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
-        NMetrics::TSample::FromVectors(
-            MakeArrayRef(target.data() + queryBegin, querySize),
-            MakeArrayRef(approxesRef.data() + queryBegin, querySize),
-            &samples);
+        const auto queryTarget = target.Slice(queryBegin, querySize);
+        const auto queryDocOrder = docOrder.Slice(queryBegin, querySize);
         if (decay.size() < querySize) {
             decay.resize(2 * querySize);
             FillDcgDecay(DenominatorType, Nothing(), decay);
         }
         if (Normalized) {
-            error.Stats[0] += queryWeight * CalcNdcg(samples, decay, MetricType, TopSize);
+            error.Stats[0] += queryWeight * CalcNdcgWithDocOrder(queryTarget, queryDocOrder, decay, MetricType, TopSize);
         } else {
-            error.Stats[0] += queryWeight * CalcDcg(samples, decay, MetricType, TopSize);
+            error.Stats[0] += queryWeight * CalcDcgWithDocOrder(queryTarget, queryDocOrder, decay, MetricType, TopSize);
         }
         error.Stats[1] += queryWeight;
     }
@@ -3139,9 +3141,10 @@ static TVector<TVector<T>> ConstructSquareMatrix(const TString& matrixString) {
 
 namespace {
     struct TAUCMetric final: public TNonAdditiveSingleTargetMetric {
-        explicit TAUCMetric(const TLossParams& params, EAucType singleClassType)
+        explicit TAUCMetric(const TLossParams& params, EAucType singleClassType, ui32 histogramBits = 0)
             : TNonAdditiveSingleTargetMetric(ELossFunction::AUC, params)
-            , Type(singleClassType) {
+            , Type(singleClassType)
+            , HistogramBits(histogramBits) {
             UseWeights.SetDefaultValue(false);
         }
 
@@ -3179,6 +3182,7 @@ namespace {
         int PositiveClass = 1;
         EAucType Type;
         TMaybe<TVector<TVector<double>>> MisclassCostMatrix = Nothing();
+        ui32 HistogramBits = 0; // 0 for exact AUC, otherwise see TBinClassAucHistogram
     };
 }
 
@@ -3198,7 +3202,14 @@ TVector<THolder<IMetric>> TAUCMetric::Create(const TMetricConfig& config) {
     }
     switch (aucType) {
         case EAucType::Classic: {
-            return AsVector(MakeHolder<TAUCMetric>(config.Params, EAucType::Classic));
+            config.ValidParams->insert("histogram_bits");
+            ui32 histogramBits = 0;
+            if (config.GetParamsMap().contains("histogram_bits")) {
+                histogramBits = FromString<ui32>(config.GetParamsMap().at("histogram_bits"));
+                CB_ENSURE(histogramBits <= TBinClassAucHistogram::MaxBinBits,
+                          "AUC histogram_bits should be at most " << TBinClassAucHistogram::MaxBinBits);
+            }
+            return AsVector(MakeHolder<TAUCMetric>(config.Params, EAucType::Classic, histogramBits));
             break;
         }
         case EAucType::Ranking: {
@@ -3240,6 +3251,7 @@ TVector<TParamSet> TAUCMetric::ValidParamSets() {
             {
                 TParamInfo{"use_weights", false, false},
                 TParamInfo{"type", false, ToString(EAucType::Classic)},
+                TParamInfo{"histogram_bits", false, 0},
                 TParamInfo{"hints", false, "skip_train~true"}
             },
             ""
@@ -3329,6 +3341,32 @@ TMetricHolder TAUCMetric::Eval(
             samples.emplace_back(realTarget(i), realApprox(i), realWeight(i));
         }
         error.Stats[0] = CalcAUC(&samples, nullptr, nullptr, &executor);
+    } else if (HistogramBits > 0) {
+        // no copies of predictions, each block needs only its own histogram
+        const int blockCount = Max(1, Min(executor.GetThreadCount() + 1, (end - begin) >> HistogramBits));
+        NCB::TEqualRangesGenerator<int> rangesGenerator({begin, end}, blockCount);
+        TVector<TBinClassAucHistogram> histograms;
+        histograms.reserve(blockCount);
+        for (auto blockId : xrange(blockCount)) {
+            Y_UNUSED(blockId);
+            histograms.emplace_back(HistogramBits);
+        }
+        executor.ExecRangeWithThrow(
+            [&](int blockId) {
+                for (int i : rangesGenerator.GetRange(blockId).Iter()) {
+                    const auto currentTarget = realTarget(i);
+                    CB_ENSURE(0 <= currentTarget && currentTarget <= 1, "All target values should be in the segment [0, 1], for Ranking AUC please use type=Ranking.");
+                    histograms[blockId].Add(realApprox(i), currentTarget * realWeight(i), (1 - currentTarget) * realWeight(i));
+                }
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        for (auto blockId : xrange(1, blockCount)) {
+            histograms[0].Merge(histograms[blockId]);
+        }
+        error.Stats[0] = histograms[0].CalcAuc();
     } else {
         TVector<NMetrics::TBinClassSample> positiveSamples, negativeSamples;
         for (int i : xrange(begin, end)) {
@@ -3376,7 +3414,8 @@ TString TAUCMetric::GetDescription() const {
             return BuildDescription(ELossFunction::AUC, UseWeights, aucType);
         }
         case EAucType::Classic: {
-            return BuildDescription(ELossFunction::AUC, UseWeights);
+            const TMetricParam<ui32> histogramBits("histogram_bits", HistogramBits, HistogramBits != 0);
+            return BuildDescription(ELossFunction::AUC, UseWeights, histogramBits);
         }
         case EAucType::Ranking: {
             return BuildDescription(ELossFunction::AUC, UseWeights, TMetricParam<TString>("type", ToString(EAucType::Ranking), /*userDefined*/true));
@@ -3942,7 +3981,7 @@ TVector<TParamSet> TPairAccuracyMetric::ValidParamSets() {
 /* PrecisionAtK */
 
 namespace {
-    struct TPrecisionAtKMetric final: public TAdditiveSingleTargetMetric {
+    struct TPrecisionAtKMetric final: public TQueryDocOrderMetric {
         explicit TPrecisionAtKMetric(const TLossParams& params,
                                      int topSize,
                                      float targetBorder);
@@ -3950,15 +3989,12 @@ namespace {
         static TVector<THolder<IMetric>> Create(const TMetricConfig& config);
         static TVector<TParamSet> ValidParamSets();
 
-        TMetricHolder EvalSingleThread(
-                TConstArrayRef<TConstArrayRef<double>> approx,
-                TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
+        TMetricHolder EvalWithDocOrder(
+            TConstArrayRef<float> target,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            TConstArrayRef<ui32> docOrder,
+            int queryStartIndex,
+            int queryEndIndex
         ) const override;
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
@@ -3980,33 +4016,26 @@ TVector<THolder<IMetric>> TPrecisionAtKMetric::Create(const TMetricConfig& confi
 }
 
 TPrecisionAtKMetric::TPrecisionAtKMetric(const TLossParams& params, int topSize, float targetBorder)
-        : TAdditiveSingleTargetMetric(ELossFunction::PrecisionAt, params)
+        : TQueryDocOrderMetric(ELossFunction::PrecisionAt, params)
         , TopSize(topSize)
         , TargetBorder(targetBorder) {
     UseWeights.SetDefaultValue(true);
 }
 
-TMetricHolder TPrecisionAtKMetric::EvalSingleThread(
-        TConstArrayRef<TConstArrayRef<double>> approx,
-        TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
+TMetricHolder TPrecisionAtKMetric::EvalWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<ui32> docOrder,
+    int queryStartIndex,
+    int queryEndIndex
 ) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
-
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
+        const ui32 queryBegin = queriesInfo[queryIndex].Begin - offset;
+        const ui32 querySize = queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
 
-        error.Stats[0] += CalcPrecisionAtK(approxCopy, targetCopy, TopSize, TargetBorder);
+        error.Stats[0] += CalcPrecisionAtKWithDocOrder(target.Slice(queryBegin, querySize), docOrder.Slice(queryBegin, querySize), TopSize, TargetBorder);
         error.Stats[1]++;
     }
     return error;
@@ -4040,19 +4069,16 @@ TVector<TParamSet> TPrecisionAtKMetric::ValidParamSets() {
 /* RecallAtK */
 
 namespace {
-    struct TRecallAtKMetric final: public TAdditiveSingleTargetMetric {
+    struct TRecallAtKMetric final: public TQueryDocOrderMetric {
         explicit TRecallAtKMetric(const TLossParams& params, int topSize, float targetBorder);
         static TVector<THolder<IMetric>> Create(const TMetricConfig& config);
         static TVector<TParamSet> ValidParamSets();
-        TMetricHolder EvalSingleThread(
-                TConstArrayRef<TConstArrayRef<double>> approx,
-                TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
+        TMetricHolder EvalWithDocOrder(
+            TConstArrayRef<float> target,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            TConstArrayRef<ui32> docOrder,
+            int queryStartIndex,
+            int queryEndIndex
         ) const override;
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
@@ -4074,33 +4100,26 @@ TVector<THolder<IMetric>> TRecallAtKMetric::Create(const TMetricConfig& config)
 }
 
 TRecallAtKMetric::TRecallAtKMetric(const TLossParams& params, int topSize, float targetBorder)
-        : TAdditiveSingleTargetMetric(ELossFunction::RecallAt, params)
+        : TQueryDocOrderMetric(ELossFunction::RecallAt, params)
         , TopSize(topSize)
         , TargetBorder(targetBorder) {
     UseWeights.SetDefaultValue(true);
 }
 
-TMetricHolder TRecallAtKMetric::EvalSingleThread(
-        TConstArrayRef<TConstArrayRef<double>> approx,
-        TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
+TMetricHolder TRecallAtKMetric::EvalWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<ui32> docOrder,
+    int queryStartIndex,
+    int queryEndIndex
 ) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
+        const ui32 queryBegin = queriesInfo[queryIndex].Begin - offset;
+        const ui32 querySize = queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
-
-        error.Stats[0] += CalcRecallAtK(approxCopy, targetCopy, TopSize, TargetBorder);
+        error.Stats[0] += CalcRecallAtKWithDocOrder(target.Slice(queryBegin, querySize), docOrder.Slice(queryBegin, querySize), TopSize, TargetBorder);
         error.Stats[1]++;
     }
     return error;
@@ -4134,19 +4153,16 @@ TVector<TParamSet> TRecallAtKMetric::ValidParamSets() {
 /* Mean Average Precision at k */
 
 namespace {
-    struct TMAPKMetric final: public TAdditiveSingleTargetMetric {
+    struct TMAPKMetric final: public TQueryDocOrderMetric {
         explicit TMAPKMetric(const TLossParams& params, int topSize, float targetBorder);
         static TVector<THolder<IMetric>> Create(const TMetricConfig& config);
         static TVector<TParamSet> ValidParamSets();
-        TMetricHolder EvalSingleThread(
-                TConstArrayRef<TConstArrayRef<double>> approx,
-                TConstArrayRef<TConstArrayRef<double>> approxDelta,
-                bool isExpApprox,
-                TConstArrayRef<float> target,
-                TConstArrayRef<float> weight,
-                TConstArrayRef<TQueryInfo> queriesInfo,
-                int queryStartIndex,
-                int queryEndIndex
+        TMetricHolder EvalWithDocOrder(
+            TConstArrayRef<float> target,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            TConstArrayRef<ui32> docOrder,
+            int queryStartIndex,
+            int queryEndIndex
         ) const override;
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
@@ -4169,34 +4185,26 @@ TVector<THolder<IMetric>> TMAPKMetric::Create(const TMetricConfig& config) {
 }
 
 TMAPKMetric::TMAPKMetric(const TLossParams& params, int topSize, float targetBorder)
-        : TAdditiveSingleTargetMetric(ELossFunction::MAP, params)
+        : TQueryDocOrderMetric(ELossFunction::MAP, params)
         , TopSize(topSize)
         , TargetBorder(targetBorder) {
     UseWeights.SetDefaultValue(true);
 }
 
-TMetricHolder TMAPKMetric::EvalSingleThread(
-        TConstArrayRef<TConstArrayRef<double>> approx,
-        TConstArrayRef<TConstArrayRef<double>> approxDelta,
-        bool isExpApprox,
-        TConstArrayRef<float> target,
-        TConstArrayRef<float> /*weight*/,
-        TConstArrayRef<TQueryInfo> queriesInfo,
-        int queryStartIndex,
-        int queryEndIndex
+TMetricHolder TMAPKMetric::EvalWithDocOrder(
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<ui32> docOrder,
+    int queryStartIndex,
+    int queryEndIndex
 ) const {
-    Y_ASSERT(approxDelta.empty());
-    Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
-
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
-        int queryBegin = queriesInfo[queryIndex].Begin;
-        int queryEnd = queriesInfo[queryIndex].End;
-
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.data() + queryBegin, target.data() + queryEnd);
+        const ui32 queryBegin = queriesInfo[queryIndex].Begin - offset;
+        const ui32 querySize = queriesInfo[queryIndex].End - queriesInfo[queryIndex].Begin;
 
-        error.Stats[0] += CalcAveragePrecisionK(approxCopy, targetCopy, TopSize, TargetBorder);
+        error.Stats[0] += CalcAveragePrecisionKWithDocOrder(target.Slice(queryBegin, querySize), docOrder.Slice(queryBegin, querySize), TopSize, TargetBorder);
         error.Stats[1]++;
     }
     return error;
@@ -4422,6 +4430,7 @@ TVector<TParamSet> TPRAUCMetric::ValidParamSets() {
             {
                 TParamInfo{"use_weights", false, false},
                 TParamInfo{"type", false, ToString(EAucType::Classic)},
+                TParamInfo{"histogram_bits", false, 0},
                 TParamInfo{"hints", false, "skip_train~true"}
             },
             ""
@@ -5274,6 +5283,7 @@ TVector<TParamSet> TQueryAUCMetric::ValidParamSets() {
             {
                 TParamInfo{"use_weights", false, false},
                 TParamInfo{"type", false, ToString(EAucType::Classic)},
+                TParamInfo{"histogram_bits", false, 0},
                 TParamInfo{"hints", false, "skip_train~true"}
             },
             ""
@@ -222,6 +222,19 @@ struct IMultiTargetEval {
     ) const = 0;
 };
 
+// Querywise metrics depending on approxes only through the order of documents in queries (see query_doc_order.h),
+// so that the order can be calculated once for all such metrics
+struct IQueryDocOrderEval {
+    // target and docOrder start at the first object of query queryStartIndex
+    virtual TMetricHolder EvalWithDocOrder(
+        TConstArrayRef<float> target,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        TConstArrayRef<ui32> docOrder,
+        int queryStartIndex,
+        int queryEndIndex
+    ) const = 0;
+};
+
 struct TSingleTargetMetric : public TMetric, ISingleTargetEval {
     explicit TSingleTargetMetric(ELossFunction lossFunction, const TLossParams& descriptionParams)
         : TMetric(lossFunction, descriptionParams) {}
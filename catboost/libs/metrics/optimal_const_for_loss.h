@@ -66,30 +66,25 @@ namespace NCB {
         return targetSum / summaryWeight;
     }
 
-    inline float CalculateWeightedTargetQuantile(
+    // specific adjust of quantile q according to delta parameter
+    inline double AdjustWeightedTargetQuantile(
         TConstArrayRef<float> target,
         TConstArrayRef<float> weights,
         double alpha,
-        double delta
+        double delta,
+        double q
     ) {
-        if (target.empty()) {
-            return 0;
-        }
-        const TVector<float> defaultWeights(target.size(), 1); // espetrov: replace with dispatch by weights.empty()
-        const auto weightsRef = weights.empty() ? MakeConstArrayRef(defaultWeights) : weights;
-        double q = CalcSampleQuantile(target, weightsRef, alpha);
-
-        // specific adjust according to delta parameter
         if (delta > 0) {
             const double totalWeight = weights.empty() ? static_cast<double>(target.size()) : Accumulate(weights, 0.0);
             const double needWeight = totalWeight * alpha;
             double lessWeight = 0;
             double equalWeight = 0;
             for (auto i : xrange(target.size())) {
+                const double weight = weights.empty() ? 1.0 : weights[i];
                 if (target[i] < q) {
-                    lessWeight += weightsRef[i];
+                    lessWeight += weight;
                 } else if (target[i] == q) {
-                    equalWeight += weightsRef[i];
+                    equalWeight += weight;
                 }
             }
             if (lessWeight + equalWeight * alpha >= needWeight - DBL_EPSILON) {
@@ -98,10 +93,40 @@ namespace NCB {
                 q += delta;
             }
         }
-
         return q;
     }
 
+    inline float CalculateWeightedTargetQuantile(
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weights,
+        double alpha,
+        double delta
+    ) {
+        if (target.empty()) {
+            return 0;
+        }
+        const double q = CalcSampleQuantile(target, weights, alpha);
+        return AdjustWeightedTargetQuantile(target, weights, alpha, delta, q);
+    }
+
+    // the same for several alphas, quantiles are selected in one pass over target
+    inline TVector<float> CalculateWeightedTargetQuantiles(
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weights,
+        TConstArrayRef<double> alphas,
+        double delta
+    ) {
+        TVector<float> result(alphas.size(), 0.0f);
+        if (target.empty()) {
+            return result;
+        }
+        const TVector<double> quantiles = CalcSampleQuantiles(target, weights, alphas);
+        for (auto i : xrange(alphas.size())) {
+            result[i] = AdjustWeightedTargetQuantile(target, weights, alphas[i], delta, quantiles[i]);
+        }
+        return result;
+    }
+
     inline float CalculateOptimalConstApproxForMAPE(
         TConstArrayRef<float> target,
         TConstArrayRef<float> weights
@@ -226,21 +251,9 @@ namespace NCB {
             {
                 auto params = lossDescription.GetLossParamsMap();
                 const auto alpha = NCatboostOptions::GetAlphaMultiQuantile(params);
-                NCatboostOptions::TLossDescription quantileDescription;
-                quantileDescription.LossFunction = ELossFunction::Quantile;
-                if (params.contains("delta")) {
-                    quantileDescription.LossParams->Put("delta", params.at("delta"));
-                }
-                const auto quantileCount = alpha.size();
-                TVector<double> startPoint(quantileCount);
-                for (auto quantile : xrange(quantileCount)) {
-                    quantileDescription.LossParams->Put("alpha", ToString(alpha[quantile]));
-                    startPoint[quantile] = *CalcOneDimensionalOptimumConstApprox(
-                        quantileDescription,
-                        target[0],
-                        weights);
-                }
-                return startPoint;
+                const double delta = params.contains("delta") ? FromString<double>(params.at("delta")) : 1e-6;
+                const auto quantiles = CalculateWeightedTargetQuantiles(target[0], weights, alpha, delta);
+                return TVector<double>(quantiles.begin(), quantiles.end());
             }
             case ELossFunction::MultiRMSEWithMissingValues:
             {
@@ -21,9 +21,9 @@ public:
 
     template <bool isExpApprox, bool hasDelta, class TRelevsType, class TApproxType>
     void AddQuery(const TRelevsType* relevs, const TApproxType* approxes, const TApproxType* approxDelta, float queryWeight, const ui32* subgroupData, ui32 querySize) {
-        TVector<int> qurls(querySize);
+        TVector<ui32> qurls(querySize);
         std::iota(qurls.begin(), qurls.end(), 0);
-        Sort(qurls.begin(), qurls.end(), [&](int left, int right) -> bool {
+        Sort(qurls.begin(), qurls.end(), [&](ui32 left, ui32 right) -> bool {
             if (hasDelta) {
                 if (isExpApprox) {
                     return CompareDocs(approxes[left] * approxDelta[left], relevs[left], approxes[right] * approxDelta[right], relevs[right]);
@@ -34,7 +34,12 @@ public:
                 return CompareDocs(approxes[left], relevs[left], approxes[right], relevs[right]);
             }
         });
+        AddQueryWithDocOrder(relevs, qurls.data(), queryWeight, subgroupData, querySize);
+    }
 
+    // qurls is the order of documents in query, see query_doc_order.h
+    template <class TRelevsType>
+    void AddQueryWithDocOrder(const TRelevsType* relevs, const ui32* qurls, float queryWeight, const ui32* subgroupData, ui32 querySize) {
         double pLook = 1, pFound = 0;
         const ui32 depth = Min<ui32>(querySize, Depth);
 
@@ -81,3 +81,39 @@ double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float
     }
     return hits > 0 ? score / Min<double>(hits, static_cast<size_t>(size)) : 0;
 }
+
+static int CalcRelevantWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, float border, size_t size) {
+    int relevant = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (target[docOrder[i]] > border)
+            relevant++;
+    }
+    return relevant;
+}
+
+double CalcPrecisionAtKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border) {
+    size_t size = CalcSampleSize(target.size(), top);
+    return CalcRelevantWithDocOrder(target, docOrder, border, size) / static_cast<double>(size);
+}
+
+double CalcRecallAtKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border) {
+    size_t size = CalcSampleSize(target.size(), top);
+    int relevant = CalcRelevantWithDocOrder(target, docOrder, border, target.size());
+    return relevant != 0 ? CalcRelevantWithDocOrder(target, docOrder, border, size) / static_cast<double>(relevant) : 1;
+}
+
+double CalcAveragePrecisionKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border) {
+    double score = 0;
+    double hits = 0;
+
+    size_t size = CalcSampleSize(target.size(), top);
+    for (size_t index = 0; index < target.size(); ++index) {
+        if (target[docOrder[index]] > border) {
+            hits += 1;
+            if (index < size) {
+                score += hits / (index + 1);
+            }
+        }
+    }
+    return hits > 0 ? score / Min<double>(hits, static_cast<size_t>(size)) : 0;
+}
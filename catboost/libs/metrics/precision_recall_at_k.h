@@ -1,9 +1,17 @@
 #pragma once
 
 #include <util/generic/fwd.h>
+#include <util/system/types.h>
 
 double CalcPrecisionAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, float border);
 
 double CalcRecallAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, float border);
 
 double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, float border);
+
+// docOrder is the order of documents in query, see query_doc_order.h
+double CalcPrecisionAtKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border);
+
+double CalcRecallAtKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border);
+
+double CalcAveragePrecisionKWithDocOrder(TConstArrayRef<float> target, TConstArrayRef<ui32> docOrder, int top, float border);
@@ -0,0 +1,81 @@
+#include "query_doc_order.h"
+#include "doc_comparator.h"
+
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+
+
+void CalcQueryDocOrder(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    TArrayRef<ui32> docOrder
+) {
+    if (queryStartIndex == queryEndIndex) {
+        return;
+    }
+    const ui32 offset = queriesInfo[queryStartIndex].Begin;
+    for (auto queryIdx : xrange(queryStartIndex, queryEndIndex)) {
+        const ui32 queryBegin = queriesInfo[queryIdx].Begin - offset;
+        const ui32 queryEnd = queriesInfo[queryIdx].End - offset;
+        const double* queryApprox = approx.data() + queryBegin;
+        const float* queryTarget = target.data() + queryBegin;
+        Iota(docOrder.begin() + queryBegin, docOrder.begin() + queryEnd, ui32(0));
+        Sort(
+            docOrder.begin() + queryBegin,
+            docOrder.begin() + queryEnd,
+            [=] (ui32 left, ui32 right) {
+                return CompareDocs(queryApprox[left], queryTarget[left], queryApprox[right], queryTarget[right]);
+            });
+    }
+}
+
+TVector<ui32> CalcQueryDocOrder(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TVector<ui32> docOrder;
+    if (queriesInfo.empty()) {
+        return docOrder;
+    }
+    docOrder.yresize(queriesInfo.back().End);
+
+    TVector<ui32> queryOffsets;
+    queryOffsets.yresize(queriesInfo.size() + 1);
+    for (auto queryIdx : xrange(queriesInfo.size())) {
+        queryOffsets[queryIdx] = queriesInfo[queryIdx].Begin;
+    }
+    queryOffsets.back() = queriesInfo.back().End;
+
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        docOrder.size(),
+        [&] (int docIdx) {
+            docOrder[docIdx] = docIdx;
+        });
+    // queries are distributed between threads by their sizes, large queries do not stall a block of small ones
+    NCB::ParallelSegmentedSort(
+        MakeConstArrayRef(queryOffsets),
+        MakeArrayRef(docOrder),
+        [&] (ui32 left, ui32 right) {
+            return CompareDocs(approx[left], target[left], approx[right], target[right]);
+        },
+        localExecutor);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        queriesInfo.size(),
+        [&] (int queryIdx) {
+            for (auto docIdx : xrange(queriesInfo[queryIdx].Begin, queriesInfo[queryIdx].End)) {
+                docOrder[docIdx] -= queriesInfo[queryIdx].Begin;
+            }
+        });
+    return docOrder;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <catboost/private/libs/data_types/query.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+/**
+ * Order of documents in queries as used by ranking metrics: by decreasing approx, documents with equal
+ * approxes by increasing target (see CompareDocs). docOrder[queryBegin + position] is the index in query
+ * of the document at this position.
+ * approx, target and docOrder start at the first object of query queryStartIndex.
+ */
+void CalcQueryDocOrder(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    TArrayRef<ui32> docOrder);
+
+// For all queries, queries are processed in parallel
+TVector<ui32> CalcQueryDocOrder(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    NPar::ILocalExecutor* localExecutor);
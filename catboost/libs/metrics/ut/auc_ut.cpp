@@ -9,6 +9,8 @@
 #include <util/random/fast.h>
 #include <util/random/shuffle.h>
 
+#include <limits>
+
 constexpr double EPS = 1e-12;
 
 static TVector<ui32> RandomSubset(ui32 size, ui32 num, TRandom& rnd) {
@@ -559,4 +561,36 @@ Y_UNIT_TEST_SUITE(AUCMetricTests) {
         TestBinClassAucRandom(2000, 1000, false, EPS);
         TestBinClassAucRandom(2000, 2000, false, EPS);
     }
+
+    Y_UNIT_TEST(BinClassAucHistogramTest) {
+        // predictions with few significant bits fall into different bins, so histogram AUC is exact
+        TRandom rnd(239);
+        TVector<NMetrics::TBinClassSample> positiveSamples, negativeSamples;
+        TBinClassAucHistogram histogram;
+        TBinClassAucHistogram secondHalfHistogram;
+        for (ui32 i = 0; i < 2000; ++i) {
+            const double prediction = (int(rnd(65)) - 32) / 8.0;
+            const double weight = rnd(10) + 1;
+            const bool isPositive = rnd(2);
+            (isPositive ? positiveSamples : negativeSamples).emplace_back(prediction, weight);
+            (i < 1000 ? histogram : secondHalfHistogram).Add(prediction, isPositive ? weight : 0, isPositive ? 0 : weight);
+        }
+        histogram.Merge(secondHalfHistogram);
+        UNIT_ASSERT_DOUBLES_EQUAL(histogram.CalcAuc(), CalcBinClassAuc(&positiveSamples, &negativeSamples), EPS);
+
+        TBinClassAucHistogram coarseHistogram(1);
+        coarseHistogram.Add(-2, 1, 0);
+        coarseHistogram.Add(1, 0, 1);
+        coarseHistogram.Add(3, 1, 0);
+        // bins are [-inf, 0) and [0, +inf], the pair in the second bin counts as a tie
+        UNIT_ASSERT_DOUBLES_EQUAL(coarseHistogram.CalcAuc(), 0.25, EPS);
+        UNIT_ASSERT_VALUES_EQUAL(coarseHistogram.GetBinCount(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(coarseHistogram.GetBinLowerBound(0), -std::numeric_limits<double>::infinity());
+        UNIT_ASSERT_VALUES_EQUAL(coarseHistogram.GetBinLowerBound(1), 0.0);
+        UNIT_ASSERT_VALUES_EQUAL(coarseHistogram.GetPositiveWeight(1), 1.0);
+        UNIT_ASSERT_VALUES_EQUAL(coarseHistogram.GetNegativeWeight(1), 1.0);
+
+        // the bin of 2.0 starts at it
+        UNIT_ASSERT_VALUES_EQUAL(histogram.GetBinLowerBound(3 * histogram.GetBinCount() / 4), 2.0);
+    }
 }
@@ -0,0 +1,139 @@
+#include <catboost/libs/metrics/caching_metric.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+static void CheckEqualErrors(
+    const TVector<const IMetric*>& metrics,
+    const TVector<TMetricHolder>& errors,
+    const TVector<TMetricHolder>& expectedErrors
+) {
+    UNIT_ASSERT_VALUES_EQUAL(errors.size(), expectedErrors.size());
+    for (auto i : xrange(metrics.size())) {
+        UNIT_ASSERT_DOUBLES_EQUAL(
+            metrics[i]->GetFinalError(errors[i]),
+            metrics[i]->GetFinalError(expectedErrors[i]),
+            1e-9);
+    }
+}
+
+Y_UNIT_TEST_SUITE(EvalErrorsWithCachingTest) {
+    Y_UNIT_TEST(TestFusedEvaluation) {
+        const ui32 objectCount = 30000;
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<float> weight;
+        for (auto i : xrange(objectCount)) {
+            Y_UNUSED(i);
+            approx[0].push_back(rng.GenRandReal1() * 4 - 2);
+            target.push_back(rng.GenRand() % 2);
+            weight.push_back(rng.GenRandReal1() + 0.5);
+        }
+        const auto metricHolders = CreateMetricsFromDescription(
+            {"Logloss", "CrossEntropy", "Accuracy", "Precision", "Recall", "F1", "RMSE", "AUC"},
+            /*approxDim*/1);
+        TVector<const IMetric*> metrics;
+        for (const auto& metric : metricHolders) {
+            metrics.push_back(metric.Get());
+        }
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        const auto errors = EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, weight, /*queriesInfo*/{}, metrics, &executor);
+        TVector<TMetricHolder> expectedErrors;
+        for (const auto* metric : metrics) {
+            expectedErrors.push_back(EvalErrors(To2DConstArrayRef<double>(approx), /*approxDelta*/{}, /*isExpApprox*/false, target, weight, /*queriesInfo*/{}, *metric, &executor));
+        }
+        CheckEqualErrors(metrics, errors, expectedErrors);
+    }
+}
+
+Y_UNIT_TEST_SUITE(QueryDocOrderTest) {
+    Y_UNIT_TEST(TestSharedQueryDocOrder) {
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<TQueryInfo> queriesInfo;
+        for (ui32 queryIdx = 0; queryIdx < 3000; ++queryIdx) {
+            const ui32 begin = target.size();
+            const ui32 querySize = 1 + rng.GenRand() % 20;
+            for (ui32 i = 0; i < querySize; ++i) {
+                approx[0].push_back(rng.GenRand() % 5);
+                target.push_back((rng.GenRand() % 4) / 3.0);
+            }
+            queriesInfo.emplace_back(begin, target.size());
+            queriesInfo.back().Weight = 1 + rng.GenRand() % 3;
+        }
+        const auto metricHolders = CreateMetricsFromDescription(
+            {"NDCG:top=5", "DCG", "PFound", "PrecisionAt:top=3", "RecallAt:top=3", "MAP:top=3"},
+            /*approxDim*/1);
+        TVector<const IMetric*> metrics;
+        for (const auto& metric : metricHolders) {
+            metrics.push_back(metric.Get());
+        }
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        const auto errors = EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, /*weight*/{}, queriesInfo, metrics, &executor);
+        TVector<TMetricHolder> expectedErrors;
+        for (const auto* metric : metrics) {
+            expectedErrors.push_back(EvalErrors(To2DConstArrayRef<double>(approx), /*approxDelta*/{}, /*isExpApprox*/false, target, /*weight*/{}, queriesInfo, *metric, &executor));
+        }
+        CheckEqualErrors(metrics, errors, expectedErrors);
+    }
+}
+
+Y_UNIT_TEST_SUITE(AdditiveMetricsStateTest) {
+    Y_UNIT_TEST(TestPartialUpdate) {
+        const ui32 objectCount = 50000;
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<float> weight;
+        for (auto i : xrange(objectCount)) {
+            Y_UNUSED(i);
+            approx[0].push_back(rng.GenRandReal1() * 4 - 2);
+            target.push_back(rng.GenRand() % 2);
+            weight.push_back(rng.GenRandReal1() + 0.5);
+        }
+        const auto metricHolders = CreateMetricsFromDescription({"Logloss", "Accuracy"}, /*approxDim*/1);
+        TVector<const IMetric*> metrics;
+        for (const auto& metric : metricHolders) {
+            metrics.push_back(metric.Get());
+        }
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        const auto evalErrors = [&] (TAdditiveMetricsState* state) {
+            return EvalErrorsWithCaching(approx, /*approxDelta*/{}, /*isExpApprox*/false, target, weight, /*queriesInfo*/{}, metrics, &executor, state);
+        };
+
+        TAdditiveMetricsState state;
+        CheckEqualErrors(metrics, evalErrors(&state), evalErrors(nullptr));
+        UNIT_ASSERT_VALUES_EQUAL(state.BlockResults.size(), metrics.size());
+        const auto blockCount = state.ObjectwiseBlockHashes.size();
+        UNIT_ASSERT(blockCount > 1);
+
+        // unchanged approxes
+        CheckEqualErrors(metrics, evalErrors(&state), evalErrors(nullptr));
+
+        // changes in one block
+        approx[0][objectCount / 2] = -approx[0][objectCount / 2];
+        target[objectCount / 2] = 1 - target[objectCount / 2];
+        approx[0][objectCount / 2 + 1] += 10;
+        CheckEqualErrors(metrics, evalErrors(&state), evalErrors(nullptr));
+
+        // changes everywhere
+        for (auto& value : approx[0]) {
+            value *= 0.5;
+        }
+        CheckEqualErrors(metrics, evalErrors(&state), evalErrors(nullptr));
+        UNIT_ASSERT_VALUES_EQUAL(state.ObjectwiseBlockHashes.size(), blockCount);
+    }
+}
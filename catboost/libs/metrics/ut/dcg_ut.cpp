@@ -1,5 +1,6 @@
 #include <catboost/libs/metrics/dcg.h>
 #include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/query_doc_order.h>
 #include <catboost/libs/metrics/sample.h>
 
 #include <library/cpp/testing/unittest/registar.h>
@@ -32,6 +33,28 @@ Y_UNIT_TEST_SUITE(NdcgTests) {
         }
     }
 
+    Y_UNIT_TEST(TestNdcgWithDocOrder) {
+        TFastRng<ui64> rng(0);
+        TVector<double> approx;
+        TVector<float> target;
+        for (ui32 i = 0; i < 100; ++i) {
+            approx.push_back(rng.Uniform(10));
+            target.push_back(rng.Uniform(4));
+        }
+        const auto samples = NMetrics::TSample::FromVectors(target, approx);
+        TVector<double> decay(samples.size());
+        FillDcgDecay(ENdcgDenominatorType::LogPosition, Nothing(), decay);
+        const TVector<TQueryInfo> queriesInfo = {TQueryInfo(0, approx.size())};
+        TVector<ui32> docOrder(approx.size());
+        CalcQueryDocOrder(approx, target, queriesInfo, 0, 1, docOrder);
+        for (auto type : {ENdcgMetricType::Base, ENdcgMetricType::Exp}) {
+            for (ui32 top : {1u, 10u, 1000u}) {
+                UNIT_ASSERT_DOUBLES_EQUAL(CalcNdcgWithDocOrder(target, docOrder, decay, type, top), CalcNdcg(samples, decay, type, top), 1e-9);
+                UNIT_ASSERT_DOUBLES_EQUAL(CalcDcgWithDocOrder(target, docOrder, decay, type, top), CalcDcg(samples, decay, type, top), 1e-9);
+            }
+        }
+    }
+
     Y_UNIT_TEST(TestDcgDetails) {
         {
             TVector<double> approx{1.0, 0.0, 2.0};
@@ -0,0 +1,70 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+#include <catboost/libs/helpers/grouped_index_hash.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NCatboost;
+
+// 24MB of dense buckets, so most lookups miss cache as for CTR tables of high cardinality features
+const size_t UniqueHashCount = 1 << 20;
+const size_t LookupCount = 1 << 16;
+
+struct TCtrIndexBenchData {
+    TVector<TBucket> DenseBuckets;
+    THolder<TGroupedIndexHash> GroupedIndex;
+    TVector<ui64> Hashes;
+    TVector<ui64> Indexes;
+
+    TCtrIndexBenchData() {
+        TFastRng64 rng(0);
+        TVector<ui64> uniqueHashes(UniqueHashCount);
+        for (auto& hash : uniqueHashes) {
+            hash = rng.GenRand();
+        }
+        DenseBuckets.resize(TDenseIndexHashBuilder::GetProperBucketsCount(UniqueHashCount));
+        TDenseIndexHashBuilder builder(DenseBuckets);
+        for (auto hash : uniqueHashes) {
+            builder.AddIndex(hash);
+        }
+        GroupedIndex = MakeHolder<TGroupedIndexHash>(TDenseIndexHashView(DenseBuckets));
+        // every tenth lookup is of an unknown category value
+        Hashes.resize(LookupCount);
+        for (auto idx : xrange(LookupCount)) {
+            Hashes[idx] = idx % 10 ? uniqueHashes[rng.Uniform(UniqueHashCount)] : rng.GenRand();
+        }
+        Indexes.resize(LookupCount);
+    }
+};
+
+Y_CPU_BENCHMARK(CtrDenseIndexLookup, iface) {
+    auto& data = *Singleton<TCtrIndexBenchData>();
+    const TDenseIndexHashView denseIndex(data.DenseBuckets);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        for (auto idx : xrange(LookupCount)) {
+            data.Indexes[idx] = denseIndex.GetIndex(data.Hashes[idx]);
+        }
+        NBench::Clobber();
+    }
+}
+
+Y_CPU_BENCHMARK(CtrGroupedIndexLookup, iface) {
+    auto& data = *Singleton<TCtrIndexBenchData>();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        for (auto idx : xrange(LookupCount)) {
+            data.Indexes[idx] = data.GroupedIndex->GetIndex(data.Hashes[idx]);
+        }
+        NBench::Clobber();
+    }
+}
+
+Y_CPU_BENCHMARK(CtrGroupedIndexBatchLookup, iface) {
+    auto& data = *Singleton<TCtrIndexBenchData>();
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        data.GroupedIndex->GetIndexes(data.Hashes, data.Indexes);
+        NBench::Clobber();
+    }
+}
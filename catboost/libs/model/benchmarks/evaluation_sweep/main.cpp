@@ -0,0 +1,462 @@
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/hash.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/static_ctr_provider.h>
+
+#include <library/cpp/getopt/small/last_getopt.h>
+#include <library/cpp/json/json_value.h>
+#include <library/cpp/json/json_writer.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/array_size.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/string/printf.h>
+#include <util/string/split.h>
+#include <util/system/hp_timer.h>
+
+#include <functional>
+
+
+namespace {
+    struct TSweepOptions {
+        TVector<size_t> BatchSizes = {1, 128, 10000};
+        TVector<size_t> TreeCounts = {100, 1000};
+        TVector<size_t> Depths = {6, 8};
+        TVector<int> ApproxDimensions = {1, 3};
+        TVector<TString> FeatureTypes = {"float", "cat"};
+        TVector<EFormulaEvaluatorType> EvaluatorTypes = {EFormulaEvaluatorType::CPU};
+
+        size_t FloatFeatureCount = 50;
+        size_t BordersPerFeature = 64;
+        size_t CatFeatureCount = 10;
+        size_t CatFeatureCardinality = 10000;
+        size_t SampleCount = 200;
+        ui64 Seed = 0;
+
+        TString OutputJsonPath;
+    };
+
+    struct TModelParams {
+        size_t TreeCount;
+        size_t Depth;
+        int ApproxDimension;
+        bool HasCatFeatures;
+    };
+
+    /* Docs in all the layouts taken by evaluation APIs.
+     * Categorical feature values are strings "c<number>", and every tenth value is absent in CTR tables.
+     */
+    struct TDocsPool {
+        size_t DocCount = 0;
+        size_t FloatFeatureCount = 0;
+
+        TVector<TVector<float>> FloatFeatures; // [docIdx][floatFeatureIdx]
+        TVector<TVector<float>> FlatFeatures; // [docIdx][flatFeatureIdx], hashes of categorical features
+        TVector<TVector<float>> TransposedFlatFeatures; // [flatFeatureIdx][docIdx]
+        TVector<TVector<TString>> CatFeatureStrings; // [docIdx][catFeatureIdx]
+        TVector<TVector<TStringBuf>> CatFeatures;
+
+        TVector<TConstArrayRef<float>> FloatFeatureRefs;
+        TVector<TConstArrayRef<float>> FlatFeatureRefs;
+    };
+
+    struct TTimings {
+        double P50 = 0.0; // ns/doc
+        double P99 = 0.0; // ns/doc
+    };
+}
+
+
+template <class T>
+static TVector<T> ParseList(TStringBuf list) {
+    TVector<T> result;
+    for (const auto& item : StringSplitter(list).Split(',').SkipEmpty()) {
+        result.push_back(FromString<T>(item.Token()));
+    }
+    CB_ENSURE(!result.empty(), "Empty list of values");
+    return result;
+}
+
+static TString GetCatFeatureValue(ui32 value) {
+    return "c" + ToString(value);
+}
+
+static TDocsPool GenerateDocs(const TSweepOptions& options, size_t docCount) {
+    TFastRng64 rng(options.Seed + 1);
+    TDocsPool pool;
+    pool.DocCount = docCount;
+    pool.FloatFeatureCount = options.FloatFeatureCount;
+    const size_t flatFeatureCount = options.FloatFeatureCount + options.CatFeatureCount;
+
+    pool.FloatFeatures.resize(docCount, TVector<float>(options.FloatFeatureCount));
+    pool.FlatFeatures.resize(docCount, TVector<float>(flatFeatureCount));
+    pool.CatFeatureStrings.resize(docCount, TVector<TString>(options.CatFeatureCount));
+    pool.CatFeatures.resize(docCount, TVector<TStringBuf>(options.CatFeatureCount));
+    for (auto docIdx : xrange(docCount)) {
+        for (auto featureIdx : xrange(options.FloatFeatureCount)) {
+            const float value = rng.GenRandReal1();
+            pool.FloatFeatures[docIdx][featureIdx] = value;
+            pool.FlatFeatures[docIdx][featureIdx] = value;
+        }
+        for (auto featureIdx : xrange(options.CatFeatureCount)) {
+            // skewed distribution of values, as usual for categorical features
+            const ui32 value = rng.Uniform(10) ?
+                ui32(rng.Uniform(options.CatFeatureCardinality) * rng.GenRandReal1()) :
+                ui32(options.CatFeatureCardinality + rng.Uniform(options.CatFeatureCardinality));
+            auto& stringValue = pool.CatFeatureStrings[docIdx][featureIdx];
+            stringValue = GetCatFeatureValue(value);
+            pool.CatFeatures[docIdx][featureIdx] = stringValue;
+            pool.FlatFeatures[docIdx][options.FloatFeatureCount + featureIdx]
+                = ConvertCatFeatureHashToFloat(CalcCatFeatureHash(stringValue));
+        }
+    }
+
+    pool.TransposedFlatFeatures.resize(flatFeatureCount, TVector<float>(docCount));
+    for (auto docIdx : xrange(docCount)) {
+        for (auto featureIdx : xrange(flatFeatureCount)) {
+            pool.TransposedFlatFeatures[featureIdx][docIdx] = pool.FlatFeatures[docIdx][featureIdx];
+        }
+    }
+    pool.FloatFeatureRefs.assign(pool.FloatFeatures.begin(), pool.FloatFeatures.end());
+    pool.FlatFeatureRefs.assign(pool.FlatFeatures.begin(), pool.FlatFeatures.end());
+    return pool;
+}
+
+/* Table of Borders CTR of one categorical feature with all values from 0 to cardinality - 1.
+ * Keys are computed the same way as CTR hashes of projections of a single categorical feature.
+ */
+static TCtrValueTable GenerateCtrTable(const TModelCtrBase& ctrBase, size_t cardinality, TFastRng64* rng) {
+    TCtrValueTable table;
+    table.ModelCtrBase = ctrBase;
+    table.TargetClassesCount = 2;
+    auto indexHashBuilder = table.GetIndexHashBuilder(cardinality);
+    auto counts = table.AllocateBlobAndGetArrayRef<int>(cardinality * 2);
+    for (auto value : xrange(cardinality)) {
+        const ui64 hash = CalcHash(
+            ui64(0),
+            (ui64)(int)CalcCatFeatureHash(GetCatFeatureValue(static_cast<ui32>(value)))
+        );
+        const auto index = indexHashBuilder.AddIndex(hash);
+        counts[index * 2] = rng->Uniform(100);
+        counts[index * 2 + 1] = rng->Uniform(100);
+    }
+    return table;
+}
+
+/* Float splits are uniformly distributed among borders of all features.
+ * In models with categorical features half of the splits are CTR splits, as in models trained on datasets
+ * with informative categorical features.
+ */
+static TFullModel GenerateModel(const TSweepOptions& options, const TModelParams& params) {
+    TFastRng64 rng(options.Seed);
+
+    TVector<TFloatFeature> floatFeatures;
+    for (auto featureIdx : xrange(options.FloatFeatureCount)) {
+        floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>{});
+    }
+    TVector<TCatFeature> catFeatures;
+    if (params.HasCatFeatures) {
+        for (auto featureIdx : xrange(options.CatFeatureCount)) {
+            catFeatures.emplace_back(true, featureIdx, options.FloatFeatureCount + featureIdx, TString());
+        }
+    }
+
+    // CTRs with different priors share the table of their categorical feature
+    const float priorNums[] = {0.0f, 0.5f, 1.0f};
+
+    TObliviousTreeBuilder builder(floatFeatures, catFeatures, {}, {}, params.ApproxDimension);
+    for (auto treeIdx : xrange(params.TreeCount)) {
+        Y_UNUSED(treeIdx);
+        TVector<TModelSplit> splits;
+        for (auto depthIdx : xrange(params.Depth)) {
+            if (params.HasCatFeatures && (depthIdx % 2)) {
+                TModelCtr ctr;
+                ctr.Base.Projection.CatFeatures.push_back(rng.Uniform(options.CatFeatureCount));
+                ctr.Base.CtrType = ECtrType::Borders;
+                ctr.PriorNum = priorNums[rng.Uniform(Y_ARRAY_SIZE(priorNums))];
+                splits.emplace_back(TModelCtrSplit(ctr, rng.GenRandReal1()));
+            } else {
+                const int featureIdx = rng.Uniform(options.FloatFeatureCount);
+                const float border = float(rng.Uniform(options.BordersPerFeature) + 1) / (options.BordersPerFeature + 1);
+                splits.emplace_back(TFloatSplit(featureIdx, border));
+            }
+        }
+        TVector<double> leafValues((size_t(1) << params.Depth) * params.ApproxDimension);
+        for (auto& value : leafValues) {
+            value = rng.GenRandReal1() - 0.5;
+        }
+        builder.AddTree(splits, leafValues, TConstArrayRef<double>());
+    }
+
+    TFullModel model;
+    builder.Build(model.ModelTrees.GetMutable());
+    if (params.HasCatFeatures) {
+        model.CtrProvider = new TStaticCtrProvider;
+        for (auto featureIdx : xrange(options.CatFeatureCount)) {
+            TModelCtrBase ctrBase;
+            ctrBase.Projection.CatFeatures.push_back(featureIdx);
+            ctrBase.CtrType = ECtrType::Borders;
+            model.CtrProvider->AddCtrCalcerData(GenerateCtrTable(ctrBase, options.CatFeatureCardinality, &rng));
+        }
+    }
+    model.UpdateDynamicData();
+    return model;
+}
+
+/* Times sampleCount calls of calcBatch on batches of the given size, taken from different parts of the
+ * pool so that all calls don't work on the same cached docs.
+ */
+static TTimings MeasureNsPerDoc(
+    size_t batchSize,
+    size_t docCount,
+    size_t sampleCount,
+    const std::function<void(size_t, size_t)>& calcBatch // (docOffset, batchSize)
+) {
+    const size_t offsetCount = docCount - batchSize + 1;
+
+    // warm up caches and lazy evaluator data
+    calcBatch(0, batchSize);
+
+    TVector<double> nsPerDoc;
+    nsPerDoc.reserve(sampleCount);
+    THPTimer timer;
+    for (auto sampleIdx : xrange(sampleCount)) {
+        const size_t docOffset = (sampleIdx * batchSize) % offsetCount;
+        timer.Reset();
+        calcBatch(docOffset, batchSize);
+        nsPerDoc.push_back(timer.Passed() * 1e9 / batchSize);
+    }
+    Sort(nsPerDoc);
+
+    TTimings timings;
+    timings.P50 = nsPerDoc[nsPerDoc.size() / 2];
+    timings.P99 = nsPerDoc[Min(nsPerDoc.size() - 1, nsPerDoc.size() * 99 / 100)];
+    return timings;
+}
+
+static TVector<std::pair<TString, std::function<void(size_t, size_t)>>> GetEvaluationApis(
+    const TFullModel& model,
+    const TModelParams& params,
+    size_t batchSize,
+    const TDocsPool& pool,
+    TVector<double>* results
+) {
+    results->yresize(batchSize * params.ApproxDimension);
+    const auto resultsRef = MakeArrayRef(*results);
+
+    TVector<std::pair<TString, std::function<void(size_t, size_t)>>> apis;
+    const auto& flatFeatures = params.HasCatFeatures ? pool.FlatFeatureRefs : pool.FloatFeatureRefs;
+    apis.emplace_back(
+        "CalcFlat",
+        [&model, &flatFeatures, resultsRef] (size_t docOffset, size_t batchSize) {
+            model.CalcFlat(MakeArrayRef(flatFeatures).subspan(docOffset, batchSize), resultsRef);
+        }
+    );
+    if (batchSize == 1) {
+        apis.emplace_back(
+            "CalcFlatSingle",
+            [&model, &flatFeatures, resultsRef] (size_t docOffset, size_t /*batchSize*/) {
+                model.CalcFlatSingle(flatFeatures[docOffset], resultsRef);
+            }
+        );
+    }
+    apis.emplace_back(
+        "CalcFlatTransposed",
+        [&model, &pool, &params, resultsRef] (size_t docOffset, size_t batchSize) {
+            const size_t featureCount = params.HasCatFeatures ? pool.TransposedFlatFeatures.size() : pool.FloatFeatureCount;
+            TVector<TConstArrayRef<float>> features(Reserve(featureCount));
+            for (auto featureIdx : xrange(featureCount)) {
+                features.push_back(
+                    MakeArrayRef(pool.TransposedFlatFeatures[featureIdx]).subspan(docOffset, batchSize)
+                );
+            }
+            model.CalcFlatTransposed(features, resultsRef);
+        }
+    );
+    if (params.HasCatFeatures) {
+        // the usual API of CTR models: categorical features are hashed during evaluation
+        apis.emplace_back(
+            "Calc",
+            [&model, &pool, resultsRef] (size_t docOffset, size_t batchSize) {
+                model.Calc(
+                    MakeArrayRef(pool.FloatFeatureRefs).subspan(docOffset, batchSize),
+                    MakeArrayRef(pool.CatFeatures).subspan(docOffset, batchSize),
+                    resultsRef
+                );
+            }
+        );
+    }
+    return apis;
+}
+
+int main(int argc, const char* argv[]) {
+    TSweepOptions options;
+    TString batchSizes = "1,128,10000";
+    TString treeCounts = "100,1000";
+    TString depths = "6,8";
+    TString approxDimensions = "1,3";
+    TString featureTypes = "float,cat";
+    TString evaluatorTypes = "CPU";
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddLongOption("batch-sizes", "comma-separated list of docs counts per evaluation call")
+        .RequiredArgument("LIST")
+        .StoreResult(&batchSizes)
+        .DefaultValue(batchSizes);
+    parser.AddLongOption("tree-counts", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&treeCounts)
+        .DefaultValue(treeCounts);
+    parser.AddLongOption("depths", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&depths)
+        .DefaultValue(depths);
+    parser.AddLongOption("approx-dimensions", "comma-separated list")
+        .RequiredArgument("LIST")
+        .StoreResult(&approxDimensions)
+        .DefaultValue(approxDimensions);
+    parser.AddLongOption("feature-types", "comma-separated list of float (float splits only), cat (float and CTR splits)")
+        .RequiredArgument("LIST")
+        .StoreResult(&featureTypes)
+        .DefaultValue(featureTypes);
+    parser.AddLongOption("evaluator-types", "comma-separated list of CPU, GPU")
+        .RequiredArgument("LIST")
+        .StoreResult(&evaluatorTypes)
+        .DefaultValue(evaluatorTypes);
+    parser.AddLongOption("float-features", "float features count")
+        .RequiredArgument("INT")
+        .StoreResult(&options.FloatFeatureCount)
+        .DefaultValue(options.FloatFeatureCount);
+    parser.AddLongOption("borders-per-feature", "borders count of each float feature")
+        .RequiredArgument("INT")
+        .StoreResult(&options.BordersPerFeature)
+        .DefaultValue(options.BordersPerFeature);
+    parser.AddLongOption("cat-features", "categorical features count for cat feature type")
+        .RequiredArgument("INT")
+        .StoreResult(&options.CatFeatureCount)
+        .DefaultValue(options.CatFeatureCount);
+    parser.AddLongOption("cat-feature-cardinality", "unique values count in CTR tables")
+        .RequiredArgument("INT")
+        .StoreResult(&options.CatFeatureCardinality)
+        .DefaultValue(options.CatFeatureCardinality);
+    parser.AddLongOption("samples", "timed evaluation calls for each configuration")
+        .RequiredArgument("INT")
+        .StoreResult(&options.SampleCount)
+        .DefaultValue(options.SampleCount);
+    parser.AddLongOption("seed", "random seed for models and docs")
+        .RequiredArgument("INT")
+        .StoreResult(&options.Seed)
+        .DefaultValue(options.Seed);
+    parser.AddLongOption("output-json", "path to save results")
+        .RequiredArgument("PATH")
+        .StoreResult(&options.OutputJsonPath);
+    parser.SetFreeArgsMax(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    options.BatchSizes = ParseList<size_t>(batchSizes);
+    options.TreeCounts = ParseList<size_t>(treeCounts);
+    options.Depths = ParseList<size_t>(depths);
+    options.ApproxDimensions = ParseList<int>(approxDimensions);
+    options.FeatureTypes = ParseList<TString>(featureTypes);
+    options.EvaluatorTypes = ParseList<EFormulaEvaluatorType>(evaluatorTypes);
+    CB_ENSURE(options.FloatFeatureCount > 0, "Float features count must be positive");
+    CB_ENSURE(options.BordersPerFeature > 0, "Borders per feature must be positive");
+    CB_ENSURE(options.SampleCount > 0, "Samples count must be positive");
+    for (const auto& featureType : options.FeatureTypes) {
+        CB_ENSURE(featureType == "float" || featureType == "cat", "Unknown feature type " << featureType);
+        CB_ENSURE(
+            featureType == "float" || (options.CatFeatureCount && options.CatFeatureCardinality),
+            "Cat feature type needs categorical features"
+        );
+    }
+    for (auto batchSize : options.BatchSizes) {
+        CB_ENSURE(batchSize > 0, "Batch size must be positive");
+    }
+
+    // big enough for consecutive batches to be mostly out of cache
+    const size_t docCount = Max<size_t>(*MaxElement(options.BatchSizes.begin(), options.BatchSizes.end()), 4096);
+    const TDocsPool pool = GenerateDocs(options, docCount);
+
+    NJson::TJsonValue jsonResults(NJson::JSON_ARRAY);
+    Cout << Sprintf(
+        "%-4s %-6s %6s %6s %6s %8s  %-20s %12s %12s\n",
+        "eval", "feats", "trees", "depth", "dim", "batch", "api", "p50 ns/doc", "p99 ns/doc");
+    for (const auto& featureType : options.FeatureTypes) {
+        for (auto treeCount : options.TreeCounts) {
+            for (auto depth : options.Depths) {
+                for (auto approxDimension : options.ApproxDimensions) {
+                    const TModelParams params{treeCount, depth, approxDimension, featureType == "cat"};
+                    const TFullModel model = GenerateModel(options, params);
+                    for (auto evaluatorType : options.EvaluatorTypes) {
+                        TFullModel evaluatedModel = model;
+                        TMaybe<TString> error;
+                        try {
+                            evaluatedModel.SetEvaluatorType(evaluatorType);
+                        } catch (const std::exception& e) {
+                            error = e.what();
+                        }
+                        for (auto batchSize : options.BatchSizes) {
+                            TVector<double> results;
+                            const auto apis = GetEvaluationApis(evaluatedModel, params, batchSize, pool, &results);
+                            for (const auto& [apiName, calcBatch] : apis) {
+                                NJson::TJsonValue jsonResult;
+                                jsonResult["evaluator_type"] = ToString(evaluatorType);
+                                jsonResult["feature_type"] = featureType;
+                                jsonResult["tree_count"] = treeCount;
+                                jsonResult["depth"] = depth;
+                                jsonResult["approx_dimension"] = approxDimension;
+                                jsonResult["batch_size"] = batchSize;
+                                jsonResult["api"] = apiName;
+
+                                TMaybe<TString> apiError = error;
+                                TTimings timings;
+                                if (!apiError) {
+                                    try {
+                                        timings = MeasureNsPerDoc(batchSize, docCount, options.SampleCount, calcBatch);
+                                    } catch (const std::exception& e) {
+                                        apiError = e.what();
+                                    }
+                                }
+                                Cout << Sprintf(
+                                    "%-4s %-6s %6zu %6zu %6d %8zu  %-20s ",
+                                    ToString(evaluatorType).c_str(),
+                                    featureType.c_str(),
+                                    treeCount,
+                                    depth,
+                                    approxDimension,
+                                    batchSize,
+                                    apiName.c_str());
+                                if (apiError) {
+                                    jsonResult["error"] = *apiError;
+                                    Cout << "unsupported: " << *apiError << Endl;
+                                } else {
+                                    jsonResult["p50_ns_per_doc"] = timings.P50;
+                                    jsonResult["p99_ns_per_doc"] = timings.P99;
+                                    Cout << Sprintf("%12.1f %12.1f", timings.P50, timings.P99) << Endl;
+                                }
+                                jsonResults.AppendValue(std::move(jsonResult));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (options.OutputJsonPath) {
+        TOFStream output(options.OutputJsonPath);
+        NJson::WriteJson(&output, &jsonResults, /*formatOutput*/ true);
+    }
+    return 0;
+}
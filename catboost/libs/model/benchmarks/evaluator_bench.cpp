@@ -0,0 +1,130 @@
+#include <catboost/libs/model/cpu/evaluator.h>
+#include <catboost/libs/model/model.h>
+
+#include <library/cpp/testing/benchmark/bench.h>
+
+#include <util/generic/singleton.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NCB::NModelEvaluation;
+
+const size_t FeatureCount = 50;
+const size_t BordersPerFeature = 64;
+const size_t TreeCount = 1000;
+const size_t TreeDepth = 6;
+const size_t DocCount = 10000;
+
+struct TBenchData {
+    TFullModel Model;
+    TVector<TVector<float>> Docs;
+    TVector<TConstArrayRef<float>> DocRefs;
+    TVector<double> Results;
+
+    TBenchData() {
+        TFastRng64 rng(0);
+        TModelTrees* trees = Model.ModelTrees.GetMutable();
+        TVector<TFloatFeature> floatFeatures;
+        for (auto featureIdx : xrange(FeatureCount)) {
+            floatFeatures.emplace_back(false, featureIdx, featureIdx, TVector<float>{});
+        }
+        trees->SetFloatFeatures(floatFeatures);
+        for (auto featureIdx : xrange(FeatureCount)) {
+            for (auto borderIdx : xrange(BordersPerFeature)) {
+                trees->AddFloatFeatureBorder(featureIdx, float(borderIdx + 1) / (BordersPerFeature + 1));
+            }
+        }
+        for (size_t treeIdx = 0; treeIdx < TreeCount; ++treeIdx) {
+            TVector<int> tree;
+            for (size_t depth = 0; depth < TreeDepth; ++depth) {
+                tree.push_back(rng.Uniform(FeatureCount * BordersPerFeature));
+            }
+            trees->AddBinTree(tree);
+            for (size_t leafIdx = 0; leafIdx < (1u << TreeDepth); ++leafIdx) {
+                trees->AddLeafValue(rng.GenRandReal1() - 0.5);
+            }
+        }
+        Model.UpdateDynamicData();
+
+        Docs.resize(DocCount, TVector<float>(FeatureCount));
+        for (auto& doc : Docs) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        DocRefs.assign(Docs.begin(), Docs.end());
+        Results.resize(DocCount);
+    }
+};
+
+static void BenchCalcFlat(
+    ECpuIndexesKernel kernel,
+    size_t docCount,
+    NBench::NCpu::TParams& iface,
+    size_t cacheBudget = DEFAULT_EVALUATION_CACHE_BUDGET
+) {
+    auto& data = *Singleton<TBenchData>();
+    if (!IsCpuIndexesKernelAvailable(kernel)) {
+        return;
+    }
+    auto evaluator = data.Model.GetCurrentEvaluator()->Clone();
+    evaluator->SetProperty("IndexesKernel", ToString(kernel));
+    evaluator->SetProperty("EvaluationCacheBudget", ToString(cacheBudget));
+    const TConstArrayRef<TConstArrayRef<float>> docs(data.DocRefs.data(), docCount);
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        evaluator->CalcFlat(docs, MakeArrayRef(data.Results.data(), docCount));
+        NBench::Clobber();
+    }
+}
+
+// Sse kernel is the 16-lane one: SSE on x86 and NEON on arm64 builds
+Y_CPU_BENCHMARK(CalcFlat128DocsSse, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Sse, 128, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlat128DocsAvx2, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Avx2, 128, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlat128DocsAvx512, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Avx512, 128, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlat10000DocsSse, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Sse, DocCount, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlat10000DocsAvx2, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Avx2, DocCount, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlat10000DocsAvx512, iface) {
+    BenchCalcFlat(ECpuIndexesKernel::Avx512, DocCount, iface);
+}
+
+// leaf values of the model take 512KB, so the default budget evaluates it tree-major
+Y_CPU_BENCHMARK(CalcFlat10000DocsDocumentMajor, iface) {
+    BenchCalcFlat(GetBestCpuIndexesKernel(), DocCount, iface, Max<size_t>());
+}
+
+Y_CPU_BENCHMARK(CalcFlat10000DocsTreeMajor, iface) {
+    BenchCalcFlat(GetBestCpuIndexesKernel(), DocCount, iface);
+}
+
+static void BenchCalcFlatSingle(bool useFastPath, NBench::NCpu::TParams& iface) {
+    auto& data = *Singleton<TBenchData>();
+    auto evaluator = data.Model.GetCurrentEvaluator()->Clone();
+    evaluator->SetProperty("SingleRowFastPath", ToString(useFastPath));
+    for (size_t i = 0; i < iface.Iterations(); ++i) {
+        evaluator->CalcFlatSingle(data.DocRefs[i % DocCount], MakeArrayRef(data.Results.data(), 1));
+        NBench::Clobber();
+    }
+}
+
+Y_CPU_BENCHMARK(CalcFlatSingleGeneric, iface) {
+    BenchCalcFlatSingle(false, iface);
+}
+
+Y_CPU_BENCHMARK(CalcFlatSingleFastPath, iface) {
+    BenchCalcFlatSingle(true, iface);
+}
@@ -0,0 +1,175 @@
+#include "compressed_model.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/cpp/blockcodecs/codecs.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/buffer.h>
+#include <util/generic/cast.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/stream/buffer.h>
+#include <util/stream/file.h>
+#include <util/stream/labeled.h>
+#include <util/stream/mem.h>
+#include <util/system/info.h>
+#include <util/system/unaligned_mem.h>
+#include <util/ysaveload.h>
+
+
+static const char COMPRESSED_MODEL_FILE_DESCRIPTOR_CHARS[4] = {'C', 'B', 'M', 'Z'};
+
+static ui32 GetCompressedModelFormatDescriptor() {
+    return *reinterpret_cast<const ui32*>(COMPRESSED_MODEL_FILE_DESCRIPTOR_CHARS);
+}
+
+namespace {
+    struct TCompressedModelHeader {
+        TString CodecName;
+        ui64 ImageSize = 0;
+        ui64 SectionSize = 0;
+        TVector<ui64> CompressedSectionSizes;
+
+    public:
+        Y_SAVELOAD_DEFINE(CodecName, ImageSize, SectionSize, CompressedSectionSizes);
+    };
+}
+
+// Sections are independent, so each one is processed by its own task
+template <class TSectionFunc>
+static void ProcessSectionsInParallel(size_t sectionCount, TSectionFunc&& sectionFunc) {
+    NPar::TLocalExecutor executor;
+    const size_t threadCount = Min<size_t>(sectionCount, NSystemInfo::CachedNumberOfCpus());
+    if (threadCount > 1) {
+        executor.RunAdditionalThreads(SafeIntegerCast<int>(threadCount - 1));
+    }
+    executor.ExecRangeWithThrow(
+        [&] (int sectionIdx) {
+            sectionFunc(SafeIntegerCast<size_t>(sectionIdx));
+        },
+        0,
+        SafeIntegerCast<int>(sectionCount),
+        NPar::ILocalExecutor::WAIT_COMPLETE
+    );
+}
+
+void OutputCompressedModel(
+    const TFullModel& model,
+    IOutputStream* out,
+    TStringBuf codecName,
+    size_t sectionSize
+) {
+    CB_ENSURE(sectionSize > 0, "Compressed model section size should be positive");
+    const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec(codecName);
+    TBufferOutput imageOutput;
+    OutputModel(model, &imageOutput);
+    const TBuffer& image = imageOutput.Buffer();
+
+    const size_t sectionCount = CeilDiv(image.Size(), sectionSize);
+    TVector<TBuffer> sections(sectionCount);
+    ProcessSectionsInParallel(
+        sectionCount,
+        [&] (size_t sectionIdx) {
+            const size_t sectionStart = sectionIdx * sectionSize;
+            const TStringBuf section(image.Data() + sectionStart, Min(sectionSize, image.Size() - sectionStart));
+            codec->Encode(section, sections[sectionIdx]);
+        }
+    );
+
+    TCompressedModelHeader header;
+    header.CodecName = codec->Name();
+    header.ImageSize = image.Size();
+    header.SectionSize = sectionSize;
+    for (const auto& section : sections) {
+        header.CompressedSectionSizes.push_back(section.Size());
+    }
+    ::Save(out, GetCompressedModelFormatDescriptor());
+    ::Save(out, header);
+    for (const auto& section : sections) {
+        out->Write(section.Data(), section.Size());
+    }
+}
+
+void OutputCompressedModel(
+    const TFullModel& model,
+    TStringBuf modelFile,
+    TStringBuf codecName,
+    size_t sectionSize
+) {
+    TOFStream f(TString{modelFile});
+    OutputCompressedModel(model, &f, codecName, sectionSize);
+}
+
+static TBlob DecompressSections(const TCompressedModelHeader& header, TStringBuf compressedSections) {
+    const NBlockCodecs::ICodec* codec = NBlockCodecs::Codec(header.CodecName);
+    CB_ENSURE(header.SectionSize > 0, "Compressed model has zero section size");
+    const size_t sectionCount = header.CompressedSectionSizes.size();
+    CB_ENSURE(
+        sectionCount == CeilDiv(header.ImageSize, header.SectionSize),
+        "Compressed model section count does not match model size: "
+            << LabeledOutput(sectionCount, header.ImageSize, header.SectionSize)
+    );
+    TVector<size_t> compressedOffsets(sectionCount + 1, 0);
+    for (size_t sectionIdx = 0; sectionIdx < sectionCount; ++sectionIdx) {
+        compressedOffsets[sectionIdx + 1] = compressedOffsets[sectionIdx] + header.CompressedSectionSizes[sectionIdx];
+    }
+    CB_ENSURE(compressedOffsets.back() <= compressedSections.size(), "Compressed model is truncated");
+
+    TBuffer image;
+    image.Resize(header.ImageSize);
+    ProcessSectionsInParallel(
+        sectionCount,
+        [&] (size_t sectionIdx) {
+            const TStringBuf section = compressedSections.substr(
+                compressedOffsets[sectionIdx],
+                header.CompressedSectionSizes[sectionIdx]
+            );
+            const size_t sectionStart = sectionIdx * header.SectionSize;
+            const size_t sectionSize = Min<size_t>(header.SectionSize, header.ImageSize - sectionStart);
+            CB_ENSURE(
+                codec->DecompressedLength(section) == sectionSize,
+                "Compressed model section " << sectionIdx << " has unexpected size"
+            );
+            // straight into the final model memory
+            codec->Decompress(section, image.Data() + sectionStart);
+        }
+    );
+    return TBlob::FromBuffer(image);
+}
+
+namespace NCB {
+    bool IsCompressedModelDescriptor(ui32 fileDescriptor) {
+        return fileDescriptor == GetCompressedModelFormatDescriptor();
+    }
+
+    bool IsCompressedModel(const void* binaryBuffer, size_t binaryBufferSize) {
+        return binaryBufferSize >= sizeof(ui32)
+            && IsCompressedModelDescriptor(ReadUnaligned<ui32>(binaryBuffer));
+    }
+
+    TBlob DecompressModel(IInputStream* in) {
+        TCompressedModelHeader header;
+        ::Load(in, header);
+        size_t compressedSize = 0;
+        for (auto sectionSize : header.CompressedSectionSizes) {
+            compressedSize += sectionSize;
+        }
+        TBuffer compressedSections;
+        compressedSections.Resize(compressedSize);
+        in->LoadOrFail(compressedSections.Data(), compressedSize);
+        return DecompressSections(header, TStringBuf(compressedSections.Data(), compressedSections.Size()));
+    }
+
+    TBlob DecompressModel(TMemoryInput* in) {
+        TCompressedModelHeader header;
+        ::Load(in, header);
+        const TStringBuf compressedSections(in->Buf(), in->Avail());
+        TBlob image = DecompressSections(header, compressedSections);
+        for (auto sectionSize : header.CompressedSectionSizes) {
+            in->Skip(sectionSize);
+        }
+        return image;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "model.h"
+
+#include <util/generic/strbuf.h>
+#include <util/memory/blob.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+
+/**
+ * Compressed container of binary model. Plain model image is split into sections of equal size which are
+ * compressed independently by one of library/cpp/blockcodecs codecs, so they are decompressed in parallel
+ * into one buffer, which becomes the memory of non owning model:
+ *
+ * | "CBMZ" | codec name | image size | section size | section count | compressed sizes | sections |
+ *
+ * ReadModel, TFullModel::Load and InitNonOwning recognize the container by its descriptor.
+ */
+constexpr TStringBuf DEFAULT_MODEL_COMPRESSION_CODEC = "zstd_3";
+constexpr size_t DEFAULT_COMPRESSED_MODEL_SECTION_SIZE = 16 << 20;
+
+void OutputCompressedModel(
+    const TFullModel& model,
+    IOutputStream* out,
+    TStringBuf codecName = DEFAULT_MODEL_COMPRESSION_CODEC,
+    size_t sectionSize = DEFAULT_COMPRESSED_MODEL_SECTION_SIZE);
+
+void OutputCompressedModel(
+    const TFullModel& model,
+    TStringBuf modelFile,
+    TStringBuf codecName = DEFAULT_MODEL_COMPRESSION_CODEC,
+    size_t sectionSize = DEFAULT_COMPRESSED_MODEL_SECTION_SIZE);
+
+namespace NCB {
+    bool IsCompressedModelDescriptor(ui32 fileDescriptor);
+
+    bool IsCompressedModel(const void* binaryBuffer, size_t binaryBufferSize);
+
+    // Decompress container which follows its already read descriptor into plain model image
+    TBlob DecompressModel(IInputStream* in);
+
+    // Same as above, but sections are decompressed from the input buffer without copying them
+    TBlob DecompressModel(TMemoryInput* in);
+}
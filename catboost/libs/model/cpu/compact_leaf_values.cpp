@@ -0,0 +1,58 @@
+#include "compact_leaf_values.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+
+#include <cmath>
+#include <limits>
+
+namespace NCB::NModelEvaluation {
+
+    TAtomicSharedPtr<TCompactLeafValues> BuildCompactLeafValues(
+        const TModelTrees& trees,
+        ELeafValuesPrecision precision
+    ) {
+        CB_ENSURE(trees.IsOblivious(), "Reduced precision leaf values are supported only for oblivious trees");
+        auto result = MakeAtomicShared<TCompactLeafValues>();
+        result->Precision = precision;
+        if (precision == ELeafValuesPrecision::Double) {
+            return result;
+        }
+        const auto leafValues = trees.GetModelTreeData()->GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetApplyData()->TreeFirstLeafOffsets;
+        const size_t treeCount = trees.GetTreeCount();
+        if (precision == ELeafValuesPrecision::Float) {
+            result->FloatValues.yresize(leafValues.size());
+        } else {
+            result->Int16Values.yresize(leafValues.size());
+            result->TreeScales.yresize(treeCount);
+        }
+        for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+            const size_t leafBegin = firstLeafOffsets[treeId];
+            const size_t leafEnd = treeId + 1 < treeCount ? firstLeafOffsets[treeId + 1] : leafValues.size();
+            double treeMaxError = 0.0;
+            if (precision == ELeafValuesPrecision::Float) {
+                for (size_t leafIdx = leafBegin; leafIdx < leafEnd; ++leafIdx) {
+                    result->FloatValues[leafIdx] = leafValues[leafIdx];
+                    treeMaxError = Max(treeMaxError, Abs(leafValues[leafIdx] - result->FloatValues[leafIdx]));
+                }
+            } else {
+                double maxAbsValue = 0.0;
+                for (size_t leafIdx = leafBegin; leafIdx < leafEnd; ++leafIdx) {
+                    maxAbsValue = Max(maxAbsValue, Abs(leafValues[leafIdx]));
+                }
+                const double scale = maxAbsValue / std::numeric_limits<i16>::max();
+                result->TreeScales[treeId] = scale;
+                for (size_t leafIdx = leafBegin; leafIdx < leafEnd; ++leafIdx) {
+                    const i16 quantized = scale > 0.0 ? (i16)std::lround(leafValues[leafIdx] / scale) : 0;
+                    result->Int16Values[leafIdx] = quantized;
+                    treeMaxError = Max(treeMaxError, Abs(leafValues[leafIdx] - scale * quantized));
+                }
+            }
+            result->MaxAbsoluteError += treeMaxError;
+        }
+        return result;
+    }
+}
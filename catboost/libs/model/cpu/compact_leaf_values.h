@@ -0,0 +1,35 @@
+#pragma once
+
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NCB::NModelEvaluation {
+
+    // Storage of leaf values used by CPU evaluator, accumulation is always done in double
+    enum class ELeafValuesPrecision {
+        Double, // model leaf values as is
+        Float,  // float32 copy, per leaf error <= |value| * 2^-24
+        Int16   // per tree scale = max |value| / 32767, per leaf error <= scale / 2
+    };
+
+    /* Apply-time copy of oblivious trees leaf values in reduced precision.
+     * Layout is the same as TModelTrees leaf values: [treeIndex][leafId * ApproxDimension + dimension].
+     */
+    struct TCompactLeafValues {
+        ELeafValuesPrecision Precision = ELeafValuesPrecision::Double;
+        TVector<float> FloatValues;
+        TVector<i16> Int16Values;
+        TVector<double> TreeScales;
+        /* Sum over trees of maximal leaf rounding error: bounds the difference of any raw prediction
+         * (before scale and bias) from the double precision one, up to double rounding of the sum.
+         */
+        double MaxAbsoluteError = 0.0;
+    };
+
+    TAtomicSharedPtr<TCompactLeafValues> BuildCompactLeafValues(
+        const TModelTrees& trees,
+        ELeafValuesPrecision precision);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "compact_leaf_values.h"
+#include "index_kernels.h"
 #include "quantization.h"
 
 #include <util/generic/utility.h>
@@ -33,7 +35,67 @@ namespace NCB::NModelEvaluation {
     TTreeCalcFunction GetCalcTreesFunction(
         const TModelTrees& trees,
         size_t docCountInBlock,
-        bool calcIndexesOnly = false);
+        bool calcIndexesOnly = false,
+        ECpuIndexesKernel indexesKernel = ECpuIndexesKernel::Sse,
+        const TCompactLeafValues* compactLeafValues = nullptr);
+
+    using TCalcTreeSpanFunction = void (*)(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        const TRepackedBin* __restrict spanSplits,
+        const double* __restrict spanLeafValues,
+        int depth,
+        size_t spanTreeCount,
+        int approxDimension,
+        double* __restrict results);
+
+    // Kernel specialized for depth (<= 8) evaluating a span of oblivious trees stored contiguously
+    TCalcTreeSpanFunction GetCalcTreeSpanFunction(int depth, bool isSingleClassModel, bool needXorMask);
+
+    /* Oblivious trees regrouped by depth at load time. Trees of a group keep their relative order,
+     * so any tree range maps to one contiguous span per group.
+     */
+    struct TCompiledTreeSpans {
+        struct TDepthGroup {
+            int Depth = 0;
+            TVector<size_t> TreeIds; // ascending
+            TVector<TRepackedBin> Splits;
+            TVector<double> LeafValues;
+            TCalcTreeSpanFunction CalcFunction = nullptr;
+        };
+
+        TVector<TDepthGroup> Groups;
+    };
+
+    TAtomicSharedPtr<TCompiledTreeSpans> CompileTreeSpans(const TModelTrees& trees);
+
+    // Trees are summed group by group, so results may differ from GetCalcTreesFunction in last bits
+    TTreeCalcFunction GetCalcCompiledTreesFunction(TAtomicSharedPtr<TCompiledTreeSpans> compiledTreeSpans);
+
+    // Default share of per-core L2 cache for leaf values and binarized documents of a tile
+    constexpr size_t DEFAULT_EVALUATION_CACHE_BUDGET = 256 * 1024;
+
+    struct TEvaluationSchedule {
+        // documents binarized at once, evaluated in FORMULA_EVALUATION_BLOCK_SIZE sub-blocks
+        size_t DocBlockSize = FORMULA_EVALUATION_BLOCK_SIZE;
+        // trees applied to all sub-blocks before moving to the next group of trees
+        size_t TreeBlockSize = 0;
+    };
+
+    /* Picks the tree-block x doc-block tiling for evaluation of trees [treeStart, treeEnd).
+     * While leaf values fit in cacheBudget every sub-block goes through all trees (document-major),
+     * otherwise trees are split in groups with cache-resident leaf values and each group is applied
+     * to several binarized sub-blocks before moving on (tree-major).
+     */
+    TEvaluationSchedule GetEvaluationSchedule(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        size_t docCount,
+        size_t treeStart,
+        size_t treeEnd,
+        size_t cacheBudget = DEFAULT_EVALUATION_CACHE_BUDGET,
+        bool allowTreeMajor = true);
 
     template <class X>
     inline X* GetAligned(X* val) {
@@ -129,6 +191,7 @@ namespace NCB::NModelEvaluation {
             estimatedFeaturesNum += embeddingProcessingCollection->TotalNumberOfOutputFeatures();
         }
         TVector<float> estimatedFeatures(estimatedFeaturesNum * blockSize);
+        TTextProcessingCollection::TCalcFeaturesBuffers textProcessingBuffers;
 
         for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
             const auto docCountInBlock = Min(blockSize, docCount - blockStart);
@@ -148,7 +211,8 @@ namespace NCB::NModelEvaluation {
                 transposedHash,
                 ctrs,
                 estimatedFeatures,
-                featureInfo
+                featureInfo,
+                &textProcessingBuffers
             );
             callback(docCountInBlock, &quantizedData);
         }
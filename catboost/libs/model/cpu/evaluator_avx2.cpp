@@ -0,0 +1,134 @@
+#include "index_kernels.h"
+
+#include <util/system/compiler.h>
+#include <util/system/platform.h>
+#include <util/system/yassert.h>
+
+#include <cstring>
+
+#if defined(_avx2_)
+
+#include <immintrin.h>
+
+namespace NCB::NModelEvaluation {
+
+    constexpr size_t AVX2_BLOCK_SIZE = 32;
+
+    template <bool NeedXorMask>
+    Y_FORCE_INLINE __m256i UpdateIndexesAvx2(
+        __m256i indexes,
+        const ui8* __restrict binFeaturePtr,
+        __m256i borderValVec,
+        __m256i xorMaskVec,
+        __m256i mask) {
+        __m256i val = _mm256_loadu_si256((const __m256i*)binFeaturePtr);
+        if (NeedXorMask) {
+            val = _mm256_xor_si256(val, xorMaskVec);
+        }
+        // unsigned (val >= border) <=> max(val, border) == val
+        const __m256i isGreaterOrEqual = _mm256_cmpeq_epi8(_mm256_max_epu8(val, borderValVec), val);
+        return _mm256_or_si256(indexes, _mm256_and_si256(isGreaterOrEqual, mask));
+    }
+
+    template <bool NeedXorMask, int curTreeSize>
+    Y_FORCE_INLINE void CalcIndexesAvx2Depthed(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr) {
+        size_t docId = 0;
+        for (; docId + 2 * AVX2_BLOCK_SIZE <= docCountInBlock; docId += 2 * AVX2_BLOCK_SIZE) {
+            __m256i v0 = _mm256_setzero_si256();
+            __m256i v1 = _mm256_setzero_si256();
+            __m256i mask = _mm256_set1_epi8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+                const __m256i borderValVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+                const __m256i xorMaskVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+                v0 = UpdateIndexesAvx2<NeedXorMask>(v0, binFeaturePtr, borderValVec, xorMaskVec, mask);
+                v1 = UpdateIndexesAvx2<NeedXorMask>(v1, binFeaturePtr + AVX2_BLOCK_SIZE, borderValVec, xorMaskVec, mask);
+                mask = _mm256_slli_epi16(mask, 1);
+            }
+            _mm256_storeu_si256((__m256i*)(indexesVec + docId), v0);
+            _mm256_storeu_si256((__m256i*)(indexesVec + docId + AVX2_BLOCK_SIZE), v1);
+        }
+        if (docId + AVX2_BLOCK_SIZE <= docCountInBlock) {
+            __m256i v0 = _mm256_setzero_si256();
+            __m256i mask = _mm256_set1_epi8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+                const __m256i borderValVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+                const __m256i xorMaskVec = _mm256_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+                v0 = UpdateIndexesAvx2<NeedXorMask>(v0, binFeaturePtr, borderValVec, xorMaskVec, mask);
+                mask = _mm256_slli_epi16(mask, 1);
+            }
+            _mm256_storeu_si256((__m256i*)(indexesVec + docId), v0);
+            docId += AVX2_BLOCK_SIZE;
+        }
+        for (; docId < docCountInBlock; ++docId) {
+            ui8 index = 0;
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                ui8 featureValue = binFeatures[treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId];
+                if (NeedXorMask) {
+                    featureValue ^= treeSplitsCurPtr[depth].XorMask;
+                }
+                index |= (featureValue >= treeSplitsCurPtr[depth].SplitIdx) << depth;
+            }
+            indexesVec[docId] = index;
+        }
+    }
+
+    template <bool NeedXorMask>
+    static void CalcIndexesAvx2(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        int curTreeSize) {
+        switch (curTreeSize) {
+        case 0:
+            memset(indexesVec, 0, docCountInBlock);
+            break;
+        case 1:
+            CalcIndexesAvx2Depthed<NeedXorMask, 1>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 2:
+            CalcIndexesAvx2Depthed<NeedXorMask, 2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 3:
+            CalcIndexesAvx2Depthed<NeedXorMask, 3>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 4:
+            CalcIndexesAvx2Depthed<NeedXorMask, 4>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 5:
+            CalcIndexesAvx2Depthed<NeedXorMask, 5>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 6:
+            CalcIndexesAvx2Depthed<NeedXorMask, 6>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 7:
+            CalcIndexesAvx2Depthed<NeedXorMask, 7>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 8:
+            CalcIndexesAvx2Depthed<NeedXorMask, 8>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        default:
+            Y_UNREACHABLE();
+        }
+    }
+
+    TCalcIndexesKernel GetAvx2IndexesKernel(bool needXorMask) {
+        return needXorMask ? &CalcIndexesAvx2<true> : &CalcIndexesAvx2<false>;
+    }
+}
+
+#else
+
+namespace NCB::NModelEvaluation {
+    TCalcIndexesKernel GetAvx2IndexesKernel(bool) {
+        return nullptr;
+    }
+}
+
+#endif
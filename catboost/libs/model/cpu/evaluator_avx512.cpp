@@ -0,0 +1,130 @@
+#include "index_kernels.h"
+
+#include <util/generic/utility.h>
+#include <util/system/compiler.h>
+#include <util/system/platform.h>
+#include <util/system/yassert.h>
+
+#include <cstring>
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+#include <immintrin.h>
+
+namespace NCB::NModelEvaluation {
+
+    constexpr size_t AVX512_BLOCK_SIZE = 64;
+
+    template <bool NeedXorMask>
+    Y_FORCE_INLINE __m512i UpdateIndexesAvx512(
+        __m512i indexes,
+        const ui8* __restrict binFeaturePtr,
+        __m512i borderValVec,
+        __m512i xorMaskVec,
+        __m512i mask) {
+        __m512i val = _mm512_loadu_si512((const void*)binFeaturePtr);
+        if (NeedXorMask) {
+            val = _mm512_xor_si512(val, xorMaskVec);
+        }
+        const __mmask64 isGreaterOrEqual = _mm512_cmpge_epu8_mask(val, borderValVec);
+        return _mm512_or_si512(indexes, _mm512_maskz_mov_epi8(isGreaterOrEqual, mask));
+    }
+
+    template <bool NeedXorMask, int curTreeSize>
+    Y_FORCE_INLINE void CalcIndexesAvx512Depthed(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr) {
+        size_t docId = 0;
+        for (; docId + 2 * AVX512_BLOCK_SIZE <= docCountInBlock; docId += 2 * AVX512_BLOCK_SIZE) {
+            __m512i v0 = _mm512_setzero_si512();
+            __m512i v1 = _mm512_setzero_si512();
+            __m512i mask = _mm512_set1_epi8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+                const __m512i borderValVec = _mm512_set1_epi8(treeSplitsCurPtr[depth].SplitIdx);
+                const __m512i xorMaskVec = _mm512_set1_epi8(treeSplitsCurPtr[depth].XorMask);
+                v0 = UpdateIndexesAvx512<NeedXorMask>(v0, binFeaturePtr, borderValVec, xorMaskVec, mask);
+                v1 = UpdateIndexesAvx512<NeedXorMask>(v1, binFeaturePtr + AVX512_BLOCK_SIZE, borderValVec, xorMaskVec, mask);
+                mask = _mm512_slli_epi16(mask, 1);
+            }
+            _mm512_storeu_si512((void*)(indexesVec + docId), v0);
+            _mm512_storeu_si512((void*)(indexesVec + docId + AVX512_BLOCK_SIZE), v1);
+        }
+        // tail is handled with masked loads and stores, so no scalar loop is needed
+        for (; docId < docCountInBlock; docId += AVX512_BLOCK_SIZE) {
+            const size_t subBlockSize = Min<size_t>(AVX512_BLOCK_SIZE, docCountInBlock - docId);
+            const __mmask64 docMask = subBlockSize == AVX512_BLOCK_SIZE
+                ? ~__mmask64(0)
+                : ((__mmask64(1) << subBlockSize) - 1);
+            __m512i v0 = _mm512_setzero_si512();
+            __m512i mask = _mm512_set1_epi8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8* __restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + docId;
+                __m512i val = _mm512_maskz_loadu_epi8(docMask, (const void*)binFeaturePtr);
+                if (NeedXorMask) {
+                    val = _mm512_xor_si512(val, _mm512_set1_epi8(treeSplitsCurPtr[depth].XorMask));
+                }
+                const __mmask64 isGreaterOrEqual = _mm512_cmpge_epu8_mask(val, _mm512_set1_epi8(treeSplitsCurPtr[depth].SplitIdx));
+                v0 = _mm512_or_si512(v0, _mm512_maskz_mov_epi8(isGreaterOrEqual, mask));
+                mask = _mm512_slli_epi16(mask, 1);
+            }
+            _mm512_mask_storeu_epi8((void*)(indexesVec + docId), docMask, v0);
+        }
+    }
+
+    template <bool NeedXorMask>
+    static void CalcIndexesAvx512(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        int curTreeSize) {
+        switch (curTreeSize) {
+        case 0:
+            memset(indexesVec, 0, docCountInBlock);
+            break;
+        case 1:
+            CalcIndexesAvx512Depthed<NeedXorMask, 1>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 2:
+            CalcIndexesAvx512Depthed<NeedXorMask, 2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 3:
+            CalcIndexesAvx512Depthed<NeedXorMask, 3>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 4:
+            CalcIndexesAvx512Depthed<NeedXorMask, 4>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 5:
+            CalcIndexesAvx512Depthed<NeedXorMask, 5>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 6:
+            CalcIndexesAvx512Depthed<NeedXorMask, 6>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 7:
+            CalcIndexesAvx512Depthed<NeedXorMask, 7>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 8:
+            CalcIndexesAvx512Depthed<NeedXorMask, 8>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        default:
+            Y_UNREACHABLE();
+        }
+    }
+
+    TCalcIndexesKernel GetAvx512IndexesKernel(bool needXorMask) {
+        return needXorMask ? &CalcIndexesAvx512<true> : &CalcIndexesAvx512<false>;
+    }
+}
+
+#else
+
+namespace NCB::NModelEvaluation {
+    TCalcIndexesKernel GetAvx512IndexesKernel(bool) {
+        return nullptr;
+    }
+}
+
+#endif
@@ -1,17 +1,27 @@
 #include "evaluator.h"
+#include "index_kernels.h"
 
 #include <library/cpp/sse/sse.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/map.h>
+#include <util/generic/ymath.h>
 #include <util/stream/format.h>
 #include <util/system/compiler.h>
+#include <util/system/cpu_id.h>
 
 #include <cstring>
 
+#if defined(_arm64_)
+#include <arm_neon.h>
+#endif
+
 namespace NCB::NModelEvaluation {
 
     constexpr size_t SSE_BLOCK_SIZE = 16;
     static_assert(SSE_BLOCK_SIZE * 8 == FORMULA_EVALUATION_BLOCK_SIZE);
+    // limits binarized data held at once by tree-major evaluation
+    constexpr size_t MAX_TREE_MAJOR_DOC_BLOCK_SIZE = 64 * FORMULA_EVALUATION_BLOCK_SIZE;
 
     template <bool NeedXorMask, size_t START_BLOCK, typename TIndexType>
     Y_FORCE_INLINE void CalcIndexesBasic(
@@ -149,6 +159,88 @@ namespace NCB::NModelEvaluation {
         }
     }
 
+    #elif defined(_arm64_)
+
+    template <bool NeedXorMask, size_t NeonBlockCount, int curTreeSize>
+    Y_FORCE_INLINE void CalcIndexesNeonDepthed(
+            const ui8* __restrict binFeatures,
+            size_t docCountInBlock,
+            ui8* __restrict indexesVec,
+            const TRepackedBin* __restrict treeSplitsCurPtr) {
+        if (NeonBlockCount == 0) {
+            CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+            return;
+        }
+        for (size_t regId = 0; regId < NeonBlockCount; regId += 2) {
+            uint8x16_t v0 = vdupq_n_u8(0);
+            uint8x16_t v1 = vdupq_n_u8(0);
+            uint8x16_t mask = vdupq_n_u8(0x01);
+            for (int depth = 0; depth < curTreeSize; ++depth) {
+                const ui8 *__restrict binFeaturePtr = binFeatures + treeSplitsCurPtr[depth].FeatureIndex * docCountInBlock + SSE_BLOCK_SIZE * regId;
+                const uint8x16_t borderValVec = vdupq_n_u8(treeSplitsCurPtr[depth].SplitIdx);
+                const uint8x16_t xorMaskVec = vdupq_n_u8(treeSplitsCurPtr[depth].XorMask);
+                uint8x16_t val0 = vld1q_u8(binFeaturePtr);
+                if (NeedXorMask) {
+                    val0 = veorq_u8(val0, xorMaskVec);
+                }
+                v0 = vorrq_u8(v0, vandq_u8(vcgeq_u8(val0, borderValVec), mask));
+                if (regId + 1 < NeonBlockCount) {
+                    uint8x16_t val1 = vld1q_u8(binFeaturePtr + SSE_BLOCK_SIZE);
+                    if (NeedXorMask) {
+                        val1 = veorq_u8(val1, xorMaskVec);
+                    }
+                    v1 = vorrq_u8(v1, vandq_u8(vcgeq_u8(val1, borderValVec), mask));
+                }
+                mask = vshlq_n_u8(mask, 1);
+            }
+            vst1q_u8(indexesVec + SSE_BLOCK_SIZE * regId, v0);
+            if (regId + 1 < NeonBlockCount) {
+                vst1q_u8(indexesVec + SSE_BLOCK_SIZE * regId + SSE_BLOCK_SIZE, v1);
+            }
+        }
+        if (NeonBlockCount != 8) {
+            CalcIndexesBasic<NeedXorMask, NeonBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        }
+    }
+
+    template <bool NeedXorMask, size_t NeonBlockCount>
+    static void CalcIndexesNeon(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        const int curTreeSize) {
+        switch (curTreeSize)
+        {
+        case 1:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 1>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 2:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 2>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 3:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 3>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 4:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 4>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 5:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 5>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 6:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 6>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 7:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 7>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        case 8:
+            CalcIndexesNeonDepthed<NeedXorMask, NeonBlockCount, 8>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr);
+            break;
+        default:
+            break;
+        }
+    }
+
     #endif
 
     template <typename TIndexType>
@@ -171,7 +263,7 @@ namespace NCB::NModelEvaluation {
         }
     }
 
-    #ifdef _sse3_
+    #if defined(_sse3_)
     template <int SSEBlockCount>
     Y_FORCE_INLINE static void GatherAddLeafSSE(const double* __restrict treeLeafPtr, const ui8* __restrict indexesPtr, __m128d* __restrict writePtr) {
         _mm_prefetch((const char*)(treeLeafPtr + 64), _MM_HINT_T2);
@@ -203,7 +295,41 @@ namespace NCB::NModelEvaluation {
     #undef GATHER_LEAFS
     #undef ADD_LEAFS
     }
+    #elif defined(_arm64_)
+    template <int NeonBlockCount>
+    Y_FORCE_INLINE static void GatherAddLeafNeon(const double* __restrict treeLeafPtr, const ui8* __restrict indexesPtr, double* __restrict writePtr) {
+        __builtin_prefetch(treeLeafPtr + 64, 0, 1);
+
+        for (size_t blockId = 0; blockId < NeonBlockCount; ++blockId) {
+    #define GATHER_LEAFS(subBlock) const float64x2_t additions##subBlock = vcombine_f64(vld1_f64(treeLeafPtr + indexesPtr[subBlock * 2 + 0]), vld1_f64(treeLeafPtr + indexesPtr[subBlock * 2 + 1]));
+    #define ADD_LEAFS(subBlock) vst1q_f64(writePtr + subBlock * 2, vaddq_f64(vld1q_f64(writePtr + subBlock * 2), additions##subBlock));
+
+            GATHER_LEAFS(0);
+            GATHER_LEAFS(1);
+            GATHER_LEAFS(2);
+            GATHER_LEAFS(3);
+            ADD_LEAFS(0);
+            ADD_LEAFS(1);
+            ADD_LEAFS(2);
+            ADD_LEAFS(3);
+
+            GATHER_LEAFS(4);
+            GATHER_LEAFS(5);
+            GATHER_LEAFS(6);
+            GATHER_LEAFS(7);
+            ADD_LEAFS(4);
+            ADD_LEAFS(5);
+            ADD_LEAFS(6);
+            ADD_LEAFS(7);
+            writePtr += 16;
+            indexesPtr += 16;
+        }
+    #undef GATHER_LEAFS
+    #undef ADD_LEAFS
+    }
+    #endif
 
+    #if defined(_sse3_) || defined(_arm64_)
     template <int SSEBlockCount>
     Y_FORCE_INLINE void CalculateLeafValues4(
         const size_t docCountInBlock,
@@ -219,11 +345,19 @@ namespace NCB::NModelEvaluation {
     {
         const auto docCountInBlock16 = SSEBlockCount * 16;
         if (SSEBlockCount > 0) {
+    #if defined(_sse3_)
             _mm_prefetch((const char*)(writePtr), _MM_HINT_T2);
             GatherAddLeafSSE<SSEBlockCount>(treeLeafPtr0, indexesPtr0, (__m128d*)writePtr);
             GatherAddLeafSSE<SSEBlockCount>(treeLeafPtr1, indexesPtr1, (__m128d*)writePtr);
             GatherAddLeafSSE<SSEBlockCount>(treeLeafPtr2, indexesPtr2, (__m128d*)writePtr);
             GatherAddLeafSSE<SSEBlockCount>(treeLeafPtr3, indexesPtr3, (__m128d*)writePtr);
+    #else
+            __builtin_prefetch(writePtr, 1, 1);
+            GatherAddLeafNeon<SSEBlockCount>(treeLeafPtr0, indexesPtr0, writePtr);
+            GatherAddLeafNeon<SSEBlockCount>(treeLeafPtr1, indexesPtr1, writePtr);
+            GatherAddLeafNeon<SSEBlockCount>(treeLeafPtr2, indexesPtr2, writePtr);
+            GatherAddLeafNeon<SSEBlockCount>(treeLeafPtr3, indexesPtr3, writePtr);
+    #endif
         }
         if (SSEBlockCount != 8) {
             indexesPtr0 += SSE_BLOCK_SIZE * SSEBlockCount;
@@ -263,14 +397,27 @@ namespace NCB::NModelEvaluation {
         TCalcerIndexType* __restrict indexesVecUI32,
         size_t treeStart,
         const size_t treeEnd,
-        double* __restrict resultsPtr) {
+        double* __restrict resultsPtr,
+        TCalcIndexesKernel indexesKernel) {
         const TRepackedBin* treeSplitsCurPtr =
             trees.GetRepackedBins().data() + trees.GetModelTreeData()->GetTreeStartOffsets()[treeStart];
 
         ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
         const auto treeLeafPtr = trees.GetModelTreeData()->GetLeafValues().data();
         auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
-    #ifdef _sse3_
+    #if defined(_sse3_) || defined(_arm64_)
+        // wide kernels (if any) replace the 16-lane one for trees of depth <= 8
+        const auto calcIndexes = [=] (ui8* __restrict treeIndexesVec, const TRepackedBin* __restrict treeSplits, int curTreeSize) {
+            if (indexesKernel) {
+                indexesKernel(binFeatures, docCountInBlock, treeIndexesVec, treeSplits, curTreeSize);
+            } else {
+        #if defined(_sse3_)
+                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, treeIndexesVec, treeSplits, curTreeSize);
+        #else
+                CalcIndexesNeon<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, treeIndexesVec, treeSplits, curTreeSize);
+        #endif
+            }
+        };
         bool allTreesAreShallow = AllOf(
             trees.GetModelTreeData()->GetTreeSizes().begin() + treeStart,
             trees.GetModelTreeData()->GetTreeSizes().begin() + treeEnd,
@@ -280,29 +427,25 @@ namespace NCB::NModelEvaluation {
             auto alignedResultsPtr = resultsPtr;
             TVector<double> resultsTmpArray;
             const size_t neededMemory = docCountInBlock * trees.GetDimensionsCount() * sizeof(double);
-            if ((uintptr_t)alignedResultsPtr % sizeof(__m128d) != 0) {
+            if ((uintptr_t)alignedResultsPtr % (2 * sizeof(double)) != 0) {
                 if (neededMemory < 2048) {
                     alignedResultsPtr = GetAligned((double*)alloca(neededMemory + 0x20));
                 } else {
                     resultsTmpArray.yresize(docCountInBlock * trees.GetDimensionsCount());
                     alignedResultsPtr = resultsTmpArray.data();
                 }
-                memset(alignedResultsPtr, 0, neededMemory);
+                memcpy(alignedResultsPtr, resultsPtr, neededMemory);
             }
             auto treeEnd4 = treeStart + (((treeEnd - treeStart) | 0x3) ^ 0x3);
             for (size_t treeId = treeStart; treeId < treeEnd4; treeId += 4) {
                 memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0,
-                                                           treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId]);
+                calcIndexes(indexesVec + docCountInBlock * 0, treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId]);
                 treeSplitsCurPtr += trees.GetModelTreeData()->GetTreeSizes()[treeId];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1,
-                                                           treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 1]);
+                calcIndexes(indexesVec + docCountInBlock * 1, treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 1]);
                 treeSplitsCurPtr += trees.GetModelTreeData()->GetTreeSizes()[treeId + 1];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2,
-                                                           treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 2]);
+                calcIndexes(indexesVec + docCountInBlock * 2, treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 2]);
                 treeSplitsCurPtr += trees.GetModelTreeData()->GetTreeSizes()[treeId + 2];
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3,
-                                                           treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 3]);
+                calcIndexes(indexesVec + docCountInBlock * 3, treeSplitsCurPtr, trees.GetModelTreeData()->GetTreeSizes()[treeId + 3]);
                 treeSplitsCurPtr += trees.GetModelTreeData()->GetTreeSizes()[treeId + 3];
 
                 CalculateLeafValues4<SSEBlockCount>(
@@ -323,14 +466,15 @@ namespace NCB::NModelEvaluation {
             }
             treeStart = treeEnd4;
         }
+#else
+        Y_UNUSED(indexesKernel);
 #endif
         for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
             auto curTreeSize = trees.GetModelTreeData()->GetTreeSizes()[treeId];
             memset(indexesVec, 0, sizeof(ui32) * docCountInBlock);
-#ifdef _sse3_
+#if defined(_sse3_) || defined(_arm64_)
             if (!CalcLeafIndexesOnly && curTreeSize <= 8) {
-                CalcIndexesSse<NeedXorMask, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr,
-                                                           curTreeSize);
+                calcIndexes(indexesVec, treeSplitsCurPtr, curTreeSize);
                 if (IsSingleClassModel) { // single class model
                     CalculateLeafValues(docCountInBlock, treeLeafPtr + firstLeafOffsetsPtr[treeId], indexesVec, resultsPtr);
                 } else { // multiclass model
@@ -361,7 +505,7 @@ namespace NCB::NModelEvaluation {
     }
 
     template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
-    Y_FORCE_INLINE void CalcTreesBlocked(
+    Y_FORCE_INLINE void CalcTreesBlockedWithKernel(
         const TModelTrees& trees,
         const TModelTrees::TForApplyData& applyData,
         const TCPUEvaluatorQuantizedData* quantizedData,
@@ -369,50 +513,130 @@ namespace NCB::NModelEvaluation {
         TCalcerIndexType* __restrict indexesVec,
         size_t treeStart,
         size_t treeEnd,
-        double* __restrict resultsPtr) {
+        double* __restrict resultsPtr,
+        TCalcIndexesKernel indexesKernel) {
         const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
         switch (docCountInBlock / SSE_BLOCK_SIZE) {
             case 0:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 0, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 1:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 1, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 2:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 2, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 3:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 3, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 4:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 4, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 5:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 5, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 6:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 6, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 7:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 7, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             case 8:
                 CalcTreesBlockedImpl<IsSingleClassModel, NeedXorMask, 8, CalcLeafIndexesOnly>(
-                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr);
+                    trees, applyData, binFeatures, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, indexesKernel);
                 break;
             default:
                 CB_ENSURE(false, "Unexpected number of SSE blocks");
         }
     }
 
+    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
+    inline void CalcTreesBlocked(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr) {
+        CalcTreesBlockedWithKernel<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>(
+            trees, applyData, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, resultsPtr, nullptr);
+    }
+
+    template <typename TLeafValue, typename TIndexType>
+    Y_FORCE_INLINE void GatherAddCompactLeafValues(
+        const size_t docCountInBlock,
+        const TLeafValue* __restrict treeLeafPtr,
+        const double treeScale,
+        const TIndexType* __restrict indexesPtr,
+        const int approxDimension,
+        double* __restrict writePtr) {
+        if (approxDimension == 1) {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                writePtr[docId] += treeScale * treeLeafPtr[indexesPtr[docId]];
+            }
+        } else {
+            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
+                const TLeafValue* __restrict leafPtr = treeLeafPtr + indexesPtr[docId] * approxDimension;
+                for (int classId = 0; classId < approxDimension; ++classId) {
+                    writePtr[classId] += treeScale * leafPtr[classId];
+                }
+                writePtr += approxDimension;
+            }
+        }
+    }
+
+    // float32 or int16 leaf values gathered and accumulated in double, treeScales is nullptr for float32
+    template <bool NeedXorMask, typename TLeafValue>
+    inline void CalcTreesCompactLeaves(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        const TCPUEvaluatorQuantizedData* quantizedData,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        size_t treeStart,
+        size_t treeEnd,
+        double* __restrict resultsPtr,
+        const TLeafValue* __restrict leafValues,
+        const double* __restrict treeScales,
+        TCalcIndexesKernel indexesKernel) {
+        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        TCalcerIndexType singleDocIndex;
+        if (indexesVec == nullptr) {
+            Y_ASSERT(docCountInBlock == 1);
+            indexesVec = &singleDocIndex;
+        }
+        const TRepackedBin* treeSplitsCurPtr =
+            trees.GetRepackedBins().data() + trees.GetModelTreeData()->GetTreeStartOffsets()[treeStart];
+        const auto treeSizes = trees.GetModelTreeData()->GetTreeSizes();
+        const auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
+        const int approxDimension = trees.GetDimensionsCount();
+        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+            const int curTreeSize = treeSizes[treeId];
+            const TLeafValue* treeLeafPtr = leafValues + firstLeafOffsetsPtr[treeId];
+            const double treeScale = treeScales ? treeScales[treeId] : 1.0;
+            if (indexesKernel && curTreeSize <= 8) {
+                ui8* __restrict indexesVecUI8 = (ui8*)indexesVec;
+                indexesKernel(binFeatures, docCountInBlock, indexesVecUI8, treeSplitsCurPtr, curTreeSize);
+                GatherAddCompactLeafValues(docCountInBlock, treeLeafPtr, treeScale, indexesVecUI8, approxDimension, resultsPtr);
+            } else {
+                memset(indexesVec, 0, sizeof(TCalcerIndexType) * docCountInBlock);
+                CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+                GatherAddCompactLeafValues(docCountInBlock, treeLeafPtr, treeScale, indexesVec, approxDimension, resultsPtr);
+            }
+            treeSplitsCurPtr += curTreeSize;
+        }
+    }
+
     template <bool IsSingleClassModel, bool NeedXorMask, bool calcIndexesOnly = false>
     inline void CalcTreesSingleDocImpl(
         const TModelTrees& trees,
@@ -459,206 +683,60 @@ namespace NCB::NModelEvaluation {
         }
     }
 
+    constexpr size_t NON_SYMMETRIC_LOCKSTEP_DOC_COUNT = 8;
+
+    // Walks one document from slot down to a terminal node and returns its leaf value offset
     template <bool NeedXorMask>
-    Y_FORCE_INLINE void CalcIndexesNonSymmetric(
-        const TModelTrees& trees,
+    Y_FORCE_INLINE ui32 CalcPackedNonSymmetricLeafOffset(
+        const TPackedNonSymmetricNode* __restrict nodes,
+        ui32 slot,
         const ui8* __restrict binFeatures,
-        const size_t firstDocId,
-        const size_t docCountInBlock,
-        const size_t treeId,
-        TCalcerIndexType* __restrict indexesVec
+        size_t docCountInBlock
     ) {
-        const TRepackedBin* treeSplitsPtr = trees.GetRepackedBins().data();
-        const TNonSymmetricTreeStepNode* treeStepNodes = trees.GetModelTreeData()->GetNonSymmetricStepNodes().data();
-        std::fill(indexesVec + firstDocId, indexesVec + docCountInBlock, trees.GetModelTreeData()->GetTreeStartOffsets()[treeId]);
-        if (binFeatures == nullptr) {
-            return;
-        }
-        size_t countStopped = 0;
-        while (countStopped != docCountInBlock - firstDocId) {
-            countStopped = 0;
-            for (size_t docId = firstDocId; docId < docCountInBlock; ++docId) {
-                const auto* stepNode = treeStepNodes + indexesVec[docId];
-                const TRepackedBin split = treeSplitsPtr[indexesVec[docId]];
-                ui8 featureValue = binFeatures[split.FeatureIndex * docCountInBlock + docId];
-                if constexpr (NeedXorMask) {
-                    featureValue ^= split.XorMask;
-                }
-                const auto diff = (featureValue >= split.SplitIdx) ? stepNode->RightSubtreeDiff
-                                                                   : stepNode->LeftSubtreeDiff;
-                countStopped += (diff == 0);
-                indexesVec[docId] += diff;
+        while (!(nodes[slot].Next & TPackedNonSymmetricNode::TerminalFlag)) {
+            const auto& node = nodes[slot];
+            ui8 featureValue = binFeatures[node.Split.FeatureIndex * docCountInBlock];
+            if constexpr (NeedXorMask) {
+                featureValue ^= node.Split.XorMask;
             }
+            slot = node.Next + (featureValue >= node.Split.SplitIdx);
         }
+        return nodes[slot].Next & ~TPackedNonSymmetricNode::TerminalFlag;
     }
-#if defined(_sse4_1_)
-    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
-    inline void CalcNonSymmetricTrees(
-        const TModelTrees& trees,
-        const TModelTrees::TForApplyData& applyData,
-        const TCPUEvaluatorQuantizedData* quantizedData,
+
+    /* Documents of a group advance through the tree in lockstep, one level per iteration, so loads for
+     * different documents are independent and overlap. Finished documents keep pointing to their terminal node.
+     */
+    template <bool NeedXorMask>
+    Y_FORCE_INLINE void CalcPackedNonSymmetricLeafOffsets(
+        const TPackedNonSymmetricNode* __restrict nodes,
+        ui32 rootSlot,
+        const ui8* __restrict binFeatures,
         size_t docCountInBlock,
-        TCalcerIndexType* __restrict indexes,
-        size_t treeStart,
-        size_t treeEnd,
-        double* __restrict resultsPtr
+        ui32* __restrict leafOffsets
     ) {
-        const ui8* __restrict binFeaturesI = quantizedData->QuantizedData.data();
-        const TRepackedBin* treeSplitsPtr = trees.GetRepackedBins().data();
-        const i32* treeStepNodes = reinterpret_cast<const i32*>(trees.GetModelTreeData()->GetNonSymmetricStepNodes().data());
-        const ui32* __restrict nonSymmetricNodeIdToLeafIdPtr = trees.GetModelTreeData()->GetNonSymmetricNodeIdToLeafId().data();
-        const double* __restrict leafValuesPtr = trees.GetModelTreeData()->GetLeafValues().data();
-        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
-            const ui32 treeStartIndex = trees.GetModelTreeData()->GetTreeStartOffsets()[treeId];
-            __m128i* indexesVec = reinterpret_cast<__m128i*>(indexes);
-            size_t docId = 0;
-            // handle special case of model containing only empty splits
-            for (; binFeaturesI != nullptr && docId + 8 <= docCountInBlock; docId += 8, indexesVec+=2) {
-                const ui8* __restrict binFeatures = binFeaturesI + docId;
-                __m128i index0 = _mm_set1_epi32(treeStartIndex);
-                __m128i index1 = _mm_set1_epi32(treeStartIndex);
-                __m128i diffs0, diffs1;
-                do {
-                    const TRepackedBin splits[8] = {
-                        treeSplitsPtr[_mm_extract_epi32(index0, 0)],
-                        treeSplitsPtr[_mm_extract_epi32(index0, 1)],
-                        treeSplitsPtr[_mm_extract_epi32(index0, 2)],
-                        treeSplitsPtr[_mm_extract_epi32(index0, 3)],
-                        treeSplitsPtr[_mm_extract_epi32(index1, 0)],
-                        treeSplitsPtr[_mm_extract_epi32(index1, 1)],
-                        treeSplitsPtr[_mm_extract_epi32(index1, 2)],
-                        treeSplitsPtr[_mm_extract_epi32(index1, 3)]
-                    };
-                    const __m128i zeroes = _mm_setzero_si128();
-                    diffs0 = _mm_unpacklo_epi16(
-                        _mm_hadd_epi16(
-                            _mm_and_si128(
-                                _mm_xor_si128(
-                                    _mm_cmplt_epi32(
-                                        _mm_xor_si128(
-                                            _mm_setr_epi32(
-                                                binFeatures[splits[0].FeatureIndex * docCountInBlock + 0],
-                                                binFeatures[splits[1].FeatureIndex * docCountInBlock + 1],
-                                                binFeatures[splits[2].FeatureIndex * docCountInBlock + 2],
-                                                binFeatures[splits[3].FeatureIndex * docCountInBlock + 3]
-                                            ),
-                                            _mm_setr_epi32(
-                                                splits[0].XorMask,
-                                                splits[1].XorMask,
-                                                splits[2].XorMask,
-                                                splits[3].XorMask
-                                            )
-                                        ),
-                                        _mm_setr_epi32(
-                                            splits[0].SplitIdx,
-                                            splits[1].SplitIdx,
-                                            splits[2].SplitIdx,
-                                            splits[3].SplitIdx
-                                        )
-                                   ),
-                                   _mm_set1_epi32(0xffff0000)
-                               ),
-                                _mm_setr_epi32(
-                                    treeStepNodes[_mm_extract_epi32(index0, 0)],
-                                    treeStepNodes[_mm_extract_epi32(index0, 1)],
-                                    treeStepNodes[_mm_extract_epi32(index0, 2)],
-                                    treeStepNodes[_mm_extract_epi32(index0, 3)]
-                                )
-                            ),
-                            zeroes
-                        ),
-                        zeroes
-                    );
-                    diffs1 = _mm_unpacklo_epi16(
-                        _mm_hadd_epi16(
-                            _mm_and_si128(
-                                _mm_xor_si128(
-                                    _mm_cmplt_epi32(
-                                        _mm_xor_si128(
-                                            _mm_setr_epi32(
-                                                binFeatures[splits[4].FeatureIndex * docCountInBlock + 4],
-                                                binFeatures[splits[5].FeatureIndex * docCountInBlock + 5],
-                                                binFeatures[splits[6].FeatureIndex * docCountInBlock + 6],
-                                                binFeatures[splits[7].FeatureIndex * docCountInBlock + 7]
-                                            ),
-                                            _mm_setr_epi32(
-                                                splits[4].XorMask,
-                                                splits[5].XorMask,
-                                                splits[6].XorMask,
-                                                splits[7].XorMask
-                                            )
-                                        ),
-                                        _mm_setr_epi32(
-                                            splits[4].SplitIdx,
-                                            splits[5].SplitIdx,
-                                            splits[6].SplitIdx,
-                                            splits[7].SplitIdx
-                                        )
-                                    ),
-                                    _mm_set1_epi32(0xffff0000)
-                                ),
-                                _mm_setr_epi32(
-                                    treeStepNodes[_mm_extract_epi32(index1, 0)],
-                                    treeStepNodes[_mm_extract_epi32(index1, 1)],
-                                    treeStepNodes[_mm_extract_epi32(index1, 2)],
-                                    treeStepNodes[_mm_extract_epi32(index1, 3)]
-                                )
-                            ),
-                            zeroes
-                        ),
-                        zeroes
-                    );
-                    index0 = _mm_add_epi32(
-                        index0,
-                        diffs0
-                    );
-                    index1 = _mm_add_epi32(
-                        index1,
-                        diffs1
-                    );
-                } while (!_mm_testz_si128(diffs0, _mm_cmpeq_epi32(diffs0, diffs0)) || !_mm_testz_si128(diffs1, _mm_cmpeq_epi32(diffs1, diffs1)));
-                _mm_storeu_si128(indexesVec, index0);
-                _mm_storeu_si128(indexesVec + 1, index1);
-            }
-            if (docId < docCountInBlock) {
-                CalcIndexesNonSymmetric<NeedXorMask>(trees, binFeaturesI, docId, docCountInBlock, treeId, indexes);
-            }
-            if constexpr (CalcLeafIndexesOnly) {
-                const auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
-                const auto approxDimension = trees.GetDimensionsCount();
-                for (docId = 0; docId < docCountInBlock; ++docId) {
-                    Y_ASSERT((nonSymmetricNodeIdToLeafIdPtr[indexes[docId]] - firstLeafOffsetsPtr[treeId]) % approxDimension == 0);
-                    indexes[docId] = ((nonSymmetricNodeIdToLeafIdPtr[indexes[docId]] - firstLeafOffsetsPtr[treeId]) / approxDimension);
-                }
-                indexes += docCountInBlock;
-            } else if constexpr (IsSingleClassModel) {
-                for (docId = 0; docId + 8 <= docCountInBlock; docId+=8) {
-                    resultsPtr[docId + 0] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 0]]];
-                    resultsPtr[docId + 1] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 1]]];
-                    resultsPtr[docId + 2] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 2]]];
-                    resultsPtr[docId + 3] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 3]]];
-                    resultsPtr[docId + 4] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 4]]];
-                    resultsPtr[docId + 5] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 5]]];
-                    resultsPtr[docId + 6] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 6]]];
-                    resultsPtr[docId + 7] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId + 7]]];
-                }
-                for (; docId < docCountInBlock; ++docId) {
-                    resultsPtr[docId] += leafValuesPtr[nonSymmetricNodeIdToLeafIdPtr[indexes[docId]]];
-                }
-            } else {
-                const auto approxDim = trees.GetDimensionsCount();
-                auto resultWritePtr = resultsPtr;
-                for (docId = 0; docId < docCountInBlock; ++docId) {
-                    const ui32 firstValueIdx = nonSymmetricNodeIdToLeafIdPtr[indexes[docId]];
-                    for (int classId = 0; classId < (int)approxDim; ++classId, ++resultWritePtr) {
-                        *resultWritePtr += leafValuesPtr[firstValueIdx + classId];
-                    }
+        ui32 slots[NON_SYMMETRIC_LOCKSTEP_DOC_COUNT];
+        std::fill(slots, slots + NON_SYMMETRIC_LOCKSTEP_DOC_COUNT, rootSlot);
+        bool hasActive = !(nodes[rootSlot].Next & TPackedNonSymmetricNode::TerminalFlag);
+        while (hasActive) {
+            hasActive = false;
+            for (size_t lane = 0; lane < NON_SYMMETRIC_LOCKSTEP_DOC_COUNT; ++lane) {
+                const auto& node = nodes[slots[lane]];
+                const bool isInner = !(node.Next & TPackedNonSymmetricNode::TerminalFlag);
+                // terminal nodes carry a zero split, so the load stays in bounds
+                ui8 featureValue = binFeatures[node.Split.FeatureIndex * docCountInBlock + lane];
+                if constexpr (NeedXorMask) {
+                    featureValue ^= node.Split.XorMask;
                 }
+                slots[lane] = isInner ? node.Next + (featureValue >= node.Split.SplitIdx) : slots[lane];
+                hasActive |= isInner;
             }
         }
+        for (size_t lane = 0; lane < NON_SYMMETRIC_LOCKSTEP_DOC_COUNT; ++lane) {
+            leafOffsets[lane] = nodes[slots[lane]].Next & ~TPackedNonSymmetricNode::TerminalFlag;
+        }
     }
 
-#else
     template <bool IsSingleClassModel, bool NeedXorMask, bool CalcLeafIndexesOnly = false>
     inline void CalcNonSymmetricTrees(
         const TModelTrees& trees,
@@ -671,90 +749,301 @@ namespace NCB::NModelEvaluation {
         double* __restrict resultsPtr
     ) {
         const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+        const TPackedNonSymmetricNode* __restrict nodes = trees.GetPackedNonSymmetricNodes().data();
+        const ui32* __restrict treeRoots = trees.GetPackedNonSymmetricTreeRoots().data();
+        const double* __restrict leafValuesPtr = trees.GetModelTreeData()->GetLeafValues().data();
+        const auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
+        const auto approxDimension = trees.GetDimensionsCount();
+        // handle special case of model containing only empty splits: all trees are single terminal nodes
+        const bool skipWork = quantizedData->QuantizedData.GetSize() == 0;
+        ui32 leafOffsets[NON_SYMMETRIC_LOCKSTEP_DOC_COUNT];
         for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
-            CalcIndexesNonSymmetric<NeedXorMask>(trees, binFeatures, 0, docCountInBlock, treeId, indexesVec);
-            for (size_t docId = 0; docId < docCountInBlock; ++docId) {
-                indexesVec[docId] = trees.GetModelTreeData()->GetNonSymmetricNodeIdToLeafId()[indexesVec[docId]];
-            }
-            if constexpr (CalcLeafIndexesOnly) {
-                const auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
-                const auto approxDimension = trees.GetDimensionsCount();
-                for (size_t docId = 0; docId < docCountInBlock; ++docId) {
-                    Y_ASSERT((indexesVec[docId] - firstLeafOffsetsPtr[treeId]) % approxDimension == 0);
-                    indexesVec[docId] = ((indexesVec[docId] - firstLeafOffsetsPtr[treeId]) / approxDimension);
+            const ui32 rootSlot = treeRoots[treeId];
+            for (size_t groupStart = 0; groupStart < docCountInBlock; groupStart += NON_SYMMETRIC_LOCKSTEP_DOC_COUNT) {
+                const size_t groupSize = Min(NON_SYMMETRIC_LOCKSTEP_DOC_COUNT, docCountInBlock - groupStart);
+                if (skipWork) {
+                    std::fill(leafOffsets, leafOffsets + groupSize, nodes[rootSlot].Next & ~TPackedNonSymmetricNode::TerminalFlag);
+                } else if (groupSize == NON_SYMMETRIC_LOCKSTEP_DOC_COUNT) {
+                    CalcPackedNonSymmetricLeafOffsets<NeedXorMask>(nodes, rootSlot, binFeatures + groupStart, docCountInBlock, leafOffsets);
+                } else {
+                    for (size_t docId = 0; docId < groupSize; ++docId) {
+                        leafOffsets[docId] = CalcPackedNonSymmetricLeafOffset<NeedXorMask>(
+                            nodes,
+                            rootSlot,
+                            binFeatures + groupStart + docId,
+                            docCountInBlock
+                        );
+                    }
                 }
-                indexesVec += docCountInBlock;
-            } else {
-                if constexpr (IsSingleClassModel) {
-                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
-                        resultsPtr[docId] += trees.GetModelTreeData()->GetLeafValues()[indexesVec[docId]];
+                if constexpr (CalcLeafIndexesOnly) {
+                    for (size_t docId = 0; docId < groupSize; ++docId) {
+                        Y_ASSERT((leafOffsets[docId] - firstLeafOffsetsPtr[treeId]) % approxDimension == 0);
+                        indexesVec[groupStart + docId] = (leafOffsets[docId] - firstLeafOffsetsPtr[treeId]) / approxDimension;
+                    }
+                } else if constexpr (IsSingleClassModel) {
+                    for (size_t docId = 0; docId < groupSize; ++docId) {
+                        resultsPtr[groupStart + docId] += leafValuesPtr[leafOffsets[docId]];
                     }
                 } else {
-                    auto resultWritePtr = resultsPtr;
-                    for (size_t docId = 0; docId < docCountInBlock; ++docId) {
-                        const ui32 firstValueIdx = indexesVec[docId];
-                        for (int classId = 0;
-                             classId < (int)trees.GetDimensionsCount(); ++classId, ++resultWritePtr) {
-                            *resultWritePtr += trees.GetModelTreeData()->GetLeafValues()[firstValueIdx + classId];
+                    double* resultWritePtr = resultsPtr + groupStart * approxDimension;
+                    for (size_t docId = 0; docId < groupSize; ++docId) {
+                        for (size_t classId = 0; classId < approxDimension; ++classId, ++resultWritePtr) {
+                            *resultWritePtr += leafValuesPtr[leafOffsets[docId] + classId];
                         }
                     }
                 }
             }
+            if constexpr (CalcLeafIndexesOnly) {
+                indexesVec += docCountInBlock;
+            }
         }
     }
-#endif
 
 
-    template <bool IsSingleClassModel, bool NeedXorMask, bool CalcIndexesOnly>
-    inline void CalcNonSymmetricTreesSingle(
-        const TModelTrees& trees,
-        const TModelTrees::TForApplyData& applyData,
-        const TCPUEvaluatorQuantizedData* quantizedData,
-        size_t,
-        TCalcerIndexType* __restrict indexesVec,
-        size_t treeStart,
-        size_t treeEnd,
-        double* __restrict resultsPtr
-    ) {
-        const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
-        TCalcerIndexType index;
-        const TRepackedBin* treeSplitsPtr = trees.GetRepackedBins().data();
-        const TNonSymmetricTreeStepNode* treeStepNodes = trees.GetModelTreeData()->GetNonSymmetricStepNodes().data();
-        const auto firstLeafOffsetsPtr = applyData.TreeFirstLeafOffsets.data();
-        // handle special empty-model case when there is no any splits at all
-        const bool skipWork = quantizedData->QuantizedData.GetSize() == 0;
-        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
-            index = trees.GetModelTreeData()->GetTreeStartOffsets()[treeId];
-            while (!skipWork) {
-                const auto* stepNode = treeStepNodes + index;
-                const TRepackedBin split = treeSplitsPtr[index];
-                ui8 featureValue = binFeatures[split.FeatureIndex];
-                if constexpr (NeedXorMask) {
-                    featureValue ^= split.XorMask;
-                }
-                const auto diff = (featureValue >= split.SplitIdx) ? stepNode->RightSubtreeDiff
-                                                                   : stepNode->LeftSubtreeDiff;
-                index += diff;
-                if (diff == 0) {
-                    break;
-                }
+    template <bool NeedXorMask, size_t SSEBlockCount, int Depth>
+    Y_FORCE_INLINE void CalcIndexesDepthed(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplits) {
+        memset(indexesVec, 0, docCountInBlock);
+    #if defined(_sse3_)
+        CalcIndexesSseDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec, treeSplits);
+    #elif defined(_arm64_)
+        CalcIndexesNeonDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec, treeSplits);
+    #else
+        CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVec, treeSplits, Depth);
+    #endif
+    }
+
+    // all trees of the span have depth Depth, so split and leaf strides are compile time constants
+    template <bool IsSingleClassModel, bool NeedXorMask, int Depth, size_t SSEBlockCount>
+    static void CalcTreeSpanImpl(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVecUI32,
+        const TRepackedBin* __restrict spanSplits,
+        const double* __restrict spanLeafValues,
+        size_t spanTreeCount,
+        int approxDimension,
+        double* __restrict resultsPtr) {
+        constexpr size_t leafCount = size_t(1) << Depth;
+        const size_t treeLeafStride = leafCount * approxDimension;
+        ui8* __restrict indexesVec = (ui8*)indexesVecUI32;
+        size_t treeId = 0;
+    #if defined(_sse3_) || defined(_arm64_)
+        if constexpr (IsSingleClassModel) {
+            double* alignedResultsPtr = resultsPtr;
+            TVector<double> resultsTmpArray;
+            const size_t neededMemory = docCountInBlock * sizeof(double);
+            if ((uintptr_t)alignedResultsPtr % (2 * sizeof(double)) != 0) {
+                resultsTmpArray.yresize(docCountInBlock);
+                alignedResultsPtr = resultsTmpArray.data();
+                memcpy(alignedResultsPtr, resultsPtr, neededMemory);
             }
-            const ui32 firstValueIdx = trees.GetModelTreeData()->GetNonSymmetricNodeIdToLeafId()[index];
-            if constexpr (CalcIndexesOnly) {
-                Y_ASSERT((firstValueIdx - firstLeafOffsetsPtr[treeId]) % trees.GetDimensionsCount() == 0);
-                *indexesVec++ = ((firstValueIdx - firstLeafOffsetsPtr[treeId]) / trees.GetDimensionsCount());
+            for (; treeId + 4 <= spanTreeCount; treeId += 4) {
+                CalcIndexesDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 0, spanSplits + Depth * 0);
+                CalcIndexesDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 1, spanSplits + Depth * 1);
+                CalcIndexesDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 2, spanSplits + Depth * 2);
+                CalcIndexesDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec + docCountInBlock * 3, spanSplits + Depth * 3);
+                CalculateLeafValues4<SSEBlockCount>(
+                    docCountInBlock,
+                    spanLeafValues + leafCount * 0,
+                    spanLeafValues + leafCount * 1,
+                    spanLeafValues + leafCount * 2,
+                    spanLeafValues + leafCount * 3,
+                    indexesVec + docCountInBlock * 0,
+                    indexesVec + docCountInBlock * 1,
+                    indexesVec + docCountInBlock * 2,
+                    indexesVec + docCountInBlock * 3,
+                    alignedResultsPtr
+                );
+                spanSplits += Depth * 4;
+                spanLeafValues += leafCount * 4;
+            }
+            if (alignedResultsPtr != resultsPtr) {
+                memcpy(resultsPtr, alignedResultsPtr, neededMemory);
+            }
+        }
+    #endif
+        for (; treeId < spanTreeCount; ++treeId) {
+            CalcIndexesDepthed<NeedXorMask, SSEBlockCount, Depth>(binFeatures, docCountInBlock, indexesVec, spanSplits);
+            if constexpr (IsSingleClassModel) {
+                CalculateLeafValues(docCountInBlock, spanLeafValues, indexesVec, resultsPtr);
             } else {
-                if constexpr (IsSingleClassModel) {
-                    *resultsPtr += trees.GetModelTreeData()->GetLeafValues()[firstValueIdx];
-                } else {
-                    for (int classId = 0; classId < (int)trees.GetDimensionsCount(); ++classId) {
-                        resultsPtr[classId] += trees.GetModelTreeData()->GetLeafValues()[firstValueIdx + classId];
-                    }
-                }
+                CalculateLeafValuesMulti(docCountInBlock, spanLeafValues, indexesVec, approxDimension, resultsPtr);
             }
+            spanSplits += Depth;
+            spanLeafValues += treeLeafStride;
         }
     }
 
+    template <bool IsSingleClassModel, bool NeedXorMask, int Depth>
+    static void CalcTreeSpanDepthed(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        const TRepackedBin* __restrict spanSplits,
+        const double* __restrict spanLeafValues,
+        int depth,
+        size_t spanTreeCount,
+        int approxDimension,
+        double* __restrict results) {
+        Y_ASSERT(depth == Depth);
+        Y_UNUSED(depth);
+        switch (docCountInBlock / SSE_BLOCK_SIZE) {
+    #define CALC_TREE_SPAN_FOR_SSE_BLOCKS(blockCount) \
+            case blockCount: \
+                CalcTreeSpanImpl<IsSingleClassModel, NeedXorMask, Depth, blockCount>( \
+                    binFeatures, docCountInBlock, indexesVec, spanSplits, spanLeafValues, spanTreeCount, approxDimension, results); \
+                break;
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(0)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(1)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(2)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(3)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(4)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(5)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(6)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(7)
+            CALC_TREE_SPAN_FOR_SSE_BLOCKS(8)
+    #undef CALC_TREE_SPAN_FOR_SSE_BLOCKS
+            default:
+                CB_ENSURE(false, "Unexpected number of SSE blocks");
+        }
+    }
+
+    // depth 0 and depths above 8 which don't fit into ui8 indexes
+    template <bool IsSingleClassModel, bool NeedXorMask>
+    static void CalcTreeSpanGeneric(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        TCalcerIndexType* __restrict indexesVec,
+        const TRepackedBin* __restrict spanSplits,
+        const double* __restrict spanLeafValues,
+        int depth,
+        size_t spanTreeCount,
+        int approxDimension,
+        double* __restrict results) {
+        const size_t treeLeafStride = (size_t(1) << depth) * approxDimension;
+        for (size_t treeId = 0; treeId < spanTreeCount; ++treeId) {
+            memset(indexesVec, 0, sizeof(TCalcerIndexType) * docCountInBlock);
+            CalcIndexesBasic<NeedXorMask, 0>(binFeatures, docCountInBlock, indexesVec, spanSplits, depth);
+            if constexpr (IsSingleClassModel) {
+                CalculateLeafValues(docCountInBlock, spanLeafValues, indexesVec, results);
+            } else {
+                CalculateLeafValuesMulti(docCountInBlock, spanLeafValues, indexesVec, approxDimension, results);
+            }
+            spanSplits += depth;
+            spanLeafValues += treeLeafStride;
+        }
+    }
+
+    template <bool IsSingleClassModel, bool NeedXorMask>
+    static TCalcTreeSpanFunction GetCalcTreeSpanFunctionImpl(int depth) {
+        switch (depth) {
+            case 1:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 1>;
+            case 2:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 2>;
+            case 3:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 3>;
+            case 4:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 4>;
+            case 5:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 5>;
+            case 6:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 6>;
+            case 7:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 7>;
+            case 8:
+                return &CalcTreeSpanDepthed<IsSingleClassModel, NeedXorMask, 8>;
+            default:
+                return &CalcTreeSpanGeneric<IsSingleClassModel, NeedXorMask>;
+        }
+    }
+
+    TCalcTreeSpanFunction GetCalcTreeSpanFunction(int depth, bool isSingleClassModel, bool needXorMask) {
+        if (isSingleClassModel) {
+            return needXorMask
+                ? GetCalcTreeSpanFunctionImpl<true, true>(depth)
+                : GetCalcTreeSpanFunctionImpl<true, false>(depth);
+        } else {
+            return needXorMask
+                ? GetCalcTreeSpanFunctionImpl<false, true>(depth)
+                : GetCalcTreeSpanFunctionImpl<false, false>(depth);
+        }
+    }
+
+    TAtomicSharedPtr<TCompiledTreeSpans> CompileTreeSpans(const TModelTrees& trees) {
+        CB_ENSURE(trees.IsOblivious(), "Compiled evaluation is supported only for oblivious trees");
+        auto result = MakeAtomicShared<TCompiledTreeSpans>();
+        const auto treeSizes = trees.GetModelTreeData()->GetTreeSizes();
+        const auto treeStartOffsets = trees.GetModelTreeData()->GetTreeStartOffsets();
+        const auto leafValues = trees.GetModelTreeData()->GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetApplyData()->TreeFirstLeafOffsets;
+        const int approxDimension = trees.GetDimensionsCount();
+        const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        TMap<int, TCompiledTreeSpans::TDepthGroup> groupByDepth;
+        for (size_t treeId = 0; treeId < trees.GetTreeCount(); ++treeId) {
+            const int depth = treeSizes[treeId];
+            auto& group = groupByDepth[depth];
+            group.Depth = depth;
+            group.TreeIds.push_back(treeId);
+            const auto treeSplits = trees.GetRepackedBins().begin() + treeStartOffsets[treeId];
+            group.Splits.insert(group.Splits.end(), treeSplits, treeSplits + depth);
+            const auto treeLeafValues = leafValues.begin() + firstLeafOffsets[treeId];
+            group.LeafValues.insert(
+                group.LeafValues.end(),
+                treeLeafValues,
+                treeLeafValues + (size_t(1) << depth) * approxDimension);
+        }
+        for (auto& [depth, group] : groupByDepth) {
+            group.CalcFunction = GetCalcTreeSpanFunction(depth, approxDimension == 1, needXorMask);
+            result->Groups.push_back(std::move(group));
+        }
+        return result;
+    }
+
+    TTreeCalcFunction GetCalcCompiledTreesFunction(TAtomicSharedPtr<TCompiledTreeSpans> compiledTreeSpans) {
+        return [compiledTreeSpans] (
+            const TModelTrees& trees,
+            const TModelTrees::TForApplyData& applyData,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t docCountInBlock,
+            TCalcerIndexType* __restrict indexesVec,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) {
+            Y_UNUSED(applyData);
+            const ui8* __restrict binFeatures = quantizedData->QuantizedData.data();
+            // single document evaluation doesn't pass a buffer, 4 trees of ui8 indexes fit in one element
+            TCalcerIndexType singleDocIndexes[4];
+            if (indexesVec == nullptr) {
+                Y_ASSERT(docCountInBlock == 1);
+                indexesVec = singleDocIndexes;
+            }
+            const int approxDimension = trees.GetDimensionsCount();
+            for (const auto& group : compiledTreeSpans->Groups) {
+                const size_t spanStart = LowerBound(group.TreeIds.begin(), group.TreeIds.end(), treeStart) - group.TreeIds.begin();
+                const size_t spanEnd = LowerBound(group.TreeIds.begin(), group.TreeIds.end(), treeEnd) - group.TreeIds.begin();
+                if (spanStart == spanEnd) {
+                    continue;
+                }
+                group.CalcFunction(
+                    binFeatures,
+                    docCountInBlock,
+                    indexesVec,
+                    group.Splits.data() + spanStart * group.Depth,
+                    group.LeafValues.data() + spanStart * (size_t(1) << group.Depth) * approxDimension,
+                    group.Depth,
+                    spanEnd - spanStart,
+                    approxDimension,
+                    results
+                );
+            }
+        };
+    }
 
     template <bool AreTreesOblivious, bool IsSingleDoc, bool IsSingleClassModel, bool NeedXorMask,
         bool CalcLeafIndexesOnly>
@@ -767,11 +1056,8 @@ namespace NCB::NModelEvaluation {
                     return CalcTreesBlocked<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>;
                 }
             } else {
-                if constexpr (IsSingleDoc) {
-                    return CalcNonSymmetricTreesSingle<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>;
-                } else {
-                    return CalcNonSymmetricTrees<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>;
-                }
+                // packed traversal handles single document blocks as a scalar tail
+                return CalcNonSymmetricTrees<IsSingleClassModel, NeedXorMask, CalcLeafIndexesOnly>;
             }
         }
     };
@@ -792,15 +1078,165 @@ namespace NCB::NModelEvaluation {
         }
     };
 
+    TCalcIndexesKernel GetIndexesKernel(ECpuIndexesKernel kernel, bool needXorMask) {
+        switch (kernel) {
+            case ECpuIndexesKernel::Sse:
+                return nullptr;
+            case ECpuIndexesKernel::Avx2:
+                return GetAvx2IndexesKernel(needXorMask);
+            case ECpuIndexesKernel::Avx512:
+                return GetAvx512IndexesKernel(needXorMask);
+        }
+        CB_ENSURE_INTERNAL(false, "Unexpected indexes kernel " << kernel);
+    }
+
+    bool IsCpuIndexesKernelAvailable(ECpuIndexesKernel kernel) {
+        switch (kernel) {
+            case ECpuIndexesKernel::Sse:
+                return true;
+            case ECpuIndexesKernel::Avx2:
+                return GetAvx2IndexesKernel(false) != nullptr && NX86::CachedHaveAVX2();
+            case ECpuIndexesKernel::Avx512:
+                return GetAvx512IndexesKernel(false) != nullptr
+                    && NX86::CachedHaveAVX512F()
+                    && NX86::CachedHaveAVX512BW();
+        }
+        return false;
+    }
+
+    ECpuIndexesKernel GetBestCpuIndexesKernel() {
+        static const ECpuIndexesKernel bestKernel = [] {
+            for (auto kernel : {ECpuIndexesKernel::Avx512, ECpuIndexesKernel::Avx2}) {
+                if (IsCpuIndexesKernelAvailable(kernel)) {
+                    return kernel;
+                }
+            }
+            return ECpuIndexesKernel::Sse;
+        }();
+        return bestKernel;
+    }
+
+    template <bool IsSingleClassModel, bool NeedXorMask>
+    static TTreeCalcFunction GetCalcTreesBlockedWithKernelFunction(TCalcIndexesKernel indexesKernel) {
+        return [indexesKernel] (
+            const TModelTrees& trees,
+            const TModelTrees::TForApplyData& applyData,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t docCountInBlock,
+            TCalcerIndexType* __restrict indexesVec,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) {
+            CalcTreesBlockedWithKernel<IsSingleClassModel, NeedXorMask>(
+                trees, applyData, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, results, indexesKernel);
+        };
+    }
+
+    TEvaluationSchedule GetEvaluationSchedule(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        size_t docCount,
+        size_t treeStart,
+        size_t treeEnd,
+        size_t cacheBudget,
+        bool allowTreeMajor
+    ) {
+        TEvaluationSchedule schedule;
+        schedule.DocBlockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+        schedule.TreeBlockSize = treeEnd - treeStart;
+        // leaf values can't be reused by a single sub-block, so small batches stay document-major
+        if (!allowTreeMajor || docCount <= FORMULA_EVALUATION_BLOCK_SIZE || treeEnd <= treeStart) {
+            return schedule;
+        }
+        const auto leafOffset = [&] (size_t treeId) -> size_t {
+            return treeId < applyData.TreeFirstLeafOffsets.size()
+                ? applyData.TreeFirstLeafOffsets[treeId]
+                : trees.GetModelTreeData()->GetLeafValues().size();
+        };
+        const size_t treeCount = treeEnd - treeStart;
+        const size_t leafBytes = (leafOffset(treeEnd) - leafOffset(treeStart)) * sizeof(double);
+        const size_t subBlockBytes = FORMULA_EVALUATION_BLOCK_SIZE * (
+            trees.GetEffectiveBinaryFeaturesBucketsCount()
+            + trees.GetDimensionsCount() * sizeof(double)
+            + sizeof(TCalcerIndexType));
+        if (leafBytes + subBlockBytes <= cacheBudget) {
+            return schedule;
+        }
+        // split the budget in halves between leaf values of a tree group and binarized sub-blocks
+        const size_t treeLeafBytes = Max<size_t>(1, CeilDiv(leafBytes, treeCount));
+        size_t treeBlockSize = Max<size_t>(4, cacheBudget / 2 / treeLeafBytes);
+        treeBlockSize -= treeBlockSize % 4; // blocked evaluation processes trees by 4
+        schedule.TreeBlockSize = Min(treeCount, treeBlockSize);
+        const size_t subBlockCount = Max<size_t>(2, cacheBudget / 2 / subBlockBytes);
+        schedule.DocBlockSize = Min(
+            subBlockCount * FORMULA_EVALUATION_BLOCK_SIZE,
+            MAX_TREE_MAJOR_DOC_BLOCK_SIZE,
+            CeilDiv(docCount, FORMULA_EVALUATION_BLOCK_SIZE) * FORMULA_EVALUATION_BLOCK_SIZE
+        );
+        return schedule;
+    }
+
+    template <bool NeedXorMask>
+    static TTreeCalcFunction GetCalcTreesCompactLeavesFunction(
+        const TCompactLeafValues* compactLeafValues,
+        TCalcIndexesKernel indexesKernel
+    ) {
+        return [compactLeafValues, indexesKernel] (
+            const TModelTrees& trees,
+            const TModelTrees::TForApplyData& applyData,
+            const TCPUEvaluatorQuantizedData* quantizedData,
+            size_t docCountInBlock,
+            TCalcerIndexType* __restrict indexesVec,
+            size_t treeStart,
+            size_t treeEnd,
+            double* __restrict results
+        ) {
+            if (compactLeafValues->Precision == ELeafValuesPrecision::Float) {
+                CalcTreesCompactLeaves<NeedXorMask>(
+                    trees, applyData, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, results,
+                    compactLeafValues->FloatValues.data(), /*treeScales*/ nullptr, indexesKernel);
+            } else {
+                CalcTreesCompactLeaves<NeedXorMask>(
+                    trees, applyData, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, results,
+                    compactLeafValues->Int16Values.data(), compactLeafValues->TreeScales.data(), indexesKernel);
+            }
+        };
+    }
+
     TTreeCalcFunction GetCalcTreesFunction(
         const TModelTrees& trees,
         size_t docCountInBlock,
-        bool calcIndexesOnly
+        bool calcIndexesOnly,
+        ECpuIndexesKernel indexesKernel,
+        const TCompactLeafValues* compactLeafValues
     ) {
         const bool areTreesOblivious = trees.IsOblivious();
         const bool isSingleDoc = (docCountInBlock == 1);
         const bool isSingleClassModel = (trees.GetDimensionsCount() == 1);
         const bool needXorMask = !trees.GetOneHotFeatures().empty();
+        if (compactLeafValues && compactLeafValues->Precision != ELeafValuesPrecision::Double && !calcIndexesOnly) {
+            CB_ENSURE_INTERNAL(areTreesOblivious, "Reduced precision leaf values require oblivious trees");
+            const TCalcIndexesKernel wideKernel = GetIndexesKernel(indexesKernel, needXorMask);
+            return needXorMask
+                ? GetCalcTreesCompactLeavesFunction<true>(compactLeafValues, wideKernel)
+                : GetCalcTreesCompactLeavesFunction<false>(compactLeafValues, wideKernel);
+        }
+        if (areTreesOblivious && !isSingleDoc && !calcIndexesOnly) {
+            // wide kernels only pay off when there is at least one full register of documents
+            const TCalcIndexesKernel wideKernel = GetIndexesKernel(indexesKernel, needXorMask);
+            if (wideKernel && docCountInBlock >= 2 * SSE_BLOCK_SIZE) {
+                if (isSingleClassModel) {
+                    return needXorMask
+                        ? GetCalcTreesBlockedWithKernelFunction<true, true>(wideKernel)
+                        : GetCalcTreesBlockedWithKernelFunction<true, false>(wideKernel);
+                } else {
+                    return needXorMask
+                        ? GetCalcTreesBlockedWithKernelFunction<false, true>(wideKernel)
+                        : GetCalcTreesBlockedWithKernelFunction<false, false>(wideKernel);
+                }
+            }
+        }
         return FunctorTemplateParamsSubstitutor<CalcTreeFunctionInstantiationGetter>::Call(
             areTreesOblivious, isSingleDoc, isSingleClassModel, needXorMask, calcIndexesOnly);
     }
@@ -1,10 +1,69 @@
 #include <catboost/libs/model/eval_processing.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/logging/logging.h>
 
 #include "evaluator.h"
+#include "single_row_evaluation.h"
+#include "tree_leaf_bounds.h"
 
 namespace NCB::NModelEvaluation {
     namespace NDetail {
+        struct TCpuEvaluationOptions {
+            ECpuIndexesKernel IndexesKernel = ECpuIndexesKernel::Sse;
+            size_t CacheBudget = DEFAULT_EVALUATION_CACHE_BUDGET;
+            // reduced precision leaf values take priority over compiled tree spans
+            TAtomicSharedPtr<TCompactLeafValues> CompactLeafValues;
+            TAtomicSharedPtr<TCompiledTreeSpans> CompiledTreeSpans;
+            // used by CalcFlatSingle when the model has only float features
+            TAtomicSharedPtr<TSingleRowEvaluationData> SingleRowData;
+            size_t EarlyExitStageSize = DEFAULT_EARLY_EXIT_STAGE_SIZE;
+            // shared by clones of the evaluator, nullptr if stats are not collected
+            TIntrusivePtr<TEvaluationStatsCounters> Stats;
+        };
+
+        inline TTreeCalcFunction GetCalcTreesFunctionWithOptions(
+            const TModelTrees& trees,
+            size_t docCountInBlock,
+            const TCpuEvaluationOptions& options
+        ) {
+            if (options.CompiledTreeSpans && !options.CompactLeafValues) {
+                return GetCalcCompiledTreesFunction(options.CompiledTreeSpans);
+            }
+            return GetCalcTreesFunction(
+                trees,
+                docCountInBlock,
+                /*calcIndexesOnly*/ false,
+                options.IndexesKernel,
+                options.CompactLeafValues.Get()
+            );
+        }
+
+        inline TTreeCalcFunction GetTimedCalcTreesFunctionWithOptions(
+            const TModelTrees& trees,
+            size_t docCountInBlock,
+            const TCpuEvaluationOptions& options,
+            TEvaluationCallTimer* callTimer
+        ) {
+            auto calcTrees = GetCalcTreesFunctionWithOptions(trees, docCountInBlock, options);
+            if (!options.Stats) {
+                return calcTrees;
+            }
+            return [calcTrees = std::move(calcTrees), callTimer] (
+                const TModelTrees& modelTrees,
+                const TModelTrees::TForApplyData& applyData,
+                const TCPUEvaluatorQuantizedData* quantizedData,
+                size_t docCountInBlock,
+                TCalcerIndexType* __restrict indexesVec,
+                size_t treeStart,
+                size_t treeEnd,
+                double* __restrict results
+            ) {
+                callTimer->TimeTrees([&] () {
+                    calcTrees(modelTrees, applyData, quantizedData, docCountInBlock, indexesVec, treeStart, treeEnd, results);
+                });
+            };
+        }
+
         template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor,
                   typename TTextFeatureAccessor, typename TEmbeddingFeatureAccessor>
         inline void CalcGeneric(
@@ -22,10 +81,22 @@ namespace NCB::NModelEvaluation {
             size_t treeEnd,
             EPredictionType predictionType,
             TArrayRef<double> results,
+            const TCpuEvaluationOptions& options,
             const NCB::NModelEvaluation::TFeatureLayout* featureInfo = nullptr
         ) {
+            TEvaluationCallTimer callTimer(options.Stats.Get(), docCount);
             const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
-            auto calcTrees = GetCalcTreesFunction(trees, blockSize);
+            // multiclass Class prediction reuses one intermediate buffer, so sub-blocks can't be interleaved
+            const auto schedule = GetEvaluationSchedule(
+                trees,
+                applyData,
+                docCount,
+                treeStart,
+                treeEnd,
+                options.CacheBudget,
+                /*allowTreeMajor*/ predictionType != EPredictionType::Class || trees.GetDimensionsCount() == 1
+            );
+            auto calcTrees = GetTimedCalcTreesFunctionWithOptions(trees, blockSize, options, &callTimer);
             if (trees.GetTreeCount() == 0) {
                 auto biasRef = trees.GetScaleAndBias().GetBiasRef();
                 if (biasRef.size() == 1) {
@@ -50,6 +121,104 @@ namespace NCB::NModelEvaluation {
                 blockSize
             );
             ui32 blockId = 0;
+            ProcessDocsInBlocks(
+                trees,
+                ctrProvider,
+                textProcessingCollection,
+                embeddingProcessingCollection,
+                floatFeatureAccessor,
+                catFeaturesAccessor,
+                textFeatureAccessor,
+                embeddingFeatureAccessor,
+                docCount,
+                schedule.DocBlockSize,
+                [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                    if (quantizedData->BlocksCount == 1) {
+                        auto blockResultsView = resultProcessor.GetViewForRawEvaluation(blockId);
+                        calcTrees(
+                            trees,
+                            applyData,
+                            quantizedData,
+                            docCountInBlock,
+                            docCount == 1 ? nullptr : indexesVec.data(),
+                            treeStart,
+                            treeEnd,
+                            blockResultsView.data()
+                        );
+                        resultProcessor.PostprocessBlock(blockId, treeStart);
+                        ++blockId;
+                        return;
+                    }
+                    for (size_t groupStart = treeStart; groupStart < treeEnd; groupStart += schedule.TreeBlockSize) {
+                        const size_t groupEnd = Min(treeEnd, groupStart + schedule.TreeBlockSize);
+                        for (size_t subBlockId = 0; subBlockId < quantizedData->BlocksCount; ++subBlockId) {
+                            const auto subBlock = quantizedData->ExtractBlock(subBlockId);
+                            calcTrees(
+                                trees,
+                                applyData,
+                                &subBlock,
+                                subBlock.ObjectsCount,
+                                indexesVec.data(),
+                                groupStart,
+                                groupEnd,
+                                resultProcessor.GetViewForRawEvaluation(blockId + subBlockId).data()
+                            );
+                        }
+                    }
+                    for (size_t subBlockId = 0; subBlockId < quantizedData->BlocksCount; ++subBlockId) {
+                        resultProcessor.PostprocessBlock(blockId, treeStart);
+                        ++blockId;
+                    }
+                },
+                featureInfo
+            );
+        }
+
+        /* Evaluates trees in stages of options.EarlyExitStageSize, after each stage objects with decided result are
+         * dropped and binarized features of the rest are compacted, so later stages work on fewer objects.
+         */
+        template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor,
+                  typename TTextFeatureAccessor, typename TEmbeddingFeatureAccessor>
+        inline void CalcWithBorderGeneric(
+            const TModelTrees& trees,
+            const TModelTrees::TForApplyData& applyData,
+            const TTreeLeafBounds& leafBounds,
+            const TIntrusivePtr<ICtrProvider>& ctrProvider,
+            const TIntrusivePtr<TTextProcessingCollection>& textProcessingCollection,
+            const TIntrusivePtr<TEmbeddingProcessingCollection>& embeddingProcessingCollection,
+            TFloatFeatureAccessor floatFeatureAccessor,
+            TCatFeatureAccessor catFeaturesAccessor,
+            TTextFeatureAccessor textFeatureAccessor,
+            TEmbeddingFeatureAccessor embeddingFeatureAccessor,
+            size_t docCount,
+            size_t treeStart,
+            size_t treeEnd,
+            double border,
+            TArrayRef<double> results,
+            const TCpuEvaluationOptions& options,
+            const NCB::NModelEvaluation::TFeatureLayout* featureInfo
+        ) {
+            TEvaluationCallTimer callTimer(options.Stats.Get(), docCount);
+            const size_t stageSize = options.EarlyExitStageSize;
+            const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+            auto calcTrees = GetTimedCalcTreesFunctionWithOptions(trees, blockSize, options, &callTimer);
+            const auto& scaleAndBias = trees.GetScaleAndBias();
+            const double scale = scaleAndBias.Scale;
+            const double bias = treeStart == 0 ? scaleAndBias.GetOneDimensionalBiasOrZero() : 0.0;
+            const double compactLeavesError = options.CompactLeafValues ? options.CompactLeafValues->MaxAbsoluteError : 0.0;
+            const size_t bucketCount = trees.GetEffectiveBinaryFeaturesBucketsCount();
+            if (treeStart == treeEnd) {
+                Fill(results.begin(), results.end(), bias > border);
+                return;
+            }
+
+            TVector<TCalcerIndexType> indexesVec(blockSize);
+            TVector<double> rawValues(blockSize);
+            TVector<ui32> activeDocIds(blockSize);
+            TVector<ui32> keptPositions(blockSize);
+            TVector<ui8> compactedBins;
+            compactedBins.yresize(bucketCount * blockSize);
+            size_t blockStart = 0;
             ProcessDocsInBlocks(
                 trees,
                 ctrProvider,
@@ -62,33 +231,84 @@ namespace NCB::NModelEvaluation {
                 docCount,
                 blockSize,
                 [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
-                    auto blockResultsView = resultProcessor.GetViewForRawEvaluation(blockId);
-                    calcTrees(
-                        trees,
-                        applyData,
-                        quantizedData,
-                        docCountInBlock,
-                        docCount == 1 ? nullptr : indexesVec.data(),
-                        treeStart,
-                        treeEnd,
-                        blockResultsView.data()
-                    );
-                    resultProcessor.PostprocessBlock(blockId, treeStart);
-                    ++blockId;
+                    Fill(rawValues.begin(), rawValues.begin() + docCountInBlock, 0.0);
+                    Iota(activeDocIds.begin(), activeDocIds.begin() + docCountInBlock, 0);
+                    TCPUEvaluatorQuantizedData activeData;
+                    activeData.BlocksCount = 1;
+                    activeData.ObjectsCount = docCountInBlock;
+                    activeData.BlockStride = bucketCount * docCountInBlock;
+                    activeData.QuantizedData = quantizedData->QuantizedData.Slice(0, activeData.BlockStride);
+                    size_t activeCount = docCountInBlock;
+                    for (size_t stageStart = treeStart; stageStart < treeEnd && activeCount > 0; stageStart += stageSize) {
+                        const size_t stageEnd = Min(treeEnd, stageStart + stageSize);
+                        calcTrees(
+                            trees,
+                            applyData,
+                            &activeData,
+                            activeCount,
+                            docCount == 1 ? nullptr : indexesVec.data(),
+                            stageStart,
+                            stageEnd,
+                            rawValues.data()
+                        );
+                        const bool isLastStage = stageEnd == treeEnd;
+                        const double restMin = isLastStage ? 0.0 : leafBounds.GetMin(stageEnd, treeEnd) - compactLeavesError;
+                        const double restMax = isLastStage ? 0.0 : leafBounds.GetMax(stageEnd, treeEnd) + compactLeavesError;
+                        size_t keptCount = 0;
+                        for (size_t pos = 0; pos < activeCount; ++pos) {
+                            const double lower = scale * (rawValues[pos] + (scale >= 0 ? restMin : restMax)) + bias;
+                            const double upper = scale * (rawValues[pos] + (scale >= 0 ? restMax : restMin)) + bias;
+                            if (isLastStage || lower > border || upper <= border) {
+                                results[blockStart + activeDocIds[pos]] = lower > border;
+                            } else {
+                                activeDocIds[keptCount] = activeDocIds[pos];
+                                rawValues[keptCount] = rawValues[pos];
+                                keptPositions[keptCount] = pos;
+                                ++keptCount;
+                            }
+                        }
+                        if (keptCount > 0 && keptCount < activeCount) {
+                            // positions only grow, so compaction into the same buffer is safe after the first one
+                            const ui8* srcBins = activeData.QuantizedData.data();
+                            ui8* dstBins = compactedBins.data();
+                            for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+                                for (size_t pos = 0; pos < keptCount; ++pos) {
+                                    dstBins[bucket * keptCount + pos] = srcBins[bucket * activeCount + keptPositions[pos]];
+                                }
+                            }
+                            activeData.ObjectsCount = keptCount;
+                            activeData.BlockStride = bucketCount * keptCount;
+                            activeData.QuantizedData = TMaybeOwningArrayHolder<ui8>::CreateNonOwning(
+                                MakeArrayRef(dstBins, activeData.BlockStride)
+                            );
+                        }
+                        activeCount = keptCount;
+                    }
+                    blockStart += docCountInBlock;
                 },
                 featureInfo
             );
         }
 
-        class TCpuEvaluator final : public IModelEvaluator {
+        class TCpuEvaluator : public IModelEvaluator {
         public:
-            explicit TCpuEvaluator(const TFullModel& fullModel)
+            explicit TCpuEvaluator(
+                const TFullModel& fullModel,
+                TAtomicSharedPtr<TCompiledTreeSpans> compiledTreeSpans = nullptr
+            )
                 : ModelTrees(fullModel.ModelTrees)
                 , ApplyData(ModelTrees->GetApplyData())
                 , CtrProvider(fullModel.CtrProvider)
                 , TextProcessingCollection(fullModel.TextProcessingCollection)
                 , EmbeddingProcessingCollection(fullModel.EmbeddingProcessingCollection)
-            {}
+            {
+                Options.IndexesKernel = GetBestCpuIndexesKernel();
+                Options.CompiledTreeSpans = std::move(compiledTreeSpans);
+                Options.SingleRowData = BuildSingleRowEvaluationData(*ModelTrees);
+                if (ModelTrees->GetDimensionsCount() == 1) {
+                    LeafBounds = BuildTreeLeafBounds(*ModelTrees);
+                }
+            }
 
             void SetPredictionType(EPredictionType type) override {
                 PredictionType = type;
@@ -115,8 +335,47 @@ namespace NCB::NModelEvaluation {
             }
 
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                CB_ENSURE(false, "CPU evaluator don't have any properties. Got: " << propName);
-                Y_UNUSED(propValue);
+                if (propName == "IndexesKernel") {
+                    const auto kernel = FromString<ECpuIndexesKernel>(propValue);
+                    CB_ENSURE(
+                        IsCpuIndexesKernelAvailable(kernel),
+                        "Indexes kernel " << kernel << " is not supported by this build or CPU"
+                    );
+                    Options.IndexesKernel = kernel;
+                } else if (propName == "EvaluationCacheBudget") {
+                    Options.CacheBudget = FromString<size_t>(propValue);
+                } else if (propName == "LeafValuesPrecision") {
+                    const auto precision = FromString<ELeafValuesPrecision>(propValue);
+                    if (precision == ELeafValuesPrecision::Double) {
+                        Options.CompactLeafValues.Reset();
+                    } else {
+                        Options.CompactLeafValues = BuildCompactLeafValues(*ModelTrees, precision);
+                    }
+                } else if (propName == "EarlyExitStageSize") {
+                    Options.EarlyExitStageSize = FromString<size_t>(propValue);
+                    CB_ENSURE(Options.EarlyExitStageSize > 0, "Early exit stage size should be positive");
+                } else if (propName == "SingleRowFastPath") {
+                    if (FromString<bool>(propValue)) {
+                        Options.SingleRowData = BuildSingleRowEvaluationData(*ModelTrees);
+                    } else {
+                        Options.SingleRowData.Reset();
+                    }
+                } else if (propName == "EvaluationStats") {
+                    if (FromString<bool>(propValue)) {
+                        Options.Stats = MakeIntrusive<TEvaluationStatsCounters>();
+                    } else {
+                        Options.Stats.Reset();
+                    }
+                } else {
+                    CB_ENSURE(false, "CPU evaluator doesn't have property " << propName);
+                }
+            }
+
+            TMaybe<TEvaluationStats> GetEvaluationStats() const override {
+                if (!Options.Stats) {
+                    return Nothing();
+                }
+                return Options.Stats->GetStats();
             }
 
             void CalcFlatTransposed(
@@ -180,6 +439,7 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
                     featureInfo
                 );
             }
@@ -227,6 +487,7 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
                     featureInfo
                 );
             }
@@ -245,6 +506,24 @@ namespace NCB::NModelEvaluation {
                     ModelTrees->GetFlatFeatureVectorExpectedSize() <= features.size(),
                     "Not enough features provided"
                 );
+                const bool canUseSingleRowData = Options.SingleRowData && !featureInfo && !Options.CompactLeafValues &&
+                    (PredictionType != EPredictionType::Class || ModelTrees->GetDimensionsCount() == 1);
+                if (canUseSingleRowData) {
+                    TEvaluationCallTimer callTimer(Options.Stats.Get(), /*objectCount*/ 1);
+                    callTimer.TimeTrees([&] () {
+                        CalcSingleRow(
+                            *ModelTrees,
+                            *ApplyData,
+                            *Options.SingleRowData,
+                            features,
+                            treeStart,
+                            treeEnd,
+                            PredictionType,
+                            results
+                        );
+                    });
+                    return;
+                }
                 CalcGeneric(
                     *ModelTrees,
                     *ApplyData,
@@ -264,6 +543,58 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
+                    featureInfo
+                );
+            }
+
+            void CalcFlatWithBorder(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t treeStart,
+                size_t treeEnd,
+                double border,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo
+            ) const override {
+                if (!featureInfo) {
+                    featureInfo = ExtFeatureLayout.Get();
+                }
+                CB_ENSURE(LeafBounds, "Evaluation with border is supported only for approx dimension 1");
+                CB_ENSURE(
+                    results.size() == features.size(),
+                    "`results` size is insufficient: " << LabeledOutput(results.size(), features.size())
+                );
+                auto expectedFlatVecSize = ModelTrees->GetFlatFeatureVectorExpectedSize();
+                if (featureInfo && featureInfo->FlatIndexes) {
+                    expectedFlatVecSize = *MaxElement(featureInfo->FlatIndexes->begin(), featureInfo->FlatIndexes->end());
+                }
+                for (const auto& flatFeaturesVec : features) {
+                    CB_ENSURE(
+                        flatFeaturesVec.size() >= expectedFlatVecSize,
+                        "insufficient flat features vector size: " << flatFeaturesVec.size() << " expected: " << expectedFlatVecSize
+                    );
+                }
+                CalcWithBorderGeneric(
+                    *ModelTrees,
+                    *ApplyData,
+                    *LeafBounds,
+                    CtrProvider,
+                    TextProcessingCollection,
+                    EmbeddingProcessingCollection,
+                    [&features](TFeaturePosition position, size_t index) -> float {
+                        return features[index][position.FlatIndex];
+                    },
+                    [&features](TFeaturePosition position, size_t index) -> int {
+                        return ConvertFloatCatFeatureToIntHash(features[index][position.FlatIndex]);
+                    },
+                    TCpuEvaluator::TextFeatureAccessorStub,
+                    TCpuEvaluator::EmbeddingFeatureAccessorStub,
+                    features.size(),
+                    treeStart,
+                    treeEnd,
+                    border,
+                    results,
+                    Options,
                     featureInfo
                 );
             }
@@ -343,6 +674,7 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
                     featureInfo
                 );
             }
@@ -393,8 +725,8 @@ namespace NCB::NModelEvaluation {
                     [&floatFeatures](TFeaturePosition position, size_t index) -> float {
                         return floatFeatures[index][position.Index];
                     },
-                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
-                        return CalcCatFeatureHash(catFeatures[index][position.Index]);
+                    [&catFeatures](TFeaturePosition position, size_t index) -> TStringBuf {
+                        return catFeatures[index][position.Index];
                     },
                     [&textFeatures](TFeaturePosition position, size_t index) -> TStringBuf {
                         return textFeatures[index][position.Index];
@@ -405,6 +737,7 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
                     featureInfo
                 );
             }
@@ -433,8 +766,8 @@ namespace NCB::NModelEvaluation {
                     [&floatFeatures](TFeaturePosition position, size_t index) -> float {
                         return floatFeatures[index][position.Index];
                     },
-                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
-                        return CalcCatFeatureHash(catFeatures[index][position.Index]);
+                    [&catFeatures](TFeaturePosition position, size_t index) -> TStringBuf {
+                        return catFeatures[index][position.Index];
                     },
                     [&textFeatures](TFeaturePosition position, size_t index) -> TStringBuf {
                         return textFeatures[index][position.Index];
@@ -447,6 +780,7 @@ namespace NCB::NModelEvaluation {
                     treeEnd,
                     PredictionType,
                     results,
+                    Options,
                     featureInfo
                 );
             }
@@ -469,8 +803,8 @@ namespace NCB::NModelEvaluation {
                     [&floatFeatures](TFeaturePosition position, size_t) -> float {
                         return floatFeatures[position.Index];
                     },
-                    [&catFeatures](TFeaturePosition position, size_t) -> int {
-                        return CalcCatFeatureHash(catFeatures[position.Index]);
+                    [&catFeatures](TFeaturePosition position, size_t) -> TStringBuf {
+                        return catFeatures[position.Index];
                     },
                     1,
                     treeStart,
@@ -500,8 +834,8 @@ namespace NCB::NModelEvaluation {
                     [&floatFeatures](TFeaturePosition position, size_t index) -> float {
                         return floatFeatures[index][position.Index];
                     },
-                    [&catFeatures](TFeaturePosition position, size_t index) -> int {
-                        return CalcCatFeatureHash(catFeatures[index][position.Index]);
+                    [&catFeatures](TFeaturePosition position, size_t index) -> TStringBuf {
+                        return catFeatures[index][position.Index];
                     },
                     docCount,
                     treeStart,
@@ -528,11 +862,7 @@ namespace NCB::NModelEvaluation {
                 CB_ENSURE(cpuQuantizedFeatures->BlocksCount * FORMULA_EVALUATION_BLOCK_SIZE >= cpuQuantizedFeatures->ObjectsCount);
                 std::fill(results.begin(), results.end(), 0.0);
                 auto subBlockSize = Min<size_t>(FORMULA_EVALUATION_BLOCK_SIZE, cpuQuantizedFeatures->ObjectsCount);
-                auto calcFunction = GetCalcTreesFunction(
-                    *ModelTrees,
-                    subBlockSize,
-                    false
-                );
+                auto calcFunction = GetCalcTreesFunctionWithOptions(*ModelTrees, subBlockSize, Options);
                 CB_ENSURE(results.size() == ModelTrees->GetDimensionsCount() * cpuQuantizedFeatures->ObjectsCount);
                 TVector<TCalcerIndexType> indexesVec(subBlockSize);
                 double* resultPtr = results.data();
@@ -720,10 +1050,34 @@ namespace NCB::NModelEvaluation {
             const TIntrusivePtr<TEmbeddingProcessingCollection> EmbeddingProcessingCollection;
             EPredictionType PredictionType = EPredictionType::RawFormulaVal;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
+            TCpuEvaluationOptions Options;
+            TAtomicSharedPtr<TTreeLeafBounds> LeafBounds;
+        };
+
+        static TAtomicSharedPtr<TCompiledTreeSpans> CompileTreeSpansOrFallback(const TModelTrees& trees) {
+            if (!trees.IsOblivious()) {
+                CATBOOST_WARNING_LOG << "Compiled evaluation is supported only for oblivious trees, "
+                    "CPU evaluation is used instead" << Endl;
+                return nullptr;
+            }
+            return CompileTreeSpans(trees);
+        }
+
+        // falls back to the plain CPU evaluation for models that cannot be compiled
+        class TCompiledCpuEvaluator final : public TCpuEvaluator {
+        public:
+            explicit TCompiledCpuEvaluator(const TFullModel& fullModel)
+                : TCpuEvaluator(fullModel, CompileTreeSpansOrFallback(*fullModel.ModelTrees))
+            {}
+
+            TModelEvaluatorPtr Clone() const override {
+                return new TCompiledCpuEvaluator(*this);
+            }
         };
     }
 
     TEvaluationBackendFactory::TRegistrator<NDetail::TCpuEvaluator> CPUEvaluationBackendRegistrator(EFormulaEvaluatorType::CPU);
+    TEvaluationBackendFactory::TRegistrator<NDetail::TCompiledCpuEvaluator> CompiledCPUEvaluationBackendRegistrator(EFormulaEvaluatorType::CompiledCPU);
 
     void* CPUEvaluationBackendRegistratorPointer = &CPUEvaluationBackendRegistrator;
 }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <catboost/libs/model/model.h>
+
+#include <util/system/types.h>
+
+namespace NCB::NModelEvaluation {
+
+    // Vector width used for leaf index calculation of oblivious trees in document blocks
+    enum class ECpuIndexesKernel {
+        Sse,    // 16 documents per register (native NEON on arm64 builds)
+        Avx2,   // 32 documents per register
+        Avx512  // 64 documents per register, requires AVX-512BW
+    };
+
+    /* Calculates ui8 leaf indexes for a tree of depth <= 8 for all documents in block.
+     * binFeatures are stored feature-major with docCountInBlock stride, indexesVec is fully overwritten.
+     */
+    using TCalcIndexesKernel = void (*)(
+        const ui8* __restrict binFeatures,
+        size_t docCountInBlock,
+        ui8* __restrict indexesVec,
+        const TRepackedBin* __restrict treeSplitsCurPtr,
+        int curTreeSize);
+
+    // Return nullptr if the corresponding translation unit was built without the instruction set
+    TCalcIndexesKernel GetAvx2IndexesKernel(bool needXorMask);
+    TCalcIndexesKernel GetAvx512IndexesKernel(bool needXorMask);
+
+    // Widest kernel which is both compiled in and supported by the host CPU
+    ECpuIndexesKernel GetBestCpuIndexesKernel();
+
+    bool IsCpuIndexesKernelAvailable(ECpuIndexesKernel kernel);
+
+    // nullptr for ECpuIndexesKernel::Sse, which is inlined into the evaluator itself
+    TCalcIndexesKernel GetIndexesKernel(ECpuIndexesKernel kernel, bool needXorMask);
+}
@@ -0,0 +1,179 @@
+#include "model_group_evaluator.h"
+
+#include "evaluator.h"
+
+#include <catboost/libs/model/eval_processing.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/map.h>
+#include <util/generic/xrange.h>
+
+namespace NCB::NModelEvaluation {
+
+    // NaN values are quantized as -infinity unless they are substituted by +infinity
+    static bool HasNanAsTrue(const TFloatFeature& feature) {
+        return feature.HasNans && feature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue;
+    }
+
+    static TVector<TFloatFeature> MergeFloatFeatures(TConstArrayRef<const TFullModel*> models) {
+        TMap<int, TFloatFeature> mergedFeatures; // same order of features as in the models
+        for (const auto* model : models) {
+            for (const auto& feature : model->ModelTrees->GetFloatFeatures()) {
+                if (!feature.UsedInModel()) {
+                    continue;
+                }
+                auto [featureIt, isNew] = mergedFeatures.emplace(feature.Position.Index, feature);
+                auto& mergedFeature = featureIt->second;
+                if (isNew) {
+                    mergedFeature.NanValueTreatment = HasNanAsTrue(feature)
+                        ? TFloatFeature::ENanValueTreatment::AsTrue
+                        : TFloatFeature::ENanValueTreatment::AsFalse;
+                    continue;
+                }
+                CB_ENSURE(
+                    mergedFeature.Position.FlatIndex == feature.Position.FlatIndex,
+                    "Models of group have different flat indexes of float feature " << feature.Position.Index
+                );
+                CB_ENSURE(
+                    HasNanAsTrue(mergedFeature) == HasNanAsTrue(feature),
+                    "Models of group treat NaN values of float feature " << feature.Position.Index << " differently"
+                );
+                mergedFeature.HasNans |= feature.HasNans;
+                mergedFeature.Borders.insert(mergedFeature.Borders.end(), feature.Borders.begin(), feature.Borders.end());
+            }
+        }
+        TVector<TFloatFeature> result;
+        for (auto& [featureIdx, feature] : mergedFeatures) {
+            SortUnique(feature.Borders);
+            result.push_back(std::move(feature));
+        }
+        return result;
+    }
+
+    static TModelTrees RemapToSharedBinFeatures(const TModelTrees& trees, const TModelTrees& sharedTrees) {
+        THashMap<TFloatSplit, int> sharedSplitIdx;
+        const auto sharedBinFeatures = sharedTrees.GetBinFeatures();
+        for (auto binFeatureIdx : xrange(sharedBinFeatures.size())) {
+            sharedSplitIdx[sharedBinFeatures[binFeatureIdx].FloatFeature] = binFeatureIdx;
+        }
+        const auto binFeatures = trees.GetBinFeatures();
+        const auto treeSplits = trees.GetModelTreeData()->GetTreeSplits();
+        const auto stepNodes = trees.GetModelTreeData()->GetNonSymmetricStepNodes();
+        TVector<int> sharedTreeSplits(treeSplits.size(), 0);
+        for (auto nodeIdx : xrange(treeSplits.size())) {
+            // terminal nodes of non symmetric trees keep zero split placeholder
+            const bool isTerminalNode = !stepNodes.empty()
+                && stepNodes[nodeIdx].LeftSubtreeDiff == TNonSymmetricTreeStepNode::TerminalMarker
+                && stepNodes[nodeIdx].RightSubtreeDiff == TNonSymmetricTreeStepNode::TerminalMarker;
+            if (!isTerminalNode) {
+                sharedTreeSplits[nodeIdx] = sharedSplitIdx.at(binFeatures[treeSplits[nodeIdx]].FloatFeature);
+            }
+        }
+        TModelTrees result = trees;
+        result.ConvertToSolid();
+        result.SetFloatFeatures(sharedTrees.GetFloatFeatures());
+        result.SetTreeSplits(sharedTreeSplits);
+        result.UpdateRuntimeData();
+        return result;
+    }
+
+    TModelGroupEvaluator::TModelGroupEvaluator(TConstArrayRef<const TFullModel*> models) {
+        CB_ENSURE(!models.empty(), "Model group should have at least one model");
+        for (const auto* model : models) {
+            const auto applyData = model->ModelTrees->GetApplyData();
+            CB_ENSURE(
+                applyData->UsedCatFeaturesCount == 0
+                    && applyData->UsedTextFeaturesCount == 0
+                    && applyData->UsedEmbeddingFeaturesCount == 0
+                    && applyData->UsedEstimatedFeaturesCount == 0,
+                "Model group evaluation supports models with float features only"
+            );
+            FlatFeatureVectorExpectedSize = Max(
+                FlatFeatureVectorExpectedSize,
+                model->ModelTrees->GetFlatFeatureVectorExpectedSize()
+            );
+        }
+        SharedTrees.SetFloatFeatures(MergeFloatFeatures(models));
+        SharedTrees.UpdateRuntimeData();
+        for (const auto* model : models) {
+            MemberTrees.push_back(RemapToSharedBinFeatures(*model->ModelTrees, SharedTrees));
+        }
+    }
+
+    void TModelGroupEvaluator::CalcFlat(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        TConstArrayRef<TArrayRef<double>> results
+    ) const {
+        CB_ENSURE(
+            results.size() == MemberTrees.size(),
+            "Expected results for " << MemberTrees.size() << " models, got " << results.size()
+        );
+        for (const auto& flatFeaturesVec : features) {
+            CB_ENSURE(
+                flatFeaturesVec.size() >= FlatFeatureVectorExpectedSize,
+                "insufficient flat features vector size: " << flatFeaturesVec.size()
+                    << " expected: " << FlatFeatureVectorExpectedSize
+            );
+        }
+        const size_t docCount = features.size();
+        if (docCount == 0) {
+            return;
+        }
+        const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+        const auto indexesKernel = GetBestCpuIndexesKernel();
+        TVector<TTreeCalcFunction> calcTrees;
+        TVector<TEvalResultProcessor> resultProcessors;
+        resultProcessors.reserve(MemberTrees.size());
+        for (auto modelIdx : xrange(MemberTrees.size())) {
+            const auto& trees = MemberTrees[modelIdx];
+            CB_ENSURE(
+                results[modelIdx].size() == docCount * trees.GetDimensionsCount(),
+                "Result size of model " << modelIdx << " should be " << docCount * trees.GetDimensionsCount()
+            );
+            Fill(results[modelIdx].begin(), results[modelIdx].end(), 0.0);
+            calcTrees.push_back(GetCalcTreesFunction(trees, blockSize, /*calcIndexesOnly*/ false, indexesKernel));
+            resultProcessors.emplace_back(
+                docCount,
+                results[modelIdx],
+                PredictionType,
+                trees.GetScaleAndBias(),
+                trees.GetDimensionsCount(),
+                blockSize
+            );
+        }
+        TVector<TCalcerIndexType> indexesVec(blockSize);
+        ui32 blockId = 0;
+        ProcessDocsInBlocks(
+            SharedTrees,
+            TIntrusivePtr<ICtrProvider>(),
+            [&features](TFeaturePosition position, size_t index) -> float {
+                return features[index][position.FlatIndex];
+            },
+            [](TFeaturePosition, size_t) -> int {
+                CB_ENSURE_INTERNAL(false, "Model group has no categorical features");
+                return 0;
+            },
+            docCount,
+            blockSize,
+            [&] (size_t docCountInBlock, const TCPUEvaluatorQuantizedData* quantizedData) {
+                // documents are quantized once and evaluated by every member
+                for (auto modelIdx : xrange(MemberTrees.size())) {
+                    const auto& trees = MemberTrees[modelIdx];
+                    calcTrees[modelIdx](
+                        trees,
+                        *trees.GetApplyData(),
+                        quantizedData,
+                        docCountInBlock,
+                        docCount == 1 ? nullptr : indexesVec.data(),
+                        0,
+                        trees.GetTreeCount(),
+                        resultProcessors[modelIdx].GetViewForRawEvaluation(blockId).data()
+                    );
+                    resultProcessors[modelIdx].PostprocessBlock(blockId, 0);
+                }
+                ++blockId;
+            },
+            /*featureInfo*/ nullptr
+        );
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <catboost/libs/model/enums.h>
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+namespace NCB::NModelEvaluation {
+
+    /* Evaluates several models with float features only over the same feature vectors.
+     * Borders of the member models are merged into one sorted superset per feature, so documents
+     * are quantized once for the whole group, and splits of each member are remapped onto this
+     * shared bin layout. Results are the same as of separate evaluation of the members.
+     */
+    class TModelGroupEvaluator {
+    public:
+        explicit TModelGroupEvaluator(TConstArrayRef<const TFullModel*> models);
+
+        size_t GetModelCount() const {
+            return MemberTrees.size();
+        }
+
+        i32 GetApproxDimension(size_t modelIdx) const {
+            return MemberTrees[modelIdx].GetDimensionsCount();
+        }
+
+        void SetPredictionType(EPredictionType type) {
+            PredictionType = type;
+        }
+
+        EPredictionType GetPredictionType() const {
+            return PredictionType;
+        }
+
+        // Float features with merged borders, members are evaluated over their bin layout
+        const TModelTrees& GetSharedTrees() const {
+            return SharedTrees;
+        }
+
+        // results[modelIdx] has features.size() * GetApproxDimension(modelIdx) values, document-major
+        void CalcFlat(
+            TConstArrayRef<TConstArrayRef<float>> features,
+            TConstArrayRef<TArrayRef<double>> results) const;
+
+    private:
+        TModelTrees SharedTrees;
+        TVector<TModelTrees> MemberTrees;
+        size_t FlatFeatureVectorExpectedSize = 0;
+        EPredictionType PredictionType = EPredictionType::RawFormulaVal;
+    };
+}
@@ -10,8 +10,12 @@
 
 #include <util/generic/array_ref.h>
 #include <util/generic/hash.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
+#include <array>
+#include <type_traits>
+
 namespace NCB::NModelEvaluation {
     constexpr size_t FORMULA_EVALUATION_BLOCK_SIZE = 128;
 
@@ -32,7 +36,8 @@ namespace NCB::NModelEvaluation {
         TCPUEvaluatorQuantizedData ExtractBlock(size_t blockId) const {
             TCPUEvaluatorQuantizedData result;
             result.BlocksCount = 1;
-            size_t width = QuantizedData.GetSize() / ObjectsCount;
+            // holder may be larger than needed, so take the width from the full block layout
+            size_t width = BlockStride / FORMULA_EVALUATION_BLOCK_SIZE;
 
             result.ObjectsCount = Min(
                 FORMULA_EVALUATION_BLOCK_SIZE, ObjectsCount - FORMULA_EVALUATION_BLOCK_SIZE * (blockId));
@@ -258,8 +263,85 @@ namespace NCB::NModelEvaluation {
 
 #endif
 
+    // count of borders less than value, borders must be sorted and nonempty
+    Y_FORCE_INLINE ui8 CountBordersLessThan(const float* borders, size_t bordersCount, float value) {
+        const float* base = borders;
+        // branch-free: the number of iterations depends only on bordersCount
+        for (size_t count = bordersCount; count > 1;) {
+            const size_t half = count / 2;
+            base = (base[half] < value) ? base + half : base;
+            count -= half;
+        }
+        return static_cast<ui8>((base - borders) + (*base < value));
+    }
+
+    /**
+     * Same result as BinarizeFloats with O(log(borders count)) comparisons per value, the borders must be sorted.
+     * Used for features with many borders.
+     */
+    template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
+    Y_FORCE_INLINE void BinarizeFloatsWithBinarySearch(
+        TFeaturePosition position,
+        const size_t docCount,
+        TFloatFeatureAccessor floatAccessor,
+        const TConstArrayRef<float> borders,
+        size_t start,
+        ui8*& result,
+        const float nanSubstitutionValue = 0.0f
+    ) {
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            float val = floatAccessor(position, start + docId);
+            if (UseNanSubstitution) {
+                if (std::isnan(val)) {
+                    val = nanSubstitutionValue;
+                }
+            }
+            ui8* writePtr = result + docId;
+            for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+                const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
+                *writePtr = CountBordersLessThan(borders.data() + blockStart, blockEnd - blockStart, val);
+                writePtr += docCount;
+            }
+        }
+        result += docCount * ((borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN);
+    }
 
-    // TCatFeatureAccessor must return hashed cat feature values
+    template <bool UseNanSubstitution, typename TFloatFeatureAccessor>
+    Y_FORCE_INLINE void BinarizeFloatFeature(
+        bool useBinarySearch,
+        TFeaturePosition position,
+        const size_t docCount,
+        TFloatFeatureAccessor floatAccessor,
+        const TConstArrayRef<float> borders,
+        size_t start,
+        ui8*& result,
+        const float nanSubstitutionValue = 0.0f
+    ) {
+        if (useBinarySearch) {
+            BinarizeFloatsWithBinarySearch<UseNanSubstitution, TFloatFeatureAccessor>(
+                position,
+                docCount,
+                floatAccessor,
+                borders,
+                start,
+                result,
+                nanSubstitutionValue
+            );
+        } else {
+            BinarizeFloats<UseNanSubstitution, TFloatFeatureAccessor>(
+                position,
+                docCount,
+                floatAccessor,
+                borders,
+                start,
+                result,
+                nanSubstitutionValue
+            );
+        }
+    }
+
+
+    // TCatFeatureAccessor must return hashed cat feature values or TStringBuf values, hashed here by columns
     template <typename TCatFeatureAccessor>
     inline void ComputeOneHotAndCtrFeaturesForBlock(
         const TModelTrees& trees,
@@ -286,10 +368,25 @@ namespace NCB::NModelEvaluation {
                 if (featureInfo) {
                     position = featureInfo->GetRemappedPosition(catFeature);
                 }
-                for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
-                     docId < docCount;
-                     ++docId, ++writeIdx) {
-                    transposedHash[writeIdx] = catFeatureAccessor(position, start + docId);
+                using TCatFeatureValue = std::decay_t<std::invoke_result_t<TCatFeatureAccessor, TFeaturePosition, size_t>>;
+                if constexpr (std::is_same_v<TCatFeatureValue, TStringBuf>) {
+                    std::array<TStringBuf, FORMULA_EVALUATION_BLOCK_SIZE> values;
+                    for (size_t chunkStart = 0; chunkStart < docCount; chunkStart += values.size()) {
+                        const size_t chunkSize = Min(values.size(), docCount - chunkStart);
+                        for (size_t docId : xrange(chunkSize)) {
+                            values[docId] = catFeatureAccessor(position, start + chunkStart + docId);
+                        }
+                        CalcCatFeatureHashes(
+                            MakeArrayRef(values.data(), chunkSize),
+                            transposedHash.subspan(usedFeatureIdx * docCount + chunkStart, chunkSize)
+                        );
+                    }
+                } else {
+                    for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
+                         docId < docCount;
+                         ++docId, ++writeIdx) {
+                        transposedHash[writeIdx] = catFeatureAccessor(position, start + docId);
+                    }
                 }
                 ++usedFeatureIdx;
             }
@@ -348,7 +445,9 @@ namespace NCB::NModelEvaluation {
         TArrayRef<ui32> transposedHash,
         TArrayRef<float> ctrs,
         TArrayRef<float> estimatedFeatures,
-        const TFeatureLayout* featureInfo = nullptr
+        const TFeatureLayout* featureInfo = nullptr,
+        // to reuse text processing buffers in several calls
+        TTextProcessingCollection::TCalcFeaturesBuffers* textProcessingBuffers = nullptr
     ) {
         const auto fullDocCount = end - start;
         auto result = *(cpuEvaluatorQuantizedData->QuantizedData);
@@ -360,11 +459,17 @@ namespace NCB::NModelEvaluation {
         cpuEvaluatorQuantizedData->ObjectsCount = fullDocCount;
         ui8* resultPtr = result.data();
         std::fill(result.begin(), result.begin() + expectedQuantizedFeaturesLen, 0);
+        TTextProcessingCollection::TCalcFeaturesBuffers localTextProcessingBuffers;
+        if (!textProcessingBuffers) {
+            textProcessingBuffers = &localTextProcessingBuffers;
+        }
         for (; start < end; start += FORMULA_EVALUATION_BLOCK_SIZE) {
             ui8* resultPtrForBlockStart = resultPtr;
             ++cpuEvaluatorQuantizedData->BlocksCount;
             auto docCount = Min(end - start, FORMULA_EVALUATION_BLOCK_SIZE);
-            for (const auto& floatFeature : trees.GetFloatFeatures()) {
+            const auto floatFeatures = trees.GetFloatFeatures();
+            for (auto floatFeatureIdx : xrange(floatFeatures.size())) {
+                const auto& floatFeature = floatFeatures[floatFeatureIdx];
                 if (!floatFeature.UsedInModel()) {
                     continue;
                 }
@@ -372,9 +477,11 @@ namespace NCB::NModelEvaluation {
                 if (featureInfo) {
                     position = featureInfo->GetRemappedPosition(floatFeature);
                 }
+                const bool useBinarySearch = applyData.FloatFeatureUsesBinarySearch[floatFeatureIdx];
                 if (!floatFeature.HasNans ||
                     floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsIs) {
-                    BinarizeFloats<false>(
+                    BinarizeFloatFeature<false>(
+                        useBinarySearch,
                         position,
                         docCount,
                         floatAccessor,
@@ -385,7 +492,8 @@ namespace NCB::NModelEvaluation {
                 } else {
                     const float infinity = std::numeric_limits<float>::infinity();
                     if (floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsFalse) {
-                        BinarizeFloats<true>(
+                        BinarizeFloatFeature<true>(
+                            useBinarySearch,
                             position,
                             docCount,
                             floatAccessor,
@@ -396,7 +504,8 @@ namespace NCB::NModelEvaluation {
                         );
                     } else {
                         Y_ASSERT(floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue);
-                        BinarizeFloats<true>(
+                        BinarizeFloatFeature<true>(
+                            useBinarySearch,
                             position,
                             docCount,
                             floatAccessor,
@@ -450,6 +559,7 @@ namespace NCB::NModelEvaluation {
                         },
                         MakeConstArrayRef(textFeatureIds),
                         docCount,
+                        textProcessingBuffers,
                         estimatedFeatures
                     );
                 }
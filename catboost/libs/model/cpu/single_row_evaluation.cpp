@@ -0,0 +1,164 @@
+#include "single_row_evaluation.h"
+
+#include <catboost/libs/model/eval_processing.h>
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+#include <util/thread/singleton.h>
+
+#include <cmath>
+#include <limits>
+
+namespace NCB::NModelEvaluation {
+
+    namespace {
+        struct TSingleRowScratch {
+            TVector<ui64> Bits;
+        };
+    }
+
+    TAtomicSharedPtr<TSingleRowEvaluationData> BuildSingleRowEvaluationData(const TModelTrees& trees) {
+        if (!trees.IsOblivious() ||
+            trees.GetTreeCount() == 0 ||
+            !trees.GetCatFeatures().empty() ||
+            !trees.GetOneHotFeatures().empty() ||
+            !trees.GetCtrFeatures().empty() ||
+            !trees.GetTextFeatures().empty() ||
+            !trees.GetEmbeddingFeatures().empty() ||
+            !trees.GetEstimatedFeatures().empty())
+        {
+            return nullptr;
+        }
+        auto result = MakeAtomicShared<TSingleRowEvaluationData>();
+
+        struct TBucketInfo {
+            ui32 FeatureId = 0;
+            ui32 FirstBorder = 0;
+        };
+        TVector<TBucketInfo> buckets;
+        for (const auto& floatFeature : trees.GetFloatFeatures()) {
+            if (!floatFeature.UsedInModel()) {
+                continue;
+            }
+            const ui32 featureId = result->FloatFeatures.size();
+            auto& featureBits = result->FloatFeatures.emplace_back();
+            featureBits.FlatIndex = floatFeature.Position.FlatIndex;
+            if (floatFeature.HasNans && floatFeature.NanValueTreatment != TFloatFeature::ENanValueTreatment::AsIs) {
+                const float infinity = std::numeric_limits<float>::infinity();
+                featureBits.HasNanSubstitution = true;
+                featureBits.NanSubstitution =
+                    floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsFalse ? -infinity : infinity;
+            }
+            for (size_t blockStart = 0; blockStart < floatFeature.Borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+                buckets.push_back({featureId, (ui32)blockStart});
+            }
+        }
+        if (buckets.size() != trees.GetEffectiveBinaryFeaturesBucketsCount()) {
+            return nullptr;
+        }
+
+        // global border indexes used by splits of each feature, only these get bits
+        TVector<TVector<ui32>> usedBorders(result->FloatFeatures.size());
+        const auto repackedBins = trees.GetRepackedBins();
+        for (const auto& bin : repackedBins) {
+            if (bin.XorMask != 0 || bin.SplitIdx == 0 || bin.FeatureIndex >= buckets.size()) {
+                return nullptr;
+            }
+            const auto& bucket = buckets[bin.FeatureIndex];
+            usedBorders[bucket.FeatureId].push_back(bucket.FirstBorder + bin.SplitIdx - 1);
+        }
+        ui32 featureId = 0;
+        for (const auto& floatFeature : trees.GetFloatFeatures()) {
+            if (!floatFeature.UsedInModel()) {
+                continue;
+            }
+            auto& borderIds = usedBorders[featureId];
+            SortUnique(borderIds);
+            auto& featureBits = result->FloatFeatures[featureId];
+            featureBits.BitsBegin = result->BitCount;
+            for (ui32 borderId : borderIds) {
+                result->Borders.push_back(floatFeature.Borders[borderId]);
+            }
+            result->BitCount += borderIds.size();
+            featureBits.BitsEnd = result->BitCount;
+            ++featureId;
+        }
+
+        result->SplitBits.yresize(repackedBins.size());
+        for (size_t splitId = 0; splitId < repackedBins.size(); ++splitId) {
+            const auto& bin = repackedBins[splitId];
+            const auto& bucket = buckets[bin.FeatureIndex];
+            const auto& borderIds = usedBorders[bucket.FeatureId];
+            const ui32 borderId = bucket.FirstBorder + bin.SplitIdx - 1;
+            result->SplitBits[splitId] =
+                result->FloatFeatures[bucket.FeatureId].BitsBegin + (LowerBound(borderIds.begin(), borderIds.end(), borderId) - borderIds.begin());
+        }
+        return result;
+    }
+
+    void CalcSingleRow(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        const TSingleRowEvaluationData& data,
+        TConstArrayRef<float> features,
+        size_t treeStart,
+        size_t treeEnd,
+        EPredictionType predictionType,
+        TArrayRef<double> results
+    ) {
+        const ui32 approxDimension = trees.GetDimensionsCount();
+        CB_ENSURE(
+            predictionType != EPredictionType::Class || approxDimension == 1,
+            "Single row evaluation does not support multiclass Class prediction"
+        );
+        auto& bits = FastTlsSingleton<TSingleRowScratch>()->Bits;
+        bits.resize(CeilDiv<size_t>(data.BitCount, 64));
+        Fill(bits.begin(), bits.end(), 0);
+
+        // borders of a feature are ascending, so a value is greater than a prefix of them
+        const float* bordersPtr = data.Borders.data();
+        for (const auto& feature : data.FloatFeatures) {
+            float value = features[feature.FlatIndex];
+            if (std::isnan(value)) {
+                if (!feature.HasNanSubstitution) {
+                    continue;
+                }
+                value = feature.NanSubstitution;
+            }
+            const ui32 bitsEnd = LowerBound(bordersPtr + feature.BitsBegin, bordersPtr + feature.BitsEnd, value) - bordersPtr;
+            for (ui32 bit = feature.BitsBegin; bit < bitsEnd; ++bit) {
+                bits[bit >> 6] |= ui64(1) << (bit & 63);
+            }
+        }
+
+        Fill(results.begin(), results.end(), 0.0);
+        const auto treeSizes = trees.GetModelTreeData()->GetTreeSizes();
+        const auto treeStartOffsets = trees.GetModelTreeData()->GetTreeStartOffsets();
+        const double* leafValues = trees.GetModelTreeData()->GetLeafValues().data();
+        const ui32* splitBits = data.SplitBits.data();
+        for (size_t treeId = treeStart; treeId < treeEnd; ++treeId) {
+            const ui32* treeSplitBits = splitBits + treeStartOffsets[treeId];
+            const int treeDepth = treeSizes[treeId];
+            size_t leafIdx = 0;
+            for (int depth = 0; depth < treeDepth; ++depth) {
+                const ui32 bit = treeSplitBits[depth];
+                leafIdx |= ((bits[bit >> 6] >> (bit & 63)) & 1) << depth;
+            }
+            const double* treeLeafValues = leafValues + applyData.TreeFirstLeafOffsets[treeId] + leafIdx * approxDimension;
+            for (ui32 dim = 0; dim < approxDimension; ++dim) {
+                results[dim] += treeLeafValues[dim];
+            }
+        }
+        TEvalResultProcessor resultProcessor(
+            1,
+            results,
+            predictionType,
+            trees.GetScaleAndBias(),
+            approxDimension,
+            1
+        );
+        resultProcessor.PostprocessBlock(0, treeStart);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <catboost/libs/model/enums.h>
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NCB::NModelEvaluation {
+
+    /* Precomputed data for allocation free evaluation of one object by oblivious models with float features only.
+     * Each distinct float split of the model is a bit of a per object bitmask, borders of a feature
+     * occupy consecutive bits in ascending order, so quantization sets a prefix of the feature bits.
+     */
+    struct TSingleRowEvaluationData {
+        struct TFloatFeatureBits {
+            ui32 FlatIndex = 0;
+            bool HasNanSubstitution = false;
+            float NanSubstitution = 0.0f;
+            ui32 BitsBegin = 0;
+            ui32 BitsEnd = 0;
+        };
+
+        TVector<TFloatFeatureBits> FloatFeatures;
+        TVector<float> Borders; // border for each bit
+        TVector<ui32> SplitBits; // bit for each split, same layout as TModelTrees::GetRepackedBins()
+        ui32 BitCount = 0;
+    };
+
+    // nullptr if the model uses anything but float features or has non-oblivious trees
+    TAtomicSharedPtr<TSingleRowEvaluationData> BuildSingleRowEvaluationData(const TModelTrees& trees);
+
+    /* Evaluates trees [treeStart, treeEnd) for one object using a thread local bitmask buffer.
+     * Multiclass Class prediction needs an intermediate buffer and is not supported.
+     */
+    void CalcSingleRow(
+        const TModelTrees& trees,
+        const TModelTrees::TForApplyData& applyData,
+        const TSingleRowEvaluationData& data,
+        TConstArrayRef<float> features,
+        size_t treeStart,
+        size_t treeEnd,
+        EPredictionType predictionType,
+        TArrayRef<double> results);
+}
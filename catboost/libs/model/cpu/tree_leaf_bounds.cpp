@@ -0,0 +1,46 @@
+#include "tree_leaf_bounds.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+
+#include <limits>
+
+namespace NCB::NModelEvaluation {
+
+    TAtomicSharedPtr<TTreeLeafBounds> BuildTreeLeafBounds(const TModelTrees& trees) {
+        CB_ENSURE(
+            trees.GetDimensionsCount() == 1,
+            "Leaf value bounds are supported only for models with approx dimension 1"
+        );
+        auto result = MakeAtomicShared<TTreeLeafBounds>();
+        const auto leafValues = trees.GetModelTreeData()->GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetApplyData()->TreeFirstLeafOffsets;
+        const size_t treeCount = trees.GetTreeCount();
+        result->MinPrefixSums.yresize(treeCount + 1);
+        result->MaxPrefixSums.yresize(treeCount + 1);
+        result->MinPrefixSums[0] = 0.0;
+        result->MaxPrefixSums[0] = 0.0;
+        double absSum = 0.0;
+        for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+            const size_t leafBegin = firstLeafOffsets[treeId];
+            const size_t leafEnd = treeId + 1 < treeCount ? firstLeafOffsets[treeId + 1] : leafValues.size();
+            double minValue = std::numeric_limits<double>::max();
+            double maxValue = std::numeric_limits<double>::lowest();
+            for (size_t leafIdx = leafBegin; leafIdx < leafEnd; ++leafIdx) {
+                minValue = Min(minValue, leafValues[leafIdx]);
+                maxValue = Max(maxValue, leafValues[leafIdx]);
+            }
+            if (leafBegin == leafEnd) {
+                minValue = maxValue = 0.0;
+            }
+            result->MinPrefixSums[treeId + 1] = result->MinPrefixSums[treeId] + minValue;
+            result->MaxPrefixSums[treeId + 1] = result->MaxPrefixSums[treeId] + maxValue;
+            absSum += Max(Abs(minValue), Abs(maxValue));
+        }
+        // summation error of n terms is below n * eps * sum |term|, far less than this for any real model
+        result->Slack = 1e-9 * absSum;
+        return result;
+    }
+}
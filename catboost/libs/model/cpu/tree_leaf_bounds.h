@@ -0,0 +1,33 @@
+#pragma once
+
+#include <catboost/libs/model/model.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+
+namespace NCB::NModelEvaluation {
+
+    // Trees evaluated between two checks of early exit bounds
+    constexpr size_t DEFAULT_EARLY_EXIT_STAGE_SIZE = 16;
+
+    /* Range of raw formula values a sequence of trees can add, used to stop evaluation of objects
+     * whose comparison with a border can't change anymore. Only for models with approx dimension 1.
+     */
+    struct TTreeLeafBounds {
+        // prefix sums of per tree minimal and maximal leaf values, tree count + 1 elements
+        TVector<double> MinPrefixSums;
+        TVector<double> MaxPrefixSums;
+        // covers rounding of prefix sums and of accumulation order
+        double Slack = 0.0;
+
+        double GetMin(size_t treeStart, size_t treeEnd) const {
+            return MinPrefixSums[treeEnd] - MinPrefixSums[treeStart] - Slack;
+        }
+
+        double GetMax(size_t treeStart, size_t treeEnd) const {
+            return MaxPrefixSums[treeEnd] - MaxPrefixSums[treeStart] + Slack;
+        }
+    };
+
+    TAtomicSharedPtr<TTreeLeafBounds> BuildTreeLeafBounds(const TModelTrees& trees);
+}
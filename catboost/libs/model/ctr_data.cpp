@@ -3,23 +3,37 @@
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/set.h>
+#include <util/stream/length.h>
 #include <util/stream/mem.h>
 
 
-void TCtrData::Save(IOutputStream* s) const {
-    TCtrDataStreamWriter ctrStreamSerializer(s, LearnCtrs.size());
+static TSet<TModelCtrBase> GetSortedCtrBases(const THashMap<TModelCtrBase, TCtrValueTable>& learnCtrs) {
     TSet<TModelCtrBase> sortedCtrBases;
-    for (const auto& iter : LearnCtrs) {
+    for (const auto& iter : learnCtrs) {
         sortedCtrBases.insert(iter.first);
     }
-    Y_ASSERT(sortedCtrBases.size() == LearnCtrs.size());
-    for (const auto& ctrBase: sortedCtrBases) {
+    Y_ASSERT(sortedCtrBases.size() == learnCtrs.size());
+    return sortedCtrBases;
+}
+
+void TCtrData::Save(IOutputStream* s) const {
+    TCtrDataStreamWriter ctrStreamSerializer(s, LearnCtrs.size());
+    for (const auto& ctrBase: GetSortedCtrBases(LearnCtrs)) {
         const auto& tableRef = LearnCtrs.at(ctrBase);
         CB_ENSURE(ctrBase == tableRef.ModelCtrBase);
         ctrStreamSerializer.SaveOneCtr(tableRef);
     }
 }
 
+void TCtrData::SaveAligned(TCountingOutput* s, size_t arrayAlignment) const {
+    ::SaveSize(s, LearnCtrs.size());
+    for (const auto& ctrBase: GetSortedCtrBases(LearnCtrs)) {
+        const auto& tableRef = LearnCtrs.at(ctrBase);
+        CB_ENSURE(ctrBase == tableRef.ModelCtrBase);
+        tableRef.SaveAligned(s, arrayAlignment);
+    }
+}
+
 void TCtrData::Load(IInputStream* s) {
     const size_t cnt = ::LoadSize(s);
     LearnCtrs.reserve(cnt);
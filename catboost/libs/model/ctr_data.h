@@ -27,6 +27,8 @@ public:
     }
 
     void Save(IOutputStream* s) const;
+    // Tables are written with TCtrValueTable::SaveAligned
+    void SaveAligned(TCountingOutput* s, size_t arrayAlignment) const;
 
     void Load(IInputStream* s);
     void LoadNonOwning(TMemoryInput* in);
@@ -13,6 +13,7 @@
 #include <util/generic/ptr.h>
 #include <util/generic/vector.h>
 #include <util/stream/fwd.h>
+#include <util/stream/length.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
@@ -45,10 +46,21 @@ public:
 
     virtual void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) = 0;
 
+    // Not thread safe with CalcCtrs
+    virtual void SetIndexType(ECtrIndexType indexType) {
+        CB_ENSURE(indexType == ECtrIndexType::Dense, "CTR index type " << indexType << " is not supported by " << ModelPartIdentifier());
+    }
+
     virtual void Save(IOutputStream* ) const {
         CB_ENSURE(false, "Serialization not allowed");
     };
 
+    // Providers without aligned layout fall back to the default one
+    virtual void SaveAligned(TCountingOutput* out, size_t arrayAlignment) const {
+        Y_UNUSED(arrayAlignment);
+        Save(out);
+    }
+
     virtual void Load(IInputStream* ) {
         CB_ENSURE(false, "Deserialization not allowed");
     };
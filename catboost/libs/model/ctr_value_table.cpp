@@ -7,20 +7,31 @@
 #include <util/generic/ptr.h>
 #include <util/stream/mem.h>
 #include <util/stream/input.h>
+#include <util/stream/length.h>
 #include <util/stream/output.h>
 #include <util/system/compiler.h>
 #include <util/ysaveload.h>
 
 
 void TCtrValueTable::Save(IOutputStream* s) const {
+    TModelPartsCachingSerializer serializer;
+    SaveImpl(s, serializer);
+}
+
+void TCtrValueTable::SaveAligned(TCountingOutput* s, size_t arrayAlignment) const {
+    // table buffer follows its ui32 size
+    TModelPartsCachingSerializer serializer(arrayAlignment, s->Counter() + sizeof(ui32));
+    SaveImpl(s, serializer);
+}
+
+void TCtrValueTable::SaveImpl(IOutputStream* s, TModelPartsCachingSerializer& serializer) const {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
-    TModelPartsCachingSerializer serializer;
     if (std::holds_alternative<TSolidTable>(Impl)) {
         auto& solid = std::get<TSolidTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) solid.IndexBuckets.data(),
+        auto indexHashOffset = serializer.CreateAlignedVector((const ui8*) solid.IndexBuckets.data(),
                                                 sizeof(NCatboost::TBucket) * solid.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(solid.CTRBlob);
+        auto ctrBlob = serializer.CreateAlignedVector(solid.CTRBlob.data(), solid.CTRBlob.size());
         auto ctrValueTable = CreateTCtrValueTable(
             serializer.FlatbufBuilder,
             serializer.GetOffset(ModelCtrBase),
@@ -28,12 +39,12 @@ void TCtrValueTable::Save(IOutputStream* s) const {
             ctrBlob,
             CounterDenominator,
             TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
+        serializer.Finish(ctrValueTable);
     } else {
         auto& thin = std::get<TThinTable>(Impl);
-        auto indexHashOffset = serializer.FlatbufBuilder.CreateVector((const ui8*) thin.IndexBuckets.data(),
+        auto indexHashOffset = serializer.CreateAlignedVector((const ui8*) thin.IndexBuckets.data(),
                                                 sizeof(NCatboost::TBucket) * thin.IndexBuckets.size());
-        auto ctrBlob = serializer.FlatbufBuilder.CreateVector(thin.CTRBlob.data(), thin.CTRBlob.size());
+        auto ctrBlob = serializer.CreateAlignedVector(thin.CTRBlob.data(), thin.CTRBlob.size());
         auto ctrValueTable = CreateTCtrValueTable(
             serializer.FlatbufBuilder,
             serializer.GetOffset(ModelCtrBase),
@@ -41,7 +52,7 @@ void TCtrValueTable::Save(IOutputStream* s) const {
             ctrBlob,
             CounterDenominator,
             TargetClassesCount);
-        serializer.FlatbufBuilder.Finish(ctrValueTable);
+        serializer.Finish(ctrValueTable);
     }
     SaveSize(s, serializer.FlatbufBuilder.GetSize());
     s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
@@ -58,6 +69,8 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     Y_UNUSED(length); // TODO(kirillovs): add length validation
     using namespace flatbuffers;
     Impl = TSolidTable();
+    GroupedIndex.Clear();
+    DataOwner.Reset();
     auto& solid = std::get<TSolidTable>(Impl);
     auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
     ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
@@ -77,6 +90,8 @@ void TCtrValueTable::LoadThin(TMemoryInput* in) {
 
     using namespace  flatbuffers;
     Impl = TThinTable();
+    GroupedIndex.Clear();
+    DataOwner.Reset();
     auto& thin = std::get<TThinTable>(Impl);
     auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(ptr);
     ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
@@ -89,3 +104,15 @@ void TCtrValueTable::LoadThin(TMemoryInput* in) {
     );
     thin.CTRBlob = TConstArrayRef<ui8>(ctrValueTable->CTRBlob()->data(), ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::ShareData(TAtomicSharedPtr<const TCtrValueTable> source) {
+    CB_ENSURE_INTERNAL(source->ModelCtrBase == ModelCtrBase, "Shared CTR table has different CTR base");
+    TThinTable thin;
+    thin.IndexBuckets = source->GetIndexHashViewer().GetBuckets();
+    thin.CTRBlob = source->GetTypedArrayRefForBlobData<ui8>();
+    CounterDenominator = source->CounterDenominator;
+    TargetClassesCount = source->TargetClassesCount;
+    // grouped index, if any, was built from equal buckets and stays valid
+    Impl = thin;
+    DataOwner = std::move(source);
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "enums.h"
 #include "online_ctr.h"
 
 #include <catboost/libs/helpers/dense_hash_view.h>
+#include <catboost/libs/helpers/grouped_index_hash.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
 #include <util/generic/variant.h>
 #include <util/generic/vector.h>
 #include <util/stream/fwd.h>
@@ -88,22 +92,54 @@ public:
         }
     }
 
+    //! Whether table data lives as long as the table, i.e. it is not a view of a model buffer
+    bool IsOwning() const {
+        return std::holds_alternative<TSolidTable>(Impl) || DataOwner;
+    }
+
+    /**
+     * Makes the table a view of equal table data kept alive by the shared pointer,
+     * so that models with equal tables can use one copy of them
+     */
+    void ShareData(TAtomicSharedPtr<const TCtrValueTable> source);
+
+    // Grouped index copy of buckets if it was selected by SetIndexType
+    const NCatboost::TGroupedIndexHash* GetGroupedIndex() const {
+        return GroupedIndex.Get();
+    }
+
+    void SetIndexType(ECtrIndexType indexType) {
+        if (indexType == ECtrIndexType::Grouped) {
+            GroupedIndex.ConstructInPlace(GetIndexHashViewer());
+        } else {
+            GroupedIndex.Clear();
+        }
+    }
+
     NCatboost::TDenseIndexHashBuilder GetIndexHashBuilder(size_t uniqueValuesCount) {
+        GroupedIndex.Clear();
         auto& solid = std::get<TSolidTable>(Impl);
         auto bucketCount = NCatboost::TDenseIndexHashBuilder::GetProperBucketsCount(uniqueValuesCount);
         solid.IndexBuckets.resize(bucketCount);
         return NCatboost::TDenseIndexHashBuilder(solid.IndexBuckets);
     }
     void Save(IOutputStream* s) const;
+    // Index buckets and CTR blob start at multiples of arrayAlignment from the counting stream start
+    void SaveAligned(TCountingOutput* s, size_t arrayAlignment) const;
 
     void Load(IInputStream* s);
 
     void LoadSolid(void* buf, size_t length);
     void LoadThin(TMemoryInput* in);
+private:
+    void SaveImpl(IOutputStream* s, TModelPartsCachingSerializer& serializer) const;
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
     int TargetClassesCount = 0;
 private:
     std::variant<TSolidTable, TThinTable> Impl;
+    TMaybe<NCatboost::TGroupedIndexHash> GroupedIndex;
+    //! Owner of data referenced by thin table set by ShareData
+    TAtomicSharedPtr<const TCtrValueTable> DataOwner;
 };
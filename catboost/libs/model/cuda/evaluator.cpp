@@ -5,12 +5,15 @@
 
 #include <catboost/libs/model/cuda/evaluator.cuh>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/ymath.h>
 #include <util/string/cast.h>
 #include <util/system/hp_timer.h>
 
 namespace NCB::NModelEvaluation {
     namespace NDetail {
+        static_assert(TGPUNonSymmetricNode::TerminalFlag == TPackedNonSymmetricNode::TerminalFlag);
+
         class TGpuEvaluator final : public IModelEvaluator {
         public:
             TGpuEvaluator(const TGpuEvaluator& other) = default;
@@ -22,7 +25,6 @@ namespace NCB::NModelEvaluation {
                 CB_ENSURE(!model.HasCategoricalFeatures(), "Model contains categorical features, gpu evaluation impossible");
                 CB_ENSURE(!model.HasTextFeatures(), "Model contains text features, gpu evaluation impossible");
                 CB_ENSURE(!model.HasEmbeddingFeatures(), "Model contains embedding features, gpu evaluation impossible");
-                CB_ENSURE(model.IsOblivious(), "Model is not oblivious, gpu evaluation impossible");
 
                 // TODO(akhropov): Support Multidimensional models
                 CB_ENSURE(ModelTrees->GetDimensionsCount() == 1, "Model is not one-dimensional, GPU evaluation is not supported yet");
@@ -51,6 +53,24 @@ namespace NCB::NModelEvaluation {
                 }
                 Ctx.GPUModelData.FloatFeatureForBucketIdx = TCudaVec<ui32>(floatFeatureForBucketIdx, EMemoryType::Device);
                 Ctx.GPUModelData.TreeSplits = TCudaVec<TGPURepackedBin>(gpuBins, EMemoryType::Device);
+                Ctx.GPUModelData.IsOblivious = model.IsOblivious();
+                if (!Ctx.GPUModelData.IsOblivious) {
+                    TVector<TGPUNonSymmetricNode> gpuNodes;
+                    for (const TPackedNonSymmetricNode& cpuNode : ModelTrees->GetPackedNonSymmetricNodes()) {
+                        gpuNodes.emplace_back(
+                            TGPUNonSymmetricNode{
+                                TGPURepackedBin{ static_cast<ui32>(cpuNode.Split.FeatureIndex * WarpSize), cpuNode.Split.SplitIdx, cpuNode.Split.XorMask },
+                                cpuNode.Next
+                            }
+                        );
+                    }
+                    const auto treeRootsRef = ModelTrees->GetPackedNonSymmetricTreeRoots();
+                    Ctx.GPUModelData.NonSymmetricNodes = TCudaVec<TGPUNonSymmetricNode>(gpuNodes, EMemoryType::Device);
+                    Ctx.GPUModelData.NonSymmetricTreeRoots = TCudaVec<ui32>(
+                        TVector<ui32>(treeRootsRef.begin(), treeRootsRef.end()),
+                        EMemoryType::Device
+                    );
+                }
                 Ctx.GPUModelData.BordersOffsets = TCudaVec<ui32>(bordersOffsets, EMemoryType::Device);
                 Ctx.GPUModelData.BordersCount = TCudaVec<ui32>(bordersCount, EMemoryType::Device);
                 Ctx.GPUModelData.FlatBordersVector = TCudaVec<float>(flatBordersVec, EMemoryType::Device);
@@ -89,8 +109,16 @@ namespace NCB::NModelEvaluation {
             }
 
             void SetProperty(const TStringBuf propName, const TStringBuf propValue) override {
-                {
-                    Y_UNUSED(propValue);
+                if (propName == "PipelineStageCount") {
+                    const auto stageCount = FromString<ui32>(propValue);
+                    PipelineStages.clear();
+                    if (stageCount > 1) {
+                        PipelineStages.resize(stageCount);
+                    }
+                } else if (propName == "PipelineBlockSize") {
+                    PipelineBlockSize = FromString<size_t>(propValue);
+                    CB_ENSURE(PipelineBlockSize > 0, "Pipeline block size should be positive");
+                } else {
                     CB_ENSURE(false, "GPU evaluator don't have property " << propName);
                 }
             }
@@ -196,6 +224,10 @@ namespace NCB::NModelEvaluation {
                 }
                 const size_t docCount = features.size();
                 const size_t stride = CeilDiv<size_t>(expectedFlatVecSize, 32) * 32;
+                if (!PipelineStages.empty() && docCount > PipelineBlockSize) {
+                    CalcFlatPipelined(features, expectedFlatVecSize, results);
+                    return;
+                }
 
                 TGPUDataInput dataInput;
                 dataInput.FloatFeatureLayout = TGPUDataInput::EFeatureLayout::RowFirst;
@@ -371,6 +403,65 @@ namespace NCB::NModelEvaluation {
             Ctx.QuantizeData(dataInput, cudaQuantizedData);
         }
         private:
+            // blocks of features are copied to pinned buffers on host while previous blocks are processed on device
+            void CalcFlatPipelined(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t flatVecSize,
+                TArrayRef<double> results
+            ) const {
+                // results of a previous failed call must not be copied
+                for (auto& stage : PipelineStages) {
+                    stage.Stream.Synchronize();
+                    stage.PendingResults = TArrayRef<double>();
+                }
+                const size_t docCount = features.size();
+                const size_t stride = CeilDiv<size_t>(flatVecSize, 32) * 32;
+                const size_t blockCount = CeilDiv(docCount, PipelineBlockSize);
+                for (size_t blockIdx = 0; blockIdx < blockCount; ++blockIdx) {
+                    auto& stage = PipelineStages[blockIdx % PipelineStages.size()];
+                    FinishPipelineStage(&stage);
+
+                    const size_t blockStart = blockIdx * PipelineBlockSize;
+                    const size_t blockDocCount = Min(PipelineBlockSize, docCount - blockStart);
+                    auto& dataCache = stage.DataCache;
+                    dataCache.PrepareCopyBufs(blockDocCount * stride, blockDocCount);
+                    dataCache.PrepareHostResultsBuf(blockDocCount);
+                    auto copyBufRef = dataCache.CopyDataBufHost.Slice(0, blockDocCount * stride);
+                    for (size_t docId = 0; docId < blockDocCount; ++docId) {
+                        memcpy(&copyBufRef[docId * stride], features[blockStart + docId].data(), sizeof(float) * flatVecSize);
+                    }
+                    MemoryCopyAsync<float>(copyBufRef, dataCache.CopyDataBufDevice.Slice(0, blockDocCount * stride), stage.Stream);
+
+                    TGPUDataInput dataInput;
+                    dataInput.FloatFeatureLayout = TGPUDataInput::EFeatureLayout::RowFirst;
+                    dataInput.ObjectCount = blockDocCount;
+                    dataInput.FloatFeatureCount = flatVecSize;
+                    dataInput.Stride = stride;
+                    dataInput.FlatFloatsVector = dataCache.CopyDataBufDevice.AsArrayRef();
+                    Ctx.EvalDataAsync(
+                        dataInput,
+                        dataCache.ResultsDoubleBufHost.Slice(0, blockDocCount),
+                        PredictionType,
+                        stage.Stream,
+                        &dataCache
+                    );
+                    stage.PendingResults = results.Slice(blockStart, blockDocCount);
+                }
+                for (auto& stage : PipelineStages) {
+                    FinishPipelineStage(&stage);
+                }
+            }
+
+            static void FinishPipelineStage(TEvaluationPipelineStage* stage) {
+                if (stage->PendingResults.empty()) {
+                    return;
+                }
+                stage->Stream.Synchronize();
+                const auto hostResults = stage->DataCache.ResultsDoubleBufHost.Slice(0, stage->PendingResults.size());
+                Copy(hostResults.begin(), hostResults.end(), stage->PendingResults.begin());
+                stage->PendingResults = TArrayRef<double>();
+            }
+
             template <typename TCatFeatureContainer = TConstArrayRef<int>>
             void ValidateInputFeatures(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
@@ -409,6 +500,8 @@ namespace NCB::NModelEvaluation {
             TAtomicSharedPtr<TModelTrees::TForApplyData> ApplyData;
             TMaybe<TFeatureLayout> ExtFeatureLayout;
             TGPUCatboostEvaluationContext Ctx;
+            size_t PipelineBlockSize = 1 << 16;
+            mutable TVector<TEvaluationPipelineStage> PipelineStages; // pipelining is disabled if empty
         };
     }
 
@@ -80,6 +80,12 @@ void TEvaluationDataCache::PrepareCopyBufs(size_t bufSize, size_t objectsCount)
     }
 }
 
+void TEvaluationDataCache::PrepareHostResultsBuf(size_t objectsCount) {
+    if (ResultsDoubleBufHost.Size() < objectsCount) {
+        ResultsDoubleBufHost = TCudaVec<double>(AlignBy<2048>(objectsCount), EMemoryType::Host);
+    }
+}
+
 template<typename TFloatFeatureAccessor>
 __launch_bounds__(QuantizationDocBlockSize, 1)
 __global__ void Binarize(
@@ -168,6 +174,36 @@ TTreeIndex __device__ __forceinline__ CalcTreeVals(int curTreeDepth, const TGPUR
     }
 }
 
+__device__ __forceinline__ void AddThreadResults(
+    const double4& localResult,
+    const int innerBlockBy32,
+    const int inBlockId,
+    const int blockby32,
+    TCudaEvaluatorLeafType* __restrict__ results) {
+
+    // TODO(kirillovs): reduce code is valid if those conditions met
+    static_assert(EvalDocBlockSize * ObjectsPerThread == 128, "");
+    static_assert(EvalDocBlockSize == 32, "");
+    __shared__ TCudaEvaluatorLeafType reduceVals[EvalDocBlockSize * ObjectsPerThread * TreeSubBlockWidth];
+    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 0 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.x;
+    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 1 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.y;
+    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 2 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.z;
+    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 3 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.w;
+    __syncthreads();
+    TCudaEvaluatorLeafType lr = reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize];
+    for (int i = 256; i < 256 * 4; i += 256) {
+        lr += reduceVals[i + threadIdx.x + threadIdx.y * EvalDocBlockSize];
+    }
+    reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize] = lr;
+    __syncthreads();
+    if (threadIdx.y < ObjectsPerThread) {
+        TAtomicAdd<TCudaEvaluatorLeafType>::Add(
+            results + blockby32 * WarpSize * ObjectsPerThread + threadIdx.x + threadIdx.y * EvalDocBlockSize,
+            reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize] + reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize + 128]
+        );
+    }
+}
+
 __launch_bounds__(BlockWidth, 1)
 __global__ void EvalObliviousTrees(
     const TCudaQuantizationBucket* __restrict__ quantizedFeatures,
@@ -222,27 +258,76 @@ __global__ void EvalObliviousTrees(
             leafValues += (1 << curTreeDepth);
         }
     }
-    // TODO(kirillovs): reduce code is valid if those conditions met
-    static_assert(EvalDocBlockSize * ObjectsPerThread == 128, "");
-    static_assert(EvalDocBlockSize == 32, "");
-    __shared__ TCudaEvaluatorLeafType reduceVals[EvalDocBlockSize * ObjectsPerThread * TreeSubBlockWidth];
-    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 0 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.x;
-    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 1 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.y;
-    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 2 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.z;
-    reduceVals[innerBlockBy32 * WarpSize * ObjectsPerThread + WarpSize * 3 + inBlockId + threadIdx.y * EvalDocBlockSize * ObjectsPerThread] = localResult.w;
-    __syncthreads();
-    TCudaEvaluatorLeafType lr = reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize];
-    for (int i = 256; i < 256 * 4; i += 256) {
-        lr += reduceVals[i + threadIdx.x + threadIdx.y * EvalDocBlockSize];
+    AddThreadResults(localResult, innerBlockBy32, inBlockId, blockby32, results);
+}
+
+__device__ __forceinline__ ui32 NonSymmetricChildSlot(const TGPUNonSymmetricNode& node, ui32 slot, ui8 bucket) {
+    const bool isInner = !(node.Next & TGPUNonSymmetricNode::TerminalFlag);
+    return isInner ? node.Next + (bucket >= node.Split.FeatureVal) : slot;
+}
+
+/* All four documents of a thread descend in lockstep, finished ones stay at their terminal nodes.
+ * Terminal nodes carry a zero split, so their loads of quantized features stay in bounds.
+ */
+__device__ __forceinline__ uint4 CalcNonSymmetricLeafOffsets(
+    const TGPUNonSymmetricNode* const __restrict__ nodes,
+    const ui32 rootSlot,
+    const TCudaQuantizationBucket* const __restrict__ quantizedFeatures) {
+
+    uint4 slots = make_uint4(rootSlot, rootSlot, rootSlot, rootSlot);
+    TGPUNonSymmetricNode nodeX = Ldg(nodes + rootSlot);
+    TGPUNonSymmetricNode nodeY = nodeX;
+    TGPUNonSymmetricNode nodeZ = nodeX;
+    TGPUNonSymmetricNode nodeW = nodeX;
+    while (!(nodeX.Next & nodeY.Next & nodeZ.Next & nodeW.Next & TGPUNonSymmetricNode::TerminalFlag)) {
+        slots.x = NonSymmetricChildSlot(nodeX, slots.x, __ldg(quantizedFeatures + nodeX.Split.FeatureIdx).x);
+        slots.y = NonSymmetricChildSlot(nodeY, slots.y, __ldg(quantizedFeatures + nodeY.Split.FeatureIdx).y);
+        slots.z = NonSymmetricChildSlot(nodeZ, slots.z, __ldg(quantizedFeatures + nodeZ.Split.FeatureIdx).z);
+        slots.w = NonSymmetricChildSlot(nodeW, slots.w, __ldg(quantizedFeatures + nodeW.Split.FeatureIdx).w);
+        nodeX = Ldg(nodes + slots.x);
+        nodeY = Ldg(nodes + slots.y);
+        nodeZ = Ldg(nodes + slots.z);
+        nodeW = Ldg(nodes + slots.w);
     }
-    reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize] = lr;
-    __syncthreads();
-    if (threadIdx.y < ObjectsPerThread) {
-        TAtomicAdd<TCudaEvaluatorLeafType>::Add(
-            results + blockby32 * WarpSize * ObjectsPerThread + threadIdx.x + threadIdx.y * EvalDocBlockSize,
-            reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize] + reduceVals[threadIdx.x + threadIdx.y * EvalDocBlockSize + 128]
-        );
+    return make_uint4(
+        nodeX.Next & ~TGPUNonSymmetricNode::TerminalFlag,
+        nodeY.Next & ~TGPUNonSymmetricNode::TerminalFlag,
+        nodeZ.Next & ~TGPUNonSymmetricNode::TerminalFlag,
+        nodeW.Next & ~TGPUNonSymmetricNode::TerminalFlag);
+}
+
+__launch_bounds__(BlockWidth, 1)
+__global__ void EvalNonSymmetricTrees(
+    const TCudaQuantizationBucket* __restrict__ quantizedFeatures,
+    const ui32 treeCount,
+    const ui32* __restrict__ treeRoots,
+    const TGPUNonSymmetricNode* __restrict__ nodes,
+    const ui32 bucketsCount,
+    const TCudaEvaluatorLeafType* __restrict__ leafValues,
+    const ui32 documentCount,
+    TCudaEvaluatorLeafType* __restrict__ results) {
+
+    const int innerBlockBy32 = threadIdx.x / WarpSize;
+    const int blockby32 = blockIdx.y * EvalDocBlockSize / WarpSize + innerBlockBy32;
+    const int inBlockId = threadIdx.x % WarpSize;
+    const int firstDocForThread = blockby32 * WarpSize * ObjectsPerThread + inBlockId;
+
+    quantizedFeatures += bucketsCount * WarpSize * blockby32 + threadIdx.x % WarpSize;
+
+    const int firstTreeIdx = TreeSubBlockWidth * ExtTreeBlockWidth * (threadIdx.y + TreeSubBlockWidth * blockIdx.x);
+    const int lastTreeIdx = min(firstTreeIdx + TreeSubBlockWidth * ExtTreeBlockWidth, treeCount);
+    double4 localResult = { 0 };
+
+    if (firstTreeIdx < lastTreeIdx && firstDocForThread < documentCount) {
+        for (int treeIdx = firstTreeIdx; treeIdx < lastTreeIdx; ++treeIdx) {
+            const uint4 leafOffsets = CalcNonSymmetricLeafOffsets(nodes, __ldg(treeRoots + treeIdx), quantizedFeatures);
+            localResult.x += __ldg(leafValues + leafOffsets.x);
+            localResult.y += __ldg(leafValues + leafOffsets.y);
+            localResult.z += __ldg(leafValues + leafOffsets.z);
+            localResult.w += __ldg(leafValues + leafOffsets.w);
+        }
     }
+    AddThreadResults(localResult, innerBlockBy32, inBlockId, blockby32, results);
 }
 
 template<NCB::NModelEvaluation::EPredictionType PredictionType, bool OneDimension>
@@ -297,19 +382,21 @@ __global__ void ProcessResultsImpl(
 
 template<bool OneDimension>
 void ProcessResults(
-    const TGPUCatboostEvaluationContext& ctx,
+    const TGPUModelData& modelData,
+    TEvaluationDataCache* dataCache,
+    TCudaStream stream,
     NCB::NModelEvaluation::EPredictionType predictionType,
     size_t objectsCount) {
 
     switch (predictionType) {
         case NCB::NModelEvaluation::EPredictionType::RawFormulaVal:
-            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::RawFormulaVal, OneDimension><<<1, 256, 0, ctx.Stream>>> (
-                ctx.EvalDataCache.ResultsFloatBuf.Get(),
+            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::RawFormulaVal, OneDimension><<<1, 256, 0, stream>>> (
+                dataCache->ResultsFloatBuf.Get(),
                 objectsCount,
-                ctx.GPUModelData.Bias.Get(),
-                ctx.GPUModelData.Scale,
-                ctx.EvalDataCache.ResultsDoubleBuf.Get(),
-                ctx.GPUModelData.ApproxDimension
+                modelData.Bias.Get(),
+                modelData.Scale,
+                dataCache->ResultsDoubleBuf.Get(),
+                modelData.ApproxDimension
             );
             break;
         case NCB::NModelEvaluation::EPredictionType::Exponent:
@@ -318,65 +405,90 @@ void ProcessResults(
             ythrow yexception() << "Unimplemented on GPU: prediction type " << ToString(predictionType);
             break;
         case NCB::NModelEvaluation::EPredictionType::Probability:
-            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::Probability, OneDimension><<<1, 256, 0, ctx.Stream>>> (
-                ctx.EvalDataCache.ResultsFloatBuf.Get(),
+            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::Probability, OneDimension><<<1, 256, 0, stream>>> (
+                dataCache->ResultsFloatBuf.Get(),
                 objectsCount,
-                ctx.GPUModelData.Bias.Get(),
-                ctx.GPUModelData.Scale,
-                ctx.EvalDataCache.ResultsDoubleBuf.Get(),
-                ctx.GPUModelData.ApproxDimension
+                modelData.Bias.Get(),
+                modelData.Scale,
+                dataCache->ResultsDoubleBuf.Get(),
+                modelData.ApproxDimension
             );
             break;
         case NCB::NModelEvaluation::EPredictionType::Class:
-            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::Class, OneDimension><<<1, 256, 0, ctx.Stream>>> (
-                ctx.EvalDataCache.ResultsFloatBuf.Get(),
+            ProcessResultsImpl<NCB::NModelEvaluation::EPredictionType::Class, OneDimension><<<1, 256, 0, stream>>> (
+                dataCache->ResultsFloatBuf.Get(),
                 objectsCount,
-                ctx.GPUModelData.Bias.Get(),
-                ctx.GPUModelData.Scale,
-                ctx.EvalDataCache.ResultsDoubleBuf.Get(),
-                ctx.GPUModelData.ApproxDimension
+                modelData.Bias.Get(),
+                modelData.Scale,
+                dataCache->ResultsDoubleBuf.Get(),
+                modelData.ApproxDimension
             );
             break;
     }
 }
 
 
-void TGPUCatboostEvaluationContext::EvalQuantizedData(
+void TGPUCatboostEvaluationContext::EvalQuantizedDataOnStream(
     const TCudaQuantizedData* data,
-    size_t treeStart,
-    size_t treeEnd,
-    TArrayRef<double> result,
-    NCB::NModelEvaluation::EPredictionType predictionType
+    NCB::NModelEvaluation::EPredictionType predictionType,
+    TCudaStream stream,
+    TEvaluationDataCache* dataCache
     ) const {
     const dim3 treeCalcDimBlock(EvalDocBlockSize, TreeSubBlockWidth);
     const dim3 treeCalcDimGrid(
         NKernel::CeilDivide<unsigned int>(GPUModelData.TreeSizes.Size(), TreeSubBlockWidth * ExtTreeBlockWidth),
         NKernel::CeilDivide<unsigned int>(data->GetObjectsCount(), EvalDocBlockSize * ObjectsPerThread)
     );
-    ClearMemoryAsync(EvalDataCache.ResultsFloatBuf.AsArrayRef(), Stream);
-    EvalObliviousTrees<<<treeCalcDimGrid, treeCalcDimBlock, 0, Stream>>> (
-        data->BinarizedFeaturesBuffer.Get(),
-        GPUModelData.TreeSizes.Get(),
-        GPUModelData.TreeSizes.Size(),
-        GPUModelData.TreeStartOffsets.Get(),
-        GPUModelData.TreeSplits.Get(),
-        GPUModelData.TreeFirstLeafOffsets.Get(),
-        GPUModelData.FloatFeatureForBucketIdx.Size(),
-        GPUModelData.ModelLeafs.Get(),
-        data->GetObjectsCount(),
-        EvalDataCache.ResultsFloatBuf.Get()
-    );
+    ClearMemoryAsync(dataCache->ResultsFloatBuf.AsArrayRef(), stream);
+    if (GPUModelData.IsOblivious) {
+        EvalObliviousTrees<<<treeCalcDimGrid, treeCalcDimBlock, 0, stream>>> (
+            data->BinarizedFeaturesBuffer.Get(),
+            GPUModelData.TreeSizes.Get(),
+            GPUModelData.TreeSizes.Size(),
+            GPUModelData.TreeStartOffsets.Get(),
+            GPUModelData.TreeSplits.Get(),
+            GPUModelData.TreeFirstLeafOffsets.Get(),
+            GPUModelData.FloatFeatureForBucketIdx.Size(),
+            GPUModelData.ModelLeafs.Get(),
+            data->GetObjectsCount(),
+            dataCache->ResultsFloatBuf.Get()
+        );
+    } else {
+        EvalNonSymmetricTrees<<<treeCalcDimGrid, treeCalcDimBlock, 0, stream>>> (
+            data->BinarizedFeaturesBuffer.Get(),
+            GPUModelData.NonSymmetricTreeRoots.Size(),
+            GPUModelData.NonSymmetricTreeRoots.Get(),
+            GPUModelData.NonSymmetricNodes.Get(),
+            GPUModelData.FloatFeatureForBucketIdx.Size(),
+            GPUModelData.ModelLeafs.Get(),
+            data->GetObjectsCount(),
+            dataCache->ResultsFloatBuf.Get()
+        );
+    }
 
     if (GPUModelData.ApproxDimension == 1) {
-        ProcessResults<true>(*this, predictionType, data->GetObjectsCount());
+        ProcessResults<true>(GPUModelData, dataCache, stream, predictionType, data->GetObjectsCount());
     } else {
-        ProcessResults<false>(*this, predictionType, data->GetObjectsCount());
+        ProcessResults<false>(GPUModelData, dataCache, stream, predictionType, data->GetObjectsCount());
     }
 
+}
+
+void TGPUCatboostEvaluationContext::EvalQuantizedData(
+    const TCudaQuantizedData* data,
+    size_t treeStart,
+    size_t treeEnd,
+    TArrayRef<double> result,
+    NCB::NModelEvaluation::EPredictionType predictionType
+    ) const {
+    EvalQuantizedDataOnStream(data, predictionType, Stream, &EvalDataCache);
     MemoryCopyAsync<double>(EvalDataCache.ResultsDoubleBuf.Slice(0, data->GetObjectsCount()), result, Stream);
 }
 
-void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput, TCudaQuantizedData* quantizedData) const{
+void TGPUCatboostEvaluationContext::QuantizeDataOnStream(
+    const TGPUDataInput& dataInput,
+    TCudaQuantizedData* quantizedData,
+    TCudaStream stream) const {
     const dim3 quantizationDimBlock(QuantizationDocBlockSize, 1);
     const dim3 quantizationDimGrid(
         NKernel::CeilDivide<unsigned int>(dataInput.ObjectCount, QuantizationDocBlockSize * ObjectsPerThread),
@@ -388,7 +500,7 @@ void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput,
         floatFeatureAccessor.Stride = dataInput.Stride;
         floatFeatureAccessor.ObjectCount = dataInput.ObjectCount;
         floatFeatureAccessor.FeaturesPtr = dataInput.FlatFloatsVector.data();
-        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, Stream>>> (
+        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, stream>>> (
             floatFeatureAccessor,
             GPUModelData.FlatBordersVector.Get(),
             GPUModelData.BordersOffsets.Get(),
@@ -403,7 +515,7 @@ void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput,
         floatFeatureAccessor.ObjectCount = dataInput.ObjectCount;
         floatFeatureAccessor.Stride = dataInput.Stride;
         floatFeatureAccessor.FeaturesPtr = dataInput.FlatFloatsVector.data();
-        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, Stream>>> (
+        Binarize<<<quantizationDimGrid, quantizationDimBlock, 0, stream>>> (
             floatFeatureAccessor,
             GPUModelData.FlatBordersVector.Get(),
             GPUModelData.BordersOffsets.Get(),
@@ -415,6 +527,10 @@ void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput,
     }
 }
 
+void TGPUCatboostEvaluationContext::QuantizeData(const TGPUDataInput& dataInput, TCudaQuantizedData* quantizedData) const{
+    QuantizeDataOnStream(dataInput, quantizedData, Stream);
+}
+
 void TGPUCatboostEvaluationContext::EvalData(
     const TGPUDataInput& dataInput,
     size_t treeStart,
@@ -426,3 +542,16 @@ void TGPUCatboostEvaluationContext::EvalData(
     QuantizeData(dataInput, &quantizedData);
     EvalQuantizedData(&quantizedData, treeStart, treeEnd, result, predictionType);
 }
+
+void TGPUCatboostEvaluationContext::EvalDataAsync(
+    const TGPUDataInput& dataInput,
+    TArrayRef<double> result,
+    NCB::NModelEvaluation::EPredictionType predictionType,
+    TCudaStream stream,
+    TEvaluationDataCache* dataCache) const {
+    auto& quantizedData = dataCache->QuantizedData;
+    quantizedData.SetDimensions(GPUModelData.FloatFeatureForBucketIdx.Size(), dataInput.ObjectCount);
+    QuantizeDataOnStream(dataInput, &quantizedData, stream);
+    EvalQuantizedDataOnStream(&quantizedData, predictionType, stream, dataCache);
+    MemoryCopyAsync<double>(dataCache->ResultsDoubleBuf.Slice(0, dataInput.ObjectCount), result, stream);
+}
@@ -14,6 +14,14 @@ struct TGPURepackedBin {
     ui8 FeatureXorMask = 0;
 };
 
+// device copy of TPackedNonSymmetricNode, Split.FeatureIdx is an offset in quantized features as in TreeSplits
+struct TGPUNonSymmetricNode {
+    static constexpr ui32 TerminalFlag = 1u << 31;
+
+    TGPURepackedBin Split;
+    ui32 Next = TerminalFlag;
+};
+
 using TCudaEvaluatorLeafType = float;
 using TCudaQuantizationBucket = uchar4;
 
@@ -27,6 +35,11 @@ struct TGPUModelData : public TThrRefBase {
     TCudaVec<ui32> TreeStartOffsets;
     TCudaVec<ui32> TreeFirstLeafOffsets;
 
+    // used instead of TreeSplits for non symmetric trees
+    bool IsOblivious = true;
+    TCudaVec<TGPUNonSymmetricNode> NonSymmetricNodes;
+    TCudaVec<ui32> NonSymmetricTreeRoots;
+
     TCudaVec<TCudaEvaluatorLeafType> ModelLeafs;
     TCudaVec<ui32> FloatFeatureForBucketIdx;
     TVector<bool> UsedInModel;
@@ -71,8 +84,24 @@ public:
     TCudaVec<float> CopyDataBufDevice;
     TCudaVec<float> ResultsFloatBuf;
     TCudaVec<double> ResultsDoubleBuf;
+
+    // used by pipelined evaluation only
+    TCudaVec<double> ResultsDoubleBufHost;
+    TCudaQuantizedData QuantizedData;
 public:
     void PrepareCopyBufs(size_t bufSize, size_t objectsCount);
+    void PrepareHostResultsBuf(size_t objectsCount);
+};
+
+/* Pipelined evaluation splits a batch into blocks and cycles them over several stages,
+ * so that host to device copy, evaluation and device to host copy of different blocks overlap.
+ */
+struct TEvaluationPipelineStage {
+    TCudaStream Stream = TCudaStream::NewStream();
+    TEvaluationDataCache DataCache;
+
+    // block of the caller's results waiting for DataCache.ResultsDoubleBufHost
+    TArrayRef<double> PendingResults;
 };
 
 class TGPUCatboostEvaluationContext {
@@ -94,4 +123,23 @@ public:
         size_t treeEnd,
         TArrayRef<double> result,
         NCB::NModelEvaluation::EPredictionType predictionType) const;
+
+    // does not wait for completion, result should be in pinned host memory to get copied asynchronously
+    void EvalDataAsync(
+        const TGPUDataInput& dataInput,
+        TArrayRef<double> result,
+        NCB::NModelEvaluation::EPredictionType predictionType,
+        TCudaStream stream,
+        TEvaluationDataCache* dataCache) const;
+
+private:
+    void QuantizeDataOnStream(
+        const TGPUDataInput& dataInput,
+        TCudaQuantizedData* quantizedData,
+        TCudaStream stream) const;
+    void EvalQuantizedDataOnStream(
+        const TCudaQuantizedData* data,
+        NCB::NModelEvaluation::EPredictionType predictionType,
+        TCudaStream stream,
+        TEvaluationDataCache* dataCache) const;
 };
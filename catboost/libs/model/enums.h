@@ -13,9 +13,16 @@ namespace NCB { // split due to CUDA-compiler inability to support nested namesp
     }
 }
 
+// Index used to find CTR values of categorical feature combination hashes at evaluation
+enum class ECtrIndexType {
+    Dense   /* "Dense" */,   // linear probing over serialized buckets
+    Grouped /* "Grouped" */  // groups of 16 slots with SIMD tag match and batch prefetch, for large tables
+};
+
 enum class EFormulaEvaluatorType {
     CPU,
-    GPU
+    GPU,
+    CompiledCPU // CPU with oblivious trees regrouped by depth at load time, other models fall back to CPU
 };
 
 // TODO(kirillovs): move inside NCB namespace
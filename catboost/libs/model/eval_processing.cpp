@@ -6,7 +6,7 @@ NCB::NModelEvaluation::TEvalResultProcessor::TEvalResultProcessor(
     size_t docCount,
     TArrayRef<double> results,
     NCB::NModelEvaluation::EPredictionType predictionType,
-    TScaleAndBias scaleAndBias,
+    const TScaleAndBias& scaleAndBias,
     ui32 approxDimension,
     ui32 blockSize,
     TMaybe<double> binclassProbabilityBorder
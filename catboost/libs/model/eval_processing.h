@@ -148,7 +148,7 @@ namespace NCB::NModelEvaluation {
             size_t docCount,
             TArrayRef<double> results,
             EPredictionType predictionType,
-            TScaleAndBias scaleAndBias,
+            const TScaleAndBias& scaleAndBias,
             ui32 approxDimension,
             ui32 blockSize,
             TMaybe<double> binclassProbabilityBorder = Nothing()
@@ -242,7 +242,8 @@ namespace NCB::NModelEvaluation {
     private:
         TArrayRef<double> Results;
         EPredictionType PredictionType;
-        TScaleAndBias ScaleAndBias;
+        // not copied to keep evaluation free of allocations, owned by model trees
+        const TScaleAndBias& ScaleAndBias;
         ui32 ApproxDimension;
         ui32 BlockSize;
 
@@ -1,5 +1,6 @@
 #include "evaluation_interface.h"
 
+#include <util/stream/labeled.h>
 #include <util/system/yassert.h>
 
 namespace NCB::NModelEvaluation {
@@ -12,4 +13,25 @@ namespace NCB::NModelEvaluation {
         Y_ASSERT(evaluatorRawPtr);
         return TModelEvaluatorPtr(evaluatorRawPtr);
     }
+
+    void IModelEvaluator::CalcFlatWithBorder(
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        double border,
+        TArrayRef<double> results,
+        const TFeatureLayout* featureInfo
+    ) const {
+        CB_ENSURE(GetApproxDimension() == 1, "Evaluation with border is supported only for approx dimension 1");
+        CB_ENSURE(
+            results.size() == features.size(),
+            "`results` size is insufficient: " << LabeledOutput(results.size(), features.size())
+        );
+        auto rawEvaluator = Clone();
+        rawEvaluator->SetPredictionType(EPredictionType::RawFormulaVal);
+        rawEvaluator->CalcFlat(features, treeStart, treeEnd, results, featureInfo);
+        for (auto& value : results) {
+            value = value > border;
+        }
+    }
 }
@@ -2,6 +2,7 @@
 
 #include "fwd.h"
 
+#include "evaluation_stats.h"
 #include "features.h"
 
 #include <catboost/libs/helpers/exception.h>
@@ -83,6 +84,11 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
 
             virtual void SetProperty(const TStringBuf propName, const TStringBuf propValue) = 0;
 
+            // Nothing if the evaluator does not collect stats (see "EvaluationStats" property of CPU evaluator)
+            virtual TMaybe<TEvaluationStats> GetEvaluationStats() const {
+                return Nothing();
+            }
+
             i32 GetPredictionDimensions() const {
                 switch (GetPredictionType())
                 {
@@ -170,6 +176,30 @@ namespace NCB {  // split due to CUDA-compiler inability to parse nested namespa
                 CalcFlatSingle(features, 0, GetTreeCount(), results, featureInfo);
             }
 
+            /**
+             * Set results to 1 for objects with RawFormulaVal of trees [treeStart, treeEnd) greater than border
+             * and to 0 otherwise, regardless of prediction type. Only for models with approx dimension 1.
+             * Implementations may stop evaluating an object as soon as the remaining trees can't change its result,
+             * the default one evaluates all trees.
+             */
+            virtual void CalcFlatWithBorder(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                size_t treeStart,
+                size_t treeEnd,
+                double border,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const;
+
+            void CalcFlatWithBorder(
+                TConstArrayRef<TConstArrayRef<float>> features,
+                double border,
+                TArrayRef<double> results,
+                const TFeatureLayout* featureInfo = nullptr
+            ) const {
+                CalcFlatWithBorder(features, 0, GetTreeCount(), border, results, featureInfo);
+            }
+
             virtual void Calc(
                 TConstArrayRef<TConstArrayRef<float>> floatFeatures,
                 TConstArrayRef<TConstArrayRef<int>> catFeatures,
@@ -0,0 +1,51 @@
+#include "evaluation_stats.h"
+
+#include <util/digest/numeric.h>
+#include <util/generic/bitops.h>
+#include <util/generic/utility.h>
+#include <util/system/thread.h>
+
+namespace NCB::NModelEvaluation {
+    TEvaluationStatsCounters::TEvaluationStatsCounters() {
+        for (auto& shard : Shards) {
+            shard.CallCount.store(0, std::memory_order_relaxed);
+            shard.ObjectCount.store(0, std::memory_order_relaxed);
+            for (auto& bucket : shard.BatchSizeHistogram) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            shard.TotalMicroSeconds.store(0, std::memory_order_relaxed);
+            shard.TreesMicroSeconds.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void TEvaluationStatsCounters::AddCall(size_t objectCount, TDuration totalTime, TDuration treesTime) {
+        // thread ids are often aligned addresses, so they are hashed
+        auto& shard = Shards[IntHash<ui64>(TThread::CurrentThreadId()) % ShardCount];
+        const size_t bucket = objectCount
+            ? Min<size_t>(GetValueBitCount(objectCount) - 1, TEvaluationStats::BatchSizeBucketCount - 1)
+            : 0;
+        shard.CallCount.fetch_add(1, std::memory_order_relaxed);
+        shard.ObjectCount.fetch_add(objectCount, std::memory_order_relaxed);
+        shard.BatchSizeHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.TotalMicroSeconds.fetch_add(totalTime.MicroSeconds(), std::memory_order_relaxed);
+        shard.TreesMicroSeconds.fetch_add(treesTime.MicroSeconds(), std::memory_order_relaxed);
+    }
+
+    TEvaluationStats TEvaluationStatsCounters::GetStats() const {
+        TEvaluationStats stats;
+        ui64 totalMicroSeconds = 0;
+        ui64 treesMicroSeconds = 0;
+        for (const auto& shard : Shards) {
+            stats.CallCount += shard.CallCount.load(std::memory_order_relaxed);
+            stats.ObjectCount += shard.ObjectCount.load(std::memory_order_relaxed);
+            for (size_t bucket = 0; bucket < TEvaluationStats::BatchSizeBucketCount; ++bucket) {
+                stats.BatchSizeHistogram[bucket] += shard.BatchSizeHistogram[bucket].load(std::memory_order_relaxed);
+            }
+            totalMicroSeconds += shard.TotalMicroSeconds.load(std::memory_order_relaxed);
+            treesMicroSeconds += shard.TreesMicroSeconds.load(std::memory_order_relaxed);
+        }
+        stats.TotalTime = TDuration::MicroSeconds(totalMicroSeconds);
+        stats.TreesTime = TDuration::MicroSeconds(treesMicroSeconds);
+        return stats;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <util/datetime/base.h>
+#include <util/generic/ptr.h>
+#include <util/system/types.h>
+
+#include <array>
+#include <atomic>
+
+namespace NCB::NModelEvaluation {
+
+    // Totals of evaluation calls of an evaluator with enabled "EvaluationStats" property
+    struct TEvaluationStats {
+        // bucket i counts calls with object count in [2^i, 2^(i+1)), the last bucket is unbounded
+        static constexpr size_t BatchSizeBucketCount = 16;
+
+    public:
+        ui64 CallCount = 0;
+        ui64 ObjectCount = 0;
+        std::array<ui64, BatchSizeBucketCount> BatchSizeHistogram = {};
+        TDuration TotalTime;
+        // the rest of the total time is spent in quantization of features and computation of CTRs
+        TDuration TreesTime;
+    };
+
+    /* Relaxed atomic counters sharded by thread: each shard is on its own cache line, so concurrent
+     * evaluation calls from different threads do not contend. Totals are summed over shards on read.
+     */
+    class TEvaluationStatsCounters : public TThrRefBase {
+    public:
+        TEvaluationStatsCounters();
+
+        void AddCall(size_t objectCount, TDuration totalTime, TDuration treesTime);
+
+        TEvaluationStats GetStats() const;
+
+    private:
+        static constexpr size_t ShardCount = 16;
+
+        struct alignas(64) TShard {
+            std::atomic<ui64> CallCount;
+            std::atomic<ui64> ObjectCount;
+            std::array<std::atomic<ui64>, TEvaluationStats::BatchSizeBucketCount> BatchSizeHistogram;
+            std::atomic<ui64> TotalMicroSeconds;
+            std::atomic<ui64> TreesMicroSeconds;
+        };
+
+    private:
+        std::array<TShard, ShardCount> Shards;
+    };
+
+    // Measures one evaluation call, does nothing if counters are nullptr
+    class TEvaluationCallTimer {
+    public:
+        TEvaluationCallTimer(TEvaluationStatsCounters* counters, size_t objectCount)
+            : Counters(counters)
+            , ObjectCount(objectCount)
+            , StartTime(counters ? TInstant::Now() : TInstant())
+        {
+        }
+
+        ~TEvaluationCallTimer() {
+            if (Counters) {
+                Counters->AddCall(ObjectCount, TInstant::Now() - StartTime, TreesTime);
+            }
+        }
+
+        template <class TCalcTrees>
+        void TimeTrees(TCalcTrees&& calcTrees) {
+            if (!Counters) {
+                calcTrees();
+                return;
+            }
+            const TInstant treesStartTime = TInstant::Now();
+            calcTrees();
+            TreesTime += TInstant::Now() - treesStartTime;
+        }
+
+    private:
+        TEvaluationStatsCounters* Counters;
+        size_t ObjectCount;
+        TInstant StartTime;
+        TDuration TreesTime;
+    };
+}
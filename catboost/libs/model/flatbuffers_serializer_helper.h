@@ -11,9 +11,64 @@
 
 class TModelPartsCachingSerializer
 {
+public:
+    TModelPartsCachingSerializer() = default;
+
+    /**
+     * Serializer for aligned model layout: arrays created by CreateAligned* methods start at multiples of
+     * arrayAlignment bytes from the stream start, if the finished buffer is written at bufferStreamOffset.
+     * The layout only pads the buffer, so it is read as any other flatbuffer. Zero alignment keeps default layout.
+     */
+    TModelPartsCachingSerializer(size_t arrayAlignment, ui64 bufferStreamOffset)
+        : ArrayAlignment(arrayAlignment)
+        , BufferStreamOffset(bufferStreamOffset)
+    {
+        CB_ENSURE(
+            (arrayAlignment & (arrayAlignment - 1)) == 0,
+            "Array alignment should be a power of 2, got " << arrayAlignment
+        );
+    }
+
+    template <typename T>
+    flatbuffers::Offset<flatbuffers::Vector<T>> CreateAlignedVector(const T* data, size_t size) {
+        AlignNextVector(size * sizeof(T));
+        return FlatbufBuilder.CreateVector(data, size);
+    }
+
+    template <typename T>
+    flatbuffers::Offset<flatbuffers::Vector<const T*>> CreateAlignedVectorOfStructs(const T* data, size_t size) {
+        AlignNextVector(size * sizeof(T));
+        return FlatbufBuilder.CreateVectorOfStructs(data, size);
+    }
+
+    template <typename T>
+    void Finish(flatbuffers::Offset<T> root) {
+        if (ArrayAlignment) {
+            /* Builder writes the buffer back to front, so aligned arrays are at multiples of alignment from its end.
+             * Padding before the root offset moves the buffer end to a multiple of alignment in the stream.
+             * Builder pads as well if the end offset is not a multiple of the buffer scalars alignment,
+             * so buffers written at offsets not divisible by 8 may stay unaligned.
+             */
+            const ui64 bufferEnd = BufferStreamOffset + FlatbufBuilder.GetSize() + sizeof(flatbuffers::uoffset_t);
+            FlatbufBuilder.Pad(flatbuffers::PaddingBytes(bufferEnd, ArrayAlignment));
+        }
+        FlatbufBuilder.Finish(root);
+    }
+
 public:
     flatbuffers::FlatBufferBuilder FlatbufBuilder;
 
+private:
+    void AlignNextVector(size_t byteSize) {
+        if (ArrayAlignment && byteSize) {
+            FlatbufBuilder.Pad(flatbuffers::PaddingBytes(FlatbufBuilder.GetSize() + byteSize, ArrayAlignment));
+        }
+    }
+
+private:
+    size_t ArrayAlignment = 0;
+    ui64 BufferStreamOffset = 0;
+
 #define GENERATE_OFFSET_HELPER(TNativeType, TFlatbuffersType)\
     public:\
     flatbuffers::Offset<TFlatbuffersType> GetOffset(const TNativeType& value) {\
@@ -0,0 +1,122 @@
+#include "incremental_evaluation.h"
+
+#include "eval_processing.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/stream/labeled.h>
+
+namespace NCB::NModelEvaluation {
+
+    static size_t GetDocCount(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures
+    ) {
+        return floatFeatures.empty() ? catFeatures.size() : floatFeatures.size();
+    }
+
+    TIncrementalLeafIndexCalcer::TIncrementalLeafIndexCalcer(const TFullModel& model)
+        : Model(model)
+        , Evaluator(model.GetCurrentEvaluator())
+    {
+    }
+
+    void TIncrementalLeafIndexCalcer::Reset(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+        const TFeatureLayout* featureInfo
+    ) {
+        DocCount = GetDocCount(floatFeatures, catFeatures);
+        LeafIndexes.yresize(DocCount * Model.GetTreeCount());
+        UpdatedTrees.clear();
+        Evaluator->CalcLeafIndexes(floatFeatures, catFeatures, 0, Model.GetTreeCount(), LeafIndexes, featureInfo);
+    }
+
+    TConstArrayRef<ui32> TIncrementalLeafIndexCalcer::Update(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+        TConstArrayRef<ui32> changedFlatFeatures,
+        const TFeatureLayout* featureInfo
+    ) {
+        const size_t docCount = GetDocCount(floatFeatures, catFeatures);
+        CB_ENSURE(docCount == DocCount, "Batch size differs from cached one: " << LabeledOutput(docCount, DocCount));
+        const auto& flatFeatureTrees = Model.ModelTrees->GetApplyData()->FlatFeatureTrees;
+        UpdatedTrees.clear();
+        for (ui32 flatFeatureIdx : changedFlatFeatures) {
+            // features beyond the used ones do not affect any tree
+            if (flatFeatureIdx < flatFeatureTrees.size()) {
+                const auto& featureTrees = flatFeatureTrees[flatFeatureIdx];
+                UpdatedTrees.insert(UpdatedTrees.end(), featureTrees.begin(), featureTrees.end());
+            }
+        }
+        SortUnique(UpdatedTrees);
+        for (size_t rangeBegin = 0; rangeBegin < UpdatedTrees.size();) {
+            size_t rangeEnd = rangeBegin + 1;
+            while (rangeEnd < UpdatedTrees.size()
+                && UpdatedTrees[rangeEnd] - UpdatedTrees[rangeEnd - 1] <= INCREMENTAL_EVALUATION_MAX_TREE_GAP)
+            {
+                ++rangeEnd;
+            }
+            CalcTreeRange(floatFeatures, catFeatures, UpdatedTrees[rangeBegin], UpdatedTrees[rangeEnd - 1] + 1, featureInfo);
+            rangeBegin = rangeEnd;
+        }
+        return UpdatedTrees;
+    }
+
+    void TIncrementalLeafIndexCalcer::CalcTreeRange(
+        TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+        TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+        size_t treeStart,
+        size_t treeEnd,
+        const TFeatureLayout* featureInfo
+    ) {
+        const size_t treeCount = Model.GetTreeCount();
+        const size_t rangeTreeCount = treeEnd - treeStart;
+        RangeLeafIndexes.yresize(DocCount * rangeTreeCount);
+        Evaluator->CalcLeafIndexes(floatFeatures, catFeatures, treeStart, treeEnd, RangeLeafIndexes, featureInfo);
+        for (size_t docId = 0; docId < DocCount; ++docId) {
+            Copy(
+                RangeLeafIndexes.begin() + docId * rangeTreeCount,
+                RangeLeafIndexes.begin() + (docId + 1) * rangeTreeCount,
+                LeafIndexes.begin() + docId * treeCount + treeStart
+            );
+        }
+    }
+
+    void TIncrementalLeafIndexCalcer::CalcFlat(TArrayRef<double> results) const {
+        CB_ENSURE(
+            results.size() == DocCount * Evaluator->GetPredictionDimensions(),
+            "`results` size is insufficient: " << LabeledOutput(results.size(), DocCount * Evaluator->GetPredictionDimensions())
+        );
+        if (DocCount == 0) {
+            return;
+        }
+        const auto& trees = *Model.ModelTrees;
+        const size_t treeCount = trees.GetTreeCount();
+        const size_t approxDimension = trees.GetDimensionsCount();
+        const auto leafValues = trees.GetModelTreeData()->GetLeafValues();
+        const auto& firstLeafOffsets = trees.GetApplyData()->TreeFirstLeafOffsets;
+        TEvalResultProcessor resultProcessor(
+            DocCount,
+            results,
+            Evaluator->GetPredictionType(),
+            trees.GetScaleAndBias(),
+            approxDimension,
+            /*blockSize*/ DocCount
+        );
+        auto rawView = resultProcessor.GetViewForRawEvaluation(0);
+        Fill(rawView.begin(), rawView.end(), 0.0);
+        for (size_t docId = 0; docId < DocCount; ++docId) {
+            const TCalcerIndexType* docLeafIndexes = LeafIndexes.data() + docId * treeCount;
+            double* docResults = rawView.data() + docId * approxDimension;
+            for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                const double* leafValuesPtr = leafValues.data() + firstLeafOffsets[treeId] + docLeafIndexes[treeId] * approxDimension;
+                for (size_t dim = 0; dim < approxDimension; ++dim) {
+                    docResults[dim] += leafValuesPtr[dim];
+                }
+            }
+        }
+        resultProcessor.PostprocessBlock(0, 0);
+    }
+}
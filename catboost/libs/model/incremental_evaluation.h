@@ -0,0 +1,63 @@
+#pragma once
+
+#include "evaluation_interface.h"
+#include "model.h"
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+namespace NCB::NModelEvaluation {
+
+    // Recomputed tree ranges separated by fewer unaffected trees are merged to avoid repeated quantization
+    constexpr size_t INCREMENTAL_EVALUATION_MAX_TREE_GAP = 16;
+
+    /**
+     * Caches leaf indexes of a batch for all model trees, so after a change of some features of the batch only
+     * trees depending on those features (see TModelTrees::TForApplyData::FlatFeatureTrees) are recomputed.
+     */
+    class TIncrementalLeafIndexCalcer {
+    public:
+        explicit TIncrementalLeafIndexCalcer(const TFullModel& model);
+
+        // Computes leaf indexes of all trees for a new batch
+        void Reset(
+            TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+            TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+            const TFeatureLayout* featureInfo = nullptr);
+
+        /**
+         * Recomputes leaf indexes of trees depending on features with flat indexes changedFlatFeatures,
+         * other features of the batch should be the same as in the previous call.
+         * @return ascending ids of recomputed trees
+         */
+        TConstArrayRef<ui32> Update(
+            TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+            TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+            TConstArrayRef<ui32> changedFlatFeatures,
+            const TFeatureLayout* featureInfo = nullptr);
+
+        // Indexation is [objectIndex * treeCount + treeIndex], same as in TFullModel::CalcLeafIndexes
+        TConstArrayRef<TCalcerIndexType> GetLeafIndexes() const {
+            return LeafIndexes;
+        }
+
+        // Predictions of the model evaluator type for the cached leaf indexes
+        void CalcFlat(TArrayRef<double> results) const;
+
+    private:
+        void CalcTreeRange(
+            TConstArrayRef<TConstArrayRef<float>> floatFeatures,
+            TConstArrayRef<TConstArrayRef<TStringBuf>> catFeatures,
+            size_t treeStart,
+            size_t treeEnd,
+            const TFeatureLayout* featureInfo);
+
+    private:
+        TFullModel Model;
+        TConstModelEvaluatorPtr Evaluator;
+        size_t DocCount = 0;
+        TVector<TCalcerIndexType> LeafIndexes;
+        TVector<ui32> UpdatedTrees;
+        TVector<TCalcerIndexType> RangeLeafIndexes;
+    };
+}
@@ -0,0 +1,159 @@
+#include "lazy_ctr_provider.h"
+
+#include <catboost/libs/model/flatbuffers/ctr_data.fbs.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/buffer.h>
+#include <util/generic/hash_set.h>
+#include <util/stream/buffer.h>
+#include <util/stream/mem.h>
+#include <util/ysaveload.h>
+
+
+bool TLazyCtrProvider::HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) const {
+    for (const auto& ctr : neededCtrs) {
+        if (!RecordByBase.contains(ctr.Base)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TLazyCtrProvider::CalcCtrs(
+    const TConstArrayRef<TModelCtr> neededCtrs,
+    const TConstArrayRef<ui8> binarizedFeatures,
+    const TConstArrayRef<ui32> hashedCatFeatures,
+    size_t docCount,
+    TArrayRef<float> result
+) {
+    for (const auto& ctr : neededCtrs) {
+        const auto recordIt = RecordByBase.find(ctr.Base);
+        CB_ENSURE(recordIt != RecordByBase.end(), "CTR table is missing in lazy CTR provider");
+        TTableRecord* record = recordIt->second;
+        record->CalcCount.fetch_add(1, std::memory_order_relaxed);
+        if (!record->Materialized.load(std::memory_order_acquire)) {
+            with_lock (MaterializationLock) {
+                if (!record->Materialized.load(std::memory_order_relaxed)) {
+                    Materialize(record);
+                }
+            }
+        }
+    }
+    Tables.CalcCtrs(neededCtrs, binarizedFeatures, hashedCatFeatures, docCount, result);
+}
+
+void TLazyCtrProvider::DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) {
+    const THashSet<TModelCtrBase> usedBases(usedModelCtrBase.begin(), usedModelCtrBase.end());
+    EraseIf(Records, [&] (const THolder<TTableRecord>& record) { return !usedBases.contains(record->Base); });
+    RecordByBase.clear();
+    TCtrData ctrData;
+    for (const auto& record : Records) {
+        RecordByBase[record->Base] = record.Get();
+        ctrData.LearnCtrs[record->Base] = std::move(Tables.CtrData.LearnCtrs[record->Base]);
+    }
+    DoSwap(Tables.CtrData, ctrData);
+}
+
+void TLazyCtrProvider::SetIndexType(ECtrIndexType indexType) {
+    with_lock (MaterializationLock) {
+        for (const auto& record : Records) {
+            if (record->Materialized.load(std::memory_order_relaxed)) {
+                Tables.CtrData.LearnCtrs.at(record->Base).SetIndexType(indexType);
+            }
+        }
+        IndexType = indexType;
+    }
+}
+
+void TLazyCtrProvider::Save(IOutputStream* out) const {
+    ::SaveSize(out, Records.size());
+    for (const auto& record : Records) {
+        out->Write(SerializedTables.AsCharPtr() + record->Offset, record->Size);
+    }
+}
+
+void TLazyCtrProvider::Load(IInputStream* in) {
+    TBuffer serializedTables;
+    TBufferOutput out(serializedTables);
+    const size_t tableCount = ::LoadSize(in);
+    for (size_t tableId = 0; tableId < tableCount; ++tableId) {
+        const size_t tableSize = ::LoadSize(in);
+        ::SaveSize(&out, tableSize);
+        const size_t tableStart = serializedTables.Size();
+        serializedTables.Advance(tableSize);
+        in->LoadOrFail(serializedTables.Data() + tableStart, tableSize);
+    }
+    IndexTables(TBlob::FromBuffer(serializedTables), tableCount);
+}
+
+void TLazyCtrProvider::LoadNonOwning(TMemoryInput* in) {
+    const size_t tableCount = ::LoadSize(in);
+    const char* tablesBegin = in->Buf();
+    for (size_t tableId = 0; tableId < tableCount; ++tableId) {
+        in->Skip(::LoadSize(in));
+    }
+    IndexTables(TBlob::NoCopy(tablesBegin, in->Buf() - tablesBegin), tableCount);
+}
+
+TIntrusivePtr<ICtrProvider> TLazyCtrProvider::Clone() const {
+    TIntrusivePtr<TLazyCtrProvider> result = new TLazyCtrProvider();
+    result->SerializedTables = SerializedTables;
+    result->IndexType = IndexType;
+    for (const auto& record : Records) {
+        result->AddRecord(record->Base, record->Offset, record->Size);
+    }
+    return result;
+}
+
+TVector<TCtrTableUsage> TLazyCtrProvider::GetTableUsage() const {
+    TVector<TCtrTableUsage> usage;
+    usage.reserve(Records.size());
+    for (const auto& record : Records) {
+        usage.push_back({
+            record->Base,
+            record->CalcCount.load(std::memory_order_relaxed),
+            record->Materialized.load(std::memory_order_relaxed)
+        });
+    }
+    return usage;
+}
+
+void TLazyCtrProvider::AddRecord(const TModelCtrBase& base, size_t offset, size_t size) {
+    auto& record = Records.emplace_back(MakeHolder<TTableRecord>());
+    record->Base = base;
+    record->Offset = offset;
+    record->Size = size;
+    RecordByBase[base] = record.Get();
+    Tables.CtrData.LearnCtrs[base];
+}
+
+void TLazyCtrProvider::IndexTables(TBlob serializedTables, size_t tableCount) {
+    SerializedTables = std::move(serializedTables);
+    Records.clear();
+    RecordByBase.clear();
+    Tables.CtrData.LearnCtrs.clear();
+    Tables.CtrData.LearnCtrs.reserve(tableCount);
+    TMemoryInput in(SerializedTables.Data(), SerializedTables.Size());
+    for (size_t tableId = 0; tableId < tableCount; ++tableId) {
+        const size_t offset = in.Buf() - SerializedTables.AsCharPtr();
+        const size_t tableSize = ::LoadSize(&in);
+        // only the small key part of the table is parsed up front
+        TModelCtrBase base;
+        base.FBDeserialize(flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(in.Buf())->ModelCtrBase());
+        in.Skip(tableSize);
+        AddRecord(base, offset, in.Buf() - SerializedTables.AsCharPtr() - offset);
+    }
+}
+
+void TLazyCtrProvider::Materialize(TTableRecord* record) {
+    TMemoryInput in(SerializedTables.AsCharPtr() + record->Offset, record->Size);
+    TCtrValueTable table;
+    table.LoadThin(&in);
+    CB_ENSURE_INTERNAL(table.ModelCtrBase == record->Base, "Serialized CTR table does not match its index");
+    if (IndexType != ECtrIndexType::Dense) {
+        table.SetIndexType(IndexType);
+    }
+    // the key exists since loading, so assignment does not touch other tables used concurrently
+    Tables.CtrData.LearnCtrs.at(record->Base) = std::move(table);
+    record->Materialized.store(true, std::memory_order_release);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ctr_provider.h"
+#include "static_ctr_provider.h"
+
+#include <util/generic/hash.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/stream/fwd.h>
+#include <util/system/mutex.h>
+
+#include <atomic>
+
+
+struct TCtrTableUsage {
+    TModelCtrBase Base;
+    //! Number of CTR computations which used the table
+    ui64 CalcCount = 0;
+    bool Materialized = false;
+};
+
+/**
+ * CTR provider with the same serialized form as TStaticCtrProvider, which keeps the serialized tables and builds
+ * TCtrValueTable views over them on first use. Tables are built under a lock, already built ones are used
+ * without locking. Providers loaded from a stream keep one copy of the serialized section, non owning ones
+ * reference the model buffer.
+ */
+class TLazyCtrProvider: public ICtrProvider {
+public:
+    TLazyCtrProvider() = default;
+    ~TLazyCtrProvider() override = default;
+
+    bool HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) const override;
+
+    void CalcCtrs(
+        const TConstArrayRef<TModelCtr> neededCtrs,
+        const TConstArrayRef<ui8> binarizedFeatures, // vector of binarized float & one hot features
+        const TConstArrayRef<ui32> hashedCatFeatures,
+        size_t docCount,
+        TArrayRef<float> result) override;
+
+    void SetupBinFeatureIndexes(
+        const TConstArrayRef<TFloatFeature> floatFeatures,
+        const TConstArrayRef<TOneHotFeature> oheFeatures,
+        const TConstArrayRef<TCatFeature> catFeatures) override {
+        Tables.SetupBinFeatureIndexes(floatFeatures, oheFeatures, catFeatures);
+    }
+
+    bool IsSerializable() const override {
+        return true;
+    }
+
+    void AddCtrCalcerData(TCtrValueTable&&) override {
+        ythrow TCatBoostException() << "TLazyCtrProvider tables are loaded from serialized model only";
+    }
+
+    void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) override;
+
+    // Already materialized tables are reindexed, other ones get the index when materialized
+    void SetIndexType(ECtrIndexType indexType) override;
+
+    void Save(IOutputStream* out) const override;
+
+    void Load(IInputStream* in) override;
+
+    void LoadNonOwning(TMemoryInput* in);
+
+    TString ModelPartIdentifier() const override {
+        return TStaticCtrProvider::ModelPartId();
+    }
+
+    TIntrusivePtr<ICtrProvider> Clone() const override;
+
+    size_t GetTableCount() const {
+        return Records.size();
+    }
+
+    // Usage of tables in serialization order
+    TVector<TCtrTableUsage> GetTableUsage() const;
+
+private:
+    struct TTableRecord {
+        TModelCtrBase Base;
+        //! Range of the size-prefixed table in SerializedTables
+        size_t Offset = 0;
+        size_t Size = 0;
+        std::atomic<bool> Materialized = false;
+        std::atomic<ui64> CalcCount = 0;
+    };
+
+private:
+    void AddRecord(const TModelCtrBase& base, size_t offset, size_t size);
+    void IndexTables(TBlob serializedTables, size_t tableCount);
+    void Materialize(TTableRecord* record);
+
+private:
+    TBlob SerializedTables;
+    TVector<THolder<TTableRecord>> Records;
+    THashMap<TModelCtrBase, TTableRecord*> RecordByBase;
+    //! Contains all table keys, values are set when materialized
+    TStaticCtrProvider Tables;
+    TMutex MaterializationLock;
+    ECtrIndexType IndexType = ECtrIndexType::Dense;
+};
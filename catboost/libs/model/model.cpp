@@ -2,10 +2,13 @@
 
 #include "evaluation_interface.h"
 
+#include "compressed_model.h"
 #include "flatbuffers_serializer_helper.h"
+#include "lazy_ctr_provider.h"
 #include "model_import_interface.h"
 #include "model_build_helper.h"
 #include "static_ctr_provider.h"
+#include "sketch_ctr_provider.h"
 
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 
@@ -24,14 +27,18 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
+#include <util/generic/deque.h>
 #include <util/generic/fwd.h>
 #include <util/generic/guid.h>
+#include <util/generic/map.h>
 #include <util/generic/variant.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
 #include <util/generic/ymath.h>
 #include <util/string/builder.h>
+#include <util/stream/length.h>
 #include <util/stream/str.h>
+#include <util/system/fs.h>
 
 
 static const char MODEL_FILE_DESCRIPTOR_CHARS[4] = {'C', 'B', 'M', '1'};
@@ -57,6 +64,11 @@ void OutputModel(const TFullModel& model, const TStringBuf modelFile) {
     OutputModel(model, &f);
 }
 
+void OutputAlignedModel(const TFullModel& model, const TStringBuf modelFile, size_t arrayAlignment) {
+    TOFStream f(TString{modelFile});
+    model.SaveAligned(&f, arrayAlignment);
+}
+
 bool IsDeserializableModelFormat(EModelType format) {
     return NCB::TModelLoaderFactory::Has(format);
 }
@@ -81,9 +93,16 @@ TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelTy
     return modelLoader->ReadModel(binaryBuffer, binaryBufferSize);
 }
 
-TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize) {
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize, bool lazyCtrTables) {
+    TFullModel model;
+    model.InitNonOwning(binaryBuffer, binaryBufferSize, lazyCtrTables);
+    return model;
+}
+
+TFullModel ReadZeroCopyModel(const TString& modelFile, bool lazyCtrTables) {
+    CB_ENSURE(NFs::Exists(modelFile), "Model file doesn't exist: " << modelFile);
     TFullModel model;
-    model.InitNonOwning(binaryBuffer, binaryBufferSize);
+    model.InitNonOwning(TBlob::FromFile(modelFile), lazyCtrTables);
     return model;
 }
 
@@ -273,6 +292,12 @@ bool TModelTrees::IsSolid() const {
     return dynamic_cast<TSolidModelTree*>(ModelTreeData.Get());
 }
 
+void TModelTrees::ConvertToSolid() {
+    if (!IsSolid()) {
+        ModelTreeData = ModelTreeData->Clone(IModelTreeData::ECloningPolicy::CloneAsSolid);
+    }
+}
+
 void TModelTrees::TruncateTrees(size_t begin, size_t end) {
     //TODO(eermishkina): support non symmetric trees
     CB_ENSURE(IsOblivious(), "Truncate support only symmetric trees");
@@ -371,7 +396,7 @@ TModelTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
             nonSymmetricStep.RightSubtreeDiff
         });
     }
-    auto fbsNonSymmetricTreeStepNode = builder.CreateVectorOfStructs(nonSymmetricTreeStepNode);
+    auto fbsNonSymmetricTreeStepNode = serializer.CreateAlignedVectorOfStructs(nonSymmetricTreeStepNode.data(), nonSymmetricTreeStepNode.size());
 
     TVector<NCatBoostFbs::TRepackedBin> repackedBins;
     repackedBins.reserve(GetRepackedBins().size());
@@ -382,15 +407,15 @@ TModelTrees::FBSerialize(TModelPartsCachingSerializer& serializer) const {
             repackedBin.SplitIdx
         });
     }
-    auto fbsRepackedBins = builder.CreateVectorOfStructs(repackedBins);
+    auto fbsRepackedBins = serializer.CreateAlignedVectorOfStructs(repackedBins.data(), repackedBins.size());
 
     auto& data = GetModelTreeData();
-    auto fbsTreeSplits = builder.CreateVector(data->GetTreeSplits().data(), data->GetTreeSplits().size());
-    auto fbsTreeSizes = builder.CreateVector(data->GetTreeSizes().data(), data->GetTreeSizes().size());
-    auto fbsTreeStartOffsets = builder.CreateVector(data->GetTreeStartOffsets().data(), data->GetTreeStartOffsets().size());
-    auto fbsLeafValues = builder.CreateVector(data->GetLeafValues().data(), data->GetLeafValues().size());
-    auto fbsLeafWeights = builder.CreateVector(data->GetLeafWeights().data(), data->GetLeafWeights().size());
-    auto fbsNonSymmetricNodeIdToLeafId = builder.CreateVector(data->GetNonSymmetricNodeIdToLeafId().data(), data->GetNonSymmetricNodeIdToLeafId().size());
+    auto fbsTreeSplits = serializer.CreateAlignedVector(data->GetTreeSplits().data(), data->GetTreeSplits().size());
+    auto fbsTreeSizes = serializer.CreateAlignedVector(data->GetTreeSizes().data(), data->GetTreeSizes().size());
+    auto fbsTreeStartOffsets = serializer.CreateAlignedVector(data->GetTreeStartOffsets().data(), data->GetTreeStartOffsets().size());
+    auto fbsLeafValues = serializer.CreateAlignedVector(data->GetLeafValues().data(), data->GetLeafValues().size());
+    auto fbsLeafWeights = serializer.CreateAlignedVector(data->GetLeafWeights().data(), data->GetLeafWeights().size());
+    auto fbsNonSymmetricNodeIdToLeafId = serializer.CreateAlignedVector(data->GetNonSymmetricNodeIdToLeafId().data(), data->GetNonSymmetricNodeIdToLeafId().size());
     auto bias = GetScaleAndBias().GetBiasRef();
     auto fbsBias = builder.CreateVector(bias.data(), bias.size());
     return NCatBoostFbs::CreateTModelTrees(
@@ -422,14 +447,24 @@ static_assert(sizeof(TRepackedBin) == sizeof(NCatBoostFbs::TRepackedBin));
 void TModelTrees::UpdateRuntimeData() {
     CalcForApplyData();
     CalcBinFeatures();
+    CalcPackedNonSymmetricNodes();
+    CalcFlatFeatureTrees();
 }
 
+// with fewer borders comparison with each border in SSE registers is faster than binary search
+static constexpr size_t MinBordersCountForBinarySearch = 64;
+
 void TModelTrees::ProcessFloatFeatures() {
+    ApplyData->FloatFeatureUsesBinarySearch.reserve(FloatFeatures.size());
     for (const auto& feature : FloatFeatures) {
         if (feature.UsedInModel()) {
             ++ApplyData->UsedFloatFeaturesCount;
             ApplyData->MinimalSufficientFloatFeaturesVectorSize = static_cast<size_t>(feature.Position.Index) + 1;
         }
+        ApplyData->FloatFeatureUsesBinarySearch.push_back(
+            feature.Borders.size() >= MinBordersCountForBinarySearch
+            && IsSorted(feature.Borders.begin(), feature.Borders.end())
+        );
     }
 }
 
@@ -572,6 +607,140 @@ void TModelTrees::CalcBinFeatures() {
     RepackedBins = NCB::TMaybeOwningConstArrayHolder<TRepackedBin>::CreateOwning(std::move(repackedBins));
 }
 
+void TModelTrees::CalcPackedNonSymmetricNodes() {
+    if (IsOblivious()) {
+        return;
+    }
+    const auto repackedBins = GetRepackedBins();
+    const auto stepNodes = GetModelTreeData()->GetNonSymmetricStepNodes();
+    const auto nodeIdToLeafId = GetModelTreeData()->GetNonSymmetricNodeIdToLeafId();
+    const auto treeStartOffsets = GetModelTreeData()->GetTreeStartOffsets();
+    auto& packedNodes = RuntimeData->PackedNonSymmetricNodes;
+    auto& treeRoots = RuntimeData->PackedNonSymmetricTreeRoots;
+    packedNodes.reserve(2 * stepNodes.size() + 2 * treeStartOffsets.size());
+    treeRoots.reserve(treeStartOffsets.size());
+
+    const auto makeTerminal = [&] (ui32 nodeId) {
+        CB_ENSURE_INTERNAL(
+            nodeIdToLeafId[nodeId] < TPackedNonSymmetricNode::TerminalFlag,
+            "Leaf value offset is too large for packed non symmetric tree"
+        );
+        TPackedNonSymmetricNode node;
+        node.Next = TPackedNonSymmetricNode::TerminalFlag | nodeIdToLeafId[nodeId];
+        return node;
+    };
+    // pairs (slot, model node id) of inner nodes waiting for their children
+    TDeque<std::pair<ui32, ui32>> queue;
+    for (int treeStart : treeStartOffsets) {
+        // root takes an odd slot, so every children pair after it starts at an even one
+        if (packedNodes.size() % 2 == 0) {
+            packedNodes.emplace_back();
+        }
+        treeRoots.push_back(packedNodes.size());
+        const auto& rootStep = stepNodes[treeStart];
+        if (rootStep.LeftSubtreeDiff == 0 && rootStep.RightSubtreeDiff == 0) {
+            packedNodes.push_back(makeTerminal(treeStart));
+            continue;
+        }
+        packedNodes.emplace_back().Split = repackedBins[treeStart];
+        queue.emplace_back(packedNodes.size() - 1, treeStart);
+        while (!queue.empty()) {
+            const auto [slot, nodeId] = queue.front();
+            queue.pop_front();
+            const auto& step = stepNodes[nodeId];
+            const ui32 childrenSlot = packedNodes.size();
+            packedNodes.resize(packedNodes.size() + 2);
+            packedNodes[slot].Next = childrenSlot;
+            const ui16 diffs[2] = {step.LeftSubtreeDiff, step.RightSubtreeDiff};
+            for (ui32 direction = 0; direction < 2; ++direction) {
+                if (diffs[direction] == 0) {
+                    packedNodes[childrenSlot + direction] = makeTerminal(nodeId);
+                    continue;
+                }
+                const ui32 childId = nodeId + diffs[direction];
+                const auto& childStep = stepNodes[childId];
+                if (childStep.LeftSubtreeDiff == 0 && childStep.RightSubtreeDiff == 0) {
+                    packedNodes[childrenSlot + direction] = makeTerminal(childId);
+                } else {
+                    packedNodes[childrenSlot + direction].Split = repackedBins[childId];
+                    queue.emplace_back(childrenSlot + direction, childId);
+                }
+            }
+        }
+    }
+    CB_ENSURE_INTERNAL(
+        packedNodes.size() < TPackedNonSymmetricNode::TerminalFlag,
+        "Too many nodes in non symmetric trees"
+    );
+}
+
+void TModelTrees::CalcFlatFeatureTrees() {
+    auto& ref = ApplyData->FlatFeatureTrees;
+    ref.resize(GetFlatFeatureVectorExpectedSize());
+    const auto binFeatures = GetBinFeatures();
+    // model containing only empty splits does not depend on features
+    if (binFeatures.empty()) {
+        return;
+    }
+    const auto makeFlatIndexMap = [] (const auto& features, size_t featureCount) {
+        TVector<int> flatIndexes(featureCount, -1);
+        for (const auto& feature : features) {
+            flatIndexes[feature.Position.Index] = feature.Position.FlatIndex;
+        }
+        return flatIndexes;
+    };
+    const auto floatFlatIndexes = makeFlatIndexMap(FloatFeatures, GetNumFloatFeatures());
+    const auto catFlatIndexes = makeFlatIndexMap(CatFeatures, GetNumCatFeatures());
+    const auto textFlatIndexes = makeFlatIndexMap(TextFeatures, GetNumTextFeatures());
+    const auto embeddingFlatIndexes = makeFlatIndexMap(EmbeddingFeatures, GetNumEmbeddingFeatures());
+
+    const auto treeSizes = GetModelTreeData()->GetTreeSizes();
+    const auto treeSplits = GetModelTreeData()->GetTreeSplits();
+    const auto treeStartOffsets = GetModelTreeData()->GetTreeStartOffsets();
+    TVector<int> treeFlatFeatures;
+    for (size_t treeId = 0; treeId < treeSizes.size(); ++treeId) {
+        treeFlatFeatures.clear();
+        for (int splitIdx = treeStartOffsets[treeId]; splitIdx < treeStartOffsets[treeId] + treeSizes[treeId]; ++splitIdx) {
+            const auto& split = binFeatures[treeSplits[splitIdx]];
+            switch (split.Type) {
+                case ESplitType::FloatFeature:
+                    treeFlatFeatures.push_back(floatFlatIndexes[split.FloatFeature.FloatFeature]);
+                    break;
+                case ESplitType::OneHotFeature:
+                    treeFlatFeatures.push_back(catFlatIndexes[split.OneHotFeature.CatFeatureIdx]);
+                    break;
+                case ESplitType::OnlineCtr: {
+                    const auto& projection = split.OnlineCtr.Ctr.Base.Projection;
+                    for (int catFeature : projection.CatFeatures) {
+                        treeFlatFeatures.push_back(catFlatIndexes[catFeature]);
+                    }
+                    for (const auto& floatSplit : projection.BinFeatures) {
+                        treeFlatFeatures.push_back(floatFlatIndexes[floatSplit.FloatFeature]);
+                    }
+                    for (const auto& oneHotSplit : projection.OneHotFeatures) {
+                        treeFlatFeatures.push_back(catFlatIndexes[oneHotSplit.CatFeatureIdx]);
+                    }
+                    break;
+                }
+                case ESplitType::EstimatedFeature: {
+                    const auto& estimatedFeature = split.EstimatedFeature.ModelEstimatedFeature;
+                    if (estimatedFeature.SourceFeatureType == EEstimatedSourceFeatureType::Text) {
+                        treeFlatFeatures.push_back(textFlatIndexes[estimatedFeature.SourceFeatureId]);
+                    } else {
+                        treeFlatFeatures.push_back(embeddingFlatIndexes[estimatedFeature.SourceFeatureId]);
+                    }
+                    break;
+                }
+            }
+        }
+        SortUnique(treeFlatFeatures);
+        for (int flatFeatureIdx : treeFlatFeatures) {
+            CB_ENSURE_INTERNAL(flatFeatureIdx >= 0, "Tree " << treeId << " depends on feature missing in model");
+            ref[flatFeatureIdx].push_back(treeId);
+        }
+    }
+}
+
 void TModelTrees::CalcUsedModelCtrs() {
     auto& ref = ApplyData->UsedModelCtrs;
     for (const auto& ctrFeature : CtrFeatures) {
@@ -619,6 +788,73 @@ void TModelTrees::CalcFirstLeafOffsets() {
     }
 }
 
+void TModelTrees::FoldEqualTrees() {
+    CB_ENSURE(IsOblivious(), "Folding of equal trees is supported only for symmetric trees");
+    ConvertToSolid();
+    const auto applyData = GetApplyData();
+    const auto& leafOffsets = applyData->TreeFirstLeafOffsets;
+    const auto treeSizes = GetModelTreeData()->GetTreeSizes();
+    const auto treeSplits = GetModelTreeData()->GetTreeSplits();
+    const auto treeStartOffsets = GetModelTreeData()->GetTreeStartOffsets();
+    const auto leafValues = GetModelTreeData()->GetLeafValues();
+    const auto leafWeights = GetModelTreeData()->GetLeafWeights();
+    const bool hasLeafWeights = !leafWeights.empty();
+
+    TMap<TVector<int>, size_t> foldedTreeIdx;
+    TVector<int> foldedTreeSizes;
+    TVector<int> foldedTreeSplits;
+    TVector<int> foldedTreeStartOffsets;
+    TVector<size_t> foldedLeafOffsets;
+    TVector<double> foldedLeafValues;
+    TVector<double> foldedLeafWeights;
+    for (size_t treeIdx = 0; treeIdx < treeSizes.size(); ++treeIdx) {
+        const int depth = treeSizes[treeIdx];
+        const auto splits = treeSplits.Slice(treeStartOffsets[treeIdx], depth);
+        // bit i of leaf index is the result of i-th split, so sorting splits permutes leaves
+        TVector<int> splitOrder(depth);
+        Iota(splitOrder.begin(), splitOrder.end(), 0);
+        StableSortBy(splitOrder, [&] (int splitIdx) { return splits[splitIdx]; });
+        TVector<int> sortedSplits;
+        for (int splitIdx : splitOrder) {
+            sortedSplits.push_back(splits[splitIdx]);
+        }
+        const size_t leafCount = size_t(1) << depth;
+        const auto [foldedTree, isNewTree] = foldedTreeIdx.emplace(sortedSplits, foldedTreeSizes.size());
+        if (isNewTree) {
+            foldedTreeSizes.push_back(depth);
+            foldedTreeStartOffsets.push_back(foldedTreeSplits.size());
+            foldedTreeSplits.insert(foldedTreeSplits.end(), sortedSplits.begin(), sortedSplits.end());
+            foldedLeafOffsets.push_back(foldedLeafValues.size());
+            foldedLeafValues.resize(foldedLeafValues.size() + leafCount * ApproxDimension, 0.0);
+            if (hasLeafWeights) {
+                foldedLeafWeights.resize(foldedLeafWeights.size() + leafCount, 0.0);
+            }
+        }
+        const size_t foldedLeafOffset = foldedLeafOffsets[foldedTree->second];
+        for (size_t leafIdx = 0; leafIdx < leafCount; ++leafIdx) {
+            size_t foldedLeafIdx = 0;
+            for (int depthIdx = 0; depthIdx < depth; ++depthIdx) {
+                foldedLeafIdx |= ((leafIdx >> splitOrder[depthIdx]) & 1) << depthIdx;
+            }
+            for (int dim = 0; dim < ApproxDimension; ++dim) {
+                foldedLeafValues[foldedLeafOffset + foldedLeafIdx * ApproxDimension + dim]
+                    += leafValues[leafOffsets[treeIdx] + leafIdx * ApproxDimension + dim];
+            }
+            if (hasLeafWeights && isNewTree) {
+                foldedLeafWeights[foldedLeafOffset / ApproxDimension + foldedLeafIdx]
+                    = leafWeights[leafOffsets[treeIdx] / ApproxDimension + leafIdx];
+            }
+        }
+    }
+    auto& data = *CastToSolidTree(*this);
+    data.TreeSizes = std::move(foldedTreeSizes);
+    data.TreeSplits = std::move(foldedTreeSplits);
+    data.TreeStartOffsets = std::move(foldedTreeStartOffsets);
+    data.LeafValues = std::move(foldedLeafValues);
+    data.LeafWeights = std::move(foldedLeafWeights);
+    UpdateRuntimeData();
+}
+
 void TModelTrees::DropUnusedFeatures() {
     EraseIf(FloatFeatures, [](const TFloatFeature& feature) { return !feature.UsedInModel();});
     EraseIf(CatFeatures, [](const TCatFeature& feature) { return !feature.UsedInModel(); });
@@ -627,6 +863,107 @@ void TModelTrees::DropUnusedFeatures() {
     UpdateRuntimeData();
 }
 
+template <class T>
+static void FilterUsed(
+    const TVector<bool>& isBinFeatureUsed,
+    size_t* binFeatureIdx,
+    TVector<int>* binFeatureRemap,
+    int* newBinFeatureCount,
+    TVector<T>* values
+) {
+    TVector<T> usedValues;
+    for (auto& value : *values) {
+        if (isBinFeatureUsed[*binFeatureIdx]) {
+            (*binFeatureRemap)[*binFeatureIdx] = (*newBinFeatureCount)++;
+            usedValues.push_back(std::move(value));
+        }
+        ++*binFeatureIdx;
+    }
+    *values = std::move(usedValues);
+}
+
+void TModelTrees::DropUnusedSplits() {
+    CB_ENSURE(IsSolid(), "Only solid models are modifiable");
+    const auto binFeatures = GetBinFeatures();
+    const auto treeSplits = GetModelTreeData()->GetTreeSplits();
+    const auto stepNodes = GetModelTreeData()->GetNonSymmetricStepNodes();
+    // terminal nodes of non symmetric trees have zero split as a placeholder
+    const auto isTerminalNode = [&] (size_t nodeIdx) {
+        return !stepNodes.empty()
+            && stepNodes[nodeIdx].LeftSubtreeDiff == TNonSymmetricTreeStepNode::TerminalMarker
+            && stepNodes[nodeIdx].RightSubtreeDiff == TNonSymmetricTreeStepNode::TerminalMarker;
+    };
+    TVector<bool> isBinFeatureUsed(binFeatures.size(), false);
+    for (size_t nodeIdx = 0; nodeIdx < treeSplits.size(); ++nodeIdx) {
+        if (!isTerminalNode(nodeIdx)) {
+            isBinFeatureUsed[treeSplits[nodeIdx]] = true;
+        }
+    }
+    THashMap<TFloatSplit, size_t> floatSplitIdx;
+    THashMap<TOneHotSplit, size_t> oneHotSplitIdx;
+    for (size_t binFeatureIdx = 0; binFeatureIdx < binFeatures.size(); ++binFeatureIdx) {
+        const auto& split = binFeatures[binFeatureIdx];
+        if (split.Type == ESplitType::FloatFeature) {
+            floatSplitIdx[split.FloatFeature] = binFeatureIdx;
+        } else if (split.Type == ESplitType::OneHotFeature) {
+            oneHotSplitIdx[split.OneHotFeature] = binFeatureIdx;
+        }
+    }
+    // CTRs of used splits are calculated on binarized float and one hot features of their projections
+    for (size_t binFeatureIdx = 0; binFeatureIdx < binFeatures.size(); ++binFeatureIdx) {
+        const auto& split = binFeatures[binFeatureIdx];
+        if (split.Type != ESplitType::OnlineCtr || !isBinFeatureUsed[binFeatureIdx]) {
+            continue;
+        }
+        const auto& projection = split.OnlineCtr.Ctr.Base.Projection;
+        for (const auto& floatSplit : projection.BinFeatures) {
+            isBinFeatureUsed[floatSplitIdx.at(floatSplit)] = true;
+        }
+        for (const auto& oneHotSplit : projection.OneHotFeatures) {
+            isBinFeatureUsed[oneHotSplitIdx.at(oneHotSplit)] = true;
+        }
+    }
+
+    // same order of bin features as in CalcBinFeatures
+    TVector<int> binFeatureRemap(binFeatures.size(), 0);
+    int newBinFeatureCount = 0;
+    size_t binFeatureIdx = 0;
+    for (auto& feature : FloatFeatures) {
+        if (feature.UsedInModel()) {
+            FilterUsed(isBinFeatureUsed, &binFeatureIdx, &binFeatureRemap, &newBinFeatureCount, &feature.Borders);
+        }
+    }
+    for (const auto& feature : EstimatedFeatures) {
+        for (size_t borderIdx = 0; borderIdx < feature.Borders.size(); ++borderIdx, ++binFeatureIdx) {
+            binFeatureRemap[binFeatureIdx] = newBinFeatureCount++;
+        }
+    }
+    for (auto& feature : OneHotFeatures) {
+        TVector<bool> isValueUsed(isBinFeatureUsed.begin() + binFeatureIdx, isBinFeatureUsed.begin() + binFeatureIdx + feature.Values.size());
+        FilterUsed(isBinFeatureUsed, &binFeatureIdx, &binFeatureRemap, &newBinFeatureCount, &feature.Values);
+        if (!feature.StringValues.empty()) {
+            size_t valueIdx = 0;
+            EraseIf(feature.StringValues, [&] (const TString&) { return !isValueUsed[valueIdx++]; });
+        }
+    }
+    for (auto& feature : CtrFeatures) {
+        FilterUsed(isBinFeatureUsed, &binFeatureIdx, &binFeatureRemap, &newBinFeatureCount, &feature.Borders);
+    }
+    CB_ENSURE_INTERNAL(binFeatureIdx == binFeatures.size(), "Bin features of model are out of sync with its features");
+    EraseIf(OneHotFeatures, [] (const TOneHotFeature& feature) { return feature.Values.empty(); });
+    EraseIf(CtrFeatures, [] (const TCtrFeature& feature) { return feature.Borders.empty(); });
+
+    TVector<int> newTreeSplits(treeSplits.size(), 0);
+    for (size_t nodeIdx = 0; nodeIdx < treeSplits.size(); ++nodeIdx) {
+        if (!isTerminalNode(nodeIdx)) {
+            newTreeSplits[nodeIdx] = binFeatureRemap[treeSplits[nodeIdx]];
+        }
+    }
+    ModelTreeData->SetTreeSplits(newTreeSplits);
+    // also updates runtime data
+    DropUnusedFeatures();
+}
+
 void TModelTrees::ConvertObliviousToAsymmetric() {
     if (!IsOblivious() || !IsSolid()) {
         return;
@@ -990,6 +1327,17 @@ TVector<EFormulaEvaluatorType> TFullModel::GetSupportedEvaluatorTypes() {
     return result;
 }
 
+void TFullModel::CompactForApply() {
+    ModelTrees.GetMutable()->DropUnusedSplits();
+    if (CtrProvider) {
+        if (auto* staticCtrProvider = dynamic_cast<TStaticCtrProvider*>(CtrProvider.Get())) {
+            staticCtrProvider->DropUnusedBuckets(ModelTrees->GetCtrFeatures());
+        }
+        CtrProvider->DropUnusedTables(ModelTrees->GetApplyData()->GetUsedModelCtrBases());
+    }
+    UpdateDynamicData();
+}
+
 void TFullModel::CalcFlat(
     TConstArrayRef<TConstArrayRef<float>> features,
     size_t treeStart,
@@ -1107,10 +1455,22 @@ void TFullModel::CalcLeafIndexes(
 
 
 void TFullModel::Save(IOutputStream* s) const {
+    SaveImpl(s, /*arrayAlignment*/ 0);
+}
+
+void TFullModel::SaveAligned(IOutputStream* s, size_t arrayAlignment) const {
+    CB_ENSURE(arrayAlignment > 0, "Array alignment should be positive");
+    SaveImpl(s, arrayAlignment);
+}
+
+void TFullModel::SaveImpl(IOutputStream* stream, size_t arrayAlignment) const {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
+    TCountingOutput countingStream(stream);
+    IOutputStream* s = &countingStream;
     ::Save(s, GetModelFormatDescriptor());
-    TModelPartsCachingSerializer serializer;
+    // core buffer follows its ui32 size
+    TModelPartsCachingSerializer serializer(arrayAlignment, countingStream.Counter() + sizeof(ui32));
     auto modelTreesOffset = ModelTrees->FBSerialize(serializer);
     std::vector<flatbuffers::Offset<TKeyValue>> infoMap;
     for (const auto& key_value : ModelInfo) {
@@ -1144,11 +1504,19 @@ void TFullModel::Save(IOutputStream* s) const {
         infoMap.empty() ? nullptr : &infoMap,
         modelPartIds.empty() ? nullptr : &modelPartIds
     );
-    serializer.FlatbufBuilder.Finish(coreOffset);
+    serializer.Finish(coreOffset);
+    CB_ENSURE(
+        !arrayAlignment || serializer.FlatbufBuilder.GetSize() < Max<ui32>(),
+        "Model is too large for aligned layout"
+    );
     SaveSize(s, serializer.FlatbufBuilder.GetSize());
     s->Write(serializer.FlatbufBuilder.GetBufferPointer(), serializer.FlatbufBuilder.GetSize());
     if (!!CtrProvider && CtrProvider->IsSerializable()) {
-        CtrProvider->Save(s);
+        if (arrayAlignment) {
+            CtrProvider->SaveAligned(&countingStream, arrayAlignment);
+        } else {
+            CtrProvider->Save(s);
+        }
     }
     if (!!TextProcessingCollection) {
         TextProcessingCollection->Save(s);
@@ -1172,12 +1540,16 @@ void TFullModel::DefaultFullModelInit(const NCatBoostFbs::TModelCore* fbModelCor
     }
 }
 
-void TFullModel::Load(IInputStream* s) {
+void TFullModel::Load(IInputStream* s, bool lazyCtrTables) {
     ReferenceMainFactoryRegistrators();
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
     ui32 fileDescriptor;
     ::Load(s, fileDescriptor);
+    if (NCB::IsCompressedModelDescriptor(fileDescriptor)) {
+        InitNonOwning(NCB::DecompressModel(s), lazyCtrTables);
+        return;
+    }
     CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
     auto coreSize = ::LoadSize(s);
     TArrayHolder<ui8> arrayHolder(new ui8[coreSize]);
@@ -1203,7 +1575,14 @@ void TFullModel::Load(IInputStream* s) {
     if (!modelParts.empty()) {
         for (const auto& modelPartId : modelParts) {
             if (modelPartId == TStaticCtrProvider::ModelPartId()) {
-                CtrProvider = new TStaticCtrProvider;
+                if (lazyCtrTables) {
+                    CtrProvider = new TLazyCtrProvider;
+                } else {
+                    CtrProvider = new TStaticCtrProvider;
+                }
+                CtrProvider->Load(s);
+            } else if (modelPartId == TSketchCtrProvider::ModelPartId()) {
+                CtrProvider = new TSketchCtrProvider;
                 CtrProvider->Load(s);
             } else if (modelPartId == NCB::TTextProcessingCollection::GetStringIdentifier()) {
                 TextProcessingCollection = new NCB::TTextProcessingCollection();
@@ -1223,13 +1602,18 @@ void TFullModel::Load(IInputStream* s) {
     UpdateDynamicData();
 }
 
-void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize) {
+void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize, bool lazyCtrTables) {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
 
     TMemoryInput in(binaryBuffer, binarySize);
     ui32 fileDescriptor;
     ::Load(&in, fileDescriptor);
+    if (NCB::IsCompressedModelDescriptor(fileDescriptor)) {
+        // decompressed image is owned by the model
+        InitNonOwning(NCB::DecompressModel(&in), lazyCtrTables);
+        return;
+    }
     CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
 
     size_t coreSize = ::LoadSize(&in);
@@ -1258,9 +1642,18 @@ void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize) {
     if (!modelParts.empty()) {
         for (const auto& modelPartId : modelParts) {
             if (modelPartId == TStaticCtrProvider::ModelPartId()) {
-                auto ptr = new TStaticCtrProvider;
-                CtrProvider = ptr;
-                ptr->LoadNonOwning(&in);
+                if (lazyCtrTables) {
+                    auto ptr = new TLazyCtrProvider;
+                    CtrProvider = ptr;
+                    ptr->LoadNonOwning(&in);
+                } else {
+                    auto ptr = new TStaticCtrProvider;
+                    CtrProvider = ptr;
+                    ptr->LoadNonOwning(&in);
+                }
+            } else if (modelPartId == TSketchCtrProvider::ModelPartId()) {
+                CtrProvider = new TSketchCtrProvider;
+                CtrProvider->Load(&in);
             } else if (modelPartId == NCB::TTextProcessingCollection::GetStringIdentifier()) {
                 TextProcessingCollection = new NCB::TTextProcessingCollection();
                 TextProcessingCollection->LoadNonOwning(&in);
@@ -1279,6 +1672,15 @@ void TFullModel::InitNonOwning(const void* binaryBuffer, size_t binarySize) {
     UpdateDynamicData();
 }
 
+void TFullModel::InitNonOwning(TBlob binaryBlob, bool lazyCtrTables) {
+    if (NCB::IsCompressedModel(binaryBlob.Data(), binaryBlob.Size())) {
+        TMemoryInput in(binaryBlob.AsCharPtr() + sizeof(ui32), binaryBlob.Size() - sizeof(ui32));
+        binaryBlob = NCB::DecompressModel(&in);
+    }
+    InitNonOwning(binaryBlob.Data(), binaryBlob.Size(), lazyCtrTables);
+    NonOwningData = std::move(binaryBlob);
+}
+
 void TFullModel::UpdateDynamicData() {
     ModelTrees.GetMutable()->UpdateRuntimeData();
     if (CtrProvider) {
@@ -1830,7 +2232,8 @@ TFullModel SumModels(
     const TVector<const TFullModel*> modelVector,
     const TVector<double>& weights,
     const TVector<TString>& modelParamsPrefixes,
-    ECtrTableMergePolicy ctrMergePolicy
+    ECtrTableMergePolicy ctrMergePolicy,
+    bool foldEqualTrees
 ) {
     CB_ENSURE(!modelVector.empty(), "empty model vector unexpected");
     CB_ENSURE(modelVector.size() == weights.size());
@@ -1935,6 +2338,13 @@ TFullModel SumModels(
             result.ModelInfo[keyPrefix + key] = value;
         }
     }
+    if (foldEqualTrees) {
+        if (result.IsOblivious()) {
+            result.ModelTrees.GetMutable()->FoldEqualTrees();
+        } else {
+            CATBOOST_WARNING_LOG << "Equal trees are not folded, it is supported only for symmetric trees" << Endl;
+        }
+    }
     result.CtrProvider = MergeCtrProvidersData(ctrProviders, ctrMergePolicy);
     result.UpdateDynamicData();
     result.ModelInfo["model_guid"] = CreateGuidAsString();
@@ -27,6 +27,7 @@
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/memory/blob.h>
 #include <util/stream/fwd.h>
 #include <util/stream/mem.h>
 #include <util/system/spinlock.h>
@@ -71,6 +72,9 @@ struct TRepackedBin {
 
 constexpr ui32 MAX_VALUES_PER_BIN = 254;
 
+//! Default alignment of arrays in models saved with TFullModel::SaveAligned
+constexpr size_t DEFAULT_MODEL_ARRAY_ALIGNMENT = 64;
+
 constexpr double DEFAULT_BINCLASS_PROBABILITY_THRESHOLD = 0.5;
 constexpr double DEFAULT_BINCLASS_LOGIT_THRESHOLD = 0;
 
@@ -94,6 +98,20 @@ struct TNonSymmetricTreeStepNode {
     }
 };
 
+/**
+ * Runtime node of non symmetric tree laid out in breadth-first order for evaluation.
+ * Children of an inner node are stored as a pair at Next (left) and Next + 1 (right), pairs start at even
+ * slots, so both children share a cache line. Terminal node stores leaf value offset with TerminalFlag set.
+ */
+struct TPackedNonSymmetricNode {
+    static constexpr ui32 TerminalFlag = 1u << 31;
+
+    TRepackedBin Split;
+    ui32 Next = TerminalFlag;
+};
+
+static_assert(sizeof(TPackedNonSymmetricNode) == 8);
+
 struct IModelTreeData {
     enum class ECloningPolicy { Default, CloneAsSolid, CloneAsOpaque };
 
@@ -151,6 +169,12 @@ public:
          */
         TVector<TModelSplit> BinFeatures;
         ui32 EffectiveBinFeaturesBucketCount = 0;
+        /**
+         * Non symmetric trees repacked for evaluation, empty for oblivious models
+         */
+        TVector<TPackedNonSymmetricNode> PackedNonSymmetricNodes;
+        //! Slot of each tree root in PackedNonSymmetricNodes
+        TVector<ui32> PackedNonSymmetricTreeRoots;
     };
 
     struct TForApplyData {
@@ -171,6 +195,18 @@ public:
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
 
+        /**
+         * For each float feature (in GetFloatFeatures() order) whether its values are binarized
+         * with binary search over borders instead of comparison with each border
+         */
+        TVector<bool> FloatFeatureUsesBinarySearch;
+
+        /**
+         * For each flat feature index ascending ids of trees with splits depending on it,
+         * including ones through CTRs and estimated features
+         */
+        TVector<TVector<ui32>> FlatFeatureTrees;
+
         /**
          * List all unique CTR bases (feature combination + ctr type) in model
          * @return
@@ -274,6 +310,9 @@ public:
 
     bool IsSolid() const;
 
+    //! Copy trees viewing model buffer into owned memory, so that they become modifiable
+    void ConvertToSolid();
+
     void ConvertObliviousToAsymmetric();
 
     /**
@@ -458,11 +497,25 @@ public:
      */
     void TruncateTrees(size_t begin, size_t end);
 
+    /**
+     * Replace symmetric trees with equal sets of splits by one tree with summed leaf values.
+     * Splits of each tree are sorted, leaves are permuted accordingly, so split order does not matter.
+     * Leaf weights of the first of equal trees are kept.
+     */
+    void FoldEqualTrees();
+
     /**
      * Drop unused float and categorical features from model
      */
      void DropUnusedFeatures();
 
+    /**
+     * Drop float feature borders, one hot values and CTR feature borders which are used neither by tree
+     * splits nor by CTR projections, then drop features left without them. Tree splits are reindexed,
+     * predictions are unchanged. Estimated feature borders are kept as is.
+     */
+    void DropUnusedSplits();
+
     /**
      * Internal usage only. Updates UsedModelCtrs and BinFeatures vectors in RuntimeData to contain all
      *  features currently used in model.
@@ -486,6 +539,14 @@ public:
         return *RepackedBins;
     }
 
+    TConstArrayRef<TPackedNonSymmetricNode> GetPackedNonSymmetricNodes() const {
+        return RuntimeData->PackedNonSymmetricNodes;
+    }
+
+    TConstArrayRef<ui32> GetPackedNonSymmetricTreeRoots() const {
+        return RuntimeData->PackedNonSymmetricTreeRoots;
+    }
+
     const double* GetFirstLeafPtrForTree(size_t treeIdx) const {
         auto applyData = GetApplyData();
         return &ModelTreeData->GetLeafValues()[applyData->TreeFirstLeafOffsets[treeIdx]];
@@ -554,6 +615,8 @@ private:
     void SetScaleAndBias(const NCatBoostFbs::TModelTrees* fbObj);
 
     void CalcBinFeatures();
+    void CalcPackedNonSymmetricNodes();
+    void CalcFlatFeatureTrees();
     void CalcForApplyData() {
         ApplyData = MakeAtomicShared<TForApplyData>();
         ProcessFloatFeatures();
@@ -633,6 +696,11 @@ public:
         return Trees.Get();
     }
 
+    //! Number of wrappers sharing the trees
+    long RefCount() const {
+        return Trees.RefCount();
+    }
+
     TModelTrees* GetMutable() {
         if (Trees.RefCount() > 1) {
             Trees = MakeAtomicShared<TModelTrees>(*Trees);
@@ -665,8 +733,15 @@ private:
     EFormulaEvaluatorType FormulaEvaluatorType = EFormulaEvaluatorType::CPU;
     TAdaptiveLock CurrentEvaluatorLock;
     mutable NCB::NModelEvaluation::TModelEvaluatorPtr Evaluator;
+    //! Keeps memory referenced by non owning model parts alive, empty for owning models
+    TBlob NonOwningData;
 public:
-    void InitNonOwning(const void* binaryBuffer, size_t dataSize);
+    void InitNonOwning(const void* binaryBuffer, size_t dataSize, bool lazyCtrTables = false);
+    /**
+     * Same as InitNonOwning(binaryBuffer, dataSize), but the model keeps a reference to the blob,
+     * so the blob may be a memory mapped file.
+     */
+    void InitNonOwning(TBlob binaryBlob, bool lazyCtrTables = false);
 
     static TVector<EFormulaEvaluatorType> GetSupportedEvaluatorTypes();
 
@@ -697,6 +772,16 @@ public:
         }
     }
 
+    //! Properties are evaluator specific and are lost when the evaluator type changes
+    void SetEvaluatorProperty(TStringBuf propName, TStringBuf propValue) const {
+        with_lock(CurrentEvaluatorLock) {
+            if (!Evaluator) {
+                Evaluator = NCB::NModelEvaluation::CreateEvaluator(FormulaEvaluatorType, *this);
+            }
+            Evaluator->SetProperty(propName, propValue);
+        }
+    }
+
     EFormulaEvaluatorType GetEvaluatorType() const {
         return FormulaEvaluatorType;
     }
@@ -720,6 +805,7 @@ public:
                 DoSwap(Evaluator, other.Evaluator);
             }
         }
+        DoSwap(NonOwningData, other.NonOwningData);
         DoSwap(TextProcessingCollection, other.TextProcessingCollection);
         DoSwap(EmbeddingProcessingCollection, other.EmbeddingProcessingCollection);
     }
@@ -773,6 +859,13 @@ public:
         UpdateDynamicData();
     }
 
+    /**
+     * Drop splits, features and CTR table buckets which do not affect predictions of the model.
+     * Resulting model is smaller and gives the same predictions, but CTR tables are no longer
+     * suitable for anything else than model application, e.g. for continuing training.
+     */
+    void CompactForApply();
+
     /**
      * @return Minimal float features vector length sufficient for this model
      */
@@ -856,11 +949,20 @@ public:
      */
     void Save(IOutputStream* s) const;
 
+    /**
+     * Serialize model to stream in the same format, with tree arrays, leaf values and CTR tables padded to
+     * start at multiples of arrayAlignment bytes from the stream start, so memory mapped model reads them aligned
+     * @param s IOutputStream ptr, should be at the start of a file for alignment to hold in it
+     * @param arrayAlignment power of 2
+     */
+    void SaveAligned(IOutputStream* s, size_t arrayAlignment = DEFAULT_MODEL_ARRAY_ALIGNMENT) const;
+
     /**
      * Deserialize model from stream
      * @param s IInputStream ptr
+     * @param lazyCtrTables use TLazyCtrProvider, which builds CTR tables on first use
      */
-    void Load(IInputStream* s);
+    void Load(IInputStream* s, bool lazyCtrTables = false);
 
     //! Check if TFullModel instance has valid CTR provider.
     // If no ctr features present it will return true
@@ -872,6 +974,16 @@ public:
         return CtrProvider->HasNeededCtrs(applyData->UsedModelCtrs);
     }
 
+    /**
+     * Select index used by CTR provider to find CTR values, see ECtrIndexType. Applies to all model copies
+     * sharing CtrProvider and should be called before evaluation, e.g. right after loading.
+     */
+    void SetCtrIndexType(ECtrIndexType indexType) {
+        if (CtrProvider) {
+            CtrProvider->SetIndexType(indexType);
+        }
+    }
+
     //! Check if TFullModel instance has valid Text processing collection
     bool HasValidTextProcessingCollection() const {
         return (bool) TextProcessingCollection;
@@ -886,6 +998,15 @@ public:
         return ModelTrees->GetScaleAndBias();
     }
 
+    //! Use trees of another wrapper, which should be equal to the model ones, e.g. to share them between models
+    void ShareModelTrees(const TCOWTreeWrapper& modelTrees) {
+        Y_ASSERT(*modelTrees == *ModelTrees);
+        ModelTrees = modelTrees;
+        with_lock(CurrentEvaluatorLock) {
+            Evaluator.Reset();
+        }
+    }
+
     //! Set normalization parameters for computing final formula from sum of trees
     void SetScaleAndBias(const TScaleAndBias& scaleAndBias) {
         ModelTrees.GetMutable()->SetScaleAndBias(scaleAndBias);
@@ -1346,11 +1467,17 @@ public:
     float GetActualShrinkCoef() const;
 
 private:
+    void SaveImpl(IOutputStream* s, size_t arrayAlignment) const;
     void DefaultFullModelInit(const NCatBoostFbs::TModelCore* fbModelCore);
 };
 
 void OutputModel(const TFullModel& model, TStringBuf modelFile);
 void OutputModel(const TFullModel& model, IOutputStream* out);
+// Same as OutputModel, but with arrays aligned in the file, see TFullModel::SaveAligned
+void OutputAlignedModel(
+    const TFullModel& model,
+    TStringBuf modelFile,
+    size_t arrayAlignment = DEFAULT_MODEL_ARRAY_ALIGNMENT);
 
 bool IsDeserializableModelFormat(EModelType format);
 
@@ -1359,7 +1486,14 @@ TFullModel ReadModel(
     const void* binaryBuffer,
     size_t binaryBufferSize,
     EModelType format = EModelType::CatboostBinary);
-TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize);
+TFullModel ReadZeroCopyModel(const void* binaryBuffer, size_t binaryBufferSize, bool lazyCtrTables = false);
+
+/**
+ * Memory-maps binary model file read-only and deserializes it without copying trees and CTR tables,
+ * so pages of the file are shared between all processes loading the same model.
+ * The file should not be modified while the model is alive.
+ */
+TFullModel ReadZeroCopyModel(const TString& modelFile, bool lazyCtrTables = false);
 
 /**
  * Serialize model to string
@@ -1390,7 +1524,8 @@ TFullModel SumModels(
     const TVector<const TFullModel*> modelVector,
     const TVector<double>& weights,
     const TVector<TString>& modelParamsPrefixes = TVector<TString>(), // can be empty - in this case default prefixes will be used
-    ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage);
+    ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage,
+    bool foldEqualTrees = false); // symmetric trees with equal splits are summed, see TModelTrees::FoldEqualTrees
 
 void SaveModelBorders(
     const TString& file,
@@ -151,6 +151,8 @@ namespace NCB {
             Out << NResource::Find("catboost_model_export_cpp_model_applicator");
         } else {
             Out << NResource::Find("catboost_model_export_cpp_model_applicator_without_cat");
+            Out << '\n';
+            Out << NResource::Find("catboost_model_export_cpp_model_batch_applicator_without_cat");
         }
     }
 
@@ -253,6 +255,8 @@ namespace NCB {
     void TCatboostModelToCppConverter::WriteHeader(bool forCatFeatures) {
         if (forCatFeatures) {
            Out << "#include <cassert>" << '\n';
+        } else {
+           Out << "#include <algorithm>" << '\n';
         }
         Out << "#include <string>" << '\n';
         Out << "#include <vector>" << '\n';
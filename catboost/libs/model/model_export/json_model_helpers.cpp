@@ -9,6 +9,7 @@
 #include <library/cpp/json/json_reader.h>
 #include <library/cpp/json/json_writer.h>
 
+#include <util/generic/map.h>
 #include <util/generic/set.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
@@ -290,39 +291,57 @@ static void GetFeaturesInfo(const TJsonValue& jsonValue, TModelTrees* modelTrees
     }
 }
 
-static TJsonValue GetObliviousModelTreesJson(const TModelTrees& modelTrees) {
-    int leafValuesOffset = 0;
-    int leafWeightsOffset = 0;
-    TJsonValue jsonValue;
+static TJsonValue GetObliviousTreeJson(
+    const TModelTrees& modelTrees,
+    int treeIdx,
+    size_t leafValuesOffset,
+    size_t leafWeightsOffset
+) {
+    TJsonValue tree;
     const auto& binFeatures = modelTrees.GetBinFeatures();
+    const size_t treeLeafCount = (1uLL << modelTrees.GetModelTreeData()->GetTreeSizes()[treeIdx]) * modelTrees.GetDimensionsCount();
+    const size_t treeWeightsCount = (1uLL << modelTrees.GetModelTreeData()->GetTreeSizes()[treeIdx]);
+    if (!modelTrees.GetModelTreeData()->GetLeafWeights().empty()) {
+        for (size_t idx = 0; idx < treeWeightsCount; ++idx) {
+            tree["leaf_weights"].AppendValue(modelTrees.GetModelTreeData()->GetLeafWeights()[leafWeightsOffset + idx]);
+        }
+    }
+    tree.InsertValue("leaf_values", TJsonValue());
+    for (size_t idx = 0; idx < treeLeafCount; ++idx) {
+        tree["leaf_values"].AppendValue(modelTrees.GetModelTreeData()->GetLeafValues()[leafValuesOffset + idx]);
+    }
+    int treeSplitEnd;
+    if (treeIdx + 1 < modelTrees.GetModelTreeData()->GetTreeStartOffsets().ysize()) {
+        treeSplitEnd = modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx + 1];
+    } else {
+        treeSplitEnd = modelTrees.GetModelTreeData()->GetTreeSplits().ysize();
+    }
+    tree.InsertValue("splits", TJsonValue());
+    for (int idx = modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx]; idx < treeSplitEnd; ++idx) {
+        tree["splits"].AppendValue(ToJson(binFeatures[modelTrees.GetModelTreeData()->GetTreeSplits()[idx]]));
+        tree["splits"].Back().InsertValue("split_index", modelTrees.GetModelTreeData()->GetTreeSplits()[idx]);
+    }
+    return tree;
+}
+
+// calls f(treeJson) for trees in order, only one tree json exists at a time
+template <class TFunc>
+static void ForEachObliviousTreeJson(const TModelTrees& modelTrees, const TFunc& f) {
+    size_t leafValuesOffset = 0;
+    size_t leafWeightsOffset = 0;
     for (int treeIdx = 0; treeIdx < modelTrees.GetModelTreeData()->GetTreeSizes().ysize(); ++treeIdx) {
-        TJsonValue tree;
-        const size_t treeLeafCount = (1uLL << modelTrees.GetModelTreeData()->GetTreeSizes()[treeIdx]) * modelTrees.GetDimensionsCount();
+        f(GetObliviousTreeJson(modelTrees, treeIdx, leafValuesOffset, leafWeightsOffset));
         const size_t treeWeightsCount = (1uLL << modelTrees.GetModelTreeData()->GetTreeSizes()[treeIdx]);
-        if (!modelTrees.GetModelTreeData()->GetLeafWeights().empty()) {
-            for (size_t idx = 0; idx < treeWeightsCount; ++idx) {
-                tree["leaf_weights"].AppendValue(modelTrees.GetModelTreeData()->GetLeafWeights()[leafWeightsOffset + idx]);
-            }
-        }
-        tree.InsertValue("leaf_values", TJsonValue());
-        for (size_t idx = 0; idx < treeLeafCount; ++idx) {
-            tree["leaf_values"].AppendValue(modelTrees.GetModelTreeData()->GetLeafValues()[leafValuesOffset + idx]);
-        }
-        leafValuesOffset += treeLeafCount;
+        leafValuesOffset += treeWeightsCount * modelTrees.GetDimensionsCount();
         leafWeightsOffset += treeWeightsCount;
-        int treeSplitEnd;
-        if (treeIdx + 1 < modelTrees.GetModelTreeData()->GetTreeStartOffsets().ysize()) {
-            treeSplitEnd = modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx + 1];
-        } else {
-            treeSplitEnd = modelTrees.GetModelTreeData()->GetTreeSplits().ysize();
-        }
-        tree.InsertValue("splits", TJsonValue());
-        for (int idx = modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx]; idx < treeSplitEnd; ++idx) {
-            tree["splits"].AppendValue(ToJson(binFeatures[modelTrees.GetModelTreeData()->GetTreeSplits()[idx]]));
-            tree["splits"].Back().InsertValue("split_index", modelTrees.GetModelTreeData()->GetTreeSplits()[idx]);
-        }
-        jsonValue.AppendValue(tree);
     }
+}
+
+static TJsonValue GetObliviousModelTreesJson(const TModelTrees& modelTrees) {
+    TJsonValue jsonValue;
+    ForEachObliviousTreeJson(modelTrees, [&] (TJsonValue&& tree) {
+        jsonValue.AppendValue(std::move(tree));
+    });
     return jsonValue;
 }
 
@@ -355,11 +374,19 @@ static TJsonValue BuildTreeJson(const TModelTrees& modelTrees, ui32 nodeIdx) {
     return tree;
 }
 
-static TJsonValue GetNonSymmetricModelTreesJson(const TModelTrees& modelTrees) {
-    TJsonValue jsonValue(JSON_ARRAY);
+// calls f(treeJson) for trees in order, only one tree json exists at a time
+template <class TFunc>
+static void ForEachNonSymmetricTreeJson(const TModelTrees& modelTrees, const TFunc& f) {
     for (int treeIdx = 0; treeIdx < modelTrees.GetModelTreeData()->GetTreeSizes().ysize(); ++treeIdx) {
-        jsonValue.AppendValue(BuildTreeJson(modelTrees, modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx]));
+        f(BuildTreeJson(modelTrees, modelTrees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx]));
     }
+}
+
+static TJsonValue GetNonSymmetricModelTreesJson(const TModelTrees& modelTrees) {
+    TJsonValue jsonValue(JSON_ARRAY);
+    ForEachNonSymmetricTreeJson(modelTrees, [&] (TJsonValue&& tree) {
+        jsonValue.AppendValue(std::move(tree));
+    });
     return jsonValue;
 }
 
@@ -371,120 +398,192 @@ static TJsonValue GetModelTreesJson(const TModelTrees& modelTrees) {
     }
 }
 
+// writes the same json as GetModelTreesJson without building json of all trees
+static void WriteModelTreesJson(const TModelTrees& modelTrees, TJsonWriter* writer) {
+    const auto writeTree = [writer] (const TJsonValue& tree) {
+        writer->Write(tree);
+    };
+    if (modelTrees.IsOblivious()) {
+        if (modelTrees.GetModelTreeData()->GetTreeSizes().empty()) {
+            writer->WriteNull();
+            return;
+        }
+        writer->OpenArray();
+        ForEachObliviousTreeJson(modelTrees, writeTree);
+        writer->CloseArray();
+    } else {
+        writer->OpenArray();
+        ForEachNonSymmetricTreeJson(modelTrees, writeTree);
+        writer->CloseArray();
+    }
+}
+
+static void AddObliviousTree(const TJsonValue& value, TModelTrees* modelTrees) {
+    for (const auto& leaf: value["leaf_values"].GetArray()) {
+        modelTrees->AddLeafValue(leaf.GetDouble());
+    }
+    int treeSize = value["splits"].GetArray().ysize();
+    modelTrees->AddTreeSize(treeSize);
+    modelTrees->SetApproxDimension(value["leaf_values"].GetArray().ysize() / (1uLL << treeSize));
+    for (const auto& split: value["splits"].GetArray()) {
+        modelTrees->AddTreeSplit(split["split_index"].GetInteger());
+    }
+    if (value.Has("leaf_weights")) {
+        for (const auto& weight: value["leaf_weights"].GetArray()) {
+            modelTrees->AddLeafWeight(weight.GetDouble());
+        }
+    }
+}
+
 static void GetObliviousModelTrees(const TJsonValue& jsonValue, TModelTrees* modelTrees) {
     for (const auto& value: jsonValue.GetArray()) {
-        for (const auto& leaf: value["leaf_values"].GetArray()) {
-            modelTrees->AddLeafValue(leaf.GetDouble());
-        }
-        int treeSize = value["splits"].GetArray().ysize();
-        modelTrees->AddTreeSize(treeSize);
-        modelTrees->SetApproxDimension(value["leaf_values"].GetArray().ysize() / (1uLL << treeSize));
-        for (const auto& split: value["splits"].GetArray()) {
-            modelTrees->AddTreeSplit(split["split_index"].GetInteger());
-        }
-        if (value.Has("leaf_weights")) {
-            for (const auto& weight: value["leaf_weights"].GetArray()) {
-                modelTrees->AddLeafWeight(weight.GetDouble());
-            }
-        }
+        AddObliviousTree(value, modelTrees);
     }
 }
 
-static void GetNonSymmetricModelTrees(const TJsonValue& jsonValue, TModelTrees* modelTrees) {
-    TVector<TNonSymmetricTreeStepNode> nodes;
-    TVector<ui32> nodeIdToLeafId;
-    const std::function<int(const TJsonValue&)> readTreeFromJson = [modelTrees, &nodes, &nodeIdToLeafId, &readTreeFromJson](const TJsonValue& jsonNode) {
-        int nodeIdx = nodes.size();
-        nodes.emplace_back(TNonSymmetricTreeStepNode{0, 0});
-        if (jsonNode.Has("value")) {
-            const TJsonValue& value = jsonNode["value"];
-            nodeIdToLeafId.push_back(modelTrees->GetModelTreeData()->GetLeafValues().size());
-            modelTrees->AddTreeSplit(0);
-            if (value.GetType() == EJsonValueType::JSON_ARRAY) {
-                modelTrees->SetApproxDimension(value.GetArray().ysize());
-                for (const auto& singleValue : value.GetArray()) {
-                    modelTrees->AddLeafValue(singleValue.GetDouble());
+namespace {
+    // step nodes of non symmetric trees are set to the model after all trees are added
+    class TNonSymmetricModelTreesBuilder {
+    public:
+        explicit TNonSymmetricModelTreesBuilder(TModelTrees* modelTrees)
+            : ModelTrees(modelTrees)
+        {
+        }
+
+        void AddTree(const TJsonValue& treeJson) {
+            int oldNodesCount = Nodes.size();
+            ReadTreeFromJson(treeJson);
+            ModelTrees->AddTreeSize(Nodes.size() - oldNodesCount);
+        }
+
+        void Finish() {
+            ModelTrees->SetNonSymmetricStepNodes(std::move(Nodes));
+            ModelTrees->SetNonSymmetricNodeIdToLeafId(std::move(NodeIdToLeafId));
+        }
+
+    private:
+        int ReadTreeFromJson(const TJsonValue& jsonNode) {
+            int nodeIdx = Nodes.size();
+            Nodes.emplace_back(TNonSymmetricTreeStepNode{0, 0});
+            if (jsonNode.Has("value")) {
+                const TJsonValue& value = jsonNode["value"];
+                NodeIdToLeafId.push_back(ModelTrees->GetModelTreeData()->GetLeafValues().size());
+                ModelTrees->AddTreeSplit(0);
+                if (value.GetType() == EJsonValueType::JSON_ARRAY) {
+                    ModelTrees->SetApproxDimension(value.GetArray().ysize());
+                    for (const auto& singleValue : value.GetArray()) {
+                        ModelTrees->AddLeafValue(singleValue.GetDouble());
+                    }
+                } else {
+                    ModelTrees->AddLeafValue(value.GetDouble());
+                }
+                if (jsonNode.Has("weight")) {
+                    ModelTrees->AddLeafWeight(jsonNode["weight"].GetDouble());
                 }
             } else {
-                modelTrees->AddLeafValue(value.GetDouble());
-            }
-            if (jsonNode.Has("weight")) {
-                modelTrees->AddLeafWeight(jsonNode["weight"].GetDouble());
+                NodeIdToLeafId.push_back(Max<ui32>());
+                ModelTrees->AddTreeSplit(jsonNode["split"]["split_index"].GetInteger());
+                Nodes[nodeIdx].LeftSubtreeDiff = ReadTreeFromJson(jsonNode["left"]) - nodeIdx;
+                Nodes[nodeIdx].RightSubtreeDiff = ReadTreeFromJson(jsonNode["right"]) - nodeIdx;
             }
-        } else {
-            nodeIdToLeafId.push_back(Max<ui32>());
-            modelTrees->AddTreeSplit(jsonNode["split"]["split_index"].GetInteger());
-            nodes[nodeIdx].LeftSubtreeDiff = readTreeFromJson(jsonNode["left"]) - nodeIdx;
-            nodes[nodeIdx].RightSubtreeDiff = readTreeFromJson(jsonNode["right"]) - nodeIdx;
+            return nodeIdx;
         }
-        return nodeIdx;
+
+    private:
+        TModelTrees* ModelTrees;
+        TVector<TNonSymmetricTreeStepNode> Nodes;
+        TVector<ui32> NodeIdToLeafId;
     };
+}
+
+static void GetNonSymmetricModelTrees(const TJsonValue& jsonValue, TModelTrees* modelTrees) {
+    TNonSymmetricModelTreesBuilder builder(modelTrees);
     for (const auto& treeJson : jsonValue.GetArray()) {
-        int oldNodesCount = nodes.size();
-        readTreeFromJson(treeJson);
-        modelTrees->AddTreeSize(nodes.size() - oldNodesCount);
+        builder.AddTree(treeJson);
     }
-    modelTrees->SetNonSymmetricStepNodes(std::move(nodes));
-    modelTrees->SetNonSymmetricNodeIdToLeafId(std::move(nodeIdToLeafId));
+    builder.Finish();
 }
 
-static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider, const TConstArrayRef<TModelCtr> neededCtrs) {
-    NJson::TJsonValue jsonValue;
-    if (neededCtrs.empty()) {
-        return jsonValue;
-    }
+// ordered by json keys, as ctrs are written with sorted keys
+static TMap<TString, const TModelCtr*> GetCtrsByJsonKey(const TConstArrayRef<TModelCtr> neededCtrs) {
+    TMap<TString, const TModelCtr*> ctrsByKey;
     auto compressedModelCtrs = NCB::CompressModelCtrs(neededCtrs);
     for (size_t idx = 0; idx < compressedModelCtrs.size(); ++idx) {
         auto& proj = *compressedModelCtrs[idx].Projection;
         for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
-            NJson::TJsonValue hashValue;
-            auto& learnCtr = ctrProvider->CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
-            const ECtrType ctrType = ctr->Base.CtrType;
-            TSet<ui64> hashIndexes;
-            for (const auto& bucket: hashIndexResolver.GetBuckets()) {
-                auto value = bucket.IndexValue;
-                if (value == NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                    continue;
-                }
-                if (hashIndexes.find(bucket.Hash) != hashIndexes.end()) {
-                    continue;
-                } else {
-                    hashIndexes.insert(bucket.Hash);
-                }
-                hashValue.AppendValue(ToString(bucket.Hash));
-                if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                    if (value != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
-                        const TCtrMeanHistory& ctrMeanHistory = ctrMean[value];
-                        hashValue.AppendValue(ctrMeanHistory.Sum);
-                        hashValue.AppendValue(ctrMeanHistory.Count);
-                    }
-                } else  if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                    TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                    hashValue.AppendValue(ctrTotal[value]);
-                } else {
-                    auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                    const int targetClassesCount = learnCtr.TargetClassesCount;
-                    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + value * targetClassesCount, targetClassesCount);
-                    for (int classId = 0; classId < targetClassesCount; ++classId) {
-                        hashValue.AppendValue(ctrHistory[classId]);
-                    }
-                }
-            }
-            NJson::TJsonValue hash;
-            hash["hash_map"] = hashValue;
-            hash["hash_stride"] =  hashValue.GetArray().ysize() / hashIndexes.size();
-            hash["counter_denominator"] = learnCtr.CounterDenominator;
             TModelCtrBase modelCtrBase;
             modelCtrBase.Projection = proj;
-            modelCtrBase.CtrType = ctrType;
-            jsonValue.InsertValue(ModelCtrBaseToStr(modelCtrBase), hash);
+            modelCtrBase.CtrType = ctr->Base.CtrType;
+            ctrsByKey[ModelCtrBaseToStr(modelCtrBase)] = ctr;
         }
     }
+    return ctrsByKey;
+}
+
+static NJson::TJsonValue ConvertCtrValueTableToJson(const TStaticCtrProvider* ctrProvider, const TModelCtr& ctr) {
+    NJson::TJsonValue hashValue;
+    auto& learnCtr = ctrProvider->CtrData.LearnCtrs.at(ctr.Base);
+    auto hashIndexResolver = learnCtr.GetIndexHashViewer();
+    const ECtrType ctrType = ctr.Base.CtrType;
+    TSet<ui64> hashIndexes;
+    for (const auto& bucket: hashIndexResolver.GetBuckets()) {
+        auto value = bucket.IndexValue;
+        if (value == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+            continue;
+        }
+        if (hashIndexes.find(bucket.Hash) != hashIndexes.end()) {
+            continue;
+        } else {
+            hashIndexes.insert(bucket.Hash);
+        }
+        hashValue.AppendValue(ToString(bucket.Hash));
+        if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+            if (value != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
+                const TCtrMeanHistory& ctrMeanHistory = ctrMean[value];
+                hashValue.AppendValue(ctrMeanHistory.Sum);
+                hashValue.AppendValue(ctrMeanHistory.Count);
+            }
+        } else  if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+            TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
+            hashValue.AppendValue(ctrTotal[value]);
+        } else {
+            auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
+            const int targetClassesCount = learnCtr.TargetClassesCount;
+            auto ctrHistory = MakeArrayRef(ctrIntArray.data() + value * targetClassesCount, targetClassesCount);
+            for (int classId = 0; classId < targetClassesCount; ++classId) {
+                hashValue.AppendValue(ctrHistory[classId]);
+            }
+        }
+    }
+    NJson::TJsonValue hash;
+    hash["hash_map"] = hashValue;
+    hash["hash_stride"] =  hashValue.GetArray().ysize() / hashIndexes.size();
+    hash["counter_denominator"] = learnCtr.CounterDenominator;
+    return hash;
+}
+
+static NJson::TJsonValue ConvertCtrsToJson(const TStaticCtrProvider* ctrProvider, const TConstArrayRef<TModelCtr> neededCtrs) {
+    NJson::TJsonValue jsonValue;
+    for (const auto& [key, ctr] : GetCtrsByJsonKey(neededCtrs)) {
+        jsonValue.InsertValue(key, ConvertCtrValueTableToJson(ctrProvider, *ctr));
+    }
     return jsonValue;
 }
 
+// writes the same json as ConvertCtrsToJson building json of one ctr table at a time
+static void WriteCtrsJson(const TStaticCtrProvider* ctrProvider, const TConstArrayRef<TModelCtr> neededCtrs, TJsonWriter* writer) {
+    if (neededCtrs.empty()) {
+        writer->WriteNull();
+        return;
+    }
+    writer->OpenMap();
+    for (const auto& [key, ctr] : GetCtrsByJsonKey(neededCtrs)) {
+        writer->Write(key, ConvertCtrValueTableToJson(ctrProvider, *ctr));
+    }
+    writer->CloseMap();
+}
+
 static TJsonValue GetScaleAndBiasJson(const TFullModel& model) {
     TJsonValue jsonValue;
     jsonValue.AppendValue(model.GetScaleAndBias().Scale);
@@ -496,8 +595,7 @@ static TJsonValue GetScaleAndBiasJson(const TFullModel& model) {
     return jsonValue;
 }
 
-TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
-    TJsonValue jsonModel;
+static TJsonValue GetModelInfoJson(const TFullModel& model) {
     TJsonValue modelInfo;
     for (const auto& key_value : model.ModelInfo) {
         if (key_value.first.EndsWith("params")) {
@@ -511,7 +609,12 @@ TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* f
             modelInfo.InsertValue(key_value.first, key_value.second);
         }
     }
-    jsonModel.InsertValue("model_info", modelInfo);
+    return modelInfo;
+}
+
+TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
+    TJsonValue jsonModel;
+    jsonModel.InsertValue("model_info", GetModelInfoJson(model));
     if (model.IsOblivious()) {
         jsonModel.InsertValue("oblivious_trees", GetModelTreesJson(*model.ModelTrees));
     } else {
@@ -527,63 +630,80 @@ TJsonValue ConvertModelToJson(const TFullModel& model, const TVector<TString>* f
     return jsonModel;
 }
 
-static TCtrData CtrDataFromJson(const TJsonValue& jsonValue) {
-    TCtrData ctrData;
-    for (const auto& key: jsonValue.GetMap()) {
-        TModelCtrBase ctrBase = ModelCtrBaseFromString(key.first);
-        TCtrValueTable learnCtr;
-        learnCtr.ModelCtrBase = ctrBase;
-        auto& ctrType = ctrBase.CtrType;
-        const auto& hashJson = key.second;
-        int hashStride = hashJson["hash_stride"].GetInteger();
-        const auto& hashMap = hashJson["hash_map"].GetArray();
-        auto blobSize = hashMap.ysize() / hashStride;
-        auto indexHashBuilder = learnCtr.GetIndexHashBuilder(blobSize);
-
-        size_t targetClassesCount = hashStride - 1;
-
-        TArrayRef<int> ctrIntArray;
-        TArrayRef<TCtrMeanHistory> ctrMean;
+static void AddCtrValueTable(TStringBuf key, const TJsonValue& hashJson, TCtrData* ctrData) {
+    TModelCtrBase ctrBase = ModelCtrBaseFromString(TString(key));
+    TCtrValueTable learnCtr;
+    learnCtr.ModelCtrBase = ctrBase;
+    auto& ctrType = ctrBase.CtrType;
+    int hashStride = hashJson["hash_stride"].GetInteger();
+    const auto& hashMap = hashJson["hash_map"].GetArray();
+    auto blobSize = hashMap.ysize() / hashStride;
+    auto indexHashBuilder = learnCtr.GetIndexHashBuilder(blobSize);
+
+    size_t targetClassesCount = hashStride - 1;
+
+    TArrayRef<int> ctrIntArray;
+    TArrayRef<TCtrMeanHistory> ctrMean;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        ctrMean = learnCtr.AllocateBlobAndGetArrayRef<TCtrMeanHistory>(blobSize);
+    } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        ctrIntArray = learnCtr.AllocateBlobAndGetArrayRef<int>(blobSize);
+        learnCtr.CounterDenominator = hashJson["counter_denominator"].GetInteger();
+    } else {
+        ctrIntArray = learnCtr.AllocateBlobAndGetArrayRef<int>(blobSize * targetClassesCount);
+        learnCtr.TargetClassesCount = targetClassesCount;
+    }
+
+    for(auto hashPtr = hashMap.begin(); hashPtr != hashMap.end();) {
+        ui64 hashValue = FromString<ui64>(hashPtr->GetString());
+        hashPtr++;
+        auto index = indexHashBuilder.AddIndex(hashValue);
+
         if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-            ctrMean = learnCtr.AllocateBlobAndGetArrayRef<TCtrMeanHistory>(blobSize);
+            ctrMean[index].Sum = hashPtr->GetInteger();
+            hashPtr++;
+            ctrMean[index].Count = hashPtr->GetInteger();
+            hashPtr++;
         } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-            ctrIntArray = learnCtr.AllocateBlobAndGetArrayRef<int>(blobSize);
-            learnCtr.CounterDenominator = hashJson["counter_denominator"].GetInteger();
-        } else {
-            ctrIntArray = learnCtr.AllocateBlobAndGetArrayRef<int>(blobSize * targetClassesCount);
-            learnCtr.TargetClassesCount = targetClassesCount;
-        }
-
-        for(auto hashPtr = hashMap.begin(); hashPtr != hashMap.end();) {
-            ui64 hashValue = FromString<ui64>(hashPtr->GetString());
+            ctrIntArray[index] = hashPtr->GetInteger();
             hashPtr++;
-            auto index = indexHashBuilder.AddIndex(hashValue);
-
-            if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                ctrMean[index].Sum = hashPtr->GetInteger();
-                hashPtr++;
-                ctrMean[index].Count = hashPtr->GetInteger();
-                hashPtr++;
-            } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                ctrIntArray[index] = hashPtr->GetInteger();
+        } else {
+            for (size_t idx = index * targetClassesCount; idx < (index + 1) * targetClassesCount; ++idx) {
+                ctrIntArray[idx] = hashPtr->GetInteger();
                 hashPtr++;
-            } else {
-                for (size_t idx = index * targetClassesCount; idx < (index + 1) * targetClassesCount; ++idx) {
-                    ctrIntArray[idx] = hashPtr->GetInteger();
-                    hashPtr++;
-                }
             }
         }
+    }
 
-        ctrData.LearnCtrs[ctrBase] = learnCtr;
+    ctrData->LearnCtrs[ctrBase] = std::move(learnCtr);
+}
+
+static TCtrData CtrDataFromJson(const TJsonValue& jsonValue) {
+    TCtrData ctrData;
+    for (const auto& key: jsonValue.GetMap()) {
+        AddCtrValueTable(key.first, key.second, &ctrData);
     }
     return ctrData;
 }
 
-void ConvertJsonToCatboostModel(const TJsonValue& jsonModel, TFullModel* fullModel) {
-    for (const auto& key_value : jsonModel["model_info"].GetMap()) {
+static void SetModelInfo(const TJsonValue& jsonValue, TFullModel* fullModel) {
+    for (const auto& key_value : jsonValue.GetMap()) {
         fullModel->ModelInfo[key_value.first] = key_value.second.GetStringRobust();
     }
+}
+
+static void SetScaleAndBias(const TJsonValue& jsonValue, TFullModel* fullModel) {
+    const auto& scaleAndBias = jsonValue.GetArray();
+    double scale = scaleAndBias[0].GetDouble();
+    TVector<double> bias;
+    for (const auto& biasValue : scaleAndBias[1].GetArray()) {
+        bias.push_back(biasValue.GetDouble());
+    }
+    fullModel->SetScaleAndBias({scale, bias});
+}
+
+void ConvertJsonToCatboostModel(const TJsonValue& jsonModel, TFullModel* fullModel) {
+    SetModelInfo(jsonModel["model_info"], fullModel);
     if (jsonModel.Has("oblivious_trees")) {
         GetObliviousModelTrees(jsonModel["oblivious_trees"], fullModel->ModelTrees.GetMutable());
     } else {
@@ -595,20 +715,253 @@ void ConvertJsonToCatboostModel(const TJsonValue& jsonModel, TFullModel* fullMod
         fullModel->CtrProvider = new TStaticCtrProvider(ctrData);
     }
     if (jsonModel.Has("scale_and_bias")) {
-        const auto& scaleAndBias = jsonModel["scale_and_bias"].GetArray();
-        double scale = scaleAndBias[0].GetDouble();
-        TVector<double> bias;
-        for (const auto& biasValue : scaleAndBias[1].GetArray()) {
-            bias.push_back(biasValue.GetDouble());
-        }
-        fullModel->SetScaleAndBias({scale, bias});
+        SetScaleAndBias(jsonModel["scale_and_bias"], fullModel);
     }
 
     fullModel->UpdateDynamicData();
 }
 
+namespace {
+    /* Builds the model from events of the streaming json reader.
+     * Trees and ctr tables are parsed as separate json values and added to the model as soon as they end,
+     * so only one of them is held in json form at a time instead of the json of the whole model.
+     * Other sections are small and are converted after the end of the model json.
+     */
+    class TJsonModelBuilder : public TJsonCallbacks {
+    public:
+        explicit TJsonModelBuilder(TFullModel* fullModel)
+            : TJsonCallbacks(/*throwException*/ true)
+            , FullModel(fullModel)
+            , NonSymmetricTreesBuilder(fullModel->ModelTrees.GetMutable())
+        {
+        }
+
+        bool OnNull() override {
+            if (!Element && (Depth == 1) && (Section != ESection::Other)) {
+                // empty trees or ctrs are written as null
+                SetSectionIsPresent();
+                return true;
+            }
+            return OnScalar([] (TJsonCallbacks* callbacks) { return callbacks->OnNull(); });
+        }
+
+        bool OnBoolean(bool value) override {
+            return OnScalar([=] (TJsonCallbacks* callbacks) { return callbacks->OnBoolean(value); });
+        }
+
+        bool OnInteger(long long value) override {
+            return OnScalar([=] (TJsonCallbacks* callbacks) { return callbacks->OnInteger(value); });
+        }
+
+        bool OnUInteger(unsigned long long value) override {
+            return OnScalar([=] (TJsonCallbacks* callbacks) { return callbacks->OnUInteger(value); });
+        }
+
+        bool OnDouble(double value) override {
+            return OnScalar([=] (TJsonCallbacks* callbacks) { return callbacks->OnDouble(value); });
+        }
+
+        bool OnString(const TStringBuf& value) override {
+            return OnScalar([=] (TJsonCallbacks* callbacks) { return callbacks->OnString(value); });
+        }
+
+        bool OnOpenMap() override {
+            return OnOpen([] (TJsonCallbacks* callbacks) { return callbacks->OnOpenMap(); });
+        }
+
+        bool OnCloseMap() override {
+            return OnClose([] (TJsonCallbacks* callbacks) { return callbacks->OnCloseMap(); });
+        }
+
+        bool OnOpenArray() override {
+            return OnOpen([] (TJsonCallbacks* callbacks) { return callbacks->OnOpenArray(); });
+        }
+
+        bool OnCloseArray() override {
+            return OnClose([] (TJsonCallbacks* callbacks) { return callbacks->OnCloseArray(); });
+        }
+
+        bool OnMapKey(const TStringBuf& key) override {
+            if (Element) {
+                return Element->OnMapKey(key);
+            }
+            if (Depth == 1) {
+                SectionKey = key;
+                if (key == "oblivious_trees") {
+                    Section = ESection::ObliviousTrees;
+                } else if (key == "trees") {
+                    Section = ESection::NonSymmetricTrees;
+                } else if (key == "ctr_data") {
+                    Section = ESection::CtrData;
+                } else {
+                    Section = ESection::Other;
+                }
+                return true;
+            }
+            CB_ENSURE((Depth == 2) && (Section == ESection::CtrData), "Unexpected key " << key << " in json model");
+            CtrKey = key;
+            return true;
+        }
+
+        void Finish() {
+            CB_ENSURE(Depth == 0, "Json model is not finished");
+            if (!HasObliviousTrees) {
+                NonSymmetricTreesBuilder.Finish();
+            }
+            TModelTrees* modelTrees = FullModel->ModelTrees.GetMutable();
+            SetModelInfo(OtherSections["model_info"], FullModel);
+            GetFeaturesInfo(OtherSections["features_info"], modelTrees);
+            if (HasCtrData) {
+                FullModel->CtrProvider = new TStaticCtrProvider(CtrData);
+            }
+            if (OtherSections.Has("scale_and_bias")) {
+                SetScaleAndBias(OtherSections["scale_and_bias"], FullModel);
+            }
+
+            FullModel->UpdateDynamicData();
+        }
+
+    private:
+        enum class ESection {
+            Other,
+            ObliviousTrees,
+            NonSymmetricTrees,
+            CtrData
+        };
+
+    private:
+        // values of other sections and elements of trees and ctr_data sections are parsed as separate json values
+        bool IsElementStart() const {
+            return ((Depth == 1) && (Section == ESection::Other)) || ((Depth == 2) && (Section != ESection::Other));
+        }
+
+        void SetSectionIsPresent() {
+            if (Section == ESection::ObliviousTrees) {
+                HasObliviousTrees = true;
+            } else if (Section == ESection::CtrData) {
+                HasCtrData = true;
+            }
+        }
+
+        void StartElement() {
+            ElementValue = TJsonValue();
+            Element = MakeHolder<TParserCallbacks>(ElementValue, /*throwOnError*/ true);
+            ElementDepth = 0;
+        }
+
+        void FinishElement() {
+            Element.Destroy();
+            switch (Section) {
+                case ESection::ObliviousTrees:
+                    AddObliviousTree(ElementValue, FullModel->ModelTrees.GetMutable());
+                    break;
+                case ESection::NonSymmetricTrees:
+                    NonSymmetricTreesBuilder.AddTree(ElementValue);
+                    break;
+                case ESection::CtrData:
+                    AddCtrValueTable(CtrKey, ElementValue, &CtrData);
+                    break;
+                case ESection::Other:
+                    OtherSections.InsertValue(SectionKey, std::move(ElementValue));
+                    break;
+            }
+            ElementValue = TJsonValue();
+        }
+
+        template <class TForward>
+        bool OnScalar(const TForward& forward) {
+            if (Element) {
+                return forward(Element.Get());
+            }
+            CB_ENSURE(IsElementStart(), "Unexpected value in json model");
+            StartElement();
+            const bool result = forward(Element.Get());
+            FinishElement();
+            return result;
+        }
+
+        template <class TForward>
+        bool OnOpen(const TForward& forward) {
+            if (!Element && IsElementStart()) {
+                StartElement();
+            }
+            if (Element) {
+                ++ElementDepth;
+                return forward(Element.Get());
+            }
+            CB_ENSURE(Depth < 2, "Unexpected value in json model");
+            ++Depth;
+            if (Depth == 2) {
+                SetSectionIsPresent();
+            }
+            return true;
+        }
+
+        template <class TForward>
+        bool OnClose(const TForward& forward) {
+            if (Element) {
+                const bool result = forward(Element.Get());
+                if (--ElementDepth == 0) {
+                    FinishElement();
+                }
+                return result;
+            }
+            --Depth;
+            return true;
+        }
+
+    private:
+        TFullModel* FullModel;
+
+        // nesting of model json, section values and their elements are not counted
+        int Depth = 0;
+        ESection Section = ESection::Other;
+        TString SectionKey;
+        TString CtrKey;
+
+        THolder<TParserCallbacks> Element;
+        TJsonValue ElementValue;
+        int ElementDepth = 0;
+
+        bool HasObliviousTrees = false;
+        TNonSymmetricModelTreesBuilder NonSymmetricTreesBuilder;
+        bool HasCtrData = false;
+        TCtrData CtrData;
+        TJsonValue OtherSections;
+    };
+}
+
+void ConvertJsonToCatboostModel(IInputStream* jsonModelStream, TFullModel* fullModel) {
+    TJsonModelBuilder modelBuilder(fullModel);
+    CB_ENSURE(ReadJson(jsonModelStream, &modelBuilder), "Json model deserialization failed");
+    modelBuilder.Finish();
+}
+
 void OutputModelJson(const TFullModel& model, const TString& outputPath, const TVector<TString>* featureId, const THashMap<ui32, TString>* catFeaturesHashToString) {
     TOFStream out(outputPath);
-    auto jsonModel = ConvertModelToJson(model, featureId, catFeaturesHashToString);
-    WriteJsonWithCatBoostPrecision(jsonModel, true, &out);
+    auto config = GetCatBoostPrecisionJsonWriterConfig(/*formatOutput*/ true);
+    config.Unbuffered = true;
+    TJsonWriter writer(&out, config);
+
+    // the same json as ConvertModelToJson, but trees and ctr tables are converted to json one at a time,
+    // sections are written in the sorted order of their keys
+    writer.OpenMap();
+    const TStaticCtrProvider* ctrProvider = dynamic_cast<TStaticCtrProvider*>(model.CtrProvider.Get());
+    if (ctrProvider) {
+        writer.WriteKey("ctr_data");
+        WriteCtrsJson(ctrProvider, model.ModelTrees->GetApplyData()->UsedModelCtrs, &writer);
+    }
+    writer.Write("features_info", GetFeaturesInfoJson(*model.ModelTrees, featureId, catFeaturesHashToString));
+    writer.Write("model_info", GetModelInfoJson(model));
+    if (model.IsOblivious()) {
+        writer.WriteKey("oblivious_trees");
+        WriteModelTreesJson(*model.ModelTrees, &writer);
+    }
+    writer.Write("scale_and_bias", GetScaleAndBiasJson(model));
+    if (!model.IsOblivious()) {
+        writer.WriteKey("trees");
+        WriteModelTreesJson(*model.ModelTrees, &writer);
+    }
+    writer.CloseMap();
+    writer.Flush();
 }
@@ -4,6 +4,8 @@
 
 #include <library/cpp/json/json_value.h>
 
+#include <util/stream/fwd.h>
+
 NJson::TJsonValue ConvertModelToJson(
     const TFullModel& model,
     const TVector<TString>* featureId=nullptr,
@@ -17,4 +19,7 @@ void OutputModelJson(
 
 void ConvertJsonToCatboostModel(const NJson::TJsonValue& jsonModel, TFullModel* fullModel);
 
+// reads trees and ctr tables one at a time without building the json of the whole model
+void ConvertJsonToCatboostModel(IInputStream* jsonModelStream, TFullModel* fullModel);
+
 TString ModelCtrBaseToStr(const TModelCtrBase& modelCtrBase);
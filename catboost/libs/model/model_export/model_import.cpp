@@ -5,8 +5,6 @@
 #include <catboost/private/libs/options/json_helper.h>
 #include <catboost/libs/model/model_export/onnx_helpers.h>
 
-#include <library/cpp/json/json_reader.h>
-
 #include <contrib/libs/coreml/TreeEnsemble.pb.h>
 #include <contrib/libs/coreml/Model.pb.h>
 
@@ -20,9 +18,7 @@ namespace NCB {
     public:
         TFullModel ReadModel(IInputStream* modelStream) const override {
             TFullModel model;
-            NJson::TJsonValue jsonModel = NJson::ReadJsonTree(modelStream);
-            CB_ENSURE(jsonModel.IsDefined(), "Json model deserialization failed");
-            ConvertJsonToCatboostModel(jsonModel, &model);
+            ConvertJsonToCatboostModel(modelStream, &model);
             CheckModel(&model);
             return model;
         }
@@ -23,6 +23,7 @@
 #include <util/system/compiler.h>
 #include <util/system/yassert.h>
 
+#include <algorithm>
 #include <numeric>
 
 
@@ -375,108 +376,175 @@ public:
 };
 
 
-static void AddTree(
+static void AddLeaf(
     const TModelTrees& trees,
     i64 treeIdx,
+    i64 nodeIdx,
+    const double* leafValue,
     bool isClassifierModel,
     TTreesAttributes* treesAttributes) {
 
-    i64 nodeIdx = 0;
+    treesAttributes->nodes_treeids->add_ints(treeIdx);
+    treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+
+    treesAttributes->nodes_modes->add_strings(TModeNode::LEAF);
+
+    // add dummy values because nodes_* must have equal length
+    treesAttributes->nodes_featureids->add_ints(0);
+    treesAttributes->nodes_values->add_floats(0.0f);
+    treesAttributes->nodes_falsenodeids->add_ints(0);
+    treesAttributes->nodes_truenodeids->add_ints(0);
+    treesAttributes->nodes_missing_value_tracks_true->add_ints(0);
+    treesAttributes->nodes_hitrates->add_floats(1.0f);
 
-    // Process splits
-    for (auto depth : xrange(trees.GetModelTreeData()->GetTreeSizes()[treeIdx])) {
-        const auto& split = trees.GetBinFeatures()[
-            trees.GetModelTreeData()->GetTreeSplits()[trees.GetModelTreeData()->GetTreeStartOffsets()[treeIdx] + (trees.GetModelTreeData()->GetTreeSizes()[treeIdx] - 1 - depth)]];
 
-        int splitFlatFeatureIdx = 0;
-        TString nodeMode;
-        i64 missingValueTracksTrue = 0;
-        float splitValue = 0.0f;
+    if (isClassifierModel) {
+        if (trees.GetDimensionsCount() > 1) {
+            for (auto approxIdx : xrange(trees.GetDimensionsCount())) {
+                treesAttributes->class_treeids->add_ints(treeIdx);
+                treesAttributes->class_nodeids->add_ints(nodeIdx);
 
-        if (split.Type == ESplitType::FloatFeature) {
-            const auto& floatFeature = trees.GetFloatFeatures()[split.FloatFeature.FloatFeature];
-            splitFlatFeatureIdx = floatFeature.Position.FlatIndex;
-            nodeMode = TModeNode::BRANCH_GT;
-            if (floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue) {
-                missingValueTracksTrue = 1;
+                treesAttributes->class_ids->add_ints(approxIdx);
+                treesAttributes->class_weights->add_floats((float)leafValue[approxIdx]);
             }
-            splitValue = split.FloatFeature.Split;
         } else {
-            CB_ENSURE_INTERNAL(
-                false,
-                "Categorical features splits are unsupported in ONNX-ML format export for now"
-            );
+            treesAttributes->class_treeids->add_ints(treeIdx);
+            treesAttributes->class_nodeids->add_ints(nodeIdx);
+            treesAttributes->class_ids->add_ints(0);
+            treesAttributes->class_weights->add_floats(-(float)*leafValue);
+
+            treesAttributes->class_treeids->add_ints(treeIdx);
+            treesAttributes->class_nodeids->add_ints(nodeIdx);
+            treesAttributes->class_ids->add_ints(1);
+            treesAttributes->class_weights->add_floats((float)*leafValue);
         }
+    } else {
+        Y_ASSERT(trees.GetDimensionsCount() == 1);
+
+        treesAttributes->target_treeids->add_ints(treeIdx);
+        treesAttributes->target_nodeids->add_ints(nodeIdx);
+
+        treesAttributes->target_ids->add_ints(0);
+        treesAttributes->target_weights->add_floats((float)*leafValue);
+    }
+}
 
-        i64 endNodeIdx = 2*nodeIdx + 1;
-        for (; nodeIdx < endNodeIdx; ++nodeIdx) {
-            treesAttributes->nodes_treeids->add_ints(treeIdx);
-            treesAttributes->nodes_nodeids->add_ints(nodeIdx);
 
-            treesAttributes->nodes_modes->add_strings(nodeMode);
+/* Add subtree of the oblivious tree with splits of depths [0, depth) and leaves [0, 2^depth) of leafValues.
+ * Each leaf has 'dimension' values, splits in the oblivious tree are stored from the deepest level.
+ * Subtrees with equal leaf values under the false and the true branch of the split do not depend on it,
+ *  the split node is omitted for them, so constant parts of trees are exported as single leaves.
+ * Returns the id of the subtree root node
+ */
+static i64 AddObliviousSubtree(
+    const TModelTrees& trees,
+    i64 treeIdx,
+    TConstArrayRef<int> treeSplits,
+    size_t depth,
+    const double* leafValues,
+    bool isClassifierModel,
+    i64* nextNodeIdx,
+    TTreesAttributes* treesAttributes) {
 
-            treesAttributes->nodes_featureids->add_ints((i64)splitFlatFeatureIdx);
-            treesAttributes->nodes_values->add_floats(splitValue);
-            treesAttributes->nodes_falsenodeids->add_ints(2*nodeIdx + 1);
-            treesAttributes->nodes_truenodeids->add_ints(2*nodeIdx + 2);
-            treesAttributes->nodes_missing_value_tracks_true->add_ints(missingValueTracksTrue);
-            treesAttributes->nodes_hitrates->add_floats(1.0f);
+    const size_t dimension = trees.GetDimensionsCount();
+
+    while (depth) {
+        const size_t halfSize = (size_t(1) << (depth - 1)) * dimension;
+        if (!std::equal(leafValues, leafValues + halfSize, leafValues + halfSize)) {
+            break;
         }
+        --depth;
     }
 
-    // Process leafs
-    auto applyData = trees.GetApplyData();
-    const double* leafValue = trees.GetModelTreeData()->GetLeafValues().begin() + applyData->TreeFirstLeafOffsets[treeIdx];
-
-    for (i64 endNodeIdx = 2*nodeIdx + 1; nodeIdx < endNodeIdx; ++nodeIdx) {
-        treesAttributes->nodes_treeids->add_ints(treeIdx);
-        treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+    const i64 nodeIdx = (*nextNodeIdx)++;
+    if (!depth) {
+        AddLeaf(trees, treeIdx, nodeIdx, leafValues, isClassifierModel, treesAttributes);
+        return nodeIdx;
+    }
 
-        treesAttributes->nodes_modes->add_strings(TModeNode::LEAF);
+    const auto& split = trees.GetBinFeatures()[treeSplits[depth - 1]];
 
-        // add dummy values because nodes_* must have equal length
-        treesAttributes->nodes_featureids->add_ints(0);
-        treesAttributes->nodes_values->add_floats(0.0f);
-        treesAttributes->nodes_falsenodeids->add_ints(0);
-        treesAttributes->nodes_truenodeids->add_ints(0);
-        treesAttributes->nodes_missing_value_tracks_true->add_ints(0);
-        treesAttributes->nodes_hitrates->add_floats(1.0f);
+    int splitFlatFeatureIdx = 0;
+    TString nodeMode;
+    i64 missingValueTracksTrue = 0;
+    float splitValue = 0.0f;
 
+    if (split.Type == ESplitType::FloatFeature) {
+        const auto& floatFeature = trees.GetFloatFeatures()[split.FloatFeature.FloatFeature];
+        splitFlatFeatureIdx = floatFeature.Position.FlatIndex;
+        nodeMode = TModeNode::BRANCH_GT;
+        if (floatFeature.NanValueTreatment == TFloatFeature::ENanValueTreatment::AsTrue) {
+            missingValueTracksTrue = 1;
+        }
+        splitValue = split.FloatFeature.Split;
+    } else {
+        CB_ENSURE_INTERNAL(
+            false,
+            "Categorical features splits are unsupported in ONNX-ML format export for now"
+        );
+    }
 
-        if (isClassifierModel) {
-            if (trees.GetDimensionsCount() > 1) {
-                for (auto approxIdx : xrange(trees.GetDimensionsCount())) {
-                    treesAttributes->class_treeids->add_ints(treeIdx);
-                    treesAttributes->class_nodeids->add_ints(nodeIdx);
-
-                    treesAttributes->class_ids->add_ints(approxIdx);
-                    treesAttributes->class_weights->add_floats((float)*leafValue);
-                    ++leafValue;
-                }
-            } else {
-                treesAttributes->class_treeids->add_ints(treeIdx);
-                treesAttributes->class_nodeids->add_ints(nodeIdx);
-                treesAttributes->class_ids->add_ints(0);
-                treesAttributes->class_weights->add_floats(-(float)*leafValue);
+    const size_t halfSize = (size_t(1) << (depth - 1)) * dimension;
+    const i64 falseNodeIdx = AddObliviousSubtree(
+        trees,
+        treeIdx,
+        treeSplits,
+        depth - 1,
+        leafValues,
+        isClassifierModel,
+        nextNodeIdx,
+        treesAttributes);
+    const i64 trueNodeIdx = AddObliviousSubtree(
+        trees,
+        treeIdx,
+        treeSplits,
+        depth - 1,
+        leafValues + halfSize,
+        isClassifierModel,
+        nextNodeIdx,
+        treesAttributes);
+
+    treesAttributes->nodes_treeids->add_ints(treeIdx);
+    treesAttributes->nodes_nodeids->add_ints(nodeIdx);
+
+    treesAttributes->nodes_modes->add_strings(nodeMode);
+
+    treesAttributes->nodes_featureids->add_ints((i64)splitFlatFeatureIdx);
+    treesAttributes->nodes_values->add_floats(splitValue);
+    treesAttributes->nodes_falsenodeids->add_ints(falseNodeIdx);
+    treesAttributes->nodes_truenodeids->add_ints(trueNodeIdx);
+    treesAttributes->nodes_missing_value_tracks_true->add_ints(missingValueTracksTrue);
+    treesAttributes->nodes_hitrates->add_floats(1.0f);
+
+    return nodeIdx;
+}
 
-                treesAttributes->class_treeids->add_ints(treeIdx);
-                treesAttributes->class_nodeids->add_ints(nodeIdx);
-                treesAttributes->class_ids->add_ints(1);
-                treesAttributes->class_weights->add_floats((float)*leafValue);
 
-                ++leafValue;
-            }
-        } else {
-            Y_ASSERT(trees.GetDimensionsCount() == 1);
+static void AddTree(
+    const TModelTrees& trees,
+    i64 treeIdx,
+    bool isClassifierModel,
+    TTreesAttributes* treesAttributes) {
 
-            treesAttributes->target_treeids->add_ints(treeIdx);
-            treesAttributes->target_nodeids->add_ints(nodeIdx);
+    const auto& treeData = *trees.GetModelTreeData();
+    const size_t treeDepth = treeData.GetTreeSizes()[treeIdx];
+    const TConstArrayRef<int> treeSplits(
+        treeData.GetTreeSplits().begin() + treeData.GetTreeStartOffsets()[treeIdx],
+        treeDepth);
 
-            treesAttributes->target_ids->add_ints(0);
-            treesAttributes->target_weights->add_floats((float)*leafValue);
-            ++leafValue;
-        }
-    }
+    auto applyData = trees.GetApplyData();
+    const double* leafValues = treeData.GetLeafValues().begin() + applyData->TreeFirstLeafOffsets[treeIdx];
+
+    i64 nextNodeIdx = 0;
+    AddObliviousSubtree(
+        trees,
+        treeIdx,
+        treeSplits,
+        treeDepth,
+        leafValues,
+        isClassifierModel,
+        &nextNodeIdx,
+        treesAttributes);
 }
 
 
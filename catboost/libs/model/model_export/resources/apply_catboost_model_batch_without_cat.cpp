@@ -0,0 +1,66 @@
+
+/* Batch model applicator.
+ * Objects are processed in blocks: features are binarized once per block into per-border columns,
+ * then each tree is evaluated for the whole block, so the inner loops go over objects and can be
+ * vectorized by the compiler.
+ * features is [objectIdx][floatFeatureIdx], results are resized to objectCount * Dimension
+ * and filled as [objectIdx * Dimension + dimensionIdx].
+ */
+void ApplyCatboostModelBatch(
+    const std::vector<std::vector<float>>& features,
+    std::vector<double>& results
+) {
+    const struct CatboostModel& model = CatboostModelStatic;
+    const size_t blockSize = 128;
+    const size_t objectCount = features.size();
+    const size_t biasCount = sizeof(model.Biases) / sizeof(model.Biases[0]);
+
+    results.assign(objectCount * model.Dimension, 0.0);
+
+    std::vector<unsigned char> binaryFeatures(std::max(model.BinaryFeatureCount, 1u) * blockSize); // [binFeatureIndex * blockSize + objectIdx]
+    std::vector<unsigned int> leafIndexes(blockSize);
+    std::vector<double> blockResults(blockSize);
+
+    for (size_t blockStart = 0; blockStart < objectCount; blockStart += blockSize) {
+        const size_t blockObjectCount = std::min(blockSize, objectCount - blockStart);
+
+        /* Binarize features */
+        unsigned int binFeatureIndex = 0;
+        for (unsigned int i = 0; i < model.FloatFeatureCount; ++i) {
+            for (unsigned int j = 0; j < model.BorderCounts[i]; ++j) {
+                const float border = model.Borders[binFeatureIndex];
+                unsigned char* binaryFeature = binaryFeatures.data() + binFeatureIndex * blockSize;
+                for (size_t objectIdx = 0; objectIdx < blockObjectCount; ++objectIdx) {
+                    binaryFeature[objectIdx] = (unsigned char)(features[blockStart + objectIdx][i] > border);
+                }
+                ++binFeatureIndex;
+            }
+        }
+
+        /* Extract and sum values from trees */
+        for (unsigned int dim = 0; dim < model.Dimension; ++dim) {
+            std::fill(blockResults.begin(), blockResults.end(), 0.0);
+            const unsigned int* treeSplitsPtr = model.TreeSplits;
+            const auto* leafValuesForCurrentTreePtr = model.LeafValues;
+            for (unsigned int treeId = 0; treeId < model.TreeCount; ++treeId) {
+                const unsigned int currentTreeDepth = model.TreeDepth[treeId];
+                std::fill(leafIndexes.begin(), leafIndexes.end(), 0u);
+                for (unsigned int depth = 0; depth < currentTreeDepth; ++depth) {
+                    const unsigned char* binaryFeature = binaryFeatures.data() + treeSplitsPtr[depth] * blockSize;
+                    for (size_t objectIdx = 0; objectIdx < blockObjectCount; ++objectIdx) {
+                        leafIndexes[objectIdx] |= ((unsigned int)binaryFeature[objectIdx] << depth);
+                    }
+                }
+                for (size_t objectIdx = 0; objectIdx < blockObjectCount; ++objectIdx) {
+                    blockResults[objectIdx] += leafValuesForCurrentTreePtr[leafIndexes[objectIdx]][dim];
+                }
+                treeSplitsPtr += currentTreeDepth;
+                leafValuesForCurrentTreePtr += (1 << currentTreeDepth);
+            }
+            for (size_t objectIdx = 0; objectIdx < blockObjectCount; ++objectIdx) {
+                results[(blockStart + objectIdx) * model.Dimension + dim]
+                    = model.Scale * blockResults[objectIdx] + model.Biases[biasCount > 1 ? dim : 0];
+            }
+        }
+    }
+}
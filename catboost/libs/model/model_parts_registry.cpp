@@ -0,0 +1,133 @@
+#include "model_parts_registry.h"
+
+#include "static_ctr_provider.h"
+
+#include <util/digest/city.h>
+#include <util/digest/multi.h>
+#include <util/generic/algorithm.h>
+
+
+template <class T>
+static ui64 ArrayCityHash(TConstArrayRef<T> data) {
+    return CityHash64(reinterpret_cast<const char*>(data.data()), sizeof(T) * data.size());
+}
+
+// Hash of the largest parts only, equality of trees is checked before sharing
+static ui64 CalcModelTreesHash(const TModelTrees& trees) {
+    const auto& treeData = *trees.GetModelTreeData();
+    ui64 hash = MultiHash(
+        trees.GetDimensionsCount(),
+        ArrayCityHash(treeData.GetTreeSplits()),
+        ArrayCityHash(treeData.GetTreeSizes()),
+        ArrayCityHash(treeData.GetLeafValues())
+    );
+    for (const auto& floatFeature : trees.GetFloatFeatures()) {
+        hash = MultiHash(hash, ArrayCityHash(MakeConstArrayRef(floatFeature.Borders)));
+    }
+    for (const auto& ctrFeature : trees.GetCtrFeatures()) {
+        hash = MultiHash(hash, ctrFeature.Ctr.GetHash(), ArrayCityHash(MakeConstArrayRef(ctrFeature.Borders)));
+    }
+    return hash;
+}
+
+static ui64 CalcCtrTableHash(const TCtrValueTable& table) {
+    return MultiHash(
+        table.ModelCtrBase.GetHash(),
+        table.CounterDenominator,
+        table.TargetClassesCount,
+        ArrayCityHash(table.GetIndexHashViewer().GetBuckets()),
+        ArrayCityHash(table.GetTypedArrayRefForBlobData<ui8>())
+    );
+}
+
+void TModelPartsRegistry::ShareParts(TFullModel* model) {
+    with_lock (Lock) {
+        ShareModelTrees(model);
+        if (auto* ctrProvider = dynamic_cast<TStaticCtrProvider*>(model->CtrProvider.Get())) {
+            ShareCtrTables(&ctrProvider->CtrData);
+        }
+    }
+}
+
+TFullModel TModelPartsRegistry::ReadModel(const TString& modelFile, EModelType format) {
+    TFullModel model = ::ReadModel(modelFile, format);
+    ShareParts(&model);
+    return model;
+}
+
+void TModelPartsRegistry::DropUnusedParts() {
+    with_lock (Lock) {
+        EraseNodesIf(
+            ModelTrees,
+            [] (auto& hashAndTrees) {
+                EraseIf(hashAndTrees.second, [] (const TCOWTreeWrapper& trees) { return trees.RefCount() == 1; });
+                return hashAndTrees.second.empty();
+            }
+        );
+        EraseNodesIf(
+            CtrTables,
+            [] (auto& hashAndTables) {
+                EraseIf(
+                    hashAndTables.second,
+                    [] (const TAtomicSharedPtr<const TCtrValueTable>& table) { return table.RefCount() == 1; }
+                );
+                return hashAndTables.second.empty();
+            }
+        );
+    }
+}
+
+TModelPartsRegistry::TStats TModelPartsRegistry::GetStats() const {
+    TStats stats;
+    with_lock (Lock) {
+        for (const auto& [hash, trees] : ModelTrees) {
+            stats.ModelTreesCount += trees.size();
+        }
+        for (const auto& [hash, tables] : CtrTables) {
+            stats.CtrTableCount += tables.size();
+        }
+        stats.SharedPartCount = SharedPartCount;
+    }
+    return stats;
+}
+
+void TModelPartsRegistry::ShareModelTrees(TFullModel* model) {
+    auto& candidates = ModelTrees[CalcModelTreesHash(*model->ModelTrees)];
+    const auto equalTrees = FindIf(
+        candidates,
+        [&] (const TCOWTreeWrapper& trees) { return *trees == *model->ModelTrees; }
+    );
+    if (equalTrees != candidates.end()) {
+        if (equalTrees->Get() != model->ModelTrees.Get()) {
+            model->ShareModelTrees(*equalTrees);
+            ++SharedPartCount;
+        }
+    } else {
+        // trees are copy on write, so registered ones are never modified through the model
+        candidates.push_back(model->ModelTrees);
+    }
+}
+
+void TModelPartsRegistry::ShareCtrTables(TCtrData* ctrData) {
+    for (auto& [base, table] : ctrData->LearnCtrs) {
+        auto& candidates = CtrTables[CalcCtrTableHash(table)];
+        const auto equalTable = FindIf(
+            candidates,
+            [&] (const TAtomicSharedPtr<const TCtrValueTable>& candidate) { return *candidate == table; }
+        );
+        const bool hasGroupedIndex = table.GetGroupedIndex();
+        if (equalTable != candidates.end()) {
+            table.ShareData(*equalTable);
+            ++SharedPartCount;
+        } else if (table.IsOwning()) {
+            // tables viewing model buffers are not registered, the buffer may be freed before the registry
+            TAtomicSharedPtr<const TCtrValueTable> sharedTable = MakeAtomicShared<TCtrValueTable>(std::move(table));
+            table.ModelCtrBase = base;
+            table.ShareData(sharedTable);
+            candidates.push_back(std::move(sharedTable));
+        }
+        if (hasGroupedIndex && !table.GetGroupedIndex()) {
+            table.SetIndexType(ECtrIndexType::Grouped);
+        }
+    }
+}
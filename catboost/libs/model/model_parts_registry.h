@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ctr_data.h"
+#include "ctr_value_table.h"
+#include "enums.h"
+#include "model.h"
+
+#include <util/generic/hash.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/mutex.h>
+
+
+/**
+ * Registry of immutable model parts for servers which keep several versions of a model, e.g. while swapping
+ * them. Parts of models passed through the registry which are equal to parts of earlier models are replaced
+ * by the earlier instances, so unchanged trees and CTR tables are kept in memory once. Parts are found by
+ * content hash and compared before sharing. Methods are thread safe.
+ */
+class TModelPartsRegistry {
+public:
+    struct TStats {
+        size_t ModelTreesCount = 0;
+        size_t CtrTableCount = 0;
+        //! Number of parts replaced by registered equal ones
+        size_t SharedPartCount = 0;
+    };
+
+public:
+    /**
+     * Replaces parts equal to registered ones, registers the other owning parts.
+     * Should be called before the model is used for evaluation.
+     */
+    void ShareParts(TFullModel* model);
+
+    // Same as ::ReadModel followed by ShareParts
+    TFullModel ReadModel(const TString& modelFile, EModelType format = EModelType::CatboostBinary);
+
+    //! Drops parts no longer used by any model
+    void DropUnusedParts();
+
+    TStats GetStats() const;
+
+private:
+    void ShareModelTrees(TFullModel* model);
+    void ShareCtrTables(TCtrData* ctrData);
+
+private:
+    THashMap<ui64, TVector<TCOWTreeWrapper>> ModelTrees;
+    THashMap<ui64, TVector<TAtomicSharedPtr<const TCtrValueTable>>> CtrTables;
+    size_t SharedPartCount = 0;
+    mutable TMutex Lock;
+};
@@ -0,0 +1,142 @@
+#include "parallel_evaluation.h"
+
+#include "eval_processing.h"
+#include "scale_and_bias.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/model/cpu/quantization.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/vector.h>
+#include <util/generic/ymath.h>
+#include <util/stream/labeled.h>
+
+namespace NCB::NModelEvaluation {
+
+    static_assert(MIN_PARALLEL_DOC_BLOCK_SIZE % FORMULA_EVALUATION_BLOCK_SIZE == 0);
+
+    static void CalcFlatByDocBlocks(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        size_t blockCount,
+        NPar::ILocalExecutor* executor,
+        const TFeatureLayout* featureInfo
+    ) {
+        const size_t docCount = features.size();
+        const size_t predictionDimension = evaluator.GetPredictionDimensions();
+        // whole evaluation blocks keep boundaries between threads at 1KB multiples of results
+        const size_t blockSize = CeilDiv(CeilDiv(docCount, blockCount), FORMULA_EVALUATION_BLOCK_SIZE)
+            * FORMULA_EVALUATION_BLOCK_SIZE;
+        blockCount = CeilDiv(docCount, blockSize);
+        executor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                const size_t blockStart = blockId * blockSize;
+                const size_t blockDocCount = Min(blockSize, docCount - blockStart);
+                evaluator.CalcFlat(
+                    features.Slice(blockStart, blockDocCount),
+                    treeStart,
+                    treeEnd,
+                    results.Slice(blockStart * predictionDimension, blockDocCount * predictionDimension),
+                    featureInfo
+                );
+            },
+            0,
+            SafeIntegerCast<int>(blockCount),
+            NPar::ILocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+    static void CalcFlatByTreeBlocks(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        size_t blockCount,
+        NPar::ILocalExecutor* executor,
+        const TFeatureLayout* featureInfo
+    ) {
+        const size_t docCount = features.size();
+        const size_t approxDimension = evaluator.GetApproxDimension();
+        auto rawEvaluator = evaluator.Clone();
+        rawEvaluator->SetPredictionType(EPredictionType::RawFormulaVal);
+        // separate allocations, so threads never share cache lines
+        TVector<TVector<double>> blockRawResults(blockCount);
+        const size_t treeCount = treeEnd - treeStart;
+        executor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                const size_t blockTreeStart = treeStart + treeCount * blockId / blockCount;
+                const size_t blockTreeEnd = treeStart + treeCount * (blockId + 1) / blockCount;
+                blockRawResults[blockId].yresize(docCount * approxDimension);
+                rawEvaluator->CalcFlat(features, blockTreeStart, blockTreeEnd, blockRawResults[blockId], featureInfo);
+            },
+            0,
+            SafeIntegerCast<int>(blockCount),
+            NPar::ILocalExecutor::WAIT_COMPLETE
+        );
+        // scale and bias were applied by the raw evaluator to every tree range
+        const TScaleAndBias identityScaleAndBias;
+        TEvalResultProcessor resultProcessor(
+            docCount,
+            results,
+            evaluator.GetPredictionType(),
+            identityScaleAndBias,
+            approxDimension,
+            /*blockSize*/ docCount
+        );
+        auto rawView = resultProcessor.GetViewForRawEvaluation(0);
+        Copy(blockRawResults[0].begin(), blockRawResults[0].end(), rawView.begin());
+        for (size_t blockId = 1; blockId < blockCount; ++blockId) {
+            const auto& blockResults = blockRawResults[blockId];
+            for (size_t idx = 0; idx < rawView.size(); ++idx) {
+                rawView[idx] += blockResults[idx];
+            }
+        }
+        resultProcessor.PostprocessBlock(0, treeStart);
+    }
+
+    void CalcFlatParallel(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        NPar::ILocalExecutor* executor,
+        const TFeatureLayout* featureInfo
+    ) {
+        CB_ENSURE(treeStart <= treeEnd && treeEnd <= evaluator.GetTreeCount(), "Invalid tree range " << LabeledOutput(treeStart, treeEnd));
+        CB_ENSURE(
+            results.size() == features.size() * evaluator.GetPredictionDimensions(),
+            "`results` size is insufficient: " << LabeledOutput(results.size(), features.size() * evaluator.GetPredictionDimensions())
+        );
+        const size_t threadCount = (executor ? executor->GetThreadCount() : 0) + 1; // one for current thread
+        const size_t docBlockCount = Min(threadCount, features.size() / MIN_PARALLEL_DOC_BLOCK_SIZE);
+        const size_t treeBlockCount = Min(threadCount, (treeEnd - treeStart) / MIN_PARALLEL_TREE_BLOCK_SIZE);
+        if (docBlockCount > 1) {
+            CalcFlatByDocBlocks(evaluator, features, treeStart, treeEnd, results, docBlockCount, executor, featureInfo);
+        } else if (treeBlockCount > 1 && !features.empty()) {
+            CalcFlatByTreeBlocks(evaluator, features, treeStart, treeEnd, results, treeBlockCount, executor, featureInfo);
+        } else {
+            evaluator.CalcFlat(features, treeStart, treeEnd, results, featureInfo);
+        }
+    }
+
+    void CalcFlatParallel(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        int threadCount,
+        const TFeatureLayout* featureInfo
+    ) {
+        CB_ENSURE(threadCount > 0, "Thread count should be positive");
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(threadCount - 1);
+        CalcFlatParallel(evaluator, features, treeStart, treeEnd, results, &executor, featureInfo);
+    }
+}
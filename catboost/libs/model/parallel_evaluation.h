@@ -0,0 +1,41 @@
+#pragma once
+
+#include "evaluation_interface.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+
+namespace NCB::NModelEvaluation {
+
+    // Batches with at least this many objects per thread are split by objects, smaller ones by trees
+    constexpr size_t MIN_PARALLEL_DOC_BLOCK_SIZE = 1024;
+    // Smallest tree range evaluated by one thread when a batch is split by trees
+    constexpr size_t MIN_PARALLEL_TREE_BLOCK_SIZE = 64;
+
+    /**
+     * Same as IModelEvaluator::CalcFlat, but work is split between executor threads and the calling one.
+     * Large batches are split into object blocks which are multiples of evaluation block size, so threads
+     * write to disjoint ranges of results starting at multiples of 1KB. Small batches are split into tree
+     * ranges evaluated into per thread buffers which are summed before prediction type transform.
+     * Trees of a range may be summed in a different order, so results may differ from CalcFlat in last bits.
+     */
+    void CalcFlatParallel(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        NPar::ILocalExecutor* executor,
+        const TFeatureLayout* featureInfo = nullptr);
+
+    // Runs on a temporary executor with threadCount - 1 additional threads
+    void CalcFlatParallel(
+        const IModelEvaluator& evaluator,
+        TConstArrayRef<TConstArrayRef<float>> features,
+        size_t treeStart,
+        size_t treeEnd,
+        TArrayRef<double> results,
+        int threadCount,
+        const TFeatureLayout* featureInfo = nullptr);
+}
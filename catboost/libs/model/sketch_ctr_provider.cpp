@@ -0,0 +1,203 @@
+#include "sketch_ctr_provider.h"
+
+#include "ctr_helpers.h"
+#include "static_ctr_provider.h"
+
+#include <util/generic/xrange.h>
+
+
+bool TCtrSketch::IsMeanCtr() const {
+    const ECtrType ctrType = ModelCtrBase.CtrType;
+    return ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue;
+}
+
+size_t TCtrSketch::GetCellCounterCount() const {
+    const ECtrType ctrType = ModelCtrBase.CtrType;
+    if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        return 1;
+    }
+    return TargetClassesCount;
+}
+
+TCtrSketch::TCtrSketch(const TCtrValueTable& table, ui32 width, ui32 depth)
+    : ModelCtrBase(table.ModelCtrBase)
+    , CounterDenominator(table.CounterDenominator)
+    , TargetClassesCount(table.TargetClassesCount)
+    , Width(width)
+    , Depth(depth)
+{
+    CB_ENSURE(width > 0 && depth > 0, "CTR sketch should have positive width and depth");
+    const size_t cellCount = (size_t)width * depth;
+    const auto buckets = table.GetIndexHashViewer().GetBuckets();
+    if (IsMeanCtr()) {
+        MeanHistories.resize(cellCount, TCtrMeanHistory{0.0f, 0});
+        const auto meanHistories = table.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
+        for (const auto& bucket : buckets) {
+            if (bucket.Hash == NCatboost::TBucket::InvalidHashValue) {
+                continue;
+            }
+            for (auto row : xrange(depth)) {
+                const size_t cell = (size_t)row * width + GetCtrSketchColumn(bucket.Hash, row, width);
+                MeanHistories[cell].Add(meanHistories[bucket.IndexValue]);
+            }
+        }
+        return;
+    }
+    const size_t counterCount = GetCellCounterCount();
+    Counters.resize(cellCount * counterCount, 0);
+    const auto counters = table.GetTypedArrayRefForBlobData<int>();
+    for (const auto& bucket : buckets) {
+        if (bucket.Hash == NCatboost::TBucket::InvalidHashValue) {
+            continue;
+        }
+        const int* bucketCounters = counters.data() + bucket.IndexValue * counterCount;
+        for (auto row : xrange(depth)) {
+            const size_t cell = (size_t)row * width + GetCtrSketchColumn(bucket.Hash, row, width);
+            int* cellCounters = Counters.data() + cell * counterCount;
+            for (auto idx : xrange(counterCount)) {
+                cellCounters[idx] += bucketCounters[idx];
+            }
+        }
+    }
+}
+
+float TCtrSketch::CalcCtr(const TModelCtr& ctr, ui64 hash) const {
+    if (IsMeanCtr()) {
+        const TCtrMeanHistory* minCell = nullptr;
+        for (auto row : xrange(Depth)) {
+            const TCtrMeanHistory& cell = MeanHistories[(size_t)row * Width + GetCtrSketchColumn(hash, row, Width)];
+            if (!minCell || cell.Count < minCell->Count) {
+                minCell = &cell;
+            }
+        }
+        return ctr.Calc(minCell->Sum, minCell->Count);
+    }
+    const size_t counterCount = GetCellCounterCount();
+    const int* minCell = nullptr;
+    int minCellTotal = 0;
+    for (auto row : xrange(Depth)) {
+        const size_t cell = (size_t)row * Width + GetCtrSketchColumn(hash, row, Width);
+        const int* cellCounters = Counters.data() + cell * counterCount;
+        int cellTotal = 0;
+        for (auto idx : xrange(counterCount)) {
+            cellTotal += cellCounters[idx];
+        }
+        if (!minCell || cellTotal < minCellTotal) {
+            minCell = cellCounters;
+            minCellTotal = cellTotal;
+        }
+    }
+    // same as CTRs of exact tables in TStaticCtrProvider::CalcCtrs
+    const ECtrType ctrType = ModelCtrBase.CtrType;
+    if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        return ctr.Calc(minCellTotal, CounterDenominator);
+    }
+    if (ctrType == ECtrType::Buckets) {
+        return ctr.Calc(minCell[ctr.TargetBorderIdx], minCellTotal);
+    }
+    int goodCount = 0;
+    for (int classId = ctr.TargetBorderIdx + 1; classId < TargetClassesCount; ++classId) {
+        goodCount += minCell[classId];
+    }
+    return ctr.Calc(goodCount, minCellTotal);
+}
+
+TSketchCtrProvider::TSketchCtrProvider(ui32 width, ui32 depth)
+    : Width(width)
+    , Depth(depth)
+{
+    CB_ENSURE(width > 0 && depth > 0, "CTR sketch should have positive width and depth");
+}
+
+bool TSketchCtrProvider::HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) const {
+    for (const auto& ctr : neededCtrs) {
+        if (!Sketches.contains(ctr.Base)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TSketchCtrProvider::CalcCtrs(
+    const TConstArrayRef<TModelCtr> neededCtrs,
+    const TConstArrayRef<ui8> binarizedFeatures,
+    const TConstArrayRef<ui32> hashedCatFeatures,
+    size_t docCount,
+    TArrayRef<float> result
+) {
+    if (neededCtrs.empty()) {
+        return;
+    }
+    auto compressedModelCtrs = NCB::CompressModelCtrs(neededCtrs);
+    TVector<ui64> ctrHashes(docCount);
+    size_t resultIdx = 0;
+    float* resultPtr = result.data();
+    TVector<int> transposedCatFeatureIndexes;
+    TVector<TBinFeatureIndexValue> binarizedIndexes;
+    for (const auto& compressedModelCtr : compressedModelCtrs) {
+        const auto& proj = *compressedModelCtr.Projection;
+        binarizedIndexes.clear();
+        transposedCatFeatureIndexes.clear();
+        for (const auto feature : proj.CatFeatures) {
+            transposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
+        }
+        for (const auto feature : proj.BinFeatures) {
+            binarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
+        }
+        for (const auto feature : proj.OneHotFeatures) {
+            binarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
+        }
+        CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
+        for (const auto& ctr : compressedModelCtr.ModelCtrs) {
+            const TCtrSketch& sketch = Sketches.at(ctr->Base);
+            for (size_t doc = 0; doc < docCount; ++doc) {
+                resultPtr[doc + resultIdx] = sketch.CalcCtr(*ctr, ctrHashes[doc]);
+            }
+            resultIdx += docCount;
+        }
+    }
+}
+
+void TSketchCtrProvider::SetupBinFeatureIndexes(
+    const TConstArrayRef<TFloatFeature> floatFeatures,
+    const TConstArrayRef<TOneHotFeature> oheFeatures,
+    const TConstArrayRef<TCatFeature> catFeatures
+) {
+    SetupCtrBinFeatureIndexes(
+        floatFeatures,
+        oheFeatures,
+        catFeatures,
+        &FloatFeatureIndexes,
+        &OneHotFeatureIndexes,
+        &CatFeatureIndex
+    );
+}
+
+void TSketchCtrProvider::AddCtrCalcerData(TCtrValueTable&& valueTable) {
+    const TCtrValueTable table = std::move(valueTable);
+    Sketches[table.ModelCtrBase] = TCtrSketch(table, Width, Depth);
+}
+
+void TSketchCtrProvider::DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) {
+    THashMap<TModelCtrBase, TCtrSketch> sketches;
+    for (const auto& base : usedModelCtrBase) {
+        sketches[base] = std::move(Sketches[base]);
+    }
+    DoSwap(Sketches, sketches);
+}
+
+TIntrusivePtr<ICtrProvider> TSketchCtrProvider::Clone() const {
+    TIntrusivePtr<TSketchCtrProvider> result = new TSketchCtrProvider();
+    result->Width = Width;
+    result->Depth = Depth;
+    result->Sketches = Sketches;
+    return result;
+}
+
+TIntrusivePtr<TSketchCtrProvider> MakeSketchCtrProvider(const TStaticCtrProvider& provider, ui32 width, ui32 depth) {
+    TIntrusivePtr<TSketchCtrProvider> result = new TSketchCtrProvider(width, depth);
+    for (const auto& [base, table] : provider.CtrData.LearnCtrs) {
+        result->Sketches[base] = TCtrSketch(table, width, depth);
+    }
+    return result;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "ctr_provider.h"
+#include "split.h"
+
+#include <util/digest/numeric.h>
+#include <util/generic/hash.h>
+#include <util/generic/vector.h>
+#include <util/ysaveload.h>
+
+
+class TStaticCtrProvider;
+
+// Column of category value hash in row of CTR count-min sketch, rows use independent hash functions
+inline ui32 GetCtrSketchColumn(ui64 hash, ui32 row, ui32 width) {
+    return IntHash<ui64>(CalcHash(hash, (ui64)row)) % width;
+}
+
+/**
+ * Count-min sketch of CTR statistics of category values: Depth rows of Width cells, statistics of each value
+ * are added to one cell of every row. CTR of value is calculated on its cell with the least number of objects,
+ * so the statistics of rare values are overestimated by collisions, but the size doesn't depend on the number
+ * of category values. Unknown values get statistics of their cells as well.
+ */
+struct TCtrSketch {
+    TModelCtrBase ModelCtrBase;
+    int CounterDenominator = 0;
+    int TargetClassesCount = 0;
+    ui32 Width = 0;
+    ui32 Depth = 0;
+    // cells of mean CTRs
+    TVector<TCtrMeanHistory> MeanHistories;
+    // cells of other CTRs, counters of all target classes of one cell are adjacent
+    TVector<int> Counters;
+
+public:
+    TCtrSketch() = default;
+
+    // Adds statistics of all buckets of exact table
+    TCtrSketch(const TCtrValueTable& table, ui32 width, ui32 depth);
+
+    bool operator==(const TCtrSketch& other) const {
+        return std::tie(ModelCtrBase, CounterDenominator, TargetClassesCount, Width, Depth, MeanHistories, Counters)
+            == std::tie(
+                other.ModelCtrBase,
+                other.CounterDenominator,
+                other.TargetClassesCount,
+                other.Width,
+                other.Depth,
+                other.MeanHistories,
+                other.Counters);
+    }
+
+    float CalcCtr(const TModelCtr& ctr, ui64 hash) const;
+
+    Y_SAVELOAD_DEFINE(ModelCtrBase, CounterDenominator, TargetClassesCount, Width, Depth, MeanHistories, Counters);
+
+private:
+    bool IsMeanCtr() const;
+    size_t GetCellCounterCount() const;
+};
+
+class TSketchCtrProvider: public ICtrProvider {
+public:
+    TSketchCtrProvider() = default;
+    TSketchCtrProvider(ui32 width, ui32 depth);
+    ~TSketchCtrProvider() override {}
+
+    bool HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) const override;
+
+    void CalcCtrs(
+        const TConstArrayRef<TModelCtr> neededCtrs,
+        const TConstArrayRef<ui8> binarizedFeatures, // vector of binarized float & one hot features
+        const TConstArrayRef<ui32> hashedCatFeatures,
+        size_t docCount,
+        TArrayRef<float> result) override;
+
+    void SetupBinFeatureIndexes(
+        const TConstArrayRef<TFloatFeature> floatFeatures,
+        const TConstArrayRef<TOneHotFeature> oheFeatures,
+        const TConstArrayRef<TCatFeature> catFeatures) override;
+
+    bool IsSerializable() const override {
+        return true;
+    }
+
+    // Exact table is folded into sketch, so tables are never kept all together
+    void AddCtrCalcerData(TCtrValueTable&& valueTable) override;
+
+    void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) override;
+
+    void Save(IOutputStream* out) const override {
+        ::SaveMany(out, Width, Depth, Sketches);
+    }
+
+    void Load(IInputStream* in) override {
+        ::LoadMany(in, Width, Depth, Sketches);
+    }
+
+    static TString ModelPartId() {
+        return "sketch_provider_v1";
+    }
+
+    TString ModelPartIdentifier() const override {
+        return ModelPartId();
+    }
+
+    TIntrusivePtr<ICtrProvider> Clone() const override;
+
+public:
+    ui32 Width = 0;
+    ui32 Depth = 0;
+    THashMap<TModelCtrBase, TCtrSketch> Sketches;
+
+private:
+    THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
+    THashMap<int, int> CatFeatureIndex;
+    THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+};
+
+// Sketches of all tables of model with exact CTR tables
+TIntrusivePtr<TSketchCtrProvider> MakeSketchCtrProvider(const TStaticCtrProvider& provider, ui32 width, ui32 depth);
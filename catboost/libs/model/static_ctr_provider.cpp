@@ -38,11 +38,15 @@ void TStaticCtrProvider::CalcCtrs(const TConstArrayRef<TModelCtr> neededCtrs,
         CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
         for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
             auto& learnCtr = CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
             const ECtrType ctrType = ctr->Base.CtrType;
             auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+            if (const auto* groupedIndex = learnCtr.GetGroupedIndex()) {
+                groupedIndex->GetIndexes(ctrHashes, buckets);
+            } else {
+                auto hashIndexResolver = learnCtr.GetIndexHashViewer();
+                for (size_t docId = 0; docId < samplesCount; ++docId) {
+                    ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+                }
             }
             if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
                 const auto emptyVal = ctr->Calc(0.f, 0.f);
@@ -130,11 +134,16 @@ bool TStaticCtrProvider::HasNeededCtrs(TConstArrayRef<TModelCtr> neededCtrs) con
     return true;
 }
 
-void TStaticCtrProvider::SetupBinFeatureIndexes(const TConstArrayRef<TFloatFeature> floatFeatures,
-                                                const TConstArrayRef<TOneHotFeature> oheFeatures,
-                                                const TConstArrayRef<TCatFeature> catFeatures) {
+void SetupCtrBinFeatureIndexes(
+    const TConstArrayRef<TFloatFeature> floatFeatures,
+    const TConstArrayRef<TOneHotFeature> oheFeatures,
+    const TConstArrayRef<TCatFeature> catFeatures,
+    THashMap<TFloatSplit, TBinFeatureIndexValue>* floatFeatureIndexes,
+    THashMap<TOneHotSplit, TBinFeatureIndexValue>* oneHotFeatureIndexes,
+    THashMap<int, int>* catFeatureIndex
+) {
     ui32 currentIndex = 0;
-    FloatFeatureIndexes.clear();
+    floatFeatureIndexes->clear();
     for (const auto& floatFeature : floatFeatures) {
         if (!floatFeature.UsedInModel()) {
             continue;
@@ -142,31 +151,156 @@ void TStaticCtrProvider::SetupBinFeatureIndexes(const TConstArrayRef<TFloatFeatu
         for (size_t borderIdx = 0; borderIdx < floatFeature.Borders.size(); ++borderIdx) {
             TBinFeatureIndexValue featureIdx{currentIndex + (ui32)borderIdx / MAX_VALUES_PER_BIN, false, (ui8)((borderIdx % MAX_VALUES_PER_BIN)+ 1)};
             TFloatSplit split{floatFeature.Position.Index, floatFeature.Borders[borderIdx]};
-            FloatFeatureIndexes[split] = featureIdx;
+            (*floatFeatureIndexes)[split] = featureIdx;
         }
         currentIndex += (floatFeature.Borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
     }
-    OneHotFeatureIndexes.clear();
+    oneHotFeatureIndexes->clear();
     for (const auto& oheFeature : oheFeatures) {
         for (size_t valueId = 0; valueId < oheFeature.Values.size(); ++valueId) {
             TBinFeatureIndexValue featureIdx{currentIndex + (ui32)valueId / MAX_VALUES_PER_BIN, true, (ui8)((valueId % MAX_VALUES_PER_BIN) + 1)};
             TOneHotSplit feature{oheFeature.CatFeatureIndex, oheFeature.Values[valueId]};
-            OneHotFeatureIndexes[feature] = featureIdx;
+            (*oneHotFeatureIndexes)[feature] = featureIdx;
         }
         currentIndex += (oheFeature.Values.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
     }
-    CatFeatureIndex.clear();
+    catFeatureIndex->clear();
     for (const auto& catFeature : catFeatures) {
         if (catFeature.UsedInModel()) {
-            const int prevSize = CatFeatureIndex.ysize();
-            CatFeatureIndex[catFeature.Position.Index] = prevSize;
+            const int prevSize = catFeatureIndex->ysize();
+            (*catFeatureIndex)[catFeature.Position.Index] = prevSize;
+        }
+    }
+}
+
+void TStaticCtrProvider::SetupBinFeatureIndexes(const TConstArrayRef<TFloatFeature> floatFeatures,
+                                                const TConstArrayRef<TOneHotFeature> oheFeatures,
+                                                const TConstArrayRef<TCatFeature> catFeatures) {
+    SetupCtrBinFeatureIndexes(
+        floatFeatures,
+        oheFeatures,
+        catFeatures,
+        &FloatFeatureIndexes,
+        &OneHotFeatureIndexes,
+        &CatFeatureIndex
+    );
+}
+
+// CTR value of table bucket, same as in CalcCtrs
+static float CalcBucketCtr(const TModelCtr& ctr, const TCtrValueTable& table, ui64 bucket) {
+    const ECtrType ctrType = ctr.Base.CtrType;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        const TCtrMeanHistory& ctrMeanHistory = table.GetTypedArrayRefForBlobData<TCtrMeanHistory>()[bucket];
+        return ctr.Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
+    }
+    auto ctrIntArray = table.GetTypedArrayRefForBlobData<int>();
+    if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        return ctr.Calc(ctrIntArray[bucket], table.CounterDenominator);
+    }
+    const int targetClassesCount = table.TargetClassesCount;
+    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + bucket * targetClassesCount, targetClassesCount);
+    int goodCount = 0;
+    int totalCount = 0;
+    if (ctrType == ECtrType::Buckets) {
+        goodCount = ctrHistory[ctr.TargetBorderIdx];
+        for (int classId = 0; classId < targetClassesCount; ++classId) {
+            totalCount += ctrHistory[classId];
+        }
+    } else if (targetClassesCount > 2) {
+        for (int classId = 0; classId < ctr.TargetBorderIdx + 1; ++classId) {
+            totalCount += ctrHistory[classId];
+        }
+        for (int classId = ctr.TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
+            goodCount += ctrHistory[classId];
+        }
+        totalCount += goodCount;
+    } else {
+        goodCount = ctrHistory[1];
+        totalCount = ctrHistory[0] + ctrHistory[1];
+    }
+    return ctr.Calc(goodCount, totalCount);
+}
+
+static size_t GetBucketDataSize(const TCtrValueTable& table) {
+    const ECtrType ctrType = table.ModelCtrBase.CtrType;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        return sizeof(TCtrMeanHistory);
+    } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        return sizeof(int);
+    }
+    return sizeof(int) * table.TargetClassesCount;
+}
+
+void TStaticCtrProvider::DropUnusedBuckets(TConstArrayRef<TCtrFeature> ctrFeatures) {
+    THashMap<TModelCtrBase, TVector<const TCtrFeature*>> baseFeatures;
+    for (const auto& ctrFeature : ctrFeatures) {
+        baseFeatures[ctrFeature.Ctr.Base].push_back(&ctrFeature);
+    }
+    for (auto& [base, table] : CtrData.LearnCtrs) {
+        const auto features = baseFeatures.FindPtr(base);
+        if (!features) {
+            continue;
+        }
+        // CTRs of unknown values are calculated on empty statistics
+        TVector<float> emptyValues;
+        for (const auto* feature : *features) {
+            const ECtrType ctrType = base.CtrType;
+            const bool isCounter = ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq;
+            emptyValues.push_back(feature->Ctr.Calc(0, isCounter ? table.CounterDenominator : 0));
+        }
+        const auto isBucketUsed = [&] (ui64 bucket) {
+            for (auto featureIdx : xrange(features->size())) {
+                const TCtrFeature& feature = *(*features)[featureIdx];
+                const float value = CalcBucketCtr(feature.Ctr, table, bucket);
+                for (float border : feature.Borders) {
+                    if ((value > border) != (emptyValues[featureIdx] > border)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+        const size_t bucketDataSize = GetBucketDataSize(table);
+        const auto blob = table.GetTypedArrayRefForBlobData<ui8>();
+        TVector<std::pair<ui64, ui32>> usedBuckets;
+        for (const auto& bucket : table.GetIndexHashViewer().GetBuckets()) {
+            if (bucket.Hash != NCatboost::TBucket::InvalidHashValue && isBucketUsed(bucket.IndexValue)) {
+                usedBuckets.emplace_back(bucket.Hash, bucket.IndexValue);
+            }
+        }
+
+        TCtrValueTable usedTable;
+        usedTable.ModelCtrBase = base;
+        usedTable.CounterDenominator = table.CounterDenominator;
+        usedTable.TargetClassesCount = table.TargetClassesCount;
+        auto hashBuilder = usedTable.GetIndexHashBuilder(usedBuckets.size());
+        auto usedBlob = usedTable.AllocateBlobAndGetArrayRef<ui8>(usedBuckets.size() * bucketDataSize);
+        for (const auto& [hash, index] : usedBuckets) {
+            const auto insertIndex = hashBuilder.AddIndex(hash);
+            std::copy_n(
+                blob.data() + index * bucketDataSize,
+                bucketDataSize,
+                usedBlob.data() + insertIndex * bucketDataSize
+            );
+        }
+        if (IndexType != ECtrIndexType::Dense) {
+            usedTable.SetIndexType(IndexType);
         }
+        table = std::move(usedTable);
+    }
+}
+
+void TStaticCtrProvider::SetIndexType(ECtrIndexType indexType) {
+    for (auto& [base, table] : CtrData.LearnCtrs) {
+        table.SetIndexType(indexType);
     }
+    IndexType = indexType;
 }
 
 TIntrusivePtr<ICtrProvider> TStaticCtrProvider::Clone() const {
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     result->CtrData = CtrData;
+    result->IndexType = IndexType;
     return result;
 }
 
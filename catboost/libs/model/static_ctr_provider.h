@@ -11,6 +11,16 @@
 #include <functional>
 
 
+// Indexes of features of CTR projections in binarized and hashed features passed to CalcCtrs
+void SetupCtrBinFeatureIndexes(
+    const TConstArrayRef<TFloatFeature> floatFeatures,
+    const TConstArrayRef<TOneHotFeature> oheFeatures,
+    const TConstArrayRef<TCatFeature> catFeatures,
+    THashMap<TFloatSplit, TBinFeatureIndexValue>* floatFeatureIndexes,
+    THashMap<TOneHotSplit, TBinFeatureIndexValue>* oneHotFeatureIndexes,
+    THashMap<int, int>* catFeatureIndex);
+
+
 class TStaticCtrProvider: public ICtrProvider {
 public:
     TStaticCtrProvider() = default;
@@ -38,6 +48,9 @@ public:
 
     void AddCtrCalcerData(TCtrValueTable&& valueTable) override {
         auto ctrBase = valueTable.ModelCtrBase;
+        if (IndexType != ECtrIndexType::Dense) {
+            valueTable.SetIndexType(IndexType);
+        }
         CtrData.LearnCtrs[ctrBase] = std::move(valueTable);
     }
 
@@ -49,16 +62,31 @@ public:
         DoSwap(CtrData, ctrData);
     }
 
+    /**
+     * Drops table buckets of category values whose CTRs are binarized by the borders of ctrFeatures
+     * the same way as CTRs of unknown values, so predictions of the model are unchanged.
+     * The tables are valid for model application only.
+     */
+    void DropUnusedBuckets(TConstArrayRef<TCtrFeature> ctrFeatures);
+
     void Save(IOutputStream* out) const override {
         ::Save(out, CtrData);
     }
 
+    void SaveAligned(TCountingOutput* out, size_t arrayAlignment) const override {
+        CtrData.SaveAligned(out, arrayAlignment);
+    }
+
+    void SetIndexType(ECtrIndexType indexType) override;
+
     void Load(IInputStream* inp) override {
         ::Load(inp, CtrData);
+        SetIndexType(IndexType);
     }
 
     void LoadNonOwning(TMemoryInput* in) {
         CtrData.LoadNonOwning(in);
+        SetIndexType(IndexType);
     }
 
     static TString ModelPartId() {
@@ -85,6 +113,7 @@ private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+    ECtrIndexType IndexType = ECtrIndexType::Dense;
 };
 
 class TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
@@ -2,13 +2,22 @@
 
 #include <catboost/libs/data/data_provider_builders.h>
 #include <catboost/libs/model/cpu/evaluator.h>
+#include <catboost/libs/model/cpu/model_group_evaluator.h>
+#include <catboost/libs/model/cpu/single_row_evaluation.h>
+#include <catboost/libs/model/incremental_evaluation.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/parallel_evaluation.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/private/libs/text_features/ut/lib/text_features_data.h>
 
 #include <library/cpp/testing/unittest/registar.h>
 
 #include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <limits>
 
 using namespace NCB;
 using namespace NCB::NModelEvaluation;
@@ -131,6 +140,61 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         CheckFlatCalcResult(model, expectedPredicts, expectedLeafIndexes, features);
     }
 
+    Y_UNIT_TEST(TestBinarySearchBinarizationGivesSameResults) {
+        // feature 0 has enough borders for binary search binarization, 2 borders blocks
+        const int manyBordersCount = 300;
+        TObliviousTreeBuilder builder(
+            TVector<TFloatFeature>{
+                TFloatFeature(true, 0, 0, {}),
+                TFloatFeature(false, 1, 1, {})
+            },
+            TVector<TCatFeature>{},
+            TVector<TTextFeature>{},
+            TVector<TEmbeddingFeature>{},
+            1
+        );
+        const TVector<double> leafValues = {0.0, 1.0};
+        for (auto borderIdx : xrange(manyBordersCount)) {
+            builder.AddTree({TModelSplit(TFloatSplit(0, float(borderIdx)))}, leafValues, {});
+        }
+        for (auto border : {-0.5f, 0.5f, 1.5f}) {
+            builder.AddTree({TModelSplit(TFloatSplit(1, border))}, leafValues, {});
+        }
+        TFullModel model;
+        builder.Build(model.ModelTrees.GetMutable());
+        model.UpdateDynamicData();
+        UNIT_ASSERT(model.ModelTrees->GetApplyData()->FloatFeatureUsesBinarySearch == TVector<bool>({true, false}));
+
+        const size_t docCount = 2 * FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(2));
+        TVector<double> expectedPredicts(docCount, 0.0);
+        for (auto docId : xrange(docCount)) {
+            auto& doc = data[docId];
+            if (docId % 50 == 0) {
+                doc[0] = std::numeric_limits<float>::quiet_NaN();
+            } else if (docId % 3 == 0) {
+                // exactly on a border
+                doc[0] = float(rng.Uniform(manyBordersCount));
+            } else {
+                doc[0] = rng.GenRandReal1() * (manyBordersCount + 20) - 10;
+            }
+            doc[1] = rng.GenRandReal1() * 3 - 1;
+            for (auto borderIdx : xrange(manyBordersCount)) {
+                expectedPredicts[docId] += doc[0] > float(borderIdx);
+            }
+            for (auto border : {-0.5f, 0.5f, 1.5f}) {
+                expectedPredicts[docId] += doc[1] > border;
+            }
+        }
+
+        TVector<double> predicts(docCount);
+        model.CalcFlat(GetFeatureRef(data), predicts);
+        for (auto docId : xrange(docCount)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], 1e-9);
+        }
+    }
+
     Y_UNIT_TEST(TestFlatCalcMultiVal) {
         auto model = MultiValueFloatModel();
         TVector<TConstArrayRef<float>> features(FLOAT_FEATURES.begin(), FLOAT_FEATURES.begin() + 4);
@@ -182,6 +246,474 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
 
+    Y_UNIT_TEST(TestCtrGroupedIndexGivesSameResults) {
+        const auto model = TrainCatOnlyNoOneHotModel();
+        // known values, unknown ones and more objects than prefetch distance of batch lookup
+        TVector<TVector<TStringBuf>> features;
+        for (auto i : xrange(20)) {
+            features.push_back({i % 2 ? "a" : "b", i % 3 ? "c" : "d", i % 5 ? "e" : "g"});
+        }
+        TVector<double> expected(features.size());
+        model.Calc({}, features, expected);
+
+        TFullModel groupedModel = model;
+        groupedModel.CtrProvider = model.CtrProvider->Clone();
+        groupedModel.SetCtrIndexType(ECtrIndexType::Grouped);
+        TVector<double> results(features.size());
+        const TVector<TConstArrayRef<TStringBuf>> featureRefs(features.begin(), features.end());
+        CreateEvaluator(EFormulaEvaluatorType::CPU, groupedModel)->Calc<TStringBuf>({}, featureRefs, results);
+        UNIT_ASSERT_EQUAL(expected, results);
+
+        NCatboost::TDenseIndexHashView denseIndex = [&] {
+            const auto* ctrProvider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+            UNIT_ASSERT(ctrProvider);
+            return ctrProvider->CtrData.LearnCtrs.begin()->second.GetIndexHashViewer();
+        }();
+        const NCatboost::TGroupedIndexHash groupedIndex(denseIndex);
+        for (const auto& bucket : denseIndex.GetBuckets()) {
+            if (bucket.Hash != NCatboost::TBucket::InvalidHashValue) {
+                UNIT_ASSERT_EQUAL(groupedIndex.GetIndex(bucket.Hash), bucket.IndexValue);
+            }
+        }
+        UNIT_ASSERT_EQUAL(groupedIndex.GetIndex(12345), NCatboost::TGroupedIndexHash::NotFoundIndex);
+    }
+
+    Y_UNIT_TEST(TestModelGroupGivesSameResults) {
+        const TVector<TFullModel> models = {
+            TrainFloatCatboostModel(/*iterations*/ 10, /*seed*/ 1),
+            TrainFloatCatboostModel(/*iterations*/ 5, /*seed*/ 2),
+            SimpleFloatModel(/*treeCount*/ 2),
+            SimpleAsymmetricModel()
+        };
+        const size_t docCount = FORMULA_EVALUATION_BLOCK_SIZE + 13;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1() * 3;
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        TVector<const TFullModel*> modelPtrs;
+        for (const auto& model : models) {
+            modelPtrs.push_back(&model);
+        }
+        const TModelGroupEvaluator group(modelPtrs);
+        size_t sharedBorderCount = 0;
+        for (const auto& feature : group.GetSharedTrees().GetFloatFeatures()) {
+            sharedBorderCount += feature.Borders.size();
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sharedBorderCount, group.GetSharedTrees().GetBinFeatures().size());
+
+        TVector<TVector<double>> groupResults;
+        TVector<TArrayRef<double>> groupResultRefs;
+        for (const auto& model : models) {
+            groupResults.emplace_back(docCount * model.GetDimensionsCount());
+        }
+        for (auto& result : groupResults) {
+            groupResultRefs.push_back(result);
+        }
+        group.CalcFlat(features, groupResultRefs);
+        for (auto modelIdx : xrange(models.size())) {
+            TVector<double> expected(docCount * models[modelIdx].GetDimensionsCount());
+            models[modelIdx].CalcFlat(features, expected);
+            for (auto i : xrange(expected.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expected[i], groupResults[modelIdx][i], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestIndexesKernelsGiveSameResults) {
+        const auto model = TrainFloatCatboostModel(/*iterations*/ 20);
+        // two full evaluation blocks and a tail which is not a multiple of any register width
+        const size_t docCount = 2 * FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        auto sseEvaluator = model.GetCurrentEvaluator()->Clone();
+        sseEvaluator->SetProperty("IndexesKernel", "Sse");
+        TVector<double> expectedPredicts(docCount);
+        sseEvaluator->CalcFlat(features, expectedPredicts);
+
+        for (auto kernel : {ECpuIndexesKernel::Avx2, ECpuIndexesKernel::Avx512}) {
+            if (!IsCpuIndexesKernelAvailable(kernel)) {
+                UNIT_ASSERT_EXCEPTION(sseEvaluator->Clone()->SetProperty("IndexesKernel", ToString(kernel)), TCatBoostException);
+                continue;
+            }
+            auto evaluator = model.GetCurrentEvaluator()->Clone();
+            evaluator->SetProperty("IndexesKernel", ToString(kernel));
+            TVector<double> predicts(docCount);
+            evaluator->CalcFlat(features, predicts);
+            UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+        }
+        UNIT_ASSERT_EXCEPTION(sseEvaluator->SetProperty("UnknownProperty", "1"), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestTreeMajorScheduleGivesSameResults) {
+        const auto model = TrainFloatCatboostModel(/*iterations*/ 30);
+        // last tile is partially filled and ends with an incomplete sub-block
+        const size_t docCount = 5 * FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        for (auto predictionType : {EPredictionType::RawFormulaVal, EPredictionType::Probability}) {
+            auto documentMajorEvaluator = model.GetCurrentEvaluator()->Clone();
+            documentMajorEvaluator->SetPredictionType(predictionType);
+            TVector<double> expectedPredicts(docCount);
+            documentMajorEvaluator->CalcFlat(features, expectedPredicts);
+
+            // tiny budget forces groups of 4 trees over tiles of several sub-blocks
+            auto treeMajorEvaluator = documentMajorEvaluator->Clone();
+            treeMajorEvaluator->SetProperty("EvaluationCacheBudget", "1");
+            TVector<double> predicts(docCount);
+            treeMajorEvaluator->CalcFlat(features, predicts);
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], 1e-12);
+            }
+        }
+    }
+
+    static TFullModel MixedDepthFloatModel() {
+        TFullModel model;
+        TModelTrees* trees = model.ModelTrees.GetMutable();
+        trees->SetFloatFeatures(
+            {
+                TFloatFeature{false, 0, 0, {0.25f, 0.5f, 0.75f}, ""}, // bin splits 0, 1, 2
+                TFloatFeature{false, 1, 1, {0.25f, 0.5f, 0.75f}, ""}, // bin splits 3, 4, 5
+                TFloatFeature{false, 2, 2, {0.25f, 0.5f, 0.75f}, ""}  // bin splits 6, 7, 8
+            }
+        );
+        TFastRng64 rng(0);
+        const TVector<TVector<int>> trees4 = {{1, 4}, {0, 3, 6, 8, 2, 5, 7, 1, 4}, {7}, {2, 5, 8}};
+        for (size_t treeId = 0; treeId < 13; ++treeId) {
+            const auto& tree = trees4[treeId % trees4.size()];
+            trees->AddBinTree(tree);
+            for (size_t leafId = 0; leafId < (size_t(1) << tree.size()); ++leafId) {
+                trees->AddLeafValue(rng.GenRandReal1() - 0.5);
+            }
+        }
+        model.UpdateDynamicData();
+        return model;
+    }
+
+    Y_UNIT_TEST(TestCompiledEvaluatorGivesSameResults) {
+        const size_t docCount = 2 * FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(9));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        const TVector<std::function<TFullModel()>> modelMakers = {
+            [] { return TrainFloatCatboostModel(/*iterations*/ 30); },
+            MixedDepthFloatModel,
+            MultiValueFloatModel,
+            [] { return SimpleDeepTreeModel(9); }
+        };
+        for (const auto& makeModel : modelMakers) {
+            const auto model = makeModel();
+            const auto cpuEvaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, model);
+            const auto compiledEvaluator = CreateEvaluator(EFormulaEvaluatorType::CompiledCPU, model);
+            const size_t treeCount = model.GetTreeCount();
+            const size_t resultSize = docCount * model.GetDimensionsCount();
+            for (auto [treeStart, treeEnd] : {std::pair<size_t, size_t>{0, treeCount}, std::pair<size_t, size_t>{treeCount / 3, treeCount}}) {
+                TVector<double> expectedPredicts(resultSize);
+                cpuEvaluator->CalcFlat(features, treeStart, treeEnd, expectedPredicts);
+                TVector<double> predicts(resultSize);
+                compiledEvaluator->CalcFlat(features, treeStart, treeEnd, predicts);
+                for (size_t i = 0; i < resultSize; ++i) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[i], predicts[i], 1e-9);
+                }
+                TVector<double> singlePredict(model.GetDimensionsCount());
+                compiledEvaluator->CalcFlatSingle(features[0], treeStart, treeEnd, singlePredict);
+                for (size_t dim = 0; dim < singlePredict.size(); ++dim) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[dim], singlePredict[dim], 1e-9);
+                }
+            }
+        }
+        // non-oblivious models fall back to the CPU evaluation
+        auto asymmetricModel = SimpleAsymmetricModel();
+        TVector<double> expectedAsymmetricPredicts(FLOAT_FEATURES.size());
+        TVector<double> asymmetricPredicts(FLOAT_FEATURES.size());
+        CreateEvaluator(EFormulaEvaluatorType::CPU, asymmetricModel)->CalcFlat(
+            FLOAT_FEATURES,
+            expectedAsymmetricPredicts
+        );
+        asymmetricModel.SetEvaluatorType(EFormulaEvaluatorType::CompiledCPU);
+        asymmetricModel.CalcFlat(FLOAT_FEATURES, asymmetricPredicts);
+        UNIT_ASSERT_VALUES_EQUAL(expectedAsymmetricPredicts, asymmetricPredicts);
+    }
+
+    Y_UNIT_TEST(TestReducedPrecisionLeafValuesAreWithinBound) {
+        const auto model = TrainFloatCatboostModel(/*iterations*/ 30);
+        const size_t docCount = FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        auto doubleEvaluator = model.GetCurrentEvaluator()->Clone();
+        TVector<double> expectedPredicts(docCount);
+        doubleEvaluator->CalcFlat(features, expectedPredicts);
+
+        for (auto precision : {ELeafValuesPrecision::Float, ELeafValuesPrecision::Int16}) {
+            const auto compactLeafValues = BuildCompactLeafValues(*model.ModelTrees, precision);
+            UNIT_ASSERT(compactLeafValues->MaxAbsoluteError > 0.0);
+            auto evaluator = doubleEvaluator->Clone();
+            evaluator->SetProperty("LeafValuesPrecision", ToString(precision));
+            TVector<double> predicts(docCount);
+            evaluator->CalcFlat(features, predicts);
+            TVector<double> singlePredict(1);
+            evaluator->CalcFlatSingle(features[0], singlePredict);
+            UNIT_ASSERT_DOUBLES_EQUAL(predicts[0], singlePredict[0], 1e-12);
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], compactLeafValues->MaxAbsoluteError + 1e-12);
+            }
+
+            evaluator->SetProperty("LeafValuesPrecision", "Double");
+            evaluator->CalcFlat(features, predicts);
+            UNIT_ASSERT_EQUAL(expectedPredicts, predicts);
+        }
+    }
+
+    static TFullModel MultiBucketFloatModel() {
+        TFullModel model;
+        TModelTrees* trees = model.ModelTrees.GetMutable();
+        TVector<float> manyBorders;
+        for (size_t borderId = 0; borderId < 600; ++borderId) {
+            manyBorders.push_back(borderId / 600.0f);
+        }
+        TFloatFeature nanAsTrueFeature{true, 0, 0, manyBorders, ""}; // bin splits 0..599, three buckets
+        nanAsTrueFeature.NanValueTreatment = TFloatFeature::ENanValueTreatment::AsTrue;
+        TFloatFeature nanAsFalseFeature{true, 1, 1, {0.25f, 0.5f, 0.75f}, ""}; // bin splits 600, 601, 602
+        nanAsFalseFeature.NanValueTreatment = TFloatFeature::ENanValueTreatment::AsFalse;
+        trees->SetFloatFeatures({nanAsTrueFeature, nanAsFalseFeature});
+        TFastRng64 rng(0);
+        for (size_t treeId = 0; treeId < 20; ++treeId) {
+            TVector<int> tree;
+            for (size_t depth = 0; depth < 1 + treeId % 6; ++depth) {
+                tree.push_back(rng.Uniform(603));
+            }
+            trees->AddBinTree(tree);
+            for (size_t leafId = 0; leafId < (size_t(1) << tree.size()); ++leafId) {
+                trees->AddLeafValue(rng.GenRandReal1() - 0.5);
+            }
+        }
+        model.UpdateDynamicData();
+        return model;
+    }
+
+    Y_UNIT_TEST(TestSingleRowFastPathGivesSameResults) {
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(50, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        // values equal to borders and nans with both treatments
+        data[0] = {0.5f, 0.5f, 0.5f};
+        data[1] = {std::numeric_limits<float>::quiet_NaN(), 0.25f, 0.f};
+        data[2] = {0.f, std::numeric_limits<float>::quiet_NaN(), 1.f};
+        const auto features = GetFeatureRef(data);
+
+        const TVector<std::function<TFullModel()>> modelMakers = {
+            [] { return TrainFloatCatboostModel(/*iterations*/ 30); },
+            MultiBucketFloatModel,
+            MultiValueFloatModel
+        };
+        for (const auto& makeModel : modelMakers) {
+            const auto model = makeModel();
+            UNIT_ASSERT(BuildSingleRowEvaluationData(*model.ModelTrees));
+            const size_t treeCount = model.GetTreeCount();
+            for (auto predictionType : {EPredictionType::RawFormulaVal, EPredictionType::Probability}) {
+                auto fastEvaluator = model.GetCurrentEvaluator()->Clone();
+                fastEvaluator->SetPredictionType(predictionType);
+                auto genericEvaluator = fastEvaluator->Clone();
+                genericEvaluator->SetProperty("SingleRowFastPath", "false");
+                for (auto [treeStart, treeEnd] : {std::pair<size_t, size_t>{0, treeCount}, std::pair<size_t, size_t>{treeCount / 3, treeCount}}) {
+                    for (const auto& doc : features) {
+                        TVector<double> expectedPredict(model.GetDimensionsCount());
+                        genericEvaluator->CalcFlatSingle(doc, treeStart, treeEnd, expectedPredict);
+                        TVector<double> predict(model.GetDimensionsCount());
+                        fastEvaluator->CalcFlatSingle(doc, treeStart, treeEnd, predict);
+                        for (size_t dim = 0; dim < predict.size(); ++dim) {
+                            UNIT_ASSERT_DOUBLES_EQUAL(expectedPredict[dim], predict[dim], 1e-12);
+                        }
+                    }
+                }
+            }
+        }
+        UNIT_ASSERT(!BuildSingleRowEvaluationData(*SimpleAsymmetricModel().ModelTrees));
+    }
+
+    Y_UNIT_TEST(TestEvaluationWithBorderGivesSameDecisions) {
+        const size_t docCount = 2 * FORMULA_EVALUATION_BLOCK_SIZE + 45;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        auto trainedModel = TrainFloatCatboostModel(/*iterations*/ 40);
+        auto scaledModel = trainedModel;
+        scaledModel.SetScaleAndBias({-0.5, {0.25}});
+        auto asymmetricModel = trainedModel;
+        asymmetricModel.ModelTrees.GetMutable()->ConvertObliviousToAsymmetric();
+        for (const auto* model : {&trainedModel, &scaledModel, &asymmetricModel}) {
+            const size_t treeCount = model->GetTreeCount();
+            for (auto [treeStart, treeEnd] : {std::pair<size_t, size_t>{0, treeCount}, std::pair<size_t, size_t>{treeCount / 3, treeCount}}) {
+                // evaluators are created explicitly since model copies share the cached one
+                const auto rawEvaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, *model);
+                TVector<double> rawPredicts(docCount);
+                rawEvaluator->CalcFlat(features, treeStart, treeEnd, rawPredicts);
+                auto evaluator = rawEvaluator->Clone();
+                evaluator->SetPredictionType(EPredictionType::Probability);
+                TVector<double> sortedPredicts = rawPredicts;
+                Sort(sortedPredicts);
+                // borders keeping almost all, about half and almost none of objects, away from any prediction
+                // since stages may sum trees in a different order
+                const auto getBorder = [&] (size_t idx) {
+                    while (idx + 2 < docCount && sortedPredicts[idx] == sortedPredicts[idx + 1]) {
+                        ++idx;
+                    }
+                    return (sortedPredicts[idx] + sortedPredicts[idx + 1]) / 2;
+                };
+                for (double border : {getBorder(docCount / 10), getBorder(docCount / 2), getBorder(docCount - 3)}) {
+                    for (auto stageSize : {"1", "16", "1000"}) {
+                        evaluator->SetProperty("EarlyExitStageSize", stageSize);
+                        TVector<double> decisions(docCount, 2.0);
+                        evaluator->CalcFlatWithBorder(features, treeStart, treeEnd, border, decisions);
+                        for (size_t docId = 0; docId < docCount; ++docId) {
+                            UNIT_ASSERT_VALUES_EQUAL(double(rawPredicts[docId] > border), decisions[docId]);
+                        }
+                    }
+                }
+            }
+        }
+        auto multiValueEvaluator = MultiValueFloatModel().GetCurrentEvaluator()->Clone();
+        TVector<double> decisions(docCount);
+        UNIT_ASSERT_EXCEPTION(multiValueEvaluator->CalcFlatWithBorder(features, 0.0, decisions), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestParallelEvaluationGivesSameResults) {
+        TFastRng64 rng(42);
+        const auto makeFeatures = [&] (size_t docCount, TVector<TVector<float>>* data) {
+            data->assign(docCount, TVector<float>(3));
+            for (auto& doc : *data) {
+                for (auto& value : doc) {
+                    value = rng.GenRandReal1();
+                }
+            }
+            return GetFeatureRef(*data);
+        };
+        TVector<TVector<float>> largeData;
+        TVector<TVector<float>> smallData;
+        // split by objects with a partial last block and split by trees respectively
+        const auto largeBatch = makeFeatures(3 * MIN_PARALLEL_DOC_BLOCK_SIZE + 45, &largeData);
+        const auto smallBatch = makeFeatures(45, &smallData);
+
+        const auto binaryModel = TrainFloatCatboostModel(/*iterations*/ 4 * MIN_PARALLEL_TREE_BLOCK_SIZE);
+        auto scaledModel = binaryModel;
+        scaledModel.SetScaleAndBias({0.5, {0.25}});
+        for (const auto* model : {&binaryModel, &scaledModel}) {
+            for (auto predictionType : {EPredictionType::RawFormulaVal, EPredictionType::Probability, EPredictionType::Class}) {
+                auto evaluator = CreateEvaluator(EFormulaEvaluatorType::CPU, *model);
+                evaluator->SetPredictionType(predictionType);
+                const size_t treeCount = model->GetTreeCount();
+                for (auto [treeStart, treeEnd] : {std::pair<size_t, size_t>{0, treeCount}, std::pair<size_t, size_t>{treeCount / 3, treeCount}}) {
+                    for (const auto& features : {largeBatch, smallBatch}) {
+                        TVector<double> expectedPredicts(features.size());
+                        evaluator->CalcFlat(features, treeStart, treeEnd, expectedPredicts);
+                        for (int threadCount : {1, 3, 4}) {
+                            TVector<double> predicts(features.size());
+                            CalcFlatParallel(*evaluator, features, treeStart, treeEnd, predicts, threadCount);
+                            for (size_t docId = 0; docId < features.size(); ++docId) {
+                                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], 1e-9);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        TVector<double> predicts(smallBatch.size());
+        UNIT_ASSERT_EXCEPTION(
+            CalcFlatParallel(*binaryModel.GetCurrentEvaluator(), smallBatch, 0, binaryModel.GetTreeCount() + 1, predicts, 2),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(TestIncrementalLeafIndexesMatchFullEvaluation) {
+        const auto model = TrainFloatCatboostModel(/*iterations*/ 60);
+        const size_t treeCount = model.GetTreeCount();
+        const size_t docCount = 70;
+        TFastRng64 rng(42);
+        TVector<TVector<float>> data(docCount, TVector<float>(3));
+        for (auto& doc : data) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        const auto features = GetFeatureRef(data);
+
+        TIncrementalLeafIndexCalcer calcer(model);
+        calcer.Reset(features, {});
+        for (ui32 changedFeature : {0, 2}) {
+            for (auto& doc : data) {
+                doc[changedFeature] = rng.GenRandReal1();
+            }
+            const TVector<ui32> oldLeafIndexes(calcer.GetLeafIndexes().begin(), calcer.GetLeafIndexes().end());
+            const auto updatedTrees = calcer.Update(features, {}, {changedFeature});
+            const auto& featureTrees = model.ModelTrees->GetApplyData()->FlatFeatureTrees[changedFeature];
+            UNIT_ASSERT_EQUAL(TVector<ui32>(updatedTrees.begin(), updatedTrees.end()), featureTrees);
+
+            TVector<ui32> expectedLeafIndexes(docCount * treeCount);
+            model.CalcLeafIndexes(features, {}, expectedLeafIndexes);
+            UNIT_ASSERT_EQUAL(TVector<ui32>(calcer.GetLeafIndexes().begin(), calcer.GetLeafIndexes().end()), expectedLeafIndexes);
+            // trees not splitting on the changed feature keep their leaves
+            for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                if (!IsIn(featureTrees, treeId)) {
+                    for (size_t docId = 0; docId < docCount; ++docId) {
+                        UNIT_ASSERT_VALUES_EQUAL(oldLeafIndexes[docId * treeCount + treeId], expectedLeafIndexes[docId * treeCount + treeId]);
+                    }
+                }
+            }
+
+            TVector<double> expectedPredicts(docCount);
+            model.GetCurrentEvaluator()->CalcFlat(features, expectedPredicts);
+            TVector<double> predicts(docCount);
+            calcer.CalcFlat(predicts);
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[docId], predicts[docId], 1e-9);
+            }
+        }
+        // features not used by the model change nothing
+        UNIT_ASSERT(calcer.Update(features, {}, {100}).empty());
+    }
+
     static void CheckCalcTextResult(
         const TFullModel& model,
         TConstArrayRef<TVector<TStringBuf>> transposedTextFeatures,
@@ -305,4 +837,75 @@ Y_UNIT_TEST_SUITE(TNonSymmetricTreeModel) {
         deserializedModel.Load(&strStream);
         CheckFlatCalcResult(deserializedModel, canonVals, expectedLeafIndexes);
     }
+
+    Y_UNIT_TEST(TestPackedNodesLayout) {
+        auto modelCalcer = SimpleAsymmetricModel();
+        const auto& trees = *modelCalcer.ModelTrees;
+        const auto nodes = trees.GetPackedNonSymmetricNodes();
+        const auto roots = trees.GetPackedNonSymmetricTreeRoots();
+        UNIT_ASSERT_VALUES_EQUAL(roots.size(), trees.GetTreeCount());
+        const size_t leafValuesCount = trees.GetModelTreeData()->GetLeafValues().size();
+        for (ui32 root : roots) {
+            UNIT_ASSERT(root % 2 == 1);
+        }
+        for (const auto& node : nodes) {
+            if (node.Next & TPackedNonSymmetricNode::TerminalFlag) {
+                UNIT_ASSERT(node.Next < (TPackedNonSymmetricNode::TerminalFlag | leafValuesCount));
+            } else {
+                UNIT_ASSERT(node.Next % 2 == 0);
+                UNIT_ASSERT(node.Next + 1 < nodes.size());
+            }
+        }
+        UNIT_ASSERT(SimpleFloatModel().ModelTrees->GetPackedNonSymmetricNodes().empty());
+    }
+
+    Y_UNIT_TEST(TestPackedTraversalMatchesObliviousTrees) {
+        const auto model = TrainFloatCatboostModel(/*iterations*/ 30);
+        auto asymmetricModel = model;
+        asymmetricModel.ModelTrees.GetMutable()->ConvertObliviousToAsymmetric();
+        // block sizes cover both full lockstep groups and the scalar tail
+        for (size_t docCount : {1, 7, 8, 13, 1000}) {
+            TFastRng64 rng(docCount);
+            TVector<TVector<float>> data(docCount, TVector<float>(3));
+            for (auto& doc : data) {
+                for (auto& value : doc) {
+                    value = rng.GenRandReal1();
+                }
+            }
+            const auto features = GetFeatureRef(data);
+            TVector<double> expectedPredicts(docCount);
+            // evaluators are created explicitly since model copies share the cached one
+            CreateEvaluator(EFormulaEvaluatorType::CPU, model)->CalcFlat(features, expectedPredicts);
+            TVector<double> predicts(docCount);
+            CreateEvaluator(EFormulaEvaluatorType::CPU, asymmetricModel)->CalcFlat(features, predicts);
+            for (size_t i = 0; i < docCount; ++i) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expectedPredicts[i], predicts[i], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestEvaluationStats) {
+        const auto model = SimpleFloatModel(2);
+        auto evaluator = model.GetCurrentEvaluator()->Clone();
+        UNIT_ASSERT(!evaluator->GetEvaluationStats());
+        evaluator->SetProperty("EvaluationStats", "true");
+
+        TVector<TVector<float>> data(100, TVector<float>{1.f, 0.f, 1.f});
+        TVector<double> predicts(data.size());
+        evaluator->CalcFlat(data, predicts);
+        evaluator->CalcFlat(TConstArrayRef<TVector<float>>(data.data(), 3), TArrayRef<double>(predicts.data(), 3));
+        evaluator->CalcFlatSingle(data[0], TArrayRef<double>(predicts.data(), 1));
+
+        const auto stats = evaluator->GetEvaluationStats();
+        UNIT_ASSERT(stats);
+        UNIT_ASSERT_VALUES_EQUAL(stats->CallCount, 3);
+        UNIT_ASSERT_VALUES_EQUAL(stats->ObjectCount, 104);
+        UNIT_ASSERT_VALUES_EQUAL(stats->BatchSizeHistogram[0], 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats->BatchSizeHistogram[1], 1);
+        UNIT_ASSERT_VALUES_EQUAL(stats->BatchSizeHistogram[6], 1);
+        UNIT_ASSERT(stats->TreesTime <= stats->TotalTime);
+
+        evaluator->SetProperty("EvaluationStats", "false");
+        UNIT_ASSERT(!evaluator->GetEvaluationStats());
+    }
 }
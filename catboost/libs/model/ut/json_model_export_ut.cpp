@@ -1,7 +1,11 @@
 #include <catboost/libs/model/ut/lib/model_test_helpers.h>
 
+#include <catboost/libs/helpers/json_helpers.h>
+#include <catboost/libs/model/model_export/json_model_helpers.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
 
+#include <util/stream/file.h>
+
 #include <library/cpp/testing/unittest/registar.h>
 
 using namespace std;
@@ -32,4 +36,11 @@ Y_UNIT_TEST_SUITE(TJsonModelExport) {
         model = ReadModel("model.json", EModelType::Json);
         UNIT_ASSERT(model.ModelTrees->GetModelTreeData()->GetLeafWeights().empty());
     }
+    Y_UNIT_TEST(TestStreamingOutputMatchesJsonValue) {
+        for (const auto& model : {TrainFloatCatboostModel(), TrainCatOnlyModel()}) {
+            OutputModelJson(model, "model.json");
+            const TString expected = WriteJsonWithCatBoostPrecision(ConvertModelToJson(model), true);
+            UNIT_ASSERT_VALUES_EQUAL(TFileInput("model.json").ReadAll(), expected);
+        }
+    }
 }
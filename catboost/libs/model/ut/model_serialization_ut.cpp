@@ -1,9 +1,14 @@
 #include <catboost/libs/model/ut/lib/model_test_helpers.h>
+#include <catboost/libs/model/compressed_model.h>
 #include <catboost/libs/model/features.h>
+#include <catboost/libs/model/lazy_ctr_provider.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/model/model_parts_registry.h>
 #include <catboost/libs/model/model_export/json_model_helpers.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
+#include <catboost/libs/model/sketch_ctr_provider.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 #include <catboost/private/libs/algo/apply.h>
 #include <catboost/private/libs/algo/learn_context.h>
@@ -51,6 +56,180 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         check(TrainCatOnlyNoOneHotModel());
     }
 
+    Y_UNIT_TEST(TestSerializeDeserializeFullModelMapped) {
+        auto check = [&](const TFullModel& model) {
+            OutputModel(model, "model.cbm");
+            TFullModel deserializedModel;
+            {
+                // the mapping should be kept alive by every model referencing it
+                TFullModel mappedModel = ReadZeroCopyModel("model.cbm");
+                deserializedModel = mappedModel;
+            }
+            UNIT_ASSERT_EQUAL(model, deserializedModel);
+            UNIT_ASSERT_EQUAL(model.HasValidCtrProvider(), deserializedModel.HasValidCtrProvider());
+        };
+        check(TrainFloatCatboostModel());
+        check(TrainCatOnlyNoOneHotModel());
+        UNIT_ASSERT_EXCEPTION(ReadZeroCopyModel("missing_model.cbm"), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestSerializeDeserializeFullModelAligned) {
+        const auto isAligned = [] (const void* ptr) {
+            return reinterpret_cast<uintptr_t>(ptr) % DEFAULT_MODEL_ARRAY_ALIGNMENT == 0;
+        };
+        auto check = [&](const TFullModel& model) {
+            OutputAlignedModel(model, "aligned_model.cbm");
+            const TFullModel mappedModel = ReadZeroCopyModel("aligned_model.cbm");
+            UNIT_ASSERT_EQUAL(model, mappedModel);
+            UNIT_ASSERT_EQUAL(model, ReadModel("aligned_model.cbm"));
+            // file mapping starts at a page boundary, so alignment in the file holds in memory
+            const auto& treeData = *mappedModel.ModelTrees->GetModelTreeData();
+            UNIT_ASSERT(isAligned(treeData.GetTreeSplits().data()));
+            UNIT_ASSERT(isAligned(treeData.GetLeafValues().data()));
+            if (const auto* ctrProvider = dynamic_cast<const TStaticCtrProvider*>(mappedModel.CtrProvider.Get())) {
+                for (const auto& [ctrBase, table] : ctrProvider->CtrData.LearnCtrs) {
+                    UNIT_ASSERT(isAligned(table.GetTypedArrayRefForBlobData<ui8>().data()));
+                }
+            }
+
+            TStringStream defaultStream;
+            model.Save(&defaultStream);
+            TStringStream alignedStream;
+            model.SaveAligned(&alignedStream);
+            UNIT_ASSERT(alignedStream.Size() >= defaultStream.Size());
+        };
+        check(TrainFloatCatboostModel());
+        check(TrainCatOnlyNoOneHotModel());
+    }
+
+    Y_UNIT_TEST(TestSerializeDeserializeFullModelLazyCtrs) {
+        const TFullModel model = TrainCatOnlyNoOneHotModel();
+        TStringStream strStream;
+        model.Save(&strStream);
+        const TVector<TVector<TStringBuf>> catFeatures = {{"a", "d", "e"}, {"b", "c", "f"}, {"a", "c", "e"}};
+        TVector<double> expected(catFeatures.size());
+        model.Calc(TVector<TConstArrayRef<float>>(catFeatures.size()), catFeatures, expected);
+        auto check = [&](const TFullModel& lazyModel) {
+            UNIT_ASSERT_EQUAL(model, lazyModel);
+            const auto* ctrProvider = dynamic_cast<const TLazyCtrProvider*>(lazyModel.CtrProvider.Get());
+            UNIT_ASSERT(ctrProvider);
+            UNIT_ASSERT(ctrProvider->GetTableCount() > 0);
+            for (const auto& usage : ctrProvider->GetTableUsage()) {
+                UNIT_ASSERT(!usage.Materialized);
+            }
+            TVector<double> results(catFeatures.size());
+            lazyModel.Calc(TVector<TConstArrayRef<float>>(catFeatures.size()), catFeatures, results);
+            UNIT_ASSERT_EQUAL(expected, results);
+            for (const auto& usage : ctrProvider->GetTableUsage()) {
+                UNIT_ASSERT(usage.Materialized);
+                UNIT_ASSERT(usage.CalcCount > 0);
+            }
+            // lazy provider saves the same section it was loaded from
+            TStringStream lazyStream;
+            lazyModel.Save(&lazyStream);
+            UNIT_ASSERT_EQUAL(strStream.Str(), lazyStream.Str());
+        };
+        {
+            TStringStream in(strStream.Str());
+            TFullModel lazyModel;
+            lazyModel.Load(&in, /*lazyCtrTables*/ true);
+            check(lazyModel);
+        }
+        check(ReadZeroCopyModel(strStream.Data(), strStream.Size(), /*lazyCtrTables*/ true));
+    }
+
+    Y_UNIT_TEST(TestSerializeDeserializeFullModelSketchCtrs) {
+        const TFullModel model = TrainCatOnlyNoOneHotModel();
+        // objects of learn dataset, so all values have statistics
+        const TVector<TVector<TStringBuf>> catFeatures = {{"a", "d", "e"}, {"a", "c", "f"}, {"b", "d", "f"}};
+        TVector<double> expected(catFeatures.size());
+        model.Calc(TVector<TConstArrayRef<float>>(catFeatures.size()), catFeatures, expected);
+
+        TFullModel sketchModel = model;
+        const auto* staticProvider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+        UNIT_ASSERT(staticProvider);
+        sketchModel.CtrProvider = MakeSketchCtrProvider(*staticProvider, /*width*/ 1 << 16, /*depth*/ 4);
+        sketchModel.UpdateDynamicData();
+        UNIT_ASSERT(sketchModel.HasValidCtrProvider());
+        TVector<double> results(catFeatures.size());
+        // few values, so they don't collide in wide sketches
+        sketchModel.Calc(TVector<TConstArrayRef<float>>(catFeatures.size()), catFeatures, results);
+        UNIT_ASSERT_EQUAL(expected, results);
+
+        auto check = [&](const TFullModel& deserializedModel) {
+            UNIT_ASSERT_EQUAL(sketchModel, deserializedModel);
+            const auto* ctrProvider = dynamic_cast<const TSketchCtrProvider*>(deserializedModel.CtrProvider.Get());
+            UNIT_ASSERT(ctrProvider);
+            UNIT_ASSERT_EQUAL(
+                ctrProvider->Sketches,
+                dynamic_cast<const TSketchCtrProvider*>(sketchModel.CtrProvider.Get())->Sketches
+            );
+            TVector<double> deserializedResults(catFeatures.size());
+            deserializedModel.Calc(TVector<TConstArrayRef<float>>(catFeatures.size()), catFeatures, deserializedResults);
+            UNIT_ASSERT_EQUAL(expected, deserializedResults);
+        };
+        TStringStream strStream;
+        sketchModel.Save(&strStream);
+        check(DeserializeModel(strStream.Str()));
+        check(ReadZeroCopyModel(strStream.Data(), strStream.Size()));
+
+        UNIT_ASSERT_EXCEPTION(MakeSketchCtrProvider(*staticProvider, /*width*/ 0, /*depth*/ 4), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestSerializeDeserializeFullModelCompressed) {
+        auto check = [&](const TFullModel& model, TStringBuf codecName) {
+            // small sections, so models are split into several of them
+            OutputCompressedModel(model, "compressed_model.cbm", codecName, /*sectionSize*/ 1000);
+            UNIT_ASSERT_EQUAL(model, ReadModel("compressed_model.cbm"));
+            UNIT_ASSERT_EQUAL(model, ReadZeroCopyModel("compressed_model.cbm"));
+            TStringStream strStream;
+            OutputCompressedModel(model, &strStream, codecName);
+            UNIT_ASSERT_EQUAL(model, DeserializeModel(strStream.Str()));
+            UNIT_ASSERT_EQUAL(model, ReadZeroCopyModel(strStream.Data(), strStream.Size()));
+        };
+        for (auto codecName : {"zstd_3", "lz4"}) {
+            check(TrainFloatCatboostModel(), codecName);
+            check(TrainCatOnlyNoOneHotModel(), codecName);
+        }
+        UNIT_ASSERT_EXCEPTION(OutputCompressedModel(SimpleFloatModel(), "compressed_model.cbm", "unknown_codec"), yexception);
+    }
+
+    Y_UNIT_TEST(TestModelPartsRegistry) {
+        const TFullModel model = TrainCatOnlyNoOneHotModel();
+        OutputModel(model, "registry_model.cbm");
+        TModelPartsRegistry registry;
+        {
+            const TFullModel first = registry.ReadModel("registry_model.cbm");
+            TFullModel second = registry.ReadModel("registry_model.cbm");
+            UNIT_ASSERT_EQUAL(model, second);
+            UNIT_ASSERT_EQUAL(first.ModelTrees.Get(), second.ModelTrees.Get());
+            const auto& firstCtrs = dynamic_cast<const TStaticCtrProvider&>(*first.CtrProvider).CtrData.LearnCtrs;
+            const auto& secondCtrs = dynamic_cast<const TStaticCtrProvider&>(*second.CtrProvider).CtrData.LearnCtrs;
+            UNIT_ASSERT(!firstCtrs.empty());
+            for (const auto& [base, table] : firstCtrs) {
+                const auto& secondTable = secondCtrs.at(base);
+                UNIT_ASSERT_EQUAL(table, secondTable);
+                UNIT_ASSERT_EQUAL(
+                    table.GetTypedArrayRefForBlobData<ui8>().data(),
+                    secondTable.GetTypedArrayRefForBlobData<ui8>().data()
+                );
+            }
+            const auto stats = registry.GetStats();
+            UNIT_ASSERT_VALUES_EQUAL(stats.ModelTreesCount, 1);
+            UNIT_ASSERT_VALUES_EQUAL(stats.CtrTableCount, firstCtrs.size());
+            UNIT_ASSERT_VALUES_EQUAL(stats.SharedPartCount, 1 + firstCtrs.size());
+
+            // modified copy stops sharing trees
+            second.SetScaleAndBias({2.0, {1.0}});
+            UNIT_ASSERT_UNEQUAL(first.ModelTrees.Get(), second.ModelTrees.Get());
+            registry.DropUnusedParts();
+            UNIT_ASSERT_VALUES_EQUAL(registry.GetStats().ModelTreesCount, 1);
+        }
+        registry.DropUnusedParts();
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetStats().ModelTreesCount, 0);
+        UNIT_ASSERT_VALUES_EQUAL(registry.GetStats().CtrTableCount, 0);
+    }
+
     Y_UNIT_TEST(TestSerializeDeserializeCoreML) {
         TFullModel trainedModel = TrainFloatCatboostModel();
         TStringStream strStream;
@@ -5,6 +5,9 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
 using namespace std;
 using namespace NCB;
 
@@ -97,6 +100,35 @@ Y_UNIT_TEST_SUITE(TModelSummTests) {
         UNIT_ASSERT_EQUAL(*mergedModel.ModelTrees, *bigModel.ModelTrees);
     }
 
+    Y_UNIT_TEST(SumWithFoldedEqualTrees) {
+        const auto model = TrainFloatCatboostModel(10);
+        const auto sumModel = SumModels({&model, &model}, {2.0, 1.0});
+        const auto foldedModel = SumModels(
+            {&model, &model},
+            {2.0, 1.0},
+            /*modelParamsPrefixes*/ {},
+            ECtrTableMergePolicy::IntersectingCountersAverage,
+            /*foldEqualTrees*/ true
+        );
+        UNIT_ASSERT_VALUES_EQUAL(sumModel.GetTreeCount(), 2 * model.GetTreeCount());
+        UNIT_ASSERT(foldedModel.GetTreeCount() <= model.GetTreeCount());
+
+        TFastRng64 rng(0);
+        TVector<TVector<float>> features(100, TVector<float>(3));
+        for (auto& doc : features) {
+            for (auto& value : doc) {
+                value = rng.GenRandReal1();
+            }
+        }
+        TVector<double> sumResult(features.size());
+        TVector<double> foldedResult(features.size());
+        sumModel.CalcFlat(features, sumResult);
+        foldedModel.CalcFlat(features, foldedResult);
+        for (auto idx : xrange(features.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(sumResult[idx], foldedResult[idx], 1e-9);
+        }
+    }
+
     Y_UNIT_TEST(SumEqualSliced) {
         AssertModelSumEqualSliced(GetAdultPool());
         AssertModelSumEqualSliced(GetMultiClassPool());
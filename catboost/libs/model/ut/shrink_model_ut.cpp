@@ -54,4 +54,53 @@ Y_UNIT_TEST_SUITE(TShrinkModel) {
         }
         model.Truncate(1, 3);
     }
+
+    Y_UNIT_TEST(TestCompactModelForApply) {
+        TDataProviderPtr pool = GetAdultPool();
+        for (TStringBuf growPolicy : {"SymmetricTree", "Lossguide"}) {
+            NJson::TJsonValue params;
+            params.InsertValue("learning_rate", 0.3);
+            params.InsertValue("iterations", 10);
+            params.InsertValue("grow_policy", growPolicy);
+            TFullModel model;
+            TEvalResult evalResult;
+            TrainModel(
+                params,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                Nothing(),
+                TDataProviders{pool, {pool}},
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                {&evalResult});
+            const auto binFeatureCount = model.ModelTrees->GetBinFeatures().size();
+            const auto result = ApplyModelMulti(model, *pool)[0];
+
+            model.CompactForApply();
+            UNIT_ASSERT(model.ModelTrees->GetBinFeatures().size() <= binFeatureCount);
+            const auto compactResult = ApplyModelMulti(model, *pool)[0];
+            UNIT_ASSERT_EQUAL(result.ysize(), compactResult.ysize());
+            for (int idx = 0; idx < result.ysize(); ++idx) {
+                UNIT_ASSERT_DOUBLES_EQUAL(result[idx], compactResult[idx], 1e-9);
+            }
+        }
+
+        // only one of the borders of the first feature is used
+        TFullModel model = SimpleFloatModel();
+        TVector<TVector<float>> features;
+        for (auto value : {-300.0f, 1.5f, 2.5f, 100.0f}) {
+            features.push_back({value, 0.0f, 1.0f});
+            features.push_back({value, 1.0f, 0.0f});
+        }
+        TVector<double> result(features.size());
+        model.CalcFlat(features, result);
+        model.CompactForApply();
+        UNIT_ASSERT_VALUES_EQUAL(model.ModelTrees->GetBinFeatures().size(), 3);
+        TVector<double> compactResult(features.size());
+        model.CalcFlat(features, compactResult);
+        UNIT_ASSERT_VALUES_EQUAL(result, compactResult);
+    }
 }
@@ -1,14 +1,18 @@
 #include "c_api.h"
 
 #include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/data/arrow_c_data_import.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/data_provider_builders.h>
 #include <catboost/libs/data/features_layout.h>
 #include <catboost/libs/helpers/polymorphic_type_containers.h>
 #include <catboost/libs/model/model.h>
 
-#include <util/generic/singleton.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
 #include <util/generic/xrange.h>
+#include <util/thread/singleton.h>
 #include <util/string/cast.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
@@ -27,6 +31,13 @@ struct TModelHandleContent {
 
 #define DATA_WRAPPER_PTR(x) ((TFeaturesDataWrapper*)(x))
 
+struct TPredictionContext {
+    THolder<NPar::TLocalExecutor> LocalExecutor; // nullptr for single threaded prediction
+    TVector<TConstArrayRef<float>> FeaturesVec;
+};
+
+#define PREDICTION_CONTEXT_PTR(x) ((TPredictionContext*)(x))
+
 struct TErrorMessageHolder {
     TString Message;
 };
@@ -57,7 +68,20 @@ public:
         );
     }
 
+    void AddArrowFeatures(const ArrowSchema& schema, ArrowArray* array) {
+        CB_ENSURE(!ArrowRecordBatch, "Arrow features have already been added");
+        ArrowRecordBatch = MakeHolder<NCB::TArrowCDataRecordBatch>(schema, array);
+        CB_ENSURE(
+            ArrowRecordBatch->GetRowCount() == DocsCount,
+            "Arrow record batch has " << ArrowRecordBatch->GetRowCount() << " rows, expected " << DocsCount
+        );
+    }
+
     NCB::TDataProviderPtr BuildDataProvider() {
+        if (ArrowRecordBatch) {
+            return BuildDataProviderFromArrow();
+        }
+
         size_t floatFeaturesCount = 0;
         size_t catFeaturesCount = 0;
         size_t textFeaturesCount = 0;
@@ -165,6 +189,36 @@ public:
         return DataProvider;
     }
 
+private:
+    NCB::TDataProviderPtr BuildDataProviderFromArrow() {
+        CB_ENSURE(
+            FloatFeatures.empty() && CatFeatures.empty() && TextFeatures.empty() && EmbeddingFeatures.empty(),
+            "Arrow features can't be combined with features added in other ways"
+        );
+
+        NCB::TDataMetaInfo metaInfo;
+        metaInfo.TargetType = NCB::ERawTargetType::Float;
+        metaInfo.TargetCount = 1;
+        metaInfo.FeaturesLayout = ArrowRecordBatch->CreateFeaturesLayout();
+        NCB::TDataProviderClosure dataProviderClosure(
+            NCB::EDatasetVisitorType::RawFeaturesOrder,
+            NCB::TDataProviderBuilderOptions(),
+            &NPar::LocalExecutor()
+        );
+        auto* visitor = dataProviderClosure.GetVisitor<NCB::IRawFeaturesOrderDataVisitor>();
+        CB_ENSURE(visitor);
+        visitor->Start(
+            metaInfo,
+            DocsCount,
+            NCB::EObjectsOrder::Undefined,
+            {ArrowRecordBatch->GetResourceHolder()}
+        );
+        ArrowRecordBatch->AddFeatures(*metaInfo.FeaturesLayout, visitor);
+        visitor->Finish();
+        DataProvider = dataProviderClosure.GetResult();
+        return DataProvider;
+    }
+
 private:
     struct TEmbeddingFeaturesDescriptor {
         const float*** Data = nullptr; // [embeddingFeatureId][sampleId][indexInEmbedding]
@@ -180,6 +234,7 @@ private:
     TVector<TEmbeddingFeaturesDescriptor> EmbeddingFeatures;
     TVector<TVector<TStringBuf>> CatFeaturesVec;
     TVector<TVector<TString>> TextFeaturesVec;
+    THolder<NCB::TArrowCDataRecordBatch> ArrowRecordBatch;
     NCB::TDataProviderPtr DataProvider;
     size_t DocsCount = 0;
 };
@@ -197,7 +252,7 @@ CATBOOST_API DataWrapperHandle* DataWrapperCreate(size_t docsCount) {
     try {
         return new TFeaturesDataWrapper(docsCount);
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
     }
     return nullptr;
 }
@@ -229,6 +284,17 @@ CATBOOST_API void AddEmbeddingFeatures(
     DATA_WRAPPER_PTR(dataWrapperHandle)->AddEmbeddingFeatures(embeddingFeatures, embeddingDimensions, embeddingFeaturesSize);
 }
 
+CATBOOST_API bool AddArrowFeatures(DataWrapperHandle* dataWrapperHandle, ArrowSchema* schema, ArrowArray* array) {
+    try {
+        CB_ENSURE(schema, "Arrow schema is null");
+        DATA_WRAPPER_PTR(dataWrapperHandle)->AddArrowFeatures(*schema, array);
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 
 CATBOOST_API DataProviderHandle* BuildDataProvider(DataWrapperHandle* dataWrapperHandle) {
     return DATA_WRAPPER_PTR(dataWrapperHandle)->BuildDataProvider().Get();
@@ -239,14 +305,14 @@ CATBOOST_API ModelCalcerHandle* ModelCalcerCreate() {
         auto* fullModel = new TFullModel;
         return new TModelHandleContent{.FullModel = THolder(fullModel)};
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
     }
 
     return nullptr;
 }
 
 CATBOOST_API const char* GetErrorString() {
-    return Singleton<TErrorMessageHolder>()->Message.data();
+    return FastTlsSingleton<TErrorMessageHolder>()->Message.data();
 }
 
 CATBOOST_API void ModelCalcerDelete(ModelCalcerHandle* modelHandle) {
@@ -259,7 +325,7 @@ CATBOOST_API bool LoadFullModelFromFile(ModelCalcerHandle* modelHandle, const ch
     try {
         *FULL_MODEL_PTR(modelHandle) = ReadModel(filename);
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
 
@@ -270,7 +336,7 @@ CATBOOST_API bool LoadFullModelFromBuffer(ModelCalcerHandle* modelHandle, const
     try {
         *FULL_MODEL_PTR(modelHandle) = ReadModel(binaryBuffer, binaryBufferSize);
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
 
@@ -283,7 +349,7 @@ CATBOOST_API bool EnableGPUEvaluation(ModelCalcerHandle* modelHandle, int device
         CB_ENSURE(deviceId == 0, "FIXME: Only device 0 is supported for now");
         FULL_MODEL_PTR(modelHandle)->SetEvaluatorType(EFormulaEvaluatorType::GPU);
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -312,7 +378,7 @@ CATBOOST_API bool GetSupportedEvaluatorTypes(
         if (*formulaEvaluatorTypes) {
             free(formulaEvaluatorTypes);
         }
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
 
         return false;
     }
@@ -323,7 +389,7 @@ CATBOOST_API bool SetPredictionType(ModelCalcerHandle* modelHandle, EApiPredicti
     try {
         FULL_MODEL_PTR(modelHandle)->SetPredictionType(static_cast<NCB::NModelEvaluation::EPredictionType>(predictionType));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
 
@@ -336,7 +402,45 @@ CATBOOST_API bool SetPredictionTypeString(ModelCalcerHandle* modelHandle, const
             FromString<NCB::NModelEvaluation::EPredictionType>(predictionTypeStr)
         );
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+
+    return true;
+}
+
+CATBOOST_API bool SetEvaluatorProperty(ModelCalcerHandle* modelHandle, const char* propName, const char* propValue) {
+    try {
+        FULL_MODEL_PTR(modelHandle)->SetEvaluatorProperty(propName, propValue);
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+
+    return true;
+}
+
+CATBOOST_API bool GetEvaluationStats(
+    ModelCalcerHandle* modelHandle,
+    size_t* callCount,
+    size_t* objectCount,
+    double* totalSeconds,
+    double* treesSeconds,
+    size_t* batchSizeHistogram,
+    size_t batchSizeHistogramSize
+) {
+    try {
+        const auto stats = EVALUATOR_PTR(modelHandle)->GetEvaluationStats();
+        CB_ENSURE(stats, "Evaluation stats are not collected, set \"EvaluationStats\" evaluator property to \"true\"");
+        *callCount = stats->CallCount;
+        *objectCount = stats->ObjectCount;
+        *totalSeconds = stats->TotalTime.SecondsFloat();
+        *treesSeconds = stats->TreesTime.SecondsFloat();
+        for (size_t bucketIdx : xrange(Min(batchSizeHistogramSize, stats->BatchSizeHistogram.size()))) {
+            batchSizeHistogram[bucketIdx] = stats->BatchSizeHistogram[bucketIdx];
+        }
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
 
@@ -355,7 +459,90 @@ CATBOOST_API bool CalcModelPredictionFlat(ModelCalcerHandle* modelHandle, size_t
             FULL_MODEL_PTR(modelHandle)->CalcFlat(featuresVec, TArrayRef<double>(result, resultSize));
         }
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+// calls f(blockStart, blockEnd) for blocks of objects in parallel with the context threads, context can be nullptr
+template <class TFunc>
+static void ForEachObjectsBlock(TPredictionContext* context, size_t docCount, const TFunc& f) {
+    const int threadCount = (context && context->LocalExecutor) ? context->LocalExecutor->GetThreadCount() + 1 : 1;
+    const size_t minBlockSize = 128;
+    const size_t blockCount = Min<size_t>(threadCount, (docCount + minBlockSize - 1) / minBlockSize);
+    if (blockCount <= 1) {
+        f(0, docCount);
+    } else {
+        const size_t blockSize = (docCount + blockCount - 1) / blockCount;
+        context->LocalExecutor->ExecRangeWithThrow(
+            [&] (int blockId) {
+                const size_t blockStart = blockId * blockSize;
+                const size_t blockEnd = Min(blockStart + blockSize, docCount);
+                f(blockStart, blockEnd);
+            },
+            0,
+            SafeIntegerCast<int>(blockCount),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+}
+
+CATBOOST_API PredictionContextHandle* PredictionContextCreate(size_t threadCount) {
+    try {
+        auto context = MakeHolder<TPredictionContext>();
+        if (threadCount > 1) {
+            context->LocalExecutor = MakeHolder<NPar::TLocalExecutor>();
+            context->LocalExecutor->RunAdditionalThreads(threadCount - 1);
+        }
+        return context.Release();
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+    }
+    return nullptr;
+}
+
+CATBOOST_API void PredictionContextDelete(PredictionContextHandle* contextHandle) {
+    if (contextHandle != nullptr) {
+        delete PREDICTION_CONTEXT_PTR(contextHandle);
+    }
+}
+
+CATBOOST_API bool CalcModelPredictionFlatWithContext(
+    ModelCalcerHandle* modelHandle,
+    PredictionContextHandle* contextHandle,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    double* result, size_t resultSize
+) {
+    try {
+        CB_ENSURE(contextHandle, "Prediction context is null");
+        TPredictionContext* context = PREDICTION_CONTEXT_PTR(contextHandle);
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        const size_t dimension = model.GetDimensionsCount();
+        CB_ENSURE(
+            resultSize == docCount * dimension,
+            "Result size should be " << docCount * dimension << ", got " << resultSize
+        );
+
+        auto& featuresVec = context->FeaturesVec;
+        featuresVec.resize(docCount); // keeps capacity between calls
+        for (size_t i = 0; i < docCount; ++i) {
+            featuresVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
+        }
+
+        ForEachObjectsBlock(
+            context,
+            docCount,
+            [&] (size_t blockStart, size_t blockEnd) {
+                model.CalcFlat(
+                    TConstArrayRef<TConstArrayRef<float>>(featuresVec).Slice(blockStart, blockEnd - blockStart),
+                    TArrayRef<double>(result + blockStart * dimension, (blockEnd - blockStart) * dimension)
+                );
+            }
+        );
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -369,7 +556,85 @@ CATBOOST_API bool CalcModelPredictionFlatTransposed(ModelCalcerHandle* modelHand
         }
         FULL_MODEL_PTR(modelHandle)->CalcFlatTransposed(featuresVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
+CATBOOST_API bool CalcModelLeafIndexes(
+    ModelCalcerHandle* modelHandle,
+    PredictionContextHandle* contextHandle,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    const char*** catFeatures, size_t catFeaturesSize,
+    size_t treeStart, size_t treeEnd,
+    bool globalLeafIndexes,
+    unsigned int* result, size_t resultSize
+) {
+    static_assert(sizeof(unsigned int) == sizeof(ui32));
+    try {
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        if (treeEnd == 0) {
+            treeEnd = model.GetTreeCount();
+        }
+        CB_ENSURE(
+            treeStart <= treeEnd && treeEnd <= model.GetTreeCount(),
+            "Wrong tree range [" << treeStart << ", " << treeEnd << ") for model with " << model.GetTreeCount() << " trees"
+        );
+        const size_t treeCount = treeEnd - treeStart;
+        CB_ENSURE(
+            resultSize == docCount * treeCount,
+            "Result size should be " << docCount * treeCount << ", got " << resultSize
+        );
+
+        TVector<TConstArrayRef<float>> floatFeaturesVec(docCount);
+        TVector<TVector<TStringBuf>> catFeaturesVec(docCount, TVector<TStringBuf>(catFeaturesSize));
+        for (size_t i = 0; i < docCount; ++i) {
+            if (floatFeaturesSize > 0) {
+                floatFeaturesVec[i] = TConstArrayRef<float>(floatFeatures[i], floatFeaturesSize);
+            }
+            for (size_t catFeatureIdx = 0; catFeatureIdx < catFeaturesSize; ++catFeatureIdx) {
+                catFeaturesVec[i][catFeatureIdx] = catFeatures[i][catFeatureIdx];
+            }
+        }
+        TVector<TConstArrayRef<TStringBuf>> catFeaturesRefs(catFeaturesVec.begin(), catFeaturesVec.end());
+
+        TVector<ui32> leafOffsets;
+        if (globalLeafIndexes) {
+            const auto treeLeafCounts = model.GetTreeLeafCounts();
+            leafOffsets.yresize(treeCount);
+            ui32 leafOffset = 0;
+            for (auto treeIdx : xrange(treeCount)) {
+                leafOffsets[treeIdx] = leafOffset;
+                leafOffset += treeLeafCounts[treeStart + treeIdx];
+            }
+        }
+
+        ForEachObjectsBlock(
+            PREDICTION_CONTEXT_PTR(contextHandle),
+            docCount,
+            [&] (size_t blockStart, size_t blockEnd) {
+                const size_t blockDocCount = blockEnd - blockStart;
+                TArrayRef<ui32> blockResult(reinterpret_cast<ui32*>(result) + blockStart * treeCount, blockDocCount * treeCount);
+                model.CalcLeafIndexes(
+                    TConstArrayRef<TConstArrayRef<float>>(floatFeaturesVec).Slice(blockStart, blockDocCount),
+                    TConstArrayRef<TConstArrayRef<TStringBuf>>(catFeaturesRefs).Slice(blockStart, blockDocCount),
+                    treeStart,
+                    treeEnd,
+                    blockResult
+                );
+                if (globalLeafIndexes) {
+                    for (auto docIdx : xrange(blockDocCount)) {
+                        for (auto treeIdx : xrange(treeCount)) {
+                            blockResult[docIdx * treeCount + treeIdx] += leafOffsets[treeIdx];
+                        }
+                    }
+                }
+            }
+        );
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -394,7 +659,7 @@ CATBOOST_API bool CalcModelPrediction(
         }
         FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -424,7 +689,7 @@ CATBOOST_API bool CalcModelPredictionText(
         }
         FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, textFeaturesVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -470,7 +735,7 @@ CATBOOST_API bool CalcModelPredictionTextAndEmbeddings(
             TArrayRef<double>(result, resultSize)
         );
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -492,7 +757,7 @@ CATBOOST_API bool CalcModelPredictionSingle(
         }
         FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -515,7 +780,7 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* mo
         }
         FULL_MODEL_PTR(modelHandle)->Calc(floatFeaturesVec, catFeaturesVec, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -543,7 +808,7 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeaturesAndTextFeatures(ModelC
         }
         FULL_MODEL_PTR(modelHandle)->CalcWithHashedCatAndTextAndEmbeddings(floatFeaturesVec, catFeaturesVec, textFeaturesVec, {}, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -589,7 +854,7 @@ CATBOOST_API bool CalcModelPredictionWithHashedCatFeaturesAndTextAndEmbeddingFea
             TArrayRef<double>(result, resultSize)
         );
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -609,7 +874,7 @@ CATBOOST_API bool PredictSpecificClassFlat(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -635,7 +900,7 @@ CATBOOST_API bool PredictSpecificClass(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -663,7 +928,7 @@ CATBOOST_API bool PredictSpecificClassText(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -693,7 +958,7 @@ CATBOOST_API bool PredictSpecificClassTextAndEmbeddings(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -718,7 +983,7 @@ CATBOOST_API bool PredictSpecificClassSingle(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -744,7 +1009,7 @@ CATBOOST_API bool PredictSpecificClassWithHashedCatFeatures(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -772,7 +1037,7 @@ CATBOOST_API bool PredictSpecificClassWithHashedCatFeaturesAndTextFeatures(
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -802,7 +1067,7 @@ CATBOOST_API bool PredictSpecificClassWithHashedCatFeaturesAndTextAndEmbeddingFe
         }
         GetSpecificClass(classId, rawResult, dim, TArrayRef<double>(result, resultSize));
     } catch (...) {
-        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
         return false;
     }
     return true;
@@ -838,6 +1103,21 @@ CATBOOST_API size_t GetTreeCount(ModelCalcerHandle* modelHandle) {
     return FULL_MODEL_PTR(modelHandle)->GetTreeCount();
 }
 
+CATBOOST_API bool GetModelTreeLeafCounts(ModelCalcerHandle* modelHandle, size_t* treeLeafCounts, size_t treeCount) {
+    try {
+        const auto modelTreeLeafCounts = FULL_MODEL_PTR(modelHandle)->GetTreeLeafCounts();
+        CB_ENSURE(
+            treeCount == modelTreeLeafCounts.size(),
+            "Tree count should be " << modelTreeLeafCounts.size() << ", got " << treeCount
+        );
+        std::copy(modelTreeLeafCounts.begin(), modelTreeLeafCounts.end(), treeLeafCounts);
+    } catch (...) {
+        FastTlsSingleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 CATBOOST_API size_t GetDimensionsCount(ModelCalcerHandle* modelHandle) {
     return FULL_MODEL_PTR(modelHandle)->GetDimensionsCount();
 }
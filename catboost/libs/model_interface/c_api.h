@@ -25,6 +25,9 @@ extern "C" {
 
 typedef void DataWrapperHandle;
 
+struct ArrowSchema;
+struct ArrowArray;
+
 typedef void DataProviderHandle;
 
 /**
@@ -43,10 +46,31 @@ CATBOOST_API void AddTextFeatures(DataWrapperHandle* dataWrapperHandle, const ch
 
 CATBOOST_API void AddEmbeddingFeatures(DataWrapperHandle* dataWrapperHandle, const float*** embeddingFeatures, size_t* embeddingDimensions, size_t embeddingFeaturesSize);
 
+/**
+ * Use record batch passed through Apache Arrow C data interface as features, each column is a feature.
+ * Numeric and boolean columns are float features, string and dictionary encoded columns are categorical.
+ * Numeric columns without nulls are not copied.
+ * Can't be combined with other Add*Features calls, record batch should have docsCount rows.
+ * @param schema - schema of record batch (struct type), it is not released
+ * @param array - record batch as struct array, it is moved (array->release is set to NULL) and released
+ *  when the data wrapper and data providers built from it are deleted
+ * @return false if error occured
+ */
+CATBOOST_API bool AddArrowFeatures(DataWrapperHandle* dataWrapperHandle, struct ArrowSchema* schema, struct ArrowArray* array);
+
 CATBOOST_API DataProviderHandle* BuildDataProvider(DataWrapperHandle* dataWrapperHandle);
 
+/**
+ * Model handle.
+ * Prediction functions (CalcModelPrediction*, PredictSpecificClass*) and getters can be called for the same
+ * handle from several threads concurrently without external synchronization.
+ * Functions that modify the model (Load*, EnableGPUEvaluation, SetPredictionType*, SetEvaluatorProperty)
+ * and ModelCalcerDelete must not be called concurrently with any other function for the same handle.
+ */
 typedef void ModelCalcerHandle;
 
+typedef void PredictionContextHandle;
+
 enum EApiPredictionType {
     APT_RAW_FORMULA_VAL = 0,
     APT_EXPONENT = 1,
@@ -75,6 +99,7 @@ CATBOOST_API void ModelCalcerDelete(ModelCalcerHandle* modelHandle);
 /**
  * If error occured will return stored exception message.
  * If no error occured, will return invalid pointer
+ * Error message is stored per thread, so it describes the last failed call made from the calling thread.
  * @return
  */
 CATBOOST_API const char* GetErrorString();
@@ -131,6 +156,28 @@ CATBOOST_API bool SetPredictionType(ModelCalcerHandle* modelHandle, enum EApiPre
 */
 CATBOOST_API bool SetPredictionTypeString(ModelCalcerHandle* modelHandle, const char* predictionTypeStr);
 
+/**
+ * Set property of the current model evaluator, e.g. "PipelineStageCount" of GPU evaluator
+ * Properties are reset when evaluator type changes (see EnableGPUEvaluation)
+ * @return false if error occured
+*/
+CATBOOST_API bool SetEvaluatorProperty(ModelCalcerHandle* modelHandle, const char* propName, const char* propValue);
+
+/**
+ * Get totals of evaluation calls collected since "EvaluationStats" property of CPU evaluator was set to "true"
+ * batchSizeHistogram[i] is the number of calls with object count in [2^i, 2^(i+1)), the last bucket is unbounded
+ * @param batchSizeHistogram array of batchSizeHistogramSize elements, at most 16 first buckets are written
+ * @return false if error occured or stats are not collected by the current evaluator
+*/
+CATBOOST_API bool GetEvaluationStats(
+    ModelCalcerHandle* modelHandle,
+    size_t* callCount,
+    size_t* objectCount,
+    double* totalSeconds,
+    double* treesSeconds,
+    size_t* batchSizeHistogram,
+    size_t batchSizeHistogramSize);
+
 
 /**
  * **Use this method only if you really understand what you want.**
@@ -152,6 +199,30 @@ CATBOOST_API bool CalcModelPredictionFlat(
     double* result, size_t resultSize);
 
 
+/**
+ * Create prediction context for repeated CalcModelPredictionFlatWithContext calls.
+ * Context holds buffers reused between calls and a thread pool if threadCount > 1.
+ * Context can be shared between models but must not be used by several threads at once.
+ * @param threadCount number of threads used for a single prediction call, 0 or 1 means the calling thread only
+ * @return context handle or NULL if error occured
+ */
+CATBOOST_API PredictionContextHandle* PredictionContextCreate(size_t threadCount);
+
+CATBOOST_API void PredictionContextDelete(PredictionContextHandle* contextHandle);
+
+/**
+ * Same as CalcModelPredictionFlat, but buffers are reused between calls with the same context and
+ * objects are evaluated in parallel with the context threads.
+ * @param contextHandle context created by PredictionContextCreate
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelPredictionFlatWithContext(
+    ModelCalcerHandle* modelHandle,
+    PredictionContextHandle* contextHandle,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    double* result, size_t resultSize);
+
 /**
  * **Use this method only if you really understand what you want.**
  * Calculate raw model predictions on transposed dataset layout
@@ -170,6 +241,36 @@ CATBOOST_API bool CalcModelPredictionFlatTransposed(
     const float** floatFeatures, size_t floatFeaturesSize,
     double* result, size_t resultSize);
 
+/**
+ * Calculate indexes of leaves to which objects are mapped by trees from interval [treeStart, treeEnd)
+ * @param calcer model handle
+ * @param contextHandle context created by PredictionContextCreate, objects are processed in parallel with
+ * the context threads. Can be NULL, then objects are processed by the calling thread
+ * @param docCount object count
+ * @param floatFeatures array of array of float (first dimension is object index, second is feature index)
+ * @param floatFeaturesSize float feature count
+ * @param catFeatures array of array of char* categorical value pointers.
+ * String pointer should point to zero terminated string.
+ * @param catFeaturesSize categorical feature count
+ * @param treeStart first tree index
+ * @param treeEnd end tree index, 0 means the model tree count
+ * @param globalLeafIndexes if true, leaf indexes of each tree are shifted by the total leaf count of the previous
+ * trees from [treeStart, treeEnd), so results are column indices of a one-hot CSR matrix with
+ * (treeEnd - treeStart) unit elements in every row (see GetModelTreeLeafCounts for the column count)
+ * @param result pointer to user allocated results vector, indexation is [objectIndex * (treeEnd - treeStart) + treeIndex - treeStart]
+ * @param resultSize result size should be equal to docCount * (treeEnd - treeStart)
+ * @return false if error occured
+ */
+CATBOOST_API bool CalcModelLeafIndexes(
+    ModelCalcerHandle* modelHandle,
+    PredictionContextHandle* contextHandle,
+    size_t docCount,
+    const float** floatFeatures, size_t floatFeaturesSize,
+    const char*** catFeatures, size_t catFeaturesSize,
+    size_t treeStart, size_t treeEnd,
+    bool globalLeafIndexes,
+    unsigned int* result, size_t resultSize);
+
 /**
  * Calculate raw model predictions on float features and string categorical feature values
  * @param calcer model handle
@@ -425,6 +526,15 @@ CATBOOST_API size_t GetEmbeddingFeaturesCount(ModelCalcerHandle* modelHandle);
  */
 CATBOOST_API size_t GetTreeCount(ModelCalcerHandle* modelHandle);
 
+/**
+ * Get leaf counts of model trees
+ * @param calcer model handle
+ * @param treeLeafCounts pointer to user allocated vector
+ * @param treeCount vector size, should be equal to the model tree count
+ * @return false if error occured
+ */
+CATBOOST_API bool GetModelTreeLeafCounts(ModelCalcerHandle* modelHandle, size_t* treeLeafCounts, size_t treeCount);
+
 /**
  * Get number of dimensions in model
  * @param calcer model handle
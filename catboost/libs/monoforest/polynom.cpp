@@ -1,5 +1,6 @@
 #include "polynom.h"
 
+#include <catboost/libs/helpers/int_cast.h>
 #include <catboost/libs/helpers/set.h>
 
 #include <util/generic/xrange.h>
@@ -10,6 +11,22 @@ namespace NMonoForest {
         int Sign = 1;
     };
 
+    static void AddMonomStat(const TMonomStat& stat, TMonomStat* dst) {
+        if (dst->Weight < 0) {
+            dst->Weight = stat.Weight;
+        } else {
+            CB_ENSURE(dst->Weight == stat.Weight,
+                      "error: monom weight depends on dataset only: " << stat.Weight << " ≠ "
+                                                                      << dst->Weight);
+        }
+        if (dst->Value.size() < stat.Value.size()) {
+            dst->Value.resize(stat.Value.size());
+        }
+        for (auto k : xrange(stat.Value.size())) {
+            dst->Value[k] += stat.Value[k];
+        }
+    }
+
     static inline TVector<TPathBit> LeafToPolynoms(const int path, int maxDepth) {
         TVector<TPathBit> pathBits = {{}};
         for (int depth = 0; depth < maxDepth; ++depth) {
@@ -124,20 +141,7 @@ namespace NMonoForest {
         }
 
         for (const auto& [structure, stat] : monomsEnsemble) {
-            auto& dst = MonomsEnsemble[structure];
-            if (dst.Weight < 0) {
-                dst.Weight = stat.Weight;
-            } else {
-                CB_ENSURE(dst.Weight == stat.Weight,
-                          "error: monom weight depends on dataset only: " << stat.Weight << " ≠ "
-                                                                          << dst.Weight);
-            }
-            if (dst.Value.size() < tree.OutputDim()) {
-                dst.Value.resize(tree.OutputDim());
-            }
-            for (ui32 k = 0; k < tree.OutputDim(); ++k) {
-                dst.Value[k] += stat.Value[k];
-            }
+            AddMonomStat(stat, &MonomsEnsemble[structure]);
         }
     }
 
@@ -189,7 +193,80 @@ namespace NMonoForest {
     }
 
     TPolynom TPolynomBuilder::Build() {
-        return {MonomsEnsemble};
+        TPolynom polynom{std::move(MonomsEnsemble)};
+        MonomsEnsemble.clear();
+        return polynom;
+    }
+
+    TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel, NPar::ILocalExecutor* localExecutor) {
+        const int treeCount = SafeIntegerCast<int>(additiveModel.Size());
+        NPar::ILocalExecutor::TExecRangeParams blockParams(0, treeCount);
+        blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+        const int blockCount = blockParams.GetBlockCount();
+
+        TVector<TPolynom> blockPolynoms(blockCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const int blockStart = blockIdx * blockParams.GetBlockSize();
+                const int blockEnd = Min(blockStart + blockParams.GetBlockSize(), treeCount);
+                TPolynomBuilder builder;
+                for (auto treeIdx : xrange(blockStart, blockEnd)) {
+                    builder.AddTree(additiveModel.GetWeakModel(treeIdx));
+                }
+                blockPolynoms[blockIdx] = builder.Build();
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        if (blockCount == 1) {
+            return std::move(blockPolynoms[0]);
+        }
+
+        const int shardCount = blockCount;
+        TVector<TVector<TVector<TMonom>>> blockShards(blockCount); // [blockIdx][shardIdx]
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& shards = blockShards[blockIdx];
+                shards.resize(shardCount);
+                for (auto& [structure, stat] : blockPolynoms[blockIdx].MonomsEnsemble) {
+                    auto& shard = shards[THash<TMonomStructure>()(structure) % shardCount];
+                    shard.push_back({structure, std::move(stat)});
+                }
+                blockPolynoms[blockIdx].MonomsEnsemble.clear();
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        // monom keys of different shards are disjoint, so shards are merged without any synchronization
+        TVector<THashMap<TMonomStructure, TMonomStat>> shardEnsembles(shardCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int shardIdx) {
+                auto& ensemble = shardEnsembles[shardIdx];
+                for (auto& shards : blockShards) {
+                    for (const auto& monom : shards[shardIdx]) {
+                        AddMonomStat(monom.Stat, &ensemble[monom.Structure]);
+                    }
+                    TVector<TMonom>().swap(shards[shardIdx]);
+                }
+            },
+            0,
+            shardCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        size_t monomCount = 0;
+        for (const auto& ensemble : shardEnsembles) {
+            monomCount += ensemble.size();
+        }
+        TPolynom polynom;
+        polynom.MonomsEnsemble.reserve(monomCount);
+        for (auto& ensemble : shardEnsembles) {
+            for (auto& [structure, stat] : ensemble) {
+                polynom.MonomsEnsemble.emplace(structure, std::move(stat));
+            }
+            ensemble.clear();
+        }
+        return polynom;
     }
 
     static inline void AddMonomToTree(const TMonom& monom, const TObliviousTreeStructure& treeStructure, TArrayRef<double> leafValues) {
@@ -4,6 +4,9 @@
 #include "monom.h"
 #include "oblivious_tree.h"
 #include "non_symmetric_tree.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/hash.h>
 
 namespace NMonoForest {
@@ -22,12 +25,18 @@ namespace NMonoForest {
     public:
         void AddTree(const TObliviousTree& tree);
         void AddTree(const TNonSymmetricTree& tree);
+        // moves accumulated monoms to the result, builder is empty after that
         TPolynom Build();
 
     private:
         THashMap<TMonomStructure, TMonomStat> MonomsEnsemble;
     };
 
+    /* Trees are added to polynoms of tree blocks in parallel,
+     * then block polynoms are split into shards by monom hash and every shard is merged independently.
+     */
+    TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel, NPar::ILocalExecutor* localExecutor);
+
     template <typename TWeakModel>
     class IPolynomToAdditiveModelConverter {
     public:
@@ -13,6 +13,7 @@
 #include <catboost/private/libs/algo/train.h>
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/data/feature_names_converter.h>
+#include <catboost/libs/data/quantization.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
@@ -319,6 +320,43 @@ void UpdatePermutationBlockSize(
     }
 }
 
+NCB::TDataProviderPtr QuantizeDataForCrossValidation(
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    NCB::TDataProviderPtr data,
+    NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    ui64 cpuUsedRamLimit,
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor
+) {
+    if (data->RefCount() > 1) {
+        // data is shared with the caller, get own provider to move from it
+        auto fullSubset = GetSubset(
+            data->ObjectsGrouping,
+            TArraySubsetIndexing<ui32>(TFullSubset<ui32>(data->ObjectsGrouping->GetGroupCount())),
+            EObjectsOrder::Ordered
+        );
+        data = data->GetSubset(fullSubset, cpuUsedRamLimit, localExecutor);
+    }
+
+    TQuantizationOptions quantizationOptions;
+    PrepareQuantizationParameters(
+        catBoostOptions,
+        data->MetaInfo,
+        /*bordersFile*/ Nothing(),
+        &quantizationOptions,
+        &quantizedFeaturesInfo
+    );
+    TRawDataProviderPtr rawData = data->CastMoveTo<TRawObjectsDataProvider>();
+    CB_ENSURE(rawData, "Only raw data can be quantized for cross-validation");
+    return Quantize(
+        quantizationOptions,
+        std::move(rawData),
+        quantizedFeaturesInfo,
+        rand,
+        localExecutor
+    )->CastMoveTo<TObjectsDataProvider>();
+}
+
 void CrossValidate(
     NJson::TJsonValue plainJsonParams,
     NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
@@ -376,6 +414,17 @@ void CrossValidate(
         data = data->GetSubset(objectsGroupingSubset, cpuUsedRamLimit, localExecutor);
     }
 
+    if (cvParams.ShareQuantizedData && dynamic_cast<TRawObjectsDataProvider*>(data->ObjectsData.Get())) {
+        data = QuantizeDataForCrossValidation(
+            catBoostOptions,
+            std::move(data),
+            quantizedFeaturesInfo,
+            cpuUsedRamLimit,
+            &rand,
+            localExecutor
+        );
+    }
+
     const auto overfittingDetectorOptions = catBoostOptions.BoostingOptions->OverfittingDetector;
     catBoostOptions.BoostingOptions->OverfittingDetector->OverfittingDetectorType = EOverfittingDetectorType::None;
 
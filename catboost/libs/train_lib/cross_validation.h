@@ -159,6 +159,18 @@ TVector<TDataProvidersTemplate> PrepareCvFolds(
     return result;
 }
 
+/* Quantize the whole raw dataset before splitting it to folds, so folds share quantized features data.
+ * quantizedFeaturesInfo can be nullptr, then it is created from catBoostOptions.
+ * If data is shared with the caller, it is not changed.
+ */
+NCB::TDataProviderPtr QuantizeDataForCrossValidation(
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    NCB::TDataProviderPtr data,
+    NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    ui64 cpuUsedRamLimit,
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor);
+
 void CrossValidate(
     NJson::TJsonValue plainJsonParams,
     NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
@@ -32,8 +32,11 @@
 #include <catboost/private/libs/options/path_helpers.h>
 #include <catboost/private/libs/options/plain_options_helper.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/hash_set.h>
 #include <util/generic/scope.h>
 #include <util/generic/xrange.h>
@@ -829,6 +832,29 @@ static ui32 GetTrainingCount(const NCatboostOptions::TFeatureEvalOptions& featur
     return foldCount * GetTrainingCountPerFold(featureEvalOptions);
 }
 
+/* Trainings of folds of a feature set are independent, but snapshots store the progress of a single training,
+ * and GPU trainings use all devices.
+ */
+static ui32 GetParallelTrainingCount(
+    const NCatboostOptions::TFeatureEvalOptions& featureEvalOptions,
+    ETaskType taskType,
+    const NCatboostOptions::TOutputFilesOptions& outputFileOptions
+) {
+    const ui32 parallelTrainingCount = featureEvalOptions.ParallelTrainingCount;
+    if (parallelTrainingCount <= 1) {
+        return 1;
+    }
+    if (taskType == ETaskType::GPU) {
+        CATBOOST_WARNING_LOG << "Parallel trainings are not supported on GPU, models are trained one at a time" << Endl;
+        return 1;
+    }
+    if (outputFileOptions.SaveSnapshot()) {
+        CATBOOST_WARNING_LOG << "Parallel trainings are not supported with snapshots, models are trained one at a time" << Endl;
+        return 1;
+    }
+    return parallelTrainingCount;
+}
+
 static void EvaluateFeaturesImpl(
     const NCatboostOptions::TCatBoostOptions& catBoostOptions,
     const NCatboostOptions::TOutputFilesOptions& outputFileOptions,
@@ -950,6 +976,7 @@ static void EvaluateFeaturesImpl(
     ui32 trainingIdx = processedFoldCount * GetTrainingCountPerFold(featureEvalOptions);
 
     const ui32 offsetInRange = cvParams.Initialized() ? 0 : featureEvalOptions.Offset.Get();
+    const ui32 parallelTrainingCount = GetParallelTrainingCount(featureEvalOptions, taskType, outputFileOptions);
     const auto trainFullModels = [&] (
         bool isTest,
         ui32 featureSetIdx,
@@ -958,9 +985,20 @@ static void EvaluateFeaturesImpl(
         const auto topLevelTrainDir = outputFileOptions.GetTrainDir();
         const bool isCalcFstr = !outputFileOptions.CreateFstrIternalFullPath().empty();
         const bool isCalcRegularFstr = !outputFileOptions.CreateFstrRegularFullPath().empty();
+
+        struct TFoldTraining {
+            ui32 FoldIdx;
+            ui32 TrainingIdx;
+            ui64 RandomSeed;
+            THolder<TFoldContext> FoldContext;
+            TVector<std::pair<double, TString>> FeatureStrengths;
+            TVector<std::pair<double, TString>> RegularFeatureStrengths;
+        };
+
+        // seeds are generated in the order of sequential trainings, so models do not depend on parallelism
+        TVector<TFoldTraining> foldTrainings;
         for (auto foldIdx : xrange(foldCount)) {
             ++trainingIdx;
-            CATBOOST_NOTICE_LOG << "Training model number " << trainingIdx << Endl;
 
             const bool haveSummary = callbacks->HaveEvalFeatureSummary(
                 foldRangeBegin,
@@ -969,50 +1007,60 @@ static void EvaluateFeaturesImpl(
                 offsetInRange + foldIdx);
 
             if (haveSummary) {
+                CATBOOST_NOTICE_LOG << "Training model number " << trainingIdx << " is skipped, its results are loaded from snapshot" << Endl;
                 continue;
             }
+            foldTrainings.push_back(TFoldTraining{foldIdx, trainingIdx, rand.GenRand(), nullptr, {}, {}});
+        }
+
+        const auto trainFold = [&] (
+            TFoldTraining* foldTraining,
+            const NCatboostOptions::TCatBoostOptions& foldOptions,
+            TFeatureEvaluationCallbacks* foldCallbacks,
+            NPar::ILocalExecutor* localExecutor) {
+
+            const ui32 foldIdx = foldTraining->FoldIdx;
+            CATBOOST_NOTICE_LOG << "Training model number " << foldTraining->TrainingIdx << Endl;
 
             THPTimer timer;
 
-            TFoldContext foldContext(
+            foldTraining->FoldContext = MakeHolder<TFoldContext>(
                 foldRangeBegin + offsetInRange + foldIdx,
                 taskType,
                 outputFileOptions,
                 std::move((*foldsData)[foldIdx]),
-                rand.GenRand(),
+                foldTraining->RandomSeed,
                 /*hasFullModel*/true);
+            auto& foldContext = *foldTraining->FoldContext;
             const auto foldDir = MakeFoldDirName(featureEvalOptions, isTest, featureSetIdx, foldContext.FoldIdx);
-            callbacks->FoldRangeBegin = foldRangeBegin;
-            callbacks->FeatureSetIndex = featureSetIdx;
-            callbacks->IsTest = isTest;
-            callbacks->FoldIndex = offsetInRange + foldIdx;
-            callbacks->ResetIterationIndex();
+            foldCallbacks->FoldRangeBegin = foldRangeBegin;
+            foldCallbacks->FeatureSetIndex = featureSetIdx;
+            foldCallbacks->IsTest = isTest;
+            foldCallbacks->FoldIndex = offsetInRange + foldIdx;
+            foldCallbacks->ResetIterationIndex();
             foldContext.OutputOptions.SetSaveSnapshotFlag(outputFileOptions.SaveSnapshot());
             CATBOOST_NOTICE_LOG << "Learn dataset: " << foldContext.TrainingData.Learn->ObjectsGrouping->GetObjectCount() << " objects, "
                 << foldContext.TrainingData.Learn->ObjectsGrouping->GetGroupCount() << " groups" << Endl;
             CATBOOST_NOTICE_LOG << "Test dataset: " << foldContext.TrainingData.Test[0]->ObjectsGrouping->GetObjectCount() << " objects, "
                 << foldContext.TrainingData.Test[0]->ObjectsGrouping->GetGroupCount() << " groups" << Endl;
+            THolder<IModelTrainer> modelTrainerHolder(TTrainerFactory::Construct(taskType));
             Train(
-                dataSpecificOptions,
+                foldOptions,
                 JoinFsPaths(topLevelTrainDir, foldDir),
                 objectiveDescriptor,
                 evalMetricDescriptor,
                 labelConverter,
                 metrics,
                 /*isErrorTrackerActive*/false,
-                callbacks,
+                foldCallbacks,
                 &foldContext,
                 modelTrainerHolder.Get(),
-                &NPar::LocalExecutor());
+                localExecutor);
 
             if (testFoldsData) {
                 CalcMetricsForTest(metrics, approxDimension, testFoldsData[foldIdx].Test[0], &foldContext);
             }
 
-            results->MetricsHistory[isTest][featureSetIdx].emplace_back(foldContext.MetricValuesOnTest);
-            results->AppendFeatureSetMetrics(isTest, featureSetIdx, foldContext.MetricValuesOnTest);
-            results->Models[isTest][featureSetIdx].emplace_back(foldContext.FullModel.GetRef());
-
             CATBOOST_INFO_LOG << "Fold " << foldContext.FoldIdx << ": model built in " <<
                 FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
 
@@ -1020,18 +1068,70 @@ static void EvaluateFeaturesImpl(
                 const auto& model = foldContext.FullModel.GetRef();
                 const NCB::TFeaturesLayout layout = MakeFeaturesLayout(model);
                 const auto fstrType = outputFileOptions.GetFstrType();
-                const auto effect = CalcFeatureEffect(model, /*dataset*/nullptr, fstrType, &NPar::LocalExecutor());
-                results->FeatureStrengths[isTest][featureSetIdx].emplace_back(ExpandFeatureDescriptions(layout, effect));
+                const auto effect = CalcFeatureEffect(model, /*dataset*/nullptr, fstrType, localExecutor);
+                foldTraining->FeatureStrengths = ExpandFeatureDescriptions(layout, effect);
                 if (isCalcRegularFstr) {
                     const auto regularEffect = CalcRegularFeatureEffect(
                         effect,
                         model);
+                    foldTraining->RegularFeatureStrengths = ExpandFeatureDescriptions(layout, regularEffect);
+                }
+            }
+        };
+
+        // results are appended in the order of folds
+        const auto appendFoldResults = [&] (TFoldTraining* foldTraining) {
+            auto& foldContext = *foldTraining->FoldContext;
+            results->MetricsHistory[isTest][featureSetIdx].emplace_back(foldContext.MetricValuesOnTest);
+            results->AppendFeatureSetMetrics(isTest, featureSetIdx, foldContext.MetricValuesOnTest);
+            results->Models[isTest][featureSetIdx].emplace_back(foldContext.FullModel.GetRef());
+            if (isCalcFstr || isCalcRegularFstr) {
+                results->FeatureStrengths[isTest][featureSetIdx].emplace_back(std::move(foldTraining->FeatureStrengths));
+                if (isCalcRegularFstr) {
                     results->RegularFeatureStrengths[isTest][featureSetIdx].emplace_back(
-                        ExpandFeatureDescriptions(layout, regularEffect));
+                        std::move(foldTraining->RegularFeatureStrengths));
                 }
             }
 
-            (*foldsData)[foldIdx] = std::move(foldContext.TrainingData);
+            (*foldsData)[foldTraining->FoldIdx] = std::move(foldContext.TrainingData);
+            foldTraining->FoldContext.Destroy();
+        };
+
+        const ui32 jobCount = Min<ui32>(parallelTrainingCount, foldTrainings.size());
+        if (jobCount <= 1) {
+            for (auto& foldTraining : foldTrainings) {
+                trainFold(&foldTraining, dataSpecificOptions, callbacks, &NPar::LocalExecutor());
+                appendFoldResults(&foldTraining);
+            }
+            return;
+        }
+
+        // threads and memory limit are divided between simultaneous trainings
+        auto foldOptions = dataSpecificOptions;
+        foldOptions.SystemOptions->NumThreads = Max<ui32>(dataSpecificOptions.SystemOptions->NumThreads.Get() / jobCount, 1);
+        if (cpuUsedRamLimit != Max<ui64>()) {
+            foldOptions.SystemOptions->CpuUsedRamLimit = ToString(cpuUsedRamLimit / jobCount);
+        }
+        CATBOOST_NOTICE_LOG << "Training " << foldTrainings.size() << " model(s), " << jobCount << " at a time with "
+            << foldOptions.SystemOptions->NumThreads.Get() << " thread(s) each" << Endl;
+
+        NPar::TLocalExecutor trainingsExecutor;
+        trainingsExecutor.RunAdditionalThreads(jobCount - 1);
+        trainingsExecutor.ExecRangeWithThrow(
+            [&] (int foldTrainingIdx) {
+                TFeatureEvaluationCallbacks foldCallbacks(
+                    dataSpecificOptions.BoostingOptions->IterationCount,
+                    featureEvalOptions,
+                    results);
+                NPar::TLocalExecutor foldExecutor;
+                foldExecutor.RunAdditionalThreads(foldOptions.SystemOptions->NumThreads.Get() - 1);
+                trainFold(&foldTrainings[foldTrainingIdx], foldOptions, &foldCallbacks, &foldExecutor);
+            },
+            0,
+            SafeIntegerCast<int>(foldTrainings.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        for (auto& foldTraining : foldTrainings) {
+            appendFoldResults(&foldTraining);
         }
     };
 
@@ -14,12 +14,14 @@
 #include <catboost/private/libs/algo/tree_print.h>
 #include <catboost/libs/data/feature_names_converter.h>
 #include <catboost/libs/data/borders_io.h>
+#include <catboost/libs/data/load_and_quantize_data.h>
 #include <catboost/libs/data/load_data.h>
 #include <catboost/private/libs/distributed/master.h>
 #include <catboost/private/libs/distributed/worker.h>
 #include <catboost/libs/fstr/calc_fstr.h>
 #include <catboost/libs/fstr/output_fstr.h>
 #include <catboost/libs/helpers/int_cast.h>
+#include <catboost/libs/helpers/json_helpers.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
@@ -28,6 +30,7 @@
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/optimal_const_for_loss.h>
 #include <catboost/libs/model/ctr_data.h>
@@ -101,7 +104,8 @@ static TDataProviders LoadPools(
     bool forceUnitAutoPairWeights,
     TVector<NJson::TJsonValue>* classLabels,
     NPar::ILocalExecutor* const executor,
-    TProfileInfo* profile
+    TProfileInfo* profile,
+    const NCatboostOptions::TCatBoostOptions* learnQuantizationOptions = nullptr
 ) {
     const auto& cvParams = loadOptions.CvParams;
     const bool cvMode = cvParams.FoldCount != 0;
@@ -120,7 +124,8 @@ static TDataProviders LoadPools(
         forceUnitAutoPairWeights,
         classLabels,
         executor,
-        profile);
+        profile,
+        learnQuantizationOptions);
 
     if (cvMode) {
         if (cvParams.Shuffle && (pools.Learn->ObjectsData->GetOrder() != EObjectsOrder::RandomShuffled)) {
@@ -233,9 +238,14 @@ struct TLoggingData {
 };
 }
 
+static bool IsLastIteration(ui32 iter, const TMetricsData& metricsData, const TLearnContext& ctx) {
+    const ui32 iterWithOffset = iter + metricsData.MetricPeriodOffset.GetOrElse(0);
+    return (iterWithOffset + 1) == ctx.Params.BoostingOptions->IterationCount;
+}
+
 static bool ShouldCalcAllMetrics(ui32 iter, const TMetricsData& metricsData, const TLearnContext& ctx) {
     const ui32 iterWithOffset = iter + metricsData.MetricPeriodOffset.GetOrElse(0);
-    return ((iterWithOffset + 1) == ctx.Params.BoostingOptions->IterationCount) || // last iteration
+    return IsLastIteration(iter, metricsData, ctx) ||
         !(iterWithOffset % SafeIntegerCast<ui32>(ctx.OutputOptions.GetMetricPeriod()));
 }
 
@@ -358,9 +368,17 @@ static void CalcErrors(
 
     auto calcAllMetrics = ShouldCalcAllMetrics(iter, metricsData, *ctx);
     auto calcErrorTrackerMetric = ShouldCalcErrorTrackerMetric(iter, metricsData, *ctx);
+    // metrics of the final model are exact
+    auto useEvalSetSamples = !IsLastIteration(iter, metricsData, *ctx);
 
     if (ctx->Params.SystemOptions->IsMaster()) {
-        CalcErrorsDistributed(data, metricsData.Metrics, calcAllMetrics, calcErrorTrackerMetric, ctx);
+        CalcErrorsDistributed(
+            data,
+            metricsData.Metrics,
+            calcAllMetrics,
+            calcErrorTrackerMetric,
+            useEvalSetSamples,
+            ctx);
     } else {
         CalcErrorsLocally(
             data,
@@ -368,6 +386,7 @@ static void CalcErrors(
             calcAllMetrics,
             calcErrorTrackerMetric,
             /*calcNonAdditiveMetricsOnly*/ false,
+            useEvalSetSamples,
             ctx);
     }
 }
@@ -412,6 +431,10 @@ static void Train(
 
     THPTimer timer;
 
+    const double timeLimit = ctx->Params.BoostingOptions->TimeLimit.Get();
+    THPTimer trainingTimer;
+    ui32 timedIterationCount = 0;
+
     const auto onSaveSnapshotCallback = [&] (IOutputStream* out) {
         trainingCallbacks->OnSaveSnapshot(NJson::TJsonValue{}, out);
     };
@@ -426,6 +449,15 @@ static void Train(
             break;
         }
 
+        if (timeLimit > 0 && timedIterationCount > 0) {
+            const double passedTime = trainingTimer.Passed();
+            if (passedTime + passedTime / timedIterationCount > timeLimit) {
+                CATBOOST_NOTICE_LOG << "Training has stopped (the next iteration does not fit into time_limit="
+                    << timeLimit << " seconds), " << iter << " iterations are trained" << Endl;
+                break;
+            }
+        }
+
         profile.StartNextIteration();
 
         if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
@@ -477,7 +509,15 @@ static void Train(
             }
         }
 
+        profile.AddCounter("Memory usage (RSS), bytes", NMemInfo::GetMemInfo().RSS);
+        {
+            const auto cpuRamUsageBreakdown = ctx->GetCpuRamUsageBreakdown();
+            profile.AddCounter("Memory usage of folds, bytes", cpuRamUsageBreakdown.FoldsDataSize);
+            profile.AddCounter("Memory usage of online CTRs, bytes", cpuRamUsageBreakdown.OnlineCtrsDataSize);
+            profile.AddCounter("Memory usage of tree level stats, bytes", cpuRamUsageBreakdown.TreeLevelStatsSize);
+        }
         profile.FinishIteration();
+        ++timedIterationCount;
 
         const TProfileResults profileResults = profile.GetProfileResults();
         ctx->LearnProgress->MetricsAndTimeHistory.TimeHistory.emplace_back(profileResults);
@@ -501,6 +541,8 @@ static void Train(
     }
 
     ctx->SaveProgress(onSaveSnapshotCallback);
+    // the snapshot of the finished training must be on disk when training returns
+    ctx->WaitForSnapshotWriting();
 
     if (hasTest && testMultiApprox) {
         if (ctx->Params.SystemOptions->IsMaster()) {
@@ -687,6 +729,14 @@ static void SaveModel(
         modelPtr->SetScaleAndBias({1, ctx.LearnProgress->StartingApprox.GetOrElse({})});
         modelPtr->UpdateDynamicData();
 
+        if (ctx.OutputOptions.SaveSplitGainImportance()) {
+            NJson::TJsonValue splitGainImportance(NJson::EJsonValueType::JSON_ARRAY);
+            for (auto featureSplitGain : ctx.LearnProgress->SplitGainImportance) {
+                splitGainImportance.AppendValue(featureSplitGain);
+            }
+            modelPtr->ModelInfo["split_gain_importance"] = WriteTJsonValue(splitGainImportance);
+        }
+
         EFinalFeatureCalcersComputationMode featureCalcerComputationMode
             = ctx.OutputOptions.GetFinalFeatureCalcerComputationMode();
         if ((modelPtr->ModelTrees->GetTextFeatures().empty() &&
@@ -1067,6 +1117,7 @@ static void TrainModel(
     if (outputOptions.AllowWriteFiles()) {
         NCB::NPrivate::CreateTrainDirWithTmpDirIfNotExist(outputOptions.GetTrainDir(), &tmpDir);
     }
+    NCB::TProfileTraceSession profileTraceSession(outputOptions.CreateProfileTraceFullPath());
 
     CB_ENSURE_INTERNAL(
         haveLearnFeaturesInMemory || poolLoadOptions, "Learn dataset is not loaded, and load options are not provided");
@@ -1183,6 +1234,8 @@ void TrainModel(
     TSetLogging inThisScope(catBoostOptions.LoggingLevel);
 
     TProfileInfo profile;
+    // started before loading of datasets, the train dir is created by the time the trace is written
+    NCB::TProfileTraceSession profileTraceSession(outputOptions.CreateProfileTraceFullPath());
 
     CB_ENSURE(
         (catBoostOptions.GetTaskType() == ETaskType::CPU) || (loadOptions.TestSetPaths.size() <= 1),
@@ -1243,6 +1296,15 @@ void TrainModel(
             TDatasetSubset::MakeColumns(HaveFeaturesInMemory(catBoostOptions, testSetPath)));
     }
 
+    /* Learn dataset with only float features is quantized while reading, so that its raw features
+     * are never stored, unless they are needed after training
+     */
+    const bool quantizeLearnWhileReading = (catBoostOptions.GetTaskType() == ETaskType::CPU)
+        && haveLearnFeaturesInMemory
+        && (loadOptions.CvParams.FoldCount == 0)
+        && !(needFstr && isLossFunctionChangeFstr)
+        && CanReadAndQuantizeDataset(loadOptions.LearnSetPath, loadOptions.ColumnarPoolFormatParams);
+
     THolder<NPar::ILocalExecutor> localExecutorHolder = CreateLocalExecutor(catBoostOptions);
     TDataProviders pools = LoadPools(
         loadOptions,
@@ -1254,7 +1316,8 @@ void TrainModel(
         catBoostOptions.DataProcessingOptions->ForceUnitAutoPairWeights,
         &classLabels,
         localExecutorHolder.Get(),
-        &profile);
+        &profile,
+        quantizeLearnWhileReading ? &catBoostOptions : nullptr);
 
     const bool hasEmbeddingFeatures = pools.Learn->MetaInfo.FeaturesLayout->GetEmbeddingFeatureCount() > 0;
     if (hasEmbeddingFeatures) {
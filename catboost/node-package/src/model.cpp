@@ -3,6 +3,8 @@
 #include "api_helpers.h"
 #include "catboost/libs/model_interface/c_api.h"
 
+#include <algorithm>
+
 namespace {
 
 // Collect pointers to matrix rows into a vector.
@@ -16,6 +18,84 @@ TVector<V> CollectMatrixRowPointers(C& matrix, uint32_t rowLength) {
     return pointers;
 }
 
+// Calculates predictions outside of the event loop thread.
+// Input and output typed arrays are referenced, not copied, so they must not be modified by
+// JS code until the promise is settled.
+class TPredictionWorker: public Napi::AsyncWorker {
+public:
+    TPredictionWorker(Napi::Env env,
+                      Napi::Object model,
+                      ModelCalcerHandle* handle,
+                      Napi::Float32Array floatFeatures,
+                      uint32_t floatFeaturesSize,
+                      Napi::Int32Array catFeatures,
+                      uint32_t catFeaturesSize,
+                      uint32_t docsCount,
+                      Napi::Float64Array result)
+        : Napi::AsyncWorker(env)
+        , Deferred(Napi::Promise::Deferred::New(env))
+        , Handle(handle)
+        , DocsCount(docsCount)
+        , FloatFeaturesSize(floatFeaturesSize)
+        , CatFeaturesSize(catFeaturesSize)
+        , Result(result.Data())
+        , ResultSize(result.ElementLength())
+    {
+        Receiver().Set("model", model);
+        Receiver().Set("floatFeatures", floatFeatures);
+        Receiver().Set("result", result);
+        FloatPtrs.reserve(docsCount);
+        for (uint32_t i = 0; i < docsCount; ++i) {
+            FloatPtrs.push_back(floatFeatures.Data() + i * floatFeaturesSize);
+        }
+        if (catFeaturesSize != 0) {
+            Receiver().Set("catFeatures", catFeatures);
+            CatPtrs.reserve(docsCount);
+            for (uint32_t i = 0; i < docsCount; ++i) {
+                CatPtrs.push_back(catFeatures.Data() + i * catFeaturesSize);
+            }
+        }
+    }
+
+    Napi::Promise GetPromise() const {
+        return Deferred.Promise();
+    }
+
+    void Execute() override {
+        const bool status = CatFeaturesSize == 0 ?
+            CalcModelPredictionFlat(Handle, DocsCount,
+                                    FloatPtrs.data(), FloatFeaturesSize,
+                                    Result, ResultSize) :
+            CalcModelPredictionWithHashedCatFeatures(Handle, DocsCount,
+                                                     FloatPtrs.data(), FloatFeaturesSize,
+                                                     CatPtrs.data(), CatFeaturesSize,
+                                                     Result, ResultSize);
+        if (!status) {
+            const char* errorMessage = GetErrorString();
+            SetError(errorMessage != nullptr ? errorMessage : "Internal error - error message expected, but missing");
+        }
+    }
+
+    void OnOK() override {
+        Deferred.Resolve(Receiver().Get("result"));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        Deferred.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred Deferred;
+    ModelCalcerHandle* Handle;
+    const uint32_t DocsCount;
+    const uint32_t FloatFeaturesSize;
+    const uint32_t CatFeaturesSize;
+    double* Result;
+    const size_t ResultSize;
+    TVector<const float*> FloatPtrs;
+    TVector<const int*> CatPtrs;
+};
+
 }
 
 namespace NNodeCatBoost {
@@ -52,6 +132,7 @@ Napi::Function TModel::GetClass(Napi::Env env) {
     return DefineClass(env, "Model", {
         TModel::InstanceMethod("loadModel", &TModel::LoadFullFromFile),
         TModel::InstanceMethod("predict", &TModel::CalcPrediction),
+        TModel::InstanceMethod("predictAsync", &TModel::CalcPredictionAsync),
         TModel::InstanceMethod("enableGPUEvaluation", &TModel::EvaluateOnGPU),
         TModel::InstanceMethod("setPredictionType", &TModel::SetPredictionType),
         TModel::InstanceMethod("getFloatFeaturesCount", &TModel::GetModelFloatFeaturesCount),
@@ -197,6 +278,57 @@ Napi::Value TModel::GetPredictionDimensionsCount(const Napi::CallbackInfo& info)
 }
 
 
+Napi::Value TModel::CalcPredictionAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (!NHelper::Check(env, info.Length() >= 1, "Wrong number of arguments - expected at least 1") ||
+        !NHelper::Check(env, info[0].IsTypedArray() &&
+                        info[0].As<Napi::TypedArray>().TypedArrayType() == napi_float32_array,
+                        "Expected the first argument to be a Float32Array of float features") ||
+        !NHelper::Check(env, this->ModelLoaded, "Trying to predict from the empty model")) {
+        return env.Undefined();
+    }
+
+    const bool hasCatFeatures = info.Length() >= 2 && !info[1].IsUndefined() && !info[1].IsNull();
+    if (hasCatFeatures && !NHelper::Check(env, info[1].IsTypedArray() &&
+                        info[1].As<Napi::TypedArray>().TypedArrayType() == napi_int32_array,
+                        "Expected the second argument to be an Int32Array of hashed cat features")) {
+        return env.Undefined();
+    }
+
+    const Napi::Float32Array floatFeatures = info[0].As<Napi::Float32Array>();
+    const Napi::Int32Array catFeatures = hasCatFeatures ?
+        info[1].As<Napi::Int32Array>() : Napi::Int32Array::New(env, 0);
+
+    // Features are laid out row by row with the model feature counts.
+    const uint32_t floatFeaturesSize = GetFloatFeaturesCount(this->Handle);
+    const uint32_t catFeaturesSize = GetCatFeaturesCount(this->Handle);
+    if (!NHelper::Check(env, catFeaturesSize == 0 || hasCatFeatures,
+                        "Model has categorial features, hashed values are required")) {
+        return env.Undefined();
+    }
+    const uint32_t docsCount = floatFeaturesSize != 0 ?
+        floatFeatures.ElementLength() / floatFeaturesSize :
+        catFeatures.ElementLength() / std::max<uint32_t>(catFeaturesSize, 1);
+    if (!NHelper::Check(env, floatFeatures.ElementLength() == size_t(docsCount) * floatFeaturesSize,
+                        "Float features array size is not a multiple of model float features count") ||
+        !NHelper::Check(env, catFeatures.ElementLength() == size_t(docsCount) * catFeaturesSize,
+                        "Cat features array size does not match the number of docs")) {
+        return env.Undefined();
+    }
+
+    const auto predictionDimensions = ::GetPredictionDimensionsCount(this->Handle);
+    Napi::Float64Array result = Napi::Float64Array::New(env, docsCount * predictionDimensions);
+
+    TPredictionWorker* worker = new TPredictionWorker(env, info.This().As<Napi::Object>(), this->Handle,
+                                                      floatFeatures, floatFeaturesSize,
+                                                      catFeatures, hasCatFeatures ? catFeaturesSize : 0,
+                                                      docsCount, result);
+    const Napi::Promise promise = worker->GetPromise();
+    // The worker is deleted by node-addon-api after completion.
+    worker->Queue();
+    return promise;
+}
+
 Napi::Array TModel::CalcPredictionHash(Napi::Env env,
                                    const TVector<float>& floatFeatures,
                                    const Napi::Array& catFeatures) {
@@ -25,6 +25,10 @@ public:
     // Calculate prediction for matrices of numeric and categorial features.
     Napi::Value CalcPrediction(const Napi::CallbackInfo& info);
 
+    // Calculate prediction for row-major Float32Array of numeric and optional Int32Array of hashed
+    // categorial features on the libuv thread pool. Returns a Promise of Float64Array.
+    Napi::Value CalcPredictionAsync(const Napi::CallbackInfo& info);
+
     // Enable GPU evaluation on the specified deivce.
     void EvaluateOnGPU(const Napi::CallbackInfo& info);
 
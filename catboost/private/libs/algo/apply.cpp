@@ -15,6 +15,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/cast.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/system/rwlock.h>
 
 #include <cmath>
@@ -243,6 +244,95 @@ TVector<TVector<double>> ApplyModelMulti(
     return approxes;
 }
 
+void ApplyModelToFlatFloatFeatures(
+    const TFullModel& model,
+    TConstArrayRef<float> features,
+    size_t featureCount,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results)
+{
+    CB_ENSURE(
+        !model.GetNumCatFeatures() && !model.GetNumTextFeatures() && !model.GetNumEmbeddingFeatures(),
+        "Model with categorical, text or embedding features can't be applied to float features matrix"
+    );
+    CB_ENSURE(
+        featureCount >= model.ModelTrees->GetFlatFeatureVectorExpectedSize(),
+        "Features matrix has " << featureCount << " features, model expects at least "
+        << model.ModelTrees->GetFlatFeatureVectorExpectedSize()
+    );
+    CB_ENSURE(
+        (predictionType == EPredictionType::RawFormulaVal) || (predictionType == EPredictionType::Exponent),
+        "Prediction type " << predictionType << " is not supported for float features matrix"
+    );
+    CB_ENSURE(
+        featureCount ? (features.size() % featureCount == 0) : features.empty(),
+        "Features matrix size is not divisible by features count"
+    );
+    const int docCount = featureCount ? SafeIntegerCast<int>(features.size() / featureCount) : 0;
+    const size_t approxDimension = model.GetDimensionsCount();
+    CB_ENSURE(
+        results.size() == docCount * approxDimension,
+        "Results buffer should have size " << docCount * approxDimension << ", got " << results.size()
+    );
+    CB_ENSURE(
+        (predictionType == EPredictionType::RawFormulaVal) || (approxDimension == 1),
+        "Prediction type " << predictionType << " is supported only for one-dimensional models"
+    );
+    const TExternalLabelsHelper externalLabelsHelper(model);
+    if (externalLabelsHelper.IsInitialized() && (approxDimension > 1)) {
+        // model values are written as is, so they should not be remapped to external classes
+        CB_ENSURE(
+            externalLabelsHelper.GetExternalApproxDimension() == SafeIntegerCast<int>(approxDimension),
+            "Model is trained on a subset of classes, its predictions can't be written to float features matrix results"
+        );
+        for (auto dim : xrange(SafeIntegerCast<int>(approxDimension))) {
+            CB_ENSURE(
+                externalLabelsHelper.GetExternalIndex(dim) == dim,
+                "Model is trained on a subset of classes, its predictions can't be written to float features matrix results"
+            );
+        }
+    }
+    if (!docCount) {
+        return;
+    }
+    FixupTreeEnd(model.GetTreeCount(), begin, &end);
+
+    const auto blockParams = GetBlockParams(threadCount - 1, docCount, end - begin);
+    NPar::TLocalExecutor executor;
+    // ToDo: fix prediction on gpu for several threads
+    if (model.GetEvaluatorType() == EFormulaEvaluatorType::CPU) {
+        executor.RunAdditionalThreads(Min<int>(threadCount, blockParams.GetBlockCount()) - 1);
+    }
+    executor.ExecRangeWithThrow(
+        [&] (int blockId) {
+            const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+            const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+
+            TVector<TConstArrayRef<float>> blockFeatures;
+            blockFeatures.reserve(blockLastIdx - blockFirstIdx);
+            for (int docIdx = blockFirstIdx; docIdx < blockLastIdx; ++docIdx) {
+                blockFeatures.push_back(features.Slice(docIdx * featureCount, featureCount));
+            }
+            const auto blockResults = results.Slice(
+                blockFirstIdx * approxDimension,
+                (blockLastIdx - blockFirstIdx) * approxDimension
+            );
+            model.CalcFlat(blockFeatures, begin, end, blockResults);
+            if (predictionType == EPredictionType::Exponent) {
+                for (double& value : blockResults) {
+                    value = std::exp(value);
+                }
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        ILocalExecutor::WAIT_COMPLETE
+    );
+}
+
 TMinMax<double> ApplyModelForMinMax(
     const TFullModel& model,
     const NCB::TObjectsDataProvider& objectsData,
@@ -341,6 +431,39 @@ void TModelCalcerOnPool::ApplyModelMulti(
     flatApproxBuffer->clear();
 }
 
+void TModelCalcerOnPool::AddModelRawApprox(
+    int begin,
+    int end,
+    size_t approxDocOffset,
+    TVector<TVector<double>>* approx)
+{
+    const auto approxDimension = Model->GetDimensionsCount();
+    CB_ENSURE_INTERNAL(approx->size() == approxDimension, "approx has a wrong dimension");
+    if (BlockParams.FirstId == BlockParams.LastId) {
+        return;
+    }
+
+    FixupTreeEnd(Model->GetTreeCount(), begin, &end);
+
+    Executor->ExecRangeWithThrow(
+        [&, this](int blockId) {
+            const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
+            const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+            TVector<double> blockApprox;
+            blockApprox.yresize((blockLastId - blockFirstId) * approxDimension);
+            ModelEvaluator->Calc(QuantizedDataForThreads[blockId].Get(), begin, end, blockApprox);
+            for (auto dim : xrange(approxDimension)) {
+                double* dst = (*approx)[dim].data() + approxDocOffset + blockFirstId;
+                for (auto objectIdx : xrange(blockLastId - blockFirstId)) {
+                    dst[objectIdx] += blockApprox[objectIdx * approxDimension + dim];
+                }
+            }
+        },
+        0,
+        BlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 TModelCalcerOnPool::TModelCalcerOnPool(
     const TFullModel& model,
     TObjectsDataProviderPtr objectsData,
@@ -523,6 +646,72 @@ TVector<ui32> CalcLeafIndexesMulti(
     return CalcLeafIndexesMulti(model, objectsData, treeStart, treeEnd, &executor);
 }
 
+namespace {
+    /* Virtual ensemble i consists of trees [0, begin + (i + 1) * evalPeriod) with unshrunk leaf values.
+     * The ensembles are nested, so each quantized block is evaluated once on successive tree ranges, and
+     * predictions of the ensembles are accumulated from the partial sums of these ranges.
+     */
+    class TVirtualEnsemblesVisitor final : public IQuantizedBlockVisitor {
+    public:
+        TVirtualEnsemblesVisitor(
+            const TFullModel& model,
+            size_t begin,
+            size_t end,
+            size_t evalPeriod,
+            size_t virtualEnsemblesCount,
+            float actualShrinkCoef,
+            TVector<TVector<double>>* rawValues)
+            : ModelEvaluator(model.GetCurrentEvaluator())
+            , ApproxDimension(model.GetDimensionsCount())
+            , Begin(begin)
+            , End(end)
+            , EvalPeriod(evalPeriod)
+            , VirtualEnsemblesCount(virtualEnsemblesCount)
+            , ActualShrinkCoef(actualShrinkCoef)
+            , RawValues(*rawValues)
+        {}
+
+        void Do(
+            const NModelEvaluation::IQuantizedData& quantizedBlock,
+            ui32 objectBlockStart,
+            ui32 objectBlockEnd) override
+        {
+            const size_t objectCount = objectBlockEnd - objectBlockStart;
+            TVector<double> approxSum(objectCount * ApproxDimension);
+            TVector<double> rangeApprox(objectCount * ApproxDimension);
+            ModelEvaluator->Calc(&quantizedBlock, 0, Begin, approxSum);
+
+            size_t rangeBegin = Begin;
+            for (size_t vEnsembleIdx : xrange(VirtualEnsemblesCount)) {
+                const size_t rangeEnd = Min(rangeBegin + EvalPeriod, End);
+                ModelEvaluator->Calc(&quantizedBlock, rangeBegin, rangeEnd, rangeApprox);
+                const float unshrinkCoef = (vEnsembleIdx + 1 != VirtualEnsemblesCount)
+                    ? pow(1. - ActualShrinkCoef, float(rangeEnd) - float(End))
+                    : 1.0f;
+                for (size_t dim : xrange(ApproxDimension)) {
+                    double* dst = RawValues[vEnsembleIdx * ApproxDimension + dim].data() + objectBlockStart;
+                    for (size_t i : xrange(objectCount)) {
+                        double& sum = approxSum[i * ApproxDimension + dim];
+                        sum += rangeApprox[i * ApproxDimension + dim];
+                        dst[i] = sum * unshrinkCoef;
+                    }
+                }
+                rangeBegin = rangeEnd;
+            }
+        }
+
+    private:
+        NModelEvaluation::TConstModelEvaluatorPtr ModelEvaluator;
+        size_t ApproxDimension;
+        size_t Begin;
+        size_t End;
+        size_t EvalPeriod;
+        size_t VirtualEnsemblesCount;
+        float ActualShrinkCoef;
+        TVector<TVector<double>>& RawValues;
+    };
+}
+
 void ApplyVirtualEnsembles(
     const TFullModel& model,
     const NCB::TDataProvider& dataset,
@@ -532,70 +721,52 @@ void ApplyVirtualEnsembles(
     NPar::ILocalExecutor* executor
 ) {
     auto& rawValues = *rawValuesPtr;
-    TModelCalcerOnPool modelCalcerOnPool(model, dataset.ObjectsData, executor);
-    TVector<double> flatApprox;
-    TVector<TVector<double>> approx;
-    TVector<TVector<double>> baseApprox;
     const auto approxDimension = model.GetDimensionsCount();
     const size_t evalPeriod = end / (2 * virtualEnsemblesCount);
     CB_ENSURE(evalPeriod > 0 && evalPeriod * virtualEnsemblesCount < end,
               "Not enough trees in model for " << virtualEnsemblesCount << " virtual Ensembles");
-    size_t begin = end - evalPeriod * virtualEnsemblesCount;
-    modelCalcerOnPool.ApplyModelMulti(
-        EPredictionType::InternalRawFormulaVal,
-        0,
-        begin,
-        &flatApprox,
-        &baseApprox);
-    const auto objectCount = baseApprox[0].size();
-    Y_ASSERT(rawValues.empty());
-    // init first virtual ensemble predictions by prediction on trees [0; end / 2)
-    rawValues.insert(rawValues.end(), baseApprox.begin(), baseApprox.end());
-    rawValues.resize(virtualEnsemblesCount * approxDimension);
-    for (auto i : xrange(approxDimension, approxDimension * virtualEnsemblesCount)) {
-        rawValues[i].resize(objectCount);
-    }
+    const size_t begin = end - evalPeriod * virtualEnsemblesCount;
 
     const float actualShrinkCoef = model.GetActualShrinkCoef();
     CB_ENSURE(actualShrinkCoef >= 0.0f && actualShrinkCoef < 1.0f,
               "For Constant shrink mode: (model_shrink_rate * learning_rate) should be in [0, 1).");
 
-    auto copyerLambda = [approxDimension, objectCount] (
-            const auto copyToNextEnsemble,
-            const TVector<TVector<double>>& approx,
-            const float unshrinkCoef,
-            TVector<TVector<double>>& rawValues,
-            size_t vEnsembleIdx
-        ) {
-        const size_t shift = vEnsembleIdx * approxDimension;
-        for (size_t i = 0; i < approxDimension; ++i) {
-            const auto srcPtr = approx[i].data();
-            auto dstPtr = rawValues[shift + i].data();
-            auto nextDstPtr = rawValues[Min(shift + approxDimension + i, rawValues.size() - 1)].data(); // failsafe ptr !
-            for (size_t j = 0; j < objectCount; ++j) {
-                dstPtr[j] += srcPtr[j];
-                if constexpr (copyToNextEnsemble) {
-                    nextDstPtr[j] = dstPtr[j];
-                }
-                dstPtr[j] *= unshrinkCoef;
-            }
-        }
-    };
+    const auto& objectsData = *dataset.ObjectsData;
+    const int objectCount = SafeIntegerCast<int>(objectsData.GetObjectCount());
+    Y_ASSERT(rawValues.empty());
+    rawValues.resize(virtualEnsemblesCount * approxDimension);
+    for (auto& ensembleRawValues : rawValues) {
+        ensembleRawValues.yresize(objectCount);
+    }
+    if (objectCount == 0) {
+        return;
+    }
+    PrepareObjectsDataProviderForEvaluation(objectsData);
 
-    for (size_t vEnsembleIdx = 0; begin < end; begin += evalPeriod, vEnsembleIdx++) {
-        const auto lastTreeIdx = Min(begin + evalPeriod, end);
-        modelCalcerOnPool.ApplyModelMulti(
-            EPredictionType::InternalRawFormulaVal,
-            begin,
-            lastTreeIdx,
-            &flatApprox,
-            &approx);
-        const float unshrinkCoef = pow(1. - actualShrinkCoef, float(lastTreeIdx) - float(end));
-        if (vEnsembleIdx != virtualEnsemblesCount - 1) {
-            copyerLambda(std::true_type(), approx, unshrinkCoef, rawValues, vEnsembleIdx);
-        } else {
-            copyerLambda(std::false_type(), approx, 1.0f, rawValues, vEnsembleIdx);
-        }
+    const int executorThreadCount = executor ? executor->GetThreadCount() : 0;
+    auto blockParams = GetBlockParams(executorThreadCount, objectCount, SafeIntegerCast<int>(end));
+
+    TVirtualEnsemblesVisitor visitor(
+        model,
+        begin,
+        end,
+        evalPeriod,
+        virtualEnsemblesCount,
+        actualShrinkCoef,
+        &rawValues);
+
+    const ui32 subBlockSize = ui32(NModelEvaluation::FORMULA_EVALUATION_BLOCK_SIZE * 64);
+
+    const auto applyOnBlock = [&](int blockId) {
+        const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+
+        BlockedEvaluation(model, objectsData, (ui32)blockFirstIdx, (ui32)blockLastIdx, subBlockSize, &visitor);
+    };
+    if (executor) {
+        executor->ExecRangeWithThrow(applyOnBlock, 0, blockParams.GetBlockCount(), ILocalExecutor::WAIT_COMPLETE);
+    } else {
+        applyOnBlock(0);
     }
 }
 
@@ -48,6 +48,22 @@ TVector<TVector<double>> ApplyModelMulti(
     int end = 0,
     int threadCount = 1);
 
+/*
+ * Apply model to dense row-major matrix of float features (objectCount x featureCount) without
+ *  creation of data provider, so model should not have categorical, text and embedding features.
+ * Only RawFormulaVal and Exponent prediction types are supported, results are written to preallocated
+ *  results with indexation [objectIdx * model.GetDimensionsCount() + dim].
+ */
+void ApplyModelToFlatFloatFeatures(
+    const TFullModel& model,
+    TConstArrayRef<float> features,
+    size_t featureCount,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount,
+    TArrayRef<double> results);
+
 TMinMax<double> ApplyModelForMinMax(
     const TFullModel& model,
     const NCB::TObjectsDataProvider& objectsData,
@@ -73,6 +89,17 @@ public:
         TVector<double>* flatApproxBuffer,
         TVector<TVector<double>>* approx);
 
+    /* Adds raw formula values of trees [begin, end) to (*approx)[dim][approxDocOffset + objectIdx].
+     * Each block of objects is added right after its evaluation, so applying successive tree ranges
+     * to the same approx (like metrics calculation for every eval period does) doesn't need
+     * additional passes over all objects to transpose and add the results.
+     */
+    void AddModelRawApprox(
+        int begin,
+        int end,
+        size_t approxDocOffset,
+        TVector<TVector<double>>* approx);
+
 private:
     const TFullModel* Model;
     NCB::NModelEvaluation::TConstModelEvaluatorPtr ModelEvaluator;
@@ -5,6 +5,7 @@
 #include "approx_delta_calcer_multi.h"
 #include "fold.h"
 #include "index_calcer.h"
+#include "iteration_arena.h"
 #include "learn_context.h"
 #include "monotonic_constraint_utils.h"
 #include "scoring.h"
@@ -13,10 +14,12 @@
 
 #include <catboost/libs/data/data_provider.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/quantile.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/metrics/optimal_const_for_loss.h>
 #include <catboost/private/libs/algo/approx_calcer/approx_calcer_multi.h>
@@ -34,6 +37,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/ymath.h>
 
 template <bool StoreExpApprox, int VectorWidth>
@@ -124,6 +128,7 @@ static void CalcApproxDers(
     blockParams.SetBlockSize(AdjustBlockSize(sampleFinish - sampleStart, APPROX_BLOCK_SIZE));
     ctx->LocalExecutor->ExecRangeWithThrow(
         [&](int blockId) {
+            CB_PROFILE_TRACE_SCOPE("CalcApproxDers");
             const int blockOffset = sampleStart + blockId * blockParams.GetBlockSize();
             error.CalcDersRange(
                 blockOffset,
@@ -169,24 +174,31 @@ static void CalcLeafDers(
     bool recalcLeafWeights,
     ELeavesEstimation estimationMethod,
     NPar::ILocalExecutor* localExecutor,
+    TMemoryPool* iterationPool,
     TArrayRef<TSum> leafDers,
     TArrayRef<TDers> weightedDers) {
     NPar::ILocalExecutor::TExecRangeParams blockParams(0, sampleCount);
     blockParams.SetBlockCount(AdjustBlockCountLimit(sampleCount, CB_THREAD_LIMIT));
 
     const int leafCount = leafDers.size();
-    TVector<TVector<TDers>> blockBucketDers(
-        blockParams.GetBlockCount(),
-        TVector<TDers>(leafCount, TDers{/*Der1*/ 0.0, /*Der2*/ 0.0, /*Der3*/ 0.0}));
-    TVector<TDers>* blockBucketDersData = blockBucketDers.data();
+    // [blockId * leafCount + leafId]
+    TIterationArenaVector<TDers> blockBucketDers(
+        blockParams.GetBlockCount() * leafCount,
+        TDers{/*Der1*/ 0.0, /*Der2*/ 0.0, /*Der3*/ 0.0},
+        TPoolAlloc<TDers>(iterationPool));
+    TDers* blockBucketDersData = blockBucketDers.data();
     // TODO(espetrov): Do not calculate sumWeights for Newton.
     // TODO(espetrov): Calculate sumWeights only on first iteration for Gradient, because on next iteration it
     //  is the same.
     // Check speedup on flights dataset.
-    TVector<TVector<double>> blockBucketSumWeights(blockParams.GetBlockCount(), TVector<double>(leafCount, 0));
-    TVector<double>* blockBucketSumWeightsData = blockBucketSumWeights.data();
+    TIterationArenaVector<double> blockBucketSumWeights(
+        blockParams.GetBlockCount() * leafCount,
+        0.0,
+        TPoolAlloc<double>(iterationPool));
+    double* blockBucketSumWeightsData = blockBucketSumWeights.data();
     localExecutor->ExecRangeWithThrow(
         [=, &error](int blockId) {
+            CB_PROFILE_TRACE_SCOPE("CalcLeafDers");
             constexpr int innerBlockSize = APPROX_BLOCK_SIZE;
             const auto approxDers = MakeArrayRef(
                 weightedDers.data() + innerBlockSize * blockId,
@@ -195,8 +207,8 @@ static void CalcLeafDers(
             const int blockStart = blockId * blockParams.GetBlockSize();
             const int nextBlockStart = Min(sampleCount, blockStart + blockParams.GetBlockSize());
 
-            const auto bucketDers = MakeArrayRef(blockBucketDersData[blockId].data(), leafCount);
-            const auto bucketSumWeights = MakeArrayRef(blockBucketSumWeightsData[blockId].data(), leafCount);
+            const auto bucketDers = MakeArrayRef(blockBucketDersData + blockId * leafCount, leafCount);
+            const auto bucketSumWeights = MakeArrayRef(blockBucketSumWeightsData + blockId * leafCount, leafCount);
 
             for (int innerBlockStart = blockStart;
                  innerBlockStart < nextBlockStart;
@@ -239,10 +251,10 @@ static void CalcLeafDers(
     if (estimationMethod == ELeavesEstimation::Newton) {
         for (int leafId = 0; leafId < leafCount; ++leafId) {
             for (int blockId = 0; blockId < blockParams.GetBlockCount(); ++blockId) {
-                if (blockBucketSumWeights[blockId][leafId] > FLT_EPSILON) {
+                if (blockBucketSumWeights[blockId * leafCount + leafId] > FLT_EPSILON) {
                     AddMethodDer<ELeavesEstimation::Newton>(
-                        blockBucketDers[blockId][leafId],
-                        blockBucketSumWeights[blockId][leafId],
+                        blockBucketDers[blockId * leafCount + leafId],
+                        blockBucketSumWeights[blockId * leafCount + leafId],
                         /* updateWeight */ false, // value doesn't matter
                         &leafDers[leafId]);
                 }
@@ -252,10 +264,10 @@ static void CalcLeafDers(
         Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
         for (int leafId = 0; leafId < leafCount; ++leafId) {
             for (int blockId = 0; blockId < blockParams.GetBlockCount(); ++blockId) {
-                if (blockBucketSumWeights[blockId][leafId] > FLT_EPSILON) {
+                if (blockBucketSumWeights[blockId * leafCount + leafId] > FLT_EPSILON) {
                     AddMethodDer<ELeavesEstimation::Gradient>(
-                        blockBucketDers[blockId][leafId],
-                        blockBucketSumWeights[blockId][leafId],
+                        blockBucketDers[blockId * leafCount + leafId],
+                        blockBucketSumWeights[blockId * leafCount + leafId],
                         recalcLeafWeights,
                         &leafDers[leafId]);
                 }
@@ -275,22 +287,28 @@ static void CalcLeafCoxDers(
     bool recalcLeafWeights,
     ELeavesEstimation estimationMethod,
     NPar::ILocalExecutor* localExecutor,
+    TMemoryPool* iterationPool,
     TArrayRef<TSum> leafDers,
     TArrayRef<TDers> weightedDers) {
     NPar::ILocalExecutor::TExecRangeParams blockParams(0, sampleCount);
     blockParams.SetBlockCount(AdjustBlockCountLimit(sampleCount, CB_THREAD_LIMIT));
 
     const int leafCount = leafDers.size();
-    TVector<TVector<TDers>> blockBucketDers(
-        blockParams.GetBlockCount(),
-        TVector<TDers>(leafCount, TDers{/*Der1*/ 0.0, /*Der2*/ 0.0, /*Der3*/ 0.0}));
-    TVector<TDers>* blockBucketDersData = blockBucketDers.data();
+    // [blockId * leafCount + leafId]
+    TIterationArenaVector<TDers> blockBucketDers(
+        blockParams.GetBlockCount() * leafCount,
+        TDers{/*Der1*/ 0.0, /*Der2*/ 0.0, /*Der3*/ 0.0},
+        TPoolAlloc<TDers>(iterationPool));
+    TDers* blockBucketDersData = blockBucketDers.data();
     // TODO(espetrov): Do not calculate sumWeights for Newton.
     // TODO(espetrov): Calculate sumWeights only on first iteration for Gradient, because on next iteration it
     //  is the same.
     // Check speedup on flights dataset.
-    TVector<TVector<double>> blockBucketSumWeights(blockParams.GetBlockCount(), TVector<double>(leafCount, 0));
-    TVector<double>* blockBucketSumWeightsData = blockBucketSumWeights.data();
+    TIterationArenaVector<double> blockBucketSumWeights(
+        blockParams.GetBlockCount() * leafCount,
+        0.0,
+        TPoolAlloc<double>(iterationPool));
+    double* blockBucketSumWeightsData = blockBucketSumWeights.data();
     error.CalcDersRange(
         0,
         targets.size(),
@@ -310,8 +328,8 @@ static void CalcLeafCoxDers(
             const int blockStart = blockId * blockParams.GetBlockSize();
             const int nextBlockStart = Min(sampleCount, blockStart + blockParams.GetBlockSize());
 
-            const auto bucketDers = MakeArrayRef(blockBucketDersData[blockId].data(), leafCount);
-            const auto bucketSumWeights = MakeArrayRef(blockBucketSumWeightsData[blockId].data(), leafCount);
+            const auto bucketDers = MakeArrayRef(blockBucketDersData + blockId * leafCount, leafCount);
+            const auto bucketSumWeights = MakeArrayRef(blockBucketSumWeightsData + blockId * leafCount, leafCount);
 
             for (int innerBlockStart = blockStart;
                  innerBlockStart < nextBlockStart;
@@ -344,10 +362,10 @@ static void CalcLeafCoxDers(
     if (estimationMethod == ELeavesEstimation::Newton) {
         for (int leafId = 0; leafId < leafCount; ++leafId) {
             for (int blockId = 0; blockId < blockParams.GetBlockCount(); ++blockId) {
-                if (blockBucketSumWeights[blockId][leafId] > FLT_EPSILON) {
+                if (blockBucketSumWeights[blockId * leafCount + leafId] > FLT_EPSILON) {
                     AddMethodDer<ELeavesEstimation::Newton>(
-                        blockBucketDers[blockId][leafId],
-                        blockBucketSumWeights[blockId][leafId],
+                        blockBucketDers[blockId * leafCount + leafId],
+                        blockBucketSumWeights[blockId * leafCount + leafId],
                         /* updateWeight */ false, // value doesn't matter
                         &leafDers[leafId]);
                 }
@@ -357,10 +375,10 @@ static void CalcLeafCoxDers(
         Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
         for (int leafId = 0; leafId < leafCount; ++leafId) {
             for (int blockId = 0; blockId < blockParams.GetBlockCount(); ++blockId) {
-                if (blockBucketSumWeights[blockId][leafId] > FLT_EPSILON) {
+                if (blockBucketSumWeights[blockId * leafCount + leafId] > FLT_EPSILON) {
                     AddMethodDer<ELeavesEstimation::Gradient>(
-                        blockBucketDers[blockId][leafId],
-                        blockBucketSumWeights[blockId][leafId],
+                        blockBucketDers[blockId * leafCount + leafId],
+                        blockBucketSumWeights[blockId * leafCount + leafId],
                         recalcLeafWeights,
                         &leafDers[leafId]);
                 }
@@ -383,6 +401,7 @@ void CalcLeafDersSimple(
     const NCatboostOptions::TCatBoostOptions& params,
     ui64 randomSeed,
     NPar::ILocalExecutor* localExecutor,
+    TMemoryPool* iterationPool,
     TVector<TSum>* leafDers,
     TArray2D<double>* pairwiseBuckets,
     TVector<TDers>* scratchDers) {
@@ -402,6 +421,7 @@ void CalcLeafDersSimple(
                 recalcLeafWeights,
                 estimationMethod,
                 localExecutor,
+                iterationPool,
                 *leafDers,
                 *scratchDers);
         } else {
@@ -416,6 +436,7 @@ void CalcLeafDersSimple(
                 recalcLeafWeights,
                 estimationMethod,
                 localExecutor,
+                iterationPool,
                 *leafDers,
                 *scratchDers);
         }
@@ -680,21 +701,63 @@ static void CalcExactLeafDeltas(
     TConstArrayRef<double> approxes,
     TConstArrayRef<float> targets,
     TConstArrayRef<float> weights,
+    NPar::ILocalExecutor* localExecutor,
     TVector<double>* leafDeltas) {
-    TVector<TVector<float>> leafSamples(leafCount);
-    TVector<TVector<float>> leafWeights(leafCount);
+    struct TLeafSample {
+        TIndexType LeafIdx;
+        float Sample;
+        float Weight;
+    };
 
-    for (size_t i = 0; i < sampleCount; i++) {
-        Y_ASSERT(indices[i] < leafSamples.size());
-        leafSamples[indices[i]].emplace_back(targets[i] - approxes[i]);
-        leafWeights[indices[i]].emplace_back(weights[i]);
+    TVector<TLeafSample> leafSamples;
+    leafSamples.yresize(sampleCount);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<int>(sampleCount),
+        [&](int i) {
+            Y_ASSERT(indices[i] < leafCount);
+            leafSamples[i] = TLeafSample{indices[i], float(targets[i] - approxes[i]), weights[i]};
+        });
+    NCB::ParallelRadixSort(
+        MakeArrayRef(leafSamples),
+        [](const TLeafSample& leafSample) { return leafSample.LeafIdx; },
+        localExecutor);
+
+    TVector<ui32> leafOffsets(leafCount + 1, 0);
+    for (size_t i = 0; i < sampleCount; ++i) {
+        ++leafOffsets[indices[i] + 1];
+    }
+    for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+        leafOffsets[leaf + 1] += leafOffsets[leaf];
     }
 
+    TVector<float> samples;
+    samples.yresize(sampleCount);
+    TVector<float> sampleWeights;
+    sampleWeights.yresize(sampleCount);
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<int>(sampleCount),
+        [&](int i) {
+            samples[i] = leafSamples[i].Sample;
+            sampleWeights[i] = leafSamples[i].Weight;
+        });
+
     Y_ASSERT(leafCount == leafDeltas->size());
-    for (size_t i = 0; i < leafCount; i++) {
-        double& leafDelta = (*leafDeltas)[i];
-        leafDelta = *NCB::CalcOneDimensionalOptimumConstApprox(lossDescription, leafSamples[i], leafWeights[i]);
-    }
+    NPar::ParallelFor(
+        *localExecutor,
+        0,
+        SafeIntegerCast<int>(leafCount),
+        [&](int leaf) {
+            const size_t leafBegin = leafOffsets[leaf];
+            const size_t leafSize = leafOffsets[leaf + 1] - leafBegin;
+            (*leafDeltas)[leaf] = *NCB::CalcOneDimensionalOptimumConstApprox(
+                lossDescription,
+                MakeConstArrayRef(samples).Slice(leafBegin, leafSize),
+                MakeConstArrayRef(sampleWeights).Slice(leafBegin, leafSize));
+        });
 }
 
 static void CalcApproxDeltaSimple(
@@ -738,6 +801,7 @@ static void CalcApproxDeltaSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]);
             return;
         }
@@ -756,6 +820,7 @@ static void CalcApproxDeltaSimple(
             ctx->Params,
             randomSeed,
             ctx->LocalExecutor,
+            ctx->IterationArena.GetThreadPool(),
             &leafDers,
             &pairwiseBuckets,
             &weightedDers);
@@ -941,6 +1006,7 @@ static void CalcLeafValuesSimple(
                 bt.Approx[0],
                 fold.LearnTarget[0],
                 MakeConstArrayRef(fold.SampleWeights),
+                ctx->LocalExecutor,
                 &(*leafDeltas)[0]);
             return;
         }
@@ -959,6 +1025,7 @@ static void CalcLeafValuesSimple(
             ctx->Params,
             ctx->LearnProgress->Rand.GenRand(),
             &localExecutor,
+            ctx->IterationArena.GetThreadPool(),
             &leafDers,
             &pairwiseBuckets,
             &weightedDers);
@@ -1126,6 +1193,7 @@ void CalcApproxForLeafStruct(
     const bool isMultiTarget = dynamic_cast<const TMultiDerCalcer*>(&error) != nullptr;
     ctx->LocalExecutor->ExecRangeWithThrow(
         [&](int bodyTailId) {
+            CB_PROFILE_TRACE_SCOPE("CalcApproxForLeafStruct body tail");
             const TFold::TBodyTail& bt = fold.BodyTailArr[bodyTailId];
             TVector<TVector<double>>& approxDeltas = (*approxesDelta)[bodyTailId];
             const double initValue = GetNeutralApprox(error.GetIsExpApprox());
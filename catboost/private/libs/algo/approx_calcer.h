@@ -6,6 +6,8 @@
 #include <catboost/private/libs/options/enum_helpers.h>
 #include <catboost/private/libs/options/restrictions.h>
 
+#include <util/memory/pool.h>
+
 
 class IDerCalcer;
 class TLearnContext;
@@ -44,6 +46,7 @@ void CalcLeafDersSimple(
     const NCatboostOptions::TCatBoostOptions& params,
     ui64 randomSeed,
     NPar::ILocalExecutor* localExecutor,
+    TMemoryPool* iterationPool, // temporaries are allocated from it
     TVector<TSum>* leafDers,
     TArray2D<double>* pairwiseBuckets,
     TVector<TDers>* scratchDers
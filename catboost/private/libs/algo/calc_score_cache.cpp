@@ -722,11 +722,11 @@ void TCalcScoreFold::Sample(
 ) {
     int objectCount = SafeIntegerCast<int>(indices.size());
     if (performRandomChoice) {
-        SetSampledControl(objectCount, samplingUnit, fold.LearnQueriesInfo, rand);
+        SetSampledControl(objectCount, samplingUnit, fold.LearnQueriesInfo, rand, localExecutor);
     } else {
         BernoulliSampleRate = 0.0f;
         Y_ASSERT(samplingUnit == ESamplingUnit::Object);
-        SetControlNoZeroWeighted(objectCount, fold.SampleWeights.data());
+        SetControlNoZeroWeighted(objectCount, fold.SampleWeights.data(), localExecutor);
     }
 
     TVectorSlicing srcBlocks;
@@ -1155,34 +1155,59 @@ void TCalcScoreFold::SetSampledControl(
     int docCount,
     ESamplingUnit samplingUnit,
     const TVector<TQueryInfo>& queriesInfo,
-    TRestorableFastRng64* rand
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor
 ) {
     if (BernoulliSampleRate == 1.0f || IsPairwiseScoring) {
         Fill(Control.begin(), Control.end(), true);
         return;
     }
+    // blocks generate the same values as rand for all objects sequentially, so sampling is reproducible
+    constexpr int SamplingBlockSize = 10000;
     if (samplingUnit == ESamplingUnit::Group) {
-        for (auto& queryInfo : queriesInfo) {
-            auto itBegin = GetDataPtr(Control, queryInfo.Begin);
-            auto itEnd = GetDataPtr(Control, queryInfo.End);
-            auto isTaken = rand->GenRandReal1() < BernoulliSampleRate;
-            Fill(itBegin, itEnd, isTaken);
-        }
+        ParallelGenRandByBlocks(
+            queriesInfo.ysize(),
+            SamplingBlockSize,
+            localExecutor,
+            rand,
+            [&] (int queryBegin, int queryEnd, TRestorableFastRng64* blockRand) {
+                for (int queryIdx = queryBegin; queryIdx < queryEnd; ++queryIdx) {
+                    auto itBegin = GetDataPtr(Control, queriesInfo[queryIdx].Begin);
+                    auto itEnd = GetDataPtr(Control, queriesInfo[queryIdx].End);
+                    auto isTaken = blockRand->GenRandReal1() < BernoulliSampleRate;
+                    Fill(itBegin, itEnd, isTaken);
+                }
+            });
     } else {
-        for (int docIdx = 0; docIdx < docCount; ++docIdx) {
-            Control[docIdx] = rand->GenRandReal1() < BernoulliSampleRate;
-        }
+        ParallelGenRandByBlocks(
+            docCount,
+            SamplingBlockSize,
+            localExecutor,
+            rand,
+            [&] (int docBegin, int docEnd, TRestorableFastRng64* blockRand) {
+                for (int docIdx = docBegin; docIdx < docEnd; ++docIdx) {
+                    Control[docIdx] = blockRand->GenRandReal1() < BernoulliSampleRate;
+                }
+            });
     }
 }
 
 void TCalcScoreFold::SetControlNoZeroWeighted(
     int docCount,
-    const float* sampleWeights
+    const float* sampleWeights,
+    NPar::ILocalExecutor* localExecutor
 ) {
     constexpr float EPS = std::numeric_limits<float>::epsilon();
-    for (int docIdx = 0; docIdx < docCount; ++docIdx) {
-        Control[docIdx] = sampleWeights[docIdx] > EPS;
-    }
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, docCount);
+    blockParams.SetBlockSize(10000);
+    bool* controlData = GetDataPtr(Control);
+    localExecutor->ExecRange(
+        [=](int docIdx) {
+            controlData[docIdx] = sampleWeights[docIdx] > EPS;
+        },
+        blockParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
 }
 
 void TCalcScoreFold::CreateBlocksAndUpdateQueriesInfoByControl(
@@ -89,6 +89,20 @@ public:
         SumWeight -= other.SumWeight;
         Count -= other.Count;
     }
+
+    inline void AddWeighted(double weightedDelta, float weight) {
+        SumWeightedDelta += weightedDelta;
+        SumWeight += weight;
+    }
+
+    inline void AddDeltaCount(double delta, float count) {
+        SumDelta += delta;
+        Count += count;
+    }
+
+    inline const TBucketStats& ToBucketStats() const {
+        return *this;
+    }
 };
 
 static_assert(
@@ -96,6 +110,73 @@ static_assert(
     "TBucketStats must be pod to avoid memory initialization in yresize"
 );
 
+/* Compact alternative of TBucketStats (see dev_compact_bucket_stats option), 24 bytes instead of 32.
+ * Sums are stored in float, sums of derivatives are accumulated with Kahan compensation,
+ * sums of weights are not compensated as weights are non-negative.
+ */
+struct TCompactBucketStats {
+    float SumWeightedDelta;
+    float SumWeightedDeltaCompensation;
+    float SumWeight;
+    float SumDelta;
+    float SumDeltaCompensation;
+    float Count;
+
+public:
+    inline void Add(const TCompactBucketStats& other) {
+        KahanAdd(
+            other.SumWeightedDelta - other.SumWeightedDeltaCompensation,
+            &SumWeightedDelta,
+            &SumWeightedDeltaCompensation);
+        KahanAdd(other.SumDelta - other.SumDeltaCompensation, &SumDelta, &SumDeltaCompensation);
+        SumWeight += other.SumWeight;
+        Count += other.Count;
+    }
+
+    inline void Remove(const TCompactBucketStats& other) {
+        KahanAdd(
+            other.SumWeightedDeltaCompensation - other.SumWeightedDelta,
+            &SumWeightedDelta,
+            &SumWeightedDeltaCompensation);
+        KahanAdd(other.SumDeltaCompensation - other.SumDelta, &SumDelta, &SumDeltaCompensation);
+        SumWeight -= other.SumWeight;
+        Count -= other.Count;
+    }
+
+    inline void AddWeighted(double weightedDelta, float weight) {
+        KahanAdd(float(weightedDelta), &SumWeightedDelta, &SumWeightedDeltaCompensation);
+        SumWeight += weight;
+    }
+
+    inline void AddDeltaCount(double delta, float count) {
+        KahanAdd(float(delta), &SumDelta, &SumDeltaCompensation);
+        Count += count;
+    }
+
+    inline TBucketStats ToBucketStats() const {
+        return {
+            double(SumWeightedDelta) - SumWeightedDeltaCompensation,
+            SumWeight,
+            double(SumDelta) - SumDeltaCompensation,
+            Count
+        };
+    }
+
+private:
+    // compensation keeps low order bits lost by sum, with the opposite sign
+    static inline void KahanAdd(float value, float* sum, float* compensation) {
+        const float compensatedValue = value - *compensation;
+        const float newSum = *sum + compensatedValue;
+        *compensation = (newSum - *sum) - compensatedValue;
+        *sum = newSum;
+    }
+};
+
+static_assert(
+    std::is_pod<TCompactBucketStats>::value,
+    "TCompactBucketStats must be pod to avoid memory initialization in yresize"
+);
+
 inline static int CountNonCtrBuckets(
     const NCB::TFeaturesLayout& featuresLayout,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -137,7 +218,26 @@ public:
         int statsCount,
         bool* areStatsDirty
     );
+    // Stats of a compact type are placed into the storage allocated for TBucketStats
+    template <class TStats>
+    TArrayRef<TStats> GetStatsAs(const TSplitEnsemble& splitEnsemble, int statsCount, bool* areStatsDirty) {
+        static_assert(sizeof(TStats) <= sizeof(TBucketStats) && alignof(TStats) <= alignof(TBucketStats));
+        const int bucketStatsCount = (statsCount * sizeof(TStats) + sizeof(TBucketStats) - 1) / sizeof(TBucketStats);
+        auto& stats = GetStats(splitEnsemble, bucketStatsCount, areStatsDirty);
+        return TArrayRef<TStats>(
+            reinterpret_cast<TStats*>(stats.data()),
+            (size_t)MaxBodyTailCount * ApproxDimension * statsCount);
+    }
     void GarbageCollect();
+    void Clear() {
+        Stats.clear();
+        if (MemoryPool) {
+            MemoryPool->Clear();
+        }
+    }
+    size_t GetMemoryUsage() const {
+        return MemoryPool ? MemoryPool->MemoryAllocated() + MemoryPool->MemoryWaste() : 0;
+    }
     static TVector<TBucketStats> GetStatsInUse(
         int segmentCount,
         int segmentSize,
@@ -306,9 +406,10 @@ private:
         int docCount,
         ESamplingUnit samplingUnit,
         const TVector<TQueryInfo>& queriesInfo,
-        TRestorableFastRng64* rand
+        TRestorableFastRng64* rand,
+        NPar::ILocalExecutor* localExecutor
     );
-    void SetControlNoZeroWeighted(int docCount, const float* sampleWeights);
+    void SetControlNoZeroWeighted(int docCount, const float* sampleWeights, NPar::ILocalExecutor* localExecutor);
 
     void CreateBlocksAndUpdateQueriesInfoByControl(
         NPar::ILocalExecutor* localExecutor,
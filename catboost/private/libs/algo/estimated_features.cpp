@@ -12,6 +12,7 @@
 #include <util/generic/cast.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
+#include <util/system/rwlock.h>
 #include <util/system/types.h>
 
 
@@ -201,8 +202,11 @@ static void Quantize(
 }
 
 
+/* Writers of different estimators can be called concurrently, so shared quantizedFeaturesInfo is accessed
+ * under its mutex. Each feature is written by one estimator only.
+ */
 static TCalculatedFeatureVisitor CreateSingleFeatureWriter(
-    ui32* featureCount,
+    ui32 featureOffset,
     const TArraySubsetIndexing<ui32>* fullSubsetIndexing,
     TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
     const TFeaturesArraySubsetIndexing* calcBordersSubset,
@@ -211,9 +215,14 @@ static TCalculatedFeatureVisitor CreateSingleFeatureWriter(
 ) {
     return TCalculatedFeatureVisitor(
         [=](ui32 localFeatureIdx, TConstArrayRef<float> values) {
-            const ui32 featureIdx = *featureCount + localFeatureIdx;
+            const ui32 featureIdx = featureOffset + localFeatureIdx;
 
-            if (!quantizedFeaturesInfo->HasBorders(TFloatFeatureIdx(featureIdx))) {
+            bool hasBorders;
+            {
+                TReadGuard readGuard(quantizedFeaturesInfo->GetRWMutex());
+                hasBorders = quantizedFeaturesInfo->HasBorders(TFloatFeatureIdx(featureIdx));
+            }
+            if (!hasBorders) {
                 TVector<float> valuesForQuantization = GetSubset<float>(
                     values,
                     *calcBordersSubset,
@@ -231,16 +240,24 @@ static TCalculatedFeatureVisitor CreateSingleFeatureWriter(
                     /*initialBorders*/ Nothing()
                 );
 
+                TWriteGuard writeGuard(quantizedFeaturesInfo->GetRWMutex());
                 quantizedFeaturesInfo->SetBorders(
                     TFloatFeatureIdx(featureIdx),
                     std::move(quantization.Borders)
                 );
             }
 
+            // borders of a feature are not changed after they are set
+            TConstArrayRef<float> borders;
+            {
+                TReadGuard readGuard(quantizedFeaturesInfo->GetRWMutex());
+                borders = quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(featureIdx));
+            }
+
             Quantize(
                 featureIdx,
                 values,
-                quantizedFeaturesInfo->GetBorders(TFloatFeatureIdx(featureIdx)),
+                borders,
                 fullSubsetIndexing,
                 localExecutor,
                 &((*featuresData)[featureIdx])
@@ -391,11 +408,12 @@ TEstimatedForCPUObjectsDataProviders NCB::CreateEstimatedFeaturesData(
     size_t currentPackedFeatureCount = 0;
 
     auto createSingleFeatureWriter = [&] (
+        ui32 featureOffset,
         const TFeaturesArraySubsetIndexing* fullSubsetIndexing,
         TQuantizedObjectsData* data
     ) {
         return CreateSingleFeatureWriter(
-            &currentFeatureCount,
+            featureOffset,
             fullSubsetIndexing,
             quantizedFeaturesInfo,
             &learnCalcBordersSubset,
@@ -413,7 +431,6 @@ TEstimatedForCPUObjectsDataProviders NCB::CreateEstimatedFeaturesData(
         );
     };
 
-    TCalculatedFeatureVisitors singleVisitors;
     TCalculatedFeatureVisitors packedVisitors;
 
     TAtomicSharedPtr<TFeaturesArraySubsetIndexing> learnFullSubset
@@ -421,9 +438,6 @@ TEstimatedForCPUObjectsDataProviders NCB::CreateEstimatedFeaturesData(
             TFullSubset<ui32>(trainingDataProviders.Learn->GetObjectCount())
         );
     learnData.FloatFeatures.resize(featureCount);
-    singleVisitors.LearnVisitor.ConstructInPlace(
-        createSingleFeatureWriter(learnFullSubset.Get(), &learnData)
-    );
     packedVisitors.LearnVisitor.ConstructInPlace(createPackedFeatureWriter(&learnPackedFeaturesData));
 
     TVector<TAtomicSharedPtr<TFeaturesArraySubsetIndexing>> testFullSubsets;
@@ -435,43 +449,67 @@ TEstimatedForCPUObjectsDataProviders NCB::CreateEstimatedFeaturesData(
             )
         );
         testData[testIdx].FloatFeatures.resize(featureCount);
-        singleVisitors.TestVisitors.push_back(
-            createSingleFeatureWriter(
-                testFullSubsets.back().Get(),
-                &testData[testIdx]
-            )
-        );
         packedVisitors.TestVisitors.push_back(createPackedFeatureWriter(&testPackedFeaturesData[testIdx]));
     }
 
 
-    for (size_t id : xrange(estimatedFeaturesMeta.size())) {
-        auto computeFeatures = [&] (TCalculatedFeatureVisitors visitors) {
-            if (isOnline) {
-                onlineFeatureEstimatorsSubset[id]->ComputeOnlineFeatures(
-                    *learnPermutation,
-                    std::move(*visitors.LearnVisitor),
-                    visitors.TestVisitors,
-                    localExecutor
-                );
-            } else {
-                featureEstimatorsSubset[id]->ComputeFeatures(
-                    std::move(*visitors.LearnVisitor),
-                    visitors.TestVisitors,
-                    localExecutor
-                );
-            }
-        };
+    auto computeFeatures = [&] (size_t id, TCalculatedFeatureVisitors visitors) {
+        if (isOnline) {
+            onlineFeatureEstimatorsSubset[id]->ComputeOnlineFeatures(
+                *learnPermutation,
+                std::move(*visitors.LearnVisitor),
+                visitors.TestVisitors,
+                localExecutor
+            );
+        } else {
+            featureEstimatorsSubset[id]->ComputeFeatures(
+                std::move(*visitors.LearnVisitor),
+                visitors.TestVisitors,
+                localExecutor
+            );
+        }
+    };
 
+    /* Packed binary features are appended to shared packs in estimators order, so these estimators are
+     * computed sequentially. Other estimators write their own columns and are computed in parallel.
+     */
+    TVector<size_t> singleFeaturesEstimators;
+    TVector<ui32> singleFeaturesOffsets;
+    for (size_t id : xrange(estimatedFeaturesMeta.size())) {
         if (IsPackedBinaryFeatures(estimatedFeaturesMeta[id])) {
-            computeFeatures(packedVisitors);
+            computeFeatures(id, packedVisitors);
             currentPackedFeatureCount += estimatedFeaturesMeta[id].FeaturesCount;
         } else {
-            computeFeatures(singleVisitors);
+            singleFeaturesEstimators.push_back(id);
+            singleFeaturesOffsets.push_back(currentFeatureCount);
         }
         currentFeatureCount += estimatedFeaturesMeta[id].FeaturesCount;
     }
 
+    localExecutor->ExecRangeWithThrow(
+        [&] (int idx) {
+            const ui32 featureOffset = singleFeaturesOffsets[idx];
+
+            TCalculatedFeatureVisitors singleVisitors;
+            singleVisitors.LearnVisitor.ConstructInPlace(
+                createSingleFeatureWriter(featureOffset, learnFullSubset.Get(), &learnData)
+            );
+            for (auto testIdx : xrange(testCount)) {
+                singleVisitors.TestVisitors.push_back(
+                    createSingleFeatureWriter(
+                        featureOffset,
+                        testFullSubsets[testIdx].Get(),
+                        &testData[testIdx]
+                    )
+                );
+            }
+            computeFeatures(singleFeaturesEstimators[idx], std::move(singleVisitors));
+        },
+        0,
+        SafeIntegerCast<int>(singleFeaturesEstimators.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
     auto createObjectsDataProvider = [&] (
         TObjectsGroupingPtr objectsGrouping,
         TAtomicSharedPtr<TFeaturesArraySubsetIndexing> fullSubset,
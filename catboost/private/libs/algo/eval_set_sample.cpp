@@ -0,0 +1,84 @@
+#include "eval_set_sample.h"
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+TVector<TVector<double>> TEvalSetSample::GetApprox(const TVector<TVector<double>>& approx) const {
+    TVector<TVector<double>> sampleApprox(approx.size());
+    for (auto dim : xrange(approx.size())) {
+        sampleApprox[dim].yresize(ObjectIndices.size());
+        for (auto sampleIdx : xrange(ObjectIndices.size())) {
+            sampleApprox[dim][sampleIdx] = approx[dim][ObjectIndices[sampleIdx]];
+        }
+    }
+    return sampleApprox;
+}
+
+TVector<TConstArrayRef<float>> TEvalSetSample::GetTargetRefs() const {
+    TVector<TConstArrayRef<float>> targetRefs;
+    for (const auto& target : Target) {
+        targetRefs.push_back(target);
+    }
+    return targetRefs;
+}
+
+TMaybe<TEvalSetSample> MakeEvalSetSample(
+    const NCB::TTargetDataProvider& targetData,
+    ui32 sampleSize,
+    ui64 randomSeed
+) {
+    const ui32 objectCount = targetData.GetObjectCount();
+    if (objectCount <= sampleSize) {
+        return Nothing();
+    }
+
+    // each object or group is taken independently, so sample has sampleSize objects on average
+    const double sampleRate = double(sampleSize) / objectCount;
+    TFastRng64 rand(randomSeed);
+    TEvalSetSample sample;
+    const auto maybeGroupInfo = targetData.GetGroupInfo();
+    if (maybeGroupInfo && !maybeGroupInfo->empty()) {
+        for (const auto& queryInfo : *maybeGroupInfo) {
+            if (rand.GenRandReal1() >= sampleRate) {
+                continue;
+            }
+            TQueryInfo sampleQueryInfo = queryInfo;
+            sampleQueryInfo.Begin = sample.ObjectIndices.size();
+            for (auto objectIdx : xrange(queryInfo.Begin, queryInfo.End)) {
+                sample.ObjectIndices.push_back(objectIdx);
+            }
+            sampleQueryInfo.End = sample.ObjectIndices.size();
+            sample.QueryInfo.push_back(std::move(sampleQueryInfo));
+        }
+    } else {
+        for (auto objectIdx : xrange(objectCount)) {
+            if (rand.GenRandReal1() < sampleRate) {
+                sample.ObjectIndices.push_back(objectIdx);
+            }
+        }
+    }
+
+    if (sample.ObjectIndices.empty()) {
+        return Nothing();
+    }
+
+    const auto maybeTarget = targetData.GetTarget();
+    if (maybeTarget) {
+        for (const auto& target : *maybeTarget) {
+            TVector<float>& sampleTarget = sample.Target.emplace_back();
+            sampleTarget.yresize(sample.ObjectIndices.size());
+            for (auto sampleIdx : xrange(sample.ObjectIndices.size())) {
+                sampleTarget[sampleIdx] = target[sample.ObjectIndices[sampleIdx]];
+            }
+        }
+    }
+    const auto weights = NCB::GetWeights(targetData);
+    if (!weights.empty()) {
+        sample.Weights.yresize(sample.ObjectIndices.size());
+        for (auto sampleIdx : xrange(sample.ObjectIndices.size())) {
+            sample.Weights[sampleIdx] = weights[sample.ObjectIndices[sampleIdx]];
+        }
+    }
+    return sample;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <catboost/libs/data/target.h>
+#include <catboost/private/libs/data_types/query.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+/**
+ * Fixed random subset of eval set objects used to calculate approximate metric values on intermediate
+ * iterations (see metric_sample_size option). Groups of objects are taken whole, so querywise metrics
+ * are calculated on the same queries with their pairs and subgroups.
+ */
+struct TEvalSetSample {
+    TVector<ui32> ObjectIndices; // sorted
+    TVector<TVector<float>> Target; // [targetIdx][sampleObjectIdx]
+    TVector<float> Weights; // [sampleObjectIdx], empty if weights of eval set are trivial
+    TVector<TQueryInfo> QueryInfo; // bounds are indices in sample
+
+public:
+    TVector<TVector<double>> GetApprox(const TVector<TVector<double>>& approx) const; // [dim][sampleObjectIdx]
+
+    TVector<TConstArrayRef<float>> GetTargetRefs() const;
+};
+
+// Nothing if the eval set has no more than sampleSize objects
+TMaybe<TEvalSetSample> MakeEvalSetSample(
+    const NCB::TTargetDataProvider& targetData,
+    ui32 sampleSize,
+    ui64 randomSeed
+);
@@ -6,6 +6,7 @@
 
 #include <catboost/private/libs/data_types/groupid.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
@@ -14,6 +15,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/cast.h>
+#include <util/generic/xrange.h>
 
 
 using namespace NCB;
@@ -96,68 +98,90 @@ static void InitPermutationData(
 }
 
 
-TFold TFold::BuildDynamicFold(
+TFold TFold::StartBuildFold(
     const NCB::TTrainingDataProviders& data,
-    const TVector<TTargetClassifier>& targetClassifiers,
     bool shuffle,
     ui32 permuteBlockSize,
+    const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
+    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TFold ff;
+
+    InitPermutationData(*data.Learn, shuffle, permuteBlockSize, rand, &ff);
+
+    ff.InitOnlineEstimatedFeatures(
+        onlineEstimatedFeaturesQuantizationOptions,
+        std::move(onlineEstimatedFeaturesQuantizedInfo),
+        data,
+        localExecutor,
+        rand
+    );
+
+    return ff;
+}
+
+void TFold::FinishBuildDynamicFold(
+    const NCB::TTrainingDataProviders& data,
+    const TVector<TTargetClassifier>& targetClassifiers,
+    bool shuffle,
     int approxDimension,
     double multiplier,
     bool storeExpApproxes,
     bool hasPairwiseWeights,
     const TMaybe<TVector<double>>& startingApprox,
-    const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
-    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
-    TRestorableFastRng64* rand,
     NPar::ILocalExecutor* localExecutor
 ) {
     const NCB::TTrainingDataProvider& learnData = *data.Learn;
 
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
-    TFold ff;
-    ff.SampleWeights.resize(learnSampleCount, 1);
-
-    InitPermutationData(learnData, shuffle, permuteBlockSize, rand, &ff);
+    SampleWeights.yresize(learnSampleCount);
+    ParallelFill(1.0f, /*blockSize*/ Nothing(), localExecutor, MakeArrayRef(SampleWeights));
 
-    ff.AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers, localExecutor);
-    ff.SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
+    AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers, localExecutor);
+    SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
 
     TVector<ui32> queryIndices;
 
     auto maybeGroupInfos = learnData.TargetData->GetGroupInfo();
     if (maybeGroupInfos) {
         if (shuffle) {
-            GetGroupInfosSubset(*maybeGroupInfos, *ff.LearnPermutation, localExecutor, &ff.LearnQueriesInfo);
+            GetGroupInfosSubset(*maybeGroupInfos, *LearnPermutation, localExecutor, &LearnQueriesInfo);
         } else {
-            ff.LearnQueriesInfo.insert(
-                ff.LearnQueriesInfo.end(),
+            LearnQueriesInfo.insert(
+                LearnQueriesInfo.end(),
                 maybeGroupInfos->begin(),
                 maybeGroupInfos->end()
             );
         }
-        queryIndices = GetQueryIndicesForDocs(ff.LearnQueriesInfo, learnSampleCount);
+        queryIndices = GetQueryIndicesForDocs(LearnQueriesInfo, learnSampleCount);
     }
 
     TVector<float> pairwiseWeights;
     if (hasPairwiseWeights) {
         pairwiseWeights.resize(learnSampleCount);
-        CalcPairwiseWeights(ff.LearnQueriesInfo, ff.LearnQueriesInfo.ysize(), &pairwiseWeights);
+        CalcPairwiseWeights(LearnQueriesInfo, LearnQueriesInfo.ysize(), &pairwiseWeights);
     }
 
     TMaybeData<TConstArrayRef<TConstArrayRef<float>>> baseline = learnData.TargetData->GetBaseline();
 
+    // bodies are nested, so their weights are summed incrementally in the same order as for each body separately
+    int prevBodyFinish = 0;
+    double bodySumWeight = 0.0;
+
     ui32 leftPartLen = UpdateSize(
         SelectMinBatchSize(learnSampleCount),
-        ff.LearnQueriesInfo,
+        LearnQueriesInfo,
         queryIndices,
         learnSampleCount
     );
-    while (ff.BodyTailArr.empty() || leftPartLen < learnSampleCount) {
+    while (BodyTailArr.empty() || leftPartLen < learnSampleCount) {
         int bodyFinish = (int)leftPartLen;
         int tailFinish = (int) UpdateSize(
             SelectTailSize(leftPartLen, multiplier),
-            ff.LearnQueriesInfo,
+            LearnQueriesInfo,
             queryIndices,
             learnSampleCount
         );
@@ -167,24 +191,36 @@ TFold TFold::BuildDynamicFold(
             bodyQueryFinish = queryIndices[bodyFinish - 1] + 1;
             tailQueryFinish = queryIndices[tailFinish - 1] + 1;
         }
-        double bodySumWeight = ff.GetLearnWeights().empty()
-            ? bodyFinish
-            : Accumulate(ff.GetLearnWeights().begin(), ff.GetLearnWeights().begin() + bodyFinish, (double)0.0);
+        if (GetLearnWeights().empty()) {
+            bodySumWeight = bodyFinish;
+        } else {
+            bodySumWeight = Accumulate(
+                GetLearnWeights().begin() + prevBodyFinish,
+                GetLearnWeights().begin() + bodyFinish,
+                bodySumWeight);
+        }
+        prevBodyFinish = bodyFinish;
 
         TFold::TBodyTail bt(bodyQueryFinish, tailQueryFinish, bodyFinish, tailFinish, bodySumWeight);
-        InitApproxes(bt.TailFinish, startingApprox, approxDimension, storeExpApproxes,  &(bt.Approx));
+        InitApproxes(
+            bt.TailFinish,
+            startingApprox,
+            approxDimension,
+            storeExpApproxes,
+            localExecutor,
+            &(bt.Approx)
+        );
 
         if (baseline) {
             InitApproxFromBaseline(
                 bt.TailFinish,
                 *baseline,
-                ff.GetLearnPermutationArray(),
+                GetLearnPermutationArray(),
                 storeExpApproxes,
                 &bt.Approx
             );
         }
-        AllocateRank2(approxDimension, bt.TailFinish, bt.WeightedDerivatives);
-        AllocateRank2(approxDimension, bt.TailFinish, bt.SampleWeightedDerivatives);
+        // derivatives are allocated by MoveDerivativesToFold
         if (hasPairwiseWeights) {
             bt.PairwiseWeights.insert(
                 bt.PairwiseWeights.begin(),
@@ -193,20 +229,48 @@ TFold TFold::BuildDynamicFold(
             );
             bt.SamplePairwiseWeights.resize(bt.TailFinish);
         }
-        ff.BodyTailArr.emplace_back(std::move(bt));
+        BodyTailArr.emplace_back(std::move(bt));
         leftPartLen = (ui32)bt.TailFinish;
     }
 
-    ff.InitOnlineEstimatedFeatures(
+    InitOnlineCtrs(data);
+}
+
+TFold TFold::BuildDynamicFold(
+    const NCB::TTrainingDataProviders& data,
+    const TVector<TTargetClassifier>& targetClassifiers,
+    bool shuffle,
+    ui32 permuteBlockSize,
+    int approxDimension,
+    double multiplier,
+    bool storeExpApproxes,
+    bool hasPairwiseWeights,
+    const TMaybe<TVector<double>>& startingApprox,
+    const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
+    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TFold ff = StartBuildFold(
+        data,
+        shuffle,
+        permuteBlockSize,
         onlineEstimatedFeaturesQuantizationOptions,
         std::move(onlineEstimatedFeaturesQuantizedInfo),
+        rand,
+        localExecutor
+    );
+    ff.FinishBuildDynamicFold(
         data,
-        localExecutor,
-        rand
+        targetClassifiers,
+        shuffle,
+        approxDimension,
+        multiplier,
+        storeExpApproxes,
+        hasPairwiseWeights,
+        startingApprox,
+        localExecutor
     );
-
-    ff.InitOnlineCtrs(data);
-
     return ff;
 }
 
@@ -219,43 +283,36 @@ void TFold::SetWeights(TConstArrayRef<float> weights, ui32 learnSampleCount) {
     }
 }
 
-TFold TFold::BuildPlainFold(
+void TFold::FinishBuildPlainFold(
     const NCB::TTrainingDataProviders& data,
     const TVector<TTargetClassifier>& targetClassifiers,
     bool shuffle,
-    ui32 permuteBlockSize,
     int approxDimension,
     bool storeExpApproxes,
     bool hasPairwiseWeights,
     const TMaybe<TVector<double>>& startingApprox,
-    const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
-    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
     TIntrusivePtr<TPrecomputedOnlineCtr> precomputedSingleOnlineCtrs,
-    TRestorableFastRng64* rand,
     NPar::ILocalExecutor* localExecutor
 ) {
     const NCB::TTrainingDataProvider& learnData = *data.Learn;
 
     const ui32 learnSampleCount = learnData.GetObjectCount();
 
-    TFold ff;
-
-    InitPermutationData(learnData, shuffle, permuteBlockSize, rand, &ff);
-
     if (learnSampleCount) {
-        ff.SampleWeights.resize(learnSampleCount, 1);
+        SampleWeights.yresize(learnSampleCount);
+        ParallelFill(1.0f, /*blockSize*/ Nothing(), localExecutor, MakeArrayRef(SampleWeights));
 
-        ff.AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers, localExecutor);
-        ff.SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
+        AssignTarget(learnData.TargetData->GetTarget(), targetClassifiers, localExecutor);
+        SetWeights(GetWeights(*learnData.TargetData), learnSampleCount);
 
         auto maybeGroupInfos = learnData.TargetData->GetGroupInfo();
         int groupCountAsInt = 0;
         if (maybeGroupInfos) {
             if (shuffle) {
-                GetGroupInfosSubset(*maybeGroupInfos, *ff.LearnPermutation, localExecutor, &ff.LearnQueriesInfo);
+                GetGroupInfosSubset(*maybeGroupInfos, *LearnPermutation, localExecutor, &LearnQueriesInfo);
             } else {
-                ff.LearnQueriesInfo.insert(
-                    ff.LearnQueriesInfo.end(),
+                LearnQueriesInfo.insert(
+                    LearnQueriesInfo.end(),
                     maybeGroupInfos->begin(),
                     maybeGroupInfos->end()
                 );
@@ -270,15 +327,22 @@ TFold TFold::BuildPlainFold(
             groupCountAsInt,
             learnSampleCountAsInt,
             learnSampleCountAsInt,
-            ff.GetSumWeight()
+            GetSumWeight()
         );
 
-        InitApproxes(learnSampleCount, startingApprox, approxDimension, storeExpApproxes, &(bt.Approx));
-        AllocateRank2(approxDimension, learnSampleCount, bt.WeightedDerivatives);
-        AllocateRank2(approxDimension, learnSampleCount, bt.SampleWeightedDerivatives);
+        InitApproxes(
+            learnSampleCount,
+            startingApprox,
+            approxDimension,
+            storeExpApproxes,
+            localExecutor,
+            &(bt.Approx)
+        );
+        bt.WeightedDerivatives.Allocate(approxDimension, learnSampleCount);
+        bt.SampleWeightedDerivatives.Allocate(approxDimension, learnSampleCount);
         if (hasPairwiseWeights) {
             bt.PairwiseWeights.resize(learnSampleCount);
-            CalcPairwiseWeights(ff.LearnQueriesInfo, bt.TailQueryFinish, &bt.PairwiseWeights);
+            CalcPairwiseWeights(LearnQueriesInfo, bt.TailQueryFinish, &bt.PairwiseWeights);
             bt.SamplePairwiseWeights.resize(learnSampleCount);
         }
 
@@ -287,24 +351,52 @@ TFold TFold::BuildPlainFold(
             InitApproxFromBaseline(
                 learnSampleCount,
                 *baseline,
-                ff.GetLearnPermutationArray(),
+                GetLearnPermutationArray(),
                 storeExpApproxes,
                 &bt.Approx
             );
         }
-        ff.BodyTailArr.emplace_back(std::move(bt));
+        BodyTailArr.emplace_back(std::move(bt));
     }
 
-    ff.InitOnlineEstimatedFeatures(
+    InitOnlineCtrs(data, precomputedSingleOnlineCtrs);
+}
+
+TFold TFold::BuildPlainFold(
+    const NCB::TTrainingDataProviders& data,
+    const TVector<TTargetClassifier>& targetClassifiers,
+    bool shuffle,
+    ui32 permuteBlockSize,
+    int approxDimension,
+    bool storeExpApproxes,
+    bool hasPairwiseWeights,
+    const TMaybe<TVector<double>>& startingApprox,
+    const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
+    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+    TIntrusivePtr<TPrecomputedOnlineCtr> precomputedSingleOnlineCtrs,
+    TRestorableFastRng64* rand,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TFold ff = StartBuildFold(
+        data,
+        shuffle,
+        permuteBlockSize,
         onlineEstimatedFeaturesQuantizationOptions,
         std::move(onlineEstimatedFeaturesQuantizedInfo),
+        rand,
+        localExecutor
+    );
+    ff.FinishBuildPlainFold(
         data,
-        localExecutor,
-        rand
+        targetClassifiers,
+        shuffle,
+        approxDimension,
+        storeExpApproxes,
+        hasPairwiseWeights,
+        startingApprox,
+        std::move(precomputedSingleOnlineCtrs),
+        localExecutor
     );
-
-    ff.InitOnlineCtrs(data, precomputedSingleOnlineCtrs);
-
     return ff;
 }
 
@@ -357,6 +449,44 @@ void TFold::AssignTarget(
     }
 }
 
+size_t TFold::GetApproxesDataSize() const {
+    size_t dataSize = 0;
+    for (const auto& bodyTail : BodyTailArr) {
+        for (const auto& dimensionApprox : bodyTail.Approx) {
+            dataSize += dimensionApprox.size() * sizeof(double);
+        }
+        for (const auto* derivatives : {&bodyTail.WeightedDerivatives, &bodyTail.SampleWeightedDerivatives}) {
+            dataSize += derivatives->size() * derivatives->GetRowSize() * sizeof(double);
+        }
+        dataSize += (bodyTail.PairwiseWeights.size() + bodyTail.SamplePairwiseWeights.size()) * sizeof(float);
+    }
+    return dataSize;
+}
+
+void TFold::MoveDerivativesToFold(TArrayRef<TFold> folds, TFold* takenFold) {
+    const int approxDimension = takenFold->GetApproxDimension();
+    for (auto bodyTailIdx : xrange(takenFold->BodyTailArr.size())) {
+        auto& takenBodyTail = takenFold->BodyTailArr[bodyTailIdx];
+        for (auto& fold : folds) {
+            if (&fold == takenFold || fold.BodyTailArr.size() <= bodyTailIdx) {
+                continue;
+            }
+            auto& bodyTail = fold.BodyTailArr[bodyTailIdx];
+            if (bodyTail.WeightedDerivatives.empty()) {
+                continue;
+            }
+            if (takenBodyTail.WeightedDerivatives.empty()) {
+                takenBodyTail.WeightedDerivatives = std::move(bodyTail.WeightedDerivatives);
+                takenBodyTail.SampleWeightedDerivatives = std::move(bodyTail.SampleWeightedDerivatives);
+            }
+            bodyTail.WeightedDerivatives.Clear();
+            bodyTail.SampleWeightedDerivatives.Clear();
+        }
+        takenBodyTail.WeightedDerivatives.Allocate(approxDimension, takenBodyTail.TailFinish);
+        takenBodyTail.SampleWeightedDerivatives.Allocate(approxDimension, takenBodyTail.TailFinish);
+    }
+}
+
 void TFold::SaveApproxes(IOutputStream* s) const {
     const ui64 bodyTailCount = BodyTailArr.size();
     ::Save(s, bodyTailCount);
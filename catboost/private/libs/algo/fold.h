@@ -8,6 +8,7 @@
 #include <catboost/private/libs/data_types/pair.h>
 #include <catboost/private/libs/data_types/query.h>
 #include <catboost/libs/helpers/array_subset.h>
+#include <catboost/libs/helpers/rank2_array.h>
 #include <catboost/libs/model/online_ctr.h>
 #include <catboost/private/libs/options/binarization_options.h>
 #include <catboost/private/libs/options/defaults_helper.h>
@@ -52,9 +53,9 @@ public:
 
     public:
         TVector<TVector<double>> Approx;  // [dim][]
-        TVector<TVector<double>> WeightedDerivatives;  // [dim][]
+        NCB::TRank2Array<double> WeightedDerivatives;  // [dim][]
         // TODO(annaveronika): make a single vector<vector> for all BodyTail
-        TVector<TVector<double>> SampleWeightedDerivatives;  // [dim][]
+        NCB::TRank2Array<double> SampleWeightedDerivatives;  // [dim][]
         TVector<float> PairwiseWeights;  // [dim][]
         TVector<float> SamplePairwiseWeights;  // [dim][]
 
@@ -116,14 +117,25 @@ public:
         return BodyTailArr[0].Approx.ysize();
     }
 
-    void TrimOnlineCTR(size_t maxOnlineCTRFeatures) {
-        if (OwnedOnlineCtrs && OwnedOnlineCtrs->Data.size() > maxOnlineCTRFeatures) {
-            OwnedOnlineCtrs->Data.clear();
+    void TrimOnlineCTR(size_t maxOnlineCTRFeatures, size_t maxOnlineCTRDataSize) {
+        if (OwnedOnlineCtrs) {
+            OwnedOnlineCtrs->TrimData(maxOnlineCTRFeatures, maxOnlineCTRDataSize);
         }
     }
 
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
+    // approxes, derivatives and pairwise weights of all body tails, in bytes
+    size_t GetApproxesDataSize() const;
+
+    /* Derivatives of body tails are needed only by the tree search on the fold taken for an iteration
+     * and are recalculated on each iteration. So derivatives of dynamic folds are not kept for every fold,
+     * instead buffers of other folds are moved to the taken fold (body tails sizes for different folds can
+     * differ a little, so the buffers are resized). With ordered boosting derivatives take about two thirds
+     * of a fold's approxes data.
+     */
+    static void MoveDerivativesToFold(TArrayRef<TFold> folds, TFold* takenFold);
+
     void SaveApproxes(IOutputStream* s) const;
     void LoadApproxes(IInputStream* s);
 
@@ -159,6 +171,46 @@ public:
         NPar::ILocalExecutor* localExecutor
     );
 
+    /* BuildDynamicFold and BuildPlainFold split in two stages, to build several folds in parallel
+     * with the same results as sequentially.
+     * StartBuildFold initializes the permutation and online estimated features, it is the only stage
+     * that uses rand, so it must be called for the folds sequentially.
+     * FinishBuild*Fold initialize all other data and can be called for different folds in parallel.
+     */
+    static TFold StartBuildFold(
+        const NCB::TTrainingDataProviders& data,
+        bool shuffle,
+        ui32 permuteBlockSize,
+        const NCatboostOptions::TBinarizationOptions& onlineEstimatedFeaturesQuantizationOptions,
+        NCB::TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo, // can be nullptr
+        TRestorableFastRng64* rand,
+        NPar::ILocalExecutor* localExecutor
+    );
+
+    void FinishBuildDynamicFold(
+        const NCB::TTrainingDataProviders& data,
+        const TVector<TTargetClassifier>& targetClassifiers,
+        bool shuffle,
+        int approxDimension,
+        double multiplier,
+        bool storeExpApproxes,
+        bool hasPairwiseWeights,
+        const TMaybe<TVector<double>>& startingApprox,
+        NPar::ILocalExecutor* localExecutor
+    );
+
+    void FinishBuildPlainFold(
+        const NCB::TTrainingDataProviders& data,
+        const TVector<TTargetClassifier>& targetClassifiers,
+        bool shuffle,
+        int approxDimension,
+        bool storeExpApproxes,
+        bool hasPairwiseWeights,
+        const TMaybe<TVector<double>>& startingApprox,
+        TIntrusivePtr<TPrecomputedOnlineCtr> precomputedSingleOnlineCtrs, // can be empty
+        NPar::ILocalExecutor* localExecutor
+    );
+
     double GetSumWeight() const { return SumWeight; }
     ui32 GetLearnSampleCount() const { return LearnPermutation->GetSubsetGrouping()->GetObjectCount(); }
 
@@ -7,6 +7,7 @@
 #include <catboost/libs/model/model_estimated_features.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/model_export/model_exporter.h>
+#include <catboost/libs/model/sketch_ctr_provider.h>
 #include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/private/libs/options/catboost_options.h>
 #include <catboost/private/libs/options/enum_helpers.h>
@@ -623,8 +624,15 @@ namespace NCB {
             "PerfectHashedToHashedCatValuesMap has not been specified"
         );
         auto applyData = dstModel->ModelTrees->GetApplyData();
-        if (requiresStaticCtrProvider) {
-            dstModel->CtrProvider = new TStaticCtrProvider;
+        const auto& catFeatureParams = Options.CatFeatureParams.Get();
+        const ui32 ctrSketchWidth = catFeatureParams.CtrSketchWidth.GetUnchecked();
+        // sketches are small, so they are not streamed
+        if (requiresStaticCtrProvider || ctrSketchWidth) {
+            if (ctrSketchWidth) {
+                dstModel->CtrProvider = new TSketchCtrProvider(ctrSketchWidth, catFeatureParams.CtrSketchDepth.GetUnchecked());
+            } else {
+                dstModel->CtrProvider = new TStaticCtrProvider;
+            }
 
             TMutex lock;
             CalcFinalCtrs(
@@ -21,11 +21,13 @@
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/private/libs/algo_helpers/langevin_utils.h>
 #include <catboost/private/libs/distributed/master.h>
 
 #include <library/cpp/fast_log/fast_log.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/queue.h>
 #include <util/generic/scope.h>
@@ -57,9 +59,23 @@ namespace {
     };
 }
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds) {
+/* Online CTRs of all folds share a quarter of the RAM limit,
+ * the margin is for the other data and the CTRs computed before the next trimming.
+ */
+static size_t GetMaxOnlineCtrDataSizePerFold(const TLearnContext& ctx) {
+    const size_t foldCount = ctx.LearnProgress->Folds.size() + 1; // with averaging fold
+    return ParseMemorySizeDescription(ctx.Params.SystemOptions->CpuUsedRamLimit.Get()) / 4 / foldCount;
+}
+
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx) {
+    const size_t maxDataSizePerFold = GetMaxOnlineCtrDataSizePerFold(ctx);
     for (auto& fold : folds) {
-        fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES);
+        fold->TrimOnlineCTR(MAX_ONLINE_CTR_FEATURES, maxDataSizePerFold);
+        if (fold->OwnedOnlineCtrs) {
+            CATBOOST_DEBUG_LOG << "Online CTR cache: hit rate " << fold->OwnedOnlineCtrs->GetHitRate()
+                << ", projections " << fold->OwnedOnlineCtrs->Data.size()
+                << ", size " << fold->OwnedOnlineCtrs->GetDataSize() << Endl;
+        }
     }
 }
 
@@ -70,7 +86,8 @@ static double CalcDerivativesStDevFromZeroOrderedBoosting(
     double sum2 = 0;
     size_t count = 0;
     for (const auto& bt : fold.BodyTailArr) {
-        for (const auto& perDimensionWeightedDerivatives : bt.WeightedDerivatives) {
+        for (auto dim : xrange(bt.WeightedDerivatives.size())) {
+            const auto perDimensionWeightedDerivatives = bt.WeightedDerivatives[dim];
             sum2 += L2NormSquared<double>(
                 MakeArrayRef(perDimensionWeightedDerivatives.data() + bt.BodyFinish, bt.TailFinish - bt.BodyFinish),
                 localExecutor
@@ -94,11 +111,11 @@ static double CalcDerivativesStDevFromZeroPlainBoosting(
     const auto& weightedDerivatives = fold.BodyTailArr.front().WeightedDerivatives;
 
     double sum2 = 0;
-    for (const auto& perDimensionWeightedDerivatives : weightedDerivatives) {
-        sum2 += L2NormSquared<double>(perDimensionWeightedDerivatives, localExecutor);
+    for (auto dim : xrange(weightedDerivatives.size())) {
+        sum2 += L2NormSquared<double>(weightedDerivatives[dim], localExecutor);
     }
 
-    return sqrt(sum2 / weightedDerivatives.front().size());
+    return sqrt(sum2 / weightedDerivatives.GetRowSize());
 }
 
 static double CalcDerivativesStDevFromZero(
@@ -392,6 +409,101 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(
 }
 
 
+// Candidates are rescored at least once per this number of trees
+constexpr ui32 MaxCandidateScoreStaleness = 10;
+
+// Part of the other candidates which are rescored at random
+constexpr double StaleCandidatesRescoringRate = 0.1;
+
+static bool HasScoresHistory(const TSplitEnsemble& splitEnsemble) {
+    return (splitEnsemble.Type == ESplitEnsembleType::OneFeature)
+        && !splitEnsemble.IsEstimated
+        && EqualToOneOf(
+            splitEnsemble.SplitCandidate.Type,
+            ESplitType::FloatFeature,
+            ESplitType::OneHotFeature);
+}
+
+static void SelectCandidatesByScoresHistory(
+    ui32 depth,
+    TLearnContext* ctx,
+    TCandidatesContext* candidatesContext) {
+
+    const ui32 rescoredCandidatesCount = ctx->Params.ObliviousTreeOptions->DevRescoredCandidatesCount.Get();
+    const auto& perDepthScores = ctx->CandidateScoresHistory.PerDepth;
+    if ((rescoredCandidatesCount == 0)
+        || (depth >= perDepthScores.size())
+        || (perDepthScores[depth].size() <= rescoredCandidatesCount))
+    {
+        return;
+    }
+    const auto& scoredCandidates = perDepthScores[depth];
+
+    TVector<double> scores;
+    scores.reserve(scoredCandidates.size());
+    for (const auto& [splitEnsemble, scoredCandidate] : scoredCandidates) {
+        scores.push_back(scoredCandidate.Score);
+    }
+    NthElement(
+        scores.begin(),
+        scores.begin() + rescoredCandidatesCount - 1,
+        scores.end(),
+        [] (double lhs, double rhs) { return lhs > rhs; });
+    const double minRescoredScore = scores[rescoredCandidatesCount - 1];
+
+    const ui32 iteration = ctx->LearnProgress->GetCurrentTrainingIterationCount();
+    auto& rand = ctx->LearnProgress->Rand;
+
+    auto& candList = candidatesContext->CandidateList;
+    TCandidateList updatedCandList;
+    updatedCandList.reserve(candList.size());
+    for (auto& candSubList : candList) {
+        const auto& splitEnsemble = candSubList.Candidates[0].SplitEnsemble;
+        const auto* scoredCandidate = HasScoresHistory(splitEnsemble)
+            ? scoredCandidates.FindPtr(splitEnsemble)
+            : nullptr;
+        const bool addCandSubListToResult = !scoredCandidate
+            || (scoredCandidate->Score >= minRescoredScore)
+            || (iteration - scoredCandidate->Iteration >= MaxCandidateScoreStaleness)
+            || (rand.GenRandReal1() < StaleCandidatesRescoringRate);
+        if (addCandSubListToResult) {
+            updatedCandList.push_back(std::move(candSubList));
+        } else if (ctx->UseTreeLevelCaching()) {
+            // stats of the previous level are not updated for skipped candidates
+            ctx->PrevTreeLevelStats.Stats.erase(splitEnsemble);
+        }
+    }
+
+    candList = std::move(updatedCandList);
+}
+
+static void UpdateCandidateScoresHistory(
+    ui32 depth,
+    const TCandidatesContext& candidatesContext,
+    TLearnContext* ctx) {
+
+    if (ctx->Params.ObliviousTreeOptions->DevRescoredCandidatesCount.Get() == 0) {
+        return;
+    }
+    auto& perDepthScores = ctx->CandidateScoresHistory.PerDepth;
+    if (depth >= perDepthScores.size()) {
+        perDepthScores.resize(depth + 1);
+    }
+    const ui32 iteration = ctx->LearnProgress->GetCurrentTrainingIterationCount();
+    for (const auto& candSubList : candidatesContext.CandidateList) {
+        const auto& splitEnsemble = candSubList.Candidates[0].SplitEnsemble;
+        if (!HasScoresHistory(splitEnsemble)) {
+            continue;
+        }
+        double bestScore = MINIMAL_SCORE;
+        for (const auto& candidate : candSubList.Candidates) {
+            bestScore = Max(bestScore, candidate.BestScore.Val);
+        }
+        perDepthScores[depth][splitEnsemble] = {bestScore, iteration};
+    }
+}
+
+
 static void AddCtrsToCandList(
     const TFold& fold,
     const TLearnContext& ctx,
@@ -626,6 +738,44 @@ static void SelectCtrsToDropAfterCalc(
 }
 
 
+/* Cost of scoring a candidates list in passes over sampled objects.
+ * Online CTRs which are not computed yet take about one more pass per CTR.
+ */
+static size_t EstimateCandidatesScoringCost(const TCandidatesInfoList& candidate, TFold* fold) {
+    const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+    size_t cost = candidate.Candidates.size();
+    if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+        const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+        const auto* ownedCtr = fold->GetOwnedCtrs(proj);
+        if (ownedCtr && ownedCtr->Data.at(proj).Feature.empty()) {
+            cost += candidate.Candidates.size();
+        }
+    }
+    return cost;
+}
+
+/* Costs of candidates lists are uneven, and executor takes tasks in order of indices,
+ * so the most expensive tasks are scheduled first not to be left for the tail.
+ */
+static TVector<int> GetScoringTasksOrder(
+    const TVector<std::pair<size_t, size_t>>& tasks, // vector of (contextIdx, candId)
+    const TVector<TCandidatesContext>& candidatesContexts,
+    TFold* fold) {
+
+    TVector<size_t> costs;
+    costs.reserve(tasks.size());
+    for (const auto& [contextIdx, candId] : tasks) {
+        costs.push_back(
+            EstimateCandidatesScoringCost(candidatesContexts[contextIdx].CandidateList[candId], fold)
+        );
+    }
+    TVector<int> tasksOrder(tasks.size());
+    Iota(tasksOrder.begin(), tasksOrder.end(), 0);
+    StableSort(tasksOrder, [&] (int lhs, int rhs) { return costs[lhs] > costs[rhs]; });
+    return tasksOrder;
+}
+
+
 static void CalcBestScore(
     const TTrainingDataProviders& data,
     const TSplitTree& currentTree,
@@ -636,6 +786,10 @@ static void CalcBestScore(
     TLearnContext* ctx) {
 
     const TFlatPairsInfo pairs = UnpackPairsFromQueries(fold->LearnQueriesInfo);
+    const TVector<TPairLeaves> pairLeaves
+        = IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())
+            ? CalcPairLeaves(pairs, ctx->SampledDocs.Indices, ctx->LocalExecutor)
+            : TVector<TPairLeaves>();
     const auto& monotonicConstraints = ctx->Params.ObliviousTreeOptions->MonotoneConstraints.Get();
     const TVector<int> currTreeMonotonicConstraints = (
         monotonicConstraints.empty()
@@ -651,9 +805,13 @@ static void CalcBestScore(
             tasks.emplace_back(contextIdx, candId);
         }
     }
+    const TVector<int> tasksOrder = GetScoringTasksOrder(tasks, *candidatesContexts, fold);
 
     ctx->LocalExecutor->ExecRange(
-        [&] (int taskIdx) {
+        [&] (int taskOrderIdx) {
+            CB_PROFILE_TRACE_SCOPE("CalcBestScore candidate");
+            // random seeds depend on task index, not on scheduling
+            const int taskIdx = tasksOrder[taskOrderIdx];
             TCandidatesContext& candidatesContext = (*candidatesContexts)[tasks[taskIdx].first];
             TCandidateList& candList = candidatesContext.CandidateList;
 
@@ -664,13 +822,14 @@ static void CalcBestScore(
             if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
                 const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
                 auto* ownedCtr = fold->GetOwnedCtrs(proj);
-                if (ownedCtr && ownedCtr->Data.at(proj).Feature.empty()) {
+                if (ownedCtr && ownedCtr->UseProjectionData(proj)) {
                     ComputeOnlineCTRs(data, *fold, proj, ctx, ownedCtr);
                 }
             }
             TVector<TVector<double>> allScores(candidate.Candidates.size());
             ctx->LocalExecutor->ExecRange(
                 [&](int oneCandidate) {
+                    CB_PROFILE_TRACE_SCOPE("CalcStatsAndScores");
                     THolder<IScoreCalcer> scoreCalcer;
                     if (IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction())) {
                         scoreCalcer.Reset(new TPairwiseScoreCalcer);
@@ -687,6 +846,7 @@ static void CalcBestScore(
                         ctx->SmallestSplitSideDocs,
                         fold,
                         pairs,
+                        pairLeaves,
                         ctx->Params,
                         candidate.Candidates[oneCandidate],
                         currentTree.GetDepth(),
@@ -695,6 +855,7 @@ static void CalcBestScore(
                         monotonicConstraints,
                         ctx->LocalExecutor,
                         &ctx->PrevTreeLevelStats,
+                        &ctx->ScratchCache,
                         /*stats3d*/nullptr,
                         /*pairwiseStats*/nullptr,
                         scoreCalcer.Get());
@@ -781,9 +942,13 @@ static void CalcBestScoreLeafwise(
             tasks.emplace_back(contextIdx, candId);
         }
     }
+    const TVector<int> tasksOrder = GetScoringTasksOrder(tasks, *candidatesContexts, fold);
 
     ctx->LocalExecutor->ExecRange(
-        [&] (int taskIdx) {
+        [&] (int taskOrderIdx) {
+            CB_PROFILE_TRACE_SCOPE("CalcBestScore candidate");
+            // random seeds depend on task index, not on scheduling
+            const int taskIdx = tasksOrder[taskOrderIdx];
             TCandidatesContext& candidatesContext = (*candidatesContexts)[tasks[taskIdx].first];
             TCandidateList& candList = candidatesContext.CandidateList;
 
@@ -795,7 +960,7 @@ static void CalcBestScoreLeafwise(
             if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
                 const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
                 auto* ownedCtr = fold->GetOwnedCtrs(proj);
-                if (ownedCtr && ownedCtr->Data.at(proj).Feature.empty()) {
+                if (ownedCtr && ownedCtr->UseProjectionData(proj)) {
                     ComputeOnlineCTRs(data, *fold, proj, ctx, ownedCtr);
                 }
             }
@@ -1085,7 +1250,10 @@ static void ProcessCtrSplit(
 
     const auto& proj = bestSplit.Ctr.Projection;
     auto* ownedCtr = fold->GetOwnedCtrs(proj);
-    if (ownedCtr && ownedCtr->Data[proj].Feature.empty()) {
+    if (ownedCtr) {
+        ownedCtr->EnsureProjectionInData(proj);
+    }
+    if (ownedCtr && ownedCtr->UseProjectionData(proj)) {
         ComputeOnlineCTRs(data, *fold, proj, ctx, ownedCtr);
         if (ctx->UseTreeLevelCaching()) {
             DropStatsForProjection(*fold, *ctx, proj, &ctx->PrevTreeLevelStats);
@@ -1153,6 +1321,27 @@ static void MarkFeaturesAsUsed(
     }
 }
 
+// split gain is divided equally between the features of the split
+static void AddSplitGainImportance(
+    const TSplit& split,
+    double gain,
+    const TCombinedEstimatedFeaturesContext& estimatedFeaturesContext,
+    const TFeaturesLayout& layout,
+    TVector<double>* splitGainImportance
+) {
+    if (splitGainImportance->empty() || !(gain > 0.0)) {
+        return;
+    }
+    TVector<ui32> externalFeatureIndices;
+    const auto addFeature = [&layout, &externalFeatureIndices](const int internalFeatureIndex, const EFeatureType type) {
+        externalFeatureIndices.push_back(layout.GetExternalFeatureIdx(internalFeatureIndex, type));
+    };
+    split.IterateOverUsedFeatures(estimatedFeaturesContext, addFeature);
+    for (auto externalFeatureIndex : externalFeatureIndices) {
+        (*splitGainImportance)[externalFeatureIndex] += gain / externalFeatureIndices.size();
+    }
+}
+
 static TSplitTree GreedyTensorSearchOblivious(
     const TTrainingDataProviders& data,
     double modelLength,
@@ -1174,6 +1363,7 @@ static TSplitTree GreedyTensorSearchOblivious(
     for (ui32 curDepth = 0; curDepth < ctx->Params.ObliviousTreeOptions->MaxDepth; ++curDepth) {
         TVector<TCandidatesContext> candidatesContexts
             = SelectFeaturesForScoring(data, currentSplitTree, fold, ctx);
+        SelectCandidatesByScoresHistory(curDepth, ctx, &candidatesContexts[0]);
         CheckInterrupted(); // check after long-lasting operation
 
         if (!isSamplingPerTree) {  // sampling per tree level
@@ -1182,6 +1372,7 @@ static TSplitTree GreedyTensorSearchOblivious(
         profile.AddOperation(TStringBuilder() << "Bootstrap, depth " << curDepth);
 
         CalcScores(data, currentSplitTree, scoreStDev, &candidatesContexts, fold, ctx);
+        UpdateCandidateScoresHistory(curDepth, candidatesContexts[0], ctx);
 
         const size_t maxFeatureValueCount = CalcMaxFeatureValueCount(*fold, candidatesContexts);
 
@@ -1196,6 +1387,7 @@ static TSplitTree GreedyTensorSearchOblivious(
             break;
         }
         Y_ASSERT(bestSplitCandidate != nullptr);
+        const double gain = bestScore - scoreBeforeSplit;
         scoreBeforeSplit = bestScore;
 
         const TSplit bestSplit = bestSplitCandidate->GetBestSplit(
@@ -1215,7 +1407,15 @@ static TSplitTree GreedyTensorSearchOblivious(
             &ctx->LearnProgress->UsedFeatures,
             &ctx->LearnProgress->UsedFeaturesPerObject
         );
+        AddSplitGainImportance(
+            bestSplit,
+            gain,
+            ctx->LearnProgress->EstimatedFeaturesContext,
+            *ctx->Layout,
+            &ctx->LearnProgress->SplitGainImportance
+        );
 
+        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             SetPermutedIndices(
                 bestSplit,
@@ -1224,33 +1424,39 @@ static TSplitTree GreedyTensorSearchOblivious(
                 *fold,
                 *indices,
                 ctx->LocalExecutor);
+            /* Preparation of the sampled docs for the next depth and the check for empty leaves both only
+             * read indices, so they are run concurrently to shorten the sequential part between depths.
+             */
+            TVector<std::function<void()>> tasks;
             if (isSamplingPerTree) {
-                if (useLeafwiseScoring) {
-                    ctx->SampledDocs.UpdateIndicesInLeafwiseSortedFold(*indices, ctx->LocalExecutor);
-                } else {
-                    ctx->SampledDocs.UpdateIndices(*indices, ctx->LocalExecutor);
-                }
-                if (ctx->UseTreeLevelCaching() && !useLeafwiseScoring) {
-                    ctx->SmallestSplitSideDocs.SelectSmallestSplitSide(
-                        curDepth + 1,
-                        ctx->SampledDocs,
-                        ctx->LocalExecutor);
-                }
+                tasks.push_back(
+                    [&] () {
+                        if (useLeafwiseScoring) {
+                            ctx->SampledDocs.UpdateIndicesInLeafwiseSortedFold(*indices, ctx->LocalExecutor);
+                        } else {
+                            ctx->SampledDocs.UpdateIndices(*indices, ctx->LocalExecutor);
+                        }
+                        if (ctx->UseTreeLevelCaching() && !useLeafwiseScoring) {
+                            ctx->SmallestSplitSideDocs.SelectSmallestSplitSide(
+                                curDepth + 1,
+                                ctx->SampledDocs,
+                                ctx->LocalExecutor);
+                        }
+                    });
             }
+            tasks.push_back(
+                [&] () {
+                    redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, *indices, ctx->LocalExecutor));
+                });
+            ExecuteTasksInParallel(&tasks, ctx->LocalExecutor);
         } else {
-            MapSetIndices(bestSplit, ctx);
+            redundantIdx = MapSetIndices(bestSplit, ctx);
         }
         currentSplitTree.AddSplit(bestSplit);
         CATBOOST_INFO_LOG << BuildDescription(*ctx->Layout, bestSplit) << " score " << bestScore << "\n";
 
         profile.AddOperation(TStringBuilder() << "Select best split " << curDepth);
 
-        int redundantIdx = -1;
-        if (ctx->Params.SystemOptions->IsSingleHost()) {
-            redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, *indices, ctx->LocalExecutor));
-        } else {
-            redundantIdx = MapGetRedundantSplitIdx(ctx);
-        }
         if (redundantIdx != -1) {
             currentSplitTree.DeleteSplit(redundantIdx);
             CATBOOST_INFO_LOG << "  tensor " << redundantIdx << " is redundant, remove it and stop\n";
@@ -1261,23 +1467,6 @@ static TSplitTree GreedyTensorSearchOblivious(
 }
 
 
-static void SplitDocsSubset(
-    const TIndexedSubset<ui32>& subsetToSplit,
-    TConstArrayRef<TIndexType> indices,
-    TIndexType leftChildIdx,
-    TIndexedSubset<ui32>* leftChildSubset,
-    TIndexedSubset<ui32>* rightChildSubset) {
-
-    // TODO(ilyzhin) it can be parallel
-    for (auto doc : subsetToSplit) {
-        if (indices[doc] == leftChildIdx) {
-            leftChildSubset->push_back(doc);
-        } else{
-            rightChildSubset->push_back(doc);
-        }
-    }
-}
-
 static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
     const TTrainingDataProviders& data,
     double modelLength,
@@ -1367,25 +1556,29 @@ static TNonSymmetricTreeStructure GreedyTensorSearchLossguide(
             &ctx->LearnProgress->UsedFeatures,
             &ctx->LearnProgress->UsedFeaturesPerObject
         );
+        AddSplitGainImportance(
+            bestSplit,
+            curSplitLeaf.Gain,
+            ctx->LearnProgress->EstimatedFeaturesContext,
+            *ctx->Layout,
+            &ctx->LearnProgress->SplitGainImportance
+        );
 
         const auto& node = currentStructure.AddSplit(bestSplit, curSplitLeaf.Leaf);
         const TIndexType leftChildIdx = ~node.Left;
         const TIndexType rightChildIdx = ~node.Right;
-        UpdateIndices(
+        Y_ASSERT(leftChildIdx == splittedNodeIdx);
+        UpdateIndicesWithSplit(
             node,
             data,
             subsetsForLeafs[splittedNodeIdx],
             *fold,
             ctx->LocalExecutor,
-            indicesRef
+            indicesRef,
+            &subsetsForLeafs[leftChildIdx],
+            &subsetsForLeafs[rightChildIdx]
         );
 
-        Y_ASSERT(leftChildIdx == splittedNodeIdx);
-        TIndexedSubset<ui32> leftChildSubset, rightChildSubset;
-        SplitDocsSubset(subsetsForLeafs[splittedNodeIdx], indicesRef, leftChildIdx, &leftChildSubset, &rightChildSubset);
-        subsetsForLeafs[leftChildIdx] = std::move(leftChildSubset);
-        subsetsForLeafs[rightChildIdx] = std::move(rightChildSubset);
-
         ctx->SampledDocs.UpdateIndicesInLeafwiseSortedFoldForSingleLeaf(
             splittedNodeIdx,
             leftChildIdx,
@@ -1702,6 +1895,13 @@ static TNonSymmetricTreeStructure GreedyTensorSearchDepthwise(
                 &ctx->LearnProgress->UsedFeatures,
                 &ctx->LearnProgress->UsedFeaturesPerObject
             );
+            AddSplitGainImportance(
+                bestSplit,
+                gain,
+                ctx->LearnProgress->EstimatedFeaturesContext,
+                *ctx->Layout,
+                &ctx->LearnProgress->SplitGainImportance
+            );
 
             const auto& node = currentStructure.AddSplit(bestSplit, curLevelLeafs[id]);
 
@@ -1749,7 +1949,7 @@ void GreedyTensorSearch(
     TLearnContext* ctx,
     std::variant<TSplitTree, TNonSymmetricTreeStructure>* resTreeStructure) {
 
-    TrimOnlineCTRcache({fold});
+    TrimOnlineCTRcache({fold}, *ctx);
 
     ui32 learnSampleCount = data.Learn->ObjectsData->GetObjectCount();
     TVector<TIndexType> indices(learnSampleCount); // always for all documents
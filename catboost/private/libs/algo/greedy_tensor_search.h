@@ -12,7 +12,8 @@ struct TSplitTree;
 struct TNonSymmetricTreeStructure;
 
 
-void TrimOnlineCTRcache(const TVector<TFold*>& folds);
+// Evicts the least recently used online CTRs of folds above count and memory limits
+void TrimOnlineCTRcache(const TVector<TFold*>& folds, const TLearnContext& ctx);
 
 void GreedyTensorSearch(
     const NCB::TTrainingDataProviders& data,
@@ -193,6 +193,7 @@ void CalcErrorsLocally(
     bool calcAllMetrics,
     bool calcErrorTrackerMetric,
     bool calcNonAdditiveMetricsOnly,
+    bool useEvalSetSamples,
     TLearnContext* ctx
 ) {
     auto onLearn = [&] (TConstArrayRef<const IMetric*> trainMetrics) {
@@ -209,6 +210,8 @@ void CalcErrorsLocally(
             approx = &ctx->LearnProgress->AveragingFold.BodyTailArr[0].Approx;
         }
 
+        // partial values of additive learn metrics are kept between iterations in plain boosting
+        const bool isPlainBoosting = ctx->Params.BoostingOptions->BoostingType == EBoostingType::Plain;
         auto errors = EvalErrorsWithCaching(
             *approx,
             /*approxDelta*/{},
@@ -217,7 +220,8 @@ void CalcErrorsLocally(
             weights,
             queryInfo,
             trainMetrics,
-            ctx->LocalExecutor
+            ctx->LocalExecutor,
+            isPlainBoosting ? &ctx->LearnAdditiveMetricsState : nullptr
         );
 
         for (auto i : xrange(trainMetrics.size())) {
@@ -234,24 +238,56 @@ void CalcErrorsLocally(
     ) {
         const auto &targetData = trainingDataProviders.Test[testIdx]->TargetData;
 
-        auto maybeTarget = targetData->GetTarget();
-        auto weights = GetWeights(*targetData);
-        auto queryInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
+        const TEvalSetSample* sample = nullptr;
+        if (useEvalSetSamples && testIdx < ctx->EvalSetSamples.size() && ctx->EvalSetSamples[testIdx]) {
+            sample = ctx->EvalSetSamples[testIdx].Get();
+        }
+        // error tracker metric is always calculated on whole eval set for overfitting detector and best iteration
+        TVector<const IMetric*> wholeSetMetrics;
+        TVector<const IMetric*> sampleMetrics;
+        for (int i : xrange(testMetrics.size())) {
+            const bool isTrackerMetric = filteredTrackerIdx && (i == *filteredTrackerIdx);
+            (sample && !isTrackerMetric ? sampleMetrics : wholeSetMetrics).push_back(testMetrics[i]);
+        }
 
-        auto errors = EvalErrorsWithCaching(
-            ctx->LearnProgress->TestApprox[testIdx],
-            /*approxDelta*/{},
-            /*isExpApprox*/false,
-            maybeTarget.GetOrElse(TConstArrayRef<TConstArrayRef<float>>()),
-            weights,
-            queryInfo,
-            testMetrics,
-            ctx->LocalExecutor
-        );
+        TVector<TMetricHolder> errors;
+        if (!wholeSetMetrics.empty()) {
+            auto maybeTarget = targetData->GetTarget();
+            auto weights = GetWeights(*targetData);
+            auto queryInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
+
+            errors = EvalErrorsWithCaching(
+                ctx->LearnProgress->TestApprox[testIdx],
+                /*approxDelta*/{},
+                /*isExpApprox*/false,
+                maybeTarget.GetOrElse(TConstArrayRef<TConstArrayRef<float>>()),
+                weights,
+                queryInfo,
+                wholeSetMetrics,
+                ctx->LocalExecutor
+            );
+        }
+        if (!sampleMetrics.empty()) {
+            const TVector<TConstArrayRef<float>> sampleTarget = sample->GetTargetRefs();
+            auto sampleErrors = EvalErrorsWithCaching(
+                sample->GetApprox(ctx->LearnProgress->TestApprox[testIdx]),
+                /*approxDelta*/{},
+                /*isExpApprox*/false,
+                TConstArrayRef<TConstArrayRef<float>>(sampleTarget),
+                sample->Weights,
+                sample->QueryInfo,
+                sampleMetrics,
+                ctx->LocalExecutor
+            );
+            for (auto& error : sampleErrors) {
+                errors.push_back(std::move(error));
+            }
+        }
+        wholeSetMetrics.insert(wholeSetMetrics.end(), sampleMetrics.begin(), sampleMetrics.end());
 
-        for (int i : xrange(testMetrics.size())) {
-            auto metric = testMetrics[i];
-            const bool updateBestIteration = filteredTrackerIdx && (i == *filteredTrackerIdx)
+        for (int i : xrange(wholeSetMetrics.size())) {
+            auto metric = wholeSetMetrics[i];
+            const bool updateBestIteration = filteredTrackerIdx && (metric == testMetrics[*filteredTrackerIdx])
                 && (testIdx == (trainingDataProviders.Test.size() - 1));
 
             ctx->LearnProgress->MetricsAndTimeHistory.AddTestError(
@@ -47,6 +47,7 @@ void CalcErrorsLocally(
     bool calcAllMetrics, // bool value for each error
     bool calcErrorTrackerMetric,
     bool calcNonAdditiveMetricsOnly,
+    bool useEvalSetSamples, // for all metrics except the error tracker one
     TLearnContext* ctx
 );
 
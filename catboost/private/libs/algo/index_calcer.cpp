@@ -185,6 +185,7 @@ void ScheduleUpdateIndicesForSplit(
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
     TMaybe<TFeaturesGroupIndex> maybeFeaturesGroupIndex,
     TConstArrayRef<TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData,
+    TConstArrayRef<TFeaturesGroup> featuresGroupsMetaData,
     const ui32* columnIndexing,  // can be nullptr
     const TColumn& column,
     std::function<const IExclusiveFeatureBundleArray*(ui32)>&& getExclusiveFeaturesBundle,
@@ -227,8 +228,10 @@ void ScheduleUpdateIndicesForSplit(
     } else if (maybeFeaturesGroupIndex) {
         scheduleUpdateIndicesForSplit(
             *getFeaturesGroup(maybeFeaturesGroupIndex->GroupIdx),
-            [partIdx = maybeFeaturesGroupIndex->InGroupIdx, cmpOp = std::move(cmpOp)] (const auto& featuresGroupValue) {
-                return cmpOp(GetPartValueFromGroup(featuresGroupValue, partIdx));
+            [partIdx = maybeFeaturesGroupIndex->InGroupIdx,
+             partBitCount = featuresGroupsMetaData[maybeFeaturesGroupIndex->GroupIdx].PartBitCount,
+             cmpOp = std::move(cmpOp)] (const auto& featuresGroupValue) {
+                return cmpOp(GetPartValueFromGroup(featuresGroupValue, partIdx, partBitCount));
             });
     } else {
         scheduleUpdateIndicesForSplit(column, std::move(cmpOp));
@@ -370,6 +373,7 @@ static void UpdateIndices(
                     maybeBinaryIndex,
                     maybeFeaturesGroupIndex,
                     objectsDataProvider->GetExclusiveFeatureBundlesMetaData(),
+                    objectsDataProvider->GetFeaturesGroupsMetaData(),
                     columnIndexing,
                     column,
                     [&] (ui32 bundleIdx) {
@@ -2,6 +2,7 @@
 
 #include "projection.h"
 
+#include <util/generic/cast.h>
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
 
@@ -167,6 +168,130 @@ void CalcHashes(
 }
 
 
+TMaybe<ui64> CalcCombinationIdsCount(
+    const TProjection& proj,
+    const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    ui64 maxCount) {
+
+    ui64 combinationCount = 1;
+    const auto addFeature = [&] (ui64 valuesCount) {
+        if (combinationCount > maxCount / Max<ui64>(valuesCount, 1)) {
+            return false;
+        }
+        combinationCount *= valuesCount;
+        return true;
+    };
+    for (const int featureIdx : proj.CatFeatures) {
+        if (!addFeature(quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(featureIdx)).OnAll)) {
+            return Nothing();
+        }
+    }
+    const size_t binaryFeatureCount = proj.BinFeatures.size() + proj.OneHotFeatures.size();
+    for (size_t binaryFeatureIdx = 0; binaryFeatureIdx < binaryFeatureCount; ++binaryFeatureIdx) {
+        if (!addFeature(2)) {
+            return Nothing();
+        }
+    }
+    return combinationCount;
+}
+
+void CalcCombinationIds(
+    const TProjection& proj,
+    const TQuantizedObjectsDataProvider& objectsDataProvider,
+    const TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    ui64* begin,
+    ui64* end,
+    NPar::ILocalExecutor* localExecutor) {
+
+    const size_t sampleCount = end - begin;
+    CB_ENSURE((size_t)featuresSubsetIndexing.Size() == sampleCount, "Unexpected range of samples");
+    if (sampleCount == 0) {
+        return;
+    }
+
+    const auto& quantizedFeaturesInfo = *objectsDataProvider.GetQuantizedFeaturesInfo();
+    TCloningParams cloningParams;
+    cloningParams.SubsetIndexing = &featuresSubsetIndexing;
+    TCtrCalcerParams ctrCalcerParams(sampleCount, begin, localExecutor);
+    for (const int featureIdx : proj.CatFeatures) {
+        ctrCalcerParams.PermutedFeatureColumns.emplace_back(
+            (*objectsDataProvider.GetCatFeature(featureIdx))->CloneWithNewSubsetIndexing(
+                cloningParams,
+                localExecutor
+            )
+        );
+        const ui64 valuesCount = quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(featureIdx)).OnAll;
+        ctrCalcerParams.PerIteratorCallbacks.emplace_back(
+            [valuesCount] (TArrayRef<ui64> idArr, IDynamicBlockIteratorBase* baseIterator) {
+                DispatchIteratorType(baseIterator, [idArr, valuesCount] (auto iterator) {
+                    auto block = iterator->Next(idArr.size());
+                    Y_ASSERT(block.size() == idArr.size());
+                    for (auto i : xrange(block.size())) {
+                        Y_ASSERT((ui64)block[i] < valuesCount);
+                        idArr[i] = idArr[i] * valuesCount + (ui64)block[i];
+                    }
+                });
+            }
+        );
+    }
+
+    for (const TBinFeature& feature : proj.BinFeatures) {
+        ctrCalcerParams.PermutedFeatureColumns.emplace_back(
+            (*objectsDataProvider.GetFloatFeature(feature.FloatFeature))->CloneWithNewSubsetIndexing(
+                cloningParams,
+                localExecutor
+            )
+        );
+        ctrCalcerParams.PerIteratorCallbacks.emplace_back(
+            [feature] (TArrayRef<ui64> idArr, IDynamicBlockIteratorBase* baseIterator) {
+                DispatchIteratorType(baseIterator, [idArr, feature] (auto iterator) {
+                    auto block = iterator->Next(idArr.size());
+                    Y_ASSERT(block.size() == idArr.size());
+                    for (auto i : xrange(block.size())) {
+                        const bool isTrueFeature = IsTrueHistogram((ui16)block[i], (ui16)feature.SplitIdx);
+                        idArr[i] = idArr[i] * 2 + isTrueFeature;
+                    }
+                });
+            }
+        );
+    }
+
+    for (const TOneHotSplit& feature : proj.OneHotFeatures) {
+        ctrCalcerParams.PermutedFeatureColumns.emplace_back(
+            (*objectsDataProvider.GetCatFeature(feature.CatFeatureIdx))->CloneWithNewSubsetIndexing(
+                cloningParams,
+                localExecutor
+            )
+        );
+        ctrCalcerParams.PerIteratorCallbacks.emplace_back(
+            [feature] (TArrayRef<ui64> idArr, IDynamicBlockIteratorBase* baseIterator) {
+                DispatchIteratorType(baseIterator, [idArr, feature] (auto iterator) {
+                    auto block = iterator->Next(idArr.size());
+                    Y_ASSERT(block.size() == idArr.size());
+                    for (auto i : xrange(block.size())) {
+                        const bool isTrueFeature = IsTrueOneHotFeature(block[i], (ui32)feature.Value);
+                        idArr[i] = idArr[i] * 2 + isTrueFeature;
+                    }
+                });
+            }
+        );
+    }
+    ctrCalcerParams.Run();
+}
+
+size_t UpdateDenseReindex(TArrayRef<ui32> reindex, size_t reindexedCount, ui64* begin, ui64* end) {
+    ui32 counter = SafeIntegerCast<ui32>(reindexedCount);
+    for (ui64* id = begin; id != end; ++id) {
+        Y_ASSERT(*id < reindex.size());
+        ui32& reindexedId = reindex[*id];
+        if (reindexedId == Max<ui32>()) {
+            reindexedId = counter++;
+        }
+        *id = reindexedId;
+    }
+    return counter;
+}
+
 /// Compute reindexHash and reindex hash values in range [begin,end).
 size_t ComputeReindexHash(ui64 topSize, TDenseHash<ui64, ui32>* reindexHashPtr, ui64* begin, ui64* end) {
     auto& reindexHash = *reindexHashPtr;
@@ -6,6 +6,7 @@
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
 #include <util/generic/vector.h>
 #include <util/system/yassert.h>
 
@@ -36,6 +37,35 @@ void CalcHashes(
     NPar::ILocalExecutor* localExecutor);
 
 
+/// Number of dense ids of feature value combinations of projection, it is the product of numbers of
+/// categorical features values and 2 for each binary split.
+/// @return Nothing if the number is larger than maxCount.
+TMaybe<ui64> CalcCombinationIdsCount(
+    const TProjection& proj,
+    const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    ui64 maxCount);
+
+
+/// Calculate dense ids of feature value combinations into range [begin,end) initialized with zeros.
+/// Features are added one by one as id = parentId * featureValuesCount + featureValue, so it is one
+/// multiply-add per feature and document instead of hashing, and ids are less than CalcCombinationIdsCount.
+/// Parameters are the same as for CalcHashes with perfect hashed values.
+void CalcCombinationIds(
+    const TProjection& proj,
+    const NCB::TQuantizedObjectsDataProvider& objectsDataProvider,
+    const NCB::TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    ui64* begin,
+    ui64* end,
+    NPar::ILocalExecutor* localExecutor);
+
+
+/// Dense counterpart of UpdateReindexHash for combination ids in range [begin,end).
+/// reindex has an element for each combination id, Max<ui32>() for ids not seen yet,
+/// new ids are numbered in the order of appearance starting from reindexedCount.
+/// @return the number of reindexed ids.
+size_t UpdateDenseReindex(TArrayRef<ui32> reindex, size_t reindexedCount, ui64* begin, ui64* end);
+
+
 /// Compute reindexHash and reindex hash values in range [begin,end).
 /// After reindex, hash values belong to [0, reindexHash.Size()].
 /// If reindexHash would become larger than topSize, keep only topSize most
@@ -0,0 +1,57 @@
+#include "iteration_arena.h"
+
+#include <util/system/guard.h>
+
+#include <atomic>
+
+
+static constexpr size_t InitialPoolSize = 64 * 1024;
+
+static std::atomic<ui64> ArenaCount = 0;
+
+thread_local TIterationArena::TCachedThreadPool TIterationArena::CachedThreadPool;
+
+
+TIterationArena::TIterationArena()
+    : Id(++ArenaCount)
+{
+}
+
+void TIterationArena::StartIteration() {
+    with_lock (Lock) {
+        for (auto& [threadId, threadPool] : ThreadPools) {
+            auto& pool = threadPool->Pool;
+            const size_t poolSize = pool->MemoryAllocated() + pool->MemoryWaste();
+            const size_t usedChunkCount = pool->ClearReturnUsedChunkCount(/*keepFirstChunk*/ true);
+            if (usedChunkCount > 1) {
+                // allocations of the next iterations will fit into the first chunk
+                pool = MakeHolder<TMemoryPool>(poolSize);
+            }
+        }
+    }
+}
+
+TMemoryPool* TIterationArena::GetThreadPool() {
+    if (CachedThreadPool.ArenaId != Id) {
+        with_lock (Lock) {
+            auto& threadPool = ThreadPools[TThread::CurrentThreadId()];
+            if (!threadPool) {
+                threadPool = MakeHolder<TThreadPool>();
+                threadPool->Pool = MakeHolder<TMemoryPool>(InitialPoolSize);
+            }
+            CachedThreadPool.ThreadPool = threadPool.Get();
+        }
+        CachedThreadPool.ArenaId = Id;
+    }
+    return CachedThreadPool.ThreadPool->Pool.Get();
+}
+
+size_t TIterationArena::GetMemoryUsage() const {
+    size_t memoryUsage = 0;
+    with_lock (Lock) {
+        for (const auto& [threadId, threadPool] : ThreadPools) {
+            memoryUsage += threadPool->Pool->MemoryAllocated() + threadPool->Pool->MemoryWaste();
+        }
+    }
+    return memoryUsage;
+}
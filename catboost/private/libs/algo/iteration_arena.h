@@ -0,0 +1,50 @@
+#pragma once
+
+#include <util/generic/hash.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/memory/pool.h>
+#include <util/system/spinlock.h>
+#include <util/system/thread.h>
+#include <util/system/types.h>
+
+
+template <class T>
+using TIterationArenaVector = TVector<T, TPoolAlloc<T>>;
+
+
+/* Bump allocators for temporaries of one training iteration, one per thread.
+ * A pool is used only by its thread, so allocations do not contend. All memory is released at once
+ * by StartIteration: containers allocated from the arena must not outlive the iteration.
+ * Pools keep the capacity needed by previous iterations, so in a steady state they don't call malloc.
+ */
+class TIterationArena {
+public:
+    TIterationArena();
+
+    // must not be called concurrently with GetThreadPool
+    void StartIteration();
+
+    TMemoryPool* GetThreadPool();
+
+    size_t GetMemoryUsage() const;
+
+private:
+    struct TThreadPool {
+        THolder<TMemoryPool> Pool;
+    };
+
+    struct TCachedThreadPool {
+        ui64 ArenaId = 0;
+        TThreadPool* ThreadPool = nullptr;
+    };
+
+private:
+    static thread_local TCachedThreadPool CachedThreadPool;
+
+    // to distinguish arenas in the thread-local cache, addresses of arenas can be reused
+    const ui64 Id;
+
+    mutable TAdaptiveLock Lock;
+    THashMap<TThread::TId, THolder<TThreadPool>> ThreadPools;
+};
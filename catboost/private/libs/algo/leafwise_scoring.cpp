@@ -31,6 +31,7 @@ inline static void SetBucketIndex(
     const int bucketBeginOffset,
     TIndexRange<ui32> docIndexRange,
     int groupSize,
+    ui32 groupPartBitCount,
     const TVector<ui32>& groupPartsBucketsOffsets,
     TVector<TBucketIndexType>* bucketIdx // already of proper size
 ) {
@@ -53,7 +54,7 @@ inline static void SetBucketIndex(
             for (auto doc : docIndexRange.Iter()) {
                 for (auto partIdx : xrange(groupSize)) {
                     bucketIdxRef[pos++] = groupPartsBucketsOffsets[partIdx] +
-                        GetPartValueFromGroup(column[bucketBeginOffset + doc], partIdx);
+                        GetPartValueFromGroup(column[bucketBeginOffset + doc], partIdx, groupPartBitCount);
                 }
             }
         } else {
@@ -61,7 +62,7 @@ inline static void SetBucketIndex(
                 const ui32 originalDocIdx = bucketIndexing[doc];
                 for (auto partIdx : xrange(groupSize)) {
                     bucketIdxRef[pos++] = groupPartsBucketsOffsets[partIdx] +
-                        GetPartValueFromGroup(column[originalDocIdx], partIdx);
+                        GetPartValueFromGroup(column[originalDocIdx], partIdx, groupPartBitCount);
                 }
             }
         }
@@ -104,6 +105,7 @@ inline static void ExtractBucketIndex(
     bool isOnlineData,
     TIndexRange<ui32> docIndexRange,
     int groupSize,
+    ui32 groupPartBitCount,
     const TVector<ui32>& groupPartsBucketsOffsets,
     TVector<TBucketIndexType>* bucketIdx // already of proper size
 ) {
@@ -125,6 +127,7 @@ inline static void ExtractBucketIndex(
                     beginOffset,
                     docIndexRange,
                     groupSize,
+                    groupPartBitCount,
                     groupPartsBucketsOffsets,
                     bucketIdx
                 );
@@ -145,6 +148,7 @@ inline static void ExtractBucketIndex(
     const TSplitEnsemble& splitEnsemble,
     TIndexRange<ui32> docIndexRange,
     int groupSize,
+    ui32 groupPartBitCount,
     const TVector<ui32>& groupPartsBucketsOffsets,
     TVector<TBucketIndexType>* bucketIdx // already of proper size
 ) {
@@ -165,6 +169,7 @@ inline static void ExtractBucketIndex(
             beginOffset,
             docIndexRange,
             groupSize,
+            groupPartBitCount,
             groupPartsBucketsOffsets,
             bucketIdx
         );
@@ -177,6 +182,7 @@ inline static void ExtractBucketIndex(
                 splitEnsemble.IsOnlineEstimated,
                 docIndexRange,
                 groupSize,
+                groupPartBitCount,
                 groupPartsBucketsOffsets,
                 bucketIdx
             );
@@ -288,10 +294,12 @@ static void CalcScoresForSubCandidate(
 
     TVector<TBucketIndexType> bucketIdx;
     int groupSize = 1;
+    ui32 groupPartBitCount = CHAR_BIT;
     TVector<ui32> bucketOffsets(1);
     if (candidateInfo.SplitEnsemble.Type == ESplitEnsembleType::FeaturesGroup) {
         const auto groupIdx = candidateInfo.SplitEnsemble.FeaturesGroupRef.GroupIdx;
         groupSize = objectsDataProvider.GetFeaturesGroupMetaData(groupIdx).Parts.ysize();
+        groupPartBitCount = objectsDataProvider.GetFeaturesGroupMetaData(groupIdx).PartBitCount;
         bucketOffsets = objectsDataProvider.GetFeaturesGroupMetaData(groupIdx).BucketOffsets;
     }
     bucketIdx.yresize(fold.GetDocCount() * groupSize);
@@ -304,6 +312,7 @@ static void CalcScoresForSubCandidate(
             candidateInfo.SplitEnsemble,
             docIndexRange,
             groupSize,
+            groupPartBitCount,
             bucketOffsets,
             &bucketIdx
         );
@@ -17,19 +17,25 @@
 #include <catboost/private/libs/distributed/master.h>
 #include <catboost/private/libs/index_range/index_range.h>
 #include <catboost/private/libs/options/defaults_helper.h>
+#include <catboost/private/libs/options/system_options.h>
 
 #include <library/cpp/digest/crc32c/crc32c.h>
 #include <library/cpp/digest/md5/md5.h>
+#include <library/cpp/threading/future/async.h>
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/digest/multi.h>
 #include <util/generic/algorithm.h>
+#include <util/generic/buffer.h>
 #include <util/generic/cast.h>
 #include <util/generic/guid.h>
 #include <util/generic/xrange.h>
 #include <util/folder/path.h>
+#include <util/stream/buffer.h>
 #include <util/stream/file.h>
+#include <util/stream/format.h>
 #include <util/system/fs.h>
+#include <util/system/mem_info.h>
 
 
 using namespace NCB;
@@ -341,6 +347,7 @@ TLearnContext::TLearnContext(
             foldCreationParamsCheckSum,
             /*estimatedFeaturesQuantizationOptions*/
                 params.DataProcessingOptions->FloatFeaturesBinarization.Get(),
+            /*onlineEstimatedFeaturesQuantizedInfo*/ nullptr,
             std::move(precomputedSingleOnlineCtrDataForSingleFold),
             params.ObliviousTreeOptions.Get(),
             initModel,
@@ -352,23 +359,76 @@ TLearnContext::TLearnContext(
     LearnProgress->EnableSaveLoadApprox = Params.SystemOptions->IsSingleHost();
 
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress->Folds));
-    UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress->ApproxDimension);
+    UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(
+        Params,
+        maxBodyTailCount,
+        LearnProgress->ApproxDimension,
+        CountNonCtrBuckets(
+            *data.Learn->ObjectsData->GetFeaturesLayout(),
+            *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(),
+            Params.CatFeatureParams->OneHotMaxSize));
+
+    if (OutputOptions.GetMetricSampleSize() > 0) {
+        EvalSetSamples.resize(data.Test.size());
+        for (auto testIdx : xrange(data.Test.size())) {
+            if (data.Test[testIdx]) {
+                EvalSetSamples[testIdx] = MakeEvalSetSample(
+                    *data.Test[testIdx]->TargetData,
+                    OutputOptions.GetMetricSampleSize(),
+                    Params.RandomSeed.Get() + testIdx);
+            }
+        }
+    }
 }
 
 
+TLearnContext::~TLearnContext() {
+    try {
+        WaitForSnapshotWriting();
+    } catch (...) {
+        CATBOOST_WARNING_LOG << "Failed to write snapshot: " << CurrentExceptionMessage() << Endl;
+    }
+}
+
 void TLearnContext::SaveProgress(std::function<void(IOutputStream*)> onSaveSnapshot) {
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    const auto snapshotBackup = Files.SnapshotFile + ".bak";
-    TProgressHelper(ToString(ETaskType::CPU)).Write(
-        snapshotBackup,
-        [&](IOutputStream* out) {
-            onSaveSnapshot(out);
-            ::SaveMany(out, *LearnProgress, Profile.DumpProfileInfo());
-        }
+    WaitForSnapshotWriting();
+
+    // serialization to memory is fast, so the snapshot is consistent and training is not blocked by the disk
+    auto snapshot = MakeAtomicShared<TBuffer>();
+    {
+        TBufferOutput out(*snapshot);
+        onSaveSnapshot(&out);
+        ::SaveMany(&out, *LearnProgress, Profile.DumpProfileInfo());
+    }
+
+    if (!SnapshotWritingThread) {
+        SnapshotWritingThread = MakeHolder<TThreadPool>();
+        SnapshotWritingThread->Start(1);
+    }
+    SnapshotWriting = NThreading::Async(
+        [snapshotFile = Files.SnapshotFile, snapshot] () {
+            const auto snapshotBackup = snapshotFile + ".bak";
+            TProgressHelper(ToString(ETaskType::CPU)).Write(
+                snapshotBackup,
+                [&](IOutputStream* out) {
+                    out->Write(snapshot->Data(), snapshot->Size());
+                }
+            );
+            TFsPath(snapshotBackup).ForceRenameTo(snapshotFile);
+        },
+        *SnapshotWritingThread
     );
-    TFsPath(snapshotBackup).ForceRenameTo(Files.SnapshotFile);
+}
+
+void TLearnContext::WaitForSnapshotWriting() {
+    if (SnapshotWriting.Initialized()) {
+        auto snapshotWriting = std::move(SnapshotWriting);
+        SnapshotWriting = {};
+        snapshotWriting.GetValueSync();
+    }
 }
 
 bool TLearnContext::TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot) {
@@ -376,9 +436,9 @@ bool TLearnContext::TryLoadProgress(std::function<bool(IInputStream*)> onLoadSna
         return false;
     }
     try {
-        TProgressHelper(ToString(ETaskType::CPU)).CheckedLoad(
+        TProgressHelper(ToString(ETaskType::CPU)).CheckedLoadMapped(
             Files.SnapshotFile,
-            [&](TIFStream* in) {
+            [&](IInputStream* in) {
                 if (!onLoadSnapshot(in)) {
                     return;
                 }
@@ -442,6 +502,7 @@ TLearnProgress::TLearnProgress(
     ui32 featuresCheckSum,
     ui32 foldCreationParamsCheckSum,
     const NCatboostOptions::TBinarizationOptions& estimatedFeaturesQuantizationOptions,
+    TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
     TMaybe<TPrecomputedOnlineCtrData> precomputedSingleOnlineCtrDataForSingleFold,
     const NCatboostOptions::TObliviousTreeLearnerOptions& trainOptions,
     TMaybe<TFullModel*> initModel,
@@ -479,7 +540,7 @@ TLearnProgress::TLearnProgress(
         "foldsCreationParams.LearningFoldCount != 0 for worker local data"
     );
 
-    TQuantizedFeaturesInfoPtr onlineEstimatedQuantizedFeaturesInfo;
+    TQuantizedFeaturesInfoPtr onlineEstimatedQuantizedFeaturesInfo = std::move(onlineEstimatedFeaturesQuantizedInfo);
 
     TIntrusivePtr<TPrecomputedOnlineCtr> precomputedSingleOnlineCtrs;
     if (precomputedSingleOnlineCtrDataForSingleFold) {
@@ -487,65 +548,36 @@ TLearnProgress::TLearnProgress(
         precomputedSingleOnlineCtrs->Data = *precomputedSingleOnlineCtrDataForSingleFold;
     }
 
-    InitApproxes(learnSampleCount, StartingApprox, ApproxDimension, false, &AvrgApprox);
+    InitApproxes(learnSampleCount, StartingApprox, ApproxDimension, false, localExecutor, &AvrgApprox);
 
     if (learnSampleCount) {
 
         Folds.reserve(foldsCreationParams.LearningFoldCount);
 
-        if (foldsCreationParams.IsOrderedBoosting) {
-            for (int foldIdx = 0; foldIdx < foldsCreationParams.LearningFoldCount; ++foldIdx) {
-                Folds.emplace_back(
-                    TFold::BuildDynamicFold(
-                        data,
-                        targetClassifiers,
-                        foldIdx != 0,
-                        foldsCreationParams.FoldPermutationBlockSize,
-                        ApproxDimension,
-                        foldsCreationParams.FoldLenMultiplier,
-                        foldsCreationParams.StoreExpApproxes,
-                        foldsCreationParams.HasPairwiseWeights,
-                        StartingApprox,
-                        estimatedFeaturesQuantizationOptions,
-                        onlineEstimatedQuantizedFeaturesInfo,
-                        &Rand,
-                        localExecutor
-                    )
-                );
-                if (foldIdx == 0) {
-                    onlineEstimatedQuantizedFeaturesInfo
-                        = Folds.back().GetOnlineEstimatedFeatures().GetQuantizedFeaturesInfo();
-                } else {
-                    Folds.back().GetOnlineEstimatedFeatures().Test
-                        = Folds[0].GetOnlineEstimatedFeatures().Test;
-                }
-            }
-        } else {
-            for (int foldIdx = 0; foldIdx < foldsCreationParams.LearningFoldCount; ++foldIdx) {
-                Folds.emplace_back(
-                    TFold::BuildPlainFold(
-                        data,
-                        targetClassifiers,
-                        foldIdx != 0,
-                        isSingleHost ? foldsCreationParams.FoldPermutationBlockSize : learnSampleCount,
-                        ApproxDimension,
-                        foldsCreationParams.StoreExpApproxes,
-                        foldsCreationParams.HasPairwiseWeights,
-                        StartingApprox,
-                        estimatedFeaturesQuantizationOptions,
-                        onlineEstimatedQuantizedFeaturesInfo,
-                        (!isSingleHost || (foldIdx == 0)) ? precomputedSingleOnlineCtrs : nullptr,
-                        &Rand,
-                        localExecutor
-                    )
-                );
-                if (foldIdx == 0) {
-                    onlineEstimatedQuantizedFeaturesInfo
-                        = Folds.back().GetOnlineEstimatedFeatures().GetQuantizedFeaturesInfo();
-                } else {
-                    Folds.back().GetOnlineEstimatedFeatures().Test
-                        = Folds[0].GetOnlineEstimatedFeatures().Test;
-                }
+        const ui32 learningFoldPermuteBlockSize
+            = (foldsCreationParams.IsOrderedBoosting || isSingleHost)
+                ? foldsCreationParams.FoldPermutationBlockSize
+                : learnSampleCount;
+
+        // the rest of folds data is initialized after all permutations, see the parallel initialization below
+        for (int foldIdx = 0; foldIdx < foldsCreationParams.LearningFoldCount; ++foldIdx) {
+            Folds.emplace_back(
+                TFold::StartBuildFold(
+                    data,
+                    foldIdx != 0,
+                    learningFoldPermuteBlockSize,
+                    estimatedFeaturesQuantizationOptions,
+                    onlineEstimatedQuantizedFeaturesInfo,
+                    &Rand,
+                    localExecutor
+                )
+            );
+            if (foldIdx == 0) {
+                onlineEstimatedQuantizedFeaturesInfo
+                    = Folds.back().GetOnlineEstimatedFeatures().GetQuantizedFeaturesInfo();
+            } else {
+                Folds.back().GetOnlineEstimatedFeatures().Test
+                    = Folds[0].GetOnlineEstimatedFeatures().Test;
             }
         }
 
@@ -563,6 +595,7 @@ TLearnProgress::TLearnProgress(
         const auto externalFeaturesCount = data.Learn->ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount();
         const auto objectsCount = data.Learn->ObjectsData->GetObjectCount();
         UsedFeatures.resize(externalFeaturesCount, false);
+        SplitGainImportance.resize(externalFeaturesCount, 0.0);
         // for symmetric tree features usage is equal for all objects, so we don't need to store it for each object individually
         if (trainOptions.GrowPolicy.Get() != EGrowPolicy::SymmetricTree) {
             const auto& featurePenaltiesOptions = trainOptions.FeaturePenalties.Get();
@@ -572,18 +605,12 @@ TLearnProgress::TLearnProgress(
         }
     }
 
-    AveragingFold = TFold::BuildPlainFold(
+    AveragingFold = TFold::StartBuildFold(
         data,
-        targetClassifiers,
         foldsCreationParams.IsAverageFoldPermuted,
         /*permuteBlockSize=*/ isSingleHost ? foldsCreationParams.FoldPermutationBlockSize : learnSampleCount,
-        ApproxDimension,
-        foldsCreationParams.StoreExpApproxes,
-        foldsCreationParams.HasPairwiseWeights,
-        StartingApprox,
         estimatedFeaturesQuantizationOptions,
         onlineEstimatedQuantizedFeaturesInfo,
-        precomputedSingleOnlineCtrs,
         &Rand,
         localExecutor
     );
@@ -591,6 +618,54 @@ TLearnProgress::TLearnProgress(
         AveragingFold.GetOnlineEstimatedFeatures().Test = Folds[0].GetOnlineEstimatedFeatures().Test;
     }
 
+    /* Folds are independent after their permutations are generated, so the rest of their data
+     * (permuted targets and weights, body tails, approxes) is initialized in parallel.
+     */
+    localExecutor->ExecRangeWithThrow(
+        [&] (int foldIdx) {
+            if (foldIdx == Folds.ysize()) {
+                AveragingFold.FinishBuildPlainFold(
+                    data,
+                    targetClassifiers,
+                    foldsCreationParams.IsAverageFoldPermuted,
+                    ApproxDimension,
+                    foldsCreationParams.StoreExpApproxes,
+                    foldsCreationParams.HasPairwiseWeights,
+                    StartingApprox,
+                    precomputedSingleOnlineCtrs,
+                    localExecutor
+                );
+            } else if (foldsCreationParams.IsOrderedBoosting) {
+                Folds[foldIdx].FinishBuildDynamicFold(
+                    data,
+                    targetClassifiers,
+                    foldIdx != 0,
+                    ApproxDimension,
+                    foldsCreationParams.FoldLenMultiplier,
+                    foldsCreationParams.StoreExpApproxes,
+                    foldsCreationParams.HasPairwiseWeights,
+                    StartingApprox,
+                    localExecutor
+                );
+            } else {
+                Folds[foldIdx].FinishBuildPlainFold(
+                    data,
+                    targetClassifiers,
+                    foldIdx != 0,
+                    ApproxDimension,
+                    foldsCreationParams.StoreExpApproxes,
+                    foldsCreationParams.HasPairwiseWeights,
+                    StartingApprox,
+                    (!isSingleHost || (foldIdx == 0)) ? precomputedSingleOnlineCtrs : nullptr,
+                    localExecutor
+                );
+            }
+        },
+        0,
+        Folds.ysize() + 1,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
     ResizeRank2(data.Test.size(), ApproxDimension, TestApprox);
     for (size_t testIdx = 0; testIdx < data.Test.size(); ++testIdx) {
         const auto* testData = data.Test[testIdx].Get();
@@ -754,7 +829,8 @@ void TLearnProgress::Save(IOutputStream* s) const {
         Rand,
         StartingApprox,
         UsedFeatures,
-        UsedFeaturesPerObject
+        UsedFeaturesPerObject,
+        SplitGainImportance
     );
 }
 
@@ -791,7 +867,8 @@ void TLearnProgress::Load(IInputStream* s) {
         Rand,
         StartingApprox,
         UsedFeatures,
-        UsedFeaturesPerObject
+        UsedFeaturesPerObject,
+        SplitGainImportance
     );
 }
 
@@ -820,17 +897,81 @@ bool TLearnContext::GetHasWeights() const {
     return HasWeights;
 }
 
+TCpuRamUsageBreakdown TLearnContext::GetCpuRamUsageBreakdown() const {
+    TCpuRamUsageBreakdown breakdown;
+    const auto addFold = [&] (const TFold& fold) {
+        breakdown.FoldsDataSize += fold.GetApproxesDataSize();
+        for (const auto* ownedCtrs : {fold.OwnedOnlineSingleCtrs, fold.OwnedOnlineCtrs}) {
+            if (ownedCtrs) {
+                breakdown.OnlineCtrsDataSize += ownedCtrs->GetDataSize();
+            }
+        }
+    };
+    for (const auto& fold : LearnProgress->Folds) {
+        addFold(fold);
+    }
+    addFold(LearnProgress->AveragingFold);
+    breakdown.TreeLevelStatsSize = PrevTreeLevelStats.GetMemoryUsage();
+    return breakdown;
+}
+
+void TLearnContext::EnforceCpuRamLimit() {
+    const ui64 cpuRamLimit = ParseMemorySizeDescription(Params.SystemOptions->CpuUsedRamLimit.Get());
+    const ui64 cpuRamUsage = NMemInfo::GetMemInfo().RSS;
+    if (cpuRamUsage <= cpuRamLimit) {
+        return;
+    }
+
+    if (!CpuRamLimitExceededReported) {
+        const auto breakdown = GetCpuRamUsageBreakdown();
+        CATBOOST_WARNING_LOG << "CPU RAM usage (" << HumanReadableSize(cpuRamUsage, SF_BYTES)
+            << ") exceeds the limit (" << HumanReadableSize(cpuRamLimit, SF_BYTES) << "), of it:"
+            << " approxes and derivatives of folds " << HumanReadableSize(breakdown.FoldsDataSize, SF_BYTES)
+            << ", online CTRs " << HumanReadableSize(breakdown.OnlineCtrsDataSize, SF_BYTES)
+            << ", stats of the previous tree level " << HumanReadableSize(breakdown.TreeLevelStatsSize, SF_BYTES)
+            << ". Caches will be dropped, training will be slower" << Endl;
+        CpuRamLimitExceededReported = true;
+    }
+
+    // workers of distributed training keep their own caches
+    if (UseTreeLevelCachingFlag && Params.SystemOptions->IsSingleHost()) {
+        PrevTreeLevelStats.Clear();
+        UseTreeLevelCachingFlag = false;
+    }
+    for (auto& fold : LearnProgress->Folds) {
+        fold.TrimOnlineCTR(/*maxOnlineCTRFeatures*/ 0, /*maxOnlineCTRDataSize*/ 0);
+    }
+    LearnProgress->AveragingFold.TrimOnlineCTR(/*maxOnlineCTRFeatures*/ 0, /*maxOnlineCTRDataSize*/ 0);
+}
+
+static constexpr ui64 MaxTreeLevelCacheSize = 1ULL << 30;
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
-    ui32 approxDimension) {
+    ui32 approxDimension,
+    ui32 nonCtrBucketCount) {
 
-    const ui32 maxLeafCount = 1 << params.ObliviousTreeOptions->MaxDepth;
     // TODO(nikitxskv): Pairwise scoring doesn't use statistics from previous tree level. Need to fix it.
-    return (
-        IsSamplingPerTree(params.ObliviousTreeOptions) &&
-        !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
-        maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
+    if (!IsSamplingPerTree(params.ObliviousTreeOptions) ||
+        IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()))
+    {
+        return false;
+    }
+    const ui64 maxLeafCount = 1ULL << params.ObliviousTreeOptions->MaxDepth;
+    const ui64 statsSegmentCount = maxLeafCount * approxDimension * maxBodyTailCount;
+    if (statsSegmentCount < 64 * 1 * 10) {
+        return true;
+    }
+    /* Stats of the previous level let only the smaller side of each split be computed, the other side
+     * is derived by subtraction. It pays off for deep trees too, so caching is limited by memory only.
+     * CTR candidates are not counted, hence the margin from the RAM limit.
+     */
+    const ui64 cacheSize = sizeof(TBucketStats) * statsSegmentCount * Max<ui64>(nonCtrBucketCount, 1);
+    const ui64 cacheSizeLimit = Min<ui64>(
+        MaxTreeLevelCacheSize,
+        ParseMemorySizeDescription(params.SystemOptions->CpuUsedRamLimit.Get()) / 4);
+    return cacheSize <= cacheSizeLimit;
 }
 
 bool UseAveragingFoldAsFoldZero(const TLearnContext& ctx) {
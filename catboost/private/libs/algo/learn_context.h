@@ -2,7 +2,9 @@
 
 #include "calc_score_cache.h"
 #include "ctr_helper.h"
+#include "eval_set_sample.h"
 #include "fold.h"
+#include "iteration_arena.h"
 #include "online_ctr.h"
 #include "split.h"
 
@@ -15,15 +17,19 @@
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/metrics/caching_metric.h>
 #include <catboost/libs/model/fwd.h>
 #include <catboost/libs/model/target_classifier.h>
 #include <catboost/private/libs/options/catboost_options.h>
 
 #include <library/cpp/json/json_reader.h>
+#include <library/cpp/threading/future/future.h>
 
 #include <util/generic/noncopyable.h>
+#include <util/generic/hash.h>
 #include <util/generic/hash_set.h>
 #include <util/generic/ptr.h>
+#include <util/thread/pool.h>
 
 
 namespace NPar {
@@ -117,6 +123,7 @@ struct TLearnProgress {
 
     TVector<bool> UsedFeatures;
     TMap<ui32, TVector<bool>> UsedFeaturesPerObject;
+    TVector<double> SplitGainImportance; // [externalFeatureIdx], sum of split gains of features' splits
 
     NCB::TCombinedEstimatedFeaturesContext EstimatedFeaturesContext;
 public:
@@ -136,6 +143,9 @@ public:
         ui32 foldCreationParamsCheckSum,
         const NCatboostOptions::TBinarizationOptions& estimatedFeaturesQuantizationOptions,
 
+        // borders of online estimated features, computed from data if nullptr
+        NCB::TQuantizedFeaturesInfoPtr onlineEstimatedFeaturesQuantizedInfo,
+
         // can be non-empty only if there is single fold
         TMaybe<NCB::TPrecomputedOnlineCtrData> precomputedSingleOnlineCtrDataForSingleFold,
         const NCatboostOptions::TObliviousTreeLearnerOptions& trainOptions,
@@ -195,6 +205,23 @@ public:
 /* Class for storing learn specific data structures like:               */
 /* prng, learn progress and target classifiers                          */
 /************************************************************************/
+// Best scores of float and one-hot features at each depth of previous symmetric trees
+struct TCandidateScoresHistory {
+    struct TScoredCandidate {
+        double Score = 0.0;
+        ui32 Iteration = 0;
+    };
+
+    TVector<THashMap<TSplitEnsemble, TScoredCandidate>> PerDepth; // [depth]
+};
+
+// sizes of the big consumers of CPU RAM in training, in bytes
+struct TCpuRamUsageBreakdown {
+    size_t FoldsDataSize = 0; // approxes, derivatives and pairwise weights
+    size_t OnlineCtrsDataSize = 0;
+    size_t TreeLevelStatsSize = 0;
+};
+
 class TLearnContext : public TCommonContext {
 public:
     TLearnContext(
@@ -215,11 +242,28 @@ public:
         NPar::ILocalExecutor* localExecutor,
         const TString& fileNamesPrefix = "");
 
+    ~TLearnContext();
+
+    /* The snapshot is serialized to memory, and written to the file in a background thread while training
+     * continues. Writing of the previous snapshot is waited for first, so at most one snapshot is kept in memory.
+     */
     void SaveProgress(std::function<void(IOutputStream*)> onSaveSnapshot = [] (IOutputStream* /*snapshot*/) {});
+
+    // rethrows errors of snapshot writing
+    void WaitForSnapshotWriting();
+
     bool TryLoadProgress(std::function<bool(IInputStream*)> onLoadSnapshot = [] (IInputStream* /*snapshot*/) { return true; });
     bool UseTreeLevelCaching() const;
     bool GetHasWeights() const;
 
+    TCpuRamUsageBreakdown GetCpuRamUsageBreakdown() const;
+
+    /* If RSS exceeds used_ram_limit, caches that are recomputed on demand are dropped:
+     * stats of the previous tree level (tree level caching is not used afterwards) and online CTRs of
+     * feature combinations. The breakdown of the big consumers is reported once.
+     */
+    void EnforceCpuRamLimit();
+
 public:
     THolder<TLearnProgress> LearnProgress;
     NCatboostOptions::TOutputFilesOptions OutputOptions;
@@ -228,18 +272,32 @@ public:
     TCalcScoreFold SmallestSplitSideDocs;
     TCalcScoreFold SampledDocs;
     TBucketStatsCache PrevTreeLevelStats;
+    TCandidateScoresHistory CandidateScoresHistory;
     TProfileInfo Profile;
 
     NCB::TScratchCache ScratchCache;
+    // released at the start of each iteration
+    TIterationArena IterationArena;
+
+    // samples of eval sets for metrics on intermediate iterations, Nothing if whole eval set is used
+    TVector<TMaybe<TEvalSetSample>> EvalSetSamples; // [testIdx]
+
+    // per-block partial values of additive learn metrics, blocks with unchanged approxes are not reevaluated
+    TAdditiveMetricsState LearnAdditiveMetricsState;
 
 private:
     bool UseTreeLevelCachingFlag;
     bool HasWeights;
+    bool CpuRamLimitExceededReported = false;
+
+    THolder<TThreadPool> SnapshotWritingThread; // started on the first snapshot
+    NThreading::TFuture<void> SnapshotWriting;
 };
 
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
-    ui32 approxDimension);
+    ui32 approxDimension,
+    ui32 nonCtrBucketCount);
 
 bool UseAveragingFoldAsFoldZero(const TLearnContext& ctx);
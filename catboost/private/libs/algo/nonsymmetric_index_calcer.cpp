@@ -44,6 +44,7 @@ std::function<bool(ui32)> BuildNodeSplitFunction(
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
     TMaybe<TFeaturesGroupIndex> maybeFeaturesGroupIndex,
     TConstArrayRef<TExclusiveFeaturesBundle> exclusiveFeaturesBundlesMetaData,
+    TConstArrayRef<TFeaturesGroup> featuresGroupsMetaData,
     const TColumn& column,
     std::function<const IExclusiveFeatureBundleArray*(ui32)>&& getExclusiveFeaturesBundle,
     std::function<const IBinaryPacksArray*(ui32)>&& getBinaryFeaturesPack,
@@ -78,8 +79,10 @@ std::function<bool(ui32)> BuildNodeSplitFunction(
     } else if (maybeFeaturesGroupIndex) {
         return buildNodeSplitFunction(
             *getFeaturesGroup(maybeFeaturesGroupIndex->GroupIdx),
-            [partIdx = maybeFeaturesGroupIndex->InGroupIdx, cmpOp = std::move(cmpOp)] (const auto& featuresGroupValue) {
-                return cmpOp(GetPartValueFromGroup(featuresGroupValue, partIdx));
+            [partIdx = maybeFeaturesGroupIndex->InGroupIdx,
+             partBitCount = featuresGroupsMetaData[maybeFeaturesGroupIndex->GroupIdx].PartBitCount,
+             cmpOp = std::move(cmpOp)] (const auto& featuresGroupValue) {
+                return cmpOp(GetPartValueFromGroup(featuresGroupValue, partIdx, partBitCount));
             });
     } else {
         return buildNodeSplitFunction(column, std::move(cmpOp));
@@ -113,6 +116,7 @@ std::function<bool(ui32)> BuildNodeSplitFunction(
                 maybeBinaryIndex,
                 maybeFeaturesGroupIndex,
                 objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+                objectsDataProvider.GetFeaturesGroupsMetaData(),
                 column,
                 [&] (ui32 bundleIdx) {
                     return &objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx);
@@ -153,62 +157,6 @@ std::function<bool(ui32)> BuildNodeSplitFunction(
     }
 }
 
-void UpdateIndices(
-    const TSplitNode& node,
-    const TTrainingDataProviders& trainingData,
-    const TIndexedSubset<ui32>& docsSubset,
-    const TFold& fold,
-    NPar::ILocalExecutor* localExecutor,
-    TArrayRef<TIndexType> indicesRef
-) {
-    TQuantizedObjectsDataProviderPtr objectsDataProvider;
-    const ui32* columnsIndexing;
-    TIndexedSubsetCache indexedSubsetCache; // not really updated because it is used for test only
-    GetObjectsDataAndIndexing(
-        trainingData,
-        fold,
-        node.Split.Type == ESplitType::EstimatedFeature,
-        node.Split.IsOnline(),
-        /*objectSubsetIdx*/ 0, // 0 - learn
-        &indexedSubsetCache,
-        localExecutor,
-        &objectsDataProvider,
-        &columnsIndexing // can return nullptr
-    );
-
-    auto func = BuildNodeSplitFunction(
-        node,
-        *objectsDataProvider,
-        node.Split.Type == ESplitType::OnlineCtr ? &fold.GetCtrs(node.Split.Ctr.Projection) : nullptr,
-        /*datasetIdx*/ 0);
-
-    // TODO(ilyzhin) std::function is very slow for calling many times (maybe replace it with lambda)
-    std::function<bool(ui32)> splitFunction;
-    if (!columnsIndexing) {
-        splitFunction = std::move(func);
-    } else {
-        splitFunction = [realObjIdx = columnsIndexing, func=std::move(func)](ui32 idx) {
-            return func(realObjIdx[idx]);
-        };
-    }
-
-    const size_t blockSize = Max<size_t>(CeilDiv<size_t>(docsSubset.size(), localExecutor->GetThreadCount() + 1), 1000);
-    const TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange<size_t>(docsSubset.size()), blockSize);
-    const int blockCount = rangesGenerator.RangesCount();
-    TConstArrayRef<ui32> docsSubsetRef(docsSubset);
-    localExecutor->ExecRange(
-        [&node, indicesRef, splitFunction, docsSubsetRef, &rangesGenerator](int blockId) {
-            for (auto idx : rangesGenerator.GetRange(blockId).Iter()) {
-                const int objIdx = docsSubsetRef[idx];
-                indicesRef[docsSubsetRef[idx]] = (~node.Left) + splitFunction(objIdx) * ((~node.Right) - (~node.Left));
-            }
-        },
-        0,
-        blockCount,
-        NPar::TLocalExecutor::WAIT_COMPLETE
-    );
-}
-
 void UpdateIndicesWithSplit(
     const TSplitNode& node,
     const TTrainingDataProviders& trainingData,
@@ -254,35 +202,21 @@ void UpdateIndicesWithSplit(
     const size_t blockSize = Max<size_t>(CeilDiv<size_t>(docSize, localExecutor->GetThreadCount() + 1), 1000);
     const TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange<size_t>(docSize), blockSize);
     const int blockCount = rangesGenerator.RangesCount();
+    const TIndexType rightChildIdx = ~node.Right;
     TVector<size_t> leftCounts(blockCount + 1, 0);
     TVector<size_t> rightCounts(blockCount + 1, 0);
-    TVector<TVector<ui32>> localLefts(blockCount);
-    TVector<TVector<ui32>> localRights(blockCount);
 
+    // the split is evaluated once and stored to indices, the partition is done from them
     localExecutor->ExecRange(
-        [&node, indicesRef, splitFunction, &docsSubsetPtr, &rangesGenerator, &leftCounts, &rightCounts, &localLefts, &localRights](int blockId) {
-            const ui32* docsSubsetLocal = docsSubsetPtr;
-            const size_t rangeSize = rangesGenerator.GetRange(blockId).GetSize();
-            localLefts[blockId].yresize(rangeSize);
-            localRights[blockId].yresize(rangeSize);
-
-            TArrayRef<ui32> localLeftsRef(localLefts[blockId]);
-            TArrayRef<ui32> localRightsRef(localRights[blockId]);
-            size_t nLeftCount = 0;
+        [&node, indicesRef, splitFunction, docsSubsetPtr, &rangesGenerator, &rightCounts](int blockId) {
+            const auto range = rangesGenerator.GetRange(blockId);
             size_t nRightCount = 0;
-            for (auto idx : rangesGenerator.GetRange(blockId).Iter()) {
-                const ui32 objIdx = *(docsSubsetLocal + idx);
+            for (auto idx : range.Iter()) {
+                const ui32 objIdx = docsSubsetPtr[idx];
                 const bool split = splitFunction(objIdx);
                 indicesRef[objIdx] = (~node.Left) + split * ((~node.Right) - (~node.Left));
-                if (split) {
-                    localRightsRef[nRightCount] = objIdx;
-                    ++nRightCount;
-                } else {
-                    localLeftsRef[nLeftCount] = objIdx;
-                    ++nLeftCount;
-                }
+                nRightCount += split;
             }
-            leftCounts[blockId + 1] = nLeftCount;
             rightCounts[blockId + 1] = nRightCount;
         },
         0,
@@ -291,37 +225,42 @@ void UpdateIndicesWithSplit(
     );
 
     for (int i = 1; i < blockCount + 1; ++i) {
-        leftCounts[i] += leftCounts[i - 1];
+        leftCounts[i] = leftCounts[i - 1] + rangesGenerator.GetRange(i - 1).GetSize() - rightCounts[i];
         rightCounts[i] += rightCounts[i - 1];
     }
 
     const size_t nLeftCount = leftCounts[blockCount];
     const size_t nRightCount = rightCounts[blockCount];
 
-    leftIndices->yresize(nLeftCount);
-    rightIndices->yresize(nRightCount);
-    TArrayRef<ui32> leftIndicesRef(*leftIndices);
-    TArrayRef<ui32> rightIndicesRef(*rightIndices);
+    // docsSubset can be the same object as leftIndices, so its partition is written to separate storage
+    TIndexedSubset<ui32> leftSubset;
+    TIndexedSubset<ui32> rightSubset;
+    leftSubset.yresize(nLeftCount);
+    rightSubset.yresize(nRightCount);
+    TArrayRef<ui32> leftIndicesRef(leftSubset);
+    TArrayRef<ui32> rightIndicesRef(rightSubset);
 
+    // stable partition: docs of each child keep the order of docsSubset
     localExecutor->ExecRange(
-        [leftIndicesRef, rightIndicesRef, &leftCounts, &rightCounts, &localLefts, &localRights] (int blockId) {
-            size_t leftStart = leftCounts[blockId];
-            size_t rightStart = rightCounts[blockId];
-            const size_t leftSize = leftCounts[blockId + 1] - leftStart;
-            const size_t rightSize = rightCounts[blockId + 1] - rightStart;
-            TConstArrayRef<ui32> localLeftsRef(localLefts[blockId].data(), leftSize);
-            TConstArrayRef<ui32> localRightsRef(localRights[blockId].data(), rightSize);
-            for (size_t j = 0; j < leftSize; ++j) {
-                leftIndicesRef[leftStart++] = localLeftsRef[j];
-            }
-            for (size_t j = 0; j < rightSize; ++j) {
-                rightIndicesRef[rightStart++] = localRightsRef[j];
+        [indicesRef, docsSubsetPtr, rightChildIdx, leftIndicesRef, rightIndicesRef, &rangesGenerator, &leftCounts, &rightCounts] (int blockId) {
+            size_t leftPosition = leftCounts[blockId];
+            size_t rightPosition = rightCounts[blockId];
+            for (auto idx : rangesGenerator.GetRange(blockId).Iter()) {
+                const ui32 objIdx = docsSubsetPtr[idx];
+                if (indicesRef[objIdx] == rightChildIdx) {
+                    rightIndicesRef[rightPosition++] = objIdx;
+                } else {
+                    leftIndicesRef[leftPosition++] = objIdx;
+                }
             }
         },
         0,
         blockCount,
         NPar::TLocalExecutor::WAIT_COMPLETE
     );
+
+    *leftIndices = std::move(leftSubset);
+    *rightIndices = std::move(rightSubset);
 }
 
 void BuildIndicesForDataset(
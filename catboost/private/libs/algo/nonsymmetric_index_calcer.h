@@ -17,6 +17,8 @@ namespace NPar {
 }
 
 
+// sets indices of docs from docsSubset to node children and stably partitions docsSubset between them,
+// leftIndices can point to docsSubset
 void UpdateIndicesWithSplit(
     const TSplitNode& node,
     const NCB::TTrainingDataProviders& trainingData,
@@ -28,15 +30,6 @@ void UpdateIndicesWithSplit(
     NCB::TIndexedSubset<ui32>* rightIndices
 );
 
-void UpdateIndices(
-    const TSplitNode& node,
-    const NCB::TTrainingDataProviders& trainingData,
-    const NCB::TIndexedSubset<ui32>& docsSubset,
-    const TFold& fold,
-    NPar::ILocalExecutor* localExecutor,
-    TArrayRef<TIndexType> indices
-);
-
 void BuildIndicesForDataset(
     const TNonSymmetricTreeStructure& tree,
     const NCB::TTrainingDataProviders& trainingData,
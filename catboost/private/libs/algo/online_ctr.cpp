@@ -10,12 +10,16 @@
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
+#include <catboost/libs/logging/profile_trace.h>
 #include <catboost/libs/model/ctr_value_table.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/model/sketch_ctr_provider.h>
 
 #include <library/cpp/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/bitops.h>
+#include <util/generic/cast.h>
 #include <util/generic/scope.h>
 #include <util/generic/utility.h>
 #include <util/generic/variant.h>
@@ -29,6 +33,31 @@
 using namespace NCB;
 
 
+size_t TOnlineCtrPerProjectionData::GetFeatureDataSize() const {
+    size_t dataSize = 0;
+    for (const auto& ctrData : Feature) {
+        for (auto targetBorderIdx : xrange(ctrData.GetYSize())) {
+            for (auto priorIdx : xrange(ctrData.GetXSize())) {
+                dataSize += ctrData[targetBorderIdx][priorIdx].size();
+            }
+        }
+    }
+    return dataSize;
+}
+
+
+bool TOwnedOnlineCtr::UseProjectionData(const TProjection& projection) {
+    auto& projectionData = Data.at(projection);
+    projectionData.LastUseGeneration = Generation;
+    if (projectionData.Feature.empty()) {
+        ++MissCount;
+        return true;
+    }
+    ++HitCount;
+    return false;
+}
+
+
 void TOwnedOnlineCtr::DropEmptyData() {
     TVector<TProjection> emptyProjections;
     for (auto& projCtr : Data) {
@@ -42,6 +71,56 @@ void TOwnedOnlineCtr::DropEmptyData() {
 }
 
 
+void TOwnedOnlineCtr::TrimData(size_t maxProjectionCount, size_t maxDataSize) {
+    struct TUsedData {
+        ui32 LastUseGeneration;
+        size_t DataSize;
+        const TProjection* Projection;
+    };
+
+    TVector<TUsedData> usedData;
+    size_t dataSize = 0;
+    for (const auto& [projection, projectionData] : Data) {
+        if (!projectionData.Feature.empty()) {
+            usedData.push_back({projectionData.LastUseGeneration, projectionData.GetFeatureDataSize(), &projection});
+            dataSize += usedData.back().DataSize;
+        }
+    }
+    SortBy(usedData, [] (const TUsedData& data) { return std::make_pair(data.LastUseGeneration, -(i64)data.DataSize); });
+
+    TVector<TProjection> evictedProjections;
+    size_t projectionCount = usedData.size();
+    for (const auto& data : usedData) {
+        if ((projectionCount <= maxProjectionCount) && (dataSize <= maxDataSize)) {
+            break;
+        }
+        evictedProjections.push_back(*data.Projection);
+        --projectionCount;
+        dataSize -= data.DataSize;
+    }
+    for (const auto& projection : evictedProjections) {
+        Data.erase(projection);
+    }
+    ++Generation;
+}
+
+
+size_t TOwnedOnlineCtr::GetDataSize() const {
+    size_t dataSize = 0;
+    for (const auto& [projection, projectionData] : Data) {
+        dataSize += projectionData.GetFeatureDataSize();
+    }
+    return dataSize;
+}
+
+
+double TOwnedOnlineCtr::GetHitRate() const {
+    const ui64 hitCount = HitCount;
+    const ui64 useCount = hitCount + MissCount;
+    return useCount ? double(hitCount) / useCount : 0.0;
+}
+
+
 TConstArrayRef<ui8> TPrecomputedOnlineCtr::GetData(const TCtr& ctr, ui32 datasetIdx) const {
     Y_ASSERT(ctr.Projection.IsSingleCatFeature());
     const TOnlineCtrIdx onlineCtrIdx{
@@ -141,45 +220,41 @@ namespace {
     };
 }
 
-static void CalcOnlineCTRClasses(
-    const TVector<size_t>& testOffsets,
+// CTRs of dataset docs from running counts of values, which are updated by learn docs
+static void CalcOnlineCTRClassesForDocs(
     TConstArrayRef<ui64> enumeratedCatFeatures,
-    size_t leafCount,
-    const TVector<int>& permutedTargetClass,
-    int targetClassesCount,
+    TConstArrayRef<int> permutedTargetClass, // empty for test docs
     int targetBorderCount,
-    const TVector<float>& priors,
+    TConstArrayRef<float> priors,
+    TConstArrayRef<float> shift,
+    TConstArrayRef<float> norm,
     int ctrBorderCount,
     ECtrType ctrType,
     ui32 ctrIdx,
-    NCB::TScratchCache* scratchCache,
+    int datasetIdx,
+    int datasetDocOffset,
+    TBucketsView* bv,
     IOnlineCtrProjectionDataWriter* writer) {
 
-    TVector<float> shift;
-    TVector<float> norm;
-    CalcNormalization(priors, &shift, &norm);
-
     // ensure blocks have reasonable size
     const int blockSize = (1000 + targetBorderCount - 1) / targetBorderCount + 100;
     TVector<int> totalCountByDoc(blockSize);
     TVector<TVector<int>> goodCountByBorderByDoc(targetBorderCount, TVector<int>(blockSize));
-    TBucketsView bv(leafCount, targetClassesCount, scratchCache);
 
-    auto calcGoodCounts = [&](int blockStart, int nextBlockStart, int datasetIdx) {
-        auto docOffset = datasetIdx ? testOffsets[datasetIdx - 1] : 0;
+    auto calcGoodCounts = [&](int blockStart, int nextBlockStart, int /*datasetIdx*/) {
         for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-            const auto elemId = enumeratedCatFeatures[docOffset + docId];
+            const auto elemId = enumeratedCatFeatures[docId];
 
-            int goodCount = totalCountByDoc[docId - blockStart] = bv.GetTotal(elemId);
-            auto bordersData = bv.GetBorders(elemId);
+            int goodCount = totalCountByDoc[docId - blockStart] = bv->GetTotal(elemId);
+            auto bordersData = bv->GetBorders(elemId);
             for (int border = 0; border < targetBorderCount; ++border) {
                 UpdateGoodCount(bordersData[border], ctrType, &goodCount);
                 goodCountByBorderByDoc[border][docId - blockStart] = goodCount;
             }
 
-            if (datasetIdx == 0) {
+            if (!permutedTargetClass.empty()) {
                 ++bordersData[permutedTargetClass[docId]];
-                ++bv.GetTotal(elemId);
+                ++bv->GetTotal(elemId);
             }
         }
     };
@@ -187,30 +262,142 @@ static void CalcOnlineCTRClasses(
     auto calcCTRs = [&](int blockStart, int nextBlockStart, int datasetIdx) {
         for (int border = 0; border < targetBorderCount; ++border) {
             for (int prior = 0; prior < priors.ysize(); ++prior) {
-                const float priorX = priors[prior];
-                const float shiftX = shift[prior];
-                const float normX = norm[prior];
-                const int* goodCountData = goodCountByBorderByDoc[border].data();
                 ui8* featureData = writer->GetDataBuffer(ctrIdx, border, prior, datasetIdx).data();
-                for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-                    featureData[docId] = CalcCTR(
-                        goodCountData[docId - blockStart],
-                        totalCountByDoc[docId - blockStart],
-                        priorX,
-                        shiftX,
-                        normX,
-                        ctrBorderCount);
-                }
+                CalcCTRs(
+                    MakeConstArrayRef(goodCountByBorderByDoc[border]).first(nextBlockStart - blockStart),
+                    MakeConstArrayRef(totalCountByDoc).first(nextBlockStart - blockStart),
+                    priors[prior],
+                    shift[prior],
+                    norm[prior],
+                    ctrBorderCount,
+                    MakeArrayRef(
+                        featureData + datasetDocOffset + blockStart,
+                        featureData + datasetDocOffset + nextBlockStart));
             }
         }
     };
 
     TBlockedCalcer calcer(blockSize);
-    const size_t learnSampleCount = testOffsets[0];
-    calcer.Calc(calcGoodCounts, calcCTRs, 0, learnSampleCount);
+    calcer.Calc(calcGoodCounts, calcCTRs, datasetIdx, enumeratedCatFeatures.size());
+}
+
+/* Learn docs are split into blocks which are processed in parallel, each block starts from counts
+ * of values in the previous blocks. These are computed by parallel counting in blocks followed by
+ * prefix sums over blocks. Per block counts take as much memory as counts of all values, so blocks
+ * are not smaller than this size.
+ */
+static void CalcOnlineCTRClasses(
+    const TVector<size_t>& testOffsets,
+    TConstArrayRef<ui64> enumeratedCatFeatures,
+    size_t leafCount,
+    const TVector<int>& permutedTargetClass,
+    int targetClassesCount,
+    int targetBorderCount,
+    const TVector<float>& priors,
+    int ctrBorderCount,
+    ECtrType ctrType,
+    ui32 ctrIdx,
+    NPar::ILocalExecutor* localExecutor,
+    NCB::TScratchCache* scratchCache,
+    IOnlineCtrProjectionDataWriter* writer) {
+
+    TVector<float> shift;
+    TVector<float> norm;
+    CalcNormalization(priors, &shift, &norm);
+
+    const int learnSampleCount = testOffsets[0];
+    const size_t countsSize = leafCount * (targetClassesCount + 1);
+    const size_t maxBlockCount = Max<size_t>(1, learnSampleCount / Max<size_t>(countsSize, 1));
+    NPar::ILocalExecutor::TExecRangeParams ctrParallelizationParams(0, learnSampleCount);
+    ctrParallelizationParams.SetBlockCount(Min<size_t>(localExecutor->GetThreadCount() + 1, maxBlockCount));
+    const int bigBlockCount = ctrParallelizationParams.GetBlockCount();
+    const int bigBlockSize = ctrParallelizationParams.GetBlockSize();
+
+    TVector<THolder<TBucketsView>> perBlockBuckets(bigBlockCount);
+    for (auto& blockBuckets : perBlockBuckets) {
+        blockBuckets = MakeHolder<TBucketsView>(leafCount, targetClassesCount, scratchCache);
+    }
+    TBucketsView learnBuckets(leafCount, targetClassesCount, scratchCache);
+
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const int blockStart = bigBlockSize * blockIdx;
+            const int nextBlockStart = Min(blockStart + bigBlockSize, learnSampleCount);
+            TBucketsView& blockBuckets = *perBlockBuckets[blockIdx];
+            for (int docIdx : xrange(blockStart, nextBlockStart)) {
+                const auto elemId = enumeratedCatFeatures[docIdx];
+                ++blockBuckets.GetBorders(elemId)[permutedTargetClass[docIdx]];
+                ++blockBuckets.GetTotal(elemId);
+            }
+        },
+        0,
+        bigBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    // counts in blocks are replaced by counts before blocks, totals are counts of all learn docs
+    NPar::ILocalExecutor::TExecRangeParams countsBlockParams(0, SafeIntegerCast<int>(countsSize));
+    countsBlockParams.SetBlockSize(1000);
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const int blockStart = countsBlockParams.GetBlockSize() * blockIdx;
+            const int nextBlockStart = Min<int>(blockStart + countsBlockParams.GetBlockSize(), countsSize);
+            TArrayRef<int> learnCounts = learnBuckets.Data;
+            for (int idx : xrange(blockStart, nextBlockStart)) {
+                int runningCount = 0;
+                for (auto& blockBuckets : perBlockBuckets) {
+                    const int blockCount = blockBuckets->Data[idx];
+                    blockBuckets->Data[idx] = runningCount;
+                    runningCount += blockCount;
+                }
+                learnCounts[idx] = runningCount;
+            }
+        },
+        0,
+        countsBlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    localExecutor->ExecRange(
+        [&] (int blockIdx) {
+            const int blockStart = bigBlockSize * blockIdx;
+            const int nextBlockStart = Min(blockStart + bigBlockSize, learnSampleCount);
+            CalcOnlineCTRClassesForDocs(
+                enumeratedCatFeatures.subspan(blockStart, nextBlockStart - blockStart),
+                MakeConstArrayRef(permutedTargetClass).subspan(blockStart, nextBlockStart - blockStart),
+                targetBorderCount,
+                priors,
+                shift,
+                norm,
+                ctrBorderCount,
+                ctrType,
+                ctrIdx,
+                /*datasetIdx*/ 0,
+                blockStart,
+                perBlockBuckets[blockIdx].Get(),
+                writer);
+        },
+        0,
+        bigBlockCount,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
     for (size_t testIdx = 0; testIdx < testOffsets.size() - 1; ++testIdx) {
         const size_t testSampleCount = testOffsets[testIdx + 1] - testOffsets[testIdx];
-        calcer.Calc(calcGoodCounts, calcCTRs, testIdx + 1, testSampleCount);
+        CalcOnlineCTRClassesForDocs(
+            enumeratedCatFeatures.subspan(testOffsets[testIdx], testSampleCount),
+            /*permutedTargetClass*/ {},
+            targetBorderCount,
+            priors,
+            shift,
+            norm,
+            ctrBorderCount,
+            ctrType,
+            ctrIdx,
+            testIdx + 1,
+            /*datasetDocOffset*/ 0,
+            &learnBuckets,
+            writer);
     }
 }
 
@@ -225,6 +412,7 @@ static void CalcStatsForEachBlock(
     const int blockSize = ctrParallelizationParams.GetBlockSize();
     localExecutor->ExecRange(
         [&] (int blockIdx) {
+            CB_PROFILE_TRACE_SCOPE("CalcStatsForEachBlock");
             const int blockStart = blockSize * blockIdx;
             const int nextBlockStart = Min(blockStart + blockSize, ctrParallelizationParams.LastId);
             TArrayRef<TCtrHistory> blockCtrsRef(perBlockCtrs[blockIdx]);
@@ -249,6 +437,7 @@ static void SumCtrsFromBlocks(
     const int blockSize = valueBlockParams.GetBlockSize();
     localExecutor->ExecRange(
         [&] (int blockIdx) {
+            CB_PROFILE_TRACE_SCOPE("SumCtrsFromBlocks");
             const int blockStart = blockIdx * blockSize;
             const int nextBlockStart = Min<int>(blockStart + blockSize, valueBlockParams.LastId);
             Fill(ctrs.data() + blockStart, ctrs.data() + nextBlockStart, TCtrHistory{0, 0});
@@ -290,6 +479,7 @@ static void CalcQuantizedCtrs(
     const int docCount = ctrParallelizationParams.LastId;
     localExecutor->ExecRange(
         [&] (int blockIdx) {
+            CB_PROFILE_TRACE_SCOPE("CalcQuantizedCtrs");
             const TArrayRef<TCtrHistory> ctrArrSimple(perBlockCtrs[blockIdx]);
             auto totalCountPtr = scratchCache->GetScratchBlob();
             Y_DEFER { scratchCache->ReleaseScratchBlob(totalCountPtr); };
@@ -317,15 +507,14 @@ static void CalcQuantizedCtrs(
                         /*targetBorderIdx*/ 0,
                         priorIdx,
                         datasetIdx).data();
-                    for (auto docIdx : xrange(blockStart, nextBlockStart)) {
-                        featureData[docOffset + docIdx] = CalcCTR(
-                            goodCount[docIdx - blockStart],
-                            totalCount[docIdx - blockStart],
-                            prior,
-                            shift,
-                            norm,
-                            borderCount);
-                    }
+                    CalcCTRs(
+                        TConstArrayRef<int>(goodCount, nextBlockStart - blockStart),
+                        TConstArrayRef<int>(totalCount.data(), nextBlockStart - blockStart),
+                        prior,
+                        shift,
+                        norm,
+                        borderCount,
+                        MakeArrayRef(featureData + docOffset + blockStart, featureData + docOffset + nextBlockStart));
                 }
             };
 
@@ -414,15 +603,14 @@ static void CalcOnlineCTRSimple(
                 /*targetBorderIdx*/ 0,
                 priorIdx,
                 datasetIdx).data();
-            for (int docIdx : xrange(blockStart, nextBlockStart)) {
-                featureData[docIdx] = CalcCTR(
-                    goodCount[docIdx - blockStart],
-                    totalCount[docIdx - blockStart],
-                    prior,
-                    shift,
-                    norm,
-                    ctrBorderCount);
-            }
+            CalcCTRs(
+                TConstArrayRef<int>(goodCount, nextBlockStart - blockStart),
+                TConstArrayRef<int>(totalCount.data(), nextBlockStart - blockStart),
+                prior,
+                shift,
+                norm,
+                ctrBorderCount,
+                MakeArrayRef(featureData + blockStart, featureData + nextBlockStart));
         }
     };
 
@@ -479,15 +667,14 @@ static void CalcOnlineCTRMean(
                 /*targetBorderIdx*/ 0,
                 prior,
                 datasetIdx).data();
-            for (int docId = blockStart; docId < nextBlockStart; ++docId) {
-                featureData[docId] = CalcCTR(
-                    sum[docId - blockStart],
-                    count[docId - blockStart],
-                    priorX,
-                    shiftX,
-                    normX,
-                    ctrBorderCount);
-            }
+            CalcCTRs(
+                MakeConstArrayRef(sum).first(nextBlockStart - blockStart),
+                MakeConstArrayRef(count).first(nextBlockStart - blockStart),
+                priorX,
+                shiftX,
+                normX,
+                ctrBorderCount,
+                MakeArrayRef(featureData + blockStart, featureData + nextBlockStart));
         }
     };
 
@@ -572,6 +759,19 @@ static inline void CountOnlineCTRTotal(
     }
 }
 
+// Online CTRs of sketch mode are calculated on the first row of count-min sketch used in the final model
+static void MapHashesToCtrSketchColumns(ui32 width, NPar::ILocalExecutor* localExecutor, TArrayRef<ui64> hashes) {
+    localExecutor->ExecRangeBlockedWithThrow(
+        [=] (int idx) {
+            // zero is the empty key of reindex hash
+            hashes[idx] = GetCtrSketchColumn(hashes[idx], /*row*/ 0, width) + 1;
+        },
+        0,
+        SafeIntegerCast<int>(hashes.size()),
+        /*batchSizeOrZeroForAutoBatchSize*/ 0,
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
 template <typename TValueType>
 static void CopyCatColumnToHash(
     const IQuantizedCatValuesHolder& catColumn,
@@ -620,45 +820,29 @@ void ComputeOnlineCTRs(
     auto hashArrPtr = scratchCache->GetScratchBlob();
     Y_DEFER { scratchCache->ReleaseScratchBlob(hashArrPtr); };
     auto hashArr = NCB::GrowScratchBlob<ui64>(totalSampleCount, hashArrPtr.Get());
-    auto rehashHashVal = scratchCache->GetScratchHash();
-    Y_DEFER { scratchCache->ReleaseScratchHash(rehashHashVal); };
-
-    if (proj.IsSingleCatFeature()) {
-        // Shortcut for simple ctrs
-        auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
+    ui64 topSize = catFeatureParams.CtrLeafCountLimit;
+    if (proj.IsSingleCatFeature() && catFeatureParams.StoreAllSimpleCtrs) {
+        topSize = Max<ui64>();
+    }
+    /* Combinations of feature values are numbered densely instead of hashing if the reindex of all of them
+     * is not larger than hashes of objects. All combinations are kept, so it is not used if their number is limited.
+     */
+    const TMaybe<ui64> combinationIdsCount = proj.IsSingleCatFeature()
+        ? Nothing()
+        : CalcCombinationIdsCount(proj, quantizedFeaturesInfo, totalSampleCount);
+    const ui32 ctrSketchWidth = catFeatureParams.CtrSketchWidth;
+    const bool useCombinationIds
+        = combinationIdsCount && !ctrSketchWidth
+            && ((topSize > learnSampleCount) || (*combinationIdsCount <= topSize));
 
-        TArrayRef<ui64> hashArrView(hashArr);
-        if (learnSampleCount > 0) {
-            CopyCatColumnToHash(
-                **data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx),
-                foldLearnPermutationFeaturesSubset,
-                localExecutor,
-                hashArrView.data()
-            );
-        }
-        for (size_t docOffset = learnSampleCount, testIdx = 0;
-             docOffset < totalSampleCount && testIdx < data.Test.size();
-             ++testIdx)
-        {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            CopyCatColumnToHash(
-                **data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx),
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                localExecutor,
-                hashArrView.data() + docOffset
-            );
-            docOffset += testSampleCount;
-        }
-        rehashHashVal->MakeEmpty(
-            quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
-        );
-    } else {
+    TOnlineCtrUniqValuesCounts uniqValuesCounts;
+    size_t leafCount = 0;
+    if (useCombinationIds) {
         ParallelFill<ui64>(/*fillValue*/0, /*blockSize*/Nothing(), localExecutor, MakeArrayRef(hashArr));
-        CalcHashes(
+        CalcCombinationIds(
             proj,
             *data.Learn->ObjectsData,
             foldLearnPermutationFeaturesSubset,
-            nullptr,
             hashArr.begin(),
             hashArr.begin() + learnSampleCount,
             localExecutor);
@@ -667,48 +851,112 @@ void ComputeOnlineCTRs(
              ++testIdx)
         {
             const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            CalcHashes(
+            CalcCombinationIds(
                 proj,
                 *data.Test[testIdx]->ObjectsData,
                 data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                nullptr,
                 hashArr.begin() + docOffset,
                 hashArr.begin() + docOffset + testSampleCount,
                 localExecutor);
             docOffset += testSampleCount;
         }
+        auto reindexPtr = scratchCache->GetScratchBlob();
+        Y_DEFER { scratchCache->ReleaseScratchBlob(reindexPtr); };
+        auto reindex = NCB::GrowScratchBlob<ui32>(*combinationIdsCount, reindexPtr.Get());
+        ParallelFill(Max<ui32>(), /*blockSize*/Nothing(), localExecutor, reindex);
+        leafCount = UpdateDenseReindex(reindex, /*reindexedCount*/ 0, hashArr.begin(), hashArr.begin() + learnSampleCount);
+        uniqValuesCounts.CounterCount = uniqValuesCounts.Count = leafCount;
+        leafCount = UpdateDenseReindex(reindex, leafCount, hashArr.begin() + learnSampleCount, hashArr.end());
+    } else {
+        auto rehashHashVal = scratchCache->GetScratchHash();
+        Y_DEFER { scratchCache->ReleaseScratchHash(rehashHashVal); };
         size_t approxBucketsCount = 1;
-        for (auto cf : proj.CatFeatures) {
-            approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
-            if (approxBucketsCount > learnSampleCount) {
-                break;
+
+        if (proj.IsSingleCatFeature()) {
+            // Shortcut for simple ctrs
+            auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
+
+            TArrayRef<ui64> hashArrView(hashArr);
+            if (learnSampleCount > 0) {
+                CopyCatColumnToHash(
+                    **data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx),
+                    foldLearnPermutationFeaturesSubset,
+                    localExecutor,
+                    hashArrView.data()
+                );
+            }
+            for (size_t docOffset = learnSampleCount, testIdx = 0;
+                 docOffset < totalSampleCount && testIdx < data.Test.size();
+                 ++testIdx)
+            {
+                const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+                CopyCatColumnToHash(
+                    **data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx),
+                    data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                    localExecutor,
+                    hashArrView.data() + docOffset
+                );
+                docOffset += testSampleCount;
             }
+            approxBucketsCount
+                = quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly;
+        } else {
+            ParallelFill<ui64>(/*fillValue*/0, /*blockSize*/Nothing(), localExecutor, MakeArrayRef(hashArr));
+            CalcHashes(
+                proj,
+                *data.Learn->ObjectsData,
+                foldLearnPermutationFeaturesSubset,
+                nullptr,
+                hashArr.begin(),
+                hashArr.begin() + learnSampleCount,
+                localExecutor);
+            for (size_t docOffset = learnSampleCount, testIdx = 0;
+                 docOffset < totalSampleCount && testIdx < data.Test.size();
+                 ++testIdx)
+            {
+                const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+                CalcHashes(
+                    proj,
+                    *data.Test[testIdx]->ObjectsData,
+                    data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                    nullptr,
+                    hashArr.begin() + docOffset,
+                    hashArr.begin() + docOffset + testSampleCount,
+                    localExecutor);
+                docOffset += testSampleCount;
+            }
+            for (auto cf : proj.CatFeatures) {
+                approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
+                if (approxBucketsCount > learnSampleCount) {
+                    break;
+                }
+            }
+            approxBucketsCount = Min(learnSampleCount, approxBucketsCount);
         }
-        rehashHashVal->MakeEmpty(Min(learnSampleCount, approxBucketsCount));
-    }
-    ui64 topSize = catFeatureParams.CtrLeafCountLimit;
-    if (proj.IsSingleCatFeature() && catFeatureParams.StoreAllSimpleCtrs) {
-        topSize = Max<ui64>();
-    }
-    auto leafCount = ComputeReindexHash(
-        topSize,
-        rehashHashVal.Get(),
-        hashArr.begin(),
-        hashArr.begin() + learnSampleCount);
+        if (ctrSketchWidth) {
+            MapHashesToCtrSketchColumns(ctrSketchWidth, localExecutor, hashArr);
+            approxBucketsCount = Min<size_t>(approxBucketsCount, ctrSketchWidth);
+        }
+        rehashHashVal->MakeEmpty(approxBucketsCount);
+        leafCount = ComputeReindexHash(
+            topSize,
+            rehashHashVal.Get(),
+            hashArr.begin(),
+            hashArr.begin() + learnSampleCount);
 
-    TOnlineCtrUniqValuesCounts uniqValuesCounts;
-    uniqValuesCounts.CounterCount = uniqValuesCounts.Count = leafCount;
+        uniqValuesCounts.CounterCount = uniqValuesCounts.Count = leafCount;
 
-    for (size_t docOffset = learnSampleCount, testIdx = 0;
-         docOffset < totalSampleCount && testIdx < data.Test.size();
-         ++testIdx)
-    {
-        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-        leafCount = UpdateReindexHash(
-            rehashHashVal.Get(),
-            hashArr.begin() + docOffset,
-            hashArr.begin() + docOffset + testSampleCount);
-        docOffset += testSampleCount;
+        for (size_t docOffset = learnSampleCount, testIdx = 0;
+             docOffset < totalSampleCount && testIdx < data.Test.size();
+             ++testIdx)
+        {
+            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+            leafCount = UpdateReindexHash(
+                rehashHashVal.Get(),
+                hashArr.begin() + docOffset,
+                hashArr.begin() + docOffset + testSampleCount);
+            docOffset += testSampleCount;
+        }
     }
 
     TVector<int> counterCTRTotal;
@@ -731,6 +979,7 @@ void ComputeOnlineCTRs(
 
     localExecutor->ExecRange(
         [&] (ui32 ctrIdx) {
+            CB_PROFILE_TRACE_SCOPE("ComputeOnlineCTR");
             const ECtrType ctrType = ctrInfo[ctrIdx].Type;
             const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
             int targetClassesCount = foldTargetClassesCount[classifierId];
@@ -779,6 +1028,7 @@ void ComputeOnlineCTRs(
                     ctrBorderCount,
                     ctrType,
                     ctrIdx,
+                    localExecutor,
                     scratchCache,
                     writer);
             } else {
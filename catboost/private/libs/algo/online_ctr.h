@@ -21,6 +21,7 @@
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <atomic>
 #include <functional>
 
 
@@ -78,6 +79,12 @@ struct IOnlineCtrProjectionDataWriter {
 struct TOnlineCtrPerProjectionData {
     NCB::TOnlineCtrUniqValuesCounts UniqValuesCounts;
     TVector<TArray2D<TVector<ui8>>> Feature; // Feature[ctrIdx][targetBorderIdx][priorIdx][docIdx]
+
+    // TOwnedOnlineCtr generation of the last use, the least recently used data is evicted first
+    ui32 LastUseGeneration = 0;
+
+public:
+    size_t GetFeatureDataSize() const;
 };
 
 
@@ -105,7 +112,28 @@ public:
         Data[projection];
     }
 
+    /* Marks data of the projection as used, returns true if it has to be computed.
+     * Projection must be already in Data, it is thread safe to call concurrently for different projections.
+     */
+    bool UseProjectionData(const TProjection& projection);
+
     void DropEmptyData();
+
+    /* Evicts the least recently used data, larger first among used at the same time,
+     * until there are no more than maxProjectionCount projections of size no more than maxDataSize.
+     * Starts the next generation of uses.
+     */
+    void TrimData(size_t maxProjectionCount, size_t maxDataSize);
+
+    size_t GetDataSize() const;
+
+    // part of UseProjectionData calls which did not require to compute data
+    double GetHitRate() const;
+
+private:
+    ui32 Generation = 0;
+    std::atomic<ui64> HitCount = 0;
+    std::atomic<ui64> MissCount = 0;
 };
 
 
@@ -128,6 +156,26 @@ inline ui8 CalcCTR(float countInClass, int totalCount, float prior, float shift,
     return (ctr + shift) / norm * borderCount;
 }
 
+// CalcCTR for arrays of docs, the loop has no dependencies or branches, so it is vectorized by compiler
+template <typename TCountInClass>
+inline void CalcCTRs(
+    TConstArrayRef<TCountInClass> countInClass,
+    TConstArrayRef<int> totalCount,
+    float prior,
+    float shift,
+    float norm,
+    int borderCount,
+    TArrayRef<ui8> ctrs) {
+
+    Y_ASSERT(countInClass.size() == ctrs.size() && totalCount.size() == ctrs.size());
+    const TCountInClass* countInClassData = countInClass.data();
+    const int* totalCountData = totalCount.data();
+    ui8* ctrsData = ctrs.data();
+    for (size_t idx = 0; idx < ctrs.size(); ++idx) {
+        ctrsData[idx] = CalcCTR(countInClassData[idx], totalCountData[idx], prior, shift, norm, borderCount);
+    }
+}
+
 void CalcNormalization(const TVector<float>& priors, TVector<float>* shift, TVector<float>* norm);
 
 
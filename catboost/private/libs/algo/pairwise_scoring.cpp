@@ -4,6 +4,8 @@
 #include <catboost/private/libs/algo_helpers/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/short_vector_ops.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/xrange.h>
 #include <util/system/yassert.h>
 
@@ -11,6 +13,27 @@
 using namespace NCB;
 
 
+TVector<TPairLeaves> CalcPairLeaves(
+    const TFlatPairsInfo& pairs,
+    TConstArrayRef<TIndexType> leafIndices,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TVector<TPairLeaves> pairLeaves;
+    pairLeaves.yresize(pairs.size());
+    NPar::ILocalExecutor::TExecRangeParams blockParams(0, pairs.ysize());
+    blockParams.SetBlockSize(10000);
+    localExecutor->ExecRange(
+        [&] (int pairIdx) {
+            pairLeaves[pairIdx].WinnerLeaf = leafIndices[pairs[pairIdx].WinnerId];
+            pairLeaves[pairIdx].LoserLeaf = leafIndices[pairs[pairIdx].LoserId];
+        },
+        blockParams,
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    return pairLeaves;
+}
+
+
 void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(SplitEnsembleSpec == rhs.SplitEnsembleSpec);
 
@@ -11,6 +11,14 @@
 
 #include <library/cpp/binsaver/bin_saver.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+
+namespace NPar {
+    class ILocalExecutor;
+}
+
 
 struct TBucketPairWeightStatistics {
     double SmallerBorderWeightSum = 0.0; // The weight sum of pair elements with smaller border.
@@ -26,6 +34,19 @@ public:
 };
 
 
+// Leaves of pair objects, they are the same for all split candidates at a depth
+struct TPairLeaves {
+    TIndexType WinnerLeaf = 0;
+    TIndexType LoserLeaf = 0;
+};
+
+// Gathered once per depth, so that pair stats of candidates are calculated without random access to leaf indices
+TVector<TPairLeaves> CalcPairLeaves(
+    const TFlatPairsInfo& pairs,
+    TConstArrayRef<TIndexType> leafIndices,
+    NPar::ILocalExecutor* localExecutor);
+
+
 struct TPairwiseStats {
     TVector<TVector<double>> DerSums; // [leafCount][bucketCount]
 
@@ -72,7 +93,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     const TFlatPairsInfo& pairs,
     int leafCount,
     int bucketCount,
-    const TVector<TIndexType>& leafIndices,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     TGetBucketFunc getBucketFunc,
     NCB::TIndexRange<int> pairIndexRange
 ) {
@@ -85,9 +106,9 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             continue;
         }
         const size_t winnerBucketId = getBucketFunc(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
+        const auto winnerLeafId = pairLeaves[pairIdx].WinnerLeaf;
         const size_t loserBucketId = getBucketFunc(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
+        const auto loserLeafId = pairLeaves[pairIdx].LoserLeaf;
         const float weight = pairs[pairIdx].Weight;
         if (winnerBucketId > loserBucketId) {
             weightSums[loserLeafId][winnerLeafId][loserBucketId].SmallerBorderWeightSum -= weight;
@@ -107,7 +128,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     const TFlatPairsInfo& pairs,
     int leafCount,
     int bucketCount,
-    const TVector<TIndexType>& leafIndices,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     TGetBinaryFeaturesPack getBinaryFeaturesPack,
     NCB::TIndexRange<int> pairIndexRange
 ) {
@@ -122,9 +143,9 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             continue;
         }
         const NCB::TBinaryFeaturesPack winnerFeaturesPack = getBinaryFeaturesPack(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
+        const auto winnerLeafId = pairLeaves[pairIdx].WinnerLeaf;
         const NCB::TBinaryFeaturesPack loserFeaturesPack = getBinaryFeaturesPack(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
+        const auto loserLeafId = pairLeaves[pairIdx].LoserLeaf;
         const float weight = pairs[pairIdx].Weight;
 
         for (auto bitIndex : xrange<NCB::TBinaryFeaturesPack>(binaryFeaturesCount)) {
@@ -153,7 +174,7 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
     ui32 oneHotMaxSize,
     const TFlatPairsInfo& pairs,
     int leafCount,
-    const TVector<TIndexType>& leafIndices,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     const NCB::TExclusiveFeaturesBundle& exclusiveFeaturesBundle,
     TGetExclusiveFeaturesBundleValue getExclusiveFeaturesBundleValue,
     NCB::TIndexRange<int> pairIndexRange
@@ -181,9 +202,9 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             continue;
         }
         const ui32 winnerBundleValue = getExclusiveFeaturesBundleValue(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
+        const auto winnerLeafId = pairLeaves[pairIdx].WinnerLeaf;
         const ui32 loserBundleValue = getExclusiveFeaturesBundleValue(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
+        const auto loserLeafId = pairLeaves[pairIdx].LoserLeaf;
         const float weight = pairs[pairIdx].Weight;
 
         ui32 bucketOffset = 0;
@@ -222,7 +243,7 @@ template <class TGetFeaturesGroupValue>
 inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatisticsForFeaturesGroup(
     const TFlatPairsInfo& pairs,
     int leafCount,
-    const TVector<TIndexType>& leafIndices,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     const NCB::TFeaturesGroup& featuresGroup,
     TGetFeaturesGroupValue getFeaturesGroupValue,
     NCB::TIndexRange<int> pairIndexRange
@@ -236,15 +257,17 @@ inline TArray2D<TVector<TBucketPairWeightStatistics>> ComputePairWeightStatistic
             continue;
         }
         const auto winnerGroupValue = getFeaturesGroupValue(winnerIdx);
-        const auto winnerLeafId = leafIndices[winnerIdx];
+        const auto winnerLeafId = pairLeaves[pairIdx].WinnerLeaf;
         const auto loserGroupValue = getFeaturesGroupValue(loserIdx);
-        const auto loserLeafId = leafIndices[loserIdx];
+        const auto loserLeafId = pairLeaves[pairIdx].LoserLeaf;
         const float weight = pairs[pairIdx].Weight;
 
         ui32 bucketOffset = 0;
         for (auto partIdx : xrange(featuresGroup.Parts.size())) {
-            auto winnerBucketId = NCB::GetPartValueFromGroup(winnerGroupValue, partIdx);
-            auto loserBucketId = NCB::GetPartValueFromGroup(loserGroupValue, partIdx);
+            auto winnerBucketId
+                = NCB::GetPartValueFromGroup(winnerGroupValue, partIdx, featuresGroup.PartBitCount);
+            auto loserBucketId
+                = NCB::GetPartValueFromGroup(loserGroupValue, partIdx, featuresGroup.PartBitCount);
 
             if (winnerBucketId > loserBucketId) {
                 weightSums[loserLeafId][winnerLeafId][bucketOffset + loserBucketId].SmallerBorderWeightSum
@@ -275,6 +298,7 @@ inline void ComputePairwiseStats(
     int bucketCount,
     ui32 oneHotMaxSize,
     const TVector<TIndexType>& leafIndices,
+    TConstArrayRef<TPairLeaves> pairLeaves,
 
     // used only if SplitEnsembleType == ESplitEnsembleType::ExclusiveBundle
     TMaybe<const NCB::TExclusiveFeaturesBundle*> exclusiveFeaturesBundle,
@@ -300,7 +324,7 @@ inline void ComputePairwiseStats(
                 pairs,
                 leafCount,
                 bucketCount,
-                leafIndices,
+                pairLeaves,
                 getBucketFunc,
                 pairIndexRange
             );
@@ -310,7 +334,7 @@ inline void ComputePairwiseStats(
                 pairs,
                 leafCount,
                 bucketCount,
-                leafIndices,
+                pairLeaves,
                 getBucketFunc,
                 pairIndexRange
             );
@@ -320,7 +344,7 @@ inline void ComputePairwiseStats(
                 oneHotMaxSize,
                 pairs,
                 leafCount,
-                leafIndices,
+                pairLeaves,
                 **exclusiveFeaturesBundle,
                 getBucketFunc,
                 pairIndexRange
@@ -330,7 +354,7 @@ inline void ComputePairwiseStats(
             output->PairWeightStatistics = ComputePairWeightStatisticsForFeaturesGroup(
                 pairs,
                 leafCount,
-                leafIndices,
+                pairLeaves,
                 **featuresGroup,
                 getBucketFunc,
                 pairIndexRange
@@ -348,6 +372,7 @@ inline void ComputePairwiseStats(
     int leafCount,
     int bucketCount,
     ui32 oneHotMaxSize,
+    TConstArrayRef<TPairLeaves> pairLeaves,
 
     // used only if splitEnsembleType == ESplitEnsembleType::ExclusiveBundle
     TMaybe<const NCB::TExclusiveFeaturesBundle*> exclusiveFeaturesBundle,
@@ -399,6 +424,7 @@ inline void ComputePairwiseStats(
                     bucketCount,
                     oneHotMaxSize,
                     fold.Indices,
+                    pairLeaves,
                     exclusiveFeaturesBundle,
                     featuresGroup,
                     docIndexRange,
@@ -5,6 +5,8 @@
 #include <catboost/libs/eval_result/eval_helpers.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/mem_usage.h>
+#include <catboost/libs/helpers/parallel_sort/parallel_sort.h>
+#include <catboost/libs/metrics/auc.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/private/libs/target/data_providers.h>
 
@@ -113,12 +115,12 @@ void TRocCurve::BuildCurve(
         );
     }
 
-    Sort(
-        probabilitiesWithTargets.begin(),
-        probabilitiesWithTargets.end(),
-        [](const TClassWithProbability& element1, const TClassWithProbability& element2) {
-            return element1.Probability > element2.Probability;
-        }
+    NCB::ParallelRadixSort(
+        MakeArrayRef(probabilitiesWithTargets),
+        [](const TClassWithProbability& element) {
+            return -element.Probability;
+        },
+        localExecutor
     );
 
     Points.clear();
@@ -146,20 +148,105 @@ void TRocCurve::BuildCurve(
     AddPoint(0, 0, 1); // always ends with (0, 0, 1)
 }
 
+void TRocCurve::BuildBinnedCurve(
+    const TVector<TVector<double>>& approxes, // [poolId][docId]
+    const TVector<TConstArrayRef<float>>& labels, // [poolId][docId]
+    ui32 histogramBinBits,
+    NPar::ILocalExecutor* localExecutor
+) {
+    // raw approxes are binned, probabilities are monotonic in them
+    const int partCount = localExecutor->GetThreadCount() + 1;
+    TVector<TBinClassAucHistogram> histograms(partCount, TBinClassAucHistogram(histogramBinBits));
+    for (size_t poolIdx = 0; poolIdx < labels.size(); ++poolIdx) {
+        const auto& poolApproxes = approxes[poolIdx];
+        const auto& targets = labels[poolIdx];
+        NPar::ILocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(targets.size()));
+        blockParams.SetBlockCount(partCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int partIdx) {
+                const int blockBegin = blockParams.FirstId + partIdx * blockParams.GetBlockSize();
+                const int blockEnd = Min(blockBegin + blockParams.GetBlockSize(), blockParams.LastId);
+                auto& histogram = histograms[partIdx];
+                for (int documentIdx = blockBegin; documentIdx < blockEnd; ++documentIdx) {
+                    const bool isPositive = targets[documentIdx] > 0.5;
+                    histogram.Add(poolApproxes[documentIdx], isPositive ? 1 : 0, isPositive ? 0 : 1);
+                }
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+    for (int partIdx = 1; partIdx < partCount; ++partIdx) {
+        histograms[0].Merge(histograms[partIdx]);
+    }
+    const auto& histogram = histograms[0];
+
+    TVector<double> countTargets(2, 0);
+    for (ui32 bin = 0; bin < histogram.GetBinCount(); ++bin) {
+        countTargets[0] += histogram.GetNegativeWeight(bin);
+        countTargets[1] += histogram.GetPositiveWeight(bin);
+    }
+    for (int classId : {0, 1}) {
+        CB_ENSURE(
+            countTargets[classId] > 0,
+            "No documents of class " << ToString(classId) << "."
+        );
+    }
+
+    Points.clear();
+
+    TVector<double> countTargetsIntermediate(2, 0);
+    const double allDocumentsCount = countTargets[0] + countTargets[1];
+
+    AddPoint(1, 1, 0); // always starts with (1, 1, 0)
+    for (ui32 bin = histogram.GetBinCount(); bin > 0; --bin) {
+        countTargetsIntermediate[0] += histogram.GetNegativeWeight(bin - 1);
+        countTargetsIntermediate[1] += histogram.GetPositiveWeight(bin - 1);
+        if (countTargetsIntermediate[0] + countTargetsIntermediate[1] == allDocumentsCount) {
+            break;
+        }
+        if (histogram.GetNegativeWeight(bin - 1) + histogram.GetPositiveWeight(bin - 1) == 0) {
+            continue;
+        }
+
+        const double boundary = 1. / (1. + std::exp(-histogram.GetBinLowerBound(bin - 1)));
+        // bins that can not be separated by probabilities are merged with the lower ones
+        if (boundary < EPS || boundary > Points.back().Boundary - EPS) {
+            continue;
+        }
+        double newFnr = (countTargets[1] - countTargetsIntermediate[1]) / countTargets[1];
+        double newFpr = countTargetsIntermediate[0] / countTargets[0];
+
+        AddPoint(boundary, newFnr, newFpr);
+    }
+    AddPoint(0, 0, 1); // always ends with (0, 0, 1)
+}
+
 
 TRocCurve::TRocCurve(
     const TVector<TVector<double>>& approxes,
     const TVector<TConstArrayRef<float>>& labels,
-    int threadCount
+    int threadCount,
+    ui32 histogramBinBits
 ) {
     NPar::TLocalExecutor localExecutor;
     localExecutor.RunAdditionalThreads(threadCount - 1);
 
-    BuildCurve(approxes, labels, &localExecutor);
+    if (histogramBinBits) {
+        BuildBinnedCurve(approxes, labels, histogramBinBits, &localExecutor);
+    } else {
+        BuildCurve(approxes, labels, &localExecutor);
+    }
 }
 
 
-TRocCurve::TRocCurve(const TFullModel& model, const TVector<TDataProviderPtr>& datasets, int threadCount) {
+TRocCurve::TRocCurve(
+    const TFullModel& model,
+    const TVector<TDataProviderPtr>& datasets,
+    int threadCount,
+    ui32 histogramBinBits
+) {
     TVector<TVector<double>> approxes(datasets.size());
     TVector<TConstArrayRef<float>> labels(datasets.size());
 
@@ -204,7 +291,11 @@ TRocCurve::TRocCurve(const TFullModel& model, const TVector<TDataProviderPtr>& d
         NPar::TLocalExecutor::WAIT_COMPLETE
     );
 
-    BuildCurve(approxes, labels, &localExecutor);
+    if (histogramBinBits) {
+        BuildBinnedCurve(approxes, labels, histogramBinBits, &localExecutor);
+    } else {
+        BuildCurve(approxes, labels, &localExecutor);
+    }
 }
 
 static void CheckRocPoint(const TRocPoint& rocPoint) {
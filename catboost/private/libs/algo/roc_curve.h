@@ -36,12 +36,22 @@ struct TRocCurve {
     constexpr static double EPS = 1e-13; // for comparisons of probabilities and coordinates
 
 public:
-    TRocCurve(const TFullModel& model, const TVector<NCB::TDataProviderPtr>& datasets, int threadCount = 1);
+    /* histogramBinBits == 0 builds the exact curve with a point for each distinct prediction,
+     * otherwise the curve is built from the TBinClassAucHistogram of predictions with the given number of
+     * bin bits: memory does not depend on the number of documents and boundaries are the bin bounds
+     */
+    TRocCurve(
+        const TFullModel& model,
+        const TVector<NCB::TDataProviderPtr>& datasets,
+        int threadCount = 1,
+        ui32 histogramBinBits = 0
+    );
 
     TRocCurve(
         const TVector<TVector<double>>& approxes,
         const TVector<TConstArrayRef<float>>& labels,
-        int threadCount
+        int threadCount,
+        ui32 histogramBinBits = 0
     );
 
     TRocCurve(const TVector<TRocPoint>& points);
@@ -68,6 +78,13 @@ private:
         NPar::ILocalExecutor* localExecutor
     );
 
+    void BuildBinnedCurve(
+        const TVector<TVector<double>>& approxes, // [poolId][docId]
+        const TVector<TConstArrayRef<float>>& labels, // [poolId][docId]
+        ui32 histogramBinBits,
+        NPar::ILocalExecutor* localExecutor
+    );
+
     static TRocPoint IntersectSegments(const TRocPoint& leftEnds, const TRocPoint& rightEnds);
 
     void AddPoint(double newBoundary, double newFnr, double newFpr);
@@ -10,9 +10,12 @@
 #include "tensor_search_helpers.h"
 
 #include <catboost/libs/data/objects.h>
+#include <catboost/libs/data/sparse_columns.h>
 #include <catboost/libs/helpers/map_merge.h>
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
+#include <catboost/libs/helpers/sparse_array.h>
 #include <catboost/private/libs/algo_helpers/online_predictor.h>
+#include <catboost/private/libs/algo_helpers/scratch_cache.h>
 #include <catboost/private/libs/algo_helpers/scoring_helpers.h>
 #include <catboost/private/libs/data_types/pair.h>
 #include <catboost/private/libs/index_range/index_range.h>
@@ -23,7 +26,11 @@
 #include <library/cpp/dot_product/dot_product.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 
+#include <array>
 #include <type_traits>
 
 
@@ -44,6 +51,10 @@ namespace {
         const ui32* const ObjectIndices; // may be nullptr
         const int ObjectOffset; // use if ObjectIndices == nullptr
 
+        // for sparse columns QuantizedValues contain only non default values
+        const TSparseArrayIndexing<ui32>* const SparseIndexing; // nullptr for dense columns
+        const ui32 DefaultQuantizedValue; // use if SparseIndexing != nullptr
+
     public:
         explicit TStatsIndexer(int bucketCount)
         : BucketCount(bucketCount)
@@ -53,6 +64,8 @@ namespace {
         , BitsPerValue(0)
         , ObjectIndices(nullptr)
         , ObjectOffset(0)
+        , SparseIndexing(nullptr)
+        , DefaultQuantizedValue(0)
         {
         }
 
@@ -63,7 +76,9 @@ namespace {
             const char* quantizedValues,
             size_t bitsPerValue,
             const ui32* objectIndices,
-            int objectOffset)
+            int objectOffset,
+            const TSparseArrayIndexing<ui32>* sparseIndexing = nullptr,
+            ui32 defaultQuantizedValue = 0)
         : BucketCount(bucketCount)
         , Depth(depth)
         , LeafIndices(leafIndices)
@@ -71,8 +86,11 @@ namespace {
         , BitsPerValue(bitsPerValue)
         , ObjectIndices(objectIndices)
         , ObjectOffset(objectOffset)
+        , SparseIndexing(sparseIndexing)
+        , DefaultQuantizedValue(defaultQuantizedValue)
         {
             Y_ASSERT(LeafIndices && QuantizedValues);
+            Y_ASSERT(!SparseIndexing || !ObjectIndices);
         }
 
         int CalcSize(int depth) const {
@@ -95,6 +113,44 @@ namespace {
             const auto leafIndex = LeafIndices[obj];
             return BucketCount * leafIndex + quantizedValue;
         }
+
+        template <bool isOneNodeTree>
+        int GetIndexForValue(int obj, ui32 quantizedValue) const {
+            if (isOneNodeTree) {
+                return quantizedValue;
+            }
+            return BucketCount * LeafIndices[obj] + quantizedValue;
+        }
+
+        // f must accept (obj, quantizedValue) params, obj is in [docIndexRange.Begin, docIndexRange.End)
+        template <typename TQuantType, typename TFunc>
+        void ForEachNonDefault(
+            NCB::TIndexRange<int> docIndexRange,
+            const TQuantType* nonDefaultQuantizedValues,
+            const TFunc& f
+        ) const {
+            Y_ASSERT(SparseIndexing && !ObjectIndices);
+            ISparseArrayIndexingBlockIteratorPtr<ui32> blockIterator;
+            ui32 nonDefaultIdx;
+            SparseIndexing->GetBlockIteratorAndNonDefaultBegin(
+                SafeIntegerCast<ui32>(ObjectOffset + docIndexRange.Begin),
+                &blockIterator,
+                &nonDefaultIdx);
+            const ui32 objectEnd = SafeIntegerCast<ui32>(ObjectOffset + docIndexRange.End);
+            while (auto objectIndices = blockIterator->NextUpToBound(objectEnd)) {
+                for (auto objectIdx : objectIndices) {
+                    f(int(objectIdx) - ObjectOffset, nonDefaultQuantizedValues[nonDefaultIdx++]);
+                }
+            }
+        }
+    };
+
+    /* For sparse columns only non default values are read and accumulated to their buckets, stats of
+     * the default value bucket are the difference of the leaf totals and the other buckets.
+     */
+    struct TSparseColumnIndexing {
+        const TSparseArrayIndexing<ui32>* Indexing = nullptr; // nullptr for dense columns
+        ui32 DefaultValue = 0;
     };
 }
 
@@ -108,6 +164,26 @@ static void GetBitsPerValueAndRawPtr(const TColumn& column, size_t* bitsPerValue
 }
 
 
+template <class TColumn>
+static void GetBitsPerValueAndRawPtr(
+    const TColumn& column,
+    size_t* bitsPerValue,
+    const char** rawPtr,
+    TSparseColumnIndexing* sparseColumnIndexing
+) {
+    const auto* sparseColumnData = dynamic_cast<const TSparseCompressedValuesHolderImpl<TColumn>*>(&column);
+    if (!sparseColumnData) {
+        GetBitsPerValueAndRawPtr(column, bitsPerValue, rawPtr);
+        return;
+    }
+    const auto& sparseArray = sparseColumnData->GetData();
+    *bitsPerValue = sparseArray.GetNonDefaultValues().GetBitsPerKey();
+    *rawPtr = sparseArray.GetNonDefaultValues().GetRawPtr();
+    sparseColumnIndexing->Indexing = sparseArray.GetIndexing().Get();
+    sparseColumnIndexing->DefaultValue = sparseArray.GetDefaultValue();
+}
+
+
 template <class TFunc>
 static void DispatchByBitsPerValue(TFunc func, size_t bitsPerValue, const char* data) {
     switch (bitsPerValue) {
@@ -126,6 +202,32 @@ static void DispatchByBitsPerValue(TFunc func, size_t bitsPerValue, const char*
 }
 
 
+// sparse columns are scored directly only for consecutive objects, other indexings need a dense copy of values
+static void MakeDenseQuantizedValues(
+    const TSparseColumnIndexing& sparseColumnIndexing,
+    size_t bitsPerValue,
+    const char* nonDefaultValues,
+    TVector<ui64>* denseValuesStorage
+) {
+    const ui32 size = sparseColumnIndexing.Indexing->GetSize();
+    denseValuesStorage->yresize(CeilDiv<size_t>(size_t(size) * bitsPerValue, CHAR_BIT * sizeof(ui64)));
+    DispatchByBitsPerValue(
+        [&] (const auto* nonDefaultQuantizedValues) {
+            using TQuantType = std::remove_cv_t<std::remove_pointer_t<decltype(nonDefaultQuantizedValues)>>;
+            auto* denseValues = reinterpret_cast<TQuantType*>(denseValuesStorage->data());
+            Fill(denseValues, denseValues + size, TQuantType(sparseColumnIndexing.DefaultValue));
+            ui32 nonDefaultIdx = 0;
+            sparseColumnIndexing.Indexing->ForEachNonDefault(
+                [&] (ui32 idx) {
+                    denseValues[idx] = nonDefaultQuantizedValues[nonDefaultIdx++];
+                }
+            );
+        },
+        bitsPerValue,
+        nonDefaultValues);
+}
+
+
 static void GetIndexingParams(
     const TCalcScoreFold& fold,
     const TSplitEnsemble& splitEnsemble,
@@ -163,8 +265,10 @@ static void GetBitsPerValueAndRawPtr(
     const std::tuple<const TOnlineCtrBase&, const TOnlineCtrBase&>& allCtrs,
     const TSplitEnsemble& splitEnsemble,
     size_t* bitsPerValue,
-    const char** rawPtr
+    const char** rawPtr,
+    TSparseColumnIndexing* sparseColumnIndexing
 ) {
+    *sparseColumnIndexing = TSparseColumnIndexing();
     if (splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
         const TCtr& ctr = splitEnsemble.SplitCandidate.Ctr;
         *bitsPerValue = 8;
@@ -175,10 +279,18 @@ static void GetBitsPerValueAndRawPtr(
                 const auto& splitCandidate = splitEnsemble.SplitCandidate;
                 const auto featureIdx = (ui32)splitCandidate.FeatureIdx;
                 if (EqualToOneOf(splitCandidate.Type, ESplitType::FloatFeature, ESplitType::EstimatedFeature)) {
-                    GetBitsPerValueAndRawPtr(**objectsDataProvider.GetNonPackedFloatFeature(featureIdx), bitsPerValue, rawPtr);
+                    GetBitsPerValueAndRawPtr(
+                        **objectsDataProvider.GetNonPackedFloatFeature(featureIdx),
+                        bitsPerValue,
+                        rawPtr,
+                        sparseColumnIndexing);
                 } else {
                     Y_ASSERT(splitCandidate.Type == ESplitType::OneHotFeature);
-                    GetBitsPerValueAndRawPtr(**objectsDataProvider.GetNonPackedCatFeature(featureIdx), bitsPerValue, rawPtr);
+                    GetBitsPerValueAndRawPtr(
+                        **objectsDataProvider.GetNonPackedCatFeature(featureIdx),
+                        bitsPerValue,
+                        rawPtr,
+                        sparseColumnIndexing);
                 }
                 break;
             }
@@ -199,23 +311,106 @@ static void GetBitsPerValueAndRawPtr(
 }
 
 
+/* Adjacent objects often fall into the same bucket of a small histogram (few leafs and buckets), and then
+ * every addition waits for the previous one. Such histograms are accumulated in several lane-private copies,
+ * object i goes to the copy i % HistogramLaneCount, and the copies are summed up at the end.
+ */
+static constexpr int HistogramLaneCount = 4;
+static constexpr int MaxLaneHistogramSize = 1024;
+static constexpr int MinObjectsPerLaneHistogramBucket = 16;
+
+// addFunc must accept (doc, stats) params
+template <class TStats, class TAddFunc>
+inline static void AccumulateStats(
+    int statsSize,
+    NCB::TIndexRange<int> docIndexRange,
+    TStats* stats,
+    const TAddFunc& addFunc
+) {
+    if ((statsSize > MaxLaneHistogramSize)
+        || (docIndexRange.GetSize() < MinObjectsPerLaneHistogramBucket * statsSize))
+    {
+        for (int doc : docIndexRange.Iter()) {
+            addFunc(doc, stats);
+        }
+        return;
+    }
+
+    TVector<TStats> laneStats(size_t(HistogramLaneCount - 1) * statsSize, TStats{});
+    TStats* lane1 = laneStats.data();
+    TStats* lane2 = lane1 + statsSize;
+    TStats* lane3 = lane2 + statsSize;
+    int doc = docIndexRange.Begin;
+    for (; doc + HistogramLaneCount <= docIndexRange.End; doc += HistogramLaneCount) {
+        addFunc(doc, stats);
+        addFunc(doc + 1, lane1);
+        addFunc(doc + 2, lane2);
+        addFunc(doc + 3, lane3);
+    }
+    for (; doc < docIndexRange.End; ++doc) {
+        addFunc(doc, stats);
+    }
+    for (int lane : xrange(HistogramLaneCount - 1)) {
+        const TStats* laneStatsBegin = laneStats.data() + lane * statsSize;
+        for (int statIdx : xrange(statsSize)) {
+            stats[statIdx].Add(laneStatsBegin[statIdx]);
+        }
+    }
+}
+
+
 // Update bootstraped sums on docIndexRange in a bucket
+template <class TStats>
 inline static void UpdateWeighted(
     const TStatsIndexer& indexer,
     const double* weightedDer,
     const float* sampleWeights,
     NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    TStats* stats
 ) {
+    if (indexer.SparseIndexing) {
+        DispatchByBitsPerValue(
+            [=] (const auto* nonDefaultQuantizedValues) {
+                DispatchGenericLambda(
+                    [=] (auto isOneNode) {
+                        const ui32 defaultValue = indexer.DefaultQuantizedValue;
+                        AccumulateStats(
+                            indexer.CalcSize(indexer.Depth),
+                            docIndexRange,
+                            stats,
+                            [=] (int doc, TStats* laneStats) {
+                                auto& leafStats = laneStats[indexer.GetIndexForValue<isOneNode>(doc, defaultValue)];
+                                leafStats.AddWeighted(weightedDer[doc], sampleWeights[doc]);
+                            });
+                        indexer.ForEachNonDefault(
+                            docIndexRange,
+                            nonDefaultQuantizedValues,
+                            [=] (int doc, ui32 quantizedValue) {
+                                auto& defaultStats = stats[indexer.GetIndexForValue<isOneNode>(doc, defaultValue)];
+                                defaultStats.AddWeighted(-weightedDer[doc], -sampleWeights[doc]);
+                                auto& leafStats = stats[indexer.GetIndexForValue<isOneNode>(doc, quantizedValue)];
+                                leafStats.AddWeighted(weightedDer[doc], sampleWeights[doc]);
+                            });
+                    },
+                    indexer.Depth == 0);
+            },
+            indexer.BitsPerValue,
+            indexer.QuantizedValues);
+        return;
+    }
+
     DispatchByBitsPerValue(
         [=] (const auto* quantizedValues) {
             DispatchGenericLambda(
                 [=] (auto isOneNode) {
-                    for (int doc : docIndexRange.Iter()) {
-                        auto& leafStats0 = stats[indexer.GetIndex<isOneNode>(doc, quantizedValues)];
-                        leafStats0.SumWeightedDelta += weightedDer[doc];
-                        leafStats0.SumWeight += sampleWeights[doc];
-                    }
+                    AccumulateStats(
+                        indexer.CalcSize(indexer.Depth),
+                        docIndexRange,
+                        stats,
+                        [=] (int doc, TStats* laneStats) {
+                            auto& leafStats0 = laneStats[indexer.GetIndex<isOneNode>(doc, quantizedValues)];
+                            leafStats0.AddWeighted(weightedDer[doc], sampleWeights[doc]);
+                        });
                 },
                 indexer.Depth == 0);
         },
@@ -225,22 +420,58 @@ inline static void UpdateWeighted(
 
 
 // Update not bootstraped sums on docIndexRange in a bucket
+template <class TStats>
 inline static void UpdateDeltaCount(
     const TStatsIndexer& indexer,
     const double* derivatives,
     const float* learnWeights,
     NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    TStats* stats
 ) {
+    if (indexer.SparseIndexing) {
+        DispatchByBitsPerValue(
+            [=] (const auto* nonDefaultQuantizedValues) {
+                DispatchGenericLambda(
+                    [=] (auto haveWeights, auto isOneNode) {
+                        const ui32 defaultValue = indexer.DefaultQuantizedValue;
+                        AccumulateStats(
+                            indexer.CalcSize(indexer.Depth),
+                            docIndexRange,
+                            stats,
+                            [=] (int doc, TStats* laneStats) {
+                                auto& leafStats = laneStats[indexer.GetIndexForValue<isOneNode>(doc, defaultValue)];
+                                leafStats.AddDeltaCount(derivatives[doc], haveWeights ? learnWeights[doc] : 1);
+                            });
+                        indexer.ForEachNonDefault(
+                            docIndexRange,
+                            nonDefaultQuantizedValues,
+                            [=] (int doc, ui32 quantizedValue) {
+                                const float weight = haveWeights ? learnWeights[doc] : 1;
+                                auto& defaultStats = stats[indexer.GetIndexForValue<isOneNode>(doc, defaultValue)];
+                                defaultStats.AddDeltaCount(-derivatives[doc], -weight);
+                                auto& leafStats = stats[indexer.GetIndexForValue<isOneNode>(doc, quantizedValue)];
+                                leafStats.AddDeltaCount(derivatives[doc], weight);
+                            });
+                    },
+                    learnWeights != nullptr, indexer.Depth == 0);
+            },
+            indexer.BitsPerValue,
+            indexer.QuantizedValues);
+        return;
+    }
+
     DispatchByBitsPerValue(
         [=] (const auto* quantizedValues) {
             DispatchGenericLambda(
                 [=] (auto haveWeights, auto isOneNode) {
-                    for (int doc : docIndexRange.Iter()) {
-                        auto& leafStats = stats[indexer.GetIndex<isOneNode>(doc, quantizedValues)];
-                        leafStats.SumDelta += derivatives[doc];
-                        leafStats.Count += haveWeights ? learnWeights[doc] : 1;
-                    }
+                    AccumulateStats(
+                        indexer.CalcSize(indexer.Depth),
+                        docIndexRange,
+                        stats,
+                        [=] (int doc, TStats* laneStats) {
+                            auto& leafStats = laneStats[indexer.GetIndex<isOneNode>(doc, quantizedValues)];
+                            leafStats.AddDeltaCount(derivatives[doc], haveWeights ? learnWeights[doc] : 1);
+                        });
                 },
                 learnWeights != nullptr, indexer.Depth == 0);
         },
@@ -249,6 +480,53 @@ inline static void UpdateDeltaCount(
 }
 
 
+/* For multiclassification and multiregression all approx dimensions share the tree structure, so an object
+ * falls into the same bucket for each dimension. Bucket indices are calculated once for a block of objects
+ * and reused by all dimensions: quantized values, leaf indices and object indices are read once instead of
+ * approxDimension times.
+ */
+static constexpr int BucketIndicesBlockSize = 1024;
+
+// addFunc must accept (dim, doc, bucketStats) params, stats of dim start at stats + dim * dimensionStatsStride
+template <class TStats, class TAddFunc>
+inline static void AccumulateStatsForAllDimensions(
+    const TStatsIndexer& indexer,
+    NCB::TIndexRange<int> docIndexRange,
+    int approxDimension,
+    int dimensionStatsStride,
+    TStats* stats,
+    const TAddFunc& addFunc
+) {
+    Y_ASSERT(!indexer.SparseIndexing);
+    DispatchByBitsPerValue(
+        [&] (const auto* quantizedValues) {
+            DispatchGenericLambda(
+                [&] (auto isOneNode) {
+                    std::array<int, BucketIndicesBlockSize> bucketIndices;
+                    for (int blockBegin = docIndexRange.Begin;
+                         blockBegin < docIndexRange.End;
+                         blockBegin += BucketIndicesBlockSize)
+                    {
+                        const int blockEnd = Min(blockBegin + BucketIndicesBlockSize, docIndexRange.End);
+                        for (int doc : xrange(blockBegin, blockEnd)) {
+                            bucketIndices[doc - blockBegin] = indexer.GetIndex<isOneNode>(doc, quantizedValues);
+                        }
+                        for (int dim : xrange(approxDimension)) {
+                            TStats* dimStats = stats + dim * dimensionStatsStride;
+                            for (int doc : xrange(blockBegin, blockEnd)) {
+                                addFunc(dim, doc, dimStats[bucketIndices[doc - blockBegin]]);
+                            }
+                        }
+                    }
+                },
+                indexer.Depth == 0);
+        },
+        indexer.BitsPerValue,
+        indexer.QuantizedValues);
+}
+
+
+template <class TStats>
 inline static void CalcStatsKernel(
     bool isCaching,
     const TCalcScoreFold& fold,
@@ -258,17 +536,17 @@ inline static void CalcStatsKernel(
     const TCalcScoreFold::TBodyTail& bt,
     int dim,
     NCB::TIndexRange<int> docIndexRange,
-    TBucketStats* stats
+    TStats* stats
 ) {
     Y_ASSERT(!isCaching || depth > 0);
     if (isCaching) {
         Fill(
             stats + indexer.CalcSize(depth - 1),
             stats + indexer.CalcSize(depth),
-            TBucketStats{0, 0, 0, 0}
+            TStats{}
         );
     } else {
-        Fill(stats, stats + indexer.CalcSize(depth), TBucketStats{0, 0, 0, 0});
+        Fill(stats, stats + indexer.CalcSize(depth), TStats{});
     }
 
     if (bt.TailFinish > docIndexRange.Begin) {
@@ -312,11 +590,108 @@ inline static void CalcStatsKernel(
 }
 
 
+// Same as CalcStatsKernel for each dim in [0, approxDimension), stats of dim start at stats + dim * dimensionStatsStride
+template <class TStats>
+inline static void CalcStatsKernelForAllDimensions(
+    bool isCaching,
+    const TCalcScoreFold& fold,
+    bool isPlainMode,
+    const TStatsIndexer& indexer,
+    int depth,
+    const TCalcScoreFold::TBodyTail& bt,
+    int approxDimension,
+    int dimensionStatsStride,
+    NCB::TIndexRange<int> docIndexRange,
+    TStats* stats
+) {
+    if (indexer.SparseIndexing) {
+        // non-default values of sparse columns are visited by a block iterator, there's nothing to share
+        for (int dim : xrange(approxDimension)) {
+            CalcStatsKernel(
+                isCaching,
+                fold,
+                isPlainMode,
+                indexer,
+                depth,
+                bt,
+                dim,
+                docIndexRange,
+                stats + dim * dimensionStatsStride);
+        }
+        return;
+    }
+
+    Y_ASSERT(!isCaching || depth > 0);
+    for (int dim : xrange(approxDimension)) {
+        TStats* dimStats = stats + dim * dimensionStatsStride;
+        if (isCaching) {
+            Fill(dimStats + indexer.CalcSize(depth - 1), dimStats + indexer.CalcSize(depth), TStats{});
+        } else {
+            Fill(dimStats, dimStats + indexer.CalcSize(depth), TStats{});
+        }
+    }
+
+    if (bt.TailFinish <= docIndexRange.Begin) {
+        return;
+    }
+
+    const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+    const float* weightsData = hasPairwiseWeights ?
+        GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
+    const float* sampleWeightsData = hasPairwiseWeights ?
+        GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
+
+    TVector<const double*> sampleWeightedDerivatives(approxDimension);
+    TVector<const double*> weightedDerivatives(approxDimension);
+    for (int dim : xrange(approxDimension)) {
+        sampleWeightedDerivatives[dim] = GetDataPtr(bt.SampleWeightedDerivatives[dim]);
+        weightedDerivatives[dim] = GetDataPtr(bt.WeightedDerivatives[dim]);
+    }
+
+    const auto updateWeighted = [&] (NCB::TIndexRange<int> range) {
+        AccumulateStatsForAllDimensions(
+            indexer,
+            range,
+            approxDimension,
+            dimensionStatsStride,
+            stats,
+            [&] (int dim, int doc, TStats& bucketStats) {
+                bucketStats.AddWeighted(sampleWeightedDerivatives[dim][doc], sampleWeightsData[doc]);
+            });
+    };
+
+    const int tailFinishInRange = Min((int)bt.TailFinish, docIndexRange.End);
+    if (isPlainMode) {
+        updateWeighted(NCB::TIndexRange<int>(docIndexRange.Begin, tailFinishInRange));
+        return;
+    }
+    if (bt.BodyFinish > docIndexRange.Begin) {
+        DispatchGenericLambda(
+            [&] (auto haveWeights) {
+                AccumulateStatsForAllDimensions(
+                    indexer,
+                    NCB::TIndexRange<int>(docIndexRange.Begin, Min((int)bt.BodyFinish, docIndexRange.End)),
+                    approxDimension,
+                    dimensionStatsStride,
+                    stats,
+                    [&] (int dim, int doc, TStats& bucketStats) {
+                        bucketStats.AddDeltaCount(weightedDerivatives[dim][doc], haveWeights ? weightsData[doc] : 1);
+                    });
+            },
+            weightsData != nullptr);
+    }
+    if (tailFinishInRange > bt.BodyFinish) {
+        updateWeighted(NCB::TIndexRange<int>(Max((int)bt.BodyFinish, docIndexRange.Begin), tailFinishInRange));
+    }
+}
+
+
+template <class TStats>
 inline static void FixUpStats(
     int depth,
     const TStatsIndexer& indexer,
     bool selectedSplitValue,
-    TBucketStats* stats
+    TStats* stats
 ) {
     const int halfOfStats = indexer.CalcSize(depth - 1);
     if (selectedSplitValue == true) {
@@ -336,6 +711,7 @@ static void CalcStatsPairwise(
     const TCalcScoreFold& fold,
     const TQuantizedObjectsDataProvider& objectsDataProvider,
     const TFlatPairsInfo& pairs,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     const std::tuple<const TOnlineCtrBase&, const TOnlineCtrBase&>& allCtrs,
     const TSplitEnsemble& splitEnsemble,
     int bucketCount,
@@ -360,6 +736,12 @@ static void CalcStatsPairwise(
     const auto pairCount = pairs.ysize();
     const auto pairPart = CeilDiv(pairCount, blockCount);
 
+    TVector<TPairLeaves> localPairLeaves;
+    if (pairLeaves.empty() && !pairs.empty()) {
+        localPairLeaves = CalcPairLeaves(pairs, fold.Indices, localExecutor);
+        pairLeaves = localPairLeaves;
+    }
+
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
@@ -388,6 +770,7 @@ static void CalcStatsPairwise(
                     leafCount,
                     bucketCount,
                     oneHotMaxSize,
+                    pairLeaves,
                     exclusiveFeaturesBundle,
                     featuresGroup,
                     column,
@@ -419,6 +802,7 @@ static void CalcStatsPairwise(
                                         bucketCount,
                                         oneHotMaxSize,
                                         fold.Indices,
+                                        pairLeaves,
                                         /*exclusiveFeaturesBundle*/ Nothing(),
                                         /*featuresGroup*/ Nothing(),
                                         docIndexRange,
@@ -477,7 +861,10 @@ static void CalcStatsPairwise(
 }
 
 
-template <typename TIsCaching>
+// number of bucket stats merged by one task after calculation by blocks of objects
+constexpr int MergedStatsBlockSize = 4096;
+
+template <typename TIsCaching, typename TStats>
 static void CalcStatsPointwise(
     const TCalcScoreFold& fold,
     const TStatsIndexer& indexer,
@@ -486,7 +873,7 @@ static void CalcStatsPointwise(
     int depth,
     int splitStatsCount,
     NPar::ILocalExecutor* localExecutor,
-    TBucketStatsRefOptionalHolder* stats
+    TDataRefOptionalHolder<TStats>* stats
 ) {
     Y_ASSERT(!isCaching || depth > 0);
 
@@ -506,7 +893,7 @@ static void CalcStatsPointwise(
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
-        /*mapFunc*/[&](NCB::TIndexRange<int> indexRange, TBucketStatsRefOptionalHolder* output) {
+        /*mapFunc*/[&](NCB::TIndexRange<int> indexRange, TDataRefOptionalHolder<TStats>* output) {
             NCB::TIndexRange<int> docIndexRange = fold.HasQueryInfo() ?
                 NCB::TIndexRange<int>(
                     fold.LearnQueriesInfo[indexRange.Begin].Begin,
@@ -515,14 +902,28 @@ static void CalcStatsPointwise(
                 : indexRange;
 
             if (output->NonInited()) {
-                (*output) = TBucketStatsRefOptionalHolder(statsCount);
+                (*output) = TDataRefOptionalHolder<TStats>(statsCount);
             } else {
                 Y_ASSERT(docIndexRange.Begin == 0);
             }
 
-            forEachBodyTailAndApproxDimension(
-                [&](int bodyTailIdx, int dim, int bucketStatsArrayBegin) {
-                    TBucketStats* statsSubset = output->GetData().data() + bucketStatsArrayBegin;
+            const int approxDimension = fold.GetApproxDimension();
+            for (int bodyTailIdx : xrange(fold.GetBodyTailCount())) {
+                TStats* statsSubset = output->GetData().data() + bodyTailIdx * approxDimension * splitStatsCount;
+                if (approxDimension > 1) {
+                    CalcStatsKernelForAllDimensions(
+                        isCaching && (indexRange.Begin == 0),
+                        fold,
+                        isPlainMode,
+                        indexer,
+                        depth,
+                        fold.BodyTailArr[bodyTailIdx],
+                        approxDimension,
+                        splitStatsCount,
+                        docIndexRange,
+                        statsSubset
+                    );
+                } else {
                     CalcStatsKernel(
                         isCaching && (indexRange.Begin == 0),
                         fold,
@@ -530,29 +931,41 @@ static void CalcStatsPointwise(
                         indexer,
                         depth,
                         fold.BodyTailArr[bodyTailIdx],
-                        dim,
+                        /*dim*/ 0,
                         docIndexRange,
                         statsSubset
                     );
                 }
-            );
+            }
         },
         /*mergeFunc*/[&](
-            TBucketStatsRefOptionalHolder* output,
-            TVector<TBucketStatsRefOptionalHolder>&& addVector
+            TDataRefOptionalHolder<TStats>* output,
+            TVector<TDataRefOptionalHolder<TStats>>&& addVector
         ) {
+            // stats are merged by independent ranges of buckets
+            NPar::ILocalExecutor::TExecRangeParams mergeBlockParams(0, filledSplitStatsCount);
+            mergeBlockParams.SetBlockSize(MergedStatsBlockSize);
             forEachBodyTailAndApproxDimension(
                 [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
-                    TBucketStats* outputStatsSubset =
+                    TStats* outputStatsSubset =
                         output->GetData().data() + bucketStatsArrayBegin;
 
-                    for (const auto& addItem : addVector) {
-                        const TBucketStats* addStatsSubset =
-                            addItem.GetData().data() + bucketStatsArrayBegin;
-                        for (size_t i : xrange(filledSplitStatsCount)) {
-                            (outputStatsSubset + i)->Add(*(addStatsSubset + i));
-                        }
-                    }
+                    localExecutor->ExecRange(
+                        [&](int blockIdx) {
+                            const int blockBegin = blockIdx * mergeBlockParams.GetBlockSize();
+                            const int blockEnd = Min(blockBegin + mergeBlockParams.GetBlockSize(), filledSplitStatsCount);
+                            for (const auto& addItem : addVector) {
+                                const TStats* addStatsSubset =
+                                    addItem.GetData().data() + bucketStatsArrayBegin;
+                                for (int i : xrange(blockBegin, blockEnd)) {
+                                    (outputStatsSubset + i)->Add(*(addStatsSubset + i));
+                                }
+                            }
+                        },
+                        0,
+                        mergeBlockParams.GetBlockCount(),
+                        NPar::TLocalExecutor::WAIT_COMPLETE
+                    );
                 }
             );
         },
@@ -562,7 +975,7 @@ static void CalcStatsPointwise(
     if (isCaching) {
         forEachBodyTailAndApproxDimension(
             [&](int /*bodyTailIdx*/, int /*dim*/, int bucketStatsArrayBegin) {
-                TBucketStats* statsSubset = stats->GetData().data() + bucketStatsArrayBegin;
+                TStats* statsSubset = stats->GetData().data() + bucketStatsArrayBegin;
                 FixUpStats(depth, indexer, fold.SmallestSplitSideValue, statsSubset);
             }
         );
@@ -588,9 +1001,9 @@ inline void UpdateSplitScore(
 /* This function calculates resulting sums for each split given statistics that are calculated for each bucket
  * of the histogram.
  */
-template <typename TIsPlainMode, typename THaveMonotonicConstraints>
+template <typename TStats, typename TIsPlainMode, typename THaveMonotonicConstraints>
 inline static void UpdateScores(
-    const TBucketStats* stats,
+    const TStats* stats,
     int leafCount,
     const TStatsIndexer& indexer,
     const TSplitEnsembleSpec& splitEnsembleSpec,
@@ -672,7 +1085,7 @@ inline static void UpdateScores(
 
     for (int leaf = 0; leaf < leafCount; ++leaf) {
         const auto& getBucketStats = [stats, leaf, indexer] (int bucketIdx) {
-            return stats[indexer.GetIndex(leaf, bucketIdx)];
+            return stats[indexer.GetIndex(leaf, bucketIdx)].ToBucketStats();
         };
         CalcScoresForLeaf(
             splitEnsembleSpec,
@@ -723,6 +1136,7 @@ inline static void UpdateScores(
 }
 
 
+template <class TStats>
 static void CalculateNonPairwiseScore(
     const TCalcScoreFold& fold,
     const TFold& initialFold,
@@ -732,7 +1146,7 @@ static void CalculateNonPairwiseScore(
     const float l2Regularizer,
     const ui32 oneHotMaxSize,
     const TStatsIndexer& indexer,
-    const TBucketStats* splitStats,
+    const TStats* splitStats,
     int splitStatsCount,
     const TVector<int>& currTreeMonotonicConstraints,
     const TVector<int>& candidateSplitMonotonicConstraints,
@@ -749,7 +1163,7 @@ static void CalculateNonPairwiseScore(
                 const double scaledL2Regularizer = l2Regularizer * (sumAllWeights / docCount);
                 scoreCalcer->SetL2Regularizer(scaledL2Regularizer);
                 for (int dim = 0; dim < approxDimension; ++dim) {
-                    const TBucketStats* stats = splitStats
+                    const TStats* stats = splitStats
                         + (bodyTailIdx * approxDimension + dim) * splitStatsCount;
                     UpdateScores(
                         stats,
@@ -777,6 +1191,7 @@ void CalcStatsAndScores(
     const TCalcScoreFold& prevLevelData,
     const TFold* initialFold,
     const TFlatPairsInfo& pairs,
+    TConstArrayRef<TPairLeaves> pairLeaves,
     const NCatboostOptions::TCatBoostOptions& fitParams,
     const TCandidateInfo& candidateInfo,
     int depth,
@@ -785,6 +1200,7 @@ void CalcStatsAndScores(
     const TMap<ui32, int>& monotonicConstraints,
     NPar::ILocalExecutor* localExecutor,
     TBucketStatsCache* statsFromPrevTree,
+    NCB::TScratchCache* scratchCache,
     TStats3D* stats3d,
     TPairwiseStats* pairwiseStats,
     IScoreCalcer* scoreCalcer
@@ -827,6 +1243,7 @@ void CalcStatsAndScores(
             fold,
             objectsDataProvider,
             pairs,
+            pairLeaves,
             allCtrs,
             splitEnsemble,
             bucketCount,
@@ -852,12 +1269,15 @@ void CalcStatsAndScores(
 
         size_t bitsPerValue;
         const char* rawPtr;
+        TSparseColumnIndexing sparseColumnIndexing;
         GetBitsPerValueAndRawPtr(
             objectsDataProvider,
             allCtrs,
             splitEnsemble,
             &bitsPerValue,
-            &rawPtr);
+            &rawPtr,
+            &sparseColumnIndexing);
+        TVector<ui64> denseValuesStorage;
 
         const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
 
@@ -875,14 +1295,24 @@ void CalcStatsAndScores(
                 &objectIndexing,
                 &beginOffset);
 
+            if (sparseColumnIndexing.Indexing && objectIndexing) {
+                if (denseValuesStorage.empty()) {
+                    MakeDenseQuantizedValues(sparseColumnIndexing, bitsPerValue, rawPtr, &denseValuesStorage);
+                }
+            }
+            const bool useSparseColumn = sparseColumnIndexing.Indexing && !objectIndexing;
+
             const TStatsIndexer indexer(
                 bucketCount,
                 depth,
                 GetDataPtr(fold.Indices),
-                rawPtr,
+                (sparseColumnIndexing.Indexing && !useSparseColumn) ?
+                    (const char*)denseValuesStorage.data() : rawPtr,
                 bitsPerValue,
                 objectIndexing,
-                beginOffset);
+                beginOffset,
+                useSparseColumn ? sparseColumnIndexing.Indexing : nullptr,
+                sparseColumnIndexing.DefaultValue);
 
             CalcStatsPointwise(
                 fold,
@@ -895,11 +1325,117 @@ void CalcStatsAndScores(
                 stats);
         };
 
-        TBucketStatsRefOptionalHolder extOrInSplitStats;
-        int splitStatsCount = 0;
+        const auto calcScores = [&] (const auto* splitStats, int splitStatsCount) {
+            const int leafCount = 1 << depth;
+            TSplitEnsembleSpec splitEnsembleSpec(
+                splitEnsemble,
+                objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+                objectsDataProvider.GetFeaturesGroupsMetaData()
+            );
+            const int candidateSplitCount = CalcSplitsCount(
+                splitEnsembleSpec, bucketCount, oneHotMaxSize
+            );
+            scoreCalcer->SetSplitsCount(candidateSplitCount);
+
+            TVector<int> candidateSplitMonotonicConstraints;
+            if (!monotonicConstraints.empty()) {
+                candidateSplitMonotonicConstraints.resize(candidateSplitCount, 0);
+                for (int splitIdx : xrange(candidateSplitCount)) {
+                    const auto split = candidateInfo.GetSplit(
+                        splitIdx, objectsDataProvider, oneHotMaxSize
+                    );
+                    if (split.Type == ESplitType::FloatFeature) {
+                        Y_ASSERT(split.FeatureIdx >= 0);
+                        if (monotonicConstraints.contains(split.FeatureIdx)) {
+                            candidateSplitMonotonicConstraints[splitIdx] =
+                                monotonicConstraints.at(split.FeatureIdx);
+                        }
+                    }
+                }
+            }
+
+            CalculateNonPairwiseScore(
+                fold,
+                *initialFold,
+                splitEnsembleSpec,
+                isPlainMode,
+                leafCount,
+                l2Regularizer,
+                oneHotMaxSize,
+                TStatsIndexer(bucketCount),
+                splitStats,
+                splitStatsCount,
+                currTreeMonotonicConstraints,
+                candidateSplitMonotonicConstraints,
+                dynamic_cast<IPointwiseScoreCalcer*>(scoreCalcer)
+            );
+        };
+
+        // stats which are not kept between depths are placed into buffers reused by all candidates
+        TAtomicSharedPtr<TVector<ui8>> scratchStats;
+        const auto getScratchStats = [&] (auto* stats, int splitStatsCount) {
+            using TStats = std::remove_reference_t<decltype(stats->GetData()[0])>;
+            if (scratchCache) {
+                scratchStats = scratchCache->GetScratchBlob();
+                const size_t statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
+                *stats = TDataRefOptionalHolder<TStats>(NCB::GrowScratchBlob<TStats>(statsCount, scratchStats.Get()));
+            }
+        };
+        const auto releaseScratchStats = [&] () {
+            if (scratchStats) {
+                scratchCache->ReleaseScratchBlob(std::move(scratchStats));
+            }
+        };
 
         const auto& treeOptions = fitParams.ObliviousTreeOptions.Get();
 
+        // stats3d are gathered from workers in distributed mode, so they are always of TBucketStats
+        if (treeOptions.DevCompactBucketStats.GetUnchecked() && !stats3d) {
+            TDataRefOptionalHolder<TCompactBucketStats> compactSplitStats;
+            int splitStatsCount = 0;
+            if (!useTreeLevelCaching) {
+                splitStatsCount = (ui64(1) << depth) * bucketCount;
+                getScratchStats(&compactSplitStats, splitStatsCount);
+                calcStatsPointwise(
+                    /*isCaching*/ std::false_type(),
+                    fold,
+                    splitStatsCount,
+                    &compactSplitStats
+                );
+            } else {
+                splitStatsCount = (ui64(1) << treeOptions.MaxDepth) * bucketCount;
+                bool areStatsDirty;
+
+                // thread-safe access
+                compactSplitStats = TDataRefOptionalHolder<TCompactBucketStats>(
+                    statsFromPrevTree->GetStatsAs<TCompactBucketStats>(splitEnsemble, splitStatsCount, &areStatsDirty)
+                );
+                if (depth == 0 || areStatsDirty) {
+                    calcStatsPointwise(
+                        /*isCaching*/ std::false_type(),
+                        fold,
+                        splitStatsCount,
+                        &compactSplitStats
+                    );
+                } else {
+                    calcStatsPointwise(
+                        /*isCaching*/ std::true_type(),
+                        prevLevelData,
+                        splitStatsCount,
+                        &compactSplitStats
+                    );
+                }
+            }
+            if (scoreCalcer) {
+                calcScores(compactSplitStats.GetData().data(), splitStatsCount);
+            }
+            releaseScratchStats();
+            return;
+        }
+
+        TBucketStatsRefOptionalHolder extOrInSplitStats;
+        int splitStatsCount = 0;
+
         if (!useTreeLevelCaching) {
             splitStatsCount = (ui64(1) << depth) * bucketCount;
             const int statsCount =
@@ -916,6 +1452,8 @@ void CalcStatsAndScores(
                 );
 
                 extOrInSplitStats = TBucketStatsRefOptionalHolder(stats3d->Stats);
+            } else {
+                getScratchStats(&extOrInSplitStats, splitStatsCount);
             }
             calcStatsPointwise(
                 /*isCaching*/ std::false_type(),
@@ -963,50 +1501,9 @@ void CalcStatsAndScores(
             }
         }
         if (scoreCalcer) {
-            const int leafCount = 1 << depth;
-            TSplitEnsembleSpec splitEnsembleSpec(
-                splitEnsemble,
-                objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
-                objectsDataProvider.GetFeaturesGroupsMetaData()
-            );
-            const int candidateSplitCount = CalcSplitsCount(
-                splitEnsembleSpec, bucketCount, oneHotMaxSize
-            );
-            scoreCalcer->SetSplitsCount(candidateSplitCount);
-
-            TVector<int> candidateSplitMonotonicConstraints;
-            if (!monotonicConstraints.empty()) {
-                candidateSplitMonotonicConstraints.resize(candidateSplitCount, 0);
-                for (int splitIdx : xrange(candidateSplitCount)) {
-                    const auto split = candidateInfo.GetSplit(
-                        splitIdx, objectsDataProvider, oneHotMaxSize
-                    );
-                    if (split.Type == ESplitType::FloatFeature) {
-                        Y_ASSERT(split.FeatureIdx >= 0);
-                        if (monotonicConstraints.contains(split.FeatureIdx)) {
-                            candidateSplitMonotonicConstraints[splitIdx] =
-                                monotonicConstraints.at(split.FeatureIdx);
-                        }
-                    }
-                }
-            }
-
-            CalculateNonPairwiseScore(
-                fold,
-                *initialFold,
-                splitEnsembleSpec,
-                isPlainMode,
-                leafCount,
-                l2Regularizer,
-                oneHotMaxSize,
-                TStatsIndexer(bucketCount),
-                extOrInSplitStats.GetData().data(),
-                splitStatsCount,
-                currTreeMonotonicConstraints,
-                candidateSplitMonotonicConstraints,
-                dynamic_cast<IPointwiseScoreCalcer*>(scoreCalcer)
-            );
+            calcScores(extOrInSplitStats.GetData().data(), splitStatsCount);
         }
+        releaseScratchStats();
     }
 }
 
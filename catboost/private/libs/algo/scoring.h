@@ -5,6 +5,7 @@
 
 #include <catboost/private/libs/data_types/pair.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
 #include <tuple>
@@ -13,6 +14,7 @@
 class TBucketStatsCache;
 class TCalcScoreFold;
 class TFold;
+struct TPairLeaves;
 struct TPairwiseStats;
 struct TCandidateInfo;
 struct TStats3D;
@@ -23,6 +25,7 @@ namespace NCatboostOptions {
 
 namespace NCB {
     class TQuantizedObjectsDataProvider;
+    struct TScratchCache;
 }
 
 namespace NPar {
@@ -43,6 +46,7 @@ void CalcStatsAndScores(
     // used only in score calculation, nullptr can be passed for stats (used in distibuted mode now)
     const TFold* initialFold,
     const TFlatPairsInfo& pairs,
+    TConstArrayRef<TPairLeaves> pairLeaves, // can be empty, if so - calculated from fold for each call
     const NCatboostOptions::TCatBoostOptions& fitParams,
     const TCandidateInfo& candidateInfo,
     int depth,
@@ -51,6 +55,7 @@ void CalcStatsAndScores(
     const TMap<ui32, int>& monotonicConstraints,
     NPar::ILocalExecutor* localExecutor,
     TBucketStatsCache* statsFromPrevTree,
+    NCB::TScratchCache* scratchCache, // can be nullptr, if so - stats are allocated for each call
     TStats3D* stats3d, // can be nullptr (and if PairwiseScoring must be), if so - don't return this data
 
     // can be nullptr (and if not PairwiseScoring must be), if so - don't return this data
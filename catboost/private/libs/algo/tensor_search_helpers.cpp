@@ -467,9 +467,14 @@ static void CalcWeightedData(
 
     const auto& learnWeights = ff.GetLearnWeights();
     if (!learnWeights.empty()) {
-        for (int i = 0; i < learnSampleCount; ++i) {
-            ff.SampleWeights[i] *= learnWeights[i];
-        }
+        const float* learnWeightsData = learnWeights.data();
+        float* sampleWeightsData = ff.SampleWeights.data();
+        localExecutor->ExecRange(
+            [=](int i) {
+                sampleWeightsData[i] *= learnWeightsData[i];
+            },
+            NPar::ILocalExecutor::TExecRangeParams(0, learnSampleCount).SetBlockSize(4000),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
     }
 }
 
@@ -566,7 +571,7 @@ void CalcWeightedDerivatives(
     const TVector<TVector<double>>& approx = bt.Approx;
     const TVector<float>& target = takenFold->LearnTarget[0];
     const TVector<float>& weight = takenFold->GetLearnWeights();
-    TVector<TVector<double>>* weightedDerivatives = &bt.WeightedDerivatives;
+    NCB::TRank2Array<double>* weightedDerivatives = &bt.WeightedDerivatives;
 
     if (error.GetErrorType() == EErrorType::QuerywiseError ||
         error.GetErrorType() == EErrorType::PairwiseError)
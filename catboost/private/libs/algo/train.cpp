@@ -179,6 +179,9 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
 
     CheckInterrupted(); // check after long-lasting operation
 
+    ctx->EnforceCpuRamLimit();
+    ctx->IterationArena.StartIteration();
+
     const double modelShrinkRate = ctx->Params.BoostingOptions->ModelShrinkRate.Get();
     if (modelShrinkRate > 0) {
         if (iterationIndex > 0) {
@@ -206,6 +209,7 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
     std::variant<TSplitTree, TNonSymmetricTreeStructure> bestTree;
     {
         TFold* takenFold = &ctx->LearnProgress->Folds[ctx->LearnProgress->Rand.GenRand() % foldCount];
+        TFold::MoveDerivativesToFold(ctx->LearnProgress->Folds, takenFold);
         const TVector<ui64> randomSeeds = GenRandUI64Vector(
             takenFold->BodyTailArr.ysize(),
             ctx->LearnProgress->Rand.GenRand()
@@ -248,8 +252,8 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
             trainFolds.push_back(&ctx->LearnProgress->Folds[foldId]);
         }
 
-        TrimOnlineCTRcache(trainFolds);
-        TrimOnlineCTRcache({ &ctx->LearnProgress->AveragingFold });
+        TrimOnlineCTRcache(trainFolds, *ctx);
+        TrimOnlineCTRcache({ &ctx->LearnProgress->AveragingFold }, *ctx);
         {
             TVector<TFold*> allFolds = trainFolds;
             allFolds.push_back(&ctx->LearnProgress->AveragingFold);
@@ -275,7 +279,10 @@ void TrainOneIteration(const NCB::TTrainingDataProviders& data, TLearnContext* c
                 }
                 for (auto* foldPtr : allFolds) {
                     auto* ownedCtrs = foldPtr->GetOwnedCtrs(proj);
-                    if (ownedCtrs && ownedCtrs->Data[proj].Feature.empty()) {
+                    if (ownedCtrs) {
+                        ownedCtrs->EnsureProjectionInData(proj);
+                    }
+                    if (ownedCtrs && ownedCtrs->UseProjectionData(proj)) {
                         parallelJobsData.emplace_back(
                             TLocalJobData{ &data, proj, foldPtr, ownedCtrs}
                         );
@@ -2,6 +2,7 @@
 #include <catboost/private/libs/algo/apply.h>
 
 #include <catboost/libs/data/data_provider_builders.h>
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/ut/lib/model_test_helpers.h>
 
 #include <util/generic/vector.h>
@@ -10,10 +11,49 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <cmath>
+
 
 using namespace NCB;
 
 
+static TDataProviderPtr CreateDataProviderWithFeatures(
+    const TVector<TVector<float>>& featuresData) {
+
+    return CreateDataProvider<IRawObjectsOrderDataVisitor>(
+        [&] (IRawObjectsOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)featuresData[0].size(),
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(
+                /*inBlock*/false,
+                metaInfo,
+                /*haveUnknownNumberOfSparseFeatures*/ false,
+                (ui32)featuresData.size(),
+                EObjectsOrder::Undefined,
+                /*resourceHolders*/ {});
+            visitor->StartNextBlock((ui32)featuresData.size());
+
+            for (auto objectIdx : xrange(featuresData.size())) {
+                visitor->AddAllFloatFeatures(objectIdx, featuresData[objectIdx]);
+            }
+
+            visitor->Finish();
+        });
+}
+
+static TObjectsDataProviderPtr CreateObjectsDataProviderWithFeatures(
+    const TVector<TVector<float>>& featuresData) {
+
+    return CreateDataProviderWithFeatures(featuresData)->ObjectsData;
+}
+
+
 Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
     const TVector<TVector<float>> DEFAULT_FEATURES = {
         {0.f, 0.f, 0.f},
@@ -26,38 +66,6 @@ Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
         {3.f, 1.f, 1.f},
     };
 
-    TObjectsDataProviderPtr CreateObjectsDataProviderWithFeatures(
-        const TVector<TVector<float>>& featuresData) {
-
-        auto dataProvider = CreateDataProvider<IRawObjectsOrderDataVisitor>(
-            [&] (IRawObjectsOrderDataVisitor* visitor) {
-                TDataMetaInfo metaInfo;
-                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
-                    (ui32)featuresData[0].size(),
-                    TVector<ui32>{},
-                    TVector<ui32>{},
-                    TVector<ui32>{},
-                    TVector<TString>{});
-
-                visitor->Start(
-                    /*inBlock*/false,
-                    metaInfo,
-                    /*haveUnknownNumberOfSparseFeatures*/ false,
-                    (ui32)featuresData.size(),
-                    EObjectsOrder::Undefined,
-                    /*resourceHolders*/ {});
-                visitor->StartNextBlock((ui32)featuresData.size());
-
-                for (auto objectIdx : xrange(featuresData.size())) {
-                    visitor->AddAllFloatFeatures(objectIdx, featuresData[objectIdx]);
-                }
-
-                visitor->Finish();
-            });
-
-        return dataProvider->ObjectsData;
-    };
-
     void CheckLeafIndexCalcer(
         const TFullModel& model,
         const TVector<TVector<float>>& features,
@@ -147,3 +155,115 @@ Y_UNIT_TEST_SUITE(TLeafIndexCalcerOnPool) {
         CheckLeafIndexCalcer(model, DEFAULT_FEATURES, expectedLeafIndexes);
     }
 }
+
+Y_UNIT_TEST_SUITE(TApplyModelToFlatFloatFeatures) {
+    Y_UNIT_TEST(TestSameAsApplyModelMulti) {
+        const auto model = SimpleFloatModel(2);
+        TVector<TVector<float>> features;
+        TVector<float> flatFeatures;
+        for (auto objectIdx : xrange(1000)) {
+            const TVector<float> objectFeatures = {float(objectIdx % 4), float(objectIdx % 3), float(objectIdx % 2)};
+            features.push_back(objectFeatures);
+            flatFeatures.insert(flatFeatures.end(), objectFeatures.begin(), objectFeatures.end());
+        }
+        const auto objectsData = CreateObjectsDataProviderWithFeatures(features);
+
+        for (auto predictionType : {EPredictionType::RawFormulaVal, EPredictionType::Exponent}) {
+            const auto expected = ApplyModelMulti(model, *objectsData, /*verbose*/ false, predictionType);
+            for (int threadCount : {1, 4}) {
+                TVector<double> results(features.size());
+                ApplyModelToFlatFloatFeatures(model, flatFeatures, 3, predictionType, 0, 0, threadCount, results);
+                for (auto objectIdx : xrange(features.size())) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(results[objectIdx], expected[0][objectIdx], 1e-9);
+                }
+            }
+        }
+
+        TVector<double> wrongSizeResults(features.size() + 1);
+        UNIT_ASSERT_EXCEPTION(
+            ApplyModelToFlatFloatFeatures(model, flatFeatures, 3, EPredictionType::RawFormulaVal, 0, 0, 1, wrongSizeResults),
+            TCatBoostException
+        );
+        TVector<double> results(features.size());
+        UNIT_ASSERT_EXCEPTION(
+            ApplyModelToFlatFloatFeatures(model, flatFeatures, 3, EPredictionType::Probability, 0, 0, 1, results),
+            TCatBoostException
+        );
+    }
+}
+
+Y_UNIT_TEST_SUITE(TApplyVirtualEnsembles) {
+    Y_UNIT_TEST(TestSameAsApplyModelMultiOnTreeRanges) {
+        const size_t treeCount = 10;
+        const size_t virtualEnsemblesCount = 2;
+        auto model = SimpleFloatModel(treeCount);
+        model.ModelInfo["params"] = R"({"boosting_options":{"learning_rate":0.5,"model_shrink_rate":0.2}})";
+        const double actualShrinkCoef = 0.1;
+
+        TVector<TVector<float>> features;
+        for (auto objectIdx : xrange(1000)) {
+            features.push_back({float(objectIdx % 4), float(objectIdx % 3), float(objectIdx % 2)});
+        }
+        const auto dataProvider = CreateDataProviderWithFeatures(features);
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TVector<TVector<double>> rawValues;
+        ApplyVirtualEnsembles(model, *dataProvider, treeCount, virtualEnsemblesCount, &rawValues, &executor);
+        UNIT_ASSERT_VALUES_EQUAL(rawValues.size(), virtualEnsemblesCount);
+
+        // evalPeriod = 10 / (2 * 2) = 2, ensembles are trees [0, 8) and [0, 10)
+        const TVector<int> ensembleEnds = {8, 10};
+        for (auto vEnsembleIdx : xrange(virtualEnsemblesCount)) {
+            const int ensembleEnd = ensembleEnds[vEnsembleIdx];
+            const double unshrinkCoef = (vEnsembleIdx + 1 != virtualEnsemblesCount)
+                ? pow(1. - actualShrinkCoef, ensembleEnd - int(treeCount))
+                : 1.;
+            const auto expected = ApplyModelMulti(
+                model,
+                *dataProvider->ObjectsData,
+                EPredictionType::InternalRawFormulaVal,
+                0,
+                ensembleEnd);
+            UNIT_ASSERT_VALUES_EQUAL(rawValues[vEnsembleIdx].size(), features.size());
+            for (auto objectIdx : xrange(features.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(rawValues[vEnsembleIdx][objectIdx], expected[0][objectIdx] * unshrinkCoef, 1e-5);
+            }
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TModelCalcerOnPool) {
+    Y_UNIT_TEST(TestAddModelRawApproxOnTreeRanges) {
+        const int treeCount = 10;
+        const auto model = SimpleFloatModel(treeCount);
+
+        TVector<TVector<float>> features;
+        for (auto objectIdx : xrange(1000)) {
+            features.push_back({float(objectIdx % 4), float(objectIdx % 3), float(objectIdx % 2)});
+        }
+        const auto objectsData = CreateObjectsDataProviderWithFeatures(features);
+        const auto expected = ApplyModelMulti(
+            model,
+            *objectsData,
+            EPredictionType::InternalRawFormulaVal,
+            0,
+            treeCount);
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        TModelCalcerOnPool modelCalcer(model, objectsData, &executor);
+
+        const size_t approxDocOffset = 5;
+        TVector<TVector<double>> approx(1, TVector<double>(approxDocOffset + features.size(), 0.0));
+        for (int begin = 0; begin < treeCount; begin += 3) {
+            modelCalcer.AddModelRawApprox(begin, Min(begin + 3, treeCount), approxDocOffset, &approx);
+        }
+        for (auto objectIdx : xrange(approxDocOffset)) {
+            UNIT_ASSERT_VALUES_EQUAL(approx[0][objectIdx], 0.0);
+        }
+        for (auto objectIdx : xrange(features.size())) {
+            UNIT_ASSERT_DOUBLES_EQUAL(approx[0][approxDocOffset + objectIdx], expected[0][objectIdx], 1e-9);
+        }
+    }
+}
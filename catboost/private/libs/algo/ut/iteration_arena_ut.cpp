@@ -0,0 +1,62 @@
+#include <catboost/private/libs/algo/iteration_arena.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <util/system/thread.h>
+
+
+Y_UNIT_TEST_SUITE(TIterationArenaTest) {
+    Y_UNIT_TEST(TestReuseAfterStartIteration) {
+        TIterationArena arena;
+        TMemoryPool* pool = arena.GetThreadPool();
+        UNIT_ASSERT_EQUAL(pool, arena.GetThreadPool());
+
+        const double* firstIterationData = nullptr;
+        {
+            TIterationArenaVector<double> values(1000, 1.0, TPoolAlloc<double>(pool));
+            firstIterationData = values.data();
+        }
+        const size_t memoryUsage = arena.GetMemoryUsage();
+        UNIT_ASSERT(memoryUsage >= 1000 * sizeof(double));
+
+        arena.StartIteration();
+        TIterationArenaVector<double> values(1000, 2.0, TPoolAlloc<double>(arena.GetThreadPool()));
+        UNIT_ASSERT_EQUAL(values.data(), firstIterationData);
+        UNIT_ASSERT_VALUES_EQUAL(arena.GetMemoryUsage(), memoryUsage);
+    }
+
+    Y_UNIT_TEST(TestCapacityIsKept) {
+        TIterationArena arena;
+        const auto allocate = [&] () {
+            // doesn't fit into the initial chunk
+            TIterationArenaVector<ui8> values(1 << 20, 0, TPoolAlloc<ui8>(arena.GetThreadPool()));
+            return values.data();
+        };
+        allocate();
+        arena.StartIteration();
+        const ui8* secondIterationData = allocate();
+        const size_t memoryUsage = arena.GetMemoryUsage();
+        UNIT_ASSERT(memoryUsage >= (1 << 20));
+
+        arena.StartIteration();
+        UNIT_ASSERT_EQUAL(allocate(), secondIterationData);
+        UNIT_ASSERT_VALUES_EQUAL(arena.GetMemoryUsage(), memoryUsage);
+    }
+
+    Y_UNIT_TEST(TestThreadsHaveSeparatePools) {
+        TIterationArena arena;
+        TIterationArena otherArena;
+        TMemoryPool* mainThreadPool = arena.GetThreadPool();
+        UNIT_ASSERT_UNEQUAL(mainThreadPool, otherArena.GetThreadPool());
+        UNIT_ASSERT_EQUAL(mainThreadPool, arena.GetThreadPool());
+
+        TMemoryPool* otherThreadPool = nullptr;
+        TThread thread([&] () {
+            otherThreadPool = arena.GetThreadPool();
+        });
+        thread.Start();
+        thread.Join();
+        UNIT_ASSERT(otherThreadPool);
+        UNIT_ASSERT_UNEQUAL(mainThreadPool, otherThreadPool);
+    }
+}
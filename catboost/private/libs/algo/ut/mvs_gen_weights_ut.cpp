@@ -17,7 +17,7 @@ Y_UNIT_TEST_SUITE(mvs) {
 
         TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
 
-        bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+        bt.WeightedDerivatives.Resize(1, SampleCount);
         bt.Approx.resize(1, TVector<double>(SampleCount));
 
         for (ui32 j = 0; j < CB_THREAD_LIMIT; ++j) {
@@ -58,7 +58,7 @@ Y_UNIT_TEST_SUITE(mvs) {
 
         TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
 
-        bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+        bt.WeightedDerivatives.Resize(1, SampleCount);
         bt.Approx.resize(1, TVector<double>(SampleCount));
 
         for (ui32 j = 0; j < CB_THREAD_LIMIT; ++j) {
@@ -99,7 +99,7 @@ Y_UNIT_TEST_SUITE(mvs) {
 
         TFold::TBodyTail bt(0, 0, SampleCountAsInt, SampleCountAsInt, (double)SampleCountAsInt);
 
-        bt.WeightedDerivatives.resize(1, TVector<double>(SampleCount));
+        bt.WeightedDerivatives.Resize(1, SampleCount);
         bt.Approx.resize(1, TVector<double>(SampleCount));
 
         for (ui32 j = 0; j < CB_THREAD_LIMIT; ++j) {
@@ -39,11 +39,16 @@ static TPairwiseStats CalcPairwiseStats(
         NCB::TIndexRange<int>(docCount));
     const auto flatPairs = UnpackPairsFromQueries(queriesInfo);
     const int pairCount = flatPairs.ysize();
+    TVector<TPairLeaves> pairLeaves(pairCount);
+    for (int pairIdx = 0; pairIdx < pairCount; ++pairIdx) {
+        pairLeaves[pairIdx].WinnerLeaf = leafIndices[flatPairs[pairIdx].WinnerId];
+        pairLeaves[pairIdx].LoserLeaf = leafIndices[flatPairs[pairIdx].LoserId];
+    }
     pairwiseStats.PairWeightStatistics = ComputePairWeightStatistics(
         flatPairs,
         leafCount,
         bucketCount,
-        leafIndices,
+        pairLeaves,
         [&](ui32 docId) { return bucketIndices[docId]; },
         NCB::TIndexRange<int>(pairCount));
     pairwiseStats.SplitEnsembleSpec = TSplitEnsembleSpec::OneSplit(ESplitType::FloatFeature);
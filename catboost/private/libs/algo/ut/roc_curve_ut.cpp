@@ -0,0 +1,46 @@
+#include <catboost/private/libs/algo/roc_curve.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <cmath>
+
+
+Y_UNIT_TEST_SUITE(TRocCurveTest) {
+    Y_UNIT_TEST(BinnedCurveIsSameAsExactForSeparableBins) {
+        // approxes with few significant bits fall into different bins
+        TReallyFastRng32 rng(239);
+        TVector<TVector<double>> approxes(2);
+        TVector<TVector<float>> targets(2);
+        for (auto poolIdx : {0, 1}) {
+            for (ui32 docIdx = 0; docIdx < 1000; ++docIdx) {
+                const int approxKey = rng.Uniform(33);
+                approxes[poolIdx].push_back((approxKey - 16) / 4.0);
+                targets[poolIdx].push_back(rng.Uniform(40) < approxKey + 4 ? 1.0f : 0.0f);
+            }
+        }
+        const TVector<TConstArrayRef<float>> labels = {targets[0], targets[1]};
+
+        TRocCurve exactCurve(approxes, labels, /*threadCount*/ 1);
+        for (int threadCount : {1, 4}) {
+            TRocCurve binnedCurve(approxes, labels, threadCount, /*histogramBinBits*/ 16);
+
+            const auto exactPoints = exactCurve.GetCurvePoints();
+            const auto binnedPoints = binnedCurve.GetCurvePoints();
+            UNIT_ASSERT_VALUES_EQUAL(exactPoints.size(), binnedPoints.size());
+            for (size_t pointIdx = 0; pointIdx < exactPoints.size(); ++pointIdx) {
+                if (pointIdx > 0) {
+                    UNIT_ASSERT(binnedPoints[pointIdx].Boundary < binnedPoints[pointIdx - 1].Boundary);
+                }
+                const auto& exactPoint = exactPoints[pointIdx];
+                if (std::abs(exactPoint.FalseNegativeRate - exactPoint.FalsePositiveRate) < TRocCurve::EPS) {
+                    continue; // the intersection depends on boundaries
+                }
+                UNIT_ASSERT_DOUBLES_EQUAL(exactPoint.FalseNegativeRate, binnedPoints[pointIdx].FalseNegativeRate, 1e-12);
+                UNIT_ASSERT_DOUBLES_EQUAL(exactPoint.FalsePositiveRate, binnedPoints[pointIdx].FalsePositiveRate, 1e-12);
+            }
+        }
+    }
+}
@@ -142,4 +142,253 @@ Y_UNIT_TEST_SUITE(TTrainTest) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestCompactBucketStats) {
+        const size_t TestDocCount = 2000;
+        const ui32 FactorCount = 10;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+        for (auto& feature : features) {
+            feature.yresize(TestDocCount);
+        }
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            for (size_t j = 0; j < FactorCount; ++j) {
+                features[j][i] = rng.GenRandReal2();
+            }
+            target[i] = features[0][i] + 2 * features[1][i] * features[2][i] + 0.1 * rng.GenRandReal2();
+        }
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<TString>{});
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+                for (auto factorId : xrange(FactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features[factorId]))
+                    );
+                }
+                visitor->AddTarget(
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target))
+                );
+                visitor->Finish();
+            }
+        );
+
+        // ordered boosting uses all sums of bucket stats, the depth is enough for tree level caching
+        for (auto boostingType : {"Plain", "Ordered"}) {
+            NJson::TJsonValue plainFitParams;
+            plainFitParams.InsertValue("random_seed", 5);
+            plainFitParams.InsertValue("iterations", 20);
+            plainFitParams.InsertValue("depth", 4);
+            plainFitParams.InsertValue("boosting_type", boostingType);
+            plainFitParams.InsertValue("train_dir", ".");
+            plainFitParams.InsertValue("thread_count", 2);
+
+            TVector<TFullModel> models(2);
+            for (auto useCompactBucketStats : {false, true}) {
+                plainFitParams.InsertValue("dev_compact_bucket_stats", useCompactBucketStats);
+                TEvalResult testApprox;
+                TrainModel(
+                    plainFitParams,
+                    nullptr,
+                    Nothing(),
+                    Nothing(),
+                    Nothing(),
+                    dataProviders,
+                    /*initModel*/ Nothing(),
+                    /*initLearnProgress*/ nullptr,
+                    "",
+                    &models[useCompactBucketStats],
+                    {&testApprox}
+                );
+            }
+
+            const auto& treeData = *models[0].ModelTrees->GetModelTreeData();
+            const auto& compactTreeData = *models[1].ModelTrees->GetModelTreeData();
+            UNIT_ASSERT(Equal(treeData.GetTreeSplits(), compactTreeData.GetTreeSplits()));
+            for (auto leafIdx : xrange(treeData.GetLeafValues().size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(
+                    treeData.GetLeafValues()[leafIdx],
+                    compactTreeData.GetLeafValues()[leafIdx],
+                    1e-6);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestRescoredCandidatesCount) {
+        const size_t TestDocCount = 2000;
+        const ui32 FactorCount = 10;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+        for (auto& feature : features) {
+            feature.yresize(TestDocCount);
+        }
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            for (size_t j = 0; j < FactorCount; ++j) {
+                features[j][i] = rng.GenRandReal2();
+            }
+            target[i] = features[0][i] + 2 * features[1][i] * features[2][i] + 0.1 * rng.GenRandReal2();
+        }
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<TString>{});
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+                for (auto factorId : xrange(FactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features[factorId]))
+                    );
+                }
+                visitor->AddTarget(
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target))
+                );
+                visitor->Finish();
+            }
+        );
+
+        NJson::TJsonValue plainFitParams;
+        plainFitParams.InsertValue("random_seed", 5);
+        plainFitParams.InsertValue("iterations", 20);
+        plainFitParams.InsertValue("depth", 4);
+        plainFitParams.InsertValue("boosting_type", "Plain");
+        plainFitParams.InsertValue("train_dir", ".");
+        plainFitParams.InsertValue("thread_count", 2);
+
+        // all features are rescored if their count does not exceed the option, the first tree has no history
+        const TVector<ui32> rescoredCandidatesCounts = {0, FactorCount, 3};
+        TVector<TFullModel> models(rescoredCandidatesCounts.size());
+        for (auto idx : xrange(rescoredCandidatesCounts.size())) {
+            plainFitParams.InsertValue("dev_rescored_candidates_count", rescoredCandidatesCounts[idx]);
+            TEvalResult testApprox;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &models[idx],
+                {&testApprox}
+            );
+        }
+
+        const auto& treeData = *models[0].ModelTrees->GetModelTreeData();
+        const auto& allRescoredTreeData = *models[1].ModelTrees->GetModelTreeData();
+        UNIT_ASSERT(Equal(treeData.GetTreeSplits(), allRescoredTreeData.GetTreeSplits()));
+
+        const auto& partRescoredTreeData = *models[2].ModelTrees->GetModelTreeData();
+        UNIT_ASSERT_VALUES_EQUAL(treeData.GetTreeSizes().size(), partRescoredTreeData.GetTreeSizes().size());
+        const size_t firstTreeSize = treeData.GetTreeSizes()[0];
+        UNIT_ASSERT_VALUES_EQUAL(firstTreeSize, partRescoredTreeData.GetTreeSizes()[0]);
+        UNIT_ASSERT(
+            Equal(
+                treeData.GetTreeSplits().begin(),
+                treeData.GetTreeSplits().begin() + firstTreeSize,
+                partRescoredTreeData.GetTreeSplits().begin()));
+    }
+
+    Y_UNIT_TEST(TestTimeLimit) {
+        const size_t TestDocCount = 200;
+        const ui32 FactorCount = 3;
+
+        TReallyFastRng32 rng(123);
+
+        TVector<float> target(TestDocCount);
+        TVector<TVector<float>> features(FactorCount); // [featureIdx][objectIdx]
+        for (auto& feature : features) {
+            feature.yresize(TestDocCount);
+        }
+        for (size_t i = 0; i < TestDocCount; ++i) {
+            for (size_t j = 0; j < FactorCount; ++j) {
+                features[j][i] = rng.GenRandReal2();
+            }
+            target[i] = features[0][i] + features[1][i] * features[2][i];
+        }
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.TargetType = ERawTargetType::Float;
+                metaInfo.TargetCount = 1;
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    FactorCount,
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<ui32>{},
+                    TVector<TString>{});
+
+                visitor->Start(metaInfo, TestDocCount, EObjectsOrder::Undefined, {});
+                for (auto factorId : xrange(FactorCount)) {
+                    visitor->AddFloatFeature(
+                        factorId,
+                        MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(features[factorId]))
+                    );
+                }
+                visitor->AddTarget(
+                    MakeIntrusive<TTypeCastArrayHolder<float, float>>(TVector<float>(target))
+                );
+                visitor->Finish();
+            }
+        );
+
+        NJson::TJsonValue plainFitParams;
+        plainFitParams.InsertValue("random_seed", 5);
+        plainFitParams.InsertValue("iterations", 20);
+        plainFitParams.InsertValue("depth", 4);
+        plainFitParams.InsertValue("train_dir", ".");
+        plainFitParams.InsertValue("thread_count", 2);
+
+        // the first iteration is always trained, its time is the estimate for the next ones
+        for (auto [timeLimit, expectedTreeCount] : {std::make_pair(1e-9, size_t(1)), std::make_pair(1e6, size_t(20))}) {
+            plainFitParams.InsertValue("time_limit", timeLimit);
+            TFullModel model;
+            TEvalResult testApprox;
+            TrainModel(
+                plainFitParams,
+                nullptr,
+                Nothing(),
+                Nothing(),
+                Nothing(),
+                dataProviders,
+                /*initModel*/ Nothing(),
+                /*initLearnProgress*/ nullptr,
+                "",
+                &model,
+                {&testApprox}
+            );
+            UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), expectedTreeCount);
+        }
+    }
 }
@@ -62,14 +62,10 @@ namespace {
     }
 
 
+    // Weights are accumulated in flat querySize x querySize matrix [winner][loser]
     class TYetiRankPairWeightsCalcer {
     public:
-        TYetiRankPairWeightsCalcer(
-            const NCatboostOptions::TLossDescription& lossDescription,
-            const float* relevs,
-            ui32 querySize
-        ) : Relevs(relevs), QuerySize(querySize)
-        {
+        explicit TYetiRankPairWeightsCalcer(const NCatboostOptions::TLossDescription& lossDescription) {
             CB_ENSURE(
                 EqualToOneOf(lossDescription.GetLossFunction(), ELossFunction::YetiRank, ELossFunction::YetiRankPairwise),
                 "Loss should be YetiRank or YetiRankPairwise"
@@ -97,7 +93,14 @@ namespace {
             NumNeighbors = NCatboostOptions::GetParamOrDefault(params, "num_neighbors", 1);
         }
 
-        void CalcWeights(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        // Options are parsed once, so one calcer is reused for all queries of a block
+        void SetQuery(const float* relevs, ui32 querySize) {
+            Relevs = relevs;
+            QuerySize = querySize;
+            IDcg = Nothing();
+        }
+
+        void CalcWeights(const TVector<int>& permutation, TArrayRef<float> competitorsWeights) {
             switch (Mode) {
                 case EYetiRankWeightsMode::Classic:
                     CalcWeightsClassic(permutation, competitorsWeights);
@@ -140,8 +143,8 @@ namespace {
         }
 
     private:
-        const float* Relevs;
-        const ui32 QuerySize;
+        const float* Relevs = nullptr;
+        ui32 QuerySize = 0;
 
         EYetiRankWeightsMode Mode = EYetiRankWeightsMode::Classic;
         double Decay = 0.99;
@@ -168,15 +171,15 @@ namespace {
             return *IDcg;
         }
 
-        void AddWeight(int firstCandidate, int secondCandidate, float pairWeight, TVector<TVector<float>>* competitorsWeights) {
+        void AddWeight(int firstCandidate, int secondCandidate, float pairWeight, TArrayRef<float> competitorsWeights) {
             if (Relevs[firstCandidate] > Relevs[secondCandidate]) {
-                (*competitorsWeights)[firstCandidate][secondCandidate] += pairWeight;
+                competitorsWeights[firstCandidate * QuerySize + secondCandidate] += pairWeight;
             } else if (Relevs[firstCandidate] < Relevs[secondCandidate]) {
-                (*competitorsWeights)[secondCandidate][firstCandidate] += pairWeight;
+                competitorsWeights[secondCandidate * QuerySize + firstCandidate] += pairWeight;
             }
         }
 
-        void CalcWeightsClassic(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsClassic(const TVector<int>& permutation, TArrayRef<float> competitorsWeights) {
             double decayCoefficient = 1;
             for (ui32 docId = 1; docId < QuerySize; ++docId) {
                 const int firstCandidate = permutation[docId - 1];
@@ -196,7 +199,7 @@ namespace {
             return position < TopSize ? numerator / denominator : 0.0;
         }
 
-        void CalcWeightsDCG(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights, double coef) {
+        void CalcWeightsDCG(const TVector<int>& permutation, TArrayRef<float> competitorsWeights, double coef) {
             const ui32 topSize = Min(TopSize, QuerySize);
             for (ui32 docId = 1; docId <= topSize; ++docId) {
                 const ui32 bound = NumNeighbors == -1 ? QuerySize : Min(QuerySize, docId + NumNeighbors);
@@ -213,7 +216,7 @@ namespace {
             }
         }
 
-        void CalcWeightsMRR(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsMRR(const TVector<int>& permutation, TArrayRef<float> competitorsWeights) {
             const ui32 topSize = Min(TopSize, QuerySize);
             bool wasRelevant = false;
             for (ui32 docId = 1; docId <= topSize && !wasRelevant; ++docId) {
@@ -233,7 +236,7 @@ namespace {
             }
         }
 
-        void CalcWeightsERR(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsERR(const TVector<int>& permutation, TArrayRef<float> competitorsWeights) {
             const ui32 topSize = Min(TopSize, QuerySize);
             double pFirstLook = 1.0;
             for (ui32 docId = 1; docId <= topSize; ++docId) {
@@ -260,7 +263,7 @@ namespace {
             }
         }
 
-        void CalcWeightsMAP(const TVector<int>& permutation, TVector<TVector<float>>* competitorsWeights) {
+        void CalcWeightsMAP(const TVector<int>& permutation, TArrayRef<float> competitorsWeights) {
             const ui32 topSize = Min(TopSize, QuerySize);
             for (ui32 docId = 1; docId <= topSize; ++docId) {
                 const int firstCandidate = permutation[docId - 1];
@@ -285,6 +288,13 @@ namespace {
         }
 
     };
+
+    // Buffers reused for all queries of a block
+    struct TYetiRankQueryBuffers {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<float> CompetitorsWeights;
+    };
 }
 
 
@@ -297,18 +307,22 @@ static void GenerateYetiRankPairsForQuery(
     double /*decaySpeed*/,
     ui64 randomSeed,
     TVector<TVector<TCompetitor>>* competitors,
-    TYetiRankPairWeightsCalcer* weightsCalcer
+    TYetiRankPairWeightsCalcer* weightsCalcer,
+    TYetiRankQueryBuffers* buffers
 ) {
     TFastRng64 rand(randomSeed);
     TVector<TVector<TCompetitor>>& competitorsRef = *competitors;
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    TVector<int>& indices = buffers->Indices;
+    indices.yresize(querySize);
+    TVector<double>& bootstrappedApprox = buffers->BootstrappedApprox;
+    TVector<float>& competitorsWeights = buffers->CompetitorsWeights;
+    competitorsWeights.assign((size_t)querySize * querySize, 0.0f);
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        bootstrappedApprox.assign(expApproxes, expApproxes + querySize);
         weightsCalcer->AddNoise(bootstrappedApprox, rand);
 
         Sort(
@@ -317,14 +331,13 @@ static void GenerateYetiRankPairsForQuery(
                 return bootstrappedApprox[i] > bootstrappedApprox[j];
             }
         );
-        weightsCalcer->CalcWeights(indices, &competitorsWeights);
+        weightsCalcer->CalcWeights(indices, competitorsWeights);
     }
 
-    // TODO(nikitxskv): Can be optimized
     for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        const float* winnerWeights = competitorsWeights.data() + (size_t)winnerIndex * querySize;
         for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight
-                = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+            const float competitorsWeight = queryWeight * winnerWeights[loserIndex] / permutationCount;
             if (competitorsWeight != 0) {
                 competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
             }
@@ -356,12 +369,13 @@ void UpdatePairsForYetiRank(
         blockCount,
         [&](int blockId) {
             TFastRng64 rand(randomSeeds[blockId]);
+            TYetiRankPairWeightsCalcer weightsCalcer(lossDescription);
+            TYetiRankQueryBuffers buffers;
             const int from = queryBegin + blockId * blockSize;
             const int to = Min<int>(queryBegin + (blockId + 1) * blockSize, queryEnd);
             for (int queryIndex = from; queryIndex < to; ++queryIndex) {
                 TQueryInfo& queryInfoRef = (*queriesInfo)[queryIndex];
-                TYetiRankPairWeightsCalcer weightsCalcer(
-                    lossDescription,
+                weightsCalcer.SetQuery(
                     relevances.data() + queryInfoRef.Begin,
                     queryInfoRef.End - queryInfoRef.Begin
                 );
@@ -374,7 +388,8 @@ void UpdatePairsForYetiRank(
                     decaySpeed,
                     rand.GenRand(),
                     &queryInfoRef.Competitors,
-                    &weightsCalcer
+                    &weightsCalcer,
+                    &buffers
                 );
             }
         }
@@ -2,6 +2,8 @@
 
 #include <catboost/libs/helpers/dispatch_generic_lambda.h>
 
+#include <util/generic/ymath.h>
+
 inline void AddDersRangeMulti(
     TConstArrayRef<TIndexType> leafIndices,
     TConstArrayRef<TConstArrayRef<float>> target,
@@ -14,47 +16,67 @@ inline void AddDersRangeMulti(
     bool isUpdateWeight,
     TArrayRef<TSumMulti> leafDers // [dimensionIdx]
 ) {
-    const auto* multiError = dynamic_cast<const TMultiDerCalcer*>(&error);
-    const bool isMultiTarget = multiError != nullptr;
-
     const int approxDimension = approx.size();
+    const int targetDimension = target.size();
     const bool useHessian = !leafDers[0].SumDer2.Data.empty();
-    THessianInfo curDer2(useHessian * approxDimension, error.GetHessianType());
-    TVector<double> curDer(approxDimension);
-    constexpr int UnrollMaxCount = 16;
-    TVector<TVector<double>> curApprox(UnrollMaxCount, TVector<double>(approxDimension));
-    TVector<TVector<float>> curTarget;
-    if (isMultiTarget) {
-        curTarget = TVector<TVector<float>>(UnrollMaxCount, TVector<float>(target.size()));
-    }
+    const size_t hessianSize = leafDers[0].SumDer2.Data.size();
+    constexpr int BlockSize = IDerCalcer::MaxDersMultiBlockSize;
+    // dimension-major blocks
+    TVector<double> blockApprox(approxDimension * BlockSize);
+    TVector<float> blockTarget(targetDimension * BlockSize);
+    TVector<double> blockDer(approxDimension * BlockSize);
+    TVector<double> blockDer2(hessianSize * BlockSize);
 
-    const auto addDersRangeMultiImpl = [&](auto useWeights, auto useLeafIndices, auto useHessian, auto isMultiTarget) {
-        for (int columnIdx = rowBegin; columnIdx < rowEnd; columnIdx += UnrollMaxCount) {
-            const int unrollCount = Min(UnrollMaxCount, rowEnd - columnIdx);
-            SumTransposedBlocks(columnIdx, columnIdx + unrollCount, approx, approxDeltas, MakeArrayRef(curApprox));
-            if (isMultiTarget) {
-                SumTransposedBlocks(columnIdx, columnIdx + unrollCount, target, /*targetDeltas*/{}, MakeArrayRef(curTarget));
-            }
-            for (int unrollIdx : xrange(unrollCount)) {
-                const double w = useWeights ? weight[columnIdx + unrollIdx] : 1;
-
-                if (isMultiTarget) {
-                    multiError->CalcDers(curApprox[unrollIdx], curTarget[unrollIdx], w, &curDer, useHessian ? &curDer2 : nullptr);
+    const auto addDersRangeMultiImpl = [&](auto useWeights, auto useLeafIndices, auto useHessian, auto hasDelta) {
+        for (int blockBegin = rowBegin; blockBegin < rowEnd; blockBegin += BlockSize) {
+            const int blockSize = Min(BlockSize, rowEnd - blockBegin);
+            for (int dim : xrange(approxDimension)) {
+                const double* approxPtr = approx[dim].data() + blockBegin;
+                double* blockApproxPtr = blockApprox.data() + dim * blockSize;
+                if (hasDelta) {
+                    const double* approxDeltaPtr = approxDeltas[dim].data() + blockBegin;
+                    for (int idx : xrange(blockSize)) {
+                        blockApproxPtr[idx] = approxPtr[idx] + approxDeltaPtr[idx];
+                    }
                 } else {
-                    error.CalcDersMulti(curApprox[unrollIdx], target[0][columnIdx + unrollIdx], w, &curDer, useHessian ? &curDer2 : nullptr);
+                    Copy(approxPtr, approxPtr + blockSize, blockApproxPtr);
                 }
+            }
+            for (int dim : xrange(targetDimension)) {
+                const float* targetPtr = target[dim].data() + blockBegin;
+                Copy(targetPtr, targetPtr + blockSize, blockTarget.data() + dim * blockSize);
+            }
+            const TConstArrayRef<float> blockWeight = useWeights
+                ? MakeArrayRef(weight.data() + blockBegin, blockSize)
+                : TConstArrayRef<float>();
+            error.CalcDersMultiBlock(
+                blockSize,
+                MakeArrayRef(blockApprox.data(), approxDimension * blockSize),
+                MakeArrayRef(blockTarget.data(), targetDimension * blockSize),
+                blockWeight,
+                MakeArrayRef(blockDer.data(), approxDimension * blockSize),
+                MakeArrayRef(blockDer2.data(), useHessian ? hessianSize * blockSize : 0));
 
-                TSumMulti& curLeafDers = useLeafIndices ? leafDers[leafIndices[columnIdx + unrollIdx]] : leafDers[0];
+            for (int idx : xrange(blockSize)) {
+                TSumMulti& curLeafDers = useLeafIndices ? leafDers[leafIndices[blockBegin + idx]] : leafDers[0];
+                double* sumDer = curLeafDers.SumDer.data();
+                for (int dim : xrange(approxDimension)) {
+                    sumDer[dim] += blockDer[dim * blockSize + idx];
+                }
                 if (useHessian) {
-                    curLeafDers.AddDerDer2(curDer, curDer2);
-                } else {
-                    curLeafDers.AddDerWeight(curDer, w, isUpdateWeight);
+                    double* sumDer2 = curLeafDers.SumDer2.Data.data();
+                    const double* der2 = blockDer2.data() + idx * hessianSize;
+                    for (size_t hessianIdx : xrange(hessianSize)) {
+                        sumDer2[hessianIdx] += der2[hessianIdx];
+                    }
+                } else if (isUpdateWeight) {
+                    curLeafDers.SumWeights += useWeights ? weight[blockBegin + idx] : 1;
                 }
             }
         }
     };
 
-    DispatchGenericLambda(addDersRangeMultiImpl, !weight.empty(), !leafIndices.empty(), useHessian, isMultiTarget);
+    DispatchGenericLambda(addDersRangeMultiImpl, !weight.empty(), !leafIndices.empty(), useHessian, !approxDeltas.empty());
 }
 
 void CalcLeafDersMulti(
@@ -77,10 +99,12 @@ void CalcLeafDersMulti(
         curLeafDers.SetZeroDers();
     }
     const auto& zeroDers = MakeZeroDers(approxDimension, estimationMethod, error.GetHessianType());
-    const auto hessianSize = zeroDers.SumDer2.Data.size();
     NCB::MapMerge(
         localExecutor,
-        NCB::TSimpleIndexRangesGenerator<int>(NCB::TIndexRange<int>(sampleCount), /*blockSize*/Max<ui32>(1000, hessianSize / CB_THREAD_LIMIT)),
+        // one part per thread, so sums of all leaves are allocated for a few parts only
+        NCB::TSimpleIndexRangesGenerator<int>(
+            NCB::TIndexRange<int>(sampleCount),
+            /*blockSize*/Max<int>(1000, CeilDiv<int>(sampleCount, localExecutor->GetThreadCount() + 1))),
         /*mapFunc*/[&](NCB::TIndexRange<int> partIndexRange, TVector<TSumMulti>* leafDers) {
             Y_ASSERT(!partIndexRange.Empty());
             leafDers->resize(leafCount, zeroDers);
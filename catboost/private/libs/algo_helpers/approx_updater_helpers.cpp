@@ -1,6 +1,7 @@
 #include "approx_updater_helpers.h"
 
 #include <catboost/libs/helpers/map_merge.h>
+#include <catboost/libs/helpers/parallel_tasks.h>
 
 
 using namespace NCB;
@@ -42,14 +43,19 @@ void InitApproxes(
     const TMaybe<TVector<double>>& startingApprox,
     double approxDimension,
     bool storeExpApproxes,
+    NPar::ILocalExecutor* localExecutor,
     TVector<TVector<double>>* approx
 ) {
     approx->resize(approxDimension);
     Y_ASSERT(!startingApprox.Defined() || startingApprox->ysize() == approxDimension);
     for (auto dim : xrange(approxDimension)) {
-        (*approx)[dim].resize(
-            size,
-            startingApprox ? ExpApproxIf(storeExpApproxes, (*startingApprox)[dim]) : GetNeutralApprox(storeExpApproxes)
+        // fill in parallel, so that memory pages are first touched by the threads which will process them
+        (*approx)[dim].yresize(size);
+        ParallelFill(
+            startingApprox ? ExpApproxIf(storeExpApproxes, (*startingApprox)[dim]) : GetNeutralApprox(storeExpApproxes),
+            /*blockSize*/ Nothing(),
+            localExecutor,
+            MakeArrayRef((*approx)[dim])
         );
     }
 }
@@ -237,4 +237,5 @@ void InitApproxes(
     const TMaybe<TVector<double>>& startingApprox,
     double approxDimension,
     bool storeExpApproxes,
+    NPar::ILocalExecutor* localExecutor,
     TVector<TVector<double>>* approx);
@@ -6,6 +6,8 @@
 #include <util/generic/xrange.h>
 #include <util/random/normal.h>
 
+#include <array>
+
 
 using namespace NCB;
 
@@ -113,6 +115,171 @@ void IDerCalcer::CalcDersRange(
     useTDers, IsExpApprox, hasDelta);
 }
 
+void IDerCalcer::CalcDersMultiBlock(
+    int blockSize,
+    TConstArrayRef<double> approxes,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TArrayRef<double> ders,
+    TArrayRef<double> der2
+) const {
+    const int approxDimension = approxes.size() / blockSize;
+    TVector<double> approx(approxDimension);
+    TVector<double> der(approxDimension);
+    THessianInfo objectDer2(der2.empty() ? 0 : approxDimension, GetHessianType());
+    const size_t hessianSize = objectDer2.Data.size();
+    for (int objectIdx : xrange(blockSize)) {
+        for (int dim : xrange(approxDimension)) {
+            approx[dim] = approxes[dim * blockSize + objectIdx];
+        }
+        const float weight = weights.empty() ? 1.0f : weights[objectIdx];
+        CalcDersMulti(approx, targets[objectIdx], weight, &der, der2.empty() ? nullptr : &objectDer2);
+        for (int dim : xrange(approxDimension)) {
+            ders[dim * blockSize + objectIdx] = der[dim];
+        }
+        Copy(objectDer2.Data.begin(), objectDer2.Data.end(), der2.begin() + objectIdx * hessianSize);
+    }
+}
+
+void TMultiDerCalcer::CalcDersMultiBlock(
+    int blockSize,
+    TConstArrayRef<double> approxes,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TArrayRef<double> ders,
+    TArrayRef<double> der2
+) const {
+    const int approxDimension = approxes.size() / blockSize;
+    const int targetDimension = targets.size() / blockSize;
+    TVector<double> approx(approxDimension);
+    TVector<float> target(targetDimension);
+    TVector<double> der(approxDimension);
+    THessianInfo objectDer2(der2.empty() ? 0 : approxDimension, GetHessianType());
+    const size_t hessianSize = objectDer2.Data.size();
+    for (int objectIdx : xrange(blockSize)) {
+        for (int dim : xrange(approxDimension)) {
+            approx[dim] = approxes[dim * blockSize + objectIdx];
+        }
+        for (int dim : xrange(targetDimension)) {
+            target[dim] = targets[dim * blockSize + objectIdx];
+        }
+        const float weight = weights.empty() ? 1.0f : weights[objectIdx];
+        CalcDers(approx, target, weight, &der, der2.empty() ? nullptr : &objectDer2);
+        for (int dim : xrange(approxDimension)) {
+            ders[dim * blockSize + objectIdx] = der[dim];
+        }
+        Copy(objectDer2.Data.begin(), objectDer2.Data.end(), der2.begin() + objectIdx * hessianSize);
+    }
+}
+
+void TMultiRMSEError::CalcDersMultiBlock(
+    int blockSize,
+    TConstArrayRef<double> approxes,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TArrayRef<double> ders,
+    TArrayRef<double> der2
+) const {
+    const int approxDimension = approxes.size() / blockSize;
+    for (int dim : xrange(approxDimension)) {
+        const double* approx = approxes.data() + dim * blockSize;
+        const float* target = targets.data() + dim * blockSize;
+        double* der = ders.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            der[objectIdx] = target[objectIdx] - approx[objectIdx];
+        }
+        if (!weights.empty()) {
+            for (int objectIdx : xrange(blockSize)) {
+                der[objectIdx] *= weights[objectIdx];
+            }
+        }
+    }
+    if (!der2.empty()) {
+        for (int objectIdx : xrange(blockSize)) {
+            const double objectDer2 = weights.empty() ? -1.0 : -weights[objectIdx];
+            Fill(der2.begin() + objectIdx * approxDimension, der2.begin() + (objectIdx + 1) * approxDimension, objectDer2);
+        }
+    }
+}
+
+void TMultiClassError::CalcDersMultiBlock(
+    int blockSize,
+    TConstArrayRef<double> approxes,
+    TConstArrayRef<float> targets,
+    TConstArrayRef<float> weights,
+    TArrayRef<double> ders,
+    TArrayRef<double> der2
+) const {
+    Y_ASSERT(blockSize <= MaxDersMultiBlockSize);
+    const int approxDimension = approxes.size() / blockSize;
+    std::array<double, MaxDersMultiBlockSize> objectValues;
+
+    // softmax, as CalcSoftmax of each object
+    Copy(approxes.data(), approxes.data() + blockSize, objectValues.begin());
+    for (int dim : xrange(1, approxDimension)) {
+        const double* approx = approxes.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            objectValues[objectIdx] = Max(objectValues[objectIdx], approx[objectIdx]);
+        }
+    }
+    for (int dim : xrange(approxDimension)) {
+        const double* approx = approxes.data() + dim * blockSize;
+        double* der = ders.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            der[objectIdx] = approx[objectIdx] - objectValues[objectIdx];
+        }
+    }
+    FastExpInplace(ders.data(), approxDimension * blockSize);
+    Fill(objectValues.begin(), objectValues.begin() + blockSize, 0.0);
+    for (int dim : xrange(approxDimension)) {
+        const double* der = ders.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            objectValues[objectIdx] += der[objectIdx];
+        }
+    }
+    for (int dim : xrange(approxDimension)) {
+        double* der = ders.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            der[objectIdx] /= objectValues[objectIdx];
+        }
+    }
+
+    if (!der2.empty()) {
+        const size_t hessianSize = approxDimension * (approxDimension + 1) / 2;
+        for (int objectIdx : xrange(blockSize)) {
+            const double weight = weights.empty() ? 1.0 : weights[objectIdx];
+            double* objectDer2 = der2.data() + objectIdx * hessianSize;
+            int idx = 0;
+            for (int dimY : xrange(approxDimension)) {
+                const double derY = ders[dimY * blockSize + objectIdx];
+                objectDer2[idx++] = derY * (derY - 1) * weight;
+                for (int dimX : xrange(dimY + 1, approxDimension)) {
+                    objectDer2[idx++] = derY * ders[dimX * blockSize + objectIdx] * weight;
+                }
+            }
+        }
+    }
+
+    for (int dim : xrange(approxDimension)) {
+        double* der = ders.data() + dim * blockSize;
+        for (int objectIdx : xrange(blockSize)) {
+            der[objectIdx] = -der[objectIdx];
+        }
+    }
+    for (int objectIdx : xrange(blockSize)) {
+        const int targetClass = static_cast<int>(targets[objectIdx]);
+        ders[targetClass * blockSize + objectIdx] += 1;
+    }
+    if (!weights.empty()) {
+        for (int dim : xrange(approxDimension)) {
+            double* der = ders.data() + dim * blockSize;
+            for (int objectIdx : xrange(blockSize)) {
+                der[objectIdx] *= weights[objectIdx];
+            }
+        }
+    }
+}
+
 TVector<size_t> ArgSort(
     int start,
     int count,
@@ -4,6 +4,7 @@
 #include "custom_objective_descriptor.h"
 #include "ders_holder.h"
 #include "hessian.h"
+#include "query_blocks.h"
 #include "survival_aft_utils.h"
 
 #include <catboost/private/libs/data_types/pair.h>
@@ -113,6 +114,22 @@ public:
         CB_ENSURE(false, "Not implemented");
     }
 
+    static constexpr int MaxDersMultiBlockSize = 16;
+
+    /* CalcDersMulti for block of objects. Approxes, targets and ders are dimension-major,
+     * [dimension * blockSize + objectIdx], targets have one dimension for single target losses.
+     * If der2 is not empty, hessians of objects are written one after another in THessianInfo::Data layout.
+     * Default implementation calls CalcDersMulti for each object. blockSize is at most MaxDersMultiBlockSize.
+     */
+    virtual void CalcDersMultiBlock(
+        int blockSize,
+        TConstArrayRef<double> approxes,
+        TConstArrayRef<float> targets,
+        TConstArrayRef<float> weights, // empty if all weights are 1
+        TArrayRef<double> ders,
+        TArrayRef<double> der2
+    ) const;
+
     virtual void CalcDersForQueries(
         int /*queryStartIndex*/,
         int /*queryEndIndex*/,
@@ -187,6 +204,16 @@ public:
         TVector<double>* der,
         THessianInfo* der2
     ) const = 0;
+
+    // Calls CalcDers for each object
+    void CalcDersMultiBlock(
+        int blockSize,
+        TConstArrayRef<double> approxes,
+        TConstArrayRef<float> targets,
+        TConstArrayRef<float> weights,
+        TArrayRef<double> ders,
+        TArrayRef<double> der2
+    ) const override;
 };
 
 class TMultiRMSEError final : public TMultiDerCalcer {
@@ -216,6 +243,15 @@ public:
             }
         }
     }
+
+    void CalcDersMultiBlock(
+        int blockSize,
+        TConstArrayRef<double> approxes,
+        TConstArrayRef<float> targets,
+        TConstArrayRef<float> weights,
+        TArrayRef<double> ders,
+        TArrayRef<double> der2
+    ) const override;
 };
 
 class TMultiRMSEErrorWithMissingValues final : public TMultiDerCalcer {
@@ -702,6 +738,16 @@ public:
             }
         }
     }
+
+    // Softmax of all objects of block at once, loops over objects are vectorized
+    void CalcDersMultiBlock(
+        int blockSize,
+        TConstArrayRef<double> approxes,
+        TConstArrayRef<float> targets,
+        TConstArrayRef<float> weights,
+        TArrayRef<double> ders,
+        TArrayRef<double> der2
+    ) const override;
 };
 
 class TMultiClassOneVsAllError final : public IDerCalcer {
@@ -816,28 +862,31 @@ public:
     ) const override {
         CB_ENSURE(queryStartIndex < queryEndIndex);
         const int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        NCB::ParallelForQueryBlocks(
+            queriesInfo,
             queryStartIndex,
             queryEndIndex,
-            [&] (ui32 queryIndex) {
-                const int begin = queriesInfo[queryIndex].Begin;
-                const int end = queriesInfo[queryIndex].End;
-                TDers* dersData = ders.data() + begin - start;
-                Fill(dersData, dersData + end - begin, TDers{/*1st*/0.0, /*2nd*/0.0, /*3rd*/0.0});
-                for (int docId = begin; docId < end; ++docId) {
-                    double winnerDer = 0.0;
-                    double winnerSecondDer = 0.0;
-                    for (const auto& competitor : queriesInfo[queryIndex].Competitors[docId - begin]) {
-                        const double p = expApproxes[competitor.Id + begin] /
-                            (expApproxes[competitor.Id + begin] + expApproxes[docId]);
-                        winnerDer += competitor.Weight * p;
-                        dersData[competitor.Id].Der1 -= competitor.Weight * p;
-                        winnerSecondDer += competitor.Weight * p * (p - 1);
-                        dersData[competitor.Id].Der2 += competitor.Weight * p * (p - 1);
+            localExecutor,
+            [&] (int blockQueryBegin, int blockQueryEnd) {
+                for (int queryIndex = blockQueryBegin; queryIndex < blockQueryEnd; ++queryIndex) {
+                    const int begin = queriesInfo[queryIndex].Begin;
+                    const int end = queriesInfo[queryIndex].End;
+                    TDers* dersData = ders.data() + begin - start;
+                    Fill(dersData, dersData + end - begin, TDers{/*1st*/0.0, /*2nd*/0.0, /*3rd*/0.0});
+                    for (int docId = begin; docId < end; ++docId) {
+                        double winnerDer = 0.0;
+                        double winnerSecondDer = 0.0;
+                        for (const auto& competitor : queriesInfo[queryIndex].Competitors[docId - begin]) {
+                            const double p = expApproxes[competitor.Id + begin] /
+                                (expApproxes[competitor.Id + begin] + expApproxes[docId]);
+                            winnerDer += competitor.Weight * p;
+                            dersData[competitor.Id].Der1 -= competitor.Weight * p;
+                            winnerSecondDer += competitor.Weight * p * (p - 1);
+                            dersData[competitor.Id].Der2 += competitor.Weight * p * (p - 1);
+                        }
+                        dersData[docId - begin].Der1 += winnerDer;
+                        dersData[docId - begin].Der2 += winnerSecondDer;
                     }
-                    dersData[docId - begin].Der1 += winnerDer;
-                    dersData[docId - begin].Der2 += winnerSecondDer;
                 }
             });
     }
@@ -863,47 +912,67 @@ public:
         NPar::ILocalExecutor* localExecutor
     ) const override {
         const int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        NCB::ParallelForQueryBlocks(
+            queriesInfo,
             queryStartIndex,
             queryEndIndex,
-            [&] (ui32 queryIndex) {
-                const int begin = queriesInfo[queryIndex].Begin;
-                const int end = queriesInfo[queryIndex].End;
-                const int querySize = end - begin;
-
-                const double queryAvrg = CalcQueryAvrg(begin, querySize, approxes, targets, weights);
-                for (int docId = begin; docId < end; ++docId) {
-                    ders[docId - start].Der1 = targets[docId] - approxes[docId] - queryAvrg;
-                    ders[docId - start].Der2 = -1;
-                    if (!weights.empty()) {
-                        ders[docId - start].Der1 *= weights[docId];
-                        ders[docId - start].Der2 *= weights[docId];
-                    }
+            localExecutor,
+            [&] (int blockQueryBegin, int blockQueryEnd) {
+                if (weights.empty()) {
+                    CalcDersForQueryBlock</*HasWeights*/false>(
+                        queriesInfo,
+                        blockQueryBegin,
+                        blockQueryEnd,
+                        approxes.data(),
+                        targets.data(),
+                        /*weights*/ nullptr,
+                        start,
+                        ders.data());
+                } else {
+                    CalcDersForQueryBlock</*HasWeights*/true>(
+                        queriesInfo,
+                        blockQueryBegin,
+                        blockQueryEnd,
+                        approxes.data(),
+                        targets.data(),
+                        weights.data(),
+                        start,
+                        ders.data());
                 }
             });
     }
 private:
-    double CalcQueryAvrg(
+    // ders are indexed by docId - start
+    template <bool HasWeights>
+    static void CalcDersForQueryBlock(
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int queryBegin,
+        int queryEnd,
+        const double* approxes,
+        const float* targets,
+        const float* weights,
         int start,
-        int count,
-        const TVector<double>& approxes,
-        const TVector<float>& targets,
-        const TVector<float>& weights
-    ) const {
-        double querySum = 0;
-        double queryCount = 0;
-        for (int docId = start; docId < start + count; ++docId) {
-            double w = weights.empty() ? 1 : weights[docId];
-            querySum += (targets[docId] - approxes[docId]) * w;
-            queryCount += w;
-        }
+        TDers* ders
+    ) {
+        for (int queryIndex = queryBegin; queryIndex < queryEnd; ++queryIndex) {
+            const int begin = queriesInfo[queryIndex].Begin;
+            const int end = queriesInfo[queryIndex].End;
+
+            double querySum = 0;
+            double queryCount = 0;
+            for (int docId = begin; docId < end; ++docId) {
+                const double w = HasWeights ? weights[docId] : 1;
+                querySum += (targets[docId] - approxes[docId]) * w;
+                queryCount += w;
+            }
+            const double queryAvrg = queryCount > 0 ? querySum / queryCount : 0;
 
-        double queryAvrg = 0;
-        if (queryCount > 0) {
-            queryAvrg = querySum / queryCount;
+            for (int docId = begin; docId < end; ++docId) {
+                const double w = HasWeights ? weights[docId] : 1;
+                ders[docId - start].Der1 = (targets[docId] - approxes[docId] - queryAvrg) * w;
+                ders[docId - start].Der2 = -w;
+            }
         }
-        return queryAvrg;
     }
 };
 
@@ -933,14 +1002,17 @@ public:
         NPar::ILocalExecutor* localExecutor
     ) const override {
         int start = queriesInfo[queryStartIndex].Begin;
-        NPar::ParallelFor(
-            *localExecutor,
+        NCB::ParallelForQueryBlocks(
+            queriesInfo,
             queryStartIndex,
             queryEndIndex,
-            [&](int queryIndex) {
-                int begin = queriesInfo[queryIndex].Begin;
-                int end = queriesInfo[queryIndex].End;
-                CalcDersForSingleQuery(start, begin - start, end - begin, approxes, targets, weights, ders);
+            localExecutor,
+            [&](int blockQueryBegin, int blockQueryEnd) {
+                for (int queryIndex = blockQueryBegin; queryIndex < blockQueryEnd; ++queryIndex) {
+                    int begin = queriesInfo[queryIndex].Begin;
+                    int end = queriesInfo[queryIndex].End;
+                    CalcDersForSingleQuery(start, begin - start, end - begin, approxes, targets, weights, ders);
+                }
             });
     }
 
@@ -1,5 +1,6 @@
 #include "langevin_utils.h"
 
+#include <catboost/libs/helpers/rank2_array.h>
 #include <catboost/private/libs/algo_helpers/ders_holder.h>
 #include <catboost/private/libs/algo_helpers/online_predictor.h>
 #include <catboost/private/libs/index_range/index_range.h>
@@ -8,6 +9,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/random/fast.h>
 #include <util/random/normal.h>
 
@@ -17,25 +19,17 @@ double CalcLangevinNoiseRate(float diffusionTemperature, float learningRate) {
     return sqrt(2.0 / learningRate / diffusionTemperature);
 }
 
-void AddLangevinNoiseToDerivatives(
-    float diffusionTemperature,
-    float learningRate,
+static void AddLangevinNoise(
+    double coef,
     ui64 randomSeed,
-    TVector<double>* derivatives,
+    const TSimpleIndexRangesGenerator<size_t>& rangesGenerator,
+    TArrayRef<double> derivatives,
     NPar::ILocalExecutor* localExecutor
 ) {
-    if (diffusionTemperature == 0.0f) {
-        return;
-    }
-    const double coef = CalcLangevinNoiseRate(diffusionTemperature, learningRate);
-    CB_ENSURE_INTERNAL(!derivatives->empty(), "Unexpected empty derivatives");
-    const size_t objectCount = derivatives->size();
-    TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange(objectCount), CB_THREAD_LIMIT);
-
     localExecutor->ExecRange(
         [&](int blockIdx) {
             TFastRng64 blockRng(randomSeed + blockIdx);
-            auto dersData = derivatives->data();
+            auto dersData = derivatives.data();
             for (auto idx : rangesGenerator.GetRange(blockIdx).Iter()) {
                 dersData[idx] += coef * StdNormalDistribution<double>(blockRng);
             }
@@ -50,7 +44,24 @@ void AddLangevinNoiseToDerivatives(
     float diffusionTemperature,
     float learningRate,
     ui64 randomSeed,
-    TVector<TVector<double>>* derivatives,
+    TVector<double>* derivatives,
+    NPar::ILocalExecutor* localExecutor
+) {
+    if (diffusionTemperature == 0.0f) {
+        return;
+    }
+    const double coef = CalcLangevinNoiseRate(diffusionTemperature, learningRate);
+    CB_ENSURE_INTERNAL(!derivatives->empty(), "Unexpected empty derivatives");
+    const size_t objectCount = derivatives->size();
+    TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange(objectCount), CB_THREAD_LIMIT);
+    AddLangevinNoise(coef, randomSeed, rangesGenerator, *derivatives, localExecutor);
+}
+
+void AddLangevinNoiseToDerivatives(
+    float diffusionTemperature,
+    float learningRate,
+    ui64 randomSeed,
+    NCB::TRank2Array<double>* derivatives,
     NPar::ILocalExecutor* localExecutor
 ) {
     if (diffusionTemperature == 0.0f) {
@@ -58,21 +69,10 @@ void AddLangevinNoiseToDerivatives(
     }
     const double coef = CalcLangevinNoiseRate(diffusionTemperature, learningRate);
     CB_ENSURE_INTERNAL(!derivatives->empty(), "Unexpected empty derivatives");
-    const size_t objectCount = derivatives->front().size();
+    const size_t objectCount = derivatives->GetRowSize();
     TSimpleIndexRangesGenerator<size_t> rangesGenerator(TIndexRange(objectCount), CB_THREAD_LIMIT);
-    for(auto& derivatives1d : *derivatives) {
-        localExecutor->ExecRange(
-            [&](int blockIdx) {
-                TFastRng64 blockRng(randomSeed + blockIdx);
-                auto dersData = derivatives1d.data();
-                for (auto idx : rangesGenerator.GetRange(blockIdx).Iter()) {
-                    dersData[idx] += coef * StdNormalDistribution<double>(blockRng);
-                }
-            },
-            0,
-            SafeIntegerCast<int>(rangesGenerator.RangesCount()),
-            NPar::TLocalExecutor::WAIT_COMPLETE
-        );
+    for (auto dim : xrange(derivatives->size())) {
+        AddLangevinNoise(coef, randomSeed, rangesGenerator, (*derivatives)[dim], localExecutor);
     }
 }
 
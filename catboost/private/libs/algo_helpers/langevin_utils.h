@@ -11,6 +11,11 @@ namespace NPar {
     class ILocalExecutor;
 }
 
+namespace NCB {
+    template <class T>
+    class TRank2Array;
+}
+
 double CalcLangevinNoiseRate(float diffusionTemperature, float learningRate);
 
 void AddLangevinNoiseToDerivatives(
@@ -25,7 +30,7 @@ void AddLangevinNoiseToDerivatives(
     float diffusionTemperature,
     float learningRate,
     ui64 randomSeed,
-    TVector<TVector<double>>* derivatives,
+    NCB::TRank2Array<double>* derivatives,
     NPar::ILocalExecutor* localExecutor
 );
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <catboost/private/libs/data_types/query.h>
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/system/types.h>
+
+#include <algorithm>
+
+
+namespace NCB {
+
+    // smaller blocks are not worth a separate task
+    constexpr ui32 MinDocCountInQueryBlock = 4096;
+
+    // blocks per thread, to balance blocks that have a different cost for the same number of documents
+    constexpr int QueryBlocksPerThread = 4;
+
+    /* Calls f(blockQueryBegin, blockQueryEnd) in parallel for blocks of successive queries from
+     * [queryBegin, queryEnd). Blocks contain approximately equal numbers of documents rather than of queries:
+     * query sizes can differ by orders of magnitude, and for many tiny queries per-query tasks are dominated
+     * by scheduling overhead.
+     */
+    template <class TFunc>
+    void ParallelForQueryBlocks(
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int queryBegin,
+        int queryEnd,
+        NPar::ILocalExecutor* localExecutor,
+        const TFunc& f
+    ) {
+        if (queryBegin >= queryEnd) {
+            return;
+        }
+        const ui32 docBegin = queriesInfo[queryBegin].Begin;
+        const ui32 docCount = queriesInfo[queryEnd - 1].End - docBegin;
+        const int blockCount = std::max(
+            std::min({
+                queryEnd - queryBegin,
+                QueryBlocksPerThread * (localExecutor->GetThreadCount() + 1),
+                (int)CeilDiv(docCount, MinDocCountInQueryBlock)
+            }),
+            1);
+        if (blockCount == 1) {
+            f(queryBegin, queryEnd);
+            return;
+        }
+
+        TVector<int> blockBounds(blockCount + 1);
+        blockBounds[0] = queryBegin;
+        blockBounds[blockCount] = queryEnd;
+        for (int blockIdx : xrange(1, blockCount)) {
+            const ui32 blockDocBegin = docBegin + ui32((ui64)docCount * blockIdx / blockCount);
+            const auto blockQueryBegin = std::partition_point(
+                queriesInfo.begin() + blockBounds[blockIdx - 1],
+                queriesInfo.begin() + queryEnd,
+                [=] (const TQueryInfo& queryInfo) {
+                    return queryInfo.Begin < blockDocBegin;
+                });
+            blockBounds[blockIdx] = blockQueryBegin - queriesInfo.begin();
+        }
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                if (blockBounds[blockIdx] < blockBounds[blockIdx + 1]) {
+                    f(blockBounds[blockIdx], blockBounds[blockIdx + 1]);
+                }
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+}
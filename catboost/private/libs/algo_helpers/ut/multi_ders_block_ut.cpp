@@ -0,0 +1,76 @@
+#include <library/cpp/testing/unittest/registar.h>
+#include <catboost/private/libs/algo_helpers/error_functions.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+// Block derivatives should be equal to derivatives of objects calculated one by one up to rounding of vectorized exp
+static void CheckBlockDers(const IDerCalcer& error, int approxDimension, int targetDimension, bool useWeights) {
+    const int blockSize = IDerCalcer::MaxDersMultiBlockSize - 3;
+    TFastRng64 rng(0);
+    TVector<double> approxes(approxDimension * blockSize);
+    for (auto& approx : approxes) {
+        approx = rng.GenRandReal1() * 10 - 5;
+    }
+    TVector<float> targets(targetDimension * blockSize);
+    for (auto& target : targets) {
+        target = targetDimension == 1 ? rng.Uniform(approxDimension) : rng.GenRandReal1();
+    }
+    TVector<float> weights;
+    if (useWeights) {
+        weights.resize(blockSize);
+        for (auto& weight : weights) {
+            weight = rng.GenRandReal1() * 2;
+        }
+    }
+    const size_t hessianSize = THessianInfo(approxDimension, error.GetHessianType()).Data.size();
+    TVector<double> ders(approxDimension * blockSize);
+    TVector<double> der2(hessianSize * blockSize);
+    error.CalcDersMultiBlock(blockSize, approxes, targets, weights, ders, der2);
+
+    TVector<double> approx(approxDimension);
+    TVector<float> target(targetDimension);
+    TVector<double> der(approxDimension);
+    THessianInfo objectDer2(approxDimension, error.GetHessianType());
+    for (auto objectIdx : xrange(blockSize)) {
+        for (auto dim : xrange(approxDimension)) {
+            approx[dim] = approxes[dim * blockSize + objectIdx];
+        }
+        for (auto dim : xrange(targetDimension)) {
+            target[dim] = targets[dim * blockSize + objectIdx];
+        }
+        const float weight = useWeights ? weights[objectIdx] : 1.0f;
+        if (const auto* multiError = dynamic_cast<const TMultiDerCalcer*>(&error)) {
+            multiError->CalcDers(approx, target, weight, &der, &objectDer2);
+        } else {
+            error.CalcDersMulti(approx, target[0], weight, &der, &objectDer2);
+        }
+        for (auto dim : xrange(approxDimension)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(der[dim], ders[dim * blockSize + objectIdx], 1e-12);
+        }
+        for (auto idx : xrange(hessianSize)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(objectDer2.Data[idx], der2[objectIdx * hessianSize + idx], 1e-12);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(MultiDersBlockTest) {
+    Y_UNIT_TEST(MultiClassBlockDers) {
+        const TMultiClassError error(/*isExpApprox*/ false);
+        for (bool useWeights : {false, true}) {
+            CheckBlockDers(error, /*approxDimension*/ 7, /*targetDimension*/ 1, useWeights);
+        }
+    }
+
+    Y_UNIT_TEST(MultiRMSEBlockDers) {
+        const TMultiRMSEError error;
+        for (bool useWeights : {false, true}) {
+            CheckBlockDers(error, /*approxDimension*/ 3, /*targetDimension*/ 3, useWeights);
+        }
+    }
+
+    Y_UNIT_TEST(OneVsAllBlockDers) {
+        const TMultiClassOneVsAllError error(/*isExpApprox*/ false);
+        CheckBlockDers(error, /*approxDimension*/ 4, /*targetDimension*/ 1, /*useWeights*/ true);
+    }
+}
@@ -0,0 +1,76 @@
+#include <catboost/private/libs/algo_helpers/query_blocks.h>
+
+#include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/spinlock.h>
+
+#include <algorithm>
+#include <utility>
+
+
+Y_UNIT_TEST_SUITE(ParallelForQueryBlocksTest) {
+    static void CheckBlocks(const TVector<TQueryInfo>& queriesInfo, int queryBegin, int queryEnd, int threadCount) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(threadCount - 1);
+
+        TAdaptiveLock lock;
+        TVector<std::pair<int, int>> blocks;
+        NCB::ParallelForQueryBlocks(
+            queriesInfo,
+            queryBegin,
+            queryEnd,
+            &localExecutor,
+            [&] (int blockQueryBegin, int blockQueryEnd) {
+                with_lock (lock) {
+                    blocks.emplace_back(blockQueryBegin, blockQueryEnd);
+                }
+            });
+        std::sort(blocks.begin(), blocks.end());
+
+        int expectedBegin = queryBegin;
+        for (const auto& [blockQueryBegin, blockQueryEnd] : blocks) {
+            UNIT_ASSERT_VALUES_EQUAL(blockQueryBegin, expectedBegin);
+            UNIT_ASSERT(blockQueryBegin < blockQueryEnd);
+            expectedBegin = blockQueryEnd;
+        }
+        UNIT_ASSERT_VALUES_EQUAL(expectedBegin, queryEnd);
+    }
+
+    static TVector<TQueryInfo> MakeQueries(const TVector<ui32>& querySizes) {
+        TVector<TQueryInfo> queriesInfo;
+        ui32 begin = 0;
+        for (auto querySize : querySizes) {
+            queriesInfo.emplace_back(begin, begin + querySize);
+            begin += querySize;
+        }
+        return queriesInfo;
+    }
+
+    Y_UNIT_TEST(ManySmallQueries) {
+        TVector<ui32> querySizes;
+        for (auto queryIdx : xrange(100000)) {
+            querySizes.push_back(2 + queryIdx % 9);
+        }
+        const auto queriesInfo = MakeQueries(querySizes);
+        for (int threadCount : {1, 4}) {
+            CheckBlocks(queriesInfo, 0, queriesInfo.ysize(), threadCount);
+            CheckBlocks(queriesInfo, 123, 54321, threadCount);
+        }
+    }
+
+    Y_UNIT_TEST(UnbalancedQueries) {
+        // few huge queries among small ones, some blocks are empty of query boundaries
+        TVector<ui32> querySizes(1000, 3);
+        querySizes[10] = 100000;
+        querySizes[500] = 200000;
+        querySizes.push_back(0);
+        const auto queriesInfo = MakeQueries(querySizes);
+        for (int threadCount : {1, 4}) {
+            CheckBlocks(queriesInfo, 0, queriesInfo.ysize(), threadCount);
+            CheckBlocks(queriesInfo, 10, 11, threadCount);
+        }
+    }
+}
@@ -317,6 +317,12 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             (*plainJsonPtr)["profile_log"] = name;
         });
 
+    parser.AddLongOption("profile-trace", "Write trace of parallel tasks of training phases in Chrome trace format to catboost_trace.json in train dir")
+        .RequiredArgument("bool")
+        .Handler1T<TString>([plainJsonPtr](const TString& param) {
+            (*plainJsonPtr)["profile_trace"] = FromString<bool>(param);
+        });
+
     parser.AddLongOption("trace-log", "path for trace log")
         .RequiredArgument("file")
         .Handler1T<TString>([](const TString& name) {
@@ -363,6 +369,15 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
         (*plainJsonPtr)["metric_period"] = period;
     });
 
+    parser.AddLongOption(
+        "metric-sample-size",
+        "calculate metrics except eval metric on random subsets of this size of eval sets,"
+        " but on whole eval sets on the last iteration")
+        .RequiredArgument("int")
+        .Handler1T<ui32>([plainJsonPtr](const auto sampleSize) {
+        (*plainJsonPtr)["metric_sample_size"] = sampleSize;
+    });
+
     parser.AddLongOption("snapshot-file", "use progress file for restoring progress after crashes")
         .RequiredArgument("PATH")
         .Handler1T<TString>([plainJsonPtr](const TString& path) {
@@ -404,6 +419,11 @@ static void BindOutputParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* p
             .Handler1T<TString>([plainJsonPtr](const TString& param) {
                 (*plainJsonPtr)["allow_writing_files"] = FromString<bool>(param);
             });
+    parser.AddLongOption("save-split-gain-importance", "Store features split gains accumulated during training in model metadata (key \"split_gain_importance\"). Possible values: true, false")
+            .RequiredArgument("bool")
+            .Handler1T<TString>([plainJsonPtr](const TString& param) {
+                (*plainJsonPtr)["save_split_gain_importance"] = FromString<bool>(param);
+            });
 
 }
 
@@ -427,6 +447,15 @@ static void BindBoostingParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue*
             (*plainJsonPtr)["fold_len_multiplier"] = multiplier;
         });
 
+    parser.AddLongOption("time-limit")
+        .RequiredArgument("SECONDS")
+        .Handler1T<double>([plainJsonPtr](double seconds) {
+            (*plainJsonPtr)["time_limit"] = seconds;
+        })
+        .Help("CPU only. Wall-clock budget of boosting iterations in seconds. "
+              "Training stops with the model built so far when the next iteration is not expected to fit into it. "
+              "0 means no limit.");
+
     parser.AddLongOption("approx-on-full-history")
         .NoArgument()
         .Handler0([plainJsonPtr]() {
@@ -671,6 +700,14 @@ static void BindFeatureEvalParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonVal
         .Handler1T<float>([plainJsonPtr](const auto quantile) {
             (*plainJsonPtr)["timesplit_quantile"] = quantile;
         });
+    parser
+        .AddLongOption("parallel-trainings")
+        .RequiredArgument("INT")
+        .Help("Max number of models trained simultaneously in feature evaluation; threads and used RAM limit are divided between them (CPU only, not compatible with snapshots)")
+        .Handler1T<ui32>([plainJsonPtr](const auto parallelTrainingCount) {
+            CB_ENSURE(parallelTrainingCount > 0, "Parallel training count must be positive");
+            (*plainJsonPtr)["parallel_trainings"] = parallelTrainingCount;
+        });
 }
 
 static void BindFeaturesSelectParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* plainJsonPtr) {
@@ -1005,6 +1042,29 @@ static void BindTreeParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* pla
             (*plainJsonPtr)["dev_leafwise_approxes"] = true;
         });
 
+    parser
+        .AddLongOption(
+            "dev-compact-bucket-stats",
+            "CPU only. Store histograms of symmetric trees in float with compensated summation. "
+            "Reduces memory and bandwidth of score calculation, "
+            "changes results a little due to numerical accuracy differences")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["dev_compact_bucket_stats"] = true;
+        });
+
+    parser
+        .AddLongOption(
+            "dev-rescored-candidates-count",
+            "CPU only. Score only this number of the best float and one-hot features of previous trees "
+            "at each depth of symmetric trees, plus a random part of the others. "
+            "0 means all features are scored. Speeds up plain boosting with small learning rates, "
+            "changes results")
+        .RequiredArgument("INT")
+        .Handler1T<ui32>([plainJsonPtr](ui32 count) {
+            (*plainJsonPtr)["dev_rescored_candidates_count"] = count;
+        });
+
     parser
         .AddLongOption("feature-weights")
         .RequiredArgument("String")
@@ -1110,6 +1170,19 @@ static void BindCatFeatureParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValu
             (*plainJsonPtr).InsertValue("ctr_leaf_count_limit", maxLeafCount);
         });
 
+    parser.AddLongOption("ctr-sketch-width",
+                         "Store ctr statistics of categorical features and their combinations in count-min sketches of this width instead of exact tables. Memory of model ctrs doesn't grow with the number of category values, but ctrs of rare values are overestimated. 0 means exact tables. CPU only")
+        .RequiredArgument("width")
+        .Handler1T<ui32>([plainJsonPtr](ui32 width) {
+            (*plainJsonPtr).InsertValue("ctr_sketch_width", width);
+        });
+
+    parser.AddLongOption("ctr-sketch-depth", "Number of hash functions of ctr count-min sketches. CPU only")
+        .RequiredArgument("depth")
+        .Handler1T<ui32>([plainJsonPtr](ui32 depth) {
+            (*plainJsonPtr).InsertValue("ctr_sketch_depth", depth);
+        });
+
     parser.AddLongOption("ctr-history-unit", counterCalcMethodHelp)
         .RequiredArgument("Policy")
         .Handler1T<ECtrHistoryUnit>([plainJsonPtr](const auto unit) {
@@ -1333,6 +1406,25 @@ static void BindDistributedTrainingParams(NLastGetopt::TOpts* parserPtr, NJson::
         .Handler1T<TString>([plainJsonPtr](const TString& nodeFile) {
             (*plainJsonPtr)["file_with_hosts"] = nodeFile;
         });
+
+    const auto histogramsWireFormatHelp = TString::Join(
+        "Format of bucket stats sent from workers, must be one of: ",
+        GetEnumAllNames<EHistogramsWireFormat>(),
+        ". Default is Compact");
+    parser
+        .AddLongOption("histograms-wire-format", histogramsWireFormatHelp)
+        .RequiredArgument("String")
+        .Handler1T<EHistogramsWireFormat>([plainJsonPtr](const auto format) {
+            (*plainJsonPtr)["histograms_wire_format"] = ToString(format);
+        });
+
+    parser
+        .AddLongOption("balance-worker-shards")
+        .NoArgument()
+        .Help("Measure workers' speed at startup and make their shards of data proportional to it")
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["balance_worker_shards"] = true;
+        });
 }
 
 static void BindSystemParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* plainJsonPtr) {
@@ -8,10 +8,13 @@
 #include <catboost/libs/logging/logging.h>
 
 #include <library/cpp/getopt/small/last_getopt.h>
+#include <library/cpp/threading/future/future.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/string/cast.h>
 #include <util/string/split.h>
 
+#include <util/generic/ptr.h>
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
 
@@ -226,6 +229,11 @@ void NCB::CalcModelSingleHost(
         32,
         static_cast<int>(10000. / (static_cast<double>(iterationsLimit) / evalPeriod) / model.GetDimensionsCount())
     );
+    const TExternalLabelsHelper visibleLabelsHelper(model);
+    // results of a block are written while the next block is read and evaluated
+    NPar::TLocalExecutor outputExecutor;
+    outputExecutor.RunAdditionalThreads(1);
+    NThreading::TFuture<void> outputDone = NThreading::MakeFuture();
     ReadAndProceedPoolInBlocks(
         params.DatasetReadingParams,
         blockSize,
@@ -233,29 +241,41 @@ void NCB::CalcModelSingleHost(
             if (IsFirstBlock) {
                 ValidateColumnOutput(params.OutputColumnsIds, *datasetPart);
             }
-            auto approx = NCB::Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, virtualEnsemblesCount, params.IsUncertaintyPrediction, &executor);
-            const TExternalLabelsHelper visibleLabelsHelper(model);
+            auto approx = MakeAtomicShared<TEvalResult>(
+                NCB::Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, virtualEnsemblesCount, params.IsUncertaintyPrediction, &executor)
+            );
+            // at most one block is waiting for output, so memory use does not depend on the pool size
+            outputDone.GetValueSync();
+            const bool writeHeader = IsFirstBlock;
+            const ui64 blockDocIdOffset = docIdOffset;
+            outputDone = outputExecutor.ExecRangeWithFutures(
+                [&, approx, datasetPart, writeHeader, blockDocIdOffset](int /*blockId*/) {
+                    poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
 
-            poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
-
-            TSetLoggingSilent inThisScope;
-            OutputEvalResultToFile(
-                approx,
-                &executor,
-                params.OutputColumnsIds,
-                model.GetLossFunctionName(),
-                visibleLabelsHelper,
-                *datasetPart,
-                outputStream.Get(),
-                // TODO: src file columns output is incompatible with block processing
-                poolColumnsPrinter,
-                /*testFileWhichOf*/ {0, 0},
-                IsFirstBlock,
-                docIdOffset,
-                std::make_pair(evalPeriod, iterationsLimit),
-                *params.BinClassLogitThreshold);
+                    TSetLoggingSilent inThisScope;
+                    OutputEvalResultToFile(
+                        *approx,
+                        &outputExecutor,
+                        params.OutputColumnsIds,
+                        model.GetLossFunctionName(),
+                        visibleLabelsHelper,
+                        *datasetPart,
+                        outputStream.Get(),
+                        // TODO: src file columns output is incompatible with block processing
+                        poolColumnsPrinter,
+                        /*testFileWhichOf*/ {0, 0},
+                        writeHeader,
+                        blockDocIdOffset,
+                        std::make_pair(evalPeriod, iterationsLimit),
+                        *params.BinClassLogitThreshold);
+                },
+                0,
+                1,
+                NPar::TLocalExecutor::MED_PRIORITY
+            )[0];
             docIdOffset += datasetPart->ObjectsGrouping->GetObjectCount();
             IsFirstBlock = false;
         },
         &executor);
+    outputDone.GetValueSync();
 }
@@ -216,13 +216,18 @@ static void CalculateHistogram(
                 if (const auto* rawObjectsDataProvider
                         = dynamic_cast<const TRawObjectsDataProvider*>(dataProvider->ObjectsData.Get()))
                 {
-                    for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
-                        auto floatFeatureData = rawObjectsDataProvider->GetFloatFeature(floatFeatureIdx);
-                        if (floatFeatureData.Defined()) {
-                            auto values = (*floatFeatureData)->ExtractValues(localExecutor);
-                            histograms.AddFloatFeatureUniformHistogram(floatFeatureIdx, *values);
-                        }
-                    }
+                    // histograms of different features are independent
+                    localExecutor->ExecRangeWithThrow(
+                        [&] (int floatFeatureIdx) {
+                            auto floatFeatureData = rawObjectsDataProvider->GetFloatFeature(floatFeatureIdx);
+                            if (floatFeatureData.Defined()) {
+                                auto values = (*floatFeatureData)->ExtractValues(localExecutor);
+                                histograms.AddFloatFeatureUniformHistogram(floatFeatureIdx, *values);
+                            }
+                        },
+                        0,
+                        SafeIntegerCast<int>(floatFeatureCount),
+                        NPar::TLocalExecutor::WAIT_COMPLETE);
                 } else {
                     CB_ENSURE(false, "Non-raw pool formats are not yet supported for dataset histograms calculation");
                 }
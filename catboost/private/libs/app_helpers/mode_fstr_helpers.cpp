@@ -97,6 +97,15 @@ void NCB::PrepareFstrModeParamsParser(
                     calcType + " shap calculation type is not supported");
         });
 
+    const auto shapOutputFormatDescription =
+            TString::Join("SHAP values output format. Should be one of: ", GetEnumAllNames<EShapValuesOutputFormat>());
+    parser.AddLongOption("shap-output-format", shapOutputFormatDescription)
+        .DefaultValue("Tsv")
+        .Handler1T<TString>([&params](const TString& outputFormat) {
+            CB_ENSURE(TryFromString<EShapValuesOutputFormat>(outputFormat, params.ShapOutputFormat),
+                    outputFormat + " shap output format is not supported");
+        });
+
     parser.AddLongOption("verbose", "Log writing period")
         .DefaultValue("0")
         .Handler1T<TString>([&params](const TString& verbose) {
@@ -152,7 +161,8 @@ void NCB::ModeFstrSingleHostInner(
                                     params.Verbose,
                                     EPreCalcShapValues::Auto,
                                     localExecutor.Get(),
-                                    params.ShapCalcType);
+                                    params.ShapCalcType,
+                                    params.ShapOutputFormat);
             break;
         case EFstrType::SageValues:
             CalcAndOutputSageValues(model,
@@ -1,5 +1,6 @@
 
 #include "exists_checker.h"
+#include "shards.h"
 
 
 namespace NCB {
@@ -12,6 +13,13 @@ namespace NCB {
         return GetProcessor<IExistsChecker>(pathWithScheme)->IsSharedFs();
     }
 
+    bool TFSExistsChecker::Exists(const TPathWithScheme& pathWithScheme) const {
+        if (IsShardedPath(pathWithScheme)) {
+            return !GetShardPaths(pathWithScheme).empty();
+        }
+        return NFs::Exists(pathWithScheme.Path);
+    }
+
     namespace {
 
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSExistsCheckerReg("");
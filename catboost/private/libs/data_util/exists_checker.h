@@ -25,10 +25,9 @@ namespace NCB {
 
     bool IsSharedFs(const TPathWithScheme& pathWithScheme);
 
+    // sharded paths (see shards.h) exist if they have at least one shard
     struct TFSExistsChecker : public IExistsChecker {
-        bool Exists(const TPathWithScheme& pathWithScheme) const override {
-            return NFs::Exists(pathWithScheme.Path);
-        }
+        bool Exists(const TPathWithScheme& pathWithScheme) const override;
         bool IsSharedFs() const override {
             return false;
         }
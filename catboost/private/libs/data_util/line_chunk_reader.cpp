@@ -0,0 +1,106 @@
+#include "line_chunk_reader.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+
+#include <cstring>
+
+
+namespace NCB {
+
+    TLineChunkReader::TLineChunkReader(
+        const TString& path,
+        bool skipHeader,
+        size_t chunkSize,
+        const TReadAheadOptions& readAheadOptions
+    )
+        : Input(MakeFileInputWithReadAhead(path, readAheadOptions))
+    {
+        CB_ENSURE(chunkSize, "TLineChunkReader: chunkSize == 0");
+        Buffer.yresize(chunkSize);
+        if (skipHeader) {
+            TString header;
+            CB_ENSURE(Input->ReadLine(header), "TLineChunkReader: no header in file");
+        }
+    }
+
+    bool TLineChunkReader::ReadChunk(TStringBuf* chunk) {
+        const size_t tailSize = DataSize - ReturnedSize;
+        if (tailSize) {
+            memmove(Buffer.data(), Buffer.data() + ReturnedSize, tailSize);
+        }
+        DataSize = tailSize;
+        ReturnedSize = 0;
+
+        while (!Finished) {
+            if (DataSize == Buffer.size()) { // line is longer than buffer
+                Buffer.yresize(2 * Buffer.size());
+            }
+            const size_t requestedSize = Buffer.size() - DataSize;
+            const size_t readSize = Input->Load(Buffer.data() + DataSize, requestedSize);
+            const TStringBuf readData(Buffer.data() + DataSize, readSize);
+            DataSize += readSize;
+            if (readSize < requestedSize) {
+                Finished = true;
+                ReturnedSize = DataSize;
+                break;
+            }
+            // tail of the previous chunk contains no line ends
+            const size_t lastLineEnd = readData.rfind('\n');
+            if (lastLineEnd != TStringBuf::npos) {
+                ReturnedSize = DataSize - readSize + lastLineEnd + 1;
+                break;
+            }
+        }
+
+        *chunk = TStringBuf(Buffer.data(), ReturnedSize);
+        return ReturnedSize != 0;
+    }
+
+    TVector<TStringBuf> SplitAtLineBoundaries(TStringBuf text, size_t partCount) {
+        TVector<TStringBuf> parts;
+        if (text.empty()) {
+            return parts;
+        }
+        const size_t partSize = CeilDiv(text.size(), Max<size_t>(partCount, 1));
+        while (!text.empty()) {
+            size_t partEnd = text.size();
+            if (partSize < text.size()) {
+                const size_t lineEnd = text.find('\n', partSize - 1);
+                if (lineEnd != TStringBuf::npos) {
+                    partEnd = lineEnd + 1;
+                }
+            }
+            parts.push_back(text.Head(partEnd));
+            text.Skip(partEnd);
+        }
+        return parts;
+    }
+
+    void SplitLines(TStringBuf text, TVector<TStringBuf>* lines) {
+        lines->clear();
+        const char* lineBegin = text.begin();
+        const char* const end = text.end();
+        while (lineBegin != end) {
+            const char* lineEnd = (const char*)memchr(lineBegin, '\n', end - lineBegin);
+            TStringBuf line(lineBegin, lineEnd ? lineEnd : end);
+            line.ChopSuffix(TStringBuf("\r"));
+            lines->push_back(line);
+            lineBegin = lineEnd ? (lineEnd + 1) : end;
+        }
+    }
+
+    size_t GetLineCount(TStringBuf text) {
+        size_t count = 0;
+        const char* lineBegin = text.begin();
+        const char* const end = text.end();
+        while (lineBegin != end) {
+            const char* lineEnd = (const char*)memchr(lineBegin, '\n', end - lineBegin);
+            ++count;
+            lineBegin = lineEnd ? (lineEnd + 1) : end;
+        }
+        return count;
+    }
+}
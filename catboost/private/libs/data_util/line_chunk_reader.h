@@ -0,0 +1,53 @@
+#pragma once
+
+#include "read_ahead_input.h"
+
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/stream/file.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Reads text file by chunks that consist of whole lines, so that line splitting and parsing of a
+     * chunk can be done in parallel without copying each line to a separate string
+     */
+    class TLineChunkReader {
+    public:
+        static constexpr size_t DefaultChunkSize = 64 << 20;
+
+    public:
+        explicit TLineChunkReader(
+            const TString& path,
+            bool skipHeader = false,
+            size_t chunkSize = DefaultChunkSize,
+            const TReadAheadOptions& readAheadOptions = TReadAheadOptions()
+        );
+
+        /* returns true, if data were read
+           *chunk refers to the internal buffer and is valid until the next call
+           each line in *chunk ends with '\n', except possibly the last line of the file
+        */
+        bool ReadChunk(TStringBuf* chunk);
+
+    private:
+        THolder<IInputStream> Input;
+        TVector<char> Buffer;
+        size_t DataSize = 0;
+        size_t ReturnedSize = 0; // the rest of data is an incomplete line
+        bool Finished = false;
+    };
+
+    // split text into at most partCount parts of roughly equal size, each part consists of whole lines
+    TVector<TStringBuf> SplitAtLineBoundaries(TStringBuf text, size_t partCount);
+
+    // lines are returned without "\n" or "\r\n" at the end, as in IInputStream::ReadLine
+    void SplitLines(TStringBuf text, TVector<TStringBuf>* lines);
+
+    // the same as SplitLines(text).size()
+    size_t GetLineCount(TStringBuf text);
+}
@@ -1,4 +1,10 @@
 #include "line_data_reader.h"
+#include "shards.h"
+
+#include <library/cpp/threading/future/async.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 
 #include <util/system/compiler.h>
 #include <util/system/fs.h>
@@ -8,19 +14,25 @@ namespace NCB {
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
                                                const TDsvFormatOptions& format,
-                                               bool keepLineOrder)
+                                               bool keepLineOrder,
+                                               TMaybe<ui64> shardsShuffleSeed)
     {
+        if (IsShardedPath(pathWithScheme)) {
+            return MakeHolder<TShardedLineDataReader>(
+                TLineDataReaderArgs{pathWithScheme, format, keepLineOrder, shardsShuffleSeed}
+            );
+        }
         return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
-            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, keepLineOrder}
+            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, keepLineOrder, shardsShuffleSeed}
         );
     }
 
-    int CountLines(const TString& poolFile) {
+    int CountLines(const TString& poolFile, const TReadAheadOptions& readAheadOptions) {
         CB_ENSURE(NFs::Exists(TString(poolFile)), "pool file '" << TString(poolFile) << "' is not found");
-        TIFStream reader(poolFile.c_str());
+        THolder<IInputStream> reader = MakeFileInputWithReadAhead(poolFile, readAheadOptions);
         size_t count = 0;
         TString buffer;
-        while (reader.ReadLine(buffer)) {
+        while (reader->ReadLine(buffer)) {
             ++count;
         }
         return count;
@@ -77,6 +89,137 @@ namespace NCB {
     }
 
 
+    TShardedLineDataReader::TShardedLineDataReader(
+        const TLineDataReaderArgs& args,
+        size_t readAheadShardCount
+    )
+        : Args(args)
+        , ShardPaths(GetShardPaths(args.PathWithScheme, args.ShardsShuffleSeed))
+    {
+        CB_ENSURE(!ShardPaths.empty(), "No dataset shards found for path " << args.PathWithScheme);
+        CB_ENSURE(readAheadShardCount, "TShardedLineDataReader: readAheadShardCount == 0");
+
+        const size_t threadCount = Min(readAheadShardCount, ShardPaths.size());
+        ThreadPool.Start(threadCount);
+        for (auto i : xrange(threadCount)) {
+            Y_UNUSED(i);
+            StartNextShardReading();
+        }
+    }
+
+    TShardedLineDataReader::~TShardedLineDataReader() {
+        ThreadPool.Stop();
+    }
+
+    ui64 TShardedLineDataReader::GetDataLineCount(bool estimate) {
+        if (estimate) {
+            return DataLineCount.GetOrElse(ShardPaths.size());
+        }
+        if (!DataLineCount) {
+            TVector<NThreading::TFuture<ui64>> shardLineCounts;
+            for (auto shardIdx : xrange(ShardPaths.size())) {
+                shardLineCounts.push_back(
+                    NThreading::Async(
+                        [shardArgs = GetShardArgs(shardIdx)] () mutable {
+                            const auto pathWithScheme = shardArgs.PathWithScheme;
+                            return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
+                                pathWithScheme,
+                                std::move(shardArgs)
+                            )->GetDataLineCount();
+                        },
+                        ThreadPool
+                    )
+                );
+            }
+            DataLineCount = 0;
+            for (auto& shardLineCount : shardLineCounts) {
+                *DataLineCount += shardLineCount.GetValueSync();
+            }
+        }
+        return *DataLineCount;
+    }
+
+    TMaybe<TString> TShardedLineDataReader::GetHeader() {
+        CB_ENSURE(!FirstShardProcessed, "TShardedLineDataReader: GetHeader must be called before ReadLine");
+        SwitchToNextShard();
+        return Header;
+    }
+
+    bool TShardedLineDataReader::ReadLine(TString* line, ui64* lineIdx) {
+        if (!FirstShardProcessed) {
+            SwitchToNextShard();
+        }
+        while (LineIdxInCurrentShard == CurrentShard.Lines.size()) {
+            if (!SwitchToNextShard()) {
+                return false;
+            }
+        }
+        *line = std::move(CurrentShard.Lines[LineIdxInCurrentShard++]);
+        if (lineIdx) {
+            *lineIdx = LineIndex;
+        }
+        ++LineIndex;
+        return true;
+    }
+
+    TLineDataReaderArgs TShardedLineDataReader::GetShardArgs(size_t shardIdx) const {
+        TLineDataReaderArgs shardArgs = Args;
+        shardArgs.PathWithScheme = ShardPaths[shardIdx];
+        shardArgs.ShardsShuffleSeed = Nothing();
+        return shardArgs;
+    }
+
+    TShardedLineDataReader::TShardData TShardedLineDataReader::ReadShard(TLineDataReaderArgs&& shardArgs) {
+        const auto pathWithScheme = shardArgs.PathWithScheme;
+        auto reader = GetProcessor<ILineDataReader, TLineDataReaderArgs>(pathWithScheme, std::move(shardArgs));
+
+        TShardData shardData;
+        shardData.Header = reader->GetHeader();
+        TString line;
+        while (reader->ReadLine(&line)) {
+            shardData.Lines.push_back(std::move(line));
+        }
+        return shardData;
+    }
+
+    void TShardedLineDataReader::StartNextShardReading() {
+        ShardsInProgress.push_back(
+            NThreading::Async(
+                [shardArgs = GetShardArgs(NextShardToRead)] () mutable {
+                    return ReadShard(std::move(shardArgs));
+                },
+                ThreadPool
+            )
+        );
+        ++NextShardToRead;
+    }
+
+    bool TShardedLineDataReader::SwitchToNextShard() {
+        if (ShardsInProgress.empty()) {
+            return false;
+        }
+        CurrentShard = ShardsInProgress.front().ExtractValueSync();
+        ShardsInProgress.pop_front();
+        LineIdxInCurrentShard = 0;
+        if (NextShardToRead < ShardPaths.size()) {
+            StartNextShardReading();
+        }
+
+        if (FirstShardProcessed) {
+            ++CurrentShardIdx;
+            CB_ENSURE(
+                CurrentShard.Header == Header,
+                "Header of dataset shard " << ShardPaths[CurrentShardIdx] << " differs from the header of "
+                << ShardPaths[0]
+            );
+        } else {
+            Header = CurrentShard.Header;
+            FirstShardProcessed = true;
+        }
+        return true;
+    }
+
+
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "path_with_scheme.h"
+#include "read_ahead_input.h"
 
 #include <catboost/private/libs/index_range/index_range.h>
 
@@ -8,9 +9,14 @@
 
 #include <library/cpp/object_factory/object_factory.h>
 
+#include <library/cpp/threading/future/future.h>
+
+#include <util/generic/deque.h>
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
 #include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/thread/pool.h>
 
 #include <util/stream/file.h>
 #include <util/string/escape.h>
@@ -52,6 +58,8 @@ namespace NCB {
         TPathWithScheme PathWithScheme;
         TDsvFormatOptions Format;
         bool KeepLineOrder = true;
+        TMaybe<ui64> ShardsShuffleSeed; // used only for sharded paths
+        TReadAheadOptions ReadAheadOptions; // used only for readers of files
     };
 
 
@@ -80,18 +88,20 @@ namespace NCB {
     using TLineDataReaderFactory =
         NObjectFactory::TParametrizedObjectFactory<ILineDataReader, TString, TLineDataReaderArgs>;
 
+    // returns TShardedLineDataReader for sharded paths (see shards.h)
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
                                                const TDsvFormatOptions& format = TDsvFormatOptions(),
-                                               bool keepLineOrder = true);
+                                               bool keepLineOrder = true,
+                                               TMaybe<ui64> shardsShuffleSeed = Nothing());
 
 
-    int CountLines(const TString& poolFile);
+    int CountLines(const TString& poolFile, const TReadAheadOptions& readAheadOptions = TReadAheadOptions());
 
     class TFileLineDataReader : public ILineDataReader {
     public:
         explicit TFileLineDataReader(const TLineDataReaderArgs& args)
             : Args(args)
-            , IFStream(args.PathWithScheme.Path)
+            , Input(MakeFileInputWithReadAhead(args.PathWithScheme.Path, args.ReadAheadOptions))
             , HeaderProcessed(!Args.Format.HasHeader)
         {}
 
@@ -100,7 +110,7 @@ namespace NCB {
                 // TODO(espetrov): estimate based one first N lines
                 return 1;
             }
-            ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path);
+            ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path, Args.ReadAheadOptions);
             if (Args.Format.HasHeader) {
                 --nLines;
             }
@@ -111,7 +121,7 @@ namespace NCB {
             if (Args.Format.HasHeader) {
                 CB_ENSURE(!HeaderProcessed, "TFileLineDataReader: multiple calls to GetHeader");
                 TString header;
-                CB_ENSURE(IFStream.ReadLine(header), "TFileLineDataReader: no header in file");
+                CB_ENSURE(Input->ReadLine(header), "TFileLineDataReader: no header in file");
                 HeaderProcessed = true;
                 return header;
             }
@@ -128,12 +138,12 @@ namespace NCB {
                 *lineIdx = LineIndex;
             }
             ++LineIndex;
-            return IFStream.ReadLine(*line) != 0;
+            return Input->ReadLine(*line);
         }
 
     private:
         TLineDataReaderArgs Args;
-        TIFStream IFStream;
+        THolder<IInputStream> Input;
         bool HeaderProcessed;
         ui64 LineIndex = 0;
     };
@@ -156,4 +166,56 @@ namespace NCB {
         ui64 LineIdx;
         TString LineBuffer;
     };
+
+    /*
+     * Reads lines of dataset shards one after another, so line order is deterministic for the given order of shards.
+     * Next shards are read in advance in background threads by readers of their scheme.
+     * Header (if present) is taken from the first shard, other shards must have the same header.
+     */
+    class TShardedLineDataReader final : public ILineDataReader {
+    public:
+        static constexpr size_t DefaultReadAheadShardCount = 4;
+
+    public:
+        TShardedLineDataReader(
+            const TLineDataReaderArgs& args,
+            size_t readAheadShardCount = DefaultReadAheadShardCount
+        );
+
+        ~TShardedLineDataReader();
+
+        ui64 GetDataLineCount(bool estimate = false) override;
+
+        TMaybe<TString> GetHeader() override;
+
+        bool ReadLine(TString* line, ui64* lineIdx = nullptr) override;
+
+    private:
+        struct TShardData {
+            TMaybe<TString> Header;
+            TVector<TString> Lines;
+        };
+
+    private:
+        TLineDataReaderArgs GetShardArgs(size_t shardIdx) const;
+        static TShardData ReadShard(TLineDataReaderArgs&& shardArgs);
+        void StartNextShardReading();
+
+        // returns false if there are no more shards
+        bool SwitchToNextShard();
+
+    private:
+        TLineDataReaderArgs Args;
+        TVector<TPathWithScheme> ShardPaths;
+        TThreadPool ThreadPool;
+        TDeque<NThreading::TFuture<TShardData>> ShardsInProgress; // in the order of shards
+        size_t NextShardToRead = 0;
+        bool FirstShardProcessed = false;
+        TMaybe<TString> Header;
+        size_t CurrentShardIdx = 0;
+        TShardData CurrentShard;
+        size_t LineIdxInCurrentShard = 0;
+        ui64 LineIndex = 0;
+        TMaybe<ui64> DataLineCount;
+    };
 }
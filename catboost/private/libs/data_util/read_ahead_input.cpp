@@ -0,0 +1,128 @@
+#include "read_ahead_input.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/cpp/threading/future/async.h>
+
+#include <util/generic/buffer.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/stream/file.h>
+#include <util/system/fstat.h>
+
+
+namespace NCB {
+
+    void TReadAheadOptions::Validate() const {
+        CB_ENSURE(BlockSize, "Read ahead block size must be positive");
+        CB_ENSURE(ParallelRequestCount, "Read ahead parallel request count must be positive");
+        CB_ENSURE(MaxBlocksInFlight >= 2, "Read ahead must allow at least 2 blocks in flight");
+    }
+
+
+    TReadAheadFileInput::TReadAheadFileInput(const TString& path, const TReadAheadOptions& options)
+        : Options(options)
+        , File(path, OpenExisting | RdOnly | Seq)
+        , FileLength(File.GetLength())
+    {
+        Options.Validate();
+        CB_ENSURE(FileLength >= 0, "Can't get length of file " << path);
+
+        ThreadPool.Start(Options.ParallelRequestCount);
+        while ((BlocksInProgress.size() < Options.MaxBlocksInFlight) && (NextBlockOffset < FileLength)) {
+            StartNextBlockReading();
+        }
+    }
+
+    TReadAheadFileInput::~TReadAheadFileInput() {
+        ThreadPool.Stop();
+    }
+
+    size_t TReadAheadFileInput::DoNext(const void** ptr, size_t len) {
+        while (CurrentBlockPos == CurrentBlock.size()) {
+            if (BlocksInProgress.empty()) {
+                return 0;
+            }
+            CurrentBlock = BlocksInProgress.front().ExtractValueSync();
+            BlocksInProgress.pop_front();
+            CurrentBlockPos = 0;
+            if (NextBlockOffset < FileLength) {
+                StartNextBlockReading();
+            }
+        }
+        const size_t size = Min(len, CurrentBlock.size() - CurrentBlockPos);
+        *ptr = CurrentBlock.data() + CurrentBlockPos;
+        CurrentBlockPos += size;
+        return size;
+    }
+
+    void TReadAheadFileInput::DoUndo(size_t len) {
+        Y_ASSERT(len <= CurrentBlockPos);
+        CurrentBlockPos -= len;
+    }
+
+    void TReadAheadFileInput::StartNextBlockReading() {
+        const i64 offset = NextBlockOffset;
+        const size_t size = (size_t)Min<i64>(Options.BlockSize, FileLength - offset);
+        NextBlockOffset += size;
+        BlocksInProgress.push_back(
+            NThreading::Async(
+                [this, offset, size] () {
+                    TVector<char> block;
+                    block.yresize(size);
+                    File.Pload(block.data(), size, offset);
+                    return block;
+                },
+                ThreadPool
+            )
+        );
+    }
+
+
+    THolder<IInputStream> MakeFileInputWithReadAhead(const TString& path, const TReadAheadOptions& options) {
+        // pipes and other special files can't be read by range requests
+        const TFileStat fileStat(path);
+        if (fileStat.IsFile() && (fileStat.Size > options.BlockSize)) {
+            return MakeHolder<TReadAheadFileInput>(path, options);
+        }
+        return MakeHolder<TFileInput>(path);
+    }
+
+    TBlob ReadFileWithReadAhead(const TString& path, const TReadAheadOptions& options) {
+        options.Validate();
+
+        TFile file(path, OpenExisting | RdOnly);
+        const i64 fileLength = file.GetLength();
+        CB_ENSURE(fileLength >= 0, "Can't get length of file " << path);
+
+        TBuffer buffer(fileLength);
+        buffer.Resize(fileLength);
+
+        const size_t blockCount = CeilDiv<size_t>(fileLength, options.BlockSize);
+        {
+            TThreadPool threadPool;
+            threadPool.Start(Max<size_t>(Min(options.ParallelRequestCount, blockCount), 1));
+
+            TVector<NThreading::TFuture<void>> blocksInProgress;
+            for (auto blockIdx : xrange(blockCount)) {
+                const i64 offset = (i64)blockIdx * options.BlockSize;
+                const size_t size = (size_t)Min<i64>(options.BlockSize, fileLength - offset);
+                blocksInProgress.push_back(
+                    NThreading::Async(
+                        [&file, dst = buffer.Data() + offset, size, offset] () {
+                            file.Pload(dst, size, offset);
+                        },
+                        threadPool
+                    )
+                );
+            }
+            for (auto& blockInProgress : blocksInProgress) {
+                blockInProgress.GetValueSync();
+            }
+            threadPool.Stop();
+        }
+
+        return TBlob::FromBuffer(buffer);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <library/cpp/threading/future/future.h>
+
+#include <util/generic/deque.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/memory/blob.h>
+#include <util/stream/zerocopy.h>
+#include <util/system/file.h>
+#include <util/system/types.h>
+#include <util/thread/pool.h>
+
+
+namespace NCB {
+
+    struct TReadAheadOptions {
+        static constexpr size_t DefaultBlockSize = 8 << 20;
+        static constexpr size_t DefaultParallelRequestCount = 4;
+        static constexpr size_t DefaultMaxBlocksInFlight = 8;
+
+    public:
+        size_t BlockSize = DefaultBlockSize;
+
+        // number of range requests that are executed simultaneously
+        size_t ParallelRequestCount = DefaultParallelRequestCount;
+
+        /* max number of blocks that are read or already read, but not consumed yet,
+         * must be >= 2 to allow reading next block while the current one is consumed
+         */
+        size_t MaxBlocksInFlight = DefaultMaxBlocksInFlight;
+
+    public:
+        void Validate() const;
+    };
+
+    /*
+     * Input stream for files on storages with high latency (network file systems, HDFS or S3 mounts).
+     * File is read by blocks of fixed size with up to ParallelRequestCount positional range requests
+     *  executed simultaneously in background threads, blocks are returned in file order.
+     * It is a zero copy input with fast ReadTo, so ReadLine does not copy data through an additional buffer.
+     */
+    class TReadAheadFileInput final : public IZeroCopyInputFastReadTo {
+    public:
+        explicit TReadAheadFileInput(const TString& path, const TReadAheadOptions& options = TReadAheadOptions());
+
+        ~TReadAheadFileInput();
+
+    private:
+        size_t DoNext(const void** ptr, size_t len) override;
+        void DoUndo(size_t len) override;
+
+        void StartNextBlockReading();
+
+    private:
+        TReadAheadOptions Options;
+        TFile File;
+        i64 FileLength;
+        i64 NextBlockOffset = 0;
+        TThreadPool ThreadPool;
+        TDeque<NThreading::TFuture<TVector<char>>> BlocksInProgress; // in the order of blocks
+        TVector<char> CurrentBlock;
+        size_t CurrentBlockPos = 0;
+    };
+
+    // reads large files by blocks with TReadAheadFileInput and other files with TFileInput
+    THolder<IInputStream> MakeFileInputWithReadAhead(
+        const TString& path,
+        const TReadAheadOptions& options = TReadAheadOptions()
+    );
+
+    // reads the whole file into memory with parallel range requests
+    TBlob ReadFileWithReadAhead(const TString& path, const TReadAheadOptions& options = TReadAheadOptions());
+}
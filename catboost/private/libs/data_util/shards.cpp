@@ -0,0 +1,106 @@
+#include "shards.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/string.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/system/fs.h>
+
+
+namespace NCB {
+
+    static bool HasWildcards(TStringBuf name) {
+        return name.find_first_of("*?") != TStringBuf::npos;
+    }
+
+    // split path to directory and file name, directory is "." when path has no directory part
+    static void SplitPath(TStringBuf path, TString* dir, TString* name) {
+        const size_t separatorPos = path.find_last_of("/\\");
+        if (separatorPos == TStringBuf::npos) {
+            *dir = ".";
+            *name = path;
+        } else {
+            *dir = path.substr(0, separatorPos + 1);
+            *name = path.substr(separatorPos + 1);
+        }
+    }
+
+    bool IsShardedPath(const TPathWithScheme& pathWithScheme) {
+        TString dir;
+        TString name;
+        SplitPath(pathWithScheme.Path, &dir, &name);
+        if (HasWildcards(name)) {
+            CB_ENSURE(!HasWildcards(dir), "Wildcards are supported only in file names of dataset shards");
+            return true;
+        }
+        return TFsPath(pathWithScheme.Path).IsDirectory();
+    }
+
+    TVector<TPathWithScheme> GetShardPaths(const TPathWithScheme& pathWithScheme, TMaybe<ui64> shuffleSeed) {
+        TString dir;
+        TString pattern;
+        if (TFsPath(pathWithScheme.Path).IsDirectory()) {
+            dir = pathWithScheme.Path;
+            pattern = "*";
+        } else {
+            SplitPath(pathWithScheme.Path, &dir, &pattern);
+        }
+        CB_ENSURE(TFsPath(dir).IsDirectory(), "Directory of dataset shards '" << dir << "' does not exist");
+
+        TVector<TString> names;
+        TFsPath(dir).ListNames(names);
+        EraseIf(
+            names,
+            [&] (const TString& name) {
+                return name.StartsWith('.') || name.StartsWith('_')
+                    || !MatchesWildcardPattern(pattern, name)
+                    || !(TFsPath(dir) / name).IsFile();
+            }
+        );
+        Sort(names);
+
+        TVector<TPathWithScheme> shardPaths;
+        shardPaths.reserve(names.size());
+        for (const auto& name : names) {
+            TPathWithScheme shardPath;
+            shardPath.Scheme = pathWithScheme.Scheme;
+            shardPath.Path = (TFsPath(dir) / name).GetPath();
+            shardPaths.push_back(std::move(shardPath));
+        }
+
+        if (shuffleSeed) {
+            TFastRng64 rand(*shuffleSeed);
+            Shuffle(shardPaths.begin(), shardPaths.end(), rand);
+        }
+        return shardPaths;
+    }
+
+    bool MatchesWildcardPattern(TStringBuf pattern, TStringBuf name) {
+        // greedy matching with backtracking to the last '*'
+        size_t patternPos = 0;
+        size_t namePos = 0;
+        size_t starPatternPos = TStringBuf::npos;
+        size_t starNamePos = 0;
+        while (namePos < name.size()) {
+            if (patternPos < pattern.size() && (pattern[patternPos] == '?' || pattern[patternPos] == name[namePos])) {
+                ++patternPos;
+                ++namePos;
+            } else if (patternPos < pattern.size() && pattern[patternPos] == '*') {
+                starPatternPos = patternPos++;
+                starNamePos = namePos;
+            } else if (starPatternPos != TStringBuf::npos) {
+                patternPos = starPatternPos + 1;
+                namePos = ++starNamePos;
+            } else {
+                return false;
+            }
+        }
+        while (patternPos < pattern.size() && pattern[patternPos] == '*') {
+            ++patternPos;
+        }
+        return patternPos == pattern.size();
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "path_with_scheme.h"
+
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Dataset in the local file system can be split into several files (shards). Its path is then either
+     *  a directory (all files in it except hidden ones and ones starting with '_' are shards)
+     *  or a pattern with '*' and '?' wildcards in the file name, e.g. 'data/part-*.tsv'
+     */
+    bool IsShardedPath(const TPathWithScheme& pathWithScheme);
+
+    // shards have the scheme of pathWithScheme, they are sorted by path or shuffled if shuffleSeed is defined
+    TVector<TPathWithScheme> GetShardPaths(
+        const TPathWithScheme& pathWithScheme,
+        TMaybe<ui64> shuffleSeed = Nothing()
+    );
+
+    // '*' matches any sequence of characters, '?' matches any single character
+    bool MatchesWildcardPattern(TStringBuf pattern, TStringBuf name);
+}
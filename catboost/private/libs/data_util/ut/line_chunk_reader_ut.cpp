@@ -0,0 +1,77 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <catboost/private/libs/data_util/line_chunk_reader.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/system/tempfile.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> ReadAllLines(const TString& path, bool skipHeader, size_t chunkSize) {
+    TLineChunkReader reader(path, skipHeader, chunkSize);
+    TVector<TString> result;
+    TStringBuf chunk;
+    TVector<TStringBuf> lines;
+    while (reader.ReadChunk(&chunk)) {
+        SplitLines(chunk, &lines);
+        UNIT_ASSERT_VALUES_EQUAL(GetLineCount(chunk), lines.size());
+        for (auto line : lines) {
+            result.push_back(TString(line));
+        }
+    }
+    return result;
+}
+
+
+Y_UNIT_TEST_SUITE(TLineChunkReaderTest) {
+    Y_UNIT_TEST(TestEmpty) {
+        TTempFile tmpFile(MakeTempName());
+        {
+            TOFStream out(tmpFile.Name());
+        }
+        UNIT_ASSERT(ReadAllLines(tmpFile.Name(), /*skipHeader*/ false, 4).empty());
+    }
+
+    Y_UNIT_TEST(TestSameAsReadLine) {
+        TTempFile tmpFile(MakeTempName());
+        {
+            TOFStream out(tmpFile.Name());
+            out << "header\nl0\r\nlong line 1\n\nl3\nvery long line 4\nl5";
+        }
+        TVector<TString> expectedLines;
+        {
+            TIFStream in(tmpFile.Name());
+            TString line;
+            while (in.ReadLine(line)) {
+                expectedLines.push_back(line);
+            }
+        }
+        for (auto chunkSize : {1, 2, 3, 5, 8, 13, 100}) {
+            UNIT_ASSERT_VALUES_EQUAL(ReadAllLines(tmpFile.Name(), /*skipHeader*/ false, chunkSize), expectedLines);
+
+            TVector<TString> expectedDataLines(expectedLines.begin() + 1, expectedLines.end());
+            UNIT_ASSERT_VALUES_EQUAL(ReadAllLines(tmpFile.Name(), /*skipHeader*/ true, chunkSize), expectedDataLines);
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(TSplitAtLineBoundariesTest) {
+    Y_UNIT_TEST(TestSplit) {
+        const TStringBuf text = "l0\nline1\nl2\nvery long line 3\nl4\n";
+        for (auto partCount : xrange(1, 10)) {
+            const TVector<TStringBuf> parts = SplitAtLineBoundaries(text, partCount);
+            UNIT_ASSERT(parts.size() <= size_t(partCount));
+            TString joined;
+            for (auto part : parts) {
+                UNIT_ASSERT(!part.empty());
+                UNIT_ASSERT_VALUES_EQUAL(part.back(), '\n');
+                joined += part;
+            }
+            UNIT_ASSERT_VALUES_EQUAL(joined, text);
+        }
+        UNIT_ASSERT(SplitAtLineBoundaries(TStringBuf(), 4).empty());
+    }
+}
@@ -0,0 +1,94 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/private/libs/data_util/read_ahead_input.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/system/tempfile.h>
+
+
+using namespace NCB;
+
+
+static TString MakeFileData(size_t lineCount) {
+    TString data;
+    for (auto lineIdx : xrange(lineCount)) {
+        data += "line " + ToString(lineIdx) + (lineIdx % 3 ? "\n" : "\r\n");
+    }
+    return data;
+}
+
+static TReadAheadOptions MakeOptions(size_t blockSize, size_t parallelRequestCount, size_t maxBlocksInFlight) {
+    TReadAheadOptions options;
+    options.BlockSize = blockSize;
+    options.ParallelRequestCount = parallelRequestCount;
+    options.MaxBlocksInFlight = maxBlocksInFlight;
+    return options;
+}
+
+
+Y_UNIT_TEST_SUITE(TReadAheadInputTest) {
+    Y_UNIT_TEST(TestEmpty) {
+        TTempFile tmpFile(MakeTempName());
+        {
+            TOFStream out(tmpFile.Name());
+        }
+        TReadAheadFileInput input(tmpFile.Name(), MakeOptions(4, 2, 2));
+        UNIT_ASSERT_VALUES_EQUAL(input.ReadAll(), "");
+        UNIT_ASSERT_VALUES_EQUAL(ReadFileWithReadAhead(tmpFile.Name()).Size(), 0);
+    }
+
+    Y_UNIT_TEST(TestSameAsFileInput) {
+        TTempFile tmpFile(MakeTempName());
+        const TString data = MakeFileData(1000);
+        {
+            TOFStream out(tmpFile.Name());
+            out << data;
+        }
+        TVector<TString> expectedLines;
+        {
+            TIFStream in(tmpFile.Name());
+            TString line;
+            while (in.ReadLine(line)) {
+                expectedLines.push_back(line);
+            }
+        }
+        for (auto blockSize : {1, 3, 16, 1000, 100000}) {
+            for (auto parallelRequestCount : {1, 4}) {
+                const auto options = MakeOptions(blockSize, parallelRequestCount, 3);
+                {
+                    TReadAheadFileInput input(tmpFile.Name(), options);
+                    UNIT_ASSERT_VALUES_EQUAL(input.ReadAll(), data);
+                }
+                {
+                    TReadAheadFileInput input(tmpFile.Name(), options);
+                    TVector<TString> lines;
+                    TString line;
+                    while (input.ReadLine(line)) {
+                        lines.push_back(line);
+                    }
+                    UNIT_ASSERT_VALUES_EQUAL(lines, expectedLines);
+                }
+                {
+                    auto input = MakeFileInputWithReadAhead(tmpFile.Name(), options);
+                    UNIT_ASSERT_VALUES_EQUAL(input->ReadAll(), data);
+                }
+                const TBlob blob = ReadFileWithReadAhead(tmpFile.Name(), options);
+                UNIT_ASSERT_VALUES_EQUAL(TStringBuf(blob.AsCharPtr(), blob.Size()), data);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestBadOptions) {
+        TTempFile tmpFile(MakeTempName());
+        {
+            TOFStream out(tmpFile.Name());
+            out << "data";
+        }
+        UNIT_ASSERT_EXCEPTION(TReadAheadFileInput(tmpFile.Name(), MakeOptions(0, 1, 2)), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(TReadAheadFileInput(tmpFile.Name(), MakeOptions(1, 0, 2)), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(TReadAheadFileInput(tmpFile.Name(), MakeOptions(1, 1, 1)), TCatBoostException);
+    }
+}
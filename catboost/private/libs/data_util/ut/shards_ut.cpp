@@ -0,0 +1,137 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <catboost/private/libs/data_util/exists_checker.h>
+#include <catboost/private/libs/data_util/line_data_reader.h>
+#include <catboost/private/libs/data_util/shards.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+static void WriteShards(const TFsPath& dir, TConstArrayRef<TString> names, TConstArrayRef<TString> contents) {
+    for (auto i : xrange(names.size())) {
+        TOFStream out((dir / names[i]).GetPath());
+        out << contents[i];
+    }
+}
+
+static TVector<TString> GetNames(TConstArrayRef<TPathWithScheme> paths) {
+    TVector<TString> names;
+    for (const auto& path : paths) {
+        names.push_back(TFsPath(path.Path).GetName());
+    }
+    return names;
+}
+
+
+Y_UNIT_TEST_SUITE(TShardsTest) {
+    Y_UNIT_TEST(TestMatchesWildcardPattern) {
+        UNIT_ASSERT(MatchesWildcardPattern("*", ""));
+        UNIT_ASSERT(MatchesWildcardPattern("*", "part-0"));
+        UNIT_ASSERT(MatchesWildcardPattern("part-*.tsv", "part-00001.tsv"));
+        UNIT_ASSERT(MatchesWildcardPattern("part-*.tsv", "part-.tsv"));
+        UNIT_ASSERT(MatchesWildcardPattern("part-?.tsv", "part-1.tsv"));
+        UNIT_ASSERT(MatchesWildcardPattern("*a*b", "xaybab"));
+        UNIT_ASSERT(!MatchesWildcardPattern("part-?.tsv", "part-10.tsv"));
+        UNIT_ASSERT(!MatchesWildcardPattern("part-*.tsv", "part-1.tsv.gz"));
+        UNIT_ASSERT(!MatchesWildcardPattern("part", "part-1"));
+    }
+
+    Y_UNIT_TEST(TestGetShardPaths) {
+        TTempDir tmpDir;
+        const TFsPath dir(tmpDir.Name());
+        WriteShards(
+            dir,
+            {"part-2.tsv", "part-0.tsv", "part-1.tsv", "_SUCCESS", ".part-3.tsv.crc", "readme.txt"},
+            {"", "", "", "", "", ""}
+        );
+
+        const TPathWithScheme dirPath(dir.GetPath(), "dsv");
+        UNIT_ASSERT(IsShardedPath(dirPath));
+        const auto dirShards = GetShardPaths(dirPath);
+        UNIT_ASSERT_EQUAL(
+            GetNames(dirShards),
+            (TVector<TString>{"part-0.tsv", "part-1.tsv", "part-2.tsv", "readme.txt"})
+        );
+        UNIT_ASSERT_VALUES_EQUAL(dirShards[0].Scheme, "dsv");
+
+        const TPathWithScheme patternPath((dir / "part-*.tsv").GetPath(), "dsv");
+        UNIT_ASSERT(IsShardedPath(patternPath));
+        UNIT_ASSERT(CheckExists(patternPath));
+        UNIT_ASSERT_EQUAL(
+            GetNames(GetShardPaths(patternPath)),
+            (TVector<TString>{"part-0.tsv", "part-1.tsv", "part-2.tsv"})
+        );
+
+        const auto shuffledShards = GetNames(GetShardPaths(patternPath, /*shuffleSeed*/ 17));
+        UNIT_ASSERT_EQUAL(shuffledShards, GetNames(GetShardPaths(patternPath, /*shuffleSeed*/ 17)));
+        auto sortedShards = shuffledShards;
+        Sort(sortedShards);
+        UNIT_ASSERT_EQUAL(sortedShards, GetNames(GetShardPaths(patternPath)));
+
+        const TPathWithScheme filePath((dir / "part-0.tsv").GetPath(), "dsv");
+        UNIT_ASSERT(!IsShardedPath(filePath));
+        UNIT_ASSERT(!CheckExists(TPathWithScheme((dir / "*.bin").GetPath(), "dsv")));
+    }
+}
+
+Y_UNIT_TEST_SUITE(TShardedLineDataReaderTest) {
+    Y_UNIT_TEST(TestReadLines) {
+        TTempDir tmpDir;
+        const TFsPath dir(tmpDir.Name());
+        TVector<TString> names;
+        TVector<TString> contents;
+        TVector<TString> expectedLines;
+        for (auto shardIdx : xrange(7)) {
+            names.push_back("part-" + ToString(shardIdx));
+            TString content = "h0\th1\n";
+            for (auto lineIdx : xrange(shardIdx % 3)) {
+                const TString line = ToString(shardIdx) + "\t" + ToString(lineIdx);
+                content += line + "\n";
+                expectedLines.push_back(line);
+            }
+            contents.push_back(content);
+        }
+        WriteShards(dir, names, contents);
+
+        TLineDataReaderArgs args;
+        args.PathWithScheme = TPathWithScheme(dir.GetPath(), "dsv");
+        args.Format.HasHeader = true;
+        TShardedLineDataReader reader(args, /*readAheadShardCount*/ 2);
+
+        UNIT_ASSERT_EQUAL(reader.GetHeader(), TMaybe<TString>("h0\th1"));
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetDataLineCount(), expectedLines.size());
+
+        TString line;
+        ui64 lineIdx;
+        for (auto expectedLineIdx : xrange(expectedLines.size())) {
+            UNIT_ASSERT(reader.ReadLine(&line, &lineIdx));
+            UNIT_ASSERT_VALUES_EQUAL(line, expectedLines[expectedLineIdx]);
+            UNIT_ASSERT_VALUES_EQUAL(lineIdx, expectedLineIdx);
+        }
+        UNIT_ASSERT(!reader.ReadLine(&line));
+    }
+
+    Y_UNIT_TEST(TestDifferentHeaders) {
+        TTempDir tmpDir;
+        const TFsPath dir(tmpDir.Name());
+        WriteShards(dir, {"part-0", "part-1"}, {"a\tb\n0\t1\n", "a\tc\n2\t3\n"});
+
+        TLineDataReaderArgs args;
+        args.PathWithScheme = TPathWithScheme((dir / "part-*").GetPath(), "dsv");
+        args.Format.HasHeader = true;
+        auto reader = GetLineDataReader(args.PathWithScheme, args.Format);
+
+        UNIT_ASSERT(reader->GetHeader().Defined());
+        TString line;
+        UNIT_ASSERT(reader->ReadLine(&line));
+        UNIT_ASSERT_EXCEPTION(reader->ReadLine(&line), TCatBoostException);
+    }
+}
@@ -44,6 +44,19 @@ namespace NCatboostDistributed {
 
     using TWorkerPairwiseStats = TVector<TVector<TPairwiseStats>>; // [cand][subCand]
 
+    // TStats4D as it is sent between hosts, see EHistogramsWireFormat
+    struct TStats4DMessage {
+        EHistogramsWireFormat Format = EHistogramsWireFormat::Plain;
+
+        // for compact formats buckets of subcandidates are moved to PackedStats and Stats[subCand].Stats are empty
+        TStats4D Stats;
+        TVector<ui64> BucketStatsCounts; // [subCand]
+        TString PackedStats;
+
+    public:
+        SAVELOAD(Format, Stats, BucketStatsCounts, PackedStats);
+    };
+
     struct TTrainData : public IObjectBase {
         NCB::TTrainingDataProviders TrainData;
 
@@ -68,6 +81,9 @@ namespace NCatboostDistributed {
         double SumAllWeights;
         EHessianType HessianType;
 
+        // text and embedding estimators are shared by all workers, quantization of their online features too
+        NCB::TQuantizedEstimatedFeaturesInfo OnlineEstimatedFeaturesInfo;
+
     public:
         SAVELOAD(
             TargetClassifiers,
@@ -76,7 +92,8 @@ namespace NCatboostDistributed {
             TrainParams,
             AllDocCount,
             SumAllWeights,
-            HessianType);
+            HessianType,
+            OnlineEstimatedFeaturesInfo);
     };
 
     struct TDatasetLoaderParams {
@@ -88,6 +105,7 @@ namespace NCatboostDistributed {
         NCB::TFeaturesLayout FeaturesLayout;
         TLabelConverter LabelConverter;
         ui64 RandomSeed;
+        TVector<double> WorkerShardWeights; // [workerIdx], empty for equal shards
 
     public:
         SAVELOAD(
@@ -98,7 +116,8 @@ namespace NCatboostDistributed {
             TestObjectsGroupings,
             FeaturesLayout,
             LabelConverter,
-            RandomSeed);
+            RandomSeed,
+            WorkerShardWeights);
     };
 
     struct TApproxReconstructorParams {
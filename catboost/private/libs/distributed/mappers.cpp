@@ -22,8 +22,17 @@
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/index_range/index_range.h>
 
+#include <library/cpp/blockcodecs/codecs.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/buffer.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/system/unaligned_mem.h>
 
+#include <cmath>
 #include <limits>
 #include <utility>
 
@@ -93,17 +102,98 @@ namespace NCatboostDistributed {
         return result;
     }
 
+    TVector<NCB::TIndexRange<ui32>> SplitBetweenWorkers(
+        const NCB::TObjectsGrouping& objectsGrouping,
+        ui32 workerCount,
+        TConstArrayRef<double> workerShardWeights
+    ) {
+        if (workerShardWeights.empty()) {
+            return WorkaroundSplit(objectsGrouping, workerCount);
+        }
+        CB_ENSURE_INTERNAL(workerShardWeights.size() == workerCount, "Worker shard weights count differs from worker count");
+        const ui32 groupCount = objectsGrouping.GetGroupCount();
+        const ui32 objectCount = objectsGrouping.GetObjectCount();
+        CB_ENSURE(groupCount >= workerCount, "Pool must contain at least " << workerCount << " groups");
+        const double sumWeights = Accumulate(workerShardWeights, 0.0);
+        CB_ENSURE_INTERNAL(sumWeights > 0, "Worker shard weights should be positive");
+
+        TVector<NCB::TIndexRange<ui32>> result;
+        ui32 startGroup = 0;
+        double prefixWeight = 0;
+        for (ui32 workerIdx : xrange(workerCount)) {
+            prefixWeight += workerShardWeights[workerIdx];
+            ui32 endGroup = groupCount;
+            if (workerIdx + 1 < workerCount) {
+                // each worker gets at least one group
+                endGroup = static_cast<ui32>(std::llround(groupCount * prefixWeight / sumWeights));
+                endGroup = Min(Max(endGroup, startGroup + 1), groupCount - (workerCount - workerIdx - 1));
+            }
+            result.emplace_back(
+                objectsGrouping.GetGroup(startGroup).Begin,
+                endGroup == groupCount ? objectCount : objectsGrouping.GetGroup(endGroup).Begin);
+            startGroup = endGroup;
+        }
+        return result;
+    }
+
     static NCB::TDatasetSubset GetSubsetForWorker(
        int workerCount,
        int hostId,
-       const NCB::TObjectsGrouping& objectsGrouping
+       const NCB::TObjectsGrouping& objectsGrouping,
+       TConstArrayRef<double> workerShardWeights
     ) {
-        const auto workerParts = WorkaroundSplit(objectsGrouping, workerCount);
+        const auto workerParts = SplitBetweenWorkers(objectsGrouping, workerCount, workerShardWeights);
         const ui32 loadStart = workerParts[hostId].Begin;
         const ui32 loadEnd = workerParts[hostId].End;
         return NCB::TDatasetSubset::MakeRange(loadStart, loadEnd);
     }
 
+    void TWorkerSpeedCalibrator::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int hostId,
+        TInput* /*unused*/,
+        TOutput* speed
+    ) const {
+        constexpr ui32 objectCount = 1 << 22;
+        constexpr ui32 bucketCount = 256;
+        constexpr int repeatCount = 3;
+
+        TFastRng64 rng(hostId);
+        TVector<ui8> bins(objectCount);
+        TVector<double> derivatives(objectCount);
+        for (auto idx : xrange(objectCount)) {
+            bins[idx] = rng.Uniform(bucketCount);
+            derivatives[idx] = rng.GenRandReal1();
+        }
+
+        auto& localExecutor = NPar::LocalExecutor();
+        NPar::ILocalExecutor::TExecRangeParams blockParams(0, objectCount);
+        blockParams.SetBlockCount(localExecutor.GetThreadCount() + 1);
+        TVector<TVector<TBucketStats>> blockStats(blockParams.GetBlockCount());
+
+        // the best of several runs to filter out warm up
+        TDuration bestDuration = TDuration::Max();
+        for (auto repeat : xrange(repeatCount)) {
+            Y_UNUSED(repeat);
+            const TInstant startTime = TInstant::Now();
+            localExecutor.ExecRangeWithThrow(
+                [&] (int blockIdx) {
+                    auto& stats = blockStats[blockIdx];
+                    stats.assign(bucketCount, TBucketStats{0, 0, 0, 0});
+                    const int blockStart = blockIdx * blockParams.GetBlockSize();
+                    const int blockEnd = Min<int>(blockStart + blockParams.GetBlockSize(), objectCount);
+                    for (auto idx : xrange(blockStart, blockEnd)) {
+                        stats[bins[idx]].AddWeighted(derivatives[idx], 1.0f);
+                    }
+                },
+                0,
+                blockParams.GetBlockCount(),
+                NPar::ILocalExecutor::WAIT_COMPLETE);
+            bestDuration = Min(bestDuration, TInstant::Now() - startTime);
+        }
+        *speed = objectCount / Max(bestDuration.SecondsFloat(), 1e-6);
+    }
+
     void TDatasetsLoader::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
@@ -120,7 +210,7 @@ namespace NCatboostDistributed {
 
         TVector<NCB::TDatasetSubset> testDatasetSubsets;
         for (const auto& testObjectsGrouping : params->TestObjectsGroupings) {
-            testDatasetSubsets.push_back(GetSubsetForWorker(workerCount, hostId, testObjectsGrouping));
+            testDatasetSubsets.push_back(GetSubsetForWorker(workerCount, hostId, testObjectsGrouping, params->WorkerShardWeights));
         }
 
         NCatboostOptions::TCatBoostOptions catBoostOptions(ETaskType::CPU);
@@ -135,7 +225,7 @@ namespace NCatboostDistributed {
             poolLoadOptions,
             params->ObjectsOrder,
             /*readTest*/true,
-            GetSubsetForWorker(workerCount, hostId, params->LearnObjectsGrouping),
+            GetSubsetForWorker(workerCount, hostId, params->LearnObjectsGrouping, params->WorkerShardWeights),
             testDatasetSubsets,
             catBoostOptions.DataProcessingOptions->ForceUnitAutoPairWeights,
             &localData.ClassLabelsFromDataset,
@@ -209,6 +299,8 @@ namespace NCatboostDistributed {
             /*foldCreationParamsCheckSum*/ 0,
             /*estimatedFeaturesQuantizationOptions*/
                 trainParams.DataProcessingOptions->FloatFeaturesBinarization.Get(),
+            // use master's borders so that bins of online estimated features are the same on all workers
+            params->OnlineEstimatedFeaturesInfo.QuantizedFeaturesInfo,
             localData.PrecomputedSingleOnlineCtrDataForSingleFold,
             trainParams.ObliviousTreeOptions.Get(),
             /*initModel*/ Nothing(),
@@ -230,10 +322,15 @@ namespace NCatboostDistributed {
         if (learnObjectCount) {
             Y_ASSERT(localData.Progress->AveragingFold.BodyTailArr.ysize() == 1);
 
+            const int nonCtrBucketCount = CountNonCtrBuckets(
+                *(GetTrainData(trainData).Learn->ObjectsData->GetFeaturesLayout()),
+                *(GetTrainData(trainData).Learn->ObjectsData->GetQuantizedFeaturesInfo()),
+                trainParams.CatFeatureParams->OneHotMaxSize.Get());
             localData.UseTreeLevelCaching = NeedToUseTreeLevelCaching(
                 trainParams,
                 /*maxBodyTailCount=*/1,
-                localData.Progress->AveragingFold.GetApproxDimension());
+                localData.Progress->AveragingFold.GetApproxDimension(),
+                nonCtrBucketCount);
 
             auto& plainFold = localData.Progress->AveragingFold;
             localData.SampledDocs.Create(
@@ -250,10 +347,7 @@ namespace NCatboostDistributed {
                     defaultCalcStatsObjBlockSize);
                 localData.PrevTreeLevelStats.Create(
                     { plainFold },
-                    CountNonCtrBuckets(
-                        *(GetTrainData(trainData).Learn->ObjectsData->GetFeaturesLayout()),
-                        *(GetTrainData(trainData).Learn->ObjectsData->GetQuantizedFeaturesInfo()),
-                        trainParams.CatFeatureParams->OneHotMaxSize.Get()),
+                    nonCtrBucketCount,
                     trainParams.ObliviousTreeOptions->MaxDepth);
             }
         }
@@ -373,8 +467,8 @@ namespace NCatboostDistributed {
             Y_ASSERT(weightedDerivatives.size() > 0);
 
 
-            for (const auto& perDimensionWeightedDerivatives : weightedDerivatives) {
-                sum2 += NCB::L2NormSquared<double>(perDimensionWeightedDerivatives, &NPar::LocalExecutor());
+            for (auto dim : xrange(weightedDerivatives.size())) {
+                sum2 += NCB::L2NormSquared<double>(weightedDerivatives[dim], &NPar::LocalExecutor());
             }
         }
         *outSum2 = sum2;
@@ -426,6 +520,7 @@ namespace NCatboostDistributed {
             localData.SmallestSplitSideDocs,
             /*initialFold*/nullptr,
             /*pairs*/{},
+            /*pairLeaves*/{},
             localData.Params,
             candidate,
             localData.Depth,
@@ -434,6 +529,7 @@ namespace NCatboostDistributed {
             /*monotonicConstraints*/{},
             &NPar::LocalExecutor(),
             &localData.PrevTreeLevelStats,
+            /*scratchCache*/nullptr,
             stats3D,
             /*pairwiseStats*/nullptr,
             /*scoreCalcer*/nullptr);
@@ -453,6 +549,7 @@ namespace NCatboostDistributed {
             localData.SmallestSplitSideDocs,
             /*initialFold*/nullptr,
             pairs,
+            /*pairLeaves*/{},
             localData.Params,
             candidate,
             localData.Depth,
@@ -461,6 +558,7 @@ namespace NCatboostDistributed {
             /*monotonicConstraints*/{},
             &NPar::LocalExecutor(),
             &localData.PrevTreeLevelStats,
+            /*scratchCache*/nullptr,
             /*stats3D*/nullptr,
             pairwiseStats,
             /*scoreCalcer*/nullptr);
@@ -558,6 +656,105 @@ namespace NCatboostDistributed {
         MapVector(getScores, *bucketStats, scores);
     }
 
+    static constexpr TStringBuf StatsCodecName = "lz4";
+
+    static bool IsEmptyBucket(const TBucketStats& bucket) {
+        return bucket.SumWeightedDelta == 0 && bucket.SumWeight == 0 && bucket.SumDelta == 0 && bucket.Count == 0;
+    }
+
+    // bit mask of non-empty buckets followed by sums of non-empty buckets
+    template <class TSum>
+    static void PackBuckets(TConstArrayRef<TBucketStats> buckets, TBuffer* packedBuckets) {
+        const size_t maskOffset = packedBuckets->Size();
+        const size_t maskSize = CeilDiv<size_t>(buckets.size(), 8);
+        packedBuckets->Resize(maskOffset + maskSize);
+        Fill(packedBuckets->Data() + maskOffset, packedBuckets->Data() + maskOffset + maskSize, 0);
+        for (auto bucketIdx : xrange(buckets.size())) {
+            const auto& bucket = buckets[bucketIdx];
+            if (IsEmptyBucket(bucket)) {
+                continue;
+            }
+            packedBuckets->Data()[maskOffset + bucketIdx / 8] |= 1 << (bucketIdx % 8);
+            const TSum sums[] = {
+                static_cast<TSum>(bucket.SumWeightedDelta),
+                static_cast<TSum>(bucket.SumWeight),
+                static_cast<TSum>(bucket.SumDelta),
+                static_cast<TSum>(bucket.Count)
+            };
+            packedBuckets->Append(reinterpret_cast<const char*>(sums), sizeof(sums));
+        }
+    }
+
+    template <class TSum>
+    static const char* UnpackBuckets(const char* packedBuckets, const char* packedEnd, TArrayRef<TBucketStats> buckets) {
+        const char* mask = packedBuckets;
+        const char* sums = packedBuckets + CeilDiv<size_t>(buckets.size(), 8);
+        CB_ENSURE_INTERNAL(sums <= packedEnd, "Packed bucket stats are truncated");
+        for (auto bucketIdx : xrange(buckets.size())) {
+            auto& bucket = buckets[bucketIdx];
+            if (!(mask[bucketIdx / 8] & (1 << (bucketIdx % 8)))) {
+                bucket = TBucketStats{0, 0, 0, 0};
+                continue;
+            }
+            CB_ENSURE_INTERNAL(sums + 4 * sizeof(TSum) <= packedEnd, "Packed bucket stats are truncated");
+            bucket.SumWeightedDelta = ReadUnaligned<TSum>(sums);
+            bucket.SumWeight = ReadUnaligned<TSum>(sums + sizeof(TSum));
+            bucket.SumDelta = ReadUnaligned<TSum>(sums + 2 * sizeof(TSum));
+            bucket.Count = ReadUnaligned<TSum>(sums + 3 * sizeof(TSum));
+            sums += 4 * sizeof(TSum);
+        }
+        return sums;
+    }
+
+    static void PackStats4D(TStats4D&& stats, EHistogramsWireFormat format, TStats4DMessage* message) {
+        message->Format = format;
+        message->BucketStatsCounts.clear();
+        message->PackedStats.clear();
+        if (format == EHistogramsWireFormat::Plain) {
+            message->Stats = std::move(stats);
+            return;
+        }
+
+        TBuffer packedStats;
+        for (auto& stats3D : stats) {
+            message->BucketStatsCounts.push_back(stats3D.Stats.size());
+            if (format == EHistogramsWireFormat::CompactFloat) {
+                PackBuckets<float>(stats3D.Stats, &packedStats);
+            } else {
+                PackBuckets<double>(stats3D.Stats, &packedStats);
+            }
+            TVector<TBucketStats>().swap(stats3D.Stats);
+        }
+        message->Stats = std::move(stats);
+        message->PackedStats = NBlockCodecs::Codec(StatsCodecName)->Encode(
+            TStringBuf(packedStats.Data(), packedStats.Size()));
+    }
+
+    static void UnpackStats4D(TStats4DMessage&& message, TStats4D* stats) {
+        *stats = std::move(message.Stats);
+        if (message.Format == EHistogramsWireFormat::Plain) {
+            return;
+        }
+
+        CB_ENSURE_INTERNAL(
+            message.BucketStatsCounts.size() == stats->size(),
+            "Packed bucket stats don't match subcandidates"
+        );
+        const TString packedStats = NBlockCodecs::Codec(StatsCodecName)->Decode(message.PackedStats);
+        const char* packedIt = packedStats.data();
+        const char* packedEnd = packedStats.data() + packedStats.size();
+        for (auto subcandidateIdx : xrange(stats->size())) {
+            auto& buckets = (*stats)[subcandidateIdx].Stats;
+            buckets.yresize(message.BucketStatsCounts[subcandidateIdx]);
+            if (message.Format == EHistogramsWireFormat::CompactFloat) {
+                packedIt = UnpackBuckets<float>(packedIt, packedEnd, buckets);
+            } else {
+                packedIt = UnpackBuckets<double>(packedIt, packedEnd, buckets);
+            }
+        }
+        CB_ENSURE_INTERNAL(packedIt == packedEnd, "Packed bucket stats have extra data");
+    }
+
     // subcandidates -> TStats4D
     void TRemoteBinCalcer::DoMap(
         NPar::IUserContext* ctx,
@@ -570,38 +767,64 @@ namespace NCatboostDistributed {
             auto calcStats3D = [&](const TCandidateInfo& candidate, TStats3D* stats3D) {
                 CalcStats3D(trainData, candidate, stats3D);
             };
-            MapVector(calcStats3D, candidatesInfoList->Candidates, bucketStats);
+            TStats4D stats;
+            MapVector(calcStats3D, candidatesInfoList->Candidates, &stats);
+            PackStats4D(
+                std::move(stats),
+                TLocalTensorSearchData::GetRef().Params.SystemOptions->HistogramsWireFormat.Get(),
+                bucketStats);
         }
     }
 
     // vector<TStats4D> -> TStats4D
     void TRemoteBinCalcer::DoReduce(TVector<TOutput>* statsFromAllWorkers, TOutput* stats) const {
         // some workers may return empty result because they don't have any learn subset
-        const TVector<size_t> validWorkers = GetNonEmptyElementsIndices(*statsFromAllWorkers);
+        TVector<size_t> validWorkers;
+        for (auto workerIdx : xrange(statsFromAllWorkers->size())) {
+            if (!(*statsFromAllWorkers)[workerIdx].Stats.empty()) {
+                validWorkers.push_back(workerIdx);
+            }
+        }
         const auto validWorkersSize = validWorkers.size();
         CB_ENSURE_INTERNAL(validWorkersSize, "No workers returned bin stats");
 
-        const int bucketCount = (*statsFromAllWorkers)[validWorkers[0]].ysize();
-        stats->yresize(bucketCount);
+        // reduced stats are sent in the format of workers
+        const auto format = (*statsFromAllWorkers)[validWorkers[0]].Format;
+        TVector<TStats4D> validWorkersStats(validWorkersSize);
+        NPar::ParallelFor(
+            0,
+            validWorkersSize,
+            [&] (int validWorkerIdx) {
+                UnpackStats4D(
+                    std::move((*statsFromAllWorkers)[validWorkers[validWorkerIdx]]),
+                    &validWorkersStats[validWorkerIdx]);
+            });
+
+        const int bucketCount = validWorkersStats[0].ysize();
+        TStats4D reducedStats;
+        reducedStats.yresize(bucketCount);
         NPar::ParallelFor(
             0,
             bucketCount,
             [&, validWorkersSize] (int bucketIdx) {
-                (*stats)[bucketIdx] = (*statsFromAllWorkers)[validWorkers[0]][bucketIdx];
+                reducedStats[bucketIdx] = std::move(validWorkersStats[0][bucketIdx]);
                 for (size_t validWorkerIdx = 1; validWorkerIdx < validWorkersSize; ++validWorkerIdx) {
-                    (*stats)[bucketIdx].Add((*statsFromAllWorkers)[validWorkers[validWorkerIdx]][bucketIdx]);
+                    reducedStats[bucketIdx].Add(validWorkersStats[validWorkerIdx][bucketIdx]);
                 }
             });
+        PackStats4D(std::move(reducedStats), format, stats);
     }
 
     // TStats4D -> TVector<TVector<double>> [subcandidate][bucket]
     void TRemoteScoreCalcer::DoMap(
         NPar::IUserContext* /*ctx*/,
         int /*hostId*/,
-        TInput* bucketStats,
+        TInput* bucketStatsMessage,
         TOutput* scores
     ) const {
         const auto& localData = TLocalTensorSearchData::GetRef();
+        TStats4D bucketStats;
+        UnpackStats4D(std::move(*bucketStatsMessage), &bucketStats);
         const auto getScores =
             [&] (const TStats3D& candidateStats3D, TVector<double>* candidateScores) {
                 *candidateScores = GetScores(candidateStats3D,
@@ -610,14 +833,14 @@ namespace NCatboostDistributed {
                                              localData.AllDocCount,
                                              localData.Params);
             };
-        MapVector(getScores, *bucketStats, scores);
+        MapVector(getScores, bucketStats, scores);
     }
 
     void TLeafIndexSetter::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
         TInput* bestSplit,
-        TOutput* /*unused*/
+        TOutput* isLeafEmpty
     ) const {
         auto& localData = TLocalTensorSearchData::GetRef();
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
@@ -643,23 +866,6 @@ namespace NCatboostDistributed {
                         &NPar::LocalExecutor());
                 }
             }
-        }
-    }
-
-    void TEmptyLeafFinder::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
-        TInput* /*unused*/,
-        TOutput* isLeafEmpty
-    ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
-
-        TArrayRef<TIndexType> learnIndices(
-            localData.Indices.data(),
-            GetTrainData(trainData).Learn->GetObjectCount());
-
-        if (!learnIndices.empty()) {
             *isLeafEmpty = GetIsLeafEmpty(localData.Depth + 1, learnIndices, &NPar::LocalExecutor());
         }
         ++localData.Depth; // tree level completed
@@ -684,6 +890,7 @@ namespace NCatboostDistributed {
                     localData.Progress->AveragingFold.BodyTailArr[0].BodyFinish;
             TVector<TDers> weightedDers;
             weightedDers.yresize(scratchSize);
+            TMemoryPool iterationPool(/*initial*/ 64 * 1024);
 
             CalcLeafDersSimple(
                 localData.Indices,
@@ -699,6 +906,7 @@ namespace NCatboostDistributed {
                 localData.Params,
                 localData.Progress->Rand.GenRand(),
                 &NPar::LocalExecutor(),
+                &iterationPool,
                 &localData.Buckets,
                 &localData.PairwiseBuckets,
                 &weightedDers);
@@ -1313,7 +1521,6 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d485, NCatboostDistributed, TScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d585, NCatboostDistributed, TRemoteBinCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d685, NCatboostDistributed, TRemoteScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d486, NCatboostDistributed, TLeafIndexSetter);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d487, NCatboostDistributed, TEmptyLeafFinder);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d488, NCatboostDistributed, TCalcApproxStarter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d489, NCatboostDistributed, TDeltaSimpleUpdater);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d48a, NCatboostDistributed, TApproxUpdater);
@@ -1334,6 +1541,7 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d4d6, NCatboostDistributed, TApproxReconstructor
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e0, NCatboostDistributed, TLeafWeightsGetter);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e1, NCatboostDistributed, TDatasetsLoader);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e2, NCatboostDistributed, TWorkerSpeedCalibrator);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e3, NCatboostDistributed, TQuantileExactApproxStarter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e4, NCatboostDistributed, TQuantileArraySplitter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e5, NCatboostDistributed, TQuantileEqualWeightsCalcer);
@@ -4,15 +4,30 @@
 
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/private/libs/algo/tensor_search_helpers.h>
+#include <catboost/private/libs/index_range/index_range.h>
 
 #include <library/cpp/par/par.h>
 #include <library/cpp/par/par_util.h>
 
+#include <util/generic/array_ref.h>
 #include <util/ysafeptr.h>
 
 
 namespace NCatboostDistributed {
 
+    /* Splits objects into contiguous shards at group boundaries,
+     * shard sizes are proportional to workerShardWeights or equal if it is empty
+     */
+    TVector<NCB::TIndexRange<ui32>> SplitBetweenWorkers(
+        const NCB::TObjectsGrouping& objectsGrouping,
+        ui32 workerCount,
+        TConstArrayRef<double> workerShardWeights);
+
+    // returns relative speed of the worker on a synthetic histograms calculation
+    class TWorkerSpeedCalibrator: public NPar::TMapReduceCmd<TUnusedInitializedParam, double> {
+        OBJECT_NOCOPY_METHODS(TWorkerSpeedCalibrator);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* speed) const final;
+    };
     class TDatasetsLoader: public NPar::TMapReduceCmd<TDatasetLoaderParams, TUnusedInitializedParam> {
         OBJECT_NOCOPY_METHODS(TDatasetsLoader);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* params, TOutput* /*unused*/) const final;
@@ -82,29 +97,22 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TRemotePairwiseScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
-    class TRemoteBinCalcer: public NPar::TMapReduceCmd<TCandidatesInfoList, TStats4D> { // [subcand]
+    class TRemoteBinCalcer: public NPar::TMapReduceCmd<TCandidatesInfoList, TStats4DMessage> { // [subcand]
         OBJECT_NOCOPY_METHODS(TRemoteBinCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* candidatesInfoList, TOutput* bucketStats) const final;
         void DoReduce(TVector<TOutput>* statsFromAllWorkers, TOutput* bucketStats) const final;
     };
-    class TRemoteScoreCalcer: public NPar::TMapReduceCmd<TStats4D, TVector<TVector<double>>> {
+    class TRemoteScoreCalcer: public NPar::TMapReduceCmd<TStats4DMessage, TVector<TVector<double>>> {
         OBJECT_NOCOPY_METHODS(TRemoteScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
-    class TLeafIndexSetter: public NPar::TMapReduceCmd<TSplit, TUnusedInitializedParam> {
+    // also returns empty leaves after the split, so that a tree level takes one round trip
+    class TLeafIndexSetter: public NPar::TMapReduceCmd<TSplit, TIsLeafEmpty> {
         OBJECT_NOCOPY_METHODS(TLeafIndexSetter);
         void DoMap(
             NPar::IUserContext* ctx,
             int hostId,
             TInput* bestSplit,
-            TOutput* /*unused*/) const final;
-    };
-    class TEmptyLeafFinder: public NPar::TMapReduceCmd<TUnusedInitializedParam, TIsLeafEmpty> {
-        OBJECT_NOCOPY_METHODS(TEmptyLeafFinder);
-        void DoMap(
-            NPar::IUserContext* /*ctx*/,
-            int /*hostId*/,
-            TInput* /*unused*/,
             TOutput* isLeafEmpty) const final;
     };
     class TBucketSimpleUpdater:
@@ -4,6 +4,7 @@
 #include <catboost/libs/data/load_data.h>
 #include <catboost/libs/helpers/parallel_tasks.h>
 #include <catboost/libs/helpers/quantile.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/algo/approx_calcer_helpers.h>
 #include <catboost/private/libs/algo/approx_calcer/gradient_walker.h>
 #include <catboost/private/libs/algo/approx_updater_helpers.h>
@@ -29,6 +30,7 @@ using namespace NCB;
 struct TMasterEnvironment {
     TObj<NPar::IRootEnvironment> RootEnvironment = nullptr;
     TObj<NPar::IEnvironment> SharedTrainData = nullptr;
+    TVector<double> WorkerShardWeights; // [workerIdx], empty for equal shards
 
     Y_DECLARE_SINGLETON_FRIEND();
 
@@ -52,6 +54,19 @@ TMasterContext::TMasterContext(const NCatboostOptions::TSystemOptions& systemOpt
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
     const auto& workerMapping = TMasterEnvironment::GetRef().RootEnvironment->MakeHostIdMapping(workerCount);
     TMasterEnvironment::GetRef().SharedTrainData = TMasterEnvironment::GetRef().RootEnvironment->CreateEnvironment(SHARED_ID_TRAIN_DATA, workerMapping);
+
+    auto& workerShardWeights = TMasterEnvironment::GetRef().WorkerShardWeights;
+    workerShardWeights.clear();
+    if (systemOptions.BalanceWorkerShards.Get()) {
+        workerShardWeights = ApplyMapper<TWorkerSpeedCalibrator>(
+            workerCount,
+            TMasterEnvironment::GetRef().SharedTrainData);
+        const double maxSpeed = *MaxElement(workerShardWeights.begin(), workerShardWeights.end());
+        for (auto workerIdx : xrange(workerCount)) {
+            CATBOOST_INFO_LOG << "Worker " << workerIdx << " relative speed "
+                << workerShardWeights[workerIdx] / maxSpeed << Endl;
+        }
+    }
 }
 
 TMasterContext::~TMasterContext() {
@@ -89,7 +104,8 @@ void SetTrainDataFromQuantizedPools(
                 std::move(testObjectsGroupings),
                 featuresLayout,
                 labelConverter,
-                rand->GenRand()
+                rand->GenRand(),
+                TMasterEnvironment::GetRef().WorkerShardWeights
             }
         );
     }
@@ -125,12 +141,27 @@ void SetTrainDataFromMaster(
     NPar::ILocalExecutor* localExecutor
 ) {
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
+    const auto& workerShardWeights = TMasterEnvironment::GetRef().WorkerShardWeights;
+
+    const auto splitBetweenWorkers = [&] (const TObjectsGrouping& objectsGrouping) {
+        if (workerShardWeights.empty()) {
+            return Split(objectsGrouping, (ui32)workerCount);
+        }
+        TVector<TArraySubsetIndexing<ui32>> workerParts;
+        for (const auto& range : SplitBetweenWorkers(objectsGrouping, (ui32)workerCount, workerShardWeights)) {
+            TSubsetBlock<ui32> block(range, /*dstBegin*/ 0);
+            workerParts.push_back(
+                TArraySubsetIndexing<ui32>(
+                    TRangesSubset<ui32>(block.GetSize(), TVector<TSubsetBlock<ui32>>{std::move(block)})));
+        }
+        return workerParts;
+    };
 
-    auto learnWorkerParts = Split(*trainData.Learn->ObjectsGrouping, (ui32)workerCount);
+    auto learnWorkerParts = splitBetweenWorkers(*trainData.Learn->ObjectsGrouping);
 
     TVector<TVector<TArraySubsetIndexing<ui32>>> testWorkerParts; // [testIdx][workerIdx]
     for (auto testIdx : xrange(trainData.Test.size())) {
-        testWorkerParts.push_back(Split(*trainData.Test[testIdx]->ObjectsGrouping, (ui32)workerCount));
+        testWorkerParts.push_back(splitBetweenWorkers(*trainData.Test[testIdx]->ObjectsGrouping));
     }
 
     const bool hasEstimatedData = !!trainData.EstimatedObjectsData.Learn;
@@ -211,7 +242,8 @@ void MapBuildPlainFold(TLearnContext* ctx) {
             WriteTJsonValue(jsonParams),
             plainFold.GetLearnSampleCount(),
             plainFold.GetSumWeight(),
-            ctx->LearnProgress->HessianType
+            ctx->LearnProgress->HessianType,
+            ctx->LearnProgress->GetOnlineEstimatedFeaturesInfo()
         })
     );
 }
@@ -313,6 +345,10 @@ void MapCalcScore(
     MapGenericCalcScore<TScoreCalcer>(getScore, scoreStDev, candidatesContext, ctx);
 }
 
+/* Stats are not reduced on the master: RemoteMap splits candidates into parts, each part is reduced and scored
+ * by TScoreCalcMapper on some worker (a reduce-scatter over candidates), and only scores come back.
+ * The best splits are selected here because it needs candidate contexts and the master random state.
+ */
 template <typename TBinCalcMapper, typename TScoreCalcMapper>
 void MapGenericRemoteCalcScore(
     double scoreStDev,
@@ -384,17 +420,11 @@ void MapRemoteCalcScore(
         ctx);
 }
 
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx) {
-    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    ApplyMapper<TLeafIndexSetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, bestSplit);
-}
-
-int MapGetRedundantSplitIdx(TLearnContext* ctx) {
+int MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = TMasterEnvironment::GetRef().RootEnvironment->GetSlaveCount();
-    TVector<TEmptyLeafFinder::TOutput> isLeafEmptyFromAllWorkers
-        = ApplyMapper<TEmptyLeafFinder>(workerCount, TMasterEnvironment::GetRef().SharedTrainData); // poll workers
+    TVector<TLeafIndexSetter::TOutput> isLeafEmptyFromAllWorkers
+        = ApplyMapper<TLeafIndexSetter>(workerCount, TMasterEnvironment::GetRef().SharedTrainData, bestSplit);
 
     // some workers may return empty result because they don't have any learn subset
     const TVector<size_t> validWorkers = GetNonEmptyElementsIndices(isLeafEmptyFromAllWorkers);
@@ -445,6 +475,7 @@ void CalcErrorsDistributed(
     const TVector<THolder<IMetric>>& metrics,
     bool calcAllMetrics,
     bool calcErrorTrackerMetric,
+    bool useEvalSetSamples,
     TLearnContext* ctx) {
 
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
@@ -495,6 +526,7 @@ void CalcErrorsDistributed(
                     calcAllMetrics,
                     calcErrorTrackerMetric,
                     /*calcNonAdditiveMetricsOnly*/true,
+                    useEvalSetSamples,
                     ctx
                 );
             }
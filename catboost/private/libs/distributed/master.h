@@ -53,13 +53,14 @@ void MapRemotePairwiseCalcScore(
     double scoreStDev,
     TVector<TCandidatesContext>* candidatesContext,
     TLearnContext* ctx);
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx);
-int MapGetRedundantSplitIdx(TLearnContext* ctx);
+// returns index of a redundant split or -1, see GetRedundantSplitIdx
+int MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx);
 void CalcErrorsDistributed(
     const NCB::TTrainingDataProviders& trainData,
     const TVector<THolder<IMetric>>& metrics,
     bool calcAllMetrics,
     bool calcErrorTrackerMetric,
+    bool useEvalSetSamples,
     TLearnContext* ctx);
 
 template <typename TMapper>
@@ -10,6 +10,7 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/private/libs/target/data_providers.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
@@ -42,73 +43,121 @@ static TUpdateMethod ParseUpdateMethod(const TString& updateMethod) {
     return TUpdateMethod(updateType, topSize);
 }
 
-static TDStrResult GetFinalDocumentImportances(
-    const TVector<TVector<double>>& rawImportances,
-    EDocumentStrengthType docImpMethod,
-    int topSize,
-    EImportanceValuesSign importanceValuesSign
-) {
-    const ui32 trainDocCount = rawImportances.size();
-    Y_ASSERT(rawImportances.size() != 0);
-    const ui32 testDocCount = rawImportances[0].size();
-    TVector<TVector<double>> preprocessedImportances;
-    if (docImpMethod == EDocumentStrengthType::Average) {
-        preprocessedImportances = TVector<TVector<double>>(1, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[0][trainDocId] += rawImportances[trainDocId][testDocId];
-            }
-        }
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            preprocessedImportances[0][trainDocId] /= testDocCount;
-        }
-
+static std::function<bool(double)> GetImportanceValuesPredicate(EImportanceValuesSign importanceValuesSign) {
+    if (importanceValuesSign == EImportanceValuesSign::Positive) {
+        return [](double v){return v > 0;};
+    } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
+        return [](double v){return v < 0;};
     } else {
-        Y_ASSERT(docImpMethod == EDocumentStrengthType::PerObject || docImpMethod == EDocumentStrengthType::Raw);
-        preprocessedImportances = TVector<TVector<double>>(testDocCount, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
-            }
-        }
+        Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
+        return [](double){return true;};
     }
+}
 
-    TDStrResult result(preprocessedImportances.size());
-    for (ui32 testDocId = 0; testDocId < preprocessedImportances.size(); ++testDocId) {
-        TVector<double>& preprocessedImportancesRef = preprocessedImportances[testDocId];
-
-        const ui32 docCount = preprocessedImportancesRef.size();
-        TVector<ui32> indices(docCount);
-        std::iota(indices.begin(), indices.end(), 0);
-        if (docImpMethod != EDocumentStrengthType::Raw) {
-            Sort(indices.begin(), indices.end(), [&](ui32 first, ui32 second) {
-                return Abs(preprocessedImportancesRef[first]) > Abs(preprocessedImportancesRef[second]);
-            });
+namespace {
+    // Collects final importances from blocks of train objects, so the full train x test importances are never stored:
+    // Average keeps the sum for every train object, PerObject and Raw keep only top candidates for every test object.
+    class TFinalDocumentImportancesCollector {
+    public:
+        TFinalDocumentImportancesCollector(
+            ui32 trainDocCount,
+            ui32 testDocCount,
+            EDocumentStrengthType docImpMethod,
+            int topSize,
+            EImportanceValuesSign importanceValuesSign
+        )
+            : TrainDocCount(trainDocCount)
+            , TestDocCount(testDocCount)
+            , DocImpMethod(docImpMethod)
+            , TopSize(topSize)
+            , Predicate(GetImportanceValuesPredicate(importanceValuesSign))
+        {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                AverageImportances.resize(TrainDocCount);
+            } else {
+                Y_ASSERT(DocImpMethod == EDocumentStrengthType::PerObject || DocImpMethod == EDocumentStrengthType::Raw);
+                Candidates.resize(TestDocCount);
+            }
         }
 
-        std::function<bool(double)> predicate;
-        if (importanceValuesSign == EImportanceValuesSign::Positive) {
-            predicate = [](double v){return v > 0;};
-        } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
-            predicate = [](double v){return v < 0;};
-        } else {
-            Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
-            predicate = [](double){return true;};
+        void AddBlock(ui32 blockStart, const TVector<TVector<double>>& blockImportances, NPar::ILocalExecutor* localExecutor) {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                localExecutor->ExecRange([&] (int blockDocId) {
+                    for (double importance : blockImportances[blockDocId]) {
+                        AverageImportances[blockStart + blockDocId] += importance;
+                    }
+                }, 0, SafeIntegerCast<int>(blockImportances.size()), NPar::TLocalExecutor::WAIT_COMPLETE);
+                return;
+            }
+            localExecutor->ExecRange([&] (int testDocId) {
+                auto& candidates = Candidates[testDocId];
+                for (ui32 blockDocId = 0; blockDocId < blockImportances.size(); ++blockDocId) {
+                    if (DocImpMethod == EDocumentStrengthType::Raw && candidates.size() >= ui32(TopSize)) {
+                        break;
+                    }
+                    const double importance = blockImportances[blockDocId][testDocId];
+                    if (Predicate(importance)) {
+                        candidates.emplace_back(blockStart + blockDocId, importance);
+                    }
+                }
+                if (DocImpMethod == EDocumentStrengthType::PerObject && candidates.size() > 2 * size_t(TopSize)) {
+                    SelectTop(&candidates);
+                }
+            }, 0, SafeIntegerCast<int>(TestDocCount), NPar::TLocalExecutor::WAIT_COMPLETE);
         }
 
-        int currentSize = 0;
-        for (ui32 i = 0; i < docCount; ++i) {
-            if (currentSize == topSize) {
-                break;
+        TDStrResult GetResult() {
+            if (DocImpMethod == EDocumentStrengthType::Average) {
+                TVector<std::pair<ui32, double>> candidates;
+                for (ui32 trainDocId = 0; trainDocId < TrainDocCount; ++trainDocId) {
+                    const double importance = AverageImportances[trainDocId] / TestDocCount;
+                    if (Predicate(importance)) {
+                        candidates.emplace_back(trainDocId, importance);
+                    }
+                }
+                Candidates = {std::move(candidates)};
             }
-            if (predicate(preprocessedImportancesRef[indices[i]])) {
-                result.Scores[testDocId].push_back(preprocessedImportancesRef[indices[i]]);
-                result.Indices[testDocId].push_back(indices[i]);
-                ++currentSize;
+            TDStrResult result(Candidates.size());
+            for (ui32 resultIdx = 0; resultIdx < Candidates.size(); ++resultIdx) {
+                auto& candidates = Candidates[resultIdx];
+                if (DocImpMethod != EDocumentStrengthType::Raw) {
+                    SelectTop(&candidates);
+                    StableSort(candidates.begin(), candidates.end(), [](const auto& first, const auto& second) {
+                        return Abs(first.second) > Abs(second.second);
+                    });
+                }
+                for (ui32 i = 0; i < Min<size_t>(candidates.size(), TopSize); ++i) {
+                    result.Indices[resultIdx].push_back(candidates[i].first);
+                    result.Scores[resultIdx].push_back(candidates[i].second);
+                }
             }
+            return result;
         }
-    }
-    return result;
+
+    private:
+        // leave TopSize candidates with the largest absolute importance in the order of train objects
+        void SelectTop(TVector<std::pair<ui32, double>>* candidates) const {
+            if (candidates->size() <= size_t(TopSize)) {
+                return;
+            }
+            auto byAbsImportance = [](const auto& first, const auto& second) {
+                return Abs(first.second) > Abs(second.second)
+                    || (Abs(first.second) == Abs(second.second) && first.first < second.first);
+            };
+            NthElement(candidates->begin(), candidates->begin() + TopSize, candidates->end(), byAbsImportance);
+            candidates->resize(TopSize);
+            SortBy(*candidates, [](const auto& candidate) { return candidate.first; });
+        }
+
+    private:
+        ui32 TrainDocCount;
+        ui32 TestDocCount;
+        EDocumentStrengthType DocImpMethod;
+        int TopSize;
+        std::function<bool(double)> Predicate;
+        TVector<double> AverageImportances; // [trainDocCount]
+        TVector<TVector<std::pair<ui32, double>>> Candidates; // [testDocCount][] (trainDocId, importance)
+    };
 }
 
 TDStrResult GetDocumentImportances(
@@ -166,7 +215,19 @@ TDStrResult GetDocumentImportances(
     ExecuteTasksInParallel(&tasks, localExecutor.Get());
 
     TDocumentImportancesEvaluator leafInfluenceEvaluator(model, *trainProcessedData, updateMethod, localExecutor, logPeriod);
-    const TVector<TVector<double>> documentImportances
-        = leafInfluenceEvaluator.GetDocumentImportances(*testProcessedData, logPeriod);
-    return GetFinalDocumentImportances(documentImportances, dstrType, topSize, importanceValuesSign);
+    TFinalDocumentImportancesCollector collector(
+        trainProcessedData->GetObjectCount(),
+        testProcessedData->GetObjectCount(),
+        dstrType,
+        topSize,
+        importanceValuesSign
+    );
+    leafInfluenceEvaluator.ProcessDocumentImportances(
+        *testProcessedData,
+        [&] (ui32 blockStart, const TVector<TVector<double>>& blockImportances) {
+            collector.AddBlock(blockStart, blockImportances, localExecutor.Get());
+        },
+        logPeriod
+    );
+    return collector.GetResult();
 }
@@ -18,8 +18,10 @@
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
+void TDocumentImportancesEvaluator::ProcessDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    const TBlockImportancesConsumer& blockConsumer,
+    int logPeriod
 ) {
     TVector<TVector<ui32>> leafIndices(TreeCount);
     auto binarizedFeatures = MakeQuantizedFeaturesForEvaluator(Model, *processedData.ObjectsData.Get());
@@ -28,27 +30,42 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
     }, NPar::ILocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
 
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetOneDimensionalTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
+    const ui32 testDocCount = processedData.GetObjectCount();
     const size_t docBlockSize = 1000;
+    TVector<TVector<double>> blockImportances(Min<size_t>(docBlockSize, DocCount), TVector<double>(testDocCount));
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
 
+    TVector<TTrainDocBuffers> buffersByThread(LocalExecutor->GetThreadCount() + 1);
+    for (auto& buffers : buffersByThread) {
+        buffers.LeafDerivatives.assign(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations));
+        buffers.Jacobian.resize(DocCount);
+        buffers.PredictedDerivatives.resize(testDocCount);
+    }
+
     for (size_t start = 0; start < DocCount; start += docBlockSize) {
         const size_t end = Min<size_t>(start + docBlockSize, DocCount);
         processDocumentsProfile.StartIterationBlock();
 
-        LocalExecutor->ExecRange([&] (int docId) {
-            // The derivative of leaf values with respect to train doc weight.
-            TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
-        }, NPar::ILocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        NPar::ILocalExecutor::TExecRangeParams blockParams(start, end);
+        blockParams.SetBlockCount(buffersByThread.size());
+        LocalExecutor->ExecRange([&] (int blockId) {
+            TTrainDocBuffers& buffers = buffersByThread[blockId];
+            const int blockEnd = Min<int>(blockParams.FirstId + (blockId + 1) * blockParams.GetBlockSize(), end);
+            for (int docId = blockParams.FirstId + blockId * blockParams.GetBlockSize(); docId < blockEnd; ++docId) {
+                // The derivative of leaf values with respect to train doc weight.
+                UpdateLeavesDerivatives(docId, &buffers);
+                GetDocumentImportancesForOneTrainDoc(leafIndices, &buffers, &blockImportances[docId - start]);
+            }
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        blockImportances.resize(end - start);
+        blockConsumer(start, blockImportances);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
-    return documentImportances;
+    }
 }
 
 void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
@@ -69,13 +86,17 @@ void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TV
     EvaluateDerivatives(LossFunction, LeafEstimationMethod, finalApproxes, target, &FinalFirstDerivatives, nullptr, nullptr);
 }
 
-TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian) {
-    TVector<ui32> leafIdToUpdate;
+void TDocumentImportancesEvaluator::GetLeafIdToUpdate(
+    ui32 treeId,
+    const TVector<double>& jacobian,
+    TVector<ui32>* leafIdToUpdate
+) {
+    leafIdToUpdate->clear();
     const ui32 leafCount = 1 << Model.ModelTrees->GetModelTreeData()->GetTreeSizes()[treeId];
 
     if (UpdateMethod.UpdateType == EUpdateType::AllPoints) {
-        leafIdToUpdate.resize(leafCount);
-        std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
+        leafIdToUpdate->resize(leafCount);
+        std::iota(leafIdToUpdate->begin(), leafIdToUpdate->end(), 0);
     } else if (UpdateMethod.UpdateType == EUpdateType::TopKLeaves) {
         const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
         TVector<double> leafJacobians(leafCount);
@@ -89,22 +110,22 @@ TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, cons
             return leafJacobians[firstDocId] > leafJacobians[secondDocId];
         });
 
-        leafIdToUpdate = TVector<ui32>(
+        leafIdToUpdate->assign(
             orderedLeafIndices.begin(),
             orderedLeafIndices.begin() + Min<ui32>(UpdateMethod.TopSize, leafCount)
         );
     }
-
-    return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocBuffers* buffers) {
+    TVector<double>& jacobian = buffers->Jacobian;
+    Fill(jacobian.begin(), jacobian.end(), 0.0);
+    TVector<ui32>& leafIdToUpdate = buffers->LeafIdToUpdate;
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         auto& treeStatistics = TreesStatistics[treeId];
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<ui32> leafIdToUpdate = GetLeafIdToUpdate(treeId, jacobian);
-            TVector<double>& leafDerivativesRef = (*leafDerivatives)[treeId][it];
+            GetLeafIdToUpdate(treeId, jacobian, &leafIdToUpdate);
+            TVector<double>& leafDerivativesRef = buffers->LeafDerivatives[treeId][it];
 
             // Updating Leaves Derivatives
             UpdateLeavesDerivativesForTree(
@@ -133,12 +154,14 @@ void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, T
 }
 
 void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
-    const TVector<TVector<TVector<double>>>& leafDerivatives,
     const TVector<TVector<ui32>>& leafIndices,
+    TTrainDocBuffers* buffers,
     TVector<double>* documentImportance
 ) {
+    const auto& leafDerivatives = buffers->LeafDerivatives;
     const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
+    TVector<double>& predictedDerivatives = buffers->PredictedDerivatives;
+    Fill(predictedDerivatives.begin(), predictedDerivatives.end(), 0.0);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
@@ -13,6 +13,7 @@
 #include <library/cpp/threading/local_executor/local_executor.h>
 
 #include <util/generic/fwd.h>
+#include <util/generic/function.h>
 #include <util/generic/ptr.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
@@ -79,20 +80,37 @@ public:
         TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, startingApprox, logPeriod);
     }
 
+    // [trainDocId - blockStart][testDocId]
+    using TBlockImportancesConsumer = std::function<void(ui32 blockStart, const TVector<TVector<double>>& blockImportances)>;
+
     // Getting the importance of all train objects for all objects from pool.
-    TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    // Train objects are processed by blocks, only the importances of the current block are kept in memory.
+    void ProcessDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        const TBlockImportancesConsumer& blockConsumer,
+        int logPeriod = 0
+    );
+
+private:
+    // Buffers reused by all train objects processed in one thread.
+    struct TTrainDocBuffers {
+        TVector<TVector<TVector<double>>> LeafDerivatives; // [treeCount][LeavesEstimationIterationsCount][leafCount]
+        TVector<double> Jacobian; // [docCount]
+        TVector<ui32> LeafIdToUpdate;
+        TVector<double> PredictedDerivatives; // [testDocCount]
+    };
 
 private:
     // Evaluate first derivatives at the final approxes
     void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
     // Leaves derivatives will be updated based on objects from these leaves.
-    TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
+    void GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian, TVector<ui32>* leafIdToUpdate);
     // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
+    void UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocBuffers* buffers);
     // Getting the importance of one train object for all objects from pool.
     void GetDocumentImportancesForOneTrainDoc(
-        const TVector<TVector<TVector<double>>>& leafDerivatives,
         const TVector<TVector<ui32>>& leafIndices,
+        TTrainDocBuffers* buffers,
         TVector<double>* documentImportance
     );
     // Evaluate leaf derivatives at a given removedDocId weight (Equation (6) from paper).
@@ -3,6 +3,7 @@
 
 #include <catboost/private/libs/embedding_features/flatbuffers/embedding_feature_calcers.fbs.h>
 
+#include <util/generic/utility.h>
 #include <util/generic/ymath.h>
 
 
@@ -68,13 +69,21 @@ namespace NCB {
         Y_ASSERT(info == 0);
     }
 
+    // vectors are added to the scatter matrix by rank-k updates with k growing with the cloud size
+    static constexpr int MinUpdateBlockSize = 32;
+    static constexpr int MaxUpdateBlockSize = 1024;
+
     void IncrementalCloud::AddVector(const TEmbeddingsArray& embed) {
+        const int blockSize = ClampVal(BaseSize / 16, MinUpdateBlockSize, MaxUpdateBlockSize);
+        if (Buffer.empty()) {
+            Buffer.reserve(Dimension * (BaseSize < 128 ? 1 : blockSize));
+        }
         ++AdditionalSize;
         for (int idx = 0; idx < Dimension; ++idx) {
             Buffer.push_back(embed[idx] - BaseCenter[idx]);
             NewShift[idx] += Buffer.back();
         }
-        if (BaseSize < 128 || AdditionalSize >= 32) {
+        if (BaseSize < 128 || AdditionalSize >= blockSize) {
             Update();
         }
     }
@@ -175,6 +184,10 @@ namespace NCB {
     void TLinearDACalcerVisitor::Flush(TEmbeddingFeatureCalcer* featureCalcer) {
         auto lda = dynamic_cast<TLinearDACalcer*>(featureCalcer);
         Y_ASSERT(lda);
+        // apply pending blocks, so that the projection accounts for all added vectors
+        for (auto& dist : lda->ClassesDist) {
+            dist.Update();
+        }
         ui32 dim = lda->TotalDimension;
         TVector<float> totalScatter(dim * dim, 0);
         lda->TotalScatterCalculation(&totalScatter);
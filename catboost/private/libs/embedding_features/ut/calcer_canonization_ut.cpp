@@ -1,9 +1,13 @@
 #include <catboost/private/libs/embedding_features/lda.h>
 
+#include <library/cpp/l2_distance/l2_distance.h>
+#include <library/cpp/l2_distance/l2_distance_avx2.h>
 #include <library/cpp/testing/unittest/registar.h>
+#include <util/system/cpu_id.h>
 #include <util/random/fast.h>
 #include <util/random/normal.h>
 #include <util/random/random.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
 using namespace NCB;
@@ -80,4 +84,54 @@ Y_UNIT_TEST_SUITE(TestCalcerCanonization) {
         UNIT_ASSERT_DOUBLES_EQUAL(proj[0] - proj[2] + proj[4], 0.0, eps * norm1);
         UNIT_ASSERT_DOUBLES_EQUAL(proj[1] - proj[3] + proj[5], 0.0, eps * norm2);
     }
+
+    Y_UNIT_TEST(TestIncrementalCloudScatter) {
+        const ui32 numSamples = 20000;
+        const ui32 dim = 3;
+        IncrementalCloud cloud(dim);
+        TVector<double> mean(dim, 0);
+        TVector<double> scatter(dim * dim, 0);
+        TVector<TEmbeddingsArray> dataSet;
+        for (ui32 id = 0; id < numSamples; ++id) {
+            dataSet.push_back(NormalEmbedding({5, -3, 1}));
+            cloud.AddVector(dataSet.back());
+            for (ui32 i = 0; i < dim; ++i) {
+                mean[i] += dataSet.back()[i] / double(numSamples);
+            }
+        }
+        cloud.Update();
+        for (const auto& embed : dataSet) {
+            for (ui32 i = 0; i < dim; ++i) {
+                for (ui32 j = 0; j < dim; ++j) {
+                    scatter[i * dim + j] += (embed[i] - mean[i]) * (embed[j] - mean[j]) / numSamples;
+                }
+            }
+        }
+
+        UNIT_ASSERT_DOUBLES_EQUAL(cloud.TotalSize(), numSamples, 0.0);
+        for (ui32 i = 0; i < dim; ++i) {
+            UNIT_ASSERT_DOUBLES_EQUAL(cloud.BaseCenter[i], mean[i], 1e-3);
+        }
+        for (ui32 i = 0; i < dim * dim; ++i) {
+            UNIT_ASSERT_DOUBLES_EQUAL(cloud.ScatterMatrix[i], scatter[i], 1e-3);
+        }
+    }
+
+    Y_UNIT_TEST(TestL2SqrDistanceKernels) {
+        TFastRng<ui32> rng(0);
+        TVector<float> lhs(67);
+        TVector<float> rhs(67);
+        for (auto i : xrange(lhs.size())) {
+            lhs[i] = rng.GenRandReal1() * 2 - 1;
+            rhs[i] = rng.GenRandReal1() * 2 - 1;
+        }
+        const bool haveAvx2 = NX86::HaveAVX2() && NX86::HaveFMA();
+        for (int length = 0; length <= (int)lhs.size(); ++length) {
+            const float expected = L2SqrDistanceSlow(lhs.data(), rhs.data(), length);
+            UNIT_ASSERT_DOUBLES_EQUAL(L2SqrDistance(lhs.data(), rhs.data(), length), expected, 1e-5);
+            if (haveAvx2) {
+                UNIT_ASSERT_DOUBLES_EQUAL(L2SqrDistanceAvx2(lhs.data(), rhs.data(), length), expected, 1e-5);
+            }
+        }
+    }
 }
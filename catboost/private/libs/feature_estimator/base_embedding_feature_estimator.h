@@ -26,18 +26,18 @@ namespace NCB {
         void ComputeFeatures(
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::ILocalExecutor*) const override {
+            NPar::ILocalExecutor* executor) const override {
 
             THolder<TFeatureCalcer> featureCalcer = EstimateFeatureCalcer();
 
             TVector<TEmbeddingDataSetPtr> learnDataset{GetLearnDatasetPtr()};
             TVector<TCalculatedFeatureVisitor> learnVisitors{std::move(learnVisitor)};
-            Calc(*featureCalcer, learnDataset, learnVisitors);
+            Calc(*featureCalcer, learnDataset, learnVisitors, executor);
 
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTestDatasets(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(*featureCalcer, GetTestDatasets(), testVisitors);
+                Calc(*featureCalcer, GetTestDatasets(), testVisitors, executor);
             }
         }
 
@@ -45,7 +45,7 @@ namespace NCB {
             TConstArrayRef<ui32> learnPermutation,
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::ILocalExecutor*) const override {
+            NPar::ILocalExecutor* executor) const override {
 
             TFeatureCalcer featureCalcer = CreateFeatureCalcer();
             TCalcerVisitor calcerVisitor = CreateCalcerVisitor();
@@ -77,7 +77,7 @@ namespace NCB {
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTestDatasets(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(featureCalcer, GetTestDatasets(), testVisitors);
+                Calc(featureCalcer, GetTestDatasets(), testVisitors, executor);
             }
         }
 
@@ -107,7 +107,8 @@ namespace NCB {
         void Calc(
             const TFeatureCalcer& featureCalcer,
             TConstArrayRef<TEmbeddingDataSetPtr> datasets,
-            TConstArrayRef<TCalculatedFeatureVisitor> visitors) const {
+            TConstArrayRef<TCalculatedFeatureVisitor> visitors,
+            NPar::ILocalExecutor* executor) const {
 
             const ui32 featuresCount = featureCalcer.FeatureCount();
             for (ui32 id = 0; id < datasets.size(); ++id) {
@@ -115,8 +116,16 @@ namespace NCB {
                 const ui64 samplesCount = currentDataset.SamplesCount();
                 TVector<float> features(featuresCount * samplesCount);
 
-                for (ui64 line = 0; line < samplesCount; ++line) {
+                // calcer is not updated here, so documents are computed independently
+                const auto computeLine = [&](ui64 line) {
                     Compute(featureCalcer, currentDataset.GetVector(line), line, samplesCount, features);
+                };
+                if (executor) {
+                    NPar::ParallelFor(*executor, 0, samplesCount, computeLine);
+                } else {
+                    for (ui64 line = 0; line < samplesCount; ++line) {
+                        computeLine(line);
+                    }
                 }
 
                 for (ui32 f = 0; f < featuresCount; ++f) {
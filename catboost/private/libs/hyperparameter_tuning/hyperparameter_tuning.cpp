@@ -759,6 +759,10 @@ namespace {
         TConstArrayRef<NJson::TJsonValue> paramsSet;
         TString paramsErrorString;
         bool foundValidParams = false;
+
+        // data quantized with lastQuantizationParamsSet, reused while quantization params do not change
+        NCB::TDataProviderPtr quantizedData;
+        NCB::TQuantizedFeaturesInfoPtr lastQuantizedFeaturesInfo;
         while (gridIterator->Next(&paramsSet)) {
             profile.StartIterationBlock();
             // paramsSet: {border_count, feature_border_type, nan_mode, [others]}
@@ -800,24 +804,53 @@ namespace {
             UpdateMetricPeriodOption(catBoostOptions, &outputFileOptions);
 
             NCB::TFeaturesLayoutPtr featuresLayout = data->MetaInfo.FeaturesLayout;
-            NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo;
 
             TMetricsAndTimeLeftHistory metricsAndTimeHistory;
             TVector<TCVResult> cvResult;
             {
                 TSetLogging inThisScope(catBoostOptions.LoggingLevel);
+                if (cvParams.ShareQuantizedData &&
+                    (!quantizedData ||
+                     lastQuantizationParamsSet.BinsCount != quantizationParamsSet.BinsCount ||
+                     lastQuantizationParamsSet.BorderType != quantizationParamsSet.BorderType ||
+                     lastQuantizationParamsSet.NanMode != quantizationParamsSet.NanMode))
+                {
+                    NCatboostOptions::TBinarizationOptions commonFloatFeaturesBinarization(
+                        quantizationParamsSet.BorderType,
+                        quantizationParamsSet.BinsCount,
+                        quantizationParamsSet.NanMode
+                    );
+                    TVector<ui32> ignoredFeatureNums;
+                    lastQuantizedFeaturesInfo = MakeIntrusive<NCB::TQuantizedFeaturesInfo>(
+                        *(featuresLayout.Get()),
+                        MakeConstArrayRef(ignoredFeatureNums),
+                        commonFloatFeaturesBinarization,
+                        /*perFloatFeatureQuantization*/TMap<ui32, NCatboostOptions::TBinarizationOptions>(),
+                        /*floatFeaturesAllowNansInTestOnly*/true
+                    );
+                    quantizedData.Reset();
+                    quantizedData = QuantizeDataForCrossValidation(
+                        catBoostOptions,
+                        data,
+                        lastQuantizedFeaturesInfo,
+                        cpuUsedRamLimit,
+                        &rand,
+                        localExecutor
+                    );
+                }
                 lastQuantizationParamsSet = quantizationParamsSet;
                 CrossValidate(
                     *modelParamsToBeTried,
-                    quantizedFeaturesInfo,
+                    lastQuantizedFeaturesInfo,
                     objectiveDescriptor,
                     evalMetricDescriptor,
                     labelConverter,
-                    data,
+                    quantizedData ? quantizedData : data,
                     cvParams,
                     localExecutor,
                     &cvResult);
             }
+            NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo = lastQuantizedFeaturesInfo;
             ui32 approxDimension = NCB::GetApproxDimension(catBoostOptions, labelConverter, data->RawTargetData.GetTargetDimension());
             const TVector<THolder<IMetric>> metrics = CreateMetrics(
                 catBoostOptions.MetricOptions,
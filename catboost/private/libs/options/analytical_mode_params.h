@@ -30,6 +30,7 @@ namespace NCB {
         int ThreadCount = NSystemInfo::CachedNumberOfCpus();
 
         ECalcTypeShapValues ShapCalcType = ECalcTypeShapValues::Regular;
+        EShapValuesOutputFormat ShapOutputFormat = EShapValuesOutputFormat::Tsv;
         TMaybe<double> BinClassLogitThreshold;
 
         void BindParserOpts(NLastGetopt::TOpts& parser);
@@ -21,6 +21,7 @@ NCatboostOptions::TBoostingOptions::TBoostingOptions(ETaskType taskType)
     , Langevin("langevin", false)
     , DiffusionTemperature("diffusion_temperature", 0.0f)
     , PosteriorSampling("posterior_sampling", false, taskType)
+    , TimeLimit("time_limit", 0.0, taskType)
     , MinFoldSize("min_fold_size", 100, taskType)
     , DataPartitionType("data_partition", EDataPartitionType::FeatureParallel, taskType)
 {
@@ -30,7 +31,8 @@ void NCatboostOptions::TBoostingOptions::Load(const NJson::TJsonValue& options)
     CheckedLoad(options,
             &LearningRate, &FoldLenMultiplier, &PermutationBlockSize, &IterationCount, &OverfittingDetector,
             &BoostingType, &BoostFromAverage, &PermutationCount, &MinFoldSize, &ApproxOnFullHistory,
-            &DataPartitionType, &ModelShrinkRate, &ModelShrinkMode, &Langevin, &DiffusionTemperature, &PosteriorSampling);
+            &DataPartitionType, &ModelShrinkRate, &ModelShrinkMode, &Langevin, &DiffusionTemperature, &PosteriorSampling,
+            &TimeLimit);
 
     Validate();
 }
@@ -43,16 +45,20 @@ void NCatboostOptions::TBoostingOptions::Save(NJson::TJsonValue* options) const
     if (Langevin) {
         SaveFields(options, Langevin, DiffusionTemperature);
     }
+    if (TimeLimit.GetUnchecked() > 0) {
+        SaveFields(options, TimeLimit);
+    }
 }
 
 bool NCatboostOptions::TBoostingOptions::operator==(const TBoostingOptions& rhs) const {
     return std::tie(LearningRate, FoldLenMultiplier, PermutationBlockSize, IterationCount, OverfittingDetector,
             ApproxOnFullHistory, BoostingType, BoostFromAverage, PermutationCount,
-            MinFoldSize, DataPartitionType, ModelShrinkRate, ModelShrinkMode, Langevin, DiffusionTemperature, PosteriorSampling) ==
+            MinFoldSize, DataPartitionType, ModelShrinkRate, ModelShrinkMode, Langevin, DiffusionTemperature, PosteriorSampling,
+            TimeLimit) ==
         std::tie(rhs.LearningRate, rhs.FoldLenMultiplier, rhs.PermutationBlockSize, rhs.IterationCount,
                 rhs.OverfittingDetector, rhs.ApproxOnFullHistory, rhs.BoostingType, rhs.BoostFromAverage,
                 rhs.PermutationCount, rhs.MinFoldSize, rhs.DataPartitionType, rhs.ModelShrinkRate, rhs.ModelShrinkMode,
-                rhs.Langevin, rhs.DiffusionTemperature, rhs.PosteriorSampling);
+                rhs.Langevin, rhs.DiffusionTemperature, rhs.PosteriorSampling, rhs.TimeLimit);
 }
 
 bool NCatboostOptions::TBoostingOptions::operator!=(const TBoostingOptions& rhs) const {
@@ -66,6 +72,8 @@ void NCatboostOptions::TBoostingOptions::Validate() const {
 
     CB_ENSURE(PermutationCount.Get() > 0, "Permutation count should be positive");
 
+    CB_ENSURE(TimeLimit.GetUnchecked() >= 0, "Time limit should be non-negative");
+
     CB_ENSURE(MinFoldSize.GetUnchecked() > 0, "Min fold size should be positive");
 
     if (BoostingType.IsSet()) {
@@ -39,6 +39,9 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<bool> PosteriorSampling;
 
+        // wall-clock budget of boosting iterations in seconds, 0 means no limit
+        TCpuOnlyOption<double> TimeLimit;
+
         TGpuOnlyOption<ui32> MinFoldSize;
         TGpuOnlyOption<EDataPartitionType> DataPartitionType;
     };
@@ -234,6 +234,8 @@ NCatboostOptions::TCatFeatureParams::TCatFeatureParams(ETaskType taskType)
     , CounterCalcMethod("counter_calc_method", ECounterCalc::SkipTest)
     , StoreAllSimpleCtrs("store_all_simple_ctr", false, taskType)
     , CtrLeafCountLimit("ctr_leaf_count_limit", Max<ui64>(), taskType)
+    , CtrSketchWidth("ctr_sketch_width", 0, taskType)
+    , CtrSketchDepth("ctr_sketch_depth", 4, taskType)
     , CtrHistoryUnit("ctr_history_unit", ECtrHistoryUnit::Sample, taskType) {
     TargetBinarization.Get().DisableNanModeOption();
     TargetBinarization.Get().DisableMaxSubsetSizeForBuildBordersOption();
@@ -242,21 +244,22 @@ NCatboostOptions::TCatFeatureParams::TCatFeatureParams(ETaskType taskType)
 void NCatboostOptions::TCatFeatureParams::Load(const NJson::TJsonValue& options) {
     CheckedLoad(options,
             &SimpleCtrs, &CombinationCtrs, &PerFeatureCtrs, &TargetBinarization, &MaxTensorComplexity, &OneHotMaxSize, &CounterCalcMethod,
-            &StoreAllSimpleCtrs, &CtrLeafCountLimit, &CtrHistoryUnit);
+            &StoreAllSimpleCtrs, &CtrLeafCountLimit, &CtrSketchWidth, &CtrSketchDepth, &CtrHistoryUnit);
     Validate();
 }
 
 void NCatboostOptions::TCatFeatureParams::Save(NJson::TJsonValue* options) const {
     SaveFields(options,
             SimpleCtrs, CombinationCtrs, PerFeatureCtrs, TargetBinarization, MaxTensorComplexity, OneHotMaxSize, CounterCalcMethod,
-            StoreAllSimpleCtrs, CtrLeafCountLimit, CtrHistoryUnit);
+            StoreAllSimpleCtrs, CtrLeafCountLimit, CtrSketchWidth, CtrSketchDepth, CtrHistoryUnit);
 }
 
 bool NCatboostOptions::TCatFeatureParams::operator==(const TCatFeatureParams& rhs) const {
     return std::tie(SimpleCtrs, CombinationCtrs, PerFeatureCtrs, TargetBinarization, MaxTensorComplexity, OneHotMaxSize, CounterCalcMethod,
-            StoreAllSimpleCtrs, CtrLeafCountLimit, CtrHistoryUnit) ==
+            StoreAllSimpleCtrs, CtrLeafCountLimit, CtrSketchWidth, CtrSketchDepth, CtrHistoryUnit) ==
         std::tie(rhs.SimpleCtrs, rhs.CombinationCtrs, rhs.PerFeatureCtrs, rhs.TargetBinarization, rhs.MaxTensorComplexity, rhs.OneHotMaxSize,
-                rhs.CounterCalcMethod, rhs.StoreAllSimpleCtrs, rhs.CtrLeafCountLimit, rhs.CtrHistoryUnit);
+                rhs.CounterCalcMethod, rhs.StoreAllSimpleCtrs, rhs.CtrLeafCountLimit, rhs.CtrSketchWidth, rhs.CtrSketchDepth,
+                rhs.CtrHistoryUnit);
 }
 
 bool NCatboostOptions::TCatFeatureParams::operator!=(const TCatFeatureParams& rhs) const {
@@ -273,6 +276,10 @@ void NCatboostOptions::TCatFeatureParams::Validate() const {
         CB_ENSURE(CtrLeafCountLimit.Get() > 0,
                 "Error: ctr_leaf_count_limit must be positive");
     }
+    if (!CtrSketchDepth.IsUnimplementedForCurrentTask()) {
+        CB_ENSURE(CtrSketchDepth.Get() > 0,
+                "Error: ctr_sketch_depth must be positive");
+    }
 }
 
 void NCatboostOptions::TCatFeatureParams::AddSimpleCtrDescription(const TCtrDescription& description) {
@@ -95,6 +95,9 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<bool> StoreAllSimpleCtrs;
         TCpuOnlyOption<ui64> CtrLeafCountLimit;
+        // Count-min sketch of CTR statistics instead of exact tables, 0 width means exact tables
+        TCpuOnlyOption<ui32> CtrSketchWidth;
+        TCpuOnlyOption<ui32> CtrSketchDepth;
 
         TGpuOnlyOption<ECtrHistoryUnit> CtrHistoryUnit;
     };
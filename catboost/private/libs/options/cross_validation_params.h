@@ -25,6 +25,12 @@ struct TCrossValidationParams : public TSplitParams {
     bool IsCalledFromSearchHyperparameters = false;
     bool ReturnModels = false;
 
+    /* quantize the whole dataset once and train folds on its subsets, so quantized features data is shared
+     * between folds. Borders and categorical features perfect hashes are calculated on all objects,
+     * not only on the learn part of each fold.
+     */
+    bool ShareQuantizedData = false;
+
 public:
     bool Initialized() const {
         return FoldCount != 0;
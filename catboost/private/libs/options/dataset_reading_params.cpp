@@ -58,4 +58,20 @@ void NCatboostOptions::BindColumnarPoolFormatParams(
     parser->AddLongOption("ignore-csv-quoting")
         .NoArgument()
         .StoreValue(&columnarPoolFormatParams->DsvFormat.IgnoreCsvQuoting, true);
+
+    parser->AddLongOption(
+        "shards-shuffle-seed",
+        "[for sharded pools, specified as a directory or a file name pattern] Read shards in random order"
+        " with this seed instead of the order of their paths")
+        .RequiredArgument("SEED")
+        .Handler1T<ui64>([columnarPoolFormatParams](ui64 seed) {
+            columnarPoolFormatParams->ShardsShuffleSeed = seed;
+        });
+
+    parser->AddLongOption(
+        "raw-dataset-cache-dir",
+        "[for local dsv and libsvm pools] Save parsed datasets to binary cache files in this directory"
+        " and load them from there on subsequent runs with the same data files and loading parameters")
+        .RequiredArgument("PATH")
+        .StoreResult(&columnarPoolFormatParams->RawDatasetCacheDir);
 }
@@ -287,6 +287,11 @@ enum class ECalcTypeShapValues {
     Independent
 };
 
+enum class EShapValuesOutputFormat {
+    Tsv,
+    Npy // float32 NumPy array of shape (documents, [dimensions,] features + 1)
+};
+
 enum class EExplainableModelOutput {
     Raw,
     Probability,
@@ -325,6 +330,13 @@ enum class ENodeType {
     SingleHost
 };
 
+// How bucket stats of split candidates are sent between hosts in distributed training
+enum class EHistogramsWireFormat {
+    Plain,          // all buckets with double sums
+    Compact,        // non-empty buckets only with double sums, lz4 compressed, lossless
+    CompactFloat    // non-empty buckets only with float sums, lz4 compressed
+};
+
 enum class EFinalCtrComputationMode {
     Skip,
     Default
@@ -381,6 +393,11 @@ enum class EFeatureCalcerType : ui32 {
     KNN
 };
 
+enum class ETextDictionaryType {
+    Frequency,
+    Hashing
+};
+
 enum class EAutoClassWeightsType {
     Balanced,
     SqrtBalanced,
@@ -14,19 +14,22 @@ NCatboostOptions::TFeatureEvalOptions::TFeatureEvalOptions()
     , FoldSize("fold_size", 0)
     , RelativeFoldSize("relative_fold_size", 0.0f)
     , TimeSplitQuantile("timesplit_quantile", 0.5)
+    , ParallelTrainingCount("parallel_trainings", 1)
 {
 }
 
 void NCatboostOptions::TFeatureEvalOptions::Load(const NJson::TJsonValue& options) {
     CheckedLoad(
         options, &FeaturesToEvaluate, &FeatureEvalMode, &EvalFeatureFileName, &ProcessorsUsageFileName,
-        &Offset, &FoldCount, &FoldSizeUnit, &FoldSize, &RelativeFoldSize, &TimeSplitQuantile);
+        &Offset, &FoldCount, &FoldSizeUnit, &FoldSize, &RelativeFoldSize, &TimeSplitQuantile,
+        &ParallelTrainingCount);
 }
 
 void NCatboostOptions::TFeatureEvalOptions::Save(NJson::TJsonValue* options) const {
     SaveFields(
         options, FeaturesToEvaluate, FeatureEvalMode, EvalFeatureFileName, ProcessorsUsageFileName,
-        Offset, FoldCount, FoldSizeUnit, FoldSize, RelativeFoldSize, TimeSplitQuantile);
+        Offset, FoldCount, FoldSizeUnit, FoldSize, RelativeFoldSize, TimeSplitQuantile,
+        ParallelTrainingCount);
 }
 
 bool NCatboostOptions::TFeatureEvalOptions::operator==(const TFeatureEvalOptions& rhs) const {
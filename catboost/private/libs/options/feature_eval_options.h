@@ -30,5 +30,8 @@ namespace NCatboostOptions {
         TOption<ui32> FoldSize;
         TOption<float> RelativeFoldSize;
         TOption<double> TimeSplitQuantile;
+
+        // max number of models trained simultaneously, does not affect results
+        TOption<ui32> ParallelTrainingCount;
     };
 }
@@ -11,6 +11,7 @@
 #include <library/cpp/binsaver/bin_saver.h>
 #include <library/cpp/json/json_value.h>
 
+#include <util/generic/maybe.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
@@ -20,11 +21,17 @@ namespace NCatboostOptions {
         NCB::TDsvFormatOptions DsvFormat;
         NCB::TPathWithScheme CdFilePath;
 
+        // shards of sharded pools are read in random order with this seed, in the order of their paths if not set
+        TMaybe<ui64> ShardsShuffleSeed;
+
+        // if not empty, parsed raw datasets are cached in this directory, see catboost/libs/data/raw_dataset_cache.h
+        TString RawDatasetCacheDir;
+
         TColumnarPoolFormatParams() = default;
 
         void Validate() const;
 
-        SAVELOAD(DsvFormat, CdFilePath);
+        SAVELOAD(DsvFormat, CdFilePath, ShardsShuffleSeed, RawDatasetCacheDir);
     };
 
     struct TPoolLoadParams {
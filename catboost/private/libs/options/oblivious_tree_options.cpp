@@ -36,6 +36,8 @@ NCatboostOptions::TObliviousTreeLearnerOptions::TObliviousTreeLearnerOptions(ETa
       , FixedBinarySplits("fixed_binary_splits", {}, taskType)
       , MonotoneConstraints("monotone_constraints", {}, taskType)
       , DevLeafwiseApproxes("dev_leafwise_approxes", false, taskType)
+      , DevCompactBucketStats("dev_compact_bucket_stats", false, taskType)
+      , DevRescoredCandidatesCount("dev_rescored_candidates_count", 0, taskType)
       , FeaturePenalties("penalties", TFeaturePenaltiesOptions())
       , TaskType("task_type", taskType)
 {
@@ -68,6 +70,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Load(const NJson::TJsonValu
             &FixedBinarySplits,
             &MonotoneConstraints,
             &DevLeafwiseApproxes,
+            &DevCompactBucketStats,
+            &DevRescoredCandidatesCount,
             &FeaturePenalties
             );
 
@@ -91,6 +95,8 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Save(NJson::TJsonValue* opt
             FixedBinarySplits,
             MonotoneConstraints,
             DevLeafwiseApproxes,
+            DevCompactBucketStats,
+            DevRescoredCandidatesCount,
             FeaturePenalties
             );
 }
@@ -101,7 +107,8 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
             AddRidgeToTargetFunctionFlag, ScoreFunction, GrowPolicy, MaxLeaves, MinDataInLeaf, MaxCtrComplexityForBordersCaching,
             PairwiseNonDiagReg, LeavesEstimationBacktrackingType, DevScoreCalcObjBlockSize,
             DevExclusiveFeaturesBundleMaxBuckets, SparseFeaturesConflictFraction, FixedBinarySplits,
-            MonotoneConstraints, DevLeafwiseApproxes, FeaturePenalties
+            MonotoneConstraints, DevLeafwiseApproxes, DevCompactBucketStats, DevRescoredCandidatesCount,
+            FeaturePenalties
             ) ==
         std::tie(rhs.MaxDepth, rhs.LeavesEstimationIterations, rhs.LeavesEstimationMethod, rhs.L2Reg, rhs.MetaL2Exponent, rhs.MetaL2Frequency, rhs.ModelSizeReg,
                 rhs.RandomStrength, rhs.BootstrapConfig, rhs.Rsm, rhs.SamplingFrequency,
@@ -109,7 +116,8 @@ bool NCatboostOptions::TObliviousTreeLearnerOptions::operator==(const TOblivious
                 rhs.ScoreFunction, rhs.GrowPolicy, rhs.MaxLeaves, rhs.MinDataInLeaf, rhs.MaxCtrComplexityForBordersCaching,
                 rhs.PairwiseNonDiagReg, rhs.LeavesEstimationBacktrackingType, rhs.DevScoreCalcObjBlockSize,
                 rhs.DevExclusiveFeaturesBundleMaxBuckets, rhs.SparseFeaturesConflictFraction,
-                rhs.FixedBinarySplits, rhs.MonotoneConstraints, rhs.DevLeafwiseApproxes, rhs.FeaturePenalties);
+                rhs.FixedBinarySplits, rhs.MonotoneConstraints, rhs.DevLeafwiseApproxes, rhs.DevCompactBucketStats,
+                rhs.DevRescoredCandidatesCount, rhs.FeaturePenalties);
 }
 
 bool NCatboostOptions::TObliviousTreeLearnerOptions::operator!=(const TObliviousTreeLearnerOptions& rhs) const {
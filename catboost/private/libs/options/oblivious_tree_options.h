@@ -57,6 +57,13 @@ namespace NCatboostOptions {
 
         TCpuOnlyOption<TMap<ui32, int>> MonotoneConstraints;
         TCpuOnlyOption <bool> DevLeafwiseApproxes;
+
+        // store histograms in float with compensated summation, changes results a little
+        TCpuOnlyOption<bool> DevCompactBucketStats;
+
+        // if > 0, only this number of best float and one-hot features of previous trees is scored at each depth,
+        // plus a random part of the others and the ones not scored for a long time
+        TCpuOnlyOption<ui32> DevRescoredCandidatesCount;
         TOption<TFeaturePenaltiesOptions> FeaturePenalties;
 
     private:
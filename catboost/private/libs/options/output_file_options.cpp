@@ -83,11 +83,14 @@ NCatboostOptions::TOutputFilesOptions::TOutputFilesOptions()
     , ModelFormats("model_format", {EModelType::CatboostBinary})
     , TestErrorLogPath("test_error_log", "test_error.tsv")
     , TimeLeftLog("time_left_log", "time_left.tsv")
+    , ProfileCountersLog("profile_counters_log", "profile_counters.tsv")
+    , ProfileTraceFlag("profile_trace", false)
     , SnapshotPath("snapshot_file", "experiment.cbsnapshot")
     , SaveSnapshotFlag("save_snapshot", false)
     , AllowWriteFilesFlag("allow_writing_files", true)
     , FinalCtrComputationMode("final_ctr_computation_mode", EFinalCtrComputationMode::Default)
     , FinalFeatureCalcerComputationMode("final_feature_calcer_computation_mode", EFinalFeatureCalcersComputationMode::Default)
+    , SaveSplitGainImportanceFlag("save_split_gain_importance", false)
     , EvalFileName("eval_file_name", "")
     , FstrRegularFileName("fstr_regular_file", "")
     , FstrInternalFileName("fstr_internal_file", "")
@@ -97,6 +100,7 @@ NCatboostOptions::TOutputFilesOptions::TOutputFilesOptions()
     , OutputBordersFileName("output_borders", "")
     , VerbosePeriod("verbose", 1)
     , MetricPeriod("metric_period", 1)
+    , MetricSampleSize("metric_sample_size", 0)
     , PredictionTypes("prediction_type", {EPredictionType::RawFormulaVal})
     , OutputColumns("output_columns", {"SampleId", "RawFormulaVal", "Label"})
     , RocOutputPath("roc_file", "") {
@@ -134,6 +138,10 @@ const TString& NCatboostOptions::TOutputFilesOptions::GetTimeLeftLogFilename() c
     return TimeLeftLog.Get();
 }
 
+const TString& NCatboostOptions::TOutputFilesOptions::GetProfileCountersLogFilename() const {
+    return ProfileCountersLog.Get();
+}
+
 const TVector<EModelType>& NCatboostOptions::TOutputFilesOptions::GetModelFormats() const {
     return ModelFormats.Get();
 }
@@ -221,6 +229,10 @@ bool NCatboostOptions::TOutputFilesOptions::SaveSnapshot() const {
     return SaveSnapshotFlag.Get();
 }
 
+bool NCatboostOptions::TOutputFilesOptions::SaveSplitGainImportance() const {
+    return SaveSplitGainImportanceFlag.Get();
+}
+
 ui64 NCatboostOptions::TOutputFilesOptions::GetSnapshotSaveInterval() const {
     return SnapshotSaveIntervalSeconds.Get();
 }
@@ -233,6 +245,10 @@ int NCatboostOptions::TOutputFilesOptions::GetMetricPeriod() const {
     return MetricPeriod.Get();
 }
 
+ui32 NCatboostOptions::TOutputFilesOptions::GetMetricSampleSize() const {
+    return MetricSampleSize.Get();
+}
+
 TString NCatboostOptions::TOutputFilesOptions::CreateFstrRegularFullPath() const {
     return GetFullPath(FstrRegularFileName.Get());
 }
@@ -261,13 +277,21 @@ TString NCatboostOptions::TOutputFilesOptions::GetRocOutputPath() const {
     return GetFullPath(RocOutputPath.Get());
 }
 
+TString NCatboostOptions::TOutputFilesOptions::CreateProfileTraceFullPath() const {
+    if (!ProfileTraceFlag.Get() || !AllowWriteFiles()) {
+        return {};
+    }
+    return GetFullPath("catboost_trace.json");
+}
+
 bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions& rhs) const {
     return std::tie(
             TrainDir, Name, JsonLogPath, ProfileLogPath, LearnErrorLogPath, TestErrorLogPath,
             TimeLeftLog, ResultModelPath, SnapshotPath, ModelFormats, SaveSnapshotFlag,
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel, BestModelMinTrees,
             SnapshotSaveIntervalSeconds, EvalFileName, FstrRegularFileName, FstrInternalFileName, FstrType,
-            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath
+            TrainingOptionsFileName, OutputBordersFileName, RocOutputPath, ProfileCountersLog, MetricSampleSize,
+            SaveSplitGainImportanceFlag, ProfileTraceFlag
             ) == std::tie(
                 rhs.TrainDir, rhs.Name, rhs.JsonLogPath, rhs.ProfileLogPath,
                 rhs.LearnErrorLogPath, rhs.TestErrorLogPath, rhs.TimeLeftLog, rhs.ResultModelPath,
@@ -275,7 +299,8 @@ bool NCatboostOptions::TOutputFilesOptions::operator==(const TOutputFilesOptions
                 rhs.FinalCtrComputationMode, rhs.FinalFeatureCalcerComputationMode, rhs.UseBestModel, rhs.BestModelMinTrees,
                 rhs.SnapshotSaveIntervalSeconds, rhs.EvalFileName, rhs.FstrRegularFileName,
                 rhs.FstrInternalFileName, rhs.FstrType, rhs.TrainingOptionsFileName, rhs.OutputBordersFileName,
-                rhs.RocOutputPath
+                rhs.RocOutputPath, rhs.ProfileCountersLog, rhs.MetricSampleSize,
+                rhs.SaveSplitGainImportanceFlag, rhs.ProfileTraceFlag
                 );
 }
 
@@ -291,7 +316,8 @@ void NCatboostOptions::TOutputFilesOptions::Load(const NJson::TJsonValue& option
             &SaveSnapshotFlag, &AllowWriteFilesFlag, &FinalCtrComputationMode, &FinalFeatureCalcerComputationMode,
             &UseBestModel, &BestModelMinTrees, &SnapshotSaveIntervalSeconds, &EvalFileName, &OutputColumns,
             &FstrRegularFileName, &FstrInternalFileName, &FstrType, &TrainingOptionsFileName, &MetricPeriod,
-            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath
+            &VerbosePeriod, &PredictionTypes, &OutputBordersFileName, &RocOutputPath, &ProfileCountersLog,
+            &MetricSampleSize, &SaveSplitGainImportanceFlag, &ProfileTraceFlag
             );
     if (!VerbosePeriod.IsSet() || VerbosePeriod.Get() == 1) {
         VerbosePeriod.Set(MetricPeriod.Get());
@@ -307,7 +333,8 @@ void NCatboostOptions::TOutputFilesOptions::Save(NJson::TJsonValue* options) con
             AllowWriteFilesFlag, FinalCtrComputationMode, FinalFeatureCalcerComputationMode, UseBestModel,
             BestModelMinTrees, SnapshotSaveIntervalSeconds, EvalFileName, OutputColumns, FstrRegularFileName,
             FstrInternalFileName, FstrType, TrainingOptionsFileName, MetricPeriod, VerbosePeriod, PredictionTypes,
-            OutputBordersFileName, RocOutputPath
+            OutputBordersFileName, RocOutputPath, ProfileCountersLog, MetricSampleSize,
+            SaveSplitGainImportanceFlag, ProfileTraceFlag
             );
 }
 
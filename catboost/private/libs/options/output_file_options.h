@@ -46,6 +46,9 @@ namespace NCatboostOptions {
 
         const TString& GetTimeLeftLogFilename() const;
 
+        // empty if counters of profile are not written
+        const TString& GetProfileCountersLogFilename() const;
+
         const TVector<EModelType>& GetModelFormats() const;
 
         bool ExportRequiresStaticCtrProvider() const;
@@ -77,12 +80,18 @@ namespace NCatboostOptions {
 
         bool SaveSnapshot() const;
 
+        // store features split gains accumulated during training in model metadata
+        bool SaveSplitGainImportance() const;
+
         ui64 GetSnapshotSaveInterval() const;
 
         int GetVerbosePeriod() const;
 
         int GetMetricPeriod() const;
 
+        // 0 if metrics are always calculated on whole eval sets
+        ui32 GetMetricSampleSize() const;
+
         TString CreateFstrRegularFullPath() const;
 
         TString CreateFstrIternalFullPath() const;
@@ -97,6 +106,9 @@ namespace NCatboostOptions {
 
         TString GetRocOutputPath() const;
 
+        // empty if trace of training phases is not written
+        TString CreateProfileTraceFullPath() const;
+
         void SetAllowWriteFiles(bool flag) {
             if (!flag) {
                 CB_ENSURE(!SaveSnapshot(), "Can't disable writing files because saving snapshots is enabled");
@@ -148,11 +160,14 @@ namespace NCatboostOptions {
         TOption<TVector<EModelType>> ModelFormats;
         TOption<TString> TestErrorLogPath;
         TOption<TString> TimeLeftLog;
+        TOption<TString> ProfileCountersLog;
+        TOption<bool> ProfileTraceFlag;
         TOption<TString> SnapshotPath;
         TOption<bool> SaveSnapshotFlag;
         TOption<bool> AllowWriteFilesFlag;
         TOption<EFinalCtrComputationMode> FinalCtrComputationMode;
         TOption<EFinalFeatureCalcersComputationMode> FinalFeatureCalcerComputationMode;
+        TOption<bool> SaveSplitGainImportanceFlag;
         TOption<TString> EvalFileName;
         TOption<TString> FstrRegularFileName;
         TOption<TString> FstrInternalFileName;
@@ -163,6 +178,7 @@ namespace NCatboostOptions {
         TOption<TString> OutputBordersFileName;
         TOption<int> VerbosePeriod;
         TOption<int> MetricPeriod;
+        TOption<ui32> MetricSampleSize;
 
         TOption<TVector<EPredictionType>> PredictionTypes;
         TOption<TVector<TString>> OutputColumns;
@@ -293,17 +293,21 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "learn_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "test_error_log", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "time_left_log", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "profile_counters_log", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "profile_trace", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "result_model_file", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "snapshot_file", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "save_snapshot", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "snapshot_interval", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "verbose", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "metric_period", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "metric_sample_size", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "prediction_type", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "output_columns", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "allow_writing_files", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "final_ctr_computation_mode", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "final_feature_calcer_computation_mode", &outputFilesJson, &seenKeys);
+    CopyOption(plainOptions, "save_split_gain_importance", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "use_best_model", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "best_model_min_trees", &outputFilesJson, &seenKeys);
     CopyOption(plainOptions, "eval_file_name", &outputFilesJson, &seenKeys);
@@ -336,6 +340,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "langevin", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "posterior_sampling", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "diffusion_temperature", &boostingOptionsRef, &seenKeys);
+    CopyOption(plainOptions, "time_limit", &boostingOptionsRef, &seenKeys);
 
     auto& odConfig = boostingOptionsRef["od_config"];
     odConfig.SetType(NJson::JSON_MAP);
@@ -372,6 +377,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "fixed_binary_splits", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "monotone_constraints", &treeOptions, &seenKeys);
     CopyOption(plainOptions, "dev_leafwise_approxes", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_compact_bucket_stats", &treeOptions, &seenKeys);
+    CopyOption(plainOptions, "dev_rescored_candidates_count", &treeOptions, &seenKeys);
 
     auto& bootstrapOptions = treeOptions["bootstrap"];
     bootstrapOptions.SetType(NJson::JSON_MAP);
@@ -427,6 +434,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "store_all_simple_ctr", &ctrOptions, &seenKeys);
     CopyOption(plainOptions, "one_hot_max_size", &ctrOptions, &seenKeys);
     CopyOption(plainOptions, "ctr_leaf_count_limit", &ctrOptions, &seenKeys);
+    CopyOption(plainOptions, "ctr_sketch_width", &ctrOptions, &seenKeys);
+    CopyOption(plainOptions, "ctr_sketch_depth", &ctrOptions, &seenKeys);
     CopyOption(plainOptions, "ctr_history_unit", &ctrOptions, &seenKeys);
 
     //data processing
@@ -478,6 +487,8 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "node_type", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "node_port", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "file_with_hosts", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "histograms_wire_format", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "balance_worker_shards", &systemOptions, &seenKeys);
 
     //pool metainfo
     CopyOption(plainOptions, "pool_metainfo_options", &trainOptions, &seenKeys);
@@ -562,17 +573,21 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
     DeleteSeenOption(&outputoptionsCopy, "learn_error_log");
     DeleteSeenOption(&outputoptionsCopy, "test_error_log");
     DeleteSeenOption(&outputoptionsCopy, "time_left_log");
+    DeleteSeenOption(&outputoptionsCopy, "profile_counters_log");
+    DeleteSeenOption(&outputoptionsCopy, "profile_trace");
     DeleteSeenOption(&outputoptionsCopy, "result_model_file");
     DeleteSeenOption(&outputoptionsCopy, "snapshot_file");
     DeleteSeenOption(&outputoptionsCopy, "save_snapshot");
     DeleteSeenOption(&outputoptionsCopy, "snapshot_interval");
     DeleteSeenOption(&outputoptionsCopy, "verbose");
     DeleteSeenOption(&outputoptionsCopy, "metric_period");
+    DeleteSeenOption(&outputoptionsCopy, "metric_sample_size");
     DeleteSeenOption(&outputoptionsCopy, "prediction_type");
     DeleteSeenOption(&outputoptionsCopy, "output_columns");
     DeleteSeenOption(&outputoptionsCopy, "allow_writing_files");
     DeleteSeenOption(&outputoptionsCopy, "final_ctr_computation_mode");
     DeleteSeenOption(&outputoptionsCopy, "final_feature_calcer_computation_mode");
+    DeleteSeenOption(&outputoptionsCopy, "save_split_gain_importance");
 
     CopyOption(outputOptions, "use_best_model", &plainOptionsJson, &seenKeys);
     DeleteSeenOption(&outputoptionsCopy, "use_best_model");
@@ -640,6 +655,9 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(boostingOptionsRef, "diffusion_temperature", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyBoosting, "diffusion_temperature");
 
+        CopyOption(boostingOptionsRef, "time_limit", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyBoosting, "time_limit");
+
         if (boostingOptionsRef.Has("od_config")) {
             const auto& odConfig = boostingOptionsRef["od_config"];
             auto& optionsCopyOdConfig = optionsCopyBoosting["od_config"];
@@ -739,6 +757,12 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(treeOptions, "dev_leafwise_approxes", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyTree, "dev_leafwise_approxes");
 
+        CopyOption(treeOptions, "dev_compact_bucket_stats", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyTree, "dev_compact_bucket_stats");
+
+        CopyOption(treeOptions, "dev_rescored_candidates_count", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyTree, "dev_rescored_candidates_count");
+
         // bootstrap
         if (treeOptions.Has("bootstrap")) {
             const auto& bootstrapOptions = treeOptions["bootstrap"];
@@ -849,6 +873,12 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(ctrOptions, "ctr_leaf_count_limit", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyCtr, "ctr_leaf_count_limit");
 
+        CopyOption(ctrOptions, "ctr_sketch_width", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyCtr, "ctr_sketch_width");
+
+        CopyOption(ctrOptions, "ctr_sketch_depth", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopyCtr, "ctr_sketch_depth");
+
         CopyOption(ctrOptions, "ctr_history_unit", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopyCtr, "ctr_history_unit");
 
@@ -974,6 +1004,12 @@ void NCatboostOptions::ConvertOptionsToPlainJson(
         CopyOption(systemOptions, "file_with_hosts", &plainOptionsJson, &seenKeys);
         DeleteSeenOption(&optionsCopySystemOptions, "file_with_hosts");
 
+        CopyOption(systemOptions, "histograms_wire_format", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopySystemOptions, "histograms_wire_format");
+
+        CopyOption(systemOptions, "balance_worker_shards", &plainOptionsJson, &seenKeys);
+        DeleteSeenOption(&optionsCopySystemOptions, "balance_worker_shards");
+
         CB_ENSURE(optionsCopySystemOptions.GetMapSafe().empty(), "system_options: key " + optionsCopySystemOptions.GetMapSafe().begin()->first + " wasn't added to plain options.");
         DeleteSeenOption(&optionsCopy, "system_options");
     }
@@ -1020,6 +1056,8 @@ void NCatboostOptions::CleanPlainJson(
     DeleteSeenOption(plainOptionsJsonEfficient, "node_port");
     DeleteSeenOption(plainOptionsJsonEfficient, "file_with_hosts");
     DeleteSeenOption(plainOptionsJsonEfficient, "node_type");
+    DeleteSeenOption(plainOptionsJsonEfficient, "histograms_wire_format");
+    DeleteSeenOption(plainOptionsJsonEfficient, "balance_worker_shards");
 
     // options with no influence on the final model
     DeleteSeenOption(plainOptionsJsonEfficient, "objective_metric");
@@ -1041,6 +1079,8 @@ void NCatboostOptions::CleanPlainJson(
         DeleteSeenOption(plainOptionsJsonEfficient, "store_all_simple_ctr");
         DeleteSeenOption(plainOptionsJsonEfficient, "one_hot_max_size");
         DeleteSeenOption(plainOptionsJsonEfficient, "ctr_leaf_count_limit");
+        DeleteSeenOption(plainOptionsJsonEfficient, "ctr_sketch_width");
+        DeleteSeenOption(plainOptionsJsonEfficient, "ctr_sketch_depth");
         DeleteSeenOption(plainOptionsJsonEfficient, "ctr_history_unit");
         DeleteSeenOption(plainOptionsJsonEfficient, "per_feature_ctr");
         DeleteSeenOption(plainOptionsJsonEfficient, "ctr_target_border_count");
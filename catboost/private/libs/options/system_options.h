@@ -29,6 +29,8 @@ namespace NCatboostOptions {
         TCpuOnlyOption<ENodeType> NodeType;
         TCpuOnlyOption<TString> FileWithHosts;
         TCpuOnlyOption<ui32> NodePort;
+        TCpuOnlyOption<EHistogramsWireFormat> HistogramsWireFormat;
+        TCpuOnlyOption<bool> BalanceWorkerShards;
 
         static ui32 GetUnusedNodePort() { return 0; }
         bool IsMaster() const;
@@ -48,6 +48,8 @@ namespace NCatboostOptions {
         : DictionaryId("dictionary_id", "default_dictionary")
         , DictionaryOptions("dictionary_options", DEFAULT_DICTIONARY_OPTIONS)
         , DictionaryBuilderOptions("dictionary_builder_options", DEFAULT_DICTIONARY_BUILDER_OPTIONS)
+        , DictionaryType("dictionary_type", ETextDictionaryType::Frequency)
+        , HashBucketCount("hash_bucket_count", DEFAULT_HASH_BUCKET_COUNT)
     {
     }
 
@@ -67,6 +69,11 @@ namespace NCatboostOptions {
         TJsonFieldHelper<TOption<TString>>::Write(DictionaryId, optionsJson);
         DictionaryOptionsToJson(DictionaryOptions, optionsJson);
         DictionaryBuilderOptionsToJson(DictionaryBuilderOptions, optionsJson);
+        // frequency based dictionaries are saved as before to keep models options unchanged
+        if (DictionaryType.Get() == ETextDictionaryType::Hashing) {
+            (*optionsJson)[DictionaryType.GetName()] = ToString(DictionaryType.Get());
+            (*optionsJson)[HashBucketCount.GetName()] = ToString(HashBucketCount.Get());
+        }
     }
 
     void TTextColumnDictionaryOptions::Load(const NJson::TJsonValue& options) {
@@ -76,11 +83,22 @@ namespace NCatboostOptions {
         }
         JsonToDictionaryOptions(options, &DictionaryOptions.Get());
         JsonToDictionaryBuilderOptions(options, &DictionaryBuilderOptions.Get());
+
+        // values are strings as for the other options in this flat map
+        if (options.Has(DictionaryType.GetName())) {
+            DictionaryType.Set(FromString<ETextDictionaryType>(options[DictionaryType.GetName()].GetStringRobust()));
+        }
+        if (options.Has(HashBucketCount.GetName())) {
+            HashBucketCount.Set(FromString<ui32>(options[HashBucketCount.GetName()].GetStringRobust()));
+        }
+        if (DictionaryType.Get() == ETextDictionaryType::Hashing) {
+            CB_ENSURE(HashBucketCount.Get() > 0, "DictionaryOptions: hash_bucket_count should be positive");
+        }
     }
 
     bool TTextColumnDictionaryOptions::operator==(const TTextColumnDictionaryOptions& rhs) const {
-        return std::tie(DictionaryOptions, DictionaryBuilderOptions) ==
-               std::tie(rhs.DictionaryOptions, rhs.DictionaryBuilderOptions);
+        return std::tie(DictionaryOptions, DictionaryBuilderOptions, DictionaryType, HashBucketCount) ==
+               std::tie(rhs.DictionaryOptions, rhs.DictionaryBuilderOptions, rhs.DictionaryType, rhs.HashBucketCount);
     }
 
     bool TTextColumnDictionaryOptions::operator!=(const TTextColumnDictionaryOptions& rhs) const {
@@ -48,6 +48,8 @@ namespace NCatboostOptions {
        /*MaxDictionarySize=*/50000
     };
 
+    constexpr ui32 DEFAULT_HASH_BUCKET_COUNT = 1 << 16;
+
     class TTextColumnDictionaryOptions {
     public:
         TTextColumnDictionaryOptions();
@@ -66,6 +68,9 @@ namespace NCatboostOptions {
         TOption<TString> DictionaryId;
         TOption<TDictionaryOptions> DictionaryOptions;
         TOption<TDictionaryBuilderOptions> DictionaryBuilderOptions;
+        // Hashing dictionaries map tokens to HashBucketCount ids and store no vocabulary
+        TOption<ETextDictionaryType> DictionaryType;
+        TOption<ui32> HashBucketCount;
     };
 
     struct TFeatureCalcerDescription {
@@ -33,6 +33,19 @@ namespace NCB {
                 return *this;
             }
 
+            IGridBuilder& AddFeatureSketch(const TQuantileSketch& sketch,
+                                           ui32 borderCount,
+                                           ENanMode nanMode,
+                                           ui32 sampleSize) override {
+                CB_ENSURE(
+                    nanMode != ENanMode::Forbidden || !sketch.GetNanCount(),
+                    "Error: NaN in features, but NaNs are forbidden");
+                const TVector<float> sortedSample = sketch.GetQuantilesSample(sampleSize);
+                auto borders = TGridBuilderBase<type>::BuildBorders(sortedSample, borderCount);
+                Result.push_back(std::move(borders));
+                return *this;
+            }
+
             const TVector<TVector<float>>& Borders() override {
                 return Result;
             }
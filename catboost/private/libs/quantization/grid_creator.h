@@ -1,5 +1,7 @@
 #pragma once
 
+#include "quantile_sketch.h"
+
 #include <catboost/private/libs/options/binarization_options.h>
 
 #include <library/cpp/grid_creator/binarization.h>
@@ -23,6 +25,15 @@ namespace NCB {
 
         virtual IGridBuilder& AddFeature(TConstArrayRef<float> feature, ui32 borderCount, ENanMode nanMode) = 0;
 
+        /* Streaming input path: sketch is built (and merged) over all feature values in one pass,
+         * borders are selected on a sample of sampleSize values at evenly spaced ranks of the sketch.
+         */
+        virtual IGridBuilder& AddFeatureSketch(
+            const TQuantileSketch& sketch,
+            ui32 borderCount,
+            ENanMode nanMode,
+            ui32 sampleSize) = 0;
+
         virtual const TVector<TVector<float>>& Borders() = 0;
 
         virtual TVector<float> BuildBorders(TConstArrayRef<float> sortedFeature,
@@ -0,0 +1,145 @@
+#include "quantile_sketch.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+
+#include <cmath>
+#include <tuple>
+
+
+namespace NCB {
+
+    // capacities of lower levels decrease geometrically with this factor
+    static constexpr double LevelCapacityFactor = 2.0 / 3.0;
+
+
+    TQuantileSketch::TQuantileSketch(ui32 k)
+        : K(k)
+        , Levels(1)
+        , CompactionCounts(1, 0)
+    {
+        CB_ENSURE(K >= 2, "Quantile sketch K must be at least 2");
+    }
+
+    bool TQuantileSketch::operator==(const TQuantileSketch& rhs) const {
+        return std::tie(K, Levels, CompactionCounts, Count, NanCount, Min, Max)
+            == std::tie(rhs.K, rhs.Levels, rhs.CompactionCounts, rhs.Count, rhs.NanCount, rhs.Min, rhs.Max);
+    }
+
+    void TQuantileSketch::Add(float value) {
+        if (std::isnan(value)) {
+            ++NanCount;
+            return;
+        }
+        ++Count;
+        Min = ::Min(Min, value);
+        Max = ::Max(Max, value);
+        Levels[0].push_back(value);
+        if (Levels[0].size() >= GetLevelCapacity(0)) {
+            Compact();
+        }
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& other) {
+        CB_ENSURE(K == other.K, "Merged quantile sketches have different K: " << K << " and " << other.K);
+        if (Levels.size() < other.Levels.size()) {
+            Levels.resize(other.Levels.size());
+            CompactionCounts.resize(other.Levels.size(), 0);
+        }
+        for (auto level : xrange(other.Levels.size())) {
+            Levels[level].insert(Levels[level].end(), other.Levels[level].begin(), other.Levels[level].end());
+        }
+        Count += other.Count;
+        NanCount += other.NanCount;
+        Min = ::Min(Min, other.Min);
+        Max = ::Max(Max, other.Max);
+        Compact();
+    }
+
+    void TQuantileSketch::GetSortedWeightedValues(TVector<float>* values, TVector<ui64>* weights) const {
+        TVector<std::pair<float, ui64>> weightedValues;
+        for (auto level : xrange(Levels.size())) {
+            for (auto value : Levels[level]) {
+                weightedValues.emplace_back(value, ui64(1) << level);
+            }
+        }
+        Sort(weightedValues);
+
+        values->clear();
+        weights->clear();
+        values->reserve(weightedValues.size());
+        weights->reserve(weightedValues.size());
+        for (const auto& [value, weight] : weightedValues) {
+            values->push_back(value);
+            weights->push_back(weight);
+        }
+    }
+
+    TVector<float> TQuantileSketch::GetQuantilesSample(ui32 sampleSize) const {
+        TVector<float> values;
+        TVector<ui64> weights;
+        GetSortedWeightedValues(&values, &weights);
+
+        TVector<float> sample;
+        if (Count <= sampleSize) {
+            sample.reserve(Count);
+            for (auto idx : xrange(values.size())) {
+                sample.insert(sample.end(), weights[idx], values[idx]);
+            }
+            return sample;
+        }
+
+        sample.yresize(sampleSize);
+        size_t valueIdx = 0;
+        ui64 cumulativeWeight = weights[0];
+        for (auto sampleIdx : xrange(sampleSize)) {
+            // rank at the middle of the sampleIdx-th of sampleSize equal parts
+            const double rank = (sampleIdx + 0.5) * Count / sampleSize;
+            while ((cumulativeWeight <= rank) && (valueIdx + 1 < values.size())) {
+                ++valueIdx;
+                cumulativeWeight += weights[valueIdx];
+            }
+            sample[sampleIdx] = values[valueIdx];
+        }
+        return sample;
+    }
+
+    ui32 TQuantileSketch::GetLevelCapacity(ui32 level) const {
+        const ui32 depth = Levels.size() - 1 - level;
+        return ::Max<ui32>(2, static_cast<ui32>(std::ceil(K * std::pow(LevelCapacityFactor, depth))));
+    }
+
+    /* Each compaction of a level sorts it and moves every other value to the next level, where values have
+     * double weight. Odd and even positions alternate, so that errors of consecutive compactions cancel out.
+     */
+    void TQuantileSketch::Compact() {
+        for (ui32 level = 0; level < Levels.size(); ++level) {
+            while (Levels[level].size() >= GetLevelCapacity(level)) {
+                if (level + 1 == Levels.size()) {
+                    Levels.emplace_back();
+                    CompactionCounts.push_back(0);
+                }
+                auto& values = Levels[level];
+                Sort(values);
+
+                // odd value count, keep the largest value at this level
+                const bool keepLast = values.size() % 2;
+                const size_t compactedSize = values.size() - keepLast;
+                const size_t offset = CompactionCounts[level]++ % 2;
+
+                auto& nextLevelValues = Levels[level + 1];
+                for (size_t idx = offset; idx < compactedSize; idx += 2) {
+                    nextLevelValues.push_back(values[idx]);
+                }
+                if (keepLast) {
+                    values[0] = values.back();
+                }
+                values.resize(keepLast);
+            }
+        }
+    }
+
+}
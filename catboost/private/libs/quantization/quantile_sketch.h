@@ -0,0 +1,87 @@
+#pragma once
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+#include <util/ysaveload.h>
+
+#include <limits>
+
+
+namespace NCB {
+
+    /* Mergeable quantile sketch of float values, a KLL sketch with deterministic compactions.
+     * It keeps about 3 * K values however many values were added, the rank error of quantiles is about
+     * 1.7 / K of the values count.
+     * Sketches can be built independently over parts of the data, e.g. by loader blocks or workers,
+     * and then merged, so that borders are selected in one streaming pass over the data.
+     */
+    class TQuantileSketch {
+    public:
+        static constexpr ui32 DefaultK = 2048;
+
+    public:
+        explicit TQuantileSketch(ui32 k = DefaultK);
+
+        bool operator==(const TQuantileSketch& rhs) const;
+
+        // NaNs are only counted
+        void Add(float value);
+
+        // other must have the same K
+        void Merge(const TQuantileSketch& other);
+
+        ui32 GetK() const {
+            return K;
+        }
+
+        // count of non-NaN added values
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        ui64 GetNanCount() const {
+            return NanCount;
+        }
+
+        float GetMin() const {
+            return Min;
+        }
+
+        float GetMax() const {
+            return Max;
+        }
+
+        /* Values kept in the sketch in increasing order, each represents weight added values.
+         * Sum of weights is GetCount().
+         */
+        void GetSortedWeightedValues(TVector<float>* values, TVector<ui64>* weights) const;
+
+        /* Sorted sample of the added non-NaN values for border selection algorithms.
+         * If the count of values is not greater than sampleSize the result has the count of values,
+         * otherwise it has sampleSize values at evenly spaced ranks.
+         */
+        TVector<float> GetQuantilesSample(ui32 sampleSize) const;
+
+        Y_SAVELOAD_DEFINE(K, Levels, CompactionCounts, Count, NanCount, Min, Max);
+
+    private:
+        ui32 GetLevelCapacity(ui32 level) const;
+
+        void Compact();
+
+    private:
+        ui32 K;
+
+        // values at level i represent 2^i added values each
+        TVector<TVector<float>> Levels;
+
+        // used to alternate halves of values kept by compactions
+        TVector<ui64> CompactionCounts;
+
+        ui64 Count = 0;
+        ui64 NanCount = 0;
+        float Min = std::numeric_limits<float>::max();
+        float Max = std::numeric_limits<float>::lowest();
+    };
+
+}
@@ -0,0 +1,120 @@
+#include <library/cpp/testing/unittest/registar.h>
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/private/libs/quantization/grid_creator.h>
+#include <catboost/private/libs/quantization/quantile_sketch.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+#include <util/stream/buffer.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace NCB;
+
+Y_UNIT_TEST_SUITE(TQuantileSketchTests) {
+    Y_UNIT_TEST(TestExactOnSmallData) {
+        TQuantileSketch sketch(64);
+        TVector<float> values;
+        for (auto i : xrange(50)) {
+            values.push_back(float(49 - i));
+            sketch.Add(values.back());
+        }
+        sketch.Add(std::numeric_limits<float>::quiet_NaN());
+        Sort(values);
+
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 50);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetNanCount(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMin(), 0.f);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetMax(), 49.f);
+        UNIT_ASSERT(sketch.GetQuantilesSample(100) == values);
+    }
+
+    Y_UNIT_TEST(TestRankError) {
+        const ui32 count = 1000000;
+        TVector<float> values(count);
+        Iota(values.begin(), values.end(), 0.f);
+        TFastRng64 rng(0);
+        Shuffle(values.begin(), values.end(), rng);
+
+        TQuantileSketch sketch(256);
+        for (auto value : values) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), count);
+
+        const ui32 sampleSize = 100;
+        const auto sample = sketch.GetQuantilesSample(sampleSize);
+        UNIT_ASSERT_VALUES_EQUAL(sample.size(), sampleSize);
+        UNIT_ASSERT(IsSorted(sample.begin(), sample.end()));
+        for (auto i : xrange(sampleSize)) {
+            // value is equal to its rank
+            const double expectedRank = (i + 0.5) * count / sampleSize;
+            UNIT_ASSERT_DOUBLES_EQUAL(sample[i], expectedRank, 0.02 * count);
+        }
+    }
+
+    Y_UNIT_TEST(TestMerge) {
+        const ui32 partCount = 8;
+        const ui32 partSize = 50000;
+        TQuantileSketch merged(256);
+        for (auto part : xrange(partCount)) {
+            TQuantileSketch partSketch(256);
+            for (auto i : xrange(partSize)) {
+                // parts have different value ranges
+                partSketch.Add(float(part * partSize + i));
+            }
+            merged.Merge(partSketch);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetCount(), partCount * partSize);
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetMin(), 0.f);
+        UNIT_ASSERT_VALUES_EQUAL(merged.GetMax(), float(partCount * partSize - 1));
+
+        TVector<float> values;
+        TVector<ui64> weights;
+        merged.GetSortedWeightedValues(&values, &weights);
+        UNIT_ASSERT(values.size() < 4 * merged.GetK());
+        UNIT_ASSERT_VALUES_EQUAL(Accumulate(weights, ui64(0)), ui64(partCount * partSize));
+
+        const auto sample = merged.GetQuantilesSample(partCount);
+        for (auto part : xrange(partCount)) {
+            UNIT_ASSERT_DOUBLES_EQUAL(sample[part], (part + 0.5) * partSize, 0.02 * partCount * partSize);
+        }
+
+        UNIT_ASSERT_EXCEPTION(merged.Merge(TQuantileSketch(128)), TCatBoostException);
+    }
+
+    Y_UNIT_TEST(TestSaveLoad) {
+        TQuantileSketch sketch(32);
+        for (auto i : xrange(1000)) {
+            sketch.Add(std::sin(float(i)));
+        }
+
+        TBufferStream stream;
+        ::Save(&stream, sketch);
+        TQuantileSketch loaded;
+        ::Load(&stream, loaded);
+        UNIT_ASSERT(loaded == sketch);
+    }
+
+    Y_UNIT_TEST(TestGridBuilderOnSketch) {
+        TVector<float> values;
+        TQuantileSketch sketch;
+        for (auto i : xrange(1000)) {
+            values.push_back(float(i % 100));
+            sketch.Add(values.back());
+        }
+
+        TGridBuilderFactory factory;
+        auto builder = factory.Create(EBorderSelectionType::GreedyLogSum);
+        builder->AddFeature(values, 16, ENanMode::Forbidden);
+        builder->AddFeatureSketch(sketch, 16, ENanMode::Forbidden, 1000);
+        UNIT_ASSERT(builder->Borders()[0] == builder->Borders()[1]);
+
+        sketch.Add(std::numeric_limits<float>::quiet_NaN());
+        UNIT_ASSERT_EXCEPTION(builder->AddFeatureSketch(sketch, 16, ENanMode::Forbidden, 1000), TCatBoostException);
+    }
+}
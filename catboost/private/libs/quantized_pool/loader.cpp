@@ -44,7 +44,7 @@ NCB::TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& arg
     : ObjectCount(0) // inited later
     , QuantizedPool(
         std::forward<TQuantizedPool>(
-            LoadQuantizedPool(args.PoolPath, GetLoadParameters(args.CommonArgs.DatasetSubset))
+            LoadQuantizedPool(args.PoolPath, GetLoadParameters(args.CommonArgs))
         )
       )
     , PairsPath(args.CommonArgs.PairsFilePath)
@@ -251,7 +251,7 @@ void NCB::TCBQuantizedDataLoader::AddQuantizedFeatureChunk(
         flatFeatureIdx,
         GetDatasetOffset(chunk),
         chunk.Chunk->BitsPerDocument(),
-        TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants));
+        GetFeatureQuants(chunk));
 }
 
  void NCB::TCBQuantizedDataLoader::AddQuantizedCatFeatureChunk(
@@ -269,7 +269,7 @@ void NCB::TCBQuantizedDataLoader::AddQuantizedFeatureChunk(
         flatFeatureIdx,
         GetDatasetOffset(chunk),
         chunk.Chunk->BitsPerDocument(),
-        TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants));
+        GetFeatureQuants(chunk));
 }
 
 void NCB::TCBQuantizedDataLoader::AddChunk(
@@ -342,6 +342,52 @@ void NCB::TCBQuantizedDataLoader::AddChunk(
     }
 }
 
+TMaybeOwningConstArrayHolder<ui8> NCB::TCBQuantizedDataLoader::GetFeatureQuants(
+    const TQuantizedPool::TChunkDescription& chunk) const
+{
+    const auto quants = ClipByDatasetSubset(chunk);
+    if (MappedBlobsHolder) {
+        return TMaybeOwningConstArrayHolder<ui8>::CreateOwning(quants, MappedBlobsHolder);
+    }
+    return TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants);
+}
+
+bool NCB::TCBQuantizedDataLoader::CanUseWholeMappedFeatureColumns() const {
+    if (!QuantizedPool.ChunkStorage.empty() || !DatasetSubset.HasFeatures) {
+        return false;
+    }
+
+    const auto columnIdxToFlatIdx = GetColumnIndexToFlatIndexMap(QuantizedPool);
+    const ui64 loadStart = DatasetSubset.Range.Begin;
+    const ui64 loadEnd = loadStart + ObjectCount;
+    size_t featureColumnCount = 0;
+    for (const auto [columnIdx, localIdx] : QuantizedPool.ColumnIndexToLocalIndex) {
+        if (!EqualToOneOf(QuantizedPool.ColumnTypes[localIdx], EColumn::Num, EColumn::Categ)) {
+            continue;
+        }
+        const auto* const flatFeatureIdx = columnIdxToFlatIdx.FindPtr(columnIdx);
+        if (!flatFeatureIdx || IsFeatureIgnored[*flatFeatureIdx]) {
+            continue;
+        }
+        const auto& chunks = QuantizedPool.Chunks[localIdx];
+        if (chunks.size() != 1) {
+            return false;
+        }
+        const auto valueBytes = static_cast<size_t>(chunks[0].Chunk->BitsPerDocument() / CHAR_BIT);
+        if (valueBytes == 0) {
+            return false;
+        }
+        const ui64 chunkStart = chunks[0].DocumentOffset;
+        const ui64 chunkEnd = chunkStart + chunks[0].Chunk->Quants()->size() / valueBytes;
+        if (chunkStart > loadStart || chunkEnd < loadEnd) {
+            return false;
+        }
+        ++featureColumnCount;
+    }
+    // features without data are reported by the builder in the copying mode
+    return featureColumnCount == (size_t)Count(IsFeatureIgnored, false);
+}
+
 TConstArrayRef<ui8> NCB::TCBQuantizedDataLoader::ClipByDatasetSubset(
     const TQuantizedPool::TChunkDescription& chunk) const
 {
@@ -389,23 +435,33 @@ ui32 NCB::TCBQuantizedDataLoader::GetDatasetOffset(const TQuantizedPool::TChunkD
 }
 
 void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
+    const bool wholeColumns = CanUseWholeMappedFeatureColumns();
+    if (wholeColumns) {
+        // features data will reference the mapped file (if it is properly aligned), so it must outlive this loader
+        MappedBlobsHolder = MakeIntrusive<NCB::TVectorHolder<TBlob>>(TVector<TBlob>(QuantizedPool.Blobs));
+    }
+    CATBOOST_DEBUG_LOG << "Quantized pool features are " << (wholeColumns ? "referenced" : "copied") << Endl;
+
     visitor->Start(
         DataMetaInfo,
         ObjectCount,
         ObjectsOrder,
         {},
         QuantizationSchemaFromProto(QuantizedPool.QuantizationSchema),
-        /*wholeColumns*/ false);
+        wholeColumns);
 
     const auto columnIdxToTargetIdx = GetColumnIndexToTargetIndexMap(QuantizedPool);
     const auto columnIdxToFlatIdx = GetColumnIndexToFlatIndexMap(QuantizedPool);
     const auto columnIdxToBaselineIdx = GetColumnIndexToBaselineIndexMap(QuantizedPool);
     const auto chunkRefs = GatherAndSortChunks(QuantizedPool);
 
+    // evicted range spans chunks, so it must lie within one mapped file
+    const bool evictReadChunks
+        = QuantizedPool.ChunkStorage.empty() && (QuantizedPool.Blobs.size() == 1) && !wholeColumns;
     TSequentialChunkEvictor evictor(1ULL << 24);
     CATBOOST_DEBUG_LOG << "Number of chunks to process " << chunkRefs.size() << Endl;
     for (const auto chunkRef : chunkRefs) {
-        if (QuantizedPool.ChunkStorage.empty()) { // reading from mapped file
+        if (evictReadChunks) {
             evictor.Push(chunkRef);
         }
         Y_DEFER { evictor.MaybeEvict(); };
@@ -450,9 +506,12 @@ void NCB::TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
         AddChunk(*chunkRef.Description, columnType, targetIdx, flatFeatureIdx, baselineIdx, visitor);
     }
 
-    evictor.MaybeEvict(true);
+    if (evictReadChunks) {
+        evictor.MaybeEvict(true);
+    }
 
     QuantizedPool = TQuantizedPool(); // release memory
+    MappedBlobsHolder.Reset();
     SetGroupWeights(GroupWeightsPath, ObjectCount, DatasetSubset, visitor);
     SetPairs(PairsPath, DatasetSubset, visitor->GetGroupIds(), visitor);
     SetBaseline(
@@ -4,6 +4,8 @@
 #include "serialization.h"
 
 #include <catboost/libs/data/loader.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/resource_holder.h>
 #include <catboost/private/libs/index_range/index_range.h>
 
 #include <library/cpp/object_factory/object_factory.h>
@@ -38,11 +40,23 @@ namespace NCB {
             const size_t flatFeatureIdx,
             IQuantizedFeaturesDataVisitor* visitor) const;
 
+        TMaybeOwningConstArrayHolder<ui8> GetFeatureQuants(const TQuantizedPool::TChunkDescription& chunk) const;
+
+        /* Feature columns can be referenced in the mapped pool file without copying if
+         * each of them is stored in a single chunk that covers the whole loaded subset
+         */
+        bool CanUseWholeMappedFeatureColumns() const;
+
         TConstArrayRef<ui8> ClipByDatasetSubset(const TQuantizedPool::TChunkDescription& chunk) const;
         ui32 GetDatasetOffset(const TQuantizedPool::TChunkDescription& chunk) const;
 
-        static TLoadQuantizedPoolParameters GetLoadParameters(NCB::TDatasetSubset loadSubset) {
-            return {/*LockMemory*/ false, /*Precharge*/ false, loadSubset};
+        static TLoadQuantizedPoolParameters GetLoadParameters(const TDatasetLoaderCommonArgs& commonArgs) {
+            return {
+                /*LockMemory*/ false,
+                /*Precharge*/ false,
+                commonArgs.DatasetSubset,
+                commonArgs.ShardsShuffleSeed
+            };
         }
 
     private:
@@ -58,6 +72,9 @@ namespace NCB {
         TDataMetaInfo DataMetaInfo;
         EObjectsOrder ObjectsOrder;
         TDatasetSubset DatasetSubset;
+
+        // keeps mapped pool file alive while features data references it, null if data is copied
+        TIntrusivePtr<IResourceHolder> MappedBlobsHolder;
     };
 
     struct IQuantizedPoolLoader {
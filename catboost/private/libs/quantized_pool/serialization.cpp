@@ -7,12 +7,20 @@
 #include <catboost/idl/pool/proto/metainfo.pb.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
 #include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/private/libs/data_util/read_ahead_input.h>
+#include <catboost/private/libs/data_util/shards.h>
 #include <catboost/private/libs/quantized_pool/detail.h>
 #include <catboost/private/libs/quantization_schema/detail.h>
 #include <catboost/private/libs/quantization_schema/serialization.h>
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
+#include <google/protobuf/util/message_differencer.h>
+
+#include <library/cpp/threading/future/future.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 
 #include <util/digest/numeric.h>
@@ -20,8 +28,12 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/buffer.h>
 #include <util/generic/cast.h>
 #include <util/generic/deque.h>
+#include <util/generic/mapfindptr.h>
+#include <util/generic/ptr.h>
+#include <util/generic/scope.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
@@ -38,6 +50,8 @@
 #include <util/system/unaligned_mem.h>
 #include <util/system/info.h>
 
+#include <functional>
+
 
 using NCB::NIdl::TPoolMetainfo;
 using NCB::NIdl::TPoolQuantizationSchema;
@@ -120,30 +134,36 @@ namespace {
             , DocumentsInChunkCount(documentsInChunkCount) {
         }
     };
+
+    struct TSerializedChunk {
+        TBuffer Data; // flatbuffer with NIdl::TQuantizedFeatureChunk
+        ui32 DocumentOffset = 0;
+        ui32 DocumentsInChunkCount = 0;
+    };
+
+    using TSerializedColumn = TVector<TSerializedChunk>;
 }
 
-static void WriteChunk(
-    const NCB::TQuantizedPool::TChunkDescription& chunk,
-    TCountingOutput* const output,
-    TDeque<TChunkInfo>* const chunkInfos,
-    flatbuffers::FlatBufferBuilder* const builder) {
+static void SerializeChunk(
+    NCB::NIdl::EBitsPerDocumentFeature bitsPerDocument,
+    TConstArrayRef<ui8> quants,
+    ui32 documentOffset,
+    ui32 documentsInChunkCount,
+    flatbuffers::FlatBufferBuilder* const builder,
+    TSerializedColumn* const column) {
 
     builder->Clear();
 
-    const auto quantsOffset = builder->CreateVector(
-        chunk.Chunk->Quants()->data(),
-        chunk.Chunk->Quants()->size());
+    const auto quantsOffset = builder->CreateVector(quants.data(), quants.size());
     NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
-    chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
+    chunkBuilder.add_BitsPerDocument(bitsPerDocument);
     chunkBuilder.add_Quants(quantsOffset);
     builder->Finish(chunkBuilder.Finish());
 
-    AddPadding(16, output);
-
-    const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
-
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    auto& chunk = column->emplace_back();
+    chunk.Data.Assign(reinterpret_cast<const char*>(builder->GetBufferPointer()), builder->GetSize());
+    chunk.DocumentOffset = documentOffset;
+    chunk.DocumentsInChunkCount = documentsInChunkCount;
 }
 
 static void WriteHeader(TCountingOutput* const output) {
@@ -238,50 +258,99 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+/* Columns are serialized in parallel by windows of localExecutor's thread count, and a window is written
+ * to the output by a separate thread while the next one is serialized. So serialization is not limited
+ * by the output speed and there are no more than two windows of serialized columns in memory.
+ *
+ * serializeColumn(localIndex, column) is called concurrently for different columns.
+ */
+static void WriteAsOneFile(
+    const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+    const std::function<void(size_t, TSerializedColumn*)>& serializeColumn,
+    const TPoolMetainfo& poolMetainfo,
+    const TPoolQuantizationSchema& quantizationSchema,
+    NPar::ILocalExecutor* localExecutor,
+    IOutputStream* slave) {
+
     TCountingOutput output(slave);
 
     WriteHeader(&output);
 
     const auto chunksOffset = output.Counter();
 
-    const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.ColumnIndexToLocalIndex);
+    const auto sortedTrueFeatureIndices = CollectAndSortKeys(columnIndexToLocalIndex);
     TDeque<TDeque<TChunkInfo>> perFeatureChunkInfos;
-    perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
+    perFeatureChunkInfos.resize(columnIndexToLocalIndex.size());
     {
-        flatbuffers::FlatBufferBuilder builder;
-        for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
-            const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-            auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
-            for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
-            }
+        NPar::TLocalExecutor outputExecutor;
+        outputExecutor.RunAdditionalThreads(1);
+        NThreading::TFuture<void> outputDone = NThreading::MakeFuture();
+        // output uses serialized columns and chunk infos, wait for it even if serialization has failed
+        Y_SCOPE_EXIT(&outputDone) {
+            outputDone.Wait();
+        };
+
+        const size_t columnCount = sortedTrueFeatureIndices.size();
+        const size_t windowSize = localExecutor->GetThreadCount() + 1;
+        for (size_t windowBegin = 0; windowBegin < columnCount; windowBegin += windowSize) {
+            const size_t windowEnd = Min(windowBegin + windowSize, columnCount);
+            auto window = MakeAtomicShared<TVector<TSerializedColumn>>(windowEnd - windowBegin);
+            localExecutor->ExecRangeWithThrow(
+                [&] (int columnInWindowIdx) {
+                    const auto trueFeatureIndex = sortedTrueFeatureIndices[windowBegin + columnInWindowIdx];
+                    serializeColumn(
+                        columnIndexToLocalIndex.at(trueFeatureIndex),
+                        &(*window)[columnInWindowIdx]);
+                },
+                0,
+                SafeIntegerCast<int>(windowEnd - windowBegin),
+                NPar::TLocalExecutor::WAIT_COMPLETE);
+
+            outputDone.GetValueSync();
+            outputDone = outputExecutor.ExecRangeWithFutures(
+                [&, window, windowBegin] (int /*blockId*/) {
+                    for (auto columnInWindowIdx : xrange(window->size())) {
+                        const auto trueFeatureIndex = sortedTrueFeatureIndices[windowBegin + columnInWindowIdx];
+                        auto* const chunkInfos = &perFeatureChunkInfos[columnIndexToLocalIndex.at(trueFeatureIndex)];
+                        for (const auto& chunk : (*window)[columnInWindowIdx]) {
+                            AddPadding(16, &output);
+
+                            const auto chunkOffset = output.Counter();
+                            output.Write(chunk.Data.Data(), chunk.Data.Size());
+
+                            chunkInfos->emplace_back(
+                                chunk.Data.Size(),
+                                chunkOffset,
+                                chunk.DocumentOffset,
+                                chunk.DocumentsInChunkCount);
+                        }
+                    }
+                },
+                0,
+                1,
+                NPar::TLocalExecutor::MED_PRIORITY
+            )[0];
         }
+        outputDone.GetValueSync();
     }
 
     const ui64 poolMetainfoSizeOffset = output.Counter();
     {
-        const auto poolMetainfo = MakePoolMetainfo(
-            pool.ColumnIndexToLocalIndex,
-            pool.ColumnTypes,
-            pool.ColumnNames,
-            pool.DocumentCount,
-            pool.IgnoredColumnIndices);
         const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
         WriteLittleEndian(poolMetainfoSize, &output);
         poolMetainfo.SerializeToArcadiaStream(&output);
     }
 
     const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
+    const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
     WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToArcadiaStream(&output);
+    quantizationSchema.SerializeToArcadiaStream(&output);
 
     const ui64 featureCountOffset = output.Counter();
     const ui32 featureCount = sortedTrueFeatureIndices.size();
     WriteLittleEndian(featureCount, &output);
     for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
-        const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
+        const auto localIndex = columnIndexToLocalIndex.at(trueFeatureIndex);
         const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
 
         WriteLittleEndian(trueFeatureIndex, &output);
@@ -301,8 +370,40 @@ static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave
     output.Write(MagicEnd, MagicEndSize);
 }
 
-void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
-    WriteAsOneFile(pool, output);
+void NCB::SaveQuantizedPool(
+    const TQuantizedPool& pool,
+    IOutputStream* const output,
+    NPar::ILocalExecutor* localExecutor) {
+
+    NPar::TLocalExecutor sequentialExecutor;
+    if (!localExecutor) {
+        localExecutor = &sequentialExecutor;
+    }
+
+    const auto poolMetainfo = MakePoolMetainfo(
+        pool.ColumnIndexToLocalIndex,
+        pool.ColumnTypes,
+        pool.ColumnNames,
+        pool.DocumentCount,
+        pool.IgnoredColumnIndices);
+    WriteAsOneFile(
+        pool.ColumnIndexToLocalIndex,
+        [&pool] (size_t localIndex, TSerializedColumn* column) {
+            flatbuffers::FlatBufferBuilder builder;
+            for (const auto& chunk : pool.Chunks[localIndex]) {
+                SerializeChunk(
+                    chunk.Chunk->BitsPerDocument(),
+                    TConstArrayRef<ui8>(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size()),
+                    chunk.DocumentOffset,
+                    chunk.DocumentCount,
+                    &builder,
+                    column);
+            }
+        },
+        poolMetainfo,
+        pool.QuantizationSchema,
+        localExecutor,
+        output);
 }
 
 static void ValidatePoolPart(const TConstArrayRef<ui8> blob) {
@@ -524,11 +625,14 @@ void TFileQuantizedPoolLoader::LoadQuantizedPool(NCB::TLoadQuantizedPoolParamete
         "Scheme quantized supports only default load subset range"
     );
 
-    Pool.Blobs.push_back(params.LockMemory
-        ? TBlob::LockedFromFile(TString(PathWithScheme.Path))
-        : TBlob::FromFile(TString(PathWithScheme.Path)));
-
-    // TODO(yazevnul): optionally precharge pool
+    if (params.LockMemory) {
+        Pool.Blobs.push_back(TBlob::LockedFromFile(TString(PathWithScheme.Path)));
+    } else if (params.Precharge) {
+        // read in advance with parallel range requests, it is much faster than page faults on network storages
+        Pool.Blobs.push_back(NCB::ReadFileWithReadAhead(TString(PathWithScheme.Path)));
+    } else {
+        Pool.Blobs.push_back(TBlob::FromFile(TString(PathWithScheme.Path)));
+    }
 
     const TConstArrayRef<ui8> blob{
         Pool.Blobs.back().AsUnsignedCharPtr(),
@@ -637,10 +741,90 @@ NCB::TPathWithScheme TFileQuantizedPoolLoader::GetPoolPathWithScheme() const {
 
 NCB::TQuantizedPoolLoaderFactory::TRegistrator<TFileQuantizedPoolLoader> FileQuantizedPoolLoaderReg("quantized");
 
+static void AppendChunks(
+    const TVector<NCB::TQuantizedPool::TChunkDescription>& chunks,
+    size_t documentOffset,
+    TVector<NCB::TQuantizedPool::TChunkDescription>* dst
+) {
+    for (auto chunk : chunks) {
+        chunk.DocumentOffset += documentOffset;
+        dst->push_back(chunk);
+    }
+}
+
+// objects of shard are added after objects of pool
+static void AppendQuantizedPoolShard(
+    const NCB::TPathWithScheme& shardPath,
+    NCB::TQuantizedPool&& shard,
+    NCB::TQuantizedPool* pool
+) {
+    CB_ENSURE(
+        google::protobuf::util::MessageDifferencer::Equals(shard.QuantizationSchema, pool->QuantizationSchema),
+        "Quantization schema of pool shard " << shardPath << " differs from the one of the first shard");
+    CB_ENSURE(
+        (shard.ColumnIndexToLocalIndex.size() == pool->ColumnIndexToLocalIndex.size())
+        && (shard.HasStringColumns == pool->HasStringColumns),
+        "Columns of pool shard " << shardPath << " differ from the ones of the first shard");
+
+    auto shardIgnoredColumnIndices = shard.IgnoredColumnIndices;
+    Sort(shardIgnoredColumnIndices);
+    auto poolIgnoredColumnIndices = pool->IgnoredColumnIndices;
+    Sort(poolIgnoredColumnIndices);
+    CB_ENSURE(
+        shardIgnoredColumnIndices == poolIgnoredColumnIndices,
+        "Ignored columns of pool shard " << shardPath << " differ from the ones of the first shard");
+
+    const size_t documentOffset = pool->DocumentCount;
+    for (const auto [columnIdx, localIdx] : shard.ColumnIndexToLocalIndex) {
+        const auto* const poolLocalIdx = MapFindPtr(pool->ColumnIndexToLocalIndex, columnIdx);
+        CB_ENSURE(
+            poolLocalIdx && (pool->ColumnTypes[*poolLocalIdx] == shard.ColumnTypes[localIdx]),
+            "Column " << columnIdx << " of pool shard " << shardPath << " differs from the one of the first shard");
+        AppendChunks(shard.Chunks[localIdx], documentOffset, &pool->Chunks[*poolLocalIdx]);
+    }
+
+    const std::pair<ui32, ui32> stringColumnLocalIndices[] = {
+        {shard.StringDocIdLocalIndex, pool->StringDocIdLocalIndex},
+        {shard.StringGroupIdLocalIndex, pool->StringGroupIdLocalIndex},
+        {shard.StringSubgroupIdLocalIndex, pool->StringSubgroupIdLocalIndex}
+    };
+    for (const auto [shardLocalIdx, poolLocalIdx] : stringColumnLocalIndices) {
+        CB_ENSURE(
+            (shardLocalIdx == static_cast<ui32>(-1)) == (poolLocalIdx == static_cast<ui32>(-1)),
+            "String columns of pool shard " << shardPath << " differ from the ones of the first shard");
+        if (shardLocalIdx != static_cast<ui32>(-1)) {
+            AppendChunks(shard.Chunks[shardLocalIdx], documentOffset, &pool->Chunks[poolLocalIdx]);
+        }
+    }
+
+    pool->DocumentCount += shard.DocumentCount;
+
+    // chunk descriptions point to data in blobs and chunk storage, it does not move with them
+    for (auto& blob : shard.Blobs) {
+        pool->Blobs.push_back(std::move(blob));
+    }
+    for (auto& chunkStorage : shard.ChunkStorage) {
+        pool->ChunkStorage.push_back(std::move(chunkStorage));
+    }
+}
+
 NCB::TQuantizedPool NCB::LoadQuantizedPool(
     const NCB::TPathWithScheme& pathWithScheme,
     const TLoadQuantizedPoolParameters& params
 ) {
+    if (IsShardedPath(pathWithScheme)) {
+        const auto shardPaths = GetShardPaths(pathWithScheme, params.ShardsShuffleSeed);
+        CB_ENSURE(!shardPaths.empty(), "No pool shards found for path " << pathWithScheme);
+
+        // shards are only mapped here, their data is read when it is passed to the visitor
+        TQuantizedPool pool = LoadQuantizedPool(shardPaths[0], params);
+        for (const auto& shardPath : MakeArrayRef(shardPaths).subspan(1)) {
+            AppendQuantizedPoolShard(shardPath, LoadQuantizedPool(shardPath, params), &pool);
+        }
+        CATBOOST_DEBUG_LOG << "Loaded " << shardPaths.size() << " shards of pool " << pathWithScheme << Endl;
+        return pool;
+    }
+
     const auto poolLoader = GetProcessor<IQuantizedPoolLoader, const TPathWithScheme&>(pathWithScheme, pathWithScheme);
     poolLoader->LoadQuantizedPool(params);
     return poolLoader->ExtractQuantizedPool();
@@ -873,102 +1057,120 @@ NCB::NIdl::TPoolMetainfo NCB::LoadPoolMetainfo(const TStringBuf path) {
 
 namespace NCB {
 
-    template <class T>
-    static void AddToPool(const TSrcColumn<T>& srcColumn, TQuantizedPool* quantizedPool) {
-        quantizedPool->ColumnTypes.push_back(srcColumn.Type);
+    // column is serialized when it is written and is not kept in memory, so columns must outlive writing
+    struct TSrcColumnSerializer {
+        EColumn Type;
+        std::function<void(TSerializedColumn*)> Serialize;
+    };
 
-        size_t documentOffset = 0;
-        TVector<TQuantizedPool::TChunkDescription> chunks;
-        for (const auto& dataPart : srcColumn.Data) {
-            flatbuffers::FlatBufferBuilder builder;
-            builder.Finish(
-                NIdl::CreateTQuantizedFeatureChunk(
-                    builder,
-                    static_cast<NIdl::EBitsPerDocumentFeature>(sizeof(T)*8),
-                    builder.CreateVector(
-                        reinterpret_cast<const ui8*>(dataPart.data()),
-                        sizeof(T)*dataPart.size()
-                    )
-                )
-            );
-            quantizedPool->Blobs.push_back(TBlob::Copy(builder.GetBufferPointer(), builder.GetSize()));
-
-            chunks.emplace_back(
-                documentOffset,
-                documentOffset + dataPart.size(),
-                flatbuffers::GetRoot<NIdl::TQuantizedFeatureChunk>(
-                    quantizedPool->Blobs.back().AsCharPtr()
-                )
-            );
-            documentOffset += dataPart.size();
-        }
-        quantizedPool->Chunks.push_back(std::move(chunks));
+    template <class T>
+    static TSrcColumnSerializer MakeSrcColumnSerializer(const TSrcColumn<T>& srcColumn) {
+        return {
+            srcColumn.Type,
+            [&srcColumn] (TSerializedColumn* column) {
+                flatbuffers::FlatBufferBuilder builder;
+                size_t documentOffset = 0;
+                for (const auto& dataPart : srcColumn.Data) {
+                    SerializeChunk(
+                        static_cast<NIdl::EBitsPerDocumentFeature>(sizeof(T)*8),
+                        TConstArrayRef<ui8>(reinterpret_cast<const ui8*>(dataPart.data()), sizeof(T)*dataPart.size()),
+                        documentOffset,
+                        // the value stored by this writer before, kept for compatibility of pool files
+                        documentOffset + dataPart.size(),
+                        &builder,
+                        column);
+                    documentOffset += dataPart.size();
+                }
+            }
+        };
     }
 
-
     template <class T>
-    static void AddToPool(const TMaybe<TSrcColumn<T>>& srcColumn, TQuantizedPool* quantizedPool) {
+    static void AddSrcColumnSerializer(
+        const TMaybe<TSrcColumn<T>>& srcColumn,
+        TVector<TSrcColumnSerializer>* serializers
+    ) {
         if (srcColumn) {
-            AddToPool(*srcColumn, quantizedPool);
+            serializers->push_back(MakeSrcColumnSerializer(*srcColumn));
         }
     }
 
-    static void AddFeatureDataToPool(
+    static TSrcColumnSerializer MakeFeatureDataSerializer(
         const THolder<TSrcColumnBase>& srcColumn,
-        EColumn columnType,
-        TQuantizedPool* quantizedPool
+        EColumn columnType
     ) {
         if (srcColumn) {
             if (auto* column = dynamic_cast<TSrcColumn<ui8>*>(srcColumn.Get())) {
-                AddToPool(*column, quantizedPool);
+                return MakeSrcColumnSerializer(*column);
             } else if (auto* column = dynamic_cast<TSrcColumn<ui16>*>(srcColumn.Get())) {
-                AddToPool(*column, quantizedPool);
+                return MakeSrcColumnSerializer(*column);
             } else if (auto* column = dynamic_cast<TSrcColumn<ui32>*>(srcColumn.Get())) {
-                AddToPool(*column, quantizedPool);
+                return MakeSrcColumnSerializer(*column);
             } else {
                 CB_ENSURE(false, "Unexpected srcColumn type for feature data");
             }
-        } else {
-            AddToPool(TSrcColumn<ui8>(columnType), quantizedPool);
         }
+        // no data, column has no chunks
+        return {columnType, [] (TSerializedColumn* /*column*/) {}};
     }
 
 
     void SaveQuantizedPool(
         const TSrcData& srcData,
-        TString fileName
+        TString fileName,
+        NPar::ILocalExecutor* localExecutor
     ) {
-        TQuantizedPool pool;
-        pool.DocumentCount = srcData.DocumentCount;
-        for (auto localIndex : xrange(srcData.LocalIndexToColumnIndex.size())) {
-            pool.ColumnIndexToLocalIndex.emplace(srcData.LocalIndexToColumnIndex[localIndex], localIndex);
+        NPar::TLocalExecutor sequentialExecutor;
+        if (!localExecutor) {
+            localExecutor = &sequentialExecutor;
         }
-        pool.QuantizationSchema = QuantizationSchemaToProto(srcData.PoolQuantizationSchema);
-        pool.ColumnNames = srcData.ColumnNames;
-        pool.IgnoredColumnIndices = srcData.IgnoredColumnIndices;
 
+        TVector<TSrcColumnSerializer> serializers;
         for (const auto& floatFeature : srcData.FloatFeatures) {
-            AddFeatureDataToPool(floatFeature, EColumn::Num, &pool);
+            serializers.push_back(MakeFeatureDataSerializer(floatFeature, EColumn::Num));
         }
         for (const auto& catFeature : srcData.CatFeatures) {
-            AddFeatureDataToPool(catFeature, EColumn::Categ, &pool);
+            serializers.push_back(MakeFeatureDataSerializer(catFeature, EColumn::Categ));
         }
 
-        AddToPool(srcData.GroupIds, &pool);
-        AddToPool(srcData.SubgroupIds, &pool);
+        AddSrcColumnSerializer(srcData.GroupIds, &serializers);
+        AddSrcColumnSerializer(srcData.SubgroupIds, &serializers);
 
-        AddToPool(srcData.Target, &pool);
+        AddSrcColumnSerializer(srcData.Target, &serializers);
 
         for (const auto& oneBaseline : srcData.Baseline) {
-            AddToPool(oneBaseline, &pool);
+            serializers.push_back(MakeSrcColumnSerializer(oneBaseline));
         }
 
-        AddToPool(srcData.Weights, &pool);
-        AddToPool(srcData.GroupWeights, &pool);
+        AddSrcColumnSerializer(srcData.Weights, &serializers);
+        AddSrcColumnSerializer(srcData.GroupWeights, &serializers);
+
+        THashMap<size_t, size_t> columnIndexToLocalIndex;
+        for (auto localIndex : xrange(srcData.LocalIndexToColumnIndex.size())) {
+            columnIndexToLocalIndex.emplace(srcData.LocalIndexToColumnIndex[localIndex], localIndex);
+        }
+        TVector<EColumn> columnTypes;
+        for (const auto& serializer : serializers) {
+            columnTypes.push_back(serializer.Type);
+        }
 
+        const auto poolMetainfo = MakePoolMetainfo(
+            columnIndexToLocalIndex,
+            columnTypes,
+            srcData.ColumnNames,
+            srcData.DocumentCount,
+            srcData.IgnoredColumnIndices);
 
         TFileOutput output(fileName);
-        SaveQuantizedPool(pool, &output);
+        WriteAsOneFile(
+            columnIndexToLocalIndex,
+            [&serializers] (size_t localIndex, TSerializedColumn* column) {
+                serializers[localIndex].Serialize(column);
+            },
+            poolMetainfo,
+            QuantizationSchemaToProto(srcData.PoolQuantizationSchema),
+            localExecutor,
+            &output);
     }
 
 
@@ -1262,6 +1464,6 @@ namespace NCB {
 
         TSrcData srcData = BuildSrcDataFromDataProvider(dataProvider, &localExecutor);
 
-        SaveQuantizedPool(srcData, fileName);
+        SaveQuantizedPool(srcData, fileName, &localExecutor);
     }
 }
@@ -4,6 +4,8 @@
 #include <catboost/private/libs/data_util/path_with_scheme.h>
 #include <catboost/libs/data/data_provider.h>
 
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <util/generic/fwd.h>
 #include <util/stream/fwd.h>
 
@@ -84,8 +86,15 @@ namespace NCB {
 }
 
 namespace NCB {
-    void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
-    void SaveQuantizedPool(const TSrcData& srcData, TString fileName);
+    // columns are serialized in parallel by localExecutor if it is specified
+    void SaveQuantizedPool(
+        const TQuantizedPool& pool,
+        IOutputStream* output,
+        NPar::ILocalExecutor* localExecutor = nullptr);
+    void SaveQuantizedPool(
+        const TSrcData& srcData,
+        TString fileName,
+        NPar::ILocalExecutor* localExecutor = nullptr);
     void SaveQuantizedPool(const TDataProviderPtr& dataProvider, TString fileName);
 
     static constexpr size_t QUANTIZED_POOL_COLUMN_DEFAULT_SLICE_COUNT = 512 * 1024;
@@ -109,9 +118,13 @@ namespace NCB {
         bool LockMemory = true;
         bool Precharge = true;
         TDatasetSubset DatasetSubset;
+        TMaybe<ui64> ShardsShuffleSeed; // used only for sharded paths
     };
 
     // Load quantized pool saved by `SaveQuantizedPool` from file.
+    //
+    // Pool can be sharded (see data_util/shards.h), then all shards must have the same columns and
+    // quantization schema, their objects are concatenated in the order of shards.
     TQuantizedPool LoadQuantizedPool(const TPathWithScheme& pathWithScheme, const TLoadQuantizedPoolParameters& params);
 
     NIdl::TPoolQuantizationSchema LoadQuantizationSchemaFromPool(TStringBuf path);
@@ -2,6 +2,7 @@
 
 #include <catboost/private/libs/text_features/flatbuffers/feature_calcers.fbs.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 
@@ -13,21 +14,8 @@ static inline double CalcTruncatedInvClassFreq(ui32 numClasses, ui32 classesWith
     return Max<double>(log((numClasses - classesWithTerm + 0.5) / (classesWithTerm + 0.5)), eps);
 }
 
-static inline ui32 ExtractTermFreq(TConstArrayRef<TDenseHash<TTokenId, ui32>> freq,
-                                   TTokenId term,
-                                   TArrayRef<ui32> termFreq) {
-    ui32 nonZeroCount = 0;
-    for (ui32 clazz = 0; clazz < freq.size(); ++clazz) {
-        const auto& classFreqTable = freq[clazz];
-        const auto termFreqIt = classFreqTable.find(term);
-        if (termFreqIt != classFreqTable.end()) {
-            termFreq[clazz] = termFreqIt->second;
-            ++nonZeroCount;
-        } else {
-            termFreq[clazz] = 0;
-        }
-    }
-    return nonZeroCount;
+static inline ui32 CountNonZero(TConstArrayRef<ui32> termFreq) {
+    return CountIf(termFreq, [](ui32 freq) { return freq != 0; });
 }
 
 static inline double Score(double termFreq, double k, double b, double meanLength, double classLength) {
@@ -64,13 +52,17 @@ TBM25::TBM25(
 }
 
 void TBM25::Compute(const TText& text, TOutputFloatIterator iterator) const {
-    TVector<ui32> termFreqInClass(NumClasses);
     TVector<double> scores(NumClasses);
     const double meanClassLength = (double)TotalTokens / NumClasses;
     for (const auto& tokenToCount : text) {
-        const ui32 nonZeroCount = ExtractTermFreq(Frequencies, tokenToCount.Token(), termFreqInClass);
+        const auto termFreqInClass = Frequencies.GetCounts(tokenToCount.Token());
+        if (termFreqInClass.empty()) {
+            // scores of unseen terms are zero
+            continue;
+        }
+        const double invClassFreq = TruncatedInvClassFreq[CountNonZero(termFreqInClass)];
         for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
-            scores[clazz] += TruncatedInvClassFreq[nonZeroCount] * Score(termFreqInClass[clazz], K, B, meanClassLength,  ClassTotalTokens[clazz]);
+            scores[clazz] += invClassFreq * Score(termFreqInClass[clazz], K, B, meanClassLength,  ClassTotalTokens[clazz]);
         }
     }
 
@@ -123,22 +115,22 @@ void TBM25::LoadParametersFromFB(const NCatBoostFbs::TFeatureCalcer* calcer) {
 }
 
 void TBM25::SaveLargeParameters(IOutputStream* stream) const {
-    ::Save(stream, Frequencies);
+    ::Save(stream, Frequencies.ToClassFrequencies());
 }
 
 void TBM25::LoadLargeParameters(IInputStream* stream) {
-    ::Load(stream, Frequencies);
+    TVector<TDenseHash<TTokenId, ui32>> classFrequencies;
+    ::Load(stream, classFrequencies);
+    Frequencies = TTokenClassCounts::FromClassFrequencies(classFrequencies);
 }
 
 void TBM25Visitor::Update(ui32 classId, const TText& text, TTextFeatureCalcer* calcer) {
     auto bm25 = dynamic_cast<TBM25*>(calcer);
     Y_ASSERT(bm25);
 
-    auto& classCounts = bm25->Frequencies[classId];
-
     for (const auto& tokenToCount : text) {
         const ui32 count = tokenToCount.Count();
-        classCounts[tokenToCount.Token()] += count;
+        bm25->Frequencies.Add(classId, tokenToCount.Token(), count);
         bm25->ClassTotalTokens[classId] += count;
         bm25->TotalTokens += count;
     }
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_counts.h"
 
-#include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
 #include <util/generic/fwd.h>
 
@@ -47,7 +47,7 @@ namespace NCB {
 
         ui64 TotalTokens;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<TTokenId, ui32>> Frequencies;
+        TTokenClassCounts Frequencies;
         TVector<double> TruncatedInvClassFreq;
 
     protected:
@@ -11,37 +11,36 @@ using namespace NCB;
 TTextFeatureCalcerFactory::TRegistrator<TMultinomialNaiveBayes>
     NaiveBayesRegistrator(EFeatureCalcerType::NaiveBayes);
 
-double TMultinomialNaiveBayes::LogProb(
-    const TDenseHash<TTokenId, ui32>& freqTable,
-    double classSamples,
-    double classTokensCount,
-    const TText& text) const {
-
-    Y_UNUSED(text, freqTable);
-    double value = log(classSamples + ClassPrior);
-
-    classTokensCount += TokenPrior * (NumSeenTokens + SEEN_TOKENS_PRIOR);
+void TMultinomialNaiveBayes::CalcLogProbs(const TText& text, TArrayRef<double> logProbs) const {
+    TVector<double> classTokensCounts(NumClasses);
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        logProbs[clazz] = log(double(ClassDocs[clazz]) + ClassPrior);
+        classTokensCounts[clazz] = double(ClassTotalTokens[clazz]) + TokenPrior * (NumSeenTokens + SEEN_TOKENS_PRIOR);
+    }
+    const double unseenTokenLogProb = log(TokenPrior);
     double textLen = 0;
 
     for (const auto& tokenToCount : text) {
-        textLen += tokenToCount.Count();
-
-        auto tokenCountPtr = freqTable.find(tokenToCount.Token());
-        double num = TokenPrior;
-
-        if (tokenCountPtr != freqTable.end()) {
-            num += tokenCountPtr->second;
-        } else {
-            //unseen word, adjust prior
-            classTokensCount += TokenPrior;
+        const double count = tokenToCount.Count();
+        textLen += count;
+
+        const auto tokenCounts = Frequencies.GetCounts(tokenToCount.Token());
+        for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+            const ui32 tokenCount = tokenCounts.empty() ? 0 : tokenCounts[clazz];
+            if (tokenCount) {
+                logProbs[clazz] += count * log(TokenPrior + tokenCount);
+            } else {
+                //unseen word, adjust prior
+                classTokensCounts[clazz] += TokenPrior;
+                logProbs[clazz] += count * unseenTokenLogProb;
+            }
         }
-        value += tokenToCount.Count() * log(num);
     }
 
     //denum
-    value -= textLen * log(classTokensCount);
-
-    return value;
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        logProbs[clazz] -= textLen * log(classTokensCounts[clazz]);
+    }
 }
 
 void TMultinomialNaiveBayes::Compute(
@@ -49,9 +48,7 @@ void TMultinomialNaiveBayes::Compute(
     TOutputFloatIterator outputFeaturesIterator) const {
 
     TVector<double> logProbs(NumClasses);
-    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
-        logProbs[clazz] = LogProb(Frequencies[clazz], ClassDocs[clazz], ClassTotalTokens[clazz], text);
-    }
+    CalcLogProbs(text, logProbs);
     Softmax(logProbs);
 
     ForEachActiveFeature(
@@ -109,22 +106,22 @@ void TMultinomialNaiveBayes::LoadParametersFromFB(const NCatBoostFbs::TFeatureCa
 }
 
 void TMultinomialNaiveBayes::SaveLargeParameters(IOutputStream* stream) const {
-    ::Save(stream, Frequencies);
+    ::Save(stream, Frequencies.ToClassFrequencies());
 }
 
 void TMultinomialNaiveBayes::LoadLargeParameters(IInputStream* stream) {
-    ::Load(stream, Frequencies);
+    TVector<TDenseHash<TTokenId, ui32>> classFrequencies;
+    ::Load(stream, classFrequencies);
+    Frequencies = TTokenClassCounts::FromClassFrequencies(classFrequencies);
 }
 
 void TNaiveBayesVisitor::Update(ui32 classId, const TText& text, TTextFeatureCalcer* calcer) {
     auto naiveBayes = dynamic_cast<TMultinomialNaiveBayes*>(calcer);
     Y_ASSERT(naiveBayes);
 
-    auto& classCounts = naiveBayes->Frequencies[classId];
-
     for (const auto& tokenToCount : text) {
         SeenTokens.Insert(tokenToCount.Token());
-        classCounts[tokenToCount.Token()] += tokenToCount.Count();
+        naiveBayes->Frequencies.Add(classId, tokenToCount.Token(), tokenToCount.Count());
         naiveBayes->ClassTotalTokens[classId] += tokenToCount.Count();
     }
     naiveBayes->ClassDocs[classId] += 1;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "feature_calcer.h"
+#include "token_class_counts.h"
 
 #include <library/cpp/containers/dense_hash/dense_hash.h>
 #include <util/system/types.h>
@@ -48,12 +49,7 @@ namespace NCB {
         }
 
     private:
-        double LogProb(
-            const TDenseHash<TTokenId, ui32>& freqTable,
-            double classSamples,
-            double classTokensCount,
-            const TText& text
-        ) const;
+        void CalcLogProbs(const TText& text, TArrayRef<double> logProbs) const;
 
     protected:
         TTextFeatureCalcer::TFeatureCalcerFbs SaveParametersToFB(flatbuffers::FlatBufferBuilder& builder) const override;
@@ -70,7 +66,7 @@ namespace NCB {
         ui64 NumSeenTokens;
         TVector<ui32> ClassDocs;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<TTokenId, ui32>> Frequencies;
+        TTokenClassCounts Frequencies;
 
         friend class TNaiveBayesVisitor;
     };
@@ -13,17 +13,14 @@
 
 namespace NCB {
     static void CalcFeatures(
-        const TVector<TTokensWithBuffer>& tokens,
-        const TDictionaryProxy& dictionary,
+        TConstArrayRef<TText> texts,
         const TTextFeatureCalcer& calcer,
         TArrayRef<float> result
     ) {
-        const ui64 docCount = tokens.size();
+        const ui64 docCount = texts.size();
         for (ui32 docId: xrange(docCount)) {
-            TText text = dictionary.Apply(tokens[docId].View);
-
             calcer.Compute(
-                text,
+                texts[docId],
                 TOutputFloatIterator(result.data() + docId, docCount, result.size())
             );
         }
@@ -40,29 +37,61 @@ namespace NCB {
         }
     }
 
+    static void DigitizeTokens(
+        TConstArrayRef<TTokensWithBuffer> tokens,
+        const TDictionaryProxy& dictionary,
+        TVector<ui32>* tokenIdsBuffer,
+        TArrayRef<TText> texts
+    ) {
+        for (ui32 docId: xrange(texts.size())) {
+            dictionary.Apply(tokens[docId].View, &texts[docId], tokenIdsBuffer);
+        }
+    }
+
     void TTextProcessingCollection::CalcFeatures(
         TConstArrayRef<TStringBuf> textFeature,
         ui32 textFeatureIdx,
         size_t docCount,
         TArrayRef<float> result
+    ) const {
+        TCalcFeaturesBuffers buffers;
+        CalcFeatures(textFeature, textFeatureIdx, docCount, &buffers, result);
+    }
+
+    void TTextProcessingCollection::CalcFeatures(
+        TConstArrayRef<TStringBuf> textFeature,
+        ui32 textFeatureIdx,
+        size_t docCount,
+        TCalcFeaturesBuffers* buffers,
+        TArrayRef<float> result
     ) const {
         CB_ENSURE(
             result.size() >= NumberOfOutputFeatures(textFeatureIdx) * docCount,
             "Proposed result buffer has size less than text processing produce"
         );
 
-        TVector<TTokensWithBuffer> tokens;
-        tokens.yresize(docCount);
+        auto& tokens = buffers->Tokens;
+        // buffers keep capacity of previous calls
+        if (tokens.size() < docCount) {
+            tokens.resize(docCount);
+        }
+        if (buffers->DigitizedTexts.size() < docCount) {
+            buffers->DigitizedTexts.resize(docCount);
+        }
+        const auto texts = MakeArrayRef(buffers->DigitizedTexts.data(), docCount);
         TTokenizerPtr previousTokenizer;
 
         for (ui32 digitizerId: PerFeatureDigitizers[textFeatureIdx]) {
             const auto& dictionary = Digitizers[digitizerId].Dictionary;
             const ui32 tokenizedFeatureIdx = GetTokenizedFeatureId(textFeatureIdx, digitizerId);
 
+            // tokens are shared by consecutive digitizers with the same tokenizer
             if (!previousTokenizer || Digitizers[digitizerId].Tokenizer != previousTokenizer) {
                 TokenizeTextFeature(textFeature, docCount, Digitizers[digitizerId].Tokenizer, &tokens);
                 previousTokenizer = Digitizers[digitizerId].Tokenizer;
             }
+            // digitized texts are shared by all calcers of the dictionary
+            DigitizeTokens(tokens, *dictionary, &buffers->TokenIds, texts);
 
             for (ui32 calcerId: PerTokenizedFeatureCalcers[tokenizedFeatureIdx]) {
                 const auto& calcer = FeatureCalcers[calcerId];
@@ -74,7 +103,7 @@ namespace NCB {
                     result.data() + calcerOffset,
                     result.data() + calcerOffset + calculatedFeaturesSize
                 );
-                NCB::CalcFeatures(tokens, *dictionary, *calcer, currentResult);
+                NCB::CalcFeatures(texts, *calcer, currentResult);
             }
         }
     }
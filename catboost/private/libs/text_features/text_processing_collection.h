@@ -38,6 +38,16 @@ namespace NCB {
             TVector<TVector<ui32>> perTokenizedFeatureCalcers
         );
 
+        /* Intermediate data of CalcFeatures, pass the same buffers to consecutive calls
+         * (e.g. for blocks of documents) to avoid allocations in each call
+         */
+        struct TCalcFeaturesBuffers {
+            TVector<TStringBuf> Texts;
+            TVector<TTokensWithBuffer> Tokens;
+            TVector<TText> DigitizedTexts;
+            TVector<ui32> TokenIds;
+        };
+
         void CalcFeatures(
             TConstArrayRef<TStringBuf> textFeature,
             ui32 textFeatureIdx,
@@ -51,6 +61,18 @@ namespace NCB {
             TConstArrayRef<ui32> textFeatureIds,
             ui32 docCount,
             TArrayRef<float> result
+        ) const {
+            TCalcFeaturesBuffers buffers;
+            CalcFeatures(featureAccessor, textFeatureIds, docCount, &buffers, result);
+        }
+
+        template <class TTextFeatureAccessor>
+        void CalcFeatures(
+            TTextFeatureAccessor featureAccessor,
+            TConstArrayRef<ui32> textFeatureIds,
+            ui32 docCount,
+            TCalcFeaturesBuffers* buffers,
+            TArrayRef<float> result
         ) const {
             const ui32 totalNumberOfFeatures = TotalNumberOfOutputFeatures() * docCount;
             CB_ENSURE(
@@ -59,7 +81,7 @@ namespace NCB {
                     << ") less than text processing produce (" << totalNumberOfFeatures << ')'
             );
 
-            TVector<TStringBuf> texts;
+            auto& texts = buffers->Texts;
             texts.yresize(docCount);
 
             float* estimatedFeatureBegin = &result[0];
@@ -74,6 +96,8 @@ namespace NCB {
                 CalcFeatures(
                     MakeConstArrayRef(texts),
                     textFeatureId,
+                    docCount,
+                    buffers,
                     TArrayRef<float>(
                         estimatedFeatureBegin,
                         estimatedFeatureEnd
@@ -89,6 +113,14 @@ namespace NCB {
             size_t docCount,
             TArrayRef<float> result) const;
 
+        // buffers->Texts is not used, so textFeature can point to it
+        void CalcFeatures(
+            TConstArrayRef<TStringBuf> textFeature,
+            ui32 textFeatureIdx,
+            size_t docCount,
+            TCalcFeaturesBuffers* buffers,
+            TArrayRef<float> result) const;
+
         ui32 GetAbsoluteCalcerOffset(const TGuid& calcerGuid) const;
         ui32 GetRelativeCalcerOffset(ui32 textFeatureIdx, const TGuid& calcerGuid) const;
 
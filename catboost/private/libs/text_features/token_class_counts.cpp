@@ -0,0 +1,40 @@
+#include "token_class_counts.h"
+
+#include <util/generic/xrange.h>
+
+using namespace NCB;
+
+void TTokenClassCounts::Add(ui32 classId, TTokenId token, ui32 count) {
+    Y_ASSERT(classId < NumClasses);
+    const ui32 newRow = TokenToRow.Size();
+    const auto [rowIt, inserted] = TokenToRow.insert({token, newRow});
+    if (inserted) {
+        Counts.resize(Counts.size() + NumClasses, 0);
+    }
+    Counts[(size_t)rowIt->second * NumClasses + classId] += count;
+}
+
+TVector<TDenseHash<TTokenId, ui32>> TTokenClassCounts::ToClassFrequencies() const {
+    TVector<TDenseHash<TTokenId, ui32>> classFrequencies(NumClasses);
+    for (const auto& [token, row] : TokenToRow) {
+        for (auto classId : xrange(NumClasses)) {
+            const ui32 count = Counts[(size_t)row * NumClasses + classId];
+            if (count) {
+                classFrequencies[classId][token] = count;
+            }
+        }
+    }
+    return classFrequencies;
+}
+
+TTokenClassCounts TTokenClassCounts::FromClassFrequencies(
+    const TVector<TDenseHash<TTokenId, ui32>>& classFrequencies
+) {
+    TTokenClassCounts result(classFrequencies.size());
+    for (auto classId : xrange(classFrequencies.size())) {
+        for (const auto& [token, count] : classFrequencies[classId]) {
+            result.Add(classId, token, count);
+        }
+    }
+    return result;
+}
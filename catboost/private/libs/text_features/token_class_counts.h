@@ -0,0 +1,51 @@
+#pragma once
+
+#include <catboost/private/libs/data_types/text.h>
+
+#include <library/cpp/containers/dense_hash/dense_hash.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NCB {
+
+    /*
+     * Counts of tokens in texts of each class, stored by token: token x class matrix with a row
+     * for each seen token, so that one lookup gives counts of a token in all classes.
+     * Calcers compute per class values of a text as a product of the sparse text vector and this matrix
+     * instead of a lookup in a table of each class for each token.
+     */
+    class TTokenClassCounts {
+    public:
+        explicit TTokenClassCounts(ui32 numClasses = 0)
+            : NumClasses(numClasses)
+        {}
+
+        ui32 GetNumClasses() const {
+            return NumClasses;
+        }
+
+        void Add(ui32 classId, TTokenId token, ui32 count);
+
+        // counts in each class, empty for tokens which were never added
+        TConstArrayRef<ui32> GetCounts(TTokenId token) const {
+            const auto rowIt = TokenToRow.find(token);
+            if (rowIt == TokenToRow.end()) {
+                return {};
+            }
+            return MakeArrayRef(Counts.data() + (size_t)rowIt->second * NumClasses, NumClasses);
+        }
+
+        // calcers serialize counts as a table for each class
+        TVector<TDenseHash<TTokenId, ui32>> ToClassFrequencies() const;
+        static TTokenClassCounts FromClassFrequencies(const TVector<TDenseHash<TTokenId, ui32>>& classFrequencies);
+
+    private:
+        ui32 NumClasses;
+        TDenseHash<TTokenId, ui32> TokenToRow;
+        // rows of NumClasses counts
+        TVector<ui32> Counts;
+    };
+
+}
@@ -2,10 +2,12 @@
 #include <catboost/private/libs/text_features/text_feature_calcers.h>
 
 #include <catboost/private/libs/text_features/helpers.h>
+#include <catboost/private/libs/text_features/token_class_counts.h>
 
 #include <library/cpp/testing/unittest/registar.h>
 #include <util/generic/ylimits.h>
 #include <util/generic/xrange.h>
+#include <util/stream/str.h>
 
 using namespace NCB;
 
@@ -242,4 +244,61 @@ Y_UNIT_TEST_SUITE(TestFeatureCalcer) {
             );
         }
     }
+
+    Y_UNIT_TEST(TestTokenClassCounts) {
+        TTokenClassCounts counts(3);
+        counts.Add(0, 5, 2);
+        counts.Add(2, 5, 1);
+        counts.Add(2, 5, 3);
+        counts.Add(1, 7, 1);
+
+        UNIT_ASSERT(counts.GetCounts(6).empty());
+        UNIT_ASSERT(TVector<ui32>(counts.GetCounts(5).begin(), counts.GetCounts(5).end()) == TVector<ui32>({2, 0, 4}));
+        UNIT_ASSERT(TVector<ui32>(counts.GetCounts(7).begin(), counts.GetCounts(7).end()) == TVector<ui32>({0, 1, 0}));
+
+        const auto classFrequencies = counts.ToClassFrequencies();
+        UNIT_ASSERT_VALUES_EQUAL(classFrequencies.size(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(classFrequencies[0].Size(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(classFrequencies[1].Size(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(classFrequencies[2].find(TTokenId(5))->second, 4);
+
+        const auto restored = TTokenClassCounts::FromClassFrequencies(classFrequencies);
+        for (ui32 tokenId : xrange(10)) {
+            const auto expected = counts.GetCounts(tokenId);
+            const auto actual = restored.GetCounts(tokenId);
+            UNIT_ASSERT(TVector<ui32>(expected.begin(), expected.end()) == TVector<ui32>(actual.begin(), actual.end()));
+        }
+    }
+
+    Y_UNIT_TEST(TestClassCalcersSerialization) {
+        const ui32 numClasses = 10;
+        TVector<TText> texts;
+        for (ui32 textIdx : xrange(200)) {
+            TVector<ui32> tokenIds;
+            for (ui32 i : xrange(textIdx % 13)) {
+                tokenIds.push_back((textIdx * 7 + i * i) % 97);
+            }
+            texts.emplace_back(std::move(tokenIds));
+        }
+
+        TVector<TTextFeatureCalcerPtr> calcers = {
+            MakeIntrusive<TBM25>(CreateGuid(), numClasses),
+            MakeIntrusive<TMultinomialNaiveBayes>(CreateGuid(), numClasses)
+        };
+        TBM25Visitor bm25Visitor;
+        TNaiveBayesVisitor naiveBayesVisitor;
+        for (ui32 textIdx : xrange(texts.size())) {
+            bm25Visitor.Update(textIdx % numClasses, texts[textIdx], calcers[0].Get());
+            naiveBayesVisitor.Update(textIdx % numClasses, texts[textIdx], calcers[1].Get());
+        }
+
+        for (const auto& calcer : calcers) {
+            TStringStream stream;
+            TTextCalcerSerializer::Save(&stream, *calcer);
+            const auto loadedCalcer = TTextCalcerSerializer::Load(&stream);
+            for (const auto& text : texts) {
+                UNIT_ASSERT(calcer->Compute(text) == loadedCalcer->Compute(text));
+            }
+        }
+    }
 }
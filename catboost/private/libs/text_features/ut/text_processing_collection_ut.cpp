@@ -206,4 +206,64 @@ Y_UNIT_TEST_SUITE(TestTextProcessingCollection) {
             features
         );
     }
+
+    Y_UNIT_TEST(TestApplyWithReusedBuffers) {
+        TVector<TTextFeature> features;
+        TMap<ui32, TTokenizedTextFeature> tokenizedFeatures;
+        TVector<TDigitizer> digitizers;
+        TVector<TTextFeatureCalcerPtr> calcers;
+        TVector<TVector<ui32>> perFeatureDigitizers;
+        TVector<TVector<ui32>> perTokenizedFeatureCalcers;
+
+        CreateTextDataForTest(
+            &features,
+            &tokenizedFeatures,
+            &digitizers,
+            &calcers,
+            &perFeatureDigitizers,
+            &perTokenizedFeatureCalcers
+        );
+
+        TTextProcessingCollection collection(
+            digitizers,
+            calcers,
+            perFeatureDigitizers,
+            perTokenizedFeatureCalcers
+        );
+
+        TTextProcessingCollection::TCalcFeaturesBuffers buffers;
+        for (ui32 featureId: xrange(features.size())) {
+            TVector<TStringBuf> texts;
+            ToStringBufArray(features[featureId], &texts);
+            const ui32 docCount = texts.size();
+            const ui32 outputFeatureCount = collection.NumberOfOutputFeatures(featureId);
+
+            TVector<float> expected;
+            expected.yresize(outputFeatureCount * docCount);
+            collection.CalcFeatures(texts, featureId, expected);
+
+            // the second part is smaller than the first one, so it is computed in larger buffers
+            const ui32 firstPartSize = (docCount + 1) / 2;
+            for (auto [partBegin, partEnd] : {std::pair<ui32, ui32>{0, firstPartSize}, std::pair<ui32, ui32>{firstPartSize, docCount}}) {
+                const ui32 partSize = partEnd - partBegin;
+                TVector<float> result;
+                result.yresize(outputFeatureCount * partSize);
+                collection.CalcFeatures(
+                    MakeArrayRef(texts.data() + partBegin, partSize),
+                    featureId,
+                    partSize,
+                    &buffers,
+                    result
+                );
+                for (ui32 outputFeatureIdx : xrange(outputFeatureCount)) {
+                    for (ui32 docId : xrange(partSize)) {
+                        UNIT_ASSERT_EQUAL(
+                            expected[outputFeatureIdx * docCount + partBegin + docId],
+                            result[outputFeatureIdx * partSize + docId]
+                        );
+                    }
+                }
+            }
+        }
+    }
 }
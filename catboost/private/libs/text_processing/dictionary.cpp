@@ -1,5 +1,7 @@
 #include "dictionary.h"
 
+#include <util/stream/length.h>
+
 namespace NCB {
     TDictionaryProxy::TDictionaryProxy(TDictionaryPtr dictionaryImpl)
         : DictionaryImpl(std::move(dictionaryImpl))
@@ -16,6 +18,15 @@ namespace NCB {
         *text = TText{std::move(tokenIds)};
     }
 
+    void TDictionaryProxy::Apply(
+        TConstArrayRef<TStringBuf> tokens,
+        TText* text,
+        TVector<ui32>* tokenIdsBuffer
+    ) const {
+        DictionaryImpl->Apply(tokens, tokenIdsBuffer);
+        text->SetTokenIds(*tokenIdsBuffer);
+    }
+
     ui32 TDictionaryProxy::Size() const {
         return DictionaryImpl->Size();
     }
@@ -35,11 +46,22 @@ namespace NCB {
     }
 
     TVector<TTokenId> TDictionaryProxy::GetTopTokens(ui32 topSize) const {
+        if (auto hashingDictionary = dynamic_cast<const THashingDictionary*>(DictionaryImpl.Get())) {
+            const auto topTokenIds = hashingDictionary->GetTopTokenIds(topSize);
+            return TVector<TTokenId>(topTokenIds.begin(), topTokenIds.end());
+        }
         topSize = Min(topSize, DictionaryImpl->Size());
         return xrange(topSize);
     }
 
     void TDictionaryProxy::Save(IOutputStream* stream) const {
+        if (auto hashingDictionary = dynamic_cast<const THashingDictionary*>(DictionaryImpl.Get())) {
+            WriteMagic(HashingDictionaryMagic.data(), MagicSize, Alignment, stream);
+            Guid.Save(stream);
+            hashingDictionary->Save(stream);
+            return;
+        }
+
         WriteMagic(DictionaryMagic.data(), MagicSize, Alignment, stream);
         Guid.Save(stream);
 
@@ -53,19 +75,47 @@ namespace NCB {
         }
     }
 
+    bool TDictionaryProxy::ReadDictionaryMagic(IInputStream* stream) {
+        TCountingInput input(stream);
+        std::array<char, MagicSize> loadedMagic;
+        const ui32 loadedBytes = input.Load(loadedMagic.data(), MagicSize);
+        const bool isHashingDictionary = (loadedBytes == MagicSize) && (loadedMagic == HashingDictionaryMagic);
+        CB_ENSURE(
+            isHashingDictionary || ((loadedBytes == MagicSize) && (loadedMagic == DictionaryMagic)),
+            "Failed to deserialize: couldn't read magic"
+        );
+        SkipPadding(&input, Alignment);
+        return isHashingDictionary;
+    }
+
     void TDictionaryProxy::Load(IInputStream* stream) {
-        ReadMagic(DictionaryMagic.data(), MagicSize, Alignment, stream);
+        const bool isHashingDictionary = ReadDictionaryMagic(stream);
         Guid.Load(stream);
 
+        if (isHashingDictionary) {
+            auto dictionaryImpl = MakeIntrusive<THashingDictionary>();
+            dictionaryImpl->Load(stream);
+            DictionaryImpl = std::move(dictionaryImpl);
+            return;
+        }
+
         auto dictionaryImpl = MakeIntrusive<TMMapDictionary>();
         dictionaryImpl->Load(stream);
         DictionaryImpl = std::move(dictionaryImpl);
     }
 
     void TDictionaryProxy::LoadNonOwning(TMemoryInput *in) {
-        ReadMagic(DictionaryMagic.data(), MagicSize, Alignment, in);
+        const bool isHashingDictionary = ReadDictionaryMagic(in);
         Guid.Load(in);
 
+        if (isHashingDictionary) {
+            // hashing dictionary has no data to share, only its options are loaded
+            auto dictionaryImpl = MakeIntrusive<THashingDictionary>();
+            dictionaryImpl->Load(in);
+            DictionaryImpl = std::move(dictionaryImpl);
+            return;
+        }
+
         auto dictionaryImpl = MakeIntrusive<TMMapDictionary>();
         auto size = TMMapDictionary::CalculateExpectedSize(in->Buf(), in->Avail());
         dictionaryImpl->InitFromMemory(in->Buf(), size);
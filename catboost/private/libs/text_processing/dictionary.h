@@ -1,5 +1,6 @@
 #pragma once
 
+#include "hashing_dictionary.h"
 #include "tokenizer.h"
 
 #include <catboost/libs/helpers/guid.h>
@@ -32,6 +33,8 @@ namespace NCB {
         TTokenId Apply(TStringBuf token) const;
         TText Apply(TConstArrayRef<TStringBuf> tokens) const;
         void Apply(TConstArrayRef<TStringBuf> tokens, TText* text) const;
+        // tokenIdsBuffer is reused to avoid allocations per text
+        void Apply(TConstArrayRef<TStringBuf> tokens, TText* text, TVector<ui32>* tokenIdsBuffer) const;
 
         ui32 Size() const;
 
@@ -42,11 +45,16 @@ namespace NCB {
         void Load(IInputStream* stream);
         void LoadNonOwning(TMemoryInput* in);
 
+    private:
+        // returns true for hashing dictionary magic
+        static bool ReadDictionaryMagic(IInputStream* stream);
+
     private:
         TDictionaryPtr DictionaryImpl;
         TGuid Guid;
 
         static constexpr std::array<char, 13> DictionaryMagic = {"DictionaryV1"};
+        static constexpr std::array<char, 13> HashingDictionaryMagic = {"HashingDicV1"};
         static constexpr ui32 MagicSize = DictionaryMagic.size();
         static constexpr ui32 Alignment = 16;
     };
@@ -117,12 +125,24 @@ namespace NCB {
         const NCatboostOptions::TTextColumnDictionaryOptions& dictionaryOptions,
         const TTokenizerPtr& tokenizer) {
 
+        TTokensWithBuffer tokens;
+        if (dictionaryOptions.DictionaryType.Get() == NCatboostOptions::ETextDictionaryType::Hashing) {
+            auto hashingDictionary = MakeIntrusive<THashingDictionary>(
+                dictionaryOptions.DictionaryOptions.Get(),
+                dictionaryOptions.HashBucketCount.Get()
+            );
+            textFeature.ForEach([&](ui32 /*index*/, TStringBuf phrase) {
+                tokenizer->Tokenize(phrase, &tokens);
+                hashingDictionary->Add(tokens.View);
+            });
+            return new TDictionaryProxy(std::move(hashingDictionary));
+        }
+
         NTextProcessing::NDictionary::TDictionaryBuilder dictionaryBuilder(
             dictionaryOptions.DictionaryBuilderOptions,
             dictionaryOptions.DictionaryOptions
         );
 
-        TTokensWithBuffer tokens;
         const auto& tokenize = [&](ui32 /*index*/, TStringBuf phrase) {
             tokenizer->Tokenize(phrase, &tokens);
             dictionaryBuilder.Add(tokens.View);
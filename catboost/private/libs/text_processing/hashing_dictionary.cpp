@@ -0,0 +1,171 @@
+#include "hashing_dictionary.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/cpp/text_processing/dictionary/multigram_dictionary_helpers.h>
+#include <library/cpp/text_processing/dictionary/util.h>
+
+#include <util/digest/murmur.h>
+#include <util/digest/numeric.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/string/builder.h>
+#include <util/ysaveload.h>
+
+using namespace NTextProcessing::NDictionary;
+
+namespace NCB {
+    static ui64 CalcTokenHash(TStringBuf token) {
+        return MurmurHash<ui64>(token.data(), token.size());
+    }
+
+    THashingDictionary::THashingDictionary(const TDictionaryOptions& dictionaryOptions, ui32 bucketCount)
+        : DictionaryOptions(dictionaryOptions)
+        , BucketCount(bucketCount)
+    {
+        CB_ENSURE(BucketCount > 0, "Hashing dictionary should have at least one bucket");
+        CB_ENSURE(DictionaryOptions.GramOrder > 0, "Hashing dictionary gram order should be positive");
+    }
+
+    template <typename TTokenType, typename TVisitor>
+    void THashingDictionary::VisitTokenIds(TConstArrayRef<TTokenType> tokens, TVisitor&& visitor) const {
+        if (DictionaryOptions.TokenLevelType == ETokenLevelType::Letter) {
+            auto visitGram = [&] (TStringBuf gram) {
+                visitor(GetBucketId(CalcTokenHash(gram)));
+            };
+            ApplyFuncToLetterNGrams(
+                tokens,
+                DictionaryOptions.GramOrder,
+                DictionaryOptions.EndOfWordTokenPolicy == EEndOfWordTokenPolicy::Insert,
+                visitGram
+            );
+            return;
+        }
+
+        TVector<TTokenType> endOfSentence;
+        const auto tokensWithEndOfSentence = AppendEndOfSentenceTokenIfNeed(
+            tokens,
+            DictionaryOptions.EndOfSentenceTokenPolicy,
+            &endOfSentence
+        );
+        const ui32 gramOrder = DictionaryOptions.GramOrder;
+        const ui32 gramStep = DictionaryOptions.SkipStep + 1;
+        const ui32 endTokenIndex = GetEndTokenIndex(tokensWithEndOfSentence.Size(), gramOrder, gramStep - 1);
+        for (ui32 tokenIndex : xrange(endTokenIndex)) {
+            ui64 hash = CalcTokenHash(tokensWithEndOfSentence[tokenIndex]);
+            for (ui32 gramIndex : xrange<ui32>(1, gramOrder)) {
+                hash = CombineHashes(hash, CalcTokenHash(tokensWithEndOfSentence[tokenIndex + gramIndex * gramStep]));
+            }
+            visitor(GetBucketId(hash));
+        }
+    }
+
+    void THashingDictionary::Add(TConstArrayRef<TStringBuf> tokens) {
+        if (BucketCounts.empty()) {
+            BucketCounts.resize(BucketCount, 0);
+        }
+        VisitTokenIds(tokens, [&] (TTokenId tokenId) {
+            ++BucketCounts[tokenId - DictionaryOptions.StartTokenId];
+        });
+    }
+
+    TTokenId THashingDictionary::Apply(TStringBuf token) const {
+        return GetBucketId(CalcTokenHash(token));
+    }
+
+    void THashingDictionary::Apply(
+        TConstArrayRef<TString> tokens,
+        TVector<TTokenId>* tokenIds,
+        EUnknownTokenPolicy /*unknownTokenPolicy*/
+    ) const {
+        tokenIds->clear();
+        VisitTokenIds(tokens, [&] (TTokenId tokenId) { tokenIds->push_back(tokenId); });
+    }
+
+    void THashingDictionary::Apply(
+        TConstArrayRef<TStringBuf> tokens,
+        TVector<TTokenId>* tokenIds,
+        EUnknownTokenPolicy /*unknownTokenPolicy*/
+    ) const {
+        tokenIds->clear();
+        VisitTokenIds(tokens, [&] (TTokenId tokenId) { tokenIds->push_back(tokenId); });
+    }
+
+    ui32 THashingDictionary::Size() const {
+        return BucketCount;
+    }
+
+    TString THashingDictionary::GetToken(TTokenId tokenId) const {
+        if (tokenId == GetUnknownTokenId()) {
+            return "_UNK_";
+        }
+        CB_ENSURE(
+            DictionaryOptions.StartTokenId <= tokenId && tokenId < GetUnknownTokenId(),
+            "Invalid tokenId " << tokenId
+        );
+        return TStringBuilder() << "_BUCKET_" << tokenId - DictionaryOptions.StartTokenId << "_";
+    }
+
+    ui64 THashingDictionary::GetCount(TTokenId tokenId) const {
+        if (BucketCounts.empty() || tokenId < DictionaryOptions.StartTokenId || tokenId >= GetUnknownTokenId()) {
+            return 0;
+        }
+        return BucketCounts[tokenId - DictionaryOptions.StartTokenId];
+    }
+
+    TVector<TString> THashingDictionary::GetTopTokens(ui32 topSize) const {
+        TVector<TString> tokens;
+        for (TTokenId tokenId : GetTopTokenIds(topSize)) {
+            tokens.push_back(GetToken(tokenId));
+        }
+        return tokens;
+    }
+
+    TVector<TTokenId> THashingDictionary::GetTopTokenIds(ui32 topSize) const {
+        topSize = Min(topSize, BucketCount);
+        TVector<TTokenId> tokenIds(BucketCount);
+        Iota(tokenIds.begin(), tokenIds.end(), DictionaryOptions.StartTokenId);
+        if (!BucketCounts.empty()) {
+            PartialSort(
+                tokenIds.begin(),
+                tokenIds.begin() + topSize,
+                tokenIds.end(),
+                [&] (TTokenId lhs, TTokenId rhs) {
+                    const ui64 lhsCount = GetCount(lhs);
+                    const ui64 rhsCount = GetCount(rhs);
+                    return lhsCount > rhsCount || (lhsCount == rhsCount && lhs < rhs);
+                }
+            );
+        }
+        tokenIds.resize(topSize);
+        return tokenIds;
+    }
+
+    void THashingDictionary::ClearStatsData() {
+        BucketCounts.clear();
+        BucketCounts.shrink_to_fit();
+    }
+
+    TTokenId THashingDictionary::GetUnknownTokenId() const {
+        return DictionaryOptions.StartTokenId + BucketCount;
+    }
+
+    TTokenId THashingDictionary::GetEndOfSentenceTokenId() const {
+        return Apply(END_OF_SENTENCE_SYMBOL);
+    }
+
+    TTokenId THashingDictionary::GetMinUnusedTokenId() const {
+        return GetUnknownTokenId() + 1;
+    }
+
+    void THashingDictionary::Save(IOutputStream* stream) const {
+        ::SaveMany(stream, DictionaryOptions, BucketCount);
+    }
+
+    void THashingDictionary::Load(IInputStream* stream) {
+        ::LoadMany(stream, DictionaryOptions, BucketCount);
+        CB_ENSURE(BucketCount > 0, "Failed to deserialize: hashing dictionary has no buckets");
+        BucketCounts.clear();
+    }
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <library/cpp/text_processing/dictionary/dictionary.h>
+#include <library/cpp/text_processing/dictionary/options.h>
+
+#include <util/generic/vector.h>
+#include <util/stream/input.h>
+#include <util/stream/output.h>
+
+namespace NCB {
+
+    /* Dictionary for unbounded vocabularies (the hashing trick): every token or n-gram is mapped to one of
+     * BucketCount ids by its hash, so nothing depends on the vocabulary except the bucket counts collected
+     * while building, which are used for top tokens selection only and are not serialized.
+     * Unknown tokens never occur, different tokens may share an id.
+     */
+    class THashingDictionary final : public NTextProcessing::NDictionary::IDictionary {
+    public:
+        using TTokenId = NTextProcessing::NDictionary::TTokenId;
+        using TDictionaryOptions = NTextProcessing::NDictionary::TDictionaryOptions;
+        using EUnknownTokenPolicy = NTextProcessing::NDictionary::EUnknownTokenPolicy;
+
+    public:
+        THashingDictionary() = default;
+        THashingDictionary(const TDictionaryOptions& dictionaryOptions, ui32 bucketCount);
+
+        // accumulate bucket counts of the text tokens
+        void Add(TConstArrayRef<TStringBuf> tokens);
+
+        TTokenId Apply(TStringBuf token) const override;
+
+        void Apply(
+            TConstArrayRef<TString> tokens,
+            TVector<TTokenId>* tokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const override;
+        void Apply(
+            TConstArrayRef<TStringBuf> tokens,
+            TVector<TTokenId>* tokenIds,
+            EUnknownTokenPolicy unknownTokenPolicy = EUnknownTokenPolicy::Skip
+        ) const override;
+
+        ui32 Size() const override;
+
+        TString GetToken(TTokenId tokenId) const override;
+        ui64 GetCount(TTokenId tokenId) const override;
+        TVector<TString> GetTopTokens(ui32 topSize = 10) const override;
+
+        // most frequent bucket ids while bucket counts are available, first ids otherwise
+        TVector<TTokenId> GetTopTokenIds(ui32 topSize) const;
+
+        void ClearStatsData() override;
+
+        TTokenId GetUnknownTokenId() const override;
+        TTokenId GetEndOfSentenceTokenId() const override;
+        TTokenId GetMinUnusedTokenId() const override;
+
+        const TDictionaryOptions& GetDictionaryOptionsRef() const {
+            return DictionaryOptions;
+        }
+
+        void Save(IOutputStream* stream) const override;
+        void Load(IInputStream* stream);
+
+    private:
+        template <typename TTokenType, typename TVisitor>
+        void VisitTokenIds(TConstArrayRef<TTokenType> tokens, TVisitor&& visitor) const;
+
+        TTokenId GetBucketId(ui64 hash) const {
+            return DictionaryOptions.StartTokenId + hash % BucketCount;
+        }
+
+    private:
+        TDictionaryOptions DictionaryOptions;
+        ui32 BucketCount = 1;
+        TVector<ui64> BucketCounts;
+    };
+
+}
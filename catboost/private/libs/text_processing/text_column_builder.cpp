@@ -5,13 +5,15 @@ using namespace NCB;
 
 void TTextColumnBuilder::AddText(ui32 index, const TStringBuf text) {
     CB_ENSURE_INTERNAL(index < Texts.size(), "Text index is out of range");
-    TTokensWithBuffer tokens;
-    Tokenizer->Tokenize(text, &tokens);
-    Dictionary->Apply(tokens.View, &Texts[index]);
+    const size_t threadId = LocalExecutor ? LocalExecutor->GetWorkerThreadId() : 0;
+    CB_ENSURE_INTERNAL(threadId < Buffers.size(), "Text is added from a thread of another executor");
+    auto& buffers = Buffers[threadId];
+    Tokenizer->Tokenize(text, &buffers.Tokens);
+    Dictionary->Apply(buffers.Tokens.View, &Texts[index], &buffers.TokenIds);
 }
 
 TVector<TText> TTextColumnBuilder::Build() {
     CB_ENSURE_INTERNAL(!WasBuilt, "Build could be done only once");
     WasBuilt = true;
-    return Texts;
+    return std::move(Texts);
 }
@@ -2,6 +2,9 @@
 
 #include "text_dataset.h"
 #include "tokenizer.h"
+
+#include <library/cpp/threading/local_executor/local_executor.h>
+
 #include <array>
 #include <util/generic/fwd.h>
 
@@ -10,22 +13,41 @@ namespace NCB {
 
     class TTextColumnBuilder {
     public:
-        TTextColumnBuilder(TTokenizerPtr tokenizer, TDictionaryPtr dictionary, ui32 samplesCount)
+        /* AddText could be called in parallel for different indices from tasks of localExecutor,
+         * without localExecutor AddText can be called only sequentially
+         */
+        TTextColumnBuilder(
+            TTokenizerPtr tokenizer,
+            TDictionaryPtr dictionary,
+            ui32 samplesCount,
+            NPar::ILocalExecutor* localExecutor = nullptr)
             : Tokenizer(std::move(tokenizer))
             , Dictionary(std::move(dictionary))
             , Texts(samplesCount)
+            , LocalExecutor(localExecutor)
+            , Buffers(localExecutor ? localExecutor->GetThreadCount() + 1 : 1)
         {}
 
         void AddText(ui32 index, TStringBuf text);
 
         TVector<TText> Build();
 
+    private:
+        // reused between texts processed by the same thread to avoid allocations per text
+        struct TBuffers {
+            TTokensWithBuffer Tokens;
+            TVector<ui32> TokenIds;
+        };
+
     private:
         TTokenizerPtr Tokenizer;
         TDictionaryPtr Dictionary;
 
         TVector<TText> Texts;
 
+        NPar::ILocalExecutor* LocalExecutor;
+        TVector<TBuffers> Buffers;
+
         bool WasBuilt = false;
     };
 
@@ -84,7 +84,7 @@ namespace NCB {
                     const auto& dictionary = Digitizers.at(digitizedTextIdx).Dictionary;
                     const auto& tokenizer = Digitizers.at(digitizedTextIdx).Tokenizer;
 
-                    TTextColumnBuilder textColumnBuilder(tokenizer, dictionary, sourceText.Size());
+                    TTextColumnBuilder textColumnBuilder(tokenizer, dictionary, sourceText.Size(), localExecutor);
                     sourceText.ForEach(
                         [&](ui32 index, TStringBuf phrase) {
                             textColumnBuilder.AddText(index, phrase);
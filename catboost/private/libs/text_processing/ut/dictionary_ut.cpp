@@ -2,6 +2,8 @@
 
 #include <library/cpp/testing/unittest/registar.h>
 
+#include <util/stream/buffer.h>
+
 Y_UNIT_TEST_SUITE(TestDictionary) {
     Y_UNIT_TEST(TestBasicProperties) {
         using namespace NCB;
@@ -44,4 +46,52 @@ Y_UNIT_TEST_SUITE(TestDictionary) {
         UNIT_ASSERT_EQUAL(1u, topTokens[1]);
         UNIT_ASSERT_EQUAL(2u, topTokens[2]);
     }
+
+    Y_UNIT_TEST(TestHashingDictionary) {
+        using namespace NCB;
+        using namespace NCatboostOptions;
+
+        TVector<TString> text = {
+            "a b", "a c", "a", "d e f"
+        };
+        const auto tokensCount = [](const TText& tokenizedText) {
+            ui32 count = 0;
+            for (const auto& tokenToCount : tokenizedText) {
+                count += tokenToCount.Count();
+            }
+            return count;
+        };
+
+        TTokenizerPtr tokenizer = CreateTokenizer();
+        TTextColumnDictionaryOptions dictionaryOptions("dictionary", TDictionaryOptions());
+        dictionaryOptions.DictionaryType.Set(ETextDictionaryType::Hashing);
+        dictionaryOptions.HashBucketCount.Set(1024);
+        auto dictionary = CreateDictionary(TIterableTextFeature(text), dictionaryOptions, tokenizer);
+
+        UNIT_ASSERT_VALUES_EQUAL(1024u, dictionary->Size());
+        UNIT_ASSERT_EQUAL(TTokenId(1024), dictionary->GetUnknownTokenId());
+        UNIT_ASSERT(dictionary->Apply("unseen").Id < dictionary->Size());
+        UNIT_ASSERT_VALUES_EQUAL(2u, tokensCount(dictionary->Apply({"a", "b"})));
+
+        TVector<TTokenId> topTokens = dictionary->GetTopTokens(1);
+        UNIT_ASSERT_VALUES_EQUAL(1u, topTokens.size());
+        UNIT_ASSERT_EQUAL(dictionary->Apply("a"), topTokens[0]);
+
+        TBufferStream stream;
+        dictionary->Save(&stream);
+        TDictionaryProxy loadedDictionary;
+        loadedDictionary.Load(&stream);
+        UNIT_ASSERT_EQUAL(dictionary->Id(), loadedDictionary.Id());
+        UNIT_ASSERT_VALUES_EQUAL(dictionary->Size(), loadedDictionary.Size());
+        UNIT_ASSERT_EQUAL(dictionary->Apply("unseen"), loadedDictionary.Apply("unseen"));
+
+        TTextColumnDictionaryOptions bigramDictionaryOptions(
+            "bigram_dictionary",
+            TDictionaryOptions{NTextProcessing::NDictionary::ETokenLevelType::Word, /*GramOrder=*/2}
+        );
+        bigramDictionaryOptions.DictionaryType.Set(ETextDictionaryType::Hashing);
+        auto bigramDictionary = CreateDictionary(TIterableTextFeature(text), bigramDictionaryOptions, tokenizer);
+        UNIT_ASSERT_VALUES_EQUAL(2u, tokensCount(bigramDictionary->Apply({"d", "e", "f"})));
+        UNIT_ASSERT_VALUES_EQUAL(0u, tokensCount(bigramDictionary->Apply({"d"})));
+    }
 }
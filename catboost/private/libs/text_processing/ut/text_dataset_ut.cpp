@@ -4,6 +4,9 @@
 #include <catboost/private/libs/text_processing/text_column_builder.h>
 
 #include <library/cpp/testing/unittest/registar.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/string/cast.h>
 
 
 using namespace NCB;
@@ -73,4 +76,37 @@ Y_UNIT_TEST_SUITE(TestTextDataset) {
         UNIT_ASSERT_EQUAL(lastText.Find(haId), lastText.end());
         UNIT_ASSERT_EQUAL(lastText.Find(hoId), lastText.end());
     }
+
+    Y_UNIT_TEST(TestParallelTextColumnBuilderGivesSameTexts) {
+        TVector<TString> text;
+        for (ui32 i = 0; i < 10000; ++i) {
+            TString line;
+            for (ui32 word = 0; word < i % 7; ++word) {
+                line += ToString((i * 31 + word * 17) % 50) + " ";
+            }
+            text.push_back(line);
+        }
+        NCatboostOptions::TTextColumnDictionaryOptions options;
+        NTextProcessing::NDictionary::TDictionaryBuilderOptions builderOptions;
+        builderOptions.OccurrenceLowerBound = 1;
+        options.DictionaryBuilderOptions.Set(builderOptions);
+        TDictionaryPtr dictionary = CreateDictionary(TIterableTextFeature(text), options, tokenizer);
+
+        TTextColumnBuilder sequentialBuilder(tokenizer, dictionary, text.size());
+        for (ui32 i = 0; i < text.size(); i++) {
+            sequentialBuilder.AddText(i, text[i]);
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TTextColumnBuilder parallelBuilder(tokenizer, dictionary, text.size(), &localExecutor);
+        TIterableTextFeature(text).ForEach(
+            [&](ui32 index, TStringBuf phrase) {
+                parallelBuilder.AddText(index, phrase);
+            },
+            &localExecutor
+        );
+
+        UNIT_ASSERT(sequentialBuilder.Build() == parallelBuilder.Build());
+    }
 }
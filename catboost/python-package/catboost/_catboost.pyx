@@ -87,6 +87,14 @@ ctypedef fused numpy_indices_dtype:
     np.uint64_t
 
 
+# pandas.Categorical codes have the smallest signed type that fits all the categories
+ctypedef fused pandas_categories_codes_dtype:
+    np.int8_t
+    np.int16_t
+    np.int32_t
+    np.int64_t
+
+
 ctypedef fused numpy_num_dtype:
     np.int8_t
     np.int16_t
@@ -777,6 +785,17 @@ cdef extern from "catboost/private/libs/algo/apply.h":
         int threadCount
     ) nogil except +ProcessException
 
+    cdef void ApplyModelToFlatFloatFeatures(
+        const TFullModel& model,
+        TConstArrayRef[float] features,
+        size_t featureCount,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount,
+        TArrayRef[double] results
+    ) nogil except +ProcessException
+
     cdef TVector[TVector[double]] ApplyUncertaintyPredictions(
         const TFullModel& calcer,
         const TDataProvider& objectsData,
@@ -2652,6 +2671,24 @@ cdef object _set_features_order_data_pd_data_frame_sparse_column(
     return new_data_holders
 
 
+# returns the index of the first object with a missing category or doc_count if there are none
+cdef ui32 _map_categories_codes_to_hashed_cat_values(
+    const pandas_categories_codes_dtype[:] categories_codes,
+    TConstArrayRef[ui32] categories_as_hashed_cat_values,
+    TArrayRef[ui32] hashed_cat_values
+) nogil:
+    cdef ui32 doc_count = categories_codes.shape[0]
+    cdef ui32 doc_idx
+    cdef pandas_categories_codes_dtype category_code
+
+    for doc_idx in range(doc_count):
+        category_code = categories_codes[doc_idx]
+        if category_code == -1:
+            return doc_idx
+        hashed_cat_values[doc_idx] = categories_as_hashed_cat_values[category_code]
+    return doc_count
+
+
 cdef _set_features_order_data_pd_data_frame_categorical_column(
     ui32 flat_feature_idx,
     object column_values, # pd.Categorical, but Cython requires cimport to provide type here
@@ -2672,8 +2709,7 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
     cdef TVector[ui32] hashed_cat_values
 
     cdef ui32 category_idx
-    cdef ui32 doc_idx
-    cdef i32 category_code
+    cdef ui32 missing_category_doc_idx
 
 
     # TODO(akhropov): make yresize accessible in Cython
@@ -2696,16 +2732,39 @@ cdef _set_features_order_data_pd_data_frame_categorical_column(
 
     # TODO(akhropov): make yresize accessible in Cython
     hashed_cat_values.resize(doc_count)
-    for doc_idx in range(doc_count):
-        category_code = categories_codes[doc_idx]
-        if category_code == -1:
-            raise CatBoostError(
-                'Invalid type for cat_feature[object_idx={},feature_idx={}]=NaN :'
-                ' cat_features must be integer or string, real number values and NaN values'
-                ' should be converted to string.'.format(doc_idx, flat_feature_idx)
-            )
 
-        hashed_cat_values[doc_idx] = categories_as_hashed_cat_values_ref[category_code]
+    # codes are mapped through typed memoryviews, without access to Python objects for each object
+    if categories_codes.dtype == np.int8:
+        missing_category_doc_idx = _map_categories_codes_to_hashed_cat_values[np.int8_t](
+            categories_codes,
+            <TConstArrayRef[ui32]>categories_as_hashed_cat_values[0],
+            <TArrayRef[ui32]>hashed_cat_values
+        )
+    elif categories_codes.dtype == np.int16:
+        missing_category_doc_idx = _map_categories_codes_to_hashed_cat_values[np.int16_t](
+            categories_codes,
+            <TConstArrayRef[ui32]>categories_as_hashed_cat_values[0],
+            <TArrayRef[ui32]>hashed_cat_values
+        )
+    elif categories_codes.dtype == np.int32:
+        missing_category_doc_idx = _map_categories_codes_to_hashed_cat_values[np.int32_t](
+            categories_codes,
+            <TConstArrayRef[ui32]>categories_as_hashed_cat_values[0],
+            <TArrayRef[ui32]>hashed_cat_values
+        )
+    else:
+        missing_category_doc_idx = _map_categories_codes_to_hashed_cat_values[np.int64_t](
+            np.asarray(categories_codes, dtype=np.int64),
+            <TConstArrayRef[ui32]>categories_as_hashed_cat_values[0],
+            <TArrayRef[ui32]>hashed_cat_values
+        )
+
+    if missing_category_doc_idx != doc_count:
+        raise CatBoostError(
+            'Invalid type for cat_feature[object_idx={},feature_idx={}]=NaN :'
+            ' cat_features must be integer or string, real number values and NaN values'
+            ' should be converted to string.'.format(missing_category_doc_idx, flat_feature_idx)
+        )
 
     builder_visitor[0].AddCatFeature(
         flat_feature_idx,
@@ -4797,6 +4856,53 @@ cdef class _CatBoost:
 
         return transform_predictions(pred, predictionType, thread_count, self.__model)
 
+    cpdef _get_dimensions_count(self):
+        return dereference(self.__model).GetDimensionsCount()
+
+    cpdef _base_predict_flat_float_features(self, np.ndarray data, str prediction_type, int ntree_start, int ntree_end, int thread_count, out):
+        cdef const np.float32_t[:, ::1] features = data
+        cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
+        cdef size_t object_count = features.shape[0]
+        cdef size_t feature_count = features.shape[1]
+        cdef size_t approx_dimension = dereference(self.__model).GetDimensionsCount()
+        if out is None:
+            out = np.empty((object_count, approx_dimension) if approx_dimension > 1 else object_count, dtype=np.float64)
+        elif not (
+            isinstance(out, np.ndarray)
+            and out.dtype == np.float64
+            and out.flags.c_contiguous
+            and out.flags.writeable
+            and out.size == object_count * approx_dimension
+        ):
+            raise CatBoostError(
+                "out should be a writeable C-contiguous numpy.ndarray of float64 with {} elements".format(
+                    object_count * approx_dimension
+                )
+            )
+        cdef double[::1] results = out.reshape(-1)
+
+        cdef TConstArrayRef[float] features_ref
+        if object_count and feature_count:
+            features_ref = TConstArrayRef[float](<const float*>&features[0, 0], object_count * feature_count)
+        cdef TArrayRef[double] results_ref
+        if object_count:
+            results_ref = TArrayRef[double](&results[0], object_count * approx_dimension)
+
+        thread_count = UpdateThreadCount(thread_count)
+        dereference(self.__model).SetEvaluatorType(EFormulaEvaluatorType_CPU)
+        with nogil:
+            ApplyModelToFlatFloatFeatures(
+                dereference(self.__model),
+                features_ref,
+                feature_count,
+                predictionType,
+                ntree_start,
+                ntree_end,
+                thread_count,
+                results_ref
+            )
+        return out
+
     cpdef _base_virtual_ensembles_predict(self, _PoolBase pool, str prediction_type, int ntree_end, int virtual_ensembles_count, int thread_count, bool_t verbose):
             cdef TVector[TVector[double]] pred
             cdef EPredictionType predictionType = string_to_prediction_type(prediction_type)
@@ -24,9 +24,9 @@ cdef extern from "catboost/python-package/catboost/monoforest_helpers.h" namespa
 
 
 cdef extern from "catboost/python-package/catboost/monoforest_helpers.h" namespace "NMonoForest":
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel) except +ProcessException
-    TVector[THumanReadableMonom] ConvertFullModelToPolynom(const TFullModel& fullModel) except +ProcessException
-    TVector[TFeatureExplanation] ExplainFeatures(const TFullModel& fullModel) except +ProcessException
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount) except +ProcessException
+    TVector[THumanReadableMonom] ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount) except +ProcessException
+    TVector[TFeatureExplanation] ExplainFeatures(const TFullModel& fullModel, int threadCount) except +ProcessException
 
 
 class Split:
@@ -115,8 +115,9 @@ class FeatureExplanation:
         return borders, values
 
 
-cpdef to_polynom(model):
-    cdef TVector[THumanReadableMonom] monoms = ConvertFullModelToPolynom(dereference((<_CatBoost>model).__model))
+cpdef to_polynom(model, thread_count=-1):
+    thread_count = UpdateThreadCount(thread_count)
+    cdef TVector[THumanReadableMonom] monoms = ConvertFullModelToPolynom(dereference((<_CatBoost>model).__model), thread_count)
     python_monoms = []
     for monom in monoms:
         python_splits = []
@@ -130,12 +131,14 @@ cpdef to_polynom(model):
     return python_monoms
 
 
-cpdef to_polynom_string(model):
-    return to_native_str(ConvertFullModelToPolynomString(dereference((<_CatBoost>model).__model)))
+cpdef to_polynom_string(model, thread_count=-1):
+    thread_count = UpdateThreadCount(thread_count)
+    return to_native_str(ConvertFullModelToPolynomString(dereference((<_CatBoost>model).__model), thread_count))
 
 
-cpdef explain_features(model):
-    cdef TVector[TFeatureExplanation] featuresExplanations = ExplainFeatures(dereference((<_CatBoost>model).__model))
+cpdef explain_features(model, thread_count=-1):
+    thread_count = UpdateThreadCount(thread_count)
+    cdef TVector[TFeatureExplanation] featuresExplanations = ExplainFeatures(dereference((<_CatBoost>model).__model), thread_count)
     result = []
     for featureExpl in featuresExplanations:
         borders = []
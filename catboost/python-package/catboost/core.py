@@ -1774,6 +1774,9 @@ class _CatBoostBase(object):
     def _base_predict(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose, task_type):
         return self._object._base_predict(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose, task_type)
 
+    def _base_predict_flat_float_features(self, data, prediction_type, ntree_start, ntree_end, thread_count, out):
+        return self._object._base_predict_flat_float_features(data, prediction_type, ntree_start, ntree_end, thread_count, out)
+
     def _base_virtual_ensembles_predict(self, pool, prediction_type, ntree_end, virtual_ensembles_count, thread_count, verbose):
         return self._object._base_virtual_ensembles_predict(pool, prediction_type, ntree_end, virtual_ensembles_count, thread_count, verbose)
 
@@ -2498,7 +2501,43 @@ class CatBoost(_CatBoostBase):
         if prediction_type not in valid_prediction_types:
             raise CatBoostError("Invalid value of prediction_type={}: must be {}.".format(prediction_type, ', '.join(valid_prediction_types)))
 
-    def _predict(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose, parent_method_name, task_type="CPU"):
+    def _is_float_features_matrix_predict_supported(self, data, prediction_type, task_type):
+        return (
+            isinstance(data, np.ndarray)
+            and (data.ndim == 2)
+            and (data.dtype == np.float32)
+            and data.flags.c_contiguous
+            and (task_type == "CPU")
+            and (prediction_type in ('RawFormulaVal', 'Exponent'))
+            and self.is_fitted()
+            and not self._get_cat_feature_indices()
+            and not self._get_text_feature_indices()
+            and not self._get_embedding_feature_indices()
+        )
+
+    def _predict_on_float_features_matrix(self, data, prediction_type, ntree_start, ntree_end, thread_count, parent_method_name, task_type, out):
+        if not self.is_fitted() or self.tree_count_ is None:
+            raise CatBoostError(("There is no trained model to use {}(). "
+                                 "Use fit() to train model. Then use this method.").format(parent_method_name))
+        if not self._is_float_features_matrix_predict_supported(data, prediction_type, task_type):
+            raise CatBoostError(
+                ("{}() with out parameter is supported only for C-contiguous two-dimensional numpy.ndarray of float32 data, "
+                 "'RawFormulaVal' or 'Exponent' prediction_type, 'CPU' task_type and models without categorical, "
+                 "text and embedding features").format(parent_method_name)
+            )
+        return self._base_predict_flat_float_features(data, prediction_type, ntree_start, ntree_end, thread_count, out)
+
+    def _predict(self, data, prediction_type, ntree_start, ntree_end, thread_count, verbose, parent_method_name, task_type="CPU", out=None):
+        # dense float32 matrices are applied directly, without Pool creation and predictions copying
+        if out is not None:
+            return self._predict_on_float_features_matrix(
+                data, prediction_type, ntree_start, ntree_end, thread_count, parent_method_name, task_type, out
+            )
+        if self._is_float_features_matrix_predict_supported(data, prediction_type, task_type) and (self._object._get_dimensions_count() == 1):
+            return self._predict_on_float_features_matrix(
+                data, prediction_type, ntree_start, ntree_end, thread_count, parent_method_name, task_type, None
+            )
+
         verbose = verbose or self.get_param('verbose')
         if verbose is None:
             verbose = False
@@ -2508,7 +2547,7 @@ class CatBoost(_CatBoostBase):
         predictions = self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, task_type)
         return predictions[0] if data_is_single_object else predictions
 
-    def predict(self, data, prediction_type='RawFormulaVal', ntree_start=0, ntree_end=0, thread_count=-1, verbose=None, task_type="CPU"):
+    def predict(self, data, prediction_type='RawFormulaVal', ntree_start=0, ntree_end=0, thread_count=-1, verbose=None, task_type="CPU", out=None):
         """
         Predict with data.
 
@@ -2544,6 +2583,13 @@ class CatBoost(_CatBoostBase):
         verbose : bool, optional (default=False)
             If True, writes the evaluation metric measured set to stderr.
 
+        out : numpy.ndarray, optional (default=None)
+            Preallocated C-contiguous numpy.ndarray of float64 with number_of_objects x prediction_dimension elements
+            to write predictions to, it is returned as the prediction.
+            Supported only for C-contiguous two-dimensional numpy.ndarray of float32 data, 'RawFormulaVal' and
+            'Exponent' prediction types, 'CPU' task_type and models without categorical, text and embedding features.
+            Such data is applied without Pool creation even if out is not specified.
+
         Returns
         -------
         prediction :
@@ -2557,7 +2603,7 @@ class CatBoost(_CatBoostBase):
                 - 'Probability' : two-dimensional numpy.ndarray with shape (number_of_objects x number_of_classes)
                   with probability for every class for each object.
         """
-        return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict', task_type)
+        return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict', task_type, out)
 
     def _virtual_ensembles_predict(self, data, prediction_type, ntree_end, virtual_ensembles_count, thread_count, verbose, parent_method_name):
         verbose = verbose or self.get_param('verbose')
@@ -5698,7 +5744,7 @@ class CatBoostRegressor(CatBoost):
                          verbose_eval, metric_period, silent, early_stopping_rounds,
                          save_snapshot, snapshot_file, snapshot_interval, init_model, callbacks, log_cout, log_cerr)
 
-    def predict(self, data, prediction_type=None, ntree_start=0, ntree_end=0, thread_count=-1, verbose=None, task_type="CPU"):
+    def predict(self, data, prediction_type=None, ntree_start=0, ntree_end=0, thread_count=-1, verbose=None, task_type="CPU", out=None):
         """
         Predict with data.
 
@@ -5730,6 +5776,13 @@ class CatBoostRegressor(CatBoost):
         verbose : bool
             If True, writes the evaluation metric measured set to stderr.
 
+        out : numpy.ndarray, optional (default=None)
+            Preallocated C-contiguous numpy.ndarray of float64 with number_of_objects x prediction_dimension elements
+            to write predictions to, it is returned as the prediction.
+            Supported only for C-contiguous two-dimensional numpy.ndarray of float32 data, 'RawFormulaVal' and
+            'Exponent' prediction types, 'CPU' task_type and models without categorical, text and embedding features.
+            Such data is applied without Pool creation even if out is not specified.
+
         Returns
         -------
         prediction :
@@ -5738,7 +5791,7 @@ class CatBoostRegressor(CatBoost):
         """
         if prediction_type is None:
             prediction_type = self._get_default_prediction_type()
-        return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict', task_type)
+        return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict', task_type, out)
 
     def staged_predict(self, data, prediction_type='RawFormulaVal', ntree_start=0, ntree_end=0, eval_period=1, thread_count=-1, verbose=None):
         """
@@ -13,23 +13,23 @@ def _check_model(model):
         raise CatBoostError("Model should be CatBoost")
 
 
-def to_polynom(model):
+def to_polynom(model, thread_count=-1):
     _check_model(model)
-    return _catboost.to_polynom(model._object)
+    return _catboost.to_polynom(model._object, thread_count)
 
 
-def to_polynom_string(model):
+def to_polynom_string(model, thread_count=-1):
     _check_model(model)
-    return _catboost.to_polynom_string(model._object)
+    return _catboost.to_polynom_string(model._object, thread_count)
 
 
-def explain_features(model):
+def explain_features(model, thread_count=-1):
     _check_model(model)
-    return _catboost.explain_features(model._object)
+    return _catboost.explain_features(model._object, thread_count)
 
 
-def calc_features_strength(model):
-    explanations = explain_features(model)
+def calc_features_strength(model, thread_count=-1):
+    explanations = explain_features(model, thread_count)
     features_strength = [expl.calc_strength() for expl in explanations]
     return features_strength
 
@@ -6,17 +6,15 @@
 #include <catboost/libs/monoforest/polynom.h>
 
 namespace NMonoForest {
-    static TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel) {
-        TPolynomBuilder polynomBuilder;
-        for (auto idx : xrange(additiveModel.Size())) {
-            polynomBuilder.AddTree(additiveModel.GetWeakModel(idx));
-        }
-        return polynomBuilder.Build();
+    static TPolynom BuildPolynom(const TAdditiveModel<TObliviousTree>& additiveModel, int threadCount) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(threadCount - 1);
+        return BuildPolynom(additiveModel, &localExecutor);
     }
 
-    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel) {
+    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         TVector<THumanReadableMonom> monoms;
         monoms.reserve(polynom.MonomsEnsemble.size());
         const IGrid& grid = importer->GetGrid();
@@ -36,15 +34,15 @@ namespace NMonoForest {
         return monoms;
     }
 
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel) {
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         return ToHumanReadableString(polynom, importer->GetGrid());
     }
 
-    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel) {
+    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel, int threadCount) {
         const auto importer = MakeCatBoostImporter(fullModel);
-        const TPolynom polynom = BuildPolynom(importer->GetModel());
+        const TPolynom polynom = BuildPolynom(importer->GetModel(), threadCount);
         return ExplainFeatures(polynom, importer->GetGrid());
     }
 }
@@ -22,7 +22,7 @@ namespace NMonoForest {
     // to manage with weak support of namespaces in Cython
     using EMonoForestFeatureType = EFeatureType;
 
-    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel);
-    TString ConvertFullModelToPolynomString(const TFullModel& fullModel);
-    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel);
+    TVector<THumanReadableMonom> ConvertFullModelToPolynom(const TFullModel& fullModel, int threadCount);
+    TString ConvertFullModelToPolynomString(const TFullModel& fullModel, int threadCount);
+    TVector<TFeatureExplanation> ExplainFeatures(const TFullModel& fullModel, int threadCount);
 }
@@ -2,11 +2,15 @@
 
 #include <catboost/libs/cat_feature/cat_feature.h>
 
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/enums.h>
 #include <catboost/libs/model/model.h>
 
+#include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/fwd.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 
 
 template <class T>
@@ -32,3 +36,76 @@ void CalcOnSparkFeatureVector(
     }
     model.Calc(floatFeaturesValues, catFeaturesValues, result);
 }
+
+
+/* Calc on a whole batch of objects passed in a columnar layout
+ * @param featureColumnsFromSpark is [flatFeatureIdx * objectCount + objectIdx]
+ * @param result is [objectIdx * modelDimensionsCount + dimensionIdx]
+ */
+template <class T>
+void CalcOnSparkFeatureColumns(
+    const TFullModel& model,
+    i32 objectCount,
+    TConstArrayRef<T> featureColumnsFromSpark,
+    TArrayRef<double> result
+) {
+    CB_ENSURE(objectCount >= 0, "Negative object count specified");
+    if (objectCount == 0) {
+        return;
+    }
+    CB_ENSURE(
+        !model.GetNumTextFeatures() && !model.GetNumEmbeddingFeatures(),
+        "Columnar model application is not supported for models with text or embedding features"
+    );
+    CB_ENSURE(
+        featureColumnsFromSpark.size() % objectCount == 0,
+        "Feature columns data size is not a multiple of object count"
+    );
+    const size_t columnCount = featureColumnsFromSpark.size() / objectCount;
+    CB_ENSURE(
+        columnCount >= model.ModelTrees->GetFlatFeatureVectorExpectedSize(),
+        "Not enough features: model expects " << model.ModelTrees->GetFlatFeatureVectorExpectedSize()
+        << ", got " << columnCount
+    );
+    CB_ENSURE(
+        result.size() == size_t(objectCount) * model.GetDimensionsCount(),
+        "Result size is not equal to object count multiplied by model dimensions count"
+    );
+
+    auto getColumn = [&] (size_t flatFeatureIdx) {
+        return featureColumnsFromSpark.Slice(flatFeatureIdx * objectCount, objectCount);
+    };
+
+    const TVector<float> unusedFeatureColumn(objectCount, 0.0f);
+    TVector<TConstArrayRef<float>> flatFeatureColumns(
+        model.ModelTrees->GetFlatFeatureVectorExpectedSize(),
+        unusedFeatureColumn
+    );
+
+    TVector<TVector<float>> convertedColumns;
+    convertedColumns.reserve(model.GetNumFloatFeatures() + model.GetNumCatFeatures());
+
+    for (const auto& floatFeatureMetaData : model.ModelTrees->GetFloatFeatures()) {
+        const auto column = getColumn(floatFeatureMetaData.Position.FlatIndex);
+        auto& convertedColumn = convertedColumns.emplace_back();
+        convertedColumn.yresize(objectCount);
+        for (auto objectIdx : xrange(objectCount)) {
+            convertedColumn[objectIdx] = column[objectIdx];
+        }
+        flatFeatureColumns[floatFeatureMetaData.Position.FlatIndex] = convertedColumn;
+    }
+
+    // categorical features values in Spark are indices, their hashes are passed as float bits
+    for (const auto& catFeatureMetaData : model.ModelTrees->GetCatFeatures()) {
+        const auto column = getColumn(catFeatureMetaData.Position.FlatIndex);
+        auto& convertedColumn = convertedColumns.emplace_back();
+        convertedColumn.yresize(objectCount);
+        for (auto objectIdx : xrange(objectCount)) {
+            const int hash = CalcCatFeatureHashInt(ToString(int(column[objectIdx])));
+            convertedColumn[objectIdx] = BitCast<float>(hash);
+        }
+        flatFeatureColumns[catFeatureMetaData.Position.FlatIndex] = convertedColumn;
+    }
+
+    model.CalcFlatTransposed(flatFeatureColumns, result);
+}
@@ -39,6 +39,12 @@
     TArrayRef<double> result
 ) const;
 
+%catches(yexception, std::exception) TFullModel::CalcColumnar(
+    i32 objectCount,
+    TConstArrayRef<double> featureColumnsFromSpark,
+    TArrayRef<double> result
+) const;
+
 %catches(yexception, std::exception) TFullModel::Save(
     const TString& fileName,
     EModelType format,
@@ -82,6 +88,18 @@ public:
             }
             CalcOnSparkFeatureVector<float>(*self, denseFeaturesValues, result);
         }
+
+        /* Calc on a batch of objectCount objects at once
+         * @param featureColumnsFromSpark is [flatFeatureIdx * objectCount + objectIdx]
+         * @param result is [objectIdx * dimensionsCount + dimensionIdx]
+         */
+        void CalcColumnar(
+            i32 objectCount,
+            TConstArrayRef<double> featureColumnsFromSpark,
+            TArrayRef<double> result
+        ) const {
+            CalcOnSparkFeatureColumns(*self, objectCount, featureColumnsFromSpark, result);
+        }
         
         void Save(
             const TString& fileName,
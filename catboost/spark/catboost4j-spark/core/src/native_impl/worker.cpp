@@ -1,4 +1,5 @@
 #include "worker.h"
+#include "quantization.h"
 
 #include <catboost/private/libs/algo/data.h>
 #include <catboost/private/libs/distributed/data_types.h>
@@ -125,3 +126,43 @@ void CreateTrainingDataForWorker(
     }
 }
 
+
+void CreateTrainingDataForWorkerFromRawData(
+    i32 hostId,
+    i32 numThreads,
+    const TString& plainJsonParamsAsString,
+    const TVector<i8>& serializedLabelConverter,
+    TVector<TDataProviderPtr>* rawTrainDataProviders, // objects data is quantized in place
+    NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    const TVector<TDataProviderPtr>& trainEstimatedDataProviders, // can be empty
+    const TString& precomputedOnlineCtrMetaDataAsJsonString
+) {
+    CB_ENSURE(numThreads >= 1, "Non-positive number of threads specified");
+
+    NPar::TLocalExecutor* localExecutor = &NPar::LocalExecutor();
+    if ((localExecutor->GetThreadCount() + 1) < numThreads) {
+        localExecutor->RunAdditionalThreads(numThreads - 1);
+    }
+
+    CATBOOST_DEBUG_LOG << "Quantize train data for worker " << hostId << "..." << Endl;
+    for (auto i : xrange(rawTrainDataProviders->size())) {
+        TDataProviderPtr& dataProvider = (*rawTrainDataProviders)[i];
+        TRawObjectsDataProviderPtr rawObjectsData
+            = dynamic_cast<TRawObjectsDataProvider*>(dataProvider->ObjectsData.Get());
+        CB_ENSURE_INTERNAL(rawObjectsData, "Train data #" << i << ": Non-raw objects data specified");
+        dataProvider->ObjectsData.Reset(); // so raw data can be released during quantization
+
+        dataProvider->ObjectsData = Quantize(quantizedFeaturesInfo, &rawObjectsData, localExecutor);
+    }
+
+    CreateTrainingDataForWorker(
+        hostId,
+        numThreads,
+        plainJsonParamsAsString,
+        serializedLabelConverter,
+        *rawTrainDataProviders,
+        quantizedFeaturesInfo,
+        trainEstimatedDataProviders,
+        precomputedOnlineCtrMetaDataAsJsonString
+    );
+}
@@ -20,3 +20,18 @@ void CreateTrainingDataForWorker(
     const TVector<NCB::TDataProviderPtr>& trainEstimatedDataProviders, // can be empty
     const TString& precomputedOnlineCtrMetaDataAsJsonString
 );
+
+/* Same as CreateTrainingDataForWorker but trainDataProviders contain raw objects data of this partition.
+ * It is quantized in place with broadcast quantizedFeaturesInfo (that must contain all borders)
+ *  so the data is passed to the worker without intermediate quantized pool serialization.
+ */
+void CreateTrainingDataForWorkerFromRawData(
+    i32 hostId,
+    i32 numThreads,
+    const TString& plainJsonParamsAsString,
+    const TVector<i8>& serializedLabelConverter,
+    TVector<NCB::TDataProviderPtr>* rawTrainDataProviders, // objects data is quantized in place
+    NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    const TVector<NCB::TDataProviderPtr>& trainEstimatedDataProviders, // can be empty
+    const TString& precomputedOnlineCtrMetaDataAsJsonString
+);
@@ -30,4 +30,15 @@ void RunWorker(ui32 numThreads, ui32 nodePort);
     const TString& precomputedOnlineCtrMetaDataAsJsonString
 );
 
+%catches(yexception) CreateTrainingDataForWorkerFromRawData(
+    i32 hostId,
+    i32 numThreads,
+    const TString& plainJsonParamsAsString,
+    const TVector<i8>& serializedLabelConverter,
+    TVector<NCB::TDataProviderPtr>* rawTrainDataProviders, // objects data is quantized in place
+    NCB::TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    const TVector<NCB::TDataProviderPtr>& trainEstimatedDataProviders, // can be empty
+    const TString& precomputedOnlineCtrMetaDataAsJsonString
+);
+
 %include "worker.h"
@@ -0,0 +1,613 @@
+#include "measure.h"
+#include "synthetic_data.h"
+
+#include <catboost/private/libs/algo/ctr_helper.h>
+#include <catboost/private/libs/algo/online_ctr.h>
+#include <catboost/private/libs/algo/projection.h>
+#include <catboost/private/libs/algo_helpers/scratch_cache.h>
+#include <catboost/private/libs/options/binarization_options.h>
+#include <catboost/private/libs/options/cat_feature_options.h>
+#include <catboost/private/libs/quantized_pool/serialization.h>
+
+#include <catboost/libs/data/data_provider.h>
+#include <catboost/libs/data/load_data.h>
+#include <catboost/libs/data/objects_grouping.h>
+#include <catboost/libs/data/quantization.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <library/cpp/containers/2d_array/2d_array.h>
+#include <library/cpp/getopt/small/last_getopt.h>
+#include <library/cpp/json/json_value.h>
+#include <library/cpp/json/json_writer.h>
+#include <library/cpp/threading/local_executor/local_executor.h>
+
+#include <util/folder/path.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/maybe.h>
+#include <util/generic/serialized_enum.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+#include <util/system/fstat.h>
+#include <util/system/hp_timer.h>
+#include <util/system/info.h>
+#include <util/system/tempfile.h>
+
+#include <functional>
+
+
+using namespace NCB;
+
+
+struct TCMDOptions {
+    TSyntheticDataParams DataParams;
+    ui32 BorderCount = 254;
+    int ThreadCount = SafeIntegerCast<int>(NSystemInfo::CachedNumberOfCpus());
+    size_t RepetitionCount = 3;
+    TVector<TString> CaseNames; // all if empty
+    TString TmpDir = ".";
+    TString OutputJsonPath;
+};
+
+
+static TDataProviderPtr ReadBenchDataset(
+    const TPathWithScheme& poolPath,
+    const TPathWithScheme& cdPath, // can be uninited
+    NPar::ILocalExecutor* localExecutor
+) {
+    NCatboostOptions::TColumnarPoolFormatParams columnarPoolFormatParams;
+    columnarPoolFormatParams.CdFilePath = cdPath;
+    return ReadDataset(
+        /*taskType*/Nothing(),
+        poolPath,
+        /*pairsFilePath*/TPathWithScheme(),
+        /*groupWeightsFilePath*/TPathWithScheme(),
+        /*timestampsFilePath*/TPathWithScheme(),
+        /*baselineFilePath*/TPathWithScheme(),
+        /*featureNamesFilePath*/TPathWithScheme(),
+        /*poolMetaInfoFilePath*/TPathWithScheme(),
+        columnarPoolFormatParams,
+        /*ignoredFeatures*/TVector<ui32>(),
+        EObjectsOrder::Undefined,
+        TDatasetSubset::MakeColumns(),
+        /*forceUnitAutoPairWeights*/ false,
+        /*classLabels*/ Nothing(),
+        localExecutor
+    );
+}
+
+static ui64 GetFileSize(const TString& path) {
+    return TFileStat(path).Size;
+}
+
+
+// stores only the data of the last projection, it is enough to measure computation speed
+class TBenchCtrDataWriter final : public IOnlineCtrProjectionDataWriter {
+public:
+    explicit TBenchCtrDataWriter(size_t objectCount)
+        : ObjectCount(objectCount)
+    {}
+
+    void SetUniqValuesCounts(const TOnlineCtrUniqValuesCounts& uniqValuesCounts) override {
+        Y_UNUSED(uniqValuesCounts);
+    }
+
+    void AllocateData(size_t ctrCount) override {
+        Data.resize(ctrCount);
+    }
+
+    void AllocateCtrData(size_t ctrIdx, size_t targetBorderCount, size_t priorCount) override {
+        auto& ctrData = Data[ctrIdx];
+        ctrData.SetSizes(priorCount, targetBorderCount);
+        for (auto targetBorderIdx : xrange(targetBorderCount)) {
+            for (auto priorIdx : xrange(priorCount)) {
+                ctrData[targetBorderIdx][priorIdx].yresize(ObjectCount);
+            }
+        }
+    }
+
+    TArrayRef<ui8> GetDataBuffer(int ctrIdx, int targetBorderIdx, int priorIdx, int datasetIdx) override {
+        Y_ASSERT(datasetIdx == 0);
+        return Data[ctrIdx][targetBorderIdx][priorIdx];
+    }
+
+private:
+    size_t ObjectCount;
+    TVector<TArray2D<TVector<ui8>>> Data; // [ctrIdx][targetBorderIdx][priorIdx][objectIdx]
+};
+
+
+/*
+ * Synthetic dataset files and datasets used as inputs of the measured operations.
+ * Everything is prepared on the first request, so preparation is not included in measured times.
+ */
+class TBenchData {
+public:
+    TBenchData(const TCMDOptions& options, NPar::ILocalExecutor* localExecutor)
+        : Options(options)
+        , LocalExecutor(localExecutor)
+        , Labels(GenerateLabels(options.DataParams))
+        , DsvFile((TFsPath(options.TmpDir) / "data_perftest.tsv").GetPath())
+        , CdFile((TFsPath(options.TmpDir) / "data_perftest.cd").GetPath())
+        , LibSvmFile((TFsPath(options.TmpDir) / "data_perftest.libsvm").GetPath())
+        , QuantizedFile((TFsPath(options.TmpDir) / "data_perftest.qbin").GetPath())
+    {}
+
+    size_t GetObjectCount() const {
+        return Labels.size();
+    }
+
+    const TString& GetDsvPath() {
+        if (!DsvGenerated) {
+            GenerateDsvDataset(Options.DataParams, Labels, DsvFile.Name(), CdFile.Name());
+            DsvGenerated = true;
+        }
+        return DsvFile.Name();
+    }
+
+    const TString& GetCdPath() {
+        GetDsvPath();
+        return CdFile.Name();
+    }
+
+    const TString& GetLibSvmPath() {
+        if (!LibSvmGenerated) {
+            GenerateLibSvmDataset(Options.DataParams, Labels, LibSvmFile.Name());
+            LibSvmGenerated = true;
+        }
+        return LibSvmFile.Name();
+    }
+
+    const TString& GetQuantizedPath() {
+        if (!QuantizedGenerated) {
+            SaveQuantizedPool(
+                QuantizeDsvData(EBorderSelectionType::GreedyLogSum)->CastMoveTo<TObjectsDataProvider>(),
+                QuantizedFile.Name()
+            );
+            QuantizedGenerated = true;
+        }
+        return QuantizedFile.Name();
+    }
+
+    TDataProviderPtr ReadDsv() {
+        return ReadBenchDataset(
+            TPathWithScheme(GetDsvPath(), "dsv"),
+            TPathWithScheme(GetCdPath(), "dsv"),
+            LocalExecutor
+        );
+    }
+
+    TDataProviderPtr ReadLibSvm() {
+        return ReadBenchDataset(TPathWithScheme(GetLibSvmPath(), "libsvm"), TPathWithScheme(), LocalExecutor);
+    }
+
+    TDataProviderPtr ReadQuantized() {
+        return ReadBenchDataset(TPathWithScheme(GetQuantizedPath(), "quantized"), TPathWithScheme(), LocalExecutor);
+    }
+
+    TRawDataProviderPtr GetRawDsvData() {
+        if (!RawDsvData) {
+            RawDsvData = ReadDsv()->CastMoveTo<TRawObjectsDataProvider>();
+            CB_ENSURE_INTERNAL(RawDsvData, "Dsv dataset is not raw");
+        }
+        return RawDsvData;
+    }
+
+    TRawDataProviderPtr GetRawLibSvmData() {
+        if (!RawLibSvmData) {
+            RawLibSvmData = ReadLibSvm()->CastMoveTo<TRawObjectsDataProvider>();
+            CB_ENSURE_INTERNAL(RawLibSvmData, "Libsvm dataset is not raw");
+        }
+        return RawLibSvmData;
+    }
+
+    TQuantizedDataProviderPtr GetQuantizedDsvData() {
+        if (!QuantizedDsvData) {
+            QuantizedDsvData = QuantizeDsvData(EBorderSelectionType::GreedyLogSum);
+        }
+        return QuantizedDsvData;
+    }
+
+    TQuantizedDataProviderPtr QuantizeDsvData(EBorderSelectionType borderSelectionType) {
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.BundleExclusiveFeatures = false;
+        return Quantize(GetRawDsvData(), borderSelectionType, quantizationOptions);
+    }
+
+    TQuantizedDataProviderPtr QuantizeLibSvmData(bool bundleExclusiveFeatures) {
+        TQuantizationOptions quantizationOptions;
+        quantizationOptions.BundleExclusiveFeatures = bundleExclusiveFeatures;
+        return Quantize(GetRawLibSvmData(), EBorderSelectionType::GreedyLogSum, quantizationOptions);
+    }
+
+    const TVector<float>& GetLabels() const {
+        return Labels;
+    }
+
+private:
+    TQuantizedDataProviderPtr Quantize(
+        TRawDataProviderPtr rawData,
+        EBorderSelectionType borderSelectionType,
+        const TQuantizationOptions& quantizationOptions
+    ) {
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            *rawData->MetaInfo.FeaturesLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions(borderSelectionType, Options.BorderCount, ENanMode::Min)
+        );
+        TRestorableFastRng64 rand(Options.DataParams.Seed);
+        return NCB::Quantize(quantizationOptions, rawData, quantizedFeaturesInfo, &rand, LocalExecutor);
+    }
+
+private:
+    const TCMDOptions& Options;
+    NPar::ILocalExecutor* LocalExecutor;
+    TVector<float> Labels;
+
+    TTempFile DsvFile;
+    TTempFile CdFile;
+    TTempFile LibSvmFile;
+    TTempFile QuantizedFile;
+    bool DsvGenerated = false;
+    bool LibSvmGenerated = false;
+    bool QuantizedGenerated = false;
+
+    TRawDataProviderPtr RawDsvData;
+    TRawDataProviderPtr RawLibSvmData;
+    TQuantizedDataProviderPtr QuantizedDsvData;
+};
+
+
+struct TBenchCase {
+    TString Name;
+
+    // prepares the inputs and returns the size of the source text data to calculate MB/s
+    std::function<ui64()> Prepare;
+
+    std::function<void()> Run;
+};
+
+static TVector<TBenchCase> GetBenchCases(
+    const TCMDOptions& options,
+    TBenchData* benchData,
+    NPar::ILocalExecutor* localExecutor
+) {
+    TVector<TBenchCase> cases;
+
+    auto getDsvSize = [=] () { return GetFileSize(benchData->GetDsvPath()); };
+    auto getLibSvmSize = [=] () { return GetFileSize(benchData->GetLibSvmPath()); };
+
+    cases.push_back({"load-dsv", getDsvSize, [=] () { benchData->ReadDsv(); }});
+    cases.push_back({"load-libsvm", getLibSvmSize, [=] () { benchData->ReadLibSvm(); }});
+    cases.push_back(
+        {
+            "load-quantized",
+            [=] () { return GetFileSize(benchData->GetQuantizedPath()); },
+            [=] () { benchData->ReadQuantized(); }
+        }
+    );
+
+    for (auto borderSelectionType : GetEnumAllValues<EBorderSelectionType>()) {
+        cases.push_back(
+            {
+                "quantize-" + ToString(borderSelectionType),
+                [=] () {
+                    benchData->GetRawDsvData();
+                    return getDsvSize();
+                },
+                [=] () { benchData->QuantizeDsvData(borderSelectionType); }
+            }
+        );
+    }
+
+    // the difference between these cases is the time spent in exclusive features bundling
+    for (bool bundleExclusiveFeatures : {false, true}) {
+        cases.push_back(
+            {
+                bundleExclusiveFeatures ? "quantize-sparse-efb" : "quantize-sparse",
+                [=] () {
+                    benchData->GetRawLibSvmData();
+                    return getLibSvmSize();
+                },
+                [=] () { benchData->QuantizeLibSvmData(bundleExclusiveFeatures); }
+            }
+        );
+    }
+
+    cases.push_back(
+        {
+            "ctr-precompute",
+            [=] () {
+                benchData->GetQuantizedDsvData();
+                return getDsvSize();
+            },
+            [=] () {
+                auto quantizedData = benchData->GetQuantizedDsvData();
+                const auto& featuresLayout = *quantizedData->MetaInfo.FeaturesLayout;
+
+                NCatboostOptions::TCatFeatureParams catFeatureParams(ETaskType::CPU);
+                const NCatboostOptions::TBinarizationOptions ctrBinarization(EBorderSelectionType::Uniform, 15);
+                catFeatureParams.SimpleCtrs = TVector<NCatboostOptions::TCtrDescription>{
+                    NCatboostOptions::TCtrDescription(ECtrType::Borders, {{0.0f}, {0.5f}, {1.0f}}, ctrBinarization),
+                    NCatboostOptions::TCtrDescription(ECtrType::Counter, {{0.0f}}, ctrBinarization)
+                };
+
+                TConstArrayRef<float> target = benchData->GetLabels();
+                TCtrHelper ctrHelper;
+                ctrHelper.InitCtrHelper(
+                    catFeatureParams,
+                    featuresLayout,
+                    TConstArrayRef<TConstArrayRef<float>>(&target, 1),
+                    ELossFunction::Logloss,
+                    /*objectiveDescriptor*/ Nothing(),
+                    /*allowConstLabel*/ false
+                );
+
+                const auto& targetClassifiers = ctrHelper.GetTargetClassifiers();
+                TVector<TVector<int>> learnTargetClass(targetClassifiers.size()); // [targetClassifierIdx][objectIdx]
+                TVector<int> targetClassesCount; // [targetClassifierIdx]
+                for (auto targetClassifierIdx : xrange(targetClassifiers.size())) {
+                    const auto& targetClassifier = targetClassifiers[targetClassifierIdx];
+                    for (auto value : target) {
+                        learnTargetClass[targetClassifierIdx].push_back(targetClassifier.GetTargetClass(value));
+                    }
+                    targetClassesCount.push_back(targetClassifier.GetClassesCount());
+                }
+
+                TDataMetaInfo metaInfo = quantizedData->MetaInfo;
+                TTrainingDataProviders trainingData;
+                trainingData.Learn = MakeIntrusive<TTrainingDataProvider>(
+                    quantizedData->MetaInfo.FeaturesLayout,
+                    std::move(metaInfo),
+                    quantizedData->ObjectsGrouping,
+                    quantizedData->ObjectsData,
+                    /*targetData*/ nullptr
+                );
+
+                const TFeaturesArraySubsetIndexing learnSubsetIndexing(
+                    TFullSubset<ui32>(quantizedData->GetObjectCount())
+                );
+                TScratchCache scratchCache;
+                TBenchCtrDataWriter writer(quantizedData->GetObjectCount());
+
+                featuresLayout.IterateOverAvailableFeatures<EFeatureType::Categorical>(
+                    [&] (TCatFeatureIdx catFeatureIdx) {
+                        TProjection projection;
+                        projection.AddCatFeature(SafeIntegerCast<int>(*catFeatureIdx));
+                        ComputeOnlineCTRs(
+                            trainingData,
+                            projection,
+                            ctrHelper,
+                            learnSubsetIndexing,
+                            learnTargetClass,
+                            targetClassesCount,
+                            catFeatureParams,
+                            localExecutor,
+                            &scratchCache,
+                            &writer
+                        );
+                    }
+                );
+            }
+        }
+    );
+
+    // subset of a half of objects in random places, as for bootstrap or cross-validation folds
+    auto getSubsetIndices = [=] () {
+        TFastRng64 rng(options.DataParams.Seed);
+        TIndexedSubset<ui32> indices;
+        for (auto objectIdx : xrange(SafeIntegerCast<ui32>(benchData->GetObjectCount()))) {
+            if (rng.Uniform(2)) {
+                indices.push_back(objectIdx);
+            }
+        }
+        return indices;
+    };
+    cases.push_back(
+        {
+            "get-subset-raw",
+            [=] () {
+                benchData->GetRawDsvData();
+                return getDsvSize();
+            },
+            [=] () {
+                auto rawData = benchData->GetRawDsvData();
+                auto subset = GetGroupingSubsetFromObjectsSubset(
+                    rawData->ObjectsGrouping,
+                    TArraySubsetIndexing<ui32>(getSubsetIndices()),
+                    EObjectsOrder::Ordered
+                );
+                rawData->GetSubset(subset, Max<ui64>(), localExecutor);
+            }
+        }
+    );
+    cases.push_back(
+        {
+            "get-subset-quantized",
+            [=] () {
+                benchData->GetQuantizedDsvData();
+                return getDsvSize();
+            },
+            [=] () {
+                auto quantizedData = benchData->GetQuantizedDsvData();
+                auto subset = GetGroupingSubsetFromObjectsSubset(
+                    quantizedData->ObjectsGrouping,
+                    TArraySubsetIndexing<ui32>(getSubsetIndices()),
+                    EObjectsOrder::Ordered
+                );
+                quantizedData->GetSubset(subset, Max<ui64>(), localExecutor);
+            }
+        }
+    );
+
+    return cases;
+}
+
+
+struct TBenchCaseResult {
+    TString Name;
+    ui64 SourceSize = 0;
+    TVector<double> Times; // in seconds
+    ui64 StartRss = 0;
+    ui64 PeakRss = 0;
+
+public:
+    double GetMinTime() const {
+        return *MinElement(Times.begin(), Times.end());
+    }
+
+    double GetMeanTime() const {
+        return Accumulate(Times, 0.0) / Times.size();
+    }
+
+    NJson::TJsonValue GetJsonValue(size_t objectCount) const {
+        const double minTime = GetMinTime();
+
+        NJson::TJsonValue result;
+        result["min_time"] = minTime;
+        result["mean_time"] = GetMeanTime();
+        result["rows_per_second"] = objectCount / minTime;
+        result["mb_per_second"] = SourceSize / minTime / (1 << 20);
+        result["start_rss"] = StartRss;
+        result["peak_rss"] = PeakRss;
+        return result;
+    }
+};
+
+static TBenchCaseResult RunBenchCase(const TBenchCase& benchCase, size_t repetitionCount) {
+    TBenchCaseResult result;
+    result.Name = benchCase.Name;
+    result.SourceSize = benchCase.Prepare();
+
+    TPeakRssSampler rssSampler;
+    for (auto i : xrange(repetitionCount)) {
+        Y_UNUSED(i);
+        THPTimer timer;
+        benchCase.Run();
+        result.Times.push_back(timer.Passed());
+    }
+    result.StartRss = rssSampler.GetStartRss();
+    result.PeakRss = rssSampler.GetPeakRss();
+    return result;
+}
+
+static void OutputResults(
+    const TVector<TBenchCaseResult>& results,
+    size_t objectCount,
+    const TString& outputJsonPath
+) {
+    const double mb = 1 << 20;
+
+    Cout << "case\tmin time, s\tmean time, s\trows/s\tMB/s\tpeak RSS, MB\tRSS increase, MB" << Endl;
+    for (const auto& result : results) {
+        const double minTime = result.GetMinTime();
+        Cout << result.Name
+            << '\t' << minTime
+            << '\t' << result.GetMeanTime()
+            << '\t' << objectCount / minTime
+            << '\t' << result.SourceSize / mb / minTime
+            << '\t' << result.PeakRss / mb
+            << '\t' << (result.PeakRss - result.StartRss) / mb
+            << Endl;
+    }
+
+    if (outputJsonPath) {
+        NJson::TJsonValue jsonValue;
+        for (const auto& result : results) {
+            jsonValue[result.Name] = result.GetJsonValue(objectCount);
+        }
+        TFileOutput output(outputJsonPath);
+        NJson::WriteJson(&output, &jsonValue, /*formatOutput*/ true);
+    }
+}
+
+
+static int DoMain(int argc, char** argv) {
+    TCMDOptions options;
+    TString caseNames;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddLongOption("objects", "objects count of synthetic datasets")
+        .StoreResult(&options.DataParams.ObjectCount)
+        .DefaultValue(options.DataParams.ObjectCount);
+    parser.AddLongOption("float-features", "float features count of dsv dataset")
+        .StoreResult(&options.DataParams.FloatFeatureCount)
+        .DefaultValue(options.DataParams.FloatFeatureCount);
+    parser.AddLongOption("cat-features", "categorical features count of dsv dataset")
+        .StoreResult(&options.DataParams.CatFeatureCount)
+        .DefaultValue(options.DataParams.CatFeatureCount);
+    parser.AddLongOption("cat-feature-cardinality", "max number of unique values of categorical features")
+        .StoreResult(&options.DataParams.CatFeatureCardinality)
+        .DefaultValue(options.DataParams.CatFeatureCardinality);
+    parser.AddLongOption("sparse-features", "features count of libsvm dataset")
+        .StoreResult(&options.DataParams.SparseFeatureCount)
+        .DefaultValue(options.DataParams.SparseFeatureCount);
+    parser.AddLongOption("sparse-density", "fraction of non-default values of libsvm dataset features")
+        .StoreResult(&options.DataParams.SparseDensity)
+        .DefaultValue(options.DataParams.SparseDensity);
+    parser.AddLongOption("seed")
+        .StoreResult(&options.DataParams.Seed)
+        .DefaultValue(options.DataParams.Seed);
+    parser.AddLongOption('x', "border-count")
+        .StoreResult(&options.BorderCount)
+        .DefaultValue(options.BorderCount);
+    parser.AddLongOption('T', "threads")
+        .StoreResult(&options.ThreadCount)
+        .DefaultValue(options.ThreadCount);
+    parser.AddLongOption("repetitions")
+        .StoreResult(&options.RepetitionCount)
+        .DefaultValue(options.RepetitionCount);
+    parser.AddLongOption("cases", "comma-separated names of cases to run, all by default")
+        .StoreResult(&caseNames);
+    parser.AddLongOption("tmp-dir", "directory for synthetic dataset files")
+        .StoreResult(&options.TmpDir)
+        .DefaultValue(options.TmpDir);
+    parser.AddLongOption("output-json", "also save results to this file in JSON format")
+        .StoreResult(&options.OutputJsonPath);
+
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    CB_ENSURE(options.ThreadCount > 0, "Thread count must be positive");
+    CB_ENSURE(options.RepetitionCount > 0, "Repetition count must be positive");
+    if (caseNames) {
+        options.CaseNames = StringSplitter(caseNames).Split(',').SkipEmpty().ToList<TString>();
+    }
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(options.ThreadCount - 1);
+
+    TBenchData benchData(options, &localExecutor);
+    TVector<TBenchCase> cases = GetBenchCases(options, &benchData, &localExecutor);
+    for (const auto& caseName : options.CaseNames) {
+        CB_ENSURE(
+            AnyOf(cases, [&] (const TBenchCase& benchCase) { return benchCase.Name == caseName; }),
+            "Unknown case " << caseName
+        );
+    }
+
+    TVector<TBenchCaseResult> results;
+    for (const auto& benchCase : cases) {
+        if (options.CaseNames.empty() || IsIn(options.CaseNames, benchCase.Name)) {
+            CATBOOST_INFO_LOG << "Run case " << benchCase.Name << Endl;
+            results.push_back(RunBenchCase(benchCase, options.RepetitionCount));
+        }
+    }
+    OutputResults(results, benchData.GetObjectCount(), options.OutputJsonPath);
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    try {
+        TSetLoggingVerbose inThisScope;
+        return DoMain(argc, argv);
+    } catch (...) {
+        Cerr << CurrentExceptionMessage() << Endl;
+        return -1;
+    }
+}
@@ -0,0 +1,41 @@
+#include "measure.h"
+
+#include <util/system/mem_info.h>
+
+
+static ui64 GetCurrentRss() {
+    return NMemInfo::GetMemInfo().RSS;
+}
+
+
+TPeakRssSampler::TPeakRssSampler(TDuration period)
+    : Period(period)
+    , StartRss(GetCurrentRss())
+    , PeakRss(StartRss)
+{
+    SamplingThread = MakeHolder<TThread>(
+        [this] () {
+            while (!StopEvent.WaitT(Period)) {
+                Sample();
+            }
+        }
+    );
+    SamplingThread->Start();
+}
+
+TPeakRssSampler::~TPeakRssSampler() {
+    StopEvent.Signal();
+    SamplingThread->Join();
+}
+
+ui64 TPeakRssSampler::GetPeakRss() {
+    Sample();
+    return PeakRss.load();
+}
+
+void TPeakRssSampler::Sample() {
+    const ui64 rss = GetCurrentRss();
+    ui64 peakRss = PeakRss.load();
+    while ((rss > peakRss) && !PeakRss.compare_exchange_weak(peakRss, rss)) {
+    }
+}
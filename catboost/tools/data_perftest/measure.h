@@ -0,0 +1,39 @@
+#pragma once
+
+#include <util/datetime/base.h>
+#include <util/generic/ptr.h>
+#include <util/system/event.h>
+#include <util/system/thread.h>
+#include <util/system/types.h>
+
+#include <atomic>
+
+
+/*
+ * Samples RSS of the process in a background thread while it exists.
+ * Process peak RSS from getrusage can't be reset, so it is useless for all cases except the first one.
+ * Short allocation peaks between samples can be missed.
+ */
+class TPeakRssSampler {
+public:
+    explicit TPeakRssSampler(TDuration period = TDuration::MilliSeconds(5));
+
+    ~TPeakRssSampler();
+
+    ui64 GetStartRss() const {
+        return StartRss;
+    }
+
+    // max of the sampled values so far, including the current one
+    ui64 GetPeakRss();
+
+private:
+    void Sample();
+
+private:
+    TDuration Period;
+    ui64 StartRss;
+    std::atomic<ui64> PeakRss;
+    TManualEvent StopEvent;
+    THolder<TThread> SamplingThread;
+};
@@ -0,0 +1,100 @@
+#include "synthetic_data.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+
+
+// sparse features in a group are mutually exclusive
+static constexpr ui32 SparseFeaturesGroupSize = 16;
+
+
+TVector<float> GenerateLabels(const TSyntheticDataParams& params) {
+    TFastRng64 rng(params.Seed);
+    TVector<float> labels;
+    labels.yresize(params.ObjectCount);
+    for (auto& label : labels) {
+        label = rng.Uniform(2);
+    }
+    return labels;
+}
+
+void GenerateDsvDataset(
+    const TSyntheticDataParams& params,
+    const TVector<float>& labels,
+    const TString& datasetPath,
+    const TString& cdPath
+) {
+    CB_ENSURE(labels.size() == params.ObjectCount, "Labels size does not match object count");
+    CB_ENSURE(params.CatFeatureCardinality, "Categorical feature cardinality must be positive");
+
+    {
+        TOFStream cdOutput(cdPath);
+        cdOutput << "0\tLabel\n";
+        for (auto featureIdx : xrange(params.FloatFeatureCount)) {
+            cdOutput << featureIdx + 1 << "\tNum\n";
+        }
+        for (auto featureIdx : xrange(params.CatFeatureCount)) {
+            cdOutput << params.FloatFeatureCount + featureIdx + 1 << "\tCateg\n";
+        }
+    }
+
+    TFastRng64 rng(params.Seed + 1);
+    TOFStream output(datasetPath);
+    for (auto objectIdx : xrange(params.ObjectCount)) {
+        output << labels[objectIdx];
+
+        // mix of continuous features and features with few unique values
+        for (auto featureIdx : xrange(params.FloatFeatureCount)) {
+            switch (featureIdx % 3) {
+                case 0:
+                    output << '\t' << rng.GenRandReal1();
+                    break;
+                case 1:
+                    output << '\t' << rng.Uniform(100);
+                    break;
+                default:
+                    output << '\t' << (rng.GenRandReal1() + rng.GenRandReal1() + rng.GenRandReal1()) * 10.0;
+            }
+        }
+
+        // skewed distribution of values, as usual for categorical features
+        for (auto featureIdx : xrange(params.CatFeatureCount)) {
+            Y_UNUSED(featureIdx);
+            const ui64 value = rng.Uniform(params.CatFeatureCardinality) * rng.GenRandReal1();
+            output << "\tc" << value;
+        }
+        output << '\n';
+    }
+}
+
+void GenerateLibSvmDataset(
+    const TSyntheticDataParams& params,
+    const TVector<float>& labels,
+    const TString& datasetPath
+) {
+    CB_ENSURE(labels.size() == params.ObjectCount, "Labels size does not match object count");
+    CB_ENSURE(
+        (params.SparseDensity >= 0.0) && (params.SparseDensity <= 1.0),
+        "Sparse density must be in [0, 1]"
+    );
+
+    TFastRng64 rng(params.Seed + 2);
+    TOFStream output(datasetPath);
+    for (auto objectIdx : xrange(params.ObjectCount)) {
+        output << labels[objectIdx];
+
+        // at most one non-default value in a group, so feature indices are increasing
+        for (ui32 groupBegin = 0; groupBegin < params.SparseFeatureCount; groupBegin += SparseFeaturesGroupSize) {
+            const ui32 groupSize = Min(SparseFeaturesGroupSize, params.SparseFeatureCount - groupBegin);
+            if (rng.GenRandReal1() < params.SparseDensity * groupSize) {
+                const ui32 featureIdx = groupBegin + rng.Uniform(groupSize);
+                output << ' ' << featureIdx + 1 << ':' << 1.0 + rng.GenRandReal1();
+            }
+        }
+        output << '\n';
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+struct TSyntheticDataParams {
+    ui32 ObjectCount = 100000;
+    ui32 FloatFeatureCount = 50;
+    ui32 CatFeatureCount = 5;
+    ui32 CatFeatureCardinality = 1000;
+
+    // sparse features are generated as groups of mutually exclusive features (like one-hot encoded ones)
+    ui32 SparseFeatureCount = 1000;
+    double SparseDensity = 0.01; // fraction of non-default values of each sparse feature
+
+    ui64 Seed = 0;
+};
+
+// binary labels, the same for all datasets generated with these params
+TVector<float> GenerateLabels(const TSyntheticDataParams& params);
+
+// Label, float features, categorical features
+void GenerateDsvDataset(
+    const TSyntheticDataParams& params,
+    const TVector<float>& labels,
+    const TString& datasetPath,
+    const TString& cdPath
+);
+
+// Label, sparse float features
+void GenerateLibSvmDataset(
+    const TSyntheticDataParams& params,
+    const TVector<float>& labels,
+    const TString& datasetPath
+);
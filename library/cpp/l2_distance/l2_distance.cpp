@@ -1,9 +1,13 @@
 #include "l2_distance.h"
+#include "l2_distance_avx2.h"
 
 #include <library/cpp/sse/sse.h>
+#include <library/cpp/testing/common/env.h>
 
 #include <contrib/libs/cblas/include/cblas.h>
 
+#include <util/system/cpu_id.h>
+#include <util/system/env.h>
 #include <util/system/platform.h>
 
 template <typename Result, typename Number>
@@ -145,7 +149,7 @@ ui32 L2SqrDistance(const ui8* lhs, const ui8* rhs, int length) {
     return sum;
 }
 
-float L2SqrDistance(const float* lhs, const float* rhs, int length) {
+static float L2SqrDistanceSse(const float* lhs, const float* rhs, int length) noexcept {
     __m128 sum = _mm_setzero_ps();
 
     while (length >= 4) {
@@ -167,6 +171,21 @@ float L2SqrDistance(const float* lhs, const float* rhs, int length) {
     return res[0] + res[1] + res[2] + res[3];
 }
 
+namespace NL2Distance {
+    static float (*L2SqrDistanceFloatImpl)(const float* lhs, const float* rhs, int length) noexcept = &L2SqrDistanceSse;
+
+    [[maybe_unused]] static const int _ = [] {
+        if (!FromYaTest() && GetEnv("Y_NO_AVX_IN_L2_DISTANCE") == "" && NX86::HaveAVX2() && NX86::HaveFMA()) {
+            L2SqrDistanceFloatImpl = &L2SqrDistanceAvx2;
+        }
+        return 0;
+    }();
+}
+
+float L2SqrDistance(const float* lhs, const float* rhs, int length) {
+    return NL2Distance::L2SqrDistanceFloatImpl(lhs, rhs, length);
+}
+
 double L2SqrDistance(const double* lhs, const double* rhs, int length) {
     __m128d sum = _mm_setzero_pd();
 
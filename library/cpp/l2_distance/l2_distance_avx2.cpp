@@ -0,0 +1,59 @@
+#include "l2_distance_avx2.h"
+
+#include <util/generic/ymath.h>
+
+#if defined(_avx2_) && defined(_fma_)
+
+#include <immintrin.h>
+
+namespace {
+    // Horizontal sum of eight float values in an avx register
+    float HsumFloat(__m256 v) {
+        __m256 y = _mm256_permute2f128_ps(v, v, 1);
+        v = _mm256_add_ps(v, y);
+        v = _mm256_hadd_ps(v, v);
+        return _mm256_cvtss_f32(_mm256_hadd_ps(v, v));
+    }
+}
+
+float L2SqrDistanceAvx2(const float* lhs, const float* rhs, int length) noexcept {
+    // two independent accumulators hide the latency of fma
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+
+    while (length >= 16) {
+        __m256 delta1 = _mm256_sub_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs));
+        __m256 delta2 = _mm256_sub_ps(_mm256_loadu_ps(lhs + 8), _mm256_loadu_ps(rhs + 8));
+        sum1 = _mm256_fmadd_ps(delta1, delta1, sum1);
+        sum2 = _mm256_fmadd_ps(delta2, delta2, sum2);
+        length -= 16;
+        lhs += 16;
+        rhs += 16;
+    }
+
+    if (length >= 8) {
+        __m256 delta = _mm256_sub_ps(_mm256_loadu_ps(lhs), _mm256_loadu_ps(rhs));
+        sum1 = _mm256_fmadd_ps(delta, delta, sum1);
+        length -= 8;
+        lhs += 8;
+        rhs += 8;
+    }
+
+    float res = HsumFloat(_mm256_add_ps(sum1, sum2));
+    while (length--) {
+        res += Sqr(*rhs++ - *lhs++);
+    }
+    return res;
+}
+
+#else
+
+float L2SqrDistanceAvx2(const float* lhs, const float* rhs, int length) noexcept {
+    float res = 0;
+    for (int i = 0; i < length; ++i) {
+        res += Sqr(rhs[i] - lhs[i]);
+    }
+    return res;
+}
+
+#endif
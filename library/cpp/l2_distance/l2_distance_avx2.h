@@ -0,0 +1,7 @@
+#pragma once
+
+#include <util/system/types.h>
+#include <util/system/compiler.h>
+
+Y_PURE_FUNCTION
+float L2SqrDistanceAvx2(const float* lhs, const float* rhs, int length) noexcept;
@@ -3,6 +3,7 @@
 #include <library/cpp/cache/cache.h>
 #include <library/cpp/tokenizer/tokenizer.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/maybe.h>
 #include <util/string/split.h>
 #include <util/string/strip.h>
@@ -193,31 +194,25 @@ static void SplitByDelimiter(
     bool skipEmpty,
     TVector<StringType>* tokens
 ) {
+    // Collect keeps the capacity of tokens, so that it can be reused for many strings
     if (splitBySet) {
         if (skipEmpty) {
-            *tokens = StringSplitter(inputString).SplitBySet(delimiter.c_str()).SkipEmpty();
+            StringSplitter(inputString).SplitBySet(delimiter.c_str()).SkipEmpty().Collect(tokens);
         } else {
-            *tokens = StringSplitter(inputString).SplitBySet(delimiter.c_str());
+            StringSplitter(inputString).SplitBySet(delimiter.c_str()).Collect(tokens);
         }
     } else {
         if (skipEmpty) {
-            *tokens = StringSplitter(inputString).SplitByString(delimiter).SkipEmpty();
+            StringSplitter(inputString).SplitByString(delimiter).SkipEmpty().Collect(tokens);
         } else {
-            *tokens = StringSplitter(inputString).SplitByString(delimiter);
+            StringSplitter(inputString).SplitByString(delimiter).Collect(tokens);
         }
     }
 }
 
 template <typename StringType>
 static void FilterNumbers(TVector<StringType>* tokens) {
-    TVector<StringType> filteredTokens;
-    filteredTokens.reserve(tokens->size());
-    for (auto& token : *tokens) {
-        if (!IsNumber(token)) {
-            filteredTokens.emplace_back(token);
-        }
-    }
-    tokens->swap(filteredTokens);
+    EraseIf(*tokens, [](const StringType& token) { return IsNumber(token); });
 }
 
 static void SplitByDelimiter(